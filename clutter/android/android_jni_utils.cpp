@@ -2,34 +2,79 @@
 
 #include "android_native_app_glue.h"
 
-extern "C" jint
-_android_show_keyboard (struct android_app *mApplication, jboolean show, jint flags)
+/* The JNI environment of the thread running the Clutter main loop, and
+ * the objects and methods used to show and hide the soft keyboard; the
+ * lookups are done once per activity, so that showing the keyboard does
+ * not attach the thread to the VM and walk the class hierarchy again.
+ */
+static struct
+{
+  ANativeActivity *activity;
+  JNIEnv *env;
+  bool attached;
+
+  jobject input_method_manager;
+  jobject decor_view;
+  jmethodID show_soft_input;
+  jmethodID hide_soft_input;
+  jmethodID get_window_token;
+} jni_cache;
+
+static void
+clear_cached_objects (void)
 {
-  jint lResult;
-  jint lFlags = flags;
-  jboolean pShow = show;
+  JNIEnv* lJNIEnv = jni_cache.env;
 
-  JavaVM* lJavaVM = mApplication->activity->vm;
+  if (jni_cache.input_method_manager != NULL)
+    lJNIEnv->DeleteGlobalRef (jni_cache.input_method_manager);
+  if (jni_cache.decor_view != NULL)
+    lJNIEnv->DeleteGlobalRef (jni_cache.decor_view);
+
+  jni_cache.input_method_manager = NULL;
+  jni_cache.decor_view = NULL;
+  jni_cache.activity = NULL;
+}
+
+/* Attaches the calling thread to the VM, if needed, and looks up the
+ * objects and methods used by _android_show_keyboard(); the thread
+ * stays attached until _android_jni_shutdown() is called.
+ */
+extern "C" jint
+_android_jni_init (struct android_app *mApplication)
+{
+  ANativeActivity* lActivity = mApplication->activity;
+  JavaVM* lJavaVM = lActivity->vm;
   JNIEnv* lJNIEnv;
 
-  bool attached = false;
-  switch (lJavaVM->GetEnv ((void**) &lJNIEnv, JNI_VERSION_1_6))
+  if (jni_cache.env != NULL && jni_cache.activity == lActivity)
+    return 0;
+
+  if (jni_cache.env == NULL)
     {
-    case JNI_OK:
-      break;
-    case JNI_EDETACHED:
-      if (lJavaVM->AttachCurrentThread (&lJNIEnv, NULL) != 0)
+      switch (lJavaVM->GetEnv ((void**) &lJNIEnv, JNI_VERSION_1_6))
         {
-          return 1;
+        case JNI_OK:
+          break;
+        case JNI_EDETACHED:
+          if (lJavaVM->AttachCurrentThread (&lJNIEnv, NULL) != 0)
+            return 1;
+          jni_cache.attached = true;
+          break;
+        case JNI_EVERSION:
+          return 2;
         }
-      attached = true;
-      break;
-    case JNI_EVERSION:
-      return 2;
+
+      jni_cache.env = lJNIEnv;
+    }
+  else
+    {
+      // The activity was created again.
+      lJNIEnv = jni_cache.env;
+      clear_cached_objects ();
     }
 
   // Retrieves NativeActivity.
-  jobject lNativeActivity = mApplication->activity->clazz;
+  jobject lNativeActivity = lActivity->clazz;
   jclass ClassNativeActivity = lJNIEnv->GetObjectClass (lNativeActivity);
 
   // Retrieves Context.INPUT_METHOD_SERVICE.
@@ -47,62 +92,99 @@ _android_show_keyboard (struct android_app *mApplication, jboolean show, jint fl
   // Runs getSystemService(Context.INPUT_METHOD_SERVICE).
   jclass ClassInputMethodManager =
     lJNIEnv->FindClass ("android/view/inputmethod/InputMethodManager");
-   jmethodID MethodGetSystemService =
-     lJNIEnv->GetMethodID (ClassNativeActivity, "getSystemService",
-                           "(Ljava/lang/String;)Ljava/lang/Object;");
-   jobject lInputMethodManager =
-     lJNIEnv->CallObjectMethod (lNativeActivity,
-                                MethodGetSystemService,
-                                INPUT_METHOD_SERVICE);
-
-   // Runs getWindow().getDecorView().
-   jmethodID MethodGetWindow = lJNIEnv->GetMethodID (ClassNativeActivity,
-                                                     "getWindow",
-                                                     "()Landroid/view/Window;");
-   jobject lWindow = lJNIEnv->CallObjectMethod (lNativeActivity,
-                                                MethodGetWindow);
-   jclass ClassWindow = lJNIEnv->FindClass ("android/view/Window");
-   jmethodID MethodGetDecorView = lJNIEnv->GetMethodID (ClassWindow,
-                                                        "getDecorView",
-                                                        "()Landroid/view/View;");
-   jobject lDecorView = lJNIEnv->CallObjectMethod (lWindow,
-                                                   MethodGetDecorView);
-
-   jint retval = 0;
-
-   if (pShow) {
-     // Runs lInputMethodManager.showSoftInput(...).
-     jmethodID MethodShowSoftInput =
-       lJNIEnv->GetMethodID (ClassInputMethodManager, "showSoftInput",
-                             "(Landroid/view/View;I)Z");
-     jboolean lResult = lJNIEnv->CallBooleanMethod (lInputMethodManager,
-                                                    MethodShowSoftInput,
-                                                    lDecorView, lFlags);
-
-     retval = lResult;
-   } else {
-     // Runs lWindow.getViewToken()
-     jclass ClassView = lJNIEnv->FindClass ("android/view/View");
-     jmethodID MethodGetWindowToken = lJNIEnv->GetMethodID (ClassView,
-                                                            "getWindowToken",
-                                                            "()Landroid/os/IBinder;");
-     jobject lBinder = lJNIEnv->CallObjectMethod (lDecorView,
-                                                  MethodGetWindowToken);
-
-     // lInputMethodManager.hideSoftInput(...).
-     jmethodID MethodHideSoftInput =
-       lJNIEnv->GetMethodID (ClassInputMethodManager,
-                             "hideSoftInputFromWindow",
-                             "(Landroid/os/IBinder;I)Z");
-     jboolean lRes = lJNIEnv->CallBooleanMethod (lInputMethodManager,
-                                                 MethodHideSoftInput,
-                                                 lBinder, lFlags);
-
-     retval = lRes;
-   }
-
-   // Finished with the JVM.
-   lJavaVM->DetachCurrentThread();
-
-   return retval;
+  jmethodID MethodGetSystemService =
+    lJNIEnv->GetMethodID (ClassNativeActivity, "getSystemService",
+                          "(Ljava/lang/String;)Ljava/lang/Object;");
+  jobject lInputMethodManager =
+    lJNIEnv->CallObjectMethod (lNativeActivity,
+                               MethodGetSystemService,
+                               INPUT_METHOD_SERVICE);
+
+  // Runs getWindow().getDecorView().
+  jmethodID MethodGetWindow = lJNIEnv->GetMethodID (ClassNativeActivity,
+                                                    "getWindow",
+                                                    "()Landroid/view/Window;");
+  jobject lWindow = lJNIEnv->CallObjectMethod (lNativeActivity,
+                                               MethodGetWindow);
+  jclass ClassWindow = lJNIEnv->FindClass ("android/view/Window");
+  jmethodID MethodGetDecorView = lJNIEnv->GetMethodID (ClassWindow,
+                                                       "getDecorView",
+                                                       "()Landroid/view/View;");
+  jobject lDecorView = lJNIEnv->CallObjectMethod (lWindow,
+                                                  MethodGetDecorView);
+
+  jclass ClassView = lJNIEnv->FindClass ("android/view/View");
+
+  jni_cache.show_soft_input =
+    lJNIEnv->GetMethodID (ClassInputMethodManager, "showSoftInput",
+                          "(Landroid/view/View;I)Z");
+  jni_cache.hide_soft_input =
+    lJNIEnv->GetMethodID (ClassInputMethodManager,
+                          "hideSoftInputFromWindow",
+                          "(Landroid/os/IBinder;I)Z");
+  jni_cache.get_window_token =
+    lJNIEnv->GetMethodID (ClassView, "getWindowToken",
+                          "()Landroid/os/IBinder;");
+
+  jni_cache.input_method_manager = lJNIEnv->NewGlobalRef (lInputMethodManager);
+  jni_cache.decor_view = lJNIEnv->NewGlobalRef (lDecorView);
+  jni_cache.activity = lActivity;
+
+  lJNIEnv->DeleteLocalRef (ClassNativeActivity);
+  lJNIEnv->DeleteLocalRef (ClassContext);
+  lJNIEnv->DeleteLocalRef (INPUT_METHOD_SERVICE);
+  lJNIEnv->DeleteLocalRef (ClassInputMethodManager);
+  lJNIEnv->DeleteLocalRef (lInputMethodManager);
+  lJNIEnv->DeleteLocalRef (lWindow);
+  lJNIEnv->DeleteLocalRef (ClassWindow);
+  lJNIEnv->DeleteLocalRef (lDecorView);
+  lJNIEnv->DeleteLocalRef (ClassView);
+
+  return 0;
+}
+
+extern "C" void
+_android_jni_shutdown (struct android_app *mApplication)
+{
+  if (jni_cache.env == NULL)
+    return;
+
+  clear_cached_objects ();
+
+  if (jni_cache.attached)
+    mApplication->activity->vm->DetachCurrentThread ();
+
+  jni_cache.env = NULL;
+  jni_cache.attached = false;
+}
+
+extern "C" jint
+_android_show_keyboard (struct android_app *mApplication, jboolean show, jint flags)
+{
+  jint retval = _android_jni_init (mApplication);
+
+  if (retval != 0)
+    return retval;
+
+  JNIEnv* lJNIEnv = jni_cache.env;
+
+  if (show) {
+    // Runs lInputMethodManager.showSoftInput(...).
+    retval = lJNIEnv->CallBooleanMethod (jni_cache.input_method_manager,
+                                         jni_cache.show_soft_input,
+                                         jni_cache.decor_view, flags);
+  } else {
+    // Runs lWindow.getViewToken(); the token changes with the window.
+    jobject lBinder = lJNIEnv->CallObjectMethod (jni_cache.decor_view,
+                                                 jni_cache.get_window_token);
+
+    // lInputMethodManager.hideSoftInput(...).
+    retval = lJNIEnv->CallBooleanMethod (jni_cache.input_method_manager,
+                                         jni_cache.hide_soft_input,
+                                         lBinder, flags);
+
+    lJNIEnv->DeleteLocalRef (lBinder);
+  }
+
+  return retval;
 }
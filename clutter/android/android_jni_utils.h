@@ -5,6 +5,9 @@
 
 #include "android_native_app_glue.h"
 
+jint _android_jni_init (struct android_app *mApplication);
+void _android_jni_shutdown (struct android_app *mApplication);
+
 jint _android_show_keyboard (struct android_app *mApplication,
                              jboolean show, jint flags);
 
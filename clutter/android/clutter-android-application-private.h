@@ -25,6 +25,8 @@
 #ifndef __CLUTTER_ANDROID_APPLICATION_PRIVATE_H__
 #define __CLUTTER_ANDROID_APPLICATION_PRIVATE_H__
 
+#include <EGL/egl.h>
+
 #include "android_native_app_glue.h"
 
 #include "clutter-android-application.h"
@@ -52,10 +54,41 @@ struct _ClutterAndroidApplication
   guint have_window : 1;
   guint touch_enabled : 1;
   guint volume_keys_enabled : 1;
+  guint snapshots_enabled : 1;
+  guint resize_transitions_enabled : 1;
 
   CoglOnscreen *saved_onscreen;
 
+  /* the surface keeping the GL context current while the activity
+   * has no window, or EGL_NO_SURFACE
+   */
+  EGLSurface parked_surface;
+
+  /* the snapshot of the stage passed to the activity when it was
+   * created, or saved by the last APP_CMD_SAVE_STATE
+   */
+  GBytes *snapshot;
+
+  /* the resources released when the window goes away, and when the
+   * system runs low on memory
+   */
+  ClutterTrimMemoryFlags background_trim_flags;
+  ClutterTrimMemoryFlags low_memory_trim_flags;
+
   GMainLoop *wait_for_window;
+
+  /* the refresh rate requested for the window, or 0 */
+  float frame_rate;
+
+  /* the text committed by the input method and not delivered yet; it
+   * can be committed from any thread
+   */
+  GMutex commit_lock;
+  GString *committed_text;
+  guint commit_id;
 };
 
+void _clutter_android_application_set_frame_rate (ClutterAndroidApplication *application,
+                                                  float                      frame_rate);
+
 #endif /* __CLUTTER_ANDROID_APPLICATION_PRIVATE_H__ */
@@ -23,18 +23,23 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <config.h>
 
 #include <android/input.h>
 #include <android/window.h>
 
+#include <EGL/egl.h>
+
 #include <cogl/cogl.h>
 #include <glib-android/glib-android.h>
 
 #include "clutter-main.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
+#include "clutter-backend-private.h"
 #include "clutter-device-manager-private.h"
+#include "clutter-event-private.h"
 #include "clutter-stage-private.h"
 
 #include "clutter-android-application-private.h"
@@ -69,6 +74,17 @@
 #define DEBUG_APP(args...)
 #endif
 
+/* the levels passed to ComponentCallbacks2.onTrimMemory() */
+#define TRIM_MEMORY_RUNNING_LOW         10
+#define TRIM_MEMORY_RUNNING_CRITICAL    15
+#define TRIM_MEMORY_MODERATE            60
+
+/* the frames of a resize transition: the first half of them spread the
+ * relayout of the stage, and the second half fade out the image of the
+ * previous size
+ */
+#define RESIZE_TRANSITION_FRAMES        12
+
 G_DEFINE_TYPE (ClutterAndroidApplication,
                clutter_android_application,
                G_TYPE_OBJECT)
@@ -76,6 +92,7 @@ G_DEFINE_TYPE (ClutterAndroidApplication,
 enum
 {
   READY,
+  CONTEXT_LOST,
 
   LAST_SIGNAL,
 };
@@ -93,6 +110,18 @@ clutter_android_application_ready (ClutterAndroidApplication *application)
 static void
 clutter_android_application_finalize (GObject *object)
 {
+  ClutterAndroidApplication *application = CLUTTER_ANDROID_APPLICATION (object);
+
+  g_clear_pointer (&application->snapshot, g_bytes_unref);
+
+  if (application->commit_id != 0)
+    g_source_remove (application->commit_id);
+
+  if (application->committed_text != NULL)
+    g_string_free (application->committed_text, TRUE);
+
+  g_mutex_clear (&application->commit_lock);
+
   G_OBJECT_CLASS (clutter_android_application_parent_class)->finalize (object);
 }
 
@@ -113,6 +142,21 @@ clutter_android_application_class_init (ClutterAndroidApplicationClass *klass)
                   NULL, NULL,
                   _clutter_marshal_BOOLEAN__VOID,
                   G_TYPE_BOOLEAN, 0);
+
+  /*
+   * Emitted when the activity comes back with a GL context that did
+   * not survive while it was in the background; Clutter releases its
+   * own textures, and the handlers should upload again the GL
+   * resources they created themselves.
+   */
+  signals[CONTEXT_LOST] =
+    g_signal_new (I_("context-lost"),
+                  G_TYPE_FROM_CLASS (object_class),
+                  G_SIGNAL_RUN_LAST,
+                  G_STRUCT_OFFSET (ClutterAndroidApplicationClass, context_lost),
+                  NULL, NULL,
+                  _clutter_marshal_VOID__VOID,
+                  G_TYPE_NONE, 0);
 }
 
 static void
@@ -120,6 +164,17 @@ clutter_android_application_init (ClutterAndroidApplication *self)
 {
   self->touch_enabled = TRUE;
   self->volume_keys_enabled = TRUE;
+  self->parked_surface = EGL_NO_SURFACE;
+
+  g_mutex_init (&self->commit_lock);
+
+  /* the offscreen buffers and the unused images are the cheapest to
+   * create again, and the memory of the textures is the first to go
+   * when the system needs it back
+   */
+  self->background_trim_flags = CLUTTER_TRIM_MEMORY_OFFSCREEN_TARGETS |
+                                CLUTTER_TRIM_MEMORY_IMAGE_CACHE;
+  self->low_memory_trim_flags = CLUTTER_TRIM_MEMORY_ALL;
 }
 
 ClutterAndroidApplication *
@@ -133,6 +188,193 @@ clutter_android_application_get_default (void)
   return (app = g_object_new (CLUTTER_TYPE_ANDROID_APPLICATION, NULL));
 }
 
+static void
+clutter_android_application_apply_frame_rate (ClutterAndroidApplication *application)
+{
+#if __ANDROID_API__ >= 30
+  ANativeWindow *window = application->android_application->window;
+
+  if (window == NULL)
+    return;
+
+  DEBUG_APP ("requesting a frame rate of %.0f", application->frame_rate);
+
+  /* a frame rate of 0 removes the preference of the window */
+  ANativeWindow_setFrameRate (window, application->frame_rate,
+                              ANATIVEWINDOW_FRAME_RATE_COMPATIBILITY_DEFAULT);
+#endif
+}
+
+/*
+ * Asks the display to switch to a refresh rate matching @frame_rate,
+ * for the animations capped with clutter_timeline_set_max_frame_rate();
+ * a @frame_rate of 0 lets the system pick the refresh rate again.
+ * The request is applied again when the window is created again.
+ */
+void
+_clutter_android_application_set_frame_rate (ClutterAndroidApplication *application,
+                                             float                      frame_rate)
+{
+  if (application->frame_rate == frame_rate)
+    return;
+
+  application->frame_rate = frame_rate;
+  clutter_android_application_apply_frame_rate (application);
+}
+
+/*
+ * Keeps the GL context of Cogl current on a small pbuffer while the
+ * activity has no window, so that the textures, the glyph atlases and
+ * the programs survive until the window comes back, instead of going
+ * away with the window surface.
+ */
+static void
+clutter_android_application_park_context (ClutterAndroidApplication *application)
+{
+  static const EGLint pbuffer_attribs[] = {
+    EGL_WIDTH, 1,
+    EGL_HEIGHT, 1,
+    EGL_NONE
+  };
+  CoglContext *context;
+  EGLDisplay egl_display;
+  EGLContext egl_context;
+  EGLint config_attribs[] = {
+    EGL_CONFIG_ID, 0,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint n_configs = 0;
+
+  if (application->parked_surface != EGL_NO_SURFACE)
+    return;
+
+  context = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  egl_display = cogl_egl_context_get_egl_display (context);
+  egl_context = cogl_egl_context_get_egl_context (context);
+
+  /* the pbuffer has to use the configuration of the context */
+  if (!eglQueryContext (egl_display, egl_context,
+                        EGL_CONFIG_ID, &config_attribs[1]) ||
+      !eglChooseConfig (egl_display, config_attribs, &config, 1, &n_configs) ||
+      n_configs == 0)
+    {
+      DEBUG_APP ("unable to find the EGL config of the context");
+      return;
+    }
+
+  application->parked_surface =
+    eglCreatePbufferSurface (egl_display, config, pbuffer_attribs);
+
+  if (application->parked_surface == EGL_NO_SURFACE)
+    {
+      DEBUG_APP ("unable to create a pbuffer: 0x%x", eglGetError ());
+      return;
+    }
+
+  if (!eglMakeCurrent (egl_display,
+                       application->parked_surface,
+                       application->parked_surface,
+                       egl_context))
+    {
+      DEBUG_APP ("unable to park the context: 0x%x", eglGetError ());
+      eglDestroySurface (egl_display, application->parked_surface);
+      application->parked_surface = EGL_NO_SURFACE;
+      return;
+    }
+
+  DEBUG_APP ("GL context parked on a pbuffer");
+}
+
+/*
+ * Moves the GL context parked by clutter_android_application_park_context()
+ * to the new window of @stage_cogl; if the context was lost anyway, the
+ * resources of Clutter are released so that they are created again in
+ * the new context, and the application is told to do the same.
+ */
+static void
+clutter_android_application_resume_context (ClutterAndroidApplication *application,
+                                            ClutterStageCogl          *stage_cogl)
+{
+  CoglContext *context;
+  EGLDisplay egl_display;
+  EGLContext egl_context;
+  gboolean context_lost = FALSE;
+
+  context = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  egl_display = cogl_egl_context_get_egl_display (context);
+  egl_context = cogl_egl_context_get_egl_context (context);
+
+  /* binding the context again is how EGL reports a context lost to
+   * a power management event while we were in the background
+   */
+  if (application->parked_surface != EGL_NO_SURFACE &&
+      !eglMakeCurrent (egl_display,
+                       application->parked_surface,
+                       application->parked_surface,
+                       egl_context))
+    context_lost = eglGetError () == EGL_CONTEXT_LOST;
+
+  /* this creates the surface of the new window, and binds it */
+  cogl_android_onscreen_update_native_window (stage_cogl->onscreen,
+                                              application->android_application->window);
+
+  if (application->parked_surface != EGL_NO_SURFACE)
+    {
+      eglDestroySurface (egl_display, application->parked_surface);
+      application->parked_surface = EGL_NO_SURFACE;
+    }
+
+  if (context_lost)
+    {
+      DEBUG_APP ("GL context lost in the background");
+
+      clutter_trim_memory (CLUTTER_TRIM_MEMORY_ALL);
+      g_signal_emit (application, signals[CONTEXT_LOST], 0);
+    }
+  else
+    DEBUG_APP ("GL context resumed");
+}
+
+/*
+ * Saves the actors of the stage in the state of the activity, so that
+ * they can be restored without building them again when the activity
+ * is created again.
+ */
+static void
+clutter_android_application_save_snapshot (ClutterAndroidApplication *application)
+{
+  struct android_app *app = application->android_application;
+  ClutterStage *stage;
+  GBytes *snapshot;
+  gconstpointer data;
+  gsize size;
+
+  stage = clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
+  if (stage == NULL)
+    return;
+
+  snapshot = clutter_actor_save_snapshot (CLUTTER_ACTOR (stage));
+  data = g_bytes_get_data (snapshot, &size);
+
+  /* the glue releases the saved state using free() */
+  app->savedState = malloc (size);
+  if (app->savedState != NULL)
+    {
+      memcpy (app->savedState, data, size);
+      app->savedStateSize = size;
+    }
+
+  DEBUG_APP ("saved a snapshot of %" G_GSIZE_FORMAT " bytes", size);
+
+  /* the process might outlive the activity, in which case we do not
+   * need to go through the saved state
+   */
+  if (application->snapshot != NULL)
+    g_bytes_unref (application->snapshot);
+
+  application->snapshot = snapshot;
+}
 
 /*
  * Process the next main command.
@@ -162,6 +404,8 @@ clutter_android_handle_cmd (struct android_app *app,
              able to use it later if needed. */
           if (!application->had_window_once)
             {
+              _clutter_startup_mark (CLUTTER_STARTUP_MARK_WINDOW, 0);
+
               cogl_android_set_native_window (application->android_application->window);
               application->had_window_once = TRUE;
               ANativeActivity_setWindowFlags (application->android_application->activity,
@@ -178,8 +422,8 @@ clutter_android_handle_cmd (struct android_app *app,
                   stage_cogl->onscreen = application->saved_onscreen;
                   application->saved_onscreen = NULL;
 
-                  cogl_android_onscreen_update_native_window (stage_cogl->onscreen,
-                                                              application->android_application->window);
+                  clutter_android_application_resume_context (application,
+                                                              stage_cogl);
 
                   clutter_actor_queue_relayout (CLUTTER_ACTOR (stage));
                   clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
@@ -190,6 +434,9 @@ clutter_android_handle_cmd (struct android_app *app,
 
           application->have_window = TRUE;
 
+          if (application->frame_rate != 0)
+            clutter_android_application_apply_frame_rate (application);
+
           if (application->wait_for_window)
             {
               DEBUG_APP ("Waking up the waiting main loop");
@@ -225,7 +472,14 @@ clutter_android_handle_cmd (struct android_app *app,
 
               application->saved_onscreen = stage_cogl->onscreen;
               stage_cogl->onscreen = NULL;
+
+              clutter_android_application_park_context (application);
             }
+
+          /* the GL context stays around while we are in the
+           * background, so release what can be created again
+           */
+          clutter_trim_memory (application->background_trim_flags);
         }
       break;
 
@@ -238,6 +492,12 @@ clutter_android_handle_cmd (struct android_app *app,
           ClutterStage *stage = clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
 
           DEBUG_APP ("resizing stage @ %ix%i", width, height);
+
+          if (application->resize_transitions_enabled &&
+              (clutter_actor_get_width (CLUTTER_ACTOR (stage)) != width ||
+               clutter_actor_get_height (CLUTTER_ACTOR (stage)) != height))
+            _clutter_stage_begin_resize_transition (stage, RESIZE_TRANSITION_FRAMES);
+
           clutter_actor_set_size (CLUTTER_ACTOR (stage), width, height);
         }
       break;
@@ -258,6 +518,11 @@ clutter_android_handle_cmd (struct android_app *app,
               clutter_actor_get_height (CLUTTER_ACTOR (stage)) != height)
             {
               DEBUG_APP ("resizing stage @ %ix%i", width, height);
+
+              /* the image has to be painted at the previous size */
+              if (application->resize_transitions_enabled)
+                _clutter_stage_begin_resize_transition (stage, RESIZE_TRANSITION_FRAMES);
+
               cogl_android_onscreen_update_size (stage_cogl->onscreen,
                                                  width, height);
               clutter_actor_queue_relayout (CLUTTER_ACTOR (stage));
@@ -280,10 +545,21 @@ clutter_android_handle_cmd (struct android_app *app,
       DEBUG_APP ("command: LOST_FOCUS");
       break;
 
+    case APP_CMD_LOW_MEMORY:
+      DEBUG_APP ("command: LOW_MEMORY");
+      clutter_trim_memory (application->low_memory_trim_flags);
+      break;
+
     case APP_CMD_RESUME:
       DEBUG_APP ("command: RESUME");
       break;
 
+    case APP_CMD_SAVE_STATE:
+      DEBUG_APP ("command: SAVE_STATE");
+      if (application->snapshots_enabled)
+        clutter_android_application_save_snapshot (application);
+      break;
+
     case APP_CMD_START:
       application->state = CLUTTER_ANDROID_APPLICATION_STATE_STARTED;
       DEBUG_APP ("command: START");
@@ -301,12 +577,48 @@ clutter_android_handle_cmd (struct android_app *app,
 
     case APP_CMD_DESTROY:
       application->state = CLUTTER_ANDROID_APPLICATION_STATE_DESTROYED;
+      _android_jni_shutdown (app);
       clutter_main_quit ();
       DEBUG_APP ("command: DESTROYED");
       break;
     }
 }
 
+/* the input events carry their time in nanoseconds */
+static guint32
+event_time_to_msecs (int64_t time_)
+{
+  return (guint32) (time_ / 1000000);
+}
+
+/* the event times use SYSTEM_TIME_MONOTONIC, which is the clock of
+ * g_get_monotonic_time()
+ */
+static gint64
+event_time_to_usecs (int64_t time_)
+{
+  return time_ / 1000;
+}
+
+/* adds the positions of @pointer_index reported since the previous
+ * motion event to the history of @event, oldest first
+ */
+static void
+add_motion_history (ClutterEvent *event,
+                    AInputEvent  *a_event,
+                    size_t        pointer_index)
+{
+  size_t i, history_size = AMotionEvent_getHistorySize (a_event);
+
+  for (i = 0; i < history_size; i++)
+    {
+      _clutter_event_add_history_sample (event,
+                                         event_time_to_msecs (AMotionEvent_getHistoricalEventTime (a_event, i)),
+                                         AMotionEvent_getHistoricalX (a_event, pointer_index, i),
+                                         AMotionEvent_getHistoricalY (a_event, pointer_index, i));
+    }
+}
+
 static gboolean
 translate_motion_event_to_pointer_event (AInputEvent *a_event)
 {
@@ -331,7 +643,7 @@ translate_motion_event_to_pointer_event (AInputEvent *a_event)
       event->button.button = 1;
       event->button.click_count = 1;
       event->button.device = pointer_device;
-      event->button.time = AMotionEvent_getEventTime (a_event);
+      event->button.time = event_time_to_msecs (AMotionEvent_getEventTime (a_event));
       event->button.x = AMotionEvent_getX (a_event, 0);
       event->button.y = AMotionEvent_getY (a_event, 0);
       break;
@@ -342,7 +654,7 @@ translate_motion_event_to_pointer_event (AInputEvent *a_event)
       event->button.button = 1;
       event->button.click_count = 1;
       event->button.device = pointer_device;
-      event->button.time = AMotionEvent_getEventTime (a_event);
+      event->button.time = event_time_to_msecs (AMotionEvent_getEventTime (a_event));
       event->button.x = AMotionEvent_getX (a_event, 0);
       event->button.y = AMotionEvent_getY (a_event, 0);
       break;
@@ -353,9 +665,10 @@ translate_motion_event_to_pointer_event (AInputEvent *a_event)
       event->motion.device = pointer_device;
        /* TODO: Following line is a massive hack for touch screen */
       event->motion.modifier_state = CLUTTER_BUTTON1_MASK;
-      event->motion.time = AMotionEvent_getEventTime (a_event);
+      event->motion.time = event_time_to_msecs (AMotionEvent_getEventTime (a_event));
       event->motion.x = AMotionEvent_getX (a_event, 0);
       event->motion.y = AMotionEvent_getY (a_event, 0);
+      add_motion_history (event, a_event, 0);
       break;
 
     default:
@@ -363,6 +676,9 @@ translate_motion_event_to_pointer_event (AInputEvent *a_event)
       return FALSE;
     }
 
+  clutter_event_set_hardware_time (event,
+                                   event_time_to_usecs (AMotionEvent_getEventTime (a_event)));
+
   event->any.stage =
     clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
   _clutter_input_device_set_stage (pointer_device, event->any.stage);
@@ -373,6 +689,23 @@ translate_motion_event_to_pointer_event (AInputEvent *a_event)
   return TRUE;
 }
 
+/* the number of fingers toggling the performance overlay */
+#define HUD_TOGGLE_FINGERS 4
+
+static gboolean
+toggle_hud_idle (gpointer data)
+{
+  ClutterStage *stage;
+
+  stage =
+    clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
+
+  if (stage != NULL)
+    clutter_stage_set_show_hud (stage, !clutter_stage_get_show_hud (stage));
+
+  return G_SOURCE_REMOVE;
+}
+
 static gboolean
 translate_motion_event_to_touch_event (ClutterAndroidApplication *application,
                                        AInputEvent *a_event)
@@ -381,6 +714,7 @@ translate_motion_event_to_touch_event (ClutterAndroidApplication *application,
   int32_t i, nb_pointers;
   int32_t action;
   int64_t current_time;
+  gint64 hardware_time;
   ClutterStage *stage;
   ClutterEvent *event;
   ClutterDeviceManager *manager;
@@ -404,11 +738,19 @@ translate_motion_event_to_touch_event (ClutterAndroidApplication *application,
   action &= AMOTION_EVENT_ACTION_MASK;
   nb_pointers = AMotionEvent_getPointerCount (a_event);
 
-  current_time = AMotionEvent_getEventTime (a_event);
+  current_time = event_time_to_msecs (AMotionEvent_getEventTime (a_event));
+  hardware_time = event_time_to_usecs (AMotionEvent_getEventTime (a_event));
 
   DEBUG_TOUCH ("TOUCH id=%i nb_pointers=%i action=%x\n",
                pointer_index, nb_pointers, action);
 
+  /* the events are translated in the thread of the activity, so the
+   * overlay is toggled from the main loop
+   */
+  if (action == AMOTION_EVENT_ACTION_POINTER_DOWN &&
+      nb_pointers == HUD_TOGGLE_FINGERS)
+    clutter_threads_add_idle (toggle_hud_idle, NULL);
+
   for (i = 0; i < nb_pointers; i++)
     {
       int32_t current_id = AMotionEvent_getPointerId (a_event, i);
@@ -455,6 +797,7 @@ translate_motion_event_to_touch_event (ClutterAndroidApplication *application,
         }
 
       event->touch.time = current_time;
+      clutter_event_set_hardware_time (event, hardware_time);
       event->touch.x = AMotionEvent_getX (a_event, i);
       event->touch.y = AMotionEvent_getY (a_event, i);
       event->touch.device = pointer_device;
@@ -464,6 +807,9 @@ translate_motion_event_to_touch_event (ClutterAndroidApplication *application,
          with + 1) */
       event->touch.sequence = (gpointer) (current_id + 1);
 
+      if (action == AMOTION_EVENT_ACTION_MOVE)
+        add_motion_history (event, a_event, i);
+
       event->any.stage = stage;
 
       _clutter_event_source_android_push_event (backend->android_source, event);
@@ -586,6 +932,22 @@ clutter_android_application_run (ClutterAndroidApplication *application)
       /*  application->state != CLUTTER_ANDROID_APPLICATION_STATE_NONE) && */
       !application->have_window)
     {
+      /* the GL context needs the window, but loading the EGL and GLES
+       * libraries does not, so we can do it while we wait
+       */
+      if (_clutter_get_staged_init ())
+        {
+          GError *error = NULL;
+
+          if (!_clutter_backend_preload_renderer (clutter_get_default_backend (),
+                                                  COGL_DRIVER_GLES2,
+                                                  &error))
+            {
+              DEBUG_APP ("Unable to preload the renderer: %s", error->message);
+              g_error_free (error);
+            }
+        }
+
       DEBUG_APP ("Waiting for the window");
       application->wait_for_window = g_main_loop_new (NULL, FALSE);
       g_main_loop_run (application->wait_for_window);
@@ -605,6 +967,91 @@ clutter_android_application_get_asset_manager (ClutterAndroidApplication *applic
   return application->android_application->activity->assetManager;
 }
 
+/*
+ * Opens the asset at @path in the APK of @application, and returns its
+ * contents without copying them: uncompressed assets are mapped in
+ * memory, while compressed ones are inflated once into a buffer owned
+ * by the asset. The asset is closed when the returned #GBytes is
+ * freed.
+ *
+ * The returned data can be passed to clutter_image_load_from_bytes_async()
+ * and g_memory_input_stream_new_from_bytes(), or loaded as a script
+ * using clutter_android_application_load_script().
+ */
+GBytes *
+clutter_android_application_get_asset_bytes (ClutterAndroidApplication  *application,
+                                             const gchar                *path,
+                                             GError                    **error)
+{
+  AAssetManager *manager;
+  AAsset *asset;
+  const void *buffer;
+
+  g_return_val_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application), NULL);
+  g_return_val_if_fail (path != NULL, NULL);
+
+  manager = clutter_android_application_get_asset_manager (application);
+
+  asset = AAssetManager_open (manager, path, AASSET_MODE_BUFFER);
+  if (asset == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                   "Unable to open the asset '%s'", path);
+      return NULL;
+    }
+
+  buffer = AAsset_getBuffer (asset);
+  if (buffer == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "Unable to read the asset '%s'", path);
+      AAsset_close (asset);
+      return NULL;
+    }
+
+  DEBUG_APP ("asset '%s': %lld bytes, %s", path,
+             (long long) AAsset_getLength64 (asset),
+             AAsset_isAllocated (asset) ? "inflated" : "mapped");
+
+  return g_bytes_new_with_free_func (buffer,
+                                     AAsset_getLength64 (asset),
+                                     (GDestroyNotify) AAsset_close,
+                                     asset);
+}
+
+/*
+ * Loads the ClutterScript definitions of the asset at @path in the APK
+ * of @application into @script, reading them in place; see
+ * clutter_android_application_get_asset_bytes().
+ *
+ * Returns the merge id of the definitions, or 0 on error.
+ */
+guint
+clutter_android_application_load_script (ClutterAndroidApplication  *application,
+                                         ClutterScript              *script,
+                                         const gchar                *path,
+                                         GError                    **error)
+{
+  GBytes *bytes;
+  gsize len;
+  const gchar *data;
+  guint retval;
+
+  g_return_val_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application), 0);
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), 0);
+
+  bytes = clutter_android_application_get_asset_bytes (application, path, error);
+  if (bytes == NULL)
+    return 0;
+
+  data = g_bytes_get_data (bytes, &len);
+  retval = clutter_script_load_from_data (script, data, len, error);
+
+  g_bytes_unref (bytes);
+
+  return retval;
+}
+
 ANativeActivity *
 clutter_android_application_get_native_activity (ClutterAndroidApplication *application)
 {
@@ -648,6 +1095,118 @@ clutter_android_application_show_keyboard (ClutterAndroidApplication *applicatio
     }
 }
 
+/* delivers each character of @text as a key press and release, for
+ * the actors other than ClutterText handling the key events themselves
+ */
+static void
+clutter_android_application_emit_text_as_keys (ClutterAndroidApplication *application,
+                                               ClutterStage              *stage,
+                                               const gchar               *text)
+{
+  ClutterBackendAndroid *backend =
+    (ClutterBackendAndroid *) clutter_get_default_backend ();
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+  ClutterInputDevice *keyboard_device =
+    clutter_device_manager_get_core_device (manager, CLUTTER_KEYBOARD_DEVICE);
+  const gchar *p;
+
+  for (p = text; *p != '\0'; p = g_utf8_next_char (p))
+    {
+      gunichar wc = g_utf8_get_char (p);
+      ClutterEventType types[] = { CLUTTER_KEY_PRESS, CLUTTER_KEY_RELEASE };
+      guint i;
+
+      for (i = 0; i < G_N_ELEMENTS (types); i++)
+        {
+          ClutterEvent *event = clutter_event_new (types[i]);
+
+          event->key.time = g_get_monotonic_time () / 1000;
+          event->key.keyval = clutter_unicode_to_keysym (wc);
+          event->key.unicode_value = wc;
+          event->key.device = keyboard_device;
+          event->any.stage = stage;
+
+          _clutter_event_source_android_push_event (backend->android_source,
+                                                    event);
+        }
+    }
+}
+
+static gboolean
+clutter_android_application_deliver_text (gpointer data)
+{
+  ClutterAndroidApplication *application = data;
+  ClutterStage *stage;
+  ClutterActor *focus;
+  GString *text;
+
+  g_mutex_lock (&application->commit_lock);
+  text = application->committed_text;
+  application->committed_text = NULL;
+  application->commit_id = 0;
+  g_mutex_unlock (&application->commit_lock);
+
+  if (text == NULL)
+    return G_SOURCE_REMOVE;
+
+  stage = clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
+  if (stage == NULL)
+    goto out;
+
+  DEBUG_KEY ("committing %" G_GSIZE_FORMAT " bytes of text", text->len);
+
+  focus = clutter_stage_get_key_focus (stage);
+  if (CLUTTER_IS_TEXT (focus) && clutter_text_get_editable (CLUTTER_TEXT (focus)))
+    {
+      ClutterText *text_actor = CLUTTER_TEXT (focus);
+
+      /* one insertion, and one relayout, for the whole batch */
+      clutter_text_delete_selection (text_actor);
+      clutter_text_insert_text (text_actor, text->str,
+                                clutter_text_get_cursor_position (text_actor));
+    }
+  else
+    clutter_android_application_emit_text_as_keys (application, stage, text->str);
+
+out:
+  g_string_free (text, TRUE);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Commits @text from the input method, typically from the
+ * InputConnection.commitText() of a Java view through JNI; it can be
+ * called from any thread.
+ *
+ * The text committed before the main loop runs again is delivered in
+ * one batch: it is inserted at the cursor of the focused ClutterText
+ * in one go, and sent as key events to the other actors.
+ */
+void
+clutter_android_application_commit_text (ClutterAndroidApplication *application,
+                                         const gchar *text)
+{
+  g_return_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application));
+  g_return_if_fail (g_utf8_validate (text, -1, NULL));
+
+  g_mutex_lock (&application->commit_lock);
+
+  if (application->committed_text == NULL)
+    application->committed_text = g_string_new (text);
+  else
+    g_string_append (application->committed_text, text);
+
+  if (application->commit_id == 0)
+    application->commit_id =
+      clutter_threads_add_idle_full (G_PRIORITY_HIGH_IDLE,
+                                     clutter_android_application_deliver_text,
+                                     application,
+                                     NULL);
+
+  g_mutex_unlock (&application->commit_lock);
+}
+
 void
 clutter_android_application_set_enable_touch (ClutterAndroidApplication *application,
                                               gboolean touch_enabled)
@@ -687,6 +1246,147 @@ clutter_android_application_get_enable_volume_keys (ClutterAndroidApplication *a
   return application->volume_keys_enabled;
 }
 
+/*
+ * When the snapshots are enabled, the actors of the default stage are
+ * saved with the state of the activity, and can be restored using
+ * clutter_android_application_restore_snapshot() when the activity is
+ * created again, instead of building them from scratch.
+ */
+void
+clutter_android_application_set_enable_snapshots (ClutterAndroidApplication *application,
+                                                  gboolean snapshots_enabled)
+{
+  g_return_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application));
+
+  application->snapshots_enabled = !!snapshots_enabled;
+}
+
+gboolean
+clutter_android_application_get_enable_snapshots (ClutterAndroidApplication *application)
+{
+  g_return_val_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application), FALSE);
+
+  return application->snapshots_enabled;
+}
+
+/*
+ * When the resize transitions are enabled, the stage keeps showing an
+ * image of its previous size, scaled to the new one, while the layout
+ * of the new size is computed; the relayout boundaries, set using
+ * clutter_actor_set_relayout_boundary(), spread that layout over a few
+ * frames, so that the rotations of the screen do not drop frames.
+ */
+void
+clutter_android_application_set_enable_resize_transitions (ClutterAndroidApplication *application,
+                                                           gboolean resize_transitions_enabled)
+{
+  g_return_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application));
+
+  application->resize_transitions_enabled = !!resize_transitions_enabled;
+}
+
+gboolean
+clutter_android_application_get_enable_resize_transitions (ClutterAndroidApplication *application)
+{
+  g_return_val_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application), FALSE);
+
+  return application->resize_transitions_enabled;
+}
+
+/*
+ * Restores the actors saved with the state of the activity into the
+ * default stage; this is meant to be called from the ::ready handler,
+ * which should build the user interface as usual if it returns FALSE.
+ */
+gboolean
+clutter_android_application_restore_snapshot (ClutterAndroidApplication *application)
+{
+  ClutterStage *stage;
+  GError *error = NULL;
+  gboolean retval;
+
+  g_return_val_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application), FALSE);
+
+  if (application->snapshot == NULL)
+    return FALSE;
+
+  stage = clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
+  if (stage == NULL)
+    return FALSE;
+
+  retval = clutter_actor_restore_snapshot (CLUTTER_ACTOR (stage),
+                                           application->snapshot,
+                                           &error);
+  if (!retval)
+    {
+      DEBUG_APP ("unable to restore the snapshot: %s", error->message);
+      g_error_free (error);
+    }
+
+  /* the actors own the state now */
+  g_clear_pointer (&application->snapshot, g_bytes_unref);
+
+  return retval;
+}
+
+/*
+ * Sets the resources released by clutter_trim_memory() when the window
+ * of the activity goes away, and when the system runs low on memory;
+ * the resources are created again when they are painted, so releasing
+ * more of them makes the first frames after resuming slower.
+ */
+void
+clutter_android_application_set_trim_memory_flags (ClutterAndroidApplication *application,
+                                                   ClutterTrimMemoryFlags background_flags,
+                                                   ClutterTrimMemoryFlags low_memory_flags)
+{
+  g_return_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application));
+
+  application->background_trim_flags = background_flags;
+  application->low_memory_trim_flags = low_memory_flags;
+}
+
+void
+clutter_android_application_get_trim_memory_flags (ClutterAndroidApplication *application,
+                                                   ClutterTrimMemoryFlags *background_flags,
+                                                   ClutterTrimMemoryFlags *low_memory_flags)
+{
+  g_return_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application));
+
+  if (background_flags != NULL)
+    *background_flags = application->background_trim_flags;
+
+  if (low_memory_flags != NULL)
+    *low_memory_flags = application->low_memory_trim_flags;
+}
+
+/*
+ * Releases resources according to a level passed to onTrimMemory();
+ * NativeActivity only forwards onLowMemory(), so the applications
+ * overriding onTrimMemory() in Java can call this through JNI.
+ */
+void
+clutter_android_application_trim_memory (ClutterAndroidApplication *application,
+                                         int level)
+{
+  ClutterTrimMemoryFlags flags = CLUTTER_TRIM_MEMORY_NONE;
+
+  g_return_if_fail (CLUTTER_IS_ANDROID_APPLICATION (application));
+
+  DEBUG_APP ("trim memory level %d", level);
+
+  if (level >= TRIM_MEMORY_RUNNING_LOW)
+    flags |= application->background_trim_flags;
+
+  /* we are about to be killed, or are slowing down the foreground */
+  if (level >= TRIM_MEMORY_MODERATE ||
+      level == TRIM_MEMORY_RUNNING_CRITICAL)
+    flags |= application->low_memory_trim_flags;
+
+  if (flags != CLUTTER_TRIM_MEMORY_NONE)
+    clutter_trim_memory (flags);
+}
+
 /*
  * This is the main entry point of a native application that is using
  * android_native_app_glue.  It runs in its own thread, with its own
@@ -725,5 +1425,14 @@ android_main (struct android_app* android_application)
 
   clutter_application->android_application = android_application;
 
+  /* attach the thread to the VM once, instead of for each JNI call */
+  if (_android_jni_init (android_application) != 0)
+    DEBUG_APP ("Unable to initialize JNI");
+
+  if (android_application->savedState != NULL)
+    clutter_application->snapshot =
+      g_bytes_new (android_application->savedState,
+                   android_application->savedStateSize);
+
   clutter_android_main (clutter_application);
 }
@@ -26,6 +26,7 @@
 #define __CLUTTER_ANDROID_APPLICATION_H__
 
 #include <glib-object.h>
+#include <clutter/clutter.h>
 
 #include <android/asset_manager.h>
 #include <android/native_activity.h>
@@ -64,6 +65,7 @@ struct _ClutterAndroidApplicationClass
 
   /* signals */
   gboolean (*ready) (ClutterAndroidApplication *self);
+  void (*context_lost) (ClutterAndroidApplication *self);
 };
 
 /* Entry point for android clutter applications */
@@ -76,9 +78,18 @@ ClutterAndroidApplication *clutter_android_application_get_default (void);
 void clutter_android_application_show_keyboard (ClutterAndroidApplication *application,
                                                 gboolean show_keyboard,
                                                 gboolean implicit);
+void clutter_android_application_commit_text (ClutterAndroidApplication *application,
+                                              const gchar *text);
 void clutter_android_application_run (ClutterAndroidApplication *application);
 
 AAssetManager *clutter_android_application_get_asset_manager (ClutterAndroidApplication *application);
+GBytes *clutter_android_application_get_asset_bytes (ClutterAndroidApplication *application,
+                                                     const gchar *path,
+                                                     GError **error);
+guint clutter_android_application_load_script (ClutterAndroidApplication *application,
+                                               ClutterScript *script,
+                                               const gchar *path,
+                                               GError **error);
 
 ANativeActivity *clutter_android_application_get_native_activity (ClutterAndroidApplication *application);
 
@@ -88,6 +99,21 @@ gboolean clutter_android_application_get_enable_touch (ClutterAndroidApplication
 void clutter_android_application_set_enable_volume_keys (ClutterAndroidApplication *application,
                                                          gboolean volume_keys_enabled);
 gboolean clutter_android_application_get_enable_volume_keys (ClutterAndroidApplication *application);
+void clutter_android_application_set_enable_snapshots (ClutterAndroidApplication *application,
+                                                       gboolean snapshots_enabled);
+gboolean clutter_android_application_get_enable_snapshots (ClutterAndroidApplication *application);
+void clutter_android_application_set_enable_resize_transitions (ClutterAndroidApplication *application,
+                                                                gboolean resize_transitions_enabled);
+gboolean clutter_android_application_get_enable_resize_transitions (ClutterAndroidApplication *application);
+gboolean clutter_android_application_restore_snapshot (ClutterAndroidApplication *application);
+void clutter_android_application_set_trim_memory_flags (ClutterAndroidApplication *application,
+                                                        ClutterTrimMemoryFlags background_flags,
+                                                        ClutterTrimMemoryFlags low_memory_flags);
+void clutter_android_application_get_trim_memory_flags (ClutterAndroidApplication *application,
+                                                        ClutterTrimMemoryFlags *background_flags,
+                                                        ClutterTrimMemoryFlags *low_memory_flags);
+void clutter_android_application_trim_memory (ClutterAndroidApplication *application,
+                                              int level);
 
 G_END_DECLS
 
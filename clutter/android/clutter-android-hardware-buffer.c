@@ -0,0 +1,515 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * ClutterAndroidHardwareBuffer is a #ClutterContent displaying frames
+ * stored in AHardwareBuffers, like the images of an AImageReader fed
+ * by the camera or by a video decoder.
+ *
+ * Each buffer is imported as an EGLImage, which backs the texture
+ * painted by the content, so the frames are never copied by the CPU.
+ * Producers cycle through a small set of buffers, so the imported
+ * buffers are kept around and a frame using a buffer seen before only
+ * costs a call to clutter_content_invalidate().
+ *
+ * Only the RGB formats can be sampled through a GL_TEXTURE_2D, which
+ * is what Cogl supports; the YUV formats need an external sampler, and
+ * the producers have to be configured to output RGBA frames.
+ */
+
+#include "config.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cogl/cogl.h>
+
+#include "clutter-android-hardware-buffer.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+/* the number of imported buffers kept around; producers usually cycle
+ * through fewer buffers than this
+ */
+#define MAX_IMPORTED_BUFFERS    8
+
+typedef struct
+{
+  AHardwareBuffer *buffer;
+  EGLImageKHR image;
+  CoglTexture *texture;
+} ImportedBuffer;
+
+struct _ClutterAndroidHardwareBuffer
+{
+  GObject parent;
+
+  /* the most recently used imported buffers first */
+  GQueue imported;
+
+  /* the frame being displayed */
+  ImportedBuffer *current;
+  GDestroyNotify current_release;
+  gpointer current_release_data;
+
+  /* the frame pushed from another thread, and not displayed yet */
+  GMutex pending_lock;
+  AHardwareBuffer *pending;
+  GDestroyNotify pending_release;
+  gpointer pending_release_data;
+  guint pending_id;
+};
+
+static PFNEGLGETNATIVECLIENTBUFFERANDROIDPROC get_native_client_buffer;
+static PFNEGLCREATEIMAGEKHRPROC create_image;
+static PFNEGLDESTROYIMAGEKHRPROC destroy_image;
+
+static void clutter_content_iface_init (ClutterContentIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ClutterAndroidHardwareBuffer,
+                         clutter_android_hardware_buffer,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_CONTENT,
+                                                clutter_content_iface_init))
+
+static EGLDisplay
+get_egl_display (void)
+{
+  CoglContext *context;
+
+  context = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  return cogl_egl_context_get_egl_display (context);
+}
+
+static void
+imported_buffer_free (ImportedBuffer *imported)
+{
+  cogl_object_unref (imported->texture);
+  destroy_image (get_egl_display (), imported->image);
+  AHardwareBuffer_release (imported->buffer);
+
+  g_slice_free (ImportedBuffer, imported);
+}
+
+static ImportedBuffer *
+import_buffer (AHardwareBuffer  *buffer,
+               GError          **error)
+{
+  static const EGLint attribs[] = {
+    EGL_IMAGE_PRESERVED_KHR, EGL_TRUE,
+    EGL_NONE
+  };
+  AHardwareBuffer_Desc desc;
+  CoglPixelFormat format;
+  CoglContext *context;
+  ImportedBuffer *imported;
+  EGLImageKHR image;
+  CoglTexture2D *texture;
+  CoglError *internal_error = NULL;
+
+  if (G_UNLIKELY (create_image == NULL))
+    {
+      get_native_client_buffer = (PFNEGLGETNATIVECLIENTBUFFERANDROIDPROC)
+        eglGetProcAddress ("eglGetNativeClientBufferANDROID");
+      create_image = (PFNEGLCREATEIMAGEKHRPROC)
+        eglGetProcAddress ("eglCreateImageKHR");
+      destroy_image = (PFNEGLDESTROYIMAGEKHRPROC)
+        eglGetProcAddress ("eglDestroyImageKHR");
+    }
+
+  if (get_native_client_buffer == NULL ||
+      create_image == NULL ||
+      destroy_image == NULL)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                           "EGL_ANDROID_get_native_client_buffer is not supported");
+      return NULL;
+    }
+
+  AHardwareBuffer_describe (buffer, &desc);
+
+  switch (desc.format)
+    {
+    case AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM:
+      format = COGL_PIXEL_FORMAT_RGBA_8888_PRE;
+      break;
+
+    case AHARDWAREBUFFER_FORMAT_R8G8B8X8_UNORM:
+    case AHARDWAREBUFFER_FORMAT_R8G8B8_UNORM:
+      format = COGL_PIXEL_FORMAT_RGB_888;
+      break;
+
+    case AHARDWAREBUFFER_FORMAT_R5G6B5_UNORM:
+      format = COGL_PIXEL_FORMAT_RGB_565;
+      break;
+
+    default:
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                   "Unsupported hardware buffer format 0x%x", desc.format);
+      return NULL;
+    }
+
+  image = create_image (get_egl_display (),
+                        EGL_NO_CONTEXT,
+                        EGL_NATIVE_BUFFER_ANDROID,
+                        get_native_client_buffer (buffer),
+                        attribs);
+  if (image == EGL_NO_IMAGE_KHR)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "Unable to create an EGLImage: 0x%x", eglGetError ());
+      return NULL;
+    }
+
+  context = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  texture = cogl_egl_texture_2d_new_from_image (context,
+                                                desc.width,
+                                                desc.height,
+                                                format,
+                                                image,
+                                                &internal_error);
+  if (texture == NULL)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                           internal_error->message);
+      cogl_error_free (internal_error);
+      destroy_image (get_egl_display (), image);
+      return NULL;
+    }
+
+  CLUTTER_NOTE (TEXTURE, "Imported hardware buffer %p (%ux%u, format 0x%x)",
+                buffer, desc.width, desc.height, desc.format);
+
+  AHardwareBuffer_acquire (buffer);
+
+  imported = g_slice_new (ImportedBuffer);
+  imported->buffer = buffer;
+  imported->image = image;
+  imported->texture = COGL_TEXTURE (texture);
+
+  return imported;
+}
+
+static void
+clutter_android_hardware_buffer_release_current (ClutterAndroidHardwareBuffer *self)
+{
+  GDestroyNotify release = self->current_release;
+  gpointer release_data = self->current_release_data;
+
+  self->current = NULL;
+  self->current_release = NULL;
+  self->current_release_data = NULL;
+
+  if (release != NULL)
+    release (release_data);
+}
+
+static gboolean
+clutter_android_hardware_buffer_show_frame (ClutterAndroidHardwareBuffer  *self,
+                                            AHardwareBuffer               *buffer,
+                                            GDestroyNotify                 release,
+                                            gpointer                       release_data,
+                                            GError                       **error)
+{
+  ImportedBuffer *imported = NULL;
+  GList *l;
+
+  for (l = self->imported.head; l != NULL; l = l->next)
+    {
+      ImportedBuffer *iter = l->data;
+
+      if (iter->buffer == buffer)
+        {
+          imported = iter;
+          g_queue_unlink (&self->imported, l);
+          g_queue_push_head_link (&self->imported, l);
+          break;
+        }
+    }
+
+  if (imported == NULL)
+    {
+      imported = import_buffer (buffer, error);
+      if (imported == NULL)
+        {
+          if (release != NULL)
+            release (release_data);
+
+          return FALSE;
+        }
+
+      g_queue_push_head (&self->imported, imported);
+
+      /* the current frame is never the least recently used buffer */
+      while (self->imported.length > MAX_IMPORTED_BUFFERS)
+        imported_buffer_free (g_queue_pop_tail (&self->imported));
+    }
+
+  clutter_android_hardware_buffer_release_current (self);
+
+  self->current = imported;
+  self->current_release = release;
+  self->current_release_data = release_data;
+
+  clutter_content_invalidate (CLUTTER_CONTENT (self));
+
+  return TRUE;
+}
+
+static gboolean
+clutter_android_hardware_buffer_show_pending (gpointer data)
+{
+  ClutterAndroidHardwareBuffer *self = data;
+  AHardwareBuffer *buffer;
+  GDestroyNotify release;
+  gpointer release_data;
+  GError *error = NULL;
+
+  g_mutex_lock (&self->pending_lock);
+  buffer = self->pending;
+  release = self->pending_release;
+  release_data = self->pending_release_data;
+  self->pending = NULL;
+  self->pending_release = NULL;
+  self->pending_release_data = NULL;
+  self->pending_id = 0;
+  g_mutex_unlock (&self->pending_lock);
+
+  if (buffer == NULL)
+    return G_SOURCE_REMOVE;
+
+  if (!clutter_android_hardware_buffer_show_frame (self, buffer,
+                                                   release, release_data,
+                                                   &error))
+    {
+      g_warning ("Unable to display the hardware buffer: %s", error->message);
+      g_error_free (error);
+    }
+
+  AHardwareBuffer_release (buffer);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+clutter_android_hardware_buffer_dispose (GObject *gobject)
+{
+  ClutterAndroidHardwareBuffer *self = CLUTTER_ANDROID_HARDWARE_BUFFER (gobject);
+
+  if (self->pending_id != 0)
+    {
+      g_source_remove (self->pending_id);
+      self->pending_id = 0;
+    }
+
+  if (self->pending != NULL)
+    {
+      if (self->pending_release != NULL)
+        self->pending_release (self->pending_release_data);
+
+      AHardwareBuffer_release (self->pending);
+      self->pending = NULL;
+    }
+
+  clutter_android_hardware_buffer_clear (self);
+
+  G_OBJECT_CLASS (clutter_android_hardware_buffer_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_android_hardware_buffer_finalize (GObject *gobject)
+{
+  ClutterAndroidHardwareBuffer *self = CLUTTER_ANDROID_HARDWARE_BUFFER (gobject);
+
+  g_mutex_clear (&self->pending_lock);
+
+  G_OBJECT_CLASS (clutter_android_hardware_buffer_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_android_hardware_buffer_paint_content (ClutterContent   *content,
+                                               ClutterActor     *actor,
+                                               ClutterPaintNode *root)
+{
+  ClutterAndroidHardwareBuffer *self = CLUTTER_ANDROID_HARDWARE_BUFFER (content);
+  ClutterPaintNode *node;
+
+  if (self->current == NULL)
+    return;
+
+  node = clutter_actor_create_texture_paint_node (actor, self->current->texture);
+  clutter_paint_node_set_name (node, "Hardware Buffer Content");
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+}
+
+static gboolean
+clutter_android_hardware_buffer_get_preferred_size (ClutterContent *content,
+                                                    gfloat         *width,
+                                                    gfloat         *height)
+{
+  ClutterAndroidHardwareBuffer *self = CLUTTER_ANDROID_HARDWARE_BUFFER (content);
+
+  if (self->current == NULL)
+    return FALSE;
+
+  if (width != NULL)
+    *width = cogl_texture_get_width (self->current->texture);
+
+  if (height != NULL)
+    *height = cogl_texture_get_height (self->current->texture);
+
+  return TRUE;
+}
+
+static void
+clutter_content_iface_init (ClutterContentIface *iface)
+{
+  iface->get_preferred_size = clutter_android_hardware_buffer_get_preferred_size;
+  iface->paint_content = clutter_android_hardware_buffer_paint_content;
+}
+
+static void
+clutter_android_hardware_buffer_class_init (ClutterAndroidHardwareBufferClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->dispose = clutter_android_hardware_buffer_dispose;
+  gobject_class->finalize = clutter_android_hardware_buffer_finalize;
+}
+
+static void
+clutter_android_hardware_buffer_init (ClutterAndroidHardwareBuffer *self)
+{
+  g_queue_init (&self->imported);
+  g_mutex_init (&self->pending_lock);
+}
+
+/*
+ * Creates a new content displaying AHardwareBuffer frames.
+ */
+ClutterContent *
+clutter_android_hardware_buffer_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_ANDROID_HARDWARE_BUFFER, NULL);
+}
+
+/*
+ * Queues @buffer as the next frame of @self; this function can be
+ * called from any thread, typically from the listener of an
+ * AImageReader or from the output callback of a decoder.
+ *
+ * The frame is displayed from the main loop; if another frame is
+ * pushed before that happens, @buffer is dropped. @release is called
+ * with @release_data once the frame is not used any more, and can be
+ * used to give the buffer back to its producer, for instance by calling
+ * AImage_delete(); it is called on the main thread when another frame
+ * replaces @buffer, and on the thread pushing the newer frame when
+ * @buffer is dropped.
+ */
+void
+clutter_android_hardware_buffer_push_frame (ClutterAndroidHardwareBuffer *self,
+                                            AHardwareBuffer *buffer,
+                                            GDestroyNotify release,
+                                            gpointer release_data)
+{
+  AHardwareBuffer *dropped;
+  GDestroyNotify dropped_release;
+  gpointer dropped_release_data;
+
+  g_return_if_fail (CLUTTER_IS_ANDROID_HARDWARE_BUFFER (self));
+  g_return_if_fail (buffer != NULL);
+
+  AHardwareBuffer_acquire (buffer);
+
+  g_mutex_lock (&self->pending_lock);
+
+  dropped = self->pending;
+  dropped_release = self->pending_release;
+  dropped_release_data = self->pending_release_data;
+
+  self->pending = buffer;
+  self->pending_release = release;
+  self->pending_release_data = release_data;
+
+  if (self->pending_id == 0)
+    self->pending_id =
+      clutter_threads_add_idle_full (G_PRIORITY_HIGH_IDLE,
+                                     clutter_android_hardware_buffer_show_pending,
+                                     self,
+                                     NULL);
+
+  g_mutex_unlock (&self->pending_lock);
+
+  if (dropped != NULL)
+    {
+      CLUTTER_NOTE (TEXTURE, "Dropped hardware buffer frame %p", dropped);
+
+      if (dropped_release != NULL)
+        dropped_release (dropped_release_data);
+
+      AHardwareBuffer_release (dropped);
+    }
+}
+
+/*
+ * Displays @buffer as the frame of @self, from the main thread. The
+ * contents of @buffer must not change until another frame is set, or
+ * until clutter_android_hardware_buffer_clear() is called.
+ *
+ * Returns FALSE if @buffer could not be imported.
+ */
+gboolean
+clutter_android_hardware_buffer_set_frame (ClutterAndroidHardwareBuffer *self,
+                                           AHardwareBuffer *buffer,
+                                           GError **error)
+{
+  g_return_val_if_fail (CLUTTER_IS_ANDROID_HARDWARE_BUFFER (self), FALSE);
+  g_return_val_if_fail (buffer != NULL, FALSE);
+
+  return clutter_android_hardware_buffer_show_frame (self, buffer,
+                                                     NULL, NULL,
+                                                     error);
+}
+
+/*
+ * Stops displaying the current frame of @self, and releases all the
+ * imported buffers.
+ */
+void
+clutter_android_hardware_buffer_clear (ClutterAndroidHardwareBuffer *self)
+{
+  g_return_if_fail (CLUTTER_IS_ANDROID_HARDWARE_BUFFER (self));
+
+  if (self->current == NULL && g_queue_is_empty (&self->imported))
+    return;
+
+  clutter_android_hardware_buffer_release_current (self);
+
+  g_queue_foreach (&self->imported, (GFunc) imported_buffer_free, NULL);
+  g_queue_clear (&self->imported);
+
+  clutter_content_invalidate (CLUTTER_CONTENT (self));
+}
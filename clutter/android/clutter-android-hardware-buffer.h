@@ -0,0 +1,65 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_ANDROID_HARDWARE_BUFFER_H__
+#define __CLUTTER_ANDROID_HARDWARE_BUFFER_H__
+
+#include <glib-object.h>
+#include <clutter/clutter.h>
+
+#include <android/hardware_buffer.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_ANDROID_HARDWARE_BUFFER clutter_android_hardware_buffer_get_type()
+
+#define CLUTTER_ANDROID_HARDWARE_BUFFER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), \
+  CLUTTER_TYPE_ANDROID_HARDWARE_BUFFER, ClutterAndroidHardwareBuffer))
+
+#define CLUTTER_IS_ANDROID_HARDWARE_BUFFER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), \
+  CLUTTER_TYPE_ANDROID_HARDWARE_BUFFER))
+
+typedef struct _ClutterAndroidHardwareBuffer ClutterAndroidHardwareBuffer;
+typedef struct _ClutterAndroidHardwareBufferClass ClutterAndroidHardwareBufferClass;
+
+struct _ClutterAndroidHardwareBufferClass
+{
+  GObjectClass parent_class;
+};
+
+GType clutter_android_hardware_buffer_get_type (void) G_GNUC_CONST;
+
+ClutterContent *clutter_android_hardware_buffer_new (void);
+
+void clutter_android_hardware_buffer_push_frame (ClutterAndroidHardwareBuffer *self,
+                                                 AHardwareBuffer *buffer,
+                                                 GDestroyNotify release,
+                                                 gpointer release_data);
+gboolean clutter_android_hardware_buffer_set_frame (ClutterAndroidHardwareBuffer *self,
+                                                    AHardwareBuffer *buffer,
+                                                    GError **error);
+void clutter_android_hardware_buffer_clear (ClutterAndroidHardwareBuffer *self);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_ANDROID_HARDWARE_BUFFER_H__ */
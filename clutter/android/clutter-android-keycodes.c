@@ -26,346 +26,126 @@
 
 #include <android/keycodes.h>
 
-static const guint keycodes[AKEYCODE_BUTTON_MODE + 1] = {
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_UNKNOWN         = 0, */
-  CLUTTER_KEY_Left, /* AKEYCODE_SOFT_LEFT       = 1, */
-  CLUTTER_KEY_Right, /* AKEYCODE_SOFT_RIGHT      = 2, */
-  CLUTTER_KEY_Home, /* AKEYCODE_HOME            = 3, */
-  CLUTTER_KEY_Back, /* AKEYCODE_BACK            = 4, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CALL            = 5, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ENDCALL         = 6, */
-  CLUTTER_KEY_0, /* AKEYCODE_0               = 7, */
-  CLUTTER_KEY_1, /* AKEYCODE_1               = 8, */
-  CLUTTER_KEY_2, /* AKEYCODE_2               = 9, */
-  CLUTTER_KEY_3, /* AKEYCODE_3               = 10, */
-  CLUTTER_KEY_4, /* AKEYCODE_4               = 11, */
-  CLUTTER_KEY_5, /* AKEYCODE_5               = 12, */
-  CLUTTER_KEY_6, /* AKEYCODE_6               = 13, */
-  CLUTTER_KEY_7, /* AKEYCODE_7               = 14, */
-  CLUTTER_KEY_8, /* AKEYCODE_8               = 15, */
-  CLUTTER_KEY_9, /* AKEYCODE_9               = 16, */
-  CLUTTER_KEY_asterisk, /* AKEYCODE_STAR            = 17, */
-  CLUTTER_KEY_ssharp, /* AKEYCODE_POUND           = 18, */
-  CLUTTER_KEY_KP_Up, /* AKEYCODE_DPAD_UP         = 19, */
-  CLUTTER_KEY_KP_Down, /* AKEYCODE_DPAD_DOWN       = 20, */
-  CLUTTER_KEY_KP_Left, /* AKEYCODE_DPAD_LEFT       = 21, */
-  CLUTTER_KEY_KP_Right, /* AKEYCODE_DPAD_RIGHT      = 22, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_CENTER     = 23, */
-  CLUTTER_KEY_AudioRaiseVolume, /* AKEYCODE_VOLUME_UP       = 24, */
-  CLUTTER_KEY_AudioLowerVolume, /* AKEYCODE_VOLUME_DOWN     = 25, */
-  CLUTTER_KEY_PowerOff, /* AKEYCODE_POWER           = 26, */
-  CLUTTER_KEY_WebCam, /* AKEYCODE_CAMERA          = 27, */
-  CLUTTER_KEY_Clear, /* AKEYCODE_CLEAR           = 28, */
-  CLUTTER_KEY_a, /* AKEYCODE_A               = 29, */
-  CLUTTER_KEY_b, /* AKEYCODE_B               = 30, */
-  CLUTTER_KEY_c, /* AKEYCODE_C               = 31, */
-  CLUTTER_KEY_d, /* AKEYCODE_D               = 32, */
-  CLUTTER_KEY_e, /* AKEYCODE_E               = 33, */
-  CLUTTER_KEY_f, /* AKEYCODE_F               = 34, */
-  CLUTTER_KEY_g, /* AKEYCODE_G               = 35, */
-  CLUTTER_KEY_h, /* AKEYCODE_H               = 36, */
-  CLUTTER_KEY_i, /* AKEYCODE_I               = 37, */
-  CLUTTER_KEY_j, /* AKEYCODE_J               = 38, */
-  CLUTTER_KEY_k, /* AKEYCODE_K               = 39, */
-  CLUTTER_KEY_l, /* AKEYCODE_L               = 40, */
-  CLUTTER_KEY_m, /* AKEYCODE_M               = 41, */
-  CLUTTER_KEY_n, /* AKEYCODE_N               = 42, */
-  CLUTTER_KEY_o, /* AKEYCODE_O               = 43, */
-  CLUTTER_KEY_p, /* AKEYCODE_P               = 44, */
-  CLUTTER_KEY_q, /* AKEYCODE_Q               = 45, */
-  CLUTTER_KEY_r, /* AKEYCODE_R               = 46, */
-  CLUTTER_KEY_s, /* AKEYCODE_S               = 47, */
-  CLUTTER_KEY_t, /* AKEYCODE_T               = 48, */
-  CLUTTER_KEY_u, /* AKEYCODE_U               = 49, */
-  CLUTTER_KEY_v, /* AKEYCODE_V               = 50, */
-  CLUTTER_KEY_w, /* AKEYCODE_W               = 51, */
-  CLUTTER_KEY_x, /* AKEYCODE_X               = 52, */
-  CLUTTER_KEY_y, /* AKEYCODE_Y               = 53, */
-  CLUTTER_KEY_z, /* AKEYCODE_Z               = 54, */
-  CLUTTER_KEY_comma, /* AKEYCODE_COMMA           = 55, */
-  CLUTTER_KEY_period, /* AKEYCODE_PERIOD          = 56, */
-  CLUTTER_KEY_Alt_L, /* AKEYCODE_ALT_LEFT        = 57, */
-  CLUTTER_KEY_Alt_R, /* AKEYCODE_ALT_RIGHT       = 58, */
-  CLUTTER_KEY_Shift_L, /* AKEYCODE_SHIFT_LEFT      = 59, */
-  CLUTTER_KEY_Shift_R, /* AKEYCODE_SHIFT_RIGHT     = 60, */
-  CLUTTER_KEY_Tab, /* AKEYCODE_TAB             = 61, */
-  CLUTTER_KEY_space, /* AKEYCODE_SPACE           = 62, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SYM             = 63, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_EXPLORER        = 64, */
-  CLUTTER_KEY_Mail, /* AKEYCODE_ENVELOPE        = 65, */
-  CLUTTER_KEY_Return, /* AKEYCODE_ENTER           = 66, */
-  CLUTTER_KEY_BackSpace, /* AKEYCODE_DEL             = 67, */
-  CLUTTER_KEY_grave, /* AKEYCODE_GRAVE           = 68, */
-  CLUTTER_KEY_minus, /* AKEYCODE_MINUS           = 69, */
-  CLUTTER_KEY_equal, /* AKEYCODE_EQUALS          = 70, */
-  CLUTTER_KEY_bracketleft, /* AKEYCODE_LEFT_BRACKET    = 71, */
-  CLUTTER_KEY_bracketright, /* AKEYCODE_RIGHT_BRACKET   = 72, */
-  CLUTTER_KEY_backslash, /* AKEYCODE_BACKSLASH       = 73, */
-  CLUTTER_KEY_semicolon, /* AKEYCODE_SEMICOLON       = 74, */
-  CLUTTER_KEY_apostrophe, /* AKEYCODE_APOSTROPHE      = 75, */
-  CLUTTER_KEY_slash, /* AKEYCODE_SLASH           = 76, */
-  CLUTTER_KEY_at, /* AKEYCODE_AT              = 77, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_NUM             = 78, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_HEADSETHOOK     = 79, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_FOCUS           = 80,   // *Camera* focus */
-  CLUTTER_KEY_plus, /* AKEYCODE_PLUS            = 81, */
-  CLUTTER_KEY_Menu, /* AKEYCODE_MENU            = 82, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_NOTIFICATION    = 83, */
-  CLUTTER_KEY_Search, /* AKEYCODE_SEARCH          = 84, */
-  CLUTTER_KEY_AudioPlay, /* AKEYCODE_MEDIA_PLAY_PAUSE= 85, */
-  CLUTTER_KEY_AudioStop, /* AKEYCODE_MEDIA_STOP      = 86, */
-  CLUTTER_KEY_AudioNext, /* AKEYCODE_MEDIA_NEXT      = 87, */
-  CLUTTER_KEY_AudioPrev, /* AKEYCODE_MEDIA_PREVIOUS  = 88, */
-  CLUTTER_KEY_AudioRewind, /* AKEYCODE_MEDIA_REWIND    = 89, */
-  CLUTTER_KEY_Forward, /* AKEYCODE_MEDIA_FAST_FORWARD = 90, */
-  CLUTTER_KEY_AudioMute, /* AKEYCODE_MUTE            = 91, */
-  CLUTTER_KEY_Page_Up, /* AKEYCODE_PAGE_UP         = 92, */
-  CLUTTER_KEY_Page_Down, /* AKEYCODE_PAGE_DOWN       = 93, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PICTSYMBOLS     = 94, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SWITCH_CHARSET  = 95, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_A        = 96, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_B        = 97, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_C        = 98, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_X        = 99, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_Y        = 100, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_Z        = 101, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_L1       = 102, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_R1       = 103, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_L2       = 104, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_R2       = 105, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_THUMBL   = 106, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_THUMBR   = 107, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_START    = 108, */
-  CLUTTER_KEY_Select, /* AKEYCODE_BUTTON_SELECT   = 109, */
-  CLUTTER_KEY_VoidSymbol /* AKEYCODE_BUTTON_MODE     = 110, */
-};
-
-static const guint shifted_keycodes[AKEYCODE_BUTTON_MODE + 1] = {
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_UNKNOWN         = 0, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SOFT_LEFT       = 1, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SOFT_RIGHT      = 2, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_HOME            = 3, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BACK            = 4, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CALL            = 5, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ENDCALL         = 6, */
-  CLUTTER_KEY_parenright, /* AKEYCODE_0               = 7, */
-  CLUTTER_KEY_exclam, /* AKEYCODE_1               = 8, */
-  CLUTTER_KEY_at, /* AKEYCODE_2               = 9, */
-  CLUTTER_KEY_numbersign, /* AKEYCODE_3               = 10, */
-  CLUTTER_KEY_dollar, /* AKEYCODE_4               = 11, */
-  CLUTTER_KEY_percent, /* AKEYCODE_5               = 12, */
-  CLUTTER_KEY_upcaret, /* AKEYCODE_6               = 13, */
-  CLUTTER_KEY_ampersand, /* AKEYCODE_7               = 14, */
-  CLUTTER_KEY_asterisk, /* AKEYCODE_8               = 15, */
-  CLUTTER_KEY_parenleft, /* AKEYCODE_9               = 16, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_STAR            = 17, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_POUND           = 18, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_UP         = 19, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_DOWN       = 20, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_LEFT       = 21, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_RIGHT      = 22, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_CENTER     = 23, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_VOLUME_UP       = 24, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_VOLUME_DOWN     = 25, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_POWER           = 26, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CAMERA          = 27, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CLEAR           = 28, */
-  CLUTTER_KEY_A, /* AKEYCODE_A               = 29, */
-  CLUTTER_KEY_B, /* AKEYCODE_B               = 30, */
-  CLUTTER_KEY_C, /* AKEYCODE_C               = 31, */
-  CLUTTER_KEY_D, /* AKEYCODE_D               = 32, */
-  CLUTTER_KEY_E, /* AKEYCODE_E               = 33, */
-  CLUTTER_KEY_F, /* AKEYCODE_F               = 34, */
-  CLUTTER_KEY_G, /* AKEYCODE_G               = 35, */
-  CLUTTER_KEY_H, /* AKEYCODE_H               = 36, */
-  CLUTTER_KEY_I, /* AKEYCODE_I               = 37, */
-  CLUTTER_KEY_J, /* AKEYCODE_J               = 38, */
-  CLUTTER_KEY_K, /* AKEYCODE_K               = 39, */
-  CLUTTER_KEY_L, /* AKEYCODE_L               = 40, */
-  CLUTTER_KEY_M, /* AKEYCODE_M               = 41, */
-  CLUTTER_KEY_N, /* AKEYCODE_N               = 42, */
-  CLUTTER_KEY_O, /* AKEYCODE_O               = 43, */
-  CLUTTER_KEY_P, /* AKEYCODE_P               = 44, */
-  CLUTTER_KEY_Q, /* AKEYCODE_Q               = 45, */
-  CLUTTER_KEY_R, /* AKEYCODE_R               = 46, */
-  CLUTTER_KEY_S, /* AKEYCODE_S               = 47, */
-  CLUTTER_KEY_T, /* AKEYCODE_T               = 48, */
-  CLUTTER_KEY_U, /* AKEYCODE_U               = 49, */
-  CLUTTER_KEY_V, /* AKEYCODE_V               = 50, */
-  CLUTTER_KEY_W, /* AKEYCODE_W               = 51, */
-  CLUTTER_KEY_X, /* AKEYCODE_X               = 52, */
-  CLUTTER_KEY_Y, /* AKEYCODE_Y               = 53, */
-  CLUTTER_KEY_Z, /* AKEYCODE_Z               = 54, */
-  CLUTTER_KEY_less, /* AKEYCODE_COMMA           = 55, */
-  CLUTTER_KEY_period, /* AKEYCODE_PERIOD          = 56, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ALT_LEFT        = 57, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ALT_RIGHT       = 58, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SHIFT_LEFT      = 59, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SHIFT_RIGHT     = 60, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_TAB             = 61, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SPACE           = 62, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SYM             = 63, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_EXPLORER        = 64, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ENVELOPE        = 65, */
-  CLUTTER_KEY_Return, /* AKEYCODE_ENTER           = 66, */
-  CLUTTER_KEY_BackSpace, /* AKEYCODE_DEL             = 67, */
-  CLUTTER_KEY_asciitilde, /* AKEYCODE_GRAVE           = 68, */
-  CLUTTER_KEY_underscore, /* AKEYCODE_MINUS           = 69, */
-  CLUTTER_KEY_plus, /* AKEYCODE_EQUALS          = 70, */
-  CLUTTER_KEY_braceleft, /* AKEYCODE_LEFT_BRACKET    = 71, */
-  CLUTTER_KEY_braceright, /* AKEYCODE_RIGHT_BRACKET   = 72, */
-  CLUTTER_KEY_vertbar, /* AKEYCODE_BACKSLASH       = 73, */
-  CLUTTER_KEY_colon, /* AKEYCODE_SEMICOLON       = 74, */
-  CLUTTER_KEY_quotedbl, /* AKEYCODE_APOSTROPHE      = 75, */
-  CLUTTER_KEY_question, /* AKEYCODE_SLASH           = 76, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_AT              = 77, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_NUM             = 78, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_HEADSETHOOK     = 79, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_FOCUS           = 80,   // *Camera* focus */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PLUS            = 81, */
-  CLUTTER_KEY_Menu, /* AKEYCODE_MENU            = 82, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_NOTIFICATION    = 83, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SEARCH          = 84, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_PLAY_PAUSE= 85, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_STOP      = 86, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_NEXT      = 87, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_PREVIOUS  = 88, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_REWIND    = 89, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_FAST_FORWARD = 90, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MUTE            = 91, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PAGE_UP         = 92, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PAGE_DOWN       = 93, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PICTSYMBOLS     = 94, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SWITCH_CHARSET  = 95, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_A        = 96, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_B        = 97, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_C        = 98, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_X        = 99, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_Y        = 100, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_Z        = 101, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_L1       = 102, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_R1       = 103, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_L2       = 104, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_R2       = 105, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_THUMBL   = 106, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_THUMBR   = 107, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_START    = 108, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_SELECT   = 109, */
-  CLUTTER_KEY_VoidSymbol /* AKEYCODE_BUTTON_MODE     = 110, */
-};
-
-static const guint alted_keycodes[AKEYCODE_BUTTON_MODE + 1] = {
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_UNKNOWN         = 0, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SOFT_LEFT       = 1, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SOFT_RIGHT      = 2, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_HOME            = 3, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BACK            = 4, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CALL            = 5, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ENDCALL         = 6, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_0               = 7, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_1               = 8, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_2               = 9, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_3               = 10, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_4               = 11, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_5               = 12, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_6               = 13, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_7               = 14, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_8               = 15, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_9               = 16, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_STAR            = 17, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_POUND           = 18, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_UP         = 19, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_DOWN       = 20, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_LEFT       = 21, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_RIGHT      = 22, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DPAD_CENTER     = 23, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_VOLUME_UP       = 24, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_VOLUME_DOWN     = 25, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_POWER           = 26, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CAMERA          = 27, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_CLEAR           = 28, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_A               = 29, */
-  CLUTTER_KEY_less, /* AKEYCODE_B               = 30, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_C               = 31, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_D               = 32, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_E               = 33, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_F               = 34, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_G               = 35, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_H               = 36, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_I               = 37, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_J               = 38, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_K               = 39, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_L               = 40, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_M               = 41, */
-  CLUTTER_KEY_greater, /* AKEYCODE_N               = 42, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_O               = 43, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_P               = 44, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_Q               = 45, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_R               = 46, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_S               = 47, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_T               = 48, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_U               = 49, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_V               = 50, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_W               = 51, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_X               = 52, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_Y               = 53, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_Z               = 54, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_COMMA           = 55, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PERIOD          = 56, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ALT_LEFT        = 57, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ALT_RIGHT       = 58, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SHIFT_LEFT      = 59, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SHIFT_RIGHT     = 60, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_TAB             = 61, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SPACE           = 62, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SYM             = 63, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_EXPLORER        = 64, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ENVELOPE        = 65, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_ENTER           = 66, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_DEL             = 67, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_GRAVE           = 68, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MINUS           = 69, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_EQUALS          = 70, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_LEFT_BRACKET    = 71, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_RIGHT_BRACKET   = 72, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BACKSLASH       = 73, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SEMICOLON       = 74, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_APOSTROPHE      = 75, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SLASH           = 76, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_AT              = 77, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_NUM             = 78, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_HEADSETHOOK     = 79, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_FOCUS           = 80,   // *Camera* focus */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PLUS            = 81, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MENU            = 82, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_NOTIFICATION    = 83, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SEARCH          = 84, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_PLAY_PAUSE= 85, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_STOP      = 86, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_NEXT      = 87, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_PREVIOUS  = 88, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_REWIND    = 89, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MEDIA_FAST_FORWARD = 90, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_MUTE            = 91, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PAGE_UP         = 92, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PAGE_DOWN       = 93, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_PICTSYMBOLS     = 94, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_SWITCH_CHARSET  = 95, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_A        = 96, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_B        = 97, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_C        = 98, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_X        = 99, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_Y        = 100, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_Z        = 101, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_L1       = 102, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_R1       = 103, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_L2       = 104, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_R2       = 105, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_THUMBL   = 106, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_THUMBR   = 107, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_START    = 108, */
-  CLUTTER_KEY_VoidSymbol, /* AKEYCODE_BUTTON_SELECT   = 109, */
-  CLUTTER_KEY_VoidSymbol /* AKEYCODE_BUTTON_MODE     = 110, */
+/* the key symbols of each key code, without modifiers, with the shift
+ * modifier, and with the alt modifier; keeping the three together means
+ * that the translation of a key only reads one row of the table
+ */
+static const struct {
+  guint keyval;
+  guint shifted_keyval;
+  guint alted_keyval;
+} keycodes[AKEYCODE_BUTTON_MODE + 1] = {
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_UNKNOWN = 0 */
+  { CLUTTER_KEY_Left, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SOFT_LEFT = 1 */
+  { CLUTTER_KEY_Right, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SOFT_RIGHT = 2 */
+  { CLUTTER_KEY_Home, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_HOME = 3 */
+  { CLUTTER_KEY_Back, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BACK = 4 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_CALL = 5 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_ENDCALL = 6 */
+  { CLUTTER_KEY_0, CLUTTER_KEY_parenright, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_0 = 7 */
+  { CLUTTER_KEY_1, CLUTTER_KEY_exclam, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_1 = 8 */
+  { CLUTTER_KEY_2, CLUTTER_KEY_at, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_2 = 9 */
+  { CLUTTER_KEY_3, CLUTTER_KEY_numbersign, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_3 = 10 */
+  { CLUTTER_KEY_4, CLUTTER_KEY_dollar, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_4 = 11 */
+  { CLUTTER_KEY_5, CLUTTER_KEY_percent, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_5 = 12 */
+  { CLUTTER_KEY_6, CLUTTER_KEY_upcaret, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_6 = 13 */
+  { CLUTTER_KEY_7, CLUTTER_KEY_ampersand, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_7 = 14 */
+  { CLUTTER_KEY_8, CLUTTER_KEY_asterisk, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_8 = 15 */
+  { CLUTTER_KEY_9, CLUTTER_KEY_parenleft, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_9 = 16 */
+  { CLUTTER_KEY_asterisk, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_STAR = 17 */
+  { CLUTTER_KEY_ssharp, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_POUND = 18 */
+  { CLUTTER_KEY_KP_Up, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_DPAD_UP = 19 */
+  { CLUTTER_KEY_KP_Down, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_DPAD_DOWN = 20 */
+  { CLUTTER_KEY_KP_Left, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_DPAD_LEFT = 21 */
+  { CLUTTER_KEY_KP_Right, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_DPAD_RIGHT = 22 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_DPAD_CENTER = 23 */
+  { CLUTTER_KEY_AudioRaiseVolume, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_VOLUME_UP = 24 */
+  { CLUTTER_KEY_AudioLowerVolume, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_VOLUME_DOWN = 25 */
+  { CLUTTER_KEY_PowerOff, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_POWER = 26 */
+  { CLUTTER_KEY_WebCam, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_CAMERA = 27 */
+  { CLUTTER_KEY_Clear, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_CLEAR = 28 */
+  { CLUTTER_KEY_a, CLUTTER_KEY_A, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_A = 29 */
+  { CLUTTER_KEY_b, CLUTTER_KEY_B, CLUTTER_KEY_less }, /* AKEYCODE_B = 30 */
+  { CLUTTER_KEY_c, CLUTTER_KEY_C, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_C = 31 */
+  { CLUTTER_KEY_d, CLUTTER_KEY_D, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_D = 32 */
+  { CLUTTER_KEY_e, CLUTTER_KEY_E, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_E = 33 */
+  { CLUTTER_KEY_f, CLUTTER_KEY_F, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_F = 34 */
+  { CLUTTER_KEY_g, CLUTTER_KEY_G, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_G = 35 */
+  { CLUTTER_KEY_h, CLUTTER_KEY_H, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_H = 36 */
+  { CLUTTER_KEY_i, CLUTTER_KEY_I, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_I = 37 */
+  { CLUTTER_KEY_j, CLUTTER_KEY_J, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_J = 38 */
+  { CLUTTER_KEY_k, CLUTTER_KEY_K, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_K = 39 */
+  { CLUTTER_KEY_l, CLUTTER_KEY_L, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_L = 40 */
+  { CLUTTER_KEY_m, CLUTTER_KEY_M, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_M = 41 */
+  { CLUTTER_KEY_n, CLUTTER_KEY_N, CLUTTER_KEY_greater }, /* AKEYCODE_N = 42 */
+  { CLUTTER_KEY_o, CLUTTER_KEY_O, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_O = 43 */
+  { CLUTTER_KEY_p, CLUTTER_KEY_P, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_P = 44 */
+  { CLUTTER_KEY_q, CLUTTER_KEY_Q, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_Q = 45 */
+  { CLUTTER_KEY_r, CLUTTER_KEY_R, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_R = 46 */
+  { CLUTTER_KEY_s, CLUTTER_KEY_S, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_S = 47 */
+  { CLUTTER_KEY_t, CLUTTER_KEY_T, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_T = 48 */
+  { CLUTTER_KEY_u, CLUTTER_KEY_U, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_U = 49 */
+  { CLUTTER_KEY_v, CLUTTER_KEY_V, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_V = 50 */
+  { CLUTTER_KEY_w, CLUTTER_KEY_W, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_W = 51 */
+  { CLUTTER_KEY_x, CLUTTER_KEY_X, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_X = 52 */
+  { CLUTTER_KEY_y, CLUTTER_KEY_Y, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_Y = 53 */
+  { CLUTTER_KEY_z, CLUTTER_KEY_Z, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_Z = 54 */
+  { CLUTTER_KEY_comma, CLUTTER_KEY_less, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_COMMA = 55 */
+  { CLUTTER_KEY_period, CLUTTER_KEY_period, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_PERIOD = 56 */
+  { CLUTTER_KEY_Alt_L, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_ALT_LEFT = 57 */
+  { CLUTTER_KEY_Alt_R, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_ALT_RIGHT = 58 */
+  { CLUTTER_KEY_Shift_L, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SHIFT_LEFT = 59 */
+  { CLUTTER_KEY_Shift_R, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SHIFT_RIGHT = 60 */
+  { CLUTTER_KEY_Tab, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_TAB = 61 */
+  { CLUTTER_KEY_space, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SPACE = 62 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SYM = 63 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_EXPLORER = 64 */
+  { CLUTTER_KEY_Mail, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_ENVELOPE = 65 */
+  { CLUTTER_KEY_Return, CLUTTER_KEY_Return, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_ENTER = 66 */
+  { CLUTTER_KEY_BackSpace, CLUTTER_KEY_BackSpace, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_DEL = 67 */
+  { CLUTTER_KEY_grave, CLUTTER_KEY_asciitilde, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_GRAVE = 68 */
+  { CLUTTER_KEY_minus, CLUTTER_KEY_underscore, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MINUS = 69 */
+  { CLUTTER_KEY_equal, CLUTTER_KEY_plus, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_EQUALS = 70 */
+  { CLUTTER_KEY_bracketleft, CLUTTER_KEY_braceleft, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_LEFT_BRACKET = 71 */
+  { CLUTTER_KEY_bracketright, CLUTTER_KEY_braceright, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_RIGHT_BRACKET = 72 */
+  { CLUTTER_KEY_backslash, CLUTTER_KEY_vertbar, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BACKSLASH = 73 */
+  { CLUTTER_KEY_semicolon, CLUTTER_KEY_colon, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SEMICOLON = 74 */
+  { CLUTTER_KEY_apostrophe, CLUTTER_KEY_quotedbl, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_APOSTROPHE = 75 */
+  { CLUTTER_KEY_slash, CLUTTER_KEY_question, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SLASH = 76 */
+  { CLUTTER_KEY_at, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_AT = 77 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_NUM = 78 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_HEADSETHOOK = 79 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_FOCUS = 80 // *Camera* focus */
+  { CLUTTER_KEY_plus, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_PLUS = 81 */
+  { CLUTTER_KEY_Menu, CLUTTER_KEY_Menu, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MENU = 82 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_NOTIFICATION = 83 */
+  { CLUTTER_KEY_Search, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SEARCH = 84 */
+  { CLUTTER_KEY_AudioPlay, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MEDIA_PLAY_PAUSE = 85 */
+  { CLUTTER_KEY_AudioStop, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MEDIA_STOP = 86 */
+  { CLUTTER_KEY_AudioNext, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MEDIA_NEXT = 87 */
+  { CLUTTER_KEY_AudioPrev, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MEDIA_PREVIOUS = 88 */
+  { CLUTTER_KEY_AudioRewind, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MEDIA_REWIND = 89 */
+  { CLUTTER_KEY_Forward, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MEDIA_FAST_FORWARD = 90 */
+  { CLUTTER_KEY_AudioMute, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_MUTE = 91 */
+  { CLUTTER_KEY_Page_Up, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_PAGE_UP = 92 */
+  { CLUTTER_KEY_Page_Down, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_PAGE_DOWN = 93 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_PICTSYMBOLS = 94 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_SWITCH_CHARSET = 95 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_A = 96 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_B = 97 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_C = 98 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_X = 99 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_Y = 100 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_Z = 101 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_L1 = 102 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_R1 = 103 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_L2 = 104 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_R2 = 105 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_THUMBL = 106 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_THUMBR = 107 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_START = 108 */
+  { CLUTTER_KEY_Select, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol }, /* AKEYCODE_BUTTON_SELECT = 109 */
+  { CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol, CLUTTER_KEY_VoidSymbol } /* AKEYCODE_BUTTON_MODE = 110 */
 };
 
 static ClutterModifierType
@@ -396,11 +176,11 @@ _clutter_android_translate_key_event (ClutterKeyEvent *event,
     }
 
   if (modifier_state & AMETA_SHIFT_ON)
-    event->keyval = shifted_keycodes[keycode];
+    event->keyval = keycodes[keycode].shifted_keyval;
   else if (modifier_state & AMETA_ALT_ON)
-    event->keyval = alted_keycodes[keycode];
+    event->keyval = keycodes[keycode].alted_keyval;
   else
-    event->keyval = keycodes[keycode];
+    event->keyval = keycodes[keycode].keyval;
 
   event->modifier_state = _translate_modifier_state (modifier_state);
   event->unicode_value = clutter_keysym_to_unicode (event->keyval);
@@ -30,6 +30,7 @@
 G_BEGIN_DECLS
 
 #include <clutter/android/clutter-android-application.h>
+#include <clutter/android/clutter-android-hardware-buffer.h>
 
 G_END_DECLS
 
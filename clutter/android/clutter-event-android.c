@@ -29,33 +29,181 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/eventfd.h>
 
 #include <glib.h>
 
+#include "clutter-debug.h"
 #include "clutter-event-private.h"
 #include "clutter-main.h"
 #include "clutter-private.h"
 
 #include "clutter-event-android.h"
 
+/* the number of events that can be pushed by the input thread before
+ * the main loop dispatches them; must be a power of two
+ */
+#define EVENT_RING_SIZE 256
+#define EVENT_RING_MASK (EVENT_RING_SIZE - 1)
+
+typedef struct _EventSlot
+{
+  /* the position of the slot in the ring when it is empty, and that
+   * position plus one once the event has been stored
+   */
+  volatile gint sequence;
+
+  ClutterEvent *event;
+} EventSlot;
 
 typedef struct _ClutterEventSourceAndroid
 {
   GSource source;
   GPollFD pfd;
 
-  int pipe[2];
+  /* bounded multiple producers, single consumer queue of the events
+   * pushed from the input thread; the consumer is the main loop
+   */
+  EventSlot ring[EVENT_RING_SIZE];
+  volatile gint enqueue_pos;
+  gint dequeue_pos;
+
+  /* set when the eventfd has been signalled, until the dispatch */
+  volatile gint wakeup_pending;
+
+  /* the events pushed while the ring was full; once an event has been
+   * queued here, the following ones are queued here as well until the
+   * next dispatch, to keep them ordered
+   */
+  GMutex overflow_lock;
+  GQueue overflow;
+  volatile gint overflow_active;
 } ClutterEventSourceAndroid;
 
+static gboolean
+event_ring_push (ClutterEventSourceAndroid *source,
+                 ClutterEvent              *event)
+{
+  EventSlot *slot;
+  gint pos;
+
+  pos = g_atomic_int_get (&source->enqueue_pos);
+
+  for (;;)
+    {
+      gint diff;
+
+      slot = &source->ring[pos & EVENT_RING_MASK];
+      diff = (gint) ((guint) g_atomic_int_get (&slot->sequence) - (guint) pos);
+
+      if (diff == 0)
+        {
+          /* the slot is free, try to claim it */
+          if (g_atomic_int_compare_and_exchange (&source->enqueue_pos,
+                                                 pos, pos + 1))
+            break;
+        }
+      else if (diff < 0)
+        {
+          /* the consumer did not release the slot yet */
+          return FALSE;
+        }
+
+      pos = g_atomic_int_get (&source->enqueue_pos);
+    }
+
+  slot->event = event;
+
+  /* publish the event to the consumer */
+  g_atomic_int_set (&slot->sequence, pos + 1);
+
+  return TRUE;
+}
+
+static ClutterEvent *
+event_ring_pop (ClutterEventSourceAndroid *source)
+{
+  EventSlot *slot = &source->ring[source->dequeue_pos & EVENT_RING_MASK];
+  ClutterEvent *event;
+  gint diff;
+
+  diff = (gint) ((guint) g_atomic_int_get (&slot->sequence) -
+                 (guint) (source->dequeue_pos + 1));
+  if (diff < 0)
+    return NULL;
+
+  event = slot->event;
+  slot->event = NULL;
+
+  /* release the slot for the next lap of the producers */
+  g_atomic_int_set (&slot->sequence, source->dequeue_pos + EVENT_RING_SIZE);
+  source->dequeue_pos += 1;
+
+  return event;
+}
+
+/* does not need to take the Clutter lock; must be called from the
+ * thread dispatching the source
+ */
+static gboolean
+event_source_has_pushed_events (ClutterEventSourceAndroid *source)
+{
+  EventSlot *slot = &source->ring[source->dequeue_pos & EVENT_RING_MASK];
+
+  return g_atomic_int_get (&slot->sequence) == source->dequeue_pos + 1 ||
+         g_atomic_int_get (&source->overflow_active);
+}
+
+static void
+event_source_wakeup (ClutterEventSourceAndroid *source)
+{
+  const guint64 one = 1;
+
+  /* one wakeup for all the events pushed until the next dispatch */
+  if (!g_atomic_int_compare_and_exchange (&source->wakeup_pending, 0, 1))
+    return;
+
+  if (write (source->pfd.fd, &one, sizeof (one)) != sizeof (one))
+    g_warning ("Unable to wake up the event source");
+}
+
+/* moves all the events pushed by the input thread to the Clutter
+ * events queue, in the order they were pushed
+ */
+static void
+event_source_flush_pushed_events (ClutterEventSourceAndroid *source)
+{
+  ClutterEvent *event;
+
+  while ((event = event_ring_pop (source)) != NULL)
+    _clutter_event_push (event, FALSE);
+
+  if (!g_atomic_int_get (&source->overflow_active))
+    return;
+
+  g_mutex_lock (&source->overflow_lock);
+
+  while ((event = g_queue_pop_head (&source->overflow)) != NULL)
+    _clutter_event_push (event, FALSE);
+
+  g_atomic_int_set (&source->overflow_active, 0);
+
+  g_mutex_unlock (&source->overflow_lock);
+}
+
 static gboolean
 clutter_event_source_android_prepare (GSource *base, gint *timeout)
 {
+  ClutterEventSourceAndroid *source = (ClutterEventSourceAndroid *) base;
   gboolean retval;
 
-  _clutter_threads_acquire_lock ();
-
   *timeout = -1;
 
+  if (event_source_has_pushed_events (source))
+    return TRUE;
+
+  _clutter_threads_acquire_lock ();
+
   retval = clutter_events_pending ();
 
   _clutter_threads_release_lock ();
@@ -66,12 +214,15 @@ clutter_event_source_android_prepare (GSource *base, gint *timeout)
 static gboolean
 clutter_event_source_android_check (GSource *base)
 {
-  gboolean retval;
   ClutterEventSourceAndroid *source = (ClutterEventSourceAndroid *) base;
+  gboolean retval;
+
+  if (source->pfd.revents || event_source_has_pushed_events (source))
+    return TRUE;
 
   _clutter_threads_acquire_lock ();
 
-  retval = clutter_events_pending () || source->pfd.revents;
+  retval = clutter_events_pending ();
 
   _clutter_threads_release_lock ();
 
@@ -84,20 +235,38 @@ clutter_event_source_android_dispatch (GSource *base,
 				       gpointer data)
 {
   ClutterEventSourceAndroid *source = (ClutterEventSourceAndroid *) base;
+  ClutterMainContext *context;
   ClutterEvent *event;
-  int dummy;
-
-  _clutter_threads_acquire_lock ();
-
-  event = clutter_event_get ();
+  guint n_events;
 
   if (source->pfd.revents)
     {
-      read (source->pipe[0], &dummy, sizeof (dummy));
+      guint64 counter;
+
+      if (read (source->pfd.fd, &counter, sizeof (counter)) < 0)
+        CLUTTER_NOTE (EVENT, "Spurious event source wakeup");
+
       source->pfd.revents = 0;
     }
 
-  if (event)
+  /* the events pushed after this point need a new wakeup */
+  g_atomic_int_set (&source->wakeup_pending, 0);
+
+  _clutter_threads_acquire_lock ();
+
+  event_source_flush_pushed_events (source);
+
+  /* only dispatch the events queued so far, as the handlers might
+   * queue new ones
+   */
+  context = _clutter_context_get_default ();
+  n_events = context->events_queue != NULL
+           ? g_queue_get_length (context->events_queue)
+           : 0;
+
+  CLUTTER_NOTE (EVENT, "Dispatching %u events", n_events);
+
+  while (n_events-- > 0 && (event = clutter_event_get ()) != NULL)
     {
       /* forward the event into clutter for emission etc. */
       clutter_do_event (event);
@@ -109,44 +278,84 @@ clutter_event_source_android_dispatch (GSource *base,
   return TRUE;
 }
 
+static void
+clutter_event_source_android_finalize (GSource *base)
+{
+  ClutterEventSourceAndroid *source = (ClutterEventSourceAndroid *) base;
+  ClutterEvent *event;
+
+  while ((event = event_ring_pop (source)) != NULL)
+    clutter_event_free (event);
+
+  g_queue_foreach (&source->overflow, (GFunc) clutter_event_free, NULL);
+  g_queue_clear (&source->overflow);
+  g_mutex_clear (&source->overflow_lock);
+
+  if (source->pfd.fd >= 0)
+    close (source->pfd.fd);
+}
+
 static GSourceFuncs clutter_event_source_android_funcs = {
     clutter_event_source_android_prepare,
     clutter_event_source_android_check,
     clutter_event_source_android_dispatch,
-    NULL
+    clutter_event_source_android_finalize
 };
 
 GSource *
 _clutter_event_source_android_new (void)
 {
   ClutterEventSourceAndroid *source;
+  gint i;
 
   source = (ClutterEventSourceAndroid *)
     g_source_new (&clutter_event_source_android_funcs,
                   sizeof (ClutterEventSourceAndroid));
 
-  if (pipe (source->pipe) == -1)
+  for (i = 0; i < EVENT_RING_SIZE; i++)
+    source->ring[i].sequence = i;
+
+  g_mutex_init (&source->overflow_lock);
+  g_queue_init (&source->overflow);
+
+  source->pfd.fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (source->pfd.fd == -1)
     {
-      g_critical ("Cannot not create a pipe for event source");
+      g_critical ("Cannot not create an eventfd for event source");
       g_source_unref (&source->source);
       return NULL;
     }
 
-  source->pfd.fd = source->pipe[0];
   source->pfd.events = G_IO_IN | G_IO_ERR;
   g_source_add_poll (&source->source, &source->pfd);
 
   return &source->source;
 }
 
+/*
+ * _clutter_event_source_android_push_event:
+ * @source: the Android event source
+ * @event: (transfer full): the event to push
+ *
+ * Pushes @event to be dispatched by @source. This function does not
+ * take the Clutter lock and can be called from any thread.
+ */
 void
 _clutter_event_source_android_push_event (GSource *source,
                                           ClutterEvent *event)
 {
   ClutterEventSourceAndroid *asource = (ClutterEventSourceAndroid *) source;
-  const int dummy = 42;
 
-  _clutter_event_push (event, FALSE);
+  if (g_atomic_int_get (&asource->overflow_active) ||
+      !event_ring_push (asource, event))
+    {
+      g_mutex_lock (&asource->overflow_lock);
+
+      g_atomic_int_set (&asource->overflow_active, 1);
+      g_queue_push_tail (&asource->overflow, event);
+
+      g_mutex_unlock (&asource->overflow_lock);
+    }
 
-  write (asource->pipe[1], &dummy, sizeof (dummy));
+  event_source_wakeup (asource);
 }
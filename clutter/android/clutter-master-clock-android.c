@@ -0,0 +1,689 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * SECTION:clutter-master-clock-android
+ * @short_description: The Android master clock for all animations
+ *
+ * The #ClutterMasterClockAndroid class is the AChoreographer based
+ * implementation of #ClutterMasterClock.
+ *
+ * Frames are started from the choreographer frame callbacks, which are
+ * tied to the vertical refresh of the display, and the frame time they
+ * carry is used to advance the timelines. The clock only asks for a new
+ * callback while there is something to do: a running timeline, queued
+ * events or a stage that needs to be updated.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-master-clock-android.h"
+
+#ifdef CLUTTER_HAS_ANDROID_CHOREOGRAPHER
+
+#include <android/choreographer.h>
+
+#include "clutter-master-clock.h"
+#include "clutter-android-application-private.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+#include "clutter-stage-manager-private.h"
+#include "clutter-stage-private.h"
+
+#ifdef CLUTTER_ENABLE_DEBUG
+#define clutter_warn_if_over_budget(master_clock,start_time,section)    G_STMT_START  { \
+  gint64 __delta = g_get_monotonic_time () - start_time;                                \
+  gint64 __budget = master_clock->remaining_budget;                                     \
+  if (__budget > 0 && __delta >= __budget) {                                            \
+    _clutter_diagnostic_message ("%s took %" G_GINT64_FORMAT " microseconds "           \
+                                 "more than the remaining budget of %" G_GINT64_FORMAT  \
+                                 " microseconds",                                       \
+                                 section, __delta - __budget, __budget);                \
+  }                                                                     } G_STMT_END
+#else
+#define clutter_warn_if_over_budget(master_clock,start_time,section)
+#endif
+
+/* how long the animations must stay capped, in usecs, before the
+ * display is asked to lower its refresh rate; switching the mode of
+ * the display is not free, and the caps come and go with the input
+ */
+#define DISPLAY_RATE_DELAY      (G_USEC_PER_SEC / 2)
+
+struct _ClutterMasterClockAndroid
+{
+  GObject parent_instance;
+
+  /* the list of timelines handled by the clock */
+  GSList *timelines;
+
+  /* the choreographer of the thread running the main loop */
+  AChoreographer *choreographer;
+
+  /* the current state of the clock, in usecs */
+  gint64 cur_tick;
+
+  /* the previous state of the clock, in usecs, used to compute the delta */
+  gint64 prev_tick;
+
+  /* the frame rate requested from the display, or 0, and the time since
+   * which the animations have been capped at a different rate
+   */
+  guint display_frame_rate;
+  gint64 frame_rate_change_time;
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  gint64 frame_budget;
+  gint64 remaining_budget;
+
+  /* the number of frames in which the timelines were advanced without
+   * any stage needing an update
+   */
+  gulong frames_elided;
+#endif
+
+  /* TRUE if a frame callback has been posted and not yet run; the
+   * choreographer cannot cancel callbacks, so this is also used to
+   * avoid posting the same frame twice
+   */
+  guint callback_pending : 1;
+  guint ensure_next_iteration : 1;
+
+  guint paused : 1;
+};
+
+static void clutter_master_clock_iface_init (ClutterMasterClockIface *iface);
+
+#define clutter_master_clock_android_get_type   _clutter_master_clock_android_get_type
+
+G_DEFINE_TYPE_WITH_CODE (ClutterMasterClockAndroid,
+                         clutter_master_clock_android,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_MASTER_CLOCK,
+                                                clutter_master_clock_iface_init));
+
+/*
+ * master_clock_is_running:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Checks if we should currently be advancing timelines or redrawing
+ * stages.
+ *
+ * Return value: %TRUE if the #ClutterMasterClock needs a new frame
+ */
+static gboolean
+master_clock_is_running (ClutterMasterClockAndroid *master_clock)
+{
+  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+  const GSList *stages, *l;
+
+  if (master_clock->paused)
+    return FALSE;
+
+  if (master_clock->timelines != NULL)
+    return TRUE;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_CONTINUOUS_REDRAW))
+    return TRUE;
+
+  stages = clutter_stage_manager_peek_stages (stage_manager);
+
+  for (l = stages; l != NULL; l = l->next)
+    {
+      if (clutter_actor_is_mapped (l->data) &&
+          (_clutter_stage_has_queued_events (l->data) ||
+           _clutter_stage_needs_update (l->data)))
+        return TRUE;
+    }
+
+  if (master_clock->ensure_next_iteration)
+    {
+      master_clock->ensure_next_iteration = FALSE;
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*
+ * master_clock_get_frame_rate:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Computes the frame rate the clock needs to run at, which is the
+ * highest of the frame rates of the running timelines when all of
+ * them are capped, and no stage needs to be updated for another
+ * reason; see clutter_timeline_set_max_frame_rate().
+ *
+ * Return value: the frame rate, or 0 for the rate of the display
+ */
+static guint
+master_clock_get_frame_rate (ClutterMasterClockAndroid *master_clock)
+{
+  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+  const GSList *stages, *l;
+  guint frame_rate = 0;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_CONTINUOUS_REDRAW))
+    return 0;
+
+  for (l = master_clock->timelines; l != NULL; l = l->next)
+    {
+      guint timeline_rate = _clutter_timeline_get_max_frame_rate (l->data);
+
+      if (timeline_rate == 0)
+        return 0;
+
+      frame_rate = MAX (frame_rate, timeline_rate);
+    }
+
+  if (frame_rate == 0)
+    return 0;
+
+  stages = clutter_stage_manager_peek_stages (stage_manager);
+
+  for (l = stages; l != NULL; l = l->next)
+    {
+      if (clutter_actor_is_mapped (l->data) &&
+          (_clutter_stage_has_queued_events (l->data) ||
+           _clutter_stage_needs_update (l->data)))
+        return 0;
+    }
+
+  return frame_rate;
+}
+
+/* asks the display for a refresh rate matching the capped animations;
+ * the rate is raised at once, and lowered only once the animations
+ * have stayed capped for a while
+ */
+static void
+master_clock_update_display_rate (ClutterMasterClockAndroid *master_clock,
+                                  guint                      frame_rate)
+{
+  if (frame_rate == master_clock->display_frame_rate)
+    {
+      master_clock->frame_rate_change_time = 0;
+      return;
+    }
+
+  if (frame_rate != 0 &&
+      (master_clock->display_frame_rate == 0 ||
+       frame_rate < master_clock->display_frame_rate))
+    {
+      if (master_clock->frame_rate_change_time == 0)
+        master_clock->frame_rate_change_time = master_clock->cur_tick;
+
+      if (master_clock->cur_tick - master_clock->frame_rate_change_time < DISPLAY_RATE_DELAY)
+        return;
+    }
+
+  CLUTTER_NOTE (SCHEDULER, "Display frame rate going from %u to %u",
+                master_clock->display_frame_rate,
+                frame_rate);
+
+  master_clock->display_frame_rate = frame_rate;
+  master_clock->frame_rate_change_time = 0;
+
+  _clutter_android_application_set_frame_rate (clutter_android_application_get_default (),
+                                               frame_rate);
+}
+
+static void master_clock_frame_cb (int64_t  frame_time_nanos,
+                                   void    *data);
+
+#if __ANDROID_API__ < 29
+/* Before Android 10 the frame time is passed as a long, which wraps
+ * around every couple of seconds on 32 bit architectures; in that case
+ * we fall back to the time at which the callback is run
+ */
+static void
+master_clock_frame_cb_legacy (long  frame_time_nanos,
+                              void *data)
+{
+  if (sizeof (long) < sizeof (int64_t))
+    master_clock_frame_cb (g_get_monotonic_time () * 1000, data);
+  else
+    master_clock_frame_cb (frame_time_nanos, data);
+}
+#endif
+
+static void
+master_clock_request_frame (ClutterMasterClockAndroid *master_clock)
+{
+  if (master_clock->callback_pending)
+    return;
+
+  if (!master_clock_is_running (master_clock))
+    {
+      CLUTTER_NOTE (SCHEDULER, "Nothing to do, not requesting a frame");
+      return;
+    }
+
+  master_clock->callback_pending = TRUE;
+
+#if __ANDROID_API__ >= 29
+  AChoreographer_postFrameCallback64 (master_clock->choreographer,
+                                      master_clock_frame_cb,
+                                      master_clock);
+#else
+  AChoreographer_postFrameCallback (master_clock->choreographer,
+                                    master_clock_frame_cb_legacy,
+                                    master_clock);
+#endif
+}
+
+static GSList *
+master_clock_list_ready_stages (ClutterMasterClockAndroid *master_clock)
+{
+  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+  const GSList *stages, *l;
+  GSList *result;
+  gint64 now;
+
+  stages = clutter_stage_manager_peek_stages (stage_manager);
+
+  /* the frame time is the time of the vertical refresh, which is
+   * already in the past when the callback runs; stages that asked to
+   * be updated since then must not wait for the next frame
+   */
+  now = g_get_monotonic_time ();
+
+  result = NULL;
+  for (l = stages; l != NULL; l = l->next)
+    {
+      gint64 update_time = _clutter_stage_get_update_time (l->data);
+
+      /* a stage waiting for a swap to complete reports no update
+       * time; it will be updated by one of the next frames
+       */
+      if (clutter_actor_is_mapped (l->data) &&
+          update_time != -1 && update_time <= now)
+        result = g_slist_prepend (result, g_object_ref (l->data));
+    }
+
+  return g_slist_reverse (result);
+}
+
+static void
+master_clock_reschedule_stage_updates (ClutterMasterClockAndroid *master_clock,
+                                       GSList                    *stages)
+{
+  const GSList *l;
+
+  for (l = stages; l != NULL; l = l->next)
+    {
+      /* Clear the old update time */
+      _clutter_stage_clear_update_time (l->data);
+
+      /* And if there is still work to be done, schedule a new one */
+      if (master_clock->timelines ||
+          _clutter_stage_has_queued_events (l->data) ||
+          _clutter_stage_needs_update (l->data))
+        _clutter_stage_schedule_update (l->data);
+    }
+}
+
+static void
+master_clock_mark_stages (GSList           *stages,
+                          ClutterFrameMark  mark)
+{
+  GSList *l;
+
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_frame_info_mark (l->data, mark);
+}
+
+static void
+master_clock_process_events (ClutterMasterClockAndroid *master_clock,
+                             GSList                    *stages)
+{
+  GSList *l;
+#ifdef CLUTTER_ENABLE_DEBUG
+  gint64 start = g_get_monotonic_time ();
+#endif
+
+  /* Process queued events */
+  for (l = stages; l != NULL; l = l->next)
+    {
+      _clutter_stage_frame_info_begin (l->data, master_clock->cur_tick);
+
+      _clutter_stage_frame_info_mark (l->data, CLUTTER_FRAME_MARK_EVENTS_START);
+      _clutter_stage_process_queued_events (l->data);
+      _clutter_stage_frame_info_mark (l->data, CLUTTER_FRAME_MARK_EVENTS_END);
+    }
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled ())
+    clutter_warn_if_over_budget (master_clock, start, "Event processing");
+
+  master_clock->remaining_budget -= (g_get_monotonic_time () - start);
+#endif
+}
+
+/*
+ * master_clock_advance_timelines:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Advances all the timelines held by the master clock to the frame
+ * time of the current choreographer callback. This function should be
+ * called before calling _clutter_stage_do_update() to make sure that
+ * all the timelines are advanced and the scene is updated.
+ */
+static void
+master_clock_advance_timelines (ClutterMasterClockAndroid *master_clock)
+{
+  GSList *timelines, *l;
+#ifdef CLUTTER_ENABLE_DEBUG
+  gint64 start = g_get_monotonic_time ();
+#endif
+
+  /* see the comment in clutter-master-clock-default.c about why we
+   * iterate over a copy of the list holding references
+   */
+  timelines = g_slist_copy (master_clock->timelines);
+  g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
+
+  for (l = timelines; l != NULL; l = l->next)
+    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+
+  g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
+  g_slist_free (timelines);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled ())
+    clutter_warn_if_over_budget (master_clock, start, "Animations");
+
+  master_clock->remaining_budget -= (g_get_monotonic_time () - start);
+#endif
+}
+
+static gboolean
+master_clock_update_stages (ClutterMasterClockAndroid *master_clock,
+                            GSList                    *stages)
+{
+  gboolean stages_updated = FALSE;
+  GSList *l;
+#ifdef CLUTTER_ENABLE_DEBUG
+  gint64 start = g_get_monotonic_time ();
+#endif
+
+  _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_PRE_PAINT);
+
+  /* Update any stage that needs redraw/relayout after the clock
+   * is advanced.
+   */
+  for (l = stages; l != NULL; l = l->next)
+    stages_updated |= _clutter_stage_do_update (l->data);
+
+  _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_POST_PAINT);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled ())
+    clutter_warn_if_over_budget (master_clock, start, "Updating the stage");
+
+  master_clock->remaining_budget -= (g_get_monotonic_time () - start);
+#endif
+
+  return stages_updated;
+}
+
+static void
+master_clock_frame_cb (int64_t  frame_time_nanos,
+                       void    *data)
+{
+  ClutterMasterClockAndroid *master_clock = data;
+  gboolean stages_updated G_GNUC_UNUSED;
+  GSList *stages;
+  guint frame_rate;
+
+  _clutter_threads_acquire_lock ();
+
+  master_clock->callback_pending = FALSE;
+
+  if (master_clock->paused)
+    goto out;
+
+  CLUTTER_NOTE (SCHEDULER, "Master clock [tick]");
+
+  /* The frame time uses CLOCK_MONOTONIC, like g_get_monotonic_time() */
+  master_clock->cur_tick = frame_time_nanos / 1000;
+
+  /* when only capped timelines are running, the vblanks coming sooner
+   * than the interval of their frame rate are skipped; the slack
+   * accounts for the jitter of the vblanks
+   */
+  frame_rate = master_clock_get_frame_rate (master_clock);
+  master_clock_update_display_rate (master_clock, frame_rate);
+
+  if (frame_rate != 0 && master_clock->prev_tick != 0)
+    {
+      gint64 interval = G_USEC_PER_SEC / frame_rate;
+
+      if (master_clock->cur_tick - master_clock->prev_tick < interval - interval / 8)
+        {
+          master_clock_request_frame (master_clock);
+          goto out;
+        }
+    }
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  master_clock->remaining_budget = master_clock->frame_budget;
+#endif
+
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_CONTINUOUS_REDRAW))
+    {
+      ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+      const GSList *l;
+
+      /* Queue a full redraw on all of the stages */
+      for (l = clutter_stage_manager_peek_stages (stage_manager); l; l = l->next)
+        clutter_actor_queue_redraw (l->data);
+    }
+
+  stages = master_clock_list_ready_stages (master_clock);
+
+  /* Each frame is split into three separate phases: */
+
+  /* 1. process all the events; each stage goes through its events queue
+   *    and processes each event according to its type, then emits the
+   *    various signals that are associated with the event
+   */
+  master_clock_process_events (master_clock, stages);
+
+  /* 2. advance the timelines */
+  master_clock_mark_stages (stages, CLUTTER_FRAME_MARK_TIMELINES_START);
+  master_clock_advance_timelines (master_clock);
+  master_clock_mark_stages (stages, CLUTTER_FRAME_MARK_TIMELINES_END);
+
+  /* 3. relayout and redraw the stages */
+  stages_updated = master_clock_update_stages (master_clock, stages);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  /* the timelines did not change anything on screen, e.g. because the
+   * interpolated values were the same as in the previous frame
+   */
+  if (!stages_updated && master_clock->timelines != NULL)
+    {
+      master_clock->frames_elided += 1;
+
+      CLUTTER_NOTE (SCHEDULER, "Frame elided (total: %lu)",
+                    master_clock->frames_elided);
+    }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  master_clock_reschedule_stage_updates (master_clock, stages);
+
+  g_slist_foreach (stages, (GFunc) g_object_unref, NULL);
+  g_slist_free (stages);
+
+  master_clock->prev_tick = master_clock->cur_tick;
+
+  /* keep the callbacks coming only while there is work left */
+  master_clock_request_frame (master_clock);
+
+out:
+  _clutter_threads_release_lock ();
+}
+
+static gboolean
+master_clock_request_frame_idle (gpointer data)
+{
+  ClutterMasterClockAndroid *master_clock = data;
+
+  _clutter_threads_acquire_lock ();
+  master_clock_request_frame (master_clock);
+  _clutter_threads_release_lock ();
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Frame callbacks can only be posted from the thread owning the
+ * choreographer, so requests coming from other threads are bounced
+ * to the main loop
+ */
+static void
+master_clock_queue_request_frame (ClutterMasterClockAndroid *master_clock)
+{
+  if (g_main_context_is_owner (g_main_context_default ()))
+    master_clock_request_frame (master_clock);
+  else
+    g_main_context_invoke (NULL, master_clock_request_frame_idle, master_clock);
+}
+
+static void
+clutter_master_clock_android_finalize (GObject *gobject)
+{
+  ClutterMasterClockAndroid *master_clock = CLUTTER_MASTER_CLOCK_ANDROID (gobject);
+
+  g_slist_free (master_clock->timelines);
+
+  G_OBJECT_CLASS (clutter_master_clock_android_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_master_clock_android_class_init (ClutterMasterClockAndroidClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = clutter_master_clock_android_finalize;
+}
+
+static void
+clutter_master_clock_android_init (ClutterMasterClockAndroid *self)
+{
+  /* the master clock is created by the thread running the main loop,
+   * which is the one whose looper dispatches the callbacks
+   */
+  self->choreographer = AChoreographer_getInstance ();
+
+  self->callback_pending = FALSE;
+  self->ensure_next_iteration = FALSE;
+  self->paused = FALSE;
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  self->frame_budget = G_USEC_PER_SEC / 60;
+#endif
+}
+
+static void
+clutter_master_clock_android_add_timeline (ClutterMasterClock *clock,
+                                           ClutterTimeline    *timeline)
+{
+  ClutterMasterClockAndroid *master_clock = (ClutterMasterClockAndroid *) clock;
+  gboolean is_first;
+
+  if (g_slist_find (master_clock->timelines, timeline))
+    return;
+
+  is_first = master_clock->timelines == NULL;
+
+  master_clock->timelines = g_slist_prepend (master_clock->timelines,
+                                             timeline);
+
+  if (is_first)
+    {
+      ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+      const GSList *l;
+
+      for (l = clutter_stage_manager_peek_stages (stage_manager); l; l = l->next)
+        _clutter_stage_schedule_update (l->data);
+
+      _clutter_master_clock_start_running (clock);
+    }
+}
+
+static void
+clutter_master_clock_android_remove_timeline (ClutterMasterClock *clock,
+                                              ClutterTimeline    *timeline)
+{
+  ClutterMasterClockAndroid *master_clock = (ClutterMasterClockAndroid *) clock;
+
+  /* the pending callback, if any, will notice that there is nothing
+   * left to do and will not request another one
+   */
+  master_clock->timelines = g_slist_remove (master_clock->timelines,
+                                            timeline);
+
+  /* the clock may stop, so the display is not left at a lower rate */
+  if (master_clock->timelines == NULL)
+    master_clock_update_display_rate (master_clock, 0);
+}
+
+static void
+clutter_master_clock_android_start_running (ClutterMasterClock *clock)
+{
+  master_clock_queue_request_frame ((ClutterMasterClockAndroid *) clock);
+}
+
+static void
+clutter_master_clock_android_ensure_next_iteration (ClutterMasterClock *clock)
+{
+  ClutterMasterClockAndroid *master_clock = (ClutterMasterClockAndroid *) clock;
+
+  master_clock->ensure_next_iteration = TRUE;
+  master_clock_queue_request_frame (master_clock);
+}
+
+static void
+clutter_master_clock_android_set_paused (ClutterMasterClock *clock,
+                                         gboolean            paused)
+{
+  ClutterMasterClockAndroid *master_clock = (ClutterMasterClockAndroid *) clock;
+
+  master_clock->paused = !!paused;
+}
+
+static void
+clutter_master_clock_iface_init (ClutterMasterClockIface *iface)
+{
+  iface->add_timeline = clutter_master_clock_android_add_timeline;
+  iface->remove_timeline = clutter_master_clock_android_remove_timeline;
+  iface->start_running = clutter_master_clock_android_start_running;
+  iface->ensure_next_iteration = clutter_master_clock_android_ensure_next_iteration;
+  iface->set_paused = clutter_master_clock_android_set_paused;
+}
+
+#endif /* CLUTTER_HAS_ANDROID_CHOREOGRAPHER */
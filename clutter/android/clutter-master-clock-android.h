@@ -0,0 +1,52 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_MASTER_CLOCK_ANDROID_H__
+#define __CLUTTER_MASTER_CLOCK_ANDROID_H__
+
+#include <android/api-level.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/* AChoreographer is only available since Android 7.0 */
+#if __ANDROID_API__ >= 24
+#define CLUTTER_HAS_ANDROID_CHOREOGRAPHER 1
+#endif
+
+#define CLUTTER_TYPE_MASTER_CLOCK_ANDROID            (_clutter_master_clock_android_get_type ())
+#define CLUTTER_MASTER_CLOCK_ANDROID(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_MASTER_CLOCK_ANDROID, ClutterMasterClockAndroid))
+#define CLUTTER_IS_MASTER_CLOCK_ANDROID(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_MASTER_CLOCK_ANDROID))
+#define CLUTTER_MASTER_CLOCK_ANDROID_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_MASTER_CLOCK_ANDROID, ClutterMasterClockAndroidClass))
+
+typedef struct _ClutterMasterClockAndroid      ClutterMasterClockAndroid;
+typedef struct _ClutterMasterClockAndroidClass ClutterMasterClockAndroidClass;
+
+struct _ClutterMasterClockAndroidClass
+{
+  GObjectClass parent_class;
+};
+
+GType _clutter_master_clock_android_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* __CLUTTER_MASTER_CLOCK_ANDROID_H__ */
@@ -179,9 +179,35 @@ struct _CallyActorPrivate
   guint   action_idle_handler;
   GList  *action_list;
 
+  /* the children last reported through children-changed; only valid
+   * if children_walked is set and children_stale is not
+   */
   GList *children;
+
+  /* the children removed since the last flush, with a reference so
+   * that their address is not reused before the flush
+   */
+  GPtrArray *removed_children;
+
+  /* the extents in stage coordinates, valid until the actor changes
+   * or the next frame is painted
+   */
+  gint extents[4];
+  guint extents_serial;
+
+  guint children_walked : 1;
+  guint children_stale  : 1;
+  guint children_queued : 1;
 };
 
+/* the CallyActors with children changes to notify before the next paint */
+static GSList *pending_children_changes = NULL;
+static guint   children_changes_flush_id = 0;
+
+/* incremented after each frame, invalidating the cached extents */
+static guint   extents_serial = 1;
+static guint   extents_serial_func_id = 0;
+
 G_DEFINE_TYPE_WITH_CODE (CallyActor,
                          cally_actor,
                          ATK_TYPE_GOBJECT_ACCESSIBLE,
@@ -240,7 +266,8 @@ cally_actor_initialize (AtkObject *obj,
   g_object_set_data (G_OBJECT (obj), "atk-component-layer",
                      GINT_TO_POINTER (ATK_LAYER_MDI));
 
-  priv->children = clutter_actor_get_children (actor);
+  /* the children are only tracked once an AT client walks to them */
+  priv->children_stale = TRUE;
 
   /*
    * We store the handler ids for these signals in case some objects
@@ -299,6 +326,7 @@ cally_actor_init (CallyActor *cally_actor)
   priv->action_list = NULL;
 
   priv->children = NULL;
+  priv->removed_children = g_ptr_array_new_with_free_func (g_object_unref);
 }
 
 static void
@@ -323,6 +351,12 @@ cally_actor_finalize (GObject *obj)
       g_queue_free (priv->action_queue);
     }
 
+  if (priv->children_queued)
+    pending_children_changes = g_slist_remove (pending_children_changes,
+                                               cally_actor);
+
+  g_ptr_array_unref (priv->removed_children);
+
   if (priv->children)
     {
       g_list_free (priv->children);
@@ -487,6 +521,8 @@ cally_actor_get_n_children (AtkObject *obj)
 
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), 0);
 
+  _cally_actor_set_children_walked (CALLY_ACTOR (obj));
+
   return clutter_actor_get_n_children (actor);
 }
 
@@ -505,6 +541,8 @@ cally_actor_ref_child (AtkObject *obj,
 
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), NULL);
 
+  _cally_actor_set_children_walked (CALLY_ACTOR (obj));
+
   if (i >= clutter_actor_get_n_children (actor))
     return NULL;
 
@@ -564,29 +602,178 @@ cally_actor_remove_actor (ClutterActor *container,
 }
 
 
+/*
+ * Returns the accessible of @actor if it has been created already;
+ * the accessibles are created lazily, when an AT client walks to
+ * them, so this must not create it
+ */
+static AtkObject *
+cally_actor_peek_accessible (ClutterActor *actor)
+{
+  gpointer accessible;
+
+  /* the key used by atk_gobject_accessible_for_object() */
+  accessible = g_object_get_data (G_OBJECT (actor), "accessible-object");
+  if (accessible == NULL || !ATK_IS_OBJECT (accessible))
+    return NULL;
+
+  return accessible;
+}
+
+static void
+cally_actor_flush_children_changes (CallyActor *cally_actor)
+{
+  CallyActorPrivate *priv = cally_actor->priv;
+  AtkObject *atk_parent = ATK_OBJECT (cally_actor);
+  ClutterActor *actor;
+  GHashTable *reported;
+  GList *children, *l;
+  guint i;
+  gint index;
+
+  actor = CALLY_GET_CLUTTER_ACTOR (cally_actor);
+  if (actor == NULL) /* actor is defunct */
+    {
+      g_ptr_array_set_size (priv->removed_children, 0);
+      return;
+    }
+
+  /* the removals are reported with the index the child had in the
+   * list the AT client knows about
+   */
+  for (i = 0; i < priv->removed_children->len; i++)
+    {
+      ClutterActor *child = g_ptr_array_index (priv->removed_children, i);
+      GList *link = g_list_find (priv->children, child);
+
+      if (link == NULL)
+        continue;
+
+      index = g_list_position (priv->children, link);
+      priv->children = g_list_delete_link (priv->children, link);
+
+      g_signal_emit_by_name (atk_parent, "children_changed::remove",
+                             index, cally_actor_peek_accessible (child),
+                             NULL);
+    }
+
+  g_ptr_array_set_size (priv->removed_children, 0);
+
+  reported = g_hash_table_new (NULL, NULL);
+  for (l = priv->children; l != NULL; l = l->next)
+    g_hash_table_add (reported, l->data);
+
+  children = clutter_actor_get_children (actor);
+
+  for (l = children, index = 0; l != NULL; l = l->next, index++)
+    {
+      AtkObject *atk_child;
+
+      if (g_hash_table_contains (reported, l->data))
+        continue;
+
+      atk_child = clutter_actor_get_accessible (l->data);
+
+      g_object_notify (G_OBJECT (atk_child), "accessible_parent");
+      g_signal_emit_by_name (atk_parent, "children_changed::add",
+                             index, atk_child, NULL);
+    }
+
+  g_hash_table_unref (reported);
+
+  g_list_free (priv->children);
+  priv->children = children;
+}
+
+static gboolean
+cally_actor_flush_pending_children_changes (gpointer data G_GNUC_UNUSED)
+{
+  GSList *pending = g_slist_reverse (pending_children_changes);
+  GSList *l;
+
+  pending_children_changes = NULL;
+  children_changes_flush_id = 0;
+
+  for (l = pending; l != NULL; l = l->next)
+    CALLY_ACTOR (l->data)->priv->children_queued = FALSE;
+
+  /* the handlers of the signals can release the accessibles */
+  g_slist_foreach (pending, (GFunc) g_object_ref, NULL);
+
+  for (l = pending; l != NULL; l = l->next)
+    cally_actor_flush_children_changes (l->data);
+
+  g_slist_free_full (pending, g_object_unref);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* The children changes are coalesced, and notified once per frame */
+static void
+cally_actor_queue_children_changes (CallyActor *cally_actor)
+{
+  CallyActorPrivate *priv = cally_actor->priv;
+
+  if (priv->children_queued)
+    return;
+
+  priv->children_queued = TRUE;
+  pending_children_changes = g_slist_prepend (pending_children_changes,
+                                              cally_actor);
+
+  if (children_changes_flush_id == 0)
+    {
+      children_changes_flush_id =
+        clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                               CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                               cally_actor_flush_pending_children_changes,
+                                               NULL, NULL);
+    }
+}
+
+/*
+ * Marks the children of @cally_actor as known to an AT client; until
+ * then, the changes of the children are not notified, and their
+ * accessibles are not created
+ */
+void
+_cally_actor_set_children_walked (CallyActor *cally_actor)
+{
+  CallyActorPrivate *priv = cally_actor->priv;
+  ClutterActor *actor;
+
+  if (priv->children_walked && !priv->children_stale)
+    return;
+
+  actor = CALLY_GET_CLUTTER_ACTOR (cally_actor);
+  if (actor == NULL)
+    return;
+
+  priv->children_walked = TRUE;
+  priv->children_stale = FALSE;
+
+  g_list_free (priv->children);
+  priv->children = clutter_actor_get_children (actor);
+}
+
 static gint
 cally_actor_real_add_actor (ClutterActor *container,
                             ClutterActor *actor,
                             gpointer      data)
 {
-  AtkObject        *atk_parent = ATK_OBJECT (data);
-  AtkObject        *atk_child  = clutter_actor_get_accessible (actor);
-  CallyActor        *cally_actor = CALLY_ACTOR (atk_parent);
+  CallyActor        *cally_actor = CALLY_ACTOR (data);
   CallyActorPrivate *priv       = cally_actor->priv;
-  gint              index;
 
   g_return_val_if_fail (CLUTTER_IS_CONTAINER (container), 0);
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), 0);
 
-  g_object_notify (G_OBJECT (atk_child), "accessible_parent");
-
-  g_list_free (priv->children);
-
-  priv->children = clutter_actor_get_children (CLUTTER_ACTOR (container));
+  if (!priv->children_walked)
+    {
+      priv->children_stale = TRUE;
+      return 1;
+    }
 
-  index = g_list_index (priv->children, actor);
-  g_signal_emit_by_name (atk_parent, "children_changed::add",
-                         index, atk_child, NULL);
+  cally_actor_queue_children_changes (cally_actor);
 
   return 1;
 }
@@ -600,13 +787,12 @@ cally_actor_real_remove_actor (ClutterActor *container,
   AtkObject*         atk_parent  = NULL;
   AtkObject         *atk_child   = NULL;
   CallyActorPrivate  *priv        = NULL;
-  gint               index;
 
   g_return_val_if_fail (CLUTTER_IS_CONTAINER (container), 0);
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), 0);
 
   atk_parent = ATK_OBJECT (data);
-  atk_child = clutter_actor_get_accessible (actor);
+  atk_child = cally_actor_peek_accessible (actor);
 
   if (atk_child)
     {
@@ -622,14 +808,15 @@ cally_actor_real_remove_actor (ClutterActor *container,
     }
 
   priv = CALLY_ACTOR (atk_parent)->priv;
-  index = g_list_index (priv->children, actor);
-  g_list_free (priv->children);
 
-  priv->children = clutter_actor_get_children (CLUTTER_ACTOR (container));
+  if (!priv->children_walked)
+    {
+      priv->children_stale = TRUE;
+      return 1;
+    }
 
-  if (index >= 0 && index <= g_list_length (priv->children))
-    g_signal_emit_by_name (atk_parent, "children_changed::remove",
-                           index, atk_child, NULL);
+  g_ptr_array_add (priv->removed_children, g_object_ref (actor));
+  cally_actor_queue_children_changes (CALLY_ACTOR (atk_parent));
 
   return 1;
 }
@@ -647,6 +834,18 @@ cally_actor_component_interface_init (AtkComponentIface *iface)
   iface->grab_focus           = cally_actor_grab_focus;
 }
 
+static gboolean
+cally_actor_bump_extents_serial (gpointer data G_GNUC_UNUSED)
+{
+  extents_serial += 1;
+
+  /* 0 is never a valid serial */
+  if (extents_serial == 0)
+    extents_serial = 1;
+
+  return G_SOURCE_CONTINUE;
+}
+
 static void
 cally_actor_get_extents (AtkComponent *component,
                         gint         *x,
@@ -656,15 +855,18 @@ cally_actor_get_extents (AtkComponent *component,
                         AtkCoordType coord_type)
 {
   CallyActor   *cally_actor = NULL;
+  CallyActorPrivate *priv   = NULL;
   ClutterActor *actor      = NULL;
   gint          top_level_x, top_level_y;
-  gfloat        f_width, f_height;
+  gfloat        x_min, x_max, y_min, y_max;
   ClutterVertex verts[4];
   ClutterActor  *stage = NULL;
+  gint          i;
 
   g_return_if_fail (CALLY_IS_ACTOR (component));
 
   cally_actor = CALLY_ACTOR (component);
+  priv = cally_actor->priv;
   actor = CALLY_GET_CLUTTER_ACTOR (cally_actor);
 
   if (actor == NULL) /* actor is defunct */
@@ -676,13 +878,47 @@ cally_actor_get_extents (AtkComponent *component,
   if (stage == NULL)
     return;
 
-  clutter_actor_get_abs_allocation_vertices (actor, verts);
-  clutter_actor_get_transformed_size (actor, &f_width, &f_height);
+  /* AT clients query the extents of the same objects many times
+   * while they walk the tree; the stage transform of the actor is
+   * only computed once per frame
+   */
+  if (extents_serial_func_id == 0)
+    {
+      extents_serial_func_id =
+        clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_POST_PAINT,
+                                               cally_actor_bump_extents_serial,
+                                               NULL, NULL);
+    }
+
+  if (priv->extents_serial != extents_serial)
+    {
+      /* the transformed size is the size of the bounding box of the
+       * vertices, so we compute it from the same vertices
+       */
+      clutter_actor_get_abs_allocation_vertices (actor, verts);
+
+      x_min = x_max = verts[0].x;
+      y_min = y_max = verts[0].y;
 
-  *x = verts[0].x;
-  *y = verts[0].y;
-  *width = ceilf (f_width);
-  *height = ceilf (f_height);
+      for (i = 1; i < G_N_ELEMENTS (verts); i++)
+        {
+          x_min = MIN (x_min, verts[i].x);
+          x_max = MAX (x_max, verts[i].x);
+          y_min = MIN (y_min, verts[i].y);
+          y_max = MAX (y_max, verts[i].y);
+        }
+
+      priv->extents[0] = verts[0].x;
+      priv->extents[1] = verts[0].y;
+      priv->extents[2] = ceilf (x_max - x_min);
+      priv->extents[3] = ceilf (y_max - y_min);
+      priv->extents_serial = extents_serial;
+    }
+
+  *x = priv->extents[0];
+  *y = priv->extents[1];
+  *width = priv->extents[2];
+  *height = priv->extents[3];
 
   /* In the ATK_XY_WINDOW case, we consider the stage as the
    * "top-level-window"
@@ -989,6 +1225,9 @@ cally_actor_notify_clutter (GObject    *obj,
   cally_actor = CALLY_ACTOR (clutter_actor_get_accessible (CLUTTER_ACTOR (obj)));
   klass = CALLY_ACTOR_GET_CLASS (cally_actor);
 
+  /* any change of the actor can move it */
+  cally_actor->priv->extents_serial = 0;
+
   if (klass->notify_clutter)
     klass->notify_clutter (obj, pspec);
 }
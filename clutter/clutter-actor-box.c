@@ -5,6 +5,7 @@
 #include <math.h>
 
 #include "clutter-types.h"
+#include "clutter-box4-private.h"
 #include "clutter-interval.h"
 #include "clutter-private.h"
 
@@ -447,10 +448,8 @@ clutter_actor_box_clamp_to_pixel (ClutterActorBox *box)
 {
   g_return_if_fail (box != NULL);
 
-  box->x1 = floorf (box->x1);
-  box->y1 = floorf (box->y1);
-  box->x2 = ceilf (box->x2);
-  box->y2 = ceilf (box->y2);
+  _clutter_box4_to_actor_box (_clutter_box4_round_out (_clutter_box4_from_actor_box (box)),
+                              box);
 }
 
 /**
@@ -473,11 +472,9 @@ clutter_actor_box_union (const ClutterActorBox *a,
   g_return_if_fail (b != NULL);
   g_return_if_fail (result != NULL);
 
-  result->x1 = MIN (a->x1, b->x1);
-  result->y1 = MIN (a->y1, b->y1);
-
-  result->x2 = MAX (a->x2, b->x2);
-  result->y2 = MAX (a->y2, b->y2);
+  _clutter_box4_to_actor_box (_clutter_box4_union (_clutter_box4_from_actor_box (a),
+                                                   _clutter_box4_from_actor_box (b)),
+                              result);
 }
 
 static gboolean
@@ -43,6 +43,22 @@ typedef enum
   CLUTTER_REDRAW_CLIPPED_TO_ALLOCATION  = 1 << 0
 } ClutterRedrawFlags;
 
+/*< private >
+ * ClutterClientBufferType:
+ * @CLUTTER_CLIENT_BUFFER_NONE: the actor does not paint a client buffer
+ * @CLUTTER_CLIENT_BUFFER_WAYLAND: the buffer is the struct wl_resource
+ *   of a wl_buffer
+ * @CLUTTER_CLIENT_BUFFER_X11_PIXMAP: the buffer is the XID of a Pixmap
+ *
+ * The types of the client buffers that an actor can paint as its
+ * content, and that a stage window can present without painting them.
+ */
+typedef enum {
+  CLUTTER_CLIENT_BUFFER_NONE,
+  CLUTTER_CLIENT_BUFFER_WAYLAND,
+  CLUTTER_CLIENT_BUFFER_X11_PIXMAP
+} ClutterClientBufferType;
+
 /*< private >
  * ClutterActorTraverseFlags:
  * CLUTTER_ACTOR_TRAVERSE_DEPTH_FIRST: Traverse the graph in
@@ -114,6 +130,19 @@ typedef struct _SizeRequest             SizeRequest;
 typedef struct _ClutterLayoutInfo       ClutterLayoutInfo;
 typedef struct _ClutterTransformInfo    ClutterTransformInfo;
 typedef struct _ClutterAnimationInfo    ClutterAnimationInfo;
+typedef struct _ClutterMemoryUsage      ClutterMemoryUsage;
+
+/* the memory held by an actor, in bytes; see
+ * _clutter_actor_get_memory_usage()
+ */
+struct _ClutterMemoryUsage
+{
+  gsize offscreen_effects;
+  gsize images;
+  gsize canvases;
+  gsize text_layouts;
+  gsize paint_nodes;
+};
 
 /* Internal helper struct to represent a point that can be stored in
    either direct pixel coordinates or as a fraction of the actor's
@@ -224,6 +253,7 @@ typedef struct _AState {
   guint easing_duration;
   guint easing_delay;
   ClutterAnimationMode easing_mode;
+  gboolean easing_paint_time;
 } AState;
 
 struct _ClutterAnimationInfo
@@ -293,11 +323,20 @@ gboolean                        _clutter_actor_set_default_paint_volume
                                                                                          GType               check_gtype,
                                                                                          ClutterPaintVolume *volume);
 
+gboolean                        _clutter_actor_get_paint_clip_box                       (ClutterActor       *self,
+                                                                                         ClutterStage       *stage,
+                                                                                         ClutterActorBox    *box);
+
 const gchar *                   _clutter_actor_get_debug_name                           (ClutterActor *self);
 
 void                            _clutter_actor_push_clone_paint                         (void);
 void                            _clutter_actor_pop_clone_paint                          (void);
 
+void                            _clutter_actor_push_layer_paint                         (void);
+void                            _clutter_actor_pop_layer_paint                          (void);
+void                            _clutter_actor_set_paint_in_layer                       (ClutterActor *self,
+                                                                                         gboolean      in_layer);
+
 guint32                         _clutter_actor_get_pick_id                              (ClutterActor *self);
 
 void                            _clutter_actor_shader_pre_paint                         (ClutterActor *actor,
@@ -308,6 +347,8 @@ ClutterActorAlign               _clutter_actor_get_effective_x_align
 
 void                            _clutter_actor_handle_event                             (ClutterActor       *actor,
                                                                                          const ClutterEvent *event);
+void                            _clutter_actor_add_event_emission_hook                  (void);
+void                            _clutter_actor_remove_event_emission_hook               (void);
 
 void                            _clutter_actor_attach_clone                             (ClutterActor *actor,
                                                                                          ClutterActor *clone);
@@ -315,13 +356,80 @@ void                            _clutter_actor_detach_clone
                                                                                          ClutterActor *clone);
 void                            _clutter_actor_queue_redraw_on_clones                   (ClutterActor *actor);
 void                            _clutter_actor_queue_relayout_on_clones                 (ClutterActor *actor);
+guint                           _clutter_actor_get_clone_damage_serial                  (ClutterActor *self);
+
+void                            _clutter_actor_update_on_screen                         (ClutterActor *self);
+gboolean                        _clutter_actor_get_transitions_suspended                (ClutterActor *self);
+void                            _clutter_actor_evict_raster_cache                       (ClutterActor *self);
 void                            _clutter_actor_queue_only_relayout                      (ClutterActor *actor);
 
 CoglFramebuffer *               _clutter_actor_get_active_framebuffer                   (ClutterActor *actor);
 
+void                            _clutter_actor_paint_children                           (ClutterActor *self);
+void                            _clutter_actor_compute_occlusion                        (ClutterActor *stage);
+void                            _clutter_actor_begin_depth_pass                         (ClutterActor    *stage,
+                                                                                         CoglFramebuffer *framebuffer);
+void                            _clutter_actor_end_depth_pass                           (void);
+void                            _clutter_actor_set_client_buffer                        (ClutterActor            *self,
+                                                                                         ClutterClientBufferType  type,
+                                                                                         gpointer                 buffer);
+ClutterClientBufferType         _clutter_actor_get_client_buffer                        (ClutterActor            *self,
+                                                                                         gpointer                *buffer);
+ClutterActor *                  _clutter_actor_get_scanout_candidate                    (ClutterActor *stage);
+
+guint                           _clutter_actor_get_scalar_animatable_property           (ClutterActor *self,
+                                                                                         GParamSpec   *pspec);
+void                            _clutter_actor_set_scalar_animatable_property           (ClutterActor *self,
+                                                                                         guint         prop_id,
+                                                                                         GParamSpec   *pspec,
+                                                                                         gdouble       value);
+void                            _clutter_actor_relayout_boundary                        (ClutterActor *self);
+void                            _clutter_actor_add_constraint_dependent                 (ClutterActor      *self,
+                                                                                         ClutterConstraint *constraint);
+void                            _clutter_actor_remove_constraint_dependent              (ClutterActor      *self,
+                                                                                         ClutterConstraint *constraint);
+GPtrArray *                     _clutter_actor_peek_constraint_dependents               (ClutterActor *self);
+void                            _clutter_actor_update_constraints_allocation            (ClutterActor *self);
+gint                            _clutter_actor_get_children_age                         (ClutterActor *self);
+
+gboolean                        _clutter_actor_needs_size_request                       (ClutterActor       *self,
+                                                                                         ClutterOrientation  orientation,
+                                                                                         gfloat              for_size,
+                                                                                         gfloat             *class_for_size);
+void                            _clutter_actor_set_size_request                         (ClutterActor       *self,
+                                                                                         ClutterOrientation  orientation,
+                                                                                         gfloat              for_size,
+                                                                                         gfloat              minimum_size,
+                                                                                         gfloat              natural_size);
+
+gboolean                        _clutter_actor_queue_paint_time_sample                  (ClutterActor *self,
+                                                                                         guint         prop_id);
+void                            _clutter_actor_sample_paint_time_transitions            (ClutterActor *self,
+                                                                                         gint64        frame_time);
+
 ClutterPaintNode *              clutter_actor_create_texture_paint_node                 (ClutterActor *self,
                                                                                          CoglTexture  *texture);
 
+void                            _clutter_actor_restore_allocation                       (ClutterActor          *self,
+                                                                                         const ClutterActorBox *box);
+void                            _clutter_actor_set_animated_allocation                  (ClutterActor           *self,
+                                                                                         const ClutterActorBox  *box,
+                                                                                         ClutterAllocationFlags  flags);
+ClutterLayoutMeta *             _clutter_actor_get_layout_meta                          (ClutterActor           *self);
+void                            _clutter_actor_set_layout_meta                          (ClutterActor           *self,
+                                                                                         ClutterLayoutMeta      *meta);
+void                            _clutter_actor_release_resources                        (ClutterActor           *self,
+                                                                                         ClutterTrimMemoryFlags  flags);
+void                            _clutter_actor_get_memory_usage                         (ClutterActor       *self,
+                                                                                         GHashTable         *contents,
+                                                                                         ClutterMemoryUsage *usage);
+gboolean                        _clutter_actor_get_stage_transform_2d                   (ClutterActor   *self,
+                                                                                         cairo_matrix_t *matrix);
+
+void                            _clutter_actor_reset_paint_stats                        (void);
+void                            _clutter_actor_get_paint_stats                          (guint *n_painted,
+                                                                                         guint *n_culled);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ACTOR_PRIVATE_H__ */
@@ -0,0 +1,813 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* A snapshot stores the children of a #ClutterActor, recursively: their
+ * type, the properties that were changed from their default value, their
+ * layout manager, their allocation, and the URI of their #ClutterImage
+ * content, if it was loaded using clutter_image_load_from_uri_async().
+ *
+ * Restoring a snapshot recreates the actors without running the code
+ * that built them, and reuses the textures still held by the image
+ * cache; the restored allocations are used as the starting point of
+ * the next relayout, so the actors that end up in the same place are
+ * not allocated again.
+ *
+ * Snapshots are meant to survive the destruction of the user interface,
+ * not a change of the version of the application: they are only valid
+ * for the same build of Clutter and of the application.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gio/gio.h>
+
+#include "clutter-actor.h"
+#include "clutter-actor-private.h"
+#include "clutter-color.h"
+#include "clutter-debug.h"
+#include "clutter-image.h"
+#include "clutter-image-private.h"
+#include "clutter-layout-manager.h"
+#include "clutter-private.h"
+#include "clutter-script-private.h"
+#include "clutter-stage.h"
+
+#define SNAPSHOT_VERSION        1
+
+#define SNAPSHOT_ACTOR_FORMAT   "(sa{sv}bm(dddd)m(sii)m(sa{sv})av)"
+#define SNAPSHOT_FORMAT         "(uav)"
+
+typedef struct {
+  ClutterActor *actor;
+  ClutterActorBox allocation;
+} RestoredAllocation;
+
+/* the properties of ClutterActor that are saved; most of the others
+ * are either derived from the allocation or only meaningful together
+ * with the boolean property in @condition
+ */
+static const struct {
+  const gchar *name;
+  const gchar *condition;
+} actor_properties[] = {
+  { "name", NULL },
+  { "x", "fixed-position-set" },
+  { "y", "fixed-position-set" },
+  { "min-width", "min-width-set" },
+  { "min-height", "min-height-set" },
+  { "natural-width", "natural-width-set" },
+  { "natural-height", "natural-height-set" },
+  { "opacity", NULL },
+  { "reactive", NULL },
+  { "clip-to-allocation", NULL },
+  { "offscreen-redirect", NULL },
+  { "background-color", "background-color-set" },
+  { "x-expand", NULL },
+  { "y-expand", NULL },
+  { "x-align", NULL },
+  { "y-align", NULL },
+  { "margin-top", NULL },
+  { "margin-bottom", NULL },
+  { "margin-left", NULL },
+  { "margin-right", NULL },
+  { "pivot-point", NULL },
+  { "pivot-point-z", NULL },
+  { "scale-x", NULL },
+  { "scale-y", NULL },
+  { "scale-z", NULL },
+  { "rotation-angle-x", NULL },
+  { "rotation-angle-y", NULL },
+  { "rotation-angle-z", NULL },
+  { "translation-x", NULL },
+  { "translation-y", NULL },
+  { "translation-z", NULL },
+  { "z-position", NULL },
+  { "content-gravity", NULL },
+  { "content-repeat", NULL },
+  { "minification-filter", NULL },
+  { "magnification-filter", NULL },
+  { "text-direction", NULL },
+};
+
+/* the types of the actors might not have been registered yet; we use
+ * the same fallback as ClutterScript, and look up the get_type()
+ * function of the class
+ */
+static GType
+snapshot_get_type (const gchar *type_name)
+{
+  GType gtype = g_type_from_name (type_name);
+
+  if (gtype == G_TYPE_INVALID)
+    gtype = _clutter_script_get_type_from_class (type_name);
+
+  return gtype;
+}
+
+static GVariant *
+snapshot_value_to_variant (const GValue *value)
+{
+  GType value_type = G_VALUE_TYPE (value);
+
+  switch (G_TYPE_FUNDAMENTAL (value_type))
+    {
+    case G_TYPE_BOOLEAN:
+      return g_variant_new_boolean (g_value_get_boolean (value));
+
+    case G_TYPE_CHAR:
+      return g_variant_new_int32 (g_value_get_schar (value));
+
+    case G_TYPE_UCHAR:
+      return g_variant_new_uint32 (g_value_get_uchar (value));
+
+    case G_TYPE_INT:
+      return g_variant_new_int32 (g_value_get_int (value));
+
+    case G_TYPE_UINT:
+      return g_variant_new_uint32 (g_value_get_uint (value));
+
+    case G_TYPE_LONG:
+      return g_variant_new_int64 (g_value_get_long (value));
+
+    case G_TYPE_ULONG:
+      return g_variant_new_uint64 (g_value_get_ulong (value));
+
+    case G_TYPE_INT64:
+      return g_variant_new_int64 (g_value_get_int64 (value));
+
+    case G_TYPE_UINT64:
+      return g_variant_new_uint64 (g_value_get_uint64 (value));
+
+    case G_TYPE_FLOAT:
+      return g_variant_new_double (g_value_get_float (value));
+
+    case G_TYPE_DOUBLE:
+      return g_variant_new_double (g_value_get_double (value));
+
+    case G_TYPE_ENUM:
+      return g_variant_new_int32 (g_value_get_enum (value));
+
+    case G_TYPE_FLAGS:
+      return g_variant_new_uint32 (g_value_get_flags (value));
+
+    case G_TYPE_STRING:
+      {
+        const gchar *str = g_value_get_string (value);
+
+        if (str == NULL || !g_utf8_validate (str, -1, NULL))
+          return NULL;
+
+        return g_variant_new_string (str);
+      }
+
+    case G_TYPE_BOXED:
+      if (value_type == CLUTTER_TYPE_COLOR)
+        {
+          const ClutterColor *color = g_value_get_boxed (value);
+
+          if (color == NULL)
+            return NULL;
+
+          return g_variant_new_uint32 (clutter_color_to_pixel (color));
+        }
+      else if (value_type == CLUTTER_TYPE_POINT)
+        {
+          const ClutterPoint *point = g_value_get_boxed (value);
+
+          if (point == NULL)
+            return NULL;
+
+          return g_variant_new ("(dd)", point->x, point->y);
+        }
+      break;
+
+    default:
+      break;
+    }
+
+  return NULL;
+}
+
+static gboolean
+snapshot_variant_to_value (GVariant *variant,
+                           GValue   *value)
+{
+  GType value_type = G_VALUE_TYPE (value);
+
+#define CHECK_TYPE(t) \
+  G_STMT_START { \
+    if (!g_variant_is_of_type (variant, (t))) \
+      return FALSE; \
+  } G_STMT_END
+
+  switch (G_TYPE_FUNDAMENTAL (value_type))
+    {
+    case G_TYPE_BOOLEAN:
+      CHECK_TYPE (G_VARIANT_TYPE_BOOLEAN);
+      g_value_set_boolean (value, g_variant_get_boolean (variant));
+      return TRUE;
+
+    case G_TYPE_CHAR:
+      CHECK_TYPE (G_VARIANT_TYPE_INT32);
+      g_value_set_schar (value, g_variant_get_int32 (variant));
+      return TRUE;
+
+    case G_TYPE_UCHAR:
+      CHECK_TYPE (G_VARIANT_TYPE_UINT32);
+      g_value_set_uchar (value, g_variant_get_uint32 (variant));
+      return TRUE;
+
+    case G_TYPE_INT:
+      CHECK_TYPE (G_VARIANT_TYPE_INT32);
+      g_value_set_int (value, g_variant_get_int32 (variant));
+      return TRUE;
+
+    case G_TYPE_UINT:
+      CHECK_TYPE (G_VARIANT_TYPE_UINT32);
+      g_value_set_uint (value, g_variant_get_uint32 (variant));
+      return TRUE;
+
+    case G_TYPE_LONG:
+      CHECK_TYPE (G_VARIANT_TYPE_INT64);
+      g_value_set_long (value, g_variant_get_int64 (variant));
+      return TRUE;
+
+    case G_TYPE_ULONG:
+      CHECK_TYPE (G_VARIANT_TYPE_UINT64);
+      g_value_set_ulong (value, g_variant_get_uint64 (variant));
+      return TRUE;
+
+    case G_TYPE_INT64:
+      CHECK_TYPE (G_VARIANT_TYPE_INT64);
+      g_value_set_int64 (value, g_variant_get_int64 (variant));
+      return TRUE;
+
+    case G_TYPE_UINT64:
+      CHECK_TYPE (G_VARIANT_TYPE_UINT64);
+      g_value_set_uint64 (value, g_variant_get_uint64 (variant));
+      return TRUE;
+
+    case G_TYPE_FLOAT:
+      CHECK_TYPE (G_VARIANT_TYPE_DOUBLE);
+      g_value_set_float (value, g_variant_get_double (variant));
+      return TRUE;
+
+    case G_TYPE_DOUBLE:
+      CHECK_TYPE (G_VARIANT_TYPE_DOUBLE);
+      g_value_set_double (value, g_variant_get_double (variant));
+      return TRUE;
+
+    case G_TYPE_ENUM:
+      CHECK_TYPE (G_VARIANT_TYPE_INT32);
+      g_value_set_enum (value, g_variant_get_int32 (variant));
+      return TRUE;
+
+    case G_TYPE_FLAGS:
+      CHECK_TYPE (G_VARIANT_TYPE_UINT32);
+      g_value_set_flags (value, g_variant_get_uint32 (variant));
+      return TRUE;
+
+    case G_TYPE_STRING:
+      CHECK_TYPE (G_VARIANT_TYPE_STRING);
+      g_value_set_string (value, g_variant_get_string (variant, NULL));
+      return TRUE;
+
+    case G_TYPE_BOXED:
+      if (value_type == CLUTTER_TYPE_COLOR)
+        {
+          ClutterColor color;
+
+          CHECK_TYPE (G_VARIANT_TYPE_UINT32);
+          clutter_color_from_pixel (&color, g_variant_get_uint32 (variant));
+          g_value_set_boxed (value, &color);
+          return TRUE;
+        }
+      else if (value_type == CLUTTER_TYPE_POINT)
+        {
+          ClutterPoint point;
+          gdouble x, y;
+
+          CHECK_TYPE (G_VARIANT_TYPE ("(dd)"));
+          g_variant_get (variant, "(dd)", &x, &y);
+          clutter_point_init (&point, x, y);
+          g_value_set_boxed (value, &point);
+          return TRUE;
+        }
+      break;
+
+    default:
+      break;
+    }
+
+#undef CHECK_TYPE
+
+  return FALSE;
+}
+
+static void
+snapshot_add_property (GVariantBuilder *builder,
+                       GObject         *gobject,
+                       GParamSpec      *pspec,
+                       gboolean         skip_default)
+{
+  GValue value = G_VALUE_INIT;
+  GVariant *variant;
+
+  g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
+  g_object_get_property (gobject, pspec->name, &value);
+
+  if (!skip_default || !g_param_value_defaults (pspec, &value))
+    {
+      variant = snapshot_value_to_variant (&value);
+      if (variant != NULL)
+        g_variant_builder_add (builder, "{sv}", pspec->name, variant);
+    }
+
+  g_value_unset (&value);
+}
+
+/* saves the writable properties of @gobject that are not installed by
+ * @skip_type or its parents, and that do not have their default value
+ */
+static GVariant *
+snapshot_save_properties (GObject *gobject,
+                          GType    skip_type)
+{
+  GVariantBuilder builder;
+  GParamSpec **pspecs;
+  guint i, n_pspecs;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+
+  pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (gobject),
+                                           &n_pspecs);
+
+  for (i = 0; i < n_pspecs; i++)
+    {
+      GParamSpec *pspec = pspecs[i];
+
+      if ((pspec->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE ||
+          (pspec->flags & (G_PARAM_CONSTRUCT_ONLY | G_PARAM_DEPRECATED)) != 0)
+        continue;
+
+      if (skip_type != G_TYPE_INVALID && g_type_is_a (skip_type, pspec->owner_type))
+        continue;
+
+      snapshot_add_property (&builder, gobject, pspec, TRUE);
+    }
+
+  g_free (pspecs);
+
+  return g_variant_builder_end (&builder);
+}
+
+static void
+snapshot_restore_properties (GObject  *gobject,
+                             GVariant *properties)
+{
+  GObjectClass *klass = G_OBJECT_GET_CLASS (gobject);
+  GVariantIter iter;
+  const gchar *name;
+  GVariant *variant;
+
+  g_object_freeze_notify (gobject);
+
+  g_variant_iter_init (&iter, properties);
+  while (g_variant_iter_loop (&iter, "{&sv}", &name, &variant))
+    {
+      GValue value = G_VALUE_INIT;
+      GParamSpec *pspec;
+
+      pspec = g_object_class_find_property (klass, name);
+      if (pspec == NULL ||
+          (pspec->flags & G_PARAM_WRITABLE) == 0 ||
+          (pspec->flags & G_PARAM_CONSTRUCT_ONLY) != 0)
+        continue;
+
+      g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
+
+      if (snapshot_variant_to_value (variant, &value))
+        g_object_set_property (gobject, pspec->name, &value);
+      else
+        CLUTTER_NOTE (MISC, "Unable to restore the property '%s' of '%s'",
+                      name,
+                      G_OBJECT_TYPE_NAME (gobject));
+
+      g_value_unset (&value);
+    }
+
+  g_object_thaw_notify (gobject);
+}
+
+static GVariant *
+snapshot_save_actor (ClutterActor *actor)
+{
+  GVariantBuilder properties, children;
+  GObject *gobject = G_OBJECT (actor);
+  GObjectClass *klass = G_OBJECT_GET_CLASS (actor);
+  GVariant *allocation = NULL;
+  GVariant *content = NULL;
+  GVariant *layout = NULL;
+  ClutterLayoutManager *manager;
+  ClutterContent *actor_content;
+  ClutterActorIter iter;
+  ClutterActor *child;
+  GVariant *class_properties;
+  GVariantIter class_iter;
+  const gchar *name;
+  GVariant *value;
+  guint i;
+
+  g_variant_builder_init (&properties, G_VARIANT_TYPE_VARDICT);
+
+  for (i = 0; i < G_N_ELEMENTS (actor_properties); i++)
+    {
+      GParamSpec *pspec;
+
+      pspec = g_object_class_find_property (klass, actor_properties[i].name);
+      if (pspec == NULL)
+        continue;
+
+      if (actor_properties[i].condition != NULL)
+        {
+          gboolean is_set = FALSE;
+
+          g_object_get (gobject, actor_properties[i].condition, &is_set, NULL);
+
+          if (is_set)
+            snapshot_add_property (&properties, gobject, pspec, FALSE);
+        }
+      else
+        snapshot_add_property (&properties, gobject, pspec, TRUE);
+    }
+
+  /* the properties added by the subclasses */
+  class_properties = snapshot_save_properties (gobject, CLUTTER_TYPE_ACTOR);
+  g_variant_ref_sink (class_properties);
+
+  g_variant_iter_init (&class_iter, class_properties);
+  while (g_variant_iter_loop (&class_iter, "{&sv}", &name, &value))
+    g_variant_builder_add (&properties, "{sv}", name, value);
+
+  g_variant_unref (class_properties);
+
+  if (clutter_actor_has_allocation (actor))
+    {
+      ClutterActorBox box;
+
+      clutter_actor_get_allocation_box (actor, &box);
+      allocation = g_variant_new ("(dddd)", box.x1, box.y1, box.x2, box.y2);
+    }
+
+  actor_content = clutter_actor_get_content (actor);
+  if (CLUTTER_IS_IMAGE (actor_content))
+    {
+      const gchar *uri;
+      int width, height;
+
+      uri = _clutter_image_get_uri (CLUTTER_IMAGE (actor_content), &width, &height);
+      if (uri != NULL && g_utf8_validate (uri, -1, NULL))
+        content = g_variant_new ("(sii)", uri, width, height);
+    }
+
+  manager = clutter_actor_get_layout_manager (actor);
+  if (manager != NULL)
+    layout = g_variant_new ("(s@a{sv})",
+                            G_OBJECT_TYPE_NAME (manager),
+                            snapshot_save_properties (G_OBJECT (manager),
+                                                      G_TYPE_INVALID));
+
+  g_variant_builder_init (&children, G_VARIANT_TYPE ("av"));
+
+  clutter_actor_iter_init (&iter, actor);
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      /* the internal children are created by their parent */
+      if (CLUTTER_ACTOR_IS_INTERNAL_CHILD (child))
+        continue;
+
+      g_variant_builder_add (&children, "v", snapshot_save_actor (child));
+    }
+
+  return g_variant_new ("(s@a{sv}b@m(dddd)@m(sii)@m(sa{sv})@av)",
+                        G_OBJECT_TYPE_NAME (actor),
+                        g_variant_builder_end (&properties),
+                        CLUTTER_ACTOR_IS_VISIBLE (actor),
+                        g_variant_new_maybe (G_VARIANT_TYPE ("(dddd)"), allocation),
+                        g_variant_new_maybe (G_VARIANT_TYPE ("(sii)"), content),
+                        g_variant_new_maybe (G_VARIANT_TYPE ("(sa{sv})"), layout),
+                        g_variant_builder_end (&children));
+}
+
+static ClutterActor *
+snapshot_restore_actor (GVariant  *data,
+                        GArray    *allocations,
+                        GError   **error)
+{
+  GVariant *properties, *allocation, *content, *layout, *children;
+  const gchar *type_name;
+  gboolean visible;
+  ClutterActor *actor = NULL;
+  GType actor_type;
+
+  if (!g_variant_is_of_type (data, G_VARIANT_TYPE (SNAPSHOT_ACTOR_FORMAT)))
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                           "Invalid actor data in the snapshot");
+      return NULL;
+    }
+
+  g_variant_get (data, "(&s@a{sv}b@m(dddd)@m(sii)@m(sa{sv})@av)",
+                 &type_name,
+                 &properties,
+                 &visible,
+                 &allocation,
+                 &content,
+                 &layout,
+                 &children);
+
+  actor_type = snapshot_get_type (type_name);
+  if (actor_type == G_TYPE_INVALID ||
+      G_TYPE_IS_ABSTRACT (actor_type) ||
+      !g_type_is_a (actor_type, CLUTTER_TYPE_ACTOR) ||
+      g_type_is_a (actor_type, CLUTTER_TYPE_STAGE))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                   "Unable to restore an actor of type '%s'",
+                   type_name);
+      goto out;
+    }
+
+  actor = g_object_new (actor_type, NULL);
+  g_object_ref_sink (actor);
+
+  snapshot_restore_properties (G_OBJECT (actor), properties);
+
+  if (g_variant_n_children (layout) > 0)
+    {
+      GVariant *layout_data = g_variant_get_child_value (layout, 0);
+      GVariant *layout_properties;
+      const gchar *layout_name;
+      GType layout_type;
+
+      g_variant_get (layout_data, "(&s@a{sv})", &layout_name, &layout_properties);
+
+      layout_type = snapshot_get_type (layout_name);
+      if (layout_type != G_TYPE_INVALID &&
+          !G_TYPE_IS_ABSTRACT (layout_type) &&
+          g_type_is_a (layout_type, CLUTTER_TYPE_LAYOUT_MANAGER))
+        {
+          GObject *manager = g_object_new (layout_type, NULL);
+
+          snapshot_restore_properties (manager, layout_properties);
+          clutter_actor_set_layout_manager (actor, CLUTTER_LAYOUT_MANAGER (manager));
+        }
+
+      g_variant_unref (layout_properties);
+      g_variant_unref (layout_data);
+    }
+
+  if (g_variant_n_children (content) > 0)
+    {
+      ClutterContent *image;
+      const gchar *uri;
+      int width, height;
+
+      g_variant_get_child (content, 0, "(&sii)", &uri, &width, &height);
+
+      /* this is a cache hit as long as the texture is still around */
+      image = clutter_image_new ();
+      clutter_image_load_from_uri_async (CLUTTER_IMAGE (image), uri,
+                                         width, height,
+                                         NULL, NULL, NULL);
+      clutter_actor_set_content (actor, image);
+      g_object_unref (image);
+    }
+
+  /* actors that build their own children when created already have
+   * them, and we would end up with two copies
+   */
+  if (clutter_actor_get_n_children (actor) == 0)
+    {
+      GVariantIter iter;
+      GVariant *child_data;
+
+      g_variant_iter_init (&iter, children);
+      while (g_variant_iter_next (&iter, "v", &child_data))
+        {
+          ClutterActor *child;
+
+          child = snapshot_restore_actor (child_data, allocations, error);
+          g_variant_unref (child_data);
+
+          if (child == NULL)
+            {
+              clutter_actor_destroy (actor);
+              g_clear_object (&actor);
+              goto out;
+            }
+
+          clutter_actor_add_child (actor, child);
+          g_object_unref (child);
+        }
+    }
+
+  if (visible)
+    clutter_actor_show (actor);
+  else
+    clutter_actor_hide (actor);
+
+  if (g_variant_n_children (allocation) > 0)
+    {
+      RestoredAllocation restored;
+      gdouble x1, y1, x2, y2;
+
+      g_variant_get_child (allocation, 0, "(dddd)", &x1, &y1, &x2, &y2);
+
+      restored.actor = g_object_ref (actor);
+      clutter_actor_box_init (&restored.allocation, x1, y1, x2, y2);
+      g_array_append_val (allocations, restored);
+    }
+
+out:
+  g_variant_unref (properties);
+  g_variant_unref (allocation);
+  g_variant_unref (content);
+  g_variant_unref (layout);
+  g_variant_unref (children);
+
+  return actor;
+}
+
+/**
+ * clutter_actor_save_snapshot:
+ * @self: a #ClutterActor
+ *
+ * Saves the state of the children of @self, and of their descendants,
+ * so that they can be recreated using clutter_actor_restore_snapshot().
+ *
+ * Only the properties that can be set after construction are saved; the
+ * constraints, actions and effects of the actors are not saved, and
+ * neither are the #ClutterContent implementations other than the
+ * #ClutterImage instances loaded with clutter_image_load_from_uri_async().
+ *
+ * Return value: (transfer full): the snapshot data. Use g_bytes_unref()
+ *   when done
+ *
+ * Since: 1.26
+ */
+GBytes *
+clutter_actor_save_snapshot (ClutterActor *self)
+{
+  GVariantBuilder children;
+  ClutterActorIter iter;
+  ClutterActor *child;
+  GVariant *snapshot;
+  GBytes *retval;
+
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+
+  g_variant_builder_init (&children, G_VARIANT_TYPE ("av"));
+
+  clutter_actor_iter_init (&iter, self);
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      if (CLUTTER_ACTOR_IS_INTERNAL_CHILD (child))
+        continue;
+
+      g_variant_builder_add (&children, "v", snapshot_save_actor (child));
+    }
+
+  snapshot = g_variant_new ("(u@av)",
+                            SNAPSHOT_VERSION,
+                            g_variant_builder_end (&children));
+  g_variant_ref_sink (snapshot);
+
+  retval = g_variant_get_data_as_bytes (snapshot);
+
+  g_variant_unref (snapshot);
+
+  return retval;
+}
+
+/**
+ * clutter_actor_restore_snapshot:
+ * @self: a #ClutterActor
+ * @snapshot: the data returned by clutter_actor_save_snapshot()
+ * @error: return location for a #GError, or %NULL
+ *
+ * Recreates the actors saved in @snapshot, and adds them as children
+ * of @self, after the children it already has.
+ *
+ * If any of the actors cannot be recreated, no actor is added to @self,
+ * and the user interface should be built as if there was no snapshot.
+ *
+ * Return value: %TRUE if the snapshot was restored
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_actor_restore_snapshot (ClutterActor  *self,
+                                GBytes        *snapshot,
+                                GError       **error)
+{
+  GVariant *data, *children;
+  GPtrArray *restored;
+  GArray *allocations;
+  GVariantIter iter;
+  GVariant *child_data;
+  gboolean retval = TRUE;
+  guint32 version;
+  guint i;
+
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+  g_return_val_if_fail (snapshot != NULL, FALSE);
+
+  data = g_variant_new_from_bytes (G_VARIANT_TYPE (SNAPSHOT_FORMAT), snapshot, FALSE);
+  g_variant_ref_sink (data);
+
+  g_variant_get (data, "(u@av)", &version, &children);
+
+  if (version != SNAPSHOT_VERSION)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                   "Unsupported snapshot version %u",
+                   version);
+      g_variant_unref (children);
+      g_variant_unref (data);
+      return FALSE;
+    }
+
+  restored = g_ptr_array_new_with_free_func (g_object_unref);
+  allocations = g_array_new (FALSE, FALSE, sizeof (RestoredAllocation));
+
+  g_variant_iter_init (&iter, children);
+  while (retval && g_variant_iter_next (&iter, "v", &child_data))
+    {
+      ClutterActor *child;
+
+      child = snapshot_restore_actor (child_data, allocations, error);
+      if (child != NULL)
+        g_ptr_array_add (restored, child);
+      else
+        retval = FALSE;
+
+      g_variant_unref (child_data);
+    }
+
+  if (retval)
+    {
+      for (i = 0; i < restored->len; i++)
+        clutter_actor_add_child (self, g_ptr_array_index (restored, i));
+
+      /* the allocations are restored once the whole tree is in place,
+       * since adding the children queues a relayout on their parents
+       */
+      for (i = 0; i < allocations->len; i++)
+        {
+          RestoredAllocation *r = &g_array_index (allocations, RestoredAllocation, i);
+
+          _clutter_actor_restore_allocation (r->actor, &r->allocation);
+        }
+
+      CLUTTER_NOTE (MISC, "Restored %u children from a snapshot of %" G_GSIZE_FORMAT " bytes",
+                    restored->len,
+                    g_bytes_get_size (snapshot));
+    }
+  else
+    {
+      for (i = 0; i < restored->len; i++)
+        clutter_actor_destroy (g_ptr_array_index (restored, i));
+    }
+
+  for (i = 0; i < allocations->len; i++)
+    g_object_unref (g_array_index (allocations, RestoredAllocation, i).actor);
+
+  g_array_free (allocations, TRUE);
+  g_ptr_array_unref (restored);
+  g_variant_unref (children);
+  g_variant_unref (data);
+
+  return retval;
+}
@@ -140,6 +140,12 @@
  * must only paint the contents of the actor itself, and not the contents of
  * its children, if the actor has any.
  *
+ * The paint nodes created by the virtual function are retained, and painted
+ * again on the following frames, until the actor queues a redraw with
+ * clutter_actor_queue_redraw(), the size of its allocation changes, or its
+ * paint opacity changes; implementations must queue a redraw whenever the
+ * state used to build the paint nodes changes.
+ *
  * The #ClutterPaintNode passed to the virtual function is the local root of
  * the render tree; any node added to it will be rendered at the correct
  * position, as defined by the actor's #ClutterActor:allocation.
@@ -621,6 +627,7 @@
 #include "clutter-action.h"
 #include "clutter-actor-meta-private.h"
 #include "clutter-animatable.h"
+#include "clutter-canvas-private.h"
 #include "clutter-color-static.h"
 #include "clutter-color.h"
 #include "clutter-constraint-private.h"
@@ -632,18 +639,26 @@
 #include "clutter-enum-types.h"
 #include "clutter-fixed-layout.h"
 #include "clutter-flatten-effect.h"
+#include "clutter-group.h"
+#include "clutter-image-private.h"
 #include "clutter-interval.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
+#include "clutter-master-clock.h"
+#include "clutter-offscreen-effect-private.h"
+#include "clutter-paint-debug.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-paint-node-private.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
-#include "clutter-property-transition.h"
+#include "clutter-property-transition-private.h"
 #include "clutter-scriptable.h"
 #include "clutter-script-private.h"
+#include "clutter-spatial-index.h"
 #include "clutter-stage-private.h"
+#include "clutter-text-private.h"
 #include "clutter-timeline.h"
+#include "clutter-trace.h"
 #include "clutter-transition.h"
 #include "clutter-units.h"
 
@@ -669,21 +684,75 @@ typedef enum {
 } MapStateChange;
 
 /* 3 entries should be a good compromise, few layout managers
- * will ask for 3 different preferred size in each allocation cycle */
-#define N_CACHED_SIZE_REQUESTS 3
+ * will ask for 3 different preferred size in each allocation cycle;
+ * the actors that do get asked for more, e.g. wrapping text inside
+ * a height-for-width layout, grow their cache up to the maximum
+ */
+#define N_CACHED_SIZE_REQUESTS          3
+#define N_CACHED_SIZE_REQUESTS_MAX      16
 
-struct _ClutterActorPrivate
+typedef struct _SizeRequestCache
 {
-  /* request mode */
-  ClutterRequestMode request_mode;
-
-  /* our cached size requests for different width / height */
-  SizeRequest width_requests[N_CACHED_SIZE_REQUESTS];
-  SizeRequest height_requests[N_CACHED_SIZE_REQUESTS];
+  /* either inline_requests or a heap allocated array */
+  SizeRequest *requests;
+  guint n_requests;
 
   /* An age of 0 means the entry is not set */
-  guint cached_height_age;
-  guint cached_width_age;
+  guint age;
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  guint n_hits;
+  guint n_misses;
+#endif
+
+  SizeRequest inline_requests[N_CACHED_SIZE_REQUESTS];
+} SizeRequestCache;
+
+/* the state used to paint the content of the actor, allocated the
+ * first time it differs from the defaults; most actors only paint
+ * their background color, or have no content at all
+ */
+typedef struct _ContentInfo
+{
+  ClutterActorBox content_box;
+  ClutterContentGravity content_gravity;
+  ClutterScalingFilter min_filter;
+  ClutterScalingFilter mag_filter;
+  ClutterContentRepeat content_repeat;
+} ContentInfo;
+
+typedef struct _OffscreenInfo
+{
+  ClutterOffscreenRedirect offscreen_redirect;
+
+  /* This is an internal effect used to implement the
+     offscreen-redirect property */
+  ClutterEffect *flatten_effect;
+
+  /* the number of consecutive paints without damage, used by
+   * CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC
+   */
+  guint static_paints;
+} OffscreenInfo;
+
+typedef struct _ConstraintInfo
+{
+  /* the constraints using this actor as their source */
+  GPtrArray *dependents;
+
+  /* the box given to clutter_actor_allocate(), before applying the
+   * constraints, used to apply them again when their sources change
+   */
+  ClutterActorBox box;
+  ClutterAllocationFlags flags;
+} ConstraintInfo;
+
+struct _ClutterActorPrivate
+{
+  /* the state read for every actor by the paint and pick traversals
+   * is kept together at the start of the structure, so that walking
+   * the scene graph touches as few cache lines as possible per actor
+   */
 
   /* the bounding box of the actor, relative to the parent's
    * allocation
@@ -697,14 +766,33 @@ struct _ClutterActorPrivate
   /* the cached transformation matrix; see apply_transform() */
   CoglMatrix transform;
 
+  /* the cached transformation from the actor to its stage, valid while
+   * neither the actor nor its ancestors changed their transformation;
+   * see clutter_actor_get_stage_transform()
+   */
+  CoglMatrix stage_transform;
+  guint stage_transform_serial;
+  guint parent_transform_serial;
+
+  /* the ClutterTransformKind of the two matrices above, so that the
+   * 2D transformations can skip most of the 4x4 matrix math
+   */
+  guint transform_kind              : 2;
+  guint stage_transform_kind        : 2;
+
   guint8 opacity;
   gint opacity_override;
 
-  ClutterOffscreenRedirect offscreen_redirect;
+  /* the transformation and layout state, allocated on first use; see
+   * _clutter_actor_get_transform_info() and _clutter_actor_get_layout_info()
+   */
+  ClutterTransformInfo *transform_info;
+  ClutterLayoutInfo *layout_info;
 
-  /* This is an internal effect used to implement the
-     offscreen-redirect property */
-  ClutterEffect *flatten_effect;
+  /* the transitions and easing state, allocated on first use; see
+   * _clutter_actor_get_animation_info()
+   */
+  ClutterAnimationInfo *animation_info;
 
   /* scene graph */
   ClutterActor *parent;
@@ -715,6 +803,11 @@ struct _ClutterActorPrivate
 
   gint n_children;
 
+  /* the number of reactive actors below this one; the subtrees without
+   * any are skipped when picking the reactive actors
+   */
+  guint n_reactive_descendants;
+
   /* tracks whenever the children of an actor are changed; the
    * age is incremented by 1 whenever an actor is added or
    * removed. the age is not incremented when the first or the
@@ -723,10 +816,76 @@ struct _ClutterActorPrivate
    */
   gint age;
 
+  /* request mode */
+  ClutterRequestMode request_mode;
+
+  /* our cached size requests for different width / height, allocated
+   * on the first request; the actors with a fixed size never need them
+   */
+  SizeRequestCache *width_requests;
+  SizeRequestCache *height_requests;
+
+  /* the offscreen-redirect state, allocated when the property is
+   * set; see clutter_actor_get_offscreen_info()
+   */
+  OffscreenInfo *offscreen_info;
+
   gchar *name; /* a non-unique name, used for debugging */
 
   gint32 pick_id; /* per-stage unique id, used for picking */
 
+  /* the spatial index of the children, created for containers with
+   * many children; the boxes are in the coordinate space of the actor
+   */
+  ClutterSpatialIndex *child_index;
+
+  /* the leaf of the actor inside the index of its parent, or -1 */
+  gint child_index_leaf;
+
+  /* the children sorted by z-position, mirroring the list of
+   * children; see clutter_actor_set_sort_children_by_z()
+   */
+  GSequence *z_sorted_children;
+
+  /* the position of the actor inside the z_sorted_children sequence
+   * of its parent, or NULL
+   */
+  GSequenceIter *z_sorted_iter;
+
+  /* the paint node tree built during the last paint, replayed until
+   * the actor queues a redraw on itself; the tree is only valid for
+   * the paint opacity and framebuffer it was built with
+   */
+  ClutterPaintNode *retained_paint_node;
+  CoglFramebuffer *retained_framebuffer;
+  guint8 retained_paint_opacity;
+
+  /* the pointwise effects applied by the pipeline of the content while
+   * the actor is painted without an offscreen buffer, starting from the
+   * innermost one; see clutter_actor_paint_effects_on_content()
+   */
+  GList *content_effects;
+
+  /* the child meta of the layout manager of the parent, which is only
+   * looked up by the layout manager in its measure and allocate loops
+   */
+  ClutterLayoutMeta *layout_meta;
+
+  /* the serial of the occlusion pass that found the actor to be
+   * fully covered by opaque actors painted after it
+   */
+  guint occlusion_serial;
+
+  /* the serial of the depth pass that assigned a depth slice to
+   * the actor, and the slice
+   */
+  guint depth_serial;
+  guint depth_slice;
+
+  /* the client buffer painted as the content of the actor */
+  ClutterClientBufferType client_buffer_type;
+  gpointer client_buffer;
+
   /* a back-pointer to the Pango context that we can use
    * to create pre-configured PangoLayout
    */
@@ -745,17 +904,22 @@ struct _ClutterActorPrivate
   ClutterMetaGroup *constraints;
   ClutterMetaGroup *effects;
 
+  /* the state of the actors using constraints, or used as the source
+   * of constraints, allocated on first use; see
+   * clutter_actor_get_constraint_info()
+   */
+  ConstraintInfo *constraint_info;
+
   /* delegate object used to allocate the children of this actor */
   ClutterLayoutManager *layout_manager;
 
   /* delegate object used to paint the contents of this actor */
   ClutterContent *content;
 
-  ClutterActorBox content_box;
-  ClutterContentGravity content_gravity;
-  ClutterScalingFilter min_filter;
-  ClutterScalingFilter mag_filter;
-  ClutterContentRepeat content_repeat;
+  /* the content box and the content paint state, allocated on first
+   * use; see clutter_actor_get_content_info()
+   */
+  ContentInfo *content_info;
 
   /* used when painting, to update the paint volume */
   ClutterEffect *current_effect;
@@ -793,6 +957,9 @@ struct _ClutterActorPrivate
   /* a set of clones of the actor */
   GHashTable *clones;
 
+  /* incremented every time a redraw is queued on the clones */
+  guint clone_damage_serial;
+
   /* whether the actor is inside a cloned branch; this
    * value is propagated to all the actor's children
    */
@@ -803,6 +970,9 @@ struct _ClutterActorPrivate
   gpointer create_child_data;
   GDestroyNotify create_child_notify;
 
+  /* the number of clutter_actor_freeze_layout() calls */
+  guint layout_freeze_count;
+
   /* bitfields: KEEP AT THE END */
 
   /* fixed position and sizes */
@@ -825,6 +995,7 @@ struct _ClutterActorPrivate
   guint has_pointer                 : 1;
   guint propagated_one_redraw       : 1;
   guint paint_volume_valid          : 1;
+  guint paint_volume_cached         : 1;
   guint last_paint_volume_valid     : 1;
   guint in_clone_paint              : 1;
   guint transform_valid             : 1;
@@ -840,6 +1011,35 @@ struct _ClutterActorPrivate
   guint needs_compute_expand        : 1;
   guint needs_x_expand              : 1;
   guint needs_y_expand              : 1;
+  /* set on the children matching a query of the index of the parent */
+  guint child_index_hit             : 1;
+  /* set while the notifications of the actor are frozen by the
+   * scalar transitions of the current frame */
+  guint in_notify_batch             : 1;
+  /* set by clutter_actor_set_relayout_boundary() */
+  guint relayout_boundary           : 1;
+  /* set while the actor is queued for relayout on its stage */
+  guint relayout_boundary_queued    : 1;
+  /* set when a relayout or a redraw was queued while the layout
+   * was frozen, and needs to be propagated when thawing it */
+  guint thaw_queue_relayout         : 1;
+  guint thaw_queue_redraw           : 1;
+  /* set once constraint_box holds the box of the last allocation */
+  guint has_constraint_box          : 1;
+  /* set when the stage window paints the actor in a layer of its own */
+  guint paint_in_layer              : 1;
+  /* set by clutter_actor_set_track_visibility() */
+  guint track_visibility            : 1;
+  /* the value of the ClutterActor:on-screen property */
+  guint on_screen                   : 1;
+  /* set by clutter_actor_set_pause_offscreen_transitions() */
+  guint pause_offscreen_transitions : 1;
+  /* whether the stage accounts for the flattened image of the actor */
+  guint raster_cached               : 1;
+  /* set while the actor is queued by clutter_actor_destroy_deferred() */
+  guint destroy_deferred            : 1;
+  /* whether the retained paint nodes apply the pointwise effects */
+  guint retained_content_effects    : 1;
 };
 
 enum
@@ -970,6 +1170,9 @@ enum
   PROP_MAGNIFICATION_FILTER,
   PROP_CONTENT_REPEAT,
 
+  PROP_TRACK_VISIBILITY,
+  PROP_ON_SCREEN,
+
   PROP_LAST
 };
 
@@ -1009,6 +1212,14 @@ enum
 
 static guint actor_signals[LAST_SIGNAL] = { 0, };
 
+/* the GObject::notify signal, and the default implementation of
+ * GObjectClass.dispatch_properties_changed; see clutter_actor_notify()
+ */
+static guint notify_signal_id = 0;
+static void (* default_dispatch_properties_changed) (GObject     *object,
+                                                     guint        n_pspecs,
+                                                     GParamSpec **pspecs);
+
 typedef struct _TransitionClosure
 {
   ClutterActor *actor;
@@ -1023,6 +1234,42 @@ static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
 static void clutter_animatable_iface_init (ClutterAnimatableIface *iface);
 static void atk_implementor_iface_init    (AtkImplementorIface    *iface);
 
+/* Checks whether emitting GObject::notify on @self could have any
+ * observable effect; GBinding and the accessibility implementation
+ * connect to the signal, so they are covered as well
+ */
+static inline gboolean
+clutter_actor_has_notify_handlers (ClutterActor *self)
+{
+  GObjectClass *object_class = G_OBJECT_GET_CLASS (self);
+
+  if (object_class->notify != NULL ||
+      object_class->dispatch_properties_changed != default_dispatch_properties_changed)
+    return TRUE;
+
+  return g_signal_has_handler_pending (self, notify_signal_id, 0, TRUE);
+}
+
+/* Emits GObject::notify for @pspec on @self, unless nothing is
+ * listening; if the stage of @self coalesces the notifications,
+ * they are queued until the end of the layout phase of the frame
+ */
+static inline void
+clutter_actor_notify (ClutterActor *self,
+                      GParamSpec   *pspec)
+{
+  ClutterActor *stage;
+
+  if (!clutter_actor_has_notify_handlers (self))
+    return;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage != NULL)
+    _clutter_stage_freeze_notify (CLUTTER_STAGE (stage), self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), pspec);
+}
+
 /* These setters are all static for now, maybe they should be in the
  * public API, but they are perhaps obscure enough to leave only as
  * properties
@@ -1046,6 +1293,9 @@ static void clutter_actor_set_natural_height_set (ClutterActor *self,
 static void clutter_actor_update_map_state       (ClutterActor  *self,
                                                   MapStateChange change);
 static void clutter_actor_unrealize_not_hiding   (ClutterActor *self);
+static void clutter_actor_allocate_internal      (ClutterActor           *self,
+                                                  const ClutterActorBox  *allocation,
+                                                  ClutterAllocationFlags  flags);
 
 /* Helper routines for managing anchor coords */
 static void clutter_anchor_coord_get_units (ClutterActor      *self,
@@ -1069,6 +1319,7 @@ static void _clutter_actor_get_relative_transformation_matrix (ClutterActor *sel
                                                                CoglMatrix *matrix);
 
 static ClutterPaintVolume *_clutter_actor_get_paint_volume_mutable (ClutterActor *self);
+static void clutter_actor_invalidate_paint_volume (ClutterActor *self);
 
 static guint8   clutter_actor_get_paint_opacity_internal        (ClutterActor *self);
 
@@ -1089,8 +1340,14 @@ static void clutter_actor_set_transform_internal (ClutterActor        *self,
 static void clutter_actor_set_child_transform_internal (ClutterActor        *self,
                                                         const ClutterMatrix *transform);
 
+static void     clutter_actor_invalidate_transform      (ClutterActor *self);
+static void     clutter_actor_remove_from_child_index   (ClutterActor *self);
+static void     clutter_actor_update_z_order            (ClutterActor *self);
+static void     clutter_actor_release_paint_node        (ClutterActor *self);
 static void     clutter_actor_realize_internal          (ClutterActor *self);
 static void     clutter_actor_unrealize_internal        (ClutterActor *self);
+static void     clutter_animation_info_free             (ClutterAnimationInfo *info);
+static void     clutter_actor_cancel_deferred_destroy   (ClutterActor *self);
 
 /* Helper macro which translates by the anchor coord, applies the
    given transformation and then translates back */
@@ -1102,9 +1359,6 @@ static void     clutter_actor_unrealize_internal        (ClutterActor *self);
   cogl_matrix_translate ((m), -_tx, -_ty, -_tz);        } G_STMT_END
 
 static GQuark quark_shader_data = 0;
-static GQuark quark_actor_layout_info = 0;
-static GQuark quark_actor_transform_info = 0;
-static GQuark quark_actor_animation_info = 0;
 
 G_DEFINE_TYPE_WITH_CODE (ClutterActor,
                          clutter_actor,
@@ -1504,9 +1758,15 @@ clutter_actor_real_map (ClutterActor *self)
 
   CLUTTER_ACTOR_SET_FLAGS (self, CLUTTER_ACTOR_MAPPED);
 
+  /* the parent only includes the mapped children in its volume */
+  clutter_actor_invalidate_paint_volume (self);
+
   stage = _clutter_actor_get_stage_internal (self);
   priv->pick_id = _clutter_stage_acquire_pick_id (CLUTTER_STAGE (stage), self);
 
+  if (priv->track_visibility || priv->pause_offscreen_transitions)
+    _clutter_stage_add_visibility_tracker (CLUTTER_STAGE (stage), self);
+
   CLUTTER_NOTE (ACTOR, "Pick id '%d' for actor '%s'",
                 priv->pick_id,
                 _clutter_actor_get_debug_name (self));
@@ -1514,7 +1774,7 @@ clutter_actor_real_map (ClutterActor *self)
   /* notify on parent mapped before potentially mapping
    * children, so apps see a top-down notification.
    */
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_MAPPED]);
+  clutter_actor_notify (self, obj_props[PROP_MAPPED]);
 
   for (iter = self->priv->first_child;
        iter != NULL;
@@ -1586,6 +1846,8 @@ clutter_actor_real_unmap (ClutterActor *self)
   CLUTTER_NOTE (ACTOR, "Unmapping actor '%s'",
                 _clutter_actor_get_debug_name (self));
 
+  clutter_actor_invalidate_paint_volume (self);
+
   for (iter = self->priv->first_child;
        iter != NULL;
        iter = iter->priv->next_sibling)
@@ -1595,6 +1857,9 @@ clutter_actor_real_unmap (ClutterActor *self)
 
   CLUTTER_ACTOR_UNSET_FLAGS (self, CLUTTER_ACTOR_MAPPED);
 
+  clutter_actor_remove_from_child_index (self);
+  clutter_actor_release_paint_node (self);
+
   /* clear the contents of the last paint volume, so that hiding + moving +
    * showing will not result in the wrong area being repainted
    */
@@ -1604,7 +1869,14 @@ clutter_actor_real_unmap (ClutterActor *self)
   /* notify on parent mapped after potentially unmapping
    * children, so apps see a bottom-up notification.
    */
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_MAPPED]);
+  clutter_actor_notify (self, obj_props[PROP_MAPPED]);
+
+  /* an unmapped actor is certainly not visible */
+  if (priv->on_screen)
+    {
+      priv->on_screen = FALSE;
+      clutter_actor_notify (self, obj_props[PROP_ON_SCREEN]);
+    }
 
   /* relinquish keyboard focus if we were unmapped while owning it */
   if (!CLUTTER_ACTOR_IS_TOPLEVEL (self))
@@ -1618,6 +1890,16 @@ clutter_actor_real_unmap (ClutterActor *self)
 
       priv->pick_id = -1;
 
+      if (stage != NULL &&
+          (priv->track_visibility || priv->pause_offscreen_transitions))
+        _clutter_stage_remove_visibility_tracker (stage, self);
+
+      if (stage != NULL && priv->raster_cached)
+        {
+          _clutter_stage_release_raster_cache (stage, self);
+          _clutter_actor_evict_raster_cache (self);
+        }
+
       if (stage != NULL &&
           clutter_stage_get_key_focus (stage) == self)
         {
@@ -1708,8 +1990,7 @@ set_show_on_set_parent (ClutterActor *self,
   if (priv->parent == NULL)
     {
       priv->show_on_set_parent = set_show;
-      g_object_notify_by_pspec (G_OBJECT (self),
-                                obj_props[PROP_SHOW_ON_SET_PARENT]);
+      clutter_actor_notify (self, obj_props[PROP_SHOW_ON_SET_PARENT]);
     }
 }
 
@@ -1765,7 +2046,7 @@ clutter_actor_show (ClutterActor *self)
     }
 
   g_signal_emit (self, actor_signals[SHOW], 0);
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_VISIBLE]);
+  clutter_actor_notify (self, obj_props[PROP_VISIBLE]);
 
   if (priv->parent != NULL)
     clutter_actor_queue_redraw (priv->parent);
@@ -1891,7 +2172,7 @@ clutter_actor_hide (ClutterActor *self)
     }
 
   g_signal_emit (self, actor_signals[HIDE], 0);
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_VISIBLE]);
+  clutter_actor_notify (self, obj_props[PROP_VISIBLE]);
 
   if (priv->parent != NULL)
     clutter_actor_queue_redraw (priv->parent);
@@ -2012,7 +2293,7 @@ clutter_actor_realize_internal (ClutterActor *self)
   CLUTTER_NOTE (ACTOR, "Realizing actor '%s'", _clutter_actor_get_debug_name (self));
 
   CLUTTER_ACTOR_SET_FLAGS (self, CLUTTER_ACTOR_REALIZED);
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_REALIZED]);
+  clutter_actor_notify (self, obj_props[PROP_REALIZED]);
 
   g_signal_emit (self, actor_signals[REALIZE], 0);
 
@@ -2114,7 +2395,7 @@ unrealize_actor_after_children_cb (ClutterActor *self,
    * child actors are unrealized, to maintain invariants.
    */
   CLUTTER_ACTOR_UNSET_FLAGS (self, CLUTTER_ACTOR_REALIZED);
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_REALIZED]);
+  clutter_actor_notify (self, obj_props[PROP_REALIZED]);
   return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
 }
 
@@ -2223,6 +2504,7 @@ clutter_actor_real_pick (ClutterActor       *self,
    */
   if (clutter_actor_should_pick_paint (self))
     {
+      ClutterStage *stage;
       ClutterActorBox box = { 0, };
       float width, height;
 
@@ -2231,12 +2513,22 @@ clutter_actor_real_pick (ClutterActor       *self,
       width = box.x2 - box.x1;
       height = box.y2 - box.y1;
 
-      cogl_set_source_color4ub (color->red,
-                                color->green,
-                                color->blue,
-                                color->alpha);
+      stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
+      if (_clutter_stage_in_geometric_pick (stage))
+        {
+          ClutterActorBox pick_box = { 0, 0, width, height };
+
+          _clutter_stage_log_pick (stage, &pick_box, self);
+        }
+      else
+        {
+          cogl_set_source_color4ub (color->red,
+                                    color->green,
+                                    color->blue,
+                                    color->alpha);
 
-      cogl_rectangle (0, 0, width, height);
+          cogl_rectangle (0, 0, width, height);
+        }
     }
 
   /* XXX - this thoroughly sucks, but we need to maintain compatibility
@@ -2247,14 +2539,52 @@ clutter_actor_real_pick (ClutterActor       *self,
    * this has to go away for 2.0; hopefully along the pick() itself.
    */
   if (CLUTTER_ACTOR_GET_CLASS (self)->pick == clutter_actor_real_pick)
-    {
-      ClutterActor *iter;
+    _clutter_actor_paint_children (self);
+}
 
-      for (iter = self->priv->first_child;
-           iter != NULL;
-           iter = iter->priv->next_sibling)
-        clutter_actor_paint (iter);
-    }
+/* Checks whether the pick silhouette of @self is the rectangle logged
+ * by the default implementation of the pick() virtual function; only
+ * the classes that override pick() to paint their children, like
+ * ClutterStage and ClutterGroup, are known to preserve it.
+ */
+static gboolean
+clutter_actor_has_geometric_pick (ClutterActor *self)
+{
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (self);
+
+  if (klass->pick != clutter_actor_real_pick &&
+      klass->pick != CLUTTER_ACTOR_CLASS (g_type_class_peek (CLUTTER_TYPE_STAGE))->pick &&
+      klass->pick != CLUTTER_ACTOR_CLASS (g_type_class_peek (CLUTTER_TYPE_GROUP))->pick)
+    return FALSE;
+
+  /* handlers of the deprecated ::pick signal can paint anything */
+  if (g_signal_has_handler_pending (self, actor_signals[PICK], 0, TRUE))
+    return FALSE;
+
+  return TRUE;
+}
+
+/* Propagates a change of @delta reactive actors in the subtree rooted
+ * in @self to the ancestors of @self
+ */
+static void
+clutter_actor_update_reactive_descendants (ClutterActor *self,
+                                           gint          delta)
+{
+  ClutterActor *iter;
+
+  if (delta == 0)
+    return;
+
+  for (iter = self->priv->parent; iter != NULL; iter = iter->priv->parent)
+    iter->priv->n_reactive_descendants += delta;
+}
+
+static inline gint
+clutter_actor_get_reactive_subtree_size (ClutterActor *self)
+{
+  return self->priv->n_reactive_descendants
+       + (CLUTTER_ACTOR_IS_REACTIVE (self) ? 1 : 0);
 }
 
 /**
@@ -2391,18 +2721,18 @@ clutter_actor_notify_if_geometry_changed (ClutterActor          *self,
    */
   if (priv->needs_allocation)
     {
-      g_object_notify_by_pspec (obj, obj_props[PROP_X]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_Y]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_POSITION]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_WIDTH]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_HEIGHT]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_SIZE]);
+      clutter_actor_notify (self, obj_props[PROP_X]);
+      clutter_actor_notify (self, obj_props[PROP_Y]);
+      clutter_actor_notify (self, obj_props[PROP_POSITION]);
+      clutter_actor_notify (self, obj_props[PROP_WIDTH]);
+      clutter_actor_notify (self, obj_props[PROP_HEIGHT]);
+      clutter_actor_notify (self, obj_props[PROP_SIZE]);
     }
   else if (priv->needs_width_request || priv->needs_height_request)
     {
-      g_object_notify_by_pspec (obj, obj_props[PROP_WIDTH]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_HEIGHT]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_SIZE]);
+      clutter_actor_notify (self, obj_props[PROP_WIDTH]);
+      clutter_actor_notify (self, obj_props[PROP_HEIGHT]);
+      clutter_actor_notify (self, obj_props[PROP_SIZE]);
     }
   else
     {
@@ -2416,26 +2746,26 @@ clutter_actor_notify_if_geometry_changed (ClutterActor          *self,
 
       if (x != old->x1)
         {
-          g_object_notify_by_pspec (obj, obj_props[PROP_X]);
-          g_object_notify_by_pspec (obj, obj_props[PROP_POSITION]);
+          clutter_actor_notify (self, obj_props[PROP_X]);
+          clutter_actor_notify (self, obj_props[PROP_POSITION]);
         }
 
       if (y != old->y1)
         {
-          g_object_notify_by_pspec (obj, obj_props[PROP_Y]);
-          g_object_notify_by_pspec (obj, obj_props[PROP_POSITION]);
+          clutter_actor_notify (self, obj_props[PROP_Y]);
+          clutter_actor_notify (self, obj_props[PROP_POSITION]);
         }
 
       if (width != (old->x2 - old->x1))
         {
-          g_object_notify_by_pspec (obj, obj_props[PROP_WIDTH]);
-          g_object_notify_by_pspec (obj, obj_props[PROP_SIZE]);
+          clutter_actor_notify (self, obj_props[PROP_WIDTH]);
+          clutter_actor_notify (self, obj_props[PROP_SIZE]);
         }
 
       if (height != (old->y2 - old->y1))
         {
-          g_object_notify_by_pspec (obj, obj_props[PROP_HEIGHT]);
-          g_object_notify_by_pspec (obj, obj_props[PROP_SIZE]);
+          clutter_actor_notify (self, obj_props[PROP_HEIGHT]);
+          clutter_actor_notify (self, obj_props[PROP_SIZE]);
         }
     }
 
@@ -2496,15 +2826,31 @@ clutter_actor_set_allocation_internal (ClutterActor           *self,
       CLUTTER_NOTE (LAYOUT, "Allocation for '%s' changed",
                     _clutter_actor_get_debug_name (self));
 
-      priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
+
+      /* the paint nodes are sized after the allocation */
+      if (clutter_actor_box_get_width (&old_alloc) != clutter_actor_box_get_width (box) ||
+          clutter_actor_box_get_height (&old_alloc) != clutter_actor_box_get_height (box))
+        clutter_actor_release_paint_node (self);
+
+      clutter_actor_notify (self, obj_props[PROP_ALLOCATION]);
+
+      /* the actors bound to this one are allocated again by the stage */
+      if (priv->constraint_info != NULL &&
+          priv->constraint_info->dependents != NULL &&
+          priv->constraint_info->dependents->len > 0)
+        {
+          ClutterActor *stage = _clutter_actor_get_stage_internal (self);
 
-      g_object_notify_by_pspec (obj, obj_props[PROP_ALLOCATION]);
+          if (stage != NULL)
+            _clutter_stage_queue_constraint_source (CLUTTER_STAGE (stage), self);
+        }
 
       /* if the allocation changes, so does the content box */
       if (priv->content != NULL)
         {
           priv->content_box_valid = FALSE;
-          g_object_notify_by_pspec (obj, obj_props[PROP_CONTENT_BOX]);
+          clutter_actor_notify (self, obj_props[PROP_CONTENT_BOX]);
         }
 
       retval = TRUE;
@@ -2627,7 +2973,12 @@ clutter_actor_real_allocate (ClutterActor           *self,
    */
   clutter_actor_maybe_layout_children (self, box, flags);
 
-  if (changed)
+  /* most actors do not have handlers, and copying the box for
+   * each one of them during a layout animation adds up
+   */
+  if (changed &&
+      g_signal_has_handler_pending (self, actor_signals[ALLOCATION_CHANGED],
+                                    0, TRUE))
     {
       ClutterActorBox signal_box = priv->allocation;
       ClutterAllocationFlags signal_flags = priv->allocation_flags;
@@ -2674,6 +3025,11 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* the paint volume of the actor might have changed, so the box
+   * inside the index of the parent has to be computed again
+   */
+  clutter_actor_remove_from_child_index (self);
+
   /* If the queue redraw is coming from a child then the actor has
      become dirty and any queued effect is no longer valid */
   if (self != origin)
@@ -2681,6 +3037,13 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
       self->priv->is_dirty = TRUE;
       self->priv->effect_to_redraw = NULL;
     }
+  else
+    {
+      /* the actor itself changed, so the paint nodes of the last
+       * paint cannot be replayed
+       */
+      clutter_actor_release_paint_node (self);
+    }
 
   /* If the actor isn't visible, we still had to emit the signal
    * to allow for a ClutterClone, but the appearance of the parent
@@ -2695,8 +3058,13 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
    * parent at least once so that it's possible to implement a
    * container that tracks which of its children have queued a
    * redraw.
+   *
+   * Inside a cloned branch we always propagate, so that the clone
+   * sources know their rendering has to be updated; see
+   * _clutter_actor_get_clone_damage_serial().
    */
-  if (self->priv->propagated_one_redraw)
+  if (self->priv->propagated_one_redraw &&
+      self->priv->in_cloned_branch == 0)
     {
       ClutterActor *stage = _clutter_actor_get_stage_internal (self);
       if (stage != NULL &&
@@ -2717,98 +3085,447 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
     }
 }
 
-static void
-clutter_actor_real_queue_relayout (ClutterActor *self)
+static SizeRequestCache *
+size_request_cache_new (void)
 {
-  ClutterActorPrivate *priv = self->priv;
+  SizeRequestCache *cache = g_slice_new0 (SizeRequestCache);
 
-  /* no point in queueing a redraw on a destroyed actor */
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+  cache->requests = cache->inline_requests;
+  cache->n_requests = N_CACHED_SIZE_REQUESTS;
+  cache->age = 1;
+
+  return cache;
+}
+
+static void
+size_request_cache_free (SizeRequestCache *cache)
+{
+  if (cache == NULL)
     return;
 
-  priv->needs_width_request  = TRUE;
-  priv->needs_height_request = TRUE;
-  priv->needs_allocation     = TRUE;
+  if (cache->requests != cache->inline_requests)
+    g_free (cache->requests);
 
-  /* reset the cached size requests */
-  memset (priv->width_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
-  memset (priv->height_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+  g_slice_free (SizeRequestCache, cache);
+}
 
-  /* We need to go all the way up the hierarchy */
-  if (priv->parent != NULL)
-    _clutter_actor_queue_only_relayout (priv->parent);
+static inline void
+size_request_cache_clear (SizeRequestCache *cache)
+{
+  if (cache != NULL)
+    memset (cache->requests, 0, cache->n_requests * sizeof (SizeRequest));
 }
 
-/**
- * clutter_actor_apply_relative_transform_to_point:
- * @self: A #ClutterActor
- * @ancestor: (allow-none): A #ClutterActor ancestor, or %NULL to use the
- *   default #ClutterStage
- * @point: A point as #ClutterVertex
- * @vertex: (out caller-allocates): The translated #ClutterVertex
- *
- * Transforms @point in coordinates relative to the actor into
- * ancestor-relative coordinates using the relevant transform
- * stack (i.e. scale, rotation, etc).
- *
- * If @ancestor is %NULL the ancestor will be the #ClutterStage. In
- * this case, the coordinates returned will be the coordinates on
- * the stage before the projection is applied. This is different from
- * the behaviour of clutter_actor_apply_transform_to_point().
- *
- * Since: 0.6
+/* returns the size request cache of @self for @orientation,
+ * creating it if needed
  */
-void
-clutter_actor_apply_relative_transform_to_point (ClutterActor        *self,
-						 ClutterActor        *ancestor,
-						 const ClutterVertex *point,
-						 ClutterVertex       *vertex)
+static SizeRequestCache *
+clutter_actor_get_size_request_cache (ClutterActor       *self,
+                                      ClutterOrientation  orientation)
 {
-  gfloat w;
-  CoglMatrix matrix;
+  ClutterActorPrivate *priv = self->priv;
+  SizeRequestCache **cache_p;
 
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
-  g_return_if_fail (ancestor == NULL || CLUTTER_IS_ACTOR (ancestor));
-  g_return_if_fail (point != NULL);
-  g_return_if_fail (vertex != NULL);
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    cache_p = &priv->width_requests;
+  else
+    cache_p = &priv->height_requests;
 
-  *vertex = *point;
-  w = 1.0;
+  if (*cache_p == NULL)
+    *cache_p = size_request_cache_new ();
 
-  if (ancestor == NULL)
-    ancestor = _clutter_actor_get_stage_internal (self);
+  return *cache_p;
+}
 
-  if (ancestor == NULL)
+/* doubles the size of @cache, and returns the first new entry */
+static SizeRequest *
+size_request_cache_grow (SizeRequestCache *cache)
+{
+  guint old_n_requests = cache->n_requests;
+  guint n_requests = MIN (old_n_requests * 2, N_CACHED_SIZE_REQUESTS_MAX);
+  SizeRequest *requests;
+
+  if (cache->requests == cache->inline_requests)
     {
-      *vertex = *point;
-      return;
+      requests = g_new0 (SizeRequest, n_requests);
+      memcpy (requests, cache->inline_requests,
+              old_n_requests * sizeof (SizeRequest));
+    }
+  else
+    {
+      requests = g_renew (SizeRequest, cache->requests, n_requests);
+      memset (requests + old_n_requests, 0,
+              (n_requests - old_n_requests) * sizeof (SizeRequest));
     }
 
-  _clutter_actor_get_relative_transformation_matrix (self, ancestor, &matrix);
-  cogl_matrix_transform_point (&matrix, &vertex->x, &vertex->y, &vertex->z, &w);
+  cache->requests = requests;
+  cache->n_requests = n_requests;
+
+  return &requests[old_n_requests];
 }
 
-static gboolean
-_clutter_actor_fully_transform_vertices (ClutterActor *self,
-                                         const ClutterVertex *vertices_in,
-                                         ClutterVertex *vertices_out,
-                                         int n_vertices)
+static const ContentInfo default_content_info = {
+  { 0.f, 0.f, 0.f, 0.f },               /* content_box */
+  CLUTTER_CONTENT_GRAVITY_RESIZE_FILL,  /* content_gravity */
+  CLUTTER_SCALING_FILTER_LINEAR,        /* min_filter */
+  CLUTTER_SCALING_FILTER_LINEAR,        /* mag_filter */
+  CLUTTER_REPEAT_NONE,                  /* content_repeat */
+};
+
+static inline const ContentInfo *
+clutter_actor_get_content_info_or_defaults (ClutterActor *self)
 {
-  ClutterActor *stage;
-  CoglMatrix modelview;
-  CoglMatrix projection;
-  float viewport[4];
+  const ContentInfo *info = self->priv->content_info;
 
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+  if (info != NULL)
+    return info;
 
-  stage = _clutter_actor_get_stage_internal (self);
+  return &default_content_info;
+}
 
-  /* We really can't do anything meaningful in this case so don't try
-   * to do any transform */
-  if (stage == NULL)
-    return FALSE;
+static ContentInfo *
+clutter_actor_get_content_info (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->content_info == NULL)
+    {
+      priv->content_info = g_slice_new (ContentInfo);
+      *priv->content_info = default_content_info;
+    }
+
+  return priv->content_info;
+}
+
+static const OffscreenInfo default_offscreen_info = { 0, NULL, 0 };
+
+static inline const OffscreenInfo *
+clutter_actor_get_offscreen_info_or_defaults (ClutterActor *self)
+{
+  const OffscreenInfo *info = self->priv->offscreen_info;
+
+  if (info != NULL)
+    return info;
+
+  return &default_offscreen_info;
+}
+
+static OffscreenInfo *
+clutter_actor_get_offscreen_info (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->offscreen_info == NULL)
+    priv->offscreen_info = g_slice_new0 (OffscreenInfo);
+
+  return priv->offscreen_info;
+}
+
+static ConstraintInfo *
+clutter_actor_get_constraint_info (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->constraint_info == NULL)
+    priv->constraint_info = g_slice_new0 (ConstraintInfo);
+
+  return priv->constraint_info;
+}
+
+/* the layout work done since the start of the process, for all the
+ * actors; see clutter_actor_get_layout_stats()
+ */
+static ClutterLayoutStats layout_stats = { 0, };
+
+/* whether a relayout queued by the children of @self can be handled by
+ * allocating @self again, with its current allocation, instead of going
+ * up to the stage
+ */
+static gboolean
+clutter_actor_is_relayout_boundary (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self) || priv->parent == NULL)
+    return FALSE;
+
+  /* the expand flags of the children are propagated to the parent,
+   * which needs to be laid out again
+   */
+  if (priv->needs_compute_expand)
+    return FALSE;
+
+  /* an actor that was never allocated, or that is already waiting for
+   * a relayout from its parent, has no allocation we can reuse
+   */
+  if (priv->needs_allocation && !priv->relayout_boundary_queued)
+    return FALSE;
+
+  /* the preferred size of an actor with a fixed size does not depend
+   * on its children
+   */
+  if (!priv->relayout_boundary &&
+      !(priv->min_width_set && priv->natural_width_set &&
+        priv->min_height_set && priv->natural_height_set))
+    return FALSE;
+
+  return _clutter_actor_get_stage_internal (self) != NULL;
+}
+
+static void
+clutter_actor_queue_boundary_relayout (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return;
+
+  /* the size requests are still valid */
+  priv->needs_allocation = TRUE;
+
+  if (priv->relayout_boundary_queued)
+    return;
+
+  CLUTTER_NOTE (LAYOUT, "Queueing relayout of the boundary '%s'",
+                _clutter_actor_get_debug_name (self));
+
+  priv->relayout_boundary_queued = TRUE;
+
+  _clutter_stage_queue_relayout_boundary (CLUTTER_STAGE (_clutter_actor_get_stage_internal (self)),
+                                          self);
+}
+
+/*< private >
+ * _clutter_actor_relayout_boundary:
+ * @self: a #ClutterActor queued by clutter_actor_queue_boundary_relayout()
+ *
+ * Allocates the children of @self again, if @self was not allocated
+ * by its parent in the meantime.
+ */
+void
+_clutter_actor_relayout_boundary (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox allocation;
+
+  priv->relayout_boundary_queued = FALSE;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) || !priv->needs_allocation)
+    return;
+
+  /* the actor might have been moved to another stage, or out of it */
+  if (_clutter_actor_get_stage_internal (self) == NULL)
+    return;
+
+  layout_stats.n_relayout_roots += 1;
+
+  /* the allocation has already been adjusted by the constraints and
+   * the margins, so we skip clutter_actor_allocate()
+   */
+  allocation = priv->allocation;
+  clutter_actor_allocate_internal (self, &allocation, CLUTTER_ALLOCATION_NONE);
+}
+
+/*< private >
+ * _clutter_actor_add_constraint_dependent:
+ * @self: a #ClutterActor
+ * @constraint: a #ClutterConstraint using @self as its source
+ *
+ * Records that the allocation of the actor using @constraint
+ * depends on the allocation of @self.
+ */
+void
+_clutter_actor_add_constraint_dependent (ClutterActor      *self,
+                                         ClutterConstraint *constraint)
+{
+  ConstraintInfo *info = clutter_actor_get_constraint_info (self);
+
+  if (info->dependents == NULL)
+    info->dependents = g_ptr_array_new ();
+
+  g_ptr_array_add (info->dependents, constraint);
+}
+
+void
+_clutter_actor_remove_constraint_dependent (ClutterActor      *self,
+                                            ClutterConstraint *constraint)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->constraint_info != NULL && priv->constraint_info->dependents != NULL)
+    g_ptr_array_remove_fast (priv->constraint_info->dependents, constraint);
+}
+
+/*< private >
+ * _clutter_actor_peek_constraint_dependents:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the constraints using @self as their source.
+ *
+ * Return value: (transfer none): an array of #ClutterConstraint,
+ *   or %NULL
+ */
+GPtrArray *
+_clutter_actor_peek_constraint_dependents (ClutterActor *self)
+{
+  if (self->priv->constraint_info == NULL)
+    return NULL;
+
+  return self->priv->constraint_info->dependents;
+}
+
+/*< private >
+ * _clutter_actor_update_constraints_allocation:
+ * @self: a #ClutterActor with constraints
+ *
+ * Allocates @self again with the box it was last given by its parent,
+ * after the allocation of the source of one of its constraints changed.
+ */
+void
+_clutter_actor_update_constraints_allocation (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box, old_allocation;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return;
+
+  if (priv->constraints == NULL || !priv->has_constraint_box)
+    return;
+
+  /* the parent is going to allocate the actor anyway */
+  if (priv->needs_allocation)
+    return;
+
+  if (_clutter_actor_get_stage_internal (self) == NULL)
+    return;
+
+  CLUTTER_NOTE (LAYOUT, "Applying the constraints of '%s' again",
+                _clutter_actor_get_debug_name (self));
+
+  box = priv->constraint_info->box;
+  old_allocation = priv->allocation;
+
+  /* the parent did not move, even if it did when it last allocated us */
+  clutter_actor_allocate (self, &box,
+                          priv->constraint_info->flags & ~CLUTTER_ABSOLUTE_ORIGIN_CHANGED);
+
+  if (!clutter_actor_box_equal (&old_allocation, &priv->allocation))
+    clutter_actor_queue_redraw (self);
+}
+
+static void
+clutter_actor_queue_parent_relayout (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->parent == NULL)
+    return;
+
+  /* We need to go all the way up the hierarchy, unless the parent
+   * can be laid out on its own
+   */
+  if (clutter_actor_is_relayout_boundary (priv->parent))
+    clutter_actor_queue_boundary_relayout (priv->parent);
+  else
+    _clutter_actor_queue_only_relayout (priv->parent);
+}
+
+static void
+clutter_actor_real_queue_relayout (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  /* no point in queueing a redraw on a destroyed actor */
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return;
+
+  priv->needs_width_request  = TRUE;
+  priv->needs_height_request = TRUE;
+  priv->needs_allocation     = TRUE;
+
+  /* reset the cached size requests */
+  size_request_cache_clear (priv->width_requests);
+  size_request_cache_clear (priv->height_requests);
+
+  /* the parent is notified once, when thawing the layout */
+  if (priv->layout_freeze_count > 0)
+    {
+      priv->thaw_queue_relayout = TRUE;
+      return;
+    }
+
+  clutter_actor_queue_parent_relayout (self);
+}
+
+/**
+ * clutter_actor_apply_relative_transform_to_point:
+ * @self: A #ClutterActor
+ * @ancestor: (allow-none): A #ClutterActor ancestor, or %NULL to use the
+ *   default #ClutterStage
+ * @point: A point as #ClutterVertex
+ * @vertex: (out caller-allocates): The translated #ClutterVertex
+ *
+ * Transforms @point in coordinates relative to the actor into
+ * ancestor-relative coordinates using the relevant transform
+ * stack (i.e. scale, rotation, etc).
+ *
+ * If @ancestor is %NULL the ancestor will be the #ClutterStage. In
+ * this case, the coordinates returned will be the coordinates on
+ * the stage before the projection is applied. This is different from
+ * the behaviour of clutter_actor_apply_transform_to_point().
+ *
+ * Since: 0.6
+ */
+void
+clutter_actor_apply_relative_transform_to_point (ClutterActor        *self,
+						 ClutterActor        *ancestor,
+						 const ClutterVertex *point,
+						 ClutterVertex       *vertex)
+{
+  gfloat w;
+  CoglMatrix matrix;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (ancestor == NULL || CLUTTER_IS_ACTOR (ancestor));
+  g_return_if_fail (point != NULL);
+  g_return_if_fail (vertex != NULL);
+
+  *vertex = *point;
+  w = 1.0;
+
+  if (ancestor == NULL)
+    ancestor = _clutter_actor_get_stage_internal (self);
+
+  if (ancestor == NULL)
+    {
+      *vertex = *point;
+      return;
+    }
+
+  _clutter_actor_get_relative_transformation_matrix (self, ancestor, &matrix);
+  cogl_matrix_transform_point (&matrix, &vertex->x, &vertex->y, &vertex->z, &w);
+}
+
+static gboolean
+_clutter_actor_fully_transform_vertices (ClutterActor *self,
+                                         const ClutterVertex *vertices_in,
+                                         ClutterVertex *vertices_out,
+                                         int n_vertices)
+{
+  ClutterActor *stage;
+  CoglMatrix modelview;
+  CoglMatrix projection;
+  float viewport[4];
+
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  stage = _clutter_actor_get_stage_internal (self);
+
+  /* We really can't do anything meaningful in this case so don't try
+   * to do any transform */
+  if (stage == NULL)
+    return FALSE;
 
   /* Note: we pass NULL as the ancestor because we don't just want the modelview
    * that gets us to stage coordinates, we want to go all the way to eye
@@ -3001,13 +3718,7 @@ clutter_actor_get_allocation_vertices (ClutterActor  *self,
   _clutter_actor_get_relative_transformation_matrix (self, ancestor,
                                                      &modelview);
 
-  cogl_matrix_transform_points (&modelview,
-                                3,
-                                sizeof (ClutterVertex),
-                                vertices,
-                                sizeof (ClutterVertex),
-                                vertices,
-                                4);
+  _clutter_util_transform_vertices (&modelview, vertices, vertices, 4);
 }
 
 /**
@@ -3197,10 +3908,13 @@ roll_back_pivot:
     cogl_matrix_translate (transform, -pivot_x, -pivot_y, -info->pivot_z);
 
   /* we have a valid modelview */
+  priv->transform_kind = _clutter_util_matrix_get_kind (transform);
   priv->transform_valid = TRUE;
 
 multiply_and_return:
-  cogl_matrix_multiply (matrix, matrix, &priv->transform);
+  _clutter_util_matrix_multiply_kind (matrix, matrix,
+                                      &priv->transform,
+                                      priv->transform_kind);
 }
 
 /* Applies the transforms associated with this actor to the given
@@ -3212,32 +3926,148 @@ _clutter_actor_apply_modelview_transform (ClutterActor  *self,
   CLUTTER_ACTOR_GET_CLASS (self)->apply_transform (self, matrix);
 }
 
+/* incremented every time the transformation of an actor to its stage
+ * is computed; 0 is never used, and marks an invalid cache
+ */
+static guint stage_transform_serial = 0;
+
 /*
- * clutter_actor_apply_relative_transformation_matrix:
- * @self: The actor whose coordinate space you want to transform from.
- * @ancestor: The ancestor actor whose coordinate space you want to transform too
- *            or %NULL if you want to transform all the way to eye coordinates.
- * @matrix: A #ClutterMatrix to apply the transformation too.
- *
- * This multiplies a transform with @matrix that will transform coordinates
- * from the coordinate space of @self into the coordinate space of @ancestor.
+ * clutter_actor_get_stage_transform:
+ * @self: a #ClutterActor inside @stage
+ * @stage: the stage of @self
  *
- * For example if you need a matrix that can transform the local actor
- * coordinates of @self into stage coordinates you would pass the actor's stage
- * pointer as the @ancestor.
+ * Retrieves the transformation from the coordinate space of @self to
+ * the coordinate space of @stage, using the matrices cached by @self
+ * and its ancestors.
  *
- * If you pass %NULL then the transformation will take you all the way through
- * to eye coordinates. This can be useful if you want to extract the entire
- * modelview transform that Clutter applies before applying the projection
- * transformation. If you want to explicitly set a modelview on a CoglFramebuffer
- * using cogl_set_modelview_matrix() for example then you would want a matrix
- * that transforms into eye coordinates.
+ * Each actor stores the serial of the matrix of its parent it was
+ * computed from, so a change in the transformation of an ancestor
+ * invalidates the matrices of its descendants when they are used,
+ * without walking the subtree; repeated queries only compare the
+ * serials up to the stage.
  *
- * This function doesn't initialize the given @matrix, it simply
- * multiplies the requested transformation matrix with the existing contents of
- * @matrix. You can use cogl_matrix_init_identity() to initialize the @matrix
- * before calling this function, or you can use
- * clutter_actor_get_relative_transformation_matrix() instead.
+ * Return value: the transformation of @self, or %NULL if an actor
+ *   between @self and @stage overrides #ClutterActorClass.apply_transform,
+ *   whose result might change without an invalidation
+ */
+static const CoglMatrix *
+clutter_actor_get_stage_transform (ClutterActor *self,
+                                   ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  const CoglMatrix *parent_transform;
+  ClutterTransformKind parent_kind;
+  guint parent_serial;
+
+  if (CLUTTER_ACTOR_GET_CLASS (self)->apply_transform != clutter_actor_real_apply_transform)
+    return NULL;
+
+  if (priv->parent == stage)
+    {
+      parent_transform = NULL;
+      parent_kind = CLUTTER_TRANSFORM_KIND_IDENTITY;
+      parent_serial = 0;
+    }
+  else
+    {
+      parent_transform = clutter_actor_get_stage_transform (priv->parent, stage);
+      if (parent_transform == NULL)
+        return NULL;
+
+      parent_kind = priv->parent->priv->stage_transform_kind;
+      parent_serial = priv->parent->priv->stage_transform_serial;
+    }
+
+  if (priv->stage_transform_serial != 0 &&
+      priv->parent_transform_serial == parent_serial)
+    return &priv->stage_transform;
+
+  if (parent_transform != NULL)
+    priv->stage_transform = *parent_transform;
+  else
+    cogl_matrix_init_identity (&priv->stage_transform);
+
+  _clutter_actor_apply_modelview_transform (self, &priv->stage_transform);
+
+  /* the transformation of the actor is cached by the call above */
+  priv->stage_transform_kind = MAX (parent_kind, priv->transform_kind);
+
+  stage_transform_serial += 1;
+  if (G_UNLIKELY (stage_transform_serial == 0))
+    stage_transform_serial = 1;
+
+  priv->stage_transform_serial = stage_transform_serial;
+  priv->parent_transform_serial = parent_serial;
+
+  return &priv->stage_transform;
+}
+
+/*< private >
+ * _clutter_actor_get_stage_transform_2d:
+ * @self: a #ClutterActor
+ * @matrix: (out): return location for the transformation
+ *
+ * Retrieves the transformation from the coordinate space of @self to the
+ * coordinate space of its stage, if it only transforms the z = 0 plane
+ * in 2D, e.g. by translating, scaling and rotating around the z axis.
+ *
+ * Return value: %TRUE if the transformation of @self is 2D
+ */
+gboolean
+_clutter_actor_get_stage_transform_2d (ClutterActor   *self,
+                                       cairo_matrix_t *matrix)
+{
+  ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+  const CoglMatrix *transform;
+
+  if (stage == NULL)
+    return FALSE;
+
+  if (stage == self)
+    {
+      cairo_matrix_init_identity (matrix);
+      return TRUE;
+    }
+
+  transform = clutter_actor_get_stage_transform (self, stage);
+  if (transform == NULL ||
+      self->priv->stage_transform_kind == CLUTTER_TRANSFORM_KIND_3D)
+    return FALSE;
+
+  cairo_matrix_init (matrix,
+                     transform->xx, transform->yx,
+                     transform->xy, transform->yy,
+                     transform->xw, transform->yw);
+
+  return TRUE;
+}
+
+/*
+ * clutter_actor_apply_relative_transformation_matrix:
+ * @self: The actor whose coordinate space you want to transform from.
+ * @ancestor: The ancestor actor whose coordinate space you want to transform too
+ *            or %NULL if you want to transform all the way to eye coordinates.
+ * @matrix: A #ClutterMatrix to apply the transformation too.
+ *
+ * This multiplies a transform with @matrix that will transform coordinates
+ * from the coordinate space of @self into the coordinate space of @ancestor.
+ *
+ * For example if you need a matrix that can transform the local actor
+ * coordinates of @self into stage coordinates you would pass the actor's stage
+ * pointer as the @ancestor.
+ *
+ * If you pass %NULL then the transformation will take you all the way through
+ * to eye coordinates. This can be useful if you want to extract the entire
+ * modelview transform that Clutter applies before applying the projection
+ * transformation. If you want to explicitly set a modelview on a CoglFramebuffer
+ * using cogl_set_modelview_matrix() for example then you would want a matrix
+ * that transforms into eye coordinates.
+ *
+ * This function doesn't initialize the given @matrix, it simply
+ * multiplies the requested transformation matrix with the existing contents of
+ * @matrix. You can use cogl_matrix_init_identity() to initialize the @matrix
+ * before calling this function, or you can use
+ * clutter_actor_get_relative_transformation_matrix() instead.
  */
 void
 _clutter_actor_apply_relative_transformation_matrix (ClutterActor *self,
@@ -3253,6 +4083,32 @@ _clutter_actor_apply_relative_transformation_matrix (ClutterActor *self,
   if (self == ancestor)
     return;
 
+  /* the transformations to the stage, and to eye coordinates, are
+   * cached by the actors
+   */
+  if (ancestor == NULL || CLUTTER_ACTOR_IS_TOPLEVEL (ancestor))
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+      if (stage != NULL && stage != self &&
+          (ancestor == NULL || ancestor == stage))
+        {
+          const CoglMatrix *stage_transform;
+
+          stage_transform = clutter_actor_get_stage_transform (self, stage);
+          if (stage_transform != NULL)
+            {
+              if (ancestor == NULL)
+                _clutter_actor_apply_modelview_transform (stage, matrix);
+
+              _clutter_util_matrix_multiply_kind (matrix, matrix,
+                                                  stage_transform,
+                                                  self->priv->stage_transform_kind);
+              return;
+            }
+        }
+    }
+
   parent = clutter_actor_get_parent (self);
 
   if (parent != NULL)
@@ -3427,6 +4283,47 @@ in_clone_paint (void)
   return clone_paint_level > 0;
 }
 
+static int layer_paint_level = 0;
+
+void
+_clutter_actor_push_layer_paint (void)
+{
+  layer_paint_level++;
+}
+
+void
+_clutter_actor_pop_layer_paint (void)
+{
+  layer_paint_level--;
+}
+
+/*< private >
+ * _clutter_actor_set_paint_in_layer:
+ * @self: a #ClutterActor
+ * @in_layer: whether the actor is painted in a layer
+ *
+ * Marks @self as painted by the stage window in a layer of its own; the
+ * actor is then skipped when painting the stage, and only painted
+ * between _clutter_actor_push_layer_paint() and
+ * _clutter_actor_pop_layer_paint(). The actor is still picked with
+ * the stage.
+ */
+void
+_clutter_actor_set_paint_in_layer (ClutterActor *self,
+                                   gboolean      in_layer)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  in_layer = !!in_layer;
+  if (priv->paint_in_layer == in_layer)
+    return;
+
+  priv->paint_in_layer = in_layer;
+
+  /* the area of the actor on the stage changes */
+  clutter_actor_queue_redraw (self);
+}
+
 /* Returns TRUE if the actor can be ignored */
 /* FIXME: we should return a ClutterCullResult, and
  * clutter_actor_paint should understand that a CLUTTER_CULL_RESULT_IN
@@ -3434,6 +4331,7 @@ in_clone_paint (void)
  * node. */
 static gboolean
 cull_actor (ClutterActor      *self,
+            CoglFramebuffer   *framebuffer,
             ClutterCullResult *result_out)
 {
   ClutterActorPrivate *priv = self->priv;
@@ -3461,7 +4359,7 @@ cull_actor (ClutterActor      *self,
       return FALSE;
     }
 
-  if (cogl_get_draw_framebuffer () != _clutter_stage_get_active_framebuffer (stage))
+  if (framebuffer != _clutter_stage_get_active_framebuffer (stage))
     {
       CLUTTER_NOTE (CLIPPING, "Bail from cull_actor without culling (%s): "
                     "Current framebuffer doesn't correspond to stage",
@@ -3504,2748 +4402,4088 @@ _clutter_actor_update_last_paint_volume (ClutterActor *self)
   priv->last_paint_volume_valid = TRUE;
 }
 
-static inline gboolean
-actor_has_shader_data (ClutterActor *self)
-{
-  return g_object_get_qdata (G_OBJECT (self), quark_shader_data) != NULL;
-}
-
-guint32
-_clutter_actor_get_pick_id (ClutterActor *self)
-{
-  if (self->priv->pick_id < 0)
-    return 0;
-
-  return self->priv->pick_id;
-}
+/* Containers with at least this many children keep a spatial index
+ * of them, so that painting and picking only need to visit the
+ * children intersecting the region of the stage being drawn
+ */
+#define CHILD_INDEX_MIN_CHILDREN        64
 
-/* This is the same as clutter_actor_add_effect except that it doesn't
-   queue a redraw and it doesn't notify on the effect property */
 static void
-_clutter_actor_add_effect_internal (ClutterActor  *self,
-                                    ClutterEffect *effect)
+clutter_actor_remove_from_child_index (ClutterActor *self)
 {
   ClutterActorPrivate *priv = self->priv;
 
-  if (priv->effects == NULL)
-    {
-      priv->effects = g_object_new (CLUTTER_TYPE_META_GROUP, NULL);
-      priv->effects->actor = self;
-    }
+  if (priv->child_index_leaf < 0)
+    return;
 
-  _clutter_meta_group_add_meta (priv->effects, CLUTTER_ACTOR_META (effect));
+  g_assert (priv->parent != NULL && priv->parent->priv->child_index != NULL);
+
+  _clutter_spatial_index_remove (priv->parent->priv->child_index,
+                                 priv->child_index_leaf);
+  priv->child_index_leaf = -1;
 }
 
-/* This is the same as clutter_actor_remove_effect except that it doesn't
-   queue a redraw and it doesn't notify on the effect property */
 static void
-_clutter_actor_remove_effect_internal (ClutterActor  *self,
-                                       ClutterEffect *effect)
+clutter_actor_invalidate_transform (ClutterActor *self)
 {
-  ClutterActorPrivate *priv = self->priv;
+  self->priv->transform_valid = FALSE;
 
-  if (priv->effects == NULL)
-    return;
+  /* the volume of the parent includes the transformed volume */
+  clutter_actor_invalidate_paint_volume (self);
 
-  _clutter_meta_group_remove_meta (priv->effects, CLUTTER_ACTOR_META (effect));
+  /* the descendants notice that the serial of their parent changed
+   * the next time their stage transformation is used
+   */
+  self->priv->stage_transform_serial = 0;
 
-  if (_clutter_meta_group_peek_metas (priv->effects) == NULL)
-    g_clear_object (&priv->effects);
+  /* the box inside the index of the parent is transformed */
+  clutter_actor_remove_from_child_index (self);
 }
 
-static gboolean
-needs_flatten_effect (ClutterActor *self)
+static void
+clutter_actor_destroy_child_index (ClutterActor *self)
 {
   ClutterActorPrivate *priv = self->priv;
+  ClutterActor *iter;
 
-  if (G_UNLIKELY (clutter_paint_debug_flags &
-                  CLUTTER_DEBUG_DISABLE_OFFSCREEN_REDIRECT))
-    return FALSE;
+  if (priv->child_index == NULL)
+    return;
 
-  if (priv->offscreen_redirect & CLUTTER_OFFSCREEN_REDIRECT_ALWAYS)
-    return TRUE;
-  else if (priv->offscreen_redirect & CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_OPACITY)
-    {
-      if (clutter_actor_get_paint_opacity (self) < 255 &&
-          clutter_actor_has_overlaps (self))
-        return TRUE;
-    }
+  CLUTTER_NOTE (CLIPPING, "Destroying the index of the children of '%s'",
+                _clutter_actor_get_debug_name (self));
 
-  return FALSE;
+  for (iter = priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    iter->priv->child_index_leaf = -1;
+
+  _clutter_spatial_index_free (priv->child_index);
+  priv->child_index = NULL;
 }
 
+/* Adds @child to the index of @self, using the paint volume of @child
+ * unioned with its allocation, so that the box covers both what the
+ * child paints and what it picks.
+ */
 static void
-add_or_remove_flatten_effect (ClutterActor *self)
+clutter_actor_add_to_child_index (ClutterActor *self,
+                                  ClutterActor *child)
 {
-  ClutterActorPrivate *priv = self->priv;
+  const ClutterPaintVolume *child_pv;
+  ClutterPaintVolume pv;
+  ClutterActorBox box;
+  int i;
 
-  /* Add or remove the flatten effect depending on the
-     offscreen-redirect property. */
-  if (needs_flatten_effect (self))
-    {
-      if (priv->flatten_effect == NULL)
-        {
-          ClutterActorMeta *actor_meta;
-          gint priority;
+  child_pv = clutter_actor_get_paint_volume (child);
+  if (child_pv == NULL)
+    return;
 
-          priv->flatten_effect = _clutter_flatten_effect_new ();
-          /* Keep a reference to the effect so that we can queue
-             redraws from it */
-          g_object_ref_sink (priv->flatten_effect);
+  _clutter_paint_volume_copy_static (child_pv, &pv);
 
-          /* Set the priority of the effect to high so that it will
-             always be applied to the actor first. It uses an internal
-             priority so that it won't be visible to applications */
-          actor_meta = CLUTTER_ACTOR_META (priv->flatten_effect);
-          priority = CLUTTER_ACTOR_META_PRIORITY_INTERNAL_HIGH;
-          _clutter_actor_meta_set_priority (actor_meta, priority);
+  box.x1 = 0.f;
+  box.y1 = 0.f;
+  box.x2 = clutter_actor_box_get_width (&child->priv->allocation);
+  box.y2 = clutter_actor_box_get_height (&child->priv->allocation);
+  clutter_paint_volume_union_box (&pv, &box);
 
-          /* This will add the effect without queueing a redraw */
-          _clutter_actor_add_effect_internal (self, priv->flatten_effect);
-        }
-    }
-  else
+  _clutter_paint_volume_transform_relative (&pv, self);
+
+  /* we find the children by projecting the stage clip on the plane
+   * of the parent, so we can only index the children lying on it
+   */
+  if (!pv.is_2d)
+    goto out;
+
+  for (i = 0; i < 4; i++)
     {
-      if (priv->flatten_effect != NULL)
-        {
-          /* Destroy the effect so that it will lose its fbo cache of
-             the actor */
-          _clutter_actor_remove_effect_internal (self, priv->flatten_effect);
-          g_clear_object (&priv->flatten_effect);
-        }
+      if (fabsf (pv.vertices[i].z) > 0.0001f)
+        goto out;
     }
+
+  _clutter_paint_volume_get_bounding_box (&pv, &box);
+
+  child->priv->child_index_leaf =
+    _clutter_spatial_index_insert (self->priv->child_index, &box, child);
+
+out:
+  clutter_paint_volume_free (&pv);
 }
 
-static void
-clutter_actor_real_paint (ClutterActor *actor)
+static gboolean
+mark_child_index_hit (gpointer               data,
+                      const ClutterActorBox *box,
+                      gpointer               user_data)
 {
-  ClutterActorPrivate *priv = actor->priv;
-  ClutterActor *iter;
+  ClutterActor *child = data;
 
-  for (iter = priv->first_child;
-       iter != NULL;
-       iter = iter->priv->next_sibling)
-    {
-      CLUTTER_NOTE (PAINT, "Painting %s, child of %s, at { %.2f, %.2f - %.2f x %.2f }",
-                    _clutter_actor_get_debug_name (iter),
-                    _clutter_actor_get_debug_name (actor),
-                    iter->priv->allocation.x1,
-                    iter->priv->allocation.y1,
-                    iter->priv->allocation.x2 - iter->priv->allocation.x1,
-                    iter->priv->allocation.y2 - iter->priv->allocation.y1);
+  child->priv->child_index_hit = TRUE;
 
-      clutter_actor_paint (iter);
-    }
+  return TRUE;
 }
 
-static gboolean
-clutter_actor_paint_node (ClutterActor     *actor,
-                          ClutterPaintNode *root)
+/*< private >
+ * _clutter_actor_get_paint_clip_box:
+ * @self: a #ClutterActor
+ * @stage: the stage of @self
+ * @box: (out): return location for the clip box
+ *
+ * Retrieves the region of the stage being painted, or the position
+ * being picked, in the coordinate space of @self.
+ *
+ * Return value: %TRUE if the region could be computed; the whole
+ *   actor should be painted otherwise
+ */
+gboolean
+_clutter_actor_get_paint_clip_box (ClutterActor    *self,
+                                   ClutterStage    *stage,
+                                   ClutterActorBox *box)
 {
-  ClutterActorPrivate *priv = actor->priv;
-  ClutterActorBox box;
-  ClutterColor bg_color;
+  ClutterActorBox clip, result = { 0, };
+  CoglMatrix matrix;
+  float corners[8];
+  int i;
 
-  if (root == NULL)
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CULLING))
     return FALSE;
 
-  box.x1 = 0.f;
-  box.y1 = 0.f;
-  box.x2 = clutter_actor_box_get_width (&priv->allocation);
-  box.y2 = clutter_actor_box_get_height (&priv->allocation);
+  if (stage == NULL || in_clone_paint ())
+    return FALSE;
 
-  bg_color = priv->bg_color;
+  if (_clutter_context_get_pick_mode () != CLUTTER_PICK_NONE &&
+      !_clutter_stage_in_geometric_pick (stage))
+    return FALSE;
 
-  if (CLUTTER_ACTOR_IS_TOPLEVEL (actor))
+  if (cogl_get_draw_framebuffer () != _clutter_stage_get_active_framebuffer (stage))
+    return FALSE;
+
+  /* the projection of the plane of the actor on the stage must not
+   * have any perspective, otherwise the clip could be unprojected
+   * beyond the horizon
+   */
+  _clutter_actor_get_relative_transformation_matrix (self, NULL, &matrix);
+  if (fabsf (matrix.zx) > 0.0001f || fabsf (matrix.zy) > 0.0001f ||
+      matrix.wx != 0.f || matrix.wy != 0.f)
+    return FALSE;
+
+  _clutter_stage_get_clip_box (stage, &clip);
+
+  corners[0] = clip.x1; corners[1] = clip.y1;
+  corners[2] = clip.x2; corners[3] = clip.y1;
+  corners[4] = clip.x2; corners[5] = clip.y2;
+  corners[6] = clip.x1; corners[7] = clip.y2;
+
+  for (i = 0; i < 4; i++)
     {
-      ClutterPaintNode *node;
-      CoglFramebuffer *fb;
-      CoglBufferBit clear_flags;
+      float x, y;
 
-      fb = _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (actor));
+      if (!clutter_actor_transform_stage_point (self,
+                                                corners[i * 2],
+                                                corners[i * 2 + 1],
+                                                &x, &y))
+        return FALSE;
 
-      if (clutter_stage_get_use_alpha (CLUTTER_STAGE (actor)))
+      if (i == 0)
         {
-          bg_color.alpha = priv->opacity
-                         * priv->bg_color.alpha
-                         / 255;
+          result.x1 = result.x2 = x;
+          result.y1 = result.y2 = y;
         }
       else
-        bg_color.alpha = 255;
-
-      CLUTTER_NOTE (PAINT, "Stage clear color: (%d, %d, %d, %d)",
-                    bg_color.red,
-                    bg_color.green,
-                    bg_color.blue,
-                    bg_color.alpha);
-
-      clear_flags = COGL_BUFFER_BIT_DEPTH;
-      if (!clutter_stage_get_no_clear_hint (CLUTTER_STAGE (actor)))
-        clear_flags |= COGL_BUFFER_BIT_COLOR;
-
-      node = _clutter_root_node_new (fb, &bg_color, clear_flags);
-      clutter_paint_node_set_name (node, "stageClear");
-      clutter_paint_node_add_rectangle (node, &box);
-      clutter_paint_node_add_child (root, node);
-      clutter_paint_node_unref (node);
+        {
+          result.x1 = MIN (result.x1, x);
+          result.y1 = MIN (result.y1, y);
+          result.x2 = MAX (result.x2, x);
+          result.y2 = MAX (result.y2, y);
+        }
     }
-  else if (priv->bg_color_set &&
-           !clutter_color_equal (&priv->bg_color, CLUTTER_COLOR_Transparent))
-    {
-      ClutterPaintNode *node;
 
-      bg_color.alpha = clutter_actor_get_paint_opacity_internal (actor)
-                     * priv->bg_color.alpha
-                     / 255;
+  /* account for the rounding inside transform_stage_point() */
+  result.x1 -= 1.f;
+  result.y1 -= 1.f;
+  result.x2 += 1.f;
+  result.y2 += 1.f;
 
-      node = clutter_color_node_new (&bg_color);
-      clutter_paint_node_set_name (node, "backgroundColor");
-      clutter_paint_node_add_rectangle (node, &box);
-      clutter_paint_node_add_child (root, node);
-      clutter_paint_node_unref (node);
-    }
+  *box = result;
 
-  if (priv->content != NULL)
-    _clutter_content_paint_content (priv->content, actor, root);
+  return TRUE;
+}
 
-  if (CLUTTER_ACTOR_GET_CLASS (actor)->paint_node != NULL)
-    CLUTTER_ACTOR_GET_CLASS (actor)->paint_node (actor, root);
+/* Queries the index of the children of @self using the region of the
+ * stage being painted, or the position being picked, and sets the
+ * child_index_hit flag on the matching children; returns %FALSE if
+ * the index cannot be used, and all the children should be visited.
+ */
+static gboolean
+clutter_actor_query_child_index (ClutterActor *self,
+                                 ClutterStage *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box;
 
-  if (clutter_paint_node_get_n_children (root) == 0)
-    return FALSE;
+  if (priv->child_index == NULL)
+    {
+      if (priv->n_children < CHILD_INDEX_MIN_CHILDREN)
+        return FALSE;
 
-#ifdef CLUTTER_ENABLE_DEBUG
-  if (CLUTTER_HAS_DEBUG (PAINT))
+      CLUTTER_NOTE (CLIPPING, "Creating an index for the %d children of '%s'",
+                    priv->n_children,
+                    _clutter_actor_get_debug_name (self));
+
+      priv->child_index = _clutter_spatial_index_new ();
+    }
+  else if (priv->n_children < CHILD_INDEX_MIN_CHILDREN / 2)
     {
-      /* dump the tree only if we have one */
-      _clutter_paint_node_dump_tree (root);
+      clutter_actor_destroy_child_index (self);
+      return FALSE;
     }
-#endif /* CLUTTER_ENABLE_DEBUG */
 
-  _clutter_paint_node_paint (root);
+  if (!_clutter_actor_get_paint_clip_box (self, stage, &box))
+    return FALSE;
+
+  _clutter_spatial_index_query (priv->child_index, &box,
+                                mark_child_index_hit,
+                                NULL);
 
   return TRUE;
 }
 
-/**
- * clutter_actor_paint:
- * @self: A #ClutterActor
- *
- * Renders the actor to display.
- *
- * This function should not be called directly by applications.
- * Call clutter_actor_queue_redraw() to queue paints, instead.
- *
- * This function is context-aware, and will either cause a
- * regular paint or a pick paint.
+/*< private >
+ * _clutter_actor_paint_children:
+ * @self: a #ClutterActor
  *
- * This function will emit the #ClutterActor::paint signal or
- * the #ClutterActor::pick signal, depending on the context.
+ * Paints, or picks, the children of @self in order.
  *
- * This function does not paint the actor if the actor is set to 0,
- * unless it is performing a pick paint.
+ * Containers with many children use a spatial index to skip the
+ * children that are outside of the region of the stage being painted
+ * without having to transform and cull each one of them.
  */
 void
-clutter_actor_paint (ClutterActor *self)
+_clutter_actor_paint_children (ClutterActor *self)
 {
-  ClutterActorPrivate *priv;
-  ClutterPickMode pick_mode;
-  gboolean clip_set = FALSE;
-  gboolean shader_applied = FALSE;
+  ClutterActorPrivate *priv = self->priv;
   ClutterStage *stage;
+  ClutterActor *iter;
+  gboolean use_index, update_index;
 
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
-    return;
+  use_index = clutter_actor_query_child_index (self, stage);
+  update_index = priv->child_index != NULL &&
+                 _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE;
 
-  priv = self->priv;
+  for (iter = priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    {
+      ClutterActorPrivate *child_priv = iter->priv;
 
-  pick_mode = _clutter_context_get_pick_mode ();
+      /* indexed children are only visited if the query found them */
+      if (use_index &&
+          child_priv->child_index_leaf >= 0 &&
+          !child_priv->child_index_hit)
+        continue;
 
-  if (pick_mode == CLUTTER_PICK_NONE)
-    priv->propagated_one_redraw = FALSE;
+      child_priv->child_index_hit = FALSE;
 
-  /* It's an important optimization that we consider painting of
-   * actors with 0 opacity to be a NOP... */
-  if (pick_mode == CLUTTER_PICK_NONE &&
-      /* ignore top-levels, since they might be transparent */
-      !CLUTTER_ACTOR_IS_TOPLEVEL (self) &&
-      /* Use the override opacity if its been set */
-      ((priv->opacity_override >= 0) ?
-       priv->opacity_override : priv->opacity) == 0)
-    return;
+      CLUTTER_NOTE (PAINT, "Painting %s, child of %s, at { %.2f, %.2f - %.2f x %.2f }",
+                    _clutter_actor_get_debug_name (iter),
+                    _clutter_actor_get_debug_name (self),
+                    child_priv->allocation.x1,
+                    child_priv->allocation.y1,
+                    child_priv->allocation.x2 - child_priv->allocation.x1,
+                    child_priv->allocation.y2 - child_priv->allocation.y1);
 
-  /* if we aren't paintable (not in a toplevel with all
-   * parents paintable) then do nothing.
-   */
-  if (!CLUTTER_ACTOR_IS_MAPPED (self))
-    return;
+      clutter_actor_paint (iter);
 
-  stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
+      /* a child that queued a redraw while painting has already
+       * changed, so we wait until it is painted again
+       */
+      if (update_index &&
+          child_priv->child_index_leaf < 0 &&
+          !child_priv->propagated_one_redraw &&
+          CLUTTER_ACTOR_IS_MAPPED (iter))
+        clutter_actor_add_to_child_index (self, iter);
+    }
+}
 
-  /* mark that we are in the paint process */
-  CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
+static void
+clutter_actor_invalidate_pick_cache (ClutterActor *self)
+{
+  ClutterActor *stage = _clutter_actor_get_stage_internal (self);
 
-  cogl_push_matrix ();
+  if (stage != NULL)
+    _clutter_stage_invalidate_pick_cache (CLUTTER_STAGE (stage));
+}
 
-  if (priv->enable_model_view_transform)
-    {
-      CoglMatrix matrix;
+static inline gboolean
+actor_has_shader_data (ClutterActor *self)
+{
+  return g_object_get_qdata (G_OBJECT (self), quark_shader_data) != NULL;
+}
 
-      /* XXX: It could be better to cache the modelview with the actor
-       * instead of progressively building up the transformations on
-       * the matrix stack every time we paint. */
-      cogl_get_modelview_matrix (&matrix);
-      _clutter_actor_apply_modelview_transform (self, &matrix);
+guint32
+_clutter_actor_get_pick_id (ClutterActor *self)
+{
+  if (self->priv->pick_id < 0)
+    return 0;
 
-#ifdef CLUTTER_ENABLE_DEBUG
-      /* Catch when out-of-band transforms have been made by actors not as part
-       * of an apply_transform vfunc... */
-      if (G_UNLIKELY (clutter_debug_flags & CLUTTER_DEBUG_OOB_TRANSFORMS))
-        {
-          CoglMatrix expected_matrix;
+  return self->priv->pick_id;
+}
 
-          _clutter_actor_get_relative_transformation_matrix (self, NULL,
-                                                             &expected_matrix);
+/* This is the same as clutter_actor_add_effect except that it doesn't
+   queue a redraw and it doesn't notify on the effect property */
+static void
+_clutter_actor_add_effect_internal (ClutterActor  *self,
+                                    ClutterEffect *effect)
+{
+  ClutterActorPrivate *priv = self->priv;
 
-          if (!cogl_matrix_equal (&matrix, &expected_matrix))
-            {
-              GString *buf = g_string_sized_new (1024);
-              ClutterActor *parent;
+  if (priv->effects == NULL)
+    {
+      priv->effects = g_object_new (CLUTTER_TYPE_META_GROUP, NULL);
+      priv->effects->actor = self;
+    }
 
-              parent = self;
-              while (parent != NULL)
-                {
-                  g_string_append (buf, _clutter_actor_get_debug_name (parent));
+  _clutter_meta_group_add_meta (priv->effects, CLUTTER_ACTOR_META (effect));
+}
 
-                  if (parent->priv->parent != NULL)
-                    g_string_append (buf, "->");
+/* This is the same as clutter_actor_remove_effect except that it doesn't
+   queue a redraw and it doesn't notify on the effect property */
+static void
+_clutter_actor_remove_effect_internal (ClutterActor  *self,
+                                       ClutterEffect *effect)
+{
+  ClutterActorPrivate *priv = self->priv;
 
-                  parent = parent->priv->parent;
-                }
+  if (priv->effects == NULL)
+    return;
 
-              g_warning ("Unexpected transform found when painting actor "
-                         "\"%s\". This will be caused by one of the actor's "
-                         "ancestors (%s) using the Cogl API directly to transform "
-                         "children instead of using ::apply_transform().",
-                         _clutter_actor_get_debug_name (self),
-                         buf->str);
+  _clutter_meta_group_remove_meta (priv->effects, CLUTTER_ACTOR_META (effect));
 
-              g_string_free (buf, TRUE);
-            }
-        }
-#endif /* CLUTTER_ENABLE_DEBUG */
+  if (_clutter_meta_group_peek_metas (priv->effects) == NULL)
+    g_clear_object (&priv->effects);
+}
 
-      cogl_set_modelview_matrix (&matrix);
-    }
+static gboolean
+needs_flatten_effect (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterOffscreenRedirect redirect;
 
-  if (priv->has_clip)
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_DISABLE_OFFSCREEN_REDIRECT))
+    return FALSE;
+
+  redirect = clutter_actor_get_offscreen_info_or_defaults (self)->offscreen_redirect;
+
+  if (redirect & CLUTTER_OFFSCREEN_REDIRECT_ALWAYS)
+    return TRUE;
+  else if (redirect & CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_OPACITY)
     {
-      CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
-      cogl_framebuffer_push_rectangle_clip (fb,
-                                            priv->clip.origin.x,
-                                            priv->clip.origin.y,
-                                            priv->clip.origin.x + priv->clip.size.width,
-                                            priv->clip.origin.y + priv->clip.size.height);
-      clip_set = TRUE;
+      if (clutter_actor_get_paint_opacity (self) < 255 &&
+          clutter_actor_has_overlaps (self))
+        return TRUE;
     }
-  else if (priv->clip_to_allocation)
-    {
-      CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
-      gfloat width, height;
 
-      width  = priv->allocation.x2 - priv->allocation.x1;
-      height = priv->allocation.y2 - priv->allocation.y1;
+  if (priv->raster_cached)
+    return TRUE;
 
-      cogl_framebuffer_push_rectangle_clip (fb, 0, 0, width, height);
-      clip_set = TRUE;
-    }
+  return FALSE;
+}
 
-  if (pick_mode == CLUTTER_PICK_NONE)
+static void
+add_or_remove_flatten_effect (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  OffscreenInfo *info;
+
+  /* Add or remove the flatten effect depending on the
+     offscreen-redirect property. */
+  if (needs_flatten_effect (self))
     {
-      /* We check whether we need to add the flatten effect before
-         each paint so that we can avoid having a mechanism for
-         applications to notify when the value of the
-         has_overlaps virtual changes. */
-      add_or_remove_flatten_effect (self);
-    }
+      info = clutter_actor_get_offscreen_info (self);
 
-  /* We save the current paint volume so that the next time the
-   * actor queues a redraw we can constrain the redraw to just
-   * cover the union of the new bounding box and the old.
-   *
-   * We also fetch the current paint volume to perform culling so
-   * we can avoid painting actors outside the current clip region.
-   *
-   * If we are painting inside a clone, we should neither update
-   * the paint volume or use it to cull painting, since the paint
-   * box represents the location of the source actor on the
-   * screen.
-   *
-   * XXX: We are starting to do a lot of vertex transforms on
-   * the CPU in a typical paint, so at some point we should
-   * audit these and consider caching some things.
-   *
-   * NB: We don't perform culling while picking at this point because
-   * clutter-stage.c doesn't setup the clipping planes appropriately.
-   *
-   * NB: We don't want to update the last-paint-volume during picking
-   * because the last-paint-volume is used to determine the old screen
-   * space location of an actor that has moved so we can know the
-   * minimal region to redraw to clear an old view of the actor. If we
-   * update this during picking then by the time we come around to
-   * paint then the last-paint-volume would likely represent the new
-   * actor position not the old.
-   */
-  if (!in_clone_paint () && pick_mode == CLUTTER_PICK_NONE)
-    {
-      gboolean success;
-      /* annoyingly gcc warns if uninitialized even though
-       * the initialization is redundant :-( */
-      ClutterCullResult result = CLUTTER_CULL_RESULT_IN;
+      if (info->flatten_effect == NULL)
+        {
+          ClutterActorMeta *actor_meta;
+          gint priority;
 
-      if (G_LIKELY ((clutter_paint_debug_flags &
-                     (CLUTTER_DEBUG_DISABLE_CULLING |
-                      CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)) !=
-                    (CLUTTER_DEBUG_DISABLE_CULLING |
-                     CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)))
-        _clutter_actor_update_last_paint_volume (self);
+          info->flatten_effect = _clutter_flatten_effect_new ();
+          /* Keep a reference to the effect so that we can queue
+             redraws from it */
+          g_object_ref_sink (info->flatten_effect);
 
-      success = cull_actor (self, &result);
+          /* Set the priority of the effect to high so that it will
+             always be applied to the actor first. It uses an internal
+             priority so that it won't be visible to applications */
+          actor_meta = CLUTTER_ACTOR_META (info->flatten_effect);
+          priority = CLUTTER_ACTOR_META_PRIORITY_INTERNAL_HIGH;
+          _clutter_actor_meta_set_priority (actor_meta, priority);
 
-      if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS))
-        _clutter_actor_paint_cull_result (self, success, result);
-      else if (result == CLUTTER_CULL_RESULT_OUT && success)
-        goto done;
+          /* This will add the effect without queueing a redraw */
+          _clutter_actor_add_effect_internal (self, info->flatten_effect);
+        }
     }
-
-  if (priv->effects == NULL)
+  else
     {
-      if (pick_mode == CLUTTER_PICK_NONE &&
-          actor_has_shader_data (self))
+      info = priv->offscreen_info;
+
+      if (info != NULL && info->flatten_effect != NULL)
         {
-          _clutter_actor_shader_pre_paint (self, FALSE);
-          shader_applied = TRUE;
+          /* Destroy the effect so that it will lose its fbo cache of
+             the actor */
+          _clutter_actor_remove_effect_internal (self, info->flatten_effect);
+          g_clear_object (&info->flatten_effect);
         }
-
-      priv->next_effect_to_paint = NULL;
     }
-  else
-    priv->next_effect_to_paint =
-      _clutter_meta_group_peek_metas (priv->effects);
+}
 
-  clutter_actor_continue_paint (self);
+/* the number of paints without damage before an actor using
+ * CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC is flattened
+ */
+#define RASTER_CACHE_STATIC_PAINTS      3
 
-  if (shader_applied)
-    _clutter_actor_shader_post_paint (self);
+/* Decides whether the flattened image of @self should be cached,
+ * before painting it. Any damage to the subtree of @self drops the
+ * cached image, which is only created again after the subtree has
+ * been static for a few frames
+ */
+static void
+clutter_actor_update_raster_cache (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  OffscreenInfo *info = priv->offscreen_info;
+  ClutterActor *stage;
+  ClutterActorBox box;
+  gboolean damaged;
 
-  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_PAINT_VOLUMES &&
-                  pick_mode == CLUTTER_PICK_NONE))
-    _clutter_actor_draw_paint_volume (self);
+  if (info == NULL ||
+      (info->offscreen_redirect & CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC) == 0)
+    return;
 
-done:
-  /* If we make it here then the actor has run through a complete
-     paint run including all the effects so it's no longer dirty */
-  if (pick_mode == CLUTTER_PICK_NONE)
-    priv->is_dirty = FALSE;
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return;
 
-  if (clip_set)
+  /* a redraw queued only for an effect can reuse the cached image */
+  damaged = priv->is_dirty && priv->effect_to_redraw == NULL;
+
+  if (damaged)
     {
-      CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
+      info->static_paints = 0;
 
-      cogl_framebuffer_pop_clip (fb);
+      if (priv->raster_cached)
+        {
+          CLUTTER_NOTE (PAINT, "Dropping the raster cache of '%s'",
+                        _clutter_actor_get_debug_name (self));
+
+          _clutter_stage_release_raster_cache (CLUTTER_STAGE (stage), self);
+          priv->raster_cached = FALSE;
+        }
+
+      return;
     }
 
-  cogl_pop_matrix ();
+  if (priv->raster_cached)
+    {
+      _clutter_stage_touch_raster_cache (CLUTTER_STAGE (stage), self);
+      return;
+    }
 
-  /* paint sequence complete */
-  CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
+  if (info->static_paints < RASTER_CACHE_STATIC_PAINTS)
+    info->static_paints += 1;
+
+  if (info->static_paints < RASTER_CACHE_STATIC_PAINTS)
+    return;
+
+  /* the offscreen image covers the paint box */
+  if (!clutter_actor_get_paint_box (self, &box))
+    return;
+
+  priv->raster_cached =
+    _clutter_stage_reserve_raster_cache (CLUTTER_STAGE (stage), self,
+                                         ceilf (clutter_actor_box_get_width (&box)),
+                                         ceilf (clutter_actor_box_get_height (&box)));
+
+  if (priv->raster_cached)
+    CLUTTER_NOTE (PAINT, "Caching the static subtree of '%s'",
+                  _clutter_actor_get_debug_name (self));
+  else
+    {
+      /* try again when the actor changes */
+      info->static_paints = 0;
+    }
 }
 
-/**
- * clutter_actor_continue_paint:
- * @self: A #ClutterActor
+/*< private >
+ * _clutter_actor_evict_raster_cache:
+ * @self: a #ClutterActor
  *
- * Run the next stage of the paint sequence. This function should only
- * be called within the implementation of the ‘run’ virtual of a
- * #ClutterEffect. It will cause the run method of the next effect to
- * be applied, or it will paint the actual actor if the current effect
- * is the last effect in the chain.
+ * Drops the cached image of @self, after the stage evicted it.
  *
- * Since: 1.8
+ * Since the eviction can happen while painting another actor, the
+ * flattening effect is only removed if @self is not being painted;
+ * otherwise, it is removed when @self is painted next.
  */
 void
-clutter_actor_continue_paint (ClutterActor *self)
+_clutter_actor_evict_raster_cache (ClutterActor *self)
 {
-  ClutterActorPrivate *priv;
+  ClutterActorPrivate *priv = self->priv;
 
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
-  /* This should only be called from with in the ‘run’ implementation
-     of a ClutterEffect */
-  g_return_if_fail (CLUTTER_ACTOR_IN_PAINT (self));
+  priv->raster_cached = FALSE;
 
-  priv = self->priv;
+  if (priv->offscreen_info != NULL)
+    priv->offscreen_info->static_paints = 0;
 
-  /* Skip any effects that are disabled */
-  while (priv->next_effect_to_paint &&
-         !clutter_actor_meta_get_enabled (priv->next_effect_to_paint->data))
-    priv->next_effect_to_paint = priv->next_effect_to_paint->next;
+  if (!CLUTTER_ACTOR_IN_PAINT (self))
+    add_or_remove_flatten_effect (self);
+}
 
-  /* If this has come from the last effect then we'll just paint the
-     actual actor */
-  if (priv->next_effect_to_paint == NULL)
-    {
-      if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
-        {
-          ClutterPaintNode *dummy;
+static void
+clutter_actor_real_paint (ClutterActor *actor)
+{
+  _clutter_actor_paint_children (actor);
+}
 
-          /* XXX - this will go away in 2.0, when we can get rid of this
-           * stuff and switch to a pure retained render tree of PaintNodes
-           * for the entire frame, starting from the Stage; the paint()
-           * virtual function can then be called directly.
-           */
-          dummy = _clutter_dummy_node_new (self);
-          clutter_paint_node_set_name (dummy, "Root");
+static gboolean
+clutter_actor_paint_node (ClutterActor     *actor,
+                          ClutterPaintNode *root)
+{
+  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorBox box;
+  ClutterColor bg_color;
 
-          /* XXX - for 1.12, we use the return value of paint_node() to
-           * decide whether we should emit the ::paint signal.
-           */
-          clutter_actor_paint_node (self, dummy);
-          clutter_paint_node_unref (dummy);
+  if (root == NULL)
+    return FALSE;
 
-          /* XXX:2.0 - Call the paint() virtual directly */
-          g_signal_emit (self, actor_signals[PAINT], 0);
-        }
-      else
-        {
-          ClutterColor col = { 0, };
+  box.x1 = 0.f;
+  box.y1 = 0.f;
+  box.x2 = clutter_actor_box_get_width (&priv->allocation);
+  box.y2 = clutter_actor_box_get_height (&priv->allocation);
 
-          _clutter_id_to_color (_clutter_actor_get_pick_id (self), &col);
+  bg_color = priv->bg_color;
 
-          /* Actor will then paint silhouette of itself in supplied
-           * color.  See clutter_stage_get_actor_at_pos() for where
-           * picking is enabled.
-           *
-           * XXX:2.0 - Call the pick() virtual directly
-           */
-          g_signal_emit (self, actor_signals[PICK], 0, &col);
-        }
-    }
-  else
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (actor))
     {
-      ClutterEffect *old_current_effect;
-      ClutterEffectPaintFlags run_flags = 0;
-
-      /* Cache the current effect so that we can put it back before
-         returning */
-      old_current_effect = priv->current_effect;
+      ClutterPaintNode *node;
+      CoglFramebuffer *fb;
+      CoglBufferBit clear_flags;
 
-      priv->current_effect = priv->next_effect_to_paint->data;
-      priv->next_effect_to_paint = priv->next_effect_to_paint->next;
+      fb = _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (actor));
 
-      if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+      if (clutter_stage_get_use_alpha (CLUTTER_STAGE (actor)))
         {
-          if (priv->is_dirty)
-            {
-              /* If there's an effect queued with this redraw then all
-                 effects up to that one will be considered dirty. It
-                 is expected the queued effect will paint the cached
-                 image and not call clutter_actor_continue_paint again
-                 (although it should work ok if it does) */
-              if (priv->effect_to_redraw == NULL ||
-                  priv->current_effect != priv->effect_to_redraw)
-                run_flags |= CLUTTER_EFFECT_PAINT_ACTOR_DIRTY;
-            }
-
-          _clutter_effect_paint (priv->current_effect, run_flags);
+          bg_color.alpha = priv->opacity
+                         * priv->bg_color.alpha
+                         / 255;
         }
       else
-        {
-          /* We can't determine when an actor has been modified since
-             its last pick so lets just assume it has always been
-             modified */
-          run_flags |= CLUTTER_EFFECT_PAINT_ACTOR_DIRTY;
+        bg_color.alpha = 255;
 
-          _clutter_effect_pick (priv->current_effect, run_flags);
-        }
+      CLUTTER_NOTE (PAINT, "Stage clear color: (%d, %d, %d, %d)",
+                    bg_color.red,
+                    bg_color.green,
+                    bg_color.blue,
+                    bg_color.alpha);
 
-      priv->current_effect = old_current_effect;
+      clear_flags = COGL_BUFFER_BIT_DEPTH;
+      if (!clutter_stage_get_no_clear_hint (CLUTTER_STAGE (actor)))
+        clear_flags |= COGL_BUFFER_BIT_COLOR;
+
+      node = _clutter_root_node_new (fb, &bg_color, clear_flags);
+      clutter_paint_node_set_name (node, "stageClear");
+      clutter_paint_node_add_rectangle (node, &box);
+      clutter_paint_node_add_child (root, node);
+      clutter_paint_node_unref (node);
     }
-}
+  else if (priv->bg_color_set &&
+           !clutter_color_equal (&priv->bg_color, CLUTTER_COLOR_Transparent))
+    {
+      ClutterPaintNode *node;
 
-static void
-_clutter_actor_stop_transitions (ClutterActor *self)
-{
-  const ClutterAnimationInfo *info;
-  GHashTableIter iter;
-  gpointer value;
+      bg_color.alpha = clutter_actor_get_paint_opacity_internal (actor)
+                     * priv->bg_color.alpha
+                     / 255;
 
-  info = _clutter_actor_get_animation_info_or_defaults (self);
-  if (info->transitions == NULL)
-    return;
+      node = clutter_color_node_new (&bg_color);
+      clutter_paint_node_set_name (node, "backgroundColor");
+      clutter_paint_node_add_rectangle (node, &box);
+      clutter_paint_node_add_child (root, node);
+      clutter_paint_node_unref (node);
+    }
 
-  g_hash_table_iter_init (&iter, info->transitions);
-  while (g_hash_table_iter_next (&iter, NULL, &value))
-    {
-      TransitionClosure *closure = value;
+  if (priv->content != NULL)
+    _clutter_content_paint_content (priv->content, actor, root);
 
-      /* implicit transitions, and automatically managed explicit ones,
-       * should be removed at this point
-       */
-      if (closure->is_implicit ||
-          clutter_transition_get_remove_on_complete (closure->transition))
-        {
-          g_hash_table_iter_remove (&iter);
-        }
-      else
-        {
-          /* otherwise we stop it, and the transition will be removed
-           * later, either by the actor's destruction or by explicit
-           * removal
-           */
-          clutter_timeline_stop (CLUTTER_TIMELINE (closure->transition));
-        }
+  if (CLUTTER_ACTOR_GET_CLASS (actor)->paint_node != NULL)
+    CLUTTER_ACTOR_GET_CLASS (actor)->paint_node (actor, root);
+
+  if (clutter_paint_node_get_n_children (root) == 0)
+    return FALSE;
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (CLUTTER_HAS_DEBUG (PAINT))
+    {
+      /* dump the tree only if we have one */
+      _clutter_paint_node_dump_tree (root);
     }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  _clutter_paint_node_paint (root);
+
+  return TRUE;
 }
 
-static ClutterActorTraverseVisitFlags
-invalidate_queue_redraw_entry (ClutterActor *self,
-                               int           depth,
-                               gpointer      user_data)
+static void
+clutter_actor_release_paint_node (ClutterActor *self)
 {
   ClutterActorPrivate *priv = self->priv;
 
-  if (priv->queue_redraw_entry != NULL)
-    {
-      _clutter_stage_queue_redraw_entry_invalidate (priv->queue_redraw_entry);
-      priv->queue_redraw_entry = NULL;
-    }
+  if (priv->retained_paint_node == NULL)
+    return;
 
-  return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
+  clutter_paint_node_unref (priv->retained_paint_node);
+  priv->retained_paint_node = NULL;
+  priv->retained_framebuffer = NULL;
 }
 
-static inline void
-remove_child (ClutterActor *self,
-              ClutterActor *child)
+/*< private >
+ * clutter_actor_paint_retained_node:
+ * @self: a #ClutterActor
+ *
+ * Paints the paint nodes of @self, replaying the tree built during
+ * a previous paint if the actor did not change in the meantime.
+ *
+ * The tree is rebuilt if the actor queued a redraw on itself, if the
+ * size of its allocation changed, or if it is going to be painted
+ * with a different opacity or on a different framebuffer. Toplevels
+ * are never retained, as their tree contains the clear of the stage.
+ */
+static void
+clutter_actor_paint_retained_node (ClutterActor *self)
 {
-  ClutterActor *prev_sibling, *next_sibling;
+  ClutterActorPrivate *priv = self->priv;
+  CoglFramebuffer *framebuffer;
+  ClutterPaintNode *root;
+  guint8 paint_opacity;
 
-  prev_sibling = child->priv->prev_sibling;
-  next_sibling = child->priv->next_sibling;
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self) ||
+      G_UNLIKELY (clutter_paint_debug_flags &
+                  CLUTTER_DEBUG_DISABLE_RETAINED_PAINT_NODES))
+    {
+      root = _clutter_dummy_node_new (self);
+      clutter_paint_node_set_name (root, "Root");
 
-  if (prev_sibling != NULL)
-    prev_sibling->priv->next_sibling = next_sibling;
+      clutter_actor_paint_node (self, root);
+      clutter_paint_node_unref (root);
+      return;
+    }
 
-  if (next_sibling != NULL)
-    next_sibling->priv->prev_sibling = prev_sibling;
+  framebuffer = _clutter_actor_get_active_framebuffer (self);
+  paint_opacity = clutter_actor_get_paint_opacity_internal (self);
 
-  if (self->priv->first_child == child)
-    self->priv->first_child = next_sibling;
+  if (priv->retained_paint_node != NULL &&
+      (priv->retained_framebuffer != framebuffer ||
+       priv->retained_paint_opacity != paint_opacity))
+    clutter_actor_release_paint_node (self);
 
-  if (self->priv->last_child == child)
-    self->priv->last_child = prev_sibling;
+  if (priv->retained_paint_node != NULL)
+    {
+      root = priv->retained_paint_node;
 
-  child->priv->parent = NULL;
-  child->priv->prev_sibling = NULL;
-  child->priv->next_sibling = NULL;
+      if (clutter_paint_node_get_n_children (root) > 0)
+        _clutter_paint_node_paint (root);
+
+      return;
+    }
+
+  CLUTTER_NOTE (PAINT, "Building the paint nodes of '%s'",
+                _clutter_actor_get_debug_name (self));
+
+  root = _clutter_dummy_node_new (self);
+  clutter_paint_node_set_name (root, "Root");
+
+  clutter_actor_paint_node (self, root);
+
+  priv->retained_paint_node = root;
+  priv->retained_framebuffer = framebuffer;
+  priv->retained_paint_opacity = paint_opacity;
 }
 
-typedef enum {
-  REMOVE_CHILD_DESTROY_META       = 1 << 0,
-  REMOVE_CHILD_EMIT_PARENT_SET    = 1 << 1,
-  REMOVE_CHILD_EMIT_ACTOR_REMOVED = 1 << 2,
-  REMOVE_CHILD_CHECK_STATE        = 1 << 3,
-  REMOVE_CHILD_FLUSH_QUEUE        = 1 << 4,
-  REMOVE_CHILD_NOTIFY_FIRST_LAST  = 1 << 5,
-  REMOVE_CHILD_STOP_TRANSITIONS   = 1 << 6,
+/* the maximum number of opaque boxes tracked by an occlusion pass */
+#define MAX_OCCLUDERS   16
 
-  /* default flags for public API */
-  REMOVE_CHILD_DEFAULT_FLAGS      = REMOVE_CHILD_STOP_TRANSITIONS |
-                                    REMOVE_CHILD_DESTROY_META |
-                                    REMOVE_CHILD_EMIT_PARENT_SET |
-                                    REMOVE_CHILD_EMIT_ACTOR_REMOVED |
-                                    REMOVE_CHILD_CHECK_STATE |
-                                    REMOVE_CHILD_FLUSH_QUEUE |
-                                    REMOVE_CHILD_NOTIFY_FIRST_LAST,
+/* the serial of the last occlusion pass */
+static guint occlusion_serial = 0;
 
-  /* flags for legacy/deprecated API */
-  REMOVE_CHILD_LEGACY_FLAGS       = REMOVE_CHILD_STOP_TRANSITIONS |
-                                    REMOVE_CHILD_CHECK_STATE |
-                                    REMOVE_CHILD_FLUSH_QUEUE |
-                                    REMOVE_CHILD_EMIT_PARENT_SET |
-                                    REMOVE_CHILD_NOTIFY_FIRST_LAST
-} ClutterActorRemoveChildFlags;
+/* the actors painted and culled since the last reset; see
+ * _clutter_actor_get_paint_stats()
+ */
+static guint paint_stats_painted = 0;
+static guint paint_stats_culled = 0;
+
+typedef struct {
+  ClutterActorBox boxes[MAX_OCCLUDERS];
+  guint n_boxes;
+} OcclusionState;
+
+/* the serial of the last depth pass, and whether it is running */
+static guint depth_serial = 0;
+static gboolean depth_pass_active = FALSE;
 
 /*< private >
- * clutter_actor_remove_child_internal:
+ * clutter_actor_get_local_opaque_box:
  * @self: a #ClutterActor
- * @child: the child of @self that has to be removed
- * @flags: control the removal operations
+ * @local: (out): return location for the opaque box, in actor coordinates
  *
- * Removes @child from the list of children of @self.
+ * Retrieves the area of the actor that is fully covered when painting
+ * its background color or its content.
+ *
+ * Return value: %TRUE if the actor has an opaque area
  */
-static void
-clutter_actor_remove_child_internal (ClutterActor                 *self,
-                                     ClutterActor                 *child,
-                                     ClutterActorRemoveChildFlags  flags)
+static gboolean
+clutter_actor_get_local_opaque_box (ClutterActor    *self,
+                                    ClutterActorBox *local)
 {
-  ClutterActor *old_first, *old_last;
-  gboolean destroy_meta, emit_parent_set, emit_actor_removed, check_state;
-  gboolean flush_queue;
-  gboolean notify_first_last;
-  gboolean was_mapped;
-  gboolean stop_transitions;
-  GObject *obj;
-
-  destroy_meta = (flags & REMOVE_CHILD_DESTROY_META) != 0;
-  emit_parent_set = (flags & REMOVE_CHILD_EMIT_PARENT_SET) != 0;
-  emit_actor_removed = (flags & REMOVE_CHILD_EMIT_ACTOR_REMOVED) != 0;
-  check_state = (flags & REMOVE_CHILD_CHECK_STATE) != 0;
-  flush_queue = (flags & REMOVE_CHILD_FLUSH_QUEUE) != 0;
-  notify_first_last = (flags & REMOVE_CHILD_NOTIFY_FIRST_LAST) != 0;
-  stop_transitions = (flags & REMOVE_CHILD_STOP_TRANSITIONS) != 0;
-
-  obj = G_OBJECT (self);
-  g_object_freeze_notify (obj);
+  ClutterActorPrivate *priv = self->priv;
 
-  if (stop_transitions)
-    _clutter_actor_stop_transitions (child);
+  /* effects and shaders can change the way the actor is painted */
+  if (priv->effects != NULL || actor_has_shader_data (self))
+    return FALSE;
 
-  if (destroy_meta)
-    clutter_container_destroy_child_meta (CLUTTER_CONTAINER (self), child);
+  if (clutter_actor_get_paint_opacity_internal (self) != 255)
+    return FALSE;
 
-  if (check_state)
+  if (priv->bg_color_set && priv->bg_color.alpha == 255)
     {
-      was_mapped = CLUTTER_ACTOR_IS_MAPPED (child);
+      local->x1 = 0.f;
+      local->y1 = 0.f;
+      local->x2 = clutter_actor_box_get_width (&priv->allocation);
+      local->y2 = clutter_actor_box_get_height (&priv->allocation);
+    }
+  else if (priv->content != NULL &&
+           CLUTTER_IS_IMAGE (priv->content) &&
+           _clutter_image_is_opaque (CLUTTER_IMAGE (priv->content)))
+    {
+      clutter_actor_get_content_box (self, local);
 
-      /* we need to unrealize *before* we set parent_actor to NULL,
-       * because in an unrealize method actors are dissociating from the
-       * stage, which means they need to be able to
-       * clutter_actor_get_stage().
-       *
-       * yhis should unmap and unrealize, unless we're reparenting.
-       */
-      clutter_actor_update_map_state (child, MAP_STATE_MAKE_UNREALIZED);
+      local->x1 = MAX (local->x1, 0.f);
+      local->y1 = MAX (local->y1, 0.f);
+      local->x2 = MIN (local->x2, clutter_actor_box_get_width (&priv->allocation));
+      local->y2 = MIN (local->y2, clutter_actor_box_get_height (&priv->allocation));
     }
   else
-    was_mapped = FALSE;
+    return FALSE;
 
-  if (flush_queue)
+  if (priv->has_clip)
     {
-      /* We take this opportunity to invalidate any queue redraw entry
-       * associated with the actor and descendants since we won't be able to
-       * determine the appropriate stage after this.
-       *
-       * we do this after we updated the mapped state because actors might
-       * end up queueing redraws inside their mapped/unmapped virtual
-       * functions, and if we invalidate the redraw entry we could end up
-       * with an inconsistent state and weird memory corruption. see
-       * bugs:
-       *
-       *   http://bugzilla.clutter-project.org/show_bug.cgi?id=2621
-       *   https://bugzilla.gnome.org/show_bug.cgi?id=652036
-       */
-      _clutter_actor_traverse (child,
-                               0,
-                               invalidate_queue_redraw_entry,
-                               NULL,
-                               NULL);
+      local->x1 = MAX (local->x1, priv->clip.origin.x);
+      local->y1 = MAX (local->y1, priv->clip.origin.y);
+      local->x2 = MIN (local->x2, priv->clip.origin.x + priv->clip.size.width);
+      local->y2 = MIN (local->y2, priv->clip.origin.y + priv->clip.size.height);
     }
 
-  old_first = self->priv->first_child;
-  old_last = self->priv->last_child;
+  if (local->x2 <= local->x1 || local->y2 <= local->y1)
+    return FALSE;
 
-  remove_child (self, child);
+  return TRUE;
+}
 
-  self->priv->n_children -= 1;
+/*< private >
+ * clutter_actor_get_opaque_box:
+ * @self: a #ClutterActor
+ * @box: (out): return location for the opaque box, in stage coordinates
+ *
+ * Retrieves the axis-aligned area of the stage that the actor fully
+ * covers when painting its background color or its content.
+ *
+ * Return value: %TRUE if the actor has an opaque area
+ */
+static gboolean
+clutter_actor_get_opaque_box (ClutterActor    *self,
+                              ClutterActorBox *box)
+{
+  ClutterVertex verts_in[4];
+  ClutterVertex verts[4];
+  ClutterActorBox local;
 
-  self->priv->age += 1;
+  if (!clutter_actor_get_local_opaque_box (self, &local))
+    return FALSE;
 
-  /* if the child that got removed was visible and set to
-   * expand then we want to reset the parent's state in
-   * case the child was the only thing that was making it
-   * expand.
-   */
-  if (CLUTTER_ACTOR_IS_VISIBLE (child) &&
-      (child->priv->needs_compute_expand ||
-       child->priv->needs_x_expand ||
-       child->priv->needs_y_expand))
-    {
-      clutter_actor_queue_compute_expand (self);
-    }
+  verts_in[0].x = local.x1; verts_in[0].y = local.y1; verts_in[0].z = 0.f;
+  verts_in[1].x = local.x2; verts_in[1].y = local.y1; verts_in[1].z = 0.f;
+  verts_in[2].x = local.x2; verts_in[2].y = local.y2; verts_in[2].z = 0.f;
+  verts_in[3].x = local.x1; verts_in[3].y = local.y2; verts_in[3].z = 0.f;
 
-  /* clutter_actor_reparent() will emit ::parent-set for us */
-  if (emit_parent_set && !CLUTTER_ACTOR_IN_REPARENT (child))
-    g_signal_emit (child, actor_signals[PARENT_SET], 0, self);
+  if (!_clutter_actor_fully_transform_vertices (self, verts_in, verts, 4))
+    return FALSE;
 
-  /* if the child was mapped then we need to relayout ourselves to account
-   * for the removed child
-   */
-  if (was_mapped)
-    clutter_actor_queue_relayout (self);
+  /* we only track areas that are still rectangles on the stage */
+  if (fabsf (verts[0].y - verts[1].y) > 0.01f ||
+      fabsf (verts[2].y - verts[3].y) > 0.01f ||
+      fabsf (verts[0].x - verts[3].x) > 0.01f ||
+      fabsf (verts[1].x - verts[2].x) > 0.01f)
+    return FALSE;
 
-  /* we need to emit the signal before dropping the reference */
-  if (emit_actor_removed)
-    g_signal_emit_by_name (self, "actor-removed", child);
+  box->x1 = MIN (verts[0].x, verts[2].x);
+  box->y1 = MIN (verts[0].y, verts[2].y);
+  box->x2 = MAX (verts[0].x, verts[2].x);
+  box->y2 = MAX (verts[0].y, verts[2].y);
 
-  if (notify_first_last)
+  return TRUE;
+}
+
+static gboolean
+occlusion_state_covers (const OcclusionState  *state,
+                        const ClutterActorBox *box)
+{
+  guint i;
+
+  for (i = 0; i < state->n_boxes; i++)
     {
-      if (old_first != self->priv->first_child)
-        g_object_notify_by_pspec (obj, obj_props[PROP_FIRST_CHILD]);
+      const ClutterActorBox *occluder = &state->boxes[i];
 
-      if (old_last != self->priv->last_child)
-        g_object_notify_by_pspec (obj, obj_props[PROP_LAST_CHILD]);
+      if (box->x1 >= occluder->x1 && box->x2 <= occluder->x2 &&
+          box->y1 >= occluder->y1 && box->y2 <= occluder->y2)
+        return TRUE;
     }
 
-  g_object_thaw_notify (obj);
-
-  /* remove the reference we acquired in clutter_actor_add_child() */
-  g_object_unref (child);
+  return FALSE;
 }
 
-static const ClutterTransformInfo default_transform_info = {
-  0.0, { 0, },                  /* rotation-x */
-  0.0, { 0, },                  /* rotation-y */
-  0.0, { 0, },                  /* rotation-z */
+/* visits the actors in the reverse of the paint order, so that each
+ * actor is tested against the opaque boxes of the actors that are
+ * painted after it
+ */
+static void
+clutter_actor_compute_occlusion_internal (ClutterActor   *self,
+                                          OcclusionState *state)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box;
+  ClutterActor *iter;
 
-  1.0, 1.0, 1.0, { 0, },        /* scale */
+  if (!CLUTTER_ACTOR_IS_MAPPED (self))
+    return;
 
-  { 0, },                       /* anchor XXX:2.0 - remove*/
+  /* the paint box includes the children, so the whole sub-tree can be
+   * skipped; an occluded actor does not need to cover anything either,
+   * since its area is already covered
+   */
+  if (state->n_boxes > 0 &&
+      clutter_actor_get_paint_box (self, &box) &&
+      occlusion_state_covers (state, &box))
+    {
+      CLUTTER_NOTE (CLIPPING, "Actor '%s' is occluded",
+                    _clutter_actor_get_debug_name (self));
 
-  CLUTTER_VERTEX_INIT_ZERO,     /* translation */
+      priv->occlusion_serial = occlusion_serial;
+      return;
+    }
 
-  0.f,                          /* z-position */
-
-  CLUTTER_POINT_INIT_ZERO,      /* pivot */
-  0.f,                          /* pivot-z */
+  /* we can only rely on the order of the children if they are painted
+   * by the default implementation, and on their opaque boxes if they
+   * are not clipped by the actor
+   */
+  if (priv->effects == NULL &&
+      !priv->has_clip &&
+      !priv->clip_to_allocation &&
+      CLUTTER_ACTOR_GET_CLASS (self)->paint == clutter_actor_real_paint)
+    {
+      for (iter = priv->last_child;
+           iter != NULL;
+           iter = iter->priv->prev_sibling)
+        clutter_actor_compute_occlusion_internal (iter, state);
+    }
 
-  CLUTTER_MATRIX_INIT_IDENTITY,
-  FALSE,                        /* transform */
-  CLUTTER_MATRIX_INIT_IDENTITY,
-  FALSE,                        /* child-transform */
-};
+  /* the background and the content are painted before the children,
+   * so they can only cover the actors painted before this one
+   */
+  if (state->n_boxes < MAX_OCCLUDERS &&
+      clutter_actor_get_opaque_box (self, &state->boxes[state->n_boxes]))
+    state->n_boxes += 1;
+}
 
 /*< private >
- * _clutter_actor_get_transform_info_or_defaults:
- * @self: a #ClutterActor
- *
- * Retrieves the ClutterTransformInfo structure associated to an actor.
- *
- * If the actor does not have a ClutterTransformInfo structure associated
- * to it, then the default structure will be returned.
- *
- * This function should only be used for getters.
+ * _clutter_actor_compute_occlusion:
+ * @stage: a #ClutterStage
  *
- * Return value: a const pointer to the ClutterTransformInfo structure
+ * Finds the actors of @stage that are fully covered by opaque actors
+ * painted after them, so that clutter_actor_paint() can skip them
+ * during the next paint of the stage.
  */
-const ClutterTransformInfo *
-_clutter_actor_get_transform_info_or_defaults (ClutterActor *self)
+void
+_clutter_actor_compute_occlusion (ClutterActor *stage)
 {
-  ClutterTransformInfo *info;
+  OcclusionState state;
+  ClutterActor *iter;
 
-  info = g_object_get_qdata (G_OBJECT (self), quark_actor_transform_info);
-  if (info != NULL)
-    return info;
+  /* invalidate the results of the previous pass */
+  occlusion_serial += 1;
+  if (occlusion_serial == 0)
+    occlusion_serial = 1;
 
-  return &default_transform_info;
-}
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CULLING))
+    return;
 
-static void
-clutter_transform_info_free (gpointer data)
-{
-  if (data != NULL)
-    g_slice_free (ClutterTransformInfo, data);
+  state.n_boxes = 0;
+
+  for (iter = stage->priv->last_child;
+       iter != NULL;
+       iter = iter->priv->prev_sibling)
+    clutter_actor_compute_occlusion_internal (iter, &state);
 }
 
-/*< private >
- * _clutter_actor_get_transform_info:
- * @self: a #ClutterActor
- *
- * Retrieves a pointer to the ClutterTransformInfo structure.
- *
- * If the actor does not have a ClutterTransformInfo associated to it, one
- * will be created and initialized to the default values.
- *
- * This function should be used for setters.
- *
- * For getters, you should use _clutter_actor_get_transform_info_or_defaults()
- * instead.
- *
- * Return value: (transfer none): a pointer to the ClutterTransformInfo
- *   structure
+typedef struct {
+  guint slice;
+  CoglMatrix modelview;
+  ClutterActorBox box;
+} DepthPrepassEntry;
+
+/* visits the actors in paint order, giving each one the next depth
+ * slice, and collects the opaque areas of the actors that are painted
  */
-ClutterTransformInfo *
-_clutter_actor_get_transform_info (ClutterActor *self)
+static void
+clutter_actor_collect_depth_slices (ClutterActor     *self,
+                                    const CoglMatrix *parent_modelview,
+                                    guint            *n_slices,
+                                    GArray           *prepass)
 {
-  ClutterTransformInfo *info;
+  ClutterActorPrivate *priv = self->priv;
+  DepthPrepassEntry entry;
+  ClutterActor *iter;
 
-  info = g_object_get_qdata (G_OBJECT (self), quark_actor_transform_info);
-  if (info == NULL)
-    {
-      info = g_slice_new (ClutterTransformInfo);
+  if (!CLUTTER_ACTOR_IS_MAPPED (self) ||
+      priv->paint_in_layer ||
+      clutter_actor_get_paint_opacity_internal (self) == 0)
+    return;
 
-      *info = default_transform_info;
+  priv->depth_serial = depth_serial;
+  priv->depth_slice = *n_slices;
+  *n_slices += 1;
+
+  entry.modelview = *parent_modelview;
+  if (priv->enable_model_view_transform)
+    _clutter_actor_apply_modelview_transform (self, &entry.modelview);
 
-      g_object_set_qdata_full (G_OBJECT (self), quark_actor_transform_info,
-                               info,
-                               clutter_transform_info_free);
+  /* the occluded actors are not painted at all */
+  if (priv->occlusion_serial != occlusion_serial &&
+      clutter_actor_get_local_opaque_box (self, &entry.box))
+    {
+      entry.slice = priv->depth_slice;
+      g_array_append_val (prepass, entry);
     }
 
-  return info;
+  /* the children painted by other implementations, or inside clips
+   * and effects, are painted using the depth slice of the actor
+   */
+  if (priv->effects == NULL &&
+      !priv->has_clip &&
+      !priv->clip_to_allocation &&
+      CLUTTER_ACTOR_GET_CLASS (self)->paint == clutter_actor_real_paint)
+    {
+      for (iter = priv->first_child;
+           iter != NULL;
+           iter = iter->priv->next_sibling)
+        clutter_actor_collect_depth_slices (iter, &entry.modelview,
+                                            n_slices,
+                                            prepass);
+    }
 }
 
-static inline void
-clutter_actor_set_pivot_point_internal (ClutterActor       *self,
-                                        const ClutterPoint *pivot)
+/*< private >
+ * _clutter_actor_begin_depth_pass:
+ * @stage: a #ClutterStage
+ * @framebuffer: the framebuffer of @stage, with a cleared depth buffer
+ *
+ * Gives a depth slice to each actor of @stage, in paint order, and
+ * writes the depth of their opaque areas front-to-back, so that the
+ * actors painted next on @framebuffer skip the hidden fragments.
+ *
+ * The depth pass must be stopped with _clutter_actor_end_depth_pass()
+ * once the children of @stage have been painted.
+ */
+void
+_clutter_actor_begin_depth_pass (ClutterActor    *stage,
+                                 CoglFramebuffer *framebuffer)
 {
-  ClutterTransformInfo *info;
+  ClutterActor *iter;
+  CoglMatrix modelview;
+  GArray *prepass;
+  guint n_slices = 0;
+  gint i;
 
-  info = _clutter_actor_get_transform_info (self);
-  info->pivot = *pivot;
+  depth_serial += 1;
+  if (depth_serial == 0)
+    depth_serial = 1;
 
-  self->priv->transform_valid = FALSE;
+  prepass = g_array_new (FALSE, FALSE, sizeof (DepthPrepassEntry));
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT]);
+  cogl_framebuffer_get_modelview_matrix (framebuffer, &modelview);
 
-  clutter_actor_queue_redraw (self);
-}
+  for (iter = stage->priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    clutter_actor_collect_depth_slices (iter, &modelview, &n_slices, prepass);
 
-static inline void
-clutter_actor_set_pivot_point_z_internal (ClutterActor *self,
-                                          float         pivot_z)
-{
-  ClutterTransformInfo *info;
+  _clutter_paint_node_begin_depth_pass (framebuffer, n_slices);
 
-  info = _clutter_actor_get_transform_info (self);
-  info->pivot_z = pivot_z;
+  /* the nearest areas first, so that the farther ones are rejected */
+  for (i = prepass->len - 1; i >= 0; i--)
+    {
+      const DepthPrepassEntry *entry =
+        &g_array_index (prepass, DepthPrepassEntry, i);
 
-  self->priv->transform_valid = FALSE;
+      _clutter_paint_node_draw_depth_prepass (entry->slice,
+                                              &entry->modelview,
+                                              &entry->box);
+    }
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT_Z]);
+  g_array_unref (prepass);
 
-  clutter_actor_queue_redraw (self);
+  depth_pass_active = TRUE;
 }
 
 /*< private >
- * clutter_actor_set_translation_internal:
- * @self: a #ClutterActor
- * @axis: the axis of the translation to change
- * @angle: the translation as a value along @axis
+ * _clutter_actor_end_depth_pass:
  *
- * Sets the translation on the given @axis
+ * Stops the depth pass started by _clutter_actor_begin_depth_pass().
  */
-static void
-clutter_actor_set_translation_internal (ClutterActor *self,
-                                        gfloat        value,
-                                        GParamSpec   *pspec)
+void
+_clutter_actor_end_depth_pass (void)
 {
-  GObject *obj = G_OBJECT (self);
-  ClutterTransformInfo *info;
-
-  info = _clutter_actor_get_transform_info (self);
+  if (!depth_pass_active)
+    return;
 
-  if (pspec == obj_props[PROP_TRANSLATION_X])
-    info->translation.x = value;
-  else if (pspec == obj_props[PROP_TRANSLATION_Y])
-    info->translation.y = value;
-  else if (pspec == obj_props[PROP_TRANSLATION_Z])
-    info->translation.z = value;
-  else
-    g_assert_not_reached ();
+  _clutter_paint_node_end_depth_pass ();
 
-  self->priv->transform_valid = FALSE;
-  clutter_actor_queue_redraw (self);
-  g_object_notify_by_pspec (obj, pspec);
+  depth_pass_active = FALSE;
 }
 
-static inline void
-clutter_actor_set_translation_factor (ClutterActor      *self,
-                                      ClutterRotateAxis  axis,
-                                      gdouble            value)
+/*< private >
+ * _clutter_actor_reset_paint_stats:
+ *
+ * Resets the counts returned by _clutter_actor_get_paint_stats().
+ */
+void
+_clutter_actor_reset_paint_stats (void)
 {
-  const ClutterTransformInfo *info;
-  const float *translate_p = NULL;
-  GParamSpec *pspec = NULL;
-
-  info = _clutter_actor_get_transform_info_or_defaults (self);
-
-  switch (axis)
-    {
-    case CLUTTER_X_AXIS:
-      pspec = obj_props[PROP_TRANSLATION_X];
-      translate_p = &info->translation.x;
-      break;
-
-    case CLUTTER_Y_AXIS:
-      pspec = obj_props[PROP_TRANSLATION_Y];
-      translate_p = &info->translation.y;
-      break;
-
-    case CLUTTER_Z_AXIS:
-      pspec = obj_props[PROP_TRANSLATION_Z];
-      translate_p = &info->translation.z;
-      break;
-    }
-
-  g_assert (pspec != NULL);
-  g_assert (translate_p != NULL);
+  paint_stats_painted = 0;
+  paint_stats_culled = 0;
+}
 
-  _clutter_actor_create_transition (self, pspec, *translate_p, value);
+/*< private >
+ * _clutter_actor_get_paint_stats:
+ * @n_painted: (out): return location for the number of actors painted
+ * @n_culled: (out): return location for the number of actors culled,
+ *   either outside of the clip or occluded
+ *
+ * Retrieves the number of actors painted on a stage, and skipped by
+ * the culling, since the last call to _clutter_actor_reset_paint_stats();
+ * the actors painted inside clones and while picking are not counted.
+ */
+void
+_clutter_actor_get_paint_stats (guint *n_painted,
+                                guint *n_culled)
+{
+  *n_painted = paint_stats_painted;
+  *n_culled = paint_stats_culled;
 }
 
-/**
- * clutter_actor_set_translation:
+/*< private >
+ * _clutter_actor_set_client_buffer:
  * @self: a #ClutterActor
- * @translate_x: the translation along the X axis
- * @translate_y: the translation along the Y axis
- * @translate_z: the translation along the Z axis
+ * @type: the type of @buffer
+ * @buffer: (nullable): the client buffer painted by @self, or %NULL
  *
- * Sets an additional translation transformation on a #ClutterActor,
- * relative to the #ClutterActor:pivot-point.
+ * Records the client buffer that @self paints as its content, so
+ * that the stage window can present the buffer directly when @self
+ * covers the whole stage.
  *
- * Since: 1.12
+ * The actor must clear the buffer when it stops painting it.
  */
 void
-clutter_actor_set_translation (ClutterActor *self,
-                               gfloat        translate_x,
-                               gfloat        translate_y,
-                               gfloat        translate_z)
+_clutter_actor_set_client_buffer (ClutterActor            *self,
+                                  ClutterClientBufferType  type,
+                                  gpointer                 buffer)
 {
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
-
-  g_object_freeze_notify (G_OBJECT (self));
+  ClutterActorPrivate *priv = self->priv;
 
-  clutter_actor_set_translation_factor (self, CLUTTER_X_AXIS, translate_x);
-  clutter_actor_set_translation_factor (self, CLUTTER_Y_AXIS, translate_y);
-  clutter_actor_set_translation_factor (self, CLUTTER_Z_AXIS, translate_z);
+  if (buffer == NULL)
+    type = CLUTTER_CLIENT_BUFFER_NONE;
 
-  g_object_thaw_notify (G_OBJECT (self));
+  priv->client_buffer_type = type;
+  priv->client_buffer = type != CLUTTER_CLIENT_BUFFER_NONE ? buffer : NULL;
 }
 
-/**
- * clutter_actor_get_translation:
+/*< private >
+ * _clutter_actor_get_client_buffer:
  * @self: a #ClutterActor
- * @translate_x: (out) (allow-none): return location for the X component
- *   of the translation, or %NULL
- * @translate_y: (out) (allow-none): return location for the Y component
- *   of the translation, or %NULL
- * @translate_z: (out) (allow-none): return location for the Z component
- *   of the translation, or %NULL
+ * @buffer: (out): return location for the client buffer
  *
- * Retrieves the translation set using clutter_actor_set_translation().
+ * Retrieves the client buffer set with _clutter_actor_set_client_buffer().
  *
- * Since: 1.12
+ * Return value: the type of the client buffer
  */
-void
-clutter_actor_get_translation (ClutterActor *self,
-                               gfloat       *translate_x,
-                               gfloat       *translate_y,
-                               gfloat       *translate_z)
+ClutterClientBufferType
+_clutter_actor_get_client_buffer (ClutterActor *self,
+                                  gpointer     *buffer)
 {
-  const ClutterTransformInfo *info;
+  *buffer = self->priv->client_buffer;
 
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  return self->priv->client_buffer_type;
+}
 
-  info = _clutter_actor_get_transform_info_or_defaults (self);
+static inline gboolean
+clutter_actor_is_painted (ClutterActor *self)
+{
+  return CLUTTER_ACTOR_IS_MAPPED (self) &&
+         clutter_actor_get_paint_opacity_internal (self) != 0;
+}
 
-  if (translate_x != NULL)
-    *translate_x = info->translation.x;
+static ClutterActor *
+clutter_actor_get_last_painted_child (ClutterActor *self)
+{
+  ClutterActor *iter;
 
-  if (translate_y != NULL)
-    *translate_y = info->translation.y;
+  for (iter = self->priv->last_child;
+       iter != NULL;
+       iter = iter->priv->prev_sibling)
+    {
+      if (clutter_actor_is_painted (iter))
+        return iter;
+    }
 
-  if (translate_z != NULL)
-    *translate_z = info->translation.z;
+  return NULL;
 }
 
 /*< private >
- * clutter_actor_set_rotation_angle_internal:
- * @self: a #ClutterActor
- * @angle: the angle of rotation
- * @pspec: the #GParamSpec of the property
+ * _clutter_actor_get_scanout_candidate:
+ * @stage: a #ClutterStage
  *
- * Sets the rotation angle on the given axis without affecting the
- * rotation center point.
+ * Finds the actor painting a client buffer that covers the whole of
+ * @stage, without any transformation, effect or translucency, and
+ * with nothing painted on top of it; the stage window can present
+ * the buffer of such an actor directly, instead of painting the stage.
+ *
+ * Return value: (transfer none): the actor, or %NULL
  */
-static inline void
-clutter_actor_set_rotation_angle_internal (ClutterActor *self,
-                                           gdouble       angle,
-                                           GParamSpec   *pspec)
+ClutterActor *
+_clutter_actor_get_scanout_candidate (ClutterActor *stage)
 {
-  ClutterTransformInfo *info;
+  ClutterActorPrivate *priv;
+  ClutterActor *iter;
+  cairo_matrix_t matrix;
+  gfloat width, height;
 
-  info = _clutter_actor_get_transform_info (self);
+  /* the actors painted by their parent before its children are below
+   * them, so we can descend through the topmost child of the parents
+   * that do not change the way their children are painted
+   */
+  iter = clutter_actor_get_last_painted_child (stage);
 
-  if (pspec == obj_props[PROP_ROTATION_ANGLE_X])
-    info->rx_angle = angle;
-  else if (pspec == obj_props[PROP_ROTATION_ANGLE_Y])
-    info->ry_angle = angle;
-  else if (pspec == obj_props[PROP_ROTATION_ANGLE_Z])
-    info->rz_angle = angle;
-  else
-    g_assert_not_reached ();
+  while (iter != NULL &&
+         iter->priv->client_buffer_type == CLUTTER_CLIENT_BUFFER_NONE)
+    {
+      priv = iter->priv;
 
-  self->priv->transform_valid = FALSE;
+      if (priv->effects != NULL ||
+          actor_has_shader_data (iter) ||
+          priv->has_clip ||
+          priv->clip_to_allocation ||
+          CLUTTER_ACTOR_GET_CLASS (iter)->paint != clutter_actor_real_paint)
+        return NULL;
 
-  clutter_actor_queue_redraw (self);
+      iter = clutter_actor_get_last_painted_child (iter);
+    }
 
-  g_object_notify_by_pspec (G_OBJECT (self), pspec);
+  if (iter == NULL)
+    return NULL;
+
+  priv = iter->priv;
+
+  if (priv->effects != NULL ||
+      actor_has_shader_data (iter) ||
+      clutter_actor_get_paint_opacity_internal (iter) != 255 ||
+      clutter_actor_get_last_painted_child (iter) != NULL)
+    return NULL;
+
+  if (!_clutter_actor_get_stage_transform_2d (iter, &matrix) ||
+      matrix.xx != 1.0 || matrix.yy != 1.0 ||
+      matrix.xy != 0.0 || matrix.yx != 0.0)
+    return NULL;
+
+  clutter_actor_get_size (stage, &width, &height);
+
+  /* the origin of the actor, including its allocation */
+  if (fabs (matrix.x0) > 0.01 || fabs (matrix.y0) > 0.01 ||
+      fabsf (clutter_actor_box_get_width (&priv->allocation) - width) > 0.01f ||
+      fabsf (clutter_actor_box_get_height (&priv->allocation) - height) > 0.01f)
+    return NULL;
+
+  return iter;
 }
 
 /**
- * clutter_actor_set_rotation_angle:
- * @self: a #ClutterActor
- * @axis: the axis to set the angle one
- * @angle: the angle of rotation, in degrees
+ * clutter_actor_paint:
+ * @self: A #ClutterActor
  *
- * Sets the @angle of rotation of a #ClutterActor on the given @axis.
+ * Renders the actor to display.
  *
- * This function is a convenience for setting the rotation properties
- * #ClutterActor:rotation-angle-x, #ClutterActor:rotation-angle-y,
- * and #ClutterActor:rotation-angle-z.
+ * This function should not be called directly by applications.
+ * Call clutter_actor_queue_redraw() to queue paints, instead.
  *
- * The center of rotation is established by the #ClutterActor:pivot-point
- * property.
+ * This function is context-aware, and will either cause a
+ * regular paint or a pick paint.
  *
- * Since: 1.12
+ * This function will emit the #ClutterActor::paint signal or
+ * the #ClutterActor::pick signal, depending on the context.
+ *
+ * This function does not paint the actor if the actor is set to 0,
+ * unless it is performing a pick paint.
  */
 void
-clutter_actor_set_rotation_angle (ClutterActor      *self,
-                                  ClutterRotateAxis  axis,
-                                  gdouble            angle)
+clutter_actor_paint (ClutterActor *self)
 {
-  const ClutterTransformInfo *info;
-  const double *cur_angle_p = NULL;
-  GParamSpec *pspec = NULL;
+  ClutterActorPrivate *priv;
+  ClutterPickMode pick_mode;
+  gboolean clip_set = FALSE;
+  gboolean shader_applied = FALSE;
+  gboolean track_breaks = FALSE;
+  gboolean depth_slice_set = FALSE;
+  guint old_depth_slice = 0;
+  CoglFramebuffer *framebuffer;
+  ClutterStage *stage;
 
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-  info = _clutter_actor_get_transform_info_or_defaults (self);
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return;
 
-  switch (axis)
-    {
-    case CLUTTER_X_AXIS:
-      cur_angle_p = &info->rx_angle;
-      pspec = obj_props[PROP_ROTATION_ANGLE_X];
-      break;
+  priv = self->priv;
 
-    case CLUTTER_Y_AXIS:
-      cur_angle_p = &info->ry_angle;
-      pspec = obj_props[PROP_ROTATION_ANGLE_Y];
-      break;
+  pick_mode = _clutter_context_get_pick_mode ();
 
-    case CLUTTER_Z_AXIS:
-      cur_angle_p = &info->rz_angle;
-      pspec = obj_props[PROP_ROTATION_ANGLE_Z];
-      break;
-    }
+  if (pick_mode == CLUTTER_PICK_NONE)
+    priv->propagated_one_redraw = FALSE;
 
-  g_assert (pspec != NULL);
-  g_assert (cur_angle_p != NULL);
+  /* It's an important optimization that we consider painting of
+   * actors with 0 opacity to be a NOP... */
+  if (pick_mode == CLUTTER_PICK_NONE &&
+      /* ignore top-levels, since they might be transparent */
+      !CLUTTER_ACTOR_IS_TOPLEVEL (self) &&
+      /* Use the override opacity if its been set */
+      ((priv->opacity_override >= 0) ?
+       priv->opacity_override : priv->opacity) == 0)
+    return;
 
-  _clutter_actor_create_transition (self, pspec, *cur_angle_p, angle);
-}
+  /* the actors promoted to a layer are painted by the stage window */
+  if (pick_mode == CLUTTER_PICK_NONE &&
+      priv->paint_in_layer &&
+      layer_paint_level == 0 &&
+      !in_clone_paint ())
+    return;
 
-/**
- * clutter_actor_get_rotation_angle:
- * @self: a #ClutterActor
- * @axis: the axis of the rotation
- *
- * Retrieves the angle of rotation set by clutter_actor_set_rotation_angle().
- *
- * Return value: the angle of rotation, in degrees
- *
- * Since: 1.12
- */
-gdouble
-clutter_actor_get_rotation_angle (ClutterActor      *self,
-                                  ClutterRotateAxis  axis)
-{
-  const ClutterTransformInfo *info;
-  gdouble retval;
+  /* if we aren't paintable (not in a toplevel with all
+   * parents paintable) then do nothing.
+   */
+  if (!CLUTTER_ACTOR_IS_MAPPED (self))
+    return;
 
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), 0.0);
+  /* nothing in a subtree without reactive actors can be the result
+   * of a pick of the reactive actors
+   */
+  if (pick_mode == CLUTTER_PICK_REACTIVE &&
+      clutter_actor_get_reactive_subtree_size (self) == 0 &&
+      !in_clone_paint ())
+    return;
 
-  info = _clutter_actor_get_transform_info_or_defaults (self);
+  stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
 
-  switch (axis)
+  /* the actors without a slice use the one of their parent */
+  if (depth_pass_active &&
+      pick_mode == CLUTTER_PICK_NONE &&
+      priv->depth_serial == depth_serial &&
+      !in_clone_paint ())
     {
-    case CLUTTER_X_AXIS:
-      retval = info->rx_angle;
-      break;
+      old_depth_slice = _clutter_paint_node_set_depth_slice (priv->depth_slice);
+      depth_slice_set = TRUE;
+    }
 
-    case CLUTTER_Y_AXIS:
-      retval = info->ry_angle;
-      break;
+  /* mark that we are in the paint process */
+  CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 
-    case CLUTTER_Z_AXIS:
-      retval = info->rz_angle;
-      break;
+  /* the offscreen effects and the clones redirect the painting of their
+   * actors, so this is the only lookup of the implicit framebuffer;
+   * everything below uses it explicitly
+   */
+  framebuffer = cogl_get_draw_framebuffer ();
 
-    default:
-      g_warn_if_reached ();
-      retval = 0.0;
-      break;
-    }
+  cogl_framebuffer_push_matrix (framebuffer);
 
-  return retval;
-}
+  if (priv->enable_model_view_transform)
+    {
+      CoglMatrix matrix;
 
-/*< private >
- * clutter_actor_set_rotation_center_internal:
- * @self: a #ClutterActor
- * @axis: the axis of the center to change
- * @center: the coordinates of the rotation center
- *
- * Sets the rotation center on the given axis without affecting the
- * rotation angle.
- */
-static inline void
-clutter_actor_set_rotation_center_internal (ClutterActor        *self,
-                                            ClutterRotateAxis    axis,
-                                            const ClutterVertex *center)
-{
-  ClutterVertex v = CLUTTER_VERTEX_INIT_ZERO; 
-  GObject *obj = G_OBJECT (self);
-  ClutterTransformInfo *info;
+      /* XXX: It could be better to cache the modelview with the actor
+       * instead of progressively building up the transformations on
+       * the matrix stack every time we paint. */
+      cogl_framebuffer_get_modelview_matrix (framebuffer, &matrix);
+      _clutter_actor_apply_modelview_transform (self, &matrix);
 
-  info = _clutter_actor_get_transform_info (self);
+#ifdef CLUTTER_ENABLE_DEBUG
+      /* Catch when out-of-band transforms have been made by actors not as part
+       * of an apply_transform vfunc... */
+      if (G_UNLIKELY (clutter_debug_flags & CLUTTER_DEBUG_OOB_TRANSFORMS))
+        {
+          CoglMatrix expected_matrix;
 
-  if (center != NULL)
-    v = *center;
+          _clutter_actor_get_relative_transformation_matrix (self, NULL,
+                                                             &expected_matrix);
 
-  g_object_freeze_notify (obj);
+          if (!cogl_matrix_equal (&matrix, &expected_matrix))
+            {
+              GString *buf = g_string_sized_new (1024);
+              ClutterActor *parent;
 
-  switch (axis)
-    {
-    case CLUTTER_X_AXIS:
-      clutter_anchor_coord_set_units (&info->rx_center, v.x, v.y, v.z);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ROTATION_CENTER_X]);
-      break;
+              parent = self;
+              while (parent != NULL)
+                {
+                  g_string_append (buf, _clutter_actor_get_debug_name (parent));
 
-    case CLUTTER_Y_AXIS:
-      clutter_anchor_coord_set_units (&info->ry_center, v.x, v.y, v.z);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ROTATION_CENTER_Y]);
-      break;
+                  if (parent->priv->parent != NULL)
+                    g_string_append (buf, "->");
 
-    case CLUTTER_Z_AXIS:
-      /* if the previously set rotation center was fractional, then
-       * setting explicit coordinates will have to notify the
-       * :rotation-center-z-gravity property as well
-       */
-      if (info->rz_center.is_fractional)
-        g_object_notify_by_pspec (obj, obj_props[PROP_ROTATION_CENTER_Z_GRAVITY]);
+                  parent = parent->priv->parent;
+                }
 
-      clutter_anchor_coord_set_units (&info->rz_center, v.x, v.y, v.z);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ROTATION_CENTER_Z]);
-      break;
+              g_warning ("Unexpected transform found when painting actor "
+                         "\"%s\". This will be caused by one of the actor's "
+                         "ancestors (%s) using the Cogl API directly to transform "
+                         "children instead of using ::apply_transform().",
+                         _clutter_actor_get_debug_name (self),
+                         buf->str);
+
+              g_string_free (buf, TRUE);
+            }
+        }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+      cogl_framebuffer_set_modelview_matrix (framebuffer, &matrix);
     }
 
-  self->priv->transform_valid = FALSE;
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_BATCH_BREAKS &&
+                  pick_mode == CLUTTER_PICK_NONE))
+    {
+      _clutter_paint_debug_push_actor ();
+      track_breaks = TRUE;
+    }
 
-  g_object_thaw_notify (obj);
+  if (priv->has_clip)
+    {
+      CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
+      _clutter_util_push_rectangle_clip (fb,
+                                         priv->clip.origin.x,
+                                         priv->clip.origin.y,
+                                         priv->clip.origin.x + priv->clip.size.width,
+                                         priv->clip.origin.y + priv->clip.size.height);
+      clip_set = TRUE;
 
-  clutter_actor_queue_redraw (self);
-}
+      if (_clutter_stage_in_geometric_pick (stage))
+        {
+          ClutterActorBox clip_box;
 
-static void
-clutter_actor_set_scale_factor_internal (ClutterActor *self,
-                                         double factor,
-                                         GParamSpec *pspec)
-{
-  GObject *obj = G_OBJECT (self);
-  ClutterTransformInfo *info;
+          clip_box.x1 = priv->clip.origin.x;
+          clip_box.y1 = priv->clip.origin.y;
+          clip_box.x2 = priv->clip.origin.x + priv->clip.size.width;
+          clip_box.y2 = priv->clip.origin.y + priv->clip.size.height;
 
-  info = _clutter_actor_get_transform_info (self);
+          _clutter_stage_push_pick_clip (stage, &clip_box);
+        }
+    }
+  else if (priv->clip_to_allocation)
+    {
+      CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
+      gfloat width, height;
 
-  if (pspec == obj_props[PROP_SCALE_X])
-    info->scale_x = factor;
-  else if (pspec == obj_props[PROP_SCALE_Y])
-    info->scale_y = factor;
-  else if (pspec == obj_props[PROP_SCALE_Z])
-    info->scale_z = factor;
-  else
-    g_assert_not_reached ();
+      width  = priv->allocation.x2 - priv->allocation.x1;
+      height = priv->allocation.y2 - priv->allocation.y1;
 
-  self->priv->transform_valid = FALSE;
-  clutter_actor_queue_redraw (self);
-  g_object_notify_by_pspec (obj, pspec);
-}
+      _clutter_util_push_rectangle_clip (fb, 0, 0, width, height);
+      clip_set = TRUE;
 
-static inline void
-clutter_actor_set_scale_factor (ClutterActor      *self,
-                                ClutterRotateAxis  axis,
-                                gdouble            factor)
-{
-  const ClutterTransformInfo *info;
-  const double *scale_p = NULL;
-  GParamSpec *pspec = NULL;
+      if (_clutter_stage_in_geometric_pick (stage))
+        {
+          ClutterActorBox clip_box = { 0, 0, width, height };
 
-  info = _clutter_actor_get_transform_info_or_defaults (self);
+          _clutter_stage_push_pick_clip (stage, &clip_box);
+        }
+    }
 
-  switch (axis)
+  if (clip_set && track_breaks)
+    _clutter_paint_debug_note_batch_break (CLUTTER_BATCH_BREAK_CLIP);
+
+  if (pick_mode == CLUTTER_PICK_NONE)
     {
-    case CLUTTER_X_AXIS:
-      pspec = obj_props[PROP_SCALE_X];
-      scale_p = &info->scale_x;
-      break;
+      /* We check whether we need to add the flatten effect before
+         each paint so that we can avoid having a mechanism for
+         applications to notify when the value of the
+         has_overlaps virtual changes. */
+      clutter_actor_update_raster_cache (self);
+      add_or_remove_flatten_effect (self);
+    }
 
-    case CLUTTER_Y_AXIS:
-      pspec = obj_props[PROP_SCALE_Y];
-      scale_p = &info->scale_y;
-      break;
+  /* We save the current paint volume so that the next time the
+   * actor queues a redraw we can constrain the redraw to just
+   * cover the union of the new bounding box and the old.
+   *
+   * We also fetch the current paint volume to perform culling so
+   * we can avoid painting actors outside the current clip region.
+   *
+   * If we are painting inside a clone, we should neither update
+   * the paint volume or use it to cull painting, since the paint
+   * box represents the location of the source actor on the
+   * screen.
+   *
+   * XXX: We are starting to do a lot of vertex transforms on
+   * the CPU in a typical paint, so at some point we should
+   * audit these and consider caching some things.
+   *
+   * NB: We don't perform culling while picking at this point because
+   * clutter-stage.c doesn't setup the clipping planes appropriately.
+   *
+   * NB: We don't want to update the last-paint-volume during picking
+   * because the last-paint-volume is used to determine the old screen
+   * space location of an actor that has moved so we can know the
+   * minimal region to redraw to clear an old view of the actor. If we
+   * update this during picking then by the time we come around to
+   * paint then the last-paint-volume would likely represent the new
+   * actor position not the old.
+   */
+  if (!in_clone_paint () && pick_mode == CLUTTER_PICK_NONE)
+    {
+      gboolean success;
+      /* annoyingly gcc warns if uninitialized even though
+       * the initialization is redundant :-( */
+      ClutterCullResult result = CLUTTER_CULL_RESULT_IN;
 
-    case CLUTTER_Z_AXIS:
-      pspec = obj_props[PROP_SCALE_Z];
-      scale_p = &info->scale_z;
-      break;
-    }
+      if (G_LIKELY ((clutter_paint_debug_flags &
+                     (CLUTTER_DEBUG_DISABLE_CULLING |
+                      CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)) !=
+                    (CLUTTER_DEBUG_DISABLE_CULLING |
+                     CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)))
+        _clutter_actor_update_last_paint_volume (self);
 
-  g_assert (pspec != NULL);
-  g_assert (scale_p != NULL);
+      success = cull_actor (self, framebuffer, &result);
 
-  _clutter_actor_create_transition (self, pspec, *scale_p, factor);
-}
+      if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS))
+        _clutter_actor_paint_cull_result (self, success, result);
+      else if (result == CLUTTER_CULL_RESULT_OUT && success)
+        {
+          paint_stats_culled += 1;
+          goto done;
+        }
 
-static inline void
-clutter_actor_set_scale_center (ClutterActor      *self,
-                                ClutterRotateAxis  axis,
-                                gfloat             coord)
-{
-  GObject *obj = G_OBJECT (self);
-  ClutterTransformInfo *info;
-  gfloat center_x, center_y;
+      /* actors covered by opaque actors painted after them can be
+       * skipped, as long as we are painting on the stage
+       */
+      if (priv->occlusion_serial == occlusion_serial &&
+          framebuffer == _clutter_stage_get_active_framebuffer (stage))
+        {
+          paint_stats_culled += 1;
+          goto done;
+        }
 
-  info = _clutter_actor_get_transform_info (self);
+      paint_stats_painted += 1;
+    }
 
-  g_object_freeze_notify (obj);
+  if (priv->effects == NULL)
+    {
+      if (pick_mode == CLUTTER_PICK_NONE &&
+          actor_has_shader_data (self))
+        {
+          _clutter_actor_shader_pre_paint (self, FALSE);
+          shader_applied = TRUE;
+        }
 
-  /* get the current scale center coordinates */
-  clutter_anchor_coord_get_units (self, &info->scale_center,
-                                  &center_x,
-                                  &center_y,
-                                  NULL);
+      priv->next_effect_to_paint = NULL;
+    }
+  else
+    priv->next_effect_to_paint =
+      _clutter_meta_group_peek_metas (priv->effects);
 
-  /* we need to notify this too, because setting explicit coordinates will
-   * change the gravity as a side effect
-   */
-  if (info->scale_center.is_fractional)
-    g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_GRAVITY]);
+  CLUTTER_TRACE_BEGIN (PAINT_ACTORS, G_OBJECT_TYPE_NAME (self));
+  clutter_actor_continue_paint (self);
+  CLUTTER_TRACE_END (PAINT_ACTORS);
 
-  switch (axis)
-    {
-    case CLUTTER_X_AXIS:
-      clutter_anchor_coord_set_units (&info->scale_center, coord, center_y, 0);
-      g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_X]);
-      break;
+  if (shader_applied)
+    _clutter_actor_shader_post_paint (self);
 
-    case CLUTTER_Y_AXIS:
-      clutter_anchor_coord_set_units (&info->scale_center, center_x, coord, 0);
-      g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_Y]);
-      break;
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_PAINT_VOLUMES &&
+                  pick_mode == CLUTTER_PICK_NONE))
+    _clutter_actor_draw_paint_volume (self);
 
-    default:
-      g_assert_not_reached ();
+  if (track_breaks)
+    {
+      _clutter_paint_debug_draw_batch_breaks (_clutter_stage_get_active_framebuffer (stage),
+                                              priv->allocation.x2 - priv->allocation.x1,
+                                              priv->allocation.y2 - priv->allocation.y1,
+                                              _clutter_paint_debug_pop_actor ());
+      track_breaks = FALSE;
     }
 
-  self->priv->transform_valid = FALSE;
-
-  clutter_actor_queue_redraw (self);
+done:
+  /* If we make it here then the actor has run through a complete
+     paint run including all the effects so it's no longer dirty */
+  if (pick_mode == CLUTTER_PICK_NONE)
+    priv->is_dirty = FALSE;
 
-  g_object_thaw_notify (obj);
-}
+  if (track_breaks)
+    _clutter_paint_debug_pop_actor ();
 
-static inline void
-clutter_actor_set_scale_gravity (ClutterActor   *self,
-                                 ClutterGravity  gravity)
-{
-  ClutterTransformInfo *info;
-  GObject *obj;
+  if (clip_set)
+    {
+      CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
 
-  info = _clutter_actor_get_transform_info (self);
-  obj = G_OBJECT (self);
+      cogl_framebuffer_pop_clip (fb);
 
-  if (gravity == CLUTTER_GRAVITY_NONE)
-    clutter_anchor_coord_set_units (&info->scale_center, 0, 0, 0);
-  else
-    clutter_anchor_coord_set_gravity (&info->scale_center, gravity);
+      if (_clutter_stage_in_geometric_pick (stage))
+        _clutter_stage_pop_pick_clip (stage);
+    }
 
-  self->priv->transform_valid = FALSE;
+  cogl_framebuffer_pop_matrix (framebuffer);
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_X]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_Y]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_GRAVITY]);
+  if (depth_slice_set)
+    _clutter_paint_node_set_depth_slice (old_depth_slice);
 
-  clutter_actor_queue_redraw (self);
+  /* paint sequence complete */
+  CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 }
 
-/* XXX:2.0 - remove */
-static inline void
-clutter_actor_set_anchor_coord (ClutterActor      *self,
-                                ClutterRotateAxis  axis,
-                                gfloat             coord)
+/* collects the pointwise effects following the current one, which is
+ * pointwise as well, so that the current effect applies them using its
+ * own offscreen buffer; the effects are skipped by the paint sequence
+ */
+static GList *
+clutter_actor_fuse_pointwise_effects (ClutterActor *self)
 {
-  GObject *obj = G_OBJECT (self);
-  ClutterTransformInfo *info;
-  gfloat anchor_x, anchor_y;
+  ClutterActorPrivate *priv = self->priv;
+  GList *fused_effects = NULL;
 
-  info = _clutter_actor_get_transform_info (self);
+  while (priv->next_effect_to_paint != NULL)
+    {
+      ClutterEffect *effect = priv->next_effect_to_paint->data;
+      GType effect_type = G_OBJECT_TYPE (effect);
+      GList *l;
 
-  g_object_freeze_notify (obj);
+      if (!clutter_actor_meta_get_enabled (CLUTTER_ACTOR_META (effect)))
+        {
+          priv->next_effect_to_paint = priv->next_effect_to_paint->next;
+          continue;
+        }
 
-  clutter_anchor_coord_get_units (self, &info->anchor,
-                                  &anchor_x,
-                                  &anchor_y,
-                                  NULL);
+      if (!_clutter_offscreen_effect_is_pointwise (effect))
+        break;
 
-  if (info->anchor.is_fractional)
-    g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_GRAVITY]);
+      /* the snippets of two effects of the same type would use the
+       * same uniforms
+       */
+      if (effect_type == G_OBJECT_TYPE (priv->current_effect))
+        break;
 
-  switch (axis)
-    {
-    case CLUTTER_X_AXIS:
-      clutter_anchor_coord_set_units (&info->anchor,
-                                      coord,
-                                      anchor_y,
-                                      0.0);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_X]);
-      break;
+      for (l = fused_effects; l != NULL; l = l->next)
+        {
+          if (G_OBJECT_TYPE (l->data) == effect_type)
+            break;
+        }
 
-    case CLUTTER_Y_AXIS:
-      clutter_anchor_coord_set_units (&info->anchor,
-                                      anchor_x,
-                                      coord,
-                                      0.0);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_Y]);
-      break;
+      if (l != NULL)
+        break;
 
-    default:
-      g_assert_not_reached ();
+      fused_effects = g_list_prepend (fused_effects, effect);
+      priv->next_effect_to_paint = priv->next_effect_to_paint->next;
     }
 
-  self->priv->transform_valid = FALSE;
-
-  clutter_actor_queue_redraw (self);
-
-  g_object_thaw_notify (obj);
+  return fused_effects;
 }
 
-static void
-clutter_actor_set_clip_rect (ClutterActor      *self,
-                             const ClutterRect *clip)
+/* checks whether the only drawing of the actor is the texture of its
+ * content, so that the pointwise effects can be applied by the pipeline
+ * of the content instead of an offscreen buffer, which is equivalent
+ * as long as nothing else is drawn on top of the content
+ */
+static gboolean
+clutter_actor_can_paint_effects_on_content (ClutterActor *self)
 {
   ClutterActorPrivate *priv = self->priv;
-  GObject *obj = G_OBJECT (self);
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (self);
 
-  if (clip != NULL)
+  /* all the remaining effects must be fused with the current one */
+  if (priv->next_effect_to_paint != NULL)
+    return FALSE;
+
+  if (priv->n_children != 0 || CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return FALSE;
+
+  if (priv->bg_color_set &&
+      !clutter_color_equal (&priv->bg_color, CLUTTER_COLOR_Transparent))
+    return FALSE;
+
+  if (CLUTTER_IS_IMAGE (priv->content))
     {
-      priv->clip = *clip;
-      priv->has_clip = TRUE;
+      /* the placeholder color is not a texture */
+      if (clutter_image_get_texture (CLUTTER_IMAGE (priv->content)) == NULL)
+        return FALSE;
     }
-  else
-    priv->has_clip = FALSE;
+  else if (!CLUTTER_IS_CANVAS (priv->content))
+    return FALSE;
 
-  clutter_actor_queue_redraw (self);
+  if (klass->paint != clutter_actor_real_paint ||
+      klass->paint_node != NULL ||
+      actor_has_shader_data (self) ||
+      g_signal_has_handler_pending (self, actor_signals[PAINT], 0, TRUE))
+    return FALSE;
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_CLIP]); /* XXX:2.0 - remove */
-  g_object_notify_by_pspec (obj, obj_props[PROP_CLIP_RECT]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_HAS_CLIP]);
+  return TRUE;
 }
 
+/* paints the content of the actor with the pointwise @effects applied
+ * by its pipeline, skipping their offscreen buffers
+ */
 static void
-clutter_actor_set_property (GObject      *object,
-			    guint         prop_id,
-			    const GValue *value,
-			    GParamSpec   *pspec)
+clutter_actor_paint_effects_on_content (ClutterActor *self,
+                                        GList        *effects)
 {
-  ClutterActor *actor = CLUTTER_ACTOR (object);
-  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorPrivate *priv = self->priv;
+  GList *l;
 
-  switch (prop_id)
+  /* the offscreen buffers of the effects are not going to be used */
+  for (l = effects; l != NULL; l = l->next)
+    _clutter_offscreen_effect_release_resources (l->data);
+
+  if (!priv->retained_content_effects)
     {
-    case PROP_X:
-      clutter_actor_set_x (actor, g_value_get_float (value));
-      break;
+      clutter_actor_release_paint_node (self);
+      priv->retained_content_effects = TRUE;
+    }
 
-    case PROP_Y:
-      clutter_actor_set_y (actor, g_value_get_float (value));
-      break;
+  priv->content_effects = effects;
 
-    case PROP_POSITION:
-      {
-        const ClutterPoint *pos = g_value_get_boxed (value);
+  clutter_actor_paint_retained_node (self);
 
-        if (pos != NULL)
-          clutter_actor_set_position (actor, pos->x, pos->y);
-        else
-          clutter_actor_set_fixed_position_set (actor, FALSE);
-      }
-      break;
-
-    case PROP_WIDTH:
-      clutter_actor_set_width (actor, g_value_get_float (value));
-      break;
+  priv->content_effects = NULL;
+}
 
-    case PROP_HEIGHT:
-      clutter_actor_set_height (actor, g_value_get_float (value));
-      break;
+/**
+ * clutter_actor_continue_paint:
+ * @self: A #ClutterActor
+ *
+ * Run the next stage of the paint sequence. This function should only
+ * be called within the implementation of the ‘run’ virtual of a
+ * #ClutterEffect. It will cause the run method of the next effect to
+ * be applied, or it will paint the actual actor if the current effect
+ * is the last effect in the chain.
+ *
+ * Since: 1.8
+ */
+void
+clutter_actor_continue_paint (ClutterActor *self)
+{
+  ClutterActorPrivate *priv;
 
-    case PROP_SIZE:
-      {
-        const ClutterSize *size = g_value_get_boxed (value);
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  /* This should only be called from with in the ‘run’ implementation
+     of a ClutterEffect */
+  g_return_if_fail (CLUTTER_ACTOR_IN_PAINT (self));
 
-        if (size != NULL)
-          clutter_actor_set_size (actor, size->width, size->height);
-        else
-          clutter_actor_set_size (actor, -1, -1);
-      }
-      break;
+  priv = self->priv;
 
-    case PROP_FIXED_X:
-      clutter_actor_set_x (actor, g_value_get_float (value));
-      break;
+  /* Skip any effects that are disabled */
+  while (priv->next_effect_to_paint &&
+         !clutter_actor_meta_get_enabled (priv->next_effect_to_paint->data))
+    priv->next_effect_to_paint = priv->next_effect_to_paint->next;
 
-    case PROP_FIXED_Y:
-      clutter_actor_set_y (actor, g_value_get_float (value));
-      break;
+  /* If this has come from the last effect then we'll just paint the
+     actual actor */
+  if (priv->next_effect_to_paint == NULL)
+    {
+      if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+        {
+          /* the retained paint nodes must not apply the effects that
+           * are now painting the actor offscreen
+           */
+          if (priv->retained_content_effects)
+            {
+              clutter_actor_release_paint_node (self);
+              priv->retained_content_effects = FALSE;
+            }
 
-    case PROP_FIXED_POSITION_SET:
-      clutter_actor_set_fixed_position_set (actor, g_value_get_boolean (value));
-      break;
+          /* XXX - this will go away in 2.0, when we can get rid of this
+           * stuff and switch to a pure retained render tree of PaintNodes
+           * for the entire frame, starting from the Stage; the paint()
+           * virtual function can then be called directly.
+           */
+          clutter_actor_paint_retained_node (self);
 
-    case PROP_MIN_WIDTH:
-      clutter_actor_set_min_width (actor, g_value_get_float (value));
-      break;
+          /* XXX:2.0 - Call the paint() virtual directly */
+          g_signal_emit (self, actor_signals[PAINT], 0);
+        }
+      else
+        {
+          ClutterStage *stage;
+          ClutterColor col = { 0, };
 
-    case PROP_MIN_HEIGHT:
-      clutter_actor_set_min_height (actor, g_value_get_float (value));
-      break;
+          /* a geometric pick cannot represent arbitrary silhouettes,
+           * so we bail out and let the stage use the color-based pick;
+           * we also must not emit any geometry, since it would end up
+           * on the onscreen framebuffer
+           */
+          stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
+          if (_clutter_stage_in_geometric_pick (stage))
+            {
+              if (_clutter_stage_needs_pick_fallback (stage))
+                return;
 
-    case PROP_NATURAL_WIDTH:
-      clutter_actor_set_natural_width (actor, g_value_get_float (value));
-      break;
+              if (!clutter_actor_has_geometric_pick (self))
+                {
+                  _clutter_stage_request_pick_fallback (stage);
+                  return;
+                }
+            }
 
-    case PROP_NATURAL_HEIGHT:
-      clutter_actor_set_natural_height (actor, g_value_get_float (value));
-      break;
+          _clutter_id_to_color (_clutter_actor_get_pick_id (self), &col);
 
-    case PROP_MIN_WIDTH_SET:
-      clutter_actor_set_min_width_set (actor, g_value_get_boolean (value));
-      break;
+          /* Actor will then paint silhouette of itself in supplied
+           * color.  See clutter_stage_get_actor_at_pos() for where
+           * picking is enabled.
+           *
+           * XXX:2.0 - Call the pick() virtual directly
+           */
+          g_signal_emit (self, actor_signals[PICK], 0, &col);
+        }
+    }
+  else
+    {
+      ClutterEffect *old_current_effect;
+      ClutterEffectPaintFlags run_flags = 0;
 
-    case PROP_MIN_HEIGHT_SET:
-      clutter_actor_set_min_height_set (actor, g_value_get_boolean (value));
-      break;
+      /* Cache the current effect so that we can put it back before
+         returning */
+      old_current_effect = priv->current_effect;
 
-    case PROP_NATURAL_WIDTH_SET:
-      clutter_actor_set_natural_width_set (actor, g_value_get_boolean (value));
-      break;
+      priv->current_effect = priv->next_effect_to_paint->data;
+      priv->next_effect_to_paint = priv->next_effect_to_paint->next;
 
-    case PROP_NATURAL_HEIGHT_SET:
-      clutter_actor_set_natural_height_set (actor, g_value_get_boolean (value));
-      break;
+      if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+        {
+          GList *fused_effects = NULL;
+          gboolean is_pointwise;
 
-    case PROP_REQUEST_MODE:
-      clutter_actor_set_request_mode (actor, g_value_get_enum (value));
-      break;
+          is_pointwise =
+            _clutter_offscreen_effect_is_pointwise (priv->current_effect);
+          if (is_pointwise)
+            {
+              fused_effects = clutter_actor_fuse_pointwise_effects (self);
 
-    case PROP_DEPTH: /* XXX:2.0 - remove */
-      clutter_actor_set_depth (actor, g_value_get_float (value));
-      break;
+              if (clutter_actor_can_paint_effects_on_content (self))
+                {
+                  fused_effects = g_list_append (fused_effects,
+                                                 priv->current_effect);
 
-    case PROP_Z_POSITION:
-      clutter_actor_set_z_position (actor, g_value_get_float (value));
-      break;
+                  clutter_actor_paint_effects_on_content (self, fused_effects);
 
-    case PROP_OPACITY:
-      clutter_actor_set_opacity (actor, g_value_get_uint (value));
-      break;
+                  g_list_free (fused_effects);
+                  priv->current_effect = old_current_effect;
+                  return;
+                }
+            }
 
-    case PROP_OFFSCREEN_REDIRECT:
-      clutter_actor_set_offscreen_redirect (actor, g_value_get_enum (value));
-      break;
+          if (priv->is_dirty)
+            {
+              /* If there's an effect queued with this redraw then all
+                 effects up to that one will be considered dirty. It
+                 is expected the queued effect will paint the cached
+                 image and not call clutter_actor_continue_paint again
+                 (although it should work ok if it does). The fused
+                 effects are applied when painting the cached image */
+              if (priv->effect_to_redraw == NULL ||
+                  (priv->current_effect != priv->effect_to_redraw &&
+                   g_list_find (fused_effects, priv->effect_to_redraw) == NULL))
+                run_flags |= CLUTTER_EFFECT_PAINT_ACTOR_DIRTY;
+            }
 
-    case PROP_NAME:
-      clutter_actor_set_name (actor, g_value_get_string (value));
-      break;
+          if (is_pointwise)
+            _clutter_offscreen_effect_set_fused_effects (CLUTTER_OFFSCREEN_EFFECT (priv->current_effect),
+                                                         fused_effects);
 
-    case PROP_VISIBLE:
-      if (g_value_get_boolean (value) == TRUE)
-	clutter_actor_show (actor);
+          _clutter_effect_paint (priv->current_effect, run_flags);
+        }
       else
-	clutter_actor_hide (actor);
-      break;
+        {
+          /* We can't determine when an actor has been modified since
+             its last pick so lets just assume it has always been
+             modified */
+          run_flags |= CLUTTER_EFFECT_PAINT_ACTOR_DIRTY;
 
-    case PROP_PIVOT_POINT:
-      {
-        const ClutterPoint *pivot = g_value_get_boxed (value);
+          if (_clutter_effect_has_custom_pick (priv->current_effect))
+            {
+              ClutterStage *stage;
 
-        if (pivot == NULL)
-          pivot = clutter_point_zero ();
+              stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
+              if (_clutter_stage_in_geometric_pick (stage))
+                {
+                  _clutter_stage_request_pick_fallback (stage);
+                  priv->current_effect = old_current_effect;
+                  return;
+                }
+            }
 
-        clutter_actor_set_pivot_point (actor, pivot->x, pivot->y);
-      }
-      break;
+          _clutter_effect_pick (priv->current_effect, run_flags);
+        }
 
-    case PROP_PIVOT_POINT_Z:
-      clutter_actor_set_pivot_point_z (actor, g_value_get_float (value));
-      break;
+      priv->current_effect = old_current_effect;
+    }
+}
 
-    case PROP_TRANSLATION_X:
-      clutter_actor_set_translation_factor (actor, CLUTTER_X_AXIS,
-                                            g_value_get_float (value));
-      break;
+static void
+_clutter_actor_stop_transitions (ClutterActor *self)
+{
+  const ClutterAnimationInfo *info;
+  GHashTableIter iter;
+  gpointer value;
 
-    case PROP_TRANSLATION_Y:
-      clutter_actor_set_translation_factor (actor, CLUTTER_Y_AXIS,
-                                            g_value_get_float (value));
-      break;
+  info = _clutter_actor_get_animation_info_or_defaults (self);
+  if (info->transitions == NULL)
+    return;
 
-    case PROP_TRANSLATION_Z:
-      clutter_actor_set_translation_factor (actor, CLUTTER_Z_AXIS,
-                                            g_value_get_float (value));
-      break;
+  g_hash_table_iter_init (&iter, info->transitions);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      TransitionClosure *closure = value;
 
-    case PROP_SCALE_X:
-      clutter_actor_set_scale_factor (actor, CLUTTER_X_AXIS,
-                                      g_value_get_double (value));
-      break;
+      /* implicit transitions, and automatically managed explicit ones,
+       * should be removed at this point
+       */
+      if (closure->is_implicit ||
+          clutter_transition_get_remove_on_complete (closure->transition))
+        {
+          g_hash_table_iter_remove (&iter);
+        }
+      else
+        {
+          /* otherwise we stop it, and the transition will be removed
+           * later, either by the actor's destruction or by explicit
+           * removal
+           */
+          clutter_timeline_stop (CLUTTER_TIMELINE (closure->transition));
+        }
+    }
+}
 
-    case PROP_SCALE_Y:
-      clutter_actor_set_scale_factor (actor, CLUTTER_Y_AXIS,
-                                      g_value_get_double (value));
-      break;
+static ClutterActorTraverseVisitFlags
+invalidate_queue_redraw_entry (ClutterActor *self,
+                               int           depth,
+                               gpointer      user_data)
+{
+  ClutterActorPrivate *priv = self->priv;
 
-    case PROP_SCALE_Z:
-      clutter_actor_set_scale_factor (actor, CLUTTER_Z_AXIS,
-                                      g_value_get_double (value));
-      break;
+  if (priv->queue_redraw_entry != NULL)
+    {
+      _clutter_stage_queue_redraw_entry_invalidate (priv->queue_redraw_entry);
+      priv->queue_redraw_entry = NULL;
+    }
 
-    case PROP_SCALE_CENTER_X: /* XXX:2.0 - remove */
-      clutter_actor_set_scale_center (actor, CLUTTER_X_AXIS,
-                                      g_value_get_float (value));
-      break;
-
-    case PROP_SCALE_CENTER_Y: /* XXX:2.0 - remove */
-      clutter_actor_set_scale_center (actor, CLUTTER_Y_AXIS,
-                                      g_value_get_float (value));
-      break;
+  return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
+}
 
-    case PROP_SCALE_GRAVITY: /* XXX:2.0 - remove */
-      clutter_actor_set_scale_gravity (actor, g_value_get_enum (value));
-      break;
+static inline void
+remove_child (ClutterActor *self,
+              ClutterActor *child)
+{
+  ClutterActor *prev_sibling, *next_sibling;
 
-    case PROP_CLIP: /* XXX:2.0 - remove */
-      {
-        const ClutterGeometry *geom = g_value_get_boxed (value);
+  prev_sibling = child->priv->prev_sibling;
+  next_sibling = child->priv->next_sibling;
 
-	clutter_actor_set_clip (actor,
-				geom->x, geom->y,
-				geom->width, geom->height);
-      }
-      break;
+  if (prev_sibling != NULL)
+    prev_sibling->priv->next_sibling = next_sibling;
 
-    case PROP_CLIP_RECT:
-      clutter_actor_set_clip_rect (actor, g_value_get_boxed (value));
-      break;
+  if (next_sibling != NULL)
+    next_sibling->priv->prev_sibling = prev_sibling;
 
-    case PROP_CLIP_TO_ALLOCATION:
-      clutter_actor_set_clip_to_allocation (actor, g_value_get_boolean (value));
-      break;
+  if (self->priv->first_child == child)
+    self->priv->first_child = next_sibling;
 
-    case PROP_REACTIVE:
-      clutter_actor_set_reactive (actor, g_value_get_boolean (value));
-      break;
+  if (self->priv->last_child == child)
+    self->priv->last_child = prev_sibling;
 
-    case PROP_ROTATION_ANGLE_X:
-      clutter_actor_set_rotation_angle (actor,
-                                        CLUTTER_X_AXIS,
-                                        g_value_get_double (value));
-      break;
+  if (child->priv->z_sorted_iter != NULL)
+    {
+      g_sequence_remove (child->priv->z_sorted_iter);
+      child->priv->z_sorted_iter = NULL;
+    }
 
-    case PROP_ROTATION_ANGLE_Y:
-      clutter_actor_set_rotation_angle (actor,
-                                        CLUTTER_Y_AXIS,
-                                        g_value_get_double (value));
-      break;
+  clutter_actor_invalidate_paint_volume (child);
 
-    case PROP_ROTATION_ANGLE_Z:
-      clutter_actor_set_rotation_angle (actor,
-                                        CLUTTER_Z_AXIS,
-                                        g_value_get_double (value));
-      break;
+  child->priv->parent = NULL;
+  child->priv->prev_sibling = NULL;
+  child->priv->next_sibling = NULL;
+}
 
-    case PROP_ROTATION_CENTER_X: /* XXX:2.0 - remove */
-      clutter_actor_set_rotation_center_internal (actor,
-                                                  CLUTTER_X_AXIS,
-                                                  g_value_get_boxed (value));
-      break;
+typedef enum {
+  REMOVE_CHILD_DESTROY_META       = 1 << 0,
+  REMOVE_CHILD_EMIT_PARENT_SET    = 1 << 1,
+  REMOVE_CHILD_EMIT_ACTOR_REMOVED = 1 << 2,
+  REMOVE_CHILD_CHECK_STATE        = 1 << 3,
+  REMOVE_CHILD_FLUSH_QUEUE        = 1 << 4,
+  REMOVE_CHILD_NOTIFY_FIRST_LAST  = 1 << 5,
+  REMOVE_CHILD_STOP_TRANSITIONS   = 1 << 6,
 
-    case PROP_ROTATION_CENTER_Y: /* XXX:2.0 - remove */
-      clutter_actor_set_rotation_center_internal (actor,
-                                                  CLUTTER_Y_AXIS,
-                                                  g_value_get_boxed (value));
-      break;
+  /* default flags for public API */
+  REMOVE_CHILD_DEFAULT_FLAGS      = REMOVE_CHILD_STOP_TRANSITIONS |
+                                    REMOVE_CHILD_DESTROY_META |
+                                    REMOVE_CHILD_EMIT_PARENT_SET |
+                                    REMOVE_CHILD_EMIT_ACTOR_REMOVED |
+                                    REMOVE_CHILD_CHECK_STATE |
+                                    REMOVE_CHILD_FLUSH_QUEUE |
+                                    REMOVE_CHILD_NOTIFY_FIRST_LAST,
 
-    case PROP_ROTATION_CENTER_Z: /* XXX:2.0 - remove */
-      clutter_actor_set_rotation_center_internal (actor,
-                                                  CLUTTER_Z_AXIS,
-                                                  g_value_get_boxed (value));
-      break;
+  /* flags for legacy/deprecated API */
+  REMOVE_CHILD_LEGACY_FLAGS       = REMOVE_CHILD_STOP_TRANSITIONS |
+                                    REMOVE_CHILD_CHECK_STATE |
+                                    REMOVE_CHILD_FLUSH_QUEUE |
+                                    REMOVE_CHILD_EMIT_PARENT_SET |
+                                    REMOVE_CHILD_NOTIFY_FIRST_LAST
+} ClutterActorRemoveChildFlags;
 
-    case PROP_ROTATION_CENTER_Z_GRAVITY: /* XXX:2.0 - remove */
-      {
-        const ClutterTransformInfo *info;
+/*< private >
+ * clutter_actor_remove_child_internal:
+ * @self: a #ClutterActor
+ * @child: the child of @self that has to be removed
+ * @flags: control the removal operations
+ *
+ * Removes @child from the list of children of @self.
+ */
+static void
+clutter_actor_remove_child_internal (ClutterActor                 *self,
+                                     ClutterActor                 *child,
+                                     ClutterActorRemoveChildFlags  flags)
+{
+  ClutterActor *old_first, *old_last;
+  gboolean destroy_meta, emit_parent_set, emit_actor_removed, check_state;
+  gboolean flush_queue;
+  gboolean notify_first_last;
+  gboolean was_mapped;
+  gboolean stop_transitions;
+  GObject *obj;
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        clutter_actor_set_z_rotation_from_gravity (actor, info->rz_angle,
-                                                   g_value_get_enum (value));
-      }
-      break;
+  destroy_meta = (flags & REMOVE_CHILD_DESTROY_META) != 0;
+  emit_parent_set = (flags & REMOVE_CHILD_EMIT_PARENT_SET) != 0;
+  emit_actor_removed = (flags & REMOVE_CHILD_EMIT_ACTOR_REMOVED) != 0;
+  check_state = (flags & REMOVE_CHILD_CHECK_STATE) != 0;
+  flush_queue = (flags & REMOVE_CHILD_FLUSH_QUEUE) != 0;
+  notify_first_last = (flags & REMOVE_CHILD_NOTIFY_FIRST_LAST) != 0;
+  stop_transitions = (flags & REMOVE_CHILD_STOP_TRANSITIONS) != 0;
 
-    case PROP_ANCHOR_X: /* XXX:2.0 - remove */
-      clutter_actor_set_anchor_coord (actor, CLUTTER_X_AXIS,
-                                      g_value_get_float (value));
-      break;
+  obj = G_OBJECT (self);
+  g_object_freeze_notify (obj);
 
-    case PROP_ANCHOR_Y: /* XXX:2.0 - remove */
-      clutter_actor_set_anchor_coord (actor, CLUTTER_Y_AXIS,
-                                      g_value_get_float (value));
-      break;
+  if (stop_transitions)
+    _clutter_actor_stop_transitions (child);
 
-    case PROP_ANCHOR_GRAVITY: /* XXX:2.0 - remove */
-      clutter_actor_set_anchor_point_from_gravity (actor,
-                                                   g_value_get_enum (value));
-      break;
+  if (destroy_meta)
+    clutter_container_destroy_child_meta (CLUTTER_CONTAINER (self), child);
 
-    case PROP_TRANSFORM:
-      clutter_actor_set_transform (actor, g_value_get_boxed (value));
-      break;
+  if (check_state)
+    {
+      was_mapped = CLUTTER_ACTOR_IS_MAPPED (child);
 
-    case PROP_CHILD_TRANSFORM:
-      clutter_actor_set_child_transform (actor, g_value_get_boxed (value));
-      break;
+      /* we need to unrealize *before* we set parent_actor to NULL,
+       * because in an unrealize method actors are dissociating from the
+       * stage, which means they need to be able to
+       * clutter_actor_get_stage().
+       *
+       * yhis should unmap and unrealize, unless we're reparenting.
+       */
+      clutter_actor_update_map_state (child, MAP_STATE_MAKE_UNREALIZED);
+    }
+  else
+    was_mapped = FALSE;
 
-    case PROP_SHOW_ON_SET_PARENT: /* XXX:2.0 - remove */
-      priv->show_on_set_parent = g_value_get_boolean (value);
-      break;
+  if (flush_queue)
+    {
+      /* We take this opportunity to invalidate any queue redraw entry
+       * associated with the actor and descendants since we won't be able to
+       * determine the appropriate stage after this.
+       *
+       * we do this after we updated the mapped state because actors might
+       * end up queueing redraws inside their mapped/unmapped virtual
+       * functions, and if we invalidate the redraw entry we could end up
+       * with an inconsistent state and weird memory corruption. see
+       * bugs:
+       *
+       *   http://bugzilla.clutter-project.org/show_bug.cgi?id=2621
+       *   https://bugzilla.gnome.org/show_bug.cgi?id=652036
+       */
+      _clutter_actor_traverse (child,
+                               0,
+                               invalidate_queue_redraw_entry,
+                               NULL,
+                               NULL);
+    }
 
-    case PROP_TEXT_DIRECTION:
-      clutter_actor_set_text_direction (actor, g_value_get_enum (value));
-      break;
+  old_first = self->priv->first_child;
+  old_last = self->priv->last_child;
 
-    case PROP_ACTIONS:
-      clutter_actor_add_action (actor, g_value_get_object (value));
-      break;
+  clutter_actor_remove_from_child_index (child);
 
-    case PROP_CONSTRAINTS:
-      clutter_actor_add_constraint (actor, g_value_get_object (value));
-      break;
+  clutter_actor_update_reactive_descendants (child,
+                                             -clutter_actor_get_reactive_subtree_size (child));
 
-    case PROP_EFFECT:
-      clutter_actor_add_effect (actor, g_value_get_object (value));
-      break;
+  remove_child (self, child);
 
-    case PROP_LAYOUT_MANAGER:
-      clutter_actor_set_layout_manager (actor, g_value_get_object (value));
-      break;
+  self->priv->n_children -= 1;
 
-    case PROP_X_EXPAND:
-      clutter_actor_set_x_expand (actor, g_value_get_boolean (value));
-      break;
+  self->priv->age += 1;
 
-    case PROP_Y_EXPAND:
-      clutter_actor_set_y_expand (actor, g_value_get_boolean (value));
-      break;
+  clutter_actor_invalidate_pick_cache (self);
 
-    case PROP_X_ALIGN:
-      clutter_actor_set_x_align (actor, g_value_get_enum (value));
-      break;
+  /* if the child that got removed was visible and set to
+   * expand then we want to reset the parent's state in
+   * case the child was the only thing that was making it
+   * expand.
+   */
+  if (CLUTTER_ACTOR_IS_VISIBLE (child) &&
+      (child->priv->needs_compute_expand ||
+       child->priv->needs_x_expand ||
+       child->priv->needs_y_expand))
+    {
+      clutter_actor_queue_compute_expand (self);
+    }
 
-    case PROP_Y_ALIGN:
-      clutter_actor_set_y_align (actor, g_value_get_enum (value));
-      break;
+  /* clutter_actor_reparent() will emit ::parent-set for us */
+  if (emit_parent_set && !CLUTTER_ACTOR_IN_REPARENT (child))
+    g_signal_emit (child, actor_signals[PARENT_SET], 0, self);
 
-    case PROP_MARGIN_TOP:
-      clutter_actor_set_margin_top (actor, g_value_get_float (value));
-      break;
+  /* if the child was mapped then we need to relayout ourselves to account
+   * for the removed child
+   */
+  if (was_mapped)
+    clutter_actor_queue_relayout (self);
 
-    case PROP_MARGIN_BOTTOM:
-      clutter_actor_set_margin_bottom (actor, g_value_get_float (value));
-      break;
+  /* we need to emit the signal before dropping the reference */
+  if (emit_actor_removed)
+    g_signal_emit_by_name (self, "actor-removed", child);
 
-    case PROP_MARGIN_LEFT:
-      clutter_actor_set_margin_left (actor, g_value_get_float (value));
-      break;
+  if (notify_first_last)
+    {
+      if (old_first != self->priv->first_child)
+        clutter_actor_notify (self, obj_props[PROP_FIRST_CHILD]);
 
-    case PROP_MARGIN_RIGHT:
-      clutter_actor_set_margin_right (actor, g_value_get_float (value));
-      break;
+      if (old_last != self->priv->last_child)
+        clutter_actor_notify (self, obj_props[PROP_LAST_CHILD]);
+    }
 
-    case PROP_BACKGROUND_COLOR:
-      clutter_actor_set_background_color (actor, g_value_get_boxed (value));
-      break;
+  g_object_thaw_notify (obj);
 
-    case PROP_CONTENT:
-      clutter_actor_set_content (actor, g_value_get_object (value));
-      break;
+  /* remove the reference we acquired in clutter_actor_add_child() */
+  g_object_unref (child);
+}
 
-    case PROP_CONTENT_GRAVITY:
-      clutter_actor_set_content_gravity (actor, g_value_get_enum (value));
-      break;
+static const ClutterTransformInfo default_transform_info = {
+  0.0, { 0, },                  /* rotation-x */
+  0.0, { 0, },                  /* rotation-y */
+  0.0, { 0, },                  /* rotation-z */
 
-    case PROP_MINIFICATION_FILTER:
-      clutter_actor_set_content_scaling_filters (actor,
-                                                 g_value_get_enum (value),
-                                                 actor->priv->mag_filter);
-      break;
+  1.0, 1.0, 1.0, { 0, },        /* scale */
 
-    case PROP_MAGNIFICATION_FILTER:
-      clutter_actor_set_content_scaling_filters (actor,
-                                                 actor->priv->min_filter,
-                                                 g_value_get_enum (value));
-      break;
+  { 0, },                       /* anchor XXX:2.0 - remove*/
 
-    case PROP_CONTENT_REPEAT:
-      clutter_actor_set_content_repeat (actor, g_value_get_flags (value));
-      break;
+  CLUTTER_VERTEX_INIT_ZERO,     /* translation */
 
-    default:
-      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-      break;
-    }
+  0.f,                          /* z-position */
+
+  CLUTTER_POINT_INIT_ZERO,      /* pivot */
+  0.f,                          /* pivot-z */
+
+  CLUTTER_MATRIX_INIT_IDENTITY,
+  FALSE,                        /* transform */
+  CLUTTER_MATRIX_INIT_IDENTITY,
+  FALSE,                        /* child-transform */
+};
+
+/*< private >
+ * _clutter_actor_get_transform_info_or_defaults:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the ClutterTransformInfo structure associated to an actor.
+ *
+ * If the actor does not have a ClutterTransformInfo structure associated
+ * to it, then the default structure will be returned.
+ *
+ * This function should only be used for getters.
+ *
+ * Return value: a const pointer to the ClutterTransformInfo structure
+ */
+const ClutterTransformInfo *
+_clutter_actor_get_transform_info_or_defaults (ClutterActor *self)
+{
+  ClutterTransformInfo *info = self->priv->transform_info;
+
+  if (info != NULL)
+    return info;
+
+  return &default_transform_info;
 }
 
-static void
-clutter_actor_get_property (GObject    *object,
-			    guint       prop_id,
-			    GValue     *value,
-			    GParamSpec *pspec)
+/*< private >
+ * _clutter_actor_get_transform_info:
+ * @self: a #ClutterActor
+ *
+ * Retrieves a pointer to the ClutterTransformInfo structure.
+ *
+ * If the actor does not have a ClutterTransformInfo associated to it, one
+ * will be created and initialized to the default values.
+ *
+ * This function should be used for setters.
+ *
+ * For getters, you should use _clutter_actor_get_transform_info_or_defaults()
+ * instead.
+ *
+ * Return value: (transfer none): a pointer to the ClutterTransformInfo
+ *   structure
+ */
+ClutterTransformInfo *
+_clutter_actor_get_transform_info (ClutterActor *self)
 {
-  ClutterActor *actor = CLUTTER_ACTOR (object);
-  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorPrivate *priv = self->priv;
 
-  switch (prop_id)
+  if (priv->transform_info == NULL)
     {
-    case PROP_X:
-      g_value_set_float (value, clutter_actor_get_x (actor));
-      break;
+      priv->transform_info = g_slice_new (ClutterTransformInfo);
 
-    case PROP_Y:
-      g_value_set_float (value, clutter_actor_get_y (actor));
-      break;
+      *priv->transform_info = default_transform_info;
+    }
 
-    case PROP_POSITION:
-      {
-        ClutterPoint position;
+  return priv->transform_info;
+}
 
-        clutter_point_init (&position,
-                            clutter_actor_get_x (actor),
-                            clutter_actor_get_y (actor));
-        g_value_set_boxed (value, &position);
-      }
-      break;
+static inline void
+clutter_actor_set_pivot_point_internal (ClutterActor       *self,
+                                        const ClutterPoint *pivot)
+{
+  ClutterTransformInfo *info;
 
-    case PROP_WIDTH:
-      g_value_set_float (value, clutter_actor_get_width (actor));
-      break;
+  info = _clutter_actor_get_transform_info (self);
+  info->pivot = *pivot;
 
-    case PROP_HEIGHT:
-      g_value_set_float (value, clutter_actor_get_height (actor));
-      break;
+  clutter_actor_invalidate_transform (self);
 
-    case PROP_SIZE:
-      {
-        ClutterSize size;
+  clutter_actor_notify (self, obj_props[PROP_PIVOT_POINT]);
 
-        clutter_size_init (&size,
-                           clutter_actor_get_width (actor),
-                           clutter_actor_get_height (actor));
-        g_value_set_boxed (value, &size);
-      }
-      break;
+  clutter_actor_queue_redraw (self);
+}
 
-    case PROP_FIXED_X:
-      {
-        const ClutterLayoutInfo *info;
+static inline void
+clutter_actor_set_pivot_point_z_internal (ClutterActor *self,
+                                          float         pivot_z)
+{
+  ClutterTransformInfo *info;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->fixed_pos.x);
-      }
-      break;
+  info = _clutter_actor_get_transform_info (self);
+  info->pivot_z = pivot_z;
 
-    case PROP_FIXED_Y:
-      {
-        const ClutterLayoutInfo *info;
+  clutter_actor_invalidate_transform (self);
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->fixed_pos.y);
-      }
-      break;
+  clutter_actor_notify (self, obj_props[PROP_PIVOT_POINT_Z]);
 
-    case PROP_FIXED_POSITION_SET:
-      g_value_set_boolean (value, priv->position_set);
-      break;
+  clutter_actor_queue_redraw (self);
+}
 
-    case PROP_MIN_WIDTH:
-      {
-        const ClutterLayoutInfo *info;
+/*< private >
+ * clutter_actor_set_translation_internal:
+ * @self: a #ClutterActor
+ * @axis: the axis of the translation to change
+ * @angle: the translation as a value along @axis
+ *
+ * Sets the translation on the given @axis
+ */
+static void
+clutter_actor_set_translation_internal (ClutterActor *self,
+                                        gfloat        value,
+                                        GParamSpec   *pspec)
+{
+  GObject *obj = G_OBJECT (self);
+  ClutterTransformInfo *info;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->minimum.width);
-      }
-      break;
+  info = _clutter_actor_get_transform_info (self);
 
-    case PROP_MIN_HEIGHT:
-      {
-        const ClutterLayoutInfo *info;
+  if (pspec == obj_props[PROP_TRANSLATION_X])
+    info->translation.x = value;
+  else if (pspec == obj_props[PROP_TRANSLATION_Y])
+    info->translation.y = value;
+  else if (pspec == obj_props[PROP_TRANSLATION_Z])
+    info->translation.z = value;
+  else
+    g_assert_not_reached ();
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->minimum.height);
-      }
-      break;
+  clutter_actor_invalidate_transform (self);
+  clutter_actor_queue_redraw (self);
+  clutter_actor_notify (self, pspec);
+}
 
-    case PROP_NATURAL_WIDTH:
-      {
-        const ClutterLayoutInfo *info;
+static inline void
+clutter_actor_set_translation_factor (ClutterActor      *self,
+                                      ClutterRotateAxis  axis,
+                                      gdouble            value)
+{
+  const ClutterTransformInfo *info;
+  const float *translate_p = NULL;
+  GParamSpec *pspec = NULL;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->natural.width);
-      }
-      break;
+  info = _clutter_actor_get_transform_info_or_defaults (self);
 
-    case PROP_NATURAL_HEIGHT:
-      {
-        const ClutterLayoutInfo *info;
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      pspec = obj_props[PROP_TRANSLATION_X];
+      translate_p = &info->translation.x;
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->natural.height);
-      }
+    case CLUTTER_Y_AXIS:
+      pspec = obj_props[PROP_TRANSLATION_Y];
+      translate_p = &info->translation.y;
       break;
 
-    case PROP_MIN_WIDTH_SET:
-      g_value_set_boolean (value, priv->min_width_set);
+    case CLUTTER_Z_AXIS:
+      pspec = obj_props[PROP_TRANSLATION_Z];
+      translate_p = &info->translation.z;
       break;
+    }
 
-    case PROP_MIN_HEIGHT_SET:
-      g_value_set_boolean (value, priv->min_height_set);
-      break;
+  g_assert (pspec != NULL);
+  g_assert (translate_p != NULL);
 
-    case PROP_NATURAL_WIDTH_SET:
-      g_value_set_boolean (value, priv->natural_width_set);
-      break;
+  _clutter_actor_create_transition (self, pspec, *translate_p, value);
+}
 
-    case PROP_NATURAL_HEIGHT_SET:
-      g_value_set_boolean (value, priv->natural_height_set);
-      break;
+/**
+ * clutter_actor_set_translation:
+ * @self: a #ClutterActor
+ * @translate_x: the translation along the X axis
+ * @translate_y: the translation along the Y axis
+ * @translate_z: the translation along the Z axis
+ *
+ * Sets an additional translation transformation on a #ClutterActor,
+ * relative to the #ClutterActor:pivot-point.
+ *
+ * Since: 1.12
+ */
+void
+clutter_actor_set_translation (ClutterActor *self,
+                               gfloat        translate_x,
+                               gfloat        translate_y,
+                               gfloat        translate_z)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-    case PROP_REQUEST_MODE:
-      g_value_set_enum (value, priv->request_mode);
-      break;
+  g_object_freeze_notify (G_OBJECT (self));
 
-    case PROP_ALLOCATION:
-      g_value_set_boxed (value, &priv->allocation);
-      break;
+  clutter_actor_set_translation_factor (self, CLUTTER_X_AXIS, translate_x);
+  clutter_actor_set_translation_factor (self, CLUTTER_Y_AXIS, translate_y);
+  clutter_actor_set_translation_factor (self, CLUTTER_Z_AXIS, translate_z);
 
-    case PROP_DEPTH: /* XXX:2.0 - remove */
-      g_value_set_float (value, clutter_actor_get_depth (actor));
-      break;
+  g_object_thaw_notify (G_OBJECT (self));
+}
 
-    case PROP_Z_POSITION:
-      g_value_set_float (value, clutter_actor_get_z_position (actor));
-      break;
+/**
+ * clutter_actor_get_translation:
+ * @self: a #ClutterActor
+ * @translate_x: (out) (allow-none): return location for the X component
+ *   of the translation, or %NULL
+ * @translate_y: (out) (allow-none): return location for the Y component
+ *   of the translation, or %NULL
+ * @translate_z: (out) (allow-none): return location for the Z component
+ *   of the translation, or %NULL
+ *
+ * Retrieves the translation set using clutter_actor_set_translation().
+ *
+ * Since: 1.12
+ */
+void
+clutter_actor_get_translation (ClutterActor *self,
+                               gfloat       *translate_x,
+                               gfloat       *translate_y,
+                               gfloat       *translate_z)
+{
+  const ClutterTransformInfo *info;
 
-    case PROP_OPACITY:
-      g_value_set_uint (value, priv->opacity);
-      break;
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-    case PROP_OFFSCREEN_REDIRECT:
-      g_value_set_flags (value, priv->offscreen_redirect);
-      break;
+  info = _clutter_actor_get_transform_info_or_defaults (self);
 
-    case PROP_NAME:
-      g_value_set_string (value, priv->name);
-      break;
+  if (translate_x != NULL)
+    *translate_x = info->translation.x;
 
-    case PROP_VISIBLE:
-      g_value_set_boolean (value, CLUTTER_ACTOR_IS_VISIBLE (actor));
-      break;
+  if (translate_y != NULL)
+    *translate_y = info->translation.y;
 
-    case PROP_MAPPED:
-      g_value_set_boolean (value, CLUTTER_ACTOR_IS_MAPPED (actor));
-      break;
+  if (translate_z != NULL)
+    *translate_z = info->translation.z;
+}
 
-    case PROP_REALIZED:
-      g_value_set_boolean (value, CLUTTER_ACTOR_IS_REALIZED (actor));
-      break;
+/*< private >
+ * clutter_actor_set_rotation_angle_internal:
+ * @self: a #ClutterActor
+ * @angle: the angle of rotation
+ * @pspec: the #GParamSpec of the property
+ *
+ * Sets the rotation angle on the given axis without affecting the
+ * rotation center point.
+ */
+static inline void
+clutter_actor_set_rotation_angle_internal (ClutterActor *self,
+                                           gdouble       angle,
+                                           GParamSpec   *pspec)
+{
+  ClutterTransformInfo *info;
 
-    case PROP_HAS_CLIP:
-      g_value_set_boolean (value, priv->has_clip);
-      break;
+  info = _clutter_actor_get_transform_info (self);
 
-    case PROP_CLIP: /* XXX:2.0 - remove */
-      {
-        ClutterGeometry clip;
+  if (pspec == obj_props[PROP_ROTATION_ANGLE_X])
+    info->rx_angle = angle;
+  else if (pspec == obj_props[PROP_ROTATION_ANGLE_Y])
+    info->ry_angle = angle;
+  else if (pspec == obj_props[PROP_ROTATION_ANGLE_Z])
+    info->rz_angle = angle;
+  else
+    g_assert_not_reached ();
 
-        clip.x      = CLUTTER_NEARBYINT (priv->clip.origin.x);
-        clip.y      = CLUTTER_NEARBYINT (priv->clip.origin.y);
-        clip.width  = CLUTTER_NEARBYINT (priv->clip.size.width);
-        clip.height = CLUTTER_NEARBYINT (priv->clip.size.height);
+  clutter_actor_invalidate_transform (self);
 
-        g_value_set_boxed (value, &clip);
-      }
-      break;
+  clutter_actor_queue_redraw (self);
 
-    case PROP_CLIP_RECT:
-      g_value_set_boxed (value, &priv->clip);
-      break;
+  clutter_actor_notify (self, pspec);
+}
 
-    case PROP_CLIP_TO_ALLOCATION:
-      g_value_set_boolean (value, priv->clip_to_allocation);
-      break;
+/**
+ * clutter_actor_set_rotation_angle:
+ * @self: a #ClutterActor
+ * @axis: the axis to set the angle one
+ * @angle: the angle of rotation, in degrees
+ *
+ * Sets the @angle of rotation of a #ClutterActor on the given @axis.
+ *
+ * This function is a convenience for setting the rotation properties
+ * #ClutterActor:rotation-angle-x, #ClutterActor:rotation-angle-y,
+ * and #ClutterActor:rotation-angle-z.
+ *
+ * The center of rotation is established by the #ClutterActor:pivot-point
+ * property.
+ *
+ * Since: 1.12
+ */
+void
+clutter_actor_set_rotation_angle (ClutterActor      *self,
+                                  ClutterRotateAxis  axis,
+                                  gdouble            angle)
+{
+  const ClutterTransformInfo *info;
+  const double *cur_angle_p = NULL;
+  GParamSpec *pspec = NULL;
 
-    case PROP_PIVOT_POINT:
-      {
-        const ClutterTransformInfo *info;
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_boxed (value, &info->pivot);
-      }
+  info = _clutter_actor_get_transform_info_or_defaults (self);
+
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      cur_angle_p = &info->rx_angle;
+      pspec = obj_props[PROP_ROTATION_ANGLE_X];
       break;
 
-    case PROP_PIVOT_POINT_Z:
-      {
-        const ClutterTransformInfo *info;
+    case CLUTTER_Y_AXIS:
+      cur_angle_p = &info->ry_angle;
+      pspec = obj_props[PROP_ROTATION_ANGLE_Y];
+      break;
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_float (value, info->pivot_z);
-      }
+    case CLUTTER_Z_AXIS:
+      cur_angle_p = &info->rz_angle;
+      pspec = obj_props[PROP_ROTATION_ANGLE_Z];
       break;
+    }
 
-    case PROP_TRANSLATION_X:
-      {
-        const ClutterTransformInfo *info;
+  g_assert (pspec != NULL);
+  g_assert (cur_angle_p != NULL);
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_float (value, info->translation.x);
-      }
-      break;
+  _clutter_actor_create_transition (self, pspec, *cur_angle_p, angle);
+}
 
-    case PROP_TRANSLATION_Y:
-      {
-        const ClutterTransformInfo *info;
+/**
+ * clutter_actor_get_rotation_angle:
+ * @self: a #ClutterActor
+ * @axis: the axis of the rotation
+ *
+ * Retrieves the angle of rotation set by clutter_actor_set_rotation_angle().
+ *
+ * Return value: the angle of rotation, in degrees
+ *
+ * Since: 1.12
+ */
+gdouble
+clutter_actor_get_rotation_angle (ClutterActor      *self,
+                                  ClutterRotateAxis  axis)
+{
+  const ClutterTransformInfo *info;
+  gdouble retval;
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_float (value, info->translation.y);
-      }
-      break;
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), 0.0);
 
-    case PROP_TRANSLATION_Z:
-      {
-        const ClutterTransformInfo *info;
+  info = _clutter_actor_get_transform_info_or_defaults (self);
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_float (value, info->translation.z);
-      }
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      retval = info->rx_angle;
       break;
 
-    case PROP_SCALE_X:
-      {
-        const ClutterTransformInfo *info;
+    case CLUTTER_Y_AXIS:
+      retval = info->ry_angle;
+      break;
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_double (value, info->scale_x);
-      }
+    case CLUTTER_Z_AXIS:
+      retval = info->rz_angle;
       break;
 
-    case PROP_SCALE_Y:
-      {
-        const ClutterTransformInfo *info;
-
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_double (value, info->scale_y);
-      }
-      break;
-
-    case PROP_SCALE_Z:
-      {
-        const ClutterTransformInfo *info;
-
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_double (value, info->scale_z);
-      }
+    default:
+      g_warn_if_reached ();
+      retval = 0.0;
       break;
+    }
 
-    case PROP_SCALE_CENTER_X: /* XXX:2.0 - remove */
-      {
-        gfloat center;
-
-        clutter_actor_get_scale_center (actor, &center, NULL);
+  return retval;
+}
 
-        g_value_set_float (value, center);
-      }
-      break;
+/*< private >
+ * clutter_actor_set_rotation_center_internal:
+ * @self: a #ClutterActor
+ * @axis: the axis of the center to change
+ * @center: the coordinates of the rotation center
+ *
+ * Sets the rotation center on the given axis without affecting the
+ * rotation angle.
+ */
+static inline void
+clutter_actor_set_rotation_center_internal (ClutterActor        *self,
+                                            ClutterRotateAxis    axis,
+                                            const ClutterVertex *center)
+{
+  ClutterVertex v = CLUTTER_VERTEX_INIT_ZERO; 
+  GObject *obj = G_OBJECT (self);
+  ClutterTransformInfo *info;
 
-    case PROP_SCALE_CENTER_Y: /* XXX:2.0 - remove */
-      {
-        gfloat center;
+  info = _clutter_actor_get_transform_info (self);
 
-        clutter_actor_get_scale_center (actor, NULL, &center);
+  if (center != NULL)
+    v = *center;
 
-        g_value_set_float (value, center);
-      }
-      break;
+  g_object_freeze_notify (obj);
 
-    case PROP_SCALE_GRAVITY: /* XXX:2.0 - remove */
-      g_value_set_enum (value, clutter_actor_get_scale_gravity (actor));
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      clutter_anchor_coord_set_units (&info->rx_center, v.x, v.y, v.z);
+      clutter_actor_notify (self, obj_props[PROP_ROTATION_CENTER_X]);
       break;
 
-    case PROP_REACTIVE:
-      g_value_set_boolean (value, clutter_actor_get_reactive (actor));
+    case CLUTTER_Y_AXIS:
+      clutter_anchor_coord_set_units (&info->ry_center, v.x, v.y, v.z);
+      clutter_actor_notify (self, obj_props[PROP_ROTATION_CENTER_Y]);
       break;
 
-    case PROP_ROTATION_ANGLE_X:
-      {
-        const ClutterTransformInfo *info;
+    case CLUTTER_Z_AXIS:
+      /* if the previously set rotation center was fractional, then
+       * setting explicit coordinates will have to notify the
+       * :rotation-center-z-gravity property as well
+       */
+      if (info->rz_center.is_fractional)
+        clutter_actor_notify (self, obj_props[PROP_ROTATION_CENTER_Z_GRAVITY]);
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_double (value, info->rx_angle);
-      }
+      clutter_anchor_coord_set_units (&info->rz_center, v.x, v.y, v.z);
+      clutter_actor_notify (self, obj_props[PROP_ROTATION_CENTER_Z]);
       break;
+    }
 
-    case PROP_ROTATION_ANGLE_Y:
-      {
-        const ClutterTransformInfo *info;
+  clutter_actor_invalidate_transform (self);
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_double (value, info->ry_angle);
-      }
-      break;
+  g_object_thaw_notify (obj);
 
-    case PROP_ROTATION_ANGLE_Z:
-      {
-        const ClutterTransformInfo *info;
+  clutter_actor_queue_redraw (self);
+}
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_double (value, info->rz_angle);
-      }
-      break;
+static void
+clutter_actor_set_scale_factor_internal (ClutterActor *self,
+                                         double factor,
+                                         GParamSpec *pspec)
+{
+  GObject *obj = G_OBJECT (self);
+  ClutterTransformInfo *info;
 
-    case PROP_ROTATION_CENTER_X: /* XXX:2.0 - remove */
-      {
-        ClutterVertex center;
+  info = _clutter_actor_get_transform_info (self);
 
-        clutter_actor_get_rotation (actor, CLUTTER_X_AXIS,
-                                    &center.x,
-                                    &center.y,
-                                    &center.z);
+  if (pspec == obj_props[PROP_SCALE_X])
+    info->scale_x = factor;
+  else if (pspec == obj_props[PROP_SCALE_Y])
+    info->scale_y = factor;
+  else if (pspec == obj_props[PROP_SCALE_Z])
+    info->scale_z = factor;
+  else
+    g_assert_not_reached ();
 
-        g_value_set_boxed (value, &center);
-      }
-      break;
+  clutter_actor_invalidate_transform (self);
+  clutter_actor_queue_redraw (self);
+  clutter_actor_notify (self, pspec);
+}
 
-    case PROP_ROTATION_CENTER_Y: /* XXX:2.0 - remove */
-      {
-        ClutterVertex center;
+static inline void
+clutter_actor_set_scale_factor (ClutterActor      *self,
+                                ClutterRotateAxis  axis,
+                                gdouble            factor)
+{
+  const ClutterTransformInfo *info;
+  const double *scale_p = NULL;
+  GParamSpec *pspec = NULL;
 
-        clutter_actor_get_rotation (actor, CLUTTER_Y_AXIS,
-                                    &center.x,
-                                    &center.y,
-                                    &center.z);
+  info = _clutter_actor_get_transform_info_or_defaults (self);
 
-        g_value_set_boxed (value, &center);
-      }
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      pspec = obj_props[PROP_SCALE_X];
+      scale_p = &info->scale_x;
       break;
 
-    case PROP_ROTATION_CENTER_Z: /* XXX:2.0 - remove */
-      {
-        ClutterVertex center;
-
-        clutter_actor_get_rotation (actor, CLUTTER_Z_AXIS,
-                                    &center.x,
-                                    &center.y,
-                                    &center.z);
-
-        g_value_set_boxed (value, &center);
-      }
+    case CLUTTER_Y_AXIS:
+      pspec = obj_props[PROP_SCALE_Y];
+      scale_p = &info->scale_y;
       break;
 
-    case PROP_ROTATION_CENTER_Z_GRAVITY: /* XXX:2.0 - remove */
-      g_value_set_enum (value, clutter_actor_get_z_rotation_gravity (actor));
+    case CLUTTER_Z_AXIS:
+      pspec = obj_props[PROP_SCALE_Z];
+      scale_p = &info->scale_z;
       break;
+    }
 
-    case PROP_ANCHOR_X: /* XXX:2.0 - remove */
-      {
-        const ClutterTransformInfo *info;
-        gfloat anchor_x;
-
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        clutter_anchor_coord_get_units (actor, &info->anchor,
-                                        &anchor_x,
-                                        NULL,
-                                        NULL);
-        g_value_set_float (value, anchor_x);
-      }
-      break;
+  g_assert (pspec != NULL);
+  g_assert (scale_p != NULL);
 
-    case PROP_ANCHOR_Y: /* XXX:2.0 - remove */
-      {
-        const ClutterTransformInfo *info;
-        gfloat anchor_y;
+  _clutter_actor_create_transition (self, pspec, *scale_p, factor);
+}
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        clutter_anchor_coord_get_units (actor, &info->anchor,
-                                        NULL,
-                                        &anchor_y,
-                                        NULL);
-        g_value_set_float (value, anchor_y);
-      }
-      break;
+static inline void
+clutter_actor_set_scale_center (ClutterActor      *self,
+                                ClutterRotateAxis  axis,
+                                gfloat             coord)
+{
+  GObject *obj = G_OBJECT (self);
+  ClutterTransformInfo *info;
+  gfloat center_x, center_y;
 
-    case PROP_ANCHOR_GRAVITY: /* XXX:2.0 - remove */
-      g_value_set_enum (value, clutter_actor_get_anchor_point_gravity (actor));
-      break;
+  info = _clutter_actor_get_transform_info (self);
 
-    case PROP_TRANSFORM:
-      {
-        ClutterMatrix m;
+  g_object_freeze_notify (obj);
 
-        clutter_actor_get_transform (actor, &m);
-        g_value_set_boxed (value, &m);
-      }
-      break;
+  /* get the current scale center coordinates */
+  clutter_anchor_coord_get_units (self, &info->scale_center,
+                                  &center_x,
+                                  &center_y,
+                                  NULL);
 
-    case PROP_TRANSFORM_SET:
-      {
-        const ClutterTransformInfo *info;
+  /* we need to notify this too, because setting explicit coordinates will
+   * change the gravity as a side effect
+   */
+  if (info->scale_center.is_fractional)
+    clutter_actor_notify (self, obj_props[PROP_SCALE_GRAVITY]);
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_boolean (value, info->transform_set);
-      }
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      clutter_anchor_coord_set_units (&info->scale_center, coord, center_y, 0);
+      clutter_actor_notify (self, obj_props[PROP_SCALE_CENTER_X]);
       break;
 
-    case PROP_CHILD_TRANSFORM:
-      {
-        ClutterMatrix m;
-
-        clutter_actor_get_child_transform (actor, &m);
-        g_value_set_boxed (value, &m);
-      }
+    case CLUTTER_Y_AXIS:
+      clutter_anchor_coord_set_units (&info->scale_center, center_x, coord, 0);
+      clutter_actor_notify (self, obj_props[PROP_SCALE_CENTER_Y]);
       break;
 
-    case PROP_CHILD_TRANSFORM_SET:
-      {
-        const ClutterTransformInfo *info;
+    default:
+      g_assert_not_reached ();
+    }
 
-        info = _clutter_actor_get_transform_info_or_defaults (actor);
-        g_value_set_boolean (value, info->child_transform_set);
-      }
-      break;
+  clutter_actor_invalidate_transform (self);
 
-    case PROP_SHOW_ON_SET_PARENT: /* XXX:2.0 - remove */
-      g_value_set_boolean (value, priv->show_on_set_parent);
+  clutter_actor_queue_redraw (self);
+
+  g_object_thaw_notify (obj);
+}
+
+static inline void
+clutter_actor_set_scale_gravity (ClutterActor   *self,
+                                 ClutterGravity  gravity)
+{
+  ClutterTransformInfo *info;
+  GObject *obj;
+
+  info = _clutter_actor_get_transform_info (self);
+  obj = G_OBJECT (self);
+
+  if (gravity == CLUTTER_GRAVITY_NONE)
+    clutter_anchor_coord_set_units (&info->scale_center, 0, 0, 0);
+  else
+    clutter_anchor_coord_set_gravity (&info->scale_center, gravity);
+
+  clutter_actor_invalidate_transform (self);
+
+  clutter_actor_notify (self, obj_props[PROP_SCALE_CENTER_X]);
+  clutter_actor_notify (self, obj_props[PROP_SCALE_CENTER_Y]);
+  clutter_actor_notify (self, obj_props[PROP_SCALE_GRAVITY]);
+
+  clutter_actor_queue_redraw (self);
+}
+
+/* XXX:2.0 - remove */
+static inline void
+clutter_actor_set_anchor_coord (ClutterActor      *self,
+                                ClutterRotateAxis  axis,
+                                gfloat             coord)
+{
+  GObject *obj = G_OBJECT (self);
+  ClutterTransformInfo *info;
+  gfloat anchor_x, anchor_y;
+
+  info = _clutter_actor_get_transform_info (self);
+
+  g_object_freeze_notify (obj);
+
+  clutter_anchor_coord_get_units (self, &info->anchor,
+                                  &anchor_x,
+                                  &anchor_y,
+                                  NULL);
+
+  if (info->anchor.is_fractional)
+    clutter_actor_notify (self, obj_props[PROP_ANCHOR_GRAVITY]);
+
+  switch (axis)
+    {
+    case CLUTTER_X_AXIS:
+      clutter_anchor_coord_set_units (&info->anchor,
+                                      coord,
+                                      anchor_y,
+                                      0.0);
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_X]);
       break;
 
-    case PROP_TEXT_DIRECTION:
-      g_value_set_enum (value, priv->text_direction);
+    case CLUTTER_Y_AXIS:
+      clutter_anchor_coord_set_units (&info->anchor,
+                                      anchor_x,
+                                      coord,
+                                      0.0);
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_Y]);
       break;
 
-    case PROP_HAS_POINTER:
-      g_value_set_boolean (value, priv->has_pointer);
+    default:
+      g_assert_not_reached ();
+    }
+
+  clutter_actor_invalidate_transform (self);
+
+  clutter_actor_queue_redraw (self);
+
+  g_object_thaw_notify (obj);
+}
+
+static void
+clutter_actor_set_clip_rect (ClutterActor      *self,
+                             const ClutterRect *clip)
+{
+  ClutterActorPrivate *priv = self->priv;
+  GObject *obj = G_OBJECT (self);
+
+  if (clip != NULL)
+    {
+      priv->clip = *clip;
+      priv->has_clip = TRUE;
+    }
+  else
+    priv->has_clip = FALSE;
+
+  clutter_actor_queue_redraw (self);
+
+  clutter_actor_notify (self, obj_props[PROP_CLIP]); /* XXX:2.0 - remove */
+  clutter_actor_notify (self, obj_props[PROP_CLIP_RECT]);
+  clutter_actor_notify (self, obj_props[PROP_HAS_CLIP]);
+}
+
+static void
+clutter_actor_set_property (GObject      *object,
+			    guint         prop_id,
+			    const GValue *value,
+			    GParamSpec   *pspec)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (object);
+  ClutterActorPrivate *priv = actor->priv;
+
+  switch (prop_id)
+    {
+    case PROP_X:
+      clutter_actor_set_x (actor, g_value_get_float (value));
       break;
 
-    case PROP_LAYOUT_MANAGER:
-      g_value_set_object (value, priv->layout_manager);
+    case PROP_Y:
+      clutter_actor_set_y (actor, g_value_get_float (value));
       break;
 
-    case PROP_X_EXPAND:
+    case PROP_POSITION:
       {
-        const ClutterLayoutInfo *info;
+        const ClutterPoint *pos = g_value_get_boxed (value);
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_boolean (value, info->x_expand);
+        if (pos != NULL)
+          clutter_actor_set_position (actor, pos->x, pos->y);
+        else
+          clutter_actor_set_fixed_position_set (actor, FALSE);
       }
       break;
 
-    case PROP_Y_EXPAND:
-      {
-        const ClutterLayoutInfo *info;
+    case PROP_WIDTH:
+      clutter_actor_set_width (actor, g_value_get_float (value));
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_boolean (value, info->y_expand);
-      }
+    case PROP_HEIGHT:
+      clutter_actor_set_height (actor, g_value_get_float (value));
       break;
 
-    case PROP_X_ALIGN:
+    case PROP_SIZE:
       {
-        const ClutterLayoutInfo *info;
+        const ClutterSize *size = g_value_get_boxed (value);
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_enum (value, info->x_align);
+        if (size != NULL)
+          clutter_actor_set_size (actor, size->width, size->height);
+        else
+          clutter_actor_set_size (actor, -1, -1);
       }
       break;
 
-    case PROP_Y_ALIGN:
-      {
-        const ClutterLayoutInfo *info;
+    case PROP_FIXED_X:
+      clutter_actor_set_x (actor, g_value_get_float (value));
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_enum (value, info->y_align);
-      }
+    case PROP_FIXED_Y:
+      clutter_actor_set_y (actor, g_value_get_float (value));
       break;
 
-    case PROP_MARGIN_TOP:
-      {
-        const ClutterLayoutInfo *info;
+    case PROP_FIXED_POSITION_SET:
+      clutter_actor_set_fixed_position_set (actor, g_value_get_boolean (value));
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->margin.top);
-      }
+    case PROP_MIN_WIDTH:
+      clutter_actor_set_min_width (actor, g_value_get_float (value));
       break;
 
-    case PROP_MARGIN_BOTTOM:
-      {
-        const ClutterLayoutInfo *info;
+    case PROP_MIN_HEIGHT:
+      clutter_actor_set_min_height (actor, g_value_get_float (value));
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->margin.bottom);
-      }
+    case PROP_NATURAL_WIDTH:
+      clutter_actor_set_natural_width (actor, g_value_get_float (value));
       break;
 
-    case PROP_MARGIN_LEFT:
-      {
-        const ClutterLayoutInfo *info;
+    case PROP_NATURAL_HEIGHT:
+      clutter_actor_set_natural_height (actor, g_value_get_float (value));
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->margin.left);
-      }
+    case PROP_MIN_WIDTH_SET:
+      clutter_actor_set_min_width_set (actor, g_value_get_boolean (value));
       break;
 
-    case PROP_MARGIN_RIGHT:
-      {
-        const ClutterLayoutInfo *info;
+    case PROP_MIN_HEIGHT_SET:
+      clutter_actor_set_min_height_set (actor, g_value_get_boolean (value));
+      break;
 
-        info = _clutter_actor_get_layout_info_or_defaults (actor);
-        g_value_set_float (value, info->margin.right);
-      }
+    case PROP_NATURAL_WIDTH_SET:
+      clutter_actor_set_natural_width_set (actor, g_value_get_boolean (value));
       break;
 
-    case PROP_BACKGROUND_COLOR_SET:
-      g_value_set_boolean (value, priv->bg_color_set);
+    case PROP_NATURAL_HEIGHT_SET:
+      clutter_actor_set_natural_height_set (actor, g_value_get_boolean (value));
       break;
 
-    case PROP_BACKGROUND_COLOR:
-      g_value_set_boxed (value, &priv->bg_color);
+    case PROP_REQUEST_MODE:
+      clutter_actor_set_request_mode (actor, g_value_get_enum (value));
       break;
 
-    case PROP_FIRST_CHILD:
-      g_value_set_object (value, priv->first_child);
+    case PROP_DEPTH: /* XXX:2.0 - remove */
+      clutter_actor_set_depth (actor, g_value_get_float (value));
       break;
 
-    case PROP_LAST_CHILD:
-      g_value_set_object (value, priv->last_child);
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position (actor, g_value_get_float (value));
       break;
 
-    case PROP_CONTENT:
-      g_value_set_object (value, priv->content);
+    case PROP_OPACITY:
+      clutter_actor_set_opacity (actor, g_value_get_uint (value));
       break;
 
-    case PROP_CONTENT_GRAVITY:
-      g_value_set_enum (value, priv->content_gravity);
+    case PROP_OFFSCREEN_REDIRECT:
+      clutter_actor_set_offscreen_redirect (actor, g_value_get_enum (value));
       break;
 
-    case PROP_CONTENT_BOX:
+    case PROP_NAME:
+      clutter_actor_set_name (actor, g_value_get_string (value));
+      break;
+
+    case PROP_VISIBLE:
+      if (g_value_get_boolean (value) == TRUE)
+	clutter_actor_show (actor);
+      else
+	clutter_actor_hide (actor);
+      break;
+
+    case PROP_PIVOT_POINT:
       {
-        ClutterActorBox box = { 0, };
+        const ClutterPoint *pivot = g_value_get_boxed (value);
 
-        clutter_actor_get_content_box (actor, &box);
-        g_value_set_boxed (value, &box);
+        if (pivot == NULL)
+          pivot = clutter_point_zero ();
+
+        clutter_actor_set_pivot_point (actor, pivot->x, pivot->y);
       }
       break;
 
-    case PROP_MINIFICATION_FILTER:
-      g_value_set_enum (value, priv->min_filter);
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z (actor, g_value_get_float (value));
       break;
 
-    case PROP_MAGNIFICATION_FILTER:
-      g_value_set_enum (value, priv->mag_filter);
+    case PROP_TRANSLATION_X:
+      clutter_actor_set_translation_factor (actor, CLUTTER_X_AXIS,
+                                            g_value_get_float (value));
       break;
 
-    case PROP_CONTENT_REPEAT:
-      g_value_set_flags (value, priv->content_repeat);
+    case PROP_TRANSLATION_Y:
+      clutter_actor_set_translation_factor (actor, CLUTTER_Y_AXIS,
+                                            g_value_get_float (value));
       break;
 
-    default:
-      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_factor (actor, CLUTTER_Z_AXIS,
+                                            g_value_get_float (value));
       break;
-    }
-}
 
-static void
-clutter_actor_dispose (GObject *object)
-{
-  ClutterActor *self = CLUTTER_ACTOR (object);
-  ClutterActorPrivate *priv = self->priv;
+    case PROP_SCALE_X:
+      clutter_actor_set_scale_factor (actor, CLUTTER_X_AXIS,
+                                      g_value_get_double (value));
+      break;
 
-  CLUTTER_NOTE (MISC, "Dispose actor (name='%s', ref_count:%d) of type '%s'",
-		_clutter_actor_get_debug_name (self),
-                object->ref_count,
-		g_type_name (G_OBJECT_TYPE (self)));
+    case PROP_SCALE_Y:
+      clutter_actor_set_scale_factor (actor, CLUTTER_Y_AXIS,
+                                      g_value_get_double (value));
+      break;
 
-  g_signal_emit (self, actor_signals[DESTROY], 0);
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor (actor, CLUTTER_Z_AXIS,
+                                      g_value_get_double (value));
+      break;
 
-  /* avoid recursing when called from clutter_actor_destroy() */
-  if (priv->parent != NULL)
-    {
-      ClutterActor *parent = priv->parent;
+    case PROP_SCALE_CENTER_X: /* XXX:2.0 - remove */
+      clutter_actor_set_scale_center (actor, CLUTTER_X_AXIS,
+                                      g_value_get_float (value));
+      break;
 
-      /* go through the Container implementation unless this
-       * is an internal child and has been marked as such.
-       *
-       * removing the actor from its parent will reset the
-       * realized and mapped states.
-       */
-      if (!CLUTTER_ACTOR_IS_INTERNAL_CHILD (self))
-        clutter_container_remove_actor (CLUTTER_CONTAINER (parent), self);
-      else
-        clutter_actor_remove_child_internal (parent, self,
-                                             REMOVE_CHILD_LEGACY_FLAGS);
-    }
+    case PROP_SCALE_CENTER_Y: /* XXX:2.0 - remove */
+      clutter_actor_set_scale_center (actor, CLUTTER_Y_AXIS,
+                                      g_value_get_float (value));
+      break;
 
-  /* parent must be gone at this point */
-  g_assert (priv->parent == NULL);
+    case PROP_SCALE_GRAVITY: /* XXX:2.0 - remove */
+      clutter_actor_set_scale_gravity (actor, g_value_get_enum (value));
+      break;
 
-  if (!CLUTTER_ACTOR_IS_TOPLEVEL (self))
-    {
-      /* can't be mapped or realized with no parent */
-      g_assert (!CLUTTER_ACTOR_IS_MAPPED (self));
-      g_assert (!CLUTTER_ACTOR_IS_REALIZED (self));
-    }
+    case PROP_CLIP: /* XXX:2.0 - remove */
+      {
+        const ClutterGeometry *geom = g_value_get_boxed (value);
 
-  g_clear_object (&priv->pango_context);
-  g_clear_object (&priv->actions);
-  g_clear_object (&priv->constraints);
-  g_clear_object (&priv->effects);
-  g_clear_object (&priv->flatten_effect);
+	clutter_actor_set_clip (actor,
+				geom->x, geom->y,
+				geom->width, geom->height);
+      }
+      break;
 
-  if (priv->child_model != NULL)
-    {
-      if (priv->create_child_notify != NULL)
-        priv->create_child_notify (priv->create_child_data);
+    case PROP_CLIP_RECT:
+      clutter_actor_set_clip_rect (actor, g_value_get_boxed (value));
+      break;
 
-      priv->create_child_func = NULL;
-      priv->create_child_data = NULL;
-      priv->create_child_notify = NULL;
+    case PROP_CLIP_TO_ALLOCATION:
+      clutter_actor_set_clip_to_allocation (actor, g_value_get_boolean (value));
+      break;
 
-      g_clear_object (&priv->child_model);
-    }
+    case PROP_REACTIVE:
+      clutter_actor_set_reactive (actor, g_value_get_boolean (value));
+      break;
 
-  if (priv->layout_manager != NULL)
-    {
-      clutter_layout_manager_set_container (priv->layout_manager, NULL);
-      g_clear_object (&priv->layout_manager);
-    }
+    case PROP_ROTATION_ANGLE_X:
+      clutter_actor_set_rotation_angle (actor,
+                                        CLUTTER_X_AXIS,
+                                        g_value_get_double (value));
+      break;
 
-  if (priv->content != NULL)
-    {
-      _clutter_content_detached (priv->content, self);
-      g_clear_object (&priv->content);
-    }
+    case PROP_ROTATION_ANGLE_Y:
+      clutter_actor_set_rotation_angle (actor,
+                                        CLUTTER_Y_AXIS,
+                                        g_value_get_double (value));
+      break;
 
-  if (priv->clones != NULL)
-    {
-      g_hash_table_unref (priv->clones);
-      priv->clones = NULL;
-    }
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle (actor,
+                                        CLUTTER_Z_AXIS,
+                                        g_value_get_double (value));
+      break;
 
-  G_OBJECT_CLASS (clutter_actor_parent_class)->dispose (object);
-}
+    case PROP_ROTATION_CENTER_X: /* XXX:2.0 - remove */
+      clutter_actor_set_rotation_center_internal (actor,
+                                                  CLUTTER_X_AXIS,
+                                                  g_value_get_boxed (value));
+      break;
 
-static void
-clutter_actor_finalize (GObject *object)
-{
-  ClutterActorPrivate *priv = CLUTTER_ACTOR (object)->priv;
+    case PROP_ROTATION_CENTER_Y: /* XXX:2.0 - remove */
+      clutter_actor_set_rotation_center_internal (actor,
+                                                  CLUTTER_Y_AXIS,
+                                                  g_value_get_boxed (value));
+      break;
 
-  CLUTTER_NOTE (MISC, "Finalize actor (name='%s') of type '%s'",
-                _clutter_actor_get_debug_name ((ClutterActor *) object),
-                g_type_name (G_OBJECT_TYPE (object)));
+    case PROP_ROTATION_CENTER_Z: /* XXX:2.0 - remove */
+      clutter_actor_set_rotation_center_internal (actor,
+                                                  CLUTTER_Z_AXIS,
+                                                  g_value_get_boxed (value));
+      break;
 
-  g_free (priv->name);
+    case PROP_ROTATION_CENTER_Z_GRAVITY: /* XXX:2.0 - remove */
+      {
+        const ClutterTransformInfo *info;
 
-#ifdef CLUTTER_ENABLE_DEBUG
-  g_free (priv->debug_name);
-#endif
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        clutter_actor_set_z_rotation_from_gravity (actor, info->rz_angle,
+                                                   g_value_get_enum (value));
+      }
+      break;
 
-  G_OBJECT_CLASS (clutter_actor_parent_class)->finalize (object);
-}
+    case PROP_ANCHOR_X: /* XXX:2.0 - remove */
+      clutter_actor_set_anchor_coord (actor, CLUTTER_X_AXIS,
+                                      g_value_get_float (value));
+      break;
 
+    case PROP_ANCHOR_Y: /* XXX:2.0 - remove */
+      clutter_actor_set_anchor_coord (actor, CLUTTER_Y_AXIS,
+                                      g_value_get_float (value));
+      break;
 
-/**
- * clutter_actor_get_accessible:
- * @self: a #ClutterActor
- *
- * Returns the accessible object that describes the actor to an
- * assistive technology.
- *
- * If no class-specific #AtkObject implementation is available for the
- * actor instance in question, it will inherit an #AtkObject
- * implementation from the first ancestor class for which such an
- * implementation is defined.
- *
- * The documentation of the <ulink
- * url="http://developer.gnome.org/doc/API/2.0/atk/index.html">ATK</ulink>
- * library contains more information about accessible objects and
- * their uses.
- *
- * Returns: (transfer none): the #AtkObject associated with @actor
- */
-AtkObject *
-clutter_actor_get_accessible (ClutterActor *self)
-{
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+    case PROP_ANCHOR_GRAVITY: /* XXX:2.0 - remove */
+      clutter_actor_set_anchor_point_from_gravity (actor,
+                                                   g_value_get_enum (value));
+      break;
 
-  return CLUTTER_ACTOR_GET_CLASS (self)->get_accessible (self);
-}
+    case PROP_TRANSFORM:
+      clutter_actor_set_transform (actor, g_value_get_boxed (value));
+      break;
 
-static AtkObject *
-clutter_actor_real_get_accessible (ClutterActor *actor)
-{
-  return atk_gobject_accessible_for_object (G_OBJECT (actor));
-}
+    case PROP_CHILD_TRANSFORM:
+      clutter_actor_set_child_transform (actor, g_value_get_boxed (value));
+      break;
 
-static AtkObject *
-_clutter_actor_ref_accessible (AtkImplementor *implementor)
-{
-  AtkObject *accessible;
+    case PROP_SHOW_ON_SET_PARENT: /* XXX:2.0 - remove */
+      priv->show_on_set_parent = g_value_get_boolean (value);
+      break;
 
-  accessible = clutter_actor_get_accessible (CLUTTER_ACTOR (implementor));
-  if (accessible != NULL)
-    g_object_ref (accessible);
+    case PROP_TEXT_DIRECTION:
+      clutter_actor_set_text_direction (actor, g_value_get_enum (value));
+      break;
 
-  return accessible;
-}
+    case PROP_ACTIONS:
+      clutter_actor_add_action (actor, g_value_get_object (value));
+      break;
 
-static void
-atk_implementor_iface_init (AtkImplementorIface *iface)
-{
-  iface->ref_accessible = _clutter_actor_ref_accessible;
-}
+    case PROP_CONSTRAINTS:
+      clutter_actor_add_constraint (actor, g_value_get_object (value));
+      break;
 
-static gboolean
-clutter_actor_update_default_paint_volume (ClutterActor       *self,
-                                           ClutterPaintVolume *volume)
-{
-  ClutterActorPrivate *priv = self->priv;
-  gboolean res = TRUE;
+    case PROP_EFFECT:
+      clutter_actor_add_effect (actor, g_value_get_object (value));
+      break;
 
-  /* this should be checked before we call this function, but it's a
-   * good idea to be explicit when it costs us nothing
-   */
-  if (priv->needs_allocation)
-    return FALSE;
+    case PROP_LAYOUT_MANAGER:
+      clutter_actor_set_layout_manager (actor, g_value_get_object (value));
+      break;
 
-  /* we start from the allocation */
-  clutter_paint_volume_set_width (volume,
-                                  priv->allocation.x2 - priv->allocation.x1);
-  clutter_paint_volume_set_height (volume,
-                                   priv->allocation.y2 - priv->allocation.y1);
+    case PROP_X_EXPAND:
+      clutter_actor_set_x_expand (actor, g_value_get_boolean (value));
+      break;
 
-  /* if the actor has a clip set then we have a pretty definite
-   * size for the paint volume: the actor cannot possibly paint
-   * outside the clip region.
-   */
-  if (priv->clip_to_allocation)
-    {
-      /* the allocation has already been set, so we just flip the
-       * return value
-       */
-      res = TRUE;
-    }
-  else
-    {
-      ClutterActor *child;
+    case PROP_Y_EXPAND:
+      clutter_actor_set_y_expand (actor, g_value_get_boolean (value));
+      break;
 
-      if (priv->has_clip &&
-          priv->clip.size.width >= 0 &&
-          priv->clip.size.height >= 0)
-        {
-          ClutterVertex origin;
+    case PROP_X_ALIGN:
+      clutter_actor_set_x_align (actor, g_value_get_enum (value));
+      break;
 
-          origin.x = priv->clip.origin.x;
-          origin.y = priv->clip.origin.y;
-          origin.z = 0;
+    case PROP_Y_ALIGN:
+      clutter_actor_set_y_align (actor, g_value_get_enum (value));
+      break;
 
-          clutter_paint_volume_set_origin (volume, &origin);
-          clutter_paint_volume_set_width (volume, priv->clip.size.width);
-          clutter_paint_volume_set_height (volume, priv->clip.size.height);
+    case PROP_MARGIN_TOP:
+      clutter_actor_set_margin_top (actor, g_value_get_float (value));
+      break;
 
-          res = TRUE;
-        }
+    case PROP_MARGIN_BOTTOM:
+      clutter_actor_set_margin_bottom (actor, g_value_get_float (value));
+      break;
 
-      /* if we don't have children we just bail out here... */
-      if (priv->n_children == 0)
-        return res;
+    case PROP_MARGIN_LEFT:
+      clutter_actor_set_margin_left (actor, g_value_get_float (value));
+      break;
 
-      /* ...but if we have children then we ask for their paint volume in
-       * our coordinates. if any of our children replies that it doesn't
-       * have a paint volume, we bail out
-       */
-      for (child = priv->first_child;
-           child != NULL;
-           child = child->priv->next_sibling)
-        {
-          const ClutterPaintVolume *child_volume;
+    case PROP_MARGIN_RIGHT:
+      clutter_actor_set_margin_right (actor, g_value_get_float (value));
+      break;
 
-          /* we ignore unmapped children, since they won't be painted.
-           *
-           * XXX: we also have to ignore mapped children without a valid
-           * allocation, because apparently some code above Clutter allows
-           * them.
-           */
-          if (!CLUTTER_ACTOR_IS_MAPPED (child) || !clutter_actor_has_allocation (child))
-            continue;
+    case PROP_BACKGROUND_COLOR:
+      clutter_actor_set_background_color (actor, g_value_get_boxed (value));
+      break;
 
-          child_volume = clutter_actor_get_transformed_paint_volume (child, self);
-          if (child_volume == NULL)
-            {
-              res = FALSE;
-              break;
-            }
+    case PROP_CONTENT:
+      clutter_actor_set_content (actor, g_value_get_object (value));
+      break;
 
-          clutter_paint_volume_union (volume, child_volume);
-          res = TRUE;
-        }
-    }
+    case PROP_CONTENT_GRAVITY:
+      clutter_actor_set_content_gravity (actor, g_value_get_enum (value));
+      break;
 
-  return res;
+    case PROP_MINIFICATION_FILTER:
+      clutter_actor_set_content_scaling_filters (actor,
+                                                 g_value_get_enum (value),
+                                                 clutter_actor_get_content_info_or_defaults (actor)->mag_filter);
+      break;
 
-}
+    case PROP_MAGNIFICATION_FILTER:
+      clutter_actor_set_content_scaling_filters (actor,
+                                                 clutter_actor_get_content_info_or_defaults (actor)->min_filter,
+                                                 g_value_get_enum (value));
+      break;
 
-static gboolean
-clutter_actor_real_get_paint_volume (ClutterActor       *self,
-                                     ClutterPaintVolume *volume)
-{
-  ClutterActorClass *klass;
-  gboolean res;
+    case PROP_CONTENT_REPEAT:
+      clutter_actor_set_content_repeat (actor, g_value_get_flags (value));
+      break;
 
-  klass = CLUTTER_ACTOR_GET_CLASS (self);
+    case PROP_TRACK_VISIBILITY:
+      clutter_actor_set_track_visibility (actor, g_value_get_boolean (value));
+      break;
 
-  /* XXX - this thoroughly sucks, but we don't want to penalize users
-   * who use ClutterActor as a "new ClutterGroup" by forcing a full-stage
-   * redraw. This should go away in 2.0.
-   */
-  if (klass->paint == clutter_actor_real_paint &&
-      klass->get_paint_volume == clutter_actor_real_get_paint_volume)
-    {
-      res = TRUE;
-    }
-  else
-    {
-      /* this is the default return value: we cannot know if a class
-       * is going to paint outside its allocation, so we take the
-       * conservative approach.
-       */
-      res = FALSE;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
     }
-
-  /* update_default_paint_volume() should only fail if one of the children
-   * reported an invalid, or no, paint volume
-   */
-  if (!clutter_actor_update_default_paint_volume (self, volume))
-    return FALSE;
-
-  return res;
 }
 
-/**
- * clutter_actor_get_default_paint_volume:
- * @self: a #ClutterActor
- *
- * Retrieves the default paint volume for @self.
- *
- * This function provides the same #ClutterPaintVolume that would be
- * computed by the default implementation inside #ClutterActor of the
- * #ClutterActorClass.get_paint_volume() virtual function.
- *
- * This function should only be used by #ClutterActor subclasses that
- * cannot chain up to the parent implementation when computing their
- * paint volume.
- *
- * Return value: (transfer none): a pointer to the default
- *   #ClutterPaintVolume, relative to the #ClutterActor, or %NULL if
- *   the actor could not compute a valid paint volume. The returned value
- *   is not guaranteed to be stable across multiple frames, so if you
- *   want to retain it, you will need to copy it using
- *   clutter_paint_volume_copy().
- *
- * Since: 1.10
- */
-const ClutterPaintVolume *
-clutter_actor_get_default_paint_volume (ClutterActor *self)
+static void
+clutter_actor_get_property (GObject    *object,
+			    guint       prop_id,
+			    GValue     *value,
+			    GParamSpec *pspec)
 {
-  ClutterPaintVolume volume;
-  ClutterPaintVolume *res;
-
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+  ClutterActor *actor = CLUTTER_ACTOR (object);
+  ClutterActorPrivate *priv = actor->priv;
 
-  res = NULL;
-  _clutter_paint_volume_init_static (&volume, self);
-  if (clutter_actor_update_default_paint_volume (self, &volume))
+  switch (prop_id)
     {
-      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
-
-      if (stage != NULL)
-        {
-          res = _clutter_stage_paint_volume_stack_allocate (CLUTTER_STAGE (stage));
-          _clutter_paint_volume_copy_static (&volume, res);
-        }
-    }
+    case PROP_X:
+      g_value_set_float (value, clutter_actor_get_x (actor));
+      break;
 
-  clutter_paint_volume_free (&volume);
+    case PROP_Y:
+      g_value_set_float (value, clutter_actor_get_y (actor));
+      break;
 
-  return res;
-}
+    case PROP_POSITION:
+      {
+        ClutterPoint position;
 
-static gboolean
-clutter_actor_real_has_overlaps (ClutterActor *self)
-{
-  /* By default we'll assume that all actors need an offscreen redirect to get
-   * the correct opacity. Actors such as ClutterTexture that would never need
-   * an offscreen redirect can override this to return FALSE. */
-  return TRUE;
-}
+        clutter_point_init (&position,
+                            clutter_actor_get_x (actor),
+                            clutter_actor_get_y (actor));
+        g_value_set_boxed (value, &position);
+      }
+      break;
 
-static void
-clutter_actor_real_destroy (ClutterActor *actor)
-{
-  ClutterActorIter iter;
+    case PROP_WIDTH:
+      g_value_set_float (value, clutter_actor_get_width (actor));
+      break;
 
-  g_object_freeze_notify (G_OBJECT (actor));
+    case PROP_HEIGHT:
+      g_value_set_float (value, clutter_actor_get_height (actor));
+      break;
 
-  clutter_actor_iter_init (&iter, actor);
-  while (clutter_actor_iter_next (&iter, NULL))
-    clutter_actor_iter_destroy (&iter);
+    case PROP_SIZE:
+      {
+        ClutterSize size;
 
-  g_object_thaw_notify (G_OBJECT (actor));
-}
+        clutter_size_init (&size,
+                           clutter_actor_get_width (actor),
+                           clutter_actor_get_height (actor));
+        g_value_set_boxed (value, &size);
+      }
+      break;
 
-static GObject *
-clutter_actor_constructor (GType gtype,
-                           guint n_props,
-                           GObjectConstructParam *props)
-{
-  GObjectClass *gobject_class;
-  ClutterActor *self;
-  GObject *retval;
+    case PROP_FIXED_X:
+      {
+        const ClutterLayoutInfo *info;
 
-  gobject_class = G_OBJECT_CLASS (clutter_actor_parent_class);
-  retval = gobject_class->constructor (gtype, n_props, props);
-  self = CLUTTER_ACTOR (retval);
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->fixed_pos.x);
+      }
+      break;
 
-  if (self->priv->layout_manager == NULL)
-    {
-      ClutterLayoutManager *default_layout;
+    case PROP_FIXED_Y:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->fixed_pos.y);
+      }
+      break;
+
+    case PROP_FIXED_POSITION_SET:
+      g_value_set_boolean (value, priv->position_set);
+      break;
+
+    case PROP_MIN_WIDTH:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->minimum.width);
+      }
+      break;
+
+    case PROP_MIN_HEIGHT:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->minimum.height);
+      }
+      break;
+
+    case PROP_NATURAL_WIDTH:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->natural.width);
+      }
+      break;
+
+    case PROP_NATURAL_HEIGHT:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->natural.height);
+      }
+      break;
+
+    case PROP_MIN_WIDTH_SET:
+      g_value_set_boolean (value, priv->min_width_set);
+      break;
+
+    case PROP_MIN_HEIGHT_SET:
+      g_value_set_boolean (value, priv->min_height_set);
+      break;
+
+    case PROP_NATURAL_WIDTH_SET:
+      g_value_set_boolean (value, priv->natural_width_set);
+      break;
+
+    case PROP_NATURAL_HEIGHT_SET:
+      g_value_set_boolean (value, priv->natural_height_set);
+      break;
+
+    case PROP_REQUEST_MODE:
+      g_value_set_enum (value, priv->request_mode);
+      break;
+
+    case PROP_ALLOCATION:
+      g_value_set_boxed (value, &priv->allocation);
+      break;
+
+    case PROP_DEPTH: /* XXX:2.0 - remove */
+      g_value_set_float (value, clutter_actor_get_depth (actor));
+      break;
+
+    case PROP_Z_POSITION:
+      g_value_set_float (value, clutter_actor_get_z_position (actor));
+      break;
+
+    case PROP_OPACITY:
+      g_value_set_uint (value, priv->opacity);
+      break;
+
+    case PROP_OFFSCREEN_REDIRECT:
+      g_value_set_flags (value, clutter_actor_get_offscreen_info_or_defaults (actor)->offscreen_redirect);
+      break;
+
+    case PROP_NAME:
+      g_value_set_string (value, priv->name);
+      break;
+
+    case PROP_VISIBLE:
+      g_value_set_boolean (value, CLUTTER_ACTOR_IS_VISIBLE (actor));
+      break;
+
+    case PROP_MAPPED:
+      g_value_set_boolean (value, CLUTTER_ACTOR_IS_MAPPED (actor));
+      break;
+
+    case PROP_REALIZED:
+      g_value_set_boolean (value, CLUTTER_ACTOR_IS_REALIZED (actor));
+      break;
+
+    case PROP_HAS_CLIP:
+      g_value_set_boolean (value, priv->has_clip);
+      break;
+
+    case PROP_CLIP: /* XXX:2.0 - remove */
+      {
+        ClutterGeometry clip;
+
+        clip.x      = CLUTTER_NEARBYINT (priv->clip.origin.x);
+        clip.y      = CLUTTER_NEARBYINT (priv->clip.origin.y);
+        clip.width  = CLUTTER_NEARBYINT (priv->clip.size.width);
+        clip.height = CLUTTER_NEARBYINT (priv->clip.size.height);
+
+        g_value_set_boxed (value, &clip);
+      }
+      break;
+
+    case PROP_CLIP_RECT:
+      g_value_set_boxed (value, &priv->clip);
+      break;
+
+    case PROP_CLIP_TO_ALLOCATION:
+      g_value_set_boolean (value, priv->clip_to_allocation);
+      break;
+
+    case PROP_PIVOT_POINT:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_boxed (value, &info->pivot);
+      }
+      break;
+
+    case PROP_PIVOT_POINT_Z:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_float (value, info->pivot_z);
+      }
+      break;
+
+    case PROP_TRANSLATION_X:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_float (value, info->translation.x);
+      }
+      break;
+
+    case PROP_TRANSLATION_Y:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_float (value, info->translation.y);
+      }
+      break;
+
+    case PROP_TRANSLATION_Z:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_float (value, info->translation.z);
+      }
+      break;
+
+    case PROP_SCALE_X:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_double (value, info->scale_x);
+      }
+      break;
+
+    case PROP_SCALE_Y:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_double (value, info->scale_y);
+      }
+      break;
+
+    case PROP_SCALE_Z:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_double (value, info->scale_z);
+      }
+      break;
+
+    case PROP_SCALE_CENTER_X: /* XXX:2.0 - remove */
+      {
+        gfloat center;
+
+        clutter_actor_get_scale_center (actor, &center, NULL);
+
+        g_value_set_float (value, center);
+      }
+      break;
+
+    case PROP_SCALE_CENTER_Y: /* XXX:2.0 - remove */
+      {
+        gfloat center;
+
+        clutter_actor_get_scale_center (actor, NULL, &center);
+
+        g_value_set_float (value, center);
+      }
+      break;
+
+    case PROP_SCALE_GRAVITY: /* XXX:2.0 - remove */
+      g_value_set_enum (value, clutter_actor_get_scale_gravity (actor));
+      break;
+
+    case PROP_REACTIVE:
+      g_value_set_boolean (value, clutter_actor_get_reactive (actor));
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_double (value, info->rx_angle);
+      }
+      break;
+
+    case PROP_ROTATION_ANGLE_Y:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_double (value, info->ry_angle);
+      }
+      break;
+
+    case PROP_ROTATION_ANGLE_Z:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_double (value, info->rz_angle);
+      }
+      break;
+
+    case PROP_ROTATION_CENTER_X: /* XXX:2.0 - remove */
+      {
+        ClutterVertex center;
+
+        clutter_actor_get_rotation (actor, CLUTTER_X_AXIS,
+                                    &center.x,
+                                    &center.y,
+                                    &center.z);
+
+        g_value_set_boxed (value, &center);
+      }
+      break;
+
+    case PROP_ROTATION_CENTER_Y: /* XXX:2.0 - remove */
+      {
+        ClutterVertex center;
+
+        clutter_actor_get_rotation (actor, CLUTTER_Y_AXIS,
+                                    &center.x,
+                                    &center.y,
+                                    &center.z);
+
+        g_value_set_boxed (value, &center);
+      }
+      break;
+
+    case PROP_ROTATION_CENTER_Z: /* XXX:2.0 - remove */
+      {
+        ClutterVertex center;
+
+        clutter_actor_get_rotation (actor, CLUTTER_Z_AXIS,
+                                    &center.x,
+                                    &center.y,
+                                    &center.z);
+
+        g_value_set_boxed (value, &center);
+      }
+      break;
+
+    case PROP_ROTATION_CENTER_Z_GRAVITY: /* XXX:2.0 - remove */
+      g_value_set_enum (value, clutter_actor_get_z_rotation_gravity (actor));
+      break;
+
+    case PROP_ANCHOR_X: /* XXX:2.0 - remove */
+      {
+        const ClutterTransformInfo *info;
+        gfloat anchor_x;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        clutter_anchor_coord_get_units (actor, &info->anchor,
+                                        &anchor_x,
+                                        NULL,
+                                        NULL);
+        g_value_set_float (value, anchor_x);
+      }
+      break;
+
+    case PROP_ANCHOR_Y: /* XXX:2.0 - remove */
+      {
+        const ClutterTransformInfo *info;
+        gfloat anchor_y;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        clutter_anchor_coord_get_units (actor, &info->anchor,
+                                        NULL,
+                                        &anchor_y,
+                                        NULL);
+        g_value_set_float (value, anchor_y);
+      }
+      break;
+
+    case PROP_ANCHOR_GRAVITY: /* XXX:2.0 - remove */
+      g_value_set_enum (value, clutter_actor_get_anchor_point_gravity (actor));
+      break;
+
+    case PROP_TRANSFORM:
+      {
+        ClutterMatrix m;
+
+        clutter_actor_get_transform (actor, &m);
+        g_value_set_boxed (value, &m);
+      }
+      break;
+
+    case PROP_TRANSFORM_SET:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_boolean (value, info->transform_set);
+      }
+      break;
+
+    case PROP_CHILD_TRANSFORM:
+      {
+        ClutterMatrix m;
+
+        clutter_actor_get_child_transform (actor, &m);
+        g_value_set_boxed (value, &m);
+      }
+      break;
+
+    case PROP_CHILD_TRANSFORM_SET:
+      {
+        const ClutterTransformInfo *info;
+
+        info = _clutter_actor_get_transform_info_or_defaults (actor);
+        g_value_set_boolean (value, info->child_transform_set);
+      }
+      break;
+
+    case PROP_SHOW_ON_SET_PARENT: /* XXX:2.0 - remove */
+      g_value_set_boolean (value, priv->show_on_set_parent);
+      break;
+
+    case PROP_TEXT_DIRECTION:
+      g_value_set_enum (value, priv->text_direction);
+      break;
+
+    case PROP_HAS_POINTER:
+      g_value_set_boolean (value, priv->has_pointer);
+      break;
+
+    case PROP_LAYOUT_MANAGER:
+      g_value_set_object (value, priv->layout_manager);
+      break;
+
+    case PROP_X_EXPAND:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_boolean (value, info->x_expand);
+      }
+      break;
+
+    case PROP_Y_EXPAND:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_boolean (value, info->y_expand);
+      }
+      break;
+
+    case PROP_X_ALIGN:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_enum (value, info->x_align);
+      }
+      break;
+
+    case PROP_Y_ALIGN:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_enum (value, info->y_align);
+      }
+      break;
+
+    case PROP_MARGIN_TOP:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->margin.top);
+      }
+      break;
+
+    case PROP_MARGIN_BOTTOM:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->margin.bottom);
+      }
+      break;
+
+    case PROP_MARGIN_LEFT:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->margin.left);
+      }
+      break;
+
+    case PROP_MARGIN_RIGHT:
+      {
+        const ClutterLayoutInfo *info;
+
+        info = _clutter_actor_get_layout_info_or_defaults (actor);
+        g_value_set_float (value, info->margin.right);
+      }
+      break;
+
+    case PROP_BACKGROUND_COLOR_SET:
+      g_value_set_boolean (value, priv->bg_color_set);
+      break;
+
+    case PROP_BACKGROUND_COLOR:
+      g_value_set_boxed (value, &priv->bg_color);
+      break;
+
+    case PROP_FIRST_CHILD:
+      g_value_set_object (value, priv->first_child);
+      break;
+
+    case PROP_LAST_CHILD:
+      g_value_set_object (value, priv->last_child);
+      break;
+
+    case PROP_CONTENT:
+      g_value_set_object (value, priv->content);
+      break;
+
+    case PROP_CONTENT_GRAVITY:
+      g_value_set_enum (value, clutter_actor_get_content_info_or_defaults (actor)->content_gravity);
+      break;
+
+    case PROP_CONTENT_BOX:
+      {
+        ClutterActorBox box = { 0, };
+
+        clutter_actor_get_content_box (actor, &box);
+        g_value_set_boxed (value, &box);
+      }
+      break;
+
+    case PROP_MINIFICATION_FILTER:
+      g_value_set_enum (value, clutter_actor_get_content_info_or_defaults (actor)->min_filter);
+      break;
+
+    case PROP_MAGNIFICATION_FILTER:
+      g_value_set_enum (value, clutter_actor_get_content_info_or_defaults (actor)->mag_filter);
+      break;
+
+    case PROP_CONTENT_REPEAT:
+      g_value_set_flags (value, clutter_actor_get_content_info_or_defaults (actor)->content_repeat);
+      break;
+
+    case PROP_TRACK_VISIBILITY:
+      g_value_set_boolean (value, priv->track_visibility);
+      break;
+
+    case PROP_ON_SCREEN:
+      g_value_set_boolean (value, priv->on_screen);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_actor_dispose (GObject *object)
+{
+  ClutterActor *self = CLUTTER_ACTOR (object);
+  ClutterActorPrivate *priv = self->priv;
+
+  CLUTTER_NOTE (MISC, "Dispose actor (name='%s', ref_count:%d) of type '%s'",
+		_clutter_actor_get_debug_name (self),
+                object->ref_count,
+		g_type_name (G_OBJECT_TYPE (self)));
+
+  g_signal_emit (self, actor_signals[DESTROY], 0);
+
+  /* avoid recursing when called from clutter_actor_destroy() */
+  if (priv->parent != NULL)
+    {
+      ClutterActor *parent = priv->parent;
+
+      /* go through the Container implementation unless this
+       * is an internal child and has been marked as such.
+       *
+       * removing the actor from its parent will reset the
+       * realized and mapped states.
+       */
+      if (!CLUTTER_ACTOR_IS_INTERNAL_CHILD (self))
+        clutter_container_remove_actor (CLUTTER_CONTAINER (parent), self);
+      else
+        clutter_actor_remove_child_internal (parent, self,
+                                             REMOVE_CHILD_LEGACY_FLAGS);
+    }
+
+  /* parent must be gone at this point */
+  g_assert (priv->parent == NULL);
+
+  if (!CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    {
+      /* can't be mapped or realized with no parent */
+      g_assert (!CLUTTER_ACTOR_IS_MAPPED (self));
+      g_assert (!CLUTTER_ACTOR_IS_REALIZED (self));
+    }
+
+  g_clear_object (&priv->pango_context);
+  g_clear_object (&priv->actions);
+  g_clear_object (&priv->constraints);
+  g_clear_object (&priv->effects);
+  if (priv->offscreen_info != NULL)
+    g_clear_object (&priv->offscreen_info->flatten_effect);
+
+  if (priv->constraint_info != NULL &&
+      priv->constraint_info->dependents != NULL)
+    {
+      GPtrArray *dependents = priv->constraint_info->dependents;
+
+      /* unsetting the source removes the constraint from the array */
+      while (dependents->len > 0)
+        {
+          guint last = dependents->len - 1;
+
+          _clutter_constraint_set_source (g_ptr_array_index (dependents, last),
+                                          NULL);
+        }
+
+      g_clear_pointer (&priv->constraint_info->dependents, g_ptr_array_unref);
+    }
+
+  if (priv->child_model != NULL)
+    {
+      if (priv->create_child_notify != NULL)
+        priv->create_child_notify (priv->create_child_data);
+
+      priv->create_child_func = NULL;
+      priv->create_child_data = NULL;
+      priv->create_child_notify = NULL;
+
+      g_clear_object (&priv->child_model);
+    }
+
+  if (priv->layout_manager != NULL)
+    {
+      clutter_layout_manager_set_container (priv->layout_manager, NULL);
+      g_clear_object (&priv->layout_manager);
+    }
+
+  clutter_actor_release_paint_node (self);
+
+  if (priv->content != NULL)
+    {
+      _clutter_content_detached (priv->content, self);
+      g_clear_object (&priv->content);
+    }
+
+  if (priv->clones != NULL)
+    {
+      g_hash_table_unref (priv->clones);
+      priv->clones = NULL;
+    }
+
+  /* destroyed before its turn came; the caller of run_dispose() holds
+   * a reference, so dropping the one of the queue is safe
+   */
+  if (priv->destroy_deferred)
+    clutter_actor_cancel_deferred_destroy (self);
+
+  G_OBJECT_CLASS (clutter_actor_parent_class)->dispose (object);
+}
+
+static void
+clutter_actor_finalize (GObject *object)
+{
+  ClutterActorPrivate *priv = CLUTTER_ACTOR (object)->priv;
+
+  CLUTTER_NOTE (MISC, "Finalize actor (name='%s') of type '%s'",
+                _clutter_actor_get_debug_name ((ClutterActor *) object),
+                g_type_name (G_OBJECT_TYPE (object)));
+
+  g_free (priv->name);
+
+  _clutter_spatial_index_free (priv->child_index);
+
+  if (priv->z_sorted_children != NULL)
+    g_sequence_free (priv->z_sorted_children);
+
+  size_request_cache_free (priv->width_requests);
+  size_request_cache_free (priv->height_requests);
+
+  if (priv->transform_info != NULL)
+    g_slice_free (ClutterTransformInfo, priv->transform_info);
+
+  if (priv->layout_info != NULL)
+    g_slice_free (ClutterLayoutInfo, priv->layout_info);
+
+  if (priv->content_info != NULL)
+    g_slice_free (ContentInfo, priv->content_info);
+
+  if (priv->offscreen_info != NULL)
+    g_slice_free (OffscreenInfo, priv->offscreen_info);
+
+  if (priv->constraint_info != NULL)
+    g_slice_free (ConstraintInfo, priv->constraint_info);
+
+  g_clear_object (&priv->layout_meta);
+
+  if (priv->animation_info != NULL)
+    clutter_animation_info_free (priv->animation_info);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  g_free (priv->debug_name);
+#endif
+
+  G_OBJECT_CLASS (clutter_actor_parent_class)->finalize (object);
+}
+
+
+/**
+ * clutter_actor_get_accessible:
+ * @self: a #ClutterActor
+ *
+ * Returns the accessible object that describes the actor to an
+ * assistive technology.
+ *
+ * If no class-specific #AtkObject implementation is available for the
+ * actor instance in question, it will inherit an #AtkObject
+ * implementation from the first ancestor class for which such an
+ * implementation is defined.
+ *
+ * The documentation of the <ulink
+ * url="http://developer.gnome.org/doc/API/2.0/atk/index.html">ATK</ulink>
+ * library contains more information about accessible objects and
+ * their uses.
+ *
+ * Returns: (transfer none): the #AtkObject associated with @actor
+ */
+AtkObject *
+clutter_actor_get_accessible (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+
+  return CLUTTER_ACTOR_GET_CLASS (self)->get_accessible (self);
+}
+
+static AtkObject *
+clutter_actor_real_get_accessible (ClutterActor *actor)
+{
+  return atk_gobject_accessible_for_object (G_OBJECT (actor));
+}
+
+static AtkObject *
+_clutter_actor_ref_accessible (AtkImplementor *implementor)
+{
+  AtkObject *accessible;
+
+  accessible = clutter_actor_get_accessible (CLUTTER_ACTOR (implementor));
+  if (accessible != NULL)
+    g_object_ref (accessible);
+
+  return accessible;
+}
+
+static void
+atk_implementor_iface_init (AtkImplementorIface *iface)
+{
+  iface->ref_accessible = _clutter_actor_ref_accessible;
+}
+
+static gboolean
+clutter_actor_update_default_paint_volume (ClutterActor       *self,
+                                           ClutterPaintVolume *volume)
+{
+  ClutterActorPrivate *priv = self->priv;
+  gboolean res = TRUE;
+
+  /* this should be checked before we call this function, but it's a
+   * good idea to be explicit when it costs us nothing
+   */
+  if (priv->needs_allocation)
+    return FALSE;
+
+  /* we start from the allocation */
+  clutter_paint_volume_set_width (volume,
+                                  priv->allocation.x2 - priv->allocation.x1);
+  clutter_paint_volume_set_height (volume,
+                                   priv->allocation.y2 - priv->allocation.y1);
+
+  /* if the actor has a clip set then we have a pretty definite
+   * size for the paint volume: the actor cannot possibly paint
+   * outside the clip region.
+   */
+  if (priv->clip_to_allocation)
+    {
+      /* the allocation has already been set, so we just flip the
+       * return value
+       */
+      res = TRUE;
+    }
+  else
+    {
+      ClutterActor *child;
+
+      if (priv->has_clip &&
+          priv->clip.size.width >= 0 &&
+          priv->clip.size.height >= 0)
+        {
+          ClutterVertex origin;
+
+          origin.x = priv->clip.origin.x;
+          origin.y = priv->clip.origin.y;
+          origin.z = 0;
+
+          clutter_paint_volume_set_origin (volume, &origin);
+          clutter_paint_volume_set_width (volume, priv->clip.size.width);
+          clutter_paint_volume_set_height (volume, priv->clip.size.height);
+
+          res = TRUE;
+        }
+
+      /* if we don't have children we just bail out here... */
+      if (priv->n_children == 0)
+        return res;
+
+      /* ...but if we have children then we ask for their paint volume in
+       * our coordinates. if any of our children replies that it doesn't
+       * have a paint volume, we bail out
+       */
+      for (child = priv->first_child;
+           child != NULL;
+           child = child->priv->next_sibling)
+        {
+          const ClutterPaintVolume *child_volume;
+
+          /* we ignore unmapped children, since they won't be painted.
+           *
+           * XXX: we also have to ignore mapped children without a valid
+           * allocation, because apparently some code above Clutter allows
+           * them.
+           */
+          if (!CLUTTER_ACTOR_IS_MAPPED (child) || !clutter_actor_has_allocation (child))
+            continue;
+
+          child_volume = clutter_actor_get_transformed_paint_volume (child, self);
+          if (child_volume == NULL)
+            {
+              res = FALSE;
+              break;
+            }
+
+          clutter_paint_volume_union (volume, child_volume);
+          res = TRUE;
+        }
+    }
+
+  return res;
+
+}
+
+static gboolean
+clutter_actor_real_get_paint_volume (ClutterActor       *self,
+                                     ClutterPaintVolume *volume)
+{
+  ClutterActorClass *klass;
+  gboolean res;
+
+  klass = CLUTTER_ACTOR_GET_CLASS (self);
+
+  /* XXX - this thoroughly sucks, but we don't want to penalize users
+   * who use ClutterActor as a "new ClutterGroup" by forcing a full-stage
+   * redraw. This should go away in 2.0.
+   */
+  if (klass->paint == clutter_actor_real_paint &&
+      klass->get_paint_volume == clutter_actor_real_get_paint_volume)
+    {
+      res = TRUE;
+    }
+  else
+    {
+      /* this is the default return value: we cannot know if a class
+       * is going to paint outside its allocation, so we take the
+       * conservative approach.
+       */
+      res = FALSE;
+    }
+
+  /* update_default_paint_volume() should only fail if one of the children
+   * reported an invalid, or no, paint volume
+   */
+  if (!clutter_actor_update_default_paint_volume (self, volume))
+    return FALSE;
+
+  return res;
+}
+
+/**
+ * clutter_actor_get_default_paint_volume:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the default paint volume for @self.
+ *
+ * This function provides the same #ClutterPaintVolume that would be
+ * computed by the default implementation inside #ClutterActor of the
+ * #ClutterActorClass.get_paint_volume() virtual function.
+ *
+ * This function should only be used by #ClutterActor subclasses that
+ * cannot chain up to the parent implementation when computing their
+ * paint volume.
+ *
+ * Return value: (transfer none): a pointer to the default
+ *   #ClutterPaintVolume, relative to the #ClutterActor, or %NULL if
+ *   the actor could not compute a valid paint volume. The returned value
+ *   is not guaranteed to be stable across multiple frames, so if you
+ *   want to retain it, you will need to copy it using
+ *   clutter_paint_volume_copy().
+ *
+ * Since: 1.10
+ */
+const ClutterPaintVolume *
+clutter_actor_get_default_paint_volume (ClutterActor *self)
+{
+  ClutterPaintVolume volume;
+  ClutterPaintVolume *res;
+
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+
+  res = NULL;
+  _clutter_paint_volume_init_static (&volume, self);
+  if (clutter_actor_update_default_paint_volume (self, &volume))
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+      if (stage != NULL)
+        {
+          res = _clutter_stage_paint_volume_stack_allocate (CLUTTER_STAGE (stage));
+          _clutter_paint_volume_copy_static (&volume, res);
+        }
+    }
+
+  clutter_paint_volume_free (&volume);
+
+  return res;
+}
+
+static gboolean
+clutter_actor_real_has_overlaps (ClutterActor *self)
+{
+  /* By default we'll assume that all actors need an offscreen redirect to get
+   * the correct opacity. Actors such as ClutterTexture that would never need
+   * an offscreen redirect can override this to return FALSE. */
+  return TRUE;
+}
+
+static void
+clutter_actor_real_destroy (ClutterActor *actor)
+{
+  ClutterActorIter iter;
+
+  g_object_freeze_notify (G_OBJECT (actor));
+
+  clutter_actor_iter_init (&iter, actor);
+  while (clutter_actor_iter_next (&iter, NULL))
+    clutter_actor_iter_destroy (&iter);
+
+  g_object_thaw_notify (G_OBJECT (actor));
+}
+
+static GObject *
+clutter_actor_constructor (GType gtype,
+                           guint n_props,
+                           GObjectConstructParam *props)
+{
+  GObjectClass *gobject_class;
+  ClutterActor *self;
+  GObject *retval;
+
+  gobject_class = G_OBJECT_CLASS (clutter_actor_parent_class);
+  retval = gobject_class->constructor (gtype, n_props, props);
+  self = CLUTTER_ACTOR (retval);
+
+  if (self->priv->layout_manager == NULL)
+    {
+      ClutterLayoutManager *default_layout;
 
       CLUTTER_NOTE (LAYOUT, "Creating default layout manager");
 
@@ -6262,9 +8500,10 @@ clutter_actor_class_init (ClutterActorClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   quark_shader_data = g_quark_from_static_string ("-clutter-actor-shader-data");
-  quark_actor_layout_info = g_quark_from_static_string ("-clutter-actor-layout-info");
-  quark_actor_transform_info = g_quark_from_static_string ("-clutter-actor-transform-info");
-  quark_actor_animation_info = g_quark_from_static_string ("-clutter-actor-animation-info");
+
+  notify_signal_id = g_signal_lookup ("notify", G_TYPE_OBJECT);
+  default_dispatch_properties_changed =
+    G_OBJECT_CLASS (clutter_actor_parent_class)->dispatch_properties_changed;
 
   object_class->constructor = clutter_actor_constructor;
   object_class->set_property = clutter_actor_set_property;
@@ -7846,6 +10085,36 @@ clutter_actor_class_init (ClutterActorClass *klass)
                         G_PARAM_READWRITE |
                         G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterActor:track-visibility:
+   *
+   * Whether the stage keeps the #ClutterActor:on-screen property of
+   * the actor up to date.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_TRACK_VISIBILITY] =
+    g_param_spec_boolean ("track-visibility",
+                          P_("Track Visibility"),
+                          P_("Whether the on-screen property is updated"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
+  /**
+   * ClutterActor:on-screen:
+   *
+   * Whether any part of the actor was visible in the last frame of
+   * its stage; see clutter_actor_set_track_visibility().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ON_SCREEN] =
+    g_param_spec_boolean ("on-screen",
+                          P_("On Screen"),
+                          P_("Whether the actor was visible in the last frame"),
+                          FALSE,
+                          CLUTTER_PARAM_READABLE);
+
   g_object_class_install_properties (object_class, PROP_LAST, obj_props);
 
   /**
@@ -8496,9 +10765,6 @@ clutter_actor_init (ClutterActor *self)
   priv->needs_height_request = TRUE;
   priv->needs_allocation = TRUE;
 
-  priv->cached_width_age = 1;
-  priv->cached_height_age = 1;
-
   priv->opacity_override = -1;
   priv->enable_model_view_transform = TRUE;
 
@@ -8508,13 +10774,12 @@ clutter_actor_init (ClutterActor *self)
 
   priv->transform_valid = FALSE;
 
+  priv->child_index_leaf = -1;
+
   /* the default is to stretch the content, to match the
    * current behaviour of basically all actors. also, it's
    * the easiest thing to compute.
    */
-  priv->content_gravity = CLUTTER_CONTENT_GRAVITY_RESIZE_FILL;
-  priv->min_filter = CLUTTER_SCALING_FILTER_LINEAR;
-  priv->mag_filter = CLUTTER_SCALING_FILTER_LINEAR;
 
   /* this flag will be set to TRUE if the actor gets a child
    * or if the [xy]-expand flags are explicitly set; until
@@ -8772,6 +11037,11 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* anything changing the way the actor is painted can change its
+   * paint volume as well
+   */
+  clutter_actor_invalidate_paint_volume (self);
+
   /* we can ignore unmapped actors, unless they have at least one
    * mapped clone or they are inside a cloned branch of the scene
    * graph, as unmapped actors will simply be left unpainted.
@@ -8794,17 +11064,38 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
       return;
     }
 
-  /* given the check above we could end up queueing a redraw on an
-   * unmapped actor with mapped clones, so we cannot assume that
-   * get_stage() will return a Stage
+  /* an actor with a pending entry was already found on a stage during
+   * this frame, and the entries are invalidated when the actor leaves
+   * it; so further redraws only need to be merged into the entry, and
+   * an entry for the whole actor absorbs them entirely. The damage is
+   * transformed into stage coordinates once per actor, when the entry
+   * is processed.
    */
-  stage = _clutter_actor_get_stage_internal (self);
-  if (stage == NULL)
-    return;
+  if (priv->queue_redraw_entry != NULL)
+    {
+      if (!_clutter_stage_queue_redraw_entry_has_clip (priv->queue_redraw_entry))
+        {
+          _clutter_stage_queue_redraw_entry_add_clip (priv->queue_redraw_entry,
+                                                      NULL);
+          goto out;
+        }
 
-  /* ignore queueing a redraw on stages that are being destroyed */
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
-    return;
+      stage = NULL;
+    }
+  else
+    {
+      /* given the check above we could end up queueing a redraw on an
+       * unmapped actor with mapped clones, so we cannot assume that
+       * get_stage() will return a Stage
+       */
+      stage = _clutter_actor_get_stage_internal (self);
+      if (stage == NULL)
+        return;
+
+      /* ignore queueing a redraw on stages that are being destroyed */
+      if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+        return;
+    }
 
   if (flags & CLUTTER_REDRAW_CLIPPED_TO_ALLOCATION)
     {
@@ -8844,15 +11135,19 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
       should_free_pv = FALSE;
     }
 
-  self->priv->queue_redraw_entry =
-    _clutter_stage_queue_actor_redraw (CLUTTER_STAGE (stage),
-                                       priv->queue_redraw_entry,
-                                       self,
-                                       pv);
+  if (priv->queue_redraw_entry != NULL)
+    _clutter_stage_queue_redraw_entry_add_clip (priv->queue_redraw_entry, pv);
+  else
+    priv->queue_redraw_entry =
+      _clutter_stage_queue_actor_redraw (CLUTTER_STAGE (stage),
+                                         NULL,
+                                         self,
+                                         pv);
 
   if (should_free_pv)
     clutter_paint_volume_free (pv);
 
+out:
   /* If this is the first redraw queued then we can directly use the
      effect parameter */
   if (!priv->is_dirty)
@@ -9066,6 +11361,80 @@ clutter_actor_queue_relayout (ClutterActor *self)
   clutter_actor_queue_redraw (self);
 }
 
+/**
+ * clutter_actor_set_relayout_boundary:
+ * @self: a #ClutterActor
+ * @boundary: whether @self is a relayout boundary
+ *
+ * Sets whether @self is a relayout boundary.
+ *
+ * When a child of a relayout boundary queues a relayout, only the
+ * boundary and its children are allocated again, using the current
+ * allocation of the boundary, instead of laying out the whole stage.
+ *
+ * This is only correct if the preferred size of @self does not depend
+ * on its children, for instance because the layout manager or the
+ * #ClutterActorClass.get_preferred_width() and
+ * #ClutterActorClass.get_preferred_height() implementations ignore them.
+ * Actors with a fixed size, set using clutter_actor_set_size() or
+ * the #ClutterActor:min-width, #ClutterActor:natural-width,
+ * #ClutterActor:min-height and #ClutterActor:natural-height properties,
+ * are always relayout boundaries.
+ *
+ * Changes to the properties of @self itself, like its size, are still
+ * propagated to its parent.
+ *
+ * Since: 1.26
+ */
+void
+clutter_actor_set_relayout_boundary (ClutterActor *self,
+                                     gboolean      boundary)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  self->priv->relayout_boundary = !!boundary;
+}
+
+/**
+ * clutter_actor_get_relayout_boundary:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the value set using clutter_actor_set_relayout_boundary().
+ *
+ * Return value: %TRUE if @self is explicitly a relayout boundary
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_actor_get_relayout_boundary (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  return self->priv->relayout_boundary;
+}
+
+/**
+ * clutter_actor_get_layout_stats:
+ * @stats: (out caller-allocates): return location for the counts
+ *
+ * Retrieves the layout work done by all the actors since the start of
+ * the process: the size requests computed by the actors, the size
+ * requests served by the cache, the allocations and the relayouts.
+ *
+ * The counts only grow; the work done by an operation is the difference
+ * between the counts retrieved before and after it. The counts of each
+ * frame of a stage are also available in #ClutterFrameInfo.
+ *
+ * Since: 1.26
+ */
+void
+clutter_actor_get_layout_stats (ClutterLayoutStats *stats)
+{
+  g_return_if_fail (stats != NULL);
+
+  *stats = layout_stats;
+}
+
 /**
  * clutter_actor_get_preferred_size:
  * @self: a #ClutterActor
@@ -9362,36 +11731,69 @@ clutter_actor_adjust_height (ClutterActor *self,
 }
 
 /* looks for a cached size request for this for_size. If not
- * found, returns the oldest entry so it can be overwritten */
+ * found, returns the least recently used entry so it can be
+ * overwritten, growing the cache first if that entry is still
+ * valid */
 static gboolean
-_clutter_actor_get_cached_size_request (gfloat         for_size,
-                                        SizeRequest   *cached_size_requests,
-                                        SizeRequest  **result)
+_clutter_actor_get_cached_size_request (ClutterActor      *self,
+                                        gfloat             for_size,
+                                        SizeRequestCache  *cache,
+                                        SizeRequest      **result)
 {
+  SizeRequest *oldest;
   guint i;
 
-  *result = &cached_size_requests[0];
+  oldest = &cache->requests[0];
 
-  for (i = 0; i < N_CACHED_SIZE_REQUESTS; i++)
+  for (i = 0; i < cache->n_requests; i++)
     {
       SizeRequest *sr;
 
-      sr = &cached_size_requests[i];
+      sr = &cache->requests[i];
 
       if (sr->age > 0 &&
           sr->for_size == for_size)
         {
-          CLUTTER_NOTE (LAYOUT, "Size cache hit for size: %.2f", for_size);
+#ifdef CLUTTER_ENABLE_DEBUG
+          cache->n_hits += 1;
+#endif
+          CLUTTER_NOTE (LAYOUT, "Size cache hit for size: %.2f "
+                        "(actor: '%s', hits: %u, misses: %u)",
+                        for_size,
+                        _clutter_actor_get_debug_name (self),
+                        cache->n_hits,
+                        cache->n_misses);
+
+          /* keep the entry around for longer */
+          sr->age = cache->age++;
+
           *result = sr;
           return TRUE;
         }
-      else if (sr->age < (*result)->age)
+      else if (sr->age < oldest->age)
         {
-          *result = sr;
+          oldest = sr;
         }
     }
 
-  CLUTTER_NOTE (LAYOUT, "Size cache miss for size: %.2f", for_size);
+#ifdef CLUTTER_ENABLE_DEBUG
+  cache->n_misses += 1;
+#endif
+  CLUTTER_NOTE (LAYOUT, "Size cache miss for size: %.2f "
+                "(actor: '%s', hits: %u, misses: %u)",
+                for_size,
+                _clutter_actor_get_debug_name (self),
+                cache->n_hits,
+                cache->n_misses);
+
+  /* the cache is cleared every time the actor queues a relayout, so
+   * evicting a valid entry means that the actor has been asked for more
+   * sizes than we can hold during the same layout cycle
+   */
+  if (oldest->age > 0 && cache->n_requests < N_CACHED_SIZE_REQUESTS_MAX)
+    oldest = size_request_cache_grow (cache);
+
+  *result = oldest;
 
   return FALSE;
 }
@@ -9415,25 +11817,212 @@ clutter_actor_update_preferred_size_for_constraints (ClutterActor *self,
       ClutterConstraint *constraint = l->data;
       ClutterActorMeta *meta = l->data;
 
-      if (!clutter_actor_meta_get_enabled (meta))
-        continue;
+      if (!clutter_actor_meta_get_enabled (meta))
+        continue;
+
+      clutter_constraint_update_preferred_size (constraint, self,
+                                                direction,
+                                                for_size,
+                                                minimum_size,
+                                                natural_size);
+
+      CLUTTER_NOTE (LAYOUT,
+                    "Preferred %s of '%s' after constraint '%s': "
+                    "{ min:%.2f, nat:%.2f }",
+                    direction == CLUTTER_ORIENTATION_HORIZONTAL
+                      ? "width"
+                      : "height",
+                    _clutter_actor_get_debug_name (self),
+                    _clutter_actor_meta_get_debug_name (meta),
+                    *minimum_size, *natural_size);
+    }
+}
+
+/* applies the constraints and the margins to the @minimum_size and
+ * @natural_size returned by the class for @for_size, and stores them
+ * in @sr using @request_for_size, the size before the margins, as key
+ */
+static void
+clutter_actor_store_size_request (ClutterActor       *self,
+                                  ClutterOrientation  orientation,
+                                  SizeRequest        *sr,
+                                  gfloat              request_for_size,
+                                  gfloat              for_size,
+                                  gfloat              minimum_size,
+                                  gfloat              natural_size)
+{
+  ClutterActorPrivate *priv = self->priv;
+  const ClutterLayoutInfo *info;
+  gfloat margin;
+
+  info = _clutter_actor_get_layout_info_or_defaults (self);
+
+  /* adjust for constraints */
+  clutter_actor_update_preferred_size_for_constraints (self,
+                                                       orientation,
+                                                       for_size,
+                                                       &minimum_size,
+                                                       &natural_size);
+
+  /* adjust for the margin */
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    margin = info->margin.left + info->margin.right;
+  else
+    margin = info->margin.top + info->margin.bottom;
+
+  minimum_size += margin;
+  natural_size += margin;
+
+  /* Due to accumulated float errors, it's better not to warn
+   * on this, but just fix it.
+   */
+  if (natural_size < minimum_size)
+    natural_size = minimum_size;
+
+  sr->min_size = minimum_size;
+  sr->natural_size = natural_size;
+  /* the cache is looked up using the size before the margin */
+  sr->for_size = request_for_size;
+
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      sr->age = priv->width_requests->age++;
+      priv->needs_width_request = FALSE;
+    }
+  else
+    {
+      sr->age = priv->height_requests->age++;
+      priv->needs_height_request = FALSE;
+    }
+}
+
+/* removes the margins in the direction opposite to @orientation from
+ * the @for_size of a request
+ */
+static inline gfloat
+clutter_actor_remove_request_margin (const ClutterLayoutInfo *info,
+                                     ClutterOrientation       orientation,
+                                     gfloat                   for_size)
+{
+  if (for_size < 0)
+    return for_size;
+
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    for_size -= (info->margin.top + info->margin.bottom);
+  else
+    for_size -= (info->margin.left + info->margin.right);
+
+  return MAX (for_size, 0);
+}
+
+/*< private >
+ * _clutter_actor_needs_size_request:
+ * @self: a #ClutterActor
+ * @orientation: the direction of the request
+ * @for_size: the size passed to clutter_actor_get_preferred_width()
+ *   or clutter_actor_get_preferred_height()
+ * @class_for_size: (out): return location for the size passed to
+ *   the class, without the margins
+ *
+ * Checks whether a size request of @self would call into the class,
+ * that is whether it is not fixed or already cached.
+ *
+ * Return value: %TRUE if @self needs to be measured for @for_size
+ */
+gboolean
+_clutter_actor_needs_size_request (ClutterActor       *self,
+                                   ClutterOrientation  orientation,
+                                   gfloat              for_size,
+                                   gfloat             *class_for_size)
+{
+  ClutterActorPrivate *priv = self->priv;
+  const SizeRequestCache *cache;
+  gboolean needs_request;
+  guint i;
+
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      if (priv->min_width_set && priv->natural_width_set)
+        return FALSE;
+
+      cache = priv->width_requests;
+      needs_request = priv->needs_width_request;
+    }
+  else
+    {
+      if (priv->min_height_set && priv->natural_height_set)
+        return FALSE;
+
+      cache = priv->height_requests;
+      needs_request = priv->needs_height_request;
+    }
+
+  if (!needs_request && cache != NULL)
+    {
+      for (i = 0; i < cache->n_requests; i++)
+        {
+          if (cache->requests[i].age > 0 &&
+              cache->requests[i].for_size == for_size)
+            return FALSE;
+        }
+    }
+
+  *class_for_size =
+    clutter_actor_remove_request_margin (_clutter_actor_get_layout_info_or_defaults (self),
+                                         orientation,
+                                         for_size);
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_set_size_request:
+ * @self: a #ClutterActor
+ * @orientation: the direction of the request
+ * @for_size: the size passed to _clutter_actor_needs_size_request()
+ * @minimum_size: the minimum size computed by the class
+ * @natural_size: the natural size computed by the class
+ *
+ * Stores a size request of @self computed outside of
+ * clutter_actor_get_preferred_width() or
+ * clutter_actor_get_preferred_height(), as if the class had been
+ * called by them.
+ */
+void
+_clutter_actor_set_size_request (ClutterActor       *self,
+                                 ClutterOrientation  orientation,
+                                 gfloat              for_size,
+                                 gfloat              minimum_size,
+                                 gfloat              natural_size)
+{
+  ClutterActorPrivate *priv = self->priv;
+  SizeRequestCache *cache;
+  SizeRequest *sr;
+  gboolean needs_request;
+
+  cache = clutter_actor_get_size_request_cache (self, orientation);
 
-      clutter_constraint_update_preferred_size (constraint, self,
-                                                direction,
-                                                for_size,
-                                                minimum_size,
-                                                natural_size);
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    needs_request = priv->needs_width_request;
+  else
+    needs_request = priv->needs_height_request;
 
-      CLUTTER_NOTE (LAYOUT,
-                    "Preferred %s of '%s' after constraint '%s': "
-                    "{ min:%.2f, nat:%.2f }",
-                    direction == CLUTTER_ORIENTATION_HORIZONTAL
-                      ? "width"
-                      : "height",
-                    _clutter_actor_get_debug_name (self),
-                    _clutter_actor_meta_get_debug_name (meta),
-                    *minimum_size, *natural_size);
+  if (!needs_request)
+    {
+      /* the same request might have been measured twice */
+      if (_clutter_actor_get_cached_size_request (self, for_size, cache, &sr))
+        return;
     }
+  else
+    sr = &cache->requests[0];
+
+  clutter_actor_store_size_request (self, orientation, sr,
+                                    for_size,
+                                    clutter_actor_remove_request_margin (_clutter_actor_get_layout_info_or_defaults (self),
+                                                                         orientation,
+                                                                         for_size),
+                                    minimum_size,
+                                    natural_size);
 }
 
 /**
@@ -9465,6 +12054,7 @@ clutter_actor_get_preferred_width (ClutterActor *self,
                                    gfloat       *natural_width_p)
 {
   float request_min_width, request_natural_width;
+  SizeRequestCache *cache;
   SizeRequest *cached_size_request;
   const ClutterLayoutInfo *info;
   ClutterActorPrivate *priv;
@@ -9498,23 +12088,29 @@ clutter_actor_get_preferred_width (ClutterActor *self,
    * the *_set flags.
    */
 
+  cache = clutter_actor_get_size_request_cache (self, CLUTTER_ORIENTATION_HORIZONTAL);
+
   if (!priv->needs_width_request)
     {
       found_in_cache =
-        _clutter_actor_get_cached_size_request (for_height,
-                                                priv->width_requests,
+        _clutter_actor_get_cached_size_request (self,
+                                                for_height,
+                                                cache,
                                                 &cached_size_request);
     }
   else
     {
       /* if the actor needs a width request we use the first slot */
       found_in_cache = FALSE;
-      cached_size_request = &priv->width_requests[0];
+      cached_size_request = &cache->requests[0];
     }
 
-  if (!found_in_cache)
+  if (found_in_cache)
+    layout_stats.n_measure_cache_hits += 1;
+  else
     {
       gfloat minimum_width, natural_width;
+      gfloat request_for_height = for_height;
       ClutterActorClass *klass;
 
       minimum_width = natural_width = 0;
@@ -9529,35 +12125,19 @@ clutter_actor_get_preferred_width (ClutterActor *self,
 
       CLUTTER_NOTE (LAYOUT, "Width request for %.2f px", for_height);
 
+      layout_stats.n_measures += 1;
+
       klass = CLUTTER_ACTOR_GET_CLASS (self);
       klass->get_preferred_width (self, for_height,
                                   &minimum_width,
                                   &natural_width);
 
-      /* adjust for constraints */
-      clutter_actor_update_preferred_size_for_constraints (self,
-                                                           CLUTTER_ORIENTATION_HORIZONTAL,
-                                                           for_height,
-                                                           &minimum_width,
-                                                           &natural_width);
-
-      /* adjust for the margin */
-      minimum_width += (info->margin.left + info->margin.right);
-      natural_width += (info->margin.left + info->margin.right);
-
-      /* Due to accumulated float errors, it's better not to warn
-       * on this, but just fix it.
-       */
-      if (natural_width < minimum_width)
-	natural_width = minimum_width;
-
-      cached_size_request->min_size = minimum_width;
-      cached_size_request->natural_size = natural_width;
-      cached_size_request->for_size = for_height;
-      cached_size_request->age = priv->cached_width_age;
-
-      priv->cached_width_age += 1;
-      priv->needs_width_request = FALSE;
+      clutter_actor_store_size_request (self, CLUTTER_ORIENTATION_HORIZONTAL,
+                                        cached_size_request,
+                                        request_for_height,
+                                        for_height,
+                                        minimum_width,
+                                        natural_width);
     }
 
   if (!priv->min_width_set)
@@ -9609,6 +12189,7 @@ clutter_actor_get_preferred_height (ClutterActor *self,
                                     gfloat       *natural_height_p)
 {
   float request_min_height, request_natural_height;
+  SizeRequestCache *cache;
   SizeRequest *cached_size_request;
   const ClutterLayoutInfo *info;
   ClutterActorPrivate *priv;
@@ -9642,22 +12223,28 @@ clutter_actor_get_preferred_height (ClutterActor *self,
    * the *_set flags.
    */
 
+  cache = clutter_actor_get_size_request_cache (self, CLUTTER_ORIENTATION_VERTICAL);
+
   if (!priv->needs_height_request)
     {
       found_in_cache =
-        _clutter_actor_get_cached_size_request (for_width,
-                                                priv->height_requests,
+        _clutter_actor_get_cached_size_request (self,
+                                                for_width,
+                                                cache,
                                                 &cached_size_request);
     }
   else
     {
       found_in_cache = FALSE;
-      cached_size_request = &priv->height_requests[0];
+      cached_size_request = &cache->requests[0];
     }
 
-  if (!found_in_cache)
+  if (found_in_cache)
+    layout_stats.n_measure_cache_hits += 1;
+  else
     {
       gfloat minimum_height, natural_height;
+      gfloat request_for_width = for_width;
       ClutterActorClass *klass;
 
       minimum_height = natural_height = 0;
@@ -9672,35 +12259,19 @@ clutter_actor_get_preferred_height (ClutterActor *self,
             for_width = 0;
         }
 
+      layout_stats.n_measures += 1;
+
       klass = CLUTTER_ACTOR_GET_CLASS (self);
       klass->get_preferred_height (self, for_width,
                                    &minimum_height,
                                    &natural_height);
 
-      /* adjust for constraints */
-      clutter_actor_update_preferred_size_for_constraints (self,
-                                                           CLUTTER_ORIENTATION_VERTICAL,
-                                                           for_width,
-                                                           &minimum_height,
-                                                           &natural_height);
-
-      /* adjust for margin */
-      minimum_height += (info->margin.top + info->margin.bottom);
-      natural_height += (info->margin.top + info->margin.bottom);
-
-      /* Due to accumulated float errors, it's better not to warn
-       * on this, but just fix it.
-       */
-      if (natural_height < minimum_height)
-	natural_height = minimum_height;
-
-      cached_size_request->min_size = minimum_height;
-      cached_size_request->natural_size = natural_height;
-      cached_size_request->for_size = for_width;
-      cached_size_request->age = priv->cached_height_age;
-
-      priv->cached_height_age += 1;
-      priv->needs_height_request = FALSE;
+      clutter_actor_store_size_request (self, CLUTTER_ORIENTATION_VERTICAL,
+                                        cached_size_request,
+                                        request_for_width,
+                                        for_width,
+                                        minimum_height,
+                                        natural_height);
     }
 
   if (!priv->min_height_set)
@@ -9933,21 +12504,69 @@ clutter_actor_adjust_allocation (ClutterActor    *self,
   *allocation = adj_allocation;
 }
 
+/* once the layout of the frame has spent its budget, the relayout
+ * boundaries take their new allocation but leave the allocation of
+ * their children to the next frame
+ */
+static gboolean
+clutter_actor_should_defer_allocation (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+
+  if (!priv->relayout_boundary || priv->n_children == 0)
+    return FALSE;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self) || priv->parent == NULL)
+    return FALSE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  return _clutter_stage_relayout_deadline_expired (CLUTTER_STAGE (stage));
+}
+
 static void
 clutter_actor_allocate_internal (ClutterActor           *self,
                                  const ClutterActorBox  *allocation,
                                  ClutterAllocationFlags  flags)
 {
+  ClutterActorPrivate *priv = self->priv;
   ClutterActorClass *klass;
 
   CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_RELAYOUT);
 
+  if (clutter_actor_should_defer_allocation (self))
+    {
+      CLUTTER_NOTE (LAYOUT, "Deferring the allocation of the children of '%s'",
+                    _clutter_actor_get_debug_name (self));
+
+      clutter_actor_set_allocation_internal (self, allocation, flags);
+
+      /* allocated again by _clutter_actor_relayout_boundary() */
+      priv->needs_allocation = TRUE;
+      priv->relayout_boundary_queued = TRUE;
+      _clutter_stage_defer_relayout_boundary (CLUTTER_STAGE (_clutter_actor_get_stage_internal (self)),
+                                              self);
+
+      CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_RELAYOUT);
+
+      return;
+    }
+
   CLUTTER_NOTE (LAYOUT, "Calling %s::allocate()",
                 _clutter_actor_get_debug_name (self));
 
+  CLUTTER_TRACE_BEGIN (LAYOUT, G_OBJECT_TYPE_NAME (self));
+
+  layout_stats.n_allocations += 1;
+
   klass = CLUTTER_ACTOR_GET_CLASS (self);
   klass->allocate (self, allocation, flags);
 
+  CLUTTER_TRACE_END (LAYOUT);
+
   CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_RELAYOUT);
 
   /* Caller should call clutter_actor_queue_redraw() if needed
@@ -10003,11 +12622,24 @@ clutter_actor_allocate (ClutterActor           *self,
       return;
     }
 
+  /* the relayouts of the stage start from the toplevel */
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    layout_stats.n_relayout_roots += 1;
+
   priv = self->priv;
 
   old_allocation = priv->allocation;
   real_allocation = *box;
 
+  if (priv->constraints != NULL)
+    {
+      ConstraintInfo *info = clutter_actor_get_constraint_info (self);
+
+      info->box = *box;
+      info->flags = flags;
+      priv->has_constraint_box = TRUE;
+    }
+
   /* constraints are allowed to modify the allocation only here; we do
    * this prior to all the other checks so that we can bail out if the
    * allocation did not change
@@ -10083,6 +12715,21 @@ clutter_actor_allocate (ClutterActor           *self,
    */
   self->priv->allocation_flags = flags;
 
+  /* the layout manager of the parent can animate the allocations of all
+   * its children at once, instead of a transition for each of them; the
+   * conditions are the same as for the implicit transitions
+   */
+  if (priv->parent != NULL &&
+      priv->parent->priv->layout_manager != NULL &&
+      _clutter_layout_manager_animate_allocation (priv->parent->priv->layout_manager,
+                                                  self,
+                                                  &priv->allocation,
+                                                  &real_allocation,
+                                                  flags,
+                                                  !priv->needs_allocation &&
+                                                  CLUTTER_ACTOR_IS_MAPPED (self)))
+    return;
+
   _clutter_actor_create_transition (self, obj_props[PROP_ALLOCATION],
                                     &priv->allocation,
                                     &real_allocation);
@@ -10200,7 +12847,12 @@ clutter_actor_set_allocation (ClutterActor           *self,
    */
   clutter_actor_maybe_layout_children (self, box, flags);
 
-  if (changed)
+  /* most actors do not have handlers, and copying the box for
+   * each one of them during a layout animation adds up
+   */
+  if (changed &&
+      g_signal_has_handler_pending (self, actor_signals[ALLOCATION_CHANGED],
+                                    0, TRUE))
     {
       ClutterActorBox signal_box = priv->allocation;
       ClutterAllocationFlags signal_flags = priv->allocation_flags;
@@ -10213,6 +12865,180 @@ clutter_actor_set_allocation (ClutterActor           *self,
   g_object_thaw_notify (G_OBJECT (self));
 }
 
+/*< private >
+ * _clutter_actor_restore_allocation:
+ * @self: a #ClutterActor
+ * @box: the allocation of @self
+ *
+ * Sets @box as the allocation of @self outside of a relayout, without
+ * allocating the children of @self; this is used when restoring a
+ * snapshot, so that the next relayout can skip the actors that end up
+ * with the same allocation they had when the snapshot was taken.
+ */
+void
+_clutter_actor_restore_allocation (ClutterActor          *self,
+                                   const ClutterActorBox *box)
+{
+  clutter_actor_set_allocation_internal (self, box, CLUTTER_ALLOCATION_NONE);
+}
+
+/*< private >
+ * _clutter_actor_set_animated_allocation:
+ * @self: a #ClutterActor
+ * @box: the allocation of @self, already adjusted
+ * @flags: the allocation flags
+ *
+ * Allocates @self at a step of the animation of its allocation driven
+ * by the layout manager of its parent, like a transition of the
+ * #ClutterActor:allocation property would.
+ */
+void
+_clutter_actor_set_animated_allocation (ClutterActor           *self,
+                                        const ClutterActorBox  *box,
+                                        ClutterAllocationFlags  flags)
+{
+  clutter_actor_allocate_internal (self, box, flags);
+  clutter_actor_queue_redraw (self);
+}
+
+/*< private >
+ * _clutter_actor_get_layout_meta:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the #ClutterLayoutMeta stored by the layout manager of the
+ * parent of @self; the layout manager checks that the meta is its own.
+ *
+ * Return value: (transfer none): a #ClutterLayoutMeta, or %NULL
+ */
+ClutterLayoutMeta *
+_clutter_actor_get_layout_meta (ClutterActor *self)
+{
+  return self->priv->layout_meta;
+}
+
+/*< private >
+ * _clutter_actor_set_layout_meta:
+ * @self: a #ClutterActor
+ * @meta: (transfer full) (allow-none): a #ClutterLayoutMeta, or %NULL
+ *
+ * Replaces the #ClutterLayoutMeta stored in @self, taking ownership
+ * of @meta.
+ */
+void
+_clutter_actor_set_layout_meta (ClutterActor      *self,
+                                ClutterLayoutMeta *meta)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->layout_meta != NULL)
+    g_object_unref (priv->layout_meta);
+
+  priv->layout_meta = meta;
+}
+
+/*< private >
+ * _clutter_actor_release_resources:
+ * @self: a #ClutterActor
+ * @flags: the resources to release
+ *
+ * Releases the GPU resources described by @flags which are held by
+ * the effects and the content of @self, without affecting its
+ * children; the resources are created again when @self is painted.
+ */
+void
+_clutter_actor_release_resources (ClutterActor           *self,
+                                  ClutterTrimMemoryFlags  flags)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if ((flags & CLUTTER_TRIM_MEMORY_OFFSCREEN_TARGETS) &&
+      priv->effects != NULL)
+    {
+      const GList *l;
+
+      /* this includes the internal effects, like the flattening one */
+      for (l = _clutter_meta_group_peek_metas (priv->effects);
+           l != NULL;
+           l = l->next)
+        {
+          if (CLUTTER_IS_OFFSCREEN_EFFECT (l->data))
+            _clutter_offscreen_effect_release_resources (l->data);
+        }
+    }
+
+  if (priv->content == NULL)
+    return;
+
+  if ((flags & CLUTTER_TRIM_MEMORY_CANVAS_TEXTURES) &&
+      CLUTTER_IS_CANVAS (priv->content))
+    _clutter_canvas_release_texture (CLUTTER_CANVAS (priv->content));
+  else if ((flags & CLUTTER_TRIM_MEMORY_IMAGE_TEXTURES) &&
+           CLUTTER_IS_IMAGE (priv->content))
+    _clutter_image_release_texture (CLUTTER_IMAGE (priv->content));
+}
+
+/*< private >
+ * _clutter_actor_get_memory_usage:
+ * @self: a #ClutterActor
+ * @contents: (allow-none): the set of the contents already accounted
+ *   for, or %NULL
+ * @usage: (out caller-allocates): return location for the memory usage
+ *
+ * Estimates the memory held by the effects, the content, the cached
+ * paint nodes and the text layouts of @self, without its children.
+ *
+ * If @contents is set, the content of @self is only accounted for if
+ * it is not inside the set already, and it is then added to it, so
+ * that the contents shared by several actors are only counted once.
+ */
+void
+_clutter_actor_get_memory_usage (ClutterActor       *self,
+                                 GHashTable         *contents,
+                                 ClutterMemoryUsage *usage)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  memset (usage, 0, sizeof (ClutterMemoryUsage));
+
+  if (priv->effects != NULL)
+    {
+      const GList *l;
+
+      /* this includes the internal effects, like the flattening one */
+      for (l = _clutter_meta_group_peek_metas (priv->effects);
+           l != NULL;
+           l = l->next)
+        {
+          if (CLUTTER_IS_OFFSCREEN_EFFECT (l->data))
+            usage->offscreen_effects +=
+              _clutter_offscreen_effect_get_memory_size (l->data);
+        }
+    }
+
+  if (priv->retained_paint_node != NULL)
+    usage->paint_nodes =
+      _clutter_paint_node_get_memory_size (priv->retained_paint_node);
+
+  if (CLUTTER_IS_TEXT (self))
+    usage->text_layouts = _clutter_text_get_memory_size (CLUTTER_TEXT (self));
+
+  if (priv->content == NULL)
+    return;
+
+  if (contents != NULL)
+    {
+      if (g_hash_table_contains (contents, priv->content))
+        return;
+
+      g_hash_table_add (contents, priv->content);
+    }
+
+  if (CLUTTER_IS_CANVAS (priv->content))
+    usage->canvases = _clutter_canvas_get_memory_size (CLUTTER_CANVAS (priv->content));
+  else if (CLUTTER_IS_IMAGE (priv->content))
+    usage->images = _clutter_image_get_memory_size (CLUTTER_IMAGE (priv->content));
+}
+
 /**
  * clutter_actor_set_position:
  * @self: A #ClutterActor
@@ -10298,7 +13124,7 @@ clutter_actor_set_fixed_position_set (ClutterActor *self,
     }
 
   self->priv->position_set = is_set != FALSE;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_FIXED_POSITION_SET]);
+  clutter_actor_notify (self, obj_props[PROP_FIXED_POSITION_SET]);
 
   clutter_actor_queue_relayout (self);
 }
@@ -10363,7 +13189,7 @@ clutter_actor_set_min_width (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   info->minimum.width = min_width;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_MIN_WIDTH]);
+  clutter_actor_notify (self, obj_props[PROP_MIN_WIDTH]);
   clutter_actor_set_min_width_set (self, TRUE);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
@@ -10401,7 +13227,7 @@ clutter_actor_set_min_height (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   info->minimum.height = min_height;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_MIN_HEIGHT]);
+  clutter_actor_notify (self, obj_props[PROP_MIN_HEIGHT]);
   clutter_actor_set_min_height_set (self, TRUE);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
@@ -10438,7 +13264,7 @@ clutter_actor_set_natural_width (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   info->natural.width = natural_width;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_NATURAL_WIDTH]);
+  clutter_actor_notify (self, obj_props[PROP_NATURAL_WIDTH]);
   clutter_actor_set_natural_width_set (self, TRUE);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
@@ -10475,7 +13301,7 @@ clutter_actor_set_natural_height (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   info->natural.height = natural_height;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_NATURAL_HEIGHT]);
+  clutter_actor_notify (self, obj_props[PROP_NATURAL_HEIGHT]);
   clutter_actor_set_natural_height_set (self, TRUE);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
@@ -10498,7 +13324,7 @@ clutter_actor_set_min_width_set (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   priv->min_width_set = use_min_width != FALSE;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_MIN_WIDTH_SET]);
+  clutter_actor_notify (self, obj_props[PROP_MIN_WIDTH_SET]);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
@@ -10518,7 +13344,7 @@ clutter_actor_set_min_height_set (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   priv->min_height_set = use_min_height != FALSE;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_MIN_HEIGHT_SET]);
+  clutter_actor_notify (self, obj_props[PROP_MIN_HEIGHT_SET]);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
@@ -10538,7 +13364,7 @@ clutter_actor_set_natural_width_set (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   priv->natural_width_set = use_natural_width != FALSE;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_NATURAL_WIDTH_SET]);
+  clutter_actor_notify (self, obj_props[PROP_NATURAL_WIDTH_SET]);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
@@ -10558,7 +13384,7 @@ clutter_actor_set_natural_height_set (ClutterActor *self,
   clutter_actor_store_old_geometry (self, &old);
 
   priv->natural_height_set = use_natural_height != FALSE;
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_NATURAL_HEIGHT_SET]);
+  clutter_actor_notify (self, obj_props[PROP_NATURAL_HEIGHT_SET]);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
@@ -10596,7 +13422,7 @@ clutter_actor_set_request_mode (ClutterActor       *self,
   priv->needs_width_request = TRUE;
   priv->needs_height_request = TRUE;
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_REQUEST_MODE]);
+  clutter_actor_notify (self, obj_props[PROP_REQUEST_MODE]);
 
   clutter_actor_queue_relayout (self);
 }
@@ -11146,6 +13972,61 @@ clutter_actor_set_height (ClutterActor *self,
                                     height);
 }
 
+/* Moves @self to its new fixed position by allocating it on its own,
+ * instead of queueing a relayout of its parent; this is only possible
+ * if the parent places its children at their fixed position and with
+ * their preferred size, and if the size of the parent does not depend
+ * on the position of its children
+ */
+static gboolean
+clutter_actor_move_fixed_position (ClutterActor *self,
+                                   gboolean      was_fixed)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *parent = priv->parent;
+  ClutterActor *stage;
+
+  /* the parent ignored the fixed position until now */
+  if (!was_fixed || parent == NULL)
+    return FALSE;
+
+  /* constraints can depend on the position */
+  if (priv->needs_allocation || priv->constraints != NULL)
+    return FALSE;
+
+  if (parent->priv->needs_allocation ||
+      parent->priv->layout_manager == NULL ||
+      G_OBJECT_TYPE (parent->priv->layout_manager) != CLUTTER_TYPE_FIXED_LAYOUT)
+    return FALSE;
+
+  /* the stage delegates the allocation of its children to the layout
+   * manager, and its size does not depend on them
+   */
+  if (!CLUTTER_ACTOR_IS_TOPLEVEL (parent) &&
+      (CLUTTER_ACTOR_GET_CLASS (parent)->allocate != clutter_actor_real_allocate ||
+       !clutter_actor_is_relayout_boundary (parent)))
+    return FALSE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL || CLUTTER_ACTOR_IN_RELAYOUT (stage))
+    return FALSE;
+
+  CLUTTER_NOTE (LAYOUT, "Moving '%s' without a relayout of its parent",
+                _clutter_actor_get_debug_name (self));
+
+  _clutter_stage_invalidate_pick_cache (CLUTTER_STAGE (stage));
+
+  /* this is what ClutterFixedLayout would do; the parent did not move */
+  CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+  clutter_actor_allocate_preferred_size (self, CLUTTER_ALLOCATION_NONE);
+  CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+
+  /* the old position is covered by the last paint volume */
+  clutter_actor_queue_redraw (self);
+
+  return TRUE;
+}
+
 static inline void
 clutter_actor_set_x_internal (ClutterActor *self,
                               float         x)
@@ -11153,6 +14034,7 @@ clutter_actor_set_x_internal (ClutterActor *self,
   ClutterActorPrivate *priv = self->priv;
   ClutterLayoutInfo *linfo;
   ClutterActorBox old = { 0, };
+  gboolean was_fixed;
 
   linfo = _clutter_actor_get_layout_info (self);
 
@@ -11161,12 +14043,15 @@ clutter_actor_set_x_internal (ClutterActor *self,
 
   clutter_actor_store_old_geometry (self, &old);
 
+  was_fixed = priv->position_set;
+
   linfo->fixed_pos.x = x;
   clutter_actor_set_fixed_position_set (self, TRUE);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
-  clutter_actor_queue_relayout (self);
+  if (!clutter_actor_move_fixed_position (self, was_fixed))
+    clutter_actor_queue_relayout (self);
 }
 
 static inline void
@@ -11176,6 +14061,7 @@ clutter_actor_set_y_internal (ClutterActor *self,
   ClutterActorPrivate *priv = self->priv;
   ClutterLayoutInfo *linfo;
   ClutterActorBox old = { 0, };
+  gboolean was_fixed;
 
   linfo = _clutter_actor_get_layout_info (self);
 
@@ -11184,12 +14070,15 @@ clutter_actor_set_y_internal (ClutterActor *self,
 
   clutter_actor_store_old_geometry (self, &old);
 
+  was_fixed = priv->position_set;
+
   linfo->fixed_pos.y = y;
   clutter_actor_set_fixed_position_set (self, TRUE);
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
-  clutter_actor_queue_relayout (self);
+  if (!clutter_actor_move_fixed_position (self, was_fixed))
+    clutter_actor_queue_relayout (self);
 }
 
 static void
@@ -11199,6 +14088,7 @@ clutter_actor_set_position_internal (ClutterActor       *self,
   ClutterActorPrivate *priv = self->priv;
   ClutterLayoutInfo *linfo;
   ClutterActorBox old = { 0, };
+  gboolean was_fixed;
 
   linfo = _clutter_actor_get_layout_info (self);
 
@@ -11208,6 +14098,8 @@ clutter_actor_set_position_internal (ClutterActor       *self,
 
   clutter_actor_store_old_geometry (self, &old);
 
+  was_fixed = priv->position_set;
+
   if (position != NULL)
     {
       linfo->fixed_pos = *position;
@@ -11218,7 +14110,8 @@ clutter_actor_set_position_internal (ClutterActor       *self,
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
-  clutter_actor_queue_relayout (self);
+  if (position == NULL || !clutter_actor_move_fixed_position (self, was_fixed))
+    clutter_actor_queue_relayout (self);
 }
 
 /**
@@ -11629,9 +14522,9 @@ clutter_actor_set_opacity_internal (ClutterActor *self,
       _clutter_actor_queue_redraw_full (self,
                                         0, /* flags */
                                         NULL, /* clip */
-                                        priv->flatten_effect);
+                                        clutter_actor_get_offscreen_info_or_defaults (self)->flatten_effect);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_OPACITY]);
+      clutter_actor_notify (self, obj_props[PROP_OPACITY]);
     }
 }
 
@@ -11804,6 +14697,13 @@ clutter_actor_get_opacity (ClutterActor *self)
  * recommended to override the has_overlaps() virtual to return %FALSE
  * for maximum efficiency.
  *
+ * Complex actors whose contents rarely change can use the
+ * %CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC flag to be
+ * flattened only after they have been painted a few times without
+ * changes; any change to the actor or its children discards the
+ * cached image. The size and the memory used by the cached images
+ * are limited by clutter_stage_set_raster_cache_limits().
+ *
  * Since: 1.8
  */
 void
@@ -11811,14 +14711,27 @@ clutter_actor_set_offscreen_redirect (ClutterActor *self,
                                       ClutterOffscreenRedirect redirect)
 {
   ClutterActorPrivate *priv;
+  OffscreenInfo *info;
 
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
   priv = self->priv;
 
-  if (priv->offscreen_redirect != redirect)
+  if (clutter_actor_get_offscreen_info_or_defaults (self)->offscreen_redirect != redirect)
     {
-      priv->offscreen_redirect = redirect;
+      info = clutter_actor_get_offscreen_info (self);
+      info->offscreen_redirect = redirect;
+
+      if ((redirect & CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC) == 0)
+        {
+          ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+          if (stage != NULL && priv->raster_cached)
+            _clutter_stage_release_raster_cache (CLUTTER_STAGE (stage), self);
+
+          priv->raster_cached = FALSE;
+          info->static_paints = 0;
+        }
 
       /* Queue a redraw from the effect so that it can use its cached
          image if available instead of having to redraw the actual
@@ -11828,10 +14741,9 @@ clutter_actor_set_offscreen_redirect (ClutterActor *self,
       _clutter_actor_queue_redraw_full (self,
                                         0, /* flags */
                                         NULL, /* clip */
-                                        priv->flatten_effect);
+                                        info->flatten_effect);
 
-      g_object_notify_by_pspec (G_OBJECT (self),
-                                obj_props[PROP_OFFSCREEN_REDIRECT]);
+      clutter_actor_notify (self, obj_props[PROP_OFFSCREEN_REDIRECT]);
     }
 }
 
@@ -11851,7 +14763,7 @@ clutter_actor_get_offscreen_redirect (ClutterActor *self)
 {
   g_return_val_if_fail (CLUTTER_IS_ACTOR (self), 0);
 
-  return self->priv->offscreen_redirect;
+  return clutter_actor_get_offscreen_info_or_defaults (self)->offscreen_redirect;
 }
 
 /**
@@ -11871,7 +14783,7 @@ clutter_actor_set_name (ClutterActor *self,
   g_free (self->priv->name);
   self->priv->name = g_strdup (name);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_NAME]);
+  clutter_actor_notify (self, obj_props[PROP_NAME]);
 }
 
 /**
@@ -11925,7 +14837,8 @@ clutter_actor_set_depth_internal (ClutterActor *self,
       /* Sets Z value - XXX 2.0: should we invert? */
       info->z_position = depth;
 
-      self->priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
+      clutter_actor_update_z_order (self);
 
       /* FIXME - remove this crap; sadly, there are still containers
        * in Clutter that depend on this utter brain damage
@@ -11934,7 +14847,7 @@ clutter_actor_set_depth_internal (ClutterActor *self,
 
       clutter_actor_queue_redraw (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_DEPTH]);
+      clutter_actor_notify (self, obj_props[PROP_DEPTH]);
     }
 }
 
@@ -11950,11 +14863,12 @@ clutter_actor_set_z_position_internal (ClutterActor *self,
     {
       info->z_position = z_position;
 
-      self->priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
+      clutter_actor_update_z_order (self);
 
       clutter_actor_queue_redraw (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_Z_POSITION]);
+      clutter_actor_notify (self, obj_props[PROP_Z_POSITION]);
     }
 }
 
@@ -12239,8 +15153,8 @@ clutter_actor_set_z_rotation_from_gravity (ClutterActor   *self,
       clutter_actor_set_rotation_angle_internal (self, angle, pspec);
 
       clutter_anchor_coord_set_gravity (&info->rz_center, gravity);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ROTATION_CENTER_Z_GRAVITY]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ROTATION_CENTER_Z]);
+      clutter_actor_notify (self, obj_props[PROP_ROTATION_CENTER_Z_GRAVITY]);
+      clutter_actor_notify (self, obj_props[PROP_ROTATION_CENTER_Z]);
 
       g_object_thaw_notify (obj);
     }
@@ -12380,9 +15294,9 @@ clutter_actor_set_clip (ClutterActor *self,
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_CLIP]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_CLIP_RECT]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_HAS_CLIP]);
+  clutter_actor_notify (self, obj_props[PROP_CLIP]);
+  clutter_actor_notify (self, obj_props[PROP_CLIP_RECT]);
+  clutter_actor_notify (self, obj_props[PROP_HAS_CLIP]);
 }
 
 /**
@@ -12403,7 +15317,7 @@ clutter_actor_remove_clip (ClutterActor *self)
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_HAS_CLIP]);
+  clutter_actor_notify (self, obj_props[PROP_HAS_CLIP]);
 }
 
 /**
@@ -12502,17 +15416,79 @@ clutter_actor_get_children (ClutterActor *self)
   return res;
 }
 
+static gint
+compare_child_z_position (gconstpointer a,
+                          gconstpointer b,
+                          gpointer      dummy G_GNUC_UNUSED)
+{
+  float depth_a, depth_b;
+
+  depth_a =
+    _clutter_actor_get_transform_info_or_defaults ((ClutterActor *) a)->z_position;
+  depth_b =
+    _clutter_actor_get_transform_info_or_defaults ((ClutterActor *) b)->z_position;
+
+  if (depth_a < depth_b)
+    return -1;
+
+  if (depth_a > depth_b)
+    return 1;
+
+  return 0;
+}
+
+/* links @child in the list of children of @self, before @sibling; if
+ * @sibling is %NULL, @child becomes the last child of @self
+ */
+static void
+link_child_before (ClutterActor *self,
+                   ClutterActor *child,
+                   ClutterActor *sibling)
+{
+  if (sibling != NULL)
+    {
+      ClutterActor *tmp = sibling->priv->prev_sibling;
+
+      if (tmp != NULL)
+        tmp->priv->next_sibling = child;
+
+      /* Insert the node before the found one */
+      child->priv->prev_sibling = tmp;
+      child->priv->next_sibling = sibling;
+      sibling->priv->prev_sibling = child;
+    }
+  else
+    {
+      ClutterActor *tmp = self->priv->last_child;
+
+      if (tmp != NULL)
+        tmp->priv->next_sibling = child;
+
+      /* insert the node at the end of the list */
+      child->priv->prev_sibling = tmp;
+      child->priv->next_sibling = NULL;
+    }
+
+  if (child->priv->prev_sibling == NULL)
+    self->priv->first_child = child;
+
+  if (child->priv->next_sibling == NULL)
+    self->priv->last_child = child;
+}
+
 /*< private >
  * insert_child_at_depth:
  * @self: a #ClutterActor
  * @child: a #ClutterActor
  *
- * Inserts @child inside the list of children held by @self, using
+ * Inserts @child inside the list of children of @self, using
  * the depth as the insertion criteria.
  *
  * This sadly makes the insertion not O(1), but we can keep the
  * list sorted so that the painters algorithm we use for painting
- * the children will work correctly.
+ * the children will work correctly. If @self keeps its children
+ * sorted by z-position, the insertion point is found in O(log n)
+ * using the sorted sequence instead of walking the list.
  */
 static void
 insert_child_at_depth (ClutterActor *self,
@@ -12524,6 +15500,24 @@ insert_child_at_depth (ClutterActor *self,
 
   child->priv->parent = self;
 
+  if (self->priv->z_sorted_children != NULL)
+    {
+      GSequenceIter *pos;
+
+      /* the search returns the position after all the children at
+       * the same depth, like the walk below
+       */
+      pos = g_sequence_search (self->priv->z_sorted_children, child,
+                               compare_child_z_position,
+                               NULL);
+      iter = g_sequence_iter_is_end (pos) ? NULL : g_sequence_get (pos);
+
+      child->priv->z_sorted_iter = g_sequence_insert_before (pos, child);
+      link_child_before (self, child, iter);
+
+      return;
+    }
+
   child_depth =
     _clutter_actor_get_transform_info_or_defaults (child)->z_position;
 
@@ -12555,35 +15549,66 @@ insert_child_at_depth (ClutterActor *self,
         break;
     }
 
-  if (iter != NULL)
-    {
-      ClutterActor *tmp = iter->priv->prev_sibling;
+  link_child_before (self, child, iter);
+}
 
-      if (tmp != NULL)
-        tmp->priv->next_sibling = child;
+/*< private >
+ * clutter_actor_update_z_order:
+ * @self: a #ClutterActor
+ *
+ * Moves @self to its new position in the list of children of its
+ * parent after a change of its z-position, if the parent keeps its
+ * children sorted by z-position.
+ *
+ * The sorted sequence is updated in O(log n), and the list of
+ * children is relinked in O(1).
+ */
+static void
+clutter_actor_update_z_order (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *parent = priv->parent;
+  ClutterActor *old_first_child, *old_last_child;
+  ClutterActor *sibling;
+  GSequenceIter *next;
 
-      /* Insert the node before the found one */
-      child->priv->prev_sibling = iter->priv->prev_sibling;
-      child->priv->next_sibling = iter;
-      iter->priv->prev_sibling = child;
-    }
+  if (priv->z_sorted_iter == NULL)
+    return;
+
+  g_sequence_sort_changed (priv->z_sorted_iter,
+                           compare_child_z_position,
+                           NULL);
+
+  next = g_sequence_iter_next (priv->z_sorted_iter);
+  sibling = g_sequence_iter_is_end (next) ? NULL : g_sequence_get (next);
+
+  /* still in the same place */
+  if (sibling == priv->next_sibling)
+    return;
+
+  old_first_child = parent->priv->first_child;
+  old_last_child = parent->priv->last_child;
+
+  if (priv->prev_sibling != NULL)
+    priv->prev_sibling->priv->next_sibling = priv->next_sibling;
   else
-    {
-      ClutterActor *tmp = self->priv->last_child;
+    parent->priv->first_child = priv->next_sibling;
 
-      if (tmp != NULL)
-        tmp->priv->next_sibling = child;
+  if (priv->next_sibling != NULL)
+    priv->next_sibling->priv->prev_sibling = priv->prev_sibling;
+  else
+    parent->priv->last_child = priv->prev_sibling;
 
-      /* insert the node at the end of the list */
-      child->priv->prev_sibling = self->priv->last_child;
-      child->priv->next_sibling = NULL;
-    }
+  link_child_before (parent, self, sibling);
 
-  if (child->priv->prev_sibling == NULL)
-    self->priv->first_child = child;
+  if (old_first_child != parent->priv->first_child)
+    clutter_actor_notify (parent, obj_props[PROP_FIRST_CHILD]);
 
-  if (child->priv->next_sibling == NULL)
-    self->priv->last_child = child;
+  if (old_last_child != parent->priv->last_child)
+    clutter_actor_notify (parent, obj_props[PROP_LAST_CHILD]);
+
+  /* the paint order changed */
+  clutter_actor_queue_redraw (parent);
 }
 
 static void
@@ -12863,15 +15888,28 @@ clutter_actor_add_child_internal (ClutterActor              *self,
   child->priv->next_sibling = NULL;
   child->priv->prev_sibling = NULL;
 
+  /* the position of the children is decided by their z-position
+   * if they are kept sorted
+   */
+  if (self->priv->z_sorted_children != NULL)
+    add_func = insert_child_at_depth;
+
   /* delegate the actual insertion */
   add_func (self, child, data);
 
   g_assert (child->priv->parent == self);
 
+  clutter_actor_invalidate_paint_volume (child);
+
   self->priv->n_children += 1;
 
+  clutter_actor_update_reactive_descendants (child,
+                                             clutter_actor_get_reactive_subtree_size (child));
+
   self->priv->age += 1;
 
+  clutter_actor_invalidate_pick_cache (self);
+
   /* if push_internal() has been called then we automatically set
    * the flag on the actor
    */
@@ -12922,10 +15960,16 @@ clutter_actor_add_child_internal (ClutterActor              *self,
     clutter_actor_show (child);
 
   /* on the other hand, this will catch any other case where
-   * the actor is supposed to be visible when it's added
+   * the actor is supposed to be visible when it's added; while the
+   * layout is frozen, we redraw the whole parent when thawing it
    */
   if (CLUTTER_ACTOR_IS_MAPPED (child))
-    clutter_actor_queue_redraw (child);
+    {
+      if (self->priv->layout_freeze_count > 0)
+        self->priv->thaw_queue_redraw = TRUE;
+      else
+        clutter_actor_queue_redraw (child);
+    }
 
   /* maintain the invariant that if an actor needs layout,
    * its parents do as well
@@ -12955,10 +15999,10 @@ clutter_actor_add_child_internal (ClutterActor              *self,
   if (notify_first_last)
     {
       if (old_first_child != self->priv->first_child)
-        g_object_notify_by_pspec (obj, obj_props[PROP_FIRST_CHILD]);
+        clutter_actor_notify (self, obj_props[PROP_FIRST_CHILD]);
 
       if (old_last_child != self->priv->last_child)
-        g_object_notify_by_pspec (obj, obj_props[PROP_LAST_CHILD]);
+        clutter_actor_notify (self, obj_props[PROP_LAST_CHILD]);
     }
 
   g_object_thaw_notify (obj);
@@ -13157,159 +16201,514 @@ clutter_actor_set_parent (ClutterActor *self,
  * clutter_actor_get_parent:
  * @self: A #ClutterActor
  *
- * Retrieves the parent of @self.
+ * Retrieves the parent of @self.
+ *
+ * Return Value: (transfer none): The #ClutterActor parent, or %NULL
+ *  if no parent is set
+ */
+ClutterActor *
+clutter_actor_get_parent (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+
+  return self->priv->parent;
+}
+
+/**
+ * clutter_actor_get_paint_visibility:
+ * @self: A #ClutterActor
+ *
+ * Retrieves the 'paint' visibility of an actor recursively checking for non
+ * visible parents.
+ *
+ * This is by definition the same as %CLUTTER_ACTOR_IS_MAPPED.
+ *
+ * Return Value: %TRUE if the actor is visibile and will be painted.
+ *
+ * Since: 0.8
+ */
+gboolean
+clutter_actor_get_paint_visibility (ClutterActor *actor)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), FALSE);
+
+  return CLUTTER_ACTOR_IS_MAPPED (actor);
+}
+
+/**
+ * clutter_actor_remove_child:
+ * @self: a #ClutterActor
+ * @child: a #ClutterActor
+ *
+ * Removes @child from the children of @self.
+ *
+ * This function will release the reference added by
+ * clutter_actor_add_child(), so if you want to keep using @child
+ * you will have to acquire a referenced on it before calling this
+ * function.
+ *
+ * This function will emit the #ClutterContainer::actor-removed
+ * signal on @self.
+ *
+ * Since: 1.10
+ */
+void
+clutter_actor_remove_child (ClutterActor *self,
+                            ClutterActor *child)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (CLUTTER_IS_ACTOR (child));
+  g_return_if_fail (self != child);
+  g_return_if_fail (child->priv->parent != NULL);
+  g_return_if_fail (child->priv->parent == self);
+
+  clutter_actor_remove_child_internal (self, child,
+                                       REMOVE_CHILD_DEFAULT_FLAGS);
+}
+
+/**
+ * clutter_actor_remove_all_children:
+ * @self: a #ClutterActor
+ *
+ * Removes all children of @self.
+ *
+ * This function releases the reference added by inserting a child actor
+ * in the list of children of @self.
+ *
+ * If the reference count of a child drops to zero, the child will be
+ * destroyed. If you want to ensure the destruction of all the children
+ * of @self, use clutter_actor_destroy_all_children().
+ *
+ * Since: 1.10
+ */
+void
+clutter_actor_remove_all_children (ClutterActor *self)
+{
+  ClutterActorIter iter;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  if (self->priv->n_children == 0)
+    return;
+
+  g_object_freeze_notify (G_OBJECT (self));
+  clutter_actor_freeze_layout (self);
+
+  clutter_actor_iter_init (&iter, self);
+  while (clutter_actor_iter_next (&iter, NULL))
+    clutter_actor_iter_remove (&iter);
+
+  clutter_actor_thaw_layout (self);
+  g_object_thaw_notify (G_OBJECT (self));
+
+  /* sanity check */
+  g_assert (self->priv->first_child == NULL);
+  g_assert (self->priv->last_child == NULL);
+  g_assert (self->priv->n_children == 0);
+}
+
+/**
+ * clutter_actor_destroy_all_children:
+ * @self: a #ClutterActor
+ *
+ * Destroys all children of @self.
+ *
+ * This function releases the reference added by inserting a child
+ * actor in the list of children of @self, and ensures that the
+ * #ClutterActor::destroy signal is emitted on each child of the
+ * actor.
+ *
+ * By default, #ClutterActor will emit the #ClutterActor::destroy signal
+ * when its reference count drops to 0; the default handler of the
+ * #ClutterActor::destroy signal will destroy all the children of an
+ * actor. This function ensures that all children are destroyed, instead
+ * of just removed from @self, unlike clutter_actor_remove_all_children()
+ * which will merely release the reference and remove each child.
+ *
+ * Unless you acquired an additional reference on each child of @self
+ * prior to calling clutter_actor_remove_all_children() and want to reuse
+ * the actors, you should use clutter_actor_destroy_all_children() in
+ * order to make sure that children are destroyed and signal handlers
+ * are disconnected even in cases where circular references prevent this
+ * from automatically happening through reference counting alone.
+ *
+ * Since: 1.10
+ */
+void
+clutter_actor_destroy_all_children (ClutterActor *self)
+{
+  ClutterActorIter iter;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  if (self->priv->n_children == 0)
+    return;
+
+  g_object_freeze_notify (G_OBJECT (self));
+  clutter_actor_freeze_layout (self);
+
+  clutter_actor_iter_init (&iter, self);
+  while (clutter_actor_iter_next (&iter, NULL))
+    clutter_actor_iter_destroy (&iter);
+
+  clutter_actor_thaw_layout (self);
+  g_object_thaw_notify (G_OBJECT (self));
+
+  /* sanity check */
+  g_assert (self->priv->first_child == NULL);
+  g_assert (self->priv->last_child == NULL);
+  g_assert (self->priv->n_children == 0);
+}
+
+/* the time each idle of the deferred destruction can take, in usecs */
+#define DEFERRED_DESTROY_BUDGET         2000
+
+/* the detached subtrees waiting to be destroyed, oldest first */
+static GQueue deferred_destroy_queue = G_QUEUE_INIT;
+static guint deferred_destroy_id = 0;
+
+static void
+clutter_actor_cancel_deferred_destroy (ClutterActor *self)
+{
+  self->priv->destroy_deferred = FALSE;
+
+  g_queue_remove (&deferred_destroy_queue, self);
+  g_object_unref (self);
+}
+
+/* detaches a leaf of a detached subtree from its parent without the
+ * notifications of clutter_actor_remove_child(), unless the parent
+ * overrides the removal of its children, and destroys it
+ */
+static void
+deferred_destroy_leaf (ClutterActor *leaf)
+{
+  ClutterActor *parent = leaf->priv->parent;
+  ClutterContainerIface *iface, *default_iface;
+
+  g_object_ref (leaf);
+
+  iface = CLUTTER_CONTAINER_GET_IFACE (parent);
+  default_iface = g_type_default_interface_peek (CLUTTER_TYPE_CONTAINER);
+
+  if (iface->remove == default_iface->remove)
+    clutter_actor_remove_child_internal (parent, leaf,
+                                         REMOVE_CHILD_STOP_TRANSITIONS |
+                                         REMOVE_CHILD_DESTROY_META);
+
+  clutter_actor_destroy (leaf);
+
+  g_object_unref (leaf);
+}
+
+static gboolean
+deferred_destroy_step (gpointer data G_GNUC_UNUSED)
+{
+  gint64 start = g_get_monotonic_time ();
+
+  do
+    {
+      ClutterActor *root = g_queue_peek_head (&deferred_destroy_queue);
+      ClutterActor *leaf = root;
+
+      /* the subtrees are destroyed from their leaves, so that each
+       * actor is destroyed without children
+       */
+      while (leaf->priv->last_child != NULL)
+        leaf = leaf->priv->last_child;
+
+      if (leaf != root)
+        deferred_destroy_leaf (leaf);
+      else
+        {
+          g_queue_pop_head (&deferred_destroy_queue);
+          root->priv->destroy_deferred = FALSE;
+
+          clutter_actor_destroy (root);
+          g_object_unref (root);
+        }
+    }
+  while (!g_queue_is_empty (&deferred_destroy_queue) &&
+         g_get_monotonic_time () - start < DEFERRED_DESTROY_BUDGET);
+
+  if (g_queue_is_empty (&deferred_destroy_queue))
+    {
+      deferred_destroy_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+clutter_actor_queue_deferred_destroy (ClutterActor *self)
+{
+  self->priv->destroy_deferred = TRUE;
+
+  /* the queue owns a reference until the actor is destroyed */
+  g_queue_push_tail (&deferred_destroy_queue, g_object_ref (self));
+
+  if (deferred_destroy_id == 0)
+    deferred_destroy_id = clutter_threads_add_idle_full (G_PRIORITY_LOW,
+                                                         deferred_destroy_step,
+                                                         NULL, NULL);
+}
+
+/**
+ * clutter_actor_destroy_deferred:
+ * @self: a #ClutterActor
+ *
+ * Removes @self from its parent right away, and destroys it, with all
+ * of its descendants, over the following iterations of the main loop.
+ *
+ * Destroying a large subtree with clutter_actor_destroy() notifies the
+ * removal of each actor from its parent, and runs the destruction of
+ * all the actors in a single go; this function only notifies the
+ * removal of @self, and destroys the descendants of @self starting
+ * from the leaves, a few at a time, when the main loop is idle. Each
+ * actor still emits the #ClutterActor::destroy signal.
  *
- * Return Value: (transfer none): The #ClutterActor parent, or %NULL
- *  if no parent is set
+ * The actors of the subtree should not be used after calling this
+ * function; destroying one of them before its turn, using
+ * clutter_actor_destroy(), is safe.
+ *
+ * Since: 1.26
  */
-ClutterActor *
-clutter_actor_get_parent (ClutterActor *self)
+void
+clutter_actor_destroy_deferred (ClutterActor *self)
 {
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (!CLUTTER_ACTOR_IS_TOPLEVEL (self));
 
-  return self->priv->parent;
+  if (self->priv->destroy_deferred || CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return;
+
+  g_object_ref (self);
+
+  if (self->priv->parent != NULL)
+    {
+      if (!CLUTTER_ACTOR_IS_INTERNAL_CHILD (self))
+        clutter_container_remove_actor (CLUTTER_CONTAINER (self->priv->parent),
+                                        self);
+      else
+        clutter_actor_remove_child_internal (self->priv->parent, self,
+                                             REMOVE_CHILD_LEGACY_FLAGS);
+    }
+
+  clutter_actor_queue_deferred_destroy (self);
+
+  g_object_unref (self);
 }
 
 /**
- * clutter_actor_get_paint_visibility:
- * @self: A #ClutterActor
- *
- * Retrieves the 'paint' visibility of an actor recursively checking for non
- * visible parents.
- *
- * This is by definition the same as %CLUTTER_ACTOR_IS_MAPPED.
+ * clutter_actor_destroy_all_children_deferred:
+ * @self: a #ClutterActor
  *
- * Return Value: %TRUE if the actor is visibile and will be painted.
+ * Removes all the children of @self right away, and destroys them
+ * over the following iterations of the main loop, as if
+ * clutter_actor_destroy_deferred() was called on each of them.
  *
- * Since: 0.8
+ * Since: 1.26
  */
-gboolean
-clutter_actor_get_paint_visibility (ClutterActor *actor)
+void
+clutter_actor_destroy_all_children_deferred (ClutterActor *self)
 {
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), FALSE);
+  ClutterActorIter iter;
+  ClutterActor *child;
 
-  return CLUTTER_ACTOR_IS_MAPPED (actor);
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  if (self->priv->n_children == 0)
+    return;
+
+  g_object_freeze_notify (G_OBJECT (self));
+  clutter_actor_freeze_layout (self);
+
+  clutter_actor_iter_init (&iter, self);
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      g_object_ref (child);
+      clutter_actor_iter_remove (&iter);
+
+      clutter_actor_queue_deferred_destroy (child);
+      g_object_unref (child);
+    }
+
+  clutter_actor_thaw_layout (self);
+  g_object_thaw_notify (G_OBJECT (self));
 }
 
 /**
- * clutter_actor_remove_child:
+ * clutter_actor_add_children:
  * @self: a #ClutterActor
- * @child: a #ClutterActor
+ * @children: (array length=n_children): the actors to add
+ * @n_children: the number of actors in @children
  *
- * Removes @child from the children of @self.
+ * Adds each actor in @children to the children of @self, as if
+ * clutter_actor_add_child() was called on each of them.
  *
- * This function will release the reference added by
- * clutter_actor_add_child(), so if you want to keep using @child
- * you will have to acquire a referenced on it before calling this
- * function.
+ * The layout of @self is frozen while adding the children, so that
+ * only one relayout and one redraw are queued for the whole batch;
+ * the #ClutterActor:first-child and #ClutterActor:last-child
+ * properties are notified at most once.
  *
- * This function will emit the #ClutterContainer::actor-removed
- * signal on @self.
+ * This function will emit the #ClutterContainer::actor-added signal
+ * on @self for each child.
  *
- * Since: 1.10
+ * Since: 1.26
  */
 void
-clutter_actor_remove_child (ClutterActor *self,
-                            ClutterActor *child)
+clutter_actor_add_children (ClutterActor  *self,
+                            ClutterActor **children,
+                            guint          n_children)
 {
+  guint i;
+
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
-  g_return_if_fail (CLUTTER_IS_ACTOR (child));
-  g_return_if_fail (self != child);
-  g_return_if_fail (child->priv->parent != NULL);
-  g_return_if_fail (child->priv->parent == self);
+  g_return_if_fail (children != NULL || n_children == 0);
 
-  clutter_actor_remove_child_internal (self, child,
-                                       REMOVE_CHILD_DEFAULT_FLAGS);
+  for (i = 0; i < n_children; i++)
+    {
+      g_return_if_fail (CLUTTER_IS_ACTOR (children[i]));
+      g_return_if_fail (children[i] != self);
+      g_return_if_fail (children[i]->priv->parent == NULL);
+    }
+
+  if (n_children == 0)
+    return;
+
+  g_object_freeze_notify (G_OBJECT (self));
+  clutter_actor_freeze_layout (self);
+
+  for (i = 0; i < n_children; i++)
+    clutter_actor_add_child_internal (self, children[i],
+                                      ADD_CHILD_DEFAULT_FLAGS,
+                                      insert_child_at_depth,
+                                      NULL);
+
+  clutter_actor_thaw_layout (self);
+  g_object_thaw_notify (G_OBJECT (self));
 }
 
 /**
- * clutter_actor_remove_all_children:
+ * clutter_actor_remove_children_range:
  * @self: a #ClutterActor
+ * @index_: the index of the first child to remove
+ * @n_children: the number of children to remove, or -1 to remove
+ *   every child starting from @index_
  *
- * Removes all children of @self.
+ * Removes @n_children children of @self, starting from the child
+ * at @index_, as if clutter_actor_remove_child() was called on each
+ * of them.
  *
- * This function releases the reference added by inserting a child actor
- * in the list of children of @self.
+ * The layout of @self is frozen while removing the children, so that
+ * only one relayout is queued for the whole batch.
  *
- * If the reference count of a child drops to zero, the child will be
- * destroyed. If you want to ensure the destruction of all the children
- * of @self, use clutter_actor_destroy_all_children().
+ * This function will emit the #ClutterContainer::actor-removed signal
+ * on @self for each child.
  *
- * Since: 1.10
+ * Since: 1.26
  */
 void
-clutter_actor_remove_all_children (ClutterActor *self)
+clutter_actor_remove_children_range (ClutterActor *self,
+                                     gint          index_,
+                                     gint          n_children)
 {
-  ClutterActorIter iter;
+  ClutterActor *child;
 
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (index_ >= 0 && index_ <= self->priv->n_children);
 
-  if (self->priv->n_children == 0)
+  if (n_children < 0 || n_children > self->priv->n_children - index_)
+    n_children = self->priv->n_children - index_;
+
+  if (n_children == 0)
     return;
 
   g_object_freeze_notify (G_OBJECT (self));
+  clutter_actor_freeze_layout (self);
 
-  clutter_actor_iter_init (&iter, self);
-  while (clutter_actor_iter_next (&iter, NULL))
-    clutter_actor_iter_remove (&iter);
+  child = clutter_actor_get_child_at_index (self, index_);
+  while (n_children-- > 0 && child != NULL)
+    {
+      ClutterActor *next = child->priv->next_sibling;
 
-  g_object_thaw_notify (G_OBJECT (self));
+      clutter_actor_remove_child_internal (self, child,
+                                           REMOVE_CHILD_DEFAULT_FLAGS);
 
-  /* sanity check */
-  g_assert (self->priv->first_child == NULL);
-  g_assert (self->priv->last_child == NULL);
-  g_assert (self->priv->n_children == 0);
+      child = next;
+    }
+
+  clutter_actor_thaw_layout (self);
+  g_object_thaw_notify (G_OBJECT (self));
 }
 
 /**
- * clutter_actor_destroy_all_children:
+ * clutter_actor_freeze_layout:
  * @self: a #ClutterActor
  *
- * Destroys all children of @self.
+ * Freezes the layout of @self.
  *
- * This function releases the reference added by inserting a child
- * actor in the list of children of @self, and ensures that the
- * #ClutterActor::destroy signal is emitted on each child of the
- * actor.
+ * While the layout is frozen, the relayouts queued on @self, or by its
+ * children, are not propagated to the parent of @self, and the redraws
+ * queued by the children added to @self are coalesced; they are queued
+ * once, when calling clutter_actor_thaw_layout().
  *
- * By default, #ClutterActor will emit the #ClutterActor::destroy signal
- * when its reference count drops to 0; the default handler of the
- * #ClutterActor::destroy signal will destroy all the children of an
- * actor. This function ensures that all children are destroyed, instead
- * of just removed from @self, unlike clutter_actor_remove_all_children()
- * which will merely release the reference and remove each child.
+ * This is useful when changing many children of @self at once; each
+ * call must be paired with a call to clutter_actor_thaw_layout().
  *
- * Unless you acquired an additional reference on each child of @self
- * prior to calling clutter_actor_remove_all_children() and want to reuse
- * the actors, you should use clutter_actor_destroy_all_children() in
- * order to make sure that children are destroyed and signal handlers
- * are disconnected even in cases where circular references prevent this
- * from automatically happening through reference counting alone.
+ * Since: 1.26
+ */
+void
+clutter_actor_freeze_layout (ClutterActor *self)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  self->priv->layout_freeze_count += 1;
+}
+
+/**
+ * clutter_actor_thaw_layout:
+ * @self: a #ClutterActor
  *
- * Since: 1.10
+ * Thaws the layout of @self frozen by clutter_actor_freeze_layout(),
+ * and queues the relayout and redraw requested in the meantime.
+ *
+ * Since: 1.26
  */
 void
-clutter_actor_destroy_all_children (ClutterActor *self)
+clutter_actor_thaw_layout (ClutterActor *self)
 {
-  ClutterActorIter iter;
+  ClutterActorPrivate *priv;
 
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-  if (self->priv->n_children == 0)
-    return;
+  priv = self->priv;
 
-  g_object_freeze_notify (G_OBJECT (self));
+  g_return_if_fail (priv->layout_freeze_count > 0);
 
-  clutter_actor_iter_init (&iter, self);
-  while (clutter_actor_iter_next (&iter, NULL))
-    clutter_actor_iter_destroy (&iter);
+  priv->layout_freeze_count -= 1;
+  if (priv->layout_freeze_count > 0)
+    return;
 
-  g_object_thaw_notify (G_OBJECT (self));
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    {
+      priv->thaw_queue_relayout = FALSE;
+      priv->thaw_queue_redraw = FALSE;
+      return;
+    }
 
-  /* sanity check */
-  g_assert (self->priv->first_child == NULL);
-  g_assert (self->priv->last_child == NULL);
-  g_assert (self->priv->n_children == 0);
+  if (priv->thaw_queue_relayout)
+    {
+      priv->thaw_queue_relayout = FALSE;
+      clutter_actor_queue_parent_relayout (self);
+    }
+
+  if (priv->thaw_queue_redraw)
+    {
+      priv->thaw_queue_redraw = FALSE;
+      clutter_actor_queue_redraw (self);
+    }
 }
 
 typedef struct _InsertBetweenData {
@@ -13618,63 +17017,182 @@ clutter_actor_set_child_below_sibling (ClutterActor *self,
   g_return_if_fail (child != sibling);
   g_return_if_fail (sibling == NULL || CLUTTER_IS_ACTOR (sibling));
 
-  if (sibling != NULL)
-    g_return_if_fail (sibling->priv->parent == self);
+  if (sibling != NULL)
+    g_return_if_fail (sibling->priv->parent == self);
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) ||
+      CLUTTER_ACTOR_IN_DESTRUCTION (child) ||
+      (sibling != NULL && CLUTTER_ACTOR_IN_DESTRUCTION (sibling)))
+    return;
+
+  /* see the comment in set_child_above_sibling() */
+  g_object_ref (child);
+  clutter_actor_remove_child_internal (self, child, 0);
+  clutter_actor_add_child_internal (self, child,
+                                    ADD_CHILD_NOTIFY_FIRST_LAST,
+                                    insert_child_below,
+                                    sibling);
+  g_object_unref(child);
+
+  clutter_actor_queue_relayout (self);
+}
+
+/**
+ * clutter_actor_set_child_at_index:
+ * @self: a #ClutterActor
+ * @child: a #ClutterActor child of @self
+ * @index_: the new index for @child
+ *
+ * Changes the index of @child in the list of children of @self.
+ *
+ * This function is logically equivalent to removing @child and
+ * calling clutter_actor_insert_child_at_index(), but it will not
+ * emit signals or change state on @child.
+ *
+ * Since: 1.10
+ */
+void
+clutter_actor_set_child_at_index (ClutterActor *self,
+                                  ClutterActor *child,
+                                  gint          index_)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  g_return_if_fail (CLUTTER_IS_ACTOR (child));
+  g_return_if_fail (child->priv->parent == self);
+  g_return_if_fail (index_ <= self->priv->n_children);
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) ||
+      CLUTTER_ACTOR_IN_DESTRUCTION (child))
+    return;
+
+  g_object_ref (child);
+  clutter_actor_remove_child_internal (self, child, 0);
+  clutter_actor_add_child_internal (self, child,
+                                    ADD_CHILD_NOTIFY_FIRST_LAST,
+                                    insert_child_at_index,
+                                    GINT_TO_POINTER (index_));
+  g_object_unref (child);
+
+  clutter_actor_queue_relayout (self);
+}
+
+/**
+ * clutter_actor_set_sort_children_by_z:
+ * @self: a #ClutterActor
+ * @sort: whether the children of @self should be kept sorted
+ *
+ * Sets whether @self keeps its children sorted by their
+ * #ClutterActor:z-position.
+ *
+ * When enabled, the children are sorted immediately, and a child moves
+ * to its new position in the list of children whenever its z-position
+ * changes; children with the same z-position keep their relative
+ * order. The children are indexed using a balanced tree, so adding a
+ * child or changing its z-position costs O(log n) instead of walking
+ * the list of children, which makes animating the z-position of many
+ * children practical.
+ *
+ * While the children are sorted, the position requested when adding
+ * a child or changing the order of the children, for instance using
+ * clutter_actor_insert_child_at_index() or
+ * clutter_actor_set_child_above_sibling(), is ignored.
+ *
+ * Since: 1.26
+ */
+void
+clutter_actor_set_sort_children_by_z (ClutterActor *self,
+                                      gboolean      sort)
+{
+  ClutterActorPrivate *priv;
+  ClutterActor *old_first_child, *old_last_child;
+  ClutterActor *iter, *prev;
+  GSequenceIter *seq_iter;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  priv = self->priv;
+
+  if ((priv->z_sorted_children != NULL) == !!sort)
+    return;
+
+  if (!sort)
+    {
+      for (iter = priv->first_child;
+           iter != NULL;
+           iter = iter->priv->next_sibling)
+        iter->priv->z_sorted_iter = NULL;
+
+      g_sequence_free (priv->z_sorted_children);
+      priv->z_sorted_children = NULL;
+
+      return;
+    }
+
+  priv->z_sorted_children = g_sequence_new (NULL);
+
+  for (iter = priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    {
+      iter->priv->z_sorted_iter =
+        g_sequence_append (priv->z_sorted_children, iter);
+    }
+
+  /* the sort is stable, and the iterators stay valid */
+  g_sequence_sort (priv->z_sorted_children, compare_child_z_position, NULL);
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) ||
-      CLUTTER_ACTOR_IN_DESTRUCTION (child) ||
-      (sibling != NULL && CLUTTER_ACTOR_IN_DESTRUCTION (sibling)))
-    return;
+  old_first_child = priv->first_child;
+  old_last_child = priv->last_child;
 
-  /* see the comment in set_child_above_sibling() */
-  g_object_ref (child);
-  clutter_actor_remove_child_internal (self, child, 0);
-  clutter_actor_add_child_internal (self, child,
-                                    ADD_CHILD_NOTIFY_FIRST_LAST,
-                                    insert_child_below,
-                                    sibling);
-  g_object_unref(child);
+  /* relink the list of children using the sorted order */
+  prev = NULL;
+  for (seq_iter = g_sequence_get_begin_iter (priv->z_sorted_children);
+       !g_sequence_iter_is_end (seq_iter);
+       seq_iter = g_sequence_iter_next (seq_iter))
+    {
+      iter = g_sequence_get (seq_iter);
 
-  clutter_actor_queue_relayout (self);
+      iter->priv->prev_sibling = prev;
+
+      if (prev != NULL)
+        prev->priv->next_sibling = iter;
+      else
+        priv->first_child = iter;
+
+      prev = iter;
+    }
+
+  if (prev != NULL)
+    prev->priv->next_sibling = NULL;
+
+  priv->last_child = prev;
+
+  if (old_first_child != priv->first_child)
+    clutter_actor_notify (self, obj_props[PROP_FIRST_CHILD]);
+
+  if (old_last_child != priv->last_child)
+    clutter_actor_notify (self, obj_props[PROP_LAST_CHILD]);
+
+  clutter_actor_queue_redraw (self);
 }
 
 /**
- * clutter_actor_set_child_at_index:
+ * clutter_actor_get_sort_children_by_z:
  * @self: a #ClutterActor
- * @child: a #ClutterActor child of @self
- * @index_: the new index for @child
  *
- * Changes the index of @child in the list of children of @self.
+ * Retrieves the value set using clutter_actor_set_sort_children_by_z().
  *
- * This function is logically equivalent to removing @child and
- * calling clutter_actor_insert_child_at_index(), but it will not
- * emit signals or change state on @child.
+ * Return value: %TRUE if the children of @self are kept sorted
+ *   by z-position
  *
- * Since: 1.10
+ * Since: 1.26
  */
-void
-clutter_actor_set_child_at_index (ClutterActor *self,
-                                  ClutterActor *child,
-                                  gint          index_)
+gboolean
+clutter_actor_get_sort_children_by_z (ClutterActor *self)
 {
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
-  g_return_if_fail (CLUTTER_IS_ACTOR (child));
-  g_return_if_fail (child->priv->parent == self);
-  g_return_if_fail (index_ <= self->priv->n_children);
-
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) ||
-      CLUTTER_ACTOR_IN_DESTRUCTION (child))
-    return;
-
-  g_object_ref (child);
-  clutter_actor_remove_child_internal (self, child, 0);
-  clutter_actor_add_child_internal (self, child,
-                                    ADD_CHILD_NOTIFY_FIRST_LAST,
-                                    insert_child_at_index,
-                                    GINT_TO_POINTER (index_));
-  g_object_unref (child);
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
 
-  clutter_actor_queue_relayout (self);
+  return self->priv->z_sorted_children != NULL;
 }
 
 /**
@@ -13809,6 +17327,137 @@ clutter_actor_lower_bottom (ClutterActor *self)
  * Event handling
  */
 
+static gint
+get_event_signal (ClutterEventType event_type)
+{
+  switch (event_type)
+    {
+    case CLUTTER_BUTTON_PRESS:
+      return BUTTON_PRESS_EVENT;
+    case CLUTTER_BUTTON_RELEASE:
+      return BUTTON_RELEASE_EVENT;
+    case CLUTTER_SCROLL:
+      return SCROLL_EVENT;
+    case CLUTTER_KEY_PRESS:
+      return KEY_PRESS_EVENT;
+    case CLUTTER_KEY_RELEASE:
+      return KEY_RELEASE_EVENT;
+    case CLUTTER_MOTION:
+      return MOTION_EVENT;
+    case CLUTTER_ENTER:
+      return ENTER_EVENT;
+    case CLUTTER_LEAVE:
+      return LEAVE_EVENT;
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_CANCEL:
+      return TOUCH_EVENT;
+    case CLUTTER_NOTHING:
+    case CLUTTER_DELETE:
+    case CLUTTER_DESTROY_NOTIFY:
+    case CLUTTER_CLIENT_MESSAGE:
+    default:
+      return -1;
+    }
+}
+
+static gboolean
+clutter_actor_class_handles_event_signal (ClutterActorClass *klass,
+                                          gint               signal_num)
+{
+  switch (signal_num)
+    {
+    case BUTTON_PRESS_EVENT:
+      return klass->button_press_event != NULL;
+    case BUTTON_RELEASE_EVENT:
+      return klass->button_release_event != NULL;
+    case SCROLL_EVENT:
+      return klass->scroll_event != NULL;
+    case KEY_PRESS_EVENT:
+      return klass->key_press_event != NULL;
+    case KEY_RELEASE_EVENT:
+      return klass->key_release_event != NULL;
+    case MOTION_EVENT:
+      return klass->motion_event != NULL;
+    case ENTER_EVENT:
+      return klass->enter_event != NULL;
+    case LEAVE_EVENT:
+      return klass->leave_event != NULL;
+    case TOUCH_EVENT:
+      return klass->touch_event != NULL;
+    default:
+      return FALSE;
+    }
+}
+
+/* the emission hooks are not bound to an instance, and GSignal does
+ * not let us know whether a signal has any, so we count the ones we
+ * know about
+ */
+static guint n_event_emission_hooks = 0;
+
+void
+_clutter_actor_add_event_emission_hook (void)
+{
+  n_event_emission_hooks += 1;
+}
+
+void
+_clutter_actor_remove_event_emission_hook (void)
+{
+  g_return_if_fail (n_event_emission_hooks > 0);
+
+  n_event_emission_hooks -= 1;
+}
+
+/*< private >
+ * clutter_actor_has_event_handlers:
+ * @self: a #ClutterActor
+ * @event: a #ClutterEvent
+ * @capture: whether to check the capture phase
+ *
+ * Checks whether clutter_actor_event() would run any handler for
+ * @event on @self; the handlers connected by the actions are signal
+ * handlers like the others.
+ *
+ * Looking up the handlers is much cheaper than emitting the signals,
+ * which have to set up the marshalling and the accumulator even when
+ * nothing is connected.
+ *
+ * Return value: %TRUE if @self has handlers for @event
+ */
+static gboolean
+clutter_actor_has_event_handlers (ClutterActor       *self,
+                                  const ClutterEvent *event,
+                                  gboolean            capture)
+{
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (self);
+  gint signal_num;
+
+  if (n_event_emission_hooks > 0)
+    return TRUE;
+
+  if (capture)
+    return klass->captured_event != NULL ||
+           g_signal_has_handler_pending (self, actor_signals[CAPTURED_EVENT],
+                                         0,
+                                         FALSE);
+
+  if (klass->event != NULL ||
+      g_signal_has_handler_pending (self, actor_signals[EVENT], 0, FALSE))
+    return TRUE;
+
+  signal_num = get_event_signal (event->type);
+  if (signal_num == -1)
+    return FALSE;
+
+  return clutter_actor_class_handles_event_signal (klass, signal_num) ||
+         g_signal_has_handler_pending (self, actor_signals[signal_num],
+                                       0,
+                                       FALSE);
+}
+
 /**
  * clutter_actor_event:
  * @actor: a #ClutterActor
@@ -13850,47 +17499,7 @@ clutter_actor_event (ClutterActor       *actor,
 
   if (!retval)
     {
-      switch (event->type)
-	{
-	case CLUTTER_NOTHING:
-	  break;
-	case CLUTTER_BUTTON_PRESS:
-	  signal_num = BUTTON_PRESS_EVENT;
-	  break;
-	case CLUTTER_BUTTON_RELEASE:
-	  signal_num = BUTTON_RELEASE_EVENT;
-	  break;
-	case CLUTTER_SCROLL:
-	  signal_num = SCROLL_EVENT;
-	  break;
-	case CLUTTER_KEY_PRESS:
-	  signal_num = KEY_PRESS_EVENT;
-	  break;
-	case CLUTTER_KEY_RELEASE:
-	  signal_num = KEY_RELEASE_EVENT;
-	  break;
-	case CLUTTER_MOTION:
-	  signal_num = MOTION_EVENT;
-	  break;
-	case CLUTTER_ENTER:
-	  signal_num = ENTER_EVENT;
-	  break;
-	case CLUTTER_LEAVE:
-	  signal_num = LEAVE_EVENT;
-	  break;
-        case CLUTTER_TOUCH_BEGIN:
-        case CLUTTER_TOUCH_END:
-        case CLUTTER_TOUCH_UPDATE:
-        case CLUTTER_TOUCH_CANCEL:
-          signal_num = TOUCH_EVENT;
-          break;
-	case CLUTTER_DELETE:
-	case CLUTTER_DESTROY_NOTIFY:
-	case CLUTTER_CLIENT_MESSAGE:
-	default:
-	  signal_num = -1;
-	  break;
-	}
+      signal_num = get_event_signal (event->type);
 
       if (signal_num != -1)
 	g_signal_emit (actor, actor_signals[signal_num], 0,
@@ -13926,7 +17535,10 @@ clutter_actor_set_reactive (ClutterActor *actor,
   else
     CLUTTER_ACTOR_UNSET_FLAGS (actor, CLUTTER_ACTOR_REACTIVE);
 
-  g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_REACTIVE]);
+  clutter_actor_update_reactive_descendants (actor, reactive ? 1 : -1);
+  clutter_actor_invalidate_pick_cache (actor);
+
+  clutter_actor_notify (actor, obj_props[PROP_REACTIVE]);
 }
 
 /**
@@ -13944,1131 +17556,1533 @@ clutter_actor_get_reactive (ClutterActor *actor)
 {
   g_return_val_if_fail (CLUTTER_IS_ACTOR (actor), FALSE);
 
-  return CLUTTER_ACTOR_IS_REACTIVE (actor) ? TRUE : FALSE;
+  return CLUTTER_ACTOR_IS_REACTIVE (actor) ? TRUE : FALSE;
+}
+
+/**
+ * clutter_actor_get_anchor_point:
+ * @self: a #ClutterActor
+ * @anchor_x: (out): return location for the X coordinate of the anchor point
+ * @anchor_y: (out): return location for the Y coordinate of the anchor point
+ *
+ * Gets the current anchor point of the @actor in pixels.
+ *
+ * Since: 0.6
+ *
+ * Deprecated: 1.12: Use #ClutterActor:pivot-point instead
+ */
+void
+clutter_actor_get_anchor_point (ClutterActor *self,
+				gfloat       *anchor_x,
+                                gfloat       *anchor_y)
+{
+  const ClutterTransformInfo *info;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  info = _clutter_actor_get_transform_info_or_defaults (self);
+  clutter_anchor_coord_get_units (self, &info->anchor,
+                                  anchor_x,
+                                  anchor_y,
+                                  NULL);
+}
+
+/**
+ * clutter_actor_set_anchor_point:
+ * @self: a #ClutterActor
+ * @anchor_x: X coordinate of the anchor point
+ * @anchor_y: Y coordinate of the anchor point
+ *
+ * Sets an anchor point for @self. The anchor point is a point in the
+ * coordinate space of an actor to which the actor position within its
+ * parent is relative; the default is (0, 0), i.e. the top-left corner
+ * of the actor.
+ *
+ * Since: 0.6
+ *
+ * Deprecated: 1.12: Use #ClutterActor:pivot-point instead.
+ */
+void
+clutter_actor_set_anchor_point (ClutterActor *self,
+                                gfloat        anchor_x,
+                                gfloat        anchor_y)
+{
+  ClutterTransformInfo *info;
+  ClutterActorPrivate *priv;
+  gboolean changed = FALSE;
+  gfloat old_anchor_x, old_anchor_y;
+  GObject *obj;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  obj = G_OBJECT (self);
+  priv = self->priv;
+  info = _clutter_actor_get_transform_info (self);
+
+  g_object_freeze_notify (obj);
+
+  clutter_anchor_coord_get_units (self, &info->anchor,
+                                  &old_anchor_x,
+                                  &old_anchor_y,
+                                  NULL);
+
+  if (info->anchor.is_fractional)
+    clutter_actor_notify (self, obj_props[PROP_ANCHOR_GRAVITY]);
+
+  if (old_anchor_x != anchor_x)
+    {
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_X]);
+      changed = TRUE;
+    }
+
+  if (old_anchor_y != anchor_y)
+    {
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_Y]);
+      changed = TRUE;
+    }
+
+  clutter_anchor_coord_set_units (&info->anchor, anchor_x, anchor_y, 0);
+
+  if (changed)
+    {
+      clutter_actor_invalidate_transform (self);
+      clutter_actor_queue_redraw (self);
+    }
+
+  g_object_thaw_notify (obj);
+}
+
+/**
+ * clutter_actor_get_anchor_point_gravity:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the anchor position expressed as a #ClutterGravity. If
+ * the anchor point was specified using pixels or units this will
+ * return %CLUTTER_GRAVITY_NONE.
+ *
+ * Return value: the #ClutterGravity used by the anchor point
+ *
+ * Since: 1.0
+ *
+ * Deprecated: 1.12: Use #ClutterActor:pivot-point instead.
+ */
+ClutterGravity
+clutter_actor_get_anchor_point_gravity (ClutterActor *self)
+{
+  const ClutterTransformInfo *info;
+
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), CLUTTER_GRAVITY_NONE);
+
+  info = _clutter_actor_get_transform_info_or_defaults (self);
+
+  return clutter_anchor_coord_get_gravity (&info->anchor);
+}
+
+/**
+ * clutter_actor_move_anchor_point:
+ * @self: a #ClutterActor
+ * @anchor_x: X coordinate of the anchor point
+ * @anchor_y: Y coordinate of the anchor point
+ *
+ * Sets an anchor point for the actor, and adjusts the actor postion so that
+ * the relative position of the actor toward its parent remains the same.
+ *
+ * Since: 0.6
+ *
+ * Deprecated: 1.12: Use #ClutterActor:pivot-point and 
+ * clutter_actor_set_translation() instead.
+ */
+void
+clutter_actor_move_anchor_point (ClutterActor *self,
+                                 gfloat        anchor_x,
+                                 gfloat        anchor_y)
+{
+  gfloat old_anchor_x, old_anchor_y;
+  const ClutterTransformInfo *info;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  info = _clutter_actor_get_transform_info (self);
+  clutter_anchor_coord_get_units (self, &info->anchor,
+                                  &old_anchor_x,
+                                  &old_anchor_y,
+                                  NULL);
+
+  g_object_freeze_notify (G_OBJECT (self));
+
+  clutter_actor_set_anchor_point (self, anchor_x, anchor_y);
+
+  if (self->priv->position_set)
+    clutter_actor_move_by (self,
+                           anchor_x - old_anchor_x,
+                           anchor_y - old_anchor_y);
+
+  g_object_thaw_notify (G_OBJECT (self));
 }
 
 /**
- * clutter_actor_get_anchor_point:
+ * clutter_actor_move_anchor_point_from_gravity:
  * @self: a #ClutterActor
- * @anchor_x: (out): return location for the X coordinate of the anchor point
- * @anchor_y: (out): return location for the Y coordinate of the anchor point
+ * @gravity: #ClutterGravity.
  *
- * Gets the current anchor point of the @actor in pixels.
+ * Sets an anchor point on the actor based on the given gravity, adjusting the
+ * actor postion so that its relative position within its parent remains
+ * unchanged.
+ *
+ * Since version 1.0 the anchor point will be stored as a gravity so
+ * that if the actor changes size then the anchor point will move. For
+ * example, if you set the anchor point to %CLUTTER_GRAVITY_SOUTH_EAST
+ * and later double the size of the actor, the anchor point will move
+ * to the bottom right.
  *
  * Since: 0.6
  *
- * Deprecated: 1.12: Use #ClutterActor:pivot-point instead
+ * Deprecated: 1.12: Use #ClutterActor:pivot-point and 
+ * clutter_actor_set_translation() instead.
  */
 void
-clutter_actor_get_anchor_point (ClutterActor *self,
-				gfloat       *anchor_x,
-                                gfloat       *anchor_y)
+clutter_actor_move_anchor_point_from_gravity (ClutterActor   *self,
+					      ClutterGravity  gravity)
 {
+  gfloat old_anchor_x, old_anchor_y, new_anchor_x, new_anchor_y;
   const ClutterTransformInfo *info;
+  ClutterActorPrivate *priv;
 
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-  info = _clutter_actor_get_transform_info_or_defaults (self);
+  priv = self->priv;
+  info = _clutter_actor_get_transform_info (self);
+
+  g_object_freeze_notify (G_OBJECT (self));
+
   clutter_anchor_coord_get_units (self, &info->anchor,
-                                  anchor_x,
-                                  anchor_y,
+                                  &old_anchor_x,
+                                  &old_anchor_y,
+                                  NULL);
+  clutter_actor_set_anchor_point_from_gravity (self, gravity);
+  clutter_anchor_coord_get_units (self, &info->anchor,
+                                  &new_anchor_x,
+                                  &new_anchor_y,
                                   NULL);
+
+  if (priv->position_set)
+    clutter_actor_move_by (self,
+                           new_anchor_x - old_anchor_x,
+                           new_anchor_y - old_anchor_y);
+
+  g_object_thaw_notify (G_OBJECT (self));
 }
 
 /**
- * clutter_actor_set_anchor_point:
+ * clutter_actor_set_anchor_point_from_gravity:
  * @self: a #ClutterActor
- * @anchor_x: X coordinate of the anchor point
- * @anchor_y: Y coordinate of the anchor point
+ * @gravity: #ClutterGravity.
  *
- * Sets an anchor point for @self. The anchor point is a point in the
- * coordinate space of an actor to which the actor position within its
- * parent is relative; the default is (0, 0), i.e. the top-left corner
- * of the actor.
+ * Sets an anchor point on the actor, based on the given gravity (this is a
+ * convenience function wrapping clutter_actor_set_anchor_point()).
+ *
+ * Since version 1.0 the anchor point will be stored as a gravity so
+ * that if the actor changes size then the anchor point will move. For
+ * example, if you set the anchor point to %CLUTTER_GRAVITY_SOUTH_EAST
+ * and later double the size of the actor, the anchor point will move
+ * to the bottom right.
  *
  * Since: 0.6
  *
- * Deprecated: 1.12: Use #ClutterActor:pivot-point instead.
+ * Deprecated: 1.12: Use #ClutterActor:pivot-point and 
+ * clutter_actor_set_translation() instead. E.g. For %CLUTTER_GRAVITY_CENTER set
+ * pivot_point to (0.5,0.5) and the translation to (width/2,height/2).
  */
 void
-clutter_actor_set_anchor_point (ClutterActor *self,
-                                gfloat        anchor_x,
-                                gfloat        anchor_y)
+clutter_actor_set_anchor_point_from_gravity (ClutterActor   *self,
+					     ClutterGravity  gravity)
 {
-  ClutterTransformInfo *info;
-  ClutterActorPrivate *priv;
-  gboolean changed = FALSE;
-  gfloat old_anchor_x, old_anchor_y;
-  GObject *obj;
-
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-  obj = G_OBJECT (self);
-  priv = self->priv;
-  info = _clutter_actor_get_transform_info (self);
+  if (gravity == CLUTTER_GRAVITY_NONE)
+    clutter_actor_set_anchor_point (self, 0, 0);
+  else
+    {
+      GObject *obj = G_OBJECT (self);
+      ClutterTransformInfo *info;
 
-  g_object_freeze_notify (obj);
+      g_object_freeze_notify (obj);
 
-  clutter_anchor_coord_get_units (self, &info->anchor,
-                                  &old_anchor_x,
-                                  &old_anchor_y,
-                                  NULL);
+      info = _clutter_actor_get_transform_info (self);
+      clutter_anchor_coord_set_gravity (&info->anchor, gravity);
 
-  if (info->anchor.is_fractional)
-    g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_GRAVITY]);
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_GRAVITY]);
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_X]);
+      clutter_actor_notify (self, obj_props[PROP_ANCHOR_Y]);
 
-  if (old_anchor_x != anchor_x)
+      clutter_actor_invalidate_transform (self);
+
+      clutter_actor_queue_redraw (self);
+
+      g_object_thaw_notify (obj);
+    }
+}
+
+static void
+clutter_actor_store_content_box (ClutterActor *self,
+                                 const ClutterActorBox *box)
+{
+  if (box != NULL)
     {
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_X]);
-      changed = TRUE;
+      clutter_actor_get_content_info (self)->content_box = *box;
+      self->priv->content_box_valid = TRUE;
     }
+  else
+    self->priv->content_box_valid = FALSE;
 
-  if (old_anchor_y != anchor_y)
+  clutter_actor_queue_redraw (self);
+
+  clutter_actor_notify (self, obj_props[PROP_CONTENT_BOX]);
+}
+
+static void
+clutter_container_iface_init (ClutterContainerIface *iface)
+{
+  /* we don't override anything, as ClutterContainer already has a default
+   * implementation that we can use, and which calls into our own API.
+   */
+}
+
+typedef enum
+{
+  PARSE_X,
+  PARSE_Y,
+  PARSE_WIDTH,
+  PARSE_HEIGHT,
+  PARSE_ANCHOR_X,
+  PARSE_ANCHOR_Y
+} ParseDimension;
+
+static gfloat
+parse_units (ClutterActor   *self,
+             ParseDimension  dimension,
+             JsonNode       *node)
+{
+  GValue value = G_VALUE_INIT;
+  gfloat retval = 0;
+
+  if (JSON_NODE_TYPE (node) != JSON_NODE_VALUE)
+    return 0;
+
+  json_node_get_value (node, &value);
+
+  if (G_VALUE_HOLDS (&value, G_TYPE_INT64))
     {
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_Y]);
-      changed = TRUE;
+      retval = (gfloat) g_value_get_int64 (&value);
+    }
+  else if (G_VALUE_HOLDS (&value, G_TYPE_DOUBLE))
+    {
+      retval = g_value_get_double (&value);
+    }
+  else if (G_VALUE_HOLDS (&value, G_TYPE_STRING))
+    {
+      ClutterUnits units;
+      gboolean res;
+
+      res = clutter_units_from_string (&units, g_value_get_string (&value));
+      if (res)
+        retval = clutter_units_to_pixels (&units);
+      else
+        {
+          g_warning ("Invalid value '%s': integers, strings or floating point "
+                     "values can be used for the x, y, width and height "
+                     "properties. Valid modifiers for strings are 'px', 'mm', "
+                     "'pt' and 'em'.",
+                     g_value_get_string (&value));
+          retval = 0;
+        }
+    }
+  else
+    {
+      g_warning ("Invalid value of type '%s': integers, strings of floating "
+                 "point values can be used for the x, y, width, height "
+                 "anchor-x and anchor-y properties.",
+                 g_type_name (G_VALUE_TYPE (&value)));
+    }
+
+  g_value_unset (&value);
+
+  return retval;
+}
+
+typedef struct {
+  ClutterRotateAxis axis;
+
+  gdouble angle;
+
+  gfloat center_x;
+  gfloat center_y;
+  gfloat center_z;
+} RotationInfo;
+
+static inline gboolean
+parse_rotation_array (ClutterActor *actor,
+                      JsonArray    *array,
+                      RotationInfo *info)
+{
+  JsonNode *element;
+
+  if (json_array_get_length (array) != 2)
+    return FALSE;
+
+  /* angle */
+  element = json_array_get_element (array, 0);
+  if (JSON_NODE_TYPE (element) == JSON_NODE_VALUE)
+    info->angle = json_node_get_double (element);
+  else
+    return FALSE;
+
+  /* center */
+  element = json_array_get_element (array, 1);
+  if (JSON_NODE_TYPE (element) == JSON_NODE_ARRAY)
+    {
+      JsonArray *center = json_node_get_array (element);
+
+      if (json_array_get_length (center) != 2)
+        return FALSE;
+
+      switch (info->axis)
+        {
+        case CLUTTER_X_AXIS:
+          info->center_y = parse_units (actor, PARSE_Y,
+                                        json_array_get_element (center, 0));
+          info->center_z = parse_units (actor, PARSE_Y,
+                                        json_array_get_element (center, 1));
+          return TRUE;
+
+        case CLUTTER_Y_AXIS:
+          info->center_x = parse_units (actor, PARSE_X,
+                                        json_array_get_element (center, 0));
+          info->center_z = parse_units (actor, PARSE_X,
+                                        json_array_get_element (center, 1));
+          return TRUE;
+
+        case CLUTTER_Z_AXIS:
+          info->center_x = parse_units (actor, PARSE_X,
+                                        json_array_get_element (center, 0));
+          info->center_y = parse_units (actor, PARSE_Y,
+                                        json_array_get_element (center, 1));
+          return TRUE;
+        }
     }
 
-  clutter_anchor_coord_set_units (&info->anchor, anchor_x, anchor_y, 0);
+  return FALSE;
+}
+
+static gboolean
+parse_rotation (ClutterActor *actor,
+                JsonNode     *node,
+                RotationInfo *info)
+{
+  JsonArray *array;
+  guint len, i;
+  gboolean retval = FALSE;
 
-  if (changed)
+  if (JSON_NODE_TYPE (node) != JSON_NODE_ARRAY)
     {
-      priv->transform_valid = FALSE;
-      clutter_actor_queue_redraw (self);
+      g_warning ("Invalid node of type '%s' found, expecting an array",
+                 json_node_type_name (node));
+      return FALSE;
     }
 
-  g_object_thaw_notify (obj);
-}
+  array = json_node_get_array (node);
+  len = json_array_get_length (array);
 
-/**
- * clutter_actor_get_anchor_point_gravity:
- * @self: a #ClutterActor
- *
- * Retrieves the anchor position expressed as a #ClutterGravity. If
- * the anchor point was specified using pixels or units this will
- * return %CLUTTER_GRAVITY_NONE.
- *
- * Return value: the #ClutterGravity used by the anchor point
- *
- * Since: 1.0
- *
- * Deprecated: 1.12: Use #ClutterActor:pivot-point instead.
- */
-ClutterGravity
-clutter_actor_get_anchor_point_gravity (ClutterActor *self)
-{
-  const ClutterTransformInfo *info;
+  for (i = 0; i < len; i++)
+    {
+      JsonNode *element = json_array_get_element (array, i);
+      JsonObject *object;
+      JsonNode *member;
 
-  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), CLUTTER_GRAVITY_NONE);
+      if (JSON_NODE_TYPE (element) != JSON_NODE_OBJECT)
+        {
+          g_warning ("Invalid node of type '%s' found, expecting an object",
+                     json_node_type_name (element));
+          return FALSE;
+        }
 
-  info = _clutter_actor_get_transform_info_or_defaults (self);
+      object = json_node_get_object (element);
 
-  return clutter_anchor_coord_get_gravity (&info->anchor);
-}
+      if (json_object_has_member (object, "x-axis"))
+        {
+          member = json_object_get_member (object, "x-axis");
 
-/**
- * clutter_actor_move_anchor_point:
- * @self: a #ClutterActor
- * @anchor_x: X coordinate of the anchor point
- * @anchor_y: Y coordinate of the anchor point
- *
- * Sets an anchor point for the actor, and adjusts the actor postion so that
- * the relative position of the actor toward its parent remains the same.
- *
- * Since: 0.6
- *
- * Deprecated: 1.12: Use #ClutterActor:pivot-point and 
- * clutter_actor_set_translation() instead.
- */
-void
-clutter_actor_move_anchor_point (ClutterActor *self,
-                                 gfloat        anchor_x,
-                                 gfloat        anchor_y)
-{
-  gfloat old_anchor_x, old_anchor_y;
-  const ClutterTransformInfo *info;
+          info->axis = CLUTTER_X_AXIS;
 
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+          if (JSON_NODE_TYPE (member) == JSON_NODE_VALUE)
+            {
+              info->angle = json_node_get_double (member);
+              retval = TRUE;
+            }
+          else if (JSON_NODE_TYPE (member) == JSON_NODE_ARRAY)
+            retval = parse_rotation_array (actor,
+                                           json_node_get_array (member),
+                                           info);
+          else
+            retval = FALSE;
+        }
+      else if (json_object_has_member (object, "y-axis"))
+        {
+          member = json_object_get_member (object, "y-axis");
 
-  info = _clutter_actor_get_transform_info (self);
-  clutter_anchor_coord_get_units (self, &info->anchor,
-                                  &old_anchor_x,
-                                  &old_anchor_y,
-                                  NULL);
+          info->axis = CLUTTER_Y_AXIS;
 
-  g_object_freeze_notify (G_OBJECT (self));
+          if (JSON_NODE_TYPE (member) == JSON_NODE_VALUE)
+            {
+              info->angle = json_node_get_double (member);
+              retval = TRUE;
+            }
+          else if (JSON_NODE_TYPE (member) == JSON_NODE_ARRAY)
+            retval = parse_rotation_array (actor,
+                                           json_node_get_array (member),
+                                           info);
+          else
+            retval = FALSE;
+        }
+      else if (json_object_has_member (object, "z-axis"))
+        {
+          member = json_object_get_member (object, "z-axis");
 
-  clutter_actor_set_anchor_point (self, anchor_x, anchor_y);
+          info->axis = CLUTTER_Z_AXIS;
 
-  if (self->priv->position_set)
-    clutter_actor_move_by (self,
-                           anchor_x - old_anchor_x,
-                           anchor_y - old_anchor_y);
+          if (JSON_NODE_TYPE (member) == JSON_NODE_VALUE)
+            {
+              info->angle = json_node_get_double (member);
+              retval = TRUE;
+            }
+          else if (JSON_NODE_TYPE (member) == JSON_NODE_ARRAY)
+            retval = parse_rotation_array (actor,
+                                           json_node_get_array (member),
+                                           info);
+          else
+            retval = FALSE;
+        }
+    }
 
-  g_object_thaw_notify (G_OBJECT (self));
+  return retval;
 }
 
-/**
- * clutter_actor_move_anchor_point_from_gravity:
- * @self: a #ClutterActor
- * @gravity: #ClutterGravity.
- *
- * Sets an anchor point on the actor based on the given gravity, adjusting the
- * actor postion so that its relative position within its parent remains
- * unchanged.
- *
- * Since version 1.0 the anchor point will be stored as a gravity so
- * that if the actor changes size then the anchor point will move. For
- * example, if you set the anchor point to %CLUTTER_GRAVITY_SOUTH_EAST
- * and later double the size of the actor, the anchor point will move
- * to the bottom right.
- *
- * Since: 0.6
- *
- * Deprecated: 1.12: Use #ClutterActor:pivot-point and 
- * clutter_actor_set_translation() instead.
- */
-void
-clutter_actor_move_anchor_point_from_gravity (ClutterActor   *self,
-					      ClutterGravity  gravity)
+static GSList *
+parse_actor_metas (ClutterScript *script,
+                   ClutterActor  *actor,
+                   JsonNode      *node)
 {
-  gfloat old_anchor_x, old_anchor_y, new_anchor_x, new_anchor_y;
-  const ClutterTransformInfo *info;
-  ClutterActorPrivate *priv;
+  GList *elements, *l;
+  GSList *retval = NULL;
 
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  if (!JSON_NODE_HOLDS_ARRAY (node))
+    return NULL;
 
-  priv = self->priv;
-  info = _clutter_actor_get_transform_info (self);
+  elements = json_array_get_elements (json_node_get_array (node));
 
-  g_object_freeze_notify (G_OBJECT (self));
+  for (l = elements; l != NULL; l = l->next)
+    {
+      JsonNode *element = l->data;
+      const gchar *id_ = _clutter_script_get_id_from_node (element);
+      GObject *meta;
 
-  clutter_anchor_coord_get_units (self, &info->anchor,
-                                  &old_anchor_x,
-                                  &old_anchor_y,
-                                  NULL);
-  clutter_actor_set_anchor_point_from_gravity (self, gravity);
-  clutter_anchor_coord_get_units (self, &info->anchor,
-                                  &new_anchor_x,
-                                  &new_anchor_y,
-                                  NULL);
+      if (id_ == NULL || *id_ == '\0')
+        continue;
 
-  if (priv->position_set)
-    clutter_actor_move_by (self,
-                           new_anchor_x - old_anchor_x,
-                           new_anchor_y - old_anchor_y);
+      meta = clutter_script_get_object (script, id_);
+      if (meta == NULL)
+        continue;
 
-  g_object_thaw_notify (G_OBJECT (self));
+      retval = g_slist_prepend (retval, meta);
+    }
+
+  g_list_free (elements);
+
+  return g_slist_reverse (retval);
 }
 
-/**
- * clutter_actor_set_anchor_point_from_gravity:
- * @self: a #ClutterActor
- * @gravity: #ClutterGravity.
- *
- * Sets an anchor point on the actor, based on the given gravity (this is a
- * convenience function wrapping clutter_actor_set_anchor_point()).
- *
- * Since version 1.0 the anchor point will be stored as a gravity so
- * that if the actor changes size then the anchor point will move. For
- * example, if you set the anchor point to %CLUTTER_GRAVITY_SOUTH_EAST
- * and later double the size of the actor, the anchor point will move
- * to the bottom right.
- *
- * Since: 0.6
- *
- * Deprecated: 1.12: Use #ClutterActor:pivot-point and 
- * clutter_actor_set_translation() instead. E.g. For %CLUTTER_GRAVITY_CENTER set
- * pivot_point to (0.5,0.5) and the translation to (width/2,height/2).
- */
-void
-clutter_actor_set_anchor_point_from_gravity (ClutterActor   *self,
-					     ClutterGravity  gravity)
+static GSList *
+parse_behaviours (ClutterScript *script,
+                  ClutterActor  *actor,
+                  JsonNode      *node)
 {
-  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+  GList *elements, *l;
+  GSList *retval = NULL;
 
-  if (gravity == CLUTTER_GRAVITY_NONE)
-    clutter_actor_set_anchor_point (self, 0, 0);
-  else
-    {
-      GObject *obj = G_OBJECT (self);
-      ClutterTransformInfo *info;
+  if (!JSON_NODE_HOLDS_ARRAY (node))
+    return NULL;
 
-      g_object_freeze_notify (obj);
+  elements = json_array_get_elements (json_node_get_array (node));
 
-      info = _clutter_actor_get_transform_info (self);
-      clutter_anchor_coord_set_gravity (&info->anchor, gravity);
+  for (l = elements; l != NULL; l = l->next)
+    {
+      JsonNode *element = l->data;
+      const gchar *id_ = _clutter_script_get_id_from_node (element);
+      GObject *behaviour;
+
+      if (id_ == NULL || *id_ == '\0')
+        continue;
 
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_GRAVITY]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_X]);
-      g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_Y]);
+      behaviour = clutter_script_get_object (script, id_);
+      if (behaviour == NULL)
+        continue;
 
-      self->priv->transform_valid = FALSE;
+      retval = g_slist_prepend (retval, behaviour);
+    }
 
-      clutter_actor_queue_redraw (self);
+  g_list_free (elements);
 
-      g_object_thaw_notify (obj);
-    }
+  return g_slist_reverse (retval);
 }
 
-static void
-clutter_actor_store_content_box (ClutterActor *self,
-                                 const ClutterActorBox *box)
+static ClutterMargin *
+parse_margin (ClutterActor *self,
+              JsonNode     *node)
 {
-  if (box != NULL)
+  ClutterMargin *margin;
+  JsonArray *array;
+
+  if (!JSON_NODE_HOLDS_ARRAY (node))
     {
-      self->priv->content_box = *box;
-      self->priv->content_box_valid = TRUE;
+      g_warning ("The margin property must be an array of 1 to 4 elements");
+      return NULL;
     }
-  else
-    self->priv->content_box_valid = FALSE;
 
-  clutter_actor_queue_redraw (self);
+  margin = clutter_margin_new ();
+  array = json_node_get_array (node);
+  switch (json_array_get_length (array))
+    {
+    case 1:
+      margin->top = margin->right = margin->bottom = margin->left =
+        parse_units (self, 0, json_array_get_element (array, 0));
+      break;
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT_BOX]);
-}
+    case 2:
+      margin->top = margin->bottom =
+        parse_units (self, 0, json_array_get_element (array, 0));
+      margin->right = margin->left =
+        parse_units (self, 0, json_array_get_element (array, 1));
+      break;
 
-static void
-clutter_container_iface_init (ClutterContainerIface *iface)
-{
-  /* we don't override anything, as ClutterContainer already has a default
-   * implementation that we can use, and which calls into our own API.
-   */
+    case 3:
+      margin->top =
+        parse_units (self, 0, json_array_get_element (array, 0));
+      margin->right = margin->left =
+        parse_units (self, 0, json_array_get_element (array, 1));
+      margin->bottom =
+        parse_units (self, 0, json_array_get_element (array, 2));
+      break;
+
+    case 4:
+      margin->top =
+        parse_units (self, 0, json_array_get_element (array, 0));
+      margin->right =
+        parse_units (self, 0, json_array_get_element (array, 1));
+      margin->bottom =
+        parse_units (self, 0, json_array_get_element (array, 2));
+      margin->left =
+        parse_units (self, 0, json_array_get_element (array, 3));
+      break;
+
+    default:
+      g_warning ("The margin property must be an array of 1 to 4 elements");
+      clutter_margin_free (margin);
+      return NULL;
+    }
+  return margin;
 }
 
-typedef enum
+static gboolean
+clutter_actor_parse_custom_node (ClutterScriptable *scriptable,
+                                 ClutterScript     *script,
+                                 GValue            *value,
+                                 const gchar       *name,
+                                 JsonNode          *node)
 {
-  PARSE_X,
-  PARSE_Y,
-  PARSE_WIDTH,
-  PARSE_HEIGHT,
-  PARSE_ANCHOR_X,
-  PARSE_ANCHOR_Y
-} ParseDimension;
+  ClutterActor *actor = CLUTTER_ACTOR (scriptable);
+  gboolean retval = FALSE;
 
-static gfloat
-parse_units (ClutterActor   *self,
-             ParseDimension  dimension,
-             JsonNode       *node)
-{
-  GValue value = G_VALUE_INIT;
-  gfloat retval = 0;
+  if ((name[0] == 'x' && name[1] == '\0') ||
+      (name[0] == 'y' && name[1] == '\0') ||
+      (strcmp (name, "width") == 0) ||
+      (strcmp (name, "height") == 0) ||
+      (strcmp (name, "anchor_x") == 0) ||
+      (strcmp (name, "anchor_y") == 0))
+    {
+      ParseDimension dimension;
+      gfloat units;
 
-  if (JSON_NODE_TYPE (node) != JSON_NODE_VALUE)
-    return 0;
+      if (name[0] == 'x')
+        dimension = PARSE_X;
+      else if (name[0] == 'y')
+        dimension = PARSE_Y;
+      else if (name[0] == 'w')
+        dimension = PARSE_WIDTH;
+      else if (name[0] == 'h')
+        dimension = PARSE_HEIGHT;
+      else if (name[0] == 'a' && name[7] == 'x')
+        dimension = PARSE_ANCHOR_X;
+      else if (name[0] == 'a' && name[7] == 'y')
+        dimension = PARSE_ANCHOR_Y;
+      else
+        return FALSE;
 
-  json_node_get_value (node, &value);
+      units = parse_units (actor, dimension, node);
 
-  if (G_VALUE_HOLDS (&value, G_TYPE_INT64))
-    {
-      retval = (gfloat) g_value_get_int64 (&value);
-    }
-  else if (G_VALUE_HOLDS (&value, G_TYPE_DOUBLE))
-    {
-      retval = g_value_get_double (&value);
+      /* convert back to pixels: all properties are pixel-based */
+      g_value_init (value, G_TYPE_FLOAT);
+      g_value_set_float (value, units);
+
+      retval = TRUE;
     }
-  else if (G_VALUE_HOLDS (&value, G_TYPE_STRING))
+  else if (strcmp (name, "rotation") == 0)
     {
-      ClutterUnits units;
-      gboolean res;
+      RotationInfo *info;
 
-      res = clutter_units_from_string (&units, g_value_get_string (&value));
-      if (res)
-        retval = clutter_units_to_pixels (&units);
-      else
+      info = g_slice_new0 (RotationInfo);
+      retval = parse_rotation (actor, node, info);
+
+      if (retval)
         {
-          g_warning ("Invalid value '%s': integers, strings or floating point "
-                     "values can be used for the x, y, width and height "
-                     "properties. Valid modifiers for strings are 'px', 'mm', "
-                     "'pt' and 'em'.",
-                     g_value_get_string (&value));
-          retval = 0;
+          g_value_init (value, G_TYPE_POINTER);
+          g_value_set_pointer (value, info);
         }
+      else
+        g_slice_free (RotationInfo, info);
     }
-  else
+  else if (strcmp (name, "behaviours") == 0)
     {
-      g_warning ("Invalid value of type '%s': integers, strings of floating "
-                 "point values can be used for the x, y, width, height "
-                 "anchor-x and anchor-y properties.",
-                 g_type_name (G_VALUE_TYPE (&value)));
-    }
-
-  g_value_unset (&value);
-
-  return retval;
-}
+      GSList *l;
 
-typedef struct {
-  ClutterRotateAxis axis;
+#ifdef CLUTTER_ENABLE_DEBUG
+      if (G_UNLIKELY (_clutter_diagnostic_enabled ()))
+        _clutter_diagnostic_message ("The 'behaviours' key is deprecated "
+                                     "and it should not be used in newly "
+                                     "written ClutterScript definitions.");
+#endif
 
-  gdouble angle;
+      l = parse_behaviours (script, actor, node);
 
-  gfloat center_x;
-  gfloat center_y;
-  gfloat center_z;
-} RotationInfo;
+      g_value_init (value, G_TYPE_POINTER);
+      g_value_set_pointer (value, l);
 
-static inline gboolean
-parse_rotation_array (ClutterActor *actor,
-                      JsonArray    *array,
-                      RotationInfo *info)
-{
-  JsonNode *element;
+      retval = TRUE;
+    }
+  else if (strcmp (name, "actions") == 0 ||
+           strcmp (name, "constraints") == 0 ||
+           strcmp (name, "effects") == 0)
+    {
+      GSList *l;
 
-  if (json_array_get_length (array) != 2)
-    return FALSE;
+      l = parse_actor_metas (script, actor, node);
 
-  /* angle */
-  element = json_array_get_element (array, 0);
-  if (JSON_NODE_TYPE (element) == JSON_NODE_VALUE)
-    info->angle = json_node_get_double (element);
-  else
-    return FALSE;
+      g_value_init (value, G_TYPE_POINTER);
+      g_value_set_pointer (value, l);
 
-  /* center */
-  element = json_array_get_element (array, 1);
-  if (JSON_NODE_TYPE (element) == JSON_NODE_ARRAY)
+      retval = TRUE;
+    }
+  else if (strcmp (name, "margin") == 0)
     {
-      JsonArray *center = json_node_get_array (element);
-
-      if (json_array_get_length (center) != 2)
-        return FALSE;
+      ClutterMargin *margin = parse_margin (actor, node);
 
-      switch (info->axis)
+      if (margin)
         {
-        case CLUTTER_X_AXIS:
-          info->center_y = parse_units (actor, PARSE_Y,
-                                        json_array_get_element (center, 0));
-          info->center_z = parse_units (actor, PARSE_Y,
-                                        json_array_get_element (center, 1));
-          return TRUE;
-
-        case CLUTTER_Y_AXIS:
-          info->center_x = parse_units (actor, PARSE_X,
-                                        json_array_get_element (center, 0));
-          info->center_z = parse_units (actor, PARSE_X,
-                                        json_array_get_element (center, 1));
-          return TRUE;
-
-        case CLUTTER_Z_AXIS:
-          info->center_x = parse_units (actor, PARSE_X,
-                                        json_array_get_element (center, 0));
-          info->center_y = parse_units (actor, PARSE_Y,
-                                        json_array_get_element (center, 1));
-          return TRUE;
+          g_value_init (value, CLUTTER_TYPE_MARGIN);
+          g_value_set_boxed (value, margin);
+          retval = TRUE;
         }
     }
 
-  return FALSE;
+  return retval;
 }
-
-static gboolean
-parse_rotation (ClutterActor *actor,
-                JsonNode     *node,
-                RotationInfo *info)
+
+static void
+clutter_actor_set_custom_property (ClutterScriptable *scriptable,
+                                   ClutterScript     *script,
+                                   const gchar       *name,
+                                   const GValue      *value)
 {
-  JsonArray *array;
-  guint len, i;
-  gboolean retval = FALSE;
+  ClutterActor *actor = CLUTTER_ACTOR (scriptable);
 
-  if (JSON_NODE_TYPE (node) != JSON_NODE_ARRAY)
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (G_UNLIKELY (CLUTTER_HAS_DEBUG (SCRIPT)))
     {
-      g_warning ("Invalid node of type '%s' found, expecting an array",
-                 json_node_type_name (node));
-      return FALSE;
-    }
+      gchar *tmp = g_strdup_value_contents (value);
 
-  array = json_node_get_array (node);
-  len = json_array_get_length (array);
+      CLUTTER_NOTE (SCRIPT,
+                    "in ClutterActor::set_custom_property('%s') = %s",
+                    name,
+                    tmp);
 
-  for (i = 0; i < len; i++)
+      g_free (tmp);
+    }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  if (strcmp (name, "rotation") == 0)
     {
-      JsonNode *element = json_array_get_element (array, i);
-      JsonObject *object;
-      JsonNode *member;
+      RotationInfo *info;
 
-      if (JSON_NODE_TYPE (element) != JSON_NODE_OBJECT)
-        {
-          g_warning ("Invalid node of type '%s' found, expecting an object",
-                     json_node_type_name (element));
-          return FALSE;
-        }
+      if (!G_VALUE_HOLDS (value, G_TYPE_POINTER))
+        return;
 
-      object = json_node_get_object (element);
+      info = g_value_get_pointer (value);
 
-      if (json_object_has_member (object, "x-axis"))
-        {
-          member = json_object_get_member (object, "x-axis");
+      clutter_actor_set_rotation (actor,
+                                  info->axis, info->angle,
+                                  info->center_x,
+                                  info->center_y,
+                                  info->center_z);
 
-          info->axis = CLUTTER_X_AXIS;
+      g_slice_free (RotationInfo, info);
 
-          if (JSON_NODE_TYPE (member) == JSON_NODE_VALUE)
-            {
-              info->angle = json_node_get_double (member);
-              retval = TRUE;
-            }
-          else if (JSON_NODE_TYPE (member) == JSON_NODE_ARRAY)
-            retval = parse_rotation_array (actor,
-                                           json_node_get_array (member),
-                                           info);
-          else
-            retval = FALSE;
-        }
-      else if (json_object_has_member (object, "y-axis"))
-        {
-          member = json_object_get_member (object, "y-axis");
+      return;
+    }
 
-          info->axis = CLUTTER_Y_AXIS;
+  if (strcmp (name, "behaviours") == 0)
+    {
+      GSList *behaviours, *l;
 
-          if (JSON_NODE_TYPE (member) == JSON_NODE_VALUE)
-            {
-              info->angle = json_node_get_double (member);
-              retval = TRUE;
-            }
-          else if (JSON_NODE_TYPE (member) == JSON_NODE_ARRAY)
-            retval = parse_rotation_array (actor,
-                                           json_node_get_array (member),
-                                           info);
-          else
-            retval = FALSE;
-        }
-      else if (json_object_has_member (object, "z-axis"))
-        {
-          member = json_object_get_member (object, "z-axis");
+      if (!G_VALUE_HOLDS (value, G_TYPE_POINTER))
+        return;
 
-          info->axis = CLUTTER_Z_AXIS;
+      behaviours = g_value_get_pointer (value);
+      for (l = behaviours; l != NULL; l = l->next)
+        {
+          ClutterBehaviour *behaviour = l->data;
 
-          if (JSON_NODE_TYPE (member) == JSON_NODE_VALUE)
-            {
-              info->angle = json_node_get_double (member);
-              retval = TRUE;
-            }
-          else if (JSON_NODE_TYPE (member) == JSON_NODE_ARRAY)
-            retval = parse_rotation_array (actor,
-                                           json_node_get_array (member),
-                                           info);
-          else
-            retval = FALSE;
+          clutter_behaviour_apply (behaviour, actor);
         }
-    }
 
-  return retval;
-}
+      g_slist_free (behaviours);
 
-static GSList *
-parse_actor_metas (ClutterScript *script,
-                   ClutterActor  *actor,
-                   JsonNode      *node)
-{
-  GList *elements, *l;
-  GSList *retval = NULL;
+      return;
+    }
 
-  if (!JSON_NODE_HOLDS_ARRAY (node))
-    return NULL;
+  if (strcmp (name, "actions") == 0 ||
+      strcmp (name, "constraints") == 0 ||
+      strcmp (name, "effects") == 0)
+    {
+      GSList *metas, *l;
 
-  elements = json_array_get_elements (json_node_get_array (node));
+      if (!G_VALUE_HOLDS (value, G_TYPE_POINTER))
+        return;
 
-  for (l = elements; l != NULL; l = l->next)
-    {
-      JsonNode *element = l->data;
-      const gchar *id_ = _clutter_script_get_id_from_node (element);
-      GObject *meta;
+      metas = g_value_get_pointer (value);
+      for (l = metas; l != NULL; l = l->next)
+        {
+          if (name[0] == 'a')
+            clutter_actor_add_action (actor, l->data);
 
-      if (id_ == NULL || *id_ == '\0')
-        continue;
+          if (name[0] == 'c')
+            clutter_actor_add_constraint (actor, l->data);
 
-      meta = clutter_script_get_object (script, id_);
-      if (meta == NULL)
-        continue;
+          if (name[0] == 'e')
+            clutter_actor_add_effect (actor, l->data);
+        }
 
-      retval = g_slist_prepend (retval, meta);
+      g_slist_free (metas);
+
+      return;
+    }
+  if (strcmp (name, "margin") == 0)
+    {
+      clutter_actor_set_margin (actor, g_value_get_boxed (value));
+      return;
     }
 
-  g_list_free (elements);
+  g_object_set_property (G_OBJECT (scriptable), name, value);
+}
 
-  return g_slist_reverse (retval);
+static void
+clutter_scriptable_iface_init (ClutterScriptableIface *iface)
+{
+  iface->parse_custom_node = clutter_actor_parse_custom_node;
+  iface->set_custom_property = clutter_actor_set_custom_property;
 }
 
-static GSList *
-parse_behaviours (ClutterScript *script,
-                  ClutterActor  *actor,
-                  JsonNode      *node)
+static ClutterActorMeta *
+get_meta_from_animation_property (ClutterActor  *actor,
+                                  const gchar   *name,
+                                  gchar        **name_p)
 {
-  GList *elements, *l;
-  GSList *retval = NULL;
+  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorMeta *meta = NULL;
+  gchar **tokens;
 
-  if (!JSON_NODE_HOLDS_ARRAY (node))
+  /* if this is not a special property, fall through */
+  if (name[0] != '@')
     return NULL;
 
-  elements = json_array_get_elements (json_node_get_array (node));
+  /* detect the properties named using the following spec:
+   *
+   *   @<section>.<meta-name>.<property-name>
+   *
+   * where <section> can be one of the following:
+   *
+   *   - actions
+   *   - constraints
+   *   - effects
+   *
+   * and <meta-name> is the name set on a specific ActorMeta
+   */
 
-  for (l = elements; l != NULL; l = l->next)
+  tokens = g_strsplit (name + 1, ".", -1);
+  if (tokens == NULL || g_strv_length (tokens) != 3)
     {
-      JsonNode *element = l->data;
-      const gchar *id_ = _clutter_script_get_id_from_node (element);
-      GObject *behaviour;
+      CLUTTER_NOTE (ANIMATION, "Invalid property name '%s'",
+                    name + 1);
+      g_strfreev (tokens);
+      return NULL;
+    }
 
-      if (id_ == NULL || *id_ == '\0')
-        continue;
+  if (strcmp (tokens[0], "actions") == 0)
+    meta = _clutter_meta_group_get_meta (priv->actions, tokens[1]);
 
-      behaviour = clutter_script_get_object (script, id_);
-      if (behaviour == NULL)
-        continue;
+  if (strcmp (tokens[0], "constraints") == 0)
+    meta = _clutter_meta_group_get_meta (priv->constraints, tokens[1]);
 
-      retval = g_slist_prepend (retval, behaviour);
-    }
+  if (strcmp (tokens[0], "effects") == 0)
+    meta = _clutter_meta_group_get_meta (priv->effects, tokens[1]);
 
-  g_list_free (elements);
+  if (name_p != NULL)
+    *name_p = g_strdup (tokens[2]);
 
-  return g_slist_reverse (retval);
+  CLUTTER_NOTE (ANIMATION,
+                "Looking for property '%s' of object '%s' in section '%s'",
+                tokens[2],
+                tokens[1],
+                tokens[0]);
+
+  g_strfreev (tokens);
+
+  return meta;
 }
 
-static ClutterMargin *
-parse_margin (ClutterActor *self,
-              JsonNode     *node)
+static GParamSpec *
+clutter_actor_find_property (ClutterAnimatable *animatable,
+                             const gchar       *property_name)
 {
-  ClutterMargin *margin;
-  JsonArray *array;
+  ClutterActorMeta *meta = NULL;
+  GObjectClass *klass = NULL;
+  GParamSpec *pspec = NULL;
+  gchar *p_name = NULL;
 
-  if (!JSON_NODE_HOLDS_ARRAY (node))
-    {
-      g_warning ("The margin property must be an array of 1 to 4 elements");
-      return NULL;
-    }
+  meta = get_meta_from_animation_property (CLUTTER_ACTOR (animatable),
+                                           property_name,
+                                           &p_name);
 
-  margin = clutter_margin_new ();
-  array = json_node_get_array (node);
-  switch (json_array_get_length (array))
+  if (meta != NULL)
     {
-    case 1:
-      margin->top = margin->right = margin->bottom = margin->left =
-        parse_units (self, 0, json_array_get_element (array, 0));
-      break;
+      klass = G_OBJECT_GET_CLASS (meta);
 
-    case 2:
-      margin->top = margin->bottom =
-        parse_units (self, 0, json_array_get_element (array, 0));
-      margin->right = margin->left =
-        parse_units (self, 0, json_array_get_element (array, 1));
-      break;
+      pspec = g_object_class_find_property (klass, p_name);
+    }
+  else
+    {
+      klass = G_OBJECT_GET_CLASS (animatable);
 
-    case 3:
-      margin->top =
-        parse_units (self, 0, json_array_get_element (array, 0));
-      margin->right = margin->left =
-        parse_units (self, 0, json_array_get_element (array, 1));
-      margin->bottom =
-        parse_units (self, 0, json_array_get_element (array, 2));
-      break;
+      pspec = g_object_class_find_property (klass, property_name);
+    }
 
-    case 4:
-      margin->top =
-        parse_units (self, 0, json_array_get_element (array, 0));
-      margin->right =
-        parse_units (self, 0, json_array_get_element (array, 1));
-      margin->bottom =
-        parse_units (self, 0, json_array_get_element (array, 2));
-      margin->left =
-        parse_units (self, 0, json_array_get_element (array, 3));
-      break;
+  g_free (p_name);
 
-    default:
-      g_warning ("The margin property must be an array of 1 to 4 elements");
-      clutter_margin_free (margin);
-      return NULL;
-    }
-  return margin;
+  return pspec;
 }
 
-static gboolean
-clutter_actor_parse_custom_node (ClutterScriptable *scriptable,
-                                 ClutterScript     *script,
-                                 GValue            *value,
-                                 const gchar       *name,
-                                 JsonNode          *node)
+static void
+clutter_actor_get_initial_state (ClutterAnimatable *animatable,
+                                 const gchar       *property_name,
+                                 GValue            *initial)
 {
-  ClutterActor *actor = CLUTTER_ACTOR (scriptable);
-  gboolean retval = FALSE;
+  ClutterActorMeta *meta = NULL;
+  gchar *p_name = NULL;
 
-  if ((name[0] == 'x' && name[1] == '\0') ||
-      (name[0] == 'y' && name[1] == '\0') ||
-      (strcmp (name, "width") == 0) ||
-      (strcmp (name, "height") == 0) ||
-      (strcmp (name, "anchor_x") == 0) ||
-      (strcmp (name, "anchor_y") == 0))
-    {
-      ParseDimension dimension;
-      gfloat units;
+  meta = get_meta_from_animation_property (CLUTTER_ACTOR (animatable),
+                                           property_name,
+                                           &p_name);
 
-      if (name[0] == 'x')
-        dimension = PARSE_X;
-      else if (name[0] == 'y')
-        dimension = PARSE_Y;
-      else if (name[0] == 'w')
-        dimension = PARSE_WIDTH;
-      else if (name[0] == 'h')
-        dimension = PARSE_HEIGHT;
-      else if (name[0] == 'a' && name[7] == 'x')
-        dimension = PARSE_ANCHOR_X;
-      else if (name[0] == 'a' && name[7] == 'y')
-        dimension = PARSE_ANCHOR_Y;
-      else
-        return FALSE;
+  if (meta != NULL)
+    g_object_get_property (G_OBJECT (meta), p_name, initial);
+  else
+    g_object_get_property (G_OBJECT (animatable), property_name, initial);
 
-      units = parse_units (actor, dimension, node);
+  g_free (p_name);
+}
 
-      /* convert back to pixels: all properties are pixel-based */
-      g_value_init (value, G_TYPE_FLOAT);
-      g_value_set_float (value, units);
+/*
+ * clutter_actor_set_animatable_property:
+ * @actor: a #ClutterActor
+ * @prop_id: the paramspec id
+ * @value: the value to set
+ * @pspec: the paramspec
+ *
+ * Sets values of animatable properties.
+ *
+ * This is a variant of clutter_actor_set_property() that gets called
+ * by the #ClutterAnimatable implementation of #ClutterActor for the
+ * properties with the %CLUTTER_PARAM_ANIMATABLE flag set on their
+ * #GParamSpec.
+ *
+ * Unlike the implementation of #GObjectClass.set_property(), this
+ * function will not update the interval if a transition involving an
+ * animatable property is in progress - this avoids cycles with the
+ * transition API calling the public API.
+ */
+static void
+clutter_actor_set_animatable_property (ClutterActor *actor,
+                                       guint         prop_id,
+                                       const GValue *value,
+                                       GParamSpec   *pspec)
+{
+  GObject *obj = G_OBJECT (actor);
 
-      retval = TRUE;
-    }
-  else if (strcmp (name, "rotation") == 0)
+  g_object_freeze_notify (obj);
+
+  switch (prop_id)
     {
-      RotationInfo *info;
+    case PROP_X:
+      clutter_actor_set_x_internal (actor, g_value_get_float (value));
+      break;
 
-      info = g_slice_new0 (RotationInfo);
-      retval = parse_rotation (actor, node, info);
+    case PROP_Y:
+      clutter_actor_set_y_internal (actor, g_value_get_float (value));
+      break;
 
-      if (retval)
-        {
-          g_value_init (value, G_TYPE_POINTER);
-          g_value_set_pointer (value, info);
-        }
-      else
-        g_slice_free (RotationInfo, info);
-    }
-  else if (strcmp (name, "behaviours") == 0)
-    {
-      GSList *l;
+    case PROP_POSITION:
+      clutter_actor_set_position_internal (actor, g_value_get_boxed (value));
+      break;
 
-#ifdef CLUTTER_ENABLE_DEBUG
-      if (G_UNLIKELY (_clutter_diagnostic_enabled ()))
-        _clutter_diagnostic_message ("The 'behaviours' key is deprecated "
-                                     "and it should not be used in newly "
-                                     "written ClutterScript definitions.");
-#endif
+    case PROP_WIDTH:
+      clutter_actor_set_width_internal (actor, g_value_get_float (value));
+      break;
 
-      l = parse_behaviours (script, actor, node);
+    case PROP_HEIGHT:
+      clutter_actor_set_height_internal (actor, g_value_get_float (value));
+      break;
 
-      g_value_init (value, G_TYPE_POINTER);
-      g_value_set_pointer (value, l);
+    case PROP_SIZE:
+      clutter_actor_set_size_internal (actor, g_value_get_boxed (value));
+      break;
 
-      retval = TRUE;
-    }
-  else if (strcmp (name, "actions") == 0 ||
-           strcmp (name, "constraints") == 0 ||
-           strcmp (name, "effects") == 0)
-    {
-      GSList *l;
+    case PROP_ALLOCATION:
+      clutter_actor_allocate_internal (actor,
+                                       g_value_get_boxed (value),
+                                       actor->priv->allocation_flags);
+      clutter_actor_queue_redraw (actor);
+      break;
 
-      l = parse_actor_metas (script, actor, node);
+    case PROP_DEPTH:
+      clutter_actor_set_depth_internal (actor, g_value_get_float (value));
+      break;
 
-      g_value_init (value, G_TYPE_POINTER);
-      g_value_set_pointer (value, l);
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position_internal (actor, g_value_get_float (value));
+      break;
 
-      retval = TRUE;
-    }
-  else if (strcmp (name, "margin") == 0)
-    {
-      ClutterMargin *margin = parse_margin (actor, node);
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (actor, g_value_get_uint (value));
+      break;
 
-      if (margin)
-        {
-          g_value_init (value, CLUTTER_TYPE_MARGIN);
-          g_value_set_boxed (value, margin);
-          retval = TRUE;
-        }
-    }
+    case PROP_BACKGROUND_COLOR:
+      clutter_actor_set_background_color_internal (actor, clutter_value_get_color (value));
+      break;
 
-  return retval;
-}
+    case PROP_PIVOT_POINT:
+      clutter_actor_set_pivot_point_internal (actor, g_value_get_boxed (value));
+      break;
 
-static void
-clutter_actor_set_custom_property (ClutterScriptable *scriptable,
-                                   ClutterScript     *script,
-                                   const gchar       *name,
-                                   const GValue      *value)
-{
-  ClutterActor *actor = CLUTTER_ACTOR (scriptable);
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z_internal (actor, g_value_get_float (value));
+      break;
 
-#ifdef CLUTTER_ENABLE_DEBUG
-  if (G_UNLIKELY (CLUTTER_HAS_DEBUG (SCRIPT)))
-    {
-      gchar *tmp = g_strdup_value_contents (value);
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (actor,
+                                              g_value_get_float (value),
+                                              pspec);
+      break;
 
-      CLUTTER_NOTE (SCRIPT,
-                    "in ClutterActor::set_custom_property('%s') = %s",
-                    name,
-                    tmp);
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (actor,
+                                               g_value_get_double (value),
+                                               pspec);
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (actor,
+                                                 g_value_get_double (value),
+                                                 pspec);
+      break;
 
-      g_free (tmp);
-    }
-#endif /* CLUTTER_ENABLE_DEBUG */
+    case PROP_CONTENT_BOX:
+      clutter_actor_store_content_box (actor, g_value_get_boxed (value));
+      break;
 
-  if (strcmp (name, "rotation") == 0)
-    {
-      RotationInfo *info;
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      clutter_actor_set_margin_internal (actor, g_value_get_float (value),
+                                         pspec);
+      break;
 
-      if (!G_VALUE_HOLDS (value, G_TYPE_POINTER))
-        return;
+    case PROP_TRANSFORM:
+      clutter_actor_set_transform_internal (actor, g_value_get_boxed (value));
+      break;
 
-      info = g_value_get_pointer (value);
+    case PROP_CHILD_TRANSFORM:
+      clutter_actor_set_child_transform_internal (actor, g_value_get_boxed (value));
+      break;
 
-      clutter_actor_set_rotation (actor,
-                                  info->axis, info->angle,
-                                  info->center_x,
-                                  info->center_y,
-                                  info->center_z);
+    default:
+      g_object_set_property (obj, pspec->name, value);
+      break;
+    }
 
-      g_slice_free (RotationInfo, info);
+  g_object_thaw_notify (obj);
+}
 
-      return;
-    }
+static void
+clutter_actor_set_final_state (ClutterAnimatable *animatable,
+                               const gchar       *property_name,
+                               const GValue      *final)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (animatable);
+  ClutterActorMeta *meta = NULL;
+  gchar *p_name = NULL;
 
-  if (strcmp (name, "behaviours") == 0)
+  meta = get_meta_from_animation_property (actor,
+                                           property_name,
+                                           &p_name);
+  if (meta != NULL)
+    g_object_set_property (G_OBJECT (meta), p_name, final);
+  else
     {
-      GSList *behaviours, *l;
+      GObjectClass *obj_class = G_OBJECT_GET_CLASS (animatable);
+      GParamSpec *pspec;
 
-      if (!G_VALUE_HOLDS (value, G_TYPE_POINTER))
-        return;
+      pspec = g_object_class_find_property (obj_class, property_name);
 
-      behaviours = g_value_get_pointer (value);
-      for (l = behaviours; l != NULL; l = l->next)
+      if (pspec != NULL)
         {
-          ClutterBehaviour *behaviour = l->data;
-
-          clutter_behaviour_apply (behaviour, actor);
+          if ((pspec->flags & CLUTTER_PARAM_ANIMATABLE) != 0)
+            {
+              /* XXX - I'm going to the special hell for this */
+              clutter_actor_set_animatable_property (actor, pspec->param_id, final, pspec);
+            }
+          else
+            g_object_set_property (G_OBJECT (animatable), pspec->name, final);
         }
-
-      g_slist_free (behaviours);
-
-      return;
     }
 
-  if (strcmp (name, "actions") == 0 ||
-      strcmp (name, "constraints") == 0 ||
-      strcmp (name, "effects") == 0)
-    {
-      GSList *metas, *l;
-
-      if (!G_VALUE_HOLDS (value, G_TYPE_POINTER))
-        return;
-
-      metas = g_value_get_pointer (value);
-      for (l = metas; l != NULL; l = l->next)
-        {
-          if (name[0] == 'a')
-            clutter_actor_add_action (actor, l->data);
+  g_free (p_name);
+}
 
-          if (name[0] == 'c')
-            clutter_actor_add_constraint (actor, l->data);
+/* the actors whose notifications are frozen until the end of the
+ * current frame; see _clutter_actor_set_scalar_animatable_property()
+ */
+static GPtrArray *notify_batch = NULL;
 
-          if (name[0] == 'e')
-            clutter_actor_add_effect (actor, l->data);
-        }
+static gboolean
+clutter_actor_flush_notify_batch (gpointer data G_GNUC_UNUSED)
+{
+  GPtrArray *actors = notify_batch;
+  guint i;
 
-      g_slist_free (metas);
+  /* thawing may emit notifications that start new transitions, which
+   * will go into a new batch
+   */
+  notify_batch = NULL;
 
-      return;
-    }
-  if (strcmp (name, "margin") == 0)
+  for (i = 0; i < actors->len; i++)
     {
-      clutter_actor_set_margin (actor, g_value_get_boxed (value));
-      return;
+      ClutterActor *actor = g_ptr_array_index (actors, i);
+
+      actor->priv->in_notify_batch = FALSE;
+      g_object_thaw_notify (G_OBJECT (actor));
     }
 
-  g_object_set_property (G_OBJECT (scriptable), name, value);
-}
+  g_ptr_array_unref (actors);
 
-static void
-clutter_scriptable_iface_init (ClutterScriptableIface *iface)
-{
-  iface->parse_custom_node = clutter_actor_parse_custom_node;
-  iface->set_custom_property = clutter_actor_set_custom_property;
+  return G_SOURCE_REMOVE;
 }
 
-static ClutterActorMeta *
-get_meta_from_animation_property (ClutterActor  *actor,
-                                  const gchar   *name,
-                                  gchar        **name_p)
+/*< private >
+ * _clutter_actor_get_scalar_animatable_property:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of an animatable property of @self
+ *
+ * Checks whether the property described by @pspec can be updated by
+ * a transition through _clutter_actor_set_scalar_animatable_property(),
+ * bypassing the #ClutterAnimatable interface and the #GValue machinery.
+ *
+ * This is only possible for the float, double and unsigned integer
+ * properties of #ClutterActor that only affect the transformation or
+ * the opacity of the actor, and only if the #ClutterAnimatable
+ * implementation of @self has not been overridden.
+ *
+ * Return value: the property id to pass to
+ *   _clutter_actor_set_scalar_animatable_property(), or 0
+ */
+guint
+_clutter_actor_get_scalar_animatable_property (ClutterActor *self,
+                                               GParamSpec   *pspec)
 {
-  ClutterActorPrivate *priv = actor->priv;
-  ClutterActorMeta *meta = NULL;
-  gchar **tokens;
+  ClutterAnimatableIface *iface;
 
-  /* if this is not a special property, fall through */
-  if (name[0] != '@')
-    return NULL;
+  if (pspec->owner_type != CLUTTER_TYPE_ACTOR)
+    return 0;
 
-  /* detect the properties named using the following spec:
-   *
-   *   @<section>.<meta-name>.<property-name>
-   *
-   * where <section> can be one of the following:
-   *
-   *   - actions
-   *   - constraints
-   *   - effects
-   *
-   * and <meta-name> is the name set on a specific ActorMeta
-   */
+  iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+  if (iface->set_final_state != clutter_actor_set_final_state ||
+      iface->interpolate_value != NULL)
+    return 0;
 
-  tokens = g_strsplit (name + 1, ".", -1);
-  if (tokens == NULL || g_strv_length (tokens) != 3)
+  switch (pspec->param_id)
     {
-      CLUTTER_NOTE (ANIMATION, "Invalid property name '%s'",
-                    name + 1);
-      g_strfreev (tokens);
-      return NULL;
+    case PROP_X:
+    case PROP_Y:
+    case PROP_Z_POSITION:
+    case PROP_OPACITY:
+    case PROP_PIVOT_POINT_Z:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      return pspec->param_id;
+
+    default:
+      return 0;
     }
+}
 
-  if (strcmp (tokens[0], "actions") == 0)
-    meta = _clutter_meta_group_get_meta (priv->actions, tokens[1]);
+/* checks whether @value is the current value of the property, with the
+ * precision used to store it
+ */
+static gboolean
+clutter_actor_scalar_property_equals (ClutterActor *self,
+                                      guint         prop_id,
+                                      gdouble       value)
+{
+  const ClutterTransformInfo *info;
+  const ClutterLayoutInfo *linfo;
 
-  if (strcmp (tokens[0], "constraints") == 0)
-    meta = _clutter_meta_group_get_meta (priv->constraints, tokens[1]);
+  switch (prop_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+      if (!self->priv->position_set)
+        return FALSE;
 
-  if (strcmp (tokens[0], "effects") == 0)
-    meta = _clutter_meta_group_get_meta (priv->effects, tokens[1]);
+      linfo = _clutter_actor_get_layout_info_or_defaults (self);
 
-  if (name_p != NULL)
-    *name_p = g_strdup (tokens[2]);
+      return prop_id == PROP_X ? linfo->fixed_pos.x == (float) value
+                               : linfo->fixed_pos.y == (float) value;
 
-  CLUTTER_NOTE (ANIMATION,
-                "Looking for property '%s' of object '%s' in section '%s'",
-                tokens[2],
-                tokens[1],
-                tokens[0]);
+    case PROP_OPACITY:
+      return self->priv->opacity == (guint8) value;
 
-  g_strfreev (tokens);
+    default:
+      break;
+    }
 
-  return meta;
-}
+  info = _clutter_actor_get_transform_info_or_defaults (self);
 
-static GParamSpec *
-clutter_actor_find_property (ClutterAnimatable *animatable,
-                             const gchar       *property_name)
-{
-  ClutterActorMeta *meta = NULL;
-  GObjectClass *klass = NULL;
-  GParamSpec *pspec = NULL;
-  gchar *p_name = NULL;
+  switch (prop_id)
+    {
+    case PROP_Z_POSITION:
+      return info->z_position == (float) value;
 
-  meta = get_meta_from_animation_property (CLUTTER_ACTOR (animatable),
-                                           property_name,
-                                           &p_name);
+    case PROP_PIVOT_POINT_Z:
+      return info->pivot_z == (float) value;
 
-  if (meta != NULL)
-    {
-      klass = G_OBJECT_GET_CLASS (meta);
+    case PROP_TRANSLATION_X:
+      return info->translation.x == (float) value;
 
-      pspec = g_object_class_find_property (klass, p_name);
-    }
-  else
-    {
-      klass = G_OBJECT_GET_CLASS (animatable);
+    case PROP_TRANSLATION_Y:
+      return info->translation.y == (float) value;
 
-      pspec = g_object_class_find_property (klass, property_name);
-    }
+    case PROP_TRANSLATION_Z:
+      return info->translation.z == (float) value;
 
-  g_free (p_name);
+    case PROP_SCALE_X:
+      return info->scale_x == value;
 
-  return pspec;
-}
+    case PROP_SCALE_Y:
+      return info->scale_y == value;
 
-static void
-clutter_actor_get_initial_state (ClutterAnimatable *animatable,
-                                 const gchar       *property_name,
-                                 GValue            *initial)
-{
-  ClutterActorMeta *meta = NULL;
-  gchar *p_name = NULL;
+    case PROP_SCALE_Z:
+      return info->scale_z == value;
 
-  meta = get_meta_from_animation_property (CLUTTER_ACTOR (animatable),
-                                           property_name,
-                                           &p_name);
+    case PROP_ROTATION_ANGLE_X:
+      return info->rx_angle == value;
 
-  if (meta != NULL)
-    g_object_get_property (G_OBJECT (meta), p_name, initial);
-  else
-    g_object_get_property (G_OBJECT (animatable), property_name, initial);
+    case PROP_ROTATION_ANGLE_Y:
+      return info->ry_angle == value;
 
-  g_free (p_name);
+    case PROP_ROTATION_ANGLE_Z:
+      return info->rz_angle == value;
+
+    default:
+      return FALSE;
+    }
 }
 
-/*
- * clutter_actor_set_animatable_property:
- * @actor: a #ClutterActor
- * @prop_id: the paramspec id
- * @value: the value to set
- * @pspec: the paramspec
- *
- * Sets values of animatable properties.
+/*< private >
+ * _clutter_actor_set_scalar_animatable_property:
+ * @self: a #ClutterActor
+ * @prop_id: the id returned by _clutter_actor_get_scalar_animatable_property()
+ * @pspec: the #GParamSpec of the property
+ * @value: the new value of the property
  *
- * This is a variant of clutter_actor_set_property() that gets called
- * by the #ClutterAnimatable implementation of #ClutterActor for the
- * properties with the %CLUTTER_PARAM_ANIMATABLE flag set on their
- * #GParamSpec.
+ * Sets the value of a property while it is being animated.
  *
- * Unlike the implementation of #GObjectClass.set_property(), this
- * function will not update the interval if a transition involving an
- * animatable property is in progress - this avoids cycles with the
- * transition API calling the public API.
+ * The notifications of @self are frozen until the end of the current
+ * frame, so that each property animated during a frame is notified
+ * once, after all the transitions have been advanced.
  */
-static void
-clutter_actor_set_animatable_property (ClutterActor *actor,
-                                       guint         prop_id,
-                                       const GValue *value,
-                                       GParamSpec   *pspec)
-{
-  GObject *obj = G_OBJECT (actor);
+void
+_clutter_actor_set_scalar_animatable_property (ClutterActor *self,
+                                               guint         prop_id,
+                                               GParamSpec   *pspec,
+                                               gdouble       value)
+{
+  /* slow transitions often compute the same value on consecutive
+   * frames, e.g. an opacity fading from 255 to 254; skipping them
+   * avoids queueing a redraw, so that the frame can be elided
+   */
+  if (clutter_actor_scalar_property_equals (self, prop_id, value))
+    return;
 
-  g_object_freeze_notify (obj);
+  if (!self->priv->in_notify_batch)
+    {
+      if (notify_batch == NULL)
+        {
+          notify_batch = g_ptr_array_new_with_free_func (g_object_unref);
+
+          clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT,
+                                                 clutter_actor_flush_notify_batch,
+                                                 NULL, NULL);
+
+          /* make sure the batch is flushed even if this happens
+           * outside of a frame
+           */
+          _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+        }
+
+      g_object_freeze_notify (G_OBJECT (self));
+      g_ptr_array_add (notify_batch, g_object_ref (self));
+      self->priv->in_notify_batch = TRUE;
+    }
 
   switch (prop_id)
     {
     case PROP_X:
-      clutter_actor_set_x_internal (actor, g_value_get_float (value));
+      clutter_actor_set_x_internal (self, value);
       break;
 
     case PROP_Y:
-      clutter_actor_set_y_internal (actor, g_value_get_float (value));
+      clutter_actor_set_y_internal (self, value);
       break;
 
-    case PROP_POSITION:
-      clutter_actor_set_position_internal (actor, g_value_get_boxed (value));
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position_internal (self, value);
       break;
 
-    case PROP_WIDTH:
-      clutter_actor_set_width_internal (actor, g_value_get_float (value));
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (self, (guint) value);
       break;
 
-    case PROP_HEIGHT:
-      clutter_actor_set_height_internal (actor, g_value_get_float (value));
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z_internal (self, value);
       break;
 
-    case PROP_SIZE:
-      clutter_actor_set_size_internal (actor, g_value_get_boxed (value));
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (self, value, pspec);
       break;
 
-    case PROP_ALLOCATION:
-      clutter_actor_allocate_internal (actor,
-                                       g_value_get_boxed (value),
-                                       actor->priv->allocation_flags);
-      clutter_actor_queue_redraw (actor);
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (self, value, pspec);
       break;
 
-    case PROP_DEPTH:
-      clutter_actor_set_depth_internal (actor, g_value_get_float (value));
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (self, value, pspec);
       break;
 
-    case PROP_Z_POSITION:
-      clutter_actor_set_z_position_internal (actor, g_value_get_float (value));
-      break;
+    default:
+      g_assert_not_reached ();
+    }
+}
 
-    case PROP_OPACITY:
-      clutter_actor_set_opacity_internal (actor, g_value_get_uint (value));
-      break;
+/*< private >
+ * _clutter_actor_queue_paint_time_sample:
+ * @self: a #ClutterActor
+ * @prop_id: the id returned by _clutter_actor_get_scalar_animatable_property()
+ *
+ * Asks the stage of @self to sample the paint time transitions of @self
+ * before painting the next frame.
+ *
+ * Return value: %FALSE if the property cannot be sampled at paint time,
+ *   and has to be set through _clutter_actor_set_scalar_animatable_property()
+ */
+gboolean
+_clutter_actor_queue_paint_time_sample (ClutterActor *self,
+                                        guint         prop_id)
+{
+  ClutterActor *stage;
 
-    case PROP_BACKGROUND_COLOR:
-      clutter_actor_set_background_color_internal (actor, clutter_value_get_color (value));
-      break;
+  /* the position affects the layout, which has already been computed
+   * by the time we sample the transitions
+   */
+  if (prop_id == PROP_X || prop_id == PROP_Y)
+    return FALSE;
 
-    case PROP_PIVOT_POINT:
-      clutter_actor_set_pivot_point_internal (actor, g_value_get_boxed (value));
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  _clutter_stage_queue_paint_time_sample (CLUTTER_STAGE (stage), self);
+
+  return TRUE;
+}
+
+/* updates the transformation or the opacity of the actor without
+ * emitting notifications; the property will be notified at the end
+ * of the transition
+ */
+static void
+clutter_actor_set_paint_time_property (ClutterActor *self,
+                                       guint         prop_id,
+                                       gdouble       value)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterTransformInfo *info;
+
+  if (clutter_actor_scalar_property_equals (self, prop_id, value))
+    return;
+
+  if (prop_id == PROP_OPACITY)
+    {
+      priv->opacity = (guint8) value;
+      _clutter_actor_queue_redraw_full (self, 0, NULL,
+                                        clutter_actor_get_offscreen_info_or_defaults (self)->flatten_effect);
+      return;
+    }
+
+  info = _clutter_actor_get_transform_info (self);
+
+  switch (prop_id)
+    {
+    case PROP_Z_POSITION:
+      info->z_position = value;
+      clutter_actor_update_z_order (self);
       break;
 
     case PROP_PIVOT_POINT_Z:
-      clutter_actor_set_pivot_point_z_internal (actor, g_value_get_float (value));
+      info->pivot_z = value;
       break;
 
     case PROP_TRANSLATION_X:
+      info->translation.x = value;
+      break;
+
     case PROP_TRANSLATION_Y:
+      info->translation.y = value;
+      break;
+
     case PROP_TRANSLATION_Z:
-      clutter_actor_set_translation_internal (actor,
-                                              g_value_get_float (value),
-                                              pspec);
+      info->translation.z = value;
       break;
 
     case PROP_SCALE_X:
-    case PROP_SCALE_Y:
-    case PROP_SCALE_Z:
-      clutter_actor_set_scale_factor_internal (actor,
-                                               g_value_get_double (value),
-                                               pspec);
+      info->scale_x = value;
       break;
 
-    case PROP_ROTATION_ANGLE_X:
-    case PROP_ROTATION_ANGLE_Y:
-    case PROP_ROTATION_ANGLE_Z:
-      clutter_actor_set_rotation_angle_internal (actor,
-                                                 g_value_get_double (value),
-                                                 pspec);
+    case PROP_SCALE_Y:
+      info->scale_y = value;
       break;
 
-    case PROP_CONTENT_BOX:
-      clutter_actor_store_content_box (actor, g_value_get_boxed (value));
+    case PROP_SCALE_Z:
+      info->scale_z = value;
       break;
 
-    case PROP_MARGIN_TOP:
-    case PROP_MARGIN_BOTTOM:
-    case PROP_MARGIN_LEFT:
-    case PROP_MARGIN_RIGHT:
-      clutter_actor_set_margin_internal (actor, g_value_get_float (value),
-                                         pspec);
+    case PROP_ROTATION_ANGLE_X:
+      info->rx_angle = value;
       break;
 
-    case PROP_TRANSFORM:
-      clutter_actor_set_transform_internal (actor, g_value_get_boxed (value));
+    case PROP_ROTATION_ANGLE_Y:
+      info->ry_angle = value;
       break;
 
-    case PROP_CHILD_TRANSFORM:
-      clutter_actor_set_child_transform_internal (actor, g_value_get_boxed (value));
+    case PROP_ROTATION_ANGLE_Z:
+      info->rz_angle = value;
       break;
 
     default:
-      g_object_set_property (obj, pspec->name, value);
-      break;
+      g_assert_not_reached ();
     }
 
-  g_object_thaw_notify (obj);
+  clutter_actor_invalidate_transform (self);
+  clutter_actor_queue_redraw (self);
 }
 
-static void
-clutter_actor_set_final_state (ClutterAnimatable *animatable,
-                               const gchar       *property_name,
-                               const GValue      *final)
+/*< private >
+ * _clutter_actor_sample_paint_time_transitions:
+ * @self: a #ClutterActor
+ * @frame_time: the time of the frame, in milliseconds
+ *
+ * Updates the transformation and the opacity of @self using the value
+ * that its paint time transitions have at @frame_time.
+ *
+ * This function is called by the stage after the layout of the frame
+ * has been computed, and before the redraw clip is computed.
+ */
+void
+_clutter_actor_sample_paint_time_transitions (ClutterActor *self,
+                                              gint64        frame_time)
 {
-  ClutterActor *actor = CLUTTER_ACTOR (animatable);
-  ClutterActorMeta *meta = NULL;
-  gchar *p_name = NULL;
+  const ClutterAnimationInfo *info;
+  GHashTableIter iter;
+  gpointer value;
 
-  meta = get_meta_from_animation_property (actor,
-                                           property_name,
-                                           &p_name);
-  if (meta != NULL)
-    g_object_set_property (G_OBJECT (meta), p_name, final);
-  else
+  info = _clutter_actor_get_animation_info_or_defaults (self);
+  if (info->transitions == NULL)
+    return;
+
+  g_hash_table_iter_init (&iter, info->transitions);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
     {
-      GObjectClass *obj_class = G_OBJECT_GET_CLASS (animatable);
-      GParamSpec *pspec;
+      TransitionClosure *clos = value;
+      ClutterPropertyTransition *transition;
+      guint prop_id;
+      gdouble res;
 
-      pspec = g_object_class_find_property (obj_class, property_name);
+      if (!CLUTTER_IS_PROPERTY_TRANSITION (clos->transition))
+        continue;
 
-      if (pspec != NULL)
-        {
-          if ((pspec->flags & CLUTTER_PARAM_ANIMATABLE) != 0)
-            {
-              /* XXX - I'm going to the special hell for this */
-              clutter_actor_set_animatable_property (actor, pspec->param_id, final, pspec);
-            }
-          else
-            g_object_set_property (G_OBJECT (animatable), pspec->name, final);
-        }
-    }
+      transition = CLUTTER_PROPERTY_TRANSITION (clos->transition);
 
-  g_free (p_name);
+      if (_clutter_property_transition_sample (transition, frame_time,
+                                               &prop_id,
+                                               &res))
+        clutter_actor_set_paint_time_property (self, prop_id, res);
+    }
 }
 
 static void
@@ -15802,6 +19816,20 @@ clutter_actor_get_pango_context (ClutterActor *self)
  */
 PangoContext *
 clutter_actor_create_pango_context (ClutterActor *self)
+{
+  return _clutter_create_pango_context ();
+}
+
+/*< private >
+ * _clutter_create_pango_context:
+ *
+ * Creates a #PangoContext configured using the font map, resolution
+ * and font options of the default #ClutterBackend.
+ *
+ * Return value: (transfer full): the newly created #PangoContext
+ */
+PangoContext *
+_clutter_create_pango_context (void)
 {
   CoglPangoFontMap *font_map;
   PangoContext *context;
@@ -16173,16 +20201,20 @@ clutter_actor_set_flags (ClutterActor      *self,
   visible_set  = ((self->flags & CLUTTER_ACTOR_VISIBLE)  != 0);
 
   if (reactive_set != was_reactive_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_REACTIVE]);
+    {
+      clutter_actor_update_reactive_descendants (self, reactive_set ? 1 : -1);
+      clutter_actor_invalidate_pick_cache (self);
+      clutter_actor_notify (self, obj_props[PROP_REACTIVE]);
+    }
 
   if (realized_set != was_realized_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_REALIZED]);
+    clutter_actor_notify (self, obj_props[PROP_REALIZED]);
 
   if (mapped_set != was_mapped_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_MAPPED]);
+    clutter_actor_notify (self, obj_props[PROP_MAPPED]);
 
   if (visible_set != was_visible_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_VISIBLE]);
+    clutter_actor_notify (self, obj_props[PROP_VISIBLE]);
 
   g_object_thaw_notify (obj);
   g_object_unref (obj);
@@ -16233,16 +20265,20 @@ clutter_actor_unset_flags (ClutterActor      *self,
   visible_set  = ((self->flags & CLUTTER_ACTOR_VISIBLE)  != 0);
 
   if (reactive_set != was_reactive_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_REACTIVE]);
+    {
+      clutter_actor_update_reactive_descendants (self, reactive_set ? 1 : -1);
+      clutter_actor_invalidate_pick_cache (self);
+      clutter_actor_notify (self, obj_props[PROP_REACTIVE]);
+    }
 
   if (realized_set != was_realized_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_REALIZED]);
+    clutter_actor_notify (self, obj_props[PROP_REALIZED]);
 
   if (mapped_set != was_mapped_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_MAPPED]);
+    clutter_actor_notify (self, obj_props[PROP_MAPPED]);
 
   if (visible_set != was_visible_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_VISIBLE]);
+    clutter_actor_notify (self, obj_props[PROP_VISIBLE]);
 
   g_object_thaw_notify (obj);
 }
@@ -16283,14 +20319,14 @@ clutter_actor_set_transform_internal (ClutterActor        *self,
   info->transform = *transform;
   info->transform_set = !cogl_matrix_is_identity (&info->transform);
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_TRANSFORM]);
+  clutter_actor_notify (self, obj_props[PROP_TRANSFORM]);
 
   if (was_set != info->transform_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_TRANSFORM_SET]);
+    clutter_actor_notify (self, obj_props[PROP_TRANSFORM_SET]);
 }
 
 /**
@@ -16430,7 +20466,7 @@ clutter_actor_set_text_direction (ClutterActor         *self,
        * the text direction; see clutter_text_direction_changed_cb()
        * inside clutter-text.c
        */
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_TEXT_DIRECTION]);
+      clutter_actor_notify (self, obj_props[PROP_TEXT_DIRECTION]);
 
       _clutter_actor_foreach_child (self, set_direction_recursive,
                                     GINT_TO_POINTER (text_dir));
@@ -16449,7 +20485,7 @@ _clutter_actor_set_has_pointer (ClutterActor *self,
     {
       priv->has_pointer = has_pointer;
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_HAS_POINTER]);
+      clutter_actor_notify (self, obj_props[PROP_HAS_POINTER]);
     }
 }
 
@@ -16685,7 +20721,7 @@ clutter_actor_add_action (ClutterActor  *self,
 
   _clutter_meta_group_add_meta (priv->actions, CLUTTER_ACTOR_META (action));
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ACTIONS]);
+  clutter_actor_notify (self, obj_props[PROP_ACTIONS]);
 }
 
 /**
@@ -16749,7 +20785,7 @@ clutter_actor_remove_action (ClutterActor  *self,
   if (_clutter_meta_group_peek_metas (priv->actions) == NULL)
     g_clear_object (&priv->actions);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ACTIONS]);
+  clutter_actor_notify (self, obj_props[PROP_ACTIONS]);
 }
 
 /**
@@ -16783,7 +20819,7 @@ clutter_actor_remove_action_by_name (ClutterActor *self,
 
   _clutter_meta_group_remove_meta (priv->actions, meta);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ACTIONS]);
+  clutter_actor_notify (self, obj_props[PROP_ACTIONS]);
 }
 
 /**
@@ -16891,7 +20927,7 @@ clutter_actor_add_constraint (ClutterActor      *self,
                                 CLUTTER_ACTOR_META (constraint));
   clutter_actor_queue_relayout (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONSTRAINTS]);
+  clutter_actor_notify (self, obj_props[PROP_CONSTRAINTS]);
 }
 
 /**
@@ -16958,7 +20994,7 @@ clutter_actor_remove_constraint (ClutterActor      *self,
 
   clutter_actor_queue_relayout (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONSTRAINTS]);
+  clutter_actor_notify (self, obj_props[PROP_CONSTRAINTS]);
 }
 
 /**
@@ -17094,8 +21130,8 @@ clutter_actor_set_clip_to_allocation (ClutterActor *self,
 
       clutter_actor_queue_redraw (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CLIP_TO_ALLOCATION]);
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_HAS_CLIP]);
+      clutter_actor_notify (self, obj_props[PROP_CLIP_TO_ALLOCATION]);
+      clutter_actor_notify (self, obj_props[PROP_HAS_CLIP]);
     }
 }
 
@@ -17141,7 +21177,7 @@ clutter_actor_add_effect (ClutterActor  *self,
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_EFFECT]);
+  clutter_actor_notify (self, obj_props[PROP_EFFECT]);
 }
 
 /**
@@ -17197,7 +21233,7 @@ clutter_actor_remove_effect (ClutterActor  *self,
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_EFFECT]);
+  clutter_actor_notify (self, obj_props[PROP_EFFECT]);
 }
 
 /**
@@ -17449,23 +21485,74 @@ _clutter_actor_get_paint_volume_real (ClutterActor *self,
   return TRUE;
 }
 
+/*< private >
+ * clutter_actor_invalidate_paint_volume:
+ * @self: a #ClutterActor
+ *
+ * Drops the cached paint volume of @self, and the ones of its
+ * ancestors, which include the volume of @self transformed into
+ * their coordinate space.
+ */
+static void
+clutter_actor_invalidate_paint_volume (ClutterActor *self)
+{
+  ClutterActor *iter;
+
+  /* an actor whose volume is not cached can still be part of the
+   * cached volume of its parent, so we always walk up to the top
+   */
+  for (iter = self; iter != NULL; iter = iter->priv->parent)
+    iter->priv->paint_volume_cached = FALSE;
+}
+
+/* the volume computed by the default implementation only depends on
+ * the allocation, the clip, and the volumes and transformations of
+ * the mapped children, which all invalidate it when they change; the
+ * effects can make the volume depend on the paint sequence, and the
+ * handlers of the paint signal can appear at any time
+ */
+static inline gboolean
+clutter_actor_can_cache_paint_volume (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  return !priv->needs_allocation &&
+         priv->effects == NULL &&
+         CLUTTER_ACTOR_GET_CLASS (self)->get_paint_volume == clutter_actor_real_get_paint_volume &&
+         !g_signal_has_handler_pending (self, actor_signals[PAINT], 0, TRUE);
+}
+
 /* The public clutter_actor_get_paint_volume API returns a const
  * pointer since we return a pointer directly to the cached
  * PaintVolume associated with the actor and don't want the user to
  * inadvertently modify it, but for internal uses we sometimes need
  * access to the same PaintVolume but need to apply some book-keeping
  * modifications to it so we don't want a const pointer.
+ *
+ * The volumes of the actors using the default implementation are kept
+ * until clutter_actor_invalidate_paint_volume() is called on them or
+ * on one of their descendants, so a container only transforms again
+ * the cached volumes of its children, and only the children that
+ * changed compute their volume again.
  */
 static ClutterPaintVolume *
 _clutter_actor_get_paint_volume_mutable (ClutterActor *self)
 {
   ClutterActorPrivate *priv;
+  gboolean can_cache;
 
   priv = self->priv;
 
+  can_cache = clutter_actor_can_cache_paint_volume (self);
+
+  if (priv->paint_volume_cached && can_cache)
+    return priv->paint_volume_valid ? &priv->paint_volume : NULL;
+
   if (priv->paint_volume_valid)
     clutter_paint_volume_free (&priv->paint_volume);
 
+  priv->paint_volume_cached = can_cache;
+
   if (_clutter_actor_get_paint_volume_real (self, &priv->paint_volume))
     {
       priv->paint_volume_valid = TRUE;
@@ -17727,6 +21814,21 @@ clutter_actor_get_n_children (ClutterActor *self)
   return self->priv->n_children;
 }
 
+/*< private >
+ * _clutter_actor_get_children_age:
+ * @self: a #ClutterActor
+ *
+ * Retrieves a counter that changes every time a child is added to or
+ * removed from @self, including when the children are reordered.
+ *
+ * Return value: the age of the list of children of @self
+ */
+gint
+_clutter_actor_get_children_age (ClutterActor *self)
+{
+  return self->priv->age;
+}
+
 /**
  * clutter_actor_get_child_at_index:
  * @self: a #ClutterActor
@@ -17997,7 +22099,7 @@ clutter_actor_set_layout_manager (ClutterActor         *self,
 
   clutter_actor_queue_relayout (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_LAYOUT_MANAGER]);
+  clutter_actor_notify (self, obj_props[PROP_LAYOUT_MANAGER]);
 }
 
 /**
@@ -18029,13 +22131,6 @@ static const ClutterLayoutInfo default_layout_info = {
   CLUTTER_SIZE_INIT_ZERO,       /* natural */
 };
 
-static void
-layout_info_free (gpointer data)
-{
-  if (G_LIKELY (data != NULL))
-    g_slice_free (ClutterLayoutInfo, data);
-}
-
 /*< private >
  * _clutter_actor_peek_layout_info:
  * @self: a #ClutterActor
@@ -18049,7 +22144,7 @@ layout_info_free (gpointer data)
 ClutterLayoutInfo *
 _clutter_actor_peek_layout_info (ClutterActor *self)
 {
-  return g_object_get_qdata (G_OBJECT (self), quark_actor_layout_info);
+  return self->priv->layout_info;
 }
 
 /*< private >
@@ -18071,21 +22166,16 @@ _clutter_actor_peek_layout_info (ClutterActor *self)
 ClutterLayoutInfo *
 _clutter_actor_get_layout_info (ClutterActor *self)
 {
-  ClutterLayoutInfo *retval;
+  ClutterActorPrivate *priv = self->priv;
 
-  retval = _clutter_actor_peek_layout_info (self);
-  if (retval == NULL)
+  if (priv->layout_info == NULL)
     {
-      retval = g_slice_new (ClutterLayoutInfo);
+      priv->layout_info = g_slice_new (ClutterLayoutInfo);
 
-      *retval = default_layout_info;
-
-      g_object_set_qdata_full (G_OBJECT (self), quark_actor_layout_info,
-                               retval,
-                               layout_info_free);
+      *priv->layout_info = default_layout_info;
     }
 
-  return retval;
+  return priv->layout_info;
 }
 
 /*< private >
@@ -18141,7 +22231,7 @@ clutter_actor_set_x_align (ClutterActor      *self,
 
       clutter_actor_queue_relayout (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_X_ALIGN]);
+      clutter_actor_notify (self, obj_props[PROP_X_ALIGN]);
     }
 }
 
@@ -18192,7 +22282,7 @@ clutter_actor_set_y_align (ClutterActor      *self,
 
       clutter_actor_queue_relayout (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_Y_ALIGN]);
+      clutter_actor_notify (self, obj_props[PROP_Y_ALIGN]);
     }
 }
 
@@ -18234,7 +22324,7 @@ clutter_actor_set_margin_internal (ClutterActor *self,
     info->margin.left = margin;
 
   clutter_actor_queue_relayout (self);
-  g_object_notify_by_pspec (G_OBJECT (self), pspec);
+  clutter_actor_notify (self, pspec);
 }
 
 /**
@@ -18486,8 +22576,8 @@ clutter_actor_set_background_color_internal (ClutterActor *self,
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR_SET]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR]);
+  clutter_actor_notify (self, obj_props[PROP_BACKGROUND_COLOR_SET]);
+  clutter_actor_notify (self, obj_props[PROP_BACKGROUND_COLOR]);
 }
 
 /**
@@ -18526,7 +22616,7 @@ clutter_actor_set_background_color (ClutterActor       *self,
 
       clutter_actor_queue_redraw (self);
 
-      g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR_SET]);
+      clutter_actor_notify (self, obj_props[PROP_BACKGROUND_COLOR_SET]);
     }
   else
     _clutter_actor_create_transition (self,
@@ -18892,29 +22982,22 @@ static const ClutterAnimationInfo default_animation_info = {
 };
 
 static void
-clutter_animation_info_free (gpointer data)
+clutter_animation_info_free (ClutterAnimationInfo *info)
 {
-  if (data != NULL)
-    {
-      ClutterAnimationInfo *info = data;
+  if (info->transitions != NULL)
+    g_hash_table_unref (info->transitions);
 
-      if (info->transitions != NULL)
-        g_hash_table_unref (info->transitions);
+  if (info->states != NULL)
+    g_array_unref (info->states);
 
-      if (info->states != NULL)
-        g_array_unref (info->states);
-
-      g_slice_free (ClutterAnimationInfo, info);
-    }
+  g_slice_free (ClutterAnimationInfo, info);
 }
 
 const ClutterAnimationInfo *
 _clutter_actor_get_animation_info_or_defaults (ClutterActor *self)
 {
-  const ClutterAnimationInfo *res;
-  GObject *obj = G_OBJECT (self);
+  const ClutterAnimationInfo *res = self->priv->animation_info;
 
-  res = g_object_get_qdata (obj, quark_actor_animation_info);
   if (res != NULL)
     return res;
 
@@ -18924,22 +23007,16 @@ _clutter_actor_get_animation_info_or_defaults (ClutterActor *self)
 ClutterAnimationInfo *
 _clutter_actor_get_animation_info (ClutterActor *self)
 {
-  GObject *obj = G_OBJECT (self);
-  ClutterAnimationInfo *res;
+  ClutterActorPrivate *priv = self->priv;
 
-  res = g_object_get_qdata (obj, quark_actor_animation_info);
-  if (res == NULL)
+  if (priv->animation_info == NULL)
     {
-      res = g_slice_new (ClutterAnimationInfo);
-
-      *res = default_animation_info;
+      priv->animation_info = g_slice_new (ClutterAnimationInfo);
 
-      g_object_set_qdata_full (obj, quark_actor_animation_info,
-                               res,
-                               clutter_animation_info_free);
+      *priv->animation_info = default_animation_info;
     }
 
-  return res;
+  return priv->animation_info;
 }
 
 ClutterTransition *
@@ -19311,6 +23388,10 @@ _clutter_actor_create_transition (ClutterActor *actor,
       res = clos->transition;
     }
 
+  if (CLUTTER_IS_PROPERTY_TRANSITION (res))
+    _clutter_property_transition_set_paint_time (CLUTTER_PROPERTY_TRANSITION (res),
+                                                 info->cur_state->easing_paint_time);
+
 out:
   if (call_restore)
     clutter_actor_restore_easing_state (actor);
@@ -19614,6 +23695,75 @@ clutter_actor_get_easing_delay (ClutterActor *self)
   return 0;
 }
 
+/**
+ * clutter_actor_set_easing_paint_time:
+ * @self: a #ClutterActor
+ * @paint_time: whether the transitions should be sampled at paint time
+ *
+ * Sets whether the transitions of the properties controlling the
+ * transformation and the opacity of @self should be sampled by the
+ * stage when painting each frame, instead of being set on each frame
+ * of their timeline.
+ *
+ * The stage samples the transitions after processing the events and
+ * computing the layout of the frame, so the animation reflects the
+ * time at which the frame is actually painted, and the intermediate
+ * values bypass the property system: the #GObject::notify signal of
+ * the animated properties is only emitted once the transitions end,
+ * and the accessors return the value used by the last painted frame.
+ *
+ * The transitions on the #ClutterActor:x and #ClutterActor:y properties,
+ * as well as the transitions of actors not inside a #ClutterStage, are
+ * not affected.
+ *
+ * Since: 1.26
+ */
+void
+clutter_actor_set_easing_paint_time (ClutterActor *self,
+                                     gboolean      paint_time)
+{
+  ClutterAnimationInfo *info;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  info = _clutter_actor_get_animation_info (self);
+
+  if (info->cur_state == NULL)
+    {
+      g_warning ("You must call clutter_actor_save_easing_state() prior "
+                 "to calling clutter_actor_set_easing_paint_time().");
+      return;
+    }
+
+  info->cur_state->easing_paint_time = !!paint_time;
+}
+
+/**
+ * clutter_actor_get_easing_paint_time:
+ * @self: a #ClutterActor
+ *
+ * Retrieves whether the transitions of @self are sampled at paint time,
+ * as set by clutter_actor_set_easing_paint_time().
+ *
+ * Return value: %TRUE if the transitions are sampled at paint time
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_actor_get_easing_paint_time (ClutterActor *self)
+{
+  const ClutterAnimationInfo *info;
+
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  info = _clutter_actor_get_animation_info_or_defaults (self);
+
+  if (info->cur_state != NULL)
+    return info->cur_state->easing_paint_time;
+
+  return FALSE;
+}
+
 /**
  * clutter_actor_get_transition:
  * @self: a #ClutterActor
@@ -19698,6 +23848,7 @@ clutter_actor_save_easing_state (ClutterActor *self)
   new_state.easing_mode = CLUTTER_EASE_OUT_CUBIC;
   new_state.easing_duration = 250;
   new_state.easing_delay = 0;
+  new_state.easing_paint_time = FALSE;
 
   g_array_append_val (info->states, new_state);
 
@@ -19787,7 +23938,7 @@ clutter_actor_set_content (ClutterActor   *self,
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT]);
+  clutter_actor_notify (self, obj_props[PROP_CONTENT]);
 
   /* if the content gravity is not resize-fill, and the new content has a
    * different preferred size than the previous one, then the content box
@@ -19795,7 +23946,7 @@ clutter_actor_set_content (ClutterActor   *self,
    * here, and let whomever watches :content-box do whatever they need to
    * do.
    */
-  if (priv->content_gravity != CLUTTER_CONTENT_GRAVITY_RESIZE_FILL)
+  if (clutter_actor_get_content_info_or_defaults (self)->content_gravity != CLUTTER_CONTENT_GRAVITY_RESIZE_FILL)
     {
       if (priv->content_box_valid)
         {
@@ -19813,7 +23964,7 @@ clutter_actor_set_content (ClutterActor   *self,
                                               &to_box);
         }
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT_BOX]);
+      clutter_actor_notify (self, obj_props[PROP_CONTENT_BOX]);
    }
 }
 
@@ -19861,14 +24012,14 @@ clutter_actor_set_content_gravity (ClutterActor *self,
 
   priv = self->priv;
 
-  if (priv->content_gravity == gravity)
+  if (clutter_actor_get_content_info_or_defaults (self)->content_gravity == gravity)
     return;
 
   priv->content_box_valid = FALSE;
 
   clutter_actor_get_content_box (self, &from_box);
 
-  priv->content_gravity = gravity;
+  clutter_actor_get_content_info (self)->content_gravity = gravity;
 
   clutter_actor_get_content_box (self, &to_box);
 
@@ -19876,7 +24027,7 @@ clutter_actor_set_content_gravity (ClutterActor *self,
                                     &from_box,
                                     &to_box);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CONTENT_GRAVITY]);
+  clutter_actor_notify (self, obj_props[PROP_CONTENT_GRAVITY]);
 }
 
 /**
@@ -19896,7 +24047,7 @@ clutter_actor_get_content_gravity (ClutterActor *self)
   g_return_val_if_fail (CLUTTER_IS_ACTOR (self),
                         CLUTTER_CONTENT_GRAVITY_RESIZE_FILL);
 
-  return self->priv->content_gravity;
+  return clutter_actor_get_content_info_or_defaults (self)->content_gravity;
 }
 
 /**
@@ -19925,6 +24076,7 @@ void
 clutter_actor_get_content_box (ClutterActor    *self,
                                ClutterActorBox *box)
 {
+  const ContentInfo *info;
   ClutterActorPrivate *priv;
   gfloat content_w, content_h;
   gfloat alloc_w, alloc_h;
@@ -19933,6 +24085,7 @@ clutter_actor_get_content_box (ClutterActor    *self,
   g_return_if_fail (box != NULL);
 
   priv = self->priv;
+  info = clutter_actor_get_content_info_or_defaults (self);
 
   box->x1 = 0.f;
   box->y1 = 0.f;
@@ -19941,12 +24094,12 @@ clutter_actor_get_content_box (ClutterActor    *self,
 
   if (priv->content_box_valid)
     {
-      *box = priv->content_box;
+      *box = info->content_box;
       return;
     }
 
   /* no need to do any more work */
-  if (priv->content_gravity == CLUTTER_CONTENT_GRAVITY_RESIZE_FILL)
+  if (info->content_gravity == CLUTTER_CONTENT_GRAVITY_RESIZE_FILL)
     return;
 
   if (priv->content == NULL)
@@ -19963,7 +24116,7 @@ clutter_actor_get_content_box (ClutterActor    *self,
   alloc_w = box->x2;
   alloc_h = box->y2;
 
-  switch (priv->content_gravity)
+  switch (info->content_gravity)
     {
     case CLUTTER_CONTENT_GRAVITY_TOP_LEFT:
       box->x2 = box->x1 + MIN (content_w, alloc_w);
@@ -20116,37 +24269,37 @@ clutter_actor_set_content_scaling_filters (ClutterActor         *self,
                                            ClutterScalingFilter  min_filter,
                                            ClutterScalingFilter  mag_filter)
 {
-  ClutterActorPrivate *priv;
-  gboolean changed;
+  const ContentInfo *old_info;
+  ContentInfo *info;
   GObject *obj;
 
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-  priv = self->priv;
+  old_info = clutter_actor_get_content_info_or_defaults (self);
+  if (old_info->min_filter == min_filter &&
+      old_info->mag_filter == mag_filter)
+    return;
+
+  info = clutter_actor_get_content_info (self);
   obj = G_OBJECT (self);
 
   g_object_freeze_notify (obj);
 
-  changed = FALSE;
-
-  if (priv->min_filter != min_filter)
+  if (info->min_filter != min_filter)
     {
-      priv->min_filter = min_filter;
-      changed = TRUE;
+      info->min_filter = min_filter;
 
-      g_object_notify_by_pspec (obj, obj_props[PROP_MINIFICATION_FILTER]);
+      clutter_actor_notify (self, obj_props[PROP_MINIFICATION_FILTER]);
     }
 
-  if (priv->mag_filter != mag_filter)
+  if (info->mag_filter != mag_filter)
     {
-      priv->mag_filter = mag_filter;
-      changed = TRUE;
+      info->mag_filter = mag_filter;
 
-      g_object_notify_by_pspec (obj, obj_props[PROP_MAGNIFICATION_FILTER]);
+      clutter_actor_notify (self, obj_props[PROP_MAGNIFICATION_FILTER]);
     }
 
-  if (changed)
-    clutter_actor_queue_redraw (self);
+  clutter_actor_queue_redraw (self);
 
   g_object_thaw_notify (obj);
 }
@@ -20171,10 +24324,10 @@ clutter_actor_get_content_scaling_filters (ClutterActor         *self,
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
   if (min_filter != NULL)
-    *min_filter = self->priv->min_filter;
+    *min_filter = clutter_actor_get_content_info_or_defaults (self)->min_filter;
 
   if (mag_filter != NULL)
-    *mag_filter = self->priv->mag_filter;
+    *mag_filter = clutter_actor_get_content_info_or_defaults (self)->mag_filter;
 }
 
 /*
@@ -20246,8 +24399,7 @@ clutter_actor_set_x_expand (ClutterActor *self,
 
       clutter_actor_queue_compute_expand (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self),
-                                obj_props[PROP_X_EXPAND]);
+      clutter_actor_notify (self, obj_props[PROP_X_EXPAND]);
     }
 }
 
@@ -20305,8 +24457,7 @@ clutter_actor_set_y_expand (ClutterActor *self,
 
       clutter_actor_queue_compute_expand (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self),
-                                obj_props[PROP_Y_EXPAND]);
+      clutter_actor_notify (self, obj_props[PROP_Y_EXPAND]);
     }
 }
 
@@ -20465,10 +24616,10 @@ clutter_actor_set_content_repeat (ClutterActor         *self,
 {
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
-  if (self->priv->content_repeat == repeat)
+  if (clutter_actor_get_content_info_or_defaults (self)->content_repeat == repeat)
     return;
 
-  self->priv->content_repeat = repeat;
+  clutter_actor_get_content_info (self)->content_repeat = repeat;
 
   clutter_actor_queue_redraw (self);
 }
@@ -20489,14 +24640,14 @@ clutter_actor_get_content_repeat (ClutterActor *self)
 {
   g_return_val_if_fail (CLUTTER_IS_ACTOR (self), CLUTTER_REPEAT_NONE);
 
-  return self->priv->content_repeat;
+  return clutter_actor_get_content_info_or_defaults (self)->content_repeat;
 }
 
 void
 _clutter_actor_handle_event (ClutterActor       *self,
                              const ClutterEvent *event)
 {
-  GPtrArray *event_tree;
+  GPtrArray *capture_tree, *bubble_tree;
   ClutterActor *iter;
   gboolean is_key_event;
   gint i = 0;
@@ -20508,10 +24659,17 @@ _clutter_actor_handle_event (ClutterActor       *self,
   is_key_event = event->type == CLUTTER_KEY_PRESS ||
                  event->type == CLUTTER_KEY_RELEASE;
 
-  event_tree = g_ptr_array_sized_new (64);
-  g_ptr_array_set_free_func (event_tree, (GDestroyNotify) g_object_unref);
+  capture_tree = g_ptr_array_sized_new (16);
+  g_ptr_array_set_free_func (capture_tree, (GDestroyNotify) g_object_unref);
 
-  /* build the list of of emitters for the event */
+  bubble_tree = g_ptr_array_sized_new (16);
+  g_ptr_array_set_free_func (bubble_tree, (GDestroyNotify) g_object_unref);
+
+  /* build the list of of emitters for the event; the actors without
+   * handlers for the event would only return FALSE, so we leave them
+   * out, and the handlers connected during the emission will only
+   * see the next event
+   */
   iter = self;
   while (iter != NULL)
     {
@@ -20524,24 +24682,29 @@ _clutter_actor_handle_event (ClutterActor       *self,
           /* keep a reference on the actor, so that it remains valid
            * for the duration of the signal emission
            */
-          g_ptr_array_add (event_tree, g_object_ref (iter));
+          if (clutter_actor_has_event_handlers (iter, event, TRUE))
+            g_ptr_array_add (capture_tree, g_object_ref (iter));
+
+          if (clutter_actor_has_event_handlers (iter, event, FALSE))
+            g_ptr_array_add (bubble_tree, g_object_ref (iter));
         }
 
       iter = parent;
     }
 
   /* Capture: from top-level downwards */
-  for (i = event_tree->len - 1; i >= 0; i--)
-    if (clutter_actor_event (g_ptr_array_index (event_tree, i), event, TRUE))
+  for (i = capture_tree->len - 1; i >= 0; i--)
+    if (clutter_actor_event (g_ptr_array_index (capture_tree, i), event, TRUE))
       goto done;
 
   /* Bubble: from source upwards */
-  for (i = 0; i < event_tree->len; i++)
-    if (clutter_actor_event (g_ptr_array_index (event_tree, i), event, FALSE))
+  for (i = 0; i < bubble_tree->len; i++)
+    if (clutter_actor_event (g_ptr_array_index (bubble_tree, i), event, FALSE))
       goto done;
 
 done:
-  g_ptr_array_free (event_tree, TRUE);
+  g_ptr_array_free (capture_tree, TRUE);
+  g_ptr_array_free (bubble_tree, TRUE);
 }
 
 static void
@@ -20562,15 +24725,15 @@ clutter_actor_set_child_transform_internal (ClutterActor        *self,
   /* we need to reset the transform_valid flag on each child */
   clutter_actor_iter_init (&iter, self);
   while (clutter_actor_iter_next (&iter, &child))
-    child->priv->transform_valid = FALSE;
+    clutter_actor_invalidate_transform (child);
 
   clutter_actor_queue_redraw (self);
 
   obj = G_OBJECT (self);
-  g_object_notify_by_pspec (obj, obj_props[PROP_CHILD_TRANSFORM]);
+  clutter_actor_notify (self, obj_props[PROP_CHILD_TRANSFORM]);
 
   if (was_set != info->child_transform_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_CHILD_TRANSFORM_SET]);
+    clutter_actor_notify (self, obj_props[PROP_CHILD_TRANSFORM_SET]);
 }
 
 /**
@@ -20712,11 +24875,27 @@ _clutter_actor_queue_redraw_on_clones (ClutterActor *self)
   if (priv->clones == NULL)
     return;
 
+  priv->clone_damage_serial += 1;
+
   g_hash_table_iter_init (&iter, priv->clones);
   while (g_hash_table_iter_next (&iter, &key, NULL))
     clutter_actor_queue_redraw (key);
 }
 
+/*< private >
+ * _clutter_actor_get_clone_damage_serial:
+ * @self: a #ClutterActor
+ *
+ * Retrieves a counter that changes every time the actor, or any of its
+ * children, queues a redraw while the actor has clones; the clones can
+ * use it to know whether what they paint of the actor is still valid.
+ */
+guint
+_clutter_actor_get_clone_damage_serial (ClutterActor *self)
+{
+  return self->priv->clone_damage_serial;
+}
+
 void
 _clutter_actor_queue_relayout_on_clones (ClutterActor *self)
 {
@@ -21061,7 +25240,10 @@ clutter_actor_create_texture_paint_node (ClutterActor *self,
                                          CoglTexture  *texture)
 {
   ClutterActorPrivate *priv = clutter_actor_get_instance_private (self);
+  ClutterScalingFilter min_filter, mag_filter;
+  const ContentInfo *info;
   ClutterPaintNode *node;
+  ClutterActor *stage;
   ClutterActorBox box;
   ClutterColor color;
 
@@ -21070,6 +25252,19 @@ clutter_actor_create_texture_paint_node (ClutterActor *self,
 
   clutter_actor_get_content_box (self, &box);
 
+  info = clutter_actor_get_content_info_or_defaults (self);
+  min_filter = info->min_filter;
+  mag_filter = info->mag_filter;
+
+  /* filtering is the first thing to go when the frames are too slow */
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage != NULL &&
+      _clutter_stage_get_quality_level (CLUTTER_STAGE (stage)) >= CLUTTER_QUALITY_LOW)
+    {
+      min_filter = CLUTTER_SCALING_FILTER_NEAREST;
+      mag_filter = CLUTTER_SCALING_FILTER_NEAREST;
+    }
+
   /* ClutterTextureNode will premultiply the blend color, so we
    * want it to be white with the paint opacity
    */
@@ -21078,19 +25273,23 @@ clutter_actor_create_texture_paint_node (ClutterActor *self,
   color.blue = 255;
   color.alpha = clutter_actor_get_paint_opacity_internal (self);
 
-  node = clutter_texture_node_new (texture, &color, priv->min_filter, priv->mag_filter);
+  node = clutter_texture_node_new (texture, &color, min_filter, mag_filter);
   clutter_paint_node_set_name (node, "Texture");
 
-  if (priv->content_repeat == CLUTTER_REPEAT_NONE)
+  if (priv->content_effects != NULL)
+    _clutter_offscreen_effect_apply_pointwise (priv->content_effects,
+                                               _clutter_pipeline_node_get_pipeline (node));
+
+  if (info->content_repeat == CLUTTER_REPEAT_NONE)
     clutter_paint_node_add_rectangle (node, &box);
   else
     {
       float t_w = 1.f, t_h = 1.f;
 
-      if ((priv->content_repeat & CLUTTER_REPEAT_X_AXIS) != FALSE)
+      if ((info->content_repeat & CLUTTER_REPEAT_X_AXIS) != FALSE)
         t_w = (box.x2 - box.x1) / cogl_texture_get_width (texture);
 
-      if ((priv->content_repeat & CLUTTER_REPEAT_Y_AXIS) != FALSE)
+      if ((info->content_repeat & CLUTTER_REPEAT_Y_AXIS) != FALSE)
         t_h = (box.y2 - box.y1) / cogl_texture_get_height (texture);
 
       clutter_paint_node_add_texture_rectangle (node, &box,
@@ -21100,3 +25299,311 @@ clutter_actor_create_texture_paint_node (ClutterActor *self,
 
   return node;
 }
+
+/* registers @self with its stage if its visibility needs to be
+ * evaluated, or unregisters it if it was evaluated before
+ */
+static void
+clutter_actor_update_visibility_tracker (ClutterActor *self,
+                                         gboolean      was_tracked)
+{
+  ClutterActorPrivate *priv = self->priv;
+  gboolean is_tracked;
+  ClutterActor *stage;
+
+  is_tracked = priv->track_visibility || priv->pause_offscreen_transitions;
+  if (is_tracked == was_tracked)
+    return;
+
+  if (!CLUTTER_ACTOR_IS_MAPPED (self))
+    return;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return;
+
+  if (is_tracked)
+    {
+      _clutter_stage_add_visibility_tracker (CLUTTER_STAGE (stage), self);
+
+      /* make sure that the state is evaluated */
+      clutter_actor_queue_redraw (stage);
+    }
+  else
+    _clutter_stage_remove_visibility_tracker (CLUTTER_STAGE (stage), self);
+}
+
+/**
+ * clutter_actor_set_track_visibility:
+ * @self: a #ClutterActor
+ * @track: whether to track the visibility of @self
+ *
+ * Sets whether the stage should keep the #ClutterActor:on-screen
+ * property of @self up to date.
+ *
+ * When tracking is enabled, the visibility of @self is evaluated at
+ * the end of every frame painted by its stage, using the same data as
+ * the culling of the paint: @self is on screen if it is mapped, its
+ * paint opacity is not zero, it was not hidden behind an opaque actor,
+ * and its paint box intersects the stage and the clip of each of its
+ * ancestors, for instance the visible area of a #ClutterScrollActor.
+ *
+ * The changes that happen during a frame, for instance while an actor
+ * is scrolled across the edge of the stage, are coalesced, and the
+ * #ClutterActor:on-screen property is notified at most once per frame.
+ * This makes it suitable for loading and releasing heavy content
+ * lazily, or for pausing the animations of actors that are not seen.
+ *
+ * Since: 1.26
+ */
+void
+clutter_actor_set_track_visibility (ClutterActor *self,
+                                    gboolean      track)
+{
+  ClutterActorPrivate *priv;
+  gboolean was_tracked;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  priv = self->priv;
+
+  if (priv->track_visibility == !!track)
+    return;
+
+  was_tracked = priv->track_visibility || priv->pause_offscreen_transitions;
+
+  priv->track_visibility = !!track;
+
+  clutter_actor_update_visibility_tracker (self, was_tracked);
+
+  clutter_actor_notify (self, obj_props[PROP_TRACK_VISIBILITY]);
+}
+
+/**
+ * clutter_actor_get_track_visibility:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the value set with clutter_actor_set_track_visibility().
+ *
+ * Return value: %TRUE if the visibility of @self is tracked
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_actor_get_track_visibility (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  return self->priv->track_visibility;
+}
+
+/**
+ * clutter_actor_is_on_screen:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the value of the #ClutterActor:on-screen property.
+ *
+ * The value is only kept up to date for the actors whose visibility is
+ * tracked; see clutter_actor_set_track_visibility().
+ *
+ * Return value: %TRUE if @self was visible in the last frame
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_actor_is_on_screen (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  return self->priv->on_screen;
+}
+
+static inline gboolean
+intersect_paint_box (ClutterActorBox       *box,
+                     const ClutterActorBox *clip)
+{
+  box->x1 = MAX (box->x1, clip->x1);
+  box->y1 = MAX (box->y1, clip->y1);
+  box->x2 = MIN (box->x2, clip->x2);
+  box->y2 = MIN (box->y2, clip->y2);
+
+  return box->x1 < box->x2 && box->y1 < box->y2;
+}
+
+static gboolean
+clutter_actor_compute_on_screen (ClutterActor *self,
+                                 ClutterActor *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box, clip;
+  ClutterActor *iter;
+
+  if (!CLUTTER_ACTOR_IS_MAPPED (self))
+    return FALSE;
+
+  if (clutter_actor_get_paint_opacity_internal (self) == 0)
+    return FALSE;
+
+  /* hidden behind an opaque actor during the last paint */
+  if (priv->occlusion_serial != 0 &&
+      priv->occlusion_serial == occlusion_serial)
+    return FALSE;
+
+  /* without a paint volume the actor could be painting anywhere */
+  if (!clutter_actor_get_paint_box (self, &box))
+    return TRUE;
+
+  clip.x1 = 0.f;
+  clip.y1 = 0.f;
+  clip.x2 = clutter_actor_get_width (stage);
+  clip.y2 = clutter_actor_get_height (stage);
+
+  if (!intersect_paint_box (&box, &clip))
+    return FALSE;
+
+  /* the paint box of an ancestor that clips its children is its
+   * visible area on the stage
+   */
+  for (iter = priv->parent; iter != NULL && iter != stage; iter = iter->priv->parent)
+    {
+      if (!iter->priv->clip_to_allocation && !iter->priv->has_clip)
+        continue;
+
+      if (clutter_actor_get_paint_box (iter, &clip) &&
+          !intersect_paint_box (&box, &clip))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_update_on_screen:
+ * @self: a #ClutterActor whose visibility is tracked
+ *
+ * Evaluates the visibility of @self after a frame has been painted,
+ * and notifies the #ClutterActor:on-screen property if it changed.
+ */
+void
+_clutter_actor_update_on_screen (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+  gboolean on_screen;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return;
+
+  on_screen = clutter_actor_compute_on_screen (self, stage);
+  if (priv->on_screen == on_screen)
+    return;
+
+  CLUTTER_NOTE (PAINT, "Actor '%s' is now %s",
+                _clutter_actor_get_debug_name (self),
+                on_screen ? "on screen" : "off screen");
+
+  priv->on_screen = on_screen;
+
+  /* the clock might have stopped, if it only had suspended timelines */
+  if (on_screen && priv->pause_offscreen_transitions)
+    _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+
+  clutter_actor_notify (self, obj_props[PROP_ON_SCREEN]);
+}
+
+/**
+ * clutter_actor_set_pause_offscreen_transitions:
+ * @self: a #ClutterActor
+ * @pause: whether to pause the transitions of the children of @self
+ *   while @self is not on screen
+ *
+ * Sets whether the transitions of the descendants of @self should be
+ * suspended while @self is not visible, as defined by the
+ * #ClutterActor:on-screen property; for instance, because @self was
+ * scrolled out of the visible area of a #ClutterScrollActor, was moved
+ * outside of the stage, or is inside a transparent or hidden branch of
+ * the scene graph.
+ *
+ * Suspended transitions are not advanced, so they do not update the
+ * properties of their actors, nor queue redraws. When @self becomes
+ * visible again, they catch up with the time that has passed while
+ * they were suspended, and continue from where they would have been.
+ *
+ * The transitions of @self itself are never suspended, as they could
+ * be the ones making @self visible; for the same reason, the
+ * descendants of @self should not use transitions to move into the
+ * visible area of @self.
+ *
+ * The visibility of @self is evaluated at the end of each frame, as
+ * if clutter_actor_set_track_visibility() was called.
+ *
+ * Since: 1.26
+ */
+void
+clutter_actor_set_pause_offscreen_transitions (ClutterActor *self,
+                                               gboolean      pause)
+{
+  ClutterActorPrivate *priv;
+  gboolean was_tracked;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  priv = self->priv;
+
+  if (priv->pause_offscreen_transitions == !!pause)
+    return;
+
+  was_tracked = priv->track_visibility || priv->pause_offscreen_transitions;
+
+  priv->pause_offscreen_transitions = !!pause;
+
+  clutter_actor_update_visibility_tracker (self, was_tracked);
+
+  /* resume the transitions that were suspended */
+  if (!priv->pause_offscreen_transitions)
+    _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+}
+
+/**
+ * clutter_actor_get_pause_offscreen_transitions:
+ * @self: a #ClutterActor
+ *
+ * Retrieves the value set with clutter_actor_set_pause_offscreen_transitions().
+ *
+ * Return value: %TRUE if the transitions of the descendants of @self
+ *   are paused while @self is not on screen
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_actor_get_pause_offscreen_transitions (ClutterActor *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_ACTOR (self), FALSE);
+
+  return self->priv->pause_offscreen_transitions;
+}
+
+/*< private >
+ * _clutter_actor_get_transitions_suspended:
+ * @self: a #ClutterActor
+ *
+ * Checks whether the transitions of @self should not be advanced,
+ * because an ancestor of @self pauses the transitions of its
+ * descendants and was not on screen in the last frame.
+ *
+ * Return value: %TRUE if the transitions of @self are suspended
+ */
+gboolean
+_clutter_actor_get_transitions_suspended (ClutterActor *self)
+{
+  ClutterActor *iter;
+
+  for (iter = self->priv->parent; iter != NULL; iter = iter->priv->parent)
+    {
+      if (iter->priv->pause_offscreen_transitions && !iter->priv->on_screen)
+        return TRUE;
+    }
+
+  return FALSE;
+}
@@ -322,6 +322,29 @@ struct _ClutterActorIter
   gpointer CLUTTER_PRIVATE_FIELD (dummy5);
 };
 
+/**
+ * ClutterLayoutStats:
+ * @n_measures: the number of calls to the #ClutterActorClass.get_preferred_width()
+ *   and #ClutterActorClass.get_preferred_height() virtual functions
+ * @n_measure_cache_hits: the number of size requests returned from the
+ *   cache of the actors, without calling the virtual functions
+ * @n_allocations: the number of calls to the #ClutterActorClass.allocate()
+ *   virtual function
+ * @n_relayout_roots: the number of relayouts started from a stage or
+ *   from a relayout boundary; see clutter_actor_set_relayout_boundary()
+ *
+ * The layout work done by the actors; see clutter_actor_get_layout_stats().
+ *
+ * Since: 1.26
+ */
+struct _ClutterLayoutStats
+{
+  guint n_measures;
+  guint n_measure_cache_hits;
+  guint n_allocations;
+  guint n_relayout_roots;
+};
+
 CLUTTER_AVAILABLE_IN_ALL
 GType clutter_actor_get_type (void) G_GNUC_CONST;
 
@@ -359,8 +382,29 @@ void                            clutter_actor_queue_redraw_with_clip
                                                                                  const cairo_rectangle_int_t *clip);
 CLUTTER_AVAILABLE_IN_ALL
 void                            clutter_actor_queue_relayout                    (ClutterActor                *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_set_relayout_boundary             (ClutterActor                *self,
+                                                                                 gboolean                     boundary);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_get_relayout_boundary             (ClutterActor                *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_get_layout_stats                  (ClutterLayoutStats          *stats);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_set_track_visibility              (ClutterActor                *self,
+                                                                                 gboolean                     track);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_get_track_visibility              (ClutterActor                *self);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_is_on_screen                      (ClutterActor                *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_set_pause_offscreen_transitions   (ClutterActor                *self,
+                                                                                 gboolean                     pause);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_get_pause_offscreen_transitions   (ClutterActor                *self);
 CLUTTER_AVAILABLE_IN_ALL
 void                            clutter_actor_destroy                           (ClutterActor                *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_destroy_deferred                  (ClutterActor                *self);
 CLUTTER_AVAILABLE_IN_ALL
 void                            clutter_actor_set_name                          (ClutterActor                *self,
                                                                                  const gchar                 *name);
@@ -685,6 +729,20 @@ CLUTTER_AVAILABLE_IN_1_10
 void                            clutter_actor_remove_all_children               (ClutterActor               *self);
 CLUTTER_AVAILABLE_IN_1_10
 void                            clutter_actor_destroy_all_children              (ClutterActor               *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_destroy_all_children_deferred     (ClutterActor               *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_add_children                      (ClutterActor               *self,
+                                                                                 ClutterActor              **children,
+                                                                                 guint                       n_children);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_remove_children_range             (ClutterActor               *self,
+                                                                                 gint                        index_,
+                                                                                 gint                        n_children);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_freeze_layout                     (ClutterActor               *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_thaw_layout                       (ClutterActor               *self);
 CLUTTER_AVAILABLE_IN_1_10
 GList *                         clutter_actor_get_children                      (ClutterActor               *self);
 CLUTTER_AVAILABLE_IN_1_10
@@ -719,6 +777,11 @@ CLUTTER_AVAILABLE_IN_1_10
 void                            clutter_actor_set_child_at_index                (ClutterActor               *self,
                                                                                  ClutterActor               *child,
                                                                                  gint                        index_);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_set_sort_children_by_z            (ClutterActor               *self,
+                                                                                 gboolean                    sort);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_get_sort_children_by_z            (ClutterActor               *self);
 CLUTTER_AVAILABLE_IN_1_10
 void                            clutter_actor_iter_init                         (ClutterActorIter           *iter,
                                                                                  ClutterActor               *root);
@@ -842,6 +905,11 @@ void                            clutter_actor_set_easing_delay
                                                                                  guint                       msecs);
 CLUTTER_AVAILABLE_IN_1_10
 guint                           clutter_actor_get_easing_delay                  (ClutterActor               *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_actor_set_easing_paint_time             (ClutterActor               *self,
+                                                                                 gboolean                    paint_time);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_get_easing_paint_time             (ClutterActor               *self);
 CLUTTER_AVAILABLE_IN_1_10
 ClutterTransition *             clutter_actor_get_transition                    (ClutterActor               *self,
                                                                                  const char                 *name);
@@ -899,6 +967,13 @@ void                            clutter_actor_bind_model_with_properties
                                                                                  const char                 *first_model_property,
                                                                                  ...);
 
+CLUTTER_AVAILABLE_IN_1_26
+GBytes *                        clutter_actor_save_snapshot                     (ClutterActor               *self);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_actor_restore_snapshot                  (ClutterActor               *self,
+                                                                                 GBytes                     *snapshot,
+                                                                                 GError                    **error);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ACTOR_H__ */
@@ -42,7 +42,7 @@
 
 #include "clutter-actor-meta-private.h"
 #include "clutter-actor-private.h"
-#include "clutter-constraint.h"
+#include "clutter-constraint-private.h"
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-private.h"
@@ -85,21 +85,13 @@ G_DEFINE_TYPE (ClutterAlignConstraint,
                clutter_align_constraint,
                CLUTTER_TYPE_CONSTRAINT);
 
-static void
-source_position_changed (ClutterActor           *actor,
-                         const ClutterActorBox  *allocation,
-                         ClutterAllocationFlags  flags,
-                         ClutterAlignConstraint *align)
-{
-  if (align->actor != NULL)
-    clutter_actor_queue_relayout (align->actor);
-}
-
 static void
 source_destroyed (ClutterActor           *actor,
                   ClutterAlignConstraint *align)
 {
   align->source = NULL;
+
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (align), NULL);
 }
 
 static void
@@ -188,9 +180,6 @@ clutter_align_constraint_dispose (GObject *gobject)
       g_signal_handlers_disconnect_by_func (align->source,
                                             G_CALLBACK (source_destroyed),
                                             align);
-      g_signal_handlers_disconnect_by_func (align->source,
-                                            G_CALLBACK (source_position_changed),
-                                            align);
       align->source = NULL;
     }
 
@@ -404,17 +393,13 @@ clutter_align_constraint_set_source (ClutterAlignConstraint *align,
       g_signal_handlers_disconnect_by_func (old_source,
                                             G_CALLBACK (source_destroyed),
                                             align);
-      g_signal_handlers_disconnect_by_func (old_source,
-                                            G_CALLBACK (source_position_changed),
-                                            align);
     }
 
   align->source = source;
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (align), source);
+
   if (align->source != NULL)
     {
-      g_signal_connect (align->source, "allocation-changed",
-                        G_CALLBACK (source_position_changed),
-                        align);
       g_signal_connect (align->source, "destroy",
                         G_CALLBACK (source_destroyed),
                         align);
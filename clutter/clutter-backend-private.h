@@ -48,6 +48,12 @@ struct _ClutterBackend
 
   CoglOnscreen *dummy_onscreen;
 
+  /* a renderer connected before the context is created, see
+   * _clutter_backend_preload_renderer()
+   */
+  CoglRenderer *preloaded_renderer;
+  CoglDriver preloaded_driver;
+
   ClutterDeviceManager *device_manager;
 
   cairo_font_options_t *font_options;
@@ -133,6 +139,9 @@ void                    _clutter_backend_ensure_context_internal        (Clutter
                                                                          ClutterStage           *stage);
 gboolean                _clutter_backend_create_context                 (ClutterBackend         *backend,
                                                                          GError                **error);
+gboolean                _clutter_backend_preload_renderer               (ClutterBackend         *backend,
+                                                                         CoglDriver              driver_id,
+                                                                         GError                **error);
 
 void                    _clutter_backend_add_options                    (ClutterBackend         *backend,
                                                                          GOptionGroup           *group);
@@ -97,6 +97,9 @@
 #ifdef CLUTTER_INPUT_ANDROID
 #include "android/clutter-backend-android.h"
 #endif
+#ifdef CLUTTER_WINDOWING_HEADLESS
+#include "headless/clutter-backend-headless.h"
+#endif
 
 #ifdef CLUTTER_HAS_WAYLAND_COMPOSITOR_SUPPORT
 #include <cogl/cogl-wayland-server.h>
@@ -142,6 +145,7 @@ clutter_backend_dispose (GObject *gobject)
   g_clear_pointer (&backend->event_translators, g_list_free);
 
   g_clear_pointer (&backend->dummy_onscreen, cogl_object_unref);
+  g_clear_pointer (&backend->preloaded_renderer, cogl_object_unref);
 
   G_OBJECT_CLASS (clutter_backend_parent_class)->dispose (gobject);
 }
@@ -264,27 +268,37 @@ clutter_backend_do_real_create_context (ClutterBackend  *backend,
   swap_chain = NULL;
   internal_error = NULL;
 
-  CLUTTER_NOTE (BACKEND, "Creating Cogl renderer");
-  if (klass->get_renderer != NULL)
-    backend->cogl_renderer = klass->get_renderer (backend, &internal_error);
+  if (backend->preloaded_renderer != NULL &&
+      backend->preloaded_driver == driver_id)
+    {
+      CLUTTER_NOTE (BACKEND, "Using the preloaded Cogl renderer");
+      backend->cogl_renderer = backend->preloaded_renderer;
+      backend->preloaded_renderer = NULL;
+    }
   else
-    backend->cogl_renderer = cogl_renderer_new ();
+    {
+      CLUTTER_NOTE (BACKEND, "Creating Cogl renderer");
+      if (klass->get_renderer != NULL)
+        backend->cogl_renderer = klass->get_renderer (backend, &internal_error);
+      else
+        backend->cogl_renderer = cogl_renderer_new ();
 
-  if (backend->cogl_renderer == NULL)
-    goto error;
+      if (backend->cogl_renderer == NULL)
+        goto error;
 
 #ifdef CLUTTER_HAS_WAYLAND_COMPOSITOR_SUPPORT
-  /* If the application is trying to act as a Wayland compositor then
-     it needs to have an EGL-based renderer backend */
-  if (_wayland_compositor_display)
-    cogl_renderer_add_constraint (backend->cogl_renderer,
-                                  COGL_RENDERER_CONSTRAINT_USES_EGL);
+      /* If the application is trying to act as a Wayland compositor then
+         it needs to have an EGL-based renderer backend */
+      if (_wayland_compositor_display)
+        cogl_renderer_add_constraint (backend->cogl_renderer,
+                                      COGL_RENDERER_CONSTRAINT_USES_EGL);
 #endif
 
-  CLUTTER_NOTE (BACKEND, "Connecting the renderer");
-  cogl_renderer_set_driver (backend->cogl_renderer, driver_id);
-  if (!cogl_renderer_connect (backend->cogl_renderer, &internal_error))
-    goto error;
+      CLUTTER_NOTE (BACKEND, "Connecting the renderer");
+      cogl_renderer_set_driver (backend->cogl_renderer, driver_id);
+      if (!cogl_renderer_connect (backend->cogl_renderer, &internal_error))
+        goto error;
+    }
 
   CLUTTER_NOTE (BACKEND, "Creating Cogl swap chain");
   swap_chain = cogl_swap_chain_new ();
@@ -384,7 +398,25 @@ clutter_backend_real_create_context (ClutterBackend  *backend,
   if (backend->cogl_context != NULL)
     return TRUE;
 
-  for (i = 0; i < G_N_ELEMENTS (known_drivers); i++)
+  /* a preloaded renderer has already loaded its driver, so we try it
+   * before the others
+   */
+  if (backend->preloaded_renderer != NULL)
+    {
+      CLUTTER_NOTE (BACKEND, "Checking for the preloaded driver");
+
+      if (!clutter_backend_do_real_create_context (backend,
+                                                   backend->preloaded_driver,
+                                                   &internal_error))
+        {
+          CLUTTER_NOTE (BACKEND, "Unable to use the preloaded driver: %s",
+                        internal_error != NULL ? internal_error->message
+                                               : "unknown error");
+          g_clear_error (&internal_error);
+        }
+    }
+
+  for (i = 0; backend->cogl_context == NULL && i < G_N_ELEMENTS (known_drivers); i++)
     {
       CLUTTER_NOTE (BACKEND, "Checking for the %s driver", known_drivers[i].driver_name);
 
@@ -557,6 +589,12 @@ _clutter_create_backend (void)
   if (backend == NULL || backend == I_(CLUTTER_WINDOWING_ANDROID))
     retval = g_object_new (CLUTTER_TYPE_BACKEND_ANDROID, NULL);
   else
+#endif
+#ifdef CLUTTER_WINDOWING_HEADLESS
+  /* the headless backend is only the default if it is the only one */
+  if (backend == NULL || backend == I_(CLUTTER_WINDOWING_HEADLESS))
+    retval = g_object_new (CLUTTER_TYPE_BACKEND_HEADLESS, NULL);
+  else
 #endif
   if (backend == NULL)
     g_error ("No default Clutter backend found.");
@@ -615,6 +653,14 @@ clutter_backend_real_init_events (ClutterBackend *backend)
     }
   else
 #endif
+#ifdef CLUTTER_INPUT_HEADLESS
+  if (clutter_check_windowing_backend (CLUTTER_WINDOWING_HEADLESS) &&
+      (input_backend == NULL || input_backend == I_(CLUTTER_INPUT_HEADLESS)))
+    {
+      _clutter_backend_headless_events_init (backend);
+    }
+  else
+#endif
 #ifdef CLUTTER_INPUT_EVDEV
   /* Evdev can be used regardless of the windowing system */
   if ((input_backend != NULL && strcmp (input_backend, CLUTTER_INPUT_EVDEV) == 0)
@@ -866,6 +912,54 @@ _clutter_backend_create_context (ClutterBackend  *backend,
   return klass->create_context (backend, error);
 }
 
+/*< private >
+ * _clutter_backend_preload_renderer:
+ * @backend: a #ClutterBackend
+ * @driver_id: the driver to load
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates and connects the Cogl renderer of @backend ahead of the
+ * creation of the Cogl context, so that the windowing system and the
+ * GL driver can be loaded while the application is still waiting for
+ * its window; _clutter_backend_create_context() will use the renderer
+ * if the driver matches.
+ *
+ * Return value: %TRUE if the renderer was connected
+ */
+gboolean
+_clutter_backend_preload_renderer (ClutterBackend  *backend,
+                                   CoglDriver       driver_id,
+                                   GError         **error)
+{
+  ClutterBackendClass *klass = CLUTTER_BACKEND_GET_CLASS (backend);
+  CoglRenderer *renderer;
+
+  if (backend->cogl_context != NULL || backend->preloaded_renderer != NULL)
+    return TRUE;
+
+  if (klass->get_renderer != NULL)
+    renderer = klass->get_renderer (backend, error);
+  else
+    renderer = cogl_renderer_new ();
+
+  if (renderer == NULL)
+    return FALSE;
+
+  cogl_renderer_set_driver (renderer, driver_id);
+  if (!cogl_renderer_connect (renderer, error))
+    {
+      cogl_object_unref (renderer);
+      return FALSE;
+    }
+
+  CLUTTER_NOTE (BACKEND, "Preloaded the Cogl renderer");
+
+  backend->preloaded_renderer = renderer;
+  backend->preloaded_driver = driver_id;
+
+  return TRUE;
+}
+
 void
 _clutter_backend_ensure_context_internal (ClutterBackend  *backend,
                                           ClutterStage    *stage)
@@ -22,77 +22,62 @@
  */
 
 #include <glib.h>
+#include <math.h>
 #include <string.h>
 #include "clutter-bezier.h"
 #include "clutter-debug.h"
 
-/*
- * We have some experimental code here to allow for constant velocity
- * movement of actors along the bezier path, this macro enables it.
- */
-#undef CBZ_L2T_INTERPOLATION
-
 /****************************************************************************
  * ClutterBezier -- represenation of a cubic bezier curve                   *
  * (private; a building block for the public bspline object)                *
  ****************************************************************************/
 
 /*
- * The t parameter of the bezier is from interval <0,1>, so we can use
- * 14.18 format and special multiplication functions that preserve
- * more of the least significant bits but would overflow if the value
- * is > 1
+ * The curve is sampled at CBZ_L_SAMPLES evenly spaced values of t, and
+ * the arc length up to each sample is stored, so that a relative length
+ * along the curve can be mapped back to t; this is what makes the
+ * movement along the curve happen at a constant speed.
  */
-#define CBZ_T_Q 18
-#define CBZ_T_ONE (1 << CBZ_T_Q)
-#define CBZ_T_MUL(x,y) ((((x) >> 3) * ((y) >> 3)) >> 12)
-#define CBZ_T_POW2(x) CBZ_T_MUL (x, x)
-#define CBZ_T_POW3(x) CBZ_T_MUL (CBZ_T_POW2 (x), x)
-#define CBZ_T_DIV(x,y) ((((x) << 9)/(y)) << 9)
+#define CBZ_L_SAMPLES 32
 
 /*
- * Constants for sampling of the bezier
+ * The arc length of each sample is integrated with an adaptive Simpson
+ * rule; the tolerance is in pixels, and the depth limits the number of
+ * subdivisions for degenerate curves.
  */
-#define CBZ_T_SAMPLES 128
-#define CBZ_T_STEP (CBZ_T_ONE / CBZ_T_SAMPLES)
-#define CBZ_L_STEP (CBZ_T_ONE / CBZ_T_SAMPLES)
+#define CBZ_L_TOLERANCE 0.01f
+#define CBZ_L_MAX_DEPTH 10
 
-typedef gint32 _FixedT;
+/*
+ * The number of positions evaluated together by _clutter_bezier_advance_n()
+ */
+#define CBZ_BATCH_SIZE 64
 
 /*
  * This is a private type representing a single cubic bezier
  */
 struct _ClutterBezier
 {
-  /*
-   * bezier coefficients -- these are calculated using multiplication and
-   * addition from integer input, so these are also integers
-   */
-  gint ax;
-  gint bx;
-  gint cx;
-  gint dx;
-
-  gint ay;
-  gint by;
-  gint cy;
-  gint dy;
-    
+  /* control points */
+  float x[4];
+  float y[4];
+
+  /* polynomial coefficients, x(t) = ((ax * t + bx) * t + cx) * t + dx */
+  float ax;
+  float bx;
+  float cx;
+  float dx;
+
+  float ay;
+  float by;
+  float cy;
+  float dy;
+
   /* length of the bezier */
-  guint length;
+  float length;
 
-#ifdef CBZ_L2T_INTERPOLATION
-  /*
-   * coefficients for the L -> t bezier; these are calculated from fixed
-   * point input, and more specifically numbers that have been normalised
-   * to fit <0,1>, so these are also fixed point, and we can used the
-   * _FixedT type here.
-   */
-  _FixedT La;
-  _FixedT Lb;
-  _FixedT Lc;
-  /*  _FixedT Ld; == 0 */
-#endif
+  /* the arc length from the start of the curve to each sample */
+  float lengths[CBZ_L_SAMPLES + 1];
 };
 
 ClutterBezier *
@@ -114,54 +99,118 @@ ClutterBezier *
 _clutter_bezier_clone_and_move (const ClutterBezier *b, gint x, gint y)
 {
   ClutterBezier * b2 = _clutter_bezier_new ();
+  int i;
+
   memcpy (b2, b, sizeof (ClutterBezier));
 
+  for (i = 0; i < 4; i++)
+    {
+      b2->x[i] += x;
+      b2->y[i] += y;
+    }
+
   b2->dx += x;
   b2->dy += y;
 
   return b2;
 }
 
-#ifdef CBZ_L2T_INTERPOLATION
+static inline float
+_clutter_bezier_speed (const ClutterBezier *b, float t)
+{
+  float dx = (3.f * b->ax * t + 2.f * b->bx) * t + b->cx;
+  float dy = (3.f * b->ay * t + 2.f * b->by) * t + b->cy;
+
+  return sqrtf (dx * dx + dy * dy);
+}
+
 /*
- * L is relative advance along the bezier curve from interval <0,1>
+ * Integrates the speed of the curve between t0 and t1, splitting the
+ * interval until the Simpson estimates of the two halves agree with the
+ * estimate of the whole
  */
-static _FixedT
-_clutter_bezier_L2t (const ClutterBezier *b, _FixedT L)
+static float
+_clutter_bezier_integrate (const ClutterBezier *b,
+                           float                t0,
+                           float                t1,
+                           float                s0,
+                           float                sm,
+                           float                s1,
+                           float                whole,
+                           float                tolerance,
+                           int                  depth)
 {
-  _FixedT t = CBZ_T_MUL (b->La, CBZ_T_POW3(L))
-    +  CBZ_T_MUL (b->Lb, CBZ_T_POW2(L))
-    +  CBZ_T_MUL (b->Lc, L);
-  
-  if (t > CBZ_T_ONE)
-    t = CBZ_T_ONE;
-  else if (t < 0)
-    t = 0;
-  
-  return t;
+  float tm = (t0 + t1) * 0.5f;
+  float sl = _clutter_bezier_speed (b, (t0 + tm) * 0.5f);
+  float sr = _clutter_bezier_speed (b, (tm + t1) * 0.5f);
+  float left = (tm - t0) / 6.f * (s0 + 4.f * sl + sm);
+  float right = (t1 - tm) / 6.f * (sm + 4.f * sr + s1);
+
+  if (depth <= 0 || fabsf (left + right - whole) <= 15.f * tolerance)
+    return left + right + (left + right - whole) / 15.f;
+
+  return _clutter_bezier_integrate (b, t0, tm, s0, sl, sm, left,
+                                    tolerance * 0.5f, depth - 1) +
+         _clutter_bezier_integrate (b, tm, t1, sm, sr, s1, right,
+                                    tolerance * 0.5f, depth - 1);
 }
-#endif
 
-static gint
-_clutter_bezier_t2x (const ClutterBezier * b, _FixedT t)
+static float
+_clutter_bezier_arc_length (const ClutterBezier *b,
+                            float                t0,
+                            float                t1)
 {
-  /*
-   * NB -- the int coefficients can be at most 8192 for the multiplication
-   * to work in this fashion due to the limits of the 14.18 fixed.
-   */
-  return ((b->ax*CBZ_T_POW3(t) + b->bx*CBZ_T_POW2(t) + b->cx*t) >> CBZ_T_Q)
-    + b->dx;
+  float s0 = _clutter_bezier_speed (b, t0);
+  float sm = _clutter_bezier_speed (b, (t0 + t1) * 0.5f);
+  float s1 = _clutter_bezier_speed (b, t1);
+  float whole = (t1 - t0) / 6.f * (s0 + 4.f * sm + s1);
+
+  return _clutter_bezier_integrate (b, t0, t1, s0, sm, s1, whole,
+                                    CBZ_L_TOLERANCE, CBZ_L_MAX_DEPTH);
 }
 
-static gint
-_clutter_bezier_t2y (const ClutterBezier * b, _FixedT t)
+/*
+ * Maps L, a relative length along the curve in the <0,CLUTTER_BEZIER_MAX_LENGTH>
+ * interval, to the t parameter of the curve
+ */
+static float
+_clutter_bezier_L2t (const ClutterBezier *b, gint L)
 {
-  /*
-   * NB -- the int coefficients can be at most 8192 for the multiplication
-   * to work in this fashion due to the limits of the 14.18 fixed.
+  float target, span;
+  int lo, hi;
+
+  if (L <= 0)
+    return 0.f;
+
+  if (L >= CLUTTER_BEZIER_MAX_LENGTH)
+    return 1.f;
+
+  if (b->length <= 0.f)
+    return (float) L / CLUTTER_BEZIER_MAX_LENGTH;
+
+  target = (float) L / CLUTTER_BEZIER_MAX_LENGTH * b->length;
+
+  /* find the sample interval containing the length */
+  lo = 0;
+  hi = CBZ_L_SAMPLES;
+  while (hi - lo > 1)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (b->lengths[mid] <= target)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  /* and interpolate inside it; the samples are close enough that the
+   * speed does not change much between them
    */
-  return ((b->ay*CBZ_T_POW3(t) + b->by*CBZ_T_POW2(t) + b->cy*t) >> CBZ_T_Q)
-    + b->dy;
+  span = b->lengths[hi] - b->lengths[lo];
+  if (span <= 0.f)
+    return (float) lo / CBZ_L_SAMPLES;
+
+  return (lo + (target - b->lengths[lo]) / span) / CBZ_L_SAMPLES;
 }
 
 /*
@@ -171,21 +220,52 @@ _clutter_bezier_t2y (const ClutterBezier * b, _FixedT t)
 void
 _clutter_bezier_advance (const ClutterBezier *b, gint L, ClutterKnot * knot)
 {
-#ifdef CBZ_L2T_INTERPOLATION
-  _FixedT t = clutter_bezier_L2t (b, L);
-#else
-  _FixedT t = L;
-#endif
-  
-  knot->x = _clutter_bezier_t2x (b, t);
-  knot->y = _clutter_bezier_t2y (b, t);
-  
+  float t = _clutter_bezier_L2t (b, L);
+
+  knot->x = floorf (((b->ax * t + b->bx) * t + b->cx) * t + b->dx + 0.5f);
+  knot->y = floorf (((b->ay * t + b->by) * t + b->cy) * t + b->dy + 0.5f);
+
   CLUTTER_NOTE (MISC, "advancing to relative pt %f: t %f, {%d,%d}",
-                (double) L / (double) CBZ_T_ONE,
-                (double) t / (double) CBZ_T_ONE,
+                (double) L / (double) CLUTTER_BEZIER_MAX_LENGTH,
+                (double) t,
                 knot->x, knot->y);
 }
 
+/*
+ * Advances along the bezier to each of the n relative lengths in L, and
+ * returns the coordinates in knots; the polynomials are evaluated in
+ * batches, in loops that the compiler can vectorize
+ */
+void
+_clutter_bezier_advance_n (const ClutterBezier *b,
+                           const gint          *L,
+                           ClutterKnot         *knots,
+                           guint                n)
+{
+  float t[CBZ_BATCH_SIZE], x[CBZ_BATCH_SIZE], y[CBZ_BATCH_SIZE];
+  guint start, i;
+
+  for (start = 0; start < n; start += CBZ_BATCH_SIZE)
+    {
+      guint count = MIN (n - start, CBZ_BATCH_SIZE);
+
+      for (i = 0; i < count; i++)
+        t[i] = _clutter_bezier_L2t (b, L[start + i]);
+
+      for (i = 0; i < count; i++)
+        {
+          x[i] = ((b->ax * t[i] + b->bx) * t[i] + b->cx) * t[i] + b->dx;
+          y[i] = ((b->ay * t[i] + b->by) * t[i] + b->cy) * t[i] + b->dy;
+        }
+
+      for (i = 0; i < count; i++)
+        {
+          knots[start + i].x = floorf (x[i] + 0.5f);
+          knots[start + i].y = floorf (y[i] + 0.5f);
+        }
+    }
+}
+
 void
 _clutter_bezier_init (ClutterBezier *b,
 		     gint x_0, gint y_0,
@@ -193,200 +273,49 @@ _clutter_bezier_init (ClutterBezier *b,
 		     gint x_2, gint y_2,
 		     gint x_3, gint y_3)
 {
-  _FixedT t;
   int i;
-  int xp = x_0;
-  int yp = y_0;
-  _FixedT length [CBZ_T_SAMPLES + 1];
-
-#ifdef CBZ_L2T_INTERPOLATION
-  int j, k;
-  _FixedT L;
-  _FixedT t_equalized [CBZ_T_SAMPLES + 1];
-#endif
-
-#if 0
-  g_debug ("Initializing bezier at {{%d,%d},{%d,%d},{%d,%d},{%d,%d}}",
-           x0, y0, x1, y1, x2, y2, x3, y3);
-#endif
-  
+
+  b->x[0] = x_0;
+  b->y[0] = y_0;
+  b->x[1] = x_1;
+  b->y[1] = y_1;
+  b->x[2] = x_2;
+  b->y[2] = y_2;
+  b->x[3] = x_3;
+  b->y[3] = y_3;
+
   b->dx = x_0;
   b->dy = y_0;
 
-  b->cx = 3 * (x_1 - x_0);
-  b->cy = 3 * (y_1 - y_0);
+  b->cx = 3.f * (b->x[1] - b->x[0]);
+  b->cy = 3.f * (b->y[1] - b->y[0]);
 
-  b->bx = 3 * (x_2 - x_1) - b->cx;
-  b->by = 3 * (y_2 - y_1) - b->cy;
+  b->bx = 3.f * (b->x[2] - b->x[1]) - b->cx;
+  b->by = 3.f * (b->y[2] - b->y[1]) - b->cy;
 
-  b->ax = x_3 - 3 * x_2 + 3 * x_1 - x_0;
-  b->ay = y_3 - 3 * y_2 + 3 * y_1 - y_0;
+  b->ax = b->x[3] - 3.f * b->x[2] + 3.f * b->x[1] - b->x[0];
+  b->ay = b->y[3] - 3.f * b->y[2] + 3.f * b->y[1] - b->y[0];
 
-#if 0
-  g_debug ("Cooeficients {{%d,%d},{%d,%d},{%d,%d},{%d,%d}}",
-           b->ax, b->ay, b->bx, b->by, b->cx, b->cy, b->dx, b->dy);
-#endif
-  
   /*
-   * Because of the way we do the multiplication in bezeir_t2x,y
-   * these coefficients need to be at most 0x1fff; this should be the case,
-   * I think, but have added this warning to catch any problems -- if it
-   * triggers, we need to change those two functions a bit.
+   * Integrate the length of the curve up to each sample; doing it per
+   * sample keeps the error of the whole length within the tolerance
+   * times the number of samples.
    */
-  if (b->ax > 0x1fff || b->bx > 0x1fff || b->cx > 0x1fff)
-    g_warning ("Calculated coefficents will result in multiplication "
-               "overflow in clutter_bezier_t2x and clutter_bezier_t2y.");
+  b->lengths[0] = 0.f;
 
-  /*
-   * Sample the bezier with CBZ_T_SAMPLES and calculate length at
-   * each point.
-   *
-   * We are working with integers here, so we use the fast sqrti function.
-   */
-  length[0] = 0;
-    
-  for (t = CBZ_T_STEP, i = 1; i <= CBZ_T_SAMPLES; ++i, t += CBZ_T_STEP)
-    {
-      int x = _clutter_bezier_t2x (b, t);
-      int y = _clutter_bezier_t2y (b, t);
-	
-      guint l = cogl_sqrti ((y - yp)*(y - yp) + (x - xp)*(x - xp));
-
-      l += length[i-1];
-
-      length[i] = l;
-
-      xp = x;
-      yp = y;
-    }
-
-  b->length = length[CBZ_T_SAMPLES];
-
-#if 0
-  g_debug ("length %d", b->length);
-#endif
-  
-#ifdef CBZ_L2T_INTERPOLATION
-  /*
-   * Now normalize the length values, converting them into _FixedT
-   */
-  for (i = 0; i <= CBZ_T_SAMPLES; ++i)
+  for (i = 1; i <= CBZ_L_SAMPLES; i++)
     {
-      length[i] = (length[i] << CBZ_T_Q) / b->length;
-    }
+      float t0 = (float) (i - 1) / CBZ_L_SAMPLES;
+      float t1 = (float) i / CBZ_L_SAMPLES;
 
-  /*
-   * Now generate a L -> t table such that the L will equidistant
-   * over <0,1>
-   */
-  t_equalized[0] = 0;
-    
-  for (i = 1, j = 1, L = CBZ_L_STEP; i < CBZ_T_SAMPLES; ++i, L += CBZ_L_STEP)
-    {
-      _FixedT l1, l2;
-      _FixedT d1, d2, d;
-      _FixedT t1, t2;
-	
-      /* find the band for our L */
-      for (k = j; k < CBZ_T_SAMPLES; ++k)
-	{
-          if (L < length[k])
-            break;
-	}
-
-      /*
-       * Now we know that L is from (length[k-1],length[k]>
-       * We remember k-1 in order not to have to iterate over the
-       * whole length array in the next iteration of the main loop
-       */
-      j = k - 1;
-
-      /*
-       * Now interpolate equlised t as a weighted average
-       */
-      l1 = length[k-1];
-      l2 = length[k];
-      d1 = l2 - L;
-      d2 = L - l1;
-      d = l2 - l1;
-      t1 = (k - 1) * CBZ_T_STEP;
-      t2 = k * CBZ_T_STEP;
-	
-      t_equalized[i] = (t1*d1 + t2*d2)/d;
-
-      if (t_equalized[i] < t_equalized[i-1])
-        g_debug ("wrong t: L %f, l1 %f, l2 %f, t1 %f, t2 %f",
-                 (double) (L)/(double)CBZ_T_ONE,
-                 (double) (l1)/(double)CBZ_T_ONE,
-                 (double) (l2)/(double)CBZ_T_ONE,
-                 (double) (t1)/(double)CBZ_T_ONE,                 
-                 (double) (t2)/(double)CBZ_T_ONE);
-      
+      b->lengths[i] = b->lengths[i - 1] + _clutter_bezier_arc_length (b, t0, t1);
     }
 
-  t_equalized[CBZ_T_SAMPLES] = CBZ_T_ONE;
-
-  /* We now fit a bezier -- at this stage, do a single fit through our values
-   * at 0, 1/3, 2/3 and 1
-   *
-   * FIXME -- do we need to  use a better fitting approach to choose the best
-   * beziere. The actual curve we acquire this way is not too bad shapwise,
-   * but (probably due to rounding errors) the resulting curve no longer
-   * satisfies the necessary condition that for L2 > L1, t2 > t1, which 
-   * causes oscilation.
-   */
-
-#if 0
-  /*
-   * These are the control points we use to calculate the curve coefficients
-   * for bezier t(L); these are not needed directly, but are implied in the
-   * calculations below.
-   *
-   * (p0 is 0,0, and p3 is 1,1)
-   */
-  p1 = (18 * t_equalized[CBZ_T_SAMPLES/3] -
-        9 * t_equalized[2*CBZ_T_SAMPLES/3] +
-        2 << CBZ_T_Q) / 6;
-
-  p2 = (18 * t_equalized[2*CBZ_T_SAMPLES/3] -
-        9 * t_equalized[CBZ_T_SAMPLES/3] -
-        (5 << CBZ_T_Q)) / 6;
-#endif
-    
-  b->Lc = (18 * t_equalized[CBZ_T_SAMPLES/3] -
-           9 * t_equalized[2*CBZ_T_SAMPLES/3] +
-           (2 << CBZ_T_Q)) >> 1;
-    
-  b->Lb = (36 * t_equalized[2*CBZ_T_SAMPLES/3] -
-           45 * t_equalized[CBZ_T_SAMPLES/3] -
-           (9 << CBZ_T_Q)) >> 1;
-
-  b->La = ((27 * (t_equalized[CBZ_T_SAMPLES/3] -
-                 t_equalized[2*CBZ_T_SAMPLES/3]) +
-            (7 << CBZ_T_Q)) >> 1) + CBZ_T_ONE;
-
-  g_debug ("t(1/3) %f, t(2/3) %f",
-           (double)t_equalized[CBZ_T_SAMPLES/3]/(double)CBZ_T_ONE,
-           (double)t_equalized[2*CBZ_T_SAMPLES/3]/(double)CBZ_T_ONE);
-
-  g_debug ("L -> t coefficients: %f, %f, %f",
-           (double)b->La/(double)CBZ_T_ONE,
-           (double)b->Lb/(double)CBZ_T_ONE,
-           (double)b->Lc/(double)CBZ_T_ONE);
-
+  b->length = b->lengths[CBZ_L_SAMPLES];
 
-  /*
-   * For debugging, you can load these values into a spreadsheet and graph
-   * them to see how well the approximation matches the data
-   */
-  for (i = 0; i < CBZ_T_SAMPLES; ++i)
-    {
-      g_print ("%f, %f, %f\n",
-               (double)(i*CBZ_T_STEP)/(double)CBZ_T_ONE,
-               (double)(t_equalized[i])/(double)CBZ_T_ONE,
-               (double)(clutter_bezier_L2t(b,i*CBZ_T_STEP))/(double)CBZ_T_ONE);
-    }
-#endif
+  CLUTTER_NOTE (MISC, "bezier {{%d,%d},{%d,%d},{%d,%d},{%d,%d}}, length %f",
+                x_0, y_0, x_1, y_1, x_2, y_2, x_3, y_3,
+                b->length);
 }
 
 /*
@@ -395,21 +324,16 @@ _clutter_bezier_init (ClutterBezier *b,
 void
 _clutter_bezier_adjust (ClutterBezier * b, ClutterKnot * knot, guint indx)
 {
-  guint x[4], y[4];
+  gint x[4], y[4];
+  int i;
 
   g_assert (indx < 4);
-    
-  x[0] = b->dx;
-  y[0] = b->dy;
-
-  x[1] = b->cx / 3 + x[0];
-  y[1] = b->cy / 3 + y[0];
-
-  x[2] = b->bx / 3 + b->cx + x[1];
-  y[2] = b->by / 3 + b->cy + y[1];
 
-  x[3] = b->ax + x[0] + b->cx + b->bx;
-  y[3] = b->ay + y[0] + b->cy + b->by;
+  for (i = 0; i < 4; i++)
+    {
+      x[i] = b->x[i];
+      y[i] = b->y[i];
+    }
 
   x[indx] = knot->x;
   y[indx] = knot->y;
@@ -420,5 +344,5 @@ _clutter_bezier_adjust (ClutterBezier * b, ClutterKnot * knot, guint indx)
 guint
 _clutter_bezier_get_length (const ClutterBezier *b)
 {
-  return b->length;
+  return floorf (b->length + 0.5f);
 }
@@ -48,6 +48,11 @@ void           _clutter_bezier_advance (const ClutterBezier *b,
                                         gint           L,
                                         ClutterKnot   *knot);
 
+void           _clutter_bezier_advance_n (const ClutterBezier *b,
+                                          const gint          *L,
+                                          ClutterKnot         *knots,
+                                          guint                n);
+
 void           _clutter_bezier_init (ClutterBezier *b,
                                      gint x_0, gint y_0,
                                      gint x_1, gint y_1,
@@ -90,7 +90,7 @@
 
 #include "clutter-actor-meta-private.h"
 #include "clutter-actor-private.h"
-#include "clutter-constraint.h"
+#include "clutter-constraint-private.h"
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-private.h"
@@ -131,19 +131,13 @@ G_DEFINE_TYPE (ClutterBindConstraint,
                clutter_bind_constraint,
                CLUTTER_TYPE_CONSTRAINT);
 
-static void
-source_queue_relayout (ClutterActor          *source,
-                       ClutterBindConstraint *bind)
-{
-  if (bind->actor != NULL)
-    _clutter_actor_queue_only_relayout (bind->actor);
-}
-
 static void
 source_destroyed (ClutterActor          *actor,
                   ClutterBindConstraint *bind)
 {
   bind->source = NULL;
+
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (bind), NULL);
 }
 
 static void
@@ -249,9 +243,6 @@ clutter_bind_constraint_dispose (GObject *gobject)
       g_signal_handlers_disconnect_by_func (bind->source,
                                             G_CALLBACK (source_destroyed),
                                             bind);
-      g_signal_handlers_disconnect_by_func (bind->source,
-                                            G_CALLBACK (source_queue_relayout),
-                                            bind);
       bind->source = NULL;
     }
 
@@ -461,17 +452,13 @@ clutter_bind_constraint_set_source (ClutterBindConstraint *constraint,
       g_signal_handlers_disconnect_by_func (old_source,
                                             G_CALLBACK (source_destroyed),
                                             constraint);
-      g_signal_handlers_disconnect_by_func (old_source,
-                                            G_CALLBACK (source_queue_relayout),
-                                            constraint);
     }
 
   constraint->source = source;
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (constraint), source);
+
   if (constraint->source != NULL)
     {
-      g_signal_connect (constraint->source, "queue-relayout",
-                        G_CALLBACK (source_queue_relayout),
-                        constraint);
       g_signal_connect (constraint->source, "destroy",
                         G_CALLBACK (source_destroyed),
                         constraint);
@@ -115,10 +115,16 @@
                                   CLUTTER_HYPER_MASK   | \
                                   CLUTTER_META_MASK)   | CLUTTER_RELEASE_MASK)
 
+/* the smallest size of the lookup table of a pool; the table is kept
+ * at most half full, so that a lookup is resolved by the first probe
+ * in the common case
+ */
+#define BINDING_TABLE_MIN_SIZE  16
+
 typedef struct _ClutterBindingEntry     ClutterBindingEntry;
 
-static GSList *clutter_binding_pools = NULL;
-static GQuark  key_class_bindings = 0;
+static GHashTable *clutter_binding_pools = NULL;
+static GQuark      key_class_bindings = 0;
 
 struct _ClutterBindingPool
 {
@@ -127,7 +133,13 @@ struct _ClutterBindingPool
   gchar *name; /* interned string, do not free */
 
   GSList *entries;
-  GHashTable *entries_hash;
+
+  /* open addressing table, with linear probing, of the entries; the
+   * size is always a power of two
+   */
+  ClutterBindingEntry **table;
+  guint table_size;
+  guint n_entries;
 };
 
 struct _ClutterBindingPoolClass
@@ -160,26 +172,69 @@ static GParamSpec *obj_props[PROP_LAST];
 
 G_DEFINE_TYPE (ClutterBindingPool, clutter_binding_pool, G_TYPE_OBJECT);
 
-static guint
-binding_entry_hash (gconstpointer v)
+static inline guint
+binding_entry_hash (guint               key_val,
+                    ClutterModifierType modifiers)
 {
-  const ClutterBindingEntry *e = v;
-  guint h;
+  guint32 h;
 
-  h = e->key_val;
-  h ^= e->modifiers;
+  /* the modifiers live in the low and in the high bits of the mask,
+   * and most key symbols are in the 0xff00 range, so we need to mix
+   * the bits before using the low ones as the slot
+   */
+  h = key_val ^ ((guint32) modifiers * 0x85ebca6b);
+  h ^= h >> 16;
+  h *= 0x9e3779b1;
+  h ^= h >> 15;
 
   return h;
 }
 
-static gint
-binding_entry_compare (gconstpointer v1,
-                       gconstpointer v2)
+static void
+binding_table_insert (ClutterBindingEntry **table,
+                      guint                 table_size,
+                      ClutterBindingEntry  *entry)
 {
-  const ClutterBindingEntry *e1 = v1;
-  const ClutterBindingEntry *e2 = v2;
+  guint mask = table_size - 1;
+  guint i;
 
-  return (e1->key_val == e2->key_val && e1->modifiers == e2->modifiers);
+  i = binding_entry_hash (entry->key_val, entry->modifiers) & mask;
+  while (table[i] != NULL)
+    i = (i + 1) & mask;
+
+  table[i] = entry;
+}
+
+static void
+binding_pool_rebuild_table (ClutterBindingPool *pool,
+                            guint               table_size)
+{
+  GSList *l;
+
+  g_free (pool->table);
+
+  pool->table = g_new0 (ClutterBindingEntry *, table_size);
+  pool->table_size = table_size;
+
+  for (l = pool->entries; l != NULL; l = l->next)
+    binding_table_insert (pool->table, pool->table_size, l->data);
+}
+
+static void
+binding_pool_add_entry (ClutterBindingPool  *pool,
+                        ClutterBindingEntry *entry)
+{
+  pool->entries = g_slist_prepend (pool->entries, entry);
+  pool->n_entries += 1;
+
+  if (pool->n_entries * 2 > pool->table_size)
+    {
+      guint table_size = MAX (pool->table_size * 2, BINDING_TABLE_MIN_SIZE);
+
+      binding_pool_rebuild_table (pool, table_size);
+    }
+  else
+    binding_table_insert (pool->table, pool->table_size, entry);
 }
 
 static ClutterBindingEntry *
@@ -206,12 +261,26 @@ binding_pool_lookup_entry (ClutterBindingPool  *pool,
                            guint                key_val,
                            ClutterModifierType  modifiers)
 {
-  ClutterBindingEntry lookup_entry = { 0, };
+  ClutterBindingEntry *entry;
+  guint mask, i;
+
+  if (pool->table == NULL)
+    return NULL;
 
-  lookup_entry.key_val = key_val;
-  lookup_entry.modifiers = modifiers;
+  modifiers = modifiers & BINDING_MOD_MASK;
+
+  mask = pool->table_size - 1;
+  i = binding_entry_hash (key_val, modifiers) & mask;
+
+  while ((entry = pool->table[i]) != NULL)
+    {
+      if (entry->key_val == key_val && entry->modifiers == modifiers)
+        return entry;
 
-  return g_hash_table_lookup (pool->entries_hash, &lookup_entry);
+      i = (i + 1) & mask;
+    }
+
+  return NULL;
 }
 
 static void
@@ -233,9 +302,12 @@ clutter_binding_pool_finalize (GObject *gobject)
   ClutterBindingPool *pool = CLUTTER_BINDING_POOL (gobject);
 
   /* remove from the pools */
-  clutter_binding_pools = g_slist_remove (clutter_binding_pools, pool);
+  if (pool->name != NULL &&
+      clutter_binding_pools != NULL &&
+      g_hash_table_lookup (clutter_binding_pools, pool->name) == pool)
+    g_hash_table_remove (clutter_binding_pools, pool->name);
 
-  g_hash_table_destroy (pool->entries_hash);
+  g_free (pool->table);
 
   g_slist_foreach (pool->entries, (GFunc) binding_entry_free, NULL);
   g_slist_free (pool->entries);
@@ -291,6 +363,14 @@ clutter_binding_pool_constructed (GObject *gobject)
   /* bad monkey! bad, bad monkey! */
   if (G_UNLIKELY (pool->name == NULL))
     g_critical ("No name set for ClutterBindingPool %p", pool);
+  else
+    {
+      if (G_UNLIKELY (clutter_binding_pools == NULL))
+        clutter_binding_pools = g_hash_table_new (NULL, NULL);
+
+      /* the names are interned, so we can use them directly as keys */
+      g_hash_table_insert (clutter_binding_pools, pool->name, pool);
+    }
 
   if (G_OBJECT_CLASS (clutter_binding_pool_parent_class)->constructed)
     G_OBJECT_CLASS (clutter_binding_pool_parent_class)->constructed (gobject);
@@ -331,10 +411,9 @@ clutter_binding_pool_init (ClutterBindingPool *pool)
 {
   pool->name = NULL;
   pool->entries = NULL;
-  pool->entries_hash = g_hash_table_new (binding_entry_hash,
-                                         binding_entry_compare);
-
-  clutter_binding_pools = g_slist_prepend (clutter_binding_pools, pool);
+  pool->table = NULL;
+  pool->table_size = 0;
+  pool->n_entries = 0;
 }
 
 /**
@@ -430,19 +509,22 @@ clutter_binding_pool_get_for_class (gpointer klass)
 ClutterBindingPool *
 clutter_binding_pool_find (const gchar *name)
 {
-  GSList *l;
+  GQuark quark;
 
   g_return_val_if_fail (name != NULL, NULL);
 
-  for (l = clutter_binding_pools; l != NULL; l = l->next)
-    {
-      ClutterBindingPool *pool = l->data;
+  if (clutter_binding_pools == NULL)
+    return NULL;
 
-      if (g_str_equal (pool->name, (gpointer) name))
-        return pool;
-    }
+  /* the names of the pools are interned, so a name that was never
+   * interned cannot belong to a pool
+   */
+  quark = g_quark_try_string (name);
+  if (quark == 0)
+    return NULL;
 
-  return NULL;
+  return g_hash_table_lookup (clutter_binding_pools,
+                              (gpointer) g_quark_to_string (quark));
 }
 
 /**
@@ -513,8 +595,7 @@ clutter_binding_pool_install_action (ClutterBindingPool  *pool,
       g_closure_set_marshal (closure, marshal);
     }
 
-  pool->entries = g_slist_prepend (pool->entries, entry);
-  g_hash_table_insert (pool->entries_hash, entry, entry);
+  binding_pool_add_entry (pool, entry);
 }
 
 /**
@@ -579,8 +660,7 @@ clutter_binding_pool_install_closure (ClutterBindingPool  *pool,
       g_closure_set_marshal (closure, marshal);
     }
 
-  pool->entries = g_slist_prepend (pool->entries, entry);
-  g_hash_table_insert (pool->entries_hash, entry, entry);
+  binding_pool_add_entry (pool, entry);
 }
 
 /**
@@ -756,30 +836,24 @@ clutter_binding_pool_remove_action (ClutterBindingPool  *pool,
                                     guint                key_val,
                                     ClutterModifierType  modifiers)
 {
-  ClutterBindingEntry remove_entry = { 0, };
-  GSList *l;
+  ClutterBindingEntry *entry;
 
   g_return_if_fail (pool != NULL);
   g_return_if_fail (key_val != 0);
 
-  modifiers = modifiers & BINDING_MOD_MASK;
+  entry = binding_pool_lookup_entry (pool, key_val, modifiers);
+  if (entry == NULL)
+    return;
 
-  remove_entry.key_val = key_val;
-  remove_entry.modifiers = modifiers;
+  pool->entries = g_slist_remove (pool->entries, entry);
+  pool->n_entries -= 1;
 
-  for (l = pool->entries; l != NULL; l = l->data)
-    {
-      ClutterBindingEntry *e = l->data;
-
-      if (e->key_val == remove_entry.key_val &&
-          e->modifiers == remove_entry.modifiers)
-        {
-          pool->entries = g_slist_remove_link (pool->entries, l);
-          break;
-        }
-    }
+  /* removing an entry would break the probe sequences going through
+   * its slot; removals are rare, so we just rebuild the table
+   */
+  binding_pool_rebuild_table (pool, pool->table_size);
 
-  g_hash_table_remove (pool->entries_hash, &remove_entry);
+  binding_entry_free (entry);
 }
 
 static gboolean
@@ -867,8 +941,6 @@ clutter_binding_pool_activate (ClutterBindingPool  *pool,
   g_return_val_if_fail (key_val != 0, FALSE);
   g_return_val_if_fail (G_IS_OBJECT (gobject), FALSE);
 
-  modifiers = (modifiers & BINDING_MOD_MASK);
-
   entry = binding_pool_lookup_entry (pool, key_val, modifiers);
   if (!entry)
     return FALSE;
@@ -43,36 +43,43 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
+#include <math.h>
+
 #include "clutter-blur-effect.h"
 
 #include "cogl/cogl.h"
 
 #include "clutter-debug.h"
-#include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
+#include "clutter-offscreen-pool.h"
 #include "clutter-private.h"
+#include "clutter-stage-private.h"
 
 #define BLUR_PADDING    2
 
-/* FIXME - lame shader; we should really have a decoupled
- * horizontal/vertical two pass shader for the gaussian blur
+/* the blur is computed using separable gaussian passes over a copy of
+ * the actor downsampled by a power of two, so that the number of taps
+ * of each pass and the number of pixels it covers stay bounded as the
+ * standard deviation grows.
+ *
+ * each pass samples between two texels, so that the linear filtering
+ * of the texture unit computes the sum of two weights with a single
+ * lookup; a pass with N pairs of taps covers a radius of 2 * N texels
  */
-static const gchar *box_blur_glsl_declarations =
-"uniform vec2 pixel_step;\n";
-#define SAMPLE(offx, offy) \
-  "cogl_texel += texture2D (cogl_sampler, cogl_tex_coord.st + pixel_step * " \
-  "vec2 (" G_STRINGIFY (offx) ", " G_STRINGIFY (offy) "));\n"
-static const gchar *box_blur_glsl_shader =
-"  cogl_texel = texture2D (cogl_sampler, cogl_tex_coord.st);\n"
-  SAMPLE (-1.0, -1.0)
-  SAMPLE ( 0.0, -1.0)
-  SAMPLE (+1.0, -1.0)
-  SAMPLE (-1.0,  0.0)
-  SAMPLE (+1.0,  0.0)
-  SAMPLE (-1.0, +1.0)
-  SAMPLE ( 0.0, +1.0)
-  SAMPLE (+1.0, +1.0)
-"  cogl_texel /= 9.0;\n";
-#undef SAMPLE
+#define MAX_TAP_PAIRS           6
+
+/* the largest standard deviation, in texels, covered by a single pass */
+#define MAX_PASS_SIGMA          ((MAX_TAP_PAIRS * 2) / 3.0)
+
+/* the standard deviation, in texels of the downsampled copy, over which
+ * the copy is downsampled again
+ */
+#define MAX_LEVEL_SIGMA         2.0
+
+#define MAX_DOWNSCALE           8
+
+#define MAX_SIGMA               64.0
+#define DEFAULT_SIGMA           1.0
 
 struct _ClutterBlurEffect
 {
@@ -81,11 +88,27 @@ struct _ClutterBlurEffect
   /* a back pointer to our actor, so that we can query it */
   ClutterActor *actor;
 
-  gint pixel_step_uniform;
+  gdouble sigma;
 
   gint tex_width;
   gint tex_height;
 
+  /* the blurred copy of the texture of the offscreen effect, at
+   * 1 / downscale of its size; it is updated only when the actor
+   * is painted offscreen again, or when the sigma changes
+   */
+  ClutterOffscreenTarget *blur_target;
+  gint downscale;
+  guint blur_dirty : 1;
+
+  /* set when the quality of the stage is too low to blur */
+  guint quality_disabled : 1;
+
+  /* the horizontal and the vertical passes */
+  CoglPipeline *pass_pipelines[2];
+  gint n_tap_pairs;
+
+  CoglPipeline *downsample_pipeline;
   CoglPipeline *pipeline;
 };
 
@@ -94,12 +117,316 @@ struct _ClutterBlurEffectClass
   ClutterOffscreenEffectClass parent_class;
 
   CoglPipeline *base_pipeline;
+
+  /* the pipelines of the passes, by number of pairs of taps */
+  CoglPipeline *base_pass_pipelines[MAX_TAP_PAIRS + 1];
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_SIGMA,
+
+  PROP_LAST
 };
 
+static GParamSpec *obj_props[PROP_LAST];
+
 G_DEFINE_TYPE (ClutterBlurEffect,
                clutter_blur_effect,
                CLUTTER_TYPE_OFFSCREEN_EFFECT);
 
+static gint
+get_padding (gdouble sigma)
+{
+  return (gint) ceil (sigma * 3.0) + BLUR_PADDING;
+}
+
+static CoglPipeline *
+get_base_pass_pipeline (ClutterBlurEffectClass *klass,
+                        gint                    n_tap_pairs)
+{
+  if (G_UNLIKELY (klass->base_pass_pipelines[n_tap_pairs] == NULL))
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+      CoglPipeline *pipeline;
+      CoglSnippet *snippet;
+      GString *declarations, *shader;
+      gint i;
+
+      declarations = g_string_new ("uniform vec2 pixel_step;\n");
+      g_string_append_printf (declarations,
+                              "uniform float weights[%d];\n"
+                              "uniform float offsets[%d];\n",
+                              n_tap_pairs + 1,
+                              n_tap_pairs + 1);
+
+      shader = g_string_new ("  cogl_texel = texture2D (cogl_sampler, "
+                             "cogl_tex_coord.st) * weights[0];\n");
+      for (i = 1; i <= n_tap_pairs; i++)
+        {
+          g_string_append_printf (shader,
+                                  "  cogl_texel += texture2D (cogl_sampler, "
+                                  "cogl_tex_coord.st + pixel_step * offsets[%d])"
+                                  " * weights[%d];\n",
+                                  i, i);
+          g_string_append_printf (shader,
+                                  "  cogl_texel += texture2D (cogl_sampler, "
+                                  "cogl_tex_coord.st - pixel_step * offsets[%d])"
+                                  " * weights[%d];\n",
+                                  i, i);
+        }
+
+      pipeline = cogl_pipeline_new (ctx);
+
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
+                                  declarations->str,
+                                  NULL);
+      cogl_snippet_set_replace (snippet, shader->str);
+      cogl_pipeline_add_layer_snippet (pipeline, 0, snippet);
+      cogl_object_unref (snippet);
+
+      cogl_pipeline_set_layer_null_texture (pipeline, 0, COGL_TEXTURE_TYPE_2D);
+      cogl_pipeline_set_layer_filters (pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+
+      /* the passes replace the contents of the targets */
+      cogl_pipeline_set_blend (pipeline, "RGBA = ADD (SRC_COLOR, 0)", NULL);
+
+      klass->base_pass_pipelines[n_tap_pairs] = pipeline;
+
+      g_string_free (declarations, TRUE);
+      g_string_free (shader, TRUE);
+    }
+
+  return klass->base_pass_pipelines[n_tap_pairs];
+}
+
+/* computes the weights and the offsets of the taps of a pass with the
+ * given standard deviation, and returns the number of pairs of taps
+ */
+static gint
+compute_kernel (gdouble  sigma,
+                gfloat  *weights,
+                gfloat  *offsets)
+{
+  gdouble values[MAX_TAP_PAIRS * 2 + 1];
+  gdouble sum;
+  gint radius, n_pairs, i;
+
+  radius = CLAMP ((gint) ceil (sigma * 3.0), 1, MAX_TAP_PAIRS * 2);
+  n_pairs = (radius + 1) / 2;
+
+  sum = values[0] = 1.0;
+  for (i = 1; i <= n_pairs * 2; i++)
+    {
+      values[i] = i <= radius ? exp (-(i * i) / (2.0 * sigma * sigma)) : 0.0;
+      sum += 2.0 * values[i];
+    }
+
+  weights[0] = values[0] / sum;
+  offsets[0] = 0.f;
+
+  for (i = 1; i <= n_pairs; i++)
+    {
+      gdouble a = values[i * 2 - 1];
+      gdouble b = values[i * 2];
+
+      weights[i] = (a + b) / sum;
+      offsets[i] = ((i * 2 - 1) * a + (i * 2) * b) / (a + b);
+    }
+
+  return n_pairs;
+}
+
+static void
+update_pass_pipelines (ClutterBlurEffect *self,
+                       gdouble            sigma)
+{
+  ClutterBlurEffectClass *klass = CLUTTER_BLUR_EFFECT_GET_CLASS (self);
+  gfloat weights[MAX_TAP_PAIRS + 1];
+  gfloat offsets[MAX_TAP_PAIRS + 1];
+  gint n_pairs, i;
+
+  n_pairs = compute_kernel (sigma, weights, offsets);
+
+  if (n_pairs != self->n_tap_pairs)
+    {
+      for (i = 0; i < 2; i++)
+        {
+          if (self->pass_pipelines[i] != NULL)
+            cogl_object_unref (self->pass_pipelines[i]);
+
+          self->pass_pipelines[i] =
+            cogl_pipeline_copy (get_base_pass_pipeline (klass, n_pairs));
+        }
+
+      self->n_tap_pairs = n_pairs;
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      CoglPipeline *pipeline = self->pass_pipelines[i];
+
+      cogl_pipeline_set_uniform_float (pipeline,
+                                       cogl_pipeline_get_uniform_location (pipeline, "weights"),
+                                       1, /* n_components */
+                                       n_pairs + 1,
+                                       weights);
+      cogl_pipeline_set_uniform_float (pipeline,
+                                       cogl_pipeline_get_uniform_location (pipeline, "offsets"),
+                                       1, /* n_components */
+                                       n_pairs + 1,
+                                       offsets);
+    }
+}
+
+/* draws the top left @width x @height texels of a new target using
+ * @pipeline, mapping them to the [0, @s] x [0, @t] region of @source
+ */
+static ClutterOffscreenTarget *
+draw_target (ClutterOffscreenPool *pool,
+             CoglPipeline         *pipeline,
+             CoglTexture          *source,
+             gfloat                s,
+             gfloat                t,
+             gint                  width,
+             gint                  height)
+{
+  ClutterOffscreenTarget *target;
+  CoglFramebuffer *fb;
+
+  target = _clutter_offscreen_pool_acquire (pool, width, height,
+                                            COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (target == NULL)
+    return NULL;
+
+  fb = COGL_FRAMEBUFFER (target->offscreen);
+
+  /* the targets are shared with the other effects, which leave their
+   * own transformations behind
+   */
+  cogl_framebuffer_set_viewport (fb, 0, 0, target->width, target->height);
+  cogl_framebuffer_orthographic (fb, 0, 0, target->width, target->height,
+                                 -1, 100);
+  cogl_framebuffer_identity_matrix (fb);
+
+  /* the texels outside of the drawn region are sampled by the passes */
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR, 0.f, 0.f, 0.f, 0.f);
+
+  cogl_pipeline_set_layer_texture (pipeline, 0, source);
+  cogl_framebuffer_draw_textured_rectangle (fb, pipeline,
+                                            0, 0, width, height,
+                                            0, 0, s, t);
+
+  return target;
+}
+
+static gboolean
+clutter_blur_effect_update_blur (ClutterBlurEffect *self)
+{
+  ClutterOffscreenPool *pool;
+  ClutterOffscreenTarget *source_target = NULL, *target;
+  CoglTexture *source;
+  ClutterActor *stage;
+  gdouble sigma;
+  gint width, height, i, n_passes;
+  gfloat s, t;
+
+  stage = clutter_actor_get_stage (self->actor);
+  if (stage == NULL)
+    return FALSE;
+
+  pool = _clutter_stage_get_offscreen_pool (CLUTTER_STAGE (stage));
+
+  source = clutter_offscreen_effect_get_texture (CLUTTER_OFFSCREEN_EFFECT (self));
+  width = self->tex_width;
+  height = self->tex_height;
+  s = t = 1.f;
+
+  /* each halving averages 2x2 texels with a single linear lookup */
+  sigma = self->sigma;
+  for (self->downscale = 1;
+       self->downscale < MAX_DOWNSCALE && sigma > MAX_LEVEL_SIGMA;
+       self->downscale *= 2)
+    {
+      gint half_width = MAX ((width + 1) / 2, 1);
+      gint half_height = MAX ((height + 1) / 2, 1);
+
+      target = draw_target (pool, self->downsample_pipeline, source,
+                            s * half_width * 2.f / width,
+                            t * half_height * 2.f / height,
+                            half_width, half_height);
+
+      if (source_target != NULL)
+        _clutter_offscreen_target_release (source_target);
+
+      if (target == NULL)
+        return FALSE;
+
+      source_target = target;
+      source = target->texture;
+      width = half_width;
+      height = half_height;
+      s = (gfloat) width / target->width;
+      t = (gfloat) height / target->height;
+
+      sigma /= 2.0;
+    }
+
+  /* passes compose: the variances of the passes add up */
+  n_passes = (gint) ceil ((sigma * sigma) / (MAX_PASS_SIGMA * MAX_PASS_SIGMA));
+  n_passes = MAX (n_passes, 1);
+
+  update_pass_pipelines (self, sigma / sqrt (n_passes));
+
+  for (i = 0; i < n_passes * 2; i++)
+    {
+      CoglPipeline *pipeline = self->pass_pipelines[i % 2];
+      gfloat pixel_step[2];
+
+      pixel_step[0] = i % 2 == 0 ? s / width : 0.f;
+      pixel_step[1] = i % 2 == 0 ? 0.f : t / height;
+
+      cogl_pipeline_set_uniform_float (pipeline,
+                                       cogl_pipeline_get_uniform_location (pipeline, "pixel_step"),
+                                       2, /* n_components */
+                                       1, /* count */
+                                       pixel_step);
+
+      target = draw_target (pool, pipeline, source, s, t, width, height);
+
+      if (source_target != NULL)
+        _clutter_offscreen_target_release (source_target);
+
+      if (target == NULL)
+        return FALSE;
+
+      source_target = target;
+      source = target->texture;
+      s = (gfloat) width / target->width;
+      t = (gfloat) height / target->height;
+    }
+
+  if (self->blur_target != NULL)
+    _clutter_offscreen_target_release (self->blur_target);
+
+  self->blur_target = source_target;
+
+  CLUTTER_NOTE (PAINT, "Blurred %dx%d texels at 1/%d with %d passes of %d taps",
+                self->tex_width, self->tex_height,
+                self->downscale,
+                n_passes * 2,
+                self->n_tap_pairs * 2 + 1);
+
+  return TRUE;
+}
+
 static gboolean
 clutter_blur_effect_pre_paint (ClutterEffect *effect)
 {
@@ -113,6 +440,10 @@ clutter_blur_effect_pre_paint (ClutterEffect *effect)
   if (self->actor == NULL)
     return FALSE;
 
+  /* paint the actor directly, without going offscreen */
+  if (self->quality_disabled)
+    return FALSE;
+
   if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
     {
       /* if we don't have support for GLSL shaders then we
@@ -136,21 +467,8 @@ clutter_blur_effect_pre_paint (ClutterEffect *effect)
       self->tex_width = cogl_texture_get_width (texture);
       self->tex_height = cogl_texture_get_height (texture);
 
-      if (self->pixel_step_uniform > -1)
-        {
-          gfloat pixel_step[2];
-
-          pixel_step[0] = 1.0f / self->tex_width;
-          pixel_step[1] = 1.0f / self->tex_height;
-
-          cogl_pipeline_set_uniform_float (self->pipeline,
-                                           self->pixel_step_uniform,
-                                           2, /* n_components */
-                                           1, /* count */
-                                           pixel_step);
-        }
-
-      cogl_pipeline_set_layer_texture (self->pipeline, 0, texture);
+      /* the contents of the texture are going to change */
+      self->blur_dirty = TRUE;
 
       return TRUE;
     }
@@ -162,7 +480,37 @@ static void
 clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  ClutterOffscreenEffectClass *parent_class;
   guint8 paint_opacity;
+  gfloat s, t;
+
+  if (self->quality_disabled)
+    {
+      parent_class =
+        CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_blur_effect_parent_class);
+      parent_class->paint_target (effect);
+      return;
+    }
+
+  if (self->sigma > 0.0 && (self->blur_dirty || self->blur_target == NULL))
+    {
+      if (!clutter_blur_effect_update_blur (self) &&
+          self->blur_target != NULL)
+        {
+          _clutter_offscreen_target_release (self->blur_target);
+          self->blur_target = NULL;
+        }
+
+      self->blur_dirty = FALSE;
+    }
+
+  if (self->sigma <= 0.0 || self->blur_target == NULL)
+    {
+      parent_class =
+        CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_blur_effect_parent_class);
+      parent_class->paint_target (effect);
+      return;
+    }
 
   paint_opacity = clutter_actor_get_paint_opacity (self->actor);
 
@@ -171,28 +519,62 @@ clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect)
                               paint_opacity,
                               paint_opacity,
                               paint_opacity);
+  cogl_pipeline_set_layer_texture (self->pipeline, 0,
+                                   self->blur_target->texture);
   cogl_push_source (self->pipeline);
 
-  cogl_rectangle (0, 0, self->tex_width, self->tex_height);
+  /* the linear filtering upsamples the blurred copy */
+  s = (gfloat) self->tex_width / self->downscale / self->blur_target->width;
+  t = (gfloat) self->tex_height / self->downscale / self->blur_target->height;
+
+  cogl_rectangle_with_texture_coords (0, 0,
+                                      self->tex_width, self->tex_height,
+                                      0, 0, s, t);
 
   cogl_pop_source ();
 }
 
+static void
+clutter_blur_effect_set_quality (ClutterEffect       *effect,
+                                 ClutterQualityLevel  level)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  gboolean disabled = level >= CLUTTER_QUALITY_LOW;
+
+  CLUTTER_EFFECT_CLASS (clutter_blur_effect_parent_class)->set_quality (effect, level);
+
+  if (self->quality_disabled == disabled)
+    return;
+
+  self->quality_disabled = disabled;
+
+  /* the fbo was not updated while the blur was disabled */
+  if (!disabled)
+    {
+      _clutter_offscreen_effect_invalidate (CLUTTER_OFFSCREEN_EFFECT (effect));
+      self->blur_dirty = TRUE;
+    }
+}
+
 static gboolean
 clutter_blur_effect_get_paint_volume (ClutterEffect      *effect,
                                       ClutterPaintVolume *volume)
 {
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
   gfloat cur_width, cur_height;
   ClutterVertex origin;
+  gint padding;
+
+  padding = get_padding (self->sigma);
 
   clutter_paint_volume_get_origin (volume, &origin);
   cur_width = clutter_paint_volume_get_width (volume);
   cur_height = clutter_paint_volume_get_height (volume);
 
-  origin.x -= BLUR_PADDING;
-  origin.y -= BLUR_PADDING;
-  cur_width += 2 * BLUR_PADDING;
-  cur_height += 2 * BLUR_PADDING;
+  origin.x -= padding;
+  origin.y -= padding;
+  cur_width += 2 * padding;
+  cur_height += 2 * padding;
   clutter_paint_volume_set_origin (volume, &origin);
   clutter_paint_volume_set_width (volume, cur_width);
   clutter_paint_volume_set_height (volume, cur_height);
@@ -204,6 +586,30 @@ static void
 clutter_blur_effect_dispose (GObject *gobject)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
+  gint i;
+
+  if (self->blur_target != NULL)
+    {
+      _clutter_offscreen_target_release (self->blur_target);
+      self->blur_target = NULL;
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      if (self->pass_pipelines[i] != NULL)
+        {
+          cogl_object_unref (self->pass_pipelines[i]);
+          self->pass_pipelines[i] = NULL;
+        }
+    }
+
+  self->n_tap_pairs = 0;
+
+  if (self->downsample_pipeline != NULL)
+    {
+      cogl_object_unref (self->downsample_pipeline);
+      self->downsample_pipeline = NULL;
+    }
 
   if (self->pipeline != NULL)
     {
@@ -214,6 +620,46 @@ clutter_blur_effect_dispose (GObject *gobject)
   G_OBJECT_CLASS (clutter_blur_effect_parent_class)->dispose (gobject);
 }
 
+static void
+clutter_blur_effect_set_property (GObject      *gobject,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  ClutterBlurEffect *effect = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SIGMA:
+      clutter_blur_effect_set_sigma (effect, g_value_get_double (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_blur_effect_get_property (GObject    *gobject,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  ClutterBlurEffect *effect = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_SIGMA:
+      g_value_set_double (value, effect->sigma);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
 static void
 clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
 {
@@ -222,12 +668,34 @@ clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
   ClutterOffscreenEffectClass *offscreen_class;
 
   gobject_class->dispose = clutter_blur_effect_dispose;
+  gobject_class->set_property = clutter_blur_effect_set_property;
+  gobject_class->get_property = clutter_blur_effect_get_property;
 
   effect_class->pre_paint = clutter_blur_effect_pre_paint;
   effect_class->get_paint_volume = clutter_blur_effect_get_paint_volume;
+  effect_class->set_quality = clutter_blur_effect_set_quality;
 
   offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
   offscreen_class->paint_target = clutter_blur_effect_paint_target;
+
+  /**
+   * ClutterBlurEffect:sigma:
+   *
+   * The standard deviation of the gaussian blur, in pixels. The blur
+   * extends to about three times the standard deviation around the
+   * actor; a value of 0.0 disables the blur.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_SIGMA] =
+    g_param_spec_double ("sigma",
+                         P_("Sigma"),
+                         P_("The standard deviation of the blur"),
+                         0.0, MAX_SIGMA,
+                         DEFAULT_SIGMA,
+                         CLUTTER_PARAM_READWRITE);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 }
 
 static void
@@ -237,28 +705,30 @@ clutter_blur_effect_init (ClutterBlurEffect *self)
 
   if (G_UNLIKELY (klass->base_pipeline == NULL))
     {
-      CoglSnippet *snippet;
       CoglContext *ctx =
         clutter_backend_get_cogl_context (clutter_get_default_backend ());
 
       klass->base_pipeline = cogl_pipeline_new (ctx);
 
-      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
-                                  box_blur_glsl_declarations,
-                                  NULL);
-      cogl_snippet_set_replace (snippet, box_blur_glsl_shader);
-      cogl_pipeline_add_layer_snippet (klass->base_pipeline, 0, snippet);
-      cogl_object_unref (snippet);
-
       cogl_pipeline_set_layer_null_texture (klass->base_pipeline,
                                             0, /* layer number */
                                             COGL_TEXTURE_TYPE_2D);
+      cogl_pipeline_set_layer_filters (klass->base_pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (klass->base_pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
     }
 
+  self->sigma = DEFAULT_SIGMA;
+  self->downscale = 1;
+
   self->pipeline = cogl_pipeline_copy (klass->base_pipeline);
 
-  self->pixel_step_uniform =
-    cogl_pipeline_get_uniform_location (self->pipeline, "pixel_step");
+  self->downsample_pipeline = cogl_pipeline_copy (klass->base_pipeline);
+  cogl_pipeline_set_blend (self->downsample_pipeline,
+                           "RGBA = ADD (SRC_COLOR, 0)",
+                           NULL);
 }
 
 /**
@@ -276,3 +746,61 @@ clutter_blur_effect_new (void)
 {
   return g_object_new (CLUTTER_TYPE_BLUR_EFFECT, NULL);
 }
+
+/**
+ * clutter_blur_effect_set_sigma:
+ * @effect: a #ClutterBlurEffect
+ * @sigma: the standard deviation of the blur, in pixels
+ *
+ * Sets the standard deviation of the gaussian blur applied by @effect.
+ *
+ * Large values are handled by blurring a downsampled copy of the
+ * actor, so that the cost of the blur does not grow with @sigma.
+ *
+ * Since: 1.26
+ */
+void
+clutter_blur_effect_set_sigma (ClutterBlurEffect *effect,
+                               gdouble            sigma)
+{
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+  g_return_if_fail (sigma >= 0.0 && sigma <= MAX_SIGMA);
+
+  if (fabs (effect->sigma - sigma) >= 0.00001)
+    {
+      ClutterActor *actor;
+      gboolean padding_changed;
+
+      padding_changed = get_padding (effect->sigma) != get_padding (sigma);
+
+      effect->sigma = sigma;
+      effect->blur_dirty = TRUE;
+
+      /* a larger blur needs a larger offscreen buffer */
+      actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+      if (padding_changed && actor != NULL)
+        clutter_actor_queue_redraw (actor);
+      else
+        clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
+
+      g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_SIGMA]);
+    }
+}
+
+/**
+ * clutter_blur_effect_get_sigma:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the standard deviation of the blur applied by @effect.
+ *
+ * Return value: the standard deviation, in pixels
+ *
+ * Since: 1.26
+ */
+gdouble
+clutter_blur_effect_get_sigma (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 0.0);
+
+  return effect->sigma;
+}
@@ -54,6 +54,12 @@ GType clutter_blur_effect_get_type (void) G_GNUC_CONST;
 CLUTTER_AVAILABLE_IN_1_4
 ClutterEffect *clutter_blur_effect_new (void);
 
+CLUTTER_AVAILABLE_IN_1_26
+void clutter_blur_effect_set_sigma (ClutterBlurEffect *effect,
+                                    gdouble            sigma);
+CLUTTER_AVAILABLE_IN_1_26
+gdouble clutter_blur_effect_get_sigma (ClutterBlurEffect *effect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_BLUR_EFFECT_H__ */
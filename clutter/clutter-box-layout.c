@@ -64,6 +64,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-layout-meta.h"
+#include "clutter-measure-pool.h"
 #include "clutter-private.h"
 #include "clutter-types.h"
 
@@ -464,6 +465,43 @@ get_child_size (ClutterActor       *actor,
     clutter_actor_get_preferred_height (actor, for_size, min_size_p, natural_size_p);
 }
 
+/* measures the visible children of @container for @for_size using the
+ * measure pool, so that the following get_child_size() calls are hits
+ * in the size request caches of the children
+ */
+static void
+measure_children (ClutterActor       *container,
+                  ClutterOrientation  orientation,
+                  gfloat              for_size)
+{
+  ClutterMeasureRequest *requests;
+  ClutterActorIter iter;
+  ClutterActor *child;
+  guint n_requests = 0;
+
+  if (!_clutter_measure_pool_is_enabled ())
+    return;
+
+  requests = g_new (ClutterMeasureRequest,
+                    clutter_actor_get_n_children (container));
+
+  clutter_actor_iter_init (&iter, container);
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      if (!clutter_actor_is_visible (child))
+        continue;
+
+      requests[n_requests].actor = child;
+      requests[n_requests].orientation = orientation;
+      requests[n_requests].for_size = for_size;
+      n_requests += 1;
+    }
+
+  _clutter_measure_pool_run (requests, n_requests);
+
+  g_free (requests);
+}
+
 /* Handle the request in the orientation of the box (i.e. width request of horizontal box) */
 static void
 get_preferred_size_for_orientation (ClutterBoxLayout   *self,
@@ -480,6 +518,8 @@ get_preferred_size_for_orientation (ClutterBoxLayout   *self,
 
   minimum = natural = 0;
 
+  measure_children (container, priv->orientation, for_size);
+
   clutter_actor_iter_init (&iter, container);
   while (clutter_actor_iter_next (&iter, &child))
     {
@@ -528,6 +568,8 @@ get_base_size_for_opposite_orientation (ClutterBoxLayout   *self,
 
   minimum = natural = 0;
 
+  measure_children (container, opposite_orientation, -1);
+
   clutter_actor_iter_init (&iter, container);
   while (clutter_actor_iter_next (&iter, &child))
     {
@@ -650,7 +692,7 @@ get_preferred_size_for_opposite_orientation (ClutterBoxLayout   *self,
       if (!clutter_actor_is_visible (child))
         continue;
 
-      meta      = clutter_layout_manager_get_child_meta (layout, real_container, child);
+      meta      = _clutter_layout_manager_get_child_meta (layout, real_container, child);
       box_child = CLUTTER_BOX_CHILD (meta);
 
       if (priv->is_homogeneous)
@@ -706,6 +748,32 @@ get_preferred_size_for_opposite_orientation (ClutterBoxLayout   *self,
     *natural_size_p = natural;
 }
 
+/* the animations of the allocations are driven by the layout manager,
+ * unless the easing mode is a logical id of clutter_alpha_register_func(),
+ * which only the easing state of the children can use
+ */
+static inline gboolean
+box_layout_uses_child_easing (ClutterBoxLayout *self)
+{
+  return self->priv->use_animations &&
+         (self->priv->easing_mode == CLUTTER_CUSTOM_MODE ||
+          self->priv->easing_mode >= CLUTTER_ANIMATION_LAST);
+}
+
+static void
+box_layout_update_allocation_easing (ClutterBoxLayout *self)
+{
+  ClutterBoxLayoutPrivate *priv = self->priv;
+
+  if (priv->use_animations && !box_layout_uses_child_easing (self))
+    clutter_layout_manager_set_allocation_easing (CLUTTER_LAYOUT_MANAGER (self),
+                                                  priv->easing_mode,
+                                                  priv->easing_duration);
+  else
+    clutter_layout_manager_set_allocation_easing (CLUTTER_LAYOUT_MANAGER (self),
+                                                  CLUTTER_LINEAR,
+                                                  0);
+}
 
 static void
 allocate_box_child (ClutterBoxLayout       *self,
@@ -717,6 +785,7 @@ allocate_box_child (ClutterBoxLayout       *self,
   ClutterBoxLayoutPrivate *priv = self->priv;
   ClutterBoxChild *box_child;
   ClutterLayoutMeta *meta;
+  gboolean child_easing;
 
   meta = clutter_layout_manager_get_child_meta (CLUTTER_LAYOUT_MANAGER (self),
                                                 container,
@@ -729,7 +798,8 @@ allocate_box_child (ClutterBoxLayout       *self,
                 child_box->x2 - child_box->x1,
                 child_box->y2 - child_box->y1);
 
-  if (priv->use_animations)
+  child_easing = box_layout_uses_child_easing (self);
+  if (child_easing)
     {
       clutter_actor_save_easing_state (child);
       clutter_actor_set_easing_mode (child, priv->easing_mode);
@@ -750,7 +820,7 @@ allocate_box_child (ClutterBoxLayout       *self,
                                        box_child->y_fill,
                                        flags);
 
-  if (priv->use_animations)
+  if (child_easing)
     clutter_actor_restore_easing_state (child);
 }
 
@@ -825,9 +895,9 @@ count_expand_children (ClutterLayoutManager *layout,
 
           *visible_children += 1;
 
-          meta = clutter_layout_manager_get_child_meta (layout,
-                                                        container,
-                                                        child);
+          meta = _clutter_layout_manager_get_child_meta (layout,
+                                                         container,
+                                                         child);
 
           if (clutter_actor_needs_expand (child, priv->orientation) ||
               CLUTTER_BOX_CHILD (meta)->expand)
@@ -1113,9 +1183,9 @@ clutter_box_layout_allocate (ClutterLayoutManager   *layout,
       if (!clutter_actor_is_visible (child))
         continue;
 
-      meta = clutter_layout_manager_get_child_meta (layout,
-                                                    container,
-                                                    child);
+      meta = _clutter_layout_manager_get_child_meta (layout,
+                                                     container,
+                                                     child);
       box_child = CLUTTER_BOX_CHILD (meta);
 
       /* Assign the child's size. */
@@ -2183,7 +2253,8 @@ clutter_box_layout_get_expand (ClutterBoxLayout *layout,
  *
  * Enabling animations will override the easing state of each child
  * of the actor using @layout, and will use the #ClutterBoxLayout:easing-mode
- * and #ClutterBoxLayout:easing-duration properties instead.
+ * and #ClutterBoxLayout:easing-duration properties instead; see
+ * clutter_layout_manager_set_allocation_easing().
  *
  * Since: 1.2
  *
@@ -2204,6 +2275,8 @@ clutter_box_layout_set_use_animations (ClutterBoxLayout *layout,
     {
       priv->use_animations = animate;
 
+      box_layout_update_allocation_easing (layout);
+
       g_object_notify (G_OBJECT (layout), "use-animations");
     }
 }
@@ -2256,6 +2329,9 @@ clutter_box_layout_set_easing_mode (ClutterBoxLayout *layout,
     {
       priv->easing_mode = mode;
 
+      if (priv->use_animations)
+        box_layout_update_allocation_easing (layout);
+
       g_object_notify (G_OBJECT (layout), "easing-mode");
     }
 }
@@ -2308,6 +2384,9 @@ clutter_box_layout_set_easing_duration (ClutterBoxLayout *layout,
     {
       priv->easing_duration = msecs;
 
+      if (priv->use_animations)
+        box_layout_update_allocation_easing (layout);
+
       g_object_notify (G_OBJECT (layout), "easing-duration");
     }
 }
@@ -0,0 +1,258 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_BOX4_PRIVATE_H__
+#define __CLUTTER_BOX4_PRIVATE_H__
+
+#include <math.h>
+#include <cairo.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define CLUTTER_BOX4_USE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CLUTTER_BOX4_USE_NEON 1
+#endif
+
+#include "clutter-types.h"
+
+G_BEGIN_DECLS
+
+/*< private >
+ * ClutterBox4:
+ *
+ * A box stored as the four lanes (x1, y1, -x2, -y2) of a vector, so
+ * that the union of two boxes is the minimum of their lanes and the
+ * intersection is the maximum, and rounding a box outwards to whole
+ * pixels is the floor of its lanes.
+ *
+ * The rounding is only exact for coordinates that fit in 32 bit
+ * integers, which is always the case for stage coordinates.
+ *
+ * ClutterBox4i is the same, with integer lanes, for the rectangles
+ * of the redraw clips.
+ */
+typedef union _ClutterBox4
+{
+  float v[4];
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  __m128 m;
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  float32x4_t m;
+#endif
+} ClutterBox4;
+
+typedef union _ClutterBox4i
+{
+  int v[4];
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  __m128i m;
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  int32x4_t m;
+#endif
+} ClutterBox4i;
+
+static inline ClutterBox4
+_clutter_box4_init (float x1,
+                    float y1,
+                    float x2,
+                    float y2)
+{
+  ClutterBox4 res;
+
+  res.v[0] = x1;
+  res.v[1] = y1;
+  res.v[2] = -x2;
+  res.v[3] = -y2;
+
+  return res;
+}
+
+static inline ClutterBox4
+_clutter_box4_from_actor_box (const ClutterActorBox *box)
+{
+  return _clutter_box4_init (box->x1, box->y1, box->x2, box->y2);
+}
+
+static inline void
+_clutter_box4_to_actor_box (ClutterBox4      box,
+                            ClutterActorBox *res)
+{
+  res->x1 = box.v[0];
+  res->y1 = box.v[1];
+  res->x2 = -box.v[2];
+  res->y2 = -box.v[3];
+}
+
+static inline ClutterBox4
+_clutter_box4_union (ClutterBox4 a,
+                     ClutterBox4 b)
+{
+  ClutterBox4 res;
+
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  res.m = _mm_min_ps (a.m, b.m);
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  res.m = vminq_f32 (a.m, b.m);
+#else
+  int i;
+
+  for (i = 0; i < 4; i++)
+    res.v[i] = MIN (a.v[i], b.v[i]);
+#endif
+
+  return res;
+}
+
+static inline ClutterBox4
+_clutter_box4_intersect (ClutterBox4 a,
+                         ClutterBox4 b)
+{
+  ClutterBox4 res;
+
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  res.m = _mm_max_ps (a.m, b.m);
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  res.m = vmaxq_f32 (a.m, b.m);
+#else
+  int i;
+
+  for (i = 0; i < 4; i++)
+    res.v[i] = MAX (a.v[i], b.v[i]);
+#endif
+
+  return res;
+}
+
+/* floors x1 and y1, and ceils x2 and y2 */
+static inline ClutterBox4
+_clutter_box4_round_out (ClutterBox4 box)
+{
+  ClutterBox4 res;
+
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  __m128 t = _mm_cvtepi32_ps (_mm_cvttps_epi32 (box.m));
+
+  /* the truncation rounds the negative values up */
+  res.m = _mm_sub_ps (t, _mm_and_ps (_mm_cmpgt_ps (t, box.m),
+                                     _mm_set1_ps (1.f)));
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  float32x4_t t = vcvtq_f32_s32 (vcvtq_s32_f32 (box.m));
+  uint32x4_t up = vcgtq_f32 (t, box.m);
+
+  res.m = vsubq_f32 (t, vreinterpretq_f32_u32 (vandq_u32 (up,
+                                                          vreinterpretq_u32_f32 (vdupq_n_f32 (1.f)))));
+#else
+  int i;
+
+  for (i = 0; i < 4; i++)
+    res.v[i] = floorf (box.v[i]);
+#endif
+
+  return res;
+}
+
+static inline gboolean
+_clutter_box4_is_empty (ClutterBox4 box)
+{
+  return box.v[0] + box.v[2] >= 0.f || box.v[1] + box.v[3] >= 0.f;
+}
+
+static inline ClutterBox4i
+_clutter_box4i_from_rectangle (const cairo_rectangle_int_t *rect)
+{
+  ClutterBox4i res;
+
+  res.v[0] = rect->x;
+  res.v[1] = rect->y;
+  res.v[2] = -(rect->x + rect->width);
+  res.v[3] = -(rect->y + rect->height);
+
+  return res;
+}
+
+static inline void
+_clutter_box4i_to_rectangle (ClutterBox4i           box,
+                             cairo_rectangle_int_t *res)
+{
+  res->x = box.v[0];
+  res->y = box.v[1];
+  res->width = -box.v[2] - box.v[0];
+  res->height = -box.v[3] - box.v[1];
+}
+
+static inline ClutterBox4i
+_clutter_box4i_union (ClutterBox4i a,
+                      ClutterBox4i b)
+{
+  ClutterBox4i res;
+
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  /* SSE2 has no 32 bit minimum, so pick the lanes with a mask */
+  __m128i a_greater = _mm_cmpgt_epi32 (a.m, b.m);
+
+  res.m = _mm_or_si128 (_mm_and_si128 (a_greater, b.m),
+                        _mm_andnot_si128 (a_greater, a.m));
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  res.m = vminq_s32 (a.m, b.m);
+#else
+  int i;
+
+  for (i = 0; i < 4; i++)
+    res.v[i] = MIN (a.v[i], b.v[i]);
+#endif
+
+  return res;
+}
+
+static inline ClutterBox4i
+_clutter_box4i_intersect (ClutterBox4i a,
+                          ClutterBox4i b)
+{
+  ClutterBox4i res;
+
+#if defined(CLUTTER_BOX4_USE_SSE2)
+  __m128i a_greater = _mm_cmpgt_epi32 (a.m, b.m);
+
+  res.m = _mm_or_si128 (_mm_and_si128 (a_greater, a.m),
+                        _mm_andnot_si128 (a_greater, b.m));
+#elif defined(CLUTTER_BOX4_USE_NEON)
+  res.m = vmaxq_s32 (a.m, b.m);
+#else
+  int i;
+
+  for (i = 0; i < 4; i++)
+    res.v[i] = MAX (a.v[i], b.v[i]);
+#endif
+
+  return res;
+}
+
+static inline gboolean
+_clutter_box4i_is_empty (ClutterBox4i box)
+{
+  return box.v[0] + box.v[2] >= 0 || box.v[1] + box.v[3] >= 0;
+}
+
+G_END_DECLS
+
+#endif /* __CLUTTER_BOX4_PRIVATE_H__ */
@@ -52,6 +52,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterBrightnessContrastEffect
@@ -82,6 +83,11 @@ struct _ClutterBrightnessContrastEffectClass
   ClutterOffscreenEffectClass parent_class;
 
   CoglPipeline *base_pipeline;
+
+  /* the snippet of the base pipeline, also used when the effect is
+   * fused with other pointwise effects
+   */
+  CoglSnippet *snippet;
 };
 
 /* Brightness effects in GLSL.
@@ -287,65 +293,6 @@ clutter_brightness_contrast_effect_get_property (GObject    *gobject,
     }
 }
 
-static void
-clutter_brightness_contrast_effect_class_init (ClutterBrightnessContrastEffectClass *klass)
-{
-  ClutterEffectClass *effect_class = CLUTTER_EFFECT_CLASS (klass);
-  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
-  ClutterOffscreenEffectClass *offscreen_class;
-
-  offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
-  offscreen_class->paint_target = clutter_brightness_contrast_effect_paint_target;
-
-  effect_class->pre_paint = clutter_brightness_contrast_effect_pre_paint;
-
-  gobject_class->set_property = clutter_brightness_contrast_effect_set_property;
-  gobject_class->get_property = clutter_brightness_contrast_effect_get_property;
-  gobject_class->dispose = clutter_brightness_contrast_effect_dispose;
-
-  /**
-   * ClutterBrightnessContrastEffect:brightness:
-   *
-   * The brightness change to apply to the effect.
-   *
-   * This property uses a #ClutterColor to represent the changes to each
-   * color channel. The range is [ 0, 255 ], with 127 as the value used
-   * to indicate no change; values smaller than 127 indicate a decrease
-   * in brightness, and values larger than 127 indicate an increase in
-   * brightness.
-   *
-   * Since: 1.10
-   */
-  obj_props[PROP_BRIGHTNESS] =
-    clutter_param_spec_color ("brightness",
-                              P_("Brightness"),
-                              P_("The brightness change to apply"),
-                              &no_brightness_change,
-                              CLUTTER_PARAM_READWRITE);
-
-  /**
-   * ClutterBrightnessContrastEffect:contrast:
-   *
-   * The contrast change to apply to the effect.
-   *
-   * This property uses a #ClutterColor to represent the changes to each
-   * color channel. The range is [ 0, 255 ], with 127 as the value used
-   * to indicate no change; values smaller than 127 indicate a decrease
-   * in contrast, and values larger than 127 indicate an increase in
-   * contrast.
-   *
-   * Since: 1.10
-   */
-  obj_props[PROP_CONTRAST] =
-    clutter_param_spec_color ("contrast",
-                              P_("Contrast"),
-                              P_("The contrast change to apply"),
-                              &no_contrast_change,
-                              CLUTTER_PARAM_READWRITE);
-
-  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
-}
-
 static void
 get_brightness_values (gfloat  value,
                        gfloat *multiplier,
@@ -364,7 +311,8 @@ get_brightness_values (gfloat  value,
 }
 
 static inline void
-update_uniforms (ClutterBrightnessContrastEffect *self)
+update_uniforms (ClutterBrightnessContrastEffect *self,
+                 CoglPipeline                    *pipeline)
 {
   if (self->brightness_multiplier_uniform > -1 &&
       self->brightness_offset_uniform > -1)
@@ -382,12 +330,12 @@ update_uniforms (ClutterBrightnessContrastEffect *self)
                              brightness_multiplier + 2,
                              brightness_offset + 2);
 
-      cogl_pipeline_set_uniform_float (self->pipeline,
+      cogl_pipeline_set_uniform_float (pipeline,
                                        self->brightness_multiplier_uniform,
                                        3, /* n_components */
                                        1, /* count */
                                        brightness_multiplier);
-      cogl_pipeline_set_uniform_float (self->pipeline,
+      cogl_pipeline_set_uniform_float (pipeline,
                                        self->brightness_offset_uniform,
                                        3, /* n_components */
                                        1, /* count */
@@ -402,7 +350,7 @@ update_uniforms (ClutterBrightnessContrastEffect *self)
         tan ((self->contrast_blue + 1) * G_PI_4)
       };
 
-      cogl_pipeline_set_uniform_float (self->pipeline,
+      cogl_pipeline_set_uniform_float (pipeline,
                                        self->contrast_uniform,
                                        3, /* n_components */
                                        1, /* count */
@@ -410,6 +358,93 @@ update_uniforms (ClutterBrightnessContrastEffect *self)
     }
 }
 
+static CoglSnippet *
+clutter_brightness_contrast_effect_get_snippet (ClutterOffscreenEffect *effect)
+{
+  return CLUTTER_BRIGHTNESS_CONTRAST_EFFECT_GET_CLASS (effect)->snippet;
+}
+
+static void
+clutter_brightness_contrast_effect_set_uniforms (ClutterOffscreenEffect *effect,
+                                                 CoglPipeline           *pipeline)
+{
+  update_uniforms (CLUTTER_BRIGHTNESS_CONTRAST_EFFECT (effect), pipeline);
+}
+
+static gboolean
+clutter_brightness_contrast_effect_is_active (ClutterOffscreenEffect *effect)
+{
+  return !will_have_no_effect (CLUTTER_BRIGHTNESS_CONTRAST_EFFECT (effect));
+}
+
+static const ClutterPointwiseEffectFuncs pointwise_funcs = {
+  clutter_brightness_contrast_effect_get_snippet,
+  clutter_brightness_contrast_effect_set_uniforms,
+  clutter_brightness_contrast_effect_is_active
+};
+
+static void
+clutter_brightness_contrast_effect_class_init (ClutterBrightnessContrastEffectClass *klass)
+{
+  ClutterEffectClass *effect_class = CLUTTER_EFFECT_CLASS (klass);
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterOffscreenEffectClass *offscreen_class;
+
+  offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
+  offscreen_class->paint_target = clutter_brightness_contrast_effect_paint_target;
+
+  _clutter_offscreen_effect_class_set_pointwise (offscreen_class,
+                                                 &pointwise_funcs);
+
+  effect_class->pre_paint = clutter_brightness_contrast_effect_pre_paint;
+
+  gobject_class->set_property = clutter_brightness_contrast_effect_set_property;
+  gobject_class->get_property = clutter_brightness_contrast_effect_get_property;
+  gobject_class->dispose = clutter_brightness_contrast_effect_dispose;
+
+  /**
+   * ClutterBrightnessContrastEffect:brightness:
+   *
+   * The brightness change to apply to the effect.
+   *
+   * This property uses a #ClutterColor to represent the changes to each
+   * color channel. The range is [ 0, 255 ], with 127 as the value used
+   * to indicate no change; values smaller than 127 indicate a decrease
+   * in brightness, and values larger than 127 indicate an increase in
+   * brightness.
+   *
+   * Since: 1.10
+   */
+  obj_props[PROP_BRIGHTNESS] =
+    clutter_param_spec_color ("brightness",
+                              P_("Brightness"),
+                              P_("The brightness change to apply"),
+                              &no_brightness_change,
+                              CLUTTER_PARAM_READWRITE);
+
+  /**
+   * ClutterBrightnessContrastEffect:contrast:
+   *
+   * The contrast change to apply to the effect.
+   *
+   * This property uses a #ClutterColor to represent the changes to each
+   * color channel. The range is [ 0, 255 ], with 127 as the value used
+   * to indicate no change; values smaller than 127 indicate a decrease
+   * in contrast, and values larger than 127 indicate an increase in
+   * contrast.
+   *
+   * Since: 1.10
+   */
+  obj_props[PROP_CONTRAST] =
+    clutter_param_spec_color ("contrast",
+                              P_("Contrast"),
+                              P_("The contrast change to apply"),
+                              &no_contrast_change,
+                              CLUTTER_PARAM_READWRITE);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
 static void
 clutter_brightness_contrast_effect_init (ClutterBrightnessContrastEffect *self)
 {
@@ -437,7 +472,7 @@ clutter_brightness_contrast_effect_init (ClutterBrightnessContrastEffect *self)
                                   brightness_contrast_decls,
                                   brightness_contrast_source);
       cogl_pipeline_add_snippet (klass->base_pipeline, snippet);
-      cogl_object_unref (snippet);
+      klass->snippet = snippet;
 
       cogl_pipeline_set_layer_null_texture (klass->base_pipeline,
                                             0, /* layer number */
@@ -455,7 +490,7 @@ clutter_brightness_contrast_effect_init (ClutterBrightnessContrastEffect *self)
   self->contrast_uniform =
     cogl_pipeline_get_uniform_location (self->pipeline, "contrast");
 
-  update_uniforms (self);
+  update_uniforms (self, self->pipeline);
 }
 
 /**
@@ -506,7 +541,7 @@ clutter_brightness_contrast_effect_set_brightness_full (ClutterBrightnessContras
   effect->brightness_green = green;
   effect->brightness_blue = blue;
 
-  update_uniforms (effect);
+  update_uniforms (effect, effect->pipeline);
 
   clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
 
@@ -596,7 +631,7 @@ clutter_brightness_contrast_effect_set_contrast_full (ClutterBrightnessContrastE
   effect->contrast_green = green;
   effect->contrast_blue = blue;
 
-  update_uniforms (effect);
+  update_uniforms (effect, effect->pipeline);
 
   clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
 
@@ -39,6 +39,13 @@
  * See [canvas.c](https://git.gnome.org/browse/clutter/tree/examples/canvas.c?h=clutter-1.18)
  * for an example of how to use #ClutterCanvas.
  *
+ * The drawing can also be moved off the main thread, using
+ * clutter_canvas_set_async(); in that case the previous contents of the
+ * canvas are shown until the new contents are ready.
+ *
+ * Drawings made of fills and strokes of paths, with colors and gradients,
+ * can be drawn by the GPU instead, using clutter_canvas_set_vector().
+ *
  * #ClutterCanvas is available since Clutter 1.10.
  */
 
@@ -49,7 +56,7 @@
 #include <cogl/cogl.h>
 #include <cairo-gobject.h>
 
-#include "clutter-canvas.h"
+#include "clutter-canvas-private.h"
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
@@ -64,6 +71,7 @@
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
 #include "clutter-settings.h"
+#include "clutter-vector-recorder.h"
 
 struct _ClutterCanvasPrivate
 {
@@ -75,12 +83,41 @@ struct _ClutterCanvasPrivate
   CoglTexture *texture;
   gboolean dirty;
 
+  /* the parts of the buffer drawn since the texture was last updated,
+   * in device pixels, if the whole buffer is not dirty
+   */
+  cairo_region_t *damage;
+
   CoglBitmap *buffer;
 
+  /* the image surface owning the data of the buffer, if the buffer
+   * was drawn on a worker thread
+   */
+  cairo_surface_t *buffer_surface;
+
+  /* the drawing currently running on a worker thread */
+  struct _AsyncDraw *async_job;
+
+  /* the commands of the drawing, if it is drawn by the GPU */
+  ClutterVectorRecorder *recorder;
+
   int scale_factor;
   guint scale_factor_set : 1;
+
+  guint async : 1;
+  guint async_pending : 1;
+  guint vector : 1;
 };
 
+typedef struct _AsyncDraw
+{
+  cairo_surface_t *surface;
+
+  int width;
+  int height;
+  int window_scale;
+} AsyncDraw;
+
 enum
 {
   PROP_0,
@@ -89,6 +126,8 @@ enum
   PROP_HEIGHT,
   PROP_SCALE_FACTOR,
   PROP_SCALE_FACTOR_SET,
+  PROP_ASYNC,
+  PROP_VECTOR,
 
   LAST_PROP
 };
@@ -134,9 +173,9 @@ clutter_cairo_context_draw_marshaller (GClosure     *closure,
 }
 
 static void
-clutter_canvas_finalize (GObject *gobject)
+clutter_canvas_clear_buffer (ClutterCanvas *self)
 {
-  ClutterCanvasPrivate *priv = CLUTTER_CANVAS (gobject)->priv;
+  ClutterCanvasPrivate *priv = self->priv;
 
   if (priv->buffer != NULL)
     {
@@ -144,7 +183,19 @@ clutter_canvas_finalize (GObject *gobject)
       priv->buffer = NULL;
     }
 
+  g_clear_pointer (&priv->buffer_surface, cairo_surface_destroy);
+  g_clear_pointer (&priv->recorder, _clutter_vector_recorder_free);
+}
+
+static void
+clutter_canvas_finalize (GObject *gobject)
+{
+  ClutterCanvasPrivate *priv = CLUTTER_CANVAS (gobject)->priv;
+
+  clutter_canvas_clear_buffer (CLUTTER_CANVAS (gobject));
+
   g_clear_pointer (&priv->texture, cogl_object_unref);
+  g_clear_pointer (&priv->damage, cairo_region_destroy);
 
   G_OBJECT_CLASS (clutter_canvas_parent_class)->finalize (gobject);
 }
@@ -190,6 +241,16 @@ clutter_canvas_set_property (GObject      *gobject,
                                        g_value_get_int (value));
       break;
 
+    case PROP_ASYNC:
+      clutter_canvas_set_async (CLUTTER_CANVAS (gobject),
+                                g_value_get_boolean (value));
+      break;
+
+    case PROP_VECTOR:
+      clutter_canvas_set_vector (CLUTTER_CANVAS (gobject),
+                                 g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -225,6 +286,14 @@ clutter_canvas_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->scale_factor_set);
       break;
 
+    case PROP_ASYNC:
+      g_value_set_boolean (value, priv->async);
+      break;
+
+    case PROP_VECTOR:
+      g_value_set_boolean (value, priv->vector);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -309,6 +378,39 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
                       -1,
                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterCanvas:async:
+   *
+   * Whether the #ClutterCanvas::draw signal is emitted on a worker
+   * thread.
+   *
+   * See clutter_canvas_set_async().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ASYNC] =
+    g_param_spec_boolean ("async",
+                          P_("Asynchronous"),
+                          P_("Whether the canvas is drawn on a worker thread"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterCanvas:vector:
+   *
+   * Whether the drawing of the canvas is drawn by the GPU.
+   *
+   * See clutter_canvas_set_vector().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_VECTOR] =
+    g_param_spec_boolean ("vector",
+                          P_("Vector"),
+                          P_("Whether the drawing of the canvas is drawn by the GPU"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ClutterCanvas::draw:
    * @canvas: the #ClutterCanvas that emitted the signal
@@ -323,6 +425,9 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
    * handler invocation will be automatically protected by cairo_save()
    * and cairo_restore() pairs.
    *
+   * If the #ClutterCanvas:async property is set, the signal is emitted
+   * on a worker thread, and the handlers must not use the Clutter API.
+   *
    * Return value: %TRUE if the signal emission should stop, and
    *   %FALSE otherwise
    *
@@ -357,6 +462,61 @@ clutter_canvas_init (ClutterCanvas *self)
   self->priv->scale_factor = -1;
 }
 
+/* draws the commands of the recorder into a new texture */
+static CoglTexture *
+clutter_canvas_render_vector (ClutterCanvas *self)
+{
+  ClutterVectorRecorder *recorder = self->priv->recorder;
+  CoglOffscreen *offscreen;
+  CoglTexture *texture;
+  CoglFramebuffer *fb;
+  CoglError *error = NULL;
+  int width, height;
+
+  _clutter_vector_recorder_get_size (recorder, &width, &height);
+
+  texture = cogl_texture_new_with_size (width, height,
+                                        COGL_TEXTURE_NO_SLICING |
+                                        COGL_TEXTURE_NO_ATLAS,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (texture == NULL)
+    return NULL;
+
+  /* the edges of the paths are only antialiased by multisampling */
+  offscreen = cogl_offscreen_new_with_texture (texture);
+  fb = COGL_FRAMEBUFFER (offscreen);
+  cogl_framebuffer_set_samples_per_pixel (fb, 4);
+  if (!cogl_framebuffer_allocate (fb, &error))
+    {
+      cogl_error_free (error);
+      error = NULL;
+
+      cogl_object_unref (offscreen);
+      offscreen = cogl_offscreen_new_with_texture (texture);
+      fb = COGL_FRAMEBUFFER (offscreen);
+
+      if (!cogl_framebuffer_allocate (fb, &error))
+        {
+          CLUTTER_NOTE (MISC, "Unable to allocate a %dx%d vector canvas: %s",
+                        width, height,
+                        error->message);
+          cogl_error_free (error);
+          cogl_object_unref (offscreen);
+          cogl_object_unref (texture);
+          return NULL;
+        }
+    }
+
+  cogl_framebuffer_orthographic (fb, 0, 0, width, height, -1, 100);
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR, 0.f, 0.f, 0.f, 0.f);
+
+  _clutter_vector_recorder_render (recorder, fb);
+
+  cogl_object_unref (offscreen);
+
+  return texture;
+}
+
 static void
 clutter_canvas_paint_content (ClutterContent   *content,
                               ClutterActor     *actor,
@@ -366,16 +526,45 @@ clutter_canvas_paint_content (ClutterContent   *content,
   ClutterCanvasPrivate *priv = self->priv;
   ClutterPaintNode *node;
 
-  if (priv->buffer == NULL)
+  if (priv->buffer == NULL && priv->recorder == NULL)
     return;
 
   if (priv->dirty)
     g_clear_pointer (&priv->texture, cogl_object_unref);
 
-  if (priv->texture == NULL)
+  if (priv->recorder != NULL)
+    {
+      if (priv->texture == NULL)
+        priv->texture = clutter_canvas_render_vector (self);
+    }
+  else if (priv->texture == NULL)
     priv->texture = cogl_texture_new_from_bitmap (priv->buffer,
                                                   COGL_TEXTURE_NO_SLICING,
                                                   CLUTTER_CAIRO_FORMAT_ARGB32);
+  else if (priv->damage != NULL)
+    {
+      int i, n_rects = cairo_region_num_rectangles (priv->damage);
+
+      /* only upload the parts of the buffer that were drawn again */
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t rect;
+
+          cairo_region_get_rectangle (priv->damage, i, &rect);
+
+          CLUTTER_NOTE (MISC, "Uploading canvas region %d, %d (%d x %d)",
+                        rect.x, rect.y,
+                        rect.width, rect.height);
+
+          cogl_texture_set_region_from_bitmap (priv->texture,
+                                               rect.x, rect.y,
+                                               rect.x, rect.y,
+                                               rect.width, rect.height,
+                                               priv->buffer);
+        }
+    }
+
+  g_clear_pointer (&priv->damage, cairo_region_destroy);
 
   if (priv->texture == NULL)
     return;
@@ -388,8 +577,85 @@ clutter_canvas_paint_content (ClutterContent   *content,
   priv->dirty = FALSE;
 }
 
-static void
-clutter_canvas_emit_draw (ClutterCanvas *self)
+/*< private >
+ * _clutter_canvas_release_texture:
+ * @canvas: a #ClutterCanvas
+ *
+ * Frees the texture of @canvas; the texture is uploaded again from the
+ * drawing of @canvas the next time it is painted, without invoking the
+ * #ClutterCanvas::draw signal.
+ */
+void
+_clutter_canvas_release_texture (ClutterCanvas *canvas)
+{
+  ClutterCanvasPrivate *priv = canvas->priv;
+
+  /* without a buffer or vector commands there is nothing to create
+   * the texture from
+   */
+  if (priv->texture == NULL ||
+      (priv->buffer == NULL && priv->recorder == NULL))
+    return;
+
+  CLUTTER_NOTE (MISC, "Releasing the texture of canvas %p", canvas);
+
+  g_clear_pointer (&priv->texture, cogl_object_unref);
+
+  /* the whole buffer is uploaded again */
+  g_clear_pointer (&priv->damage, cairo_region_destroy);
+}
+
+/*< private >
+ * _clutter_canvas_get_memory_size:
+ * @canvas: a #ClutterCanvas
+ *
+ * Estimates the memory held by @canvas, i.e. the size of its drawing
+ * buffer, and the size of its texture assuming 4 bytes per pixel.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_canvas_get_memory_size (ClutterCanvas *canvas)
+{
+  ClutterCanvasPrivate *priv = canvas->priv;
+  gsize size = 0;
+
+  if (priv->buffer != NULL)
+    size += (gsize) cogl_bitmap_get_rowstride (priv->buffer)
+          * cogl_bitmap_get_height (priv->buffer);
+
+  if (priv->texture != NULL)
+    size += (gsize) cogl_texture_get_width (priv->texture)
+          * cogl_texture_get_height (priv->texture)
+          * 4;
+
+  return size;
+}
+
+static int
+clutter_canvas_get_window_scale (ClutterCanvas *self)
+{
+  int window_scale = 1;
+
+  if (self->priv->scale_factor_set)
+    return self->priv->scale_factor;
+
+  g_object_get (clutter_settings_get_default (),
+                "window-scaling-factor", &window_scale,
+                NULL);
+
+  return window_scale;
+}
+
+/* draws the whole canvas, or only the area inside @clip on top of the
+ * current contents of the buffer; drawing only a part of the canvas
+ * fails if the buffer cannot be mapped. If @recording is set, it is
+ * replayed instead of emitting the #ClutterCanvas::draw signal
+ */
+static gboolean
+clutter_canvas_emit_draw (ClutterCanvas               *self,
+                          const cairo_rectangle_int_t *clip,
+                          cairo_surface_t             *recording)
 {
   ClutterCanvasPrivate *priv = self->priv;
   int real_width, real_height;
@@ -397,20 +663,13 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
   gboolean mapped_buffer;
   unsigned char *data;
   CoglBuffer *buffer;
-  int window_scale = 1;
+  int window_scale;
   gboolean res;
   cairo_t *cr;
 
   g_assert (priv->width > 0 && priv->width > 0);
 
-  priv->dirty = TRUE;
-
-  if (priv->scale_factor_set)
-    window_scale = priv->scale_factor;
-  else
-    g_object_get (clutter_settings_get_default (),
-                  "window-scaling-factor", &window_scale,
-                  NULL);
+  window_scale = clutter_canvas_get_window_scale (self);
 
   real_width = priv->width * window_scale;
   real_height = priv->height * window_scale;
@@ -433,13 +692,39 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
 
   buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
   if (buffer == NULL)
-    return;
+    return FALSE;
 
   cogl_buffer_set_update_hint (buffer, COGL_BUFFER_UPDATE_HINT_DYNAMIC);
 
+  /* the contents outside of the clip must be preserved */
   data = cogl_buffer_map (buffer,
                           COGL_BUFFER_ACCESS_READ_WRITE,
-                          COGL_BUFFER_MAP_HINT_DISCARD);
+                          clip == NULL ? COGL_BUFFER_MAP_HINT_DISCARD : 0);
+
+  if (data == NULL && clip != NULL)
+    return FALSE;
+
+  if (clip == NULL)
+    {
+      priv->dirty = TRUE;
+      g_clear_pointer (&priv->damage, cairo_region_destroy);
+    }
+  else if (!priv->dirty)
+    {
+      cairo_rectangle_int_t device_rect, bounds = { 0, 0, real_width, real_height };
+
+      device_rect.x = clip->x * window_scale;
+      device_rect.y = clip->y * window_scale;
+      device_rect.width = clip->width * window_scale;
+      device_rect.height = clip->height * window_scale;
+
+      if (priv->damage == NULL)
+        priv->damage = cairo_region_create_rectangle (&device_rect);
+      else
+        cairo_region_union_rectangle (priv->damage, &device_rect);
+
+      cairo_region_intersect_rectangle (priv->damage, &bounds);
+    }
 
   if (data != NULL)
     {
@@ -465,9 +750,30 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
 
   self->priv->cr = cr = cairo_create (surface);
 
-  g_signal_emit (self, canvas_signals[DRAW], 0,
-                 cr, priv->width, priv->height,
-                 &res);
+  if (clip != NULL)
+    {
+      cairo_rectangle (cr, clip->x, clip->y, clip->width, clip->height);
+      cairo_clip (cr);
+
+      /* the area is cleared, as if the whole canvas was invalidated */
+      cairo_save (cr);
+      cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+      cairo_paint (cr);
+      cairo_restore (cr);
+    }
+
+  if (recording != NULL)
+    {
+      /* the recording is in device pixels */
+      cairo_scale (cr, 1.0 / window_scale, 1.0 / window_scale);
+      cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+      cairo_set_source_surface (cr, recording, 0, 0);
+      cairo_paint (cr);
+    }
+  else
+    g_signal_emit (self, canvas_signals[DRAW], 0,
+                   cr, priv->width, priv->height,
+                   &res);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled () && cairo_status (cr))
@@ -493,6 +799,196 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
     }
 
   cairo_surface_destroy (surface);
+
+  return TRUE;
+}
+
+/* records the drawing of the canvas, to be drawn by the GPU when the
+ * canvas is painted; the drawings the GPU cannot draw are replayed in
+ * the buffer instead
+ */
+static void
+clutter_canvas_emit_vector_draw (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  ClutterVectorRecorder *recorder;
+  int window_scale;
+  gboolean res;
+  cairo_t *cr;
+
+  window_scale = clutter_canvas_get_window_scale (self);
+
+  recorder = _clutter_vector_recorder_new (priv->width * window_scale,
+                                           priv->height * window_scale,
+                                           window_scale);
+
+  priv->cr = cr = _clutter_vector_recorder_create_context (recorder);
+
+  g_signal_emit (self, canvas_signals[DRAW], 0,
+                 cr, priv->width, priv->height,
+                 &res);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled () && cairo_status (cr))
+    {
+      g_warning ("Drawing failed for <ClutterCanvas>[%p]: %s",
+                 self,
+                 cairo_status_to_string (cairo_status (cr)));
+    }
+#endif
+
+  priv->cr = NULL;
+  cairo_destroy (cr);
+
+  _clutter_vector_recorder_finish (recorder);
+
+  priv->dirty = TRUE;
+  g_clear_pointer (&priv->damage, cairo_region_destroy);
+
+  if (_clutter_vector_recorder_needs_fallback (recorder))
+    {
+      clutter_canvas_emit_draw (self, NULL,
+                                _clutter_vector_recorder_get_recording (recorder));
+      _clutter_vector_recorder_free (recorder);
+    }
+  else
+    priv->recorder = recorder;
+}
+
+static void
+async_draw_free (gpointer data)
+{
+  AsyncDraw *job = data;
+
+  if (job->surface != NULL)
+    cairo_surface_destroy (job->surface);
+
+  g_slice_free (AsyncDraw, job);
+}
+
+static void
+clutter_canvas_async_draw_thread (GTask        *task,
+                                  gpointer      source_object,
+                                  gpointer      task_data,
+                                  GCancellable *cancellable)
+{
+  ClutterCanvas *self = source_object;
+  AsyncDraw *job = task_data;
+  gboolean res;
+  cairo_t *cr;
+
+  cairo_surface_set_device_scale (job->surface,
+                                  job->window_scale,
+                                  job->window_scale);
+
+  cr = cairo_create (job->surface);
+
+  g_signal_emit (self, canvas_signals[DRAW], 0,
+                 cr, job->width, job->height,
+                 &res);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_diagnostic_enabled () && cairo_status (cr))
+    {
+      g_warning ("Drawing failed for <ClutterCanvas>[%p]: %s",
+                 self,
+                 cairo_status_to_string (cairo_status (cr)));
+    }
+#endif
+
+  cairo_destroy (cr);
+
+  cairo_surface_flush (job->surface);
+
+  g_task_return_boolean (task, TRUE);
+}
+
+static void
+clutter_canvas_async_draw_done (GObject      *gobject,
+                                GAsyncResult *result,
+                                gpointer      user_data)
+{
+  ClutterCanvas *self = CLUTTER_CANVAS (gobject);
+  ClutterCanvasPrivate *priv = self->priv;
+  AsyncDraw *job = g_task_get_task_data (G_TASK (result));
+
+  g_assert (priv->async_job == job);
+  priv->async_job = NULL;
+
+  if (!g_task_propagate_boolean (G_TASK (result), NULL))
+    return;
+
+  /* the contents are stale if the canvas changed size in the meantime;
+   * in that case another drawing is pending
+   */
+  if (job->width == priv->width &&
+      job->height == priv->height &&
+      job->window_scale == clutter_canvas_get_window_scale (self))
+    {
+      CoglContext *ctx;
+
+      CLUTTER_NOTE (MISC, "Canvas drawn on a worker thread (size: %d x %d)",
+                    job->width, job->height);
+
+      clutter_canvas_clear_buffer (self);
+
+      ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+      priv->buffer =
+        cogl_bitmap_new_for_data (ctx,
+                                  cairo_image_surface_get_width (job->surface),
+                                  cairo_image_surface_get_height (job->surface),
+                                  CLUTTER_CAIRO_FORMAT_ARGB32,
+                                  cairo_image_surface_get_stride (job->surface),
+                                  cairo_image_surface_get_data (job->surface));
+
+      /* the bitmap does not own the data */
+      priv->buffer_surface = job->surface;
+      job->surface = NULL;
+
+      priv->dirty = TRUE;
+      g_clear_pointer (&priv->damage, cairo_region_destroy);
+
+      _clutter_content_queue_redraw (CLUTTER_CONTENT (self));
+    }
+
+  if (priv->async_pending)
+    {
+      priv->async_pending = FALSE;
+      clutter_content_invalidate (CLUTTER_CONTENT (self));
+    }
+}
+
+/* draws the canvas on a worker thread; the current contents are kept
+ * until the new ones are ready, and the invalidations happening in the
+ * meantime are coalesced into a single drawing
+ */
+static void
+clutter_canvas_queue_async_draw (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  AsyncDraw *job;
+  GTask *task;
+
+  if (priv->async_job != NULL)
+    {
+      priv->async_pending = TRUE;
+      return;
+    }
+
+  job = g_slice_new0 (AsyncDraw);
+  job->width = priv->width;
+  job->height = priv->height;
+  job->window_scale = clutter_canvas_get_window_scale (self);
+  job->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                             job->width * job->window_scale,
+                                             job->height * job->window_scale);
+
+  task = g_task_new (self, NULL, clutter_canvas_async_draw_done, NULL);
+  g_task_set_task_data (task, job, async_draw_free);
+  g_task_run_in_thread (task, clutter_canvas_async_draw_thread);
+  g_object_unref (task);
+
+  priv->async_job = job;
 }
 
 static void
@@ -501,16 +997,31 @@ clutter_canvas_invalidate (ClutterContent *content)
   ClutterCanvas *self = CLUTTER_CANVAS (content);
   ClutterCanvasPrivate *priv = self->priv;
 
-  if (priv->buffer != NULL)
+  /* the handlers must never run on two threads at the same time, so
+   * the canvas is also drawn asynchronously while a worker is busy;
+   * the vector drawings are recorded on the main thread
+   */
+  if ((priv->async && !priv->vector) || priv->async_job != NULL)
     {
-      cogl_object_unref (priv->buffer);
-      priv->buffer = NULL;
+      if (priv->width <= 0 || priv->height <= 0)
+        {
+          clutter_canvas_clear_buffer (self);
+          return;
+        }
+
+      clutter_canvas_queue_async_draw (self);
+      return;
     }
 
+  clutter_canvas_clear_buffer (self);
+
   if (priv->width <= 0 || priv->height <= 0)
     return;
 
-  clutter_canvas_emit_draw (self);
+  if (priv->vector)
+    clutter_canvas_emit_vector_draw (self);
+  else
+    clutter_canvas_emit_draw (self, NULL, NULL);
 }
 
 static gboolean
@@ -714,3 +1225,194 @@ clutter_canvas_get_scale_factor (ClutterCanvas *canvas)
 
   return canvas->priv->scale_factor;
 }
+
+/**
+ * clutter_canvas_invalidate_rect:
+ * @canvas: a #ClutterCanvas
+ * @rect: the area to draw again, in the coordinates of the canvas
+ *
+ * Invalidates the area of @canvas inside @rect.
+ *
+ * Unlike clutter_content_invalidate(), the #ClutterCanvas::draw signal
+ * is emitted with the Cairo context clipped to @rect, with the area
+ * inside @rect cleared and the rest of the contents of the canvas
+ * preserved; only that area is uploaded to the GPU when the canvas is
+ * painted. The handlers drawing expensive contents can use
+ * cairo_clip_extents() to only draw what is inside the clip.
+ *
+ * If the contents of the canvas cannot be preserved, for instance
+ * because the canvas was never drawn or because it is drawn on a
+ * worker thread or by the GPU, the whole canvas is invalidated instead.
+ *
+ * Since: 1.26
+ */
+void
+clutter_canvas_invalidate_rect (ClutterCanvas               *canvas,
+                                const cairo_rectangle_int_t *rect)
+{
+  ClutterCanvasPrivate *priv;
+  cairo_rectangle_int_t clip;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+  g_return_if_fail (rect != NULL);
+
+  priv = canvas->priv;
+
+  if (priv->width <= 0 || priv->height <= 0)
+    return;
+
+  clip = *rect;
+
+  if (clip.x < 0)
+    {
+      clip.width += clip.x;
+      clip.x = 0;
+    }
+
+  if (clip.y < 0)
+    {
+      clip.height += clip.y;
+      clip.y = 0;
+    }
+
+  clip.width = MIN (clip.width, priv->width - clip.x);
+  clip.height = MIN (clip.height, priv->height - clip.y);
+
+  if (clip.width <= 0 || clip.height <= 0)
+    return;
+
+  if (priv->buffer == NULL ||
+      priv->async ||
+      priv->vector ||
+      priv->async_job != NULL ||
+      !clutter_canvas_emit_draw (canvas, &clip, NULL))
+    {
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+      return;
+    }
+
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (canvas));
+}
+
+/**
+ * clutter_canvas_set_async:
+ * @canvas: a #ClutterCanvas
+ * @async: whether the @canvas should be drawn on a worker thread
+ *
+ * Sets whether the #ClutterCanvas::draw signal of @canvas is emitted
+ * on a worker thread.
+ *
+ * When drawing asynchronously, the handlers draw on a private image
+ * surface, and the previous contents of the @canvas are shown until
+ * the drawing is done; the invalidations happening in the meantime
+ * are coalesced into a single drawing. The handlers of the
+ * #ClutterCanvas::draw signal run on the worker thread, and must not
+ * use the Clutter API, or access state shared with the main thread
+ * without locking.
+ *
+ * Since: 1.26
+ */
+void
+clutter_canvas_set_async (ClutterCanvas *canvas,
+                          gboolean       async)
+{
+  ClutterCanvasPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  priv = canvas->priv;
+
+  async = !!async;
+
+  if (priv->async == async)
+    return;
+
+  priv->async = async;
+
+  g_object_notify_by_pspec (G_OBJECT (canvas), obj_props[PROP_ASYNC]);
+}
+
+/**
+ * clutter_canvas_get_async:
+ * @canvas: a #ClutterCanvas
+ *
+ * Retrieves the value set using clutter_canvas_set_async().
+ *
+ * Return value: %TRUE if the @canvas is drawn on a worker thread
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_canvas_get_async (ClutterCanvas *canvas)
+{
+  g_return_val_if_fail (CLUTTER_IS_CANVAS (canvas), FALSE);
+
+  return canvas->priv->async;
+}
+
+/**
+ * clutter_canvas_set_vector:
+ * @canvas: a #ClutterCanvas
+ * @vector: whether the drawing of @canvas should be drawn by the GPU
+ *
+ * Sets whether the drawing of @canvas is drawn by the GPU.
+ *
+ * In vector mode the #ClutterCanvas::draw signal is emitted on the
+ * main thread, and the fills and strokes of the drawing are recorded
+ * instead of being rasterized by Cairo; when the @canvas is painted,
+ * the paths are tessellated and drawn into its texture by the GPU,
+ * which is faster for large canvases, and for canvases drawn again
+ * at every frame.
+ *
+ * Only the paths filled or stroked with the OVER operator, using colors,
+ * linear or radial gradients, and clipped by at most one rectangle, can
+ * be drawn by the GPU; if a drawing uses anything else, e.g. text, images,
+ * masks or dashes, the whole drawing is rasterized by Cairo instead. The
+ * edges of the paths drawn by the GPU are antialiased only if the GPU
+ * supports multisampling.
+ *
+ * Vector mode takes precedence over #ClutterCanvas:async.
+ *
+ * Changing the mode invalidates the @canvas.
+ *
+ * Since: 1.26
+ */
+void
+clutter_canvas_set_vector (ClutterCanvas *canvas,
+                           gboolean       vector)
+{
+  ClutterCanvasPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  priv = canvas->priv;
+
+  vector = !!vector;
+
+  if (priv->vector == vector)
+    return;
+
+  priv->vector = vector;
+
+  clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+
+  g_object_notify_by_pspec (G_OBJECT (canvas), obj_props[PROP_VECTOR]);
+}
+
+/**
+ * clutter_canvas_get_vector:
+ * @canvas: a #ClutterCanvas
+ *
+ * Retrieves the value set using clutter_canvas_set_vector().
+ *
+ * Return value: %TRUE if the drawing of @canvas is drawn by the GPU
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_canvas_get_vector (ClutterCanvas *canvas)
+{
+  g_return_val_if_fail (CLUTTER_IS_CANVAS (canvas), FALSE);
+
+  return canvas->priv->vector;
+}
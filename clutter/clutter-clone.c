@@ -34,6 +34,11 @@
  * the presence of support for FBOs in the underlying GL or GLES
  * implementation.
  *
+ * By default, every clone paints the whole source again. When many clones
+ * of a complex source are visible at the same time, the clones can share
+ * a cached rendering of the source instead; see
+ * clutter_clone_set_cache_source().
+ *
  * #ClutterClone is available since Clutter 1.0
  */
 
@@ -43,6 +48,7 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 #include "clutter-actor-private.h"
+#include "clutter-backend.h"
 #include "clutter-clone.h"
 #include "clutter-debug.h"
 #include "clutter-main.h"
@@ -51,9 +57,36 @@
 
 #include "cogl/cogl.h"
 
+#include <math.h>
+
+typedef struct _ClutterCloneCache       ClutterCloneCache;
+
+/* the rendering of a source, shared by all its caching clones */
+struct _ClutterCloneCache
+{
+  guint n_clones;
+
+  CoglTexture *texture;
+  CoglOffscreen *offscreen;
+  CoglPipeline *pipeline;
+
+  /* the area of the source rendered in the texture, in the
+   * coordinate space of the source
+   */
+  gfloat x, y;
+  gfloat width, height;
+
+  guint damage_serial;
+  guint is_valid : 1;
+};
+
 struct _ClutterClonePrivate
 {
   ClutterActor *clone_source;
+
+  ClutterCloneCache *cache;
+
+  guint cache_source : 1;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterClone, clutter_clone, CLUTTER_TYPE_ACTOR)
@@ -63,12 +96,15 @@ enum
   PROP_0,
 
   PROP_SOURCE,
+  PROP_CACHE_SOURCE,
 
   PROP_LAST
 };
 
 static GParamSpec *obj_props[PROP_LAST];
 
+static GQuark quark_clone_cache = 0;
+
 static void clutter_clone_set_source_internal (ClutterClone *clone,
 					       ClutterActor *source);
 static void
@@ -153,17 +189,71 @@ clutter_clone_apply_transform (ClutterActor *self, CoglMatrix *matrix)
 }
 
 static void
-clutter_clone_paint (ClutterActor *actor)
+clutter_clone_cache_clear (ClutterCloneCache *cache)
 {
-  ClutterClone *self = CLUTTER_CLONE (actor);
-  ClutterClonePrivate *priv = self->priv;
-  gboolean was_unmapped = FALSE;
+  if (cache->offscreen != NULL)
+    {
+      cogl_object_unref (cache->offscreen);
+      cache->offscreen = NULL;
+    }
 
-  if (priv->clone_source == NULL)
-    return;
+  if (cache->texture != NULL)
+    {
+      cogl_object_unref (cache->texture);
+      cache->texture = NULL;
+    }
 
-  CLUTTER_NOTE (PAINT, "painting clone actor '%s'",
-                _clutter_actor_get_debug_name (actor));
+  cache->is_valid = FALSE;
+}
+
+static void
+clutter_clone_cache_free (gpointer data)
+{
+  ClutterCloneCache *cache = data;
+
+  clutter_clone_cache_clear (cache);
+
+  if (cache->pipeline != NULL)
+    cogl_object_unref (cache->pipeline);
+
+  g_slice_free (ClutterCloneCache, cache);
+}
+
+static ClutterCloneCache *
+clutter_clone_cache_ref (ClutterActor *source)
+{
+  ClutterCloneCache *cache;
+
+  cache = g_object_get_qdata (G_OBJECT (source), quark_clone_cache);
+  if (cache == NULL)
+    {
+      cache = g_slice_new0 (ClutterCloneCache);
+      g_object_set_qdata_full (G_OBJECT (source), quark_clone_cache,
+                               cache,
+                               clutter_clone_cache_free);
+    }
+
+  cache->n_clones += 1;
+
+  return cache;
+}
+
+static void
+clutter_clone_cache_unref (ClutterActor      *source,
+                           ClutterCloneCache *cache)
+{
+  cache->n_clones -= 1;
+
+  if (cache->n_clones == 0)
+    g_object_set_qdata (G_OBJECT (source), quark_clone_cache, NULL);
+}
+
+static void
+clutter_clone_paint_source (ClutterClone *self,
+                            guint8        opacity)
+{
+  ClutterClonePrivate *priv = self->priv;
+  gboolean was_unmapped = FALSE;
 
   /* The final bits of magic:
    * - We need to override the paint opacity of the actor with our own
@@ -174,8 +264,7 @@ clutter_clone_paint (ClutterActor *actor)
    *   the clone source actor.
    */
   _clutter_actor_set_in_clone_paint (priv->clone_source, TRUE);
-  clutter_actor_set_opacity_override (priv->clone_source,
-                                       clutter_actor_get_paint_opacity (actor));
+  clutter_actor_set_opacity_override (priv->clone_source, opacity);
   _clutter_actor_set_enable_model_view_transform (priv->clone_source, FALSE);
 
   if (!clutter_actor_is_mapped (priv->clone_source))
@@ -202,6 +291,154 @@ clutter_clone_paint (ClutterActor *actor)
   _clutter_actor_set_in_clone_paint (priv->clone_source, FALSE);
 }
 
+/* Renders the source in the shared texture of the cache, unless it has
+ * not been damaged since the last clone rendered it
+ */
+static gboolean
+clutter_clone_update_cache (ClutterClone *self)
+{
+  ClutterClonePrivate *priv = self->priv;
+  ClutterCloneCache *cache = priv->cache;
+  const ClutterPaintVolume *volume;
+  ClutterVertex origin;
+  CoglFramebuffer *fb;
+  CoglMatrix modelview;
+  CoglColor transparent;
+  gfloat x, y, width, height;
+  int texture_width, texture_height;
+  guint damage_serial;
+
+  volume = clutter_actor_get_paint_volume (priv->clone_source);
+  if (volume == NULL)
+    return FALSE;
+
+  clutter_paint_volume_get_origin (volume, &origin);
+  x = floorf (origin.x);
+  y = floorf (origin.y);
+  width = ceilf (origin.x + clutter_paint_volume_get_width (volume)) - x;
+  height = ceilf (origin.y + clutter_paint_volume_get_height (volume)) - y;
+
+  if (width < 1.f || height < 1.f)
+    return FALSE;
+
+  damage_serial = _clutter_actor_get_clone_damage_serial (priv->clone_source);
+
+  if (cache->is_valid &&
+      cache->damage_serial == damage_serial &&
+      cache->x == x && cache->y == y &&
+      cache->width == width && cache->height == height)
+    return TRUE;
+
+  texture_width = width;
+  texture_height = height;
+
+  if (cache->texture == NULL ||
+      cogl_texture_get_width (cache->texture) != texture_width ||
+      cogl_texture_get_height (cache->texture) != texture_height)
+    {
+      CoglError *error = NULL;
+
+      clutter_clone_cache_clear (cache);
+
+      cache->texture = cogl_texture_new_with_size (texture_width,
+                                                   texture_height,
+                                                   COGL_TEXTURE_NO_SLICING,
+                                                   COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+      if (cache->texture == NULL)
+        return FALSE;
+
+      cache->offscreen = cogl_offscreen_new_with_texture (cache->texture);
+      if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (cache->offscreen),
+                                      &error))
+        {
+          CLUTTER_NOTE (PAINT, "Unable to allocate a %dx%d clone cache: %s",
+                        texture_width, texture_height,
+                        error->message);
+          cogl_error_free (error);
+          clutter_clone_cache_clear (cache);
+          return FALSE;
+        }
+
+      if (cache->pipeline == NULL)
+        {
+          CoglContext *ctx =
+            clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+          cache->pipeline = cogl_pipeline_new (ctx);
+        }
+
+      cogl_pipeline_set_layer_texture (cache->pipeline, 0, cache->texture);
+    }
+
+  CLUTTER_NOTE (PAINT, "updating the clone cache of actor '%s'",
+                _clutter_actor_get_debug_name (priv->clone_source));
+
+  fb = COGL_FRAMEBUFFER (cache->offscreen);
+  cogl_push_framebuffer (fb);
+
+  /* the source is rendered flat, in its own coordinate space */
+  cogl_framebuffer_orthographic (fb, x, y, x + width, y + height, -1000.f, 1000.f);
+  cogl_matrix_init_identity (&modelview);
+  cogl_framebuffer_set_modelview_matrix (fb, &modelview);
+
+  cogl_color_init_from_4ub (&transparent, 0, 0, 0, 0);
+  cogl_framebuffer_clear (fb, COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH, &transparent);
+
+  clutter_clone_paint_source (self, 0xff);
+
+  cogl_pop_framebuffer ();
+
+  cache->x = x;
+  cache->y = y;
+  cache->width = width;
+  cache->height = height;
+  cache->damage_serial = damage_serial;
+  cache->is_valid = TRUE;
+
+  return TRUE;
+}
+
+static void
+clutter_clone_paint (ClutterActor *actor)
+{
+  ClutterClone *self = CLUTTER_CLONE (actor);
+  ClutterClonePrivate *priv = self->priv;
+  guint8 paint_opacity;
+
+  if (priv->clone_source == NULL)
+    return;
+
+  CLUTTER_NOTE (PAINT, "painting clone actor '%s'",
+                _clutter_actor_get_debug_name (actor));
+
+  paint_opacity = clutter_actor_get_paint_opacity (actor);
+
+  /* A clone of a clone, or a source painting itself through an effect,
+   * cannot use the cache while it is being updated
+   */
+  if (priv->cache != NULL &&
+      !clutter_actor_is_in_clone_paint (priv->clone_source) &&
+      clutter_actor_is_realized (priv->clone_source) &&
+      clutter_clone_update_cache (self))
+    {
+      ClutterCloneCache *cache = priv->cache;
+
+      cogl_pipeline_set_color4ub (cache->pipeline,
+                                  paint_opacity,
+                                  paint_opacity,
+                                  paint_opacity,
+                                  paint_opacity);
+      cogl_framebuffer_draw_rectangle (cogl_get_draw_framebuffer (),
+                                       cache->pipeline,
+                                       cache->x, cache->y,
+                                       cache->x + cache->width,
+                                       cache->y + cache->height);
+      return;
+    }
+
+  clutter_clone_paint_source (self, paint_opacity);
+}
+
 static gboolean
 clutter_clone_get_paint_volume (ClutterActor       *actor,
                                 ClutterPaintVolume *volume)
@@ -284,6 +521,10 @@ clutter_clone_set_property (GObject      *gobject,
       clutter_clone_set_source (self, g_value_get_object (value));
       break;
 
+    case PROP_CACHE_SOURCE:
+      clutter_clone_set_cache_source (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -304,6 +545,10 @@ clutter_clone_get_property (GObject    *gobject,
       g_value_set_object (value, priv->clone_source);
       break;
 
+    case PROP_CACHE_SOURCE:
+      g_value_set_boolean (value, priv->cache_source);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -351,7 +596,26 @@ clutter_clone_class_init (ClutterCloneClass *klass)
                          G_PARAM_CONSTRUCT |
                          CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterClone:cache-source:
+   *
+   * Whether the clone paints a cached rendering of the source, shared
+   * with the other clones of the same source that cache it.
+   *
+   * See clutter_clone_set_cache_source().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_CACHE_SOURCE] =
+    g_param_spec_boolean ("cache-source",
+                          P_("Cache Source"),
+                          P_("Whether the clones share a cached rendering of the source"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+
+  quark_clone_cache = g_quark_from_static_string ("-clutter-clone-cache");
 }
 
 static void
@@ -387,6 +651,12 @@ clutter_clone_set_source_internal (ClutterClone *self,
 
   if (priv->clone_source != NULL)
     {
+      if (priv->cache != NULL)
+        {
+          clutter_clone_cache_unref (priv->clone_source, priv->cache);
+          priv->cache = NULL;
+        }
+
       _clutter_actor_detach_clone (priv->clone_source, CLUTTER_ACTOR (self));
       g_object_unref (priv->clone_source);
       priv->clone_source = NULL;
@@ -396,6 +666,9 @@ clutter_clone_set_source_internal (ClutterClone *self,
     {
       priv->clone_source = g_object_ref (source);
       _clutter_actor_attach_clone (priv->clone_source, CLUTTER_ACTOR (self));
+
+      if (priv->cache_source)
+        priv->cache = clutter_clone_cache_ref (priv->clone_source);
     }
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_SOURCE]);
@@ -440,3 +713,74 @@ clutter_clone_get_source (ClutterClone *self)
 
   return self->priv->clone_source;
 }
+
+/**
+ * clutter_clone_set_cache_source:
+ * @self: a #ClutterClone
+ * @cache_source: whether to cache the rendering of the source
+ *
+ * Sets whether @self paints a cached rendering of its source, instead
+ * of painting the source again.
+ *
+ * The rendering is shared by all the clones of the same source that
+ * cache it, and it is only updated when the source, or any of its
+ * children, queues a redraw; so painting many caching clones of a
+ * complex source costs a single paint of the source per frame, at
+ * most, and one textured rectangle per clone.
+ *
+ * The source is rendered at its own size, with an orthographic
+ * projection, so the clones should not be much bigger than the
+ * source, and the perspective of the 3D transformations inside the
+ * source is flattened.
+ *
+ * Since: 1.26
+ */
+void
+clutter_clone_set_cache_source (ClutterClone *self,
+                                gboolean      cache_source)
+{
+  ClutterClonePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CLONE (self));
+
+  priv = self->priv;
+
+  cache_source = !!cache_source;
+  if (priv->cache_source == cache_source)
+    return;
+
+  priv->cache_source = cache_source;
+
+  if (priv->clone_source != NULL)
+    {
+      if (cache_source)
+        priv->cache = clutter_clone_cache_ref (priv->clone_source);
+      else
+        {
+          clutter_clone_cache_unref (priv->clone_source, priv->cache);
+          priv->cache = NULL;
+        }
+    }
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CACHE_SOURCE]);
+}
+
+/**
+ * clutter_clone_get_cache_source:
+ * @self: a #ClutterClone
+ *
+ * Retrieves whether @self paints a cached rendering of its source.
+ *
+ * Return value: %TRUE if the rendering of the source is cached
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_clone_get_cache_source (ClutterClone *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_CLONE (self), FALSE);
+
+  return self->priv->cache_source;
+}
@@ -89,6 +89,12 @@ void            clutter_clone_set_source        (ClutterClone *self,
 CLUTTER_AVAILABLE_IN_1_0
 ClutterActor *  clutter_clone_get_source        (ClutterClone *self);
 
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_clone_set_cache_source  (ClutterClone *self,
+                                                 gboolean      cache_source);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_clone_get_cache_source  (ClutterClone *self);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CLONE_H__ */
@@ -38,6 +38,16 @@
 #endif
 
 #include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CLUTTER_COLOR_USE_NEON 1
+#endif
 
 #include <pango/pango-attributes.h>
 
@@ -882,6 +892,231 @@ clutter_color_interpolate (const ClutterColor *initial,
   result->alpha = initial->alpha + (final->alpha - initial->alpha) * progress;
 }
 
+/* the weight of the final color in the fixed point interpolation,
+ * in the [0, 256] interval
+ */
+static inline guint
+color_progress_to_weight (gdouble progress)
+{
+  return CLAMP (progress, 0.0, 1.0) * 256.0 + 0.5;
+}
+
+/* interpolates @n_channels bytes with a weight of @w for @final */
+static void
+interpolate_channels (const guint8 *initial,
+                      const guint8 *final,
+                      guint         w,
+                      guint8       *result,
+                      gsize         n_channels)
+{
+  guint iw = 256 - w;
+  gsize i = 0;
+
+#if defined(__SSE2__)
+  {
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i v_w = _mm_set1_epi16 (w);
+    const __m128i v_iw = _mm_set1_epi16 (iw);
+    const __m128i half = _mm_set1_epi16 (128);
+
+    /* a * (256 - w) + b * w + 128 fits in 16 unsigned bits, so the
+     * wrapping 16 bit arithmetic is exact
+     */
+    for (; i + 16 <= n_channels; i += 16)
+      {
+        __m128i a = _mm_loadu_si128 ((const __m128i *) (initial + i));
+        __m128i b = _mm_loadu_si128 ((const __m128i *) (final + i));
+        __m128i lo, hi;
+
+        lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (a, zero), v_iw),
+                            _mm_mullo_epi16 (_mm_unpacklo_epi8 (b, zero), v_w));
+        hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (a, zero), v_iw),
+                            _mm_mullo_epi16 (_mm_unpackhi_epi8 (b, zero), v_w));
+
+        lo = _mm_srli_epi16 (_mm_add_epi16 (lo, half), 8);
+        hi = _mm_srli_epi16 (_mm_add_epi16 (hi, half), 8);
+
+        _mm_storeu_si128 ((__m128i *) (result + i), _mm_packus_epi16 (lo, hi));
+      }
+  }
+#elif defined(CLUTTER_COLOR_USE_NEON)
+  {
+    const uint16x8_t half = vdupq_n_u16 (128);
+
+    for (; i + 16 <= n_channels; i += 16)
+      {
+        uint8x16_t a = vld1q_u8 (initial + i);
+        uint8x16_t b = vld1q_u8 (final + i);
+        uint16x8_t lo, hi;
+
+        lo = vmulq_n_u16 (vmovl_u8 (vget_low_u8 (a)), iw);
+        lo = vmlaq_n_u16 (lo, vmovl_u8 (vget_low_u8 (b)), w);
+        hi = vmulq_n_u16 (vmovl_u8 (vget_high_u8 (a)), iw);
+        hi = vmlaq_n_u16 (hi, vmovl_u8 (vget_high_u8 (b)), w);
+
+        vst1q_u8 (result + i,
+                  vcombine_u8 (vshrn_n_u16 (vaddq_u16 (lo, half), 8),
+                               vshrn_n_u16 (vaddq_u16 (hi, half), 8)));
+      }
+  }
+#endif
+
+  for (; i < n_channels; i++)
+    result[i] = (initial[i] * iw + final[i] * w + 128) >> 8;
+}
+
+/**
+ * clutter_color_interpolate_array:
+ * @initial: (array length=n_colors): the initial colors
+ * @final: (array length=n_colors): the final colors
+ * @progress: the interpolation progress, between 0 and 1
+ * @result: (array length=n_colors) (out caller-allocates): return
+ *   location for the interpolated colors
+ * @n_colors: the number of colors
+ *
+ * Interpolates each color in @initial with the color at the same
+ * position in @final using @progress, like clutter_color_interpolate().
+ *
+ * The colors are interpolated together with fixed point math, so the
+ * channels can differ by one from the ones computed by
+ * clutter_color_interpolate(); @result can be the same array as
+ * @initial or @final.
+ *
+ * Since: 1.26
+ */
+void
+clutter_color_interpolate_array (const ClutterColor *initial,
+                                 const ClutterColor *final,
+                                 gdouble             progress,
+                                 ClutterColor       *result,
+                                 guint               n_colors)
+{
+  g_return_if_fail (n_colors == 0 || (initial != NULL && final != NULL));
+  g_return_if_fail (n_colors == 0 || result != NULL);
+
+  G_STATIC_ASSERT (sizeof (ClutterColor) == 4);
+
+  interpolate_channels ((const guint8 *) initial,
+                        (const guint8 *) final,
+                        color_progress_to_weight (progress),
+                        (guint8 *) result,
+                        (gsize) n_colors * 4);
+}
+
+/**
+ * clutter_color_interpolate_array_premultiplied:
+ * @initial: (array length=n_colors): the initial colors
+ * @final: (array length=n_colors): the final colors
+ * @progress: the interpolation progress, between 0 and 1
+ * @result: (array length=n_colors) (out caller-allocates): return
+ *   location for the interpolated colors
+ * @n_colors: the number of colors
+ *
+ * Interpolates each color in @initial with the color at the same
+ * position in @final using @progress, like clutter_color_interpolate_array(),
+ * but weighting the color channels by the alpha channel.
+ *
+ * The colors in @initial, @final and @result are not premultiplied;
+ * interpolating the premultiplied colors means that a fully transparent
+ * color does not tint the interpolation, for instance when fading a
+ * color in from transparent black.
+ *
+ * Since: 1.26
+ */
+void
+clutter_color_interpolate_array_premultiplied (const ClutterColor *initial,
+                                               const ClutterColor *final,
+                                               gdouble             progress,
+                                               ClutterColor       *result,
+                                               guint               n_colors)
+{
+  float t = CLAMP (progress, 0.0, 1.0);
+  guint i = 0;
+
+  g_return_if_fail (n_colors == 0 || (initial != NULL && final != NULL));
+  g_return_if_fail (n_colors == 0 || result != NULL);
+
+#ifdef __SSE2__
+  {
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128 v_t = _mm_set1_ps (t);
+    const __m128 v_255 = _mm_set1_ps (255.f);
+    const __m128 v_inv_255 = _mm_set1_ps (1.f / 255.f);
+    const __m128 rgb_mask = _mm_castsi128_ps (_mm_set_epi32 (0, -1, -1, -1));
+    const __m128 alpha_one = _mm_set_ps (1.f, 0.f, 0.f, 0.f);
+
+    for (; i < n_colors; i++)
+      {
+        __m128i ia, ib;
+        __m128 a, b, ka, kb, p, alpha, k;
+        guint32 pixel;
+
+        memcpy (&pixel, &initial[i], 4);
+        ia = _mm_unpacklo_epi16 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (pixel),
+                                                    zero),
+                                 zero);
+        memcpy (&pixel, &final[i], 4);
+        ib = _mm_unpacklo_epi16 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (pixel),
+                                                    zero),
+                                 zero);
+
+        a = _mm_cvtepi32_ps (ia);
+        b = _mm_cvtepi32_ps (ib);
+
+        /* premultiply the color channels, keeping the alpha */
+        ka = _mm_mul_ps (_mm_shuffle_ps (a, a, _MM_SHUFFLE (3, 3, 3, 3)),
+                         v_inv_255);
+        kb = _mm_mul_ps (_mm_shuffle_ps (b, b, _MM_SHUFFLE (3, 3, 3, 3)),
+                         v_inv_255);
+        a = _mm_mul_ps (a, _mm_or_ps (_mm_and_ps (ka, rgb_mask), alpha_one));
+        b = _mm_mul_ps (b, _mm_or_ps (_mm_and_ps (kb, rgb_mask), alpha_one));
+
+        p = _mm_add_ps (a, _mm_mul_ps (_mm_sub_ps (b, a), v_t));
+
+        /* and divide the color channels by the interpolated alpha; a
+         * fully transparent result is transparent black
+         */
+        alpha = _mm_shuffle_ps (p, p, _MM_SHUFFLE (3, 3, 3, 3));
+        k = _mm_and_ps (_mm_div_ps (v_255, alpha),
+                        _mm_cmpgt_ps (alpha, _mm_setzero_ps ()));
+        p = _mm_mul_ps (p, _mm_or_ps (_mm_and_ps (k, rgb_mask), alpha_one));
+
+        ia = _mm_cvtps_epi32 (_mm_min_ps (p, v_255));
+        ia = _mm_packus_epi16 (_mm_packs_epi32 (ia, ia), zero);
+
+        pixel = _mm_cvtsi128_si32 (ia);
+        memcpy (&result[i], &pixel, 4);
+      }
+  }
+#endif
+
+  for (; i < n_colors; i++)
+    {
+      float a0 = initial[i].alpha / 255.f;
+      float a1 = final[i].alpha / 255.f;
+      float alpha = a0 + (a1 - a0) * t;
+      float red, green, blue;
+
+      red = initial[i].red * a0 + (final[i].red * a1 - initial[i].red * a0) * t;
+      green = initial[i].green * a0 + (final[i].green * a1 - initial[i].green * a0) * t;
+      blue = initial[i].blue * a0 + (final[i].blue * a1 - initial[i].blue * a0) * t;
+
+      if (alpha > 0.f)
+        {
+          red = MIN (red / alpha, 255.f);
+          green = MIN (green / alpha, 255.f);
+          blue = MIN (blue / alpha, 255.f);
+        }
+      else
+        red = green = blue = 0.f;
+
+      result[i].red = red + 0.5f;
+      result[i].green = green + 0.5f;
+      result[i].blue = blue + 0.5f;
+      result[i].alpha = alpha * 255.f + 0.5f;
+    }
+}
+
 static gboolean
 clutter_color_progress (const GValue *a,
                         const GValue *b,
@@ -890,10 +1125,23 @@ clutter_color_progress (const GValue *a,
 {
   const ClutterColor *a_color = clutter_value_get_color (a);
   const ClutterColor *b_color = clutter_value_get_color (b);
-  ClutterColor res = { 0, };
+  ClutterColor *res;
 
-  clutter_color_interpolate (a_color, b_color, progress, &res);
-  clutter_value_set_color (retval, &res);
+  /* this is called for every frame of a color transition, so reuse
+   * the color that @retval already owns instead of copying a new one
+   */
+  res = g_value_get_boxed (retval);
+  if (res != NULL && (retval->data[1].v_uint & G_VALUE_NOCOPY_CONTENTS) == 0)
+    {
+      clutter_color_interpolate (a_color, b_color, progress, res);
+    }
+  else
+    {
+      ClutterColor color = { 0, };
+
+      clutter_color_interpolate (a_color, b_color, progress, &color);
+      clutter_value_set_color (retval, &color);
+    }
 
   return TRUE;
 }
@@ -142,6 +142,18 @@ void          clutter_color_interpolate (const ClutterColor *initial,
                                          const ClutterColor *final,
                                          gdouble             progress,
                                          ClutterColor       *result);
+CLUTTER_AVAILABLE_IN_1_26
+void          clutter_color_interpolate_array               (const ClutterColor *initial,
+                                                             const ClutterColor *final,
+                                                             gdouble             progress,
+                                                             ClutterColor       *result,
+                                                             guint               n_colors);
+CLUTTER_AVAILABLE_IN_1_26
+void          clutter_color_interpolate_array_premultiplied (const ClutterColor *initial,
+                                                             const ClutterColor *final,
+                                                             gdouble             progress,
+                                                             ClutterColor       *result,
+                                                             guint               n_colors);
 
 #define CLUTTER_TYPE_PARAM_COLOR           (clutter_param_color_get_type ())
 #define CLUTTER_PARAM_SPEC_COLOR(pspec)    (G_TYPE_CHECK_INSTANCE_CAST ((pspec), CLUTTER_TYPE_PARAM_COLOR, ClutterParamSpecColor))
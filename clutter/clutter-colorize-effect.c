@@ -50,6 +50,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterColorizeEffect
@@ -72,6 +73,11 @@ struct _ClutterColorizeEffectClass
   ClutterOffscreenEffectClass parent_class;
 
   CoglPipeline *base_pipeline;
+
+  /* the snippet of the base pipeline, also used when the effect is
+   * fused with other pointwise effects
+   */
+  CoglSnippet *snippet;
 };
 
 /* the magic gray vec3 has been taken from the NTSC conversion weights
@@ -223,6 +229,45 @@ clutter_colorize_effect_get_property (GObject    *gobject,
     }
 }
 
+static void
+update_tint_uniform (ClutterColorizeEffect *self,
+                     CoglPipeline          *pipeline)
+{
+  if (self->tint_uniform > -1)
+    {
+      float tint[3] = {
+        self->tint.red / 255.0,
+        self->tint.green / 255.0,
+        self->tint.blue / 255.0
+      };
+
+      cogl_pipeline_set_uniform_float (pipeline,
+                                       self->tint_uniform,
+                                       3, /* n_components */
+                                       1, /* count */
+                                       tint);
+    }
+}
+
+static CoglSnippet *
+clutter_colorize_effect_get_snippet (ClutterOffscreenEffect *effect)
+{
+  return CLUTTER_COLORIZE_EFFECT_GET_CLASS (effect)->snippet;
+}
+
+static void
+clutter_colorize_effect_set_uniforms (ClutterOffscreenEffect *effect,
+                                      CoglPipeline           *pipeline)
+{
+  update_tint_uniform (CLUTTER_COLORIZE_EFFECT (effect), pipeline);
+}
+
+static const ClutterPointwiseEffectFuncs pointwise_funcs = {
+  clutter_colorize_effect_get_snippet,
+  clutter_colorize_effect_set_uniforms,
+  NULL
+};
+
 static void
 clutter_colorize_effect_class_init (ClutterColorizeEffectClass *klass)
 {
@@ -233,6 +278,9 @@ clutter_colorize_effect_class_init (ClutterColorizeEffectClass *klass)
   offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
   offscreen_class->paint_target = clutter_colorize_effect_paint_target;
 
+  _clutter_offscreen_effect_class_set_pointwise (offscreen_class,
+                                                 &pointwise_funcs);
+
   effect_class->pre_paint = clutter_colorize_effect_pre_paint;
 
   gobject_class->set_property = clutter_colorize_effect_set_property;
@@ -256,25 +304,6 @@ clutter_colorize_effect_class_init (ClutterColorizeEffectClass *klass)
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 }
 
-static void
-update_tint_uniform (ClutterColorizeEffect *self)
-{
-  if (self->tint_uniform > -1)
-    {
-      float tint[3] = {
-        self->tint.red / 255.0,
-        self->tint.green / 255.0,
-        self->tint.blue / 255.0
-      };
-
-      cogl_pipeline_set_uniform_float (self->pipeline,
-                                       self->tint_uniform,
-                                       3, /* n_components */
-                                       1, /* count */
-                                       tint);
-    }
-}
-
 static void
 clutter_colorize_effect_init (ClutterColorizeEffect *self)
 {
@@ -292,7 +321,7 @@ clutter_colorize_effect_init (ClutterColorizeEffect *self)
                                   colorize_glsl_declarations,
                                   colorize_glsl_source);
       cogl_pipeline_add_snippet (klass->base_pipeline, snippet);
-      cogl_object_unref (snippet);
+      klass->snippet = snippet;
 
       cogl_pipeline_set_layer_null_texture (klass->base_pipeline,
                                             0, /* layer number */
@@ -306,7 +335,7 @@ clutter_colorize_effect_init (ClutterColorizeEffect *self)
 
   self->tint = default_tint;
 
-  update_tint_uniform (self);
+  update_tint_uniform (self, self->pipeline);
 }
 
 /**
@@ -345,7 +374,7 @@ clutter_colorize_effect_set_tint (ClutterColorizeEffect *effect,
 
   effect->tint = *tint;
 
-  update_tint_uniform (effect);
+  update_tint_uniform (effect, effect->pipeline);
 
   clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
 
@@ -0,0 +1,920 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * Compressed textures: loads KTX and PKM containers holding ETC1, ETC2
+ * or ASTC data.
+ *
+ * Cogl does not know about compressed pixel formats, so the data is
+ * uploaded using glCompressedTexImage2D() into a GL texture owned by
+ * Clutter, which is then wrapped into a foreign Cogl texture. If the
+ * driver does not support the format, ETC1 and ETC2 data is decoded
+ * on the CPU instead; ASTC data cannot be used in that case.
+ *
+ * The data with an alpha channel is expected to be premultiplied, as
+ * it cannot be converted.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+
+#include <string.h>
+
+#include "clutter-compressed-texture.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-image.h"
+#include "clutter-private.h"
+
+#ifdef G_OS_WIN32
+#define CLUTTER_GL_APIENTRY __stdcall
+#else
+#define CLUTTER_GL_APIENTRY
+#endif
+
+#define GL_NO_ERROR                                     0
+#define GL_TEXTURE_2D                                   0x0DE1
+#define GL_TEXTURE_BINDING_2D                           0x8069
+#define GL_TEXTURE_MIN_FILTER                           0x2801
+#define GL_TEXTURE_MAG_FILTER                           0x2800
+#define GL_LINEAR                                       0x2601
+#define GL_NUM_COMPRESSED_TEXTURE_FORMATS               0x86A2
+#define GL_COMPRESSED_TEXTURE_FORMATS                   0x86A3
+
+#define GL_ETC1_RGB8_OES                                0x8D64
+#define GL_COMPRESSED_RGB8_ETC2                         0x9274
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2     0x9276
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                    0x9278
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR                 0x93B0
+#define GL_COMPRESSED_RGBA_ASTC_12x12_KHR               0x93BD
+
+typedef void (CLUTTER_GL_APIENTRY *GenTexturesFunc)            (int           n,
+                                                                unsigned int *textures);
+typedef void (CLUTTER_GL_APIENTRY *DeleteTexturesFunc)         (int                 n,
+                                                                const unsigned int *textures);
+typedef void (CLUTTER_GL_APIENTRY *BindTextureFunc)            (unsigned int target,
+                                                                unsigned int texture);
+typedef void (CLUTTER_GL_APIENTRY *TexParameteriFunc)          (unsigned int target,
+                                                                unsigned int pname,
+                                                                int          param);
+typedef void (CLUTTER_GL_APIENTRY *GetIntegervFunc)            (unsigned int  pname,
+                                                                int          *params);
+typedef unsigned int (CLUTTER_GL_APIENTRY *GetErrorFunc)       (void);
+typedef void (CLUTTER_GL_APIENTRY *CompressedTexImage2DFunc)   (unsigned int  target,
+                                                                int           level,
+                                                                unsigned int  internal_format,
+                                                                int           width,
+                                                                int           height,
+                                                                int           border,
+                                                                int           image_size,
+                                                                const void   *data);
+
+typedef struct
+{
+  GenTexturesFunc GenTextures;
+  DeleteTexturesFunc DeleteTextures;
+  BindTextureFunc BindTexture;
+  TexParameteriFunc TexParameteri;
+  GetIntegervFunc GetIntegerv;
+  GetErrorFunc GetError;
+  CompressedTexImage2DFunc CompressedTexImage2D;
+
+  /* the compressed formats supported by the driver */
+  int *formats;
+  int n_formats;
+} GLFuncs;
+
+#define MAX_LEVELS      16
+
+typedef struct
+{
+  unsigned int gl_format;
+
+  int width;
+  int height;
+
+  /* the size of each compressed block, in pixels and bytes */
+  int block_width;
+  int block_height;
+  int block_size;
+
+  guint has_alpha : 1;
+
+  int n_levels;
+  const guint8 *levels[MAX_LEVELS];
+} CompressedImage;
+
+static const guint8 ktx_identifier[] = {
+  0xab, 'K', 'T', 'X', ' ', '1', '1', 0xbb, '\r', '\n', 0x1a, '\n'
+};
+
+/* the ASTC block sizes, indexed from GL_COMPRESSED_RGBA_ASTC_4x4_KHR */
+static const guint8 astc_block_sizes[][2] = {
+  {  4,  4 }, {  5,  4 }, {  5,  5 }, {  6,  5 }, {  6,  6 },
+  {  8,  5 }, {  8,  6 }, {  8,  8 }, { 10,  5 }, { 10,  6 },
+  { 10,  8 }, { 10, 10 }, { 12, 10 }, { 12, 12 },
+};
+
+static GLFuncs *
+get_gl_funcs (void)
+{
+  static GLFuncs *funcs = NULL;
+  static gboolean initialized = FALSE;
+
+  if (G_UNLIKELY (!initialized))
+    {
+      GLFuncs *gl = g_new0 (GLFuncs, 1);
+
+      initialized = TRUE;
+
+      gl->GenTextures = (GenTexturesFunc) cogl_get_proc_address ("glGenTextures");
+      gl->DeleteTextures = (DeleteTexturesFunc) cogl_get_proc_address ("glDeleteTextures");
+      gl->BindTexture = (BindTextureFunc) cogl_get_proc_address ("glBindTexture");
+      gl->TexParameteri = (TexParameteriFunc) cogl_get_proc_address ("glTexParameteri");
+      gl->GetIntegerv = (GetIntegervFunc) cogl_get_proc_address ("glGetIntegerv");
+      gl->GetError = (GetErrorFunc) cogl_get_proc_address ("glGetError");
+      gl->CompressedTexImage2D = (CompressedTexImage2DFunc) cogl_get_proc_address ("glCompressedTexImage2D");
+
+      if (gl->GenTextures == NULL ||
+          gl->DeleteTextures == NULL ||
+          gl->BindTexture == NULL ||
+          gl->TexParameteri == NULL ||
+          gl->GetIntegerv == NULL ||
+          gl->GetError == NULL ||
+          gl->CompressedTexImage2D == NULL)
+        {
+          CLUTTER_NOTE (TEXTURE, "Compressed textures cannot be uploaded");
+          g_free (gl);
+          return NULL;
+        }
+
+      gl->GetIntegerv (GL_NUM_COMPRESSED_TEXTURE_FORMATS, &gl->n_formats);
+      if (gl->n_formats > 0)
+        {
+          gl->formats = g_new0 (int, gl->n_formats);
+          gl->GetIntegerv (GL_COMPRESSED_TEXTURE_FORMATS, gl->formats);
+        }
+
+      CLUTTER_NOTE (TEXTURE, "The driver supports %d compressed formats",
+                    gl->n_formats);
+
+      funcs = gl;
+    }
+
+  return funcs;
+}
+
+static gboolean
+gl_funcs_has_format (GLFuncs      *gl,
+                     unsigned int  gl_format)
+{
+  int i;
+
+  for (i = 0; i < gl->n_formats; i++)
+    {
+      if ((unsigned int) gl->formats[i] == gl_format)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static gboolean
+compressed_image_set_format (CompressedImage *image,
+                             unsigned int     gl_format)
+{
+  image->gl_format = gl_format;
+  image->block_width = 4;
+  image->block_height = 4;
+
+  switch (gl_format)
+    {
+    case GL_ETC1_RGB8_OES:
+    case GL_COMPRESSED_RGB8_ETC2:
+      image->block_size = 8;
+      image->has_alpha = FALSE;
+      return TRUE;
+
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+      image->block_size = 8;
+      image->has_alpha = TRUE;
+      return TRUE;
+
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      image->block_size = 16;
+      image->has_alpha = TRUE;
+      return TRUE;
+
+    default:
+      if (gl_format >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
+          gl_format <= GL_COMPRESSED_RGBA_ASTC_12x12_KHR)
+        {
+          const guint8 *block = astc_block_sizes[gl_format - GL_COMPRESSED_RGBA_ASTC_4x4_KHR];
+
+          image->block_width = block[0];
+          image->block_height = block[1];
+          image->block_size = 16;
+          image->has_alpha = TRUE;
+          return TRUE;
+        }
+      break;
+    }
+
+  return FALSE;
+}
+
+static gsize
+compressed_image_get_level_size (const CompressedImage *image,
+                                 int                    level)
+{
+  int width = MAX (1, image->width >> level);
+  int height = MAX (1, image->height >> level);
+
+  return (gsize) ((width + image->block_width - 1) / image->block_width)
+       * ((height + image->block_height - 1) / image->block_height)
+       * image->block_size;
+}
+
+static guint32
+read_uint32 (const guint8 *data,
+             gboolean      swap)
+{
+  guint32 value;
+
+  memcpy (&value, data, sizeof (value));
+
+  return swap ? GUINT32_SWAP_LE_BE (value) : value;
+}
+
+static gboolean
+parse_ktx (CompressedImage  *image,
+           const guint8     *data,
+           gsize             size,
+           GError          **error)
+{
+  guint32 gl_type, gl_internal_format, depth, n_elements, n_faces;
+  guint32 n_levels, key_value_size;
+  gsize offset;
+  gboolean swap;
+  int i;
+
+  if (size < 64)
+    goto invalid;
+
+  swap = read_uint32 (data + 12, FALSE) != 0x04030201;
+  if (swap && read_uint32 (data + 12, TRUE) != 0x04030201)
+    goto invalid;
+
+  gl_type = read_uint32 (data + 16, swap);
+  gl_internal_format = read_uint32 (data + 28, swap);
+  image->width = read_uint32 (data + 36, swap);
+  image->height = read_uint32 (data + 40, swap);
+  depth = read_uint32 (data + 44, swap);
+  n_elements = read_uint32 (data + 48, swap);
+  n_faces = read_uint32 (data + 52, swap);
+  n_levels = read_uint32 (data + 56, swap);
+  key_value_size = read_uint32 (data + 60, swap);
+
+  /* only single 2D compressed images are supported */
+  if (gl_type != 0 || depth > 1 || n_elements > 0 || n_faces != 1 ||
+      image->width <= 0 || image->height <= 0)
+    goto unsupported;
+
+  if (!compressed_image_set_format (image, gl_internal_format))
+    goto unsupported;
+
+  offset = 64 + key_value_size;
+  image->n_levels = MIN (MAX (n_levels, 1), MAX_LEVELS);
+
+  for (i = 0; i < image->n_levels; i++)
+    {
+      guint32 level_size;
+
+      if (offset + 4 > size)
+        goto invalid;
+
+      level_size = read_uint32 (data + offset, swap);
+      offset += 4;
+
+      if (level_size < compressed_image_get_level_size (image, i) ||
+          offset + level_size > size)
+        goto invalid;
+
+      image->levels[i] = data + offset;
+
+      offset += (level_size + 3) & ~3;
+    }
+
+  return TRUE;
+
+invalid:
+  g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                       CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                       _("Invalid KTX data"));
+  return FALSE;
+
+unsupported:
+  g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                       CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT,
+                       _("Unsupported KTX image format"));
+  return FALSE;
+}
+
+static gboolean
+parse_pkm (CompressedImage  *image,
+           const guint8     *data,
+           gsize             size,
+           GError          **error)
+{
+  unsigned int gl_format;
+
+  if (size < 16)
+    goto invalid;
+
+  switch ((data[6] << 8) | data[7])
+    {
+    case 0:
+      gl_format = GL_ETC1_RGB8_OES;
+      break;
+
+    case 1:
+      gl_format = GL_COMPRESSED_RGB8_ETC2;
+      break;
+
+    case 3:
+      gl_format = GL_COMPRESSED_RGBA8_ETC2_EAC;
+      break;
+
+    case 4:
+      gl_format = GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+      break;
+
+    default:
+      g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                           CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT,
+                           _("Unsupported PKM image format"));
+      return FALSE;
+    }
+
+  compressed_image_set_format (image, gl_format);
+
+  image->width = (data[12] << 8) | data[13];
+  image->height = (data[14] << 8) | data[15];
+  image->n_levels = 1;
+  image->levels[0] = data + 16;
+
+  if (image->width == 0 || image->height == 0 ||
+      16 + compressed_image_get_level_size (image, 0) > size)
+    goto invalid;
+
+  return TRUE;
+
+invalid:
+  g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                       CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                       _("Invalid PKM data"));
+  return FALSE;
+}
+
+static CoglUserDataKey gl_texture_key;
+
+static void
+delete_gl_texture (void *user_data)
+{
+  GLFuncs *gl = get_gl_funcs ();
+  unsigned int handle = GPOINTER_TO_UINT (user_data);
+
+  gl->DeleteTextures (1, &handle);
+}
+
+static CoglTexture *
+upload_compressed_image (const CompressedImage *image)
+{
+  GLFuncs *gl = get_gl_funcs ();
+  CoglTexture2D *texture;
+  CoglContext *ctx;
+  unsigned int handle;
+  CoglError *error = NULL;
+  int prev_binding = 0;
+  gboolean failed = FALSE;
+  int i;
+
+  if (gl == NULL || !gl_funcs_has_format (gl, image->gl_format))
+    return NULL;
+
+  /* Cogl tracks the bound textures, so the binding is restored */
+  gl->GetIntegerv (GL_TEXTURE_BINDING_2D, &prev_binding);
+
+  while (gl->GetError () != GL_NO_ERROR)
+    ;
+
+  gl->GenTextures (1, &handle);
+  gl->BindTexture (GL_TEXTURE_2D, handle);
+  gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  for (i = 0; i < image->n_levels && !failed; i++)
+    {
+      gl->CompressedTexImage2D (GL_TEXTURE_2D, i,
+                                image->gl_format,
+                                MAX (1, image->width >> i),
+                                MAX (1, image->height >> i),
+                                0,
+                                compressed_image_get_level_size (image, i),
+                                image->levels[i]);
+
+      failed = gl->GetError () != GL_NO_ERROR;
+    }
+
+  gl->BindTexture (GL_TEXTURE_2D, prev_binding);
+
+  if (failed)
+    {
+      CLUTTER_NOTE (TEXTURE, "Unable to upload compressed texture (format 0x%x)",
+                    image->gl_format);
+      gl->DeleteTextures (1, &handle);
+      return NULL;
+    }
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  texture = cogl_texture_2d_gl_new_from_foreign (ctx, handle,
+                                                 image->width,
+                                                 image->height,
+                                                 image->has_alpha
+                                                   ? COGL_PIXEL_FORMAT_RGBA_8888_PRE
+                                                   : COGL_PIXEL_FORMAT_RGB_888);
+
+  if (!cogl_texture_allocate (COGL_TEXTURE (texture), &error))
+    {
+      CLUTTER_NOTE (TEXTURE, "Unable to wrap compressed texture: %s",
+                    error->message);
+      cogl_error_free (error);
+      cogl_object_unref (texture);
+      gl->DeleteTextures (1, &handle);
+      return NULL;
+    }
+
+  /* Cogl does not delete foreign textures */
+  cogl_object_set_user_data (COGL_OBJECT (texture), &gl_texture_key,
+                             GUINT_TO_POINTER (handle),
+                             delete_gl_texture);
+
+  return COGL_TEXTURE (texture);
+}
+
+/* ETC1 and ETC2 decoding, see the "ETC Compressed Texture Image
+ * Formats" section of the OpenGL ES 3.0 specification
+ */
+
+static const int etc1_modifiers[8][2] = {
+  {  2,   8 }, {  5,  17 }, {  9,  29 }, { 13,  42 },
+  { 18,  60 }, { 24,  80 }, { 33, 106 }, { 47, 183 },
+};
+
+static const int etc2_distances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const int eac_modifiers[16][8] = {
+  { -3, -6,  -9, -15, 2, 5, 8, 14 },
+  { -3, -7, -10, -13, 2, 6, 9, 12 },
+  { -2, -5,  -8, -13, 1, 4, 7, 12 },
+  { -2, -4,  -6, -13, 1, 3, 5, 12 },
+  { -3, -6,  -8, -12, 2, 5, 7, 11 },
+  { -3, -7,  -9, -11, 2, 6, 8, 10 },
+  { -4, -7,  -8, -11, 3, 6, 7, 10 },
+  { -3, -5,  -8, -11, 2, 4, 7, 10 },
+  { -2, -6,  -8, -10, 1, 5, 7,  9 },
+  { -2, -5,  -8, -10, 1, 4, 7,  9 },
+  { -2, -4,  -8, -10, 1, 3, 7,  9 },
+  { -2, -5,  -7, -10, 1, 4, 6,  9 },
+  { -3, -4,  -7, -10, 2, 3, 6,  9 },
+  { -1, -2,  -3, -10, 0, 1, 2,  9 },
+  { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+  { -3, -5,  -7,  -9, 2, 4, 6,  8 },
+};
+
+static inline guint64
+read_block (const guint8 *data)
+{
+  guint64 value;
+
+  memcpy (&value, data, sizeof (value));
+
+  return GUINT64_FROM_BE (value);
+}
+
+static inline int
+bits (guint64 block,
+      int     high,
+      int     low)
+{
+  return (block >> low) & ((G_GUINT64_CONSTANT (1) << (high - low + 1)) - 1);
+}
+
+static inline guint8
+clamp_byte (int value)
+{
+  return CLAMP (value, 0, 255);
+}
+
+static inline int
+extend_4 (int value)
+{
+  return (value << 4) | value;
+}
+
+static inline int
+extend_5 (int value)
+{
+  return (value << 3) | (value >> 2);
+}
+
+static inline int
+extend_6 (int value)
+{
+  return (value << 2) | (value >> 4);
+}
+
+static inline int
+extend_7 (int value)
+{
+  return (value << 1) | (value >> 6);
+}
+
+static void
+set_color (guint8    *pixel,
+           const int *color,
+           int        delta)
+{
+  pixel[0] = clamp_byte (color[0] + delta);
+  pixel[1] = clamp_byte (color[1] + delta);
+  pixel[2] = clamp_byte (color[2] + delta);
+  pixel[3] = 255;
+}
+
+/* decodes a 4x4 block into @pixels, an array of 16 RGBA pixels in
+ * column-major order
+ */
+static void
+decode_etc2_color_block (const guint8 *data,
+                         gboolean      is_etc2,
+                         gboolean      punchthrough,
+                         guint8       *pixels)
+{
+  guint64 block = read_block (data);
+  guint32 indices = block & 0xffffffff;
+  gboolean diff = bits (block, 33, 33);
+  gboolean opaque = TRUE;
+  int i;
+
+  /* the differential bit is the opaque bit with punchthrough alpha,
+   * and the individual mode is not available
+   */
+  if (punchthrough)
+    {
+      opaque = diff;
+      diff = TRUE;
+    }
+
+  if (diff && is_etc2)
+    {
+      int r = bits (block, 63, 59), dr = bits (block, 58, 56);
+      int g = bits (block, 55, 51), dg = bits (block, 50, 48);
+      int b = bits (block, 47, 43), db = bits (block, 42, 40);
+
+      /* the deltas are 3 bits, two's complement */
+      dr = (dr << 29) >> 29;
+      dg = (dg << 29) >> 29;
+      db = (db << 29) >> 29;
+
+      if (r + dr < 0 || r + dr > 31)
+        {
+          /* T mode */
+          int c1[3], c2[3], d, paint[4][3];
+
+          c1[0] = extend_4 ((bits (block, 60, 59) << 2) | bits (block, 57, 56));
+          c1[1] = extend_4 (bits (block, 55, 52));
+          c1[2] = extend_4 (bits (block, 51, 48));
+          c2[0] = extend_4 (bits (block, 47, 44));
+          c2[1] = extend_4 (bits (block, 43, 40));
+          c2[2] = extend_4 (bits (block, 39, 36));
+          d = etc2_distances[(bits (block, 35, 34) << 1) | bits (block, 32, 32)];
+
+          for (i = 0; i < 3; i++)
+            {
+              paint[0][i] = c1[i];
+              paint[1][i] = c2[i] + d;
+              paint[2][i] = c2[i];
+              paint[3][i] = c2[i] - d;
+            }
+
+          for (i = 0; i < 16; i++)
+            {
+              int index = (((indices >> (16 + i)) & 1) << 1) | ((indices >> i) & 1);
+
+              if (!opaque && index == 2)
+                memset (pixels + i * 4, 0, 4);
+              else
+                set_color (pixels + i * 4, paint[index], 0);
+            }
+
+          return;
+        }
+
+      if (g + dg < 0 || g + dg > 31)
+        {
+          /* H mode */
+          int c1[3], c2[3], d, paint[4][3];
+          int d_index;
+
+          c1[0] = extend_4 (bits (block, 62, 59));
+          c1[1] = extend_4 ((bits (block, 58, 56) << 1) | bits (block, 52, 52));
+          c1[2] = extend_4 ((bits (block, 51, 51) << 3) | bits (block, 49, 47));
+          c2[0] = extend_4 (bits (block, 46, 43));
+          c2[1] = extend_4 (bits (block, 42, 39));
+          c2[2] = extend_4 (bits (block, 38, 35));
+
+          d_index = (bits (block, 34, 34) << 2) | (bits (block, 32, 32) << 1);
+          if (((c1[0] << 16) | (c1[1] << 8) | c1[2]) >=
+              ((c2[0] << 16) | (c2[1] << 8) | c2[2]))
+            d_index |= 1;
+
+          d = etc2_distances[d_index];
+
+          for (i = 0; i < 3; i++)
+            {
+              paint[0][i] = c1[i] + d;
+              paint[1][i] = c1[i] - d;
+              paint[2][i] = c2[i] + d;
+              paint[3][i] = c2[i] - d;
+            }
+
+          for (i = 0; i < 16; i++)
+            {
+              int index = (((indices >> (16 + i)) & 1) << 1) | ((indices >> i) & 1);
+
+              if (!opaque && index == 2)
+                memset (pixels + i * 4, 0, 4);
+              else
+                set_color (pixels + i * 4, paint[index], 0);
+            }
+
+          return;
+        }
+
+      if (b + db < 0 || b + db > 31)
+        {
+          /* planar mode, which is always opaque */
+          int o[3], h[3], v[3];
+          int x, y;
+
+          o[0] = extend_6 (bits (block, 62, 57));
+          o[1] = extend_7 ((bits (block, 56, 56) << 6) | bits (block, 54, 49));
+          o[2] = extend_6 ((bits (block, 48, 48) << 5) |
+                           (bits (block, 44, 43) << 3) |
+                           bits (block, 41, 39));
+          h[0] = extend_6 ((bits (block, 38, 34) << 1) | bits (block, 32, 32));
+          h[1] = extend_7 (bits (block, 31, 25));
+          h[2] = extend_6 (bits (block, 24, 19));
+          v[0] = extend_6 (bits (block, 18, 13));
+          v[1] = extend_7 (bits (block, 12, 6));
+          v[2] = extend_6 (bits (block, 5, 0));
+
+          for (x = 0; x < 4; x++)
+            for (y = 0; y < 4; y++)
+              {
+                guint8 *pixel = pixels + (x * 4 + y) * 4;
+
+                for (i = 0; i < 3; i++)
+                  pixel[i] = clamp_byte ((x * (h[i] - o[i]) +
+                                          y * (v[i] - o[i]) +
+                                          4 * o[i] + 2) >> 2);
+
+                pixel[3] = 255;
+              }
+
+          return;
+        }
+    }
+
+  /* ETC1 individual and differential modes */
+  {
+    int base[2][3], table[2];
+    gboolean flip = bits (block, 32, 32);
+
+    if (diff)
+      {
+        int r = bits (block, 63, 59), dr = (bits (block, 58, 56) << 29) >> 29;
+        int g = bits (block, 55, 51), dg = (bits (block, 50, 48) << 29) >> 29;
+        int b = bits (block, 47, 43), db = (bits (block, 42, 40) << 29) >> 29;
+
+        base[0][0] = extend_5 (r);
+        base[0][1] = extend_5 (g);
+        base[0][2] = extend_5 (b);
+        base[1][0] = extend_5 ((r + dr) & 0x1f);
+        base[1][1] = extend_5 ((g + dg) & 0x1f);
+        base[1][2] = extend_5 ((b + db) & 0x1f);
+      }
+    else
+      {
+        base[0][0] = extend_4 (bits (block, 63, 60));
+        base[1][0] = extend_4 (bits (block, 59, 56));
+        base[0][1] = extend_4 (bits (block, 55, 52));
+        base[1][1] = extend_4 (bits (block, 51, 48));
+        base[0][2] = extend_4 (bits (block, 47, 44));
+        base[1][2] = extend_4 (bits (block, 43, 40));
+      }
+
+    table[0] = bits (block, 39, 37);
+    table[1] = bits (block, 36, 34);
+
+    for (i = 0; i < 16; i++)
+      {
+        int x = i / 4, y = i % 4;
+        int sub = flip ? (y >= 2) : (x >= 2);
+        int msb = (indices >> (16 + i)) & 1;
+        int lsb = (indices >> i) & 1;
+        int delta;
+
+        if (!opaque && msb && !lsb)
+          {
+            memset (pixels + i * 4, 0, 4);
+            continue;
+          }
+
+        /* without the opaque bit, the smaller modifiers are zero */
+        if (!opaque && !lsb)
+          delta = 0;
+        else
+          delta = etc1_modifiers[table[sub]][lsb];
+
+        set_color (pixels + i * 4, base[sub], msb ? -delta : delta);
+      }
+  }
+}
+
+static void
+decode_eac_alpha_block (const guint8 *data,
+                        guint8       *pixels)
+{
+  guint64 block = read_block (data);
+  int base = bits (block, 63, 56);
+  int multiplier = bits (block, 55, 52);
+  const int *modifiers = eac_modifiers[bits (block, 51, 48)];
+  int i;
+
+  for (i = 0; i < 16; i++)
+    {
+      int index = bits (block, 47 - i * 3, 45 - i * 3);
+
+      pixels[i * 4 + 3] = clamp_byte (base + modifiers[index] * multiplier);
+    }
+}
+
+static CoglTexture *
+decode_compressed_image (const CompressedImage  *image,
+                         GError                **error)
+{
+  int blocks_x = (image->width + 3) / 4;
+  int blocks_y = (image->height + 3) / 4;
+  const guint8 *src = image->levels[0];
+  CoglTexture *texture;
+  int stride = image->width * 4;
+  guint8 *data;
+  int bx, by;
+
+  if (image->gl_format >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
+      image->gl_format <= GL_COMPRESSED_RGBA_ASTC_12x12_KHR)
+    {
+      g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                           CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT,
+                           _("ASTC textures are not supported by the driver"));
+      return NULL;
+    }
+
+  CLUTTER_NOTE (TEXTURE, "Decoding compressed texture (format 0x%x, size %d x %d)",
+                image->gl_format,
+                image->width,
+                image->height);
+
+  data = g_malloc (stride * image->height);
+
+  for (by = 0; by < blocks_y; by++)
+    for (bx = 0; bx < blocks_x; bx++)
+      {
+        guint8 pixels[16 * 4];
+        int x, y;
+
+        if (image->gl_format == GL_COMPRESSED_RGBA8_ETC2_EAC)
+          {
+            decode_etc2_color_block (src + 8, TRUE, FALSE, pixels);
+            decode_eac_alpha_block (src, pixels);
+          }
+        else
+          decode_etc2_color_block (src,
+                                   image->gl_format != GL_ETC1_RGB8_OES,
+                                   image->gl_format == GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,
+                                   pixels);
+
+        src += image->block_size;
+
+        for (x = 0; x < 4 && bx * 4 + x < image->width; x++)
+          for (y = 0; y < 4 && by * 4 + y < image->height; y++)
+            memcpy (data + (by * 4 + y) * stride + (bx * 4 + x) * 4,
+                    pixels + (x * 4 + y) * 4,
+                    4);
+      }
+
+  texture = cogl_texture_new_from_data (image->width, image->height,
+                                        COGL_TEXTURE_NONE,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                        image->has_alpha
+                                          ? COGL_PIXEL_FORMAT_ANY
+                                          : COGL_PIXEL_FORMAT_RGB_888,
+                                        stride,
+                                        data);
+  g_free (data);
+
+  if (texture == NULL)
+    g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                         CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                         _("Unable to load image data"));
+
+  return texture;
+}
+
+/*< private >
+ * _clutter_compressed_texture_new:
+ * @data: the contents of a KTX or PKM file
+ * @size: the size of @data
+ * @error: return location for a #GError, or %NULL
+ *
+ * Creates a texture from the compressed image inside @data, using the
+ * compressed data directly if the driver supports its format, and
+ * decoding it otherwise.
+ *
+ * Return value: (transfer full): the newly created texture, or %NULL
+ */
+CoglTexture *
+_clutter_compressed_texture_new (const guint8  *data,
+                                 gsize          size,
+                                 GError       **error)
+{
+  CompressedImage image = { 0, };
+  CoglTexture *texture;
+
+  g_return_val_if_fail (data != NULL, NULL);
+
+  if (size >= sizeof (ktx_identifier) &&
+      memcmp (data, ktx_identifier, sizeof (ktx_identifier)) == 0)
+    {
+      if (!parse_ktx (&image, data, size, error))
+        return NULL;
+    }
+  else if (size >= 4 && memcmp (data, "PKM ", 4) == 0)
+    {
+      if (!parse_pkm (&image, data, size, error))
+        return NULL;
+    }
+  else
+    {
+      g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
+                           CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT,
+                           _("The data is neither a KTX nor a PKM image"));
+      return NULL;
+    }
+
+  texture = upload_compressed_image (&image);
+  if (texture != NULL)
+    {
+      CLUTTER_NOTE (TEXTURE, "Uploaded compressed texture (format 0x%x, size %d x %d)",
+                    image.gl_format,
+                    image.width,
+                    image.height);
+      return texture;
+    }
+
+  return decode_compressed_image (&image, error);
+}
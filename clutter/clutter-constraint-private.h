@@ -37,6 +37,9 @@ void clutter_constraint_update_preferred_size (ClutterConstraint  *constraint,
                                                float              *minimum_size,
                                                float              *natural_size);
 
+void _clutter_constraint_set_source (ClutterConstraint *constraint,
+                                     ClutterActor      *source);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CONSTRAINT_PRIVATE_H__ */
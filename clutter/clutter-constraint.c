@@ -138,11 +138,18 @@
 
 #include "clutter-actor.h"
 #include "clutter-actor-meta-private.h"
+#include "clutter-actor-private.h"
 #include "clutter-private.h"
 
-G_DEFINE_ABSTRACT_TYPE (ClutterConstraint,
-                        clutter_constraint,
-                        CLUTTER_TYPE_ACTOR_META);
+typedef struct _ClutterConstraintPrivate
+{
+  /* the actor whose allocation is read by the constraint */
+  ClutterActor *source;
+} ClutterConstraintPrivate;
+
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterConstraint,
+                                     clutter_constraint,
+                                     CLUTTER_TYPE_ACTOR_META);
 
 static void
 constraint_update_allocation (ClutterConstraint *constraint,
@@ -178,12 +185,21 @@ clutter_constraint_notify (GObject    *gobject,
     G_OBJECT_CLASS (clutter_constraint_parent_class)->notify (gobject, pspec);
 }
 
+static void
+clutter_constraint_dispose (GObject *gobject)
+{
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (gobject), NULL);
+
+  G_OBJECT_CLASS (clutter_constraint_parent_class)->dispose (gobject);
+}
+
 static void
 clutter_constraint_class_init (ClutterConstraintClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->notify = clutter_constraint_notify;
+  gobject_class->dispose = clutter_constraint_dispose;
 
   klass->update_allocation = constraint_update_allocation;
   klass->update_preferred_size = constraint_update_preferred_size;
@@ -241,3 +257,39 @@ clutter_constraint_update_preferred_size (ClutterConstraint  *constraint,
                                                                     minimum_size,
                                                                     natural_size);
 }
+
+/*< private >
+ * _clutter_constraint_set_source:
+ * @constraint: a #ClutterConstraint
+ * @source: (allow-none): the #ClutterActor whose allocation is used
+ *   by @constraint, or %NULL
+ *
+ * Records the source of @constraint, so that the actor using
+ * @constraint is allocated again, after @source, whenever the
+ * allocation of @source changes.
+ *
+ * Sub-classes reading the allocation of another actor should call
+ * this function instead of tracking the changes of its allocation.
+ */
+void
+_clutter_constraint_set_source (ClutterConstraint *constraint,
+                                ClutterActor      *source)
+{
+  ClutterConstraintPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CONSTRAINT (constraint));
+  g_return_if_fail (source == NULL || CLUTTER_IS_ACTOR (source));
+
+  priv = clutter_constraint_get_instance_private (constraint);
+
+  if (priv->source == source)
+    return;
+
+  if (priv->source != NULL)
+    _clutter_actor_remove_constraint_dependent (priv->source, constraint);
+
+  priv->source = source;
+
+  if (priv->source != NULL)
+    _clutter_actor_add_constraint_dependent (priv->source, constraint);
+}
@@ -167,14 +167,28 @@ clutter_content_default_init (ClutterContentInterface *iface)
 void
 clutter_content_invalidate (ClutterContent *content)
 {
-  GHashTable *actors;
-  GHashTableIter iter;
-  gpointer key_p, value_p;
-
   g_return_if_fail (CLUTTER_IS_CONTENT (content));
 
   CLUTTER_CONTENT_GET_IFACE (content)->invalidate (content);
 
+  _clutter_content_queue_redraw (content);
+}
+
+/*< private >
+ * _clutter_content_queue_redraw:
+ * @content: a #ClutterContent
+ *
+ * Queues a redraw of the actors using @content, without invalidating
+ * it; this can be used by the implementations that already updated
+ * the parts of their state that changed.
+ */
+void
+_clutter_content_queue_redraw (ClutterContent *content)
+{
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer key_p, value_p;
+
   actors = g_object_get_qdata (G_OBJECT (content), quark_content_actors);
   if (actors == NULL)
     return;
@@ -190,6 +204,55 @@ clutter_content_invalidate (ClutterContent *content)
     }
 }
 
+/*< private >
+ * _clutter_content_is_on_screen:
+ * @content: a #ClutterContent
+ *
+ * Checks whether one of the actors using @content is mapped, and has
+ * a paint box intersecting the size of its stage.
+ *
+ * The actors without a paint box are considered on screen.
+ *
+ * Return value: %TRUE if @content is painted on screen
+ */
+gboolean
+_clutter_content_is_on_screen (ClutterContent *content)
+{
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer key_p, value_p;
+
+  actors = g_object_get_qdata (G_OBJECT (content), quark_content_actors);
+  if (actors == NULL)
+    return FALSE;
+
+  g_hash_table_iter_init (&iter, actors);
+  while (g_hash_table_iter_next (&iter, &key_p, &value_p))
+    {
+      ClutterActor *actor = key_p;
+      ClutterActor *stage;
+      ClutterActorBox box;
+      gfloat width, height;
+
+      if (!clutter_actor_is_mapped (actor))
+        continue;
+
+      if (!clutter_actor_get_paint_box (actor, &box))
+        return TRUE;
+
+      stage = clutter_actor_get_stage (actor);
+      if (stage == NULL)
+        continue;
+
+      clutter_actor_get_size (stage, &width, &height);
+
+      if (box.x2 > 0 && box.y2 > 0 && box.x1 < width && box.y1 < height)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 /*< private >
  * _clutter_content_attached:
  * @content: a #ClutterContent
@@ -28,7 +28,9 @@ typedef enum {
 
 typedef enum {
   CLUTTER_DEBUG_NOP_PICKING         = 1 << 0,
-  CLUTTER_DEBUG_DUMP_PICK_BUFFERS   = 1 << 1
+  CLUTTER_DEBUG_DUMP_PICK_BUFFERS   = 1 << 1,
+  CLUTTER_DEBUG_DISABLE_PICK_CACHE  = 1 << 2,
+  CLUTTER_DEBUG_DISABLE_GRAB_PICK_SKIP = 1 << 3
 } ClutterPickDebugFlag;
 
 typedef enum {
@@ -39,7 +41,10 @@ typedef enum {
   CLUTTER_DEBUG_DISABLE_CULLING         = 1 << 4,
   CLUTTER_DEBUG_DISABLE_OFFSCREEN_REDIRECT = 1 << 5,
   CLUTTER_DEBUG_CONTINUOUS_REDRAW       = 1 << 6,
-  CLUTTER_DEBUG_PAINT_DEFORM_TILES      = 1 << 7
+  CLUTTER_DEBUG_PAINT_DEFORM_TILES      = 1 << 7,
+  CLUTTER_DEBUG_DISABLE_RETAINED_PAINT_NODES = 1 << 8,
+  CLUTTER_DEBUG_OVERDRAW                = 1 << 9,
+  CLUTTER_DEBUG_BATCH_BREAKS            = 1 << 10
 } ClutterDrawDebugFlag;
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -0,0 +1,59 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_DEFORM_EFFECT_PRIVATE_H__
+#define __CLUTTER_DEFORM_EFFECT_PRIVATE_H__
+
+#include <clutter/clutter-deform-effect.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterDeformEffectShaderFuncs  ClutterDeformEffectShaderFuncs;
+
+/*< private >
+ * ClutterDeformEffectShaderFuncs:
+ * @get_snippet: returns the %COGL_SNIPPET_HOOK_VERTEX snippet applying
+ *   the deformation; the undeformed position of the vertex, in pixels,
+ *   is in cogl_position_in, and the snippet should replace
+ *   cogl_position_out, and optionally modulate cogl_color_out
+ * @set_uniforms: sets the uniforms used by the snippet on a pipeline,
+ *   for a target of the given size
+ *
+ * The functions of a deform effect which can deform its vertices in a
+ * vertex shader. The mesh of those effects is only uploaded again when
+ * its size changes, and the ClutterDeformEffectClass.deform_vertex()
+ * virtual function is only used when GLSL is not available.
+ */
+struct _ClutterDeformEffectShaderFuncs
+{
+  CoglSnippet * (* get_snippet)  (ClutterDeformEffect *effect);
+  void          (* set_uniforms) (ClutterDeformEffect *effect,
+                                  CoglPipeline        *pipeline,
+                                  gfloat               width,
+                                  gfloat               height);
+};
+
+void            _clutter_deform_effect_class_set_shader (ClutterDeformEffectClass             *klass,
+                                                         const ClutterDeformEffectShaderFuncs *funcs);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_DEFORM_EFFECT_PRIVATE_H__ */
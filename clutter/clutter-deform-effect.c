@@ -58,15 +58,24 @@
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 #include "clutter-deform-effect.h"
 
+#include <math.h>
+
 #include <cogl/cogl.h>
 
 #include "clutter-debug.h"
+#include "clutter-deform-effect-private.h"
 #include "clutter-enum-types.h"
+#include "clutter-feature.h"
 #include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 #define DEFAULT_N_TILES         32
 
+/* the smallest size of a tile on screen, in pixels; smaller tiles do
+ * not make the deformation look any better
+ */
+#define MIN_TILE_SIZE           8.f
+
 struct _ClutterDeformEffectPrivate
 {
   CoglPipeline *back_pipeline;
@@ -82,9 +91,31 @@ struct _ClutterDeformEffectPrivate
 
   gint n_vertices;
 
+  /* the number of tiles of the mesh, which has less tiles than
+   * requested when the actor is small on screen
+   */
+  gint mesh_x_tiles;
+  gint mesh_y_tiles;
+
+  /* the number of tiles is divided by 1 << quality_shift when the
+   * quality of the stage is lowered
+   */
+  guint quality_shift;
+
+  /* the size of the undeformed vertices of the mesh, when they are
+   * deformed in the vertex shader
+   */
+  gfloat mesh_width;
+  gfloat mesh_height;
+
+  /* the target pipeline with the snippet of the effect */
+  CoglPipeline *snippet_pipeline;
+
   gulong allocation_id;
 
   guint is_dirty : 1;
+  guint mesh_uses_shader : 1;
+  guint mesh_is_flat : 1;
 };
 
 enum
@@ -101,10 +132,17 @@ enum
 
 static GParamSpec *obj_props[PROP_LAST];
 
+static GQuark quark_shader_funcs = 0;
+
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterDeformEffect,
                                      clutter_deform_effect,
                                      CLUTTER_TYPE_OFFSCREEN_EFFECT)
 
+static void clutter_deform_effect_init_arrays (ClutterDeformEffect *self,
+                                               gint                 x_tiles,
+                                               gint                 y_tiles,
+                                               gboolean             use_shader);
+
 static void
 clutter_deform_effect_real_deform_vertex (ClutterDeformEffect *effect,
                                           gfloat               width,
@@ -167,112 +205,207 @@ clutter_deform_effect_set_actor (ClutterActorMeta *meta,
   CLUTTER_ACTOR_META_CLASS (clutter_deform_effect_parent_class)->set_actor (meta, actor);
 }
 
+/* returns the shader functions of the effect, if they can be used */
+static const ClutterDeformEffectShaderFuncs *
+get_shader_funcs (ClutterDeformEffect *self)
+{
+  const ClutterDeformEffectShaderFuncs *funcs;
+
+  funcs = g_type_get_qdata (G_OBJECT_TYPE (self), quark_shader_funcs);
+  if (funcs == NULL)
+    return NULL;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return NULL;
+
+  return funcs;
+}
+
+/* the number of tiles for @size pixels on screen, rounded up to a power
+ * of two, so that animating the size of an actor does not build a new
+ * mesh on every frame
+ */
+static gint
+get_mesh_tiles (gint   n_tiles,
+                gfloat size)
+{
+  gint needed = ceilf (size / MIN_TILE_SIZE);
+  gint res = 1;
+
+  while (res < needed && res < n_tiles)
+    res *= 2;
+
+  return MIN (res, n_tiles);
+}
+
+static void
+clutter_deform_effect_update_vertices (ClutterDeformEffect *self,
+                                       gfloat               width,
+                                       gfloat               height,
+                                       guint                opacity,
+                                       gboolean             deform)
+{
+  ClutterDeformEffectPrivate *priv = self->priv;
+  gboolean mapped_buffer;
+  CoglVertexP3T2C4 *verts;
+  gint i, j;
+
+  verts = cogl_buffer_map (COGL_BUFFER (priv->buffer),
+                           COGL_BUFFER_ACCESS_WRITE,
+                           COGL_BUFFER_MAP_HINT_DISCARD);
+
+  /* If the map failed then we'll resort to allocating a temporary
+     buffer */
+  if (verts == NULL)
+    {
+      mapped_buffer = FALSE;
+      verts = g_malloc (sizeof (*verts) * priv->n_vertices);
+    }
+  else
+    mapped_buffer = TRUE;
+
+  for (i = 0; i < priv->mesh_y_tiles + 1; i++)
+    {
+      for (j = 0; j < priv->mesh_x_tiles + 1; j++)
+        {
+          CoglVertexP3T2C4 *vertex_out;
+          CoglTextureVertex vertex;
+
+          /* CoglTextureVertex isn't an ideal structure to use for
+             this because it contains a CoglColor. The internal
+             layout of CoglColor is mean to be private so Clutter
+             can not pass a pointer to it as a vertex
+             attribute. Also it contains padding so we end up
+             storing more data in the vertex buffer than we need
+             to. Instead we let the application modify a dummy
+             vertex and then copy the details back out to a more
+             well-defined struct */
+
+          vertex.tx = (float) j / priv->mesh_x_tiles;
+          vertex.ty = (float) i / priv->mesh_y_tiles;
+
+          vertex.x = width * vertex.tx;
+          vertex.y = height * vertex.ty;
+          vertex.z = 0.0f;
+
+          cogl_color_init_from_4ub (&vertex.color, 255, 255, 255, opacity);
+
+          if (deform)
+            clutter_deform_effect_deform_vertex (self,
+                                                 width, height,
+                                                 &vertex);
+
+          vertex_out = verts + i * (priv->mesh_x_tiles + 1) + j;
+
+          vertex_out->x = vertex.x;
+          vertex_out->y = vertex.y;
+          vertex_out->z = vertex.z;
+          vertex_out->s = vertex.tx;
+          vertex_out->t = vertex.ty;
+          vertex_out->r = cogl_color_get_red_byte (&vertex.color);
+          vertex_out->g = cogl_color_get_green_byte (&vertex.color);
+          vertex_out->b = cogl_color_get_blue_byte (&vertex.color);
+          vertex_out->a = cogl_color_get_alpha_byte (&vertex.color);
+        }
+    }
+
+  if (mapped_buffer)
+    cogl_buffer_unmap (COGL_BUFFER (priv->buffer));
+  else
+    {
+      cogl_buffer_set_data (COGL_BUFFER (priv->buffer),
+                            0, /* offset */
+                            verts,
+                            sizeof (*verts) * priv->n_vertices);
+      g_free (verts);
+    }
+}
+
+/* the deformation of the shader is applied through the uniforms, and
+ * the opacity through the color of the pipeline, since the vertices
+ * of the mesh have no color
+ */
+static void
+clutter_deform_effect_setup_shader (ClutterDeformEffect                  *self,
+                                    const ClutterDeformEffectShaderFuncs *funcs,
+                                    CoglPipeline                         *pipeline,
+                                    gfloat                                width,
+                                    gfloat                                height,
+                                    guint                                 opacity)
+{
+  funcs->set_uniforms (self, pipeline, width, height);
+  cogl_pipeline_set_color4ub (pipeline, opacity, opacity, opacity, opacity);
+}
+
 static void
 clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterDeformEffect *self= CLUTTER_DEFORM_EFFECT (effect);
   ClutterDeformEffectPrivate *priv = self->priv;
+  const ClutterDeformEffectShaderFuncs *funcs;
   CoglHandle material;
   CoglPipeline *pipeline;
   CoglDepthState depth_state;
   CoglFramebuffer *fb = cogl_get_draw_framebuffer ();
+  ClutterActor *actor;
+  ClutterRect rect;
+  gfloat width, height;
+  gfloat screen_width, screen_height;
+  gint x_tiles, y_tiles;
+  guint opacity;
 
-  if (priv->is_dirty)
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  opacity = clutter_actor_get_paint_opacity (actor);
+
+  /* if we don't have a target size, fall back to the actor's
+   * allocation, though wrong it might be
+   */
+  if (clutter_offscreen_effect_get_target_rect (effect, &rect))
     {
-      ClutterRect rect;
-      gboolean mapped_buffer;
-      CoglVertexP3T2C4 *verts;
-      ClutterActor *actor;
-      gfloat width, height;
-      guint opacity;
-      gint i, j;
-
-      actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
-      opacity = clutter_actor_get_paint_opacity (actor);
-
-      /* if we don't have a target size, fall back to the actor's
-       * allocation, though wrong it might be
-       */
-      if (clutter_offscreen_effect_get_target_rect (effect, &rect))
-        {
-          width = clutter_rect_get_width (&rect);
-          height = clutter_rect_get_height (&rect);
-        }
-      else
-        clutter_actor_get_size (actor, &width, &height);
+      width = clutter_rect_get_width (&rect);
+      height = clutter_rect_get_height (&rect);
+    }
+  else
+    clutter_actor_get_size (actor, &width, &height);
 
-      /* XXX ideally, the sub-classes should tell us what they
-       * changed in the texture vertices; we then would be able to
-       * avoid resubmitting the same data, if it did not change. for
-       * the time being, we resubmit everything
-       */
-      verts = cogl_buffer_map (COGL_BUFFER (priv->buffer),
-                               COGL_BUFFER_ACCESS_WRITE,
-                               COGL_BUFFER_MAP_HINT_DISCARD);
+  funcs = get_shader_funcs (self);
 
-      /* If the map failed then we'll resort to allocating a temporary
-         buffer */
-      if (verts == NULL)
-        {
-          mapped_buffer = FALSE;
-          verts = g_malloc (sizeof (*verts) * priv->n_vertices);
-        }
-      else
-        mapped_buffer = TRUE;
+  /* tiles smaller than a few pixels on screen are not worth computing */
+  clutter_actor_get_transformed_size (actor, &screen_width, &screen_height);
+  x_tiles = get_mesh_tiles (MAX (priv->x_tiles >> priv->quality_shift, 1),
+                            screen_width);
+  y_tiles = get_mesh_tiles (MAX (priv->y_tiles >> priv->quality_shift, 1),
+                            screen_height);
+
+  if (priv->primitive == NULL ||
+      priv->mesh_x_tiles != x_tiles ||
+      priv->mesh_y_tiles != y_tiles ||
+      priv->mesh_uses_shader != (funcs != NULL))
+    clutter_deform_effect_init_arrays (self, x_tiles, y_tiles, funcs != NULL);
 
-      for (i = 0; i < priv->y_tiles + 1; i++)
+  if (priv->is_dirty)
+    {
+      /* the vertex shader only needs the undeformed mesh, which does not
+       * change with the parameters of the effect
+       */
+      if (funcs == NULL)
         {
-          for (j = 0; j < priv->x_tiles + 1; j++)
-            {
-              CoglVertexP3T2C4 *vertex_out;
-              CoglTextureVertex vertex;
-
-              /* CoglTextureVertex isn't an ideal structure to use for
-                 this because it contains a CoglColor. The internal
-                 layout of CoglColor is mean to be private so Clutter
-                 can not pass a pointer to it as a vertex
-                 attribute. Also it contains padding so we end up
-                 storing more data in the vertex buffer than we need
-                 to. Instead we let the application modify a dummy
-                 vertex and then copy the details back out to a more
-                 well-defined struct */
-
-              vertex.tx = (float) j / priv->x_tiles;
-              vertex.ty = (float) i / priv->y_tiles;
-
-              vertex.x = width * vertex.tx;
-              vertex.y = height * vertex.ty;
-              vertex.z = 0.0f;
-
-              cogl_color_init_from_4ub (&vertex.color, 255, 255, 255, opacity);
-
-              clutter_deform_effect_deform_vertex (self,
-                                                   width, height,
-                                                   &vertex);
-
-              vertex_out = verts + i * (priv->x_tiles + 1) + j;
-
-              vertex_out->x = vertex.x;
-              vertex_out->y = vertex.y;
-              vertex_out->z = vertex.z;
-              vertex_out->s = vertex.tx;
-              vertex_out->t = vertex.ty;
-              vertex_out->r = cogl_color_get_red_byte (&vertex.color);
-              vertex_out->g = cogl_color_get_green_byte (&vertex.color);
-              vertex_out->b = cogl_color_get_blue_byte (&vertex.color);
-              vertex_out->a = cogl_color_get_alpha_byte (&vertex.color);
-            }
+          /* XXX ideally, the sub-classes should tell us what they
+           * changed in the texture vertices; we then would be able to
+           * avoid resubmitting the same data, if it did not change. for
+           * the time being, we resubmit everything
+           */
+          clutter_deform_effect_update_vertices (self, width, height, opacity, TRUE);
         }
-
-      if (mapped_buffer)
-        cogl_buffer_unmap (COGL_BUFFER (priv->buffer));
-      else
+      else if (!priv->mesh_is_flat ||
+               priv->mesh_width != width ||
+               priv->mesh_height != height)
         {
-          cogl_buffer_set_data (COGL_BUFFER (priv->buffer),
-                                0, /* offset */
-                                verts,
-                                sizeof (*verts) * priv->n_vertices);
-          g_free (verts);
+          clutter_deform_effect_update_vertices (self, width, height, opacity, FALSE);
+
+          priv->mesh_width = width;
+          priv->mesh_height = height;
+          priv->mesh_is_flat = TRUE;
         }
 
       priv->is_dirty = FALSE;
@@ -281,6 +414,21 @@ clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
   material = clutter_offscreen_effect_get_target (effect);
   pipeline = COGL_PIPELINE (material);
 
+  if (funcs != NULL && pipeline != NULL)
+    {
+      if (priv->snippet_pipeline != pipeline)
+        {
+          g_clear_pointer (&priv->snippet_pipeline, cogl_object_unref);
+
+          cogl_pipeline_add_snippet (pipeline, funcs->get_snippet (self));
+          priv->snippet_pipeline = cogl_object_ref (pipeline);
+        }
+
+      clutter_deform_effect_setup_shader (self, funcs, pipeline,
+                                          width, height,
+                                          opacity);
+    }
+
   /* enable depth testing */
   cogl_depth_state_init (&depth_state);
   cogl_depth_state_set_test_enabled (&depth_state, TRUE);
@@ -307,6 +455,14 @@ clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
       cogl_pipeline_set_cull_face_mode (back_pipeline,
                                         COGL_PIPELINE_CULL_FACE_MODE_FRONT);
 
+      if (funcs != NULL)
+        {
+          cogl_pipeline_add_snippet (back_pipeline, funcs->get_snippet (self));
+          clutter_deform_effect_setup_shader (self, funcs, back_pipeline,
+                                              width, height,
+                                              opacity);
+        }
+
       cogl_framebuffer_draw_primitive (fb, back_pipeline, priv->primitive);
 
       cogl_object_unref (back_pipeline);
@@ -317,6 +473,13 @@ clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
       CoglContext *ctx =
         clutter_backend_get_cogl_context (clutter_get_default_backend ());
       CoglPipeline *lines_pipeline = cogl_pipeline_new (ctx);
+
+      if (funcs != NULL)
+        {
+          cogl_pipeline_add_snippet (lines_pipeline, funcs->get_snippet (self));
+          funcs->set_uniforms (self, lines_pipeline, width, height);
+        }
+
       cogl_pipeline_set_color4f (lines_pipeline, 1.0, 0, 0, 1.0);
       cogl_framebuffer_draw_primitive (fb, lines_pipeline,
                                        priv->lines_primitive);
@@ -349,7 +512,10 @@ clutter_deform_effect_free_arrays (ClutterDeformEffect *self)
 }
 
 static void
-clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
+clutter_deform_effect_init_arrays (ClutterDeformEffect *self,
+                                   gint                 x_tiles,
+                                   gint                 y_tiles,
+                                   gboolean             use_shader)
 {
   ClutterDeformEffectPrivate *priv = self->priv;
   gint x, y, direction, n_indices;
@@ -363,13 +529,18 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
 
   clutter_deform_effect_free_arrays (self);
 
-  n_indices = ((2 + 2 * priv->x_tiles)
-               * priv->y_tiles
-               + (priv->y_tiles - 1));
+  priv->mesh_x_tiles = x_tiles;
+  priv->mesh_y_tiles = y_tiles;
+  priv->mesh_uses_shader = use_shader;
+  priv->mesh_is_flat = FALSE;
+
+  n_indices = ((2 + 2 * priv->mesh_x_tiles)
+               * priv->mesh_y_tiles
+               + (priv->mesh_y_tiles - 1));
 
   static_indices = g_new (guint16, n_indices);
 
-#define MESH_INDEX(x,y) ((y) * (priv->x_tiles + 1) + (x))
+#define MESH_INDEX(x,y) ((y) * (priv->mesh_x_tiles + 1) + (x))
 
   /* compute all the triangles from the various tiles */
   direction = 1;
@@ -379,9 +550,9 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
   idx[1] = MESH_INDEX (0, 1);
   idx += 2;
 
-  for (y = 0; y < priv->y_tiles; y++)
+  for (y = 0; y < priv->mesh_y_tiles; y++)
     {
-      for (x = 0; x < priv->x_tiles; x++)
+      for (x = 0; x < priv->mesh_x_tiles; x++)
         {
           if (direction)
             {
@@ -390,21 +561,21 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
             }
           else
             {
-              idx[0] = MESH_INDEX (priv->x_tiles - x - 1, y);
-              idx[1] = MESH_INDEX (priv->x_tiles - x - 1, y + 1);
+              idx[0] = MESH_INDEX (priv->mesh_x_tiles - x - 1, y);
+              idx[1] = MESH_INDEX (priv->mesh_x_tiles - x - 1, y + 1);
             }
 
           idx += 2;
         }
 
-      if (y == (priv->y_tiles - 1))
+      if (y == (priv->mesh_y_tiles - 1))
         break;
 
       if (direction)
         {
-          idx[0] = MESH_INDEX (priv->x_tiles, y + 1);
-          idx[1] = MESH_INDEX (priv->x_tiles, y + 1);
-          idx[2] = MESH_INDEX (priv->x_tiles, y + 2);
+          idx[0] = MESH_INDEX (priv->mesh_x_tiles, y + 1);
+          idx[1] = MESH_INDEX (priv->mesh_x_tiles, y + 1);
+          idx[2] = MESH_INDEX (priv->mesh_x_tiles, y + 2);
         }
       else
         {
@@ -427,7 +598,7 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
 
   g_free (static_indices);
 
-  priv->n_vertices = (priv->x_tiles + 1) * (priv->y_tiles + 1);
+  priv->n_vertices = (priv->mesh_x_tiles + 1) * (priv->mesh_y_tiles + 1);
 
   priv->buffer =
     cogl_attribute_buffer_new (ctx,
@@ -436,9 +607,12 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
                                NULL);
 
   /* The application is expected to continuously modify the vertices
-     so we should give a hint to Cogl about that */
+     so we should give a hint to Cogl about that, unless they are
+     deformed in the vertex shader */
   cogl_buffer_set_update_hint (COGL_BUFFER (priv->buffer),
-                               COGL_BUFFER_UPDATE_HINT_DYNAMIC);
+                               use_shader
+                                 ? COGL_BUFFER_UPDATE_HINT_STATIC
+                                 : COGL_BUFFER_UPDATE_HINT_DYNAMIC);
 
   attributes[0] = cogl_attribute_new (priv->buffer,
                                       "cogl_position_in",
@@ -459,11 +633,14 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
                                       4, /* n_components */
                                       COGL_ATTRIBUTE_TYPE_UNSIGNED_BYTE);
 
+  /* the color of the vertices overrides the color of the pipeline,
+   * which holds the opacity when using the vertex shader
+   */
   priv->primitive =
     cogl_primitive_new_with_attributes (COGL_VERTICES_MODE_TRIANGLE_STRIP,
                                         priv->n_vertices,
                                         attributes,
-                                        3 /* n_attributes */);
+                                        use_shader ? 2 : 3);
   cogl_primitive_set_indices (priv->primitive,
                               indices,
                               n_indices);
@@ -508,6 +685,8 @@ clutter_deform_effect_finalize (GObject *gobject)
   clutter_deform_effect_free_arrays (self);
   clutter_deform_effect_free_back_pipeline (self);
 
+  g_clear_pointer (&self->priv->snippet_pipeline, cogl_object_unref);
+
   G_OBJECT_CLASS (clutter_deform_effect_parent_class)->finalize (gobject);
 }
 
@@ -575,9 +754,13 @@ clutter_deform_effect_class_init (ClutterDeformEffectClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   ClutterActorMetaClass *meta_class = CLUTTER_ACTOR_META_CLASS (klass);
   ClutterOffscreenEffectClass *offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
+  ClutterEffectClass *effect_class = CLUTTER_EFFECT_CLASS (klass);
 
   klass->deform_vertex = clutter_deform_effect_real_deform_vertex;
 
+  quark_shader_funcs =
+    g_quark_from_static_string ("clutter-deform-effect-shader-funcs");
+
   /**
    * ClutterDeformEffect:x-tiles:
    *
@@ -637,6 +820,33 @@ clutter_deform_effect_class_init (ClutterDeformEffectClass *klass)
   meta_class->set_actor = clutter_deform_effect_set_actor;
 
   offscreen_class->paint_target = clutter_deform_effect_paint_target;
+
+  effect_class->set_quality = clutter_deform_effect_set_quality;
+}
+
+static void
+clutter_deform_effect_set_quality (ClutterEffect       *effect,
+                                   ClutterQualityLevel  level)
+{
+  ClutterDeformEffectPrivate *priv = CLUTTER_DEFORM_EFFECT (effect)->priv;
+
+  CLUTTER_EFFECT_CLASS (clutter_deform_effect_parent_class)->set_quality (effect, level);
+
+  switch (level)
+    {
+    case CLUTTER_QUALITY_FULL:
+      priv->quality_shift = 0;
+      break;
+
+    case CLUTTER_QUALITY_REDUCED:
+    case CLUTTER_QUALITY_LOW:
+      priv->quality_shift = 1;
+      break;
+
+    case CLUTTER_QUALITY_MINIMAL:
+      priv->quality_shift = 2;
+      break;
+    }
 }
 
 static void
@@ -646,7 +856,8 @@ clutter_deform_effect_init (ClutterDeformEffect *self)
   self->priv->x_tiles = self->priv->y_tiles = DEFAULT_N_TILES;
   self->priv->back_pipeline = NULL;
 
-  clutter_deform_effect_init_arrays (self);
+  /* the mesh is built when painting, for the size of the actor */
+  self->priv->is_dirty = TRUE;
 }
 
 /**
@@ -750,11 +961,9 @@ clutter_deform_effect_set_n_tiles (ClutterDeformEffect *effect,
       tiles_changed = TRUE;
     }
 
+  /* the mesh is built again when painting */
   if (tiles_changed)
-    {
-      clutter_deform_effect_init_arrays (effect);
-      clutter_deform_effect_invalidate (effect);
-    }
+    clutter_deform_effect_invalidate (effect);
 
   g_object_thaw_notify (G_OBJECT (effect));
 }
@@ -811,3 +1020,25 @@ clutter_deform_effect_invalidate (ClutterDeformEffect *effect)
   if (actor != NULL)
     clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
 }
+
+/*< private >
+ * _clutter_deform_effect_class_set_shader:
+ * @klass: the class of a deform effect
+ * @funcs: (transfer none): the functions used to deform the vertices
+ *   in a vertex shader
+ *
+ * Declares that the effects of the type of @klass can deform their
+ * vertices in a vertex shader, when GLSL is available. The sub-classes
+ * of the type use the ClutterDeformEffectClass.deform_vertex() virtual
+ * function, unless they declare their own shader functions as well.
+ */
+void
+_clutter_deform_effect_class_set_shader (ClutterDeformEffectClass             *klass,
+                                         const ClutterDeformEffectShaderFuncs *funcs)
+{
+  g_return_if_fail (CLUTTER_IS_DEFORM_EFFECT_CLASS (klass));
+  g_return_if_fail (funcs != NULL);
+
+  g_type_set_qdata (G_TYPE_FROM_CLASS (klass), quark_shader_funcs,
+                    (gpointer) funcs);
+}
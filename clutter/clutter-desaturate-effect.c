@@ -54,6 +54,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterDesaturateEffect
@@ -76,6 +77,11 @@ struct _ClutterDesaturateEffectClass
   ClutterOffscreenEffectClass parent_class;
 
   CoglPipeline *base_pipeline;
+
+  /* the snippet of the base pipeline, also used when the effect is
+   * fused with other pointwise effects
+   */
+  CoglSnippet *snippet;
 };
 
 /* the magic gray vec3 has been taken from the NTSC conversion weights
@@ -237,14 +243,34 @@ clutter_desaturate_effect_get_property (GObject    *gobject,
 }
 
 static void
-update_factor_uniform (ClutterDesaturateEffect *self)
+update_factor_uniform (ClutterDesaturateEffect *self,
+                       CoglPipeline            *pipeline)
 {
   if (self->factor_uniform > -1)
-    cogl_pipeline_set_uniform_1f (self->pipeline,
+    cogl_pipeline_set_uniform_1f (pipeline,
                                   self->factor_uniform,
                                   self->factor);
 }
 
+static CoglSnippet *
+clutter_desaturate_effect_get_snippet (ClutterOffscreenEffect *effect)
+{
+  return CLUTTER_DESATURATE_EFFECT_GET_CLASS (effect)->snippet;
+}
+
+static void
+clutter_desaturate_effect_set_uniforms (ClutterOffscreenEffect *effect,
+                                        CoglPipeline           *pipeline)
+{
+  update_factor_uniform (CLUTTER_DESATURATE_EFFECT (effect), pipeline);
+}
+
+static const ClutterPointwiseEffectFuncs pointwise_funcs = {
+  clutter_desaturate_effect_get_snippet,
+  clutter_desaturate_effect_set_uniforms,
+  NULL
+};
+
 static void
 clutter_desaturate_effect_class_init (ClutterDesaturateEffectClass *klass)
 {
@@ -255,6 +281,9 @@ clutter_desaturate_effect_class_init (ClutterDesaturateEffectClass *klass)
   offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
   offscreen_class->paint_target = clutter_desaturate_effect_paint_target;
 
+  _clutter_offscreen_effect_class_set_pointwise (offscreen_class,
+                                                 &pointwise_funcs);
+
   effect_class->pre_paint = clutter_desaturate_effect_pre_paint;
 
   /**
@@ -297,7 +326,7 @@ clutter_desaturate_effect_init (ClutterDesaturateEffect *self)
                                   desaturate_glsl_declarations,
                                   desaturate_glsl_source);
       cogl_pipeline_add_snippet (klass->base_pipeline, snippet);
-      cogl_object_unref (snippet);
+      klass->snippet = snippet;
 
       cogl_pipeline_set_layer_null_texture (klass->base_pipeline,
                                             0, /* layer number */
@@ -311,7 +340,7 @@ clutter_desaturate_effect_init (ClutterDesaturateEffect *self)
 
   self->factor = 1.0;
 
-  update_factor_uniform (self);
+  update_factor_uniform (self, self->pipeline);
 }
 
 /**
@@ -355,7 +384,7 @@ clutter_desaturate_effect_set_factor (ClutterDesaturateEffect *effect,
   if (fabsf (effect->factor - factor) >= 0.00001)
     {
       effect->factor = factor;
-      update_factor_uniform (effect);
+      update_factor_uniform (effect, effect->pipeline);
 
       clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
 
@@ -60,6 +60,9 @@ typedef struct _ClutterScrollInfo
   guint last_value_valid : 1;
 } ClutterScrollInfo;
 
+/* the number of touch points tracked without a hash table lookup */
+#define CLUTTER_INPUT_DEVICE_N_TOUCH_SLOTS      16
+
 typedef struct _ClutterTouchInfo
 {
   ClutterEventSequence *sequence;
@@ -112,8 +115,15 @@ struct _ClutterInputDevice
   gint current_button_number;
   ClutterModifierType current_state;
 
-  /* the current touch points states */
+  /* the current touch points states; the sequences numbered from 1
+   * to CLUTTER_INPUT_DEVICE_N_TOUCH_SLOTS, like the ones of the
+   * backends using the hardware slot of the touch point, are stored
+   * in a slot table, and the other ones in a hash table created on
+   * demand. The free slots have a %NULL sequence
+   */
+  ClutterTouchInfo touch_slots[CLUTTER_INPUT_DEVICE_N_TOUCH_SLOTS];
   GHashTable *touch_sequences_info;
+  guint n_touches;
 
   /* the previous state, used for click count generation */
   gint previous_x;
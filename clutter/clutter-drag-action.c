@@ -107,6 +107,7 @@ struct _ClutterDragActionPrivate
   guint in_drag               : 1;
   guint motion_events_enabled : 1;
   guint drag_area_set         : 1;
+  guint use_prediction        : 1;
 };
 
 enum
@@ -119,6 +120,7 @@ enum
   PROP_DRAG_AXIS,
   PROP_DRAG_AREA,
   PROP_DRAG_AREA_SET,
+  PROP_USE_PREDICTION,
 
   PROP_LAST
 };
@@ -213,7 +215,13 @@ emit_drag_motion (ClutterDragAction *action,
   gfloat motion_x, motion_y;
   gboolean can_emit_drag_motion = TRUE;
 
-  clutter_event_get_coords (event, &priv->last_motion_x, &priv->last_motion_y);
+  if (priv->use_prediction)
+    clutter_event_get_predicted_coords (event,
+                                        &priv->last_motion_x,
+                                        &priv->last_motion_y);
+  else
+    clutter_event_get_coords (event, &priv->last_motion_x, &priv->last_motion_y);
+
   priv->last_motion_state = clutter_event_get_state (event);
   priv->last_motion_device = clutter_event_get_device (event);
 
@@ -589,6 +597,10 @@ clutter_drag_action_set_property (GObject      *gobject,
       clutter_drag_action_set_drag_area (action, g_value_get_boxed (value));
       break;
 
+    case PROP_USE_PREDICTION:
+      clutter_drag_action_set_use_prediction (action, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -638,6 +650,10 @@ clutter_drag_action_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->drag_area_set);
       break;
 
+    case PROP_USE_PREDICTION:
+      g_value_set_boolean (value, priv->use_prediction);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -831,6 +847,24 @@ clutter_drag_action_class_init (ClutterDragActionClass *klass)
 			  FALSE,
 			  CLUTTER_PARAM_READABLE);
 
+  /**
+   * ClutterDragAction:use-prediction:
+   *
+   * Whether the dragging should follow the position predicted for the
+   * time the frame is presented, instead of the position reported by
+   * the input device.
+   *
+   * See clutter_event_get_predicted_coords().
+   *
+   * Since: 1.26
+   */
+  drag_props[PROP_USE_PREDICTION] =
+    g_param_spec_boolean ("use-prediction",
+                          P_("Use Prediction"),
+                          P_("Whether to drag using the predicted position of the pointer"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
 
   gobject_class->set_property = clutter_drag_action_set_property;
   gobject_class->get_property = clutter_drag_action_get_property;
@@ -1321,3 +1355,55 @@ clutter_drag_action_set_drag_area (ClutterDragAction *action,
   g_object_notify_by_pspec (G_OBJECT (action), drag_props[PROP_DRAG_AREA_SET]);
   g_object_notify_by_pspec (G_OBJECT (action), drag_props[PROP_DRAG_AREA]);
 }
+
+/**
+ * clutter_drag_action_set_use_prediction:
+ * @action: a #ClutterDragAction
+ * @use_prediction: whether to use the predicted pointer positions
+ *
+ * Sets whether @action should move the dragged actor to the position
+ * that the pointer is predicted to have when the frame is presented,
+ * which reduces the perceived latency of the dragging.
+ *
+ * The #ClutterDragAction::drag-end signal always uses the position
+ * of the release event.
+ *
+ * Since: 1.26
+ */
+void
+clutter_drag_action_set_use_prediction (ClutterDragAction *action,
+                                        gboolean           use_prediction)
+{
+  ClutterDragActionPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_DRAG_ACTION (action));
+
+  priv = action->priv;
+
+  use_prediction = !!use_prediction;
+
+  if (priv->use_prediction == use_prediction)
+    return;
+
+  priv->use_prediction = use_prediction;
+
+  g_object_notify_by_pspec (G_OBJECT (action), drag_props[PROP_USE_PREDICTION]);
+}
+
+/**
+ * clutter_drag_action_get_use_prediction:
+ * @action: a #ClutterDragAction
+ *
+ * Retrieves the value set by clutter_drag_action_set_use_prediction().
+ *
+ * Return value: %TRUE if @action uses the predicted pointer positions
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_drag_action_get_use_prediction (ClutterDragAction *action)
+{
+  g_return_val_if_fail (CLUTTER_IS_DRAG_ACTION (action), FALSE);
+
+  return action->priv->use_prediction;
+}
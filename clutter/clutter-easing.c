@@ -553,3 +553,187 @@ clutter_easing_for_mode (ClutterAnimationMode mode,
 
   return _clutter_animation_modes[mode].func (t, d);
 }
+
+/* the control points of the named cubic-bezier() modes */
+gboolean
+clutter_easing_get_cubic_bezier_points (ClutterAnimationMode  mode,
+                                        double               *x_1,
+                                        double               *y_1,
+                                        double               *x_2,
+                                        double               *y_2)
+{
+  switch (mode)
+    {
+    case CLUTTER_EASE:
+      *x_1 = 0.25; *y_1 = 0.1; *x_2 = 0.25; *y_2 = 1.0;
+      return TRUE;
+
+    case CLUTTER_EASE_IN:
+      *x_1 = 0.42; *y_1 = 0.0; *x_2 = 1.0; *y_2 = 1.0;
+      return TRUE;
+
+    case CLUTTER_EASE_OUT:
+      *x_1 = 0.0; *y_1 = 0.0; *x_2 = 0.58; *y_2 = 1.0;
+      return TRUE;
+
+    case CLUTTER_EASE_IN_OUT:
+      *x_1 = 0.42; *y_1 = 0.0; *x_2 = 0.58; *y_2 = 1.0;
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/* the number of intervals of an easing table; linearly interpolating
+ * between 256 samples keeps the error under 0.003 for all the tabulated
+ * modes, the worst case being the corners of the bounce modes, which is
+ * less than a step of an 8 bit opacity
+ */
+#define EASING_TABLE_SIZE       256
+
+struct _ClutterEasingTable
+{
+  double values[EASING_TABLE_SIZE + 1];
+};
+
+/* the modes that are worth tabulating; the polynomial ones are cheaper
+ * to compute than to look up, and the steps are not continuous
+ */
+static inline gboolean
+easing_mode_has_table (ClutterAnimationMode mode)
+{
+  switch (mode)
+    {
+    case CLUTTER_EASE_IN_SINE:
+    case CLUTTER_EASE_OUT_SINE:
+    case CLUTTER_EASE_IN_OUT_SINE:
+    case CLUTTER_EASE_IN_EXPO:
+    case CLUTTER_EASE_OUT_EXPO:
+    case CLUTTER_EASE_IN_OUT_EXPO:
+    case CLUTTER_EASE_IN_ELASTIC:
+    case CLUTTER_EASE_OUT_ELASTIC:
+    case CLUTTER_EASE_IN_OUT_ELASTIC:
+    case CLUTTER_EASE_IN_BOUNCE:
+    case CLUTTER_EASE_OUT_BOUNCE:
+    case CLUTTER_EASE_IN_OUT_BOUNCE:
+    case CLUTTER_EASE:
+    case CLUTTER_EASE_IN:
+    case CLUTTER_EASE_OUT:
+    case CLUTTER_EASE_IN_OUT:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+static ClutterEasingTable *easing_tables[CLUTTER_ANIMATION_LAST] = { NULL, };
+
+/*< private >
+ * clutter_easing_table_for_mode:
+ * @mode: an animation mode
+ *
+ * Retrieves the shared easing table for @mode, computing it the first
+ * time it is needed.
+ *
+ * Return value: an easing table, or %NULL if @mode is not tabulated
+ */
+const ClutterEasingTable *
+clutter_easing_table_for_mode (ClutterAnimationMode mode)
+{
+  if (mode >= CLUTTER_ANIMATION_LAST || !easing_mode_has_table (mode))
+    return NULL;
+
+  if (g_once_init_enter (&easing_tables[mode]))
+    {
+      ClutterEasingTable *table;
+      double x_1, y_1, x_2, y_2;
+
+      if (clutter_easing_get_cubic_bezier_points (mode, &x_1, &y_1, &x_2, &y_2))
+        table = clutter_easing_table_new_cubic_bezier (x_1, y_1, x_2, y_2);
+      else
+        {
+          ClutterEasingFunc func = clutter_get_easing_func_for_mode (mode);
+          int i;
+
+          table = g_slice_new (ClutterEasingTable);
+
+          for (i = 0; i <= EASING_TABLE_SIZE; i++)
+            table->values[i] = func (i, EASING_TABLE_SIZE);
+        }
+
+      g_once_init_leave (&easing_tables[mode], table);
+    }
+
+  return easing_tables[mode];
+}
+
+/*< private >
+ * clutter_easing_table_new_cubic_bezier:
+ * @x_1: the X coordinate of the first control point
+ * @y_1: the Y coordinate of the first control point
+ * @x_2: the X coordinate of the second control point
+ * @y_2: the Y coordinate of the second control point
+ *
+ * Creates an easing table for the cubic bezier with the given control
+ * points, solving the curve once for each sample.
+ *
+ * Return value: (transfer full): a new easing table; use
+ *   clutter_easing_table_free() when done
+ */
+ClutterEasingTable *
+clutter_easing_table_new_cubic_bezier (double x_1,
+                                       double y_1,
+                                       double x_2,
+                                       double y_2)
+{
+  ClutterEasingTable *table = g_slice_new (ClutterEasingTable);
+  int i;
+
+  for (i = 0; i <= EASING_TABLE_SIZE; i++)
+    table->values[i] = clutter_ease_cubic_bezier (i, EASING_TABLE_SIZE,
+                                                  x_1, y_1,
+                                                  x_2, y_2);
+
+  return table;
+}
+
+void
+clutter_easing_table_free (ClutterEasingTable *table)
+{
+  if (table != NULL)
+    g_slice_free (ClutterEasingTable, table);
+}
+
+/*< private >
+ * clutter_easing_table_lookup:
+ * @table: an easing table
+ * @t: elapsed time
+ * @d: total duration
+ *
+ * Computes the value of the easing function tabulated in @table by
+ * linearly interpolating the two closest samples.
+ *
+ * Return value: the interpolated value
+ */
+double
+clutter_easing_table_lookup (const ClutterEasingTable *table,
+                             double                    t,
+                             double                    d)
+{
+  double p = t / d * EASING_TABLE_SIZE;
+  int i;
+
+  /* this also catches the NaN of a zero duration */
+  if (!(p > 0.0))
+    return table->values[0];
+
+  if (p >= EASING_TABLE_SIZE)
+    return table->values[EASING_TABLE_SIZE];
+
+  i = (int) p;
+  p -= i;
+
+  return table->values[i] + p * (table->values[i + 1] - table->values[i]);
+}
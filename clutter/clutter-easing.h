@@ -16,6 +16,14 @@ G_BEGIN_DECLS
  */
 typedef double (* ClutterEasingFunc) (double t, double d);
 
+/*< private >
+ * ClutterEasingTable:
+ *
+ * A table of precomputed values of an easing function, sampled at
+ * regular intervals of the progress.
+ */
+typedef struct _ClutterEasingTable      ClutterEasingTable;
+
 G_GNUC_INTERNAL
 ClutterEasingFunc       clutter_get_easing_func_for_mode        (ClutterAnimationMode mode);
 
@@ -137,6 +145,27 @@ double  clutter_ease_cubic_bezier       (double t,
                                          double x_2,
                                          double y_2);
 
+G_GNUC_INTERNAL
+gboolean                        clutter_easing_get_cubic_bezier_points  (ClutterAnimationMode      mode,
+                                                                         double                   *x_1,
+                                                                         double                   *y_1,
+                                                                         double                   *x_2,
+                                                                         double                   *y_2);
+
+G_GNUC_INTERNAL
+const ClutterEasingTable *      clutter_easing_table_for_mode           (ClutterAnimationMode      mode);
+G_GNUC_INTERNAL
+ClutterEasingTable *            clutter_easing_table_new_cubic_bezier   (double                    x_1,
+                                                                         double                    y_1,
+                                                                         double                    x_2,
+                                                                         double                    y_2);
+G_GNUC_INTERNAL
+void                            clutter_easing_table_free               (ClutterEasingTable       *table);
+G_GNUC_INTERNAL
+double                          clutter_easing_table_lookup             (const ClutterEasingTable *table,
+                                                                         double                    t,
+                                                                         double                    d);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EASING_H__ */
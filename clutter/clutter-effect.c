@@ -173,11 +173,15 @@
 #include "clutter-marshal.h"
 #include "clutter-private.h"
 #include "clutter-actor-private.h"
+#include "clutter-stage-private.h"
+#include "clutter-trace.h"
 
 G_DEFINE_ABSTRACT_TYPE (ClutterEffect,
                         clutter_effect,
                         CLUTTER_TYPE_ACTOR_META);
 
+static GQuark quark_quality_level = 0;
+
 static gboolean
 clutter_effect_real_pre_paint (ClutterEffect *effect)
 {
@@ -250,6 +254,8 @@ clutter_effect_class_init (ClutterEffectClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
+  quark_quality_level = g_quark_from_static_string ("-clutter-effect-quality-level");
+
   gobject_class->notify = clutter_effect_notify;
 
   klass->pre_paint = clutter_effect_real_pre_paint;
@@ -280,13 +286,57 @@ _clutter_effect_post_paint (ClutterEffect *effect)
   CLUTTER_EFFECT_GET_CLASS (effect)->post_paint (effect);
 }
 
+/* calls the set_quality() virtual function if the quality level of the
+ * stage changed since the effect was last painted
+ */
+static void
+clutter_effect_update_quality (ClutterEffect *effect)
+{
+  ClutterEffectClass *klass = CLUTTER_EFFECT_GET_CLASS (effect);
+  ClutterQualityLevel level = CLUTTER_QUALITY_FULL;
+  ClutterActor *actor, *stage;
+  guint old_level;
+
+  if (klass->set_quality == NULL)
+    return;
+
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  stage = actor != NULL ? _clutter_actor_get_stage_internal (actor) : NULL;
+  if (stage != NULL)
+    level = _clutter_stage_get_quality_level (CLUTTER_STAGE (stage));
+
+  /* the level is stored plus one, so that effects start at full
+   * quality without being told
+   */
+  old_level = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (effect),
+                                                    quark_quality_level));
+  if (old_level == 0)
+    old_level = CLUTTER_QUALITY_FULL + 1;
+
+  if (old_level == level + 1)
+    return;
+
+  g_object_set_qdata (G_OBJECT (effect), quark_quality_level,
+                      GUINT_TO_POINTER (level + 1));
+
+  CLUTTER_NOTE (PAINT, "Setting the quality of the effect '%s' to %d",
+                _clutter_actor_meta_get_debug_name (CLUTTER_ACTOR_META (effect)),
+                level);
+
+  klass->set_quality (effect, level);
+}
+
 void
 _clutter_effect_paint (ClutterEffect           *effect,
                        ClutterEffectPaintFlags  flags)
 {
   g_return_if_fail (CLUTTER_IS_EFFECT (effect));
 
+  clutter_effect_update_quality (effect);
+
+  CLUTTER_TRACE_BEGIN (EFFECTS, G_OBJECT_TYPE_NAME (effect));
   CLUTTER_EFFECT_GET_CLASS (effect)->paint (effect, flags);
+  CLUTTER_TRACE_END (EFFECTS);
 }
 
 void
@@ -298,6 +348,14 @@ _clutter_effect_pick (ClutterEffect           *effect,
   CLUTTER_EFFECT_GET_CLASS (effect)->pick (effect, flags);
 }
 
+gboolean
+_clutter_effect_has_custom_pick (ClutterEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_EFFECT (effect), FALSE);
+
+  return CLUTTER_EFFECT_GET_CLASS (effect)->pick != clutter_effect_real_pick;
+}
+
 gboolean
 _clutter_effect_get_paint_volume (ClutterEffect      *effect,
                                   ClutterPaintVolume *volume)
@@ -63,6 +63,10 @@ struct _ClutterEffect
  * @get_paint_volume: virtual function
  * @paint: virtual function
  * @pick: virtual function
+ * @set_quality: virtual function; called before painting the effect
+ *   when the quality level of the stage changed, so that the effect
+ *   can trade its quality for a cheaper rendering. Effects start at
+ *   %CLUTTER_QUALITY_FULL. Available since: 1.26
  *
  * The #ClutterEffectClass structure contains only private data
  *
@@ -85,8 +89,10 @@ struct _ClutterEffectClass
   void     (* pick)             (ClutterEffect           *effect,
                                  ClutterEffectPaintFlags  flags);
 
+  void     (* set_quality)      (ClutterEffect           *effect,
+                                 ClutterQualityLevel      level);
+
   /*< private >*/
-  void (* _clutter_effect4) (void);
   void (* _clutter_effect5) (void);
   void (* _clutter_effect6) (void);
 };
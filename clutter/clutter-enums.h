@@ -276,6 +276,9 @@ typedef enum {
  * ClutterFontFlags:
  * @CLUTTER_FONT_MIPMAPPING: Set to use mipmaps for the glyph cache textures.
  * @CLUTTER_FONT_HINTING: Set to enable hinting on the glyphs.
+ * @CLUTTER_FONT_DISTANCE_FIELD: Set to draw the text using distance
+ *   field glyphs, which stay sharp when scaled; this flag is available
+ *   since 1.26
  *
  * Runtime flags to change the font quality. To be used with
  * clutter_set_font_flags().
@@ -286,7 +289,8 @@ typedef enum {
  */
 typedef enum { /*< prefix=CLUTTER_FONT >*/
   CLUTTER_FONT_MIPMAPPING = (1 << 0),
-  CLUTTER_FONT_HINTING    = (1 << 1)
+  CLUTTER_FONT_HINTING    = (1 << 1),
+  CLUTTER_FONT_DISTANCE_FIELD = (1 << 2)
 } ClutterFontFlags;
 
 /**
@@ -426,6 +430,10 @@ typedef enum { /*< prefix=CLUTTER_ACTOR >*/
  *   virtual returns %TRUE. This is the default.
  * @CLUTTER_OFFSCREEN_REDIRECT_ALWAYS: Always redirect the actor to an
  *   offscreen buffer even if it is fully opaque.
+ * @CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC: Redirect the actor
+ *   once it has been painted a few times without any change to its
+ *   contents, and keep the image until the actor or its children
+ *   change (available since 1.26)
  *
  * Possible flags to pass to clutter_actor_set_offscreen_redirect().
  *
@@ -433,7 +441,8 @@ typedef enum { /*< prefix=CLUTTER_ACTOR >*/
  */
 typedef enum { /*< prefix=CLUTTER_OFFSCREEN_REDIRECT >*/
   CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_OPACITY = 1<<0,
-  CLUTTER_OFFSCREEN_REDIRECT_ALWAYS = 1<<1
+  CLUTTER_OFFSCREEN_REDIRECT_ALWAYS = 1<<1,
+  CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC = 1<<2
 } ClutterOffscreenRedirect;
 
 /**
@@ -1445,6 +1454,85 @@ typedef enum {
   CLUTTER_TOUCHPAD_GESTURE_PHASE_CANCEL
 } ClutterTouchpadGesturePhase;
 
+/**
+ * ClutterTrimMemoryFlags:
+ * @CLUTTER_TRIM_MEMORY_NONE: Do not release anything
+ * @CLUTTER_TRIM_MEMORY_OFFSCREEN_TARGETS: Release the offscreen buffers
+ *   of the effects, and the render targets that are not in use
+ * @CLUTTER_TRIM_MEMORY_GLYPH_CACHES: Release the caches of glyphs and
+ *   of text layouts
+ * @CLUTTER_TRIM_MEMORY_IMAGE_CACHE: Release the decoded images kept in
+ *   the image cache which are not used by any #ClutterImage
+ * @CLUTTER_TRIM_MEMORY_CANVAS_TEXTURES: Release the textures of the
+ *   #ClutterCanvas contents, keeping their drawing
+ * @CLUTTER_TRIM_MEMORY_IMAGE_TEXTURES: Release the textures of the
+ *   #ClutterImage contents loaded using clutter_image_load_from_uri_async()
+ * @CLUTTER_TRIM_MEMORY_ALL: Release everything that can be released
+ *
+ * Flags to pass to clutter_trim_memory(), describing the resources
+ * to release; all of them are created again the next time they are
+ * needed.
+ *
+ * Since: 1.26
+ */
+typedef enum { /*< prefix=CLUTTER_TRIM_MEMORY >*/
+  CLUTTER_TRIM_MEMORY_NONE = 0,
+  CLUTTER_TRIM_MEMORY_OFFSCREEN_TARGETS = 1 << 0,
+  CLUTTER_TRIM_MEMORY_GLYPH_CACHES = 1 << 1,
+  CLUTTER_TRIM_MEMORY_IMAGE_CACHE = 1 << 2,
+  CLUTTER_TRIM_MEMORY_CANVAS_TEXTURES = 1 << 3,
+  CLUTTER_TRIM_MEMORY_IMAGE_TEXTURES = 1 << 4,
+
+  CLUTTER_TRIM_MEMORY_ALL = 0x1f
+} ClutterTrimMemoryFlags;
+
+/**
+ * ClutterQualityLevel:
+ * @CLUTTER_QUALITY_FULL: Paint at full quality
+ * @CLUTTER_QUALITY_REDUCED: Reduce the cost of the expensive effects,
+ *   for instance by painting offscreen at a lower resolution
+ * @CLUTTER_QUALITY_LOW: Skip the optional work, like blurring, and
+ *   sample the textures without filtering
+ * @CLUTTER_QUALITY_MINIMAL: Paint as cheaply as possible
+ *
+ * The quality of the rendering of a #ClutterStage, lowered when the
+ * frames go over their budget; see clutter_stage_set_adaptive_quality()
+ * and #ClutterEffectClass.set_quality().
+ *
+ * Since: 1.26
+ */
+typedef enum {
+  CLUTTER_QUALITY_FULL,
+  CLUTTER_QUALITY_REDUCED,
+  CLUTTER_QUALITY_LOW,
+  CLUTTER_QUALITY_MINIMAL
+} ClutterQualityLevel;
+
+/**
+ * ClutterPresentationFlags:
+ * @CLUTTER_PRESENTATION_NONE: Nothing is known about the presentation
+ * @CLUTTER_PRESENTATION_VSYNC: The frame was presented in sync with the
+ *   vertical retrace of the display, without tearing
+ * @CLUTTER_PRESENTATION_HW_CLOCK: The presentation time comes from the
+ *   clock of the display hardware
+ * @CLUTTER_PRESENTATION_HW_COMPLETION: The completion of the presentation
+ *   was signalled by the display hardware
+ * @CLUTTER_PRESENTATION_ZERO_COPY: The frame was scanned out directly,
+ *   without being copied by the compositor
+ *
+ * How a frame was presented on screen, as reported by the windowing
+ * system; see #ClutterFrameInfo.
+ *
+ * Since: 1.26
+ */
+typedef enum { /*< prefix=CLUTTER_PRESENTATION >*/
+  CLUTTER_PRESENTATION_NONE = 0,
+  CLUTTER_PRESENTATION_VSYNC = 1 << 0,
+  CLUTTER_PRESENTATION_HW_CLOCK = 1 << 1,
+  CLUTTER_PRESENTATION_HW_COMPLETION = 1 << 2,
+  CLUTTER_PRESENTATION_ZERO_COPY = 1 << 3
+} ClutterPresentationFlags;
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ENUMS_H__ */
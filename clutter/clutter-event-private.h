@@ -10,6 +10,9 @@ void            _clutter_event_set_pointer_emulated     (ClutterEvent       *eve
 
 /* Reinjecting queued events for processing */
 void            _clutter_process_event                  (ClutterEvent       *event);
+void            _clutter_pick_queued_touch_events       (ClutterStage       *stage,
+                                                         ClutterEvent      **events,
+                                                         guint               n_events);
 
 gboolean        _clutter_event_process_filters          (ClutterEvent       *event);
 
@@ -31,6 +34,16 @@ void            _clutter_event_set_state_full           (ClutterEvent        *ev
 void            _clutter_event_push                     (const ClutterEvent *event,
                                                          gboolean            do_copy);
 
+void            _clutter_event_add_history_sample       (ClutterEvent       *event,
+                                                         guint32             time_,
+                                                         gfloat              x,
+                                                         gfloat              y);
+void            _clutter_event_coalesce                 (ClutterEvent       *event,
+                                                         const ClutterEvent *previous);
+void            _clutter_event_set_predicted_coords     (ClutterEvent       *event,
+                                                         gfloat              x,
+                                                         gfloat              y);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EVENT_PRIVATE_H__ */
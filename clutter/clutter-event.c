@@ -30,10 +30,12 @@
 #include "clutter-backend-private.h"
 #include "clutter-debug.h"
 #include "clutter-event-private.h"
+#include "clutter-input-recorder.h"
 #include "clutter-keysyms.h"
 #include "clutter-private.h"
 
 #include <math.h>
+#include <string.h>
 
 /**
  * SECTION:clutter-event
@@ -48,6 +50,9 @@
 typedef struct _ClutterEventPrivate {
   ClutterEvent base;
 
+  /* points to the event itself while it is allocated */
+  gpointer self;
+
   ClutterInputDevice *device;
   ClutterInputDevice *source_device;
 
@@ -61,9 +66,33 @@ typedef struct _ClutterEventPrivate {
   ClutterModifierType latched_state;
   ClutterModifierType locked_state;
 
+  /* the samples coalesced into a motion or touch update event,
+   * as ClutterEventSample, oldest first
+   */
+  GArray *history;
+
+  /* the position extrapolated at the next presentation time */
+  gfloat predicted_x;
+  gfloat predicted_y;
+
+  /* the time the input device reported the event, in microseconds */
+  gint64 hardware_time;
+
   guint is_pointer_emulated : 1;
+  guint has_prediction : 1;
 } ClutterEventPrivate;
 
+/* the maximum number of samples kept inside an event */
+#define MAX_HISTORY_SAMPLES     128
+
+/* set inside the flags of the events allocated by clutter_event_new();
+ * it is never returned by clutter_event_get_flags()
+ */
+#define CLUTTER_EVENT_FLAG_ALLOCATED    (1 << 30)
+
+/* the freed events kept for the next clutter_event_new() */
+#define MAX_FREE_EVENTS         128
+
 typedef struct _ClutterEventFilter {
   int id;
 
@@ -73,7 +102,9 @@ typedef struct _ClutterEventFilter {
   gpointer user_data;
 } ClutterEventFilter;
 
-static GHashTable *all_events = NULL;
+/* like the rest of the event API, only used from the main thread */
+static GTrashStack *free_events = NULL;
+static guint n_free_events = 0;
 
 G_DEFINE_BOXED_TYPE (ClutterEvent, clutter_event,
                      clutter_event_copy,
@@ -96,13 +127,17 @@ G_DEFINE_BOXED_TYPE (ClutterEventSequence, clutter_event_sequence,
                      clutter_event_sequence_copy,
                      clutter_event_sequence_free);
 
-static gboolean
+/* the flag is enough to tell apart the events on the stack, or inside
+ * other structures, without touching the memory past them; checking
+ * the pointer as well catches the allocated events copied by value
+ */
+static inline gboolean
 is_event_allocated (const ClutterEvent *event)
 {
-  if (all_events == NULL)
+  if ((event->any.flags & CLUTTER_EVENT_FLAG_ALLOCATED) == 0)
     return FALSE;
 
-  return g_hash_table_lookup (all_events, event) != NULL;
+  return ((const ClutterEventPrivate *) event)->self == event;
 }
 
 /*
@@ -615,7 +650,7 @@ clutter_event_get_flags (const ClutterEvent *event)
 {
   g_return_val_if_fail (event != NULL, CLUTTER_EVENT_NONE);
 
-  return event->any.flags;
+  return event->any.flags & ~CLUTTER_EVENT_FLAG_ALLOCATED;
 }
 
 /**
@@ -633,10 +668,13 @@ clutter_event_set_flags (ClutterEvent      *event,
 {
   g_return_if_fail (event != NULL);
 
-  if (event->any.flags == flags)
+  flags &= ~CLUTTER_EVENT_FLAG_ALLOCATED;
+
+  if ((event->any.flags & ~CLUTTER_EVENT_FLAG_ALLOCATED) == flags)
     return;
 
-  event->any.flags = flags;
+  event->any.flags &= CLUTTER_EVENT_FLAG_ALLOCATED;
+  event->any.flags |= flags;
   event->any.flags |= CLUTTER_EVENT_FLAG_SYNTHETIC;
 }
 
@@ -1220,15 +1258,21 @@ clutter_event_new (ClutterEventType type)
   ClutterEvent *new_event;
   ClutterEventPrivate *priv;
 
-  priv = g_slice_new0 (ClutterEventPrivate);
+  if (free_events != NULL)
+    {
+      priv = g_trash_stack_pop (&free_events);
+      n_free_events -= 1;
 
-  new_event = (ClutterEvent *) priv;
-  new_event->type = new_event->any.type = type;
+      memset (priv, 0, sizeof (ClutterEventPrivate));
+    }
+  else
+    priv = g_slice_new0 (ClutterEventPrivate);
 
-  if (G_UNLIKELY (all_events == NULL))
-    all_events = g_hash_table_new (NULL, NULL);
+  priv->self = priv;
 
-  g_hash_table_replace (all_events, priv, GUINT_TO_POINTER (1));
+  new_event = (ClutterEvent *) priv;
+  new_event->type = new_event->any.type = type;
+  new_event->any.flags = CLUTTER_EVENT_FLAG_ALLOCATED;
 
   return new_event;
 }
@@ -1255,6 +1299,7 @@ clutter_event_copy (const ClutterEvent *event)
   new_real_event = (ClutterEventPrivate *) new_event;
 
   *new_event = *event;
+  new_event->any.flags |= CLUTTER_EVENT_FLAG_ALLOCATED;
 
   if (is_event_allocated (event))
     {
@@ -1269,6 +1314,20 @@ clutter_event_copy (const ClutterEvent *event)
       new_real_event->button_state = real_event->button_state;
       new_real_event->latched_state = real_event->latched_state;
       new_real_event->locked_state = real_event->locked_state;
+      new_real_event->predicted_x = real_event->predicted_x;
+      new_real_event->predicted_y = real_event->predicted_y;
+      new_real_event->has_prediction = real_event->has_prediction;
+      new_real_event->hardware_time = real_event->hardware_time;
+
+      if (real_event->history != NULL)
+        {
+          new_real_event->history =
+            g_array_sized_new (FALSE, FALSE, sizeof (ClutterEventSample),
+                               real_event->history->len);
+          g_array_append_vals (new_real_event->history,
+                               real_event->history->data,
+                               real_event->history->len);
+        }
     }
 
   device = clutter_event_get_device (event);
@@ -1356,8 +1415,19 @@ clutter_event_free (ClutterEvent *event)
           break;
         }
 
-      g_hash_table_remove (all_events, event);
-      g_slice_free (ClutterEventPrivate, (ClutterEventPrivate *) event);
+      if (((ClutterEventPrivate *) event)->history != NULL)
+        g_array_unref (((ClutterEventPrivate *) event)->history);
+
+      ((ClutterEventPrivate *) event)->self = NULL;
+      event->any.flags &= ~CLUTTER_EVENT_FLAG_ALLOCATED;
+
+      if (n_free_events < MAX_FREE_EVENTS)
+        {
+          g_trash_stack_push (&free_events, event);
+          n_free_events += 1;
+        }
+      else
+        g_slice_free (ClutterEventPrivate, (ClutterEventPrivate *) event);
     }
 }
 
@@ -1431,6 +1501,17 @@ _clutter_event_push (const ClutterEvent *event,
         return;
     }
 
+  /* the input events are recorded here, and replaced by the recorded
+   * ones while replaying
+   */
+  if (_clutter_input_recorder_filter_event (event))
+    {
+      if (!do_copy)
+        clutter_event_free ((ClutterEvent *) event);
+
+      return;
+    }
+
   if (do_copy)
     {
       ClutterEvent *copy;
@@ -1999,3 +2080,257 @@ clutter_event_get_gesture_motion_delta (const ClutterEvent *event,
         *dy = event->touchpad_swipe.dy;
     }
 }
+
+static void
+clutter_event_trim_history (ClutterEventPrivate *real_event)
+{
+  if (real_event->history->len > MAX_HISTORY_SAMPLES)
+    g_array_remove_range (real_event->history, 0,
+                          real_event->history->len - MAX_HISTORY_SAMPLES);
+}
+
+/*< private >
+ * _clutter_event_add_history_sample:
+ * @event: a motion or touch update #ClutterEvent
+ * @time_: the time of the sample, in milliseconds
+ * @x: the X coordinate of the sample
+ * @y: the Y coordinate of the sample
+ *
+ * Appends a sample preceding the position of @event to its history;
+ * the samples must be added from the oldest to the newest.
+ */
+void
+_clutter_event_add_history_sample (ClutterEvent *event,
+                                   guint32       time_,
+                                   gfloat        x,
+                                   gfloat        y)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+  ClutterEventSample sample = { time_, x, y };
+
+  g_return_if_fail (event->type == CLUTTER_MOTION ||
+                    event->type == CLUTTER_TOUCH_UPDATE);
+
+  if (!is_event_allocated (event))
+    return;
+
+  if (real_event->history == NULL)
+    real_event->history = g_array_new (FALSE, FALSE, sizeof (ClutterEventSample));
+
+  g_array_append_val (real_event->history, sample);
+  clutter_event_trim_history (real_event);
+}
+
+/*< private >
+ * _clutter_event_coalesce:
+ * @event: a motion or touch update #ClutterEvent
+ * @previous: the event preceding @event, which is not going to be
+ *   delivered
+ *
+ * Prepends the history and the position of @previous to the history
+ * of @event.
+ */
+void
+_clutter_event_coalesce (ClutterEvent       *event,
+                         const ClutterEvent *previous)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+  ClutterEventPrivate *real_previous = (ClutterEventPrivate *) previous;
+  ClutterEventSample sample;
+  GArray *history;
+
+  g_return_if_fail (event->type == CLUTTER_MOTION ||
+                    event->type == CLUTTER_TOUCH_UPDATE);
+
+  if (!is_event_allocated (event))
+    return;
+
+  history = g_array_new (FALSE, FALSE, sizeof (ClutterEventSample));
+
+  if (is_event_allocated (previous) && real_previous->history != NULL)
+    g_array_append_vals (history,
+                         real_previous->history->data,
+                         real_previous->history->len);
+
+  sample.time = clutter_event_get_time (previous);
+  clutter_event_get_coords (previous, &sample.x, &sample.y);
+  g_array_append_val (history, sample);
+
+  if (real_event->history != NULL)
+    {
+      g_array_append_vals (history,
+                           real_event->history->data,
+                           real_event->history->len);
+      g_array_unref (real_event->history);
+    }
+
+  real_event->history = history;
+  clutter_event_trim_history (real_event);
+}
+
+/**
+ * clutter_event_get_history:
+ * @event: a motion or touch update #ClutterEvent
+ * @n_samples: (out): return location for the number of samples
+ *
+ * Retrieves the positions reported by the input device before the
+ * position of @event, and coalesced into it; for instance, because
+ * the device reports positions faster than the frame rate, or because
+ * the stage throttles the motion events.
+ *
+ * Gesture recognizers can use the history of the events to track the
+ * motion of the pointer or of the touch point at the rate of the
+ * device, while only handling one event per frame.
+ *
+ * Return value: (array length=n_samples) (transfer none) (nullable):
+ *   the samples, from the oldest to the newest, or %NULL if @event
+ *   does not have a history
+ *
+ * Since: 1.26
+ */
+const ClutterEventSample *
+clutter_event_get_history (const ClutterEvent *event,
+                           guint              *n_samples)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+  g_return_val_if_fail (event != NULL, NULL);
+  g_return_val_if_fail (n_samples != NULL, NULL);
+
+  *n_samples = 0;
+
+  if (!is_event_allocated (event) || real_event->history == NULL)
+    return NULL;
+
+  *n_samples = real_event->history->len;
+
+  return (const ClutterEventSample *) real_event->history->data;
+}
+
+/*< private >
+ * _clutter_event_set_predicted_coords:
+ * @event: a motion or touch update #ClutterEvent
+ * @x: the predicted X coordinate
+ * @y: the predicted Y coordinate
+ *
+ * Sets the position extrapolated for @event at the time the frame
+ * handling it is presented.
+ */
+void
+_clutter_event_set_predicted_coords (ClutterEvent *event,
+                                     gfloat        x,
+                                     gfloat        y)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+  if (!is_event_allocated (event))
+    return;
+
+  real_event->predicted_x = x;
+  real_event->predicted_y = y;
+  real_event->has_prediction = TRUE;
+}
+
+/**
+ * clutter_event_get_predicted_coords:
+ * @event: a #ClutterEvent
+ * @x: (out) (allow-none): return location for the X coordinate, or %NULL
+ * @y: (out) (allow-none): return location for the Y coordinate, or %NULL
+ *
+ * Retrieves the position that the pointer or the touch point of a
+ * motion or touch update event is expected to have at the time the
+ * frame handling @event is presented on screen.
+ *
+ * The prediction is extrapolated from the recent motion of the
+ * pointer or of the touch point while it is pressed; using it instead
+ * of clutter_event_get_coords() to move an actor hides some of the
+ * latency between the input device and the display, at the cost of
+ * overshooting a little when the motion changes abruptly.
+ *
+ * If @event does not have a prediction, the coordinates of @event are
+ * returned instead.
+ *
+ * Return value: %TRUE if @event has a predicted position
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_event_get_predicted_coords (const ClutterEvent *event,
+                                    gfloat             *x,
+                                    gfloat             *y)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+  g_return_val_if_fail (event != NULL, FALSE);
+
+  if (!is_event_allocated (event) || !real_event->has_prediction)
+    {
+      clutter_event_get_coords (event, x, y);
+      return FALSE;
+    }
+
+  if (x != NULL)
+    *x = real_event->predicted_x;
+
+  if (y != NULL)
+    *y = real_event->predicted_y;
+
+  return TRUE;
+}
+
+/**
+ * clutter_event_set_hardware_time:
+ * @event: a #ClutterEvent allocated using clutter_event_new()
+ * @hardware_time: the time the input device reported @event, in
+ *   microseconds, or 0 if unknown
+ *
+ * Sets the time at which the input device reported @event.
+ *
+ * The time must use the same clock as g_get_monotonic_time(); the
+ * backends set it for the events they translate, when the windowing
+ * system reports it.
+ *
+ * Since: 1.26
+ */
+void
+clutter_event_set_hardware_time (ClutterEvent *event,
+                                 gint64        hardware_time)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+  g_return_if_fail (event != NULL);
+
+  if (!is_event_allocated (event))
+    return;
+
+  real_event->hardware_time = hardware_time;
+}
+
+/**
+ * clutter_event_get_hardware_time:
+ * @event: a #ClutterEvent
+ *
+ * Retrieves the time at which the input device reported @event.
+ *
+ * Unlike clutter_event_get_time(), which may come from the clock of
+ * the windowing system, the returned time uses the same clock as
+ * g_get_monotonic_time(), and can be compared with the times of
+ * #ClutterFrameInfo to measure the latency between the input device
+ * and the screen.
+ *
+ * Return value: the time in microseconds, or 0 if unknown
+ *
+ * Since: 1.26
+ */
+gint64
+clutter_event_get_hardware_time (const ClutterEvent *event)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+
+  g_return_val_if_fail (event != NULL, 0);
+
+  if (!is_event_allocated (event))
+    return 0;
+
+  return real_event->hardware_time;
+}
@@ -117,6 +117,7 @@ typedef struct _ClutterCrossingEvent    ClutterCrossingEvent;
 typedef struct _ClutterTouchEvent       ClutterTouchEvent;
 typedef struct _ClutterTouchpadPinchEvent ClutterTouchpadPinchEvent;
 typedef struct _ClutterTouchpadSwipeEvent ClutterTouchpadSwipeEvent;
+typedef struct _ClutterEventSample      ClutterEventSample;
 
 /**
  * ClutterAnyEvent:
@@ -464,6 +465,24 @@ struct _ClutterTouchpadSwipeEvent
   gfloat dy;
 };
 
+/**
+ * ClutterEventSample:
+ * @time: the time of the sample, in milliseconds
+ * @x: the X coordinate of the sample, relative to the stage
+ * @y: the Y coordinate of the sample, relative to the stage
+ *
+ * A position reported by an input device before the one of a motion or
+ * touch update event, and coalesced into it.
+ *
+ * Since: 1.26
+ */
+struct _ClutterEventSample
+{
+  guint32 time;
+  gfloat x;
+  gfloat y;
+};
+
 /**
  * ClutterEvent:
  *
@@ -682,6 +701,19 @@ void                    clutter_event_get_gesture_motion_delta       (const Clut
                                                                       gdouble                *dx,
                                                                       gdouble                *dy);
 
+CLUTTER_AVAILABLE_IN_1_26
+const ClutterEventSample *clutter_event_get_history                  (const ClutterEvent     *event,
+                                                                      guint                  *n_samples);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_event_get_predicted_coords           (const ClutterEvent     *event,
+                                                                      gfloat                 *x,
+                                                                      gfloat                 *y);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_event_set_hardware_time              (ClutterEvent           *event,
+                                                                      gint64                  hardware_time);
+CLUTTER_AVAILABLE_IN_1_26
+gint64                  clutter_event_get_hardware_time              (const ClutterEvent     *event);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EVENT_H__ */
@@ -61,7 +61,7 @@
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 #include "deprecated/clutter-container.h"
 
-#include "clutter-actor.h"
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
 #include "clutter-child-meta.h"
 #include "clutter-debug.h"
@@ -70,6 +70,63 @@
 #include "clutter-layout-meta.h"
 #include "clutter-private.h"
 
+/* the state of the computation of a preferred size at the beginning
+ * of a line, so that the computation can restart from any line
+ * instead of going through all the children again
+ */
+typedef struct _FlowLine
+{
+  /* the index of the first item of the line in priv->children */
+  guint first_item;
+
+  /* whether the line was started by wrapping its first item */
+  guint wrapped : 1;
+
+  gint line_count;
+  gfloat total_min;
+  gfloat total_natural;
+  gfloat max_min;
+  gfloat max_natural;
+
+  /* the extent of the line */
+  gfloat line_min;
+  gfloat line_natural;
+} FlowLine;
+
+/* the cached result of a preferred size request */
+typedef struct _FlowRequest
+{
+  /* FlowLine; when not wrapping, each item is its own line */
+  GArray *lines;
+
+  gfloat for_size;
+  gboolean wrap;
+
+  /* the number of items per line, when snapping to the grid */
+  gint n_lines;
+
+  /* the first item that changed since the last computation, or
+   * G_MAXUINT if the result is still valid
+   */
+  guint dirty_item;
+
+  gint line_count;
+  gfloat min_size;
+  gfloat natural_size;
+  gfloat cell_size;
+} FlowRequest;
+
+/* the state of the allocation at the beginning of a line */
+typedef struct _FlowAllocLine
+{
+  guint first_item;
+  guint wrapped : 1;
+
+  gint line_index;
+  gfloat item_x;
+  gfloat item_y;
+} FlowAllocLine;
+
 struct _ClutterFlowLayoutPrivate
 {
   ClutterContainer *container;
@@ -87,14 +144,30 @@ struct _ClutterFlowLayoutPrivate
   gfloat max_row_height;
   gfloat row_height;
 
+  /* the children of the container, and their index in the array;
+   * hidden children are included, so that the indices match the
+   * order of the children of the container
+   */
+  GPtrArray *children;
+  GHashTable *child_index;
+  gint children_age;
+
   /* per-line size */
-  GArray *line_min;
-  GArray *line_natural;
+  FlowRequest width_request;
+  FlowRequest height_request;
   gfloat req_width;
   gfloat req_height;
 
   guint line_count;
 
+  /* the lines of the last allocation */
+  GArray *alloc_lines;
+  ClutterActorBox last_allocation;
+  ClutterAllocationFlags last_flags;
+  gint last_items_per_line;
+  guint alloc_dirty_item;
+  gint alloc_dirty_line;
+
   guint is_homogeneous : 1;
   guint snap_to_grid : 1;
 };
@@ -184,385 +257,529 @@ compute_lines (ClutterFlowLayout *self,
 }
 
 static void
-clutter_flow_layout_get_preferred_width (ClutterLayoutManager *manager,
-                                         ClutterContainer     *container,
-                                         gfloat                for_height,
-                                         gfloat               *min_width_p,
-                                         gfloat               *nat_width_p)
+clutter_flow_layout_invalidate_from (ClutterFlowLayout *self,
+                                     guint              item)
 {
-  ClutterFlowLayoutPrivate *priv = CLUTTER_FLOW_LAYOUT (manager)->priv;
-  gint n_rows, line_item_count, line_count;
-  gfloat total_min_width, total_natural_width;
-  gfloat line_min_width, line_natural_width;
-  gfloat max_min_width, max_natural_width;
-  ClutterActor *actor, *child;
-  ClutterActorIter iter;
-  gfloat item_y;
-
-  n_rows = get_rows (CLUTTER_FLOW_LAYOUT (manager), for_height);
-
-  total_min_width = 0;
-  total_natural_width = 0;
+  ClutterFlowLayoutPrivate *priv = self->priv;
 
-  line_min_width = 0;
-  line_natural_width = 0;
+  priv->width_request.dirty_item = MIN (priv->width_request.dirty_item, item);
+  priv->height_request.dirty_item = MIN (priv->height_request.dirty_item, item);
+  priv->alloc_dirty_item = MIN (priv->alloc_dirty_item, item);
 
-  line_item_count = 0;
-  line_count = 0;
+  if (item == 0)
+    priv->alloc_dirty_line = 0;
+}
 
-  item_y = 0;
+static void
+on_child_changed (ClutterActor      *child,
+                  ClutterFlowLayout *self)
+{
+  gpointer index;
 
-  actor = CLUTTER_ACTOR (container);
+  if (g_hash_table_lookup_extended (self->priv->child_index, child, NULL, &index))
+    clutter_flow_layout_invalidate_from (self, GPOINTER_TO_UINT (index));
+  else
+    clutter_flow_layout_invalidate_from (self, 0);
+}
 
-  /* clear the line width arrays */
-  if (priv->line_min != NULL)
-    g_array_free (priv->line_min, TRUE);
+static void
+on_child_visible_changed (ClutterActor      *child,
+                          GParamSpec        *pspec,
+                          ClutterFlowLayout *self)
+{
+  on_child_changed (child, self);
+}
 
-  if (priv->line_natural != NULL)
-    g_array_free (priv->line_natural, TRUE);
+static void
+clutter_flow_layout_track_child (ClutterFlowLayout *self,
+                                 ClutterActor      *child)
+{
+  g_signal_connect (child, "queue-relayout",
+                    G_CALLBACK (on_child_changed),
+                    self);
+  g_signal_connect (child, "notify::visible",
+                    G_CALLBACK (on_child_visible_changed),
+                    self);
+}
 
-  priv->line_min = g_array_sized_new (FALSE, FALSE,
-                                      sizeof (gfloat),
-                                      16);
-  priv->line_natural = g_array_sized_new (FALSE, FALSE,
-                                          sizeof (gfloat),
-                                          16);
+static void
+clutter_flow_layout_untrack_child (ClutterFlowLayout *self,
+                                   ClutterActor      *child)
+{
+  g_signal_handlers_disconnect_by_func (child, on_child_changed, self);
+  g_signal_handlers_disconnect_by_func (child, on_child_visible_changed, self);
+}
 
-  if (clutter_actor_get_n_children (actor) != 0)
-    line_count = 1;
+static void
+clutter_flow_layout_update_indices (ClutterFlowLayout *self,
+                                    guint              first)
+{
+  ClutterFlowLayoutPrivate *priv = self->priv;
+  guint i;
 
-  max_min_width = max_natural_width = 0;
+  for (i = first; i < priv->children->len; i++)
+    g_hash_table_insert (priv->child_index,
+                         g_ptr_array_index (priv->children, i),
+                         GUINT_TO_POINTER (i));
+}
 
-  clutter_actor_iter_init (&iter, actor);
-  while (clutter_actor_iter_next (&iter, &child))
-    {
-      gfloat child_min, child_natural;
-      gfloat new_y, item_height;
+static void
+clutter_flow_layout_clear_children (ClutterFlowLayout *self)
+{
+  ClutterFlowLayoutPrivate *priv = self->priv;
+  guint i;
 
-      if (!clutter_actor_is_visible (child))
-        continue;
+  for (i = 0; i < priv->children->len; i++)
+    clutter_flow_layout_untrack_child (self, g_ptr_array_index (priv->children, i));
 
-      if (priv->orientation == CLUTTER_FLOW_VERTICAL && for_height > 0)
-        {
-          clutter_actor_get_preferred_height (child, -1,
-                                              &child_min,
-                                              &child_natural);
+  g_ptr_array_set_size (priv->children, 0);
+  g_hash_table_remove_all (priv->child_index);
 
-          if ((priv->snap_to_grid && line_item_count == n_rows) ||
-              (!priv->snap_to_grid && item_y + child_natural > for_height))
-            {
-              total_min_width += line_min_width;
-              total_natural_width += line_natural_width;
+  clutter_flow_layout_invalidate_from (self, 0);
+}
 
-              g_array_append_val (priv->line_min,
-                                  line_min_width);
-              g_array_append_val (priv->line_natural,
-                                  line_natural_width);
+/* the children are tracked using the ::actor-added and ::actor-removed
+ * signals of the container; the children can also be reordered without
+ * emitting any signal, which we detect using the age of the container
+ */
+static void
+clutter_flow_layout_sync_children (ClutterFlowLayout *self)
+{
+  ClutterFlowLayoutPrivate *priv = self->priv;
+  ClutterActor *actor, *child;
 
-              line_min_width = line_natural_width = 0;
+  if (priv->container == NULL)
+    return;
 
-              line_item_count = 0;
-              line_count += 1;
-              item_y = 0;
-            }
+  actor = CLUTTER_ACTOR (priv->container);
 
-          if (priv->snap_to_grid)
-            {
-              new_y = ((line_item_count + 1) * (for_height + priv->row_spacing))
-                    / n_rows;
-              item_height = new_y - item_y - priv->row_spacing;
-            }
-          else
-            {
-              new_y = item_y + child_natural + priv->row_spacing;
-              item_height = child_natural;
-            }
+  if (priv->children_age == _clutter_actor_get_children_age (actor) &&
+      priv->children->len == clutter_actor_get_n_children (actor))
+    return;
 
-          clutter_actor_get_preferred_width (child, item_height,
-                                             &child_min,
-                                             &child_natural);
+  CLUTTER_NOTE (LAYOUT, "Flow: rebuilding the list of children");
 
-          line_min_width = MAX (line_min_width, child_min);
-          line_natural_width = MAX (line_natural_width, child_natural);
+  clutter_flow_layout_clear_children (self);
 
-          item_y = new_y;
-          line_item_count += 1;
+  for (child = clutter_actor_get_first_child (actor);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    {
+      g_ptr_array_add (priv->children, child);
+      clutter_flow_layout_track_child (self, child);
+    }
 
-          max_min_width = MAX (max_min_width, line_min_width);
-          max_natural_width = MAX (max_natural_width, line_natural_width);
-        }
-      else
-        {
-          clutter_actor_get_preferred_width (child, for_height,
-                                             &child_min,
-                                             &child_natural);
+  clutter_flow_layout_update_indices (self, 0);
 
-          max_min_width = MAX (max_min_width, child_min);
-          max_natural_width = MAX (max_natural_width, child_natural);
+  priv->children_age = _clutter_actor_get_children_age (actor);
+}
 
-          total_min_width += max_min_width;
-          total_natural_width += max_natural_width;
-          line_count += 1;
-        }
-    }
+static void
+on_actor_added (ClutterContainer  *container,
+                ClutterActor      *child,
+                ClutterFlowLayout *self)
+{
+  ClutterFlowLayoutPrivate *priv = self->priv;
+  ClutterActor *sibling;
+  gpointer index;
+  guint position;
 
-  priv->col_width = max_natural_width;
+  /* a stale list of children will be rebuilt anyway */
+  if (priv->children_age + 1 != _clutter_actor_get_children_age (CLUTTER_ACTOR (container)))
+    return;
 
-  if (priv->max_col_width > 0 && priv->col_width > priv->max_col_width)
-    priv->col_width = MAX (priv->max_col_width, max_min_width);
+  sibling = clutter_actor_get_previous_sibling (child);
+  if (sibling == NULL)
+    position = 0;
+  else if (g_hash_table_lookup_extended (priv->child_index, sibling, NULL, &index))
+    position = GPOINTER_TO_UINT (index) + 1;
+  else
+    return;
 
-  if (priv->col_width < priv->min_col_width)
-    priv->col_width = priv->min_col_width;
+  g_ptr_array_insert (priv->children, position, child);
+  clutter_flow_layout_update_indices (self, position);
+  clutter_flow_layout_track_child (self, child);
 
-  if (priv->orientation == CLUTTER_FLOW_VERTICAL && for_height > 0)
-    {
-      /* if we have a non-full row we need to add it */
-      if (line_item_count > 0)
-        {
-          total_min_width += line_min_width;
-          total_natural_width += line_natural_width;
+  priv->children_age += 1;
 
-          g_array_append_val (priv->line_min,
-                              line_min_width);
-          g_array_append_val (priv->line_natural,
-                              line_natural_width);
-        }
+  clutter_flow_layout_invalidate_from (self, position);
+}
 
-      priv->line_count = line_count;
+static void
+on_actor_removed (ClutterContainer  *container,
+                  ClutterActor      *child,
+                  ClutterFlowLayout *self)
+{
+  ClutterFlowLayoutPrivate *priv = self->priv;
+  gpointer index;
+  guint position;
 
-      if (priv->line_count > 0)
-        {
-          gfloat total_spacing;
+  /* the child is dropped even from a stale list, as it might go away
+   * before the list is rebuilt
+   */
+  if (g_hash_table_lookup_extended (priv->child_index, child, NULL, &index))
+    {
+      position = GPOINTER_TO_UINT (index);
 
-          total_spacing = priv->col_spacing * (priv->line_count - 1);
+      clutter_flow_layout_untrack_child (self, child);
+      g_hash_table_remove (priv->child_index, child);
+      g_ptr_array_remove_index (priv->children, position);
+      clutter_flow_layout_update_indices (self, position);
 
-          total_min_width += total_spacing;
-          total_natural_width += total_spacing;
-        }
+      clutter_flow_layout_invalidate_from (self, position);
     }
   else
-    {
-      g_array_append_val (priv->line_min, line_min_width);
-      g_array_append_val (priv->line_natural, line_natural_width);
+    clutter_flow_layout_invalidate_from (self, 0);
 
-      priv->line_count = line_count;
+  if (priv->children_age + 1 == _clutter_actor_get_children_age (CLUTTER_ACTOR (container)))
+    priv->children_age += 1;
+}
 
-      if (priv->line_count > 0)
-        {
-          gfloat total_spacing;
+static inline void
+get_preferred_size (ClutterActor       *child,
+                    ClutterOrientation  orientation,
+                    gfloat              for_size,
+                    gfloat             *min_size,
+                    gfloat             *natural_size)
+{
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    clutter_actor_get_preferred_width (child, for_size, min_size, natural_size);
+  else
+    clutter_actor_get_preferred_height (child, for_size, min_size, natural_size);
+}
+
+/* finds the last line starting before @item; the line starting with
+ * @item itself depends on the previous line for the wrapping
+ */
+static gint
+flow_find_restart_line (GArray *lines,
+                        gsize   line_size,
+                        guint   item)
+{
+  gint lo = 0, hi = (gint) lines->len - 1, res = -1;
 
-          total_spacing = priv->col_spacing * (priv->line_count - 1);
+  while (lo <= hi)
+    {
+      gint mid = (lo + hi) / 2;
+      guint first_item = *(guint *) (lines->data + mid * line_size);
 
-          total_min_width += total_spacing;
-          total_natural_width += total_spacing;
+      if (first_item < item)
+        {
+          res = mid;
+          lo = mid + 1;
         }
+      else
+        hi = mid - 1;
     }
 
-  CLUTTER_NOTE (LAYOUT,
-                "Flow[w]: %d lines (%d per line): w [ %.2f, %.2f ] for h %.2f",
-                n_rows, priv->line_count,
-                total_min_width,
-                total_natural_width,
-                for_height);
-
-  priv->req_height = for_height;
+  return res;
+}
 
-  if (min_width_p)
-    *min_width_p = max_min_width;
+static gfloat
+flow_request_get_line_natural (const FlowRequest *request,
+                               gint               line_index)
+{
+  if (!request->wrap || line_index < 0 || (guint) line_index >= request->lines->len)
+    return 0.f;
 
-  if (nat_width_p)
-    *nat_width_p = total_natural_width;
+  return g_array_index (request->lines, FlowLine, line_index).line_natural;
 }
 
+/* computes the preferred size of the layout in the @orientation
+ * direction for the given @for_size, restarting from the first line
+ * affected by the changes since the last computation
+ */
 static void
-clutter_flow_layout_get_preferred_height (ClutterLayoutManager *manager,
-                                          ClutterContainer     *container,
-                                          gfloat                for_width,
-                                          gfloat               *min_height_p,
-                                          gfloat               *nat_height_p)
+clutter_flow_layout_compute_request (ClutterFlowLayout  *self,
+                                     FlowRequest        *request,
+                                     ClutterOrientation  orientation,
+                                     gfloat              for_size)
 {
-  ClutterFlowLayoutPrivate *priv = CLUTTER_FLOW_LAYOUT (manager)->priv;
-  gint n_columns, line_item_count, line_count;
-  gfloat total_min_height, total_natural_height;
-  gfloat line_min_height, line_natural_height;
-  gfloat max_min_height, max_natural_height;
-  ClutterActor *actor, *child;
-  ClutterActorIter iter;
-  gfloat item_x;
-
-  n_columns = get_columns (CLUTTER_FLOW_LAYOUT (manager), for_width);
-
-  total_min_height = 0;
-  total_natural_height = 0;
+  ClutterFlowLayoutPrivate *priv = self->priv;
+  ClutterOrientation wrap_orientation;
+  gint n_lines, line_item_count, line_count, restart;
+  gfloat total_min, total_natural;
+  gfloat line_min, line_natural;
+  gfloat max_min, max_natural;
+  gfloat item_pos, spacing, total_spacing;
+  gboolean wrap, check_wrap;
+  FlowLine line = { 0, };
+  guint i;
+
+  clutter_flow_layout_sync_children (self);
+
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      wrap = priv->orientation == CLUTTER_FLOW_VERTICAL && for_size > 0;
+      wrap_orientation = CLUTTER_ORIENTATION_VERTICAL;
+      spacing = priv->row_spacing;
+    }
+  else
+    {
+      wrap = priv->orientation == CLUTTER_FLOW_HORIZONTAL && for_size > 0;
+      wrap_orientation = CLUTTER_ORIENTATION_HORIZONTAL;
+      spacing = priv->col_spacing;
+    }
 
-  line_min_height = 0;
-  line_natural_height = 0;
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    n_lines = get_rows (self, for_size);
+  else
+    n_lines = get_columns (self, for_size);
 
-  line_item_count = 0;
-  line_count = 0;
+  /* the grid depends on the size of the cells, which is computed by
+   * the request in the other direction
+   */
+  if (request->for_size != for_size ||
+      request->wrap != wrap ||
+      (priv->snap_to_grid && request->n_lines != n_lines))
+    request->dirty_item = 0;
 
-  item_x = 0;
+  if (request->dirty_item == G_MAXUINT)
+    return;
 
-  actor = CLUTTER_ACTOR (container);
+  restart = flow_find_restart_line (request->lines,
+                                    sizeof (FlowLine),
+                                    request->dirty_item);
+  if (restart >= 0)
+    {
+      line = g_array_index (request->lines, FlowLine, restart);
+      g_array_set_size (request->lines, restart);
+    }
+  else
+    {
+      line.first_item = 0;
+      line.wrapped = FALSE;
+      line.line_count = priv->children->len != 0 ? 1 : 0;
+      line.total_min = line.total_natural = 0;
+      line.max_min = line.max_natural = 0;
+      g_array_set_size (request->lines, 0);
+      restart = 0;
+    }
 
-  /* clear the line height arrays */
-  if (priv->line_min != NULL)
-    g_array_free (priv->line_min, TRUE);
+  CLUTTER_NOTE (LAYOUT, "Flow[%s]: restarting from item %u of %u",
+                orientation == CLUTTER_ORIENTATION_HORIZONTAL ? "w" : "h",
+                line.first_item,
+                priv->children->len);
 
-  if (priv->line_natural != NULL)
-    g_array_free (priv->line_natural, TRUE);
+  /* the allocation uses the lines in the wrapping direction */
+  if (wrap_orientation == (priv->orientation == CLUTTER_FLOW_HORIZONTAL
+                           ? CLUTTER_ORIENTATION_HORIZONTAL
+                           : CLUTTER_ORIENTATION_VERTICAL))
+    {
+      priv->alloc_dirty_item = MIN (priv->alloc_dirty_item, line.first_item);
+      priv->alloc_dirty_line = MIN (priv->alloc_dirty_line, restart);
+    }
 
-  priv->line_min = g_array_sized_new (FALSE, FALSE,
-                                      sizeof (gfloat),
-                                      16);
-  priv->line_natural = g_array_sized_new (FALSE, FALSE,
-                                          sizeof (gfloat),
-                                          16);
+  line_count = line.line_count;
+  total_min = line.total_min;
+  total_natural = line.total_natural;
+  max_min = line.max_min;
+  max_natural = line.max_natural;
 
-  if (clutter_actor_get_n_children (actor) != 0)
-    line_count = 1;
+  line_min = line_natural = 0;
+  line_item_count = 0;
+  item_pos = 0;
 
-  max_min_height = max_natural_height = 0;
+  /* the first item of a wrapped line has already been wrapped */
+  check_wrap = !line.wrapped;
 
-  clutter_actor_iter_init (&iter, actor);
-  while (clutter_actor_iter_next (&iter, &child))
+  for (i = line.first_item; i < priv->children->len; i++)
     {
+      ClutterActor *child = g_ptr_array_index (priv->children, i);
       gfloat child_min, child_natural;
-      gfloat new_x, item_width;
+      gfloat new_pos, item_size;
 
       if (!clutter_actor_is_visible (child))
         continue;
 
-      if (priv->orientation == CLUTTER_FLOW_HORIZONTAL && for_width > 0)
+      if (wrap)
         {
-          clutter_actor_get_preferred_width (child, -1,
-                                             &child_min,
-                                             &child_natural);
+          get_preferred_size (child, wrap_orientation, -1,
+                              &child_min,
+                              &child_natural);
 
-          if ((priv->snap_to_grid && line_item_count == n_columns) ||
-              (!priv->snap_to_grid && item_x + child_natural > for_width))
+          if (check_wrap &&
+              ((priv->snap_to_grid && line_item_count == n_lines) ||
+               (!priv->snap_to_grid && item_pos + child_natural > for_size)))
             {
-              total_min_height += line_min_height;
-              total_natural_height += line_natural_height;
+              total_min += line_min;
+              total_natural += line_natural;
 
-              g_array_append_val (priv->line_min,
-                                  line_min_height);
-              g_array_append_val (priv->line_natural,
-                                  line_natural_height);
+              line.line_min = line_min;
+              line.line_natural = line_natural;
+              g_array_append_val (request->lines, line);
 
-              line_min_height = line_natural_height = 0;
+              line_min = line_natural = 0;
 
               line_item_count = 0;
               line_count += 1;
-              item_x = 0;
+              item_pos = 0;
+
+              line.first_item = i;
+              line.wrapped = TRUE;
+              line.line_count = line_count;
+              line.total_min = total_min;
+              line.total_natural = total_natural;
+              line.max_min = max_min;
+              line.max_natural = max_natural;
             }
 
+          check_wrap = TRUE;
+
           if (priv->snap_to_grid)
             {
-              new_x = ((line_item_count + 1) * (for_width + priv->col_spacing))
-                    / n_columns;
-              item_width = new_x - item_x - priv->col_spacing;
+              new_pos = ((line_item_count + 1) * (for_size + spacing))
+                      / n_lines;
+              item_size = new_pos - item_pos - spacing;
             }
           else
             {
-              new_x = item_x + child_natural + priv->col_spacing;
-              item_width = child_natural;
+              new_pos = item_pos + child_natural + spacing;
+              item_size = child_natural;
             }
 
-          clutter_actor_get_preferred_height (child, item_width,
-                                              &child_min,
-                                              &child_natural);
+          get_preferred_size (child, orientation, item_size,
+                              &child_min,
+                              &child_natural);
 
-          line_min_height = MAX (line_min_height, child_min);
-          line_natural_height = MAX (line_natural_height, child_natural);
+          line_min = MAX (line_min, child_min);
+          line_natural = MAX (line_natural, child_natural);
 
-          item_x = new_x;
+          item_pos = new_pos;
           line_item_count += 1;
 
-          max_min_height = MAX (max_min_height, line_min_height);
-          max_natural_height = MAX (max_natural_height, line_natural_height);
+          max_min = MAX (max_min, line_min);
+          max_natural = MAX (max_natural, line_natural);
         }
       else
         {
-          clutter_actor_get_preferred_height (child, for_width,
-                                              &child_min,
-                                              &child_natural);
-
-          max_min_height = MAX (max_min_height, child_min);
-          max_natural_height = MAX (max_natural_height, child_natural);
-
-          total_min_height += max_min_height;
-          total_natural_height += max_natural_height;
-
+          line.first_item = i;
+          line.line_count = line_count;
+          line.total_min = total_min;
+          line.total_natural = total_natural;
+          line.max_min = max_min;
+          line.max_natural = max_natural;
+          g_array_append_val (request->lines, line);
+
+          get_preferred_size (child, orientation, for_size,
+                              &child_min,
+                              &child_natural);
+
+          max_min = MAX (max_min, child_min);
+          max_natural = MAX (max_natural, child_natural);
+
+          total_min += max_min;
+          total_natural += max_natural;
           line_count += 1;
         }
     }
 
-  priv->row_height = max_natural_height;
-
-  if (priv->max_row_height > 0 && priv->row_height > priv->max_row_height)
-    priv->row_height = MAX (priv->max_row_height, max_min_height);
+  /* if we have a non-full line we need to add it */
+  if (wrap && line_item_count > 0)
+    {
+      total_min += line_min;
+      total_natural += line_natural;
 
-  if (priv->row_height < priv->min_row_height)
-    priv->row_height = priv->min_row_height;
+      line.line_min = line_min;
+      line.line_natural = line_natural;
+      g_array_append_val (request->lines, line);
+    }
 
-  if (priv->orientation == CLUTTER_FLOW_HORIZONTAL && for_width > 0)
+  total_spacing = 0;
+  if (line_count > 0)
     {
-      /* if we have a non-full row we need to add it */
-      if (line_item_count > 0)
-        {
-          total_min_height += line_min_height;
-          total_natural_height += line_natural_height;
-
-          g_array_append_val (priv->line_min,
-                              line_min_height);
-          g_array_append_val (priv->line_natural,
-                              line_natural_height);
-        }
+      if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+        total_spacing = priv->col_spacing * (line_count - 1);
+      else if (wrap)
+        total_spacing = priv->row_spacing * (line_count - 1);
+      else
+        total_spacing = priv->col_spacing * line_count;
+    }
 
-      priv->line_count = line_count;
-      if (priv->line_count > 0)
-        {
-          gfloat total_spacing;
+  request->cell_size = max_natural;
 
-          total_spacing = priv->row_spacing * (priv->line_count - 1);
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      if (priv->max_col_width > 0 && request->cell_size > priv->max_col_width)
+        request->cell_size = MAX (priv->max_col_width, max_min);
 
-          total_min_height += total_spacing;
-          total_natural_height += total_spacing;
-        }
+      if (request->cell_size < priv->min_col_width)
+        request->cell_size = priv->min_col_width;
     }
   else
     {
-      g_array_append_val (priv->line_min, line_min_height);
-      g_array_append_val (priv->line_natural, line_natural_height);
+      if (priv->max_row_height > 0 && request->cell_size > priv->max_row_height)
+        request->cell_size = MAX (priv->max_row_height, max_min);
 
-      priv->line_count = line_count;
+      if (request->cell_size < priv->min_row_height)
+        request->cell_size = priv->min_row_height;
+    }
 
-      if (priv->line_count > 0)
-        {
-          gfloat total_spacing;
+  request->for_size = for_size;
+  request->wrap = wrap;
+  request->n_lines = n_lines;
+  request->dirty_item = G_MAXUINT;
+  request->line_count = line_count;
+  request->min_size = max_min;
+  request->natural_size = total_natural + total_spacing;
 
-          total_spacing = priv->col_spacing * priv->line_count;
+  CLUTTER_NOTE (LAYOUT,
+                "Flow[%s]: %d lines (%d per line): [ %.2f, %.2f ] for %.2f",
+                orientation == CLUTTER_ORIENTATION_HORIZONTAL ? "w" : "h",
+                line_count, n_lines,
+                total_min + total_spacing,
+                request->natural_size,
+                for_size);
+}
 
-          total_min_height += total_spacing;
-          total_natural_height += total_spacing;
-        }
-    }
+static void
+clutter_flow_layout_get_preferred_width (ClutterLayoutManager *manager,
+                                         ClutterContainer     *container,
+                                         gfloat                for_height,
+                                         gfloat               *min_width_p,
+                                         gfloat               *nat_width_p)
+{
+  ClutterFlowLayout *self = CLUTTER_FLOW_LAYOUT (manager);
+  ClutterFlowLayoutPrivate *priv = self->priv;
 
-  CLUTTER_NOTE (LAYOUT,
-                "Flow[h]: %d lines (%d per line): w [ %.2f, %.2f ] for h %.2f",
-                n_columns, priv->line_count,
-                total_min_height,
-                total_natural_height,
-                for_width);
+  clutter_flow_layout_compute_request (self, &priv->width_request,
+                                       CLUTTER_ORIENTATION_HORIZONTAL,
+                                       for_height);
+
+  priv->col_width = priv->width_request.cell_size;
+  priv->line_count = priv->width_request.line_count;
+  priv->req_height = for_height;
+
+  if (min_width_p)
+    *min_width_p = priv->width_request.min_size;
+
+  if (nat_width_p)
+    *nat_width_p = priv->width_request.natural_size;
+}
 
+static void
+clutter_flow_layout_get_preferred_height (ClutterLayoutManager *manager,
+                                          ClutterContainer     *container,
+                                          gfloat                for_width,
+                                          gfloat               *min_height_p,
+                                          gfloat               *nat_height_p)
+{
+  ClutterFlowLayout *self = CLUTTER_FLOW_LAYOUT (manager);
+  ClutterFlowLayoutPrivate *priv = self->priv;
+
+  clutter_flow_layout_compute_request (self, &priv->height_request,
+                                       CLUTTER_ORIENTATION_VERTICAL,
+                                       for_width);
+
+  priv->row_height = priv->height_request.cell_size;
+  priv->line_count = priv->height_request.line_count;
   priv->req_width = for_width;
 
   if (min_height_p)
-    *min_height_p = max_min_height;
+    *min_height_p = priv->height_request.min_size;
 
   if (nat_height_p)
-    *nat_height_p = total_natural_height;
+    *nat_height_p = priv->height_request.natural_size;
 }
 
 static void
@@ -572,14 +789,18 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
                               ClutterAllocationFlags  flags)
 {
   ClutterFlowLayoutPrivate *priv = CLUTTER_FLOW_LAYOUT (manager)->priv;
-  ClutterActor *actor, *child;
-  ClutterActorIter iter;
+  const FlowRequest *request;
+  FlowAllocLine line = { 0, };
+  ClutterActor *actor;
   gfloat x_off, y_off;
   gfloat avail_width, avail_height;
   gfloat item_x, item_y;
   gint line_item_count;
   gint items_per_line;
   gint line_index;
+  guint dirty_item, i;
+  gint dirty_line, restart;
+  gboolean check_wrap;
 
   actor = CLUTTER_ACTOR (container);
   if (clutter_actor_get_n_children (actor) == 0)
@@ -588,12 +809,17 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
   clutter_actor_box_get_origin (allocation, &x_off, &y_off);
   clutter_actor_box_get_size (allocation, &avail_width, &avail_height);
 
+  clutter_flow_layout_sync_children (CLUTTER_FLOW_LAYOUT (manager));
+
   /* blow the cached preferred size and re-compute with the given
    * available size in case the FlowLayout wasn't given the exact
-   * size it requested
+   * size it requested, or the children changed since the last
+   * request, e.g. because the container has a fixed size
    */
   if ((priv->req_width >= 0 && avail_width != priv->req_width) ||
-      (priv->req_height >= 0 && avail_height != priv->req_height))
+      (priv->req_height >= 0 && avail_height != priv->req_height) ||
+      priv->width_request.dirty_item != G_MAXUINT ||
+      priv->height_request.dirty_item != G_MAXUINT)
     {
       clutter_flow_layout_get_preferred_width (manager, container,
                                                avail_height,
@@ -603,22 +829,77 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
                                                 NULL, NULL);
     }
 
+  if (priv->orientation == CLUTTER_FLOW_HORIZONTAL)
+    request = &priv->height_request;
+  else
+    request = &priv->width_request;
+
   items_per_line = compute_lines (CLUTTER_FLOW_LAYOUT (manager),
                                   avail_width, avail_height);
 
-  item_x = x_off;
-  item_y = y_off;
+  /* the children before the first changed line keep their allocation,
+   * unless the whole layout moved
+   */
+  dirty_item = priv->alloc_dirty_item;
+  dirty_line = priv->alloc_dirty_line;
+
+  if ((priv->snap_to_grid && items_per_line != priv->last_items_per_line) ||
+      (flags & CLUTTER_ABSOLUTE_ORIGIN_CHANGED) != 0 ||
+      flags != priv->last_flags ||
+      !clutter_actor_box_equal (allocation, &priv->last_allocation))
+    dirty_item = 0;
+
+  priv->alloc_dirty_item = G_MAXUINT;
+  priv->alloc_dirty_line = G_MAXINT;
+  priv->last_allocation = *allocation;
+  priv->last_flags = flags;
+  priv->last_items_per_line = items_per_line;
+
+  if (dirty_item == G_MAXUINT)
+    return;
+
+  restart = flow_find_restart_line (priv->alloc_lines,
+                                    sizeof (FlowAllocLine),
+                                    dirty_item);
+
+  /* the lines using an extent that changed need a new allocation */
+  while (restart >= 0 &&
+         g_array_index (priv->alloc_lines, FlowAllocLine, restart).line_index > dirty_line)
+    restart -= 1;
+
+  if (restart >= 0)
+    {
+      line = g_array_index (priv->alloc_lines, FlowAllocLine, restart);
+      g_array_set_size (priv->alloc_lines, restart);
+    }
+  else
+    {
+      line.first_item = 0;
+      line.wrapped = FALSE;
+      line.line_index = 0;
+      line.item_x = x_off;
+      line.item_y = y_off;
+      g_array_set_size (priv->alloc_lines, 0);
+    }
+
+  g_array_append_val (priv->alloc_lines, line);
+
+  item_x = line.item_x;
+  item_y = line.item_y;
 
   line_item_count = 0;
-  line_index = 0;
+  line_index = line.line_index;
+
+  check_wrap = !line.wrapped;
 
-  clutter_actor_iter_init (&iter, actor);
-  while (clutter_actor_iter_next (&iter, &child))
+  for (i = line.first_item; i < priv->children->len; i++)
     {
+      ClutterActor *child = g_ptr_array_index (priv->children, i);
       ClutterActorBox child_alloc;
       gfloat item_width, item_height;
       gfloat new_x, new_y;
       gfloat child_min, child_natural;
+      gboolean wrapped = FALSE;
 
       if (!clutter_actor_is_visible (child))
         continue;
@@ -633,13 +914,12 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
 
       if (priv->orientation == CLUTTER_FLOW_HORIZONTAL)
         {
-          if ((priv->snap_to_grid &&
-               line_item_count == items_per_line && line_item_count > 0) ||
-              (!priv->snap_to_grid && item_x + item_width > avail_width))
+          if (check_wrap &&
+              ((priv->snap_to_grid &&
+                line_item_count == items_per_line && line_item_count > 0) ||
+               (!priv->snap_to_grid && item_x + item_width > avail_width)))
             {
-              item_y += g_array_index (priv->line_natural,
-                                       gfloat,
-                                       line_index);
+              item_y += flow_request_get_line_natural (request, line_index);
 
               if (line_index >= 0)
                 item_y += priv->row_spacing;
@@ -648,6 +928,8 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
               line_index += 1;
 
               item_x = x_off;
+
+              wrapped = TRUE;
             }
 
           if (priv->snap_to_grid)
@@ -661,20 +943,17 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
               new_x = item_x + item_width + priv->col_spacing;
             }
 
-          item_height = g_array_index (priv->line_natural,
-                                       gfloat,
-                                       line_index);
+          item_height = flow_request_get_line_natural (request, line_index);
 
         }
       else
         {
-          if ((priv->snap_to_grid &&
-               line_item_count == items_per_line && line_item_count > 0) ||
-              (!priv->snap_to_grid && item_y + item_height > avail_height))
+          if (check_wrap &&
+              ((priv->snap_to_grid &&
+                line_item_count == items_per_line && line_item_count > 0) ||
+               (!priv->snap_to_grid && item_y + item_height > avail_height)))
             {
-              item_x += g_array_index (priv->line_natural,
-                                       gfloat,
-                                       line_index);
+              item_x += flow_request_get_line_natural (request, line_index);
 
               if (line_index >= 0)
                 item_x += priv->col_spacing;
@@ -683,6 +962,8 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
               line_index += 1;
 
               item_y = y_off;
+
+              wrapped = TRUE;
             }
 
           if (priv->snap_to_grid)
@@ -696,9 +977,19 @@ clutter_flow_layout_allocate (ClutterLayoutManager   *manager,
               new_y = item_y + item_height + priv->row_spacing;
             }
 
-          item_width = g_array_index (priv->line_natural,
-                                      gfloat,
-                                      line_index);
+          item_width = flow_request_get_line_natural (request, line_index);
+        }
+
+      check_wrap = TRUE;
+
+      if (wrapped)
+        {
+          line.first_item = i;
+          line.wrapped = TRUE;
+          line.line_index = line_index;
+          line.item_x = item_x;
+          line.item_y = item_y;
+          g_array_append_val (priv->alloc_lines, line);
         }
 
       if (!priv->is_homogeneous &&
@@ -746,9 +1037,21 @@ static void
 clutter_flow_layout_set_container (ClutterLayoutManager *manager,
                                    ClutterContainer     *container)
 {
-  ClutterFlowLayoutPrivate *priv = CLUTTER_FLOW_LAYOUT (manager)->priv;
+  ClutterFlowLayout *self = CLUTTER_FLOW_LAYOUT (manager);
+  ClutterFlowLayoutPrivate *priv = self->priv;
   ClutterLayoutManagerClass *parent_class;
 
+  if (priv->container != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (priv->container,
+                                            on_actor_added,
+                                            self);
+      g_signal_handlers_disconnect_by_func (priv->container,
+                                            on_actor_removed,
+                                            self);
+      clutter_flow_layout_clear_children (self);
+    }
+
   priv->container = container;
 
   if (priv->container != NULL)
@@ -763,12 +1066,28 @@ clutter_flow_layout_set_container (ClutterLayoutManager *manager,
                    : CLUTTER_REQUEST_WIDTH_FOR_HEIGHT;
       clutter_actor_set_request_mode (CLUTTER_ACTOR (priv->container),
                                       request_mode);
+
+      g_signal_connect (priv->container, "actor-added",
+                        G_CALLBACK (on_actor_added),
+                        self);
+      g_signal_connect (priv->container, "actor-removed",
+                        G_CALLBACK (on_actor_removed),
+                        self);
+
+      /* force a rebuild of the children on the next request */
+      priv->children_age = _clutter_actor_get_children_age (CLUTTER_ACTOR (priv->container)) - 1;
     }
 
   parent_class = CLUTTER_LAYOUT_MANAGER_CLASS (clutter_flow_layout_parent_class);
   parent_class->set_container (manager, container);
 }
 
+static void
+clutter_flow_layout_layout_changed (ClutterLayoutManager *manager)
+{
+  clutter_flow_layout_invalidate_from (CLUTTER_FLOW_LAYOUT (manager), 0);
+}
+
 static void
 clutter_flow_layout_set_property (GObject      *gobject,
                                   guint         prop_id,
@@ -887,11 +1206,12 @@ clutter_flow_layout_finalize (GObject *gobject)
 {
   ClutterFlowLayoutPrivate *priv = CLUTTER_FLOW_LAYOUT (gobject)->priv;
 
-  if (priv->line_min != NULL)
-    g_array_free (priv->line_min, TRUE);
+  g_ptr_array_unref (priv->children);
+  g_hash_table_unref (priv->child_index);
 
-  if (priv->line_natural != NULL)
-    g_array_free (priv->line_natural, TRUE);
+  g_array_unref (priv->width_request.lines);
+  g_array_unref (priv->height_request.lines);
+  g_array_unref (priv->alloc_lines);
 
   G_OBJECT_CLASS (clutter_flow_layout_parent_class)->finalize (gobject);
 }
@@ -911,6 +1231,7 @@ clutter_flow_layout_class_init (ClutterFlowLayoutClass *klass)
     clutter_flow_layout_get_preferred_height;
   layout_class->allocate = clutter_flow_layout_allocate;
   layout_class->set_container = clutter_flow_layout_set_container;
+  layout_class->layout_changed = clutter_flow_layout_layout_changed;
 
   /**
    * ClutterFlowLayout:orientation:
@@ -1079,8 +1400,17 @@ clutter_flow_layout_init (ClutterFlowLayout *self)
   priv->min_col_width = priv->min_row_height = 0;
   priv->max_col_width = priv->max_row_height = -1;
 
-  priv->line_min = NULL;
-  priv->line_natural = NULL;
+  priv->children = g_ptr_array_new ();
+  priv->child_index = g_hash_table_new (NULL, NULL);
+
+  priv->width_request.lines = g_array_new (FALSE, FALSE, sizeof (FlowLine));
+  priv->width_request.dirty_item = 0;
+  priv->height_request.lines = g_array_new (FALSE, FALSE, sizeof (FlowLine));
+  priv->height_request.dirty_item = 0;
+
+  priv->alloc_lines = g_array_new (FALSE, FALSE, sizeof (FlowAllocLine));
+  priv->alloc_dirty_item = 0;
+  priv->alloc_dirty_line = 0;
   priv->snap_to_grid = TRUE;
 }
 
@@ -26,6 +26,17 @@
 
 G_BEGIN_DECLS
 
+void     _clutter_gesture_action_get_predicted_coords    (ClutterGestureAction *action,
+                                                          guint                 point,
+                                                          gfloat               *motion_x,
+                                                          gfloat               *motion_y);
+gfloat   _clutter_gesture_action_get_predicted_delta     (ClutterGestureAction *action,
+                                                          guint                 point,
+                                                          gfloat               *delta_x,
+                                                          gfloat               *delta_y);
+gboolean _clutter_gesture_action_handle_stage_event      (ClutterGestureAction *action,
+                                                          ClutterEvent         *event);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_GESTURE_ACTION_PRIVATE_H__ */
@@ -91,6 +91,7 @@
 
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
+#include "clutter-gesture-arena.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
 
@@ -111,6 +112,16 @@ typedef struct
   gint64 last_delta_time;
   gfloat last_delta_x, last_delta_y;
   gfloat release_x, release_y;
+
+  /* the latest motion, relative to the newest sample coalesced into
+   * the last motion event, if any
+   */
+  gint64 velocity_delta_time;
+  gfloat velocity_delta_x, velocity_delta_y;
+
+  /* the position predicted at the presentation time of the frame */
+  gfloat predicted_x, predicted_y;
+  gfloat predicted_delta_x, predicted_delta_y;
 } GesturePoint;
 
 struct _ClutterGestureActionPrivate
@@ -121,12 +132,12 @@ struct _ClutterGestureActionPrivate
   GArray *points;
 
   guint actor_capture_id;
-  gulong stage_capture_id;
 
   ClutterGestureTriggerEdge edge;
   float distance_x, distance_y;
 
   guint in_gesture : 1;
+  guint in_arena : 1;
 };
 
 enum
@@ -179,6 +190,13 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
   point->last_delta_x = point->last_delta_y = 0;
   point->last_delta_time = 0;
 
+  point->velocity_delta_x = point->velocity_delta_y = 0;
+  point->velocity_delta_time = 0;
+
+  point->predicted_x = point->press_x;
+  point->predicted_y = point->press_y;
+  point->predicted_delta_x = point->predicted_delta_y = 0;
+
   if (clutter_event_type (event) != CLUTTER_BUTTON_PRESS)
     point->sequence = clutter_event_get_event_sequence (event);
   else
@@ -231,24 +249,50 @@ gesture_unregister_point (ClutterGestureAction *action, gint position)
 }
 
 static void
-gesture_update_motion_point (GesturePoint *point,
-                             ClutterEvent *event)
+gesture_update_motion_point (ClutterGestureAction *action,
+                             GesturePoint         *point,
+                             ClutterEvent         *event)
 {
+  ClutterGestureActionPrivate *priv = action->priv;
   gfloat motion_x, motion_y;
+  gfloat predicted_x, predicted_y;
   gint64 _time;
 
   clutter_event_get_coords (event, &motion_x, &motion_y);
 
+  clutter_event_get_predicted_coords (event, &predicted_x, &predicted_y);
+  point->predicted_delta_x = predicted_x - point->predicted_x;
+  point->predicted_delta_y = predicted_y - point->predicted_y;
+  point->predicted_x = predicted_x;
+  point->predicted_y = predicted_y;
+
   clutter_event_free (point->last_event);
   point->last_event = clutter_event_copy (event);
 
   point->last_delta_x = motion_x - point->last_motion_x;
   point->last_delta_y = motion_y - point->last_motion_y;
-  point->last_motion_x = motion_x;
-  point->last_motion_y = motion_y;
 
   _time = clutter_event_get_time (event);
   point->last_delta_time = _time - point->last_motion_time;
+
+  /* the velocity is measured by the arena, from the newest sample
+   * coalesced into the event, instead of being averaged over the
+   * whole frame
+   */
+  if (!priv->in_arena ||
+      !_clutter_gesture_arena_get_velocity (_clutter_gesture_arena_get_for_stage (priv->stage),
+                                            event,
+                                            &point->velocity_delta_x,
+                                            &point->velocity_delta_y,
+                                            &point->velocity_delta_time))
+    {
+      point->velocity_delta_x = point->last_delta_x;
+      point->velocity_delta_y = point->last_delta_y;
+      point->velocity_delta_time = point->last_delta_time;
+    }
+
+  point->last_motion_x = motion_x;
+  point->last_motion_y = motion_y;
   point->last_motion_time = _time;
 }
 
@@ -268,6 +312,7 @@ gesture_update_release_point (GesturePoint *point,
    * releasing it. */
    _time = clutter_event_get_time (event);
    point->last_delta_time += _time - point->last_motion_time;
+   point->velocity_delta_time += _time - point->last_motion_time;
 }
 
 static gint
@@ -302,6 +347,19 @@ gesture_point_unset (GesturePoint *point)
   clutter_event_free (point->last_event);
 }
 
+static void
+gesture_leave_arena (ClutterGestureAction *action)
+{
+  ClutterGestureActionPrivate *priv = action->priv;
+
+  if (!priv->in_arena)
+    return;
+
+  _clutter_gesture_arena_remove_action (_clutter_gesture_arena_get_for_stage (priv->stage),
+                                        action);
+  priv->in_arena = FALSE;
+}
+
 static void
 cancel_gesture (ClutterGestureAction *action)
 {
@@ -310,11 +368,7 @@ cancel_gesture (ClutterGestureAction *action)
 
   priv->in_gesture = FALSE;
 
-  if (priv->stage_capture_id != 0)
-    {
-      g_signal_handler_disconnect (priv->stage, priv->stage_capture_id);
-      priv->stage_capture_id = 0;
-    }
+  gesture_leave_arena (action);
 
   actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (action));
   g_signal_emit (action, gesture_signals[GESTURE_CANCEL], 0, actor);
@@ -354,10 +408,17 @@ begin_gesture (ClutterGestureAction *action,
   return TRUE;
 }
 
-static gboolean
-stage_captured_event_cb (ClutterActor         *stage,
-                         ClutterEvent         *event,
-                         ClutterGestureAction *action)
+/*< private >
+ * _clutter_gesture_action_handle_stage_event:
+ * @action: a #ClutterGestureAction
+ * @event: an event for one of the points of @action
+ *
+ * Called by the #ClutterGestureArena of the stage for the events of
+ * the points registered by @action.
+ */
+gboolean
+_clutter_gesture_action_handle_stage_event (ClutterGestureAction *action,
+                                            ClutterEvent         *event)
 {
   ClutterGestureActionPrivate *priv = action->priv;
   ClutterActor *actor;
@@ -403,7 +464,7 @@ stage_captured_event_cb (ClutterActor         *stage,
         {
           if (priv->points->len < priv->requested_nb_points)
             {
-              gesture_update_motion_point (point, event);
+              gesture_update_motion_point (action, point, event);
               return CLUTTER_EVENT_PROPAGATE;
             }
 
@@ -412,14 +473,14 @@ stage_captured_event_cb (ClutterActor         *stage,
           if (priv->edge == CLUTTER_GESTURE_TRIGGER_EDGE_AFTER &&
               gesture_point_pass_threshold (action, point, event))
             {
-              gesture_update_motion_point (point, event);
+              gesture_update_motion_point (action, point, event);
               return CLUTTER_EVENT_PROPAGATE;
             }
 
           if (!begin_gesture (action, actor))
             {
               if ((point = gesture_find_point (action, event, &position)) != NULL)
-                gesture_update_motion_point (point, event);
+                gesture_update_motion_point (action, point, event);
               return CLUTTER_EVENT_PROPAGATE;
             }
 
@@ -427,7 +488,7 @@ stage_captured_event_cb (ClutterActor         *stage,
             return CLUTTER_EVENT_PROPAGATE;
         }
 
-      gesture_update_motion_point (point, event);
+      gesture_update_motion_point (action, point, event);
 
       g_signal_emit (action, gesture_signals[GESTURE_PROGRESS], 0, actor,
                      &return_value);
@@ -483,11 +544,8 @@ stage_captured_event_cb (ClutterActor         *stage,
       break;
     }
 
-  if (priv->points->len == 0 && priv->stage_capture_id)
-    {
-      g_signal_handler_disconnect (priv->stage, priv->stage_capture_id);
-      priv->stage_capture_id = 0;
-    }
+  if (priv->points->len == 0)
+    gesture_leave_arena (action);
 
   return CLUTTER_EVENT_PROPAGATE;
 }
@@ -498,7 +556,7 @@ actor_captured_event_cb (ClutterActor *actor,
                          ClutterGestureAction *action)
 {
   ClutterGestureActionPrivate *priv = action->priv;
-  GesturePoint *point G_GNUC_UNUSED;
+  GesturePoint *point;
 
   if ((clutter_event_type (event) != CLUTTER_BUTTON_PRESS) &&
       (clutter_event_type (event) != CLUTTER_TOUCH_BEGIN))
@@ -512,11 +570,13 @@ actor_captured_event_cb (ClutterActor *actor,
   if (priv->stage == NULL)
     priv->stage = clutter_actor_get_stage (actor);
 
-  if (priv->stage_capture_id == 0)
-    priv->stage_capture_id =
-      g_signal_connect_after (priv->stage, "captured-event",
-                              G_CALLBACK (stage_captured_event_cb),
-                              action);
+  if (point != NULL)
+    {
+      _clutter_gesture_arena_add_point (_clutter_gesture_arena_get_for_stage (priv->stage),
+                                        action,
+                                        event);
+      priv->in_arena = TRUE;
+    }
 
   /* Start the gesture immediately if the gesture has no
    * _TRIGGER_EDGE_AFTER drag threshold. */
@@ -545,14 +605,8 @@ clutter_gesture_action_set_actor (ClutterActorMeta *meta,
       priv->actor_capture_id = 0;
     }
 
-  if (priv->stage_capture_id != 0)
-    {
-      if (priv->stage != NULL)
-        g_signal_handler_disconnect (priv->stage, priv->stage_capture_id);
-
-      priv->stage_capture_id = 0;
-      priv->stage = NULL;
-    }
+  gesture_leave_arena (CLUTTER_GESTURE_ACTION (meta));
+  priv->stage = NULL;
 
   if (actor != NULL)
     {
@@ -1032,18 +1086,19 @@ clutter_gesture_action_get_velocity (ClutterGestureAction *action,
                                      gfloat               *velocity_x,
                                      gfloat               *velocity_y)
 {
+  GesturePoint *gesture_point;
   gfloat d_x, d_y, distance, velocity;
   gint64 d_t;
 
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
   g_return_val_if_fail (action->priv->points->len > point, 0);
 
-  distance = clutter_gesture_action_get_motion_delta (action, point,
-                                                      &d_x, &d_y);
+  gesture_point = &g_array_index (action->priv->points, GesturePoint, point);
 
-  d_t = g_array_index (action->priv->points,
-                       GesturePoint,
-                       point).last_delta_time;
+  d_x = gesture_point->velocity_delta_x;
+  d_y = gesture_point->velocity_delta_y;
+  d_t = gesture_point->velocity_delta_time;
+  distance = sqrt ((d_x * d_x) + (d_y * d_y));
 
   if (velocity_x)
     *velocity_x = d_t > FLOAT_EPSILON ? d_x / d_t : 0;
@@ -1366,3 +1421,74 @@ clutter_gesture_action_get_threshold_trigger_distance (ClutterGestureAction *act
         *y = gesture_get_default_threshold ();
     }
 }
+
+/*< private >
+ * _clutter_gesture_action_get_predicted_coords:
+ * @action: a #ClutterGestureAction
+ * @point: the touch point index
+ * @motion_x: (out) (allow-none): return location for the X coordinate
+ * @motion_y: (out) (allow-none): return location for the Y coordinate
+ *
+ * Retrieves the position of the touch point predicted for the
+ * presentation of the frame handling the latest motion event; see
+ * clutter_event_get_predicted_coords().
+ */
+void
+_clutter_gesture_action_get_predicted_coords (ClutterGestureAction *action,
+                                              guint                 point,
+                                              gfloat               *motion_x,
+                                              gfloat               *motion_y)
+{
+  GesturePoint *gesture_point;
+
+  g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
+  g_return_if_fail (action->priv->points->len > point);
+
+  gesture_point = &g_array_index (action->priv->points, GesturePoint, point);
+
+  if (motion_x)
+    *motion_x = gesture_point->predicted_x;
+
+  if (motion_y)
+    *motion_y = gesture_point->predicted_y;
+}
+
+/*< private >
+ * _clutter_gesture_action_get_predicted_delta:
+ * @action: a #ClutterGestureAction
+ * @point: the touch point index
+ * @delta_x: (out) (allow-none): return location for the X axis
+ *   component of the predicted delta
+ * @delta_y: (out) (allow-none): return location for the Y axis
+ *   component of the predicted delta
+ *
+ * Retrieves the incremental delta between the predicted positions of
+ * the last two motion events.
+ *
+ * Return value: the distance between the predicted positions
+ */
+gfloat
+_clutter_gesture_action_get_predicted_delta (ClutterGestureAction *action,
+                                             guint                 point,
+                                             gfloat               *delta_x,
+                                             gfloat               *delta_y)
+{
+  GesturePoint *gesture_point;
+  gfloat d_x, d_y;
+
+  g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
+  g_return_val_if_fail (action->priv->points->len > point, 0);
+
+  gesture_point = &g_array_index (action->priv->points, GesturePoint, point);
+
+  d_x = gesture_point->predicted_delta_x;
+  d_y = gesture_point->predicted_delta_y;
+
+  if (delta_x)
+    *delta_x = d_x;
+
+  if (delta_y)
+    *delta_y = d_y;
+
+  return sqrt ((d_x * d_x) + (d_y * d_y));
+}
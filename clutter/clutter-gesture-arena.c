@@ -0,0 +1,344 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * ClutterGestureArena: tracks the points of the gesture actions of a
+ * stage.
+ *
+ * The gesture actions register their points with the arena of the
+ * stage when a button or a touch point is pressed on their actor; the
+ * arena keeps a single captured-event handler on the stage, and routes
+ * each event only to the actions tracking its device or sequence,
+ * instead of every action in a gesture connecting its own handler.
+ *
+ * The velocity of each point is computed once for all the actions
+ * tracking it, from the newest sample coalesced into the motion
+ * events.
+ *
+ * The actions are dispatched in the order in which they registered
+ * the point, which is the capture order of the press; each recognizer
+ * still decides whether to begin or cancel its own gesture.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-gesture-arena.h"
+
+#include "clutter-debug.h"
+#include "clutter-event.h"
+#include "clutter-gesture-action-private.h"
+#include "clutter-private.h"
+#include "clutter-stage.h"
+
+typedef struct _GestureTrack
+{
+  /* the actions tracking the point, in registration order; the
+   * actions remove themselves before going away, so they are not
+   * referenced
+   */
+  GPtrArray *actions;
+
+  gfloat last_x, last_y;
+  gint64 last_time;
+
+  /* the latest motion, relative to the newest coalesced sample */
+  gfloat delta_x, delta_y;
+  gint64 delta_time;
+} GestureTrack;
+
+struct _ClutterGestureArena
+{
+  ClutterActor *stage;
+
+  /* ClutterEventSequence or ClutterInputDevice → GestureTrack */
+  GHashTable *tracks;
+
+  gulong capture_id;
+};
+
+static GQuark quark_gesture_arena = 0;
+
+static gpointer
+get_track_key (const ClutterEvent *event)
+{
+  ClutterEventSequence *sequence = clutter_event_get_event_sequence (event);
+
+  if (sequence != NULL)
+    return sequence;
+
+  return clutter_event_get_device (event);
+}
+
+static void
+gesture_track_free (gpointer data)
+{
+  GestureTrack *track = data;
+
+  g_ptr_array_unref (track->actions);
+  g_slice_free (GestureTrack, track);
+}
+
+static gboolean
+gesture_track_has_action (GestureTrack         *track,
+                          ClutterGestureAction *action)
+{
+  guint i;
+
+  for (i = 0; i < track->actions->len; i++)
+    {
+      if (g_ptr_array_index (track->actions, i) == action)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+gesture_track_update (GestureTrack       *track,
+                      const ClutterEvent *event)
+{
+  const ClutterEventSample *history;
+  gfloat x, y;
+  guint n_samples;
+  gint64 time_;
+
+  clutter_event_get_coords (event, &x, &y);
+  time_ = clutter_event_get_time (event);
+
+  history = clutter_event_get_history (event, &n_samples);
+  if (n_samples > 0 && history[n_samples - 1].time >= track->last_time)
+    {
+      const ClutterEventSample *sample = &history[n_samples - 1];
+
+      track->delta_x = x - sample->x;
+      track->delta_y = y - sample->y;
+      track->delta_time = time_ - sample->time;
+    }
+  else
+    {
+      track->delta_x = x - track->last_x;
+      track->delta_y = y - track->last_y;
+      track->delta_time = time_ - track->last_time;
+    }
+
+  track->last_x = x;
+  track->last_y = y;
+  track->last_time = time_;
+}
+
+static void
+clutter_gesture_arena_update_handler (ClutterGestureArena *arena);
+
+static gboolean
+clutter_gesture_arena_captured_event (ClutterActor        *stage,
+                                      ClutterEvent        *event,
+                                      ClutterGestureArena *arena)
+{
+  ClutterEventType event_type = clutter_event_type (event);
+  GPtrArray *actions;
+  GestureTrack *track;
+  gpointer key;
+  guint i;
+
+  if (event_type != CLUTTER_TOUCH_CANCEL &&
+      event_type != CLUTTER_TOUCH_UPDATE &&
+      event_type != CLUTTER_TOUCH_END &&
+      event_type != CLUTTER_MOTION &&
+      event_type != CLUTTER_BUTTON_RELEASE)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  key = get_track_key (event);
+  track = g_hash_table_lookup (arena->tracks, key);
+  if (track == NULL)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  if (event_type == CLUTTER_MOTION || event_type == CLUTTER_TOUCH_UPDATE)
+    gesture_track_update (track, event);
+
+  /* the actions can leave the arena while handling the event */
+  actions = g_ptr_array_new_full (track->actions->len, g_object_unref);
+  for (i = 0; i < track->actions->len; i++)
+    g_ptr_array_add (actions, g_object_ref (g_ptr_array_index (track->actions, i)));
+
+  for (i = 0; i < actions->len; i++)
+    {
+      ClutterGestureAction *action = g_ptr_array_index (actions, i);
+
+      track = g_hash_table_lookup (arena->tracks, key);
+      if (track == NULL)
+        break;
+
+      if (!gesture_track_has_action (track, action))
+        continue;
+
+      _clutter_gesture_action_handle_stage_event (action, event);
+    }
+
+  g_ptr_array_unref (actions);
+
+  /* the point is gone for every action */
+  if (event_type != CLUTTER_MOTION && event_type != CLUTTER_TOUCH_UPDATE)
+    {
+      g_hash_table_remove (arena->tracks, key);
+      clutter_gesture_arena_update_handler (arena);
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+/* the handler is only connected while points are tracked, so that
+ * the stage has no capture cost at other times
+ */
+static void
+clutter_gesture_arena_update_handler (ClutterGestureArena *arena)
+{
+  gboolean has_tracks = g_hash_table_size (arena->tracks) > 0;
+
+  if (has_tracks && arena->capture_id == 0)
+    {
+      arena->capture_id =
+        g_signal_connect_after (arena->stage, "captured-event",
+                                G_CALLBACK (clutter_gesture_arena_captured_event),
+                                arena);
+    }
+  else if (!has_tracks && arena->capture_id != 0)
+    {
+      g_signal_handler_disconnect (arena->stage, arena->capture_id);
+      arena->capture_id = 0;
+    }
+}
+
+static void
+clutter_gesture_arena_free (gpointer data)
+{
+  ClutterGestureArena *arena = data;
+
+  /* the stage is being finalized, and has no handlers left */
+  g_hash_table_unref (arena->tracks);
+  g_slice_free (ClutterGestureArena, arena);
+}
+
+ClutterGestureArena *
+_clutter_gesture_arena_get_for_stage (ClutterActor *stage)
+{
+  ClutterGestureArena *arena;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+
+  if (G_UNLIKELY (quark_gesture_arena == 0))
+    quark_gesture_arena = g_quark_from_static_string ("-clutter-gesture-arena");
+
+  arena = g_object_get_qdata (G_OBJECT (stage), quark_gesture_arena);
+  if (arena != NULL)
+    return arena;
+
+  arena = g_slice_new0 (ClutterGestureArena);
+  arena->stage = stage;
+  arena->tracks = g_hash_table_new_full (NULL, NULL, NULL, gesture_track_free);
+
+  g_object_set_qdata_full (G_OBJECT (stage), quark_gesture_arena,
+                           arena,
+                           clutter_gesture_arena_free);
+
+  return arena;
+}
+
+void
+_clutter_gesture_arena_add_point (ClutterGestureArena  *arena,
+                                  ClutterGestureAction *action,
+                                  const ClutterEvent   *event)
+{
+  GestureTrack *track;
+  gpointer key;
+
+  g_return_if_fail (arena != NULL);
+  g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
+
+  key = get_track_key (event);
+  track = g_hash_table_lookup (arena->tracks, key);
+
+  if (track == NULL)
+    {
+      track = g_slice_new0 (GestureTrack);
+      track->actions = g_ptr_array_new ();
+
+      clutter_event_get_coords (event, &track->last_x, &track->last_y);
+      track->last_time = clutter_event_get_time (event);
+
+      g_hash_table_insert (arena->tracks, key, track);
+
+      CLUTTER_NOTE (EVENT, "Tracking a new point (%d tracked)",
+                    g_hash_table_size (arena->tracks));
+    }
+
+  if (!gesture_track_has_action (track, action))
+    g_ptr_array_add (track->actions, action);
+
+  clutter_gesture_arena_update_handler (arena);
+}
+
+void
+_clutter_gesture_arena_remove_action (ClutterGestureArena  *arena,
+                                      ClutterGestureAction *action)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_return_if_fail (arena != NULL);
+
+  g_hash_table_iter_init (&iter, arena->tracks);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      GestureTrack *track = value;
+
+      g_ptr_array_remove (track->actions, action);
+
+      if (track->actions->len == 0)
+        g_hash_table_iter_remove (&iter);
+    }
+
+  clutter_gesture_arena_update_handler (arena);
+}
+
+gboolean
+_clutter_gesture_arena_get_velocity (ClutterGestureArena *arena,
+                                     const ClutterEvent  *event,
+                                     gfloat              *delta_x,
+                                     gfloat              *delta_y,
+                                     gint64              *delta_time)
+{
+  GestureTrack *track;
+
+  g_return_val_if_fail (arena != NULL, FALSE);
+
+  track = g_hash_table_lookup (arena->tracks, get_track_key (event));
+  if (track == NULL)
+    return FALSE;
+
+  *delta_x = track->delta_x;
+  *delta_y = track->delta_y;
+  *delta_time = track->delta_time;
+
+  return TRUE;
+}
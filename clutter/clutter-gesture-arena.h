@@ -0,0 +1,46 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+ */
+
+#ifndef __CLUTTER_GESTURE_ARENA_H__
+#define __CLUTTER_GESTURE_ARENA_H__
+
+#include <clutter/clutter-gesture-action.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterGestureArena     ClutterGestureArena;
+
+ClutterGestureArena *   _clutter_gesture_arena_get_for_stage    (ClutterActor         *stage);
+void                    _clutter_gesture_arena_add_point        (ClutterGestureArena  *arena,
+                                                                 ClutterGestureAction *action,
+                                                                 const ClutterEvent   *event);
+void                    _clutter_gesture_arena_remove_action    (ClutterGestureArena  *arena,
+                                                                 ClutterGestureAction *action);
+gboolean                _clutter_gesture_arena_get_velocity     (ClutterGestureArena  *arena,
+                                                                 const ClutterEvent   *event,
+                                                                 gfloat               *delta_x,
+                                                                 gfloat               *delta_y,
+                                                                 gint64               *delta_time);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_GESTURE_ARENA_H__ */
@@ -40,6 +40,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-layout-meta.h"
+#include "clutter-measure-pool.h"
 #include "clutter-private.h"
 
 /**
@@ -75,6 +76,7 @@ typedef struct _ClutterGridLine         ClutterGridLine;
 typedef struct _ClutterGridLines        ClutterGridLines;
 typedef struct _ClutterGridLineData     ClutterGridLineData;
 typedef struct _ClutterGridRequest      ClutterGridRequest;
+typedef struct _ClutterGridLineCache    ClutterGridLineCache;
 
 
 struct _ClutterGridAttach
@@ -104,14 +106,6 @@ struct _ClutterGridLineData
   guint homogeneous : 1;
 };
 
-struct _ClutterGridLayoutPrivate
-{
-  ClutterContainer *container;
-  ClutterOrientation orientation;
-
-  ClutterGridLineData linedata[2];
-};
-
 #define ROWS(priv)    (&(priv)->linedata[CLUTTER_ORIENTATION_HORIZONTAL])
 #define COLUMNS(priv) (&(priv)->linedata[CLUTTER_ORIENTATION_VERTICAL])
 
@@ -142,6 +136,34 @@ struct _ClutterGridRequest
   ClutterGridLines lines[2];
 };
 
+/* A ClutterGridLineCache struct holds the requests of the lines in
+ * one orientation, computed either without context or for the lines
+ * in the opposite orientation allocated to for_size
+ */
+struct _ClutterGridLineCache
+{
+  ClutterGridLine *lines;
+  gfloat for_size;
+
+  guint valid : 1;
+};
+
+struct _ClutterGridLayoutPrivate
+{
+  ClutterContainer *container;
+  ClutterOrientation orientation;
+
+  ClutterGridLineData linedata[2];
+
+  /* the requests are kept until the children change, indexed by
+   * orientation and by whether they are contextual
+   */
+  ClutterGridRequest request;
+  ClutterGridLineCache line_cache[2][2];
+
+  guint request_valid : 1;
+};
+
 enum
 {
   PROP_0,
@@ -180,7 +202,7 @@ G_DEFINE_TYPE_WITH_PRIVATE (ClutterGridLayout,
 
 
 #define GET_GRID_CHILD(grid, child) \
-  (CLUTTER_GRID_CHILD(clutter_layout_manager_get_child_meta \
+  (CLUTTER_GRID_CHILD(_clutter_layout_manager_get_child_meta \
    (CLUTTER_LAYOUT_MANAGER((grid)),\
     CLUTTER_GRID_LAYOUT((grid))->priv->container,(child))))
 
@@ -878,18 +900,88 @@ clutter_grid_request_sum (ClutterGridRequest *request,
  * When contextual is TRUE, requires allocation of
  * lines in the opposite orientation to be set.
  */
+/* Measures the visible children using the measure pool, so that
+ * compute_request_for_child() hits the size request caches.
+ */
+static void
+clutter_grid_request_measure_children (ClutterGridRequest *request,
+                                       ClutterOrientation  orientation,
+                                       gboolean            contextual)
+{
+  ClutterGridLayoutPrivate *priv = request->grid->priv;
+  ClutterMeasureRequest *requests;
+  ClutterActorIter iter;
+  ClutterActor *child;
+  guint n_requests = 0;
+
+  if (!_clutter_measure_pool_is_enabled ())
+    return;
+
+  requests = g_new (ClutterMeasureRequest,
+                    clutter_actor_get_n_children (CLUTTER_ACTOR (priv->container)));
+
+  clutter_actor_iter_init (&iter, CLUTTER_ACTOR (priv->container));
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      if (!clutter_actor_is_visible (child))
+        continue;
+
+      requests[n_requests].actor = child;
+      requests[n_requests].orientation = orientation;
+      requests[n_requests].for_size = contextual
+        ? compute_allocation_for_child (request, child, 1 - orientation)
+        : -1;
+      n_requests += 1;
+    }
+
+  _clutter_measure_pool_run (requests, n_requests);
+
+  g_free (requests);
+}
+
 static void
 clutter_grid_request_run (ClutterGridRequest *request,
                           ClutterOrientation  orientation,
                           gboolean            contextual)
 {
   clutter_grid_request_init (request, orientation);
+  clutter_grid_request_measure_children (request, orientation, contextual);
   clutter_grid_request_non_spanning (request, orientation, contextual);
   clutter_grid_request_homogeneous (request, orientation);
   clutter_grid_request_spanning (request, orientation, contextual);
   clutter_grid_request_homogeneous (request, orientation);
 }
 
+/* Like clutter_grid_request_run(), but reuses the requests computed
+ * by a previous call, as long as the children did not change.
+ */
+static void
+clutter_grid_request_run_cached (ClutterGridRequest *request,
+                                 ClutterOrientation  orientation,
+                                 gboolean            contextual,
+                                 gfloat              for_size)
+{
+  ClutterGridLayoutPrivate *priv = request->grid->priv;
+  ClutterGridLineCache *cache;
+
+  cache = &priv->line_cache[orientation][contextual ? 1 : 0];
+
+  request->lines[orientation].lines = cache->lines;
+
+  if (cache->valid && (!contextual || cache->for_size == for_size))
+    return;
+
+  CLUTTER_NOTE (LAYOUT, "Computing the %s %s request%s",
+                contextual ? "contextual" : "natural",
+                orientation == CLUTTER_ORIENTATION_HORIZONTAL ? "column" : "row",
+                cache->valid ? " for a new size" : "");
+
+  clutter_grid_request_run (request, orientation, contextual);
+
+  cache->for_size = for_size;
+  cache->valid = TRUE;
+}
+
 typedef struct _RequestedSize
 {
   gpointer data;
@@ -1261,19 +1353,139 @@ clutter_grid_child_init (ClutterGridChild *self)
   CHILD_HEIGHT (self) = 1;
 }
 
+/* Returns the request of the grid, updating the attach points of the
+ * children and the number of lines if any child changed since the
+ * last call.
+ */
+static ClutterGridRequest *
+clutter_grid_layout_get_request (ClutterGridLayout *self)
+{
+  ClutterGridLayoutPrivate *priv = self->priv;
+  ClutterGridRequest *request = &priv->request;
+  gint orientation, n_lines;
+
+  if (priv->request_valid)
+    return request;
+
+  request->grid = self;
+  clutter_grid_request_update_attach (request);
+  clutter_grid_request_count_lines (request);
+
+  for (orientation = 0; orientation < 2; orientation++)
+    {
+      ClutterGridLines *lines = &request->lines[orientation];
+      gint i;
+
+      /* no children */
+      if (lines->max < lines->min)
+        lines->min = lines->max = 0;
+
+      n_lines = lines->max - lines->min;
+
+      for (i = 0; i < 2; i++)
+        {
+          ClutterGridLineCache *cache = &priv->line_cache[orientation][i];
+
+          cache->lines = g_renew (ClutterGridLine, cache->lines, n_lines);
+          memset (cache->lines, 0, n_lines * sizeof (ClutterGridLine));
+          cache->valid = FALSE;
+        }
+    }
+
+  priv->request_valid = TRUE;
+
+  return request;
+}
+
+static void
+clutter_grid_layout_invalidate (ClutterGridLayout *self)
+{
+  self->priv->request_valid = FALSE;
+}
+
+static void
+on_child_changed (ClutterActor      *child,
+                  ClutterGridLayout *self)
+{
+  clutter_grid_layout_invalidate (self);
+}
+
+static void
+on_child_visible_changed (ClutterActor      *child,
+                          GParamSpec        *pspec,
+                          ClutterGridLayout *self)
+{
+  clutter_grid_layout_invalidate (self);
+}
+
+static void
+on_actor_added (ClutterContainer  *container,
+                ClutterActor      *child,
+                ClutterGridLayout *self)
+{
+  g_signal_connect (child, "queue-relayout",
+                    G_CALLBACK (on_child_changed),
+                    self);
+  g_signal_connect (child, "notify::visible",
+                    G_CALLBACK (on_child_visible_changed),
+                    self);
+
+  clutter_grid_layout_invalidate (self);
+}
+
+static void
+on_actor_removed (ClutterContainer  *container,
+                  ClutterActor      *child,
+                  ClutterGridLayout *self)
+{
+  g_signal_handlers_disconnect_by_func (child, on_child_changed, self);
+  g_signal_handlers_disconnect_by_func (child, on_child_visible_changed, self);
+
+  clutter_grid_layout_invalidate (self);
+}
+
 static void
 clutter_grid_layout_set_container (ClutterLayoutManager *self,
                                    ClutterContainer     *container)
 {
   ClutterGridLayoutPrivate *priv = CLUTTER_GRID_LAYOUT (self)->priv;
   ClutterLayoutManagerClass *parent_class;
+  ClutterActorIter iter;
+  ClutterActor *child;
+
+  if (priv->container != NULL)
+    {
+      clutter_actor_iter_init (&iter, CLUTTER_ACTOR (priv->container));
+      while (clutter_actor_iter_next (&iter, &child))
+        on_actor_removed (priv->container, child, CLUTTER_GRID_LAYOUT (self));
+
+      g_signal_handlers_disconnect_by_func (priv->container,
+                                            on_actor_added,
+                                            self);
+      g_signal_handlers_disconnect_by_func (priv->container,
+                                            on_actor_removed,
+                                            self);
+    }
 
   priv->container = container;
 
+  clutter_grid_layout_invalidate (CLUTTER_GRID_LAYOUT (self));
+
   if (priv->container != NULL)
     {
       ClutterRequestMode request_mode;
 
+      clutter_actor_iter_init (&iter, CLUTTER_ACTOR (priv->container));
+      while (clutter_actor_iter_next (&iter, &child))
+        on_actor_added (priv->container, child, CLUTTER_GRID_LAYOUT (self));
+
+      g_signal_connect (priv->container, "actor-added",
+                        G_CALLBACK (on_actor_added),
+                        self);
+      g_signal_connect (priv->container, "actor-removed",
+                        G_CALLBACK (on_actor_removed),
+                        self);
+
       /* we need to change the :request-mode of the container
        * to match the orientation
        */
@@ -1295,28 +1507,17 @@ clutter_grid_layout_get_size_for_size (ClutterGridLayout  *self,
                                        float              *minimum,
                                        float              *natural)
 {
-  ClutterGridRequest request;
-  ClutterGridLines *lines;
+  ClutterGridRequest *request;
   float min_size, nat_size;
 
-  request.grid = self;
-  clutter_grid_request_update_attach (&request);
-  clutter_grid_request_count_lines (&request);
-
-  lines = &request.lines[0];
-  lines->lines = g_newa (ClutterGridLine, lines->max - lines->min);
-  memset (lines->lines, 0, (lines->max - lines->min) * sizeof (ClutterGridLine));
+  request = clutter_grid_layout_get_request (self);
 
-  lines = &request.lines[1];
-  lines->lines = g_newa (ClutterGridLine, lines->max - lines->min);
-  memset (lines->lines, 0, (lines->max - lines->min) * sizeof (ClutterGridLine));
+  clutter_grid_request_run_cached (request, 1 - orientation, FALSE, 0);
+  clutter_grid_request_sum (request, 1 - orientation, &min_size, &nat_size);
+  clutter_grid_request_allocate (request, 1 - orientation, MAX (size, nat_size));
 
-  clutter_grid_request_run (&request, 1 - orientation, FALSE);
-  clutter_grid_request_sum (&request, 1 - orientation, &min_size, &nat_size);
-  clutter_grid_request_allocate (&request, 1 - orientation, MAX (size, nat_size));
-
-  clutter_grid_request_run (&request, orientation, TRUE);
-  clutter_grid_request_sum (&request, orientation, minimum, natural);
+  clutter_grid_request_run_cached (request, orientation, TRUE, MAX (size, nat_size));
+  clutter_grid_request_sum (request, orientation, minimum, natural);
 }
 
 static void
@@ -1398,35 +1599,28 @@ clutter_grid_layout_allocate (ClutterLayoutManager   *layout,
 {
   ClutterGridLayout *self = CLUTTER_GRID_LAYOUT (layout);
   ClutterOrientation orientation;
-  ClutterGridRequest request;
-  ClutterGridLines *lines;
+  ClutterGridRequest *request;
   ClutterActorIter iter;
   ClutterActor *child;
+  gfloat size;
 
-  request.grid = self;
-
-  clutter_grid_request_update_attach (&request);
-  clutter_grid_request_count_lines (&request);
-  lines = &request.lines[0];
-  lines->lines = g_newa (ClutterGridLine, lines->max - lines->min);
-  memset (lines->lines, 0, (lines->max - lines->min) * sizeof (ClutterGridLine));
-  lines = &request.lines[1];
-  lines->lines = g_newa (ClutterGridLine, lines->max - lines->min);
-  memset (lines->lines, 0, (lines->max - lines->min) * sizeof (ClutterGridLine));
+  request = clutter_grid_layout_get_request (self);
 
   if (clutter_actor_get_request_mode (CLUTTER_ACTOR (container)) == CLUTTER_REQUEST_WIDTH_FOR_HEIGHT)
     orientation = CLUTTER_ORIENTATION_HORIZONTAL;
   else
     orientation = CLUTTER_ORIENTATION_VERTICAL;
 
-  clutter_grid_request_run (&request, 1 - orientation, FALSE);
-  clutter_grid_request_allocate (&request, 1 - orientation, GET_SIZE (allocation, 1 - orientation));
-  clutter_grid_request_run (&request, orientation, TRUE);
+  size = GET_SIZE (allocation, 1 - orientation);
+
+  clutter_grid_request_run_cached (request, 1 - orientation, FALSE, 0);
+  clutter_grid_request_allocate (request, 1 - orientation, size);
+  clutter_grid_request_run_cached (request, orientation, TRUE, size);
 
-  clutter_grid_request_allocate (&request, orientation, GET_SIZE (allocation, orientation));
+  clutter_grid_request_allocate (request, orientation, GET_SIZE (allocation, orientation));
 
-  clutter_grid_request_position (&request, 0);
-  clutter_grid_request_position (&request, 1);
+  clutter_grid_request_position (request, 0);
+  clutter_grid_request_position (request, 1);
 
   clutter_actor_iter_init (&iter, CLUTTER_ACTOR (container));
   while (clutter_actor_iter_next (&iter, &child))
@@ -1439,9 +1633,9 @@ clutter_grid_layout_allocate (ClutterLayoutManager   *layout,
         continue;
 
       grid_child = GET_GRID_CHILD (self, child);
-      allocate_child (&request, CLUTTER_ORIENTATION_HORIZONTAL, grid_child,
+      allocate_child (request, CLUTTER_ORIENTATION_HORIZONTAL, grid_child,
                       &x, &width);
-      allocate_child (&request, CLUTTER_ORIENTATION_VERTICAL, grid_child,
+      allocate_child (request, CLUTTER_ORIENTATION_VERTICAL, grid_child,
                       &y, &height);
       x += allocation->x1;
       y += allocation->y1;
@@ -1539,6 +1733,27 @@ clutter_grid_layout_get_property (GObject    *gobject,
     }
 }
 
+static void
+clutter_grid_layout_layout_changed (ClutterLayoutManager *manager)
+{
+  clutter_grid_layout_invalidate (CLUTTER_GRID_LAYOUT (manager));
+}
+
+static void
+clutter_grid_layout_finalize (GObject *gobject)
+{
+  ClutterGridLayoutPrivate *priv = CLUTTER_GRID_LAYOUT (gobject)->priv;
+  gint i;
+
+  for (i = 0; i < 2; i++)
+    {
+      g_free (priv->line_cache[i][0].lines);
+      g_free (priv->line_cache[i][1].lines);
+    }
+
+  G_OBJECT_CLASS (clutter_grid_layout_parent_class)->finalize (gobject);
+}
+
 static void
 clutter_grid_layout_class_init (ClutterGridLayoutClass *klass)
 {
@@ -1549,12 +1764,14 @@ clutter_grid_layout_class_init (ClutterGridLayoutClass *klass)
 
   object_class->set_property = clutter_grid_layout_set_property;
   object_class->get_property = clutter_grid_layout_get_property;
+  object_class->finalize = clutter_grid_layout_finalize;
 
   layout_class->set_container = clutter_grid_layout_set_container;
   layout_class->get_preferred_width = clutter_grid_layout_get_preferred_width;
   layout_class->get_preferred_height = clutter_grid_layout_get_preferred_height;
   layout_class->allocate = clutter_grid_layout_allocate;
   layout_class->get_child_meta_type = clutter_grid_layout_get_child_meta_type;
+  layout_class->layout_changed = clutter_grid_layout_layout_changed;
 
   /**
    * ClutterGridLayout:orientation:
@@ -38,7 +38,12 @@
 struct _ClutterIDPool
 {
   GArray *array;     /* Array of pointers    */
-  GSList *free_ids;  /* A stack of freed ids */
+
+  /* a binary min-heap of the freed ids; handing out the lowest free id
+   * first keeps the ids in use packed towards zero, so that they fit in
+   * the bits of the pick framebuffer even after a lot of churn
+   */
+  GArray *free_ids;
 };
 
 ClutterIDPool *
@@ -50,7 +55,7 @@ _clutter_id_pool_new  (guint initial_size)
 
   self->array = g_array_sized_new (FALSE, FALSE, 
                                    sizeof (gpointer), initial_size);
-  self->free_ids = NULL;
+  self->free_ids = g_array_new (FALSE, FALSE, sizeof (guint32));
   return self;
 }
 
@@ -60,10 +65,75 @@ _clutter_id_pool_free (ClutterIDPool *id_pool)
   g_return_if_fail (id_pool != NULL);
 
   g_array_free (id_pool->array, TRUE);
-  g_slist_free (id_pool->free_ids);
+  g_array_free (id_pool->free_ids, TRUE);
   g_slice_free (ClutterIDPool, id_pool);
 }
 
+static void
+free_ids_push (GArray  *heap,
+               guint32  id_)
+{
+  guint32 *ids;
+  guint i;
+
+  g_array_append_val (heap, id_);
+
+  ids = (guint32 *) heap->data;
+  i = heap->len - 1;
+
+  while (i > 0)
+    {
+      guint parent = (i - 1) / 2;
+
+      if (ids[parent] <= id_)
+        break;
+
+      ids[i] = ids[parent];
+      i = parent;
+    }
+
+  ids[i] = id_;
+}
+
+static guint32
+free_ids_pop (GArray *heap)
+{
+  guint32 *ids = (guint32 *) heap->data;
+  guint32 retval, last;
+  guint i, len;
+
+  retval = ids[0];
+
+  len = heap->len - 1;
+  last = ids[len];
+  g_array_set_size (heap, len);
+
+  if (len == 0)
+    return retval;
+
+  i = 0;
+  while (TRUE)
+    {
+      guint child = 2 * i + 1;
+
+      if (child >= len)
+        break;
+
+      if (child + 1 < len && ids[child + 1] < ids[child])
+        child += 1;
+
+      if (last <= ids[child])
+        break;
+
+      ids[i] = ids[child];
+      i = child;
+    }
+
+  ids[i] = last;
+
+  return retval;
+}
+
 guint32
 _clutter_id_pool_add (ClutterIDPool *id_pool,
                       gpointer       ptr)
@@ -73,13 +143,11 @@ _clutter_id_pool_add (ClutterIDPool *id_pool,
 
   g_return_val_if_fail (id_pool != NULL, 0);
 
-  if (id_pool->free_ids) /* There are items on our freelist, reuse one */
+  if (id_pool->free_ids->len > 0) /* There are freed ids, reuse the lowest */
     {
       array = (void*) id_pool->array->data;
-      retval = GPOINTER_TO_UINT (id_pool->free_ids->data);
+      retval = free_ids_pop (id_pool->free_ids);
 
-      id_pool->free_ids = g_slist_remove (id_pool->free_ids,
-                                          id_pool->free_ids->data);
       array[retval] = ptr;
       return retval;
     }
@@ -98,13 +166,17 @@ _clutter_id_pool_remove (ClutterIDPool *id_pool,
   gpointer *array;
 
   g_return_if_fail (id_pool != NULL);
+  g_return_if_fail (id_ < id_pool->array->len);
 
   array = (void*) id_pool->array->data;
 
+  /* removing an id twice would hand it out twice */
+  if (G_UNLIKELY (array[id_] == NULL))
+    return;
+
   array[id_] = NULL;
 
-  id_pool->free_ids = g_slist_prepend (id_pool->free_ids,
-                                       GUINT_TO_POINTER (id_));
+  free_ids_push (id_pool->free_ids, id_);
 }
 
 gpointer
@@ -0,0 +1,542 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterImageAtlas: shared textures for the small images.
+ *
+ * Each ClutterImage used to get its own texture, so the icons painted
+ * next to each other could never be drawn together, as the Cogl
+ * journal breaks its batches whenever the texture changes. The images
+ * smaller than the size set using the CLUTTER_IMAGE_ATLAS environment
+ * variable are instead placed inside a few large textures, and each
+ * image gets a sub-texture of its atlas; Cogl transforms the texture
+ * coordinates of the sub-textures, and batches the rectangles using
+ * the same atlas.
+ *
+ * The atlases are divided in shelves, each one as tall as the first
+ * image placed on it, and each shelf keeps the list of its free spans.
+ * The region of an image is released together with its sub-texture,
+ * and merged with the free spans next to it; the shelves left empty
+ * are merged with the empty shelves around them, and given back to the
+ * free area at the bottom of the atlas, so that they can be used for
+ * images of a different height. An atlas without images is freed.
+ *
+ * Each image is surrounded by a copy of its edges, so that the linear
+ * filtering does not sample the images around it.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-image-atlas.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+#define IMAGE_ATLAS_SIZE        1024
+
+/* the copy of the edges around each image, in pixels */
+#define IMAGE_ATLAS_BORDER      1
+
+typedef struct _AtlasSpan
+{
+  gint x;
+  gint width;
+} AtlasSpan;
+
+typedef struct _AtlasShelf
+{
+  gint y;
+  gint height;
+
+  /* the free AtlasSpan, sorted by position */
+  GArray *free_spans;
+} AtlasShelf;
+
+typedef struct _ImageAtlas
+{
+  CoglTexture *texture;
+
+  /* the AtlasShelf, from the top of the atlas */
+  GPtrArray *shelves;
+
+  guint n_regions;
+} ImageAtlas;
+
+typedef struct _AtlasRegion
+{
+  ImageAtlas *atlas;
+  AtlasShelf *shelf;
+
+  /* the span of the region, including the borders */
+  gint x;
+  gint width;
+} AtlasRegion;
+
+static GPtrArray *image_atlases = NULL;
+
+static CoglUserDataKey atlas_region_key;
+
+static AtlasShelf *
+atlas_shelf_new (gint y,
+                 gint height)
+{
+  AtlasShelf *shelf = g_slice_new (AtlasShelf);
+  AtlasSpan span = { 0, IMAGE_ATLAS_SIZE };
+
+  shelf->y = y;
+  shelf->height = height;
+  shelf->free_spans = g_array_new (FALSE, FALSE, sizeof (AtlasSpan));
+  g_array_append_val (shelf->free_spans, span);
+
+  return shelf;
+}
+
+static void
+atlas_shelf_free (gpointer data)
+{
+  AtlasShelf *shelf = data;
+
+  g_array_unref (shelf->free_spans);
+
+  g_slice_free (AtlasShelf, shelf);
+}
+
+static gboolean
+atlas_shelf_is_empty (AtlasShelf *shelf)
+{
+  return shelf->free_spans->len == 1 &&
+         g_array_index (shelf->free_spans, AtlasSpan, 0).width == IMAGE_ATLAS_SIZE;
+}
+
+/* reserves @width pixels from the first free span large enough */
+static gboolean
+atlas_shelf_reserve (AtlasShelf *shelf,
+                     gint        width,
+                     gint       *x)
+{
+  guint i;
+
+  for (i = 0; i < shelf->free_spans->len; i++)
+    {
+      AtlasSpan *span = &g_array_index (shelf->free_spans, AtlasSpan, i);
+
+      if (span->width < width)
+        continue;
+
+      *x = span->x;
+
+      span->x += width;
+      span->width -= width;
+
+      if (span->width == 0)
+        g_array_remove_index (shelf->free_spans, i);
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* gives a span back to @shelf, merging it with the free spans next to it */
+static void
+atlas_shelf_release (AtlasShelf *shelf,
+                     gint        x,
+                     gint        width)
+{
+  AtlasSpan span = { x, width };
+  AtlasSpan *prev = NULL, *next = NULL;
+  guint i;
+
+  for (i = 0; i < shelf->free_spans->len; i++)
+    {
+      if (g_array_index (shelf->free_spans, AtlasSpan, i).x > x)
+        break;
+    }
+
+  if (i > 0)
+    prev = &g_array_index (shelf->free_spans, AtlasSpan, i - 1);
+
+  if (i < shelf->free_spans->len)
+    next = &g_array_index (shelf->free_spans, AtlasSpan, i);
+
+  if (prev != NULL && prev->x + prev->width == x)
+    {
+      prev->width += width;
+
+      if (next != NULL && prev->x + prev->width == next->x)
+        {
+          prev->width += next->width;
+          g_array_remove_index (shelf->free_spans, i);
+        }
+    }
+  else if (next != NULL && x + width == next->x)
+    {
+      next->x = x;
+      next->width += width;
+    }
+  else
+    g_array_insert_val (shelf->free_spans, i, span);
+}
+
+static void
+image_atlas_free (ImageAtlas *atlas)
+{
+  g_ptr_array_unref (atlas->shelves);
+  cogl_object_unref (atlas->texture);
+
+  g_slice_free (ImageAtlas, atlas);
+}
+
+static ImageAtlas *
+image_atlas_new (void)
+{
+  ImageAtlas *atlas;
+  CoglTexture *texture;
+
+  texture = cogl_texture_new_with_size (IMAGE_ATLAS_SIZE, IMAGE_ATLAS_SIZE,
+                                        COGL_TEXTURE_NO_SLICING |
+                                        COGL_TEXTURE_NO_ATLAS,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (texture == NULL)
+    return NULL;
+
+  atlas = g_slice_new0 (ImageAtlas);
+  atlas->texture = texture;
+  atlas->shelves = g_ptr_array_new_with_free_func (atlas_shelf_free);
+
+  if (image_atlases == NULL)
+    image_atlases = g_ptr_array_new ();
+
+  g_ptr_array_add (image_atlases, atlas);
+
+  CLUTTER_NOTE (TEXTURE, "Created image atlas %u", image_atlases->len);
+
+  return atlas;
+}
+
+/* reserves a @width x @height area inside @atlas; the empty shelves
+ * taller than needed are split, and the others are only used if they
+ * waste less than half of the height of the image
+ */
+static AtlasShelf *
+image_atlas_reserve (ImageAtlas *atlas,
+                     gint        width,
+                     gint        height,
+                     gint       *x)
+{
+  AtlasShelf *shelf;
+  gint bottom = 0;
+  guint i;
+
+  for (i = 0; i < atlas->shelves->len; i++)
+    {
+      shelf = g_ptr_array_index (atlas->shelves, i);
+      bottom = shelf->y + shelf->height;
+
+      if (shelf->height < height)
+        continue;
+
+      if (atlas_shelf_is_empty (shelf))
+        {
+          if (shelf->height > height)
+            {
+              AtlasShelf *rest;
+
+              rest = atlas_shelf_new (shelf->y + height, shelf->height - height);
+              g_ptr_array_insert (atlas->shelves, i + 1, rest);
+
+              shelf->height = height;
+            }
+        }
+      else if (shelf->height > height + height / 2)
+        continue;
+
+      if (atlas_shelf_reserve (shelf, width, x))
+        return shelf;
+    }
+
+  if (bottom + height > IMAGE_ATLAS_SIZE)
+    return NULL;
+
+  shelf = atlas_shelf_new (bottom, height);
+  g_ptr_array_add (atlas->shelves, shelf);
+
+  atlas_shelf_reserve (shelf, width, x);
+
+  return shelf;
+}
+
+/* merges the empty shelves around the shelf at @index, and gives the
+ * empty shelves at the bottom back to the free area of @atlas
+ */
+static void
+image_atlas_merge_shelves (ImageAtlas *atlas,
+                           guint       index)
+{
+  AtlasShelf *shelf = g_ptr_array_index (atlas->shelves, index);
+
+  while (index + 1 < atlas->shelves->len)
+    {
+      AtlasShelf *next = g_ptr_array_index (atlas->shelves, index + 1);
+
+      if (!atlas_shelf_is_empty (next))
+        break;
+
+      shelf->height += next->height;
+      g_ptr_array_remove_index (atlas->shelves, index + 1);
+    }
+
+  while (index > 0)
+    {
+      AtlasShelf *prev = g_ptr_array_index (atlas->shelves, index - 1);
+
+      if (!atlas_shelf_is_empty (prev))
+        break;
+
+      prev->height += shelf->height;
+      g_ptr_array_remove_index (atlas->shelves, index);
+
+      index -= 1;
+      shelf = prev;
+    }
+
+  if (index == atlas->shelves->len - 1)
+    g_ptr_array_remove_index (atlas->shelves, index);
+}
+
+/* called when the sub-texture of an image is destroyed */
+static void
+atlas_region_free (gpointer data)
+{
+  AtlasRegion *region = data;
+  ImageAtlas *atlas = region->atlas;
+  AtlasShelf *shelf = region->shelf;
+  guint i;
+
+  atlas_shelf_release (shelf, region->x, region->width);
+
+  if (atlas_shelf_is_empty (shelf))
+    {
+      for (i = 0; i < atlas->shelves->len; i++)
+        {
+          if (g_ptr_array_index (atlas->shelves, i) == shelf)
+            {
+              image_atlas_merge_shelves (atlas, i);
+              break;
+            }
+        }
+    }
+
+  g_slice_free (AtlasRegion, region);
+
+  atlas->n_regions -= 1;
+  if (atlas->n_regions == 0)
+    {
+      CLUTTER_NOTE (TEXTURE, "Freeing an empty image atlas");
+
+      g_ptr_array_remove (image_atlases, atlas);
+      image_atlas_free (atlas);
+    }
+}
+
+static gboolean
+image_atlas_can_add (int             width,
+                     int             height,
+                     CoglPixelFormat format)
+{
+  guint max_size = _clutter_get_image_atlas_max_size ();
+
+  if (width <= 0 || height <= 0)
+    return FALSE;
+
+  if ((guint) width > max_size || (guint) height > max_size)
+    return FALSE;
+
+  /* the atlases have an alpha channel, while the opaque images need
+   * to keep their own texture to occlude the actors behind them
+   */
+  if ((format & COGL_A_BIT) == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_image_atlas_add_bitmap:
+ * @bitmap: the image data
+ *
+ * Places the contents of @bitmap inside an image atlas, if it is small
+ * enough.
+ *
+ * Return value: (transfer full): a sub-texture of the atlas, or %NULL
+ *   if @bitmap should be uploaded in its own texture
+ */
+CoglTexture *
+_clutter_image_atlas_add_bitmap (CoglBitmap *bitmap)
+{
+  CoglContext *ctx;
+  ImageAtlas *atlas = NULL;
+  AtlasShelf *shelf = NULL;
+  AtlasRegion *region;
+  CoglSubTexture *texture;
+  int width, height;
+  gint padded_width, padded_height;
+  gint x = 0, y;
+  guint i;
+
+  width = cogl_bitmap_get_width (bitmap);
+  height = cogl_bitmap_get_height (bitmap);
+
+  if (!image_atlas_can_add (width, height, cogl_bitmap_get_format (bitmap)))
+    return NULL;
+
+  padded_width = width + 2 * IMAGE_ATLAS_BORDER;
+  padded_height = height + 2 * IMAGE_ATLAS_BORDER;
+
+  for (i = 0; image_atlases != NULL && i < image_atlases->len; i++)
+    {
+      atlas = g_ptr_array_index (image_atlases, i);
+
+      shelf = image_atlas_reserve (atlas, padded_width, padded_height, &x);
+      if (shelf != NULL)
+        break;
+    }
+
+  if (shelf == NULL)
+    {
+      atlas = image_atlas_new ();
+      if (atlas == NULL)
+        return NULL;
+
+      shelf = image_atlas_reserve (atlas, padded_width, padded_height, &x);
+    }
+
+  y = shelf->y + IMAGE_ATLAS_BORDER;
+
+  region = g_slice_new (AtlasRegion);
+  region->atlas = atlas;
+  region->shelf = shelf;
+  region->x = x;
+  region->width = padded_width;
+
+  atlas->n_regions += 1;
+
+  x += IMAGE_ATLAS_BORDER;
+
+  /* the image, then its edges */
+  cogl_texture_set_region_from_bitmap (atlas->texture,
+                                       0, 0,
+                                       x, y,
+                                       width, height,
+                                       bitmap);
+  cogl_texture_set_region_from_bitmap (atlas->texture,
+                                       0, 0,
+                                       x, y - 1,
+                                       width, 1,
+                                       bitmap);
+  cogl_texture_set_region_from_bitmap (atlas->texture,
+                                       0, height - 1,
+                                       x, y + height,
+                                       width, 1,
+                                       bitmap);
+  cogl_texture_set_region_from_bitmap (atlas->texture,
+                                       0, 0,
+                                       x - 1, y,
+                                       1, height,
+                                       bitmap);
+  cogl_texture_set_region_from_bitmap (atlas->texture,
+                                       width - 1, 0,
+                                       x + width, y,
+                                       1, height,
+                                       bitmap);
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  texture = cogl_sub_texture_new (ctx, atlas->texture, x, y, width, height);
+
+  /* the region is released together with the sub-texture */
+  cogl_object_set_user_data (COGL_OBJECT (texture), &atlas_region_key,
+                             region,
+                             atlas_region_free);
+
+  CLUTTER_NOTE (TEXTURE, "Placed a %d x %d image at %d, %d of an atlas",
+                width, height, x, y);
+
+  return COGL_TEXTURE (texture);
+}
+
+/*< private >
+ * _clutter_image_atlas_add_data:
+ * @width: the width of the image
+ * @height: the height of the image
+ * @format: the pixel format of @data
+ * @rowstride: the length of each row inside @data
+ * @data: the image data
+ *
+ * Places the image data inside an image atlas, if it is small enough;
+ * see _clutter_image_atlas_add_bitmap().
+ *
+ * Return value: (transfer full): a sub-texture of the atlas, or %NULL
+ */
+CoglTexture *
+_clutter_image_atlas_add_data (int              width,
+                               int              height,
+                               CoglPixelFormat  format,
+                               int              rowstride,
+                               const guint8    *data)
+{
+  CoglContext *ctx;
+  CoglBitmap *bitmap;
+  CoglTexture *texture;
+
+  if (!image_atlas_can_add (width, height, format))
+    return NULL;
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  bitmap = cogl_bitmap_new_for_data (ctx, width, height, format, rowstride,
+                                     (guint8 *) data);
+
+  texture = _clutter_image_atlas_add_bitmap (bitmap);
+
+  cogl_object_unref (bitmap);
+
+  return texture;
+}
+
+/*< private >
+ * _clutter_image_atlas_get_size:
+ *
+ * Retrieves the size of the textures of the image atlases.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_image_atlas_get_size (void)
+{
+  if (image_atlases == NULL)
+    return 0;
+
+  return (gsize) image_atlases->len * IMAGE_ATLAS_SIZE * IMAGE_ATLAS_SIZE * 4;
+}
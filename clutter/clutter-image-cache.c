@@ -0,0 +1,323 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterImageCache: a cache of the textures of the images loaded
+ * using clutter_image_load_from_uri_async().
+ *
+ * The entries are keyed on the URI and on the requested size of the
+ * image. Each entry references its texture weakly, so that the images
+ * showing the same file share a single texture for as long as one of
+ * them uses it; the entry goes away with the texture.
+ *
+ * On top of that, the most recently used textures are referenced by
+ * the cache, until their estimated size goes over the size set using
+ * the CLUTTER_IMAGE_CACHE environment variable, so that the images
+ * loaded again shortly after being dropped are not decoded again.
+ *
+ * The entries being decoded hold the tasks of the images waiting for
+ * them, which are completed by the caller once the texture is ready.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-image-cache.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+typedef struct _CacheEntry
+{
+  gchar *key;
+
+  /* owned by the entry only while it is inside the LRU queue */
+  CoglTexture *texture;
+
+  /* the estimated size of the texture, in bytes */
+  gsize size;
+
+  /* the link inside the LRU queue; the data is the entry */
+  GList link;
+  guint in_lru : 1;
+
+  /* the tasks waiting for the texture to be decoded */
+  GList *waiters;
+} CacheEntry;
+
+static GHashTable *cache_entries = NULL;
+
+/* the most recently used entry is at the head */
+static GQueue cache_lru = G_QUEUE_INIT;
+
+static gsize cache_size = 0;
+
+static CoglUserDataKey cache_entry_key;
+
+static gchar *
+cache_entry_key_new (const gchar *uri,
+                     int          width,
+                     int          height)
+{
+  return g_strdup_printf ("%dx%d:%s", width, height, uri);
+}
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+  g_free (entry->key);
+
+  g_slice_free (CacheEntry, entry);
+}
+
+static CacheEntry *
+cache_entry_lookup (const gchar *uri,
+                    int          width,
+                    int          height)
+{
+  CacheEntry *entry;
+  gchar *key;
+
+  if (cache_entries == NULL)
+    return NULL;
+
+  key = cache_entry_key_new (uri, width, height);
+  entry = g_hash_table_lookup (cache_entries, key);
+  g_free (key);
+
+  return entry;
+}
+
+/* called when the last reference on the texture of an entry which is
+ * not inside the LRU queue goes away
+ */
+static void
+cache_entry_texture_destroyed (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_assert (!entry->in_lru);
+
+  CLUTTER_NOTE (TEXTURE, "Dropping shared image '%s'", entry->key);
+
+  g_hash_table_remove (cache_entries, entry->key);
+  cache_entry_free (entry);
+}
+
+static void
+clutter_image_cache_evict (gsize max_size)
+{
+  while (cache_size > max_size && cache_lru.tail != NULL)
+    {
+      CacheEntry *entry = cache_lru.tail->data;
+
+      g_queue_unlink (&cache_lru, &entry->link);
+      entry->in_lru = FALSE;
+      cache_size -= entry->size;
+
+      /* this frees the entry, unless an image uses the texture */
+      cogl_object_unref (entry->texture);
+    }
+}
+
+static void
+cache_entry_touch (CacheEntry *entry)
+{
+  if (entry->in_lru)
+    {
+      g_queue_unlink (&cache_lru, &entry->link);
+      g_queue_push_head_link (&cache_lru, &entry->link);
+      return;
+    }
+
+  cogl_object_ref (entry->texture);
+
+  entry->in_lru = TRUE;
+  g_queue_push_head_link (&cache_lru, &entry->link);
+  cache_size += entry->size;
+
+  clutter_image_cache_evict (_clutter_get_image_cache_size ());
+}
+
+/*< private >
+ * _clutter_image_cache_lookup:
+ * @uri: the URI of the image
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ *
+ * Retrieves the texture of a decoded image.
+ *
+ * Return value: (transfer full): the texture, or %NULL if the image
+ *   is not decoded
+ */
+CoglTexture *
+_clutter_image_cache_lookup (const gchar *uri,
+                             int          width,
+                             int          height)
+{
+  CacheEntry *entry;
+  CoglTexture *texture;
+
+  g_return_val_if_fail (uri != NULL, NULL);
+
+  entry = cache_entry_lookup (uri, width, height);
+  if (entry == NULL || entry->texture == NULL)
+    return NULL;
+
+  /* the entry may be freed while touching it */
+  texture = cogl_object_ref (entry->texture);
+
+  cache_entry_touch (entry);
+
+  return texture;
+}
+
+/*< private >
+ * _clutter_image_cache_queue:
+ * @uri: the URI of the image
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ * @task: (transfer full): the task waiting for the image
+ *
+ * Queues @task until the image is decoded; the first caller for an
+ * image is expected to start decoding it, and to call
+ * _clutter_image_cache_complete() once it is done.
+ *
+ * Return value: %TRUE if the image needs to be decoded, and %FALSE
+ *   if it is already being decoded
+ */
+gboolean
+_clutter_image_cache_queue (const gchar *uri,
+                            int          width,
+                            int          height,
+                            GTask       *task)
+{
+  CacheEntry *entry;
+
+  g_return_val_if_fail (uri != NULL, FALSE);
+  g_return_val_if_fail (G_IS_TASK (task), FALSE);
+
+  if (G_UNLIKELY (cache_entries == NULL))
+    cache_entries = g_hash_table_new (g_str_hash, g_str_equal);
+
+  entry = cache_entry_lookup (uri, width, height);
+  if (entry != NULL)
+    {
+      g_return_val_if_fail (entry->texture == NULL, FALSE);
+
+      entry->waiters = g_list_prepend (entry->waiters, task);
+
+      return FALSE;
+    }
+
+  entry = g_slice_new0 (CacheEntry);
+  entry->key = cache_entry_key_new (uri, width, height);
+  entry->link.data = entry;
+  entry->waiters = g_list_prepend (NULL, task);
+
+  g_hash_table_insert (cache_entries, entry->key, entry);
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_image_cache_complete:
+ * @uri: the URI of the image
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ * @texture: (allow-none): the texture of the decoded image, or %NULL
+ *   if the image could not be decoded
+ *
+ * Stores the texture of an image queued using _clutter_image_cache_queue().
+ *
+ * Return value: (transfer full) (element-type GTask): the tasks
+ *   waiting for the image, in the order in which they were queued
+ */
+GList *
+_clutter_image_cache_complete (const gchar *uri,
+                               int          width,
+                               int          height,
+                               CoglTexture *texture)
+{
+  CacheEntry *entry;
+  GList *waiters;
+
+  g_return_val_if_fail (uri != NULL, NULL);
+
+  entry = cache_entry_lookup (uri, width, height);
+  g_return_val_if_fail (entry != NULL && entry->texture == NULL, NULL);
+
+  waiters = g_list_reverse (entry->waiters);
+  entry->waiters = NULL;
+
+  if (texture == NULL)
+    {
+      g_hash_table_remove (cache_entries, entry->key);
+      cache_entry_free (entry);
+      return waiters;
+    }
+
+  CLUTTER_NOTE (TEXTURE, "Sharing image '%s' between %u images",
+                entry->key,
+                g_list_length (waiters));
+
+  entry->texture = texture;
+  entry->size = (gsize) cogl_texture_get_width (texture)
+              * cogl_texture_get_height (texture)
+              * 4;
+
+  cogl_object_set_user_data (COGL_OBJECT (texture), &cache_entry_key,
+                             entry,
+                             cache_entry_texture_destroyed);
+
+  /* the caller holds a reference until the waiters are completed */
+  cache_entry_touch (entry);
+
+  return waiters;
+}
+
+/*< private >
+ * _clutter_image_cache_clear:
+ *
+ * Drops the references held by the cache on the textures which are
+ * not used by any image.
+ */
+void
+_clutter_image_cache_clear (void)
+{
+  clutter_image_cache_evict (0);
+}
+
+/*< private >
+ * _clutter_image_cache_get_size:
+ *
+ * Retrieves the estimated size of the textures referenced by the
+ * cache, excluding the ones only used by images.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_image_cache_get_size (void)
+{
+  return cache_size;
+}
@@ -0,0 +1,47 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_IMAGE_CACHE_H__
+#define __CLUTTER_IMAGE_CACHE_H__
+
+#include <clutter/clutter-types.h>
+#include <cogl/cogl.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+CoglTexture *   _clutter_image_cache_lookup     (const gchar *uri,
+                                                 int          width,
+                                                 int          height);
+gboolean        _clutter_image_cache_queue      (const gchar *uri,
+                                                 int          width,
+                                                 int          height,
+                                                 GTask       *task);
+GList *         _clutter_image_cache_complete   (const gchar *uri,
+                                                 int          width,
+                                                 int          height,
+                                                 CoglTexture *texture);
+void            _clutter_image_cache_clear      (void);
+gsize           _clutter_image_cache_get_size   (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_IMAGE_CACHE_H__ */
@@ -0,0 +1,38 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_IMAGE_PRIVATE_H__
+#define __CLUTTER_IMAGE_PRIVATE_H__
+
+#include <clutter/clutter-image.h>
+
+G_BEGIN_DECLS
+
+gboolean        _clutter_image_is_opaque                (ClutterImage     *image);
+const gchar *   _clutter_image_get_uri                  (ClutterImage     *image,
+                                                         int              *width,
+                                                         int              *height);
+void            _clutter_image_release_texture          (ClutterImage     *image);
+gsize           _clutter_image_get_memory_size          (ClutterImage     *image);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_IMAGE_PRIVATE_H__ */
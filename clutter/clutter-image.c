@@ -33,6 +33,11 @@
  * See [image.c](https://git.gnome.org/browse/clutter/tree/examples/image-content.c?h=clutter-1.18)
  * for an example of how to use #ClutterImage.
  *
+ * Image files can also be decoded on a worker thread, using
+ * clutter_image_load_from_file_async(),
+ * clutter_image_load_from_stream_async() and
+ * clutter_image_load_from_bytes_async().
+ *
  * #ClutterImage is available since Clutter 1.10.
  */
 
@@ -42,19 +47,108 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
+#include <math.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
 #include "clutter-image.h"
+#include "clutter-image-private.h"
 
 #include "clutter-actor-private.h"
+#include "clutter-backend.h"
+#include "clutter-cairo.h"
 #include "clutter-color.h"
+#include "clutter-compressed-texture.h"
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
+#include "clutter-image-atlas.h"
+#include "clutter-image-cache.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
+#include "clutter-upload-queue.h"
 
 struct _ClutterImagePrivate
 {
   CoglTexture *texture;
+
+  /* incremented each time the image data changes, so that the
+   * asynchronous loads started before are discarded
+   */
+  guint load_serial;
+
+  /* the URI and size passed to clutter_image_load_from_uri_async()
+   * for the current image data, if any
+   */
+  gchar *uri;
+  int uri_width;
+  int uri_height;
+
+  /* the size of the texture released by _clutter_image_release_texture(),
+   * which is loaded again from the URI the next time the image is painted
+   */
+  int released_width;
+  int released_height;
+  guint released : 1;
+
+  /* set while an asynchronous load of the image data is decoding, or
+   * waiting for its upload
+   */
+  guint loading : 1;
+
+  /* painted while loading, if the image has no texture */
+  ClutterColor placeholder_color;
+
+  /* the texture painted in place of the image data when the image is
+   * displayed smaller than its size, see clutter_image_set_downscaling()
+   */
+  CoglTexture *scaled_texture;
+
+  /* the largest size the image data was displayed at, in pixels */
+  int painted_width;
+  int painted_height;
+
+  guint downscaling : 1;
+};
+
+/* the upload of a decoded image, run from the upload queue */
+typedef struct _ImageUpload
+{
+  /* the task decoding the image */
+  GAsyncResult *result;
+
+  /* the task of the caller, if the image is not loaded through the
+   * shared cache
+   */
+  GTask *task;
+} ImageUpload;
+
+typedef struct _ImageLoad
+{
+  gchar *filename;
+  GInputStream *stream;
+  GFile *file;
+  GBytes *bytes;
+
+  /* the URI of the image, if it is loaded through the shared cache */
+  gchar *uri;
+
+  /* the size to fit the image into, or -1 */
+  int width;
+  int height;
+
+  /* the image data serial of the image being loaded, if the image is
+   * not loaded through the shared cache
+   */
+  guint serial;
+
+  /* the decoded image; only one of them is set */
+  CoglBitmap *bitmap;
+  cairo_surface_t *surface;
+} ImageLoad;
+
+static const guint8 png_signature[] = {
+  0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
 };
 
 static void clutter_content_iface_init (ClutterContentIface *iface);
@@ -81,6 +175,10 @@ clutter_image_finalize (GObject *gobject)
       priv->texture = NULL;
     }
 
+  g_clear_pointer (&priv->scaled_texture, cogl_object_unref);
+
+  g_free (priv->uri);
+
   G_OBJECT_CLASS (clutter_image_parent_class)->finalize (gobject);
 }
 
@@ -96,18 +194,278 @@ clutter_image_init (ClutterImage *self)
   self->priv = clutter_image_get_instance_private (self);
 }
 
+/* loads the texture released by _clutter_image_release_texture() again,
+ * from the shared cache if possible
+ */
+static void
+clutter_image_reload (ClutterImage *image)
+{
+  ClutterImagePrivate *priv = image->priv;
+  int width, height;
+  gchar *uri;
+
+  priv->released = FALSE;
+
+  priv->texture = _clutter_image_cache_lookup (priv->uri,
+                                               priv->uri_width,
+                                               priv->uri_height);
+  if (priv->texture != NULL)
+    return;
+
+  CLUTTER_NOTE (TEXTURE, "Loading the released image '%s' again", priv->uri);
+
+  width = priv->released_width;
+  height = priv->released_height;
+
+  /* starting the load clears the URI */
+  uri = g_strdup (priv->uri);
+  clutter_image_load_from_uri_async (image, uri,
+                                     priv->uri_width,
+                                     priv->uri_height,
+                                     NULL,
+                                     NULL, NULL);
+  g_free (uri);
+
+  /* keep the preferred size until the image is loaded */
+  if (priv->texture == NULL)
+    {
+      priv->released_width = width;
+      priv->released_height = height;
+    }
+}
+
+/* the pipeline copying a texture into a level half its size; the
+ * linear filter averages the 2x2 texels around each sample
+ */
+static CoglPipeline *
+get_downscale_pipeline (void)
+{
+  static CoglPipeline *pipeline = NULL;
+
+  if (G_UNLIKELY (pipeline == NULL))
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      pipeline = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_blend (pipeline, "RGBA = ADD (SRC_COLOR, 0)", NULL);
+      cogl_pipeline_set_layer_null_texture (pipeline, 0, COGL_TEXTURE_TYPE_2D);
+      cogl_pipeline_set_layer_filters (pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+    }
+
+  return pipeline;
+}
+
+/* halves @texture on the GPU @n_levels times; the levels are not in
+ * an atlas, so that Cogl can generate their mipmaps for the trilinear
+ * filter
+ */
+static CoglTexture *
+clutter_image_scale_texture (CoglTexture *texture,
+                             int          n_levels)
+{
+  CoglPipeline *pipeline;
+  CoglTexture *source;
+  int width, height;
+  int i;
+
+  pipeline = cogl_pipeline_copy (get_downscale_pipeline ());
+
+  source = cogl_object_ref (texture);
+  width = cogl_texture_get_width (texture);
+  height = cogl_texture_get_height (texture);
+
+  for (i = 0; i < n_levels; i++)
+    {
+      CoglOffscreen *offscreen;
+      CoglFramebuffer *fb;
+      CoglTexture *level;
+      CoglError *error = NULL;
+
+      width = MAX (width / 2, 1);
+      height = MAX (height / 2, 1);
+
+      level = cogl_texture_new_with_size (width, height,
+                                          COGL_TEXTURE_NO_SLICING |
+                                          COGL_TEXTURE_NO_ATLAS,
+                                          COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+      if (level == NULL)
+        goto fail;
+
+      offscreen = cogl_offscreen_new_with_texture (level);
+      fb = COGL_FRAMEBUFFER (offscreen);
+      if (!cogl_framebuffer_allocate (fb, &error))
+        {
+          CLUTTER_NOTE (TEXTURE, "Unable to allocate a %dx%d image level: %s",
+                        width, height,
+                        error->message);
+          cogl_error_free (error);
+          cogl_object_unref (offscreen);
+          cogl_object_unref (level);
+          goto fail;
+        }
+
+      cogl_framebuffer_orthographic (fb, 0, 0, width, height, -1, 100);
+
+      cogl_pipeline_set_layer_texture (pipeline, 0, source);
+      cogl_framebuffer_draw_textured_rectangle (fb, pipeline,
+                                                0, 0, width, height,
+                                                0, 0, 1, 1);
+
+      cogl_object_unref (offscreen);
+      cogl_object_unref (source);
+      source = level;
+    }
+
+  cogl_object_unref (pipeline);
+
+  return source;
+
+fail:
+  cogl_object_unref (pipeline);
+  cogl_object_unref (source);
+
+  return NULL;
+}
+
+/* retrieves the texture to paint the image data of @image with inside
+ * @actor, which is a level of the image data matching the largest size
+ * the image was displayed at, if downscaling is enabled
+ */
+static CoglTexture *
+clutter_image_get_paint_texture (ClutterImage *image,
+                                 ClutterActor *actor)
+{
+  ClutterImagePrivate *priv = image->priv;
+  ClutterActorBox alloc, box;
+  gfloat transformed_width, transformed_height;
+  int width, height;
+  int level_width, level_height;
+  int n_levels;
+
+  if (!priv->downscaling)
+    return priv->texture;
+
+  /* the repeated image data is painted at its own size */
+  if (clutter_actor_get_content_repeat (actor) != CLUTTER_REPEAT_NONE)
+    return priv->texture;
+
+  clutter_actor_get_allocation_box (actor, &alloc);
+  if (clutter_actor_box_get_width (&alloc) <= 0 ||
+      clutter_actor_box_get_height (&alloc) <= 0)
+    return priv->texture;
+
+  /* the bounding box of the transformed allocation, scaled down to the
+   * content box
+   */
+  clutter_actor_get_content_box (actor, &box);
+  clutter_actor_get_transformed_size (actor,
+                                      &transformed_width,
+                                      &transformed_height);
+
+  width = ceilf (clutter_actor_box_get_width (&box) * transformed_width
+                 / clutter_actor_box_get_width (&alloc));
+  height = ceilf (clutter_actor_box_get_height (&box) * transformed_height
+                  / clutter_actor_box_get_height (&alloc));
+
+  /* the level is only regenerated when the image grows, so that
+   * animating its size down does not scale the image data each frame
+   */
+  priv->painted_width = MAX (priv->painted_width, width);
+  priv->painted_height = MAX (priv->painted_height, height);
+
+  level_width = cogl_texture_get_width (priv->texture);
+  level_height = cogl_texture_get_height (priv->texture);
+  n_levels = 0;
+
+  while (level_width > 1 && level_height > 1 &&
+         level_width / 2 >= priv->painted_width &&
+         level_height / 2 >= priv->painted_height)
+    {
+      level_width /= 2;
+      level_height /= 2;
+      n_levels += 1;
+    }
+
+  if (n_levels == 0)
+    {
+      g_clear_pointer (&priv->scaled_texture, cogl_object_unref);
+      return priv->texture;
+    }
+
+  if (priv->scaled_texture != NULL &&
+      cogl_texture_get_width (priv->scaled_texture) == level_width &&
+      cogl_texture_get_height (priv->scaled_texture) == level_height)
+    return priv->scaled_texture;
+
+  CLUTTER_NOTE (TEXTURE, "Scaling the image data down to %dx%d",
+                level_width, level_height);
+
+  g_clear_pointer (&priv->scaled_texture, cogl_object_unref);
+  priv->scaled_texture = clutter_image_scale_texture (priv->texture, n_levels);
+  if (priv->scaled_texture == NULL)
+    return priv->texture;
+
+  return priv->scaled_texture;
+}
+
+/* drops the level of the image data, which does not match the image
+ * data anymore
+ */
+static void
+clutter_image_invalidate (ClutterContent *content)
+{
+  ClutterImagePrivate *priv = CLUTTER_IMAGE (content)->priv;
+
+  g_clear_pointer (&priv->scaled_texture, cogl_object_unref);
+  priv->painted_width = 0;
+  priv->painted_height = 0;
+}
+
 static void
 clutter_image_paint_content (ClutterContent   *content,
                              ClutterActor     *actor,
                              ClutterPaintNode *root)
 {
-  ClutterImagePrivate *priv = CLUTTER_IMAGE (content)->priv;
+  ClutterImage *image = CLUTTER_IMAGE (content);
+  ClutterImagePrivate *priv = image->priv;
   ClutterPaintNode *node;
+  CoglTexture *texture;
+
+  if (priv->texture == NULL && priv->released && priv->uri != NULL)
+    clutter_image_reload (image);
 
   if (priv->texture == NULL)
-    return;
+    {
+      ClutterActorBox box;
+      ClutterColor color;
+
+      if (!priv->loading || priv->placeholder_color.alpha == 0)
+        return;
+
+      color = priv->placeholder_color;
+      color.alpha = clutter_actor_get_paint_opacity (actor)
+                  * priv->placeholder_color.alpha
+                  / 255;
 
-  node = clutter_actor_create_texture_paint_node (actor, priv->texture);
+      clutter_actor_get_content_box (actor, &box);
+
+      node = clutter_color_node_new (&color);
+      clutter_paint_node_set_name (node, "Image Placeholder");
+      clutter_paint_node_add_rectangle (node, &box);
+      clutter_paint_node_add_child (root, node);
+      clutter_paint_node_unref (node);
+
+      return;
+    }
+
+  texture = clutter_image_get_paint_texture (image, actor);
+
+  node = clutter_actor_create_texture_paint_node (actor, texture);
   clutter_paint_node_set_name (node, "Image Content");
   clutter_paint_node_add_child (root, node);
   clutter_paint_node_unref (node);
@@ -121,7 +479,18 @@ clutter_image_get_preferred_size (ClutterContent *content,
   ClutterImagePrivate *priv = CLUTTER_IMAGE (content)->priv;
 
   if (priv->texture == NULL)
-    return FALSE;
+    {
+      if (priv->uri == NULL || priv->released_width == 0)
+        return FALSE;
+
+      if (width != NULL)
+        *width = priv->released_width;
+
+      if (height != NULL)
+        *height = priv->released_height;
+
+      return TRUE;
+    }
 
   if (width != NULL)
     *width = cogl_texture_get_width (priv->texture);
@@ -132,11 +501,157 @@ clutter_image_get_preferred_size (ClutterContent *content,
   return TRUE;
 }
 
+/*< private >
+ * _clutter_image_get_uri:
+ * @image: a #ClutterImage
+ * @width: (out) (optional): return location for the width passed
+ *   to clutter_image_load_from_uri_async()
+ * @height: (out) (optional): return location for the height passed
+ *   to clutter_image_load_from_uri_async()
+ *
+ * Retrieves the URI that the image data of @image was loaded from, if
+ * it was set using clutter_image_load_from_uri_async().
+ *
+ * Return value: the URI of the image data, or %NULL
+ */
+const gchar *
+_clutter_image_get_uri (ClutterImage *image,
+                        int          *width,
+                        int          *height)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  if (width != NULL)
+    *width = priv->uri_width;
+
+  if (height != NULL)
+    *height = priv->uri_height;
+
+  return priv->uri;
+}
+
+/*< private >
+ * _clutter_image_release_texture:
+ * @image: a #ClutterImage
+ *
+ * Frees the texture of @image, if its image data was loaded using
+ * clutter_image_load_from_uri_async(); the image is loaded again from
+ * its URI the next time it is painted, and its preferred size does not
+ * change in the meantime.
+ *
+ * The texture stays inside the shared cache of images, unless the
+ * cache is cleared as well.
+ */
+void
+_clutter_image_release_texture (ClutterImage *image)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  if (priv->uri == NULL || priv->texture == NULL)
+    return;
+
+  CLUTTER_NOTE (TEXTURE, "Releasing the texture of image '%s'", priv->uri);
+
+  priv->released_width = cogl_texture_get_width (priv->texture);
+  priv->released_height = cogl_texture_get_height (priv->texture);
+  priv->released = TRUE;
+
+  cogl_object_unref (priv->texture);
+  priv->texture = NULL;
+
+  clutter_image_invalidate (CLUTTER_CONTENT (image));
+}
+
+/*< private >
+ * _clutter_image_get_memory_size:
+ * @image: a #ClutterImage
+ *
+ * Estimates the size of the textures of @image, including its
+ * downscaled level, assuming 4 bytes per pixel; the textures shared through the cache of images are counted
+ * for each image using them.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_image_get_memory_size (ClutterImage *image)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  gsize size;
+
+  if (priv->texture == NULL)
+    return 0;
+
+  size = (gsize) cogl_texture_get_width (priv->texture)
+       * cogl_texture_get_height (priv->texture)
+       * 4;
+
+  if (priv->scaled_texture != NULL)
+    size += (gsize) cogl_texture_get_width (priv->scaled_texture)
+          * cogl_texture_get_height (priv->scaled_texture)
+          * 4;
+
+  return size;
+}
+
+/*< private >
+ * _clutter_image_is_opaque:
+ * @image: a #ClutterImage
+ *
+ * Checks whether the image data of @image fully covers the content
+ * box of the actors using it, i.e. whether the texture does not have
+ * an alpha channel.
+ *
+ * Return value: %TRUE if the image is opaque
+ */
+gboolean
+_clutter_image_is_opaque (ClutterImage *image)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  if (priv->texture == NULL)
+    return FALSE;
+
+  return cogl_texture_get_components (priv->texture) == COGL_TEXTURE_COMPONENTS_RGB;
+}
+
+/* creates the texture for the image data, placing the small images
+ * inside the shared image atlases
+ */
+static CoglTexture *
+clutter_image_create_texture (int              width,
+                              int              height,
+                              CoglPixelFormat  pixel_format,
+                              int              row_stride,
+                              const guint8    *data)
+{
+  CoglTextureFlags flags = COGL_TEXTURE_NONE;
+  CoglTexture *texture;
+
+  texture = _clutter_image_atlas_add_data (width, height,
+                                           pixel_format,
+                                           row_stride,
+                                           data);
+  if (texture != NULL)
+    return texture;
+
+  if (width >= 512 && height >= 512)
+    flags |= COGL_TEXTURE_NO_ATLAS;
+
+  return cogl_texture_new_from_data (width, height,
+                                     flags,
+                                     pixel_format,
+                                     COGL_PIXEL_FORMAT_ANY,
+                                     row_stride,
+                                     data);
+}
+
 static void
 clutter_content_iface_init (ClutterContentIface *iface)
 {
   iface->get_preferred_size = clutter_image_get_preferred_size;
   iface->paint_content = clutter_image_paint_content;
+  iface->invalidate = clutter_image_invalidate;
 }
 
 /**
@@ -211,26 +726,22 @@ clutter_image_set_data (ClutterImage     *image,
                         GError          **error)
 {
   ClutterImagePrivate *priv;
-  CoglTextureFlags flags;
 
   g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
   g_return_val_if_fail (data != NULL, FALSE);
 
   priv = image->priv;
+  priv->load_serial += 1;
+  priv->loading = FALSE;
+  g_clear_pointer (&priv->uri, g_free);
 
   if (priv->texture != NULL)
     cogl_object_unref (priv->texture);
 
-  flags = COGL_TEXTURE_NONE;
-  if (width >= 512 && height >= 512)
-    flags |= COGL_TEXTURE_NO_ATLAS;
-
-  priv->texture = cogl_texture_new_from_data (width, height,
-                                              flags,
-                                              pixel_format,
-                                              COGL_PIXEL_FORMAT_ANY,
-                                              row_stride,
-                                              data);
+  priv->texture = clutter_image_create_texture (width, height,
+                                                pixel_format,
+                                                row_stride,
+                                                data);
   if (priv->texture == NULL)
     {
       g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
@@ -279,26 +790,22 @@ clutter_image_set_bytes (ClutterImage     *image,
                          GError          **error)
 {
   ClutterImagePrivate *priv;
-  CoglTextureFlags flags;
 
   g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
   g_return_val_if_fail (data != NULL, FALSE);
 
   priv = image->priv;
+  priv->load_serial += 1;
+  priv->loading = FALSE;
+  g_clear_pointer (&priv->uri, g_free);
 
   if (priv->texture != NULL)
     cogl_object_unref (priv->texture);
 
-  flags = COGL_TEXTURE_NONE;
-  if (width >= 512 && height >= 512)
-    flags |= COGL_TEXTURE_NO_ATLAS;
-
-  priv->texture = cogl_texture_new_from_data (width, height,
-                                              flags,
-                                              pixel_format,
-                                              COGL_PIXEL_FORMAT_ANY,
-                                              row_stride,
-                                              g_bytes_get_data (data, NULL));
+  priv->texture = clutter_image_create_texture (width, height,
+                                                pixel_format,
+                                                row_stride,
+                                                g_bytes_get_data (data, NULL));
   if (priv->texture == NULL)
     {
       g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
@@ -356,6 +863,9 @@ clutter_image_set_area (ClutterImage                 *image,
   g_return_val_if_fail (area != NULL, FALSE);
 
   priv = image->priv;
+  priv->load_serial += 1;
+  priv->loading = FALSE;
+  g_clear_pointer (&priv->uri, g_free);
 
   if (priv->texture == NULL)
     {
@@ -405,6 +915,64 @@ clutter_image_set_area (ClutterImage                 *image,
   return TRUE;
 }
 
+/**
+ * clutter_image_set_compressed_data:
+ * @image: a #ClutterImage
+ * @data: (array length=size): the contents of a KTX or PKM file
+ * @size: the size of @data, in bytes
+ * @error: return location for a #GError, or %NULL
+ *
+ * Sets the image data to be displayed by @image from a GPU compressed
+ * image, stored inside a KTX or PKM container.
+ *
+ * ETC1, ETC2 and ASTC compressed data is uploaded as it is if the
+ * driver supports its format, which uses a fraction of the memory of
+ * the uncompressed image data and avoids decoding it. Otherwise, the
+ * ETC1 and ETC2 data is decompressed, and the ASTC data fails to load
+ * with %CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT.
+ *
+ * The compressed data with an alpha channel is expected to use
+ * premultiplied alpha. The mipmap levels stored inside a KTX container
+ * are uploaded, if the data is not decompressed.
+ *
+ * If the image data was successfully loaded, the @image will be invalidated.
+ *
+ * Return value: %TRUE if the image data was successfully loaded,
+ *   and %FALSE otherwise.
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_image_set_compressed_data (ClutterImage  *image,
+                                   const guint8  *data,
+                                   gsize          size,
+                                   GError       **error)
+{
+  ClutterImagePrivate *priv;
+  CoglTexture *texture;
+
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+
+  priv = image->priv;
+  priv->load_serial += 1;
+  priv->loading = FALSE;
+  g_clear_pointer (&priv->uri, g_free);
+
+  texture = _clutter_compressed_texture_new (data, size, error);
+  if (texture == NULL)
+    return FALSE;
+
+  if (priv->texture != NULL)
+    cogl_object_unref (priv->texture);
+
+  priv->texture = texture;
+
+  clutter_content_invalidate (CLUTTER_CONTENT (image));
+
+  return TRUE;
+}
+
 /**
  * clutter_image_get_texture:
  * @image: a #ClutterImage
@@ -427,3 +995,817 @@ clutter_image_get_texture (ClutterImage *image)
 
   return image->priv->texture;
 }
+
+static void
+image_load_free (gpointer data)
+{
+  ImageLoad *load = data;
+
+  g_free (load->filename);
+  g_free (load->uri);
+  g_clear_object (&load->stream);
+  g_clear_object (&load->file);
+  g_clear_pointer (&load->bytes, g_bytes_unref);
+
+  if (load->bitmap != NULL)
+    cogl_object_unref (load->bitmap);
+
+  if (load->surface != NULL)
+    cairo_surface_destroy (load->surface);
+
+  g_slice_free (ImageLoad, load);
+}
+
+typedef struct
+{
+  const guint8 *data;
+  gsize len;
+} PngReader;
+
+static cairo_status_t
+png_reader_read (void          *closure,
+                 unsigned char *data,
+                 unsigned int   length)
+{
+  PngReader *reader = closure;
+
+  if (length > reader->len)
+    return CAIRO_STATUS_READ_ERROR;
+
+  memcpy (data, reader->data, length);
+  reader->data += length;
+  reader->len -= length;
+
+  return CAIRO_STATUS_SUCCESS;
+}
+
+/* scales @surface down to fit inside the requested size of @load,
+ * preserving its aspect ratio; images are never scaled up
+ */
+static cairo_surface_t *
+image_load_scale_surface (ImageLoad       *load,
+                          cairo_surface_t *surface)
+{
+  int width = cairo_image_surface_get_width (surface);
+  int height = cairo_image_surface_get_height (surface);
+  double scale = 1.0;
+  cairo_surface_t *scaled;
+  cairo_t *cr;
+
+  if (load->width > 0 && load->width < width)
+    scale = (double) load->width / width;
+
+  if (load->height > 0 && load->height < height * scale)
+    scale = (double) load->height / height;
+
+  if (scale >= 1.0)
+    return surface;
+
+  scaled = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                       MAX (1, (int) (width * scale + 0.5)),
+                                       MAX (1, (int) (height * scale + 0.5)));
+
+  cr = cairo_create (scaled);
+  cairo_scale (cr, scale, scale);
+  cairo_set_source_surface (cr, surface, 0, 0);
+  cairo_pattern_set_filter (cairo_get_source (cr), CAIRO_FILTER_GOOD);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  cairo_paint (cr);
+  cairo_destroy (cr);
+
+  cairo_surface_destroy (surface);
+
+  return scaled;
+}
+
+/* decodes PNG data using Cairo, and any other format supported by Cogl
+ * from a file; only the former can be scaled while decoding
+ */
+static gboolean
+image_load_decode (ImageLoad     *load,
+                   const guint8  *data,
+                   gsize          len,
+                   GError       **error)
+{
+  gboolean is_png = len >= sizeof (png_signature) &&
+                    memcmp (data, png_signature, sizeof (png_signature)) == 0;
+
+  if (is_png)
+    {
+      PngReader reader = { data, len };
+      cairo_surface_t *surface;
+
+      surface = cairo_image_surface_create_from_png_stream (png_reader_read,
+                                                            &reader);
+      if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS)
+        {
+          g_set_error (error, CLUTTER_IMAGE_ERROR,
+                       CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                       _("Unable to load image data: %s"),
+                       cairo_status_to_string (cairo_surface_status (surface)));
+          cairo_surface_destroy (surface);
+          return FALSE;
+        }
+
+      load->surface = image_load_scale_surface (load, surface);
+
+      return TRUE;
+    }
+
+  if (load->filename != NULL)
+    {
+      load->bitmap = cogl_bitmap_new_from_file (load->filename, error);
+    }
+  else
+    {
+      gchar *filename = NULL;
+      int fd;
+
+      /* Cogl can only decode files */
+      fd = g_file_open_tmp ("clutter-image-XXXXXX", &filename, error);
+      if (fd < 0)
+        return FALSE;
+
+      g_close (fd, NULL);
+
+      if (g_file_set_contents (filename, (const gchar *) data, len, error))
+        load->bitmap = cogl_bitmap_new_from_file (filename, error);
+
+      g_unlink (filename);
+      g_free (filename);
+    }
+
+  return load->bitmap != NULL;
+}
+
+static void
+clutter_image_load_thread (GTask        *task,
+                           gpointer      source_object,
+                           gpointer      task_data,
+                           GCancellable *cancellable)
+{
+  ImageLoad *load = task_data;
+  GError *error = NULL;
+  GBytes *bytes = NULL;
+  gboolean res;
+
+  if (load->bytes != NULL)
+    {
+      bytes = g_bytes_ref (load->bytes);
+    }
+  else if (load->stream != NULL)
+    {
+      GOutputStream *output = g_memory_output_stream_new_resizable ();
+
+      if (g_output_stream_splice (output, load->stream,
+                                  G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+                                  cancellable,
+                                  &error) >= 0)
+        bytes = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (output));
+
+      g_object_unref (output);
+    }
+  else if (load->file != NULL)
+    {
+      gchar *contents;
+      gsize len;
+
+      if (g_file_load_contents (load->file, cancellable,
+                                &contents, &len,
+                                NULL,
+                                &error))
+        bytes = g_bytes_new_take (contents, len);
+    }
+  else
+    {
+      GMappedFile *file = g_mapped_file_new (load->filename, FALSE, &error);
+
+      if (file != NULL)
+        {
+          bytes = g_mapped_file_get_bytes (file);
+          g_mapped_file_unref (file);
+        }
+    }
+
+  if (bytes == NULL)
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_bytes_unref (bytes);
+      return;
+    }
+
+  CLUTTER_NOTE (MISC, "Decoding image '%s' (%" G_GSIZE_FORMAT " bytes)",
+                load->uri != NULL ? load->uri
+                                  : load->filename != NULL ? load->filename
+                                                           : load->bytes != NULL ? "<bytes>"
+                                                                                 : "<stream>",
+                g_bytes_get_size (bytes));
+
+  res = image_load_decode (load,
+                           g_bytes_get_data (bytes, NULL),
+                           g_bytes_get_size (bytes),
+                           &error);
+
+  g_bytes_unref (bytes);
+
+  if (res)
+    g_task_return_boolean (task, TRUE);
+  else
+    g_task_return_error (task, error);
+}
+
+static CoglTexture *
+image_load_create_texture (ImageLoad *load)
+{
+  CoglTextureFlags flags = COGL_TEXTURE_NONE;
+
+  if (load->surface != NULL)
+    {
+      return clutter_image_create_texture (cairo_image_surface_get_width (load->surface),
+                                           cairo_image_surface_get_height (load->surface),
+                                           CLUTTER_CAIRO_FORMAT_ARGB32,
+                                           cairo_image_surface_get_stride (load->surface),
+                                           cairo_image_surface_get_data (load->surface));
+    }
+
+  if (load->bitmap != NULL)
+    {
+      CoglTexture *texture;
+
+      texture = _clutter_image_atlas_add_bitmap (load->bitmap);
+      if (texture != NULL)
+        return texture;
+
+      if (cogl_bitmap_get_width (load->bitmap) >= 512 &&
+          cogl_bitmap_get_height (load->bitmap) >= 512)
+        flags |= COGL_TEXTURE_NO_ATLAS;
+
+      return cogl_texture_new_from_bitmap (load->bitmap,
+                                           flags,
+                                           COGL_PIXEL_FORMAT_ANY);
+    }
+
+  return NULL;
+}
+
+/* completes the task of a caller, setting @texture as the image data
+ * unless the image data changed since the task was started
+ */
+static void
+clutter_image_complete_load (GTask        *task,
+                             CoglTexture  *texture,
+                             const GError *error)
+{
+  ClutterImage *image = g_task_get_source_object (task);
+  ClutterImagePrivate *priv = image->priv;
+  guint serial = GPOINTER_TO_UINT (g_task_get_task_data (task));
+
+  if (serial == priv->load_serial)
+    priv->loading = FALSE;
+
+  if (error != NULL)
+    g_task_return_error (task, g_error_copy (error));
+  else if (serial != priv->load_serial ||
+           g_cancellable_is_cancelled (g_task_get_cancellable (task)))
+    g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                             "The image data was replaced");
+  else if (texture == NULL)
+    g_task_return_new_error (task, CLUTTER_IMAGE_ERROR,
+                             CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                             _("Unable to load image data"));
+  else
+    {
+      if (priv->texture != NULL)
+        cogl_object_unref (priv->texture);
+
+      priv->texture = cogl_object_ref (texture);
+
+      clutter_content_invalidate (CLUTTER_CONTENT (image));
+
+      g_task_return_boolean (task, TRUE);
+    }
+
+  g_object_unref (task);
+}
+
+/* the estimated size of the decoded image, in bytes */
+static gsize
+image_load_get_size (ImageLoad *load)
+{
+  if (load->surface != NULL)
+    return (gsize) cairo_image_surface_get_stride (load->surface)
+         * cairo_image_surface_get_height (load->surface);
+
+  if (load->bitmap != NULL)
+    return (gsize) cogl_bitmap_get_rowstride (load->bitmap)
+         * cogl_bitmap_get_height (load->bitmap);
+
+  return 0;
+}
+
+static void
+image_upload_free (gpointer data)
+{
+  ImageUpload *upload = data;
+
+  g_object_unref (upload->result);
+  g_slice_free (ImageUpload, upload);
+}
+
+/* uploads the decoded image on the main thread, and completes the
+ * tasks of the callers
+ */
+static void
+clutter_image_upload (gpointer data)
+{
+  ImageUpload *upload = data;
+  ImageLoad *load = g_task_get_task_data (G_TASK (upload->result));
+  CoglTexture *texture = NULL;
+  GError *error = NULL;
+
+  if (load->uri != NULL)
+    {
+      GList *waiters, *l;
+
+      if (g_task_propagate_boolean (G_TASK (upload->result), &error))
+        texture = image_load_create_texture (load);
+
+      waiters = _clutter_image_cache_complete (load->uri,
+                                               load->width,
+                                               load->height,
+                                               texture);
+
+      for (l = waiters; l != NULL; l = l->next)
+        clutter_image_complete_load (l->data, texture, error);
+
+      g_list_free (waiters);
+    }
+  else
+    {
+      GTask *task = upload->task;
+      ClutterImage *image = g_task_get_source_object (task);
+
+      /* the texture is not needed if the image data changed */
+      if (g_task_propagate_boolean (G_TASK (upload->result), &error) &&
+          load->serial == image->priv->load_serial)
+        texture = image_load_create_texture (load);
+
+      clutter_image_complete_load (task, texture, error);
+    }
+
+  if (texture != NULL)
+    cogl_object_unref (texture);
+
+  g_clear_error (&error);
+}
+
+/* queues the upload of the decoded image, so that the uploads of many
+ * images loaded at the same time are spread over several frames
+ */
+static void
+clutter_image_load_done (GObject      *gobject,
+                         GAsyncResult *result,
+                         gpointer      user_data)
+{
+  ImageLoad *load = g_task_get_task_data (G_TASK (result));
+  ImageUpload *upload;
+
+  upload = g_slice_new (ImageUpload);
+  upload->result = g_object_ref (result);
+  upload->task = user_data;
+
+  _clutter_upload_queue_push (CLUTTER_CONTENT (gobject),
+                              image_load_get_size (load),
+                              clutter_image_upload,
+                              upload,
+                              image_upload_free);
+}
+
+static GTask *
+clutter_image_create_load_task (ClutterImage        *image,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GTask *task;
+  guint serial;
+
+  serial = ++image->priv->load_serial;
+  g_clear_pointer (&image->priv->uri, g_free);
+
+  image->priv->released_width = 0;
+  image->priv->released_height = 0;
+  image->priv->released = FALSE;
+  image->priv->loading = TRUE;
+
+  task = g_task_new (image, cancellable, callback, user_data);
+  g_task_set_source_tag (task, clutter_image_load_async);
+  g_task_set_task_data (task, GUINT_TO_POINTER (serial), NULL);
+
+  return task;
+}
+
+static void
+clutter_image_load_async (ClutterImage        *image,
+                          ImageLoad           *load,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+  GTask *task, *decode_task;
+
+  task = clutter_image_create_load_task (image, cancellable, callback, user_data);
+  load->serial = image->priv->load_serial;
+
+  decode_task = g_task_new (image, cancellable, clutter_image_load_done, task);
+  g_task_set_task_data (decode_task, load, image_load_free);
+  g_task_run_in_thread (decode_task, clutter_image_load_thread);
+  g_object_unref (decode_task);
+}
+
+/**
+ * clutter_image_load_from_file_async:
+ * @image: a #ClutterImage
+ * @filename: the path of an image file
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): the function to call when the image is loaded
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronously loads the image file at @filename, and sets it as the
+ * image data of @image.
+ *
+ * The file is read and decoded on a worker thread, and the image data
+ * is uploaded on the main thread once it is ready; the current image
+ * data of @image is displayed in the meantime.
+ *
+ * If @width or @height are positive, the image is scaled down to fit
+ * inside that size while being decoded, preserving its aspect ratio;
+ * this is only supported for PNG images, and the images in the other
+ * formats are loaded at their own size.
+ *
+ * Setting the image data of @image again before the load is done
+ * causes it to fail with %G_IO_ERROR_CANCELLED.
+ *
+ * Call clutter_image_load_finish() from within @callback to retrieve
+ * the result of the operation.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_load_from_file_async (ClutterImage        *image,
+                                    const gchar         *filename,
+                                    int                  width,
+                                    int                  height,
+                                    GCancellable        *cancellable,
+                                    GAsyncReadyCallback  callback,
+                                    gpointer             user_data)
+{
+  ImageLoad *load;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (filename != NULL);
+
+  load = g_slice_new0 (ImageLoad);
+  load->filename = g_strdup (filename);
+  load->width = width;
+  load->height = height;
+
+  clutter_image_load_async (image, load, cancellable, callback, user_data);
+}
+
+/**
+ * clutter_image_load_from_stream_async:
+ * @image: a #ClutterImage
+ * @stream: a #GInputStream containing an image file
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): the function to call when the image is loaded
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronously loads an image file from @stream, and sets it as the
+ * image data of @image.
+ *
+ * The @stream is read from a worker thread, and must not be used until
+ * the operation is done.
+ *
+ * See clutter_image_load_from_file_async() for more details.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_load_from_stream_async (ClutterImage        *image,
+                                      GInputStream        *stream,
+                                      int                  width,
+                                      int                  height,
+                                      GCancellable        *cancellable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+  ImageLoad *load;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+
+  load = g_slice_new0 (ImageLoad);
+  load->stream = g_object_ref (stream);
+  load->width = width;
+  load->height = height;
+
+  clutter_image_load_async (image, load, cancellable, callback, user_data);
+}
+
+/**
+ * clutter_image_load_from_bytes_async:
+ * @image: a #ClutterImage
+ * @data: a #GBytes containing an image file
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): the function to call when the image is loaded
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronously decodes the image file contained in @data, and sets
+ * it as the image data of @image.
+ *
+ * Unlike clutter_image_load_from_stream_async(), @data is decoded in
+ * place, without being copied; this allows decoding image files that
+ * are mapped in memory, like the assets returned by
+ * clutter_android_application_get_asset_bytes(). A reference on @data
+ * is held until the image is decoded.
+ *
+ * See clutter_image_load_from_file_async() for more details.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_load_from_bytes_async (ClutterImage        *image,
+                                     GBytes              *data,
+                                     int                  width,
+                                     int                  height,
+                                     GCancellable        *cancellable,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data)
+{
+  ImageLoad *load;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (data != NULL);
+
+  load = g_slice_new0 (ImageLoad);
+  load->bytes = g_bytes_ref (data);
+  load->width = width;
+  load->height = height;
+
+  clutter_image_load_async (image, load, cancellable, callback, user_data);
+}
+
+/**
+ * clutter_image_load_from_uri_async:
+ * @image: a #ClutterImage
+ * @uri: the URI of an image file
+ * @width: the maximum width of the image, or -1
+ * @height: the maximum height of the image, or -1
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): the function to call when the image is loaded
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronously loads the image file at @uri, and sets it as the
+ * image data of @image, like clutter_image_load_from_file_async().
+ *
+ * The images loaded from the same @uri at the same size share their
+ * texture: the file is only decoded once, even if multiple images
+ * start loading it at the same time, and stays in memory as long as
+ * an image uses it. The recently used textures are also kept in a
+ * cache after they stop being used, up to the size set using the
+ * CLUTTER_IMAGE_CACHE environment variable; if the texture is in the
+ * cache, the image data of @image is set before this function returns.
+ *
+ * The contents of the file at @uri are not expected to change.
+ *
+ * Call clutter_image_load_finish() from within @callback to retrieve
+ * the result of the operation.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_load_from_uri_async (ClutterImage        *image,
+                                   const gchar         *uri,
+                                   int                  width,
+                                   int                  height,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data)
+{
+  CoglTexture *texture;
+  GTask *task;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (uri != NULL);
+
+  width = MAX (width, -1);
+  height = MAX (height, -1);
+
+  task = clutter_image_create_load_task (image, cancellable, callback, user_data);
+
+  image->priv->uri = g_strdup (uri);
+  image->priv->uri_width = width;
+  image->priv->uri_height = height;
+
+  texture = _clutter_image_cache_lookup (uri, width, height);
+  if (texture != NULL)
+    {
+      clutter_image_complete_load (task, texture, NULL);
+      cogl_object_unref (texture);
+      return;
+    }
+
+  /* the image is already being decoded for another caller */
+  if (_clutter_image_cache_queue (uri, width, height, task))
+    {
+      ImageLoad *load;
+      GTask *decode_task;
+      GFile *file;
+
+      file = g_file_new_for_uri (uri);
+
+      load = g_slice_new0 (ImageLoad);
+      load->uri = g_strdup (uri);
+      load->width = width;
+      load->height = height;
+
+      load->filename = g_file_get_path (file);
+      if (load->filename == NULL)
+        load->file = g_object_ref (file);
+
+      g_object_unref (file);
+
+      /* the decoding is shared, so it cannot be cancelled by a caller;
+       * the first caller is only used to prioritize the upload
+       */
+      decode_task = g_task_new (image, NULL, clutter_image_load_done, NULL);
+      g_task_set_task_data (decode_task, load, image_load_free);
+      g_task_run_in_thread (decode_task, clutter_image_load_thread);
+      g_object_unref (decode_task);
+    }
+}
+
+/**
+ * clutter_image_load_finish:
+ * @image: a #ClutterImage
+ * @result: the #GAsyncResult passed to the callback
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes an operation started using clutter_image_load_from_file_async(),
+ * clutter_image_load_from_stream_async(),
+ * clutter_image_load_from_bytes_async() or
+ * clutter_image_load_from_uri_async().
+ *
+ * Return value: %TRUE if the image data was successfully loaded,
+ *   and %FALSE otherwise
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_image_load_finish (ClutterImage  *image,
+                           GAsyncResult  *result,
+                           GError       **error)
+{
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, image), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == clutter_image_load_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * clutter_image_set_placeholder_color:
+ * @image: a #ClutterImage
+ * @color: (allow-none): the placeholder color, or %NULL
+ *
+ * Sets the color painted in place of @image while its image data is
+ * being loaded asynchronously, for instance using
+ * clutter_image_load_from_file_async(), if @image has no image data
+ * yet.
+ *
+ * The decoded images are uploaded to the GPU over several frames when
+ * many of them are ready at the same time, so the placeholder color
+ * can be visible for a few frames even after the image is decoded.
+ *
+ * The default placeholder color is transparent, which paints nothing.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_set_placeholder_color (ClutterImage       *image,
+                                     const ClutterColor *color)
+{
+  ClutterImagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+
+  priv = image->priv;
+
+  if (color != NULL)
+    priv->placeholder_color = *color;
+  else
+    memset (&priv->placeholder_color, 0, sizeof (ClutterColor));
+
+  if (priv->texture == NULL && priv->loading)
+    _clutter_content_queue_redraw (CLUTTER_CONTENT (image));
+}
+
+/**
+ * clutter_image_get_placeholder_color:
+ * @image: a #ClutterImage
+ * @color: (out caller-allocates): return location for the placeholder color
+ *
+ * Retrieves the color set using clutter_image_set_placeholder_color().
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_get_placeholder_color (ClutterImage *image,
+                                     ClutterColor *color)
+{
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (color != NULL);
+
+  *color = image->priv->placeholder_color;
+}
+
+/**
+ * clutter_image_set_downscaling:
+ * @image: a #ClutterImage
+ * @downscaling: whether to downscale the image data
+ *
+ * Sets whether @image should keep a downscaled copy of its image data,
+ * matching the largest size the image was displayed at, and paint it
+ * in place of the image data.
+ *
+ * Thumbnails and other images displayed much smaller than their size
+ * otherwise sample the full resolution image data each frame, which
+ * wastes memory bandwidth and aliases with the linear filter. The
+ * downscaled copy is generated on the GPU when the image is painted,
+ * from the transformed size of the actors displaying it, and is only
+ * generated again when the image is displayed larger than the copy;
+ * its size is the size of the image data divided by a power of two.
+ *
+ * The copy does not use an atlas, so that the mipmaps required by the
+ * %CLUTTER_SCALING_FILTER_TRILINEAR minification filter are generated
+ * automatically.
+ *
+ * Repeated image data, see clutter_actor_set_content_repeat(), is
+ * always painted from the full resolution image data.
+ *
+ * Downscaling is disabled by default.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_set_downscaling (ClutterImage *image,
+                               gboolean      downscaling)
+{
+  ClutterImagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+
+  priv = image->priv;
+
+  downscaling = !!downscaling;
+  if (priv->downscaling == downscaling)
+    return;
+
+  priv->downscaling = downscaling;
+
+  if (!priv->downscaling)
+    clutter_image_invalidate (CLUTTER_CONTENT (image));
+
+  if (priv->texture != NULL)
+    _clutter_content_queue_redraw (CLUTTER_CONTENT (image));
+}
+
+/**
+ * clutter_image_get_downscaling:
+ * @image: a #ClutterImage
+ *
+ * Retrieves the value set using clutter_image_set_downscaling().
+ *
+ * Return value: %TRUE if the image data is downscaled
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_image_get_downscaling (ClutterImage *image)
+{
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+
+  return image->priv->downscaling;
+}
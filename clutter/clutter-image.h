@@ -30,6 +30,7 @@
 #endif
 
 #include <cogl/cogl.h>
+#include <gio/gio.h>
 #include <clutter/clutter-types.h>
 
 G_BEGIN_DECLS
@@ -58,13 +59,17 @@ typedef struct _ClutterImageClass      ClutterImageClass;
  * ClutterImageError:
  * @CLUTTER_IMAGE_ERROR_INVALID_DATA: Invalid data passed to the
  *   clutter_image_set_data() function.
+ * @CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT: The format of the compressed
+ *   data passed to clutter_image_set_compressed_data() is not supported.
+ *   Since: 1.26
  *
  * Error enumeration for #ClutterImage.
  *
  * Since: 1.10
  */
 typedef enum {
-  CLUTTER_IMAGE_ERROR_INVALID_DATA
+  CLUTTER_IMAGE_ERROR_INVALID_DATA,
+  CLUTTER_IMAGE_ERROR_UNSUPPORTED_FORMAT
 } ClutterImageError;
 
 /**
@@ -131,6 +136,62 @@ gboolean                clutter_image_set_bytes         (ClutterImage
                                                          guint                         row_stride,
                                                          GError                      **error);
 
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_image_set_compressed_data       (ClutterImage         *image,
+                                                                 const guint8         *data,
+                                                                 gsize                 size,
+                                                                 GError              **error);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_load_from_file_async      (ClutterImage         *image,
+                                                                 const gchar          *filename,
+                                                                 int                   width,
+                                                                 int                   height,
+                                                                 GCancellable         *cancellable,
+                                                                 GAsyncReadyCallback   callback,
+                                                                 gpointer              user_data);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_load_from_stream_async    (ClutterImage         *image,
+                                                                 GInputStream         *stream,
+                                                                 int                   width,
+                                                                 int                   height,
+                                                                 GCancellable         *cancellable,
+                                                                 GAsyncReadyCallback   callback,
+                                                                 gpointer              user_data);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_load_from_bytes_async     (ClutterImage         *image,
+                                                                 GBytes               *data,
+                                                                 int                   width,
+                                                                 int                   height,
+                                                                 GCancellable         *cancellable,
+                                                                 GAsyncReadyCallback   callback,
+                                                                 gpointer              user_data);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_load_from_uri_async       (ClutterImage         *image,
+                                                                 const gchar          *uri,
+                                                                 int                   width,
+                                                                 int                   height,
+                                                                 GCancellable         *cancellable,
+                                                                 GAsyncReadyCallback   callback,
+                                                                 gpointer              user_data);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_image_load_finish               (ClutterImage         *image,
+                                                                 GAsyncResult         *result,
+                                                                 GError              **error);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_set_placeholder_color     (ClutterImage         *image,
+                                                                 const ClutterColor   *color);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_get_placeholder_color     (ClutterImage         *image,
+                                                                 ClutterColor         *color);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_set_downscaling           (ClutterImage         *image,
+                                                                 gboolean              downscaling);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_image_get_downscaling           (ClutterImage         *image);
+
 #if defined(COGL_ENABLE_EXPERIMENTAL_API) && defined(CLUTTER_ENABLE_EXPERIMENTAL_API)
 CLUTTER_AVAILABLE_IN_1_10
 CoglTexture *           clutter_image_get_texture       (ClutterImage                 *image);
@@ -47,6 +47,7 @@
 #include "clutter-stage-private.h"
 
 #include <math.h>
+#include <string.h>
 
 enum
 {
@@ -426,34 +427,90 @@ clutter_input_device_init (ClutterInputDevice *self)
   self->current_button_number = self->previous_button_number = -1;
   self->current_state = self->previous_state = 0;
 
-  self->touch_sequences_info =
-    g_hash_table_new_full (NULL, NULL,
-                           NULL, _clutter_input_device_free_touch_info);
   self->inv_touch_sequence_actors = g_hash_table_new (NULL, NULL);
 }
 
+/* the index of the slot of @sequence, or -1 if it does not have one */
+static inline int
+_clutter_input_device_get_touch_slot (ClutterEventSequence *sequence)
+{
+  guintptr slot = GPOINTER_TO_SIZE (sequence) - 1;
+
+  if (slot < CLUTTER_INPUT_DEVICE_N_TOUCH_SLOTS)
+    return slot;
+
+  return -1;
+}
+
+static ClutterTouchInfo *
+_clutter_input_device_lookup_touch_info (ClutterInputDevice   *device,
+                                         ClutterEventSequence *sequence)
+{
+  int slot = _clutter_input_device_get_touch_slot (sequence);
+
+  if (slot >= 0)
+    {
+      ClutterTouchInfo *info = &device->touch_slots[slot];
+
+      return info->sequence != NULL ? info : NULL;
+    }
+
+  if (device->touch_sequences_info == NULL)
+    return NULL;
+
+  return g_hash_table_lookup (device->touch_sequences_info, sequence);
+}
+
 static ClutterTouchInfo *
 _clutter_input_device_ensure_touch_info (ClutterInputDevice *device,
                                          ClutterEventSequence *sequence,
                                          ClutterStage *stage)
 {
   ClutterTouchInfo *info;
+  int slot;
 
-  info = g_hash_table_lookup (device->touch_sequences_info, sequence);
+  info = _clutter_input_device_lookup_touch_info (device, sequence);
 
   if (info == NULL)
     {
-      info = g_slice_new0 (ClutterTouchInfo);
+      slot = _clutter_input_device_get_touch_slot (sequence);
+
+      if (slot >= 0)
+        info = &device->touch_slots[slot];
+      else
+        {
+          if (device->touch_sequences_info == NULL)
+            device->touch_sequences_info =
+              g_hash_table_new_full (NULL, NULL,
+                                     NULL, _clutter_input_device_free_touch_info);
+
+          info = g_slice_new0 (ClutterTouchInfo);
+          g_hash_table_insert (device->touch_sequences_info, sequence, info);
+        }
+
       info->sequence = sequence;
-      g_hash_table_insert (device->touch_sequences_info, sequence, info);
 
-      if (g_hash_table_size (device->touch_sequences_info) == 1)
+      if (++device->n_touches == 1)
         _clutter_input_device_set_stage (device, stage);
     }
 
   return info;
 }
 
+static void
+_clutter_input_device_remove_touch_info (ClutterInputDevice   *device,
+                                         ClutterEventSequence *sequence)
+{
+  int slot = _clutter_input_device_get_touch_slot (sequence);
+
+  if (slot >= 0)
+    memset (&device->touch_slots[slot], 0, sizeof (ClutterTouchInfo));
+  else
+    g_hash_table_remove (device->touch_sequences_info, sequence);
+
+  device->n_touches -= 1;
+}
+
 /*< private >
  * clutter_input_device_set_coords:
  * @device: a #ClutterInputDevice
@@ -593,7 +650,7 @@ _clutter_input_device_get_actor (ClutterInputDevice   *device,
   if (sequence == NULL)
     return device->cursor_actor;
 
-  info = g_hash_table_lookup (device->touch_sequences_info, sequence);
+  info = _clutter_input_device_lookup_touch_info (device, sequence);
 
   return info->actor;
 }
@@ -650,7 +707,7 @@ _clutter_input_device_unassociate_actor (ClutterInputDevice   *device,
       for (l = sequences; l != NULL; l = l->next)
         {
           ClutterTouchInfo *info =
-            g_hash_table_lookup (device->touch_sequences_info, l->data);
+            _clutter_input_device_lookup_touch_info (device, l->data);
 
           if (info)
             info->actor = NULL;
@@ -899,7 +956,7 @@ clutter_input_device_get_coords (ClutterInputDevice   *device,
   else
     {
       ClutterTouchInfo *info =
-        g_hash_table_lookup (device->touch_sequences_info, sequence);
+        _clutter_input_device_lookup_touch_info (device, sequence);
 
       if (info == NULL)
         return FALSE;
@@ -1581,9 +1638,12 @@ _clutter_input_device_remove_event_sequence (ClutterInputDevice *device,
                                              ClutterEvent       *event)
 {
   ClutterEventSequence *sequence = clutter_event_get_event_sequence (event);
-  ClutterTouchInfo *info =
-    g_hash_table_lookup (device->touch_sequences_info, sequence);
+  ClutterTouchInfo *info;
+
+  if (sequence == NULL)
+    return;
 
+  info = _clutter_input_device_lookup_touch_info (device, sequence);
   if (info == NULL)
     return;
 
@@ -1599,7 +1659,7 @@ _clutter_input_device_remove_event_sequence (ClutterInputDevice *device,
       _clutter_input_device_set_actor (device, sequence, NULL, TRUE);
     }
 
-  g_hash_table_remove (device->touch_sequences_info, sequence);
+  _clutter_input_device_remove_touch_info (device, sequence);
 }
 
 /**
@@ -0,0 +1,279 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ *
+ * ClutterInputPredictor: extrapolates the position of pointers and
+ * touch points at the time the next frame is presented.
+ *
+ * Each stage keeps the recent samples of every pressed pointer and
+ * touch point, including the samples coalesced into the motion events;
+ * a straight line is fitted through the samples of the last
+ * PREDICTION_WINDOW milliseconds, and extended up to the expected
+ * presentation time of the frame that is going to handle the event.
+ * The result is stored inside the event, and retrieved with
+ * clutter_event_get_predicted_coords().
+ *
+ * Fitting a line, instead of using the last two samples, smooths out
+ * the jitter of the touch screens; the prediction is limited to
+ * PREDICTION_MAX_HORIZON, since the error grows quickly past a couple
+ * of frames.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-input-predictor.h"
+
+#include "clutter-debug.h"
+#include "clutter-event-private.h"
+#include "clutter-private.h"
+
+/* the samples used for fitting the motion, in milliseconds */
+#define PREDICTION_WINDOW       60
+
+/* the longest extrapolation, in milliseconds */
+#define PREDICTION_MAX_HORIZON  32
+
+#define MAX_TRACK_SAMPLES       32
+
+typedef struct _InputTrack
+{
+  /* oldest first */
+  ClutterEventSample samples[MAX_TRACK_SAMPLES];
+  guint n_samples;
+} InputTrack;
+
+struct _ClutterInputPredictor
+{
+  /* ClutterEventSequence or ClutterInputDevice → InputTrack */
+  GHashTable *tracks;
+};
+
+ClutterInputPredictor *
+_clutter_input_predictor_new (void)
+{
+  ClutterInputPredictor *predictor = g_slice_new (ClutterInputPredictor);
+
+  predictor->tracks = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
+  return predictor;
+}
+
+void
+_clutter_input_predictor_free (ClutterInputPredictor *predictor)
+{
+  if (predictor == NULL)
+    return;
+
+  g_hash_table_unref (predictor->tracks);
+
+  g_slice_free (ClutterInputPredictor, predictor);
+}
+
+static gpointer
+get_track_key (const ClutterEvent *event)
+{
+  ClutterEventSequence *sequence = clutter_event_get_event_sequence (event);
+
+  if (sequence != NULL)
+    return sequence;
+
+  return clutter_event_get_device (event);
+}
+
+static void
+input_track_add_sample (InputTrack *track,
+                        guint32     time_,
+                        gfloat      x,
+                        gfloat      y)
+{
+  ClutterEventSample *sample;
+
+  /* the samples already coalesced into a previous event */
+  if (track->n_samples > 0 &&
+      time_ <= track->samples[track->n_samples - 1].time)
+    return;
+
+  if (track->n_samples == MAX_TRACK_SAMPLES)
+    {
+      memmove (track->samples, track->samples + 1,
+               sizeof (ClutterEventSample) * (MAX_TRACK_SAMPLES - 1));
+      track->n_samples -= 1;
+    }
+
+  sample = &track->samples[track->n_samples++];
+  sample->time = time_;
+  sample->x = x;
+  sample->y = y;
+}
+
+/* least squares fit of the velocity, in pixels per millisecond */
+static gboolean
+input_track_get_velocity (const InputTrack *track,
+                          gfloat           *velocity_x,
+                          gfloat           *velocity_y)
+{
+  const ClutterEventSample *last;
+  gdouble mean_t = 0, mean_x = 0, mean_y = 0;
+  gdouble stt = 0, stx = 0, sty = 0;
+  guint i, first, n;
+
+  if (track->n_samples < 2)
+    return FALSE;
+
+  last = &track->samples[track->n_samples - 1];
+
+  for (first = track->n_samples - 1; first > 0; first--)
+    {
+      if (last->time - track->samples[first - 1].time > PREDICTION_WINDOW)
+        break;
+    }
+
+  n = track->n_samples - first;
+  if (n < 2)
+    return FALSE;
+
+  /* relative to the last sample, to keep the sums small */
+  for (i = first; i < track->n_samples; i++)
+    {
+      mean_t += (gdouble) track->samples[i].time - last->time;
+      mean_x += track->samples[i].x;
+      mean_y += track->samples[i].y;
+    }
+
+  mean_t /= n;
+  mean_x /= n;
+  mean_y /= n;
+
+  for (i = first; i < track->n_samples; i++)
+    {
+      gdouble dt = (gdouble) track->samples[i].time - last->time - mean_t;
+
+      stt += dt * dt;
+      stx += dt * (track->samples[i].x - mean_x);
+      sty += dt * (track->samples[i].y - mean_y);
+    }
+
+  if (stt < 1.0)
+    return FALSE;
+
+  *velocity_x = stx / stt;
+  *velocity_y = sty / stt;
+
+  return TRUE;
+}
+
+static void
+input_track_add_event (InputTrack         *track,
+                       const ClutterEvent *event)
+{
+  const ClutterEventSample *history;
+  guint i, n_samples;
+  gfloat x, y;
+
+  history = clutter_event_get_history (event, &n_samples);
+
+  for (i = 0; i < n_samples; i++)
+    input_track_add_sample (track, history[i].time, history[i].x, history[i].y);
+
+  clutter_event_get_coords (event, &x, &y);
+  input_track_add_sample (track, clutter_event_get_time (event), x, y);
+}
+
+/*< private >
+ * _clutter_input_predictor_process_event:
+ * @predictor: a #ClutterInputPredictor
+ * @event: the #ClutterEvent about to be processed
+ * @presentation_time: the expected presentation time of the next frame,
+ *   in microseconds on the g_get_monotonic_time() clock, or 0 if unknown
+ *
+ * Tracks the pointers and touch points of @event and, for motion and
+ * touch update events, stores the predicted position into @event.
+ */
+void
+_clutter_input_predictor_process_event (ClutterInputPredictor *predictor,
+                                        ClutterEvent          *event,
+                                        gint64                 presentation_time)
+{
+  InputTrack *track;
+  gpointer key;
+  gint64 horizon;
+  gfloat velocity_x, velocity_y;
+  gfloat x, y;
+
+  key = get_track_key (event);
+  if (key == NULL)
+    return;
+
+  switch (clutter_event_type (event))
+    {
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_TOUCH_BEGIN:
+      track = g_new0 (InputTrack, 1);
+      input_track_add_event (track, event);
+      g_hash_table_replace (predictor->tracks, key, track);
+      return;
+
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+      g_hash_table_remove (predictor->tracks, key);
+      return;
+
+    case CLUTTER_MOTION:
+    case CLUTTER_TOUCH_UPDATE:
+      break;
+
+    default:
+      return;
+    }
+
+  /* we only predict the motion of pressed pointers */
+  track = g_hash_table_lookup (predictor->tracks, key);
+  if (track == NULL)
+    return;
+
+  input_track_add_event (track, event);
+
+  if (!input_track_get_velocity (track, &velocity_x, &velocity_y))
+    return;
+
+  if (presentation_time > 0)
+    horizon = (presentation_time - g_get_monotonic_time ()) / 1000;
+  else
+    horizon = 1000 / 60;
+
+  horizon = CLAMP (horizon, 0, PREDICTION_MAX_HORIZON);
+
+  clutter_event_get_coords (event, &x, &y);
+  x += velocity_x * horizon;
+  y += velocity_y * horizon;
+
+  CLUTTER_NOTE (EVENT, "Predicted position %.2f, %.2f in %d ms",
+                x, y, (int) horizon);
+
+  _clutter_event_set_predicted_coords (event, x, y);
+}
@@ -0,0 +1,40 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+ */
+
+#ifndef __CLUTTER_INPUT_PREDICTOR_H__
+#define __CLUTTER_INPUT_PREDICTOR_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterInputPredictor   ClutterInputPredictor;
+
+ClutterInputPredictor * _clutter_input_predictor_new            (void);
+void                    _clutter_input_predictor_free           (ClutterInputPredictor *predictor);
+void                    _clutter_input_predictor_process_event  (ClutterInputPredictor *predictor,
+                                                                 ClutterEvent          *event,
+                                                                 gint64                 presentation_time);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_INPUT_PREDICTOR_H__ */
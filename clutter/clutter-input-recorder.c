@@ -0,0 +1,620 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterInputRecorder: records the input events of a session, and
+ * replays them deterministically.
+ *
+ * When the CLUTTER_RECORD_EVENTS environment variable is set, the input
+ * events pushed by the backends are written to a file, together with
+ * the time of each iteration of the master clock. When the
+ * CLUTTER_REPLAY_EVENTS environment variable is set, the events of such
+ * a file are queued on their stages at the start of the iteration that
+ * followed them in the recording, and the timelines are advanced using
+ * the recorded time of the iteration instead of the current time; the
+ * input events from the windowing system are dropped until the end of
+ * the replay. Replaying the same file on different builds delivers the
+ * same events in the same frames, so the frame timings can be compared.
+ *
+ * The file starts with a magic string, followed by a sequence of
+ * records, in little endian order:
+ *
+ *   frame: kind (u8), time since the previous frame, in usecs (u32)
+ *   event: kind (u8), type (u8), index of the stage (u8),
+ *          device type (u8), device id (i32), time since the first
+ *          event, in msecs (u32), modifier state (u32), x (f32),
+ *          y (f32), followed by the fields of the event type
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "clutter-input-recorder.h"
+
+#include "clutter-debug.h"
+#include "clutter-device-manager.h"
+#include "clutter-event-private.h"
+#include "clutter-private.h"
+#include "clutter-stage-manager.h"
+
+#define RECORDING_MAGIC         "CLUTREC1"
+#define RECORDING_MAGIC_LEN     8
+
+enum {
+  RECORD_FRAME = 1,
+  RECORD_EVENT = 2
+};
+
+typedef enum {
+  RECORDER_UNINITIALIZED,
+  RECORDER_IDLE,
+  RECORDER_RECORDING,
+  RECORDER_REPLAYING
+} RecorderState;
+
+static RecorderState recorder_state = RECORDER_UNINITIALIZED;
+
+/* recording */
+static FILE *record_file = NULL;
+static gint64 record_last_frame = -1;
+static gboolean record_has_time_base = FALSE;
+static guint32 record_time_base = 0;
+
+/* replaying */
+static gchar *replay_data = NULL;
+static gsize replay_size = 0;
+static gsize replay_offset = 0;
+static gboolean replay_started = FALSE;
+static gint64 replay_frame_time = 0;
+static guint32 replay_time_base = 0;
+static guint replay_n_frames = 0;
+
+static gboolean
+recorder_open_replay (const gchar *path)
+{
+  GError *error = NULL;
+
+  if (!g_file_get_contents (path, &replay_data, &replay_size, &error))
+    {
+      g_warning ("Unable to read the input recording '%s': %s",
+                 path, error->message);
+      g_error_free (error);
+      return FALSE;
+    }
+
+  if (replay_size < RECORDING_MAGIC_LEN ||
+      memcmp (replay_data, RECORDING_MAGIC, RECORDING_MAGIC_LEN) != 0)
+    {
+      g_warning ("The file '%s' is not an input recording", path);
+      g_clear_pointer (&replay_data, g_free);
+      return FALSE;
+    }
+
+  replay_offset = RECORDING_MAGIC_LEN;
+
+  CLUTTER_NOTE (EVENT, "Replaying the input events from '%s'", path);
+
+  return TRUE;
+}
+
+static gboolean
+recorder_open_record (const gchar *path)
+{
+  record_file = g_fopen (path, "wb");
+  if (record_file == NULL)
+    {
+      g_warning ("Unable to create the input recording '%s'", path);
+      return FALSE;
+    }
+
+  fwrite (RECORDING_MAGIC, 1, RECORDING_MAGIC_LEN, record_file);
+
+  CLUTTER_NOTE (EVENT, "Recording the input events into '%s'", path);
+
+  return TRUE;
+}
+
+static void
+recorder_ensure_initialized (void)
+{
+  const gchar *path;
+
+  if (G_LIKELY (recorder_state != RECORDER_UNINITIALIZED))
+    return;
+
+  recorder_state = RECORDER_IDLE;
+
+  path = _clutter_get_replay_events_path ();
+  if (path != NULL && recorder_open_replay (path))
+    {
+      recorder_state = RECORDER_REPLAYING;
+      return;
+    }
+
+  path = _clutter_get_record_events_path ();
+  if (path != NULL && recorder_open_record (path))
+    recorder_state = RECORDER_RECORDING;
+}
+
+static void
+recorder_finish_replay (void)
+{
+  CLUTTER_NOTE (EVENT, "Input replay finished after %u frames",
+                replay_n_frames);
+
+  g_clear_pointer (&replay_data, g_free);
+  replay_size = replay_offset = 0;
+
+  recorder_state = RECORDER_IDLE;
+}
+
+/* only the events coming from the input devices are recorded, and
+ * dropped while replaying
+ */
+static gboolean
+is_input_event (const ClutterEvent *event)
+{
+  if (event->any.flags & CLUTTER_EVENT_FLAG_SYNTHETIC)
+    return FALSE;
+
+  switch (event->type)
+    {
+    case CLUTTER_MOTION:
+    case CLUTTER_ENTER:
+    case CLUTTER_LEAVE:
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_KEY_PRESS:
+    case CLUTTER_KEY_RELEASE:
+    case CLUTTER_SCROLL:
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+static void
+write_u8 (guint8 value)
+{
+  fwrite (&value, 1, 1, record_file);
+}
+
+static void
+write_u16 (guint16 value)
+{
+  value = GUINT16_TO_LE (value);
+  fwrite (&value, 2, 1, record_file);
+}
+
+static void
+write_u32 (guint32 value)
+{
+  value = GUINT32_TO_LE (value);
+  fwrite (&value, 4, 1, record_file);
+}
+
+static void
+write_float (gfloat value)
+{
+  guint32 bits;
+
+  memcpy (&bits, &value, 4);
+  write_u32 (bits);
+}
+
+static gboolean
+read_u8 (guint8 *value)
+{
+  if (replay_offset + 1 > replay_size)
+    return FALSE;
+
+  *value = (guint8) replay_data[replay_offset];
+  replay_offset += 1;
+
+  return TRUE;
+}
+
+static gboolean
+read_u16 (guint16 *value)
+{
+  if (replay_offset + 2 > replay_size)
+    return FALSE;
+
+  memcpy (value, replay_data + replay_offset, 2);
+  *value = GUINT16_FROM_LE (*value);
+  replay_offset += 2;
+
+  return TRUE;
+}
+
+static gboolean
+read_u32 (guint32 *value)
+{
+  if (replay_offset + 4 > replay_size)
+    return FALSE;
+
+  memcpy (value, replay_data + replay_offset, 4);
+  *value = GUINT32_FROM_LE (*value);
+  replay_offset += 4;
+
+  return TRUE;
+}
+
+static gboolean
+read_float (gfloat *value)
+{
+  guint32 bits;
+
+  if (!read_u32 (&bits))
+    return FALSE;
+
+  memcpy (value, &bits, 4);
+
+  return TRUE;
+}
+
+static gint
+get_stage_index (ClutterStage *stage)
+{
+  ClutterStageManager *manager = clutter_stage_manager_get_default ();
+
+  return g_slist_index ((GSList *) clutter_stage_manager_peek_stages (manager),
+                        stage);
+}
+
+static ClutterStage *
+get_stage_at_index (guint index_)
+{
+  ClutterStageManager *manager = clutter_stage_manager_get_default ();
+
+  return g_slist_nth_data ((GSList *) clutter_stage_manager_peek_stages (manager),
+                           index_);
+}
+
+static void
+record_event (const ClutterEvent *event)
+{
+  ClutterInputDevice *device = clutter_event_get_device (event);
+  gint stage_index;
+  gfloat x, y;
+  guint32 time_;
+
+  stage_index = get_stage_index (event->any.stage);
+  if (stage_index < 0 || stage_index > G_MAXUINT8)
+    return;
+
+  time_ = clutter_event_get_time (event);
+  if (!record_has_time_base)
+    {
+      record_time_base = time_;
+      record_has_time_base = TRUE;
+    }
+
+  clutter_event_get_coords (event, &x, &y);
+
+  write_u8 (RECORD_EVENT);
+  write_u8 (event->type);
+  write_u8 (stage_index);
+  write_u8 (device != NULL ? clutter_input_device_get_device_type (device)
+                           : CLUTTER_POINTER_DEVICE);
+  write_u32 (device != NULL ? clutter_input_device_get_device_id (device) : -1);
+  write_u32 (time_ - record_time_base);
+  write_u32 (clutter_event_get_state (event));
+  write_float (x);
+  write_float (y);
+
+  switch (event->type)
+    {
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+      write_u32 (event->button.button);
+      write_u8 (event->button.click_count);
+      break;
+
+    case CLUTTER_KEY_PRESS:
+    case CLUTTER_KEY_RELEASE:
+      write_u32 (event->key.keyval);
+      write_u16 (event->key.hardware_keycode);
+      write_u32 (event->key.unicode_value);
+      break;
+
+    case CLUTTER_SCROLL:
+      {
+        gdouble dx = 0, dy = 0;
+
+        if (event->scroll.direction == CLUTTER_SCROLL_SMOOTH)
+          clutter_event_get_scroll_delta (event, &dx, &dy);
+
+        write_u8 (event->scroll.direction);
+        write_float (dx);
+        write_float (dy);
+      }
+      break;
+
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+      write_u32 (GPOINTER_TO_UINT (event->touch.sequence));
+      break;
+
+    default:
+      break;
+    }
+}
+
+/* reads an event record, without the kind; returns %FALSE if the
+ * recording is truncated, and sets @event to %NULL if the event can
+ * not be replayed, e.g. because its stage does not exist
+ */
+static gboolean
+read_event (ClutterEvent **event)
+{
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+  ClutterInputDevice *device;
+  ClutterStage *stage;
+  guint8 type, stage_index, device_type;
+  guint32 device_id, time_, state;
+  gfloat x, y;
+  ClutterEvent *res;
+
+  *event = NULL;
+
+  if (!read_u8 (&type) ||
+      !read_u8 (&stage_index) ||
+      !read_u8 (&device_type) ||
+      !read_u32 (&device_id) ||
+      !read_u32 (&time_) ||
+      !read_u32 (&state) ||
+      !read_float (&x) ||
+      !read_float (&y))
+    return FALSE;
+
+  res = clutter_event_new (type);
+  clutter_event_set_time (res, replay_time_base + time_);
+  clutter_event_set_state (res, state);
+  clutter_event_set_coords (res, x, y);
+
+  switch (type)
+    {
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+      {
+        guint32 button;
+        guint8 click_count;
+
+        if (!read_u32 (&button) || !read_u8 (&click_count))
+          goto truncated;
+
+        res->button.button = button;
+        res->button.click_count = click_count;
+      }
+      break;
+
+    case CLUTTER_KEY_PRESS:
+    case CLUTTER_KEY_RELEASE:
+      {
+        guint32 keyval, unicode_value;
+        guint16 keycode;
+
+        if (!read_u32 (&keyval) ||
+            !read_u16 (&keycode) ||
+            !read_u32 (&unicode_value))
+          goto truncated;
+
+        res->key.keyval = keyval;
+        res->key.hardware_keycode = keycode;
+        res->key.unicode_value = unicode_value;
+      }
+      break;
+
+    case CLUTTER_SCROLL:
+      {
+        guint8 direction;
+        gfloat dx, dy;
+
+        if (!read_u8 (&direction) || !read_float (&dx) || !read_float (&dy))
+          goto truncated;
+
+        res->scroll.direction = direction;
+        if (direction == CLUTTER_SCROLL_SMOOTH)
+          clutter_event_set_scroll_delta (res, dx, dy);
+      }
+      break;
+
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+      {
+        guint32 sequence;
+
+        if (!read_u32 (&sequence))
+          goto truncated;
+
+        res->touch.sequence = GUINT_TO_POINTER (sequence);
+      }
+      break;
+
+    default:
+      break;
+    }
+
+  stage = get_stage_at_index (stage_index);
+  if (stage == NULL)
+    {
+      clutter_event_free (res);
+      return TRUE;
+    }
+
+  clutter_event_set_stage (res, stage);
+
+  device = clutter_device_manager_get_device (manager, (gint) device_id);
+  if (device == NULL)
+    device = clutter_device_manager_get_core_device (manager, device_type);
+
+  clutter_event_set_device (res, device);
+  clutter_event_set_source_device (res, device);
+
+  *event = res;
+
+  return TRUE;
+
+truncated:
+  clutter_event_free (res);
+  return FALSE;
+}
+
+/* queues the events recorded before the next frame, and returns the
+ * recorded time of the frame
+ */
+static gint64
+replay_frame (gint64 frame_time)
+{
+  if (!replay_started)
+    {
+      replay_frame_time = frame_time;
+      replay_time_base = (guint32) (frame_time / 1000);
+      replay_started = TRUE;
+    }
+
+  while (replay_offset < replay_size)
+    {
+      ClutterEvent *event;
+      guint32 delta;
+      guint8 kind;
+
+      if (!read_u8 (&kind))
+        break;
+
+      if (kind == RECORD_FRAME)
+        {
+          if (!read_u32 (&delta))
+            break;
+
+          if (replay_n_frames > 0)
+            replay_frame_time += delta;
+
+          replay_n_frames += 1;
+
+          return replay_frame_time;
+        }
+
+      if (kind != RECORD_EVENT || !read_event (&event))
+        {
+          g_warning ("The input recording is truncated or corrupted");
+          break;
+        }
+
+      if (event != NULL)
+        {
+          clutter_do_event (event);
+          clutter_event_free (event);
+        }
+    }
+
+  recorder_finish_replay ();
+
+  return frame_time;
+}
+
+/*< private >
+ * _clutter_input_recorder_frame:
+ * @frame_time: the time of the iteration of the master clock, in usecs
+ *
+ * Called by the master clock at the start of each iteration. When
+ * recording, writes the time of the iteration; when replaying, queues
+ * the events recorded before the iteration on their stages.
+ *
+ * Return value: the time to be used to advance the timelines, in usecs
+ */
+gint64
+_clutter_input_recorder_frame (gint64 frame_time)
+{
+  recorder_ensure_initialized ();
+
+  switch (recorder_state)
+    {
+    case RECORDER_RECORDING:
+      write_u8 (RECORD_FRAME);
+      write_u32 (record_last_frame >= 0
+                 ? (guint32) MIN (frame_time - record_last_frame, G_MAXUINT32)
+                 : 0);
+      record_last_frame = frame_time;
+      return frame_time;
+
+    case RECORDER_REPLAYING:
+      return replay_frame (frame_time);
+
+    default:
+      return frame_time;
+    }
+}
+
+/*< private >
+ * _clutter_input_recorder_filter_event:
+ * @event: an event pushed by a backend
+ *
+ * Records @event, if the input events are being recorded.
+ *
+ * Return value: %TRUE if @event should be dropped, i.e. if it is an
+ *   input event and the input events are being replayed
+ */
+gboolean
+_clutter_input_recorder_filter_event (const ClutterEvent *event)
+{
+  recorder_ensure_initialized ();
+
+  if (recorder_state == RECORDER_IDLE || !is_input_event (event))
+    return FALSE;
+
+  if (recorder_state == RECORDER_REPLAYING)
+    return TRUE;
+
+  record_event (event);
+
+  return FALSE;
+}
+
+/*< private >
+ * _clutter_input_recorder_is_replaying:
+ *
+ * Checks whether the input events are being replayed; the master clock
+ * keeps running until the end of the replay.
+ *
+ * Return value: %TRUE if a replay is in progress
+ */
+gboolean
+_clutter_input_recorder_is_replaying (void)
+{
+  return recorder_state == RECORDER_REPLAYING;
+}
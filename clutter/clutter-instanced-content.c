@@ -0,0 +1,729 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-instanced-content
+ * @Title: ClutterInstancedContent
+ * @Short_Description: Content drawing many copies of a texture
+ *
+ * #ClutterInstancedContent is a #ClutterContent implementation that
+ * draws a large number of rectangles, or instances, sharing the same
+ * texture, like the particles of an effect or the icons of a large
+ * field, using a single draw call.
+ *
+ * Each instance is described by a #ClutterInstance, which holds its
+ * position, size, scale, rotation, color and texture rectangle; the
+ * instances do not have the allocation, the paint volume and the paint
+ * node of a #ClutterActor, and are updated in bulk:
+ *
+ * |[<!-- language="C" -->
+ *   ClutterContent *particles = clutter_instanced_content_new ();
+ *   clutter_instanced_content_set_texture (CLUTTER_INSTANCED_CONTENT (particles),
+ *                                          spark_texture);
+ *   clutter_instanced_content_set_instances (CLUTTER_INSTANCED_CONTENT (particles),
+ *                                            0, n_sparks,
+ *                                            sparks);
+ *   clutter_actor_set_content (actor, particles);
+ *
+ *   // on each frame
+ *   clutter_instanced_content_set_positions (CLUTTER_INSTANCED_CONTENT (particles),
+ *                                            0, n_sparks,
+ *                                            positions);
+ * ]|
+ *
+ * The coordinates of the instances are relative to the actor using the
+ * content; the instances are not clipped to the allocation of the actor,
+ * which should be large enough to contain them, so that the redraws of
+ * the actor cover them.
+ *
+ * Only the vertices of the instances that changed are uploaded again,
+ * and the instances are drawn in the order of their index. The actor is
+ * picked as a whole; clutter_instanced_content_get_instance_at() can be
+ * used to find the instance under a point.
+ *
+ * #ClutterInstancedContent is available since Clutter 1.26.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "clutter-instanced-content.h"
+
+#include "clutter-actor.h"
+#include "clutter-backend.h"
+#include "clutter-content-private.h"
+#include "clutter-debug.h"
+#include "clutter-paint-node.h"
+#include "clutter-paint-nodes.h"
+#include "clutter-private.h"
+
+/* the indices of a primitive are unsigned shorts, so each primitive
+ * can address up to 65536 vertices, that is 16384 instances
+ */
+#define INSTANCES_PER_PRIMITIVE         16384
+
+struct _ClutterInstancedContentPrivate
+{
+  /* the ClutterInstance */
+  GArray *instances;
+
+  CoglTexture *texture;
+  CoglPipeline *pipeline;
+
+  /* the vertices of the instances, four per instance */
+  CoglAttributeBuffer *buffer;
+  guint buffer_size;
+
+  /* the instances whose vertices must be uploaded again */
+  guint dirty_first;
+  guint dirty_last;
+
+  GPtrArray *primitives;
+};
+
+static void clutter_content_iface_init (ClutterContentIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ClutterInstancedContent, clutter_instanced_content, G_TYPE_OBJECT,
+                         G_ADD_PRIVATE (ClutterInstancedContent)
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_CONTENT,
+                                                clutter_content_iface_init))
+
+static void
+clutter_instanced_content_clear_primitives (ClutterInstancedContent *self)
+{
+  g_clear_pointer (&self->priv->primitives, g_ptr_array_unref);
+}
+
+static void
+clutter_instanced_content_mark_dirty (ClutterInstancedContent *self,
+                                      guint                    first,
+                                      guint                    last)
+{
+  ClutterInstancedContentPrivate *priv = self->priv;
+
+  if (priv->dirty_first > priv->dirty_last)
+    {
+      priv->dirty_first = first;
+      priv->dirty_last = last;
+    }
+  else
+    {
+      priv->dirty_first = MIN (priv->dirty_first, first);
+      priv->dirty_last = MAX (priv->dirty_last, last);
+    }
+}
+
+static void
+clutter_instanced_content_finalize (GObject *gobject)
+{
+  ClutterInstancedContentPrivate *priv = CLUTTER_INSTANCED_CONTENT (gobject)->priv;
+
+  clutter_instanced_content_clear_primitives (CLUTTER_INSTANCED_CONTENT (gobject));
+
+  g_clear_pointer (&priv->buffer, cogl_object_unref);
+  g_clear_pointer (&priv->pipeline, cogl_object_unref);
+  g_clear_pointer (&priv->texture, cogl_object_unref);
+
+  g_array_unref (priv->instances);
+
+  G_OBJECT_CLASS (clutter_instanced_content_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_instanced_content_class_init (ClutterInstancedContentClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = clutter_instanced_content_finalize;
+}
+
+static void
+clutter_instanced_content_init (ClutterInstancedContent *self)
+{
+  self->priv = clutter_instanced_content_get_instance_private (self);
+
+  self->priv->instances = g_array_new (FALSE, FALSE, sizeof (ClutterInstance));
+
+  /* nothing to upload */
+  self->priv->dirty_first = 1;
+  self->priv->dirty_last = 0;
+}
+
+static void
+instance_get_vertices (const ClutterInstance *instance,
+                       CoglVertexP2T2C4      *vertices)
+{
+  gfloat half_width = instance->width * instance->scale / 2.0f;
+  gfloat half_height = instance->height * instance->scale / 2.0f;
+  gfloat center_x = instance->x + instance->width / 2.0f;
+  gfloat center_y = instance->y + instance->height / 2.0f;
+  gfloat c = 1.0f, s = 0.0f;
+  guint8 red, green, blue, alpha;
+  int i;
+
+  if (instance->rotation != 0.0f)
+    {
+      gfloat angle = instance->rotation * (G_PI / 180.0f);
+
+      c = cosf (angle);
+      s = sinf (angle);
+    }
+
+  /* the vertex colors replace the color of the pipeline, which
+   * expects premultiplied colors
+   */
+  alpha = instance->color.alpha;
+  red = instance->color.red * alpha / 255;
+  green = instance->color.green * alpha / 255;
+  blue = instance->color.blue * alpha / 255;
+
+  /* top-left, top-right, bottom-right, bottom-left, as expected by
+   * the indices returned by cogl_get_rectangle_indices()
+   */
+  vertices[0].x = -half_width;
+  vertices[0].y = -half_height;
+  vertices[0].s = instance->tx1;
+  vertices[0].t = instance->ty1;
+
+  vertices[1].x = half_width;
+  vertices[1].y = -half_height;
+  vertices[1].s = instance->tx2;
+  vertices[1].t = instance->ty1;
+
+  vertices[2].x = half_width;
+  vertices[2].y = half_height;
+  vertices[2].s = instance->tx2;
+  vertices[2].t = instance->ty2;
+
+  vertices[3].x = -half_width;
+  vertices[3].y = half_height;
+  vertices[3].s = instance->tx1;
+  vertices[3].t = instance->ty2;
+
+  for (i = 0; i < 4; i++)
+    {
+      gfloat x = vertices[i].x;
+      gfloat y = vertices[i].y;
+
+      vertices[i].x = center_x + x * c - y * s;
+      vertices[i].y = center_y + x * s + y * c;
+
+      vertices[i].r = red;
+      vertices[i].g = green;
+      vertices[i].b = blue;
+      vertices[i].a = alpha;
+    }
+}
+
+/* uploads the vertices of the instances that changed, and creates the
+ * primitives drawing them
+ */
+static void
+clutter_instanced_content_update_primitives (ClutterInstancedContent *self)
+{
+  ClutterInstancedContentPrivate *priv = self->priv;
+  CoglContext *ctx;
+  guint n_instances = priv->instances->len;
+  guint first;
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  if (priv->buffer == NULL || priv->buffer_size < n_instances)
+    {
+      clutter_instanced_content_clear_primitives (self);
+      g_clear_pointer (&priv->buffer, cogl_object_unref);
+
+      /* leave some room for the instances added later */
+      priv->buffer_size = MAX (n_instances + n_instances / 4, 16);
+      priv->buffer = cogl_attribute_buffer_new (ctx,
+                                                sizeof (CoglVertexP2T2C4) * 4 *
+                                                priv->buffer_size,
+                                                NULL);
+      cogl_buffer_set_update_hint (COGL_BUFFER (priv->buffer),
+                                   COGL_BUFFER_UPDATE_HINT_DYNAMIC);
+
+      CLUTTER_NOTE (PAINT, "Allocated the vertices of %u instances",
+                    priv->buffer_size);
+
+      clutter_instanced_content_mark_dirty (self, 0, n_instances - 1);
+    }
+
+  if (priv->dirty_first <= priv->dirty_last &&
+      priv->dirty_first < n_instances)
+    {
+      guint last = MIN (priv->dirty_last, n_instances - 1);
+      guint n_dirty = last - priv->dirty_first + 1;
+      CoglVertexP2T2C4 *vertices;
+      guint i;
+
+      vertices = g_new (CoglVertexP2T2C4, n_dirty * 4);
+
+      for (i = 0; i < n_dirty; i++)
+        instance_get_vertices (&g_array_index (priv->instances,
+                                               ClutterInstance,
+                                               priv->dirty_first + i),
+                               vertices + i * 4);
+
+      cogl_buffer_set_data (COGL_BUFFER (priv->buffer),
+                            sizeof (CoglVertexP2T2C4) * 4 * priv->dirty_first,
+                            vertices,
+                            sizeof (CoglVertexP2T2C4) * 4 * n_dirty);
+
+      g_free (vertices);
+    }
+
+  priv->dirty_first = 1;
+  priv->dirty_last = 0;
+
+  if (priv->primitives != NULL)
+    return;
+
+  priv->primitives = g_ptr_array_new_with_free_func (cogl_object_unref);
+
+  for (first = 0; first < n_instances; first += INSTANCES_PER_PRIMITIVE)
+    {
+      guint n = MIN (n_instances - first, INSTANCES_PER_PRIMITIVE);
+      gsize offset = sizeof (CoglVertexP2T2C4) * 4 * first;
+      CoglAttribute *attributes[3];
+      CoglPrimitive *primitive;
+      int i;
+
+      attributes[0] = cogl_attribute_new (priv->buffer,
+                                          "cogl_position_in",
+                                          sizeof (CoglVertexP2T2C4),
+                                          offset + G_STRUCT_OFFSET (CoglVertexP2T2C4, x),
+                                          2, /* n_components */
+                                          COGL_ATTRIBUTE_TYPE_FLOAT);
+      attributes[1] = cogl_attribute_new (priv->buffer,
+                                          "cogl_tex_coord0_in",
+                                          sizeof (CoglVertexP2T2C4),
+                                          offset + G_STRUCT_OFFSET (CoglVertexP2T2C4, s),
+                                          2, /* n_components */
+                                          COGL_ATTRIBUTE_TYPE_FLOAT);
+      attributes[2] = cogl_attribute_new (priv->buffer,
+                                          "cogl_color_in",
+                                          sizeof (CoglVertexP2T2C4),
+                                          offset + G_STRUCT_OFFSET (CoglVertexP2T2C4, r),
+                                          4, /* n_components */
+                                          COGL_ATTRIBUTE_TYPE_UNSIGNED_BYTE);
+
+      primitive = cogl_primitive_new_with_attributes (COGL_VERTICES_MODE_TRIANGLES,
+                                                      n * 6,
+                                                      attributes,
+                                                      3);
+      cogl_primitive_set_indices (primitive,
+                                  cogl_get_rectangle_indices (ctx, n),
+                                  n * 6);
+
+      for (i = 0; i < 3; i++)
+        cogl_object_unref (attributes[i]);
+
+      g_ptr_array_add (priv->primitives, primitive);
+    }
+}
+
+static void
+clutter_instanced_content_paint_content (ClutterContent   *content,
+                                         ClutterActor     *actor,
+                                         ClutterPaintNode *root)
+{
+  ClutterInstancedContent *self = CLUTTER_INSTANCED_CONTENT (content);
+  ClutterInstancedContentPrivate *priv = self->priv;
+  ClutterPaintNode *node;
+  CoglPipeline *pipeline;
+  guint8 opacity;
+  guint i;
+
+  if (priv->instances->len == 0)
+    return;
+
+  opacity = clutter_actor_get_paint_opacity (actor);
+  if (opacity == 0)
+    return;
+
+  clutter_instanced_content_update_primitives (self);
+
+  if (priv->pipeline == NULL)
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      priv->pipeline = cogl_pipeline_new (ctx);
+
+      if (priv->texture != NULL)
+        cogl_pipeline_set_layer_texture (priv->pipeline, 0, priv->texture);
+    }
+
+  /* the vertex colors replace the color of the pipeline, so the paint
+   * opacity is applied by an additional layer
+   */
+  if (opacity < 255)
+    {
+      int layer = priv->texture != NULL ? 1 : 0;
+      CoglColor constant;
+
+      pipeline = cogl_pipeline_copy (priv->pipeline);
+
+      cogl_color_init_from_4ub (&constant, opacity, opacity, opacity, opacity);
+      cogl_pipeline_set_layer_combine (pipeline, layer,
+                                       "RGBA = MODULATE (PREVIOUS, CONSTANT[A])",
+                                       NULL);
+      cogl_pipeline_set_layer_combine_constant (pipeline, layer, &constant);
+    }
+  else
+    pipeline = cogl_object_ref (priv->pipeline);
+
+  node = clutter_pipeline_node_new (pipeline);
+  clutter_paint_node_set_name (node, "Instanced Content");
+
+  for (i = 0; i < priv->primitives->len; i++)
+    clutter_paint_node_add_primitive (node, g_ptr_array_index (priv->primitives, i));
+
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+
+  cogl_object_unref (pipeline);
+}
+
+static void
+clutter_content_iface_init (ClutterContentIface *iface)
+{
+  iface->paint_content = clutter_instanced_content_paint_content;
+}
+
+/**
+ * clutter_instanced_content_new:
+ *
+ * Creates a new #ClutterInstancedContent instance, without instances.
+ *
+ * Return value: (transfer full): the newly created #ClutterInstancedContent
+ *   instance. Use g_object_unref() when done.
+ *
+ * Since: 1.26
+ */
+ClutterContent *
+clutter_instanced_content_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_INSTANCED_CONTENT, NULL);
+}
+
+/**
+ * clutter_instanced_content_set_texture:
+ * @content: a #ClutterInstancedContent
+ * @texture: (allow-none): the texture of the instances, or %NULL
+ *
+ * Sets the texture drawn by the instances of @content; each instance
+ * uses the part of the texture set in its #ClutterInstance.
+ *
+ * If @texture is %NULL, the instances are filled with their color.
+ *
+ * Since: 1.26
+ */
+void
+clutter_instanced_content_set_texture (ClutterInstancedContent *content,
+                                       CoglTexture             *texture)
+{
+  ClutterInstancedContentPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content));
+
+  priv = content->priv;
+
+  if (priv->texture == texture)
+    return;
+
+  if (texture != NULL)
+    cogl_object_ref (texture);
+
+  g_clear_pointer (&priv->texture, cogl_object_unref);
+  priv->texture = texture;
+
+  g_clear_pointer (&priv->pipeline, cogl_object_unref);
+
+  clutter_content_invalidate (CLUTTER_CONTENT (content));
+}
+
+/**
+ * clutter_instanced_content_get_texture:
+ * @content: a #ClutterInstancedContent
+ *
+ * Retrieves the texture set using clutter_instanced_content_set_texture().
+ *
+ * Return value: (transfer none): the texture of the instances, or %NULL
+ *
+ * Since: 1.26
+ */
+CoglTexture *
+clutter_instanced_content_get_texture (ClutterInstancedContent *content)
+{
+  g_return_val_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content), NULL);
+
+  return content->priv->texture;
+}
+
+/**
+ * clutter_instanced_content_set_n_instances:
+ * @content: a #ClutterInstancedContent
+ * @n_instances: the number of instances
+ *
+ * Sets the number of instances drawn by @content.
+ *
+ * The instances added by this function are white, with a scale factor
+ * of 1, and use the whole texture; their size is 0, so they are not
+ * visible until they are set using clutter_instanced_content_set_instances().
+ *
+ * Since: 1.26
+ */
+void
+clutter_instanced_content_set_n_instances (ClutterInstancedContent *content,
+                                           guint                    n_instances)
+{
+  ClutterInstancedContentPrivate *priv;
+  guint old_n_instances, i;
+
+  g_return_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content));
+
+  priv = content->priv;
+
+  old_n_instances = priv->instances->len;
+  if (old_n_instances == n_instances)
+    return;
+
+  g_array_set_size (priv->instances, n_instances);
+
+  for (i = old_n_instances; i < n_instances; i++)
+    {
+      ClutterInstance *instance = &g_array_index (priv->instances,
+                                                  ClutterInstance,
+                                                  i);
+
+      memset (instance, 0, sizeof (ClutterInstance));
+      instance->scale = 1.0f;
+      instance->color = *CLUTTER_COLOR_White;
+      instance->tx2 = 1.0f;
+      instance->ty2 = 1.0f;
+    }
+
+  if (n_instances > old_n_instances)
+    clutter_instanced_content_mark_dirty (content, old_n_instances, n_instances - 1);
+
+  clutter_instanced_content_clear_primitives (content);
+
+  clutter_content_invalidate (CLUTTER_CONTENT (content));
+}
+
+/**
+ * clutter_instanced_content_get_n_instances:
+ * @content: a #ClutterInstancedContent
+ *
+ * Retrieves the number of instances drawn by @content.
+ *
+ * Return value: the number of instances
+ *
+ * Since: 1.26
+ */
+guint
+clutter_instanced_content_get_n_instances (ClutterInstancedContent *content)
+{
+  g_return_val_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content), 0);
+
+  return content->priv->instances->len;
+}
+
+/**
+ * clutter_instanced_content_set_instances:
+ * @content: a #ClutterInstancedContent
+ * @first: the index of the first instance to set
+ * @n_instances: the number of instances to set
+ * @instances: (array length=n_instances): the data of the instances
+ *
+ * Sets the data of @n_instances instances of @content, starting from
+ * the instance at @first.
+ *
+ * If the instances do not exist yet, the number of instances of @content
+ * is increased as if clutter_instanced_content_set_n_instances() was
+ * called.
+ *
+ * Since: 1.26
+ */
+void
+clutter_instanced_content_set_instances (ClutterInstancedContent *content,
+                                         guint                    first,
+                                         guint                    n_instances,
+                                         const ClutterInstance   *instances)
+{
+  ClutterInstancedContentPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content));
+  g_return_if_fail (n_instances == 0 || instances != NULL);
+
+  if (n_instances == 0)
+    return;
+
+  priv = content->priv;
+
+  if (first + n_instances > priv->instances->len)
+    clutter_instanced_content_set_n_instances (content, first + n_instances);
+
+  memcpy (&g_array_index (priv->instances, ClutterInstance, first),
+          instances,
+          sizeof (ClutterInstance) * n_instances);
+
+  clutter_instanced_content_mark_dirty (content, first, first + n_instances - 1);
+
+  clutter_content_invalidate (CLUTTER_CONTENT (content));
+}
+
+/**
+ * clutter_instanced_content_get_instance:
+ * @content: a #ClutterInstancedContent
+ * @index_: the index of the instance
+ * @instance: (out caller-allocates): return location for the data
+ *   of the instance
+ *
+ * Retrieves the data of the instance at @index_.
+ *
+ * Since: 1.26
+ */
+void
+clutter_instanced_content_get_instance (ClutterInstancedContent *content,
+                                        guint                    index_,
+                                        ClutterInstance         *instance)
+{
+  g_return_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content));
+  g_return_if_fail (index_ < content->priv->instances->len);
+  g_return_if_fail (instance != NULL);
+
+  *instance = g_array_index (content->priv->instances, ClutterInstance, index_);
+}
+
+/**
+ * clutter_instanced_content_set_positions:
+ * @content: a #ClutterInstancedContent
+ * @first: the index of the first instance to move
+ * @n_instances: the number of instances to move
+ * @positions: (array): the new positions of the instances, as pairs
+ *   of X and Y coordinates
+ *
+ * Moves @n_instances existing instances of @content, starting from the
+ * instance at @first, leaving the rest of their data unchanged.
+ *
+ * The @positions array must contain 2 * @n_instances coordinates.
+ *
+ * Since: 1.26
+ */
+void
+clutter_instanced_content_set_positions (ClutterInstancedContent *content,
+                                         guint                    first,
+                                         guint                    n_instances,
+                                         const gfloat            *positions)
+{
+  ClutterInstancedContentPrivate *priv;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content));
+  g_return_if_fail (first + n_instances <= content->priv->instances->len);
+  g_return_if_fail (n_instances == 0 || positions != NULL);
+
+  if (n_instances == 0)
+    return;
+
+  priv = content->priv;
+
+  for (i = 0; i < n_instances; i++)
+    {
+      ClutterInstance *instance = &g_array_index (priv->instances,
+                                                  ClutterInstance,
+                                                  first + i);
+
+      instance->x = positions[i * 2];
+      instance->y = positions[i * 2 + 1];
+    }
+
+  clutter_instanced_content_mark_dirty (content, first, first + n_instances - 1);
+
+  clutter_content_invalidate (CLUTTER_CONTENT (content));
+}
+
+/**
+ * clutter_instanced_content_get_instance_at:
+ * @content: a #ClutterInstancedContent
+ * @x: the X coordinate, relative to the actor using @content
+ * @y: the Y coordinate, relative to the actor using @content
+ *
+ * Retrieves the topmost instance of @content containing the point
+ * at the given coordinates.
+ *
+ * The coordinates can be obtained from the coordinates of an event
+ * using clutter_actor_transform_stage_point() on the actor using
+ * @content.
+ *
+ * Return value: the index of the instance, or -1
+ *
+ * Since: 1.26
+ */
+gint
+clutter_instanced_content_get_instance_at (ClutterInstancedContent *content,
+                                           gfloat                   x,
+                                           gfloat                   y)
+{
+  ClutterInstancedContentPrivate *priv;
+  gint i;
+
+  g_return_val_if_fail (CLUTTER_IS_INSTANCED_CONTENT (content), -1);
+
+  priv = content->priv;
+
+  /* the instances are drawn in order, so the last one is on top */
+  for (i = (gint) priv->instances->len - 1; i >= 0; i--)
+    {
+      const ClutterInstance *instance = &g_array_index (priv->instances,
+                                                        ClutterInstance,
+                                                        i);
+      gfloat half_width = instance->width * instance->scale / 2.0f;
+      gfloat half_height = instance->height * instance->scale / 2.0f;
+      gfloat dx = x - (instance->x + instance->width / 2.0f);
+      gfloat dy = y - (instance->y + instance->height / 2.0f);
+
+      if (instance->color.alpha == 0)
+        continue;
+
+      /* rotate the point back into the frame of the instance */
+      if (instance->rotation != 0.0f)
+        {
+          gfloat angle = instance->rotation * (G_PI / 180.0f);
+          gfloat c = cosf (angle);
+          gfloat s = sinf (angle);
+          gfloat rx = dx * c + dy * s;
+          gfloat ry = dy * c - dx * s;
+
+          dx = rx;
+          dy = ry;
+        }
+
+      if (fabsf (dx) <= half_width && fabsf (dy) <= half_height)
+        return i;
+    }
+
+  return -1;
+}
@@ -0,0 +1,160 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_INSTANCED_CONTENT_H__
+#define __CLUTTER_INSTANCED_CONTENT_H__
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#include <cogl/cogl.h>
+#include <clutter/clutter-types.h>
+#include <clutter/clutter-color.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_INSTANCED_CONTENT                  (clutter_instanced_content_get_type ())
+#define CLUTTER_INSTANCED_CONTENT(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_INSTANCED_CONTENT, ClutterInstancedContent))
+#define CLUTTER_IS_INSTANCED_CONTENT(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_INSTANCED_CONTENT))
+#define CLUTTER_INSTANCED_CONTENT_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_INSTANCED_CONTENT, ClutterInstancedContentClass))
+#define CLUTTER_IS_INSTANCED_CONTENT_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_INSTANCED_CONTENT))
+#define CLUTTER_INSTANCED_CONTENT_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_INSTANCED_CONTENT, ClutterInstancedContentClass))
+
+typedef struct _ClutterInstance                 ClutterInstance;
+typedef struct _ClutterInstancedContent         ClutterInstancedContent;
+typedef struct _ClutterInstancedContentPrivate  ClutterInstancedContentPrivate;
+typedef struct _ClutterInstancedContentClass    ClutterInstancedContentClass;
+
+/**
+ * ClutterInstance:
+ * @x: the X coordinate of the top-left corner of the instance
+ * @y: the Y coordinate of the top-left corner of the instance
+ * @width: the width of the instance
+ * @height: the height of the instance
+ * @scale: the scale factor of the instance, around its center
+ * @rotation: the rotation of the instance around its center, in degrees
+ * @color: the color of the instance, multiplied by the texture
+ * @tx1: the X coordinate of the top-left corner of the texture rectangle
+ * @ty1: the Y coordinate of the top-left corner of the texture rectangle
+ * @tx2: the X coordinate of the bottom-right corner of the texture rectangle
+ * @ty2: the Y coordinate of the bottom-right corner of the texture rectangle
+ *
+ * The data of an instance drawn by #ClutterInstancedContent.
+ *
+ * The coordinates of the instance are relative to the actor using the
+ * content, and the texture rectangle is in normalized texture
+ * coordinates.
+ *
+ * Since: 1.26
+ */
+struct _ClutterInstance
+{
+  gfloat x;
+  gfloat y;
+  gfloat width;
+  gfloat height;
+
+  gfloat scale;
+  gfloat rotation;
+
+  ClutterColor color;
+
+  gfloat tx1;
+  gfloat ty1;
+  gfloat tx2;
+  gfloat ty2;
+};
+
+/**
+ * ClutterInstancedContent:
+ *
+ * The #ClutterInstancedContent structure contains
+ * private data and should only be accessed using the provided
+ * API.
+ *
+ * Since: 1.26
+ */
+struct _ClutterInstancedContent
+{
+  /*< private >*/
+  GObject parent_instance;
+
+  ClutterInstancedContentPrivate *priv;
+};
+
+/**
+ * ClutterInstancedContentClass:
+ *
+ * The #ClutterInstancedContentClass structure contains
+ * private data.
+ *
+ * Since: 1.26
+ */
+struct _ClutterInstancedContentClass
+{
+  /*< private >*/
+  GObjectClass parent_class;
+
+  gpointer _padding[16];
+};
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_instanced_content_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterContent *        clutter_instanced_content_new                   (void);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_instanced_content_set_texture           (ClutterInstancedContent *content,
+                                                                         CoglTexture             *texture);
+CLUTTER_AVAILABLE_IN_1_26
+CoglTexture *           clutter_instanced_content_get_texture           (ClutterInstancedContent *content);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_instanced_content_set_n_instances       (ClutterInstancedContent *content,
+                                                                         guint                    n_instances);
+CLUTTER_AVAILABLE_IN_1_26
+guint                   clutter_instanced_content_get_n_instances       (ClutterInstancedContent *content);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_instanced_content_set_instances         (ClutterInstancedContent *content,
+                                                                         guint                    first,
+                                                                         guint                    n_instances,
+                                                                         const ClutterInstance   *instances);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_instanced_content_get_instance          (ClutterInstancedContent *content,
+                                                                         guint                    index_,
+                                                                         ClutterInstance         *instance);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_instanced_content_set_positions         (ClutterInstancedContent *content,
+                                                                         guint                    first,
+                                                                         guint                    n_instances,
+                                                                         const gfloat            *positions);
+
+CLUTTER_AVAILABLE_IN_1_26
+gint                    clutter_instanced_content_get_instance_at       (ClutterInstancedContent *content,
+                                                                         gfloat                   x,
+                                                                         gfloat                   y);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_INSTANCED_CONTENT_H__ */
@@ -87,11 +87,39 @@ enum
   N_VALUES
 };
 
+/* the decomposition of the boundaries of a matrix interval, and the
+ * matrices it was computed from
+ */
+typedef struct _MatrixCache
+{
+  ClutterMatrix initial;
+  ClutterMatrix final;
+
+  ClutterMatrixComponents initial_components;
+  ClutterMatrixComponents final_components;
+} MatrixCache;
+
+typedef gboolean (* IntervalComputeFunc) (const GValue *initial,
+                                           const GValue *final,
+                                           gdouble       factor,
+                                           GValue       *value);
+
 struct _ClutterIntervalPrivate
 {
   GType value_type;
 
   GValue *values;
+
+  MatrixCache *matrix_cache;
+
+  /* the interpolation of the values, resolved from the value type
+   * the first time it is needed, and again when the registered
+   * progress functions change
+   */
+  IntervalComputeFunc compute_func;
+  ClutterProgressFunc progress_func;
+  guint progress_funcs_serial;
+  guint use_matrix_cache : 1;
 };
 
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
@@ -262,135 +290,273 @@ G_GNUC_END_IGNORE_DEPRECATIONS;
   return TRUE;
 }
 
-static gboolean
-clutter_interval_real_compute_value (ClutterInterval *interval,
-                                     gdouble          factor,
-                                     GValue          *value)
+/* Interpolates the matrices of @interval by decomposing them only when
+ * they change, instead of on every frame like the progress function of
+ * ClutterMatrix has to
+ */
+static void
+clutter_interval_compute_matrix (ClutterInterval *interval,
+                                 const GValue    *initial,
+                                 const GValue    *final,
+                                 gdouble          factor,
+                                 GValue          *value)
 {
-  GValue *initial, *final;
-  GType value_type;
-  gboolean retval = FALSE;
+  ClutterIntervalPrivate *priv = interval->priv;
+  const ClutterMatrix *initial_matrix = g_value_get_boxed (initial);
+  const ClutterMatrix *final_matrix = g_value_get_boxed (final);
+  MatrixCache *cache = priv->matrix_cache;
+  ClutterMatrix res;
 
-  initial = clutter_interval_peek_initial_value (interval);
-  final = clutter_interval_peek_final_value (interval);
+  if (cache == NULL)
+    {
+      cache = priv->matrix_cache = g_new (MatrixCache, 1);
+      cache->initial = *initial_matrix;
+      cache->final = *final_matrix;
+
+      _clutter_util_matrix_get_components (initial_matrix,
+                                           &cache->initial_components);
+      _clutter_util_matrix_get_components (final_matrix,
+                                           &cache->final_components);
+    }
+  else
+    {
+      if (!cogl_matrix_equal (&cache->initial, initial_matrix))
+        {
+          cache->initial = *initial_matrix;
+          _clutter_util_matrix_get_components (initial_matrix,
+                                               &cache->initial_components);
+        }
 
-  value_type = clutter_interval_get_value_type (interval);
+      if (!cogl_matrix_equal (&cache->final, final_matrix))
+        {
+          cache->final = *final_matrix;
+          _clutter_util_matrix_get_components (final_matrix,
+                                               &cache->final_components);
+        }
+    }
 
-  if (_clutter_has_progress_function (value_type))
-    {
-      retval = _clutter_run_progress_function (value_type,
-                                               initial,
-                                               final,
+  _clutter_util_matrix_components_interpolate (&cache->initial_components,
+                                               &cache->final_components,
                                                factor,
-                                               value);
-      if (retval)
-        return TRUE;
-    }
+                                               &res);
 
-  switch (G_TYPE_FUNDAMENTAL (value_type))
-    {
-    case G_TYPE_INT:
-      {
-        gint ia, ib, res;
+  g_value_set_boxed (value, &res);
+}
 
-        ia = g_value_get_int (initial);
-        ib = g_value_get_int (final);
+static gboolean
+interval_compute_int (const GValue *initial,
+                      const GValue *final,
+                      gdouble       factor,
+                      GValue       *value)
+{
+  gint ia, ib, res;
 
-        res = (factor * (ib - ia)) + ia;
+  ia = g_value_get_int (initial);
+  ib = g_value_get_int (final);
 
-        g_value_set_int (value, res);
+  res = (factor * (ib - ia)) + ia;
 
-        retval = TRUE;
-      }
-      break;
+  g_value_set_int (value, res);
 
-    case G_TYPE_CHAR:
-      {
-        gchar ia, ib, res;
+  return TRUE;
+}
 
-        ia = g_value_get_schar (initial);
-        ib = g_value_get_schar (final);
+static gboolean
+interval_compute_char (const GValue *initial,
+                       const GValue *final,
+                       gdouble       factor,
+                       GValue       *value)
+{
+  gchar ia, ib, res;
 
-        res = (factor * (ib - (gdouble) ia)) + ia;
+  ia = g_value_get_schar (initial);
+  ib = g_value_get_schar (final);
 
-        g_value_set_schar (value, res);
+  res = (factor * (ib - (gdouble) ia)) + ia;
 
-        retval = TRUE;
-      }
-      break;
+  g_value_set_schar (value, res);
 
-    case G_TYPE_UINT:
-      {
-        guint ia, ib, res;
+  return TRUE;
+}
 
-        ia = g_value_get_uint (initial);
-        ib = g_value_get_uint (final);
+static gboolean
+interval_compute_uint (const GValue *initial,
+                       const GValue *final,
+                       gdouble       factor,
+                       GValue       *value)
+{
+  guint ia, ib, res;
 
-        res = (factor * (ib - (gdouble) ia)) + ia;
+  ia = g_value_get_uint (initial);
+  ib = g_value_get_uint (final);
 
-        g_value_set_uint (value, res);
+  res = (factor * (ib - (gdouble) ia)) + ia;
 
-        retval = TRUE;
-      }
-      break;
+  g_value_set_uint (value, res);
 
-    case G_TYPE_UCHAR:
-      {
-        guchar ia, ib, res;
+  return TRUE;
+}
 
-        ia = g_value_get_uchar (initial);
-        ib = g_value_get_uchar (final);
+static gboolean
+interval_compute_uchar (const GValue *initial,
+                        const GValue *final,
+                        gdouble       factor,
+                        GValue       *value)
+{
+  guchar ia, ib, res;
 
-        res = (factor * (ib - (gdouble) ia)) + ia;
+  ia = g_value_get_uchar (initial);
+  ib = g_value_get_uchar (final);
 
-        g_value_set_uchar (value, res);
+  res = (factor * (ib - (gdouble) ia)) + ia;
 
-        retval = TRUE;
-      }
-      break;
+  g_value_set_uchar (value, res);
 
-    case G_TYPE_FLOAT:
-    case G_TYPE_DOUBLE:
-      {
-        gdouble ia, ib, res;
+  return TRUE;
+}
 
-        if (value_type == G_TYPE_DOUBLE)
-          {
-            ia = g_value_get_double (initial);
-            ib = g_value_get_double (final);
-          }
-        else
-          {
-            ia = g_value_get_float (initial);
-            ib = g_value_get_float (final);
-          }
+static gboolean
+interval_compute_float (const GValue *initial,
+                        const GValue *final,
+                        gdouble       factor,
+                        GValue       *value)
+{
+  gdouble ia, ib;
 
-        res = (factor * (ib - ia)) + ia;
+  ia = g_value_get_float (initial);
+  ib = g_value_get_float (final);
 
-        if (value_type == G_TYPE_DOUBLE)
-          g_value_set_double (value, res);
-        else
-          g_value_set_float (value, res);
+  g_value_set_float (value, (factor * (ib - ia)) + ia);
 
-        retval = TRUE;
-      }
+  return TRUE;
+}
+
+static gboolean
+interval_compute_double (const GValue *initial,
+                         const GValue *final,
+                         gdouble       factor,
+                         GValue       *value)
+{
+  gdouble ia, ib;
+
+  ia = g_value_get_double (initial);
+  ib = g_value_get_double (final);
+
+  g_value_set_double (value, (factor * (ib - ia)) + ia);
+
+  return TRUE;
+}
+
+static gboolean
+interval_compute_boolean (const GValue *initial,
+                          const GValue *final,
+                          gdouble       factor,
+                          GValue       *value)
+{
+  if (factor > 0.5)
+    g_value_set_boolean (value, TRUE);
+  else
+    g_value_set_boolean (value, FALSE);
+
+  return TRUE;
+}
+
+static gboolean
+interval_compute_none (const GValue *initial,
+                       const GValue *final,
+                       gdouble       factor,
+                       GValue       *value)
+{
+  return FALSE;
+}
+
+/* Resolves the interpolation of the values of @interval from its
+ * value type, so that computing a value does not need to look up
+ * the progress functions or the fundamental type again
+ */
+static void
+clutter_interval_resolve_compute_func (ClutterInterval *interval)
+{
+  ClutterIntervalPrivate *priv = interval->priv;
+  GType value_type = priv->value_type;
+
+  priv->progress_funcs_serial = _clutter_get_progress_functions_serial ();
+  priv->progress_func = _clutter_get_progress_function (value_type);
+
+  /* unless the application replaced the progress function for matrices */
+  priv->use_matrix_cache = value_type == CLUTTER_TYPE_MATRIX &&
+                           priv->progress_func == _clutter_matrix_progress;
+
+  switch (G_TYPE_FUNDAMENTAL (value_type))
+    {
+    case G_TYPE_INT:
+      priv->compute_func = interval_compute_int;
       break;
 
-    case G_TYPE_BOOLEAN:
-      if (factor > 0.5)
-        g_value_set_boolean (value, TRUE);
-      else
-        g_value_set_boolean (value, FALSE);
+    case G_TYPE_CHAR:
+      priv->compute_func = interval_compute_char;
+      break;
+
+    case G_TYPE_UINT:
+      priv->compute_func = interval_compute_uint;
+      break;
 
-      retval = TRUE;
+    case G_TYPE_UCHAR:
+      priv->compute_func = interval_compute_uchar;
       break;
 
-    case G_TYPE_BOXED:
+    case G_TYPE_FLOAT:
+      priv->compute_func = interval_compute_float;
+      break;
+
+    case G_TYPE_DOUBLE:
+      priv->compute_func = interval_compute_double;
+      break;
+
+    case G_TYPE_BOOLEAN:
+      priv->compute_func = interval_compute_boolean;
       break;
 
     default:
+      priv->compute_func = interval_compute_none;
       break;
     }
+}
+
+static gboolean
+clutter_interval_real_compute_value (ClutterInterval *interval,
+                                     gdouble          factor,
+                                     GValue          *value)
+{
+  ClutterIntervalPrivate *priv = interval->priv;
+  GValue *initial, *final;
+  gboolean retval = FALSE;
+
+  if (G_UNLIKELY (priv->compute_func == NULL ||
+                  priv->progress_funcs_serial != _clutter_get_progress_functions_serial ()))
+    clutter_interval_resolve_compute_func (interval);
+
+  initial = clutter_interval_peek_initial_value (interval);
+  final = clutter_interval_peek_final_value (interval);
+
+  if (priv->use_matrix_cache &&
+      G_VALUE_HOLDS (initial, CLUTTER_TYPE_MATRIX) &&
+      G_VALUE_HOLDS (final, CLUTTER_TYPE_MATRIX) &&
+      g_value_get_boxed (initial) != NULL &&
+      g_value_get_boxed (final) != NULL)
+    {
+      clutter_interval_compute_matrix (interval, initial, final, factor, value);
+      return TRUE;
+    }
+
+  if (priv->progress_func != NULL)
+    {
+      retval = priv->progress_func (initial, final, factor, value);
+      if (retval)
+        return TRUE;
+    }
+
+  retval = priv->compute_func (initial, final, factor, value);
 
   /* We're trying to animate a property without knowing how to do that. Issue
    * a warning with a hint to what could be done to fix that */
@@ -400,7 +566,7 @@ clutter_interval_real_compute_value (ClutterInterval *interval,
                  "register a progress function to instruct ClutterInterval "
                  "how to deal with this GType",
                  G_STRLOC,
-                 g_type_name (value_type));
+                 g_type_name (priv->value_type));
     }
 
   return retval;
@@ -421,6 +587,7 @@ clutter_interval_finalize (GObject *gobject)
     g_value_unset (&priv->values[RESULT]);
 
   g_free (priv->values);
+  g_free (priv->matrix_cache);
 
   G_OBJECT_CLASS (clutter_interval_parent_class)->finalize (gobject);
 }
@@ -0,0 +1,218 @@
+#!/usr/bin/env perl
+
+# Notes   : Reads the keysym <-> Unicode tables in clutter-keysyms-table.in
+# Notes   : and creates clutter-keysyms-index.h, with the paged tables used
+# Notes   : by clutter_keysym_to_unicode() and clutter_unicode_to_keysym()
+#
+# Usage   : perl clutter-keysyms-index.pl [clutter-keysyms-table.in]
+
+use strict;
+
+# The number of low bits of a key used to index inside a page; the
+# tables have different densities, so each has its own page size
+my %page_bits = (
+  'keysym_to_unicode' => 8,
+  'unicode_to_keysym' => 7,
+);
+
+my $input = shift @ARGV || 'clutter-keysyms-table.in';
+my $output = 'clutter-keysyms-index.h';
+
+open (my $in, '<', $input) or die "Unable to open $input: $!\n";
+
+my @tables;
+my $current;
+
+while (my $line = <$in>)
+{
+	if ($line =~ /^}\s*clutter_(\w+)_tab\[\]/)
+	{
+		$current = { 'name' => $1, 'entries' => [] };
+		push @tables, $current;
+		next;
+	}
+
+	if ($line =~ /^};/)
+	{
+		$current = undef;
+		next;
+	}
+
+	next unless defined $current;
+
+	# { 0x01a1, 0x0104 }, /* comment */
+	# { 0xFF80 /* Space */, ' ' },
+	if ($line =~ /^\s*{\s*(0x[0-9a-fA-F]+)\s*(?:\/\*.*?\*\/)?\s*,\s*(0x[0-9a-fA-F]+|'.')\s*}/)
+	{
+		my ($keysym, $ucs) = (hex ($1), $2);
+
+		$ucs = ($ucs =~ /^'(.)'$/) ? ord ($1) : hex ($ucs);
+
+		push @{$current->{'entries'}}, [ $keysym, $ucs ];
+	}
+}
+
+close ($in);
+
+die "Unable to find the tables in $input\n" unless scalar @tables == 2;
+
+open (my $out, '>', $output) or die "Unable to create $output: $!\n";
+
+print $out <<EOF;
+/* clutter-keysyms-index.h: generated by clutter-keysyms-index.pl from
+ * clutter-keysyms-table.in; do not edit.
+ *
+ * Each table maps a 16 bit key to a 16 bit value, using the high bits of
+ * the key to find a page, and the low bits to find the value inside the
+ * page; the pages only store the range between their first and last key,
+ * and a value of 0 means that the key has no mapping.
+ */
+
+#ifndef __CLUTTER_KEYSYMS_INDEX_H__
+#define __CLUTTER_KEYSYMS_INDEX_H__
+
+typedef struct {
+  guint16 offset;
+  guint8 first;
+  guint8 last;
+} ClutterKeysymsPage;
+
+#define CLUTTER_KEYSYMS_NO_PAGE 0xff
+
+EOF
+
+foreach my $table (@tables)
+{
+	my $name = $table->{'name'};
+	my $bits = $page_bits{$name};
+	my @entries = @{$table->{'entries'}};
+
+	die "Unknown table $name\n" unless defined $bits;
+
+	# keysym_to_unicode is keyed by the keysym column, and
+	# unicode_to_keysym by the Unicode column
+	my $key_column = ($name eq 'keysym_to_unicode') ? 0 : 1;
+	my $value_column = 1 - $key_column;
+
+	for (my $i = 1; $i < scalar @entries; $i++)
+	{
+		die "The $name table is not sorted at entry $i\n"
+			if $entries[$i]->[$key_column] < $entries[$i - 1]->[$key_column];
+	}
+
+	# a key can appear more than once; keep the entry that the binary
+	# search over the sorted table used to find, so that the results
+	# do not change
+	my %values;
+	my %seen;
+
+	foreach my $entry (@entries)
+	{
+		my $key = $entry->[$key_column];
+
+		next if $seen{$key}++;
+
+		my ($min, $max) = (0, scalar @entries - 1);
+
+		while ($max >= $min)
+		{
+			my $mid = int (($min + $max) / 2);
+			my $mid_key = $entries[$mid]->[$key_column];
+
+			if ($mid_key < $key)
+			{
+				$min = $mid + 1;
+			}
+			elsif ($mid_key > $key)
+			{
+				$max = $mid - 1;
+			}
+			else
+			{
+				$values{$key} = $entries[$mid]->[$value_column];
+				last;
+			}
+		}
+
+		die "Key $key has no mapping in $name\n" unless $values{$key};
+		die "Key $key is too big for $name\n" if $key > 0xffff;
+	}
+
+	my $mask = (1 << $bits) - 1;
+	my $n_dir = 0x10000 >> $bits;
+	my %pages;
+
+	foreach my $key (keys %values)
+	{
+		my $page = $key >> $bits;
+		my $low = $key & $mask;
+
+		$pages{$page} = [ $low, $low ] unless defined $pages{$page};
+		$pages{$page}->[0] = $low if $low < $pages{$page}->[0];
+		$pages{$page}->[1] = $low if $low > $pages{$page}->[1];
+	}
+
+	my @page_numbers = sort { $a <=> $b } keys %pages;
+
+	die "Too many pages in $name\n" if scalar @page_numbers >= 0xff;
+
+	my @dir = (-1) x $n_dir;
+	my @page_defs;
+	my @page_values;
+
+	for (my $i = 0; $i < scalar @page_numbers; $i++)
+	{
+		my $page = $page_numbers[$i];
+		my ($first, $last) = @{$pages{$page}};
+
+		$dir[$page] = $i;
+		push @page_defs, [ scalar @page_values, $first, $last, $page ];
+
+		for (my $low = $first; $low <= $last; $low++)
+		{
+			my $key = ($page << $bits) | $low;
+
+			push @page_values, defined $values{$key} ? $values{$key} : 0;
+		}
+	}
+
+	my $upper = uc ($name);
+
+	my $n_keys = scalar (keys %values);
+	my $n_pages = scalar (@page_numbers);
+	my $n_values = scalar (@page_values);
+
+	printf $out "/* %d keys in %d pages, %d bytes */\n",
+		$n_keys, $n_pages, $n_dir + 4 * $n_pages + 2 * $n_values;
+	print $out "#define CLUTTER_${upper}_PAGE_BITS $bits\n\n";
+
+	print $out "static const guint8 clutter_${name}_dir[$n_dir] = {";
+	for (my $i = 0; $i < $n_dir; $i++)
+	{
+		print $out "\n " if $i % 16 == 0;
+		printf $out " 0x%02x,", $dir[$i] < 0 ? 0xff : $dir[$i];
+	}
+	print $out "\n};\n\n";
+
+	print $out "static const ClutterKeysymsPage clutter_${name}_pages[] = {\n";
+	foreach my $def (@page_defs)
+	{
+		printf $out "  { %4d, 0x%02x, 0x%02x }, /* 0x%04x */\n",
+			$def->[0], $def->[1], $def->[2], $def->[3] << $bits;
+	}
+	print $out "};\n\n";
+
+	print $out "static const guint16 clutter_${name}_values[] = {";
+	for (my $i = 0; $i < scalar @page_values; $i++)
+	{
+		print $out "\n " if $i % 8 == 0;
+		printf $out " 0x%04x,", $page_values[$i];
+	}
+	print $out "\n};\n\n";
+}
+
+print $out "#endif /* __CLUTTER_KEYSYMS_INDEX_H__ */\n";
+
+close ($out);
+
+printf "%s generated\n", $output;
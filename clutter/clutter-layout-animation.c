@@ -0,0 +1,277 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * The animation of the allocations of the children of a layout manager.
+ *
+ * Instead of a ClutterPropertyTransition on the allocation of each
+ * child, the layout manager records the initial and final allocation
+ * of each of its children in a single array, and one timeline
+ * interpolates all of them in a single pass at each frame.
+ *
+ * A relayout while the animation is running retargets it: the children
+ * start again from their current allocation, and the timeline restarts.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-layout-animation.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+#include "clutter-timeline.h"
+
+typedef struct {
+  ClutterActor *child;
+  ClutterActor *parent;
+
+  ClutterActorBox from;
+  ClutterActorBox to;
+  ClutterActorBox current;
+
+  ClutterAllocationFlags flags;
+} AnimatedChild;
+
+struct _ClutterLayoutAnimation
+{
+  ClutterTimeline *timeline;
+
+  /* the animated children, and their index in the array plus one */
+  GArray *children;
+  GHashTable *indices;
+};
+
+static void
+animated_child_clear (gpointer data)
+{
+  AnimatedChild *animated = data;
+
+  g_object_unref (animated->child);
+}
+
+static void
+layout_animation_remove_index (ClutterLayoutAnimation *animation,
+                               guint                   index_)
+{
+  AnimatedChild *animated;
+
+  animated = &g_array_index (animation->children, AnimatedChild, index_);
+  g_hash_table_remove (animation->indices, animated->child);
+
+  /* the last child takes the place of the removed one */
+  g_array_remove_index_fast (animation->children, index_);
+
+  if (index_ < animation->children->len)
+    {
+      animated = &g_array_index (animation->children, AnimatedChild, index_);
+      g_hash_table_insert (animation->indices, animated->child,
+                           GUINT_TO_POINTER (index_ + 1));
+    }
+}
+
+static void
+layout_animation_new_frame (ClutterTimeline        *timeline,
+                            gint                    elapsed,
+                            ClutterLayoutAnimation *animation)
+{
+  gdouble progress = clutter_timeline_get_progress (timeline);
+  guint i = animation->children->len;
+
+  while (i-- > 0)
+    {
+      AnimatedChild *animated;
+
+      animated = &g_array_index (animation->children, AnimatedChild, i);
+
+      /* the child was removed from the layout */
+      if (clutter_actor_get_parent (animated->child) != animated->parent ||
+          CLUTTER_ACTOR_IN_DESTRUCTION (animated->child))
+        {
+          layout_animation_remove_index (animation, i);
+          continue;
+        }
+
+      clutter_actor_box_interpolate (&animated->from, &animated->to,
+                                     progress,
+                                     &animated->current);
+
+      _clutter_actor_set_animated_allocation (animated->child,
+                                              &animated->current,
+                                              animated->flags);
+    }
+}
+
+static void
+layout_animation_completed (ClutterTimeline        *timeline,
+                            ClutterLayoutAnimation *animation)
+{
+  CLUTTER_NOTE (LAYOUT, "Allocation animation of %u children completed",
+                animation->children->len);
+
+  /* the last frame allocated the final boxes */
+  g_hash_table_remove_all (animation->indices);
+  g_array_set_size (animation->children, 0);
+}
+
+ClutterLayoutAnimation *
+_clutter_layout_animation_new (ClutterAnimationMode mode,
+                               guint                duration)
+{
+  ClutterLayoutAnimation *animation;
+
+  animation = g_slice_new0 (ClutterLayoutAnimation);
+
+  animation->timeline = clutter_timeline_new (duration);
+  clutter_timeline_set_progress_mode (animation->timeline, mode);
+
+  g_signal_connect (animation->timeline, "new-frame",
+                    G_CALLBACK (layout_animation_new_frame),
+                    animation);
+  g_signal_connect (animation->timeline, "completed",
+                    G_CALLBACK (layout_animation_completed),
+                    animation);
+
+  animation->children = g_array_new (FALSE, FALSE, sizeof (AnimatedChild));
+  g_array_set_clear_func (animation->children, animated_child_clear);
+
+  animation->indices = g_hash_table_new (NULL, NULL);
+
+  return animation;
+}
+
+void
+_clutter_layout_animation_free (ClutterLayoutAnimation *animation)
+{
+  if (animation == NULL)
+    return;
+
+  clutter_timeline_stop (animation->timeline);
+  g_signal_handlers_disconnect_by_data (animation->timeline, animation);
+  g_object_unref (animation->timeline);
+
+  g_hash_table_unref (animation->indices);
+  g_array_unref (animation->children);
+
+  g_slice_free (ClutterLayoutAnimation, animation);
+}
+
+void
+_clutter_layout_animation_set_easing (ClutterLayoutAnimation *animation,
+                                      ClutterAnimationMode    mode,
+                                      guint                   duration)
+{
+  clutter_timeline_set_duration (animation->timeline, duration);
+  clutter_timeline_set_progress_mode (animation->timeline, mode);
+}
+
+void
+_clutter_layout_animation_get_easing (ClutterLayoutAnimation *animation,
+                                      ClutterAnimationMode   *mode,
+                                      guint                  *duration)
+{
+  if (mode != NULL)
+    *mode = clutter_timeline_get_progress_mode (animation->timeline);
+
+  if (duration != NULL)
+    *duration = clutter_timeline_get_duration (animation->timeline);
+}
+
+/*< private >
+ * _clutter_layout_animation_add_child:
+ * @animation: a #ClutterLayoutAnimation
+ * @child: the child being allocated
+ * @from: the current allocation of @child
+ * @to: the new allocation of @child
+ * @flags: the allocation flags
+ *
+ * Animates the allocation of @child from @from to @to; the first child
+ * added after a frame of the animation restarts it.
+ */
+void
+_clutter_layout_animation_add_child (ClutterLayoutAnimation *animation,
+                                     ClutterActor           *child,
+                                     const ClutterActorBox  *from,
+                                     const ClutterActorBox  *to,
+                                     ClutterAllocationFlags  flags)
+{
+  AnimatedChild *animated;
+  guint index_;
+
+  /* the children still moving start again from where they are */
+  if (clutter_timeline_get_elapsed_time (animation->timeline) > 0)
+    {
+      guint i;
+
+      for (i = 0; i < animation->children->len; i++)
+        {
+          animated = &g_array_index (animation->children, AnimatedChild, i);
+          animated->from = animated->current;
+        }
+
+      clutter_timeline_rewind (animation->timeline);
+    }
+
+  index_ = GPOINTER_TO_UINT (g_hash_table_lookup (animation->indices, child));
+  if (index_ == 0)
+    {
+      AnimatedChild new_child;
+
+      new_child.child = g_object_ref (child);
+      new_child.parent = clutter_actor_get_parent (child);
+      new_child.current = *from;
+
+      g_array_append_val (animation->children, new_child);
+      index_ = animation->children->len;
+
+      g_hash_table_insert (animation->indices, child,
+                           GUINT_TO_POINTER (index_));
+    }
+
+  animated = &g_array_index (animation->children, AnimatedChild, index_ - 1);
+  animated->from = *from;
+  animated->to = *to;
+  animated->flags = flags;
+
+  if (!clutter_timeline_is_playing (animation->timeline))
+    clutter_timeline_start (animation->timeline);
+}
+
+/*< private >
+ * _clutter_layout_animation_remove_child:
+ * @animation: a #ClutterLayoutAnimation
+ * @child: a child
+ *
+ * Stops animating the allocation of @child, if it is animated.
+ */
+void
+_clutter_layout_animation_remove_child (ClutterLayoutAnimation *animation,
+                                        ClutterActor           *child)
+{
+  guint index_;
+
+  index_ = GPOINTER_TO_UINT (g_hash_table_lookup (animation->indices, child));
+  if (index_ != 0)
+    layout_animation_remove_index (animation, index_ - 1);
+}
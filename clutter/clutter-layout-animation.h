@@ -0,0 +1,50 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_LAYOUT_ANIMATION_H__
+#define __CLUTTER_LAYOUT_ANIMATION_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterLayoutAnimation ClutterLayoutAnimation;
+
+ClutterLayoutAnimation *_clutter_layout_animation_new           (ClutterAnimationMode    mode,
+                                                                 guint                   duration);
+void                    _clutter_layout_animation_free          (ClutterLayoutAnimation *animation);
+void                    _clutter_layout_animation_set_easing    (ClutterLayoutAnimation *animation,
+                                                                 ClutterAnimationMode    mode,
+                                                                 guint                   duration);
+void                    _clutter_layout_animation_get_easing    (ClutterLayoutAnimation *animation,
+                                                                 ClutterAnimationMode   *mode,
+                                                                 guint                  *duration);
+void                    _clutter_layout_animation_add_child     (ClutterLayoutAnimation *animation,
+                                                                 ClutterActor           *child,
+                                                                 const ClutterActorBox  *from,
+                                                                 const ClutterActorBox  *to,
+                                                                 ClutterAllocationFlags  flags);
+void                    _clutter_layout_animation_remove_child  (ClutterLayoutAnimation *animation,
+                                                                 ClutterActor           *child);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_LAYOUT_ANIMATION_H__ */
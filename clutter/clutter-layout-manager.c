@@ -140,7 +140,9 @@
 #include "deprecated/clutter-container.h"
 #include "deprecated/clutter-alpha.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
+#include "clutter-layout-animation.h"
 #include "clutter-layout-manager.h"
 #include "clutter-layout-meta.h"
 #include "clutter-marshal.h"
@@ -165,8 +167,8 @@ G_DEFINE_ABSTRACT_TYPE (ClutterLayoutManager,
                         clutter_layout_manager,
                         G_TYPE_INITIALLY_UNOWNED)
 
-static GQuark quark_layout_meta  = 0;
 static GQuark quark_layout_alpha = 0;
+static GQuark quark_layout_animation = 0;
 
 static guint manager_signals[LAST_SIGNAL] = { 0, };
 
@@ -392,13 +394,13 @@ layout_manager_real_end_animation (ClutterLayoutManager *manager)
 static void
 clutter_layout_manager_class_init (ClutterLayoutManagerClass *klass)
 {
-  quark_layout_meta =
-    g_quark_from_static_string ("clutter-layout-manager-child-meta");
-
   /* XXX:2.0 - Remove */
   quark_layout_alpha =
     g_quark_from_static_string ("clutter-layout-manager-alpha");
 
+  quark_layout_animation =
+    g_quark_from_static_string ("clutter-layout-manager-animation");
+
   klass->get_preferred_width = layout_manager_real_get_preferred_width;
   klass->get_preferred_height = layout_manager_real_get_preferred_height;
   klass->allocate = layout_manager_real_allocate;
@@ -643,7 +645,7 @@ get_child_meta (ClutterLayoutManager *manager,
 {
   ClutterLayoutMeta *layout = NULL;
 
-  layout = g_object_get_qdata (G_OBJECT (actor), quark_layout_meta);
+  layout = _clutter_actor_get_layout_meta (actor);
   if (layout != NULL)
     {
       ClutterChildMeta *child = CLUTTER_CHILD_META (layout);
@@ -663,15 +665,33 @@ get_child_meta (ClutterLayoutManager *manager,
   if (layout != NULL)
     {
       g_assert (CLUTTER_IS_LAYOUT_META (layout));
-      g_object_set_qdata_full (G_OBJECT (actor), quark_layout_meta,
-                               layout,
-                               (GDestroyNotify) g_object_unref);
+      _clutter_actor_set_layout_meta (actor, layout);
       return layout;
     }
 
   return NULL;
 }
 
+/*< private >
+ * _clutter_layout_manager_get_child_meta:
+ * @manager: a #ClutterLayoutManager
+ * @container: a #ClutterContainer using @manager
+ * @actor: a #ClutterActor child of @container
+ *
+ * Like clutter_layout_manager_get_child_meta(), without checking the
+ * types of the arguments, for the measure and allocate loops of the
+ * layout managers.
+ *
+ * Return value: (transfer none): a #ClutterLayoutMeta, or %NULL
+ */
+ClutterLayoutMeta *
+_clutter_layout_manager_get_child_meta (ClutterLayoutManager *manager,
+                                        ClutterContainer     *container,
+                                        ClutterActor         *actor)
+{
+  return get_child_meta (manager, container, actor);
+}
+
 /**
  * clutter_layout_manager_get_child_meta:
  * @manager: a #ClutterLayoutManager
@@ -1110,3 +1130,130 @@ clutter_layout_manager_list_child_properties (ClutterLayoutManager *manager,
 
   return pspecs;
 }
+
+/**
+ * clutter_layout_manager_set_allocation_easing:
+ * @manager: a #ClutterLayoutManager
+ * @mode: the easing mode of the animations
+ * @duration: the duration of the animations, in milliseconds, or 0
+ *   to disable them
+ *
+ * Animates the changes of the allocations of the children of the
+ * actor using @manager, instead of allocating them at their new
+ * position and size right away.
+ *
+ * The animations of all the children are driven by a single timeline,
+ * and the children are allocated in a single pass at each frame; no
+ * #ClutterTransition is created for the children. A relayout while the
+ * children are moving restarts the animation from their current
+ * allocation.
+ *
+ * While the animations are enabled, they replace the easing state of
+ * the children for their allocation. As with the implicit transitions,
+ * the children that are not mapped, or that were never allocated, are
+ * not animated.
+ *
+ * Since: 1.26
+ */
+void
+clutter_layout_manager_set_allocation_easing (ClutterLayoutManager *manager,
+                                              ClutterAnimationMode  mode,
+                                              guint                 duration)
+{
+  ClutterLayoutAnimation *animation;
+
+  g_return_if_fail (CLUTTER_IS_LAYOUT_MANAGER (manager));
+  g_return_if_fail (mode != CLUTTER_CUSTOM_MODE);
+
+  if (duration == 0)
+    {
+      g_object_set_qdata (G_OBJECT (manager), quark_layout_animation, NULL);
+      return;
+    }
+
+  animation = g_object_get_qdata (G_OBJECT (manager), quark_layout_animation);
+  if (animation == NULL)
+    {
+      animation = _clutter_layout_animation_new (mode, duration);
+      g_object_set_qdata_full (G_OBJECT (manager), quark_layout_animation,
+                               animation,
+                               (GDestroyNotify) _clutter_layout_animation_free);
+    }
+  else
+    _clutter_layout_animation_set_easing (animation, mode, duration);
+}
+
+/**
+ * clutter_layout_manager_get_allocation_easing:
+ * @manager: a #ClutterLayoutManager
+ * @mode: (out) (allow-none): return location for the easing mode, or %NULL
+ * @duration: (out) (allow-none): return location for the duration, or %NULL
+ *
+ * Retrieves the values set using clutter_layout_manager_set_allocation_easing().
+ *
+ * Since: 1.26
+ */
+void
+clutter_layout_manager_get_allocation_easing (ClutterLayoutManager *manager,
+                                              ClutterAnimationMode *mode,
+                                              guint                *duration)
+{
+  ClutterLayoutAnimation *animation;
+
+  g_return_if_fail (CLUTTER_IS_LAYOUT_MANAGER (manager));
+
+  animation = g_object_get_qdata (G_OBJECT (manager), quark_layout_animation);
+  if (animation == NULL)
+    {
+      if (mode != NULL)
+        *mode = CLUTTER_LINEAR;
+
+      if (duration != NULL)
+        *duration = 0;
+
+      return;
+    }
+
+  _clutter_layout_animation_get_easing (animation, mode, duration);
+}
+
+/*< private >
+ * _clutter_layout_manager_animate_allocation:
+ * @manager: a #ClutterLayoutManager
+ * @child: a child of the actor using @manager
+ * @from: the current allocation of @child
+ * @to: the new allocation of @child
+ * @flags: the allocation flags
+ * @animate: whether @child can be animated
+ *
+ * Animates the allocation of @child, if the animations of @manager
+ * are enabled and @animate is %TRUE.
+ *
+ * Return value: %TRUE if @manager animates the allocation of @child,
+ *   and %FALSE if @child should be allocated right away
+ */
+gboolean
+_clutter_layout_manager_animate_allocation (ClutterLayoutManager   *manager,
+                                            ClutterActor           *child,
+                                            const ClutterActorBox  *from,
+                                            const ClutterActorBox  *to,
+                                            ClutterAllocationFlags  flags,
+                                            gboolean                animate)
+{
+  ClutterLayoutAnimation *animation;
+
+  animation = g_object_get_qdata (G_OBJECT (manager), quark_layout_animation);
+  if (animation == NULL)
+    return FALSE;
+
+  if (!animate)
+    {
+      /* the allocation jumps, so the animation must not move it back */
+      _clutter_layout_animation_remove_child (animation, child);
+      return FALSE;
+    }
+
+  _clutter_layout_animation_add_child (animation, child, from, to, flags);
+
+  return TRUE;
+}
@@ -176,6 +176,15 @@ void               clutter_layout_manager_set_container         (ClutterLayoutMa
 CLUTTER_AVAILABLE_IN_1_2
 void               clutter_layout_manager_layout_changed        (ClutterLayoutManager   *manager);
 
+CLUTTER_AVAILABLE_IN_1_26
+void               clutter_layout_manager_set_allocation_easing (ClutterLayoutManager   *manager,
+                                                                 ClutterAnimationMode    mode,
+                                                                 guint                   duration);
+CLUTTER_AVAILABLE_IN_1_26
+void               clutter_layout_manager_get_allocation_easing (ClutterLayoutManager   *manager,
+                                                                 ClutterAnimationMode   *mode,
+                                                                 guint                  *duration);
+
 CLUTTER_AVAILABLE_IN_1_2
 GParamSpec *       clutter_layout_manager_find_child_property   (ClutterLayoutManager   *manager,
                                                                  const gchar            *name);
@@ -0,0 +1,1019 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-list-view
+ * @Title: ClutterListView
+ * @Short_Description: An actor that only creates the visible children
+ *   of a model
+ *
+ * #ClutterListView is an actor that displays the items of a #GListModel
+ * as a vertical list, or as a grid, of cells of the same size.
+ *
+ * Unlike clutter_actor_bind_model(), which creates a child for every item
+ * of the model, #ClutterListView only creates the children of the items
+ * that are inside the visible area, plus a prefetch margin above and below
+ * it; the memory and the layout costs depend on the size of the visible
+ * area instead of the number of items in the model.
+ *
+ * The visible area is the allocation of the parent of the #ClutterListView,
+ * offset by the #ClutterActor:child-transform of the parent; this makes
+ * #ClutterListView a natural child of a #ClutterScrollActor:
+ *
+ * |[<!-- language="C" -->
+ *   ClutterActor *scroll = clutter_scroll_actor_new ();
+ *   clutter_scroll_actor_set_scroll_mode (CLUTTER_SCROLL_ACTOR (scroll),
+ *                                         CLUTTER_SCROLL_VERTICALLY);
+ *   clutter_actor_set_size (scroll, 800, 600);
+ *
+ *   ClutterActor *view = clutter_list_view_new ();
+ *   clutter_list_view_set_item_size (CLUTTER_LIST_VIEW (view), 200, 100);
+ *   clutter_list_view_bind_model (CLUTTER_LIST_VIEW (view), model,
+ *                                 create_item, bind_item,
+ *                                 NULL, NULL);
+ *   clutter_actor_set_width (view, 800);
+ *   clutter_actor_add_child (scroll, view);
+ * ]|
+ *
+ * The children that scroll out of the prefetch area are kept aside and,
+ * if a #ClutterListViewBindChildFunc was passed to
+ * clutter_list_view_bind_model(), recycled for the items that scroll in,
+ * instead of being destroyed and created again.
+ *
+ * If the #ClutterListView:item-width property is set, the items are laid
+ * out as a grid, using as many columns as they fit in the width of the
+ * #ClutterListView; otherwise, every item spans the whole width.
+ *
+ * The children of a #ClutterListView are managed by the view, and should
+ * not be added or removed using the #ClutterActor API.
+ *
+ * #ClutterListView is available since Clutter 1.26.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include "clutter-list-view.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+#define DEFAULT_PREFETCH_MARGIN         200.f
+
+struct _ClutterListViewPrivate
+{
+  GListModel *model;
+  gulong items_changed_id;
+
+  ClutterActorCreateChildFunc create_child_func;
+  ClutterListViewBindChildFunc bind_child_func;
+  gpointer user_data;
+  GDestroyNotify notify;
+
+  gfloat item_width;
+  gfloat item_height;
+  gfloat prefetch_margin;
+
+  /* the children for the items in [first, first + children->len) */
+  guint first;
+  GPtrArray *children;
+
+  /* the unparented children waiting to be bound to a new item */
+  GPtrArray *pool;
+
+  /* the geometry of the last allocation */
+  guint n_columns;
+  gfloat width;
+  gfloat y_offset;
+  gfloat viewport_height;
+
+  /* the parent, whose allocation defines the visible area */
+  ClutterActor *viewport;
+  gulong viewport_transform_id;
+  gulong viewport_allocation_id;
+
+  guint update_id;
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_MODEL,
+  PROP_ITEM_WIDTH,
+  PROP_ITEM_HEIGHT,
+  PROP_PREFETCH_MARGIN,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (ClutterListView, clutter_list_view, CLUTTER_TYPE_ACTOR)
+
+static inline guint
+clutter_list_view_get_n_items (ClutterListView *self)
+{
+  if (self->priv->model == NULL)
+    return 0;
+
+  return g_list_model_get_n_items (self->priv->model);
+}
+
+static guint
+clutter_list_view_get_n_columns (ClutterListView *self,
+                                 gfloat           width)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->item_width <= 0.f || width <= 0.f)
+    return 1;
+
+  return MAX (1, (guint) floorf (width / priv->item_width));
+}
+
+/* computes the range of items that should have a child, using the
+ * geometry of the last allocation and the current scroll offset
+ */
+static void
+clutter_list_view_compute_range (ClutterListView *self,
+                                 guint           *first_p,
+                                 guint           *last_p)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  ClutterMatrix transform;
+  gfloat y1, y2;
+  guint n_items, row1, row2;
+
+  *first_p = *last_p = 0;
+
+  n_items = clutter_list_view_get_n_items (self);
+  if (n_items == 0 || priv->viewport == NULL ||
+      priv->n_columns == 0 || priv->item_height <= 0.f)
+    return;
+
+  /* the child transform of a scrolling parent moves the visible area
+   * across the view
+   */
+  clutter_actor_get_child_transform (priv->viewport, &transform);
+
+  y1 = -transform.yw - priv->y_offset - priv->prefetch_margin;
+  y2 = -transform.yw - priv->y_offset + priv->viewport_height + priv->prefetch_margin;
+
+  if (y2 <= 0.f)
+    return;
+
+  row1 = (guint) floorf (MAX (y1, 0.f) / priv->item_height);
+  row2 = (guint) ceilf (y2 / priv->item_height);
+
+  *first_p = MIN (row1 * priv->n_columns, n_items);
+  *last_p = MIN (row2 * priv->n_columns, n_items);
+}
+
+static void
+clutter_list_view_release_child (ClutterListView *self,
+                                 ClutterActor    *child)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (child == NULL)
+    return;
+
+  /* the child might have been destroyed behind our back */
+  if (clutter_actor_get_parent (child) == CLUTTER_ACTOR (self))
+    {
+      if (priv->bind_child_func != NULL)
+        {
+          g_ptr_array_add (priv->pool, g_object_ref (child));
+          clutter_actor_remove_child (CLUTTER_ACTOR (self), child);
+        }
+      else
+        clutter_actor_destroy (child);
+    }
+
+  g_object_unref (child);
+}
+
+/* releases the children of the items starting at @position */
+static void
+clutter_list_view_release_children (ClutterListView *self,
+                                    guint            position)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  guint i, start;
+
+  if (position >= priv->first + priv->children->len)
+    return;
+
+  start = position > priv->first ? position - priv->first : 0;
+
+  for (i = start; i < priv->children->len; i++)
+    clutter_list_view_release_child (self, g_ptr_array_index (priv->children, i));
+
+  g_ptr_array_set_size (priv->children, start);
+
+  if (priv->children->len == 0)
+    priv->first = 0;
+}
+
+static ClutterActor *
+clutter_list_view_create_child (ClutterListView *self,
+                                guint            position)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  ClutterActor *child = NULL;
+  gpointer item;
+
+  item = g_list_model_get_item (priv->model, position);
+
+  while (child == NULL && priv->pool->len > 0)
+    {
+      child = g_ptr_array_index (priv->pool, priv->pool->len - 1);
+      g_ptr_array_remove_index_fast (priv->pool, priv->pool->len - 1);
+
+      if (CLUTTER_ACTOR_IN_DESTRUCTION (child))
+        {
+          g_object_unref (child);
+          child = NULL;
+        }
+    }
+
+  if (child != NULL)
+    {
+      priv->bind_child_func (child, item, priv->user_data);
+    }
+  else
+    {
+      child = priv->create_child_func (item, priv->user_data);
+
+      if (child == NULL)
+        {
+          g_critical ("The function passed to clutter_list_view_bind_model() "
+                      "did not return an actor for the item at position %u",
+                      position);
+          g_object_unref (item);
+          return NULL;
+        }
+
+      g_object_ref_sink (child);
+    }
+
+  g_object_unref (item);
+
+  clutter_actor_add_child (CLUTTER_ACTOR (self), child);
+
+  return child;
+}
+
+static void
+clutter_list_view_update_children (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  GPtrArray *children;
+  guint first, last, i;
+
+  clutter_list_view_compute_range (self, &first, &last);
+
+  if (first == priv->first && last - first == priv->children->len)
+    return;
+
+  CLUTTER_NOTE (LAYOUT, "List view '%s': items [%u, %u) -> [%u, %u)",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (self)),
+                priv->first, priv->first + priv->children->len,
+                first, last);
+
+  children = g_ptr_array_sized_new (last - first);
+  g_ptr_array_set_size (children, last - first);
+
+  /* keep the children of the items that are still in the range */
+  for (i = 0; i < priv->children->len; i++)
+    {
+      guint position = priv->first + i;
+
+      if (position >= first && position < last)
+        {
+          g_ptr_array_index (children, position - first) =
+            g_ptr_array_index (priv->children, i);
+          g_ptr_array_index (priv->children, i) = NULL;
+        }
+    }
+
+  /* release the others before creating the new ones, so that they
+   * can be recycled
+   */
+  for (i = 0; i < priv->children->len; i++)
+    clutter_list_view_release_child (self, g_ptr_array_index (priv->children, i));
+
+  g_ptr_array_unref (priv->children);
+  priv->children = children;
+  priv->first = first;
+
+  for (i = 0; i < children->len; i++)
+    {
+      if (g_ptr_array_index (children, i) == NULL)
+        g_ptr_array_index (children, i) =
+          clutter_list_view_create_child (self, first + i);
+    }
+
+  /* keep at most as many spare children as the ones in use */
+  while (priv->pool->len > children->len)
+    {
+      ClutterActor *child = g_ptr_array_index (priv->pool, priv->pool->len - 1);
+
+      g_ptr_array_remove_index_fast (priv->pool, priv->pool->len - 1);
+      clutter_actor_destroy (child);
+      g_object_unref (child);
+    }
+}
+
+static gboolean
+clutter_list_view_update_func (gpointer data)
+{
+  ClutterListView *self = data;
+
+  self->priv->update_id = 0;
+
+  clutter_list_view_update_children (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* the children are updated right before the next stage update, so that
+ * we never add or remove children while the stage is being allocated
+ */
+static void
+clutter_list_view_queue_update (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->update_id != 0)
+    return;
+
+  priv->update_id =
+    clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                           CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                           clutter_list_view_update_func,
+                                           self,
+                                           NULL);
+}
+
+static void
+on_viewport_changed (GObject         *gobject,
+                     GParamSpec      *pspec,
+                     ClutterListView *self)
+{
+  clutter_list_view_queue_update (self);
+}
+
+static void
+clutter_list_view_set_viewport (ClutterListView *self,
+                                ClutterActor    *viewport)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->viewport == viewport)
+    return;
+
+  if (priv->viewport != NULL)
+    {
+      g_signal_handler_disconnect (priv->viewport, priv->viewport_transform_id);
+      g_signal_handler_disconnect (priv->viewport, priv->viewport_allocation_id);
+      priv->viewport_transform_id = 0;
+      priv->viewport_allocation_id = 0;
+    }
+
+  priv->viewport = viewport;
+
+  if (priv->viewport != NULL)
+    {
+      priv->viewport_transform_id =
+        g_signal_connect (priv->viewport, "notify::child-transform",
+                          G_CALLBACK (on_viewport_changed),
+                          self);
+      priv->viewport_allocation_id =
+        g_signal_connect (priv->viewport, "notify::allocation",
+                          G_CALLBACK (on_viewport_changed),
+                          self);
+    }
+
+  clutter_list_view_queue_update (self);
+}
+
+static void
+on_items_changed (GListModel      *model,
+                  guint            position,
+                  guint            removed,
+                  guint            added,
+                  ClutterListView *self)
+{
+  /* the items after @position have moved, so their children are
+   * bound to the wrong items
+   */
+  clutter_list_view_release_children (self, position);
+
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+  clutter_list_view_queue_update (self);
+}
+
+static void
+clutter_list_view_clear_model (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  clutter_list_view_release_children (self, 0);
+
+  /* the spare children might not be compatible with the new model */
+  while (priv->pool->len > 0)
+    {
+      ClutterActor *child = g_ptr_array_index (priv->pool, priv->pool->len - 1);
+
+      g_ptr_array_remove_index_fast (priv->pool, priv->pool->len - 1);
+      clutter_actor_destroy (child);
+      g_object_unref (child);
+    }
+
+  if (priv->model != NULL)
+    {
+      g_signal_handler_disconnect (priv->model, priv->items_changed_id);
+      priv->items_changed_id = 0;
+      g_clear_object (&priv->model);
+    }
+
+  if (priv->notify != NULL)
+    priv->notify (priv->user_data);
+
+  priv->create_child_func = NULL;
+  priv->bind_child_func = NULL;
+  priv->user_data = NULL;
+  priv->notify = NULL;
+}
+
+static void
+clutter_list_view_get_preferred_width (ClutterActor *actor,
+                                       gfloat        for_height,
+                                       gfloat       *min_width_p,
+                                       gfloat       *natural_width_p)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (actor)->priv;
+
+  /* a single column; lists get their width from their parent */
+  *min_width_p = *natural_width_p = MAX (priv->item_width, 0.f);
+}
+
+static void
+clutter_list_view_get_preferred_height (ClutterActor *actor,
+                                        gfloat        for_width,
+                                        gfloat       *min_height_p,
+                                        gfloat       *natural_height_p)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+  ClutterListViewPrivate *priv = self->priv;
+  guint n_items, n_columns, n_rows;
+
+  n_items = clutter_list_view_get_n_items (self);
+  n_columns = clutter_list_view_get_n_columns (self, for_width);
+  n_rows = (n_items + n_columns - 1) / n_columns;
+
+  *min_height_p = *natural_height_p = n_rows * MAX (priv->item_height, 0.f);
+}
+
+static void
+clutter_list_view_allocate (ClutterActor           *actor,
+                            const ClutterActorBox  *box,
+                            ClutterAllocationFlags  flags)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+  ClutterListViewPrivate *priv = self->priv;
+  gfloat cell_width;
+  guint first, last, i;
+
+  clutter_actor_set_allocation (actor, box, flags);
+
+  priv->width = clutter_actor_box_get_width (box);
+  priv->n_columns = clutter_list_view_get_n_columns (self, priv->width);
+  priv->y_offset = box->y1;
+
+  if (priv->viewport != NULL)
+    {
+      ClutterActorBox viewport_box;
+
+      clutter_actor_get_allocation_box (priv->viewport, &viewport_box);
+      priv->viewport_height = clutter_actor_box_get_height (&viewport_box);
+    }
+
+  /* the new geometry might need a different set of children */
+  clutter_list_view_compute_range (self, &first, &last);
+  if (first != priv->first || last - first != priv->children->len)
+    clutter_list_view_queue_update (self);
+
+  cell_width = priv->item_width > 0.f ? priv->item_width : priv->width;
+
+  for (i = 0; i < priv->children->len; i++)
+    {
+      ClutterActor *child = g_ptr_array_index (priv->children, i);
+      guint position = priv->first + i;
+      ClutterActorBox child_box;
+
+      if (child == NULL)
+        continue;
+
+      child_box.x1 = (position % priv->n_columns) * cell_width;
+      child_box.y1 = (position / priv->n_columns) * priv->item_height;
+      child_box.x2 = child_box.x1 + cell_width;
+      child_box.y2 = child_box.y1 + priv->item_height;
+
+      clutter_actor_allocate (child, &child_box, flags);
+    }
+}
+
+static void
+clutter_list_view_parent_set (ClutterActor *actor,
+                              ClutterActor *old_parent)
+{
+  clutter_list_view_set_viewport (CLUTTER_LIST_VIEW (actor),
+                                  clutter_actor_get_parent (actor));
+}
+
+static void
+clutter_list_view_dispose (GObject *gobject)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (gobject);
+  ClutterListViewPrivate *priv = self->priv;
+
+  clutter_list_view_set_viewport (self, NULL);
+  clutter_list_view_clear_model (self);
+
+  if (priv->update_id != 0)
+    {
+      clutter_threads_remove_repaint_func (priv->update_id);
+      priv->update_id = 0;
+    }
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_list_view_finalize (GObject *gobject)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  g_ptr_array_unref (priv->children);
+  g_ptr_array_unref (priv->pool);
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_list_view_set_property (GObject      *gobject,
+                                guint         prop_id,
+                                const GValue *value,
+                                GParamSpec   *pspec)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (gobject);
+  ClutterListViewPrivate *priv = self->priv;
+
+  switch (prop_id)
+    {
+    case PROP_ITEM_WIDTH:
+      clutter_list_view_set_item_size (self,
+                                       g_value_get_float (value),
+                                       priv->item_height);
+      break;
+
+    case PROP_ITEM_HEIGHT:
+      clutter_list_view_set_item_size (self,
+                                       priv->item_width,
+                                       g_value_get_float (value));
+      break;
+
+    case PROP_PREFETCH_MARGIN:
+      clutter_list_view_set_prefetch_margin (self, g_value_get_float (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_list_view_get_property (GObject    *gobject,
+                                guint       prop_id,
+                                GValue     *value,
+                                GParamSpec *pspec)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, priv->model);
+      break;
+
+    case PROP_ITEM_WIDTH:
+      g_value_set_float (value, priv->item_width);
+      break;
+
+    case PROP_ITEM_HEIGHT:
+      g_value_set_float (value, priv->item_height);
+      break;
+
+    case PROP_PREFETCH_MARGIN:
+      g_value_set_float (value, priv->prefetch_margin);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_list_view_class_init (ClutterListViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+
+  gobject_class->set_property = clutter_list_view_set_property;
+  gobject_class->get_property = clutter_list_view_get_property;
+  gobject_class->dispose = clutter_list_view_dispose;
+  gobject_class->finalize = clutter_list_view_finalize;
+
+  actor_class->get_preferred_width = clutter_list_view_get_preferred_width;
+  actor_class->get_preferred_height = clutter_list_view_get_preferred_height;
+  actor_class->allocate = clutter_list_view_allocate;
+  actor_class->parent_set = clutter_list_view_parent_set;
+
+  /**
+   * ClutterListView:model:
+   *
+   * The #GListModel set using clutter_list_view_bind_model().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_MODEL] =
+    g_param_spec_object ("model",
+                         P_("Model"),
+                         P_("The model of the items"),
+                         G_TYPE_LIST_MODEL,
+                         CLUTTER_PARAM_READABLE);
+
+  /**
+   * ClutterListView:item-width:
+   *
+   * The width of each item, or 0 to use the whole width of the
+   * #ClutterListView.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ITEM_WIDTH] =
+    g_param_spec_float ("item-width",
+                        P_("Item Width"),
+                        P_("The width of each item, or 0 for the whole width"),
+                        0.f, G_MAXFLOAT,
+                        0.f,
+                        CLUTTER_PARAM_READWRITE);
+
+  /**
+   * ClutterListView:item-height:
+   *
+   * The height of each item.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ITEM_HEIGHT] =
+    g_param_spec_float ("item-height",
+                        P_("Item Height"),
+                        P_("The height of each item"),
+                        0.f, G_MAXFLOAT,
+                        0.f,
+                        CLUTTER_PARAM_READWRITE);
+
+  /**
+   * ClutterListView:prefetch-margin:
+   *
+   * The distance, in pixels, above and below the visible area within
+   * which the items have a child.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_PREFETCH_MARGIN] =
+    g_param_spec_float ("prefetch-margin",
+                        P_("Prefetch Margin"),
+                        P_("The distance outside the visible area within which the items have a child"),
+                        0.f, G_MAXFLOAT,
+                        DEFAULT_PREFETCH_MARGIN,
+                        CLUTTER_PARAM_READWRITE);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
+static void
+clutter_list_view_init (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv;
+
+  self->priv = priv = clutter_list_view_get_instance_private (self);
+
+  priv->prefetch_margin = DEFAULT_PREFETCH_MARGIN;
+  priv->children = g_ptr_array_new ();
+  priv->pool = g_ptr_array_new ();
+}
+
+/**
+ * clutter_list_view_new:
+ *
+ * Creates a new #ClutterListView.
+ *
+ * Return value: the newly created #ClutterListView
+ *
+ * Since: 1.26
+ */
+ClutterActor *
+clutter_list_view_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_LIST_VIEW, NULL);
+}
+
+/**
+ * clutter_list_view_bind_model:
+ * @view: a #ClutterListView
+ * @model: (nullable): a #GListModel
+ * @create_child_func: a function that creates the #ClutterActor for an
+ *   item of @model
+ * @bind_child_func: (nullable): a function that updates a recycled
+ *   #ClutterActor for another item of @model, or %NULL to destroy the
+ *   children instead of recycling them
+ * @user_data: data passed to @create_child_func and @bind_child_func
+ * @notify: function called when unsetting the @model
+ *
+ * Binds a #GListModel to a #ClutterListView.
+ *
+ * The @view will create children, using @create_child_func, only for the
+ * items of @model inside the visible area and its prefetch margin.
+ *
+ * The children of the items that scroll out of the prefetch area are
+ * passed to @bind_child_func, if set, and reused for the items that
+ * scroll in.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_bind_model (ClutterListView              *view,
+                              GListModel                   *model,
+                              ClutterActorCreateChildFunc   create_child_func,
+                              ClutterListViewBindChildFunc  bind_child_func,
+                              gpointer                      user_data,
+                              GDestroyNotify                notify)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_child_func != NULL);
+
+  priv = view->priv;
+
+  clutter_list_view_clear_model (view);
+
+  if (model != NULL)
+    {
+      priv->model = g_object_ref (model);
+      priv->create_child_func = create_child_func;
+      priv->bind_child_func = bind_child_func;
+      priv->user_data = user_data;
+      priv->notify = notify;
+
+      priv->items_changed_id =
+        g_signal_connect (priv->model, "items-changed",
+                          G_CALLBACK (on_items_changed),
+                          view);
+    }
+
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+  clutter_list_view_queue_update (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_MODEL]);
+}
+
+/**
+ * clutter_list_view_get_model:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the model set using clutter_list_view_bind_model().
+ *
+ * Return value: (transfer none) (nullable): the #GListModel
+ *
+ * Since: 1.26
+ */
+GListModel *
+clutter_list_view_get_model (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  return view->priv->model;
+}
+
+/**
+ * clutter_list_view_set_item_size:
+ * @view: a #ClutterListView
+ * @width: the width of each item, or 0 to use the whole width
+ *   of the @view
+ * @height: the height of each item
+ *
+ * Sets the size of the cells used to lay out the items of @view.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_item_size (ClutterListView *view,
+                                 gfloat           width,
+                                 gfloat           height)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (width >= 0.f && height >= 0.f);
+
+  priv = view->priv;
+
+  g_object_freeze_notify (G_OBJECT (view));
+
+  if (priv->item_width != width)
+    {
+      priv->item_width = width;
+      g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_ITEM_WIDTH]);
+    }
+
+  if (priv->item_height != height)
+    {
+      priv->item_height = height;
+      g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_ITEM_HEIGHT]);
+    }
+
+  g_object_thaw_notify (G_OBJECT (view));
+
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+}
+
+/**
+ * clutter_list_view_get_item_size:
+ * @view: a #ClutterListView
+ * @width: (out) (optional): return location for the width, or %NULL
+ * @height: (out) (optional): return location for the height, or %NULL
+ *
+ * Retrieves the size set using clutter_list_view_set_item_size().
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_get_item_size (ClutterListView *view,
+                                 gfloat          *width,
+                                 gfloat          *height)
+{
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  if (width != NULL)
+    *width = view->priv->item_width;
+
+  if (height != NULL)
+    *height = view->priv->item_height;
+}
+
+/**
+ * clutter_list_view_set_prefetch_margin:
+ * @view: a #ClutterListView
+ * @margin: the prefetch margin, in pixels
+ *
+ * Sets the distance above and below the visible area within which the
+ * items of @view have a child.
+ *
+ * A larger margin avoids creating or binding the children while the
+ * @view is being scrolled, at the cost of more children.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_prefetch_margin (ClutterListView *view,
+                                       gfloat           margin)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (margin >= 0.f);
+
+  priv = view->priv;
+
+  if (priv->prefetch_margin == margin)
+    return;
+
+  priv->prefetch_margin = margin;
+
+  clutter_list_view_queue_update (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_PREFETCH_MARGIN]);
+}
+
+/**
+ * clutter_list_view_get_prefetch_margin:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the value set using clutter_list_view_set_prefetch_margin().
+ *
+ * Return value: the prefetch margin, in pixels
+ *
+ * Since: 1.26
+ */
+gfloat
+clutter_list_view_get_prefetch_margin (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0.f);
+
+  return view->priv->prefetch_margin;
+}
+
+/**
+ * clutter_list_view_get_item_child:
+ * @view: a #ClutterListView
+ * @position: the position of an item in the model
+ *
+ * Retrieves the child of @view for the item at @position.
+ *
+ * Return value: (transfer none) (nullable): the child, or %NULL if
+ *   the item is outside of the visible area and of the prefetch margin
+ *
+ * Since: 1.26
+ */
+ClutterActor *
+clutter_list_view_get_item_child (ClutterListView *view,
+                                  guint            position)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  priv = view->priv;
+
+  if (position < priv->first ||
+      position >= priv->first + priv->children->len)
+    return NULL;
+
+  return g_ptr_array_index (priv->children, position - priv->first);
+}
+
+/**
+ * clutter_list_view_get_child_range:
+ * @view: a #ClutterListView
+ * @first: (out) (optional): return location for the position of the
+ *   first item with a child, or %NULL
+ * @n_children: (out) (optional): return location for the number of
+ *   items with a child, or %NULL
+ *
+ * Retrieves the range of items of the model that currently have a child.
+ *
+ * Return value: %TRUE if at least an item has a child
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_list_view_get_child_range (ClutterListView *view,
+                                   guint           *first,
+                                   guint           *n_children)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), FALSE);
+
+  priv = view->priv;
+
+  if (first != NULL)
+    *first = priv->first;
+
+  if (n_children != NULL)
+    *n_children = priv->children->len;
+
+  return priv->children->len > 0;
+}
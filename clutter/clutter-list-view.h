@@ -0,0 +1,131 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_LIST_VIEW_H__
+#define __CLUTTER_LIST_VIEW_H__
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#include <clutter/clutter-types.h>
+#include <clutter/clutter-actor.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_LIST_VIEW                  (clutter_list_view_get_type ())
+#define CLUTTER_LIST_VIEW(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListView))
+#define CLUTTER_IS_LIST_VIEW(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+#define CLUTTER_IS_LIST_VIEW_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+
+typedef struct _ClutterListViewPrivate          ClutterListViewPrivate;
+typedef struct _ClutterListViewClass            ClutterListViewClass;
+
+/**
+ * ClutterListView:
+ *
+ * The #ClutterListView structure contains only
+ * private data, and should be accessed using the provided API.
+ *
+ * Since: 1.26
+ */
+struct _ClutterListView
+{
+  /*< private >*/
+  ClutterActor parent_instance;
+
+  ClutterListViewPrivate *priv;
+};
+
+/**
+ * ClutterListViewClass:
+ *
+ * The #ClutterListViewClass structure contains only
+ * private data.
+ *
+ * Since: 1.26
+ */
+struct _ClutterListViewClass
+{
+  /*< private >*/
+  ClutterActorClass parent_class;
+
+  gpointer _padding[8];
+};
+
+/**
+ * ClutterListViewBindChildFunc:
+ * @child: a #ClutterActor created by the #ClutterActorCreateChildFunc
+ *   passed to clutter_list_view_bind_model()
+ * @item: (type GObject): the new item in the model
+ * @user_data: Data passed to clutter_list_view_bind_model()
+ *
+ * Updates a recycled @child so that it represents @item.
+ *
+ * Since: 1.26
+ */
+typedef void (* ClutterListViewBindChildFunc) (ClutterActor *child,
+                                               gpointer      item,
+                                               gpointer      user_data);
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_list_view_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterActor *          clutter_list_view_new                   (void);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_bind_model            (ClutterListView              *view,
+                                                                 GListModel                   *model,
+                                                                 ClutterActorCreateChildFunc   create_child_func,
+                                                                 ClutterListViewBindChildFunc  bind_child_func,
+                                                                 gpointer                      user_data,
+                                                                 GDestroyNotify                notify);
+CLUTTER_AVAILABLE_IN_1_26
+GListModel *            clutter_list_view_get_model             (ClutterListView              *view);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_item_size         (ClutterListView              *view,
+                                                                 gfloat                        width,
+                                                                 gfloat                        height);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_get_item_size         (ClutterListView              *view,
+                                                                 gfloat                       *width,
+                                                                 gfloat                       *height);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_prefetch_margin   (ClutterListView              *view,
+                                                                 gfloat                        margin);
+CLUTTER_AVAILABLE_IN_1_26
+gfloat                  clutter_list_view_get_prefetch_margin   (ClutterListView              *view);
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterActor *          clutter_list_view_get_item_child        (ClutterListView              *view,
+                                                                 guint                         position);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_list_view_get_child_range       (ClutterListView              *view,
+                                                                 guint                        *first,
+                                                                 guint                        *n_children);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_LIST_VIEW_H__ */
@@ -53,8 +53,15 @@
 
 #include <stdlib.h>
 #include <glib/gi18n-lib.h>
+#include <gio/gio.h>
 #include <locale.h>
 
+#ifdef HAVE_PANGO_FT2
+/* for pango_fc_font_map_set_config() */
+#define PANGO_ENABLE_BACKEND
+#include <pango/pangofc-fontmap.h>
+#endif /* HAVE_PANGO_FT2 */
+
 #include "clutter-actor-private.h"
 #include "clutter-backend-private.h"
 #include "clutter-config.h"
@@ -62,12 +69,16 @@
 #include "clutter-device-manager-private.h"
 #include "clutter-event-private.h"
 #include "clutter-feature.h"
+#include "clutter-image-cache.h"
 #include "clutter-main.h"
 #include "clutter-master-clock.h"
 #include "clutter-private.h"
+#include "clutter-sdf-glyph-cache.h"
 #include "clutter-settings-private.h"
 #include "clutter-stage-manager.h"
 #include "clutter-stage-private.h"
+#include "clutter-text-layout-cache.h"
+#include "clutter-trace.h"
 #include "clutter-version.h" 	/* For flavour define */
 
 #ifdef CLUTTER_WINDOWING_OSX
@@ -94,6 +105,9 @@
 #ifdef CLUTTER_WINDOWING_ANDROID
 #include "android/clutter-backend-android.h"
 #endif
+#ifdef CLUTTER_WINDOWING_HEADLESS
+#include "headless/clutter-backend-headless.h"
+#endif
 
 #include <cogl/cogl.h>
 #include <cogl-pango/cogl-pango.h>
@@ -112,16 +126,32 @@ static GCallback clutter_threads_unlock      = NULL;
 /* command line options */
 static gboolean clutter_is_initialized       = FALSE;
 static gboolean clutter_show_fps             = FALSE;
+static gboolean clutter_show_hud             = FALSE;
 static gboolean clutter_fatal_warnings       = FALSE;
 static gboolean clutter_disable_mipmap_text  = FALSE;
 static gboolean clutter_use_fuzzy_picking    = FALSE;
 static gboolean clutter_enable_accessibility = TRUE;
 static gboolean clutter_sync_to_vblank       = TRUE;
+static gboolean clutter_distance_field_text  = FALSE;
+static gboolean clutter_staged_init          = FALSE;
+static gboolean clutter_pipelined_swaps      = FALSE;
 
 static guint clutter_default_fps             = 60;
+static guint clutter_measure_threads         = 0;
+static gsize clutter_text_layout_cache_size  = 0;
+static gsize clutter_image_cache_size        = 32 * 1024 * 1024;
+static guint clutter_image_atlas_max_size    = 128;
+static gsize clutter_upload_budget           = 4 * 1024 * 1024;
+
+/* the files used to record and replay the input events */
+static gchar *clutter_record_events          = NULL;
+static gchar *clutter_replay_events          = NULL;
 
 static ClutterTextDirection clutter_text_direction = CLUTTER_TEXT_DIRECTION_LTR;
 
+/* the start up timeline, see clutter_get_startup_info() */
+static ClutterStartupInfo clutter_startup_info = { 0, };
+
 static guint clutter_main_loop_level         = 0;
 static GSList *main_loops                    = NULL;
 
@@ -129,6 +159,7 @@ static GSList *main_loops                    = NULL;
 guint clutter_debug_flags       = 0;
 guint clutter_paint_debug_flags = 0;
 guint clutter_pick_debug_flags  = 0;
+guint clutter_trace_flags       = 0;
 
 const guint clutter_major_version = CLUTTER_MAJOR_VERSION;
 const guint clutter_minor_version = CLUTTER_MINOR_VERSION;
@@ -157,6 +188,8 @@ static const GDebugKey clutter_debug_keys[] = {
 static const GDebugKey clutter_pick_debug_keys[] = {
   { "nop-picking", CLUTTER_DEBUG_NOP_PICKING },
   { "dump-pick-buffers", CLUTTER_DEBUG_DUMP_PICK_BUFFERS },
+  { "disable-pick-cache", CLUTTER_DEBUG_DISABLE_PICK_CACHE },
+  { "disable-grab-pick-skip", CLUTTER_DEBUG_DISABLE_GRAB_PICK_SKIP },
 };
 
 static const GDebugKey clutter_paint_debug_keys[] = {
@@ -168,8 +201,24 @@ static const GDebugKey clutter_paint_debug_keys[] = {
   { "disable-offscreen-redirect", CLUTTER_DEBUG_DISABLE_OFFSCREEN_REDIRECT },
   { "continuous-redraw", CLUTTER_DEBUG_CONTINUOUS_REDRAW },
   { "paint-deform-tiles", CLUTTER_DEBUG_PAINT_DEFORM_TILES },
+  { "disable-retained-paint-nodes", CLUTTER_DEBUG_DISABLE_RETAINED_PAINT_NODES },
+  { "overdraw", CLUTTER_DEBUG_OVERDRAW },
+  { "batch-breaks", CLUTTER_DEBUG_BATCH_BREAKS },
 };
 
+#ifdef CLUTTER_ENABLE_TRACING
+static const GDebugKey clutter_trace_keys[] = {
+  { "stage", CLUTTER_TRACE_STAGE },
+  { "layout", CLUTTER_TRACE_LAYOUT },
+  { "paint", CLUTTER_TRACE_PAINT },
+  { "paint-actors", CLUTTER_TRACE_PAINT_ACTORS },
+  { "pick", CLUTTER_TRACE_PICK },
+  { "text", CLUTTER_TRACE_TEXT },
+  { "effects", CLUTTER_TRACE_EFFECTS },
+  { "clock", CLUTTER_TRACE_CLOCK },
+};
+#endif /* CLUTTER_ENABLE_TRACING */
+
 static void
 clutter_threads_impl_lock (void)
 {
@@ -234,6 +283,16 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
   else
     clutter_show_fps = bool_value;
 
+  bool_value =
+    g_key_file_get_boolean (keyfile, ENVIRONMENT_GROUP,
+                            "ShowHud",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_show_hud = bool_value;
+
   bool_value =
     g_key_file_get_boolean (keyfile, ENVIRONMENT_GROUP,
                             "DisableMipmappedText",
@@ -264,6 +323,16 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
   else
     clutter_enable_accessibility = bool_value;
 
+  bool_value =
+    g_key_file_get_boolean (keyfile, ENVIRONMENT_GROUP,
+                            "StagedInit",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_staged_init = bool_value;
+
   bool_value =
     g_key_file_get_boolean (keyfile, ENVIRONMENT_GROUP,
                             "SyncToVblank",
@@ -442,6 +511,14 @@ _clutter_context_get_show_fps (void)
   return context->show_fps;
 }
 
+gboolean
+_clutter_context_get_show_hud (void)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  return context->show_hud;
+}
+
 /**
  * clutter_get_accessibility_enabled:
  *
@@ -482,6 +559,60 @@ clutter_disable_accessibility (void)
   clutter_enable_accessibility = FALSE;
 }
 
+/**
+ * clutter_enable_staged_init:
+ *
+ * Enables the staged initialization of Clutter. It has the same effect
+ * as setting the environment variable CLUTTER_STAGED_INIT, and it should
+ * be called before clutter_init().
+ *
+ * With the staged initialization, the parts of Clutter that are not
+ * needed to paint the first frame, like the accessibility support, are
+ * initialized once the first frame has been painted; on Android, the
+ * Cogl renderer is also connected while the application is waiting for
+ * its window.
+ *
+ * See also clutter_get_startup_info().
+ *
+ * Since: 1.26
+ */
+void
+clutter_enable_staged_init (void)
+{
+  if (clutter_is_initialized)
+    {
+      g_warning ("clutter_enable_staged_init() can only be called before "
+                 "initializing Clutter.");
+      return;
+    }
+
+  clutter_staged_init = TRUE;
+}
+
+/**
+ * clutter_get_startup_info:
+ * @info: (out caller-allocates): return location for the start up
+ *   timeline
+ *
+ * Retrieves the timeline of the start up of Clutter, from the creation
+ * of the windowing system backend to the presentation of the first
+ * frame; the phases that did not happen yet are set to 0.
+ *
+ * The time to the first frame is the difference between the
+ * #ClutterStartupInfo.first_frame_time, or the
+ * #ClutterStartupInfo.first_frame_presented, and the
+ * #ClutterStartupInfo.init_start fields.
+ *
+ * Since: 1.26
+ */
+void
+clutter_get_startup_info (ClutterStartupInfo *info)
+{
+  g_return_if_fail (info != NULL);
+
+  *info = clutter_startup_info;
+}
+
 /**
  * clutter_redraw:
  *
@@ -562,6 +693,45 @@ clutter_get_motion_events_enabled (void)
   return _clutter_context_get_motion_events_enabled ();
 }
 
+/*< private >
+ * _clutter_set_pick_color_bits:
+ * @red_bits: the number of bits of the red channel of the pick target
+ * @green_bits: the number of bits of the green channel of the pick target
+ * @blue_bits: the number of bits of the blue channel of the pick target
+ *
+ * Sets the layout of the framebuffer that the pick is going to be
+ * rendered to, so that _clutter_id_to_color() and _clutter_pixel_to_id()
+ * can use all the bits it provides to store the identifiers.
+ */
+void
+_clutter_set_pick_color_bits (gint red_bits,
+                              gint green_bits,
+                              gint blue_bits)
+{
+  ClutterMainContext *ctx;
+
+  ctx = _clutter_context_get_default ();
+
+  ctx->fb_r_mask = MIN (red_bits, 8);
+  ctx->fb_g_mask = MIN (green_bits, 8);
+  ctx->fb_b_mask = MIN (blue_bits, 8);
+
+  ctx->fb_r_mask_used = ctx->fb_r_mask;
+  ctx->fb_g_mask_used = ctx->fb_g_mask;
+  ctx->fb_b_mask_used = ctx->fb_b_mask;
+
+  /* "fuzzy picking" drops the lowest bit of each channel and sets it
+   * when painting, so that drivers that do not round the colors
+   * exactly still read back the same identifier
+   */
+  if (clutter_use_fuzzy_picking)
+    {
+      ctx->fb_r_mask_used--;
+      ctx->fb_g_mask_used--;
+      ctx->fb_b_mask_used--;
+    }
+}
+
 void
 _clutter_id_to_color (guint         id_,
                       ClutterColor *col)
@@ -573,24 +743,26 @@ _clutter_id_to_color (guint         id_,
 
   if (ctx->fb_g_mask == 0)
     {
-      /* Figure out framebuffer masks used for pick */
-      cogl_get_bitmasks (&ctx->fb_r_mask,
-			 &ctx->fb_g_mask,
-			 &ctx->fb_b_mask, NULL);
+      gint red_bits, green_bits, blue_bits;
 
-      ctx->fb_r_mask_used = ctx->fb_r_mask;
-      ctx->fb_g_mask_used = ctx->fb_g_mask;
-      ctx->fb_b_mask_used = ctx->fb_b_mask;
+      /* Figure out framebuffer masks used for pick */
+      cogl_get_bitmasks (&red_bits, &green_bits, &blue_bits, NULL);
 
-      /* XXX - describe what "fuzzy picking" is */
-      if (clutter_use_fuzzy_picking)
-	{
-	  ctx->fb_r_mask_used--;
-	  ctx->fb_g_mask_used--;
-	  ctx->fb_b_mask_used--;
-	}
+      _clutter_set_pick_color_bits (red_bits, green_bits, blue_bits);
     }
 
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (G_UNLIKELY (id_ >= (1u << (ctx->fb_r_mask_used +
+                                 ctx->fb_g_mask_used +
+                                 ctx->fb_b_mask_used))))
+    CLUTTER_NOTE (PICK, "The pick identifier %u does not fit in the "
+                  "%d:%d:%d bits of the pick framebuffer",
+                  id_,
+                  ctx->fb_r_mask_used,
+                  ctx->fb_g_mask_used,
+                  ctx->fb_b_mask_used);
+#endif /* CLUTTER_ENABLE_DEBUG */
+
   /* compute the numbers we'll store in the components */
   red   = (id_ >> (ctx->fb_g_mask_used+ctx->fb_b_mask_used))
         & (0xff >> (8-ctx->fb_r_mask_used));
@@ -693,6 +865,8 @@ clutter_context_get_pango_fontmap (void)
   if (G_LIKELY (self->font_map != NULL))
     return self->font_map;
 
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_FONT_MAP_START, 0);
+
   font_map = COGL_PANGO_FONT_MAP (cogl_pango_font_map_new ());
 
   resolution = clutter_backend_get_resolution (self->backend);
@@ -703,6 +877,8 @@ clutter_context_get_pango_fontmap (void)
 
   self->font_map = font_map;
 
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_FONT_MAP_END, 0);
+
   return self->font_map;
 }
 
@@ -1125,6 +1301,189 @@ clutter_threads_add_timeout (guint       interval,
                                            NULL);
 }
 
+typedef struct _ClutterTimeoutSource
+{
+  GSource source;
+
+  /* all in microseconds */
+  gint64 interval;
+  gint64 slack;
+  gint64 deadline;
+} ClutterTimeoutSource;
+
+static void
+clutter_timeout_source_schedule (ClutterTimeoutSource *timeout_source,
+                                 gint64                current_time)
+{
+  gint64 granularity = 1;
+  gint64 ready_time;
+
+  timeout_source->deadline = current_time + timeout_source->interval;
+
+  /* the timeouts wake up at the multiples of the largest power of two
+   * fitting in their slack, so timeouts with compatible slacks share
+   * the same wake ups; since the multiples of a power of two are
+   * multiples of the smaller ones, the timeouts with a large slack
+   * also line up with the ones with a smaller slack
+   */
+  while (granularity * 2 <= timeout_source->slack)
+    granularity *= 2;
+
+  ready_time = (timeout_source->deadline + granularity - 1) / granularity;
+  ready_time *= granularity;
+
+  g_source_set_ready_time (&timeout_source->source, ready_time);
+}
+
+static gboolean
+clutter_timeout_source_prepare (GSource *source,
+                                gint    *timeout)
+{
+  ClutterTimeoutSource *timeout_source = (ClutterTimeoutSource *) source;
+
+  /* the wake up is driven by the ready time; if the main loop is
+   * woken up by anything else after the deadline, like a frame, we
+   * dispatch right away instead of waking it up again later
+   */
+  *timeout = -1;
+
+  return g_source_get_time (source) >= timeout_source->deadline;
+}
+
+static gboolean
+clutter_timeout_source_check (GSource *source)
+{
+  ClutterTimeoutSource *timeout_source = (ClutterTimeoutSource *) source;
+
+  return g_source_get_time (source) >= timeout_source->deadline;
+}
+
+static gboolean
+clutter_timeout_source_dispatch (GSource     *source,
+                                 GSourceFunc  callback,
+                                 gpointer     user_data)
+{
+  ClutterTimeoutSource *timeout_source = (ClutterTimeoutSource *) source;
+
+  if (callback == NULL)
+    return G_SOURCE_REMOVE;
+
+  if (!callback (user_data))
+    return G_SOURCE_REMOVE;
+
+  clutter_timeout_source_schedule (timeout_source, g_source_get_time (source));
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs clutter_timeout_source_funcs = {
+  clutter_timeout_source_prepare,
+  clutter_timeout_source_check,
+  clutter_timeout_source_dispatch,
+  NULL
+};
+
+/**
+ * clutter_threads_add_coalesced_timeout_full: (rename-to clutter_threads_add_coalesced_timeout)
+ * @priority: the priority of the timeout source. Typically this will be in the
+ *            range between #G_PRIORITY_DEFAULT and #G_PRIORITY_HIGH.
+ * @interval: the time between calls to the function, in milliseconds
+ * @slack: the time by which each call to the function can be delayed,
+ *   in milliseconds
+ * @func: function to call
+ * @data: data to pass to the function
+ * @notify: function to call when the timeout source is removed
+ *
+ * Similar to clutter_threads_add_timeout_full(), except that each call
+ * to @func can happen up to @slack milliseconds after the end of the
+ * @interval.
+ *
+ * Clutter uses the slack to coalesce the timeouts: the timeouts with
+ * compatible slacks wake up the main loop at the same time, and the
+ * timeouts expiring while the main loop is already awake, for instance
+ * while painting a frame, are dispatched without waking up the main
+ * loop again. This is useful for timeouts that do not need to be
+ * accurate, like hiding a hint or blinking a cursor, as it reduces the
+ * number of wake ups of the application.
+ *
+ * A @slack of 0 makes the timeout as accurate as the ones added by
+ * clutter_threads_add_timeout_full().
+ *
+ * Return value: the ID (greater than 0) of the event source.
+ *
+ * Since: 1.26
+ */
+guint
+clutter_threads_add_coalesced_timeout_full (gint           priority,
+                                            guint          interval,
+                                            guint          slack,
+                                            GSourceFunc    func,
+                                            gpointer       data,
+                                            GDestroyNotify notify)
+{
+  ClutterTimeoutSource *timeout_source;
+  ClutterThreadsDispatch *dispatch;
+  GSource *source;
+  guint retval;
+
+  g_return_val_if_fail (func != NULL, 0);
+
+  dispatch = g_slice_new (ClutterThreadsDispatch);
+  dispatch->func = func;
+  dispatch->data = data;
+  dispatch->notify = notify;
+
+  source = g_source_new (&clutter_timeout_source_funcs,
+                         sizeof (ClutterTimeoutSource));
+  timeout_source = (ClutterTimeoutSource *) source;
+  timeout_source->interval = (gint64) interval * 1000;
+  timeout_source->slack = (gint64) slack * 1000;
+
+  clutter_timeout_source_schedule (timeout_source, g_get_monotonic_time ());
+
+  if (priority != G_PRIORITY_DEFAULT)
+    g_source_set_priority (source, priority);
+
+  g_source_set_name (source, "Clutter coalesced timeout");
+  g_source_set_callback (source,
+                         _clutter_threads_dispatch, dispatch,
+                         _clutter_threads_dispatch_free);
+
+  retval = g_source_attach (source, NULL);
+
+  g_source_unref (source);
+
+  return retval;
+}
+
+/**
+ * clutter_threads_add_coalesced_timeout: (skip)
+ * @interval: the time between calls to the function, in milliseconds
+ * @slack: the time by which each call to the function can be delayed,
+ *   in milliseconds
+ * @func: function to call
+ * @data: data to pass to the function
+ *
+ * Simple wrapper around clutter_threads_add_coalesced_timeout_full().
+ *
+ * Return value: the ID (greater than 0) of the event source.
+ *
+ * Since: 1.26
+ */
+guint
+clutter_threads_add_coalesced_timeout (guint       interval,
+                                       guint       slack,
+                                       GSourceFunc func,
+                                       gpointer    data)
+{
+  g_return_val_if_fail (func != NULL, 0);
+
+  return clutter_threads_add_coalesced_timeout_full (G_PRIORITY_DEFAULT,
+                                                     interval, slack,
+                                                     func, data,
+                                                     NULL);
+}
+
 void
 _clutter_threads_acquire_lock (void)
 {
@@ -1221,6 +1580,8 @@ clutter_context_get_default_unlocked (void)
     {
       ClutterMainContext *ctx;
 
+      _clutter_startup_mark (CLUTTER_STARTUP_MARK_INIT_START, 0);
+
       ClutterCntx = ctx = g_new0 (ClutterMainContext, 1);
 
       ctx->is_initialized = FALSE;
@@ -1329,6 +1690,48 @@ clutter_init_error_quark (void)
   return g_quark_from_static_string ("clutter-init-error-quark");
 }
 
+static void
+clutter_init_accessibility (void)
+{
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_ACCESSIBILITY_START, 0);
+
+  cally_accessibility_init ();
+
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_ACCESSIBILITY_END, 0);
+}
+
+static gboolean
+clutter_staged_init_idle (gpointer data G_GNUC_UNUSED)
+{
+  CLUTTER_NOTE (MISC, "Completing the staged initialization");
+
+  /* the font map is created on demand, so this is a no-op if the
+   * first frame already had some text in it
+   */
+  clutter_context_get_pango_fontmap ();
+
+  if (clutter_enable_accessibility)
+    clutter_init_accessibility ();
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+clutter_staged_init_after_paint (gpointer data G_GNUC_UNUSED)
+{
+  /* wait for a frame to reach the screen before doing the rest of the
+   * initialization, at a priority lower than the redraws
+   */
+  if (clutter_startup_info.first_frame_time == 0)
+    return G_SOURCE_CONTINUE;
+
+  clutter_threads_add_idle_full (G_PRIORITY_LOW,
+                                 clutter_staged_init_idle,
+                                 NULL, NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
 static ClutterInitError
 clutter_init_real (GError **error)
 {
@@ -1361,6 +1764,8 @@ clutter_init_real (GError **error)
   if (!_clutter_backend_post_parse (backend, error))
     return CLUTTER_INIT_ERROR_BACKEND;
 
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_BACKEND_END, 0);
+
   /* If we are displaying the regions that would get redrawn with clipped
    * redraws enabled we actually have to disable the clipped redrawing
    * because otherwise we end up with nasty trails of rectangles everywhere.
@@ -1375,23 +1780,46 @@ clutter_init_real (GError **error)
         CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS | CLUTTER_DEBUG_DISABLE_CULLING;
     }
 
+  /* ...and when visualizing the overdraw or the batch breaks, which
+   * only make sense for the whole stage
+   */
+  if (clutter_paint_debug_flags & (CLUTTER_DEBUG_OVERDRAW |
+                                   CLUTTER_DEBUG_BATCH_BREAKS))
+    clutter_paint_debug_flags |= CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS;
+
   /* this will take care of initializing Cogl's state and
    * query the GL machinery for features
    */
   if (!_clutter_feature_init (error))
     return CLUTTER_INIT_ERROR_BACKEND;
 
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_CONTEXT_END, 0);
+
   clutter_text_direction = clutter_get_text_direction ();
 
   /* Initiate event collection */
   _clutter_backend_init_events (ctx->backend);
 
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_EVENTS_END, 0);
+
   clutter_is_initialized = TRUE;
   ctx->is_initialized = TRUE;
 
-  /* Initialize a11y */
-  if (clutter_enable_accessibility)
-    cally_accessibility_init ();
+  /* Initialize a11y; with the staged initialization, the accessibility
+   * support is initialized after the first frame
+   */
+  if (clutter_staged_init)
+    {
+      CLUTTER_NOTE (MISC, "Deferring the accessibility and font map setup");
+
+      clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_POST_PAINT,
+                                             clutter_staged_init_after_paint,
+                                             NULL, NULL);
+    }
+  else if (clutter_enable_accessibility)
+    clutter_init_accessibility ();
+
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_INIT_END, 0);
 
   return CLUTTER_INIT_SUCCESS;
 }
@@ -1487,10 +1915,26 @@ pre_parse_hook (GOptionContext  *context,
       env_string = NULL;
     }
 
+#ifdef CLUTTER_ENABLE_TRACING
+  env_string = g_getenv ("CLUTTER_TRACE");
+  if (env_string != NULL)
+    {
+      clutter_trace_flags =
+        g_parse_debug_string (env_string,
+                              clutter_trace_keys,
+                              G_N_ELEMENTS (clutter_trace_keys));
+      env_string = NULL;
+    }
+#endif /* CLUTTER_ENABLE_TRACING */
+
   env_string = g_getenv ("CLUTTER_SHOW_FPS");
   if (env_string)
     clutter_show_fps = TRUE;
 
+  env_string = g_getenv ("CLUTTER_SHOW_HUD");
+  if (env_string)
+    clutter_show_hud = TRUE;
+
   env_string = g_getenv ("CLUTTER_DEFAULT_FPS");
   if (env_string)
     {
@@ -1511,6 +1955,66 @@ pre_parse_hook (GOptionContext  *context,
   if (g_strcmp0 (env_string, "none") == 0)
     clutter_sync_to_vblank = FALSE;
 
+  env_string = g_getenv ("CLUTTER_MEASURE_THREADS");
+  if (env_string)
+    {
+      gint measure_threads = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_measure_threads = CLAMP (measure_threads, 0, 64);
+    }
+
+  env_string = g_getenv ("CLUTTER_TEXT_LAYOUT_CACHE");
+  if (env_string)
+    {
+      gint64 cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      /* the size is in kilobytes */
+      clutter_text_layout_cache_size = CLAMP (cache_size, 0, G_MAXUINT32 / 1024) * 1024;
+    }
+
+  env_string = g_getenv ("CLUTTER_IMAGE_CACHE");
+  if (env_string)
+    {
+      gint64 cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      /* the size is in kilobytes */
+      clutter_image_cache_size = CLAMP (cache_size, 0, G_MAXUINT32 / 1024) * 1024;
+    }
+
+  env_string = g_getenv ("CLUTTER_IMAGE_ATLAS");
+  if (env_string)
+    {
+      gint64 max_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      /* the size is in pixels */
+      clutter_image_atlas_max_size = CLAMP (max_size, 0, 512);
+    }
+
+  env_string = g_getenv ("CLUTTER_UPLOAD_BUDGET");
+  if (env_string)
+    {
+      gint64 budget = g_ascii_strtoll (env_string, NULL, 10);
+
+      /* the size is in kilobytes */
+      clutter_upload_budget = CLAMP (budget, 0, G_MAXUINT32 / 1024) * 1024;
+    }
+
+  env_string = g_getenv ("CLUTTER_STAGED_INIT");
+  if (env_string)
+    clutter_staged_init = TRUE;
+
+  env_string = g_getenv ("CLUTTER_PIPELINED_SWAPS");
+  if (env_string)
+    clutter_pipelined_swaps = TRUE;
+
+  env_string = g_getenv ("CLUTTER_RECORD_EVENTS");
+  if (env_string && *env_string != '\0')
+    clutter_record_events = g_strdup (env_string);
+
+  env_string = g_getenv ("CLUTTER_REPLAY_EVENTS");
+  if (env_string && *env_string != '\0')
+    clutter_replay_events = g_strdup (env_string);
+
   return _clutter_backend_pre_parse (backend, error);
 }
 
@@ -1544,6 +2048,7 @@ post_parse_hook (GOptionContext  *context,
 
   clutter_context->frame_rate = clutter_default_fps;
   clutter_context->show_fps = clutter_show_fps;
+  clutter_context->show_hud = clutter_show_hud;
   clutter_context->options_parsed = TRUE;
 
   /* If not asked to defer display setup, call clutter_init_real(),
@@ -2118,27 +2623,85 @@ is_off_stage (ClutterActor *stage,
           y >= height);
 }
 
-/**
- * clutter_do_event:
- * @event: a #ClutterEvent.
- *
- * Processes an event.
- *
- * The @event must be a valid #ClutterEvent and have a #ClutterStage
- * associated to it.
- *
- * This function is only useful when embedding Clutter inside another
- * toolkit, and it should never be called by applications.
- *
- * Since: 0.4
+/* the grabs route the motion to the grab actor whatever the actor
+ * underneath is, so the pick is only needed for the crossing events;
+ * the pointer actor of the device is updated by the first pick after
+ * the grab, which emits the crossing events that were skipped
  */
-void
-clutter_do_event (ClutterEvent *event)
+static gboolean
+actor_wants_crossing_events (ClutterActor *actor)
 {
-  /* we need the stage for the event */
-  if (event->any.stage == NULL)
-    {
-      g_warning ("%s: Event does not have a stage: discarding.", G_STRFUNC);
+  static guint enter_event_id = 0, leave_event_id = 0, event_id = 0;
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (actor);
+
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_DISABLE_GRAB_PICK_SKIP))
+    return TRUE;
+
+  if (klass->enter_event != NULL ||
+      klass->leave_event != NULL ||
+      klass->event != NULL)
+    return TRUE;
+
+  if (G_UNLIKELY (event_id == 0))
+    {
+      enter_event_id = g_signal_lookup ("enter-event", CLUTTER_TYPE_ACTOR);
+      leave_event_id = g_signal_lookup ("leave-event", CLUTTER_TYPE_ACTOR);
+      event_id = g_signal_lookup ("event", CLUTTER_TYPE_ACTOR);
+    }
+
+  return g_signal_has_handler_pending (actor, enter_event_id, 0, FALSE) ||
+         g_signal_has_handler_pending (actor, leave_event_id, 0, FALSE) ||
+         g_signal_has_handler_pending (actor, event_id, 0, FALSE);
+}
+
+static ClutterActor *
+get_motion_grab_actor (ClutterEvent       *event,
+                       ClutterInputDevice *device)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+  ClutterActor *grab_actor = NULL;
+
+  if (event->type == CLUTTER_MOTION)
+    {
+      if (context->pointer_grab_actor != NULL)
+        grab_actor = context->pointer_grab_actor;
+      else if (device != NULL)
+        grab_actor = device->pointer_grab_actor;
+    }
+  else if (event->type == CLUTTER_TOUCH_UPDATE)
+    {
+      if (device != NULL && device->sequence_grab_actors != NULL)
+        grab_actor = g_hash_table_lookup (device->sequence_grab_actors,
+                                          event->touch.sequence);
+    }
+
+  if (grab_actor == NULL || actor_wants_crossing_events (grab_actor))
+    return NULL;
+
+  return grab_actor;
+}
+
+/**
+ * clutter_do_event:
+ * @event: a #ClutterEvent.
+ *
+ * Processes an event.
+ *
+ * The @event must be a valid #ClutterEvent and have a #ClutterStage
+ * associated to it.
+ *
+ * This function is only useful when embedding Clutter inside another
+ * toolkit, and it should never be called by applications.
+ *
+ * Since: 0.4
+ */
+void
+clutter_do_event (ClutterEvent *event)
+{
+  /* we need the stage for the event */
+  if (event->any.stage == NULL)
+    {
+      g_warning ("%s: Event does not have a stage: discarding.", G_STRFUNC);
       return;
     }
 
@@ -2296,7 +2859,7 @@ _clutter_process_event_details (ClutterActor        *stage,
       case CLUTTER_TOUCHPAD_PINCH:
       case CLUTTER_TOUCHPAD_SWIPE:
         {
-          ClutterActor *actor;
+          ClutterActor *actor, *grab_actor;
           gfloat x, y;
 
           clutter_event_get_coords (event, &x, &y);
@@ -2304,6 +2867,16 @@ _clutter_process_event_details (ClutterActor        *stage,
           /* Only do a pick to find the source if source is not already set
            * (as it could be in a synthetic event)
            */
+          if (event->any.source == NULL &&
+              (grab_actor = get_motion_grab_actor (event, device)) != NULL)
+            {
+              CLUTTER_NOTE (EVENT, "Motion inside a grab, skipping the pick");
+
+              event->any.source = grab_actor;
+              emit_pointer_event (event, device);
+              break;
+            }
+
           if (event->any.source == NULL)
             {
               /* emulate X11 the implicit soft grab; the implicit soft grab
@@ -2423,7 +2996,7 @@ _clutter_process_event_details (ClutterActor        *stage,
       case CLUTTER_TOUCH_CANCEL:
       case CLUTTER_TOUCH_END:
         {
-          ClutterActor *actor;
+          ClutterActor *actor, *grab_actor;
           ClutterEventSequence *sequence;
           gfloat x, y;
 
@@ -2438,6 +3011,16 @@ _clutter_process_event_details (ClutterActor        *stage,
           /* Only do a pick to find the source if source is not already set
            * (as it could be in a synthetic event)
            */
+          if (event->any.source == NULL &&
+              (grab_actor = get_motion_grab_actor (event, device)) != NULL)
+            {
+              CLUTTER_NOTE (EVENT, "Touch update inside a grab, skipping the pick");
+
+              event->any.source = grab_actor;
+              emit_touch_event (event, device);
+              break;
+            }
+
           if (event->any.source == NULL)
             {
               /* same as the mouse events above, emulate the X11 implicit
@@ -2511,6 +3094,96 @@ _clutter_process_event_details (ClutterActor        *stage,
     }
 }
 
+/* the most positions picked in a single pass; this matches the size
+ * of the pick cache of the stage
+ */
+#define MAX_BATCHED_PICKS       16
+
+/*
+ * _clutter_pick_queued_touch_events:
+ * @stage: the #ClutterStage the events have been queued on
+ * @events: (array length=n_events): the queued events
+ * @n_events: the number of events in @events
+ *
+ * Picks the actors underneath all the touch events inside @events that
+ * will need a pick when processed, using a single pass when possible.
+ *
+ * The results are stored in the pick cache of @stage, so processing
+ * the events later on does not need to pick again, unless an event
+ * handler changes the scene in between.
+ */
+void
+_clutter_pick_queued_touch_events (ClutterStage  *stage,
+                                   ClutterEvent **events,
+                                   guint          n_events)
+{
+  ClutterPoint positions[MAX_BATCHED_PICKS];
+  ClutterActor *actors[MAX_BATCHED_PICKS];
+  guint n_positions = 0;
+  guint n;
+
+  for (n = 0; n < n_events && n_positions < MAX_BATCHED_PICKS; n++)
+    {
+      ClutterEvent *event = events[n];
+      ClutterInputDevice *device;
+      ClutterPoint point;
+      guint i;
+
+      if (event->any.stage != stage || event->any.source != NULL)
+        continue;
+
+      switch (event->type)
+        {
+        case CLUTTER_TOUCH_UPDATE:
+          /* see _clutter_process_event_details() */
+          if (!clutter_stage_get_motion_events_enabled (stage))
+            continue;
+          break;
+
+        case CLUTTER_TOUCH_BEGIN:
+        case CLUTTER_TOUCH_END:
+        case CLUTTER_TOUCH_CANCEL:
+          break;
+
+        default:
+          continue;
+        }
+
+      /* the device picks at its own coordinates, which have already
+       * been updated by the last queued event of the sequence
+       */
+      device = clutter_event_get_device (event);
+      if (device != NULL)
+        clutter_input_device_get_coords (device,
+                                         clutter_event_get_event_sequence (event),
+                                         &point);
+      else
+        clutter_event_get_coords (event, &point.x, &point.y);
+
+      if (is_off_stage (CLUTTER_ACTOR (stage), point.x, point.y))
+        continue;
+
+      for (i = 0; i < n_positions; i++)
+        {
+          if ((gint) positions[i].x == (gint) point.x &&
+              (gint) positions[i].y == (gint) point.y)
+            break;
+        }
+
+      if (i == n_positions)
+        positions[n_positions++] = point;
+    }
+
+  if (n_positions < 2)
+    return;
+
+  CLUTTER_NOTE (EVENT, "Picking %u touch points at once", n_positions);
+
+  _clutter_stage_do_pick_multiple (stage, positions, n_positions,
+                                   CLUTTER_PICK_REACTIVE,
+                                   actors);
+}
+
 /*
  * _clutter_process_event
  * @event: a #ClutterEvent.
@@ -3045,6 +3718,8 @@ clutter_clear_glyph_cache (void)
 
   font_map = clutter_context_get_pango_fontmap ();
   cogl_pango_font_map_clear_glyph_cache (font_map);
+
+  _clutter_sdf_glyph_cache_clear ();
 }
 
 /**
@@ -3060,6 +3735,10 @@ clutter_clear_glyph_cache (void)
  * Enabling hinting improves text quality for static text but may
  * introduce some artifacts if the text is animated.
  *
+ * Using distance field glyphs keeps the text sharp when it is scaled
+ * or when its size is animated, at the cost of slightly softer glyphs
+ * at small sizes; see #ClutterText:use-distance-field.
+ *
  * Since: 1.0
  *
  * Deprecated: 1.10: Use clutter_backend_set_font_options() and the
@@ -3089,6 +3768,9 @@ clutter_set_font_flags (ClutterFontFlags flags)
       hint_style != CAIRO_HINT_STYLE_NONE)
     old_flags |= CLUTTER_FONT_HINTING;
 
+  if (clutter_distance_field_text)
+    old_flags |= CLUTTER_FONT_DISTANCE_FIELD;
+
   if (old_flags == flags)
     return;
 
@@ -3114,6 +3796,10 @@ clutter_set_font_flags (ClutterFontFlags flags)
       cairo_font_options_set_hint_style (new_font_options, hint_style);
     }
 
+  if ((changed_flags & CLUTTER_FONT_DISTANCE_FIELD))
+    clutter_distance_field_text = (flags & CLUTTER_FONT_DISTANCE_FIELD) != 0;
+
+  /* this also queues a redraw of the text actors */
   clutter_backend_set_font_options (backend, new_font_options);
 
   cairo_font_options_destroy (new_font_options);
@@ -3152,6 +3838,9 @@ clutter_get_font_flags (void)
       hint_style != CAIRO_HINT_STYLE_NONE)
     flags |= CLUTTER_FONT_HINTING;
 
+  if (clutter_distance_field_text)
+    flags |= CLUTTER_FONT_DISTANCE_FIELD;
+
   return flags;
 }
 
@@ -3207,15 +3896,286 @@ clutter_get_font_map (void)
   return PANGO_FONT_MAP (clutter_context_get_pango_fontmap ());
 }
 
+/**
+ * clutter_load_font_config:
+ * @config_file: the path of a fontconfig configuration file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads a prebuilt font configuration, to be used by the font map of
+ * Clutter instead of the configuration of the system.
+ *
+ * Building the font configuration of the system at run time requires
+ * scanning all the font directories, and computing the coverage of
+ * every font, which can take a large part of the start up time on
+ * platforms, like Android, where the result is not cached by the
+ * system. An application can instead ship a snapshot of the
+ * configuration: @config_file lists the font directories and the
+ * fallback rules, and a `<cachedir>` element names a directory
+ * holding the caches made by `fc-cache` for those directories, which
+ * are memory-mapped instead of being computed again. On Android, the
+ * files must be extracted from the APK assets to the file system, e.g.
+ * in the files directory of the application.
+ *
+ * The caches are only used for the font directories they match; the
+ * directories that changed since the snapshot was made, e.g. after an
+ * update of the system fonts, are scanned again at run time.
+ *
+ * This function should be called after clutter_init(), before any
+ * text is laid out; if the font map already exists, its fonts are
+ * loaded again, and the #ClutterBackend::font-changed signal is
+ * emitted.
+ *
+ * Return value: %TRUE if the configuration was loaded; if %FALSE is
+ *   returned, the configuration of the system is used
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_load_font_config (const gchar  *config_file,
+                          GError      **error)
+{
+#ifdef HAVE_PANGO_FT2
+  ClutterMainContext *context;
+  FcConfig *config;
+  gint64 start_time;
+
+  g_return_val_if_fail (config_file != NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  start_time = g_get_monotonic_time ();
+
+  config = FcConfigCreate ();
+
+  if (!FcConfigParseAndLoad (config, (const FcChar8 *) config_file, FcTrue))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                   "Unable to load the font configuration from '%s'",
+                   config_file);
+      FcConfigDestroy (config);
+      return FALSE;
+    }
+
+  /* the directories whose cache is stale or missing are scanned here */
+  if (!FcConfigBuildFonts (config))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "Unable to build the fonts of the configuration '%s'",
+                   config_file);
+      FcConfigDestroy (config);
+      return FALSE;
+    }
+
+  /* the configuration is kept for the lifetime of the process */
+  FcConfigSetCurrent (config);
+
+  CLUTTER_NOTE (MISC, "Loaded the font configuration '%s' in %.3f ms",
+                config_file,
+                (g_get_monotonic_time () - start_time) / 1000.0);
+
+  context = _clutter_context_get_default ();
+  if (context->font_map != NULL &&
+      PANGO_IS_FC_FONT_MAP (context->font_map))
+    {
+      pango_fc_font_map_set_config (PANGO_FC_FONT_MAP (context->font_map),
+                                    config);
+
+      if (context->backend != NULL)
+        g_signal_emit_by_name (context->backend, "font-changed");
+    }
+
+  return TRUE;
+#else
+  g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+               "Font configurations are not supported by this build");
+
+  return FALSE;
+#endif /* HAVE_PANGO_FT2 */
+}
+
+/* the number of characters added to the glyph cache by each
+ * iteration of clutter_warm_glyph_cache()
+ */
+#define GLYPH_CACHE_WARM_CHUNK  64
+
+typedef struct _GlyphCacheWarm
+{
+  PangoContext *context;
+  PangoFontDescription *font_desc;
+  gchar *characters;
+  const gchar *next;
+} GlyphCacheWarm;
+
+static void
+glyph_cache_warm_free (gpointer data)
+{
+  GlyphCacheWarm *warm = data;
+
+  g_object_unref (warm->context);
+
+  if (warm->font_desc != NULL)
+    pango_font_description_free (warm->font_desc);
+
+  g_free (warm->characters);
+
+  g_slice_free (GlyphCacheWarm, warm);
+}
+
+static gboolean
+glyph_cache_warm_step (gpointer data)
+{
+  GlyphCacheWarm *warm = data;
+  PangoLayout *layout;
+  const gchar *end;
+  glong n_chars;
+
+  n_chars = g_utf8_strlen (warm->next, -1);
+  end = g_utf8_offset_to_pointer (warm->next, MIN (n_chars, GLYPH_CACHE_WARM_CHUNK));
+
+  layout = pango_layout_new (warm->context);
+
+  if (warm->font_desc != NULL)
+    pango_layout_set_font_description (layout, warm->font_desc);
+
+  pango_layout_set_text (layout, warm->next, end - warm->next);
+
+  cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+  g_object_unref (layout);
+
+  warm->next = end;
+
+  return *warm->next != '\0' ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/**
+ * clutter_warm_glyph_cache:
+ * @font_name: (allow-none): a font name, as accepted by
+ *   pango_font_description_from_string(), or %NULL for the
+ *   default font
+ * @characters: the characters to add to the glyph cache
+ *
+ * Adds the glyphs of @characters in @font_name to the glyph cache used
+ * to render text, so that the first paint of text using them does not
+ * need to rasterize them.
+ *
+ * The glyphs are rasterized in small batches when the main loop is
+ * idle, to avoid blocking the frames; this function can be called
+ * during the start up of the application, right after clutter_init().
+ *
+ * Since: 1.26
+ */
+void
+clutter_warm_glyph_cache (const gchar *font_name,
+                          const gchar *characters)
+{
+  GlyphCacheWarm *warm;
+
+  g_return_if_fail (characters != NULL);
+  g_return_if_fail (g_utf8_validate (characters, -1, NULL));
+
+  if (*characters == '\0')
+    return;
+
+  warm = g_slice_new0 (GlyphCacheWarm);
+  warm->context = _clutter_create_pango_context ();
+  warm->characters = g_strdup (characters);
+  warm->next = warm->characters;
+
+  if (font_name != NULL)
+    warm->font_desc = pango_font_description_from_string (font_name);
+
+  CLUTTER_NOTE (PANGO, "Warming the glyph cache for %ld characters of '%s'",
+                g_utf8_strlen (characters, -1),
+                font_name != NULL ? font_name : "the default font");
+
+  clutter_threads_add_idle_full (G_PRIORITY_LOW,
+                                 glyph_cache_warm_step,
+                                 warm,
+                                 glyph_cache_warm_free);
+}
+
+/**
+ * clutter_trim_memory:
+ * @flags: the resources to release
+ *
+ * Releases the resources described by @flags, to lower the memory
+ * used by Clutter while the application is not visible, or when the
+ * system is running low on memory.
+ *
+ * All of the released resources can be created again from the state
+ * of the actors, and they are created again the next time they are
+ * painted; this makes the first frames painted after trimming slower.
+ *
+ * Since: 1.26
+ */
+void
+clutter_trim_memory (ClutterTrimMemoryFlags flags)
+{
+  ClutterStageManager *stage_manager;
+  const GSList *l;
+
+  if (!_clutter_context_is_initialized ())
+    return;
+
+  CLUTTER_NOTE (MISC, "Trimming memory (flags: %x)", flags);
+
+  stage_manager = clutter_stage_manager_get_default ();
+
+  for (l = clutter_stage_manager_peek_stages (stage_manager);
+       l != NULL;
+       l = l->next)
+    {
+      _clutter_stage_trim_memory (l->data, flags);
+    }
+
+  if (flags & CLUTTER_TRIM_MEMORY_GLYPH_CACHES)
+    {
+      cogl_pango_font_map_clear_glyph_cache (clutter_context_get_pango_fontmap ());
+      _clutter_sdf_glyph_cache_clear ();
+      _clutter_text_layout_cache_clear ();
+    }
+
+  /* the images released by the stages go to the cache */
+  if (flags & CLUTTER_TRIM_MEMORY_IMAGE_CACHE)
+    _clutter_image_cache_clear ();
+}
+
 typedef struct _ClutterRepaintFunction
 {
   guint id;
   ClutterRepaintFlags flags;
+  gint priority;
   GSourceFunc func;
   gpointer data;
   GDestroyNotify notify;
+
+  /* set when the function was skipped by the last frame because the
+   * repaint functions budget ran out
+   */
+  guint deferred : 1;
 } ClutterRepaintFunction;
 
+/* keeps the list sorted by priority; among the functions with the same
+ * priority, the most recently added ones run first
+ */
+static GList *
+repaint_func_list_insert (GList                  *list,
+                          ClutterRepaintFunction *repaint_func)
+{
+  GList *l;
+
+  for (l = list; l != NULL; l = l->next)
+    {
+      ClutterRepaintFunction *iter = l->data;
+
+      if (iter->priority >= repaint_func->priority)
+        break;
+    }
+
+  /* appends if l is NULL */
+  return g_list_insert_before (list, l, repaint_func);
+}
+
 /**
  * clutter_threads_remove_repaint_func:
  * @handle_id: an unsigned integer greater than zero
@@ -3354,6 +4314,47 @@ clutter_threads_add_repaint_func_full (ClutterRepaintFlags flags,
                                        GSourceFunc         func,
                                        gpointer            data,
                                        GDestroyNotify      notify)
+{
+  return clutter_threads_add_repaint_func_with_priority (flags,
+                                                         G_PRIORITY_DEFAULT,
+                                                         func,
+                                                         data, notify);
+}
+
+/**
+ * clutter_threads_add_repaint_func_with_priority:
+ * @flags: flags for the repaint function
+ * @priority: the priority of the repaint function, like %G_PRIORITY_DEFAULT
+ * @func: the function to be called within the paint cycle
+ * @data: data to be passed to the function, or %NULL
+ * @notify: function to be called when removing the repaint
+ *    function, or %NULL
+ *
+ * Adds a function to be called whenever Clutter is processing a new
+ * frame, like clutter_threads_add_repaint_func_full().
+ *
+ * The repaint functions are called in order of @priority, with the
+ * lower values first, as for #GSource; functions with the same
+ * priority are called starting from the most recently added.
+ *
+ * Repaint functions with a priority lower than %G_PRIORITY_DEFAULT,
+ * like %G_PRIORITY_LOW or %G_PRIORITY_DEFAULT_IDLE, are deferred to
+ * the next frame if the budget set using
+ * clutter_threads_set_repaint_func_budget() is exhausted when they
+ * should be called; a function is never deferred two frames in a row.
+ *
+ * Return value: the ID (greater than 0) of the repaint function. You
+ *   can use the returned integer to remove the repaint function by
+ *   calling clutter_threads_remove_repaint_func().
+ *
+ * Since: 1.26
+ */
+guint
+clutter_threads_add_repaint_func_with_priority (ClutterRepaintFlags flags,
+                                                gint                priority,
+                                                GSourceFunc         func,
+                                                gpointer            data,
+                                                GDestroyNotify      notify)
 {
   ClutterMainContext *context;
   ClutterRepaintFunction *repaint_func;
@@ -3370,12 +4371,14 @@ clutter_threads_add_repaint_func_full (ClutterRepaintFlags flags,
 
   /* mask out QUEUE_REDRAW_ON_ADD, since we're going to consume it */
   repaint_func->flags = flags & ~CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD;
+  repaint_func->priority = priority;
   repaint_func->func = func;
   repaint_func->data = data;
   repaint_func->notify = notify;
+  repaint_func->deferred = FALSE;
 
-  context->repaint_funcs = g_list_prepend (context->repaint_funcs,
-                                           repaint_func);
+  context->repaint_funcs = repaint_func_list_insert (context->repaint_funcs,
+                                                     repaint_func);
 
   _clutter_context_unlock ();
 
@@ -3389,6 +4392,65 @@ clutter_threads_add_repaint_func_full (ClutterRepaintFlags flags,
   return repaint_func->id;
 }
 
+/**
+ * clutter_threads_set_repaint_func_budget:
+ * @budget: the time budget of the repaint functions, in microseconds,
+ *   or 0 to disable the budget
+ *
+ * Sets the time that the repaint functions can take in each phase of
+ * a frame before the ones with a priority lower than
+ * %G_PRIORITY_DEFAULT are deferred to the next frame.
+ *
+ * The repaint functions with a priority of %G_PRIORITY_DEFAULT or
+ * higher are always called. See
+ * clutter_threads_add_repaint_func_with_priority().
+ *
+ * The time spent in the repaint functions, and the number of deferred
+ * functions, are recorded in the #ClutterFrameInfo of the stages.
+ *
+ * Since: 1.26
+ */
+void
+clutter_threads_set_repaint_func_budget (gint64 budget)
+{
+  ClutterMainContext *context;
+
+  g_return_if_fail (budget >= 0);
+
+  _clutter_context_lock ();
+
+  context = clutter_context_get_default_unlocked ();
+  context->repaint_funcs_budget = budget;
+
+  _clutter_context_unlock ();
+}
+
+/**
+ * clutter_threads_get_repaint_func_budget:
+ *
+ * Retrieves the value set using clutter_threads_set_repaint_func_budget().
+ *
+ * Return value: the time budget of the repaint functions, in
+ *   microseconds, or 0
+ *
+ * Since: 1.26
+ */
+gint64
+clutter_threads_get_repaint_func_budget (void)
+{
+  ClutterMainContext *context;
+  gint64 retval;
+
+  _clutter_context_lock ();
+
+  context = clutter_context_get_default_unlocked ();
+  retval = context->repaint_funcs_budget;
+
+  _clutter_context_unlock ();
+
+  return retval;
+}
+
 /*
  * _clutter_run_repaint_functions:
  * @flags: only run the repaint functions matching the passed flags
@@ -3396,6 +4458,9 @@ clutter_threads_add_repaint_func_full (ClutterRepaintFlags flags,
  * Executes the repaint functions added using the
  * clutter_threads_add_repaint_func() function.
  *
+ * The functions with a priority lower than %G_PRIORITY_DEFAULT are
+ * skipped once the budget is exhausted, and run during the next frame.
+ *
  * Must be called with the Clutter thread lock held.
  */
 void
@@ -3404,10 +4469,16 @@ _clutter_run_repaint_functions (ClutterRepaintFlags flags)
   ClutterMainContext *context = _clutter_context_get_default ();
   ClutterRepaintFunction *repaint_func;
   GList *invoke_list, *reinvoke_list, *l;
+  const GSList *stages;
+  gint64 start, now;
+  guint n_deferred;
 
   if (context->repaint_funcs == NULL)
     return;
 
+  start = now = g_get_monotonic_time ();
+  n_deferred = 0;
+
   /* steal the list */
   invoke_list = context->repaint_funcs;
   context->repaint_funcs = NULL;
@@ -3426,10 +4497,23 @@ _clutter_run_repaint_functions (ClutterRepaintFlags flags)
 
       g_list_free (l);
 
-      if ((repaint_func->flags & flags) != 0)
-        res = repaint_func->func (repaint_func->data);
-      else
+      if ((repaint_func->flags & flags) == 0)
         res = TRUE;
+      else if (repaint_func->priority > G_PRIORITY_DEFAULT &&
+               !repaint_func->deferred &&
+               context->repaint_funcs_budget > 0 &&
+               now - start >= context->repaint_funcs_budget)
+        {
+          repaint_func->deferred = TRUE;
+          n_deferred += 1;
+          res = TRUE;
+        }
+      else
+        {
+          repaint_func->deferred = FALSE;
+          res = repaint_func->func (repaint_func->data);
+          now = g_get_monotonic_time ();
+        }
 
       if (res)
         reinvoke_list = g_list_prepend (reinvoke_list, repaint_func);
@@ -3442,13 +4526,295 @@ _clutter_run_repaint_functions (ClutterRepaintFlags flags)
         }
     }
 
+  reinvoke_list = g_list_reverse (reinvoke_list);
+
+  /* the functions added while running the list go in front of the
+   * functions with the same priority, as if they had been added to
+   * the list after them
+   */
   if (context->repaint_funcs != NULL)
     {
-      context->repaint_funcs = g_list_concat (context->repaint_funcs,
-                                              g_list_reverse (reinvoke_list));
+      for (l = g_list_last (context->repaint_funcs); l != NULL; l = l->prev)
+        reinvoke_list = repaint_func_list_insert (reinvoke_list, l->data);
+
+      g_list_free (context->repaint_funcs);
     }
-  else
-    context->repaint_funcs = g_list_reverse (reinvoke_list);
+
+  context->repaint_funcs = reinvoke_list;
+
+  now = g_get_monotonic_time ();
+
+  CLUTTER_NOTE (SCHEDULER, "Repaint functions took %" G_GINT64_FORMAT " usecs "
+                           "(%u deferred)",
+                now - start,
+                n_deferred);
+
+  stages = clutter_stage_manager_peek_stages (context->stage_manager);
+  for (; stages != NULL; stages = stages->next)
+    _clutter_stage_frame_info_add_repaint_funcs (stages->data,
+                                                 now - start,
+                                                 n_deferred);
+
+  /* make sure that the deferred functions get their frame */
+  if (n_deferred > 0)
+    _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+}
+
+typedef struct _ClutterTask
+{
+  ClutterTaskFunc func;
+  gpointer data;
+  GDestroyNotify notify;
+} ClutterTask;
+
+/* the tasks posted by the other threads, in order; the lock protects
+ * the posted tasks, their count and the pending flag
+ */
+static GMutex task_queue_lock;
+static GArray *posted_tasks = NULL;
+static guint n_queued_tasks = 0;
+static gboolean tasks_pending = FALSE;
+
+/* the tasks being run by the main thread, and the next one to run */
+static GArray *running_tasks = NULL;
+static guint next_running_task = 0;
+
+static guint task_queue_max_tasks = 0;
+static gint64 task_queue_budget = 0;
+
+/**
+ * clutter_threads_post_task:
+ * @func: function to call
+ * @data: data to pass to the function
+ * @notify: (allow-none): function to call after @func, or %NULL
+ *
+ * Posts @func to be called once by the thread running the Clutter
+ * main loop, while holding the Clutter lock.
+ *
+ * This function can be called from any thread. Unlike
+ * clutter_threads_add_idle(), it does not create a #GSource for each
+ * call: the posted tasks are kept in a single queue, and are all run
+ * at the beginning of the next frame, before the layout of the stages,
+ * in the order in which they were posted.
+ *
+ * If the number of tasks waiting to run reached the limit set using
+ * clutter_threads_set_task_queue_limits(), @func is not posted, and
+ * %FALSE is returned; the caller is expected to coalesce its updates
+ * or to post them again later. @notify is not called in that case.
+ *
+ * Return value: %TRUE if the task was posted
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_threads_post_task (ClutterTaskFunc func,
+                           gpointer        data,
+                           GDestroyNotify  notify)
+{
+  ClutterTask task;
+  gboolean wakeup;
+
+  g_return_val_if_fail (func != NULL, FALSE);
+
+  g_mutex_lock (&task_queue_lock);
+
+  if (task_queue_max_tasks > 0 && n_queued_tasks >= task_queue_max_tasks)
+    {
+      g_mutex_unlock (&task_queue_lock);
+      return FALSE;
+    }
+
+  if (G_UNLIKELY (posted_tasks == NULL))
+    posted_tasks = g_array_new (FALSE, FALSE, sizeof (ClutterTask));
+
+  task.func = func;
+  task.data = data;
+  task.notify = notify;
+  g_array_append_val (posted_tasks, task);
+
+  n_queued_tasks += 1;
+
+  /* only the first task posted since the last frame wakes up the
+   * main loop
+   */
+  wakeup = !tasks_pending;
+  tasks_pending = TRUE;
+
+  g_mutex_unlock (&task_queue_lock);
+
+  if (wakeup)
+    g_main_context_wakeup (NULL);
+
+  return TRUE;
+}
+
+/**
+ * clutter_threads_set_task_queue_limits:
+ * @max_tasks: the maximum number of tasks waiting to run, or 0 for
+ *   no limit
+ * @budget: the time the tasks can take in each frame, in microseconds,
+ *   or 0 for no limit
+ *
+ * Sets the limits of the queue of the tasks posted using
+ * clutter_threads_post_task().
+ *
+ * Once @max_tasks tasks are waiting to run, posting a task fails until
+ * the main thread runs some of them. Once the tasks run in a frame took
+ * @budget microseconds, the remaining tasks run in the next frame; at
+ * least one task runs in each frame.
+ *
+ * Since: 1.26
+ */
+void
+clutter_threads_set_task_queue_limits (guint  max_tasks,
+                                       gint64 budget)
+{
+  g_return_if_fail (budget >= 0);
+
+  g_mutex_lock (&task_queue_lock);
+
+  task_queue_max_tasks = max_tasks;
+  task_queue_budget = budget;
+
+  g_mutex_unlock (&task_queue_lock);
+}
+
+/**
+ * clutter_threads_get_task_queue_limits:
+ * @max_tasks: (out) (allow-none): return location for the maximum
+ *   number of tasks, or %NULL
+ * @budget: (out) (allow-none): return location for the time budget,
+ *   or %NULL
+ *
+ * Retrieves the limits set using clutter_threads_set_task_queue_limits().
+ *
+ * Since: 1.26
+ */
+void
+clutter_threads_get_task_queue_limits (guint  *max_tasks,
+                                       gint64 *budget)
+{
+  g_mutex_lock (&task_queue_lock);
+
+  if (max_tasks != NULL)
+    *max_tasks = task_queue_max_tasks;
+
+  if (budget != NULL)
+    *budget = task_queue_budget;
+
+  g_mutex_unlock (&task_queue_lock);
+}
+
+/*< private >
+ * _clutter_threads_has_pending_tasks:
+ *
+ * Checks whether tasks were posted since the last frame.
+ *
+ * Return value: %TRUE if tasks are waiting to run
+ */
+gboolean
+_clutter_threads_has_pending_tasks (void)
+{
+  gboolean retval;
+
+  g_mutex_lock (&task_queue_lock);
+  retval = tasks_pending;
+  g_mutex_unlock (&task_queue_lock);
+
+  return retval;
+}
+
+/*< private >
+ * _clutter_threads_run_tasks:
+ *
+ * Runs the tasks posted using clutter_threads_post_task(), until the
+ * queue is empty or the budget of the frame is exhausted.
+ *
+ * Must be called with the Clutter thread lock held.
+ */
+void
+_clutter_threads_run_tasks (void)
+{
+  gint64 start, budget;
+  guint n_run, n_uncounted;
+
+  if (G_UNLIKELY (running_tasks == NULL))
+    running_tasks = g_array_new (FALSE, FALSE, sizeof (ClutterTask));
+
+  g_mutex_lock (&task_queue_lock);
+  budget = task_queue_budget;
+  g_mutex_unlock (&task_queue_lock);
+
+  start = g_get_monotonic_time ();
+  n_run = n_uncounted = 0;
+
+  while (TRUE)
+    {
+      ClutterTask *task;
+
+      /* the posted tasks are taken all at once, and run without
+       * holding the lock
+       */
+      if (next_running_task == running_tasks->len)
+        {
+          GArray *tmp;
+
+          g_array_set_size (running_tasks, 0);
+          next_running_task = 0;
+
+          g_mutex_lock (&task_queue_lock);
+
+          n_queued_tasks -= n_uncounted;
+          n_uncounted = 0;
+          tasks_pending = FALSE;
+
+          if (posted_tasks != NULL)
+            {
+              tmp = posted_tasks;
+              posted_tasks = running_tasks;
+              running_tasks = tmp;
+            }
+
+          g_mutex_unlock (&task_queue_lock);
+
+          if (running_tasks->len == 0)
+            break;
+        }
+
+      if (budget > 0 && n_run > 0 &&
+          g_get_monotonic_time () - start >= budget)
+        break;
+
+      task = &g_array_index (running_tasks, ClutterTask, next_running_task);
+      next_running_task += 1;
+      n_uncounted += 1;
+      n_run += 1;
+
+      task->func (task->data);
+
+      if (task->notify != NULL)
+        task->notify (task->data);
+    }
+
+  if (n_uncounted > 0)
+    {
+      g_mutex_lock (&task_queue_lock);
+      n_queued_tasks -= n_uncounted;
+      g_mutex_unlock (&task_queue_lock);
+    }
+
+  if (n_run == 0)
+    return;
+
+  CLUTTER_NOTE (SCHEDULER, "%u tasks took %" G_GINT64_FORMAT " usecs "
+                           "(%u left)",
+                n_run,
+                g_get_monotonic_time () - start,
+                running_tasks->len - next_running_task);
+
+  /* make sure that the remaining tasks get their frame */
+  if (next_running_task < running_tasks->len)
+    _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
 }
 
 /**
@@ -3682,6 +5048,12 @@ clutter_check_windowing_backend (const char *backend_type)
       CLUTTER_IS_BACKEND_ANDROID (context->backend))
     return TRUE;
   else
+#endif
+#ifdef CLUTTER_WINDOWING_HEADLESS
+  if (backend_type == I_(CLUTTER_WINDOWING_HEADLESS) &&
+      CLUTTER_IS_BACKEND_HEADLESS (context->backend))
+    return TRUE;
+  else
 #endif
   return FALSE;
 }
@@ -3698,6 +5070,172 @@ _clutter_get_sync_to_vblank (void)
   return clutter_sync_to_vblank;
 }
 
+guint
+_clutter_get_measure_threads (void)
+{
+  return clutter_measure_threads;
+}
+
+gsize
+_clutter_get_text_layout_cache_size (void)
+{
+  return clutter_text_layout_cache_size;
+}
+
+gsize
+_clutter_get_image_cache_size (void)
+{
+  return clutter_image_cache_size;
+}
+
+guint
+_clutter_get_image_atlas_max_size (void)
+{
+  return clutter_image_atlas_max_size;
+}
+
+gsize
+_clutter_get_upload_budget (void)
+{
+  return clutter_upload_budget;
+}
+
+gboolean
+_clutter_get_distance_field_text (void)
+{
+  return clutter_distance_field_text;
+}
+
+gboolean
+_clutter_get_staged_init (void)
+{
+  return clutter_staged_init;
+}
+
+gboolean
+_clutter_get_pipelined_swaps (void)
+{
+  return clutter_pipelined_swaps;
+}
+
+const gchar *
+_clutter_get_record_events_path (void)
+{
+  return clutter_record_events;
+}
+
+const gchar *
+_clutter_get_replay_events_path (void)
+{
+  return clutter_replay_events;
+}
+
+#ifdef CLUTTER_ENABLE_DEBUG
+static void
+clutter_startup_info_dump (const ClutterStartupInfo *info)
+{
+  gint64 start = info->init_start;
+
+#define PHASE(name,value) \
+  G_STMT_START { \
+    if ((value) != 0) \
+      CLUTTER_NOTE (MISC, "Startup: %-22s %8.3f ms", name, \
+                    ((value) - start) / 1000.0); \
+  } G_STMT_END
+
+  PHASE ("backend", info->backend_end);
+  PHASE ("context", info->context_end);
+  PHASE ("events", info->events_end);
+  PHASE ("init", info->init_end);
+  PHASE ("window", info->window_time);
+  PHASE ("font map", info->font_map_end);
+  PHASE ("accessibility", info->accessibility_end);
+  PHASE ("first frame", info->first_frame_time);
+
+#undef PHASE
+}
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+/*< private >
+ * _clutter_startup_mark:
+ * @mark: the phase of the start up
+ * @time_: the time of the phase, in microseconds, or 0 to use the
+ *   current time
+ *
+ * Records the first time @mark is reached in the start up timeline.
+ */
+void
+_clutter_startup_mark (ClutterStartupMark mark,
+                       gint64             time_)
+{
+  ClutterStartupInfo *info = &clutter_startup_info;
+  gint64 *field = NULL;
+
+  switch (mark)
+    {
+    case CLUTTER_STARTUP_MARK_INIT_START:
+      field = &info->init_start;
+      break;
+
+    case CLUTTER_STARTUP_MARK_BACKEND_END:
+      field = &info->backend_end;
+      break;
+
+    case CLUTTER_STARTUP_MARK_CONTEXT_END:
+      field = &info->context_end;
+      break;
+
+    case CLUTTER_STARTUP_MARK_EVENTS_END:
+      field = &info->events_end;
+      break;
+
+    case CLUTTER_STARTUP_MARK_INIT_END:
+      field = &info->init_end;
+      break;
+
+    case CLUTTER_STARTUP_MARK_WINDOW:
+      field = &info->window_time;
+      break;
+
+    case CLUTTER_STARTUP_MARK_FONT_MAP_START:
+      field = &info->font_map_start;
+      break;
+
+    case CLUTTER_STARTUP_MARK_FONT_MAP_END:
+      field = &info->font_map_end;
+      break;
+
+    case CLUTTER_STARTUP_MARK_ACCESSIBILITY_START:
+      field = &info->accessibility_start;
+      break;
+
+    case CLUTTER_STARTUP_MARK_ACCESSIBILITY_END:
+      field = &info->accessibility_end;
+      break;
+
+    case CLUTTER_STARTUP_MARK_FIRST_FRAME:
+      field = &info->first_frame_time;
+      break;
+
+    case CLUTTER_STARTUP_MARK_FIRST_PRESENTATION:
+      field = &info->first_frame_presented;
+      break;
+    }
+
+  if (G_LIKELY (field == NULL || *field != 0))
+    return;
+
+  *field = time_ != 0 ? time_ : g_get_monotonic_time ();
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (mark == CLUTTER_STARTUP_MARK_FIRST_FRAME)
+    clutter_startup_info_dump (info);
+  else if (mark == CLUTTER_STARTUP_MARK_FIRST_PRESENTATION)
+    CLUTTER_NOTE (MISC, "Startup: %-22s %8.3f ms", "first presentation",
+                  (*field - info->init_start) / 1000.0);
+#endif
+}
+
 void
 _clutter_debug_messagev (const char *format,
                          va_list     var_args)
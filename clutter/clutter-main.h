@@ -77,6 +77,66 @@ GQuark clutter_init_error_quark (void);
  */
 #define CLUTTER_PRIORITY_REDRAW         (G_PRIORITY_HIGH_IDLE + 50)
 
+typedef struct _ClutterStartupInfo      ClutterStartupInfo;
+
+/**
+ * ClutterTaskFunc:
+ * @data: the data passed to clutter_threads_post_task()
+ *
+ * The type of the functions posted using clutter_threads_post_task().
+ *
+ * Since: 1.26
+ */
+typedef void (* ClutterTaskFunc) (gpointer data);
+
+/**
+ * ClutterStartupInfo:
+ * @init_start: the time the initialization of Clutter started
+ * @backend_end: the time the windowing system backend was set up
+ * @context_end: the time the Cogl context was created
+ * @events_end: the time the event handling was set up
+ * @init_end: the time the initialization of Clutter ended
+ * @window_time: the time the native window became available, or 0 if
+ *   the backend does not wait for one
+ * @font_map_start: the time the creation of the font map started, or 0
+ *   if the font map has not been created yet
+ * @font_map_end: the time the creation of the font map ended, or 0
+ * @accessibility_start: the time the initialization of the accessibility
+ *   support started, or 0 if it has not been initialized yet
+ * @accessibility_end: the time the initialization of the accessibility
+ *   support ended, or 0
+ * @first_frame_time: the time the first frame of a stage was painted,
+ *   or 0 if no frame has been painted yet
+ * @first_frame_presented: the time the first frame of a stage was
+ *   presented on screen, or 0 if it is not known
+ *
+ * The timeline of the start up of Clutter; all the times are in
+ * microseconds, and use the same clock as g_get_monotonic_time().
+ *
+ * See clutter_get_startup_info().
+ *
+ * Since: 1.26
+ */
+struct _ClutterStartupInfo
+{
+  gint64 init_start;
+  gint64 backend_end;
+  gint64 context_end;
+  gint64 events_end;
+  gint64 init_end;
+
+  gint64 window_time;
+
+  gint64 font_map_start;
+  gint64 font_map_end;
+
+  gint64 accessibility_start;
+  gint64 accessibility_end;
+
+  gint64 first_frame_time;
+  gint64 first_frame_presented;
+};
+
 /* Initialisation */
 CLUTTER_AVAILABLE_IN_ALL
 void                    clutter_base_init                       (void);
@@ -114,6 +174,11 @@ gboolean                clutter_get_accessibility_enabled       (void);
 CLUTTER_AVAILABLE_IN_1_14
 void                    clutter_disable_accessibility           (void);
 
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_enable_staged_init              (void);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_get_startup_info                (ClutterStartupInfo *info);
+
 /* Threading functions */
 CLUTTER_AVAILABLE_IN_ALL
 void                    clutter_threads_set_lock_functions      (GCallback enter_fn,
@@ -136,6 +201,18 @@ guint                   clutter_threads_add_timeout_full        (gint
                                                                  GSourceFunc    func,
                                                                  gpointer       data,
                                                                  GDestroyNotify notify);
+CLUTTER_AVAILABLE_IN_1_26
+guint                   clutter_threads_add_coalesced_timeout   (guint          interval,
+                                                                 guint          slack,
+                                                                 GSourceFunc    func,
+                                                                 gpointer       data);
+CLUTTER_AVAILABLE_IN_1_26
+guint                   clutter_threads_add_coalesced_timeout_full (gint           priority,
+                                                                    guint          interval,
+                                                                    guint          slack,
+                                                                    GSourceFunc    func,
+                                                                    gpointer       data,
+                                                                    GDestroyNotify notify);
 CLUTTER_AVAILABLE_IN_1_0
 guint                   clutter_threads_add_repaint_func        (GSourceFunc    func,
                                                                  gpointer       data,
@@ -145,8 +222,29 @@ guint                   clutter_threads_add_repaint_func_full   (ClutterRepaintF
                                                                  GSourceFunc    func,
                                                                  gpointer       data,
                                                                  GDestroyNotify notify);
+CLUTTER_AVAILABLE_IN_1_26
+guint                   clutter_threads_add_repaint_func_with_priority (ClutterRepaintFlags flags,
+                                                                        gint                priority,
+                                                                        GSourceFunc         func,
+                                                                        gpointer            data,
+                                                                        GDestroyNotify      notify);
 CLUTTER_AVAILABLE_IN_1_0
 void                    clutter_threads_remove_repaint_func     (guint          handle_id);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_threads_set_repaint_func_budget (gint64         budget);
+CLUTTER_AVAILABLE_IN_1_26
+gint64                  clutter_threads_get_repaint_func_budget (void);
+
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_threads_post_task               (ClutterTaskFunc func,
+                                                                 gpointer       data,
+                                                                 GDestroyNotify notify);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_threads_set_task_queue_limits   (guint          max_tasks,
+                                                                 gint64         budget);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_threads_get_task_queue_limits   (guint         *max_tasks,
+                                                                 gint64        *budget);
 
 CLUTTER_AVAILABLE_IN_ALL
 void                    clutter_grab_pointer                    (ClutterActor  *actor);
@@ -163,6 +261,14 @@ ClutterActor *          clutter_get_keyboard_grab               (void);
 
 CLUTTER_AVAILABLE_IN_ALL
 PangoFontMap *          clutter_get_font_map                    (void);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_load_font_config                (const gchar  *config_file,
+                                                                 GError      **error);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_warm_glyph_cache                (const gchar *font_name,
+                                                                 const gchar *characters);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_trim_memory                     (ClutterTrimMemoryFlags flags);
 
 CLUTTER_AVAILABLE_IN_ALL
 ClutterTextDirection    clutter_get_default_text_direction      (void);
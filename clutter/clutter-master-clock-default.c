@@ -35,10 +35,17 @@
 
 #include "clutter-master-clock.h"
 #include "clutter-master-clock-default.h"
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
+#include "clutter-input-recorder.h"
 #include "clutter-private.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
+#include "clutter-trace.h"
+#include "clutter-transition.h"
+#ifdef CLUTTER_WINDOWING_HEADLESS
+#include "headless/clutter-backend-headless.h"
+#endif
 
 #ifdef CLUTTER_ENABLE_DEBUG
 #define clutter_warn_if_over_budget(master_clock,start_time,section)    G_STMT_START  { \
@@ -56,6 +63,11 @@
 
 typedef struct _ClutterClockSource              ClutterClockSource;
 
+typedef struct {
+  gint64 start_time;
+  ClutterTimeline *timeline;
+} DelayedTimeline;
+
 struct _ClutterMasterClockDefault
 {
   GObject parent_instance;
@@ -63,15 +75,31 @@ struct _ClutterMasterClockDefault
   /* the list of timelines handled by the clock */
   GSList *timelines;
 
+  /* a binary min-heap of DelayedTimeline, keyed on the start time, for
+   * the timelines waiting for their delay to elapse; they are not
+   * ticked until they are moved to the list above
+   */
+  GArray *delayed_timelines;
+
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
 
   /* the previous state of the clock, in usecs, used to compute the delta */
   gint64 prev_tick;
 
+  /* the time used to advance the timelines, in usecs; it is the recorded
+   * time of the frame when replaying the input events
+   */
+  gint64 timeline_tick;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 frame_budget;
   gint64 remaining_budget;
+
+  /* the number of frames in which the timelines were advanced without
+   * any stage needing an update
+   */
+  gulong frames_elided;
 #endif
 
   /* an idle source, used by the Master Clock to queue
@@ -79,12 +107,6 @@ struct _ClutterMasterClockDefault
    */
   GSource *source;
 
-  /* If the master clock is idle that means it has
-   * fallen back to idle polling for timeline
-   * progressions and it may have been some time since
-   * the last real stage update.
-   */
-  guint idle : 1;
   guint ensure_next_iteration : 1;
 
   guint paused : 1;
@@ -113,6 +135,9 @@ static GSourceFuncs clock_funcs = {
 
 static void clutter_master_clock_iface_init (ClutterMasterClockIface *iface);
 
+/* set on the stages whose last update did not paint anything */
+static GQuark quark_stage_idle = 0;
+
 #define clutter_master_clock_default_get_type   _clutter_master_clock_default_get_type
 
 G_DEFINE_TYPE_WITH_CODE (ClutterMasterClockDefault,
@@ -121,6 +146,160 @@ G_DEFINE_TYPE_WITH_CODE (ClutterMasterClockDefault,
                          G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_MASTER_CLOCK,
                                                 clutter_master_clock_iface_init));
 
+#define DELAYED_TIMELINE(array,i) (&g_array_index ((array), DelayedTimeline, (i)))
+
+static void
+delayed_timelines_swap (GArray *heap,
+                        guint   a,
+                        guint   b)
+{
+  DelayedTimeline tmp = *DELAYED_TIMELINE (heap, a);
+
+  *DELAYED_TIMELINE (heap, a) = *DELAYED_TIMELINE (heap, b);
+  *DELAYED_TIMELINE (heap, b) = tmp;
+}
+
+static void
+delayed_timelines_sift_up (GArray *heap,
+                           guint   i)
+{
+  while (i > 0)
+    {
+      guint parent = (i - 1) / 2;
+
+      if (DELAYED_TIMELINE (heap, parent)->start_time <=
+          DELAYED_TIMELINE (heap, i)->start_time)
+        break;
+
+      delayed_timelines_swap (heap, parent, i);
+      i = parent;
+    }
+}
+
+static void
+delayed_timelines_sift_down (GArray *heap,
+                             guint   i)
+{
+  while (TRUE)
+    {
+      guint left = 2 * i + 1, right = left + 1, min = i;
+
+      if (left < heap->len &&
+          DELAYED_TIMELINE (heap, left)->start_time <
+          DELAYED_TIMELINE (heap, min)->start_time)
+        min = left;
+
+      if (right < heap->len &&
+          DELAYED_TIMELINE (heap, right)->start_time <
+          DELAYED_TIMELINE (heap, min)->start_time)
+        min = right;
+
+      if (min == i)
+        break;
+
+      delayed_timelines_swap (heap, min, i);
+      i = min;
+    }
+}
+
+static void
+delayed_timelines_remove_index (GArray *heap,
+                                guint   i)
+{
+  guint last = heap->len - 1;
+
+  if (i != last)
+    {
+      *DELAYED_TIMELINE (heap, i) = *DELAYED_TIMELINE (heap, last);
+      g_array_set_size (heap, last);
+
+      delayed_timelines_sift_down (heap, i);
+      delayed_timelines_sift_up (heap, i);
+    }
+  else
+    g_array_set_size (heap, last);
+}
+
+/*
+ * master_clock_get_delayed_wait_time:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Computes the number of milliseconds before the first delayed
+ * timeline should start.
+ *
+ * Return value: -1 if there is no delayed timeline, otherwise the
+ *   number of milliseconds to wait
+ */
+static gint
+master_clock_get_delayed_wait_time (ClutterMasterClockDefault *master_clock)
+{
+  gint64 now, start_time;
+
+  if (master_clock->paused || master_clock->delayed_timelines->len == 0)
+    return -1;
+
+  now = g_source_get_time (master_clock->source);
+  start_time = DELAYED_TIMELINE (master_clock->delayed_timelines, 0)->start_time;
+
+  if (start_time <= now)
+    return 0;
+
+  return (start_time - now + 999) / 1000;
+}
+
+/*
+ * master_clock_start_delayed_timelines:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Starts all the delayed timelines whose start time is before the
+ * current tick; timelines started in response to this, or delayed
+ * again, are handled by the next frames.
+ */
+static void
+master_clock_start_delayed_timelines (ClutterMasterClockDefault *master_clock)
+{
+  GArray *heap = master_clock->delayed_timelines;
+
+  while (heap->len > 0 &&
+         DELAYED_TIMELINE (heap, 0)->start_time <= master_clock->cur_tick)
+    {
+      ClutterTimeline *timeline = DELAYED_TIMELINE (heap, 0)->timeline;
+
+      delayed_timelines_remove_index (heap, 0);
+
+      CLUTTER_NOTE (SCHEDULER, "Delay of timeline [%p] elapsed", timeline);
+
+      g_object_ref (timeline);
+      _clutter_timeline_delay_elapsed (timeline);
+      g_object_unref (timeline);
+    }
+}
+
+/*
+ * master_clock_timeline_is_suspended:
+ * @timeline: a #ClutterTimeline
+ *
+ * Checks whether @timeline is a transition on an actor inside a
+ * branch of the scene graph that pauses its transitions while it
+ * is not on screen; see clutter_actor_set_pause_offscreen_transitions().
+ *
+ * Return value: %TRUE if @timeline should not be advanced
+ */
+static gboolean
+master_clock_timeline_is_suspended (ClutterTimeline *timeline)
+{
+  ClutterAnimatable *animatable;
+
+  if (!CLUTTER_IS_TRANSITION (timeline))
+    return FALSE;
+
+  animatable = clutter_transition_get_animatable (CLUTTER_TRANSITION (timeline));
+  if (!CLUTTER_IS_ACTOR (animatable))
+    return FALSE;
+
+  return _clutter_actor_get_transitions_suspended (CLUTTER_ACTOR (animatable));
+}
+
 /*
  * master_clock_is_running:
  * @master_clock: a #ClutterMasterClock
@@ -142,9 +321,15 @@ master_clock_is_running (ClutterMasterClockDefault *master_clock)
   if (master_clock->paused)
     return FALSE;
 
-  if (master_clock->timelines)
+  if (_clutter_threads_has_pending_tasks ())
     return TRUE;
 
+  for (l = master_clock->timelines; l != NULL; l = l->next)
+    {
+      if (!master_clock_timeline_is_suspended (l->data))
+        return TRUE;
+    }
+
   for (l = stages; l; l = l->next)
     {
       if (clutter_actor_is_mapped (l->data) &&
@@ -162,6 +347,57 @@ master_clock_is_running (ClutterMasterClockDefault *master_clock)
   return FALSE;
 }
 
+/*
+ * master_clock_get_frame_rate:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Computes the frame rate the clock needs to run at, which is the
+ * highest of the frame rates of the running timelines when all of
+ * them are capped, and no stage needs to be updated for another
+ * reason; see clutter_timeline_set_max_frame_rate().
+ *
+ * Return value: the frame rate, or 0 for the rate of the display
+ */
+static guint
+master_clock_get_frame_rate (ClutterMasterClockDefault *master_clock)
+{
+  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+  const GSList *stages, *l;
+  guint frame_rate = 0;
+
+  if (_clutter_threads_has_pending_tasks ())
+    return 0;
+
+  for (l = master_clock->timelines; l != NULL; l = l->next)
+    {
+      guint timeline_rate;
+
+      if (master_clock_timeline_is_suspended (l->data))
+        continue;
+
+      timeline_rate = _clutter_timeline_get_max_frame_rate (l->data);
+      if (timeline_rate == 0)
+        return 0;
+
+      frame_rate = MAX (frame_rate, timeline_rate);
+    }
+
+  if (frame_rate == 0)
+    return 0;
+
+  stages = clutter_stage_manager_peek_stages (stage_manager);
+
+  for (l = stages; l != NULL; l = l->next)
+    {
+      if (clutter_actor_is_mapped (l->data) &&
+          (_clutter_stage_has_queued_events (l->data) ||
+           _clutter_stage_needs_update (l->data)))
+        return 0;
+    }
+
+  return frame_rate;
+}
+
 static gint
 master_clock_get_swap_wait_time (ClutterMasterClockDefault *master_clock)
 {
@@ -173,7 +409,16 @@ master_clock_get_swap_wait_time (ClutterMasterClockDefault *master_clock)
 
   for (l = stages; l != NULL; l = l->next)
     {
-      gint64 update_time = _clutter_stage_get_update_time (l->data);
+      gint64 update_time;
+
+      /* the stages that are not mapped are never updated, so their
+       * update time must not wake up the clock, or it would spin
+       * without ever clearing it
+       */
+      if (!clutter_actor_is_mapped (l->data))
+        continue;
+
+      update_time = _clutter_stage_get_update_time (l->data);
       if (min_update_time == -1 ||
           (update_time != -1 && update_time < min_update_time))
         min_update_time = update_time;
@@ -210,6 +455,26 @@ master_clock_schedule_stage_updates (ClutterMasterClockDefault *master_clock)
     _clutter_stage_schedule_update (l->data);
 }
 
+static gint
+master_clock_compare_stage_deadlines (gconstpointer a,
+                                      gconstpointer b)
+{
+  gint64 deadline_a = _clutter_stage_get_next_presentation_time ((ClutterStage *) a);
+  gint64 deadline_b = _clutter_stage_get_next_presentation_time ((ClutterStage *) b);
+
+  /* the stages without a known deadline go last */
+  if (deadline_a == deadline_b)
+    return 0;
+
+  if (deadline_a == 0)
+    return 1;
+
+  if (deadline_b == 0)
+    return -1;
+
+  return deadline_a < deadline_b ? -1 : 1;
+}
+
 static GSList *
 master_clock_list_ready_stages (ClutterMasterClockDefault *master_clock)
 {
@@ -242,7 +507,17 @@ master_clock_list_ready_stages (ClutterMasterClockDefault *master_clock)
         result = g_slist_prepend (result, g_object_ref (l->data));
     }
 
-  return g_slist_reverse (result);
+  result = g_slist_reverse (result);
+
+  /* each stage is scheduled by the presentation feedback of its own
+   * output; when several of them are ready in the same iteration, the
+   * stage whose output presents first is updated first, so that a stage
+   * on a slower output does not make it miss its refresh
+   */
+  if (result != NULL && result->next != NULL)
+    result = g_slist_sort (result, master_clock_compare_stage_deadlines);
+
+  return result;
 }
 
 static void
@@ -264,8 +539,44 @@ master_clock_reschedule_stage_updates (ClutterMasterClockDefault *master_clock,
     }
 }
 
+static inline gboolean
+master_clock_stage_is_idle (ClutterStage *stage)
+{
+  return g_object_get_qdata (G_OBJECT (stage), quark_stage_idle) != NULL;
+}
+
+/* Checks whether a stage that is not idle is due for an update; the
+ * updates of those stages are throttled by the presentation of their
+ * own output, while the idle stages are polled
+ */
+static gboolean
+master_clock_has_due_active_stage (ClutterMasterClockDefault *master_clock)
+{
+  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+  const GSList *stages, *l;
+  gint64 now;
+
+  stages = clutter_stage_manager_peek_stages (stage_manager);
+  now = g_source_get_time (master_clock->source);
+
+  for (l = stages; l != NULL; l = l->next)
+    {
+      gint64 update_time;
+
+      if (!clutter_actor_is_mapped (l->data) ||
+          master_clock_stage_is_idle (l->data))
+        continue;
+
+      update_time = _clutter_stage_get_update_time (l->data);
+      if (update_time != -1 && update_time <= now)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 /*
- * master_clock_next_frame_delay:
+ * master_clock_next_update_delay:
  * @master_clock: a #ClutterMasterClock
  *
  * Computes the number of delay before we need to draw the next frame.
@@ -274,10 +585,11 @@ master_clock_reschedule_stage_updates (ClutterMasterClockDefault *master_clock,
  *  number of millseconds before the we need to draw the next frame
  */
 static gint
-master_clock_next_frame_delay (ClutterMasterClockDefault *master_clock)
+master_clock_next_update_delay (ClutterMasterClockDefault *master_clock)
 {
   gint64 now, next;
   gint swap_delay;
+  guint frame_rate;
 
   if (!master_clock_is_running (master_clock))
     return -1;
@@ -292,16 +604,40 @@ master_clock_next_frame_delay (ClutterMasterClockDefault *master_clock)
    * swap-buffer-complete events if supported in the backend) to throttle our
    * frame rate so no additional delay is needed to start the next frame.
    *
-   * If the master-clock has become idle due to no timeline progression causing
-   * redraws then we can no longer rely on vblank synchronization because the
-   * last real stage update/redraw may have happened a long time ago and so we
+   * If the stages that are due have become idle due to no timeline progression
+   * causing redraws then we can no longer rely on vblank synchronization because
+   * their last real update/redraw may have happened a long time ago and so we
    * fallback to polling for timeline progressions every 1/frame_rate seconds.
+   * Each stage is idle on its own, so that a stage on an output that does not
+   * change does not make the stages on the other outputs fall back to polling.
    *
    * (NB: if there aren't even any timelines running then the master clock will
    * be completely stopped in master_clock_is_running())
+   *
+   * When only capped timelines are running, the clock waits for the
+   * interval of the highest of their frame rates instead, and the
+   * swap of the next frame lands on the following vblank.
    */
+  frame_rate = master_clock_get_frame_rate (master_clock);
+  if (frame_rate != 0 && master_clock->prev_tick != 0)
+    {
+      now = g_source_get_time (master_clock->source);
+      next = master_clock->prev_tick + G_USEC_PER_SEC / frame_rate;
+
+      if (now < next && now > master_clock->prev_tick)
+        {
+          CLUTTER_NOTE (SCHEDULER, "Capped at %u fps, waiting %" G_GINT64_FORMAT " msecs",
+                        frame_rate,
+                        (next - now) / 1000);
+
+          return MAX ((next - now) / 1000, 1);
+        }
+
+      return 0;
+    }
+
   if (clutter_feature_available (CLUTTER_FEATURE_SYNC_TO_VBLANK) &&
-      !master_clock->idle)
+      master_clock_has_due_active_stage (master_clock))
     {
       CLUTTER_NOTE (SCHEDULER, "vblank available and updated stages");
       return 0;
@@ -350,6 +686,46 @@ master_clock_next_frame_delay (ClutterMasterClockDefault *master_clock)
     }
 }
 
+/*
+ * master_clock_next_frame_delay:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Computes the number of delay before the next iteration of the clock,
+ * which is either the next frame or the start of a delayed timeline.
+ *
+ * Return value: -1 if there is nothing to do, otherwise the
+ *  number of millseconds before the next iteration
+ */
+static gint
+master_clock_next_frame_delay (ClutterMasterClockDefault *master_clock)
+{
+  gint update_delay, delayed_wait;
+
+  update_delay = master_clock_next_update_delay (master_clock);
+  if (update_delay == 0)
+    return 0;
+
+  delayed_wait = master_clock_get_delayed_wait_time (master_clock);
+
+  if (update_delay == -1)
+    return delayed_wait;
+
+  if (delayed_wait == -1)
+    return update_delay;
+
+  return MIN (update_delay, delayed_wait);
+}
+
+static void
+master_clock_mark_stages (GSList           *stages,
+                          ClutterFrameMark  mark)
+{
+  GSList *l;
+
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_frame_info_mark (l->data, mark);
+}
+
 static void
 master_clock_process_events (ClutterMasterClockDefault *master_clock,
                              GSList                    *stages)
@@ -361,7 +737,13 @@ master_clock_process_events (ClutterMasterClockDefault *master_clock,
 
   /* Process queued events */
   for (l = stages; l != NULL; l = l->next)
-    _clutter_stage_process_queued_events (l->data);
+    {
+      _clutter_stage_frame_info_begin (l->data, master_clock->cur_tick);
+
+      _clutter_stage_frame_info_mark (l->data, CLUTTER_FRAME_MARK_EVENTS_START);
+      _clutter_stage_process_queued_events (l->data);
+      _clutter_stage_frame_info_mark (l->data, CLUTTER_FRAME_MARK_EVENTS_END);
+    }
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -411,7 +793,15 @@ master_clock_advance_timelines (ClutterMasterClockDefault *master_clock)
   g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
 
   for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+    {
+      /* suspended timelines will catch up on their next tick, since
+       * the elapsed time is computed from their last frame time
+       */
+      if (master_clock_timeline_is_suspended (l->data))
+        continue;
+
+      _clutter_timeline_do_tick (l->data, master_clock->timeline_tick / 1000);
+    }
 
   g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
   g_slist_free (timelines);
@@ -429,20 +819,77 @@ master_clock_update_stages (ClutterMasterClockDefault *master_clock,
                             GSList                    *stages)
 {
   gboolean stages_updated = FALSE;
+  gboolean defer_swaps, pipelined;
   GSList *l;
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
 
+  /* the tasks posted by other threads run before the layout, so that
+   * their changes are in this frame
+   */
+  _clutter_threads_run_tasks ();
+
   _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_PRE_PAINT);
 
+  /* With more than one stage, a blocking swap of a stage would delay
+   * the paint of all the stages after it; we paint every stage first
+   * and only then swap them, so that the frame time follows the
+   * slowest stage instead of the sum of all the swaps.
+   *
+   * With pipelined swaps, the swaps are also deferred for a single
+   * stage, until after the post-paint repaint functions: the commands
+   * of the frame are submitted when it is painted, so the GPU renders
+   * it while the CPU runs them.
+   */
+  pipelined = _clutter_get_pipelined_swaps ();
+  defer_swaps = pipelined || (stages != NULL && stages->next != NULL);
+  if (defer_swaps)
+    {
+      for (l = stages; l != NULL; l = l->next)
+        {
+          ClutterStageWindow *window = _clutter_stage_get_window (l->data);
+
+          if (window != NULL)
+            _clutter_stage_window_set_defer_swap (window, TRUE);
+        }
+    }
+
   /* Update any stage that needs redraw/relayout after the clock
    * is advanced.
    */
   for (l = stages; l != NULL; l = l->next)
-    stages_updated |= _clutter_stage_do_update (l->data);
+    {
+      gboolean updated = _clutter_stage_do_update (l->data);
+
+      /* a stage on an output that is not changing must not make the
+       * clock stop following the presentation of the other outputs
+       */
+      g_object_set_qdata (l->data, quark_stage_idle,
+                          updated ? NULL : GINT_TO_POINTER (TRUE));
 
-  _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_POST_PAINT);
+      stages_updated |= updated;
+    }
+
+  if (pipelined)
+    _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_POST_PAINT);
+
+  if (defer_swaps)
+    {
+      for (l = stages; l != NULL; l = l->next)
+        {
+          ClutterStageWindow *window = _clutter_stage_get_window (l->data);
+
+          if (window == NULL)
+            continue;
+
+          _clutter_stage_window_finish_swap (window);
+          _clutter_stage_window_set_defer_swap (window, FALSE);
+        }
+    }
+
+  if (!pipelined)
+    _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_POST_PAINT);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -531,6 +978,7 @@ clutter_clock_dispatch (GSource     *source,
   ClutterClockSource *clock_source = (ClutterClockSource *) source;
   ClutterMasterClockDefault *master_clock = clock_source->master_clock;
   gboolean stages_updated = FALSE;
+  gint64 frame_time;
   GSList *stages;
 
   CLUTTER_NOTE (SCHEDULER, "Master clock [tick]");
@@ -540,6 +988,29 @@ clutter_clock_dispatch (GSource     *source,
   /* Get the time to use for this frame */
   master_clock->cur_tick = g_source_get_time (source);
 
+  frame_time = master_clock->cur_tick;
+
+#ifdef CLUTTER_WINDOWING_HEADLESS
+  /* the headless backend advances the timelines by a fixed interval
+   * at each frame, however long the frames take
+   */
+  if (clutter_check_windowing_backend (CLUTTER_WINDOWING_HEADLESS))
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+
+      frame_time =
+        _clutter_backend_headless_advance_clock (CLUTTER_BACKEND_HEADLESS (backend));
+    }
+#endif
+
+  /* queue the recorded input events, if any; the replay drives the
+   * clock until its end
+   */
+  master_clock->timeline_tick = _clutter_input_recorder_frame (frame_time);
+
+  if (_clutter_input_recorder_is_replaying ())
+    master_clock->ensure_next_iteration = TRUE;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   master_clock->remaining_budget = master_clock->frame_budget;
 #endif
@@ -550,7 +1021,10 @@ clutter_clock_dispatch (GSource     *source,
    */
   stages = master_clock_list_ready_stages (master_clock);
 
-  master_clock->idle = FALSE;
+  /* Start the timelines whose delay has elapsed, so that they are
+   * advanced with the others
+   */
+  master_clock_start_delayed_timelines (master_clock);
 
   /* Each frame is split into three separate phases: */
 
@@ -558,18 +1032,34 @@ clutter_clock_dispatch (GSource     *source,
    *    and processes each event according to its type, then emits the
    *    various signals that are associated with the event
    */
+  CLUTTER_TRACE_BEGIN (CLOCK, "ClutterMasterClock::process-events");
   master_clock_process_events (master_clock, stages);
+  CLUTTER_TRACE_END (CLOCK);
 
   /* 2. advance the timelines */
+  master_clock_mark_stages (stages, CLUTTER_FRAME_MARK_TIMELINES_START);
+  CLUTTER_TRACE_BEGIN (CLOCK, "ClutterMasterClock::advance-timelines");
   master_clock_advance_timelines (master_clock);
+  CLUTTER_TRACE_END (CLOCK);
+  master_clock_mark_stages (stages, CLUTTER_FRAME_MARK_TIMELINES_END);
 
   /* 3. relayout and redraw the stages */
+  CLUTTER_TRACE_BEGIN (CLOCK, "ClutterMasterClock::update-stages");
   stages_updated = master_clock_update_stages (master_clock, stages);
+  CLUTTER_TRACE_END (CLOCK);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  /* the timelines did not change anything on screen, e.g. because the
+   * interpolated values were the same as in the previous frame
+   */
+  if (!stages_updated && master_clock->timelines != NULL)
+    {
+      master_clock->frames_elided += 1;
 
-  /* The master clock goes idle if no stages were updated and falls back
-   * to polling for timeline progressions... */
-  if (!stages_updated)
-    master_clock->idle = TRUE;
+      CLUTTER_NOTE (SCHEDULER, "Frame elided (total: %lu)",
+                    master_clock->frames_elided);
+    }
+#endif /* CLUTTER_ENABLE_DEBUG */
 
   master_clock_reschedule_stage_updates (master_clock, stages);
 
@@ -589,6 +1079,7 @@ clutter_master_clock_default_finalize (GObject *gobject)
   ClutterMasterClockDefault *master_clock = CLUTTER_MASTER_CLOCK_DEFAULT (gobject);
 
   g_slist_free (master_clock->timelines);
+  g_array_unref (master_clock->delayed_timelines);
 
   G_OBJECT_CLASS (clutter_master_clock_default_parent_class)->finalize (gobject);
 }
@@ -599,6 +1090,8 @@ clutter_master_clock_default_class_init (ClutterMasterClockDefaultClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->finalize = clutter_master_clock_default_finalize;
+
+  quark_stage_idle = g_quark_from_static_string ("clutter-master-clock-stage-idle");
 }
 
 static void
@@ -609,7 +1102,8 @@ clutter_master_clock_default_init (ClutterMasterClockDefault *self)
   source = clutter_clock_source_new (self);
   self->source = source;
 
-  self->idle = FALSE;
+  self->delayed_timelines = g_array_new (FALSE, FALSE, sizeof (DelayedTimeline));
+
   self->ensure_next_iteration = FALSE;
   self->paused = FALSE;
 
@@ -654,6 +1148,46 @@ clutter_master_clock_default_remove_timeline (ClutterMasterClock *clock,
                                             timeline);
 }
 
+static void
+clutter_master_clock_default_add_delayed_timeline (ClutterMasterClock *clock,
+                                                   ClutterTimeline    *timeline,
+                                                   gint64              start_time)
+{
+  ClutterMasterClockDefault *master_clock = (ClutterMasterClockDefault *) clock;
+  DelayedTimeline delayed;
+
+  delayed.start_time = start_time;
+  delayed.timeline = timeline;
+
+  g_array_append_val (master_clock->delayed_timelines, delayed);
+  delayed_timelines_sift_up (master_clock->delayed_timelines,
+                             master_clock->delayed_timelines->len - 1);
+
+  /* the main loop has to wake up in time for the new deadline */
+  g_main_context_wakeup (NULL);
+}
+
+static void
+clutter_master_clock_default_remove_delayed_timeline (ClutterMasterClock *clock,
+                                                      ClutterTimeline    *timeline)
+{
+  ClutterMasterClockDefault *master_clock = (ClutterMasterClockDefault *) clock;
+  GArray *heap = master_clock->delayed_timelines;
+  guint i;
+
+  /* this only happens when a timeline is stopped before its delay
+   * has elapsed, so a linear search is fine
+   */
+  for (i = 0; i < heap->len; i++)
+    {
+      if (DELAYED_TIMELINE (heap, i)->timeline == timeline)
+        {
+          delayed_timelines_remove_index (heap, i);
+          break;
+        }
+    }
+}
+
 static void
 clutter_master_clock_default_start_running (ClutterMasterClock *master_clock)
 {
@@ -688,4 +1222,6 @@ clutter_master_clock_iface_init (ClutterMasterClockIface *iface)
   iface->start_running = clutter_master_clock_default_start_running;
   iface->ensure_next_iteration = clutter_master_clock_default_ensure_next_iteration;
   iface->set_paused = clutter_master_clock_default_set_paused;
+  iface->add_delayed_timeline = clutter_master_clock_default_add_delayed_timeline;
+  iface->remove_delayed_timeline = clutter_master_clock_default_remove_delayed_timeline;
 }
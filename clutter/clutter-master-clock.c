@@ -42,6 +42,10 @@
 #include "gdk/clutter-backend-gdk.h"
 #include "gdk/clutter-master-clock-gdk.h"
 #endif
+#ifdef CLUTTER_WINDOWING_ANDROID
+#include "android/clutter-backend-android.h"
+#include "android/clutter-master-clock-android.h"
+#endif
 
 #define clutter_master_clock_get_type   _clutter_master_clock_get_type
 
@@ -65,6 +69,11 @@ _clutter_master_clock_get_default (void)
     if (CLUTTER_IS_BACKEND_GDK (context->backend))
       context->master_clock = g_object_new (CLUTTER_TYPE_MASTER_CLOCK_GDK, NULL);
     else
+#endif
+#ifdef CLUTTER_HAS_ANDROID_CHOREOGRAPHER
+    if (CLUTTER_IS_BACKEND_ANDROID (context->backend))
+      context->master_clock = g_object_new (CLUTTER_TYPE_MASTER_CLOCK_ANDROID, NULL);
+    else
 #endif
       context->master_clock = g_object_new (CLUTTER_TYPE_MASTER_CLOCK_DEFAULT, NULL);
   }
@@ -147,3 +156,54 @@ _clutter_master_clock_set_paused (ClutterMasterClock *master_clock,
   CLUTTER_MASTER_CLOCK_GET_IFACE (master_clock)->set_paused (master_clock,
                                                              !!paused);
 }
+
+/*
+ * _clutter_master_clock_add_delayed_timeline:
+ * @master_clock: a #ClutterMasterClock
+ * @timeline: a #ClutterTimeline
+ * @start_time: the monotonic time at which @timeline should start, in µs
+ *
+ * Asks @master_clock to call _clutter_timeline_delay_elapsed() on
+ * @timeline at the first frame after @start_time.
+ *
+ * Return value: %FALSE if @master_clock does not handle delayed
+ *   timelines, and the caller should wait on its own
+ */
+gboolean
+_clutter_master_clock_add_delayed_timeline (ClutterMasterClock *master_clock,
+                                            ClutterTimeline    *timeline,
+                                            gint64              start_time)
+{
+  ClutterMasterClockIface *iface;
+
+  g_return_val_if_fail (CLUTTER_IS_MASTER_CLOCK (master_clock), FALSE);
+
+  iface = CLUTTER_MASTER_CLOCK_GET_IFACE (master_clock);
+  if (iface->add_delayed_timeline == NULL)
+    return FALSE;
+
+  iface->add_delayed_timeline (master_clock, timeline, start_time);
+
+  return TRUE;
+}
+
+/*
+ * _clutter_master_clock_remove_delayed_timeline:
+ * @master_clock: a #ClutterMasterClock
+ * @timeline: a #ClutterTimeline
+ *
+ * Removes a @timeline added with _clutter_master_clock_add_delayed_timeline()
+ * before its delay has elapsed.
+ */
+void
+_clutter_master_clock_remove_delayed_timeline (ClutterMasterClock *master_clock,
+                                               ClutterTimeline    *timeline)
+{
+  ClutterMasterClockIface *iface;
+
+  g_return_if_fail (CLUTTER_IS_MASTER_CLOCK (master_clock));
+
+  iface = CLUTTER_MASTER_CLOCK_GET_IFACE (master_clock);
+  if (iface->remove_delayed_timeline != NULL)
+    iface->remove_delayed_timeline (master_clock, timeline);
+}
@@ -49,6 +49,15 @@ struct _ClutterMasterClockIface
   void (* ensure_next_iteration)  (ClutterMasterClock *master_clock);
   void (* set_paused)             (ClutterMasterClock *master_clock,
                                    gboolean            paused);
+
+  /* optional; implementations without them use a timeout source for
+   * each delayed timeline
+   */
+  void (* add_delayed_timeline)   (ClutterMasterClock *master_clock,
+                                   ClutterTimeline    *timeline,
+                                   gint64              start_time);
+  void (* remove_delayed_timeline) (ClutterMasterClock *master_clock,
+                                    ClutterTimeline    *timeline);
 };
 
 GType _clutter_master_clock_get_type (void) G_GNUC_CONST;
@@ -62,12 +71,25 @@ void                    _clutter_master_clock_start_running             (Clutter
 void                    _clutter_master_clock_ensure_next_iteration     (ClutterMasterClock *master_clock);
 void                    _clutter_master_clock_set_paused                (ClutterMasterClock *master_clock,
                                                                          gboolean            paused);
+gboolean                _clutter_master_clock_add_delayed_timeline      (ClutterMasterClock *master_clock,
+                                                                         ClutterTimeline    *timeline,
+                                                                         gint64              start_time);
+void                    _clutter_master_clock_remove_delayed_timeline   (ClutterMasterClock *master_clock,
+                                                                         ClutterTimeline    *timeline);
 
 void                    _clutter_timeline_advance                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
 gint64                  _clutter_timeline_get_delta                     (ClutterTimeline    *timeline);
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
+void                    _clutter_timeline_delay_elapsed                 (ClutterTimeline    *timeline);
+gdouble                 _clutter_timeline_get_progress_at_time          (ClutterTimeline    *timeline,
+                                                                         gint64              frame_time);
+gboolean                _clutter_timeline_shares_progress               (ClutterTimeline    *timeline,
+                                                                         ClutterTimeline    *other);
+void                    _clutter_timeline_set_progress_leader           (ClutterTimeline    *timeline,
+                                                                         ClutterTimeline    *leader);
+guint                   _clutter_timeline_get_max_frame_rate            (ClutterTimeline    *timeline);
 
 G_END_DECLS
 
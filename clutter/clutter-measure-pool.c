@@ -0,0 +1,336 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterMeasurePool: measures actors on worker threads.
+ *
+ * Layout managers can ask for the preferred sizes of a batch of children
+ * before laying them out; the children whose type declared thread safe
+ * ClutterMeasureFuncs are measured in parallel, and the results are
+ * stored in the size request cache of each actor, so that the following
+ * calls to clutter_actor_get_preferred_width() and
+ * clutter_actor_get_preferred_height() on the main thread are hits.
+ *
+ * The jobs of a batch are shared between the worker threads and the
+ * main thread, which take the next job from the batch until none are
+ * left; the main thread then waits for the workers to finish.
+ *
+ * The pool is disabled unless the CLUTTER_MEASURE_THREADS environment
+ * variable sets the number of worker threads.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-measure-pool.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+/* below this number of jobs, waking up the workers costs more than
+ * measuring the actors on the main thread
+ */
+#define MIN_PARALLEL_JOBS       4
+
+typedef struct _MeasureJob
+{
+  const ClutterMeasureRequest *request;
+  const ClutterMeasureFuncs *funcs;
+  gpointer data;
+
+  gfloat min_size;
+  gfloat natural_size;
+} MeasureJob;
+
+typedef struct _MeasureBatch
+{
+  MeasureJob *jobs;
+  gint n_jobs;
+
+  /* the index of the next job to run */
+  gint next_job;
+
+  GMutex mutex;
+  GCond cond;
+
+  /* the workers that did not finish yet; protected by mutex */
+  guint n_workers;
+} MeasureBatch;
+
+/* GType to ClutterMeasureFuncs; only modified on the main thread */
+static GHashTable *measure_types = NULL;
+
+static GThreadPool *measure_pool = NULL;
+
+static GPrivate measure_context = G_PRIVATE_INIT (g_object_unref);
+
+/*< private >
+ * _clutter_measure_pool_register_type:
+ * @actor_type: a #ClutterActor type
+ * @funcs: (transfer none): the functions measuring @actor_type
+ *
+ * Declares that the actors of @actor_type can be measured off the main
+ * thread using @funcs. The subclasses of @actor_type overriding the
+ * size requests are measured on the main thread.
+ */
+void
+_clutter_measure_pool_register_type (GType                      actor_type,
+                                     const ClutterMeasureFuncs *funcs)
+{
+  g_return_if_fail (g_type_is_a (actor_type, CLUTTER_TYPE_ACTOR));
+  g_return_if_fail (funcs != NULL);
+
+  if (G_UNLIKELY (measure_types == NULL))
+    measure_types = g_hash_table_new (NULL, NULL);
+
+  g_hash_table_insert (measure_types,
+                       GSIZE_TO_POINTER (actor_type),
+                       (gpointer) funcs);
+}
+
+static const ClutterMeasureFuncs *
+clutter_measure_pool_get_funcs (ClutterActor *actor)
+{
+  ClutterActorClass *klass = CLUTTER_ACTOR_GET_CLASS (actor);
+  GType type;
+
+  for (type = G_OBJECT_TYPE (actor);
+       type != CLUTTER_TYPE_ACTOR;
+       type = g_type_parent (type))
+    {
+      const ClutterMeasureFuncs *funcs;
+      ClutterActorClass *type_class;
+
+      funcs = g_hash_table_lookup (measure_types, GSIZE_TO_POINTER (type));
+      if (funcs == NULL)
+        continue;
+
+      /* a subclass overriding the size requests might not be thread safe */
+      type_class = g_type_class_peek (type);
+      if (klass->get_preferred_width != type_class->get_preferred_width ||
+          klass->get_preferred_height != type_class->get_preferred_height)
+        return NULL;
+
+      return funcs;
+    }
+
+  return NULL;
+}
+
+static void
+measure_batch_run_jobs (MeasureBatch *batch)
+{
+  while (TRUE)
+    {
+      gint index_ = g_atomic_int_add (&batch->next_job, 1);
+      MeasureJob *job;
+
+      if (index_ >= batch->n_jobs)
+        break;
+
+      job = &batch->jobs[index_];
+      job->funcs->measure (job->data, &job->min_size, &job->natural_size);
+    }
+}
+
+static void
+measure_worker (gpointer data,
+                gpointer user_data)
+{
+  MeasureBatch *batch = data;
+
+  measure_batch_run_jobs (batch);
+
+  g_mutex_lock (&batch->mutex);
+  batch->n_workers -= 1;
+  g_cond_signal (&batch->cond);
+  g_mutex_unlock (&batch->mutex);
+}
+
+/*< private >
+ * _clutter_measure_pool_is_enabled:
+ *
+ * Checks whether the layout managers should measure their children
+ * using _clutter_measure_pool_run().
+ *
+ * Return value: %TRUE if there are worker threads
+ */
+gboolean
+_clutter_measure_pool_is_enabled (void)
+{
+  return _clutter_get_measure_threads () > 0 && measure_types != NULL;
+}
+
+static void
+clutter_measure_pool_ensure_threads (void)
+{
+  GError *error = NULL;
+
+  if (G_LIKELY (measure_pool != NULL))
+    return;
+
+  measure_pool = g_thread_pool_new (measure_worker, NULL,
+                                    _clutter_get_measure_threads (),
+                                    FALSE,
+                                    &error);
+  if (error != NULL)
+    {
+      g_critical ("Unable to create the measure threads: %s", error->message);
+      g_error_free (error);
+    }
+}
+
+/*< private >
+ * _clutter_measure_pool_run:
+ * @requests: (array length=n_requests): the size requests
+ * @n_requests: the number of size requests
+ *
+ * Measures the actors in @requests that can be measured off the main
+ * thread, and stores the results in their size request caches.
+ *
+ * This function must be called on the main thread, without holding
+ * any lock needed by the measure functions.
+ */
+void
+_clutter_measure_pool_run (const ClutterMeasureRequest *requests,
+                           guint                        n_requests)
+{
+  MeasureBatch batch;
+  guint i, n_workers;
+  gint64 start_time;
+
+  if (!_clutter_measure_pool_is_enabled () || n_requests < MIN_PARALLEL_JOBS)
+    return;
+
+  clutter_measure_pool_ensure_threads ();
+  if (measure_pool == NULL)
+    return;
+
+  start_time = g_get_monotonic_time ();
+
+  batch.jobs = g_new (MeasureJob, n_requests);
+  batch.n_jobs = 0;
+  batch.next_job = 0;
+
+  for (i = 0; i < n_requests; i++)
+    {
+      const ClutterMeasureRequest *request = &requests[i];
+      const ClutterMeasureFuncs *funcs;
+      gfloat for_size;
+      gpointer data;
+
+      funcs = clutter_measure_pool_get_funcs (request->actor);
+      if (funcs == NULL)
+        continue;
+
+      if (!_clutter_actor_needs_size_request (request->actor,
+                                              request->orientation,
+                                              request->for_size,
+                                              &for_size))
+        continue;
+
+      data = funcs->prepare (request->actor, request->orientation, for_size);
+      if (data == NULL)
+        continue;
+
+      batch.jobs[batch.n_jobs].request = request;
+      batch.jobs[batch.n_jobs].funcs = funcs;
+      batch.jobs[batch.n_jobs].data = data;
+      batch.n_jobs += 1;
+    }
+
+  if (batch.n_jobs == 0)
+    {
+      g_free (batch.jobs);
+      return;
+    }
+
+  g_mutex_init (&batch.mutex);
+  g_cond_init (&batch.cond);
+
+  /* the main thread runs jobs too */
+  n_workers = MIN ((guint) batch.n_jobs - 1, _clutter_get_measure_threads ());
+  batch.n_workers = n_workers;
+
+  for (i = 0; i < n_workers; i++)
+    g_thread_pool_push (measure_pool, &batch, NULL);
+
+  measure_batch_run_jobs (&batch);
+
+  /* the batch lives on the stack, so we need to wait for every worker */
+  g_mutex_lock (&batch.mutex);
+  while (batch.n_workers > 0)
+    g_cond_wait (&batch.cond, &batch.mutex);
+  g_mutex_unlock (&batch.mutex);
+
+  g_cond_clear (&batch.cond);
+  g_mutex_clear (&batch.mutex);
+
+  for (i = 0; i < (guint) batch.n_jobs; i++)
+    {
+      MeasureJob *job = &batch.jobs[i];
+
+      _clutter_actor_set_size_request (job->request->actor,
+                                       job->request->orientation,
+                                       job->request->for_size,
+                                       job->min_size,
+                                       job->natural_size);
+
+      job->funcs->free (job->data);
+    }
+
+  CLUTTER_NOTE (LAYOUT, "Measured %d actors using %u workers in %.3f ms",
+                batch.n_jobs,
+                n_workers,
+                (g_get_monotonic_time () - start_time) / 1000.0);
+
+  g_free (batch.jobs);
+}
+
+/*< private >
+ * _clutter_measure_pool_get_pango_context:
+ *
+ * Retrieves a #PangoContext for the calling thread, to be used by the
+ * measure functions. The context has its own font map, since font maps
+ * cannot be shared between threads.
+ *
+ * Return value: (transfer none): a #PangoContext
+ */
+PangoContext *
+_clutter_measure_pool_get_pango_context (void)
+{
+  PangoContext *context = g_private_get (&measure_context);
+
+  if (G_UNLIKELY (context == NULL))
+    {
+      PangoFontMap *font_map = pango_cairo_font_map_new ();
+
+      context = pango_font_map_create_context (font_map);
+      g_object_unref (font_map);
+
+      g_private_set (&measure_context, context);
+    }
+
+  return context;
+}
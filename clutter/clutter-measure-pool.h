@@ -0,0 +1,85 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_MEASURE_POOL_H__
+#define __CLUTTER_MEASURE_POOL_H__
+
+#include <clutter/clutter-types.h>
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterMeasureFuncs     ClutterMeasureFuncs;
+typedef struct _ClutterMeasureRequest   ClutterMeasureRequest;
+
+/*< private >
+ * ClutterMeasureFuncs:
+ * @prepare: called on the main thread; copies the state of the actor
+ *   needed to measure it for @for_size, which does not include the
+ *   margins, or returns %NULL if the actor must be measured on the
+ *   main thread
+ * @measure: called on a worker thread with the data returned by
+ *   @prepare; it must not access the actor
+ * @free: frees the data returned by @prepare
+ *
+ * The functions used to measure an actor off the main thread; the
+ * results of @measure are the same as the ones returned by the
+ * #ClutterActorClass.get_preferred_width() and
+ * #ClutterActorClass.get_preferred_height() implementations.
+ */
+struct _ClutterMeasureFuncs
+{
+  gpointer (* prepare) (ClutterActor       *actor,
+                        ClutterOrientation  orientation,
+                        gfloat              for_size);
+  void     (* measure) (gpointer            data,
+                        gfloat             *min_size_p,
+                        gfloat             *natural_size_p);
+  void     (* free)    (gpointer            data);
+};
+
+/*< private >
+ * ClutterMeasureRequest:
+ * @actor: the actor to measure
+ * @orientation: %CLUTTER_ORIENTATION_HORIZONTAL for the preferred width,
+ *   and %CLUTTER_ORIENTATION_VERTICAL for the preferred height
+ * @for_size: the size to pass to clutter_actor_get_preferred_width()
+ *   or clutter_actor_get_preferred_height()
+ */
+struct _ClutterMeasureRequest
+{
+  ClutterActor *actor;
+  ClutterOrientation orientation;
+  gfloat for_size;
+};
+
+void            _clutter_measure_pool_register_type     (GType                        actor_type,
+                                                         const ClutterMeasureFuncs   *funcs);
+
+gboolean        _clutter_measure_pool_is_enabled        (void);
+void            _clutter_measure_pool_run               (const ClutterMeasureRequest *requests,
+                                                         guint                        n_requests);
+
+PangoContext *  _clutter_measure_pool_get_pango_context (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_MEASURE_POOL_H__ */
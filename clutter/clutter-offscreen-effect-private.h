@@ -5,6 +5,40 @@
 
 G_BEGIN_DECLS
 
+typedef struct _ClutterPointwiseEffectFuncs     ClutterPointwiseEffectFuncs;
+
+/*< private >
+ * ClutterPointwiseEffectFuncs:
+ * @get_snippet: returns the %COGL_SNIPPET_HOOK_FRAGMENT snippet applying
+ *   the effect to cogl_color_out
+ * @set_uniforms: sets the uniforms used by the snippet on a pipeline
+ * @is_active: returns whether the effect changes the colors at all, or
+ *   %NULL if it always does
+ *
+ * The functions of an offscreen effect whose result at each pixel only
+ * depends on the color of that pixel. Consecutive pointwise effects of
+ * different types on an actor are painted using a single offscreen
+ * buffer and a single pipeline.
+ */
+struct _ClutterPointwiseEffectFuncs
+{
+  CoglSnippet * (* get_snippet)  (ClutterOffscreenEffect *effect);
+  void          (* set_uniforms) (ClutterOffscreenEffect *effect,
+                                  CoglPipeline           *pipeline);
+  gboolean      (* is_active)    (ClutterOffscreenEffect *effect);
+};
+
+void            _clutter_offscreen_effect_class_set_pointwise   (ClutterOffscreenEffectClass       *klass,
+                                                                 const ClutterPointwiseEffectFuncs *funcs);
+gboolean        _clutter_offscreen_effect_is_pointwise          (ClutterEffect                     *effect);
+void            _clutter_offscreen_effect_set_fused_effects     (ClutterOffscreenEffect            *effect,
+                                                                 GList                             *effects);
+void            _clutter_offscreen_effect_apply_pointwise       (GList                             *effects,
+                                                                 CoglPipeline                      *pipeline);
+void            _clutter_offscreen_effect_release_resources     (ClutterOffscreenEffect            *effect);
+gsize           _clutter_offscreen_effect_get_memory_size       (ClutterOffscreenEffect            *effect);
+void            _clutter_offscreen_effect_invalidate            (ClutterOffscreenEffect            *effect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_OFFSCREEN_EFFECT_PRIVATE_H__ */
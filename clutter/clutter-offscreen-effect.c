@@ -68,21 +68,44 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
+#include <math.h>
+
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 
 #include "cogl/cogl.h"
 
+#include "clutter-actor-meta-private.h"
 #include "clutter-actor-private.h"
 #include "clutter-debug.h"
+#include "clutter-offscreen-pool.h"
+#include "clutter-paint-debug.h"
+#include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 #include "clutter-stage-private.h"
 
+/* the largest error, in pixels, for a change of the transformation of
+ * the actor to be considered a translation by a whole number of pixels
+ */
+#define PIXEL_EPSILON   1e-3f
+
+/* the resolution of the fbo, relative to the stage, when the quality
+ * of the stage is lowered
+ */
+#define REDUCED_RESOLUTION_SCALE        0.5f
+
 struct _ClutterOffscreenEffectPrivate
 {
   CoglHandle offscreen;
   CoglPipeline *target;
   CoglHandle texture;
 
+  /* the render target borrowed from the pool of the stage, if the
+   * texture is not created by a sub-class; the texture is then a
+   * sub-texture of the target
+   */
+  ClutterOffscreenTarget *pool_target;
+
   ClutterActor *actor;
   ClutterActor *stage;
 
@@ -98,6 +121,21 @@ struct _ClutterOffscreenEffectPrivate
 
   gint old_opacity_override;
 
+  /* the resolution of the fbo relative to the stage, lowered by the
+   * adaptive quality of the stage
+   */
+  gfloat resolution_scale;
+
+  /* whether the fbo was clamped to the size of the stage, in which case
+   * it does not hold the whole paint box of the actor
+   */
+  guint fbo_clamped : 1;
+
+  /* whether the contents of the fbo must be painted again, even if the
+   * actor did not change
+   */
+  guint contents_dirty : 1;
+
   /* The matrix that was current the last time the fbo was updated. We
      need to keep track of this to detect when we can reuse the
      contents of the fbo without redrawing the actor. We need the
@@ -107,8 +145,17 @@ struct _ClutterOffscreenEffectPrivate
      and it won't cause a redraw to be queued on the parent's
      children. */
   CoglMatrix last_matrix_drawn;
+
+  /* the pointwise effects following this one on the actor, which are
+   * applied when painting the target instead of using their own fbo;
+   * the innermost effect is first
+   */
+  GList *fused_effects;
+  CoglPipeline *fused_pipeline;
 };
 
+static GQuark quark_pointwise_funcs = 0;
+
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterOffscreenEffect,
                                      clutter_offscreen_effect,
                                      CLUTTER_TYPE_EFFECT)
@@ -131,6 +178,20 @@ clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
       priv->offscreen = NULL;
     }
 
+  /* the target can be used by another effect, so the texture pointing
+   * to it must go as well
+   */
+  if (priv->pool_target != NULL)
+    {
+      _clutter_offscreen_target_release (priv->pool_target);
+      priv->pool_target = NULL;
+
+      cogl_handle_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
+  _clutter_offscreen_effect_set_fused_effects (self, NULL);
+
   /* we keep a back pointer here, to avoid going through the ActorMeta */
   priv->actor = clutter_actor_meta_get_actor (meta);
 }
@@ -145,6 +206,52 @@ clutter_offscreen_effect_real_create_texture (ClutterOffscreenEffect *effect,
                                      COGL_PIXEL_FORMAT_RGBA_8888_PRE);
 }
 
+/* uses a render target from the pool of the stage, keeping the one
+ * already borrowed if the new size is in the same bucket; the offscreen
+ * framebuffer draws to the whole target, and since the viewport is set
+ * up from the size of the stage the actor lands in its top left corner,
+ * which is exposed to the sub-classes as a texture of the requested size
+ */
+static gboolean
+update_pool_target (ClutterOffscreenEffect *self,
+                    int                     fbo_width,
+                    int                     fbo_height)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+  ClutterOffscreenPool *pool;
+  CoglContext *ctx;
+
+  pool = _clutter_stage_get_offscreen_pool (CLUTTER_STAGE (priv->stage));
+
+  if (priv->pool_target != NULL &&
+      (priv->pool_target->pool != pool ||
+       !_clutter_offscreen_target_fits (priv->pool_target, fbo_width, fbo_height)))
+    {
+      _clutter_offscreen_target_release (priv->pool_target);
+      priv->pool_target = NULL;
+    }
+
+  if (priv->pool_target == NULL)
+    {
+      priv->pool_target =
+        _clutter_offscreen_pool_acquire (pool,
+                                         fbo_width, fbo_height,
+                                         COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+      if (priv->pool_target == NULL)
+        return FALSE;
+    }
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  priv->texture = cogl_sub_texture_new (ctx, priv->pool_target->texture,
+                                        0, 0,
+                                        MAX (fbo_width, 1),
+                                        MAX (fbo_height, 1));
+  priv->offscreen = cogl_object_ref (priv->pool_target->offscreen);
+
+  return TRUE;
+}
+
 static gboolean
 update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
 {
@@ -188,6 +295,25 @@ update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
       priv->texture = NULL;
     }
 
+  if (priv->offscreen != NULL)
+    {
+      cogl_handle_unref (priv->offscreen);
+      priv->offscreen = NULL;
+    }
+
+  /* the textures created by sub-classes cannot be shared */
+  if (CLUTTER_OFFSCREEN_EFFECT_GET_CLASS (self)->create_texture ==
+      clutter_offscreen_effect_real_create_texture &&
+      update_pool_target (self, fbo_width, fbo_height))
+    {
+      priv->fbo_width = fbo_width;
+      priv->fbo_height = fbo_height;
+
+      cogl_pipeline_set_layer_texture (priv->target, 0, priv->texture);
+
+      return TRUE;
+    }
+
   priv->texture =
     clutter_offscreen_effect_create_texture (self, fbo_width, fbo_height);
   if (priv->texture == NULL)
@@ -198,9 +324,6 @@ update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
   priv->fbo_width = fbo_width;
   priv->fbo_height = fbo_height;
 
-  if (priv->offscreen != NULL)
-    cogl_handle_unref (priv->offscreen);
-
   priv->offscreen = cogl_offscreen_new_to_texture (priv->texture);
   if (priv->offscreen == NULL)
     {
@@ -260,29 +383,46 @@ clutter_offscreen_effect_pre_paint (ClutterEffect *effect)
       fbo_height = stage_height;
     }
 
+  /* if the fbo covers the whole stage then it only holds the parts of
+   * the actor inside the stage, and it cannot be moved around
+   */
+  priv->fbo_clamped = fbo_width >= stage_width || fbo_height >= stage_height;
+
   if (fbo_width == stage_width)
     priv->x_offset = 0.0f;
   if (fbo_height == stage_height)
     priv->y_offset = 0.0f;
 
   /* First assert that the framebuffer is the right size... */
-  if (!update_fbo (effect, fbo_width, fbo_height))
+  if (!update_fbo (effect,
+                   fbo_width * priv->resolution_scale,
+                   fbo_height * priv->resolution_scale))
     return FALSE;
 
-  texture_width = cogl_texture_get_width (priv->texture);
-  texture_height = cogl_texture_get_height (priv->texture);
+  priv->contents_dirty = FALSE;
+
+  /* the size of the texture in stage pixels */
+  texture_width = cogl_texture_get_width (priv->texture) / priv->resolution_scale;
+  texture_height = cogl_texture_get_height (priv->texture) / priv->resolution_scale;
 
   /* get the current modelview matrix so that we can copy it to the
    * framebuffer. We also store the matrix that was last used when we
    * updated the FBO so that we can detect when we don't need to
    * update the FBO to paint a second time */
-  cogl_get_modelview_matrix (&priv->last_matrix_drawn);
+  cogl_framebuffer_get_modelview_matrix (cogl_get_draw_framebuffer (),
+                                         &priv->last_matrix_drawn);
 
-  /* let's draw offscreen */
+  /* let's draw offscreen; the framebuffer is still pushed for the
+   * actors drawing through the implicit framebuffer
+   */
   cogl_push_framebuffer (priv->offscreen);
 
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_BATCH_BREAKS))
+    _clutter_paint_debug_note_batch_break (CLUTTER_BATCH_BREAK_OFFSCREEN);
+
   /* Copy the modelview that would have been used if rendering onscreen */
-  cogl_set_modelview_matrix (&priv->last_matrix_drawn);
+  cogl_framebuffer_set_modelview_matrix (priv->offscreen,
+                                         &priv->last_matrix_drawn);
 
   /* Set up the viewport so that it has the same size as the stage,
    * but offset it so that the actor of interest lands on our
@@ -305,8 +445,11 @@ clutter_offscreen_effect_pre_paint (ClutterEffect *effect)
     yexpand = MAX (yexpand, (priv->y_offset + texture_height) - height);
 
   /* Set the viewport */
-  cogl_set_viewport (-(priv->x_offset + xexpand), -(priv->y_offset + yexpand),
-                     width + (2 * xexpand), height + (2 * yexpand));
+  cogl_framebuffer_set_viewport (priv->offscreen,
+                                 -(priv->x_offset + xexpand) * priv->resolution_scale,
+                                 -(priv->y_offset + yexpand) * priv->resolution_scale,
+                                 (width + (2 * xexpand)) * priv->resolution_scale,
+                                 (height + (2 * yexpand)) * priv->resolution_scale);
 
   /* Copy the stage's projection matrix across to the framebuffer */
   _clutter_stage_get_projection_matrix (CLUTTER_STAGE (priv->stage),
@@ -329,14 +472,15 @@ clutter_offscreen_effect_pre_paint (ClutterEffect *effect)
                          1);
     }
 
-  cogl_set_projection_matrix (&projection);
+  cogl_framebuffer_set_projection_matrix (priv->offscreen, &projection);
 
   cogl_color_init_from_4ub (&transparent, 0, 0, 0, 0);
-  cogl_clear (&transparent,
-              COGL_BUFFER_BIT_COLOR |
-              COGL_BUFFER_BIT_DEPTH);
+  cogl_framebuffer_clear (priv->offscreen,
+                          COGL_BUFFER_BIT_COLOR |
+                          COGL_BUFFER_BIT_DEPTH,
+                          &transparent);
 
-  cogl_push_matrix ();
+  cogl_framebuffer_push_matrix (priv->offscreen);
 
   /* Override the actor's opacity to fully opaque - we paint the offscreen
    * texture with the actor's paint opacity, so we need to do this to avoid
@@ -376,13 +520,80 @@ clutter_offscreen_effect_real_paint_target (ClutterOffscreenEffect *effect)
                                       1.0, 1.0);
 }
 
+static const ClutterPointwiseEffectFuncs *
+get_pointwise_funcs (ClutterOffscreenEffect *effect)
+{
+  return g_type_get_qdata (G_OBJECT_TYPE (effect), quark_pointwise_funcs);
+}
+
+static void
+clutter_offscreen_effect_paint_fused (ClutterOffscreenEffect *effect)
+{
+  ClutterOffscreenEffectPrivate *priv = effect->priv;
+  const ClutterPointwiseEffectFuncs *funcs;
+  guint8 paint_opacity;
+  GList *l;
+
+  if (priv->fused_pipeline == NULL)
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      priv->fused_pipeline = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_layer_null_texture (priv->fused_pipeline,
+                                            0, /* layer number */
+                                            COGL_TEXTURE_TYPE_2D);
+
+      /* the snippets are applied in order, starting from the innermost
+       * effect, and ending with this one
+       */
+      for (l = priv->fused_effects; l != NULL; l = l->next)
+        {
+          funcs = get_pointwise_funcs (l->data);
+          cogl_pipeline_add_snippet (priv->fused_pipeline,
+                                     funcs->get_snippet (l->data));
+        }
+
+      funcs = get_pointwise_funcs (effect);
+      cogl_pipeline_add_snippet (priv->fused_pipeline,
+                                 funcs->get_snippet (effect));
+    }
+
+  for (l = priv->fused_effects; l != NULL; l = l->next)
+    {
+      funcs = get_pointwise_funcs (l->data);
+      funcs->set_uniforms (l->data, priv->fused_pipeline);
+    }
+
+  funcs = get_pointwise_funcs (effect);
+  funcs->set_uniforms (effect, priv->fused_pipeline);
+
+  cogl_pipeline_set_layer_texture (priv->fused_pipeline, 0, priv->texture);
+
+  paint_opacity = clutter_actor_get_paint_opacity (priv->actor);
+  cogl_pipeline_set_color4ub (priv->fused_pipeline,
+                              paint_opacity,
+                              paint_opacity,
+                              paint_opacity,
+                              paint_opacity);
+
+  cogl_push_source (priv->fused_pipeline);
+
+  cogl_rectangle (0, 0,
+                  cogl_texture_get_width (priv->texture),
+                  cogl_texture_get_height (priv->texture));
+
+  cogl_pop_source ();
+}
+
 static void
 clutter_offscreen_effect_paint_texture (ClutterOffscreenEffect *effect)
 {
   ClutterOffscreenEffectPrivate *priv = effect->priv;
+  CoglFramebuffer *framebuffer = cogl_get_draw_framebuffer ();
   CoglMatrix modelview;
 
-  cogl_push_matrix ();
+  cogl_framebuffer_push_matrix (framebuffer);
 
   /* Now reset the modelview to put us in stage coordinates so
    * we can drawn the result of our offscreen render as a textured
@@ -391,14 +602,26 @@ clutter_offscreen_effect_paint_texture (ClutterOffscreenEffect *effect)
   cogl_matrix_init_identity (&modelview);
   _clutter_actor_apply_modelview_transform (priv->stage, &modelview);
   cogl_matrix_translate (&modelview, priv->x_offset, priv->y_offset, 0.0f);
-  cogl_set_modelview_matrix (&modelview);
+
+  /* the targets are painted in texture pixels */
+  if (priv->resolution_scale != 1.0f)
+    cogl_matrix_scale (&modelview,
+                       1.0f / priv->resolution_scale,
+                       1.0f / priv->resolution_scale,
+                       1.0f);
+
+  cogl_framebuffer_set_modelview_matrix (framebuffer, &modelview);
 
   /* paint the target material; this is virtualized for
-   * sub-classes that require special hand-holding
+   * sub-classes that require special hand-holding, unless the
+   * effect is fused with the effects following it
    */
-  clutter_offscreen_effect_paint_target (effect);
+  if (priv->fused_effects != NULL)
+    clutter_offscreen_effect_paint_fused (effect);
+  else
+    clutter_offscreen_effect_paint_target (effect);
 
-  cogl_pop_matrix ();
+  cogl_framebuffer_pop_matrix (framebuffer);
 }
 
 static void
@@ -415,12 +638,98 @@ clutter_offscreen_effect_post_paint (ClutterEffect *effect)
   /* Restore the previous opacity override */
   clutter_actor_set_opacity_override (priv->actor, priv->old_opacity_override);
 
-  cogl_pop_matrix ();
+  cogl_framebuffer_pop_matrix (priv->offscreen);
   cogl_pop_framebuffer ();
 
   clutter_offscreen_effect_paint_texture (self);
 }
 
+/* checks whether painting the actor with @matrix instead of the matrix
+ * that was used to update the fbo only moves it on the stage by a whole
+ * number of pixels, in which case the contents of the fbo can be painted
+ * at the new position
+ */
+static gboolean
+clutter_offscreen_effect_get_translation (ClutterOffscreenEffect *self,
+                                          const CoglMatrix       *matrix,
+                                          gfloat                 *dx_p,
+                                          gfloat                 *dy_p)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+  const ClutterPaintVolume *volume;
+  ClutterPaintVolume pv;
+  ClutterVertex old_vertices[8], new_vertices[8];
+  CoglMatrix projection;
+  ClutterActor *stage;
+  float viewport[4];
+  gfloat dx, dy;
+  int i, n_vertices;
+
+  if (priv->fbo_clamped)
+    return FALSE;
+
+  stage = _clutter_actor_get_stage_internal (priv->actor);
+  if (stage == NULL)
+    return FALSE;
+
+  /* when the actor is painted inside another offscreen redirection the
+   * pixels of the draw framebuffer are not the pixels of the stage
+   */
+  if (cogl_get_draw_framebuffer () !=
+      _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (stage)))
+    return FALSE;
+
+  volume = clutter_actor_get_paint_volume (priv->actor);
+  if (volume == NULL)
+    return FALSE;
+
+  _clutter_paint_volume_copy_static (volume, &pv);
+  _clutter_paint_volume_complete (&pv);
+  n_vertices = pv.is_2d ? 4 : 8;
+
+  /* the offsets of the fbo are in stage coordinates, regardless of the
+   * scaling factor of the stage
+   */
+  _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage), &projection);
+  viewport[0] = 0.f;
+  viewport[1] = 0.f;
+  clutter_actor_get_size (stage, &viewport[2], &viewport[3]);
+
+  _clutter_util_fully_transform_vertices (&priv->last_matrix_drawn,
+                                          &projection,
+                                          viewport,
+                                          pv.vertices,
+                                          old_vertices,
+                                          n_vertices);
+  _clutter_util_fully_transform_vertices (matrix,
+                                          &projection,
+                                          viewport,
+                                          pv.vertices,
+                                          new_vertices,
+                                          n_vertices);
+
+  clutter_paint_volume_free (&pv);
+
+  dx = new_vertices[0].x - old_vertices[0].x;
+  dy = new_vertices[0].y - old_vertices[0].y;
+
+  if (fabsf (dx - roundf (dx)) > PIXEL_EPSILON ||
+      fabsf (dy - roundf (dy)) > PIXEL_EPSILON)
+    return FALSE;
+
+  for (i = 1; i < n_vertices; i++)
+    {
+      if (fabsf (new_vertices[i].x - old_vertices[i].x - dx) > PIXEL_EPSILON ||
+          fabsf (new_vertices[i].y - old_vertices[i].y - dy) > PIXEL_EPSILON)
+        return FALSE;
+    }
+
+  *dx_p = roundf (dx);
+  *dy_p = roundf (dy);
+
+  return TRUE;
+}
+
 static void
 clutter_offscreen_effect_paint (ClutterEffect           *effect,
                                 ClutterEffectPaintFlags  flags)
@@ -428,13 +737,34 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
   ClutterOffscreenEffect *self = CLUTTER_OFFSCREEN_EFFECT (effect);
   ClutterOffscreenEffectPrivate *priv = self->priv;
   CoglMatrix matrix;
+  gfloat dx, dy;
+
+  cogl_framebuffer_get_modelview_matrix (cogl_get_draw_framebuffer (), &matrix);
+
+  /* If the actor hasn't been redrawn and it has only been moved by
+     whole pixels on the stage, for instance because its parent is
+     scrolling, then the cached image only needs to be painted at a
+     different position */
+  if (priv->offscreen != NULL &&
+      !priv->contents_dirty &&
+      !(flags & CLUTTER_EFFECT_PAINT_ACTOR_DIRTY) &&
+      !cogl_matrix_equal (&matrix, &priv->last_matrix_drawn) &&
+      clutter_offscreen_effect_get_translation (self, &matrix, &dx, &dy))
+    {
+      CLUTTER_NOTE (PAINT, "Reusing the fbo of the effect '%s' moved by %.0f, %.0f",
+                    _clutter_actor_meta_get_debug_name (CLUTTER_ACTOR_META (effect)),
+                    dx, dy);
 
-  cogl_get_modelview_matrix (&matrix);
+      priv->x_offset += dx;
+      priv->y_offset += dy;
+      priv->last_matrix_drawn = matrix;
+    }
 
   /* If we've already got a cached image for the same matrix and the
      actor hasn't been redrawn then we can just use the cached image
      in the fbo */
   if (priv->offscreen == NULL ||
+      priv->contents_dirty ||
       (flags & CLUTTER_EFFECT_PAINT_ACTOR_DIRTY) ||
       !cogl_matrix_equal (&matrix, &priv->last_matrix_drawn))
     {
@@ -447,6 +777,21 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
     clutter_offscreen_effect_paint_texture (self);
 }
 
+static void
+clutter_offscreen_effect_set_quality (ClutterEffect       *effect,
+                                      ClutterQualityLevel  level)
+{
+  ClutterOffscreenEffectPrivate *priv = CLUTTER_OFFSCREEN_EFFECT (effect)->priv;
+  gfloat scale;
+
+  scale = level >= CLUTTER_QUALITY_REDUCED ? REDUCED_RESOLUTION_SCALE : 1.0f;
+  if (priv->resolution_scale == scale)
+    return;
+
+  priv->resolution_scale = scale;
+  priv->contents_dirty = TRUE;
+}
+
 static void
 clutter_offscreen_effect_finalize (GObject *gobject)
 {
@@ -462,6 +807,11 @@ clutter_offscreen_effect_finalize (GObject *gobject)
   if (priv->texture)
     cogl_handle_unref (priv->texture);
 
+  if (priv->pool_target != NULL)
+    _clutter_offscreen_target_release (priv->pool_target);
+
+  _clutter_offscreen_effect_set_fused_effects (self, NULL);
+
   G_OBJECT_CLASS (clutter_offscreen_effect_parent_class)->finalize (gobject);
 }
 
@@ -472,6 +822,9 @@ clutter_offscreen_effect_class_init (ClutterOffscreenEffectClass *klass)
   ClutterEffectClass *effect_class = CLUTTER_EFFECT_CLASS (klass);
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
+  quark_pointwise_funcs =
+    g_quark_from_static_string ("clutter-offscreen-effect-pointwise-funcs");
+
   klass->create_texture = clutter_offscreen_effect_real_create_texture;
   klass->paint_target = clutter_offscreen_effect_real_paint_target;
 
@@ -480,6 +833,7 @@ clutter_offscreen_effect_class_init (ClutterOffscreenEffectClass *klass)
   effect_class->pre_paint = clutter_offscreen_effect_pre_paint;
   effect_class->post_paint = clutter_offscreen_effect_post_paint;
   effect_class->paint = clutter_offscreen_effect_paint;
+  effect_class->set_quality = clutter_offscreen_effect_set_quality;
 
   gobject_class->finalize = clutter_offscreen_effect_finalize;
 }
@@ -488,6 +842,7 @@ static void
 clutter_offscreen_effect_init (ClutterOffscreenEffect *self)
 {
   self->priv = clutter_offscreen_effect_get_instance_private (self);
+  self->priv->resolution_scale = 1.0f;
 }
 
 /**
@@ -669,3 +1024,200 @@ clutter_offscreen_effect_get_target_rect (ClutterOffscreenEffect *effect,
 
   return TRUE;
 }
+
+/*< private >
+ * _clutter_offscreen_effect_class_set_pointwise:
+ * @klass: the class of an offscreen effect
+ * @funcs: (transfer none): the functions used to fuse the effect
+ *
+ * Declares that the effects of the type of @klass only change the color
+ * of each pixel, so that they can be fused with the adjacent pointwise
+ * effects. The sub-classes of the type are not pointwise, unless they
+ * declare it as well.
+ */
+void
+_clutter_offscreen_effect_class_set_pointwise (ClutterOffscreenEffectClass       *klass,
+                                               const ClutterPointwiseEffectFuncs *funcs)
+{
+  g_return_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT_CLASS (klass));
+  g_return_if_fail (funcs != NULL);
+
+  g_type_set_qdata (G_TYPE_FROM_CLASS (klass), quark_pointwise_funcs,
+                    (gpointer) funcs);
+}
+
+/*< private >
+ * _clutter_offscreen_effect_is_pointwise:
+ * @effect: a #ClutterEffect
+ *
+ * Checks whether @effect is an enabled pointwise effect which can be
+ * fused with the adjacent pointwise effects.
+ *
+ * Return value: %TRUE if the effect can be fused
+ */
+gboolean
+_clutter_offscreen_effect_is_pointwise (ClutterEffect *effect)
+{
+  const ClutterPointwiseEffectFuncs *funcs;
+
+  if (!CLUTTER_IS_OFFSCREEN_EFFECT (effect))
+    return FALSE;
+
+  funcs = get_pointwise_funcs (CLUTTER_OFFSCREEN_EFFECT (effect));
+  if (funcs == NULL)
+    return FALSE;
+
+  if (!clutter_actor_meta_get_enabled (CLUTTER_ACTOR_META (effect)))
+    return FALSE;
+
+  /* the effects warn and disable themselves when painted */
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return FALSE;
+
+  if (funcs->is_active != NULL &&
+      !funcs->is_active (CLUTTER_OFFSCREEN_EFFECT (effect)))
+    return FALSE;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_offscreen_effect_set_fused_effects:
+ * @effect: a pointwise #ClutterOffscreenEffect
+ * @effects: (transfer container) (element-type Clutter.Effect): the
+ *   pointwise effects following @effect on its actor, starting from
+ *   the innermost one, or %NULL
+ *
+ * Sets the effects that @effect applies when painting its target, in
+ * addition to its own; the actor does not paint them on their own.
+ */
+void
+_clutter_offscreen_effect_set_fused_effects (ClutterOffscreenEffect *effect,
+                                             GList                  *effects)
+{
+  ClutterOffscreenEffectPrivate *priv = effect->priv;
+  GList *l, *old_l;
+
+  for (l = effects, old_l = priv->fused_effects;
+       l != NULL && old_l != NULL;
+       l = l->next, old_l = old_l->next)
+    {
+      if (l->data != old_l->data)
+        break;
+    }
+
+  /* the pipeline only needs to be built again for different effects */
+  if (l == NULL && old_l == NULL)
+    {
+      g_list_free (effects);
+      return;
+    }
+
+  g_list_free_full (priv->fused_effects, g_object_unref);
+  priv->fused_effects = effects;
+
+  for (l = priv->fused_effects; l != NULL; l = l->next)
+    g_object_ref (l->data);
+
+  g_clear_pointer (&priv->fused_pipeline, cogl_object_unref);
+}
+
+/*< private >
+ * _clutter_offscreen_effect_apply_pointwise:
+ * @effects: (element-type Clutter.Effect): pointwise effects, starting
+ *   from the innermost one
+ * @pipeline: the pipeline drawing the content of an actor
+ *
+ * Adds the snippets of @effects to @pipeline, and sets their uniforms,
+ * so that @pipeline draws the content with the effects applied without
+ * going through an offscreen buffer.
+ */
+void
+_clutter_offscreen_effect_apply_pointwise (GList        *effects,
+                                           CoglPipeline *pipeline)
+{
+  GList *l;
+
+  for (l = effects; l != NULL; l = l->next)
+    {
+      const ClutterPointwiseEffectFuncs *funcs = get_pointwise_funcs (l->data);
+
+      cogl_pipeline_add_snippet (pipeline, funcs->get_snippet (l->data));
+      funcs->set_uniforms (l->data, pipeline);
+    }
+}
+
+/*< private >
+ * _clutter_offscreen_effect_release_resources:
+ * @effect: a #ClutterOffscreenEffect
+ *
+ * Frees the offscreen buffer of @effect and its texture, giving back
+ * the render target to the pool of the stage; they are created again
+ * the next time the actor is painted.
+ */
+void
+_clutter_offscreen_effect_release_resources (ClutterOffscreenEffect *effect)
+{
+  ClutterOffscreenEffectPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect));
+
+  priv = effect->priv;
+
+  if (priv->offscreen == NULL && priv->texture == NULL)
+    return;
+
+  CLUTTER_NOTE (PAINT, "Releasing the fbo of the effect '%s'",
+                _clutter_actor_meta_get_debug_name (CLUTTER_ACTOR_META (effect)));
+
+  g_clear_pointer (&priv->offscreen, cogl_object_unref);
+  g_clear_pointer (&priv->texture, cogl_object_unref);
+
+  /* the pipelines keep a reference on the texture */
+  g_clear_pointer (&priv->target, cogl_object_unref);
+  g_clear_pointer (&priv->fused_pipeline, cogl_object_unref);
+
+  if (priv->pool_target != NULL)
+    {
+      _clutter_offscreen_target_release (priv->pool_target);
+      priv->pool_target = NULL;
+    }
+
+  priv->fbo_width = 0;
+  priv->fbo_height = 0;
+}
+
+/*< private >
+ * _clutter_offscreen_effect_invalidate:
+ * @effect: a #ClutterOffscreenEffect
+ *
+ * Makes @effect paint its actor offscreen again the next time it is
+ * painted, instead of reusing the contents of its fbo.
+ */
+void
+_clutter_offscreen_effect_invalidate (ClutterOffscreenEffect *effect)
+{
+  effect->priv->contents_dirty = TRUE;
+}
+
+/*< private >
+ * _clutter_offscreen_effect_get_memory_size:
+ * @effect: a #ClutterOffscreenEffect
+ *
+ * Estimates the size of the texture of the offscreen buffer of
+ * @effect, assuming 4 bytes per pixel.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_offscreen_effect_get_memory_size (ClutterOffscreenEffect *effect)
+{
+  ClutterOffscreenEffectPrivate *priv = effect->priv;
+
+  if (priv->texture == NULL)
+    return 0;
+
+  return (gsize) cogl_texture_get_width (priv->texture)
+       * cogl_texture_get_height (priv->texture)
+       * 4;
+}
@@ -0,0 +1,350 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterOffscreenPool: a pool of offscreen render targets.
+ *
+ * Each stage owns a pool of textures and framebuffers used by the
+ * offscreen effects. The targets are bucketed by power of two sizes
+ * and by pixel format, so that an effect whose size changes on every
+ * frame, for instance during a resize animation, keeps using the same
+ * target until the size goes over the bucket; the targets that are
+ * given back are kept for the other effects, up to POOL_MAX_IDLE_BYTES.
+ *
+ * The targets hold a reference on the pool, so that they can be given
+ * back after the stage has been destroyed, in which case they are
+ * simply freed.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-offscreen-pool.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+#define POOL_MIN_SIZE           16
+
+/* the memory used by the idle targets of a pool */
+#define POOL_MAX_IDLE_BYTES     (32 * 1024 * 1024)
+
+struct _ClutterOffscreenPool
+{
+  /* the targets given back, the most recent first */
+  GQueue idle;
+  gsize idle_bytes;
+
+  guint n_borrowed;
+  gsize borrowed_bytes;
+
+  guint destroyed : 1;
+};
+
+static int
+get_bucket_size (int size)
+{
+  int bucket = POOL_MIN_SIZE;
+
+  while (bucket < size)
+    bucket *= 2;
+
+  return bucket;
+}
+
+static gsize
+get_target_bytes (const ClutterOffscreenTarget *target)
+{
+  int bpp = 4;
+
+  if (target->format == COGL_PIXEL_FORMAT_A_8)
+    bpp = 1;
+
+  return (gsize) target->width * target->height * bpp;
+}
+
+static void
+clutter_offscreen_target_free (ClutterOffscreenTarget *target)
+{
+  cogl_object_unref (target->offscreen);
+  cogl_object_unref (target->texture);
+
+  g_slice_free (ClutterOffscreenTarget, target);
+}
+
+static void
+clutter_offscreen_pool_note (ClutterOffscreenPool *pool,
+                             const gchar          *action)
+{
+  CLUTTER_NOTE (PAINT, "Offscreen pool %p: %s; %u borrowed (%" G_GSIZE_FORMAT " KiB), "
+                "%u idle (%" G_GSIZE_FORMAT " KiB)",
+                pool,
+                action,
+                pool->n_borrowed,
+                pool->borrowed_bytes / 1024,
+                g_queue_get_length (&pool->idle),
+                pool->idle_bytes / 1024);
+}
+
+static void
+clutter_offscreen_pool_free (ClutterOffscreenPool *pool)
+{
+  g_slice_free (ClutterOffscreenPool, pool);
+}
+
+static void
+clutter_offscreen_pool_trim (ClutterOffscreenPool *pool,
+                             gsize                 max_bytes)
+{
+  while (pool->idle_bytes > max_bytes && pool->idle.tail != NULL)
+    {
+      ClutterOffscreenTarget *target = g_queue_pop_tail (&pool->idle);
+
+      pool->idle_bytes -= get_target_bytes (target);
+      clutter_offscreen_target_free (target);
+    }
+}
+
+/*< private >
+ * _clutter_offscreen_pool_new:
+ *
+ * Creates a new, empty, pool of offscreen render targets.
+ *
+ * Return value: the newly created pool
+ */
+ClutterOffscreenPool *
+_clutter_offscreen_pool_new (void)
+{
+  ClutterOffscreenPool *pool = g_slice_new0 (ClutterOffscreenPool);
+
+  g_queue_init (&pool->idle);
+
+  return pool;
+}
+
+/*< private >
+ * _clutter_offscreen_pool_destroy:
+ * @pool: a #ClutterOffscreenPool
+ *
+ * Frees the idle targets of @pool; the pool itself is freed once all
+ * of the borrowed targets have been given back.
+ */
+void
+_clutter_offscreen_pool_destroy (ClutterOffscreenPool *pool)
+{
+  g_return_if_fail (pool != NULL);
+  g_return_if_fail (!pool->destroyed);
+
+  clutter_offscreen_pool_trim (pool, 0);
+  pool->destroyed = TRUE;
+
+  if (pool->n_borrowed == 0)
+    clutter_offscreen_pool_free (pool);
+}
+
+/*< private >
+ * _clutter_offscreen_pool_acquire:
+ * @pool: a #ClutterOffscreenPool
+ * @width: the minimum width of the target
+ * @height: the minimum height of the target
+ * @format: the pixel format of the target
+ *
+ * Borrows a render target at least @width by @height pixels big from
+ * @pool, reusing an idle one in the same bucket if possible.
+ *
+ * Return value: a target, to be given back using
+ *   _clutter_offscreen_target_release(), or %NULL if the target could
+ *   not be allocated
+ */
+ClutterOffscreenTarget *
+_clutter_offscreen_pool_acquire (ClutterOffscreenPool *pool,
+                                 int                   width,
+                                 int                   height,
+                                 CoglPixelFormat       format)
+{
+  ClutterOffscreenTarget *target;
+  CoglError *error = NULL;
+  int bucket_width, bucket_height;
+  GList *l;
+
+  g_return_val_if_fail (pool != NULL, NULL);
+  g_return_val_if_fail (!pool->destroyed, NULL);
+
+  bucket_width = get_bucket_size (MAX (width, 1));
+  bucket_height = get_bucket_size (MAX (height, 1));
+
+  for (l = pool->idle.head; l != NULL; l = l->next)
+    {
+      target = l->data;
+
+      if (target->width == bucket_width &&
+          target->height == bucket_height &&
+          target->format == format)
+        {
+          g_queue_delete_link (&pool->idle, l);
+          pool->idle_bytes -= get_target_bytes (target);
+
+          goto out;
+        }
+    }
+
+  target = g_slice_new0 (ClutterOffscreenTarget);
+  target->width = bucket_width;
+  target->height = bucket_height;
+  target->format = format;
+  target->texture = cogl_texture_new_with_size (bucket_width, bucket_height,
+                                                COGL_TEXTURE_NO_SLICING,
+                                                format);
+  if (target->texture == NULL)
+    {
+      g_slice_free (ClutterOffscreenTarget, target);
+      return NULL;
+    }
+
+  target->offscreen = cogl_offscreen_new_with_texture (target->texture);
+  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (target->offscreen), &error))
+    {
+      CLUTTER_NOTE (PAINT, "Unable to allocate a %dx%d offscreen target: %s",
+                    bucket_width, bucket_height,
+                    error->message);
+      cogl_error_free (error);
+
+      clutter_offscreen_target_free (target);
+      return NULL;
+    }
+
+out:
+  target->pool = pool;
+
+  pool->n_borrowed += 1;
+  pool->borrowed_bytes += get_target_bytes (target);
+
+  clutter_offscreen_pool_note (pool, "target borrowed");
+
+  return target;
+}
+
+/*< private >
+ * _clutter_offscreen_target_fits:
+ * @target: a #ClutterOffscreenTarget
+ * @width: the width needed
+ * @height: the height needed
+ *
+ * Checks whether @target is in the bucket used for @width by @height
+ * targets; if not, a smaller or larger target should be borrowed.
+ *
+ * Return value: %TRUE if @target can be used for the given size
+ */
+gboolean
+_clutter_offscreen_target_fits (ClutterOffscreenTarget *target,
+                                int                     width,
+                                int                     height)
+{
+  g_return_val_if_fail (target != NULL, FALSE);
+
+  return target->width == get_bucket_size (MAX (width, 1)) &&
+         target->height == get_bucket_size (MAX (height, 1));
+}
+
+/*< private >
+ * _clutter_offscreen_target_release:
+ * @target: a #ClutterOffscreenTarget
+ *
+ * Gives @target back to the pool it was borrowed from.
+ */
+void
+_clutter_offscreen_target_release (ClutterOffscreenTarget *target)
+{
+  ClutterOffscreenPool *pool;
+
+  g_return_if_fail (target != NULL);
+  g_return_if_fail (target->pool != NULL);
+
+  pool = target->pool;
+  target->pool = NULL;
+
+  pool->n_borrowed -= 1;
+  pool->borrowed_bytes -= get_target_bytes (target);
+
+  if (pool->destroyed)
+    {
+      clutter_offscreen_target_free (target);
+
+      if (pool->n_borrowed == 0)
+        clutter_offscreen_pool_free (pool);
+
+      return;
+    }
+
+  g_queue_push_head (&pool->idle, target);
+  pool->idle_bytes += get_target_bytes (target);
+
+  clutter_offscreen_pool_trim (pool, POOL_MAX_IDLE_BYTES);
+
+  clutter_offscreen_pool_note (pool, "target given back");
+}
+
+/*< private >
+ * _clutter_offscreen_pool_release_idle:
+ * @pool: a #ClutterOffscreenPool
+ *
+ * Frees all the idle targets of @pool; the borrowed targets are not
+ * affected.
+ */
+void
+_clutter_offscreen_pool_release_idle (ClutterOffscreenPool *pool)
+{
+  g_return_if_fail (pool != NULL);
+
+  clutter_offscreen_pool_trim (pool, 0);
+
+  clutter_offscreen_pool_note (pool, "idle targets released");
+}
+
+/*< private >
+ * _clutter_offscreen_pool_get_stats:
+ * @pool: a #ClutterOffscreenPool
+ * @n_borrowed: (out) (optional): the number of borrowed targets
+ * @n_idle: (out) (optional): the number of idle targets
+ * @n_bytes: (out) (optional): the memory used by the textures of
+ *   all the targets, in bytes
+ *
+ * Retrieves the occupancy of @pool.
+ */
+void
+_clutter_offscreen_pool_get_stats (ClutterOffscreenPool *pool,
+                                   guint                *n_borrowed,
+                                   guint                *n_idle,
+                                   gsize                *n_bytes)
+{
+  g_return_if_fail (pool != NULL);
+
+  if (n_borrowed != NULL)
+    *n_borrowed = pool->n_borrowed;
+
+  if (n_idle != NULL)
+    *n_idle = g_queue_get_length (&pool->idle);
+
+  if (n_bytes != NULL)
+    *n_bytes = pool->borrowed_bytes + pool->idle_bytes;
+}
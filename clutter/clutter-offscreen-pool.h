@@ -0,0 +1,76 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_OFFSCREEN_POOL_H__
+#define __CLUTTER_OFFSCREEN_POOL_H__
+
+#include <clutter/clutter-types.h>
+#include <cogl/cogl.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterOffscreenPool    ClutterOffscreenPool;
+typedef struct _ClutterOffscreenTarget  ClutterOffscreenTarget;
+
+/*< private >
+ * ClutterOffscreenTarget:
+ * @texture: the texture of the target; its size is rounded up to a
+ *   power of two, so only the top left corner is used
+ * @offscreen: the framebuffer drawing to @texture
+ * @width: the width of @texture
+ * @height: the height of @texture
+ * @format: the pixel format of @texture
+ *
+ * A render target borrowed from a #ClutterOffscreenPool.
+ */
+struct _ClutterOffscreenTarget
+{
+  CoglTexture *texture;
+  CoglOffscreen *offscreen;
+
+  int width;
+  int height;
+  CoglPixelFormat format;
+
+  /*< private >*/
+  ClutterOffscreenPool *pool;
+};
+
+ClutterOffscreenPool *          _clutter_offscreen_pool_new             (void);
+void                            _clutter_offscreen_pool_destroy         (ClutterOffscreenPool *pool);
+ClutterOffscreenTarget *        _clutter_offscreen_pool_acquire         (ClutterOffscreenPool *pool,
+                                                                         int                   width,
+                                                                         int                   height,
+                                                                         CoglPixelFormat       format);
+void                            _clutter_offscreen_pool_release_idle    (ClutterOffscreenPool *pool);
+void                            _clutter_offscreen_pool_get_stats       (ClutterOffscreenPool *pool,
+                                                                         guint                *n_borrowed,
+                                                                         guint                *n_idle,
+                                                                         gsize                *n_bytes);
+
+gboolean                        _clutter_offscreen_target_fits          (ClutterOffscreenTarget *target,
+                                                                         int                     width,
+                                                                         int                     height);
+void                            _clutter_offscreen_target_release       (ClutterOffscreenTarget *target);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_OFFSCREEN_POOL_H__ */
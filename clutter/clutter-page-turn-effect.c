@@ -44,6 +44,7 @@
 #include "clutter-page-turn-effect.h"
 
 #include "clutter-debug.h"
+#include "clutter-deform-effect-private.h"
 #include "clutter-private.h"
 
 #define CLUTTER_PAGE_TURN_EFFECT_CLASS(k)       (G_TYPE_CHECK_CLASS_CAST ((k), CLUTTER_TYPE_PAGE_TURN_EFFECT, ClutterPageTurnEffectClass))
@@ -63,6 +64,13 @@ struct _ClutterPageTurnEffect
 struct _ClutterPageTurnEffectClass
 {
   ClutterDeformEffectClass parent_class;
+
+  CoglSnippet *snippet;
+
+  gint center_uniform;
+  gint rotation_uniform;
+  gint radius_uniform;
+  gint active_uniform;
 };
 
 enum
@@ -147,6 +155,102 @@ clutter_page_turn_effect_deform_vertex (ClutterDeformEffect *effect,
     }
 }
 
+/* the same deformation as clutter_page_turn_effect_deform_vertex(),
+ * with the shading applied to the color of the pipeline
+ */
+static const gchar *page_turn_glsl_declarations =
+  "uniform vec2 clutter_page_turn_center;\n"
+  "uniform vec2 clutter_page_turn_rotation;\n"
+  "uniform float clutter_page_turn_radius;\n"
+  "uniform float clutter_page_turn_active;\n";
+
+static const gchar *page_turn_glsl_source =
+  "if (clutter_page_turn_active > 0.0)\n"
+  "  {\n"
+  "    float radius = clutter_page_turn_radius;\n"
+  "    float c = clutter_page_turn_rotation.x;\n"
+  "    float s = clutter_page_turn_rotation.y;\n"
+  "    vec2 d = cogl_position_in.xy - clutter_page_turn_center;\n"
+  "    float rx = d.x * c + d.y * s - radius;\n"
+  "    float ry = d.y * c - d.x * s;\n"
+  "    float turn_angle = 0.0;\n"
+  "\n"
+  "    if (rx > radius * -2.0)\n"
+  "      {\n"
+  "        turn_angle = rx / radius * 1.5707963 - 1.5707963;\n"
+  "        cogl_color_out.rgb *= (sin (turn_angle) * 96.0 + 159.0) / 255.0;\n"
+  "      }\n"
+  "\n"
+  "    if (rx > 0.0)\n"
+  "      {\n"
+  "        float small_radius =\n"
+  "          radius - min (radius, turn_angle * 10.0 / 3.1415926);\n"
+  "\n"
+  "        rx = small_radius * cos (turn_angle) + radius;\n"
+  "\n"
+  "        cogl_position_out = cogl_modelview_projection_matrix *\n"
+  "          vec4 (rx * c - ry * s + clutter_page_turn_center.x,\n"
+  "                rx * s + ry * c + clutter_page_turn_center.y,\n"
+  "                small_radius * sin (turn_angle) + radius,\n"
+  "                1.0);\n"
+  "      }\n"
+  "  }\n";
+
+static CoglSnippet *
+clutter_page_turn_effect_get_snippet (ClutterDeformEffect *effect)
+{
+  ClutterPageTurnEffectClass *klass = CLUTTER_PAGE_TURN_EFFECT_GET_CLASS (effect);
+
+  if (G_UNLIKELY (klass->snippet == NULL))
+    klass->snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_VERTEX,
+                                       page_turn_glsl_declarations,
+                                       page_turn_glsl_source);
+
+  return klass->snippet;
+}
+
+static void
+clutter_page_turn_effect_set_uniforms (ClutterDeformEffect *effect,
+                                       CoglPipeline        *pipeline,
+                                       gfloat               width,
+                                       gfloat               height)
+{
+  ClutterPageTurnEffect *self = CLUTTER_PAGE_TURN_EFFECT (effect);
+  ClutterPageTurnEffectClass *klass = CLUTTER_PAGE_TURN_EFFECT_GET_CLASS (effect);
+  gfloat center[2], rotation[2];
+  gfloat radians;
+
+  if (G_UNLIKELY (klass->active_uniform < 0))
+    {
+      klass->center_uniform =
+        cogl_pipeline_get_uniform_location (pipeline, "clutter_page_turn_center");
+      klass->rotation_uniform =
+        cogl_pipeline_get_uniform_location (pipeline, "clutter_page_turn_rotation");
+      klass->radius_uniform =
+        cogl_pipeline_get_uniform_location (pipeline, "clutter_page_turn_radius");
+      klass->active_uniform =
+        cogl_pipeline_get_uniform_location (pipeline, "clutter_page_turn_active");
+    }
+
+  radians = self->angle / (180.0f / G_PI);
+
+  center[0] = (1.f - self->period) * width;
+  center[1] = (1.f - self->period) * height;
+  rotation[0] = cosf (radians);
+  rotation[1] = sinf (radians);
+
+  cogl_pipeline_set_uniform_float (pipeline, klass->center_uniform, 2, 1, center);
+  cogl_pipeline_set_uniform_float (pipeline, klass->rotation_uniform, 2, 1, rotation);
+  cogl_pipeline_set_uniform_1f (pipeline, klass->radius_uniform, self->radius);
+  cogl_pipeline_set_uniform_1f (pipeline, klass->active_uniform,
+                                self->period != 0.0 ? 1.f : 0.f);
+}
+
+static const ClutterDeformEffectShaderFuncs shader_funcs = {
+  clutter_page_turn_effect_get_snippet,
+  clutter_page_turn_effect_set_uniforms
+};
+
 static void
 clutter_page_turn_effect_set_property (GObject      *gobject,
                                        guint         prop_id,
@@ -263,6 +367,13 @@ clutter_page_turn_effect_class_init (ClutterPageTurnEffectClass *klass)
   g_object_class_install_property (gobject_class, PROP_RADIUS, pspec);
 
   deform_class->deform_vertex = clutter_page_turn_effect_deform_vertex;
+
+  klass->center_uniform = -1;
+  klass->rotation_uniform = -1;
+  klass->radius_uniform = -1;
+  klass->active_uniform = -1;
+
+  _clutter_deform_effect_class_set_shader (deform_class, &shader_funcs);
 }
 
 static void
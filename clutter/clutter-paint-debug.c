@@ -0,0 +1,359 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * The overdraw and batch-breaks visualizations of CLUTTER_PAINT.
+ *
+ * With "overdraw", the paint nodes draw with a single pipeline which
+ * adds a constant amount to the red channel of the framebuffer, cleared
+ * to black by the root node, so that at the end of the frame each pixel
+ * holds the number of times it was filled; the framebuffer is then read
+ * back and replaced with a heat map of those counts.
+ *
+ * With "batch-breaks", each actor is tinted according to what prevented
+ * its geometry from being batched with the geometry drawn before it:
+ * an offscreen redirection, in magenta; a clip, in cyan; a change of
+ * pipeline, in yellow. Cogl does not expose its own comparison of the
+ * pipelines, so two pipelines are considered compatible when they use
+ * the same GL textures and the same program, which is what the journal
+ * mostly splits its batches on; the sub-textures of an atlas share the
+ * same GL texture, and do not break the batches.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-paint-debug.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+/* the amount added to the red channel by each fill */
+#define OVERDRAW_STEP           16
+
+/* the number of layers compared between two pipelines */
+#define MAX_COMPARED_LAYERS     4
+
+typedef struct {
+  int n_layers;
+  GLuint textures[MAX_COMPARED_LAYERS];
+  CoglHandle program;
+} PipelineState;
+
+/* the colors of the heat map, indexed by the number of fills */
+static const guint8 overdraw_colors[][4] = {
+  {   0,   0,   0, 255 },
+  {   0,   0, 160, 255 },
+  {   0, 160,   0, 255 },
+  { 220, 220,   0, 255 },
+  { 240, 130,   0, 255 },
+  { 240,   0,   0, 255 },
+};
+
+static PipelineState last_pipeline = { -1, };
+
+/* the batch breaks of the actors being painted, innermost last */
+static GArray *actor_breaks = NULL;
+
+/*< private >
+ * _clutter_paint_debug_begin_frame:
+ *
+ * Resets the state of the visualizations before painting a stage.
+ */
+void
+_clutter_paint_debug_begin_frame (void)
+{
+  last_pipeline.n_layers = -1;
+
+  if (actor_breaks != NULL)
+    g_array_set_size (actor_breaks, 0);
+}
+
+/*< private >
+ * _clutter_paint_debug_end_frame:
+ * @framebuffer: the framebuffer of the stage
+ * @width: the width of the stage
+ * @height: the height of the stage
+ *
+ * Replaces the contents of @framebuffer with the heat map of the
+ * overdraw, if the "overdraw" visualization is enabled. The modelview
+ * of @framebuffer must be the one of the stage.
+ */
+void
+_clutter_paint_debug_end_frame (CoglFramebuffer *framebuffer,
+                                float            width,
+                                float            height)
+{
+  static CoglPipeline *heatmap = NULL;
+  CoglTexture *texture;
+  int fb_width, fb_height;
+  guint8 *pixels;
+  int i;
+
+  if (!(clutter_paint_debug_flags & CLUTTER_DEBUG_OVERDRAW))
+    return;
+
+  fb_width = cogl_framebuffer_get_width (framebuffer);
+  fb_height = cogl_framebuffer_get_height (framebuffer);
+  if (fb_width <= 0 || fb_height <= 0)
+    return;
+
+  pixels = g_malloc (fb_width * fb_height * 4);
+
+  if (!cogl_framebuffer_read_pixels (framebuffer, 0, 0, fb_width, fb_height,
+                                     COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                     pixels))
+    goto out;
+
+  for (i = 0; i < fb_width * fb_height; i++)
+    {
+      guint8 *p = pixels + i * 4;
+      guint n_fills;
+
+      n_fills = (p[0] + OVERDRAW_STEP / 2) / OVERDRAW_STEP;
+      n_fills = MIN (n_fills, G_N_ELEMENTS (overdraw_colors) - 1);
+
+      p[0] = overdraw_colors[n_fills][0];
+      p[1] = overdraw_colors[n_fills][1];
+      p[2] = overdraw_colors[n_fills][2];
+      p[3] = overdraw_colors[n_fills][3];
+    }
+
+  texture = cogl_texture_new_from_data (fb_width, fb_height,
+                                        COGL_TEXTURE_NO_SLICING |
+                                        COGL_TEXTURE_NO_ATLAS,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                        COGL_PIXEL_FORMAT_ANY,
+                                        fb_width * 4,
+                                        pixels);
+  if (texture == NULL)
+    goto out;
+
+  if (heatmap == NULL)
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      heatmap = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_blend (heatmap, "RGBA = ADD (SRC_COLOR, 0)", NULL);
+      cogl_pipeline_set_layer_filters (heatmap, 0,
+                                       COGL_PIPELINE_FILTER_NEAREST,
+                                       COGL_PIPELINE_FILTER_NEAREST);
+    }
+
+  cogl_pipeline_set_layer_texture (heatmap, 0, texture);
+
+  cogl_framebuffer_draw_textured_rectangle (framebuffer, heatmap,
+                                            0, 0, width, height,
+                                            0, 0, 1, 1);
+
+  /* the pipeline keeps the texture alive until the next frame */
+  cogl_object_unref (texture);
+
+out:
+  g_free (pixels);
+}
+
+/*< private >
+ * _clutter_paint_debug_get_overdraw_pipeline:
+ *
+ * Retrieves the pipeline used by the paint nodes instead of their own
+ * when the "overdraw" visualization is enabled.
+ *
+ * Return value: (transfer none): a #CoglPipeline
+ */
+CoglPipeline *
+_clutter_paint_debug_get_overdraw_pipeline (void)
+{
+  static CoglPipeline *overdraw = NULL;
+
+  if (G_UNLIKELY (overdraw == NULL))
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      overdraw = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (overdraw, OVERDRAW_STEP, 0, 0, 0);
+      cogl_pipeline_set_blend (overdraw, "RGBA = ADD (SRC_COLOR, DST_COLOR)", NULL);
+    }
+
+  return overdraw;
+}
+
+/*< private >
+ * _clutter_paint_debug_push_actor:
+ *
+ * Starts collecting the batch breaks of an actor; the breaks noted
+ * while painting its children are collected by the children.
+ */
+void
+_clutter_paint_debug_push_actor (void)
+{
+  ClutterBatchBreak breaks = 0;
+
+  if (G_UNLIKELY (actor_breaks == NULL))
+    actor_breaks = g_array_new (FALSE, FALSE, sizeof (ClutterBatchBreak));
+
+  g_array_append_val (actor_breaks, breaks);
+}
+
+/*< private >
+ * _clutter_paint_debug_pop_actor:
+ *
+ * Stops collecting the batch breaks of the actor being painted.
+ *
+ * Return value: the batch breaks noted since the matching call to
+ *   _clutter_paint_debug_push_actor()
+ */
+ClutterBatchBreak
+_clutter_paint_debug_pop_actor (void)
+{
+  ClutterBatchBreak breaks;
+
+  if (actor_breaks == NULL || actor_breaks->len == 0)
+    return 0;
+
+  breaks = g_array_index (actor_breaks, ClutterBatchBreak, actor_breaks->len - 1);
+  g_array_set_size (actor_breaks, actor_breaks->len - 1);
+
+  return breaks;
+}
+
+/*< private >
+ * _clutter_paint_debug_note_batch_break:
+ * @reason: the reason of the break
+ *
+ * Notes that the geometry of the actor being painted cannot be
+ * batched with the geometry drawn before it.
+ */
+void
+_clutter_paint_debug_note_batch_break (ClutterBatchBreak reason)
+{
+  if (actor_breaks == NULL || actor_breaks->len == 0)
+    return;
+
+  g_array_index (actor_breaks, ClutterBatchBreak, actor_breaks->len - 1) |= reason;
+}
+
+static gboolean
+collect_layer_texture (CoglPipeline *pipeline,
+                       int           layer_index,
+                       void         *user_data)
+{
+  PipelineState *state = user_data;
+  CoglTexture *texture;
+  GLuint gl_texture = 0;
+  GLenum gl_target;
+
+  if (state->n_layers == MAX_COMPARED_LAYERS)
+    return FALSE;
+
+  texture = cogl_pipeline_get_layer_texture (pipeline, layer_index);
+  if (texture != NULL)
+    cogl_texture_get_gl_texture (texture, &gl_texture, &gl_target);
+
+  state->textures[state->n_layers++] = gl_texture;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_paint_debug_note_pipeline:
+ * @pipeline: the pipeline about to be drawn with
+ *
+ * Notes a %CLUTTER_BATCH_BREAK_PIPELINE break if @pipeline cannot be
+ * batched with the pipeline drawn with before it.
+ */
+void
+_clutter_paint_debug_note_pipeline (CoglPipeline *pipeline)
+{
+  PipelineState state = { 0, };
+  int i;
+
+  cogl_pipeline_foreach_layer (pipeline, collect_layer_texture, &state);
+  state.program = cogl_pipeline_get_user_program (pipeline);
+
+  if (last_pipeline.n_layers >= 0)
+    {
+      gboolean compatible = state.n_layers == last_pipeline.n_layers &&
+                            state.program == last_pipeline.program;
+
+      for (i = 0; compatible && i < state.n_layers; i++)
+        compatible = state.textures[i] == last_pipeline.textures[i];
+
+      if (!compatible)
+        _clutter_paint_debug_note_batch_break (CLUTTER_BATCH_BREAK_PIPELINE);
+    }
+
+  last_pipeline = state;
+}
+
+/*< private >
+ * _clutter_paint_debug_draw_batch_breaks:
+ * @framebuffer: the framebuffer of the stage
+ * @width: the width of the actor
+ * @height: the height of the actor
+ * @breaks: the batch breaks of the actor
+ *
+ * Tints the allocation of the actor being painted with the color of
+ * the most expensive of @breaks.
+ */
+void
+_clutter_paint_debug_draw_batch_breaks (CoglFramebuffer   *framebuffer,
+                                        float              width,
+                                        float              height,
+                                        ClutterBatchBreak  breaks)
+{
+  static CoglPipeline *tints[3] = { NULL, };
+  int tint;
+
+  if (breaks & CLUTTER_BATCH_BREAK_OFFSCREEN)
+    tint = 0;
+  else if (breaks & CLUTTER_BATCH_BREAK_CLIP)
+    tint = 1;
+  else if (breaks & CLUTTER_BATCH_BREAK_PIPELINE)
+    tint = 2;
+  else
+    return;
+
+  if (G_UNLIKELY (tints[0] == NULL))
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      /* premultiplied, a quarter opaque */
+      tints[0] = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (tints[0], 64, 0, 64, 64);
+      tints[1] = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (tints[1], 0, 64, 64, 64);
+      tints[2] = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (tints[2], 64, 64, 0, 64);
+    }
+
+  /* the tints are not noted, so that they do not count as breaks of
+   * the next actor
+   */
+  cogl_framebuffer_draw_rectangle (framebuffer, tints[tint],
+                                   0, 0, width, height);
+}
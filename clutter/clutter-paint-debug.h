@@ -0,0 +1,64 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_PAINT_DEBUG_H__
+#define __CLUTTER_PAINT_DEBUG_H__
+
+#include <clutter/clutter-types.h>
+#include <cogl/cogl.h>
+
+G_BEGIN_DECLS
+
+/*< private >
+ * ClutterBatchBreak:
+ * @CLUTTER_BATCH_BREAK_PIPELINE: the actor drew with a pipeline that
+ *   cannot be batched with the previous one
+ * @CLUTTER_BATCH_BREAK_CLIP: the actor pushed a clip
+ * @CLUTTER_BATCH_BREAK_OFFSCREEN: the actor was redirected offscreen
+ *
+ * The reasons for which the geometry of an actor could not be batched
+ * with the geometry drawn before it.
+ */
+typedef enum {
+  CLUTTER_BATCH_BREAK_PIPELINE  = 1 << 0,
+  CLUTTER_BATCH_BREAK_CLIP      = 1 << 1,
+  CLUTTER_BATCH_BREAK_OFFSCREEN = 1 << 2
+} ClutterBatchBreak;
+
+void            _clutter_paint_debug_begin_frame                (void);
+void            _clutter_paint_debug_end_frame                  (CoglFramebuffer   *framebuffer,
+                                                                 float              width,
+                                                                 float              height);
+
+CoglPipeline *  _clutter_paint_debug_get_overdraw_pipeline      (void);
+
+void            _clutter_paint_debug_push_actor                 (void);
+ClutterBatchBreak _clutter_paint_debug_pop_actor                (void);
+void            _clutter_paint_debug_note_batch_break           (ClutterBatchBreak  reason);
+void            _clutter_paint_debug_note_pipeline              (CoglPipeline      *pipeline);
+void            _clutter_paint_debug_draw_batch_breaks          (CoglFramebuffer   *framebuffer,
+                                                                 float              width,
+                                                                 float              height,
+                                                                 ClutterBatchBreak  breaks);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_PAINT_DEBUG_H__ */
@@ -29,6 +29,8 @@
 #include <json-glib/json-glib.h>
 #include <clutter/clutter-paint-node.h>
 
+#include "clutter-paint-stream-private.h"
+
 G_BEGIN_DECLS
 
 #define CLUTTER_PAINT_NODE_CLASS(klass)         (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_PAINT_NODE, ClutterPaintNodeClass))
@@ -70,6 +72,9 @@ struct _ClutterPaintNodeClass
   JsonNode*(* serialize) (ClutterPaintNode *node);
 
   CoglFramebuffer *(* get_framebuffer) (ClutterPaintNode *node);
+
+  gboolean (* record)    (ClutterPaintNode         *node,
+                          ClutterPaintStreamWriter *writer);
 };
 
 #define PAINT_OP_INIT   { PAINT_OP_INVALID }
@@ -113,8 +118,25 @@ ClutterPaintNode *      _clutter_root_node_new                          (CoglFra
 ClutterPaintNode *      _clutter_transform_node_new                     (const CoglMatrix            *matrix);
 ClutterPaintNode *      _clutter_dummy_node_new                         (ClutterActor                *actor);
 
+CoglPipeline *          _clutter_pipeline_node_get_pipeline             (ClutterPaintNode            *node);
+
+void                    _clutter_paint_node_begin_depth_pass            (CoglFramebuffer             *framebuffer,
+                                                                         guint                        n_slices);
+void                    _clutter_paint_node_end_depth_pass              (void);
+guint                   _clutter_paint_node_set_depth_slice             (guint                        slice);
+void                    _clutter_paint_node_draw_depth_prepass          (guint                        slice,
+                                                                         const CoglMatrix            *modelview,
+                                                                         const ClutterActorBox       *box);
+
 void                    _clutter_paint_node_paint                       (ClutterPaintNode            *root);
 void                    _clutter_paint_node_dump_tree                   (ClutterPaintNode            *root);
+gsize                   _clutter_paint_node_get_memory_size             (ClutterPaintNode            *root);
+
+void                    _clutter_paint_node_record                      (ClutterPaintNode            *node,
+                                                                         ClutterPaintStreamWriter    *writer);
+ClutterPaintNode *      _clutter_paint_node_replay                      (ClutterPaintStreamReader    *reader);
+ClutterPaintNode *      _clutter_paint_node_decode                      (ClutterPaintStreamReader    *reader,
+                                                                         guint8                       tag);
 
 G_GNUC_INTERNAL
 void                    clutter_paint_node_remove_child                 (ClutterPaintNode      *node,
@@ -77,6 +77,54 @@
 
 static inline void      clutter_paint_operation_clear   (ClutterPaintOperation *op);
 
+/* the number of operations arrays kept around for reuse, and the
+ * maximum length of an array that can be put back into the pool, to
+ * avoid holding on to large allocations
+ */
+#define OPERATIONS_POOL_SIZE            256
+#define OPERATIONS_POOL_MAX_LENGTH      16
+
+/* paint nodes are created and destroyed on every frame, and most of
+ * them have at least one operation; recycling the arrays holding the
+ * operations saves us two allocations per node; like the rest of the
+ * paint machinery, the pool is only accessed while holding the Clutter
+ * lock
+ */
+static GArray *operations_pool[OPERATIONS_POOL_SIZE];
+static guint operations_pool_len = 0;
+
+static GArray *
+clutter_paint_operations_acquire (void)
+{
+  if (operations_pool_len > 0)
+    return operations_pool[--operations_pool_len];
+
+  return g_array_sized_new (FALSE, FALSE, sizeof (ClutterPaintOperation), 1);
+}
+
+static void
+clutter_paint_operations_release (GArray *operations)
+{
+  guint i;
+
+  for (i = 0; i < operations->len; i++)
+    {
+      ClutterPaintOperation *op;
+
+      op = &g_array_index (operations, ClutterPaintOperation, i);
+      clutter_paint_operation_clear (op);
+    }
+
+  if (operations_pool_len < OPERATIONS_POOL_SIZE &&
+      operations->len <= OPERATIONS_POOL_MAX_LENGTH)
+    {
+      g_array_set_size (operations, 0);
+      operations_pool[operations_pool_len++] = operations;
+    }
+  else
+    g_array_unref (operations);
+}
+
 static void
 value_paint_node_init (GValue *value)
 {
@@ -176,19 +224,7 @@ clutter_paint_node_real_finalize (ClutterPaintNode *node)
   g_free (node->name);
 
   if (node->operations != NULL)
-    {
-      guint i;
-
-      for (i = 0; i < node->operations->len; i++)
-        {
-          ClutterPaintOperation *op;
-
-          op = &g_array_index (node->operations, ClutterPaintOperation, i);
-          clutter_paint_operation_clear (op);
-        }
-
-      g_array_unref (node->operations);
-    }
+    clutter_paint_operations_release (node->operations);
 
   iter = node->first_child;
   while (iter != NULL)
@@ -822,8 +858,7 @@ clutter_paint_node_maybe_init_operations (ClutterPaintNode *node)
   if (node->operations != NULL)
     return;
 
-  node->operations =
-    g_array_new (FALSE, FALSE, sizeof (ClutterPaintOperation));
+  node->operations = clutter_paint_operations_acquire ();
 }
 
 /**
@@ -893,6 +928,11 @@ clutter_paint_node_add_texture_rectangle (ClutterPaintNode      *node,
  * This function acquires a reference on the passed @path, so it
  * is safe to call cogl_object_unref() when it returns.
  *
+ * Cogl keeps the tessellation of a path until the path is modified,
+ * so paths that do not change should be kept and added again at each
+ * frame, instead of being built from scratch; see also
+ * clutter_path_get_cogl_path().
+ *
  * Since: 1.10
  * Stability: unstable
  */
@@ -952,6 +992,12 @@ _clutter_paint_node_paint (ClutterPaintNode *node)
   ClutterPaintNode *iter;
   gboolean res;
 
+  /* the trees painted while a ClutterPaintRecorder records the frame
+   * are added to the stream
+   */
+  if (node->parent == NULL)
+    _clutter_paint_recorder_add_tree (node);
+
   res = klass->pre_draw (node);
 
   if (res)
@@ -1099,6 +1145,181 @@ _clutter_paint_node_dump_tree (ClutterPaintNode *node)
 #endif /* CLUTTER_ENABLE_DEBUG */
 }
 
+/*< private >
+ * _clutter_paint_node_record:
+ * @node: a #ClutterPaintNode
+ * @writer: the writer of the block being recorded
+ *
+ * Writes @node, its rectangles and its children into the block of a
+ * #ClutterPaintRecorder. The nodes whose class cannot be recorded,
+ * like the dummy nodes of the actors, are replaced by their children;
+ * the paths and the primitives of the operations are not recorded.
+ */
+void
+_clutter_paint_node_record (ClutterPaintNode         *node,
+                            ClutterPaintStreamWriter *writer)
+{
+  ClutterPaintNodeClass *klass = CLUTTER_PAINT_NODE_GET_CLASS (node);
+  ClutterPaintNode *iter;
+  guint32 n_rectangles = 0;
+  guint i;
+
+  if (klass->record == NULL || !klass->record (node, writer))
+    {
+      for (iter = node->first_child; iter != NULL; iter = iter->next_sibling)
+        _clutter_paint_node_record (iter, writer);
+
+      return;
+    }
+
+  if (node->operations != NULL)
+    {
+      for (i = 0; i < node->operations->len; i++)
+        {
+          const ClutterPaintOperation *op;
+
+          op = &g_array_index (node->operations, ClutterPaintOperation, i);
+          if (op->opcode == PAINT_OP_TEX_RECT)
+            n_rectangles += 1;
+        }
+    }
+
+  _clutter_paint_stream_writer_put_uint32 (writer, n_rectangles);
+
+  for (i = 0; n_rectangles > 0 && i < node->operations->len; i++)
+    {
+      const ClutterPaintOperation *op;
+      guint j;
+
+      op = &g_array_index (node->operations, ClutterPaintOperation, i);
+      if (op->opcode != PAINT_OP_TEX_RECT)
+        continue;
+
+      for (j = 0; j < 8; j++)
+        _clutter_paint_stream_writer_put_float (writer, op->op.texrect[j]);
+    }
+
+  for (iter = node->first_child; iter != NULL; iter = iter->next_sibling)
+    _clutter_paint_node_record (iter, writer);
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_END);
+}
+
+/* reads the nodes written by _clutter_paint_node_record() and adds them
+ * to @parent, up to the end of the children of @parent
+ */
+static gboolean
+clutter_paint_node_replay_children (ClutterPaintNode         *parent,
+                                    ClutterPaintStreamReader *reader)
+{
+  while (_clutter_paint_stream_reader_is_valid (reader))
+    {
+      ClutterPaintNode *node;
+      guint32 n_rectangles, i;
+      guint8 tag;
+
+      tag = _clutter_paint_stream_reader_get_uint8 (reader);
+      if (tag == PAINT_STREAM_NODE_END)
+        return _clutter_paint_stream_reader_is_valid (reader);
+
+      node = _clutter_paint_node_decode (reader, tag);
+      if (node == NULL)
+        return FALSE;
+
+      n_rectangles = _clutter_paint_stream_reader_get_uint32 (reader);
+      if (n_rectangles > _clutter_paint_stream_reader_get_remaining (reader) / (8 * sizeof (float)))
+        {
+          clutter_paint_node_unref (node);
+          return FALSE;
+        }
+
+      for (i = 0; i < n_rectangles; i++)
+        {
+          ClutterActorBox box;
+          float tex[4];
+
+          box.x1 = _clutter_paint_stream_reader_get_float (reader);
+          box.y1 = _clutter_paint_stream_reader_get_float (reader);
+          box.x2 = _clutter_paint_stream_reader_get_float (reader);
+          box.y2 = _clutter_paint_stream_reader_get_float (reader);
+          tex[0] = _clutter_paint_stream_reader_get_float (reader);
+          tex[1] = _clutter_paint_stream_reader_get_float (reader);
+          tex[2] = _clutter_paint_stream_reader_get_float (reader);
+          tex[3] = _clutter_paint_stream_reader_get_float (reader);
+
+          clutter_paint_node_add_texture_rectangle (node, &box,
+                                                    tex[0], tex[1],
+                                                    tex[2], tex[3]);
+        }
+
+      if (!clutter_paint_node_replay_children (node, reader))
+        {
+          clutter_paint_node_unref (node);
+          return FALSE;
+        }
+
+      clutter_paint_node_add_child (parent, node);
+      clutter_paint_node_unref (node);
+    }
+
+  return FALSE;
+}
+
+/*< private >
+ * _clutter_paint_node_replay:
+ * @reader: the reader of a block of a #ClutterPaintPlayer
+ *
+ * Builds the tree of nodes recorded in a block of the stream.
+ *
+ * Return value: (transfer full): the root of the tree, or %NULL if
+ *   the block is not valid
+ */
+ClutterPaintNode *
+_clutter_paint_node_replay (ClutterPaintStreamReader *reader)
+{
+  ClutterPaintNode *root;
+
+  root = _clutter_transform_node_new (NULL);
+  clutter_paint_node_set_name (root, "Replay");
+
+  if (!clutter_paint_node_replay_children (root, reader))
+    {
+      clutter_paint_node_unref (root);
+      return NULL;
+    }
+
+  return root;
+}
+
+/*< private >
+ * _clutter_paint_node_get_memory_size:
+ * @root: a #ClutterPaintNode
+ *
+ * Computes the memory used by the instances and the operations of the
+ * nodes of the tree starting from @root; the resources referenced by
+ * the nodes, like textures and pipelines, are not included.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_paint_node_get_memory_size (ClutterPaintNode *root)
+{
+  ClutterPaintNode *iter;
+  GTypeQuery query;
+  gsize size;
+
+  g_type_query (G_TYPE_FROM_INSTANCE (root), &query);
+  size = query.instance_size;
+
+  if (root->operations != NULL)
+    size += (gsize) root->operations->len * sizeof (ClutterPaintOperation);
+
+  for (iter = root->first_child; iter != NULL; iter = iter->next_sibling)
+    size += _clutter_paint_node_get_memory_size (iter);
+
+  return size;
+}
+
 /*< private >
  * _clutter_paint_node_create:
  * @gtype: a #ClutterPaintNode type
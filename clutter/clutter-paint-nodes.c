@@ -39,12 +39,16 @@
 
 #include "clutter-paint-node-private.h"
 
+#include <string.h>
+
 #include <pango/pango.h>
 #include <cogl/cogl.h>
 
 #include "clutter-actor-private.h"
 #include "clutter-color.h"
 #include "clutter-debug.h"
+#include "clutter-feature.h"
+#include "clutter-paint-debug.h"
 #include "clutter-private.h"
 
 #include "clutter-paint-nodes.h"
@@ -52,6 +56,89 @@
 static CoglPipeline *default_color_pipeline   = NULL;
 static CoglPipeline *default_texture_pipeline = NULL;
 
+/* the pipelines of the rounded rectangle, border and shadow nodes */
+static CoglPipeline *default_rounded_rect_pipeline = NULL;
+static CoglPipeline *default_border_pipeline       = NULL;
+static CoglPipeline *default_shadow_pipeline       = NULL;
+
+/* the distance from the edge of a rounded rectangle, negative inside;
+ * the position and the half size are passed as the texture coordinates
+ * of the layers 0 and 1, and the radius and the width of the border or
+ * the blur of the shadow as the texture coordinates of the layer 2, so
+ * that the rectangles using the same pipeline are batched together
+ */
+static const gchar *rounded_rect_glsl_declarations =
+"float\n"
+"clutter_rounded_rect_distance (vec2  position,\n"
+"                               vec2  half_size,\n"
+"                               float radius)\n"
+"{\n"
+"  vec2 q = abs (position) - half_size + vec2 (radius);\n"
+"\n"
+"  return min (max (q.x, q.y), 0.0) + length (max (q, vec2 (0.0))) - radius;\n"
+"}\n";
+
+#define ROUNDED_RECT_GLSL_DISTANCE \
+"  float distance =\n" \
+"    clutter_rounded_rect_distance (cogl_tex_coord_in[0].xy,\n" \
+"                                   cogl_tex_coord_in[1].xy,\n" \
+"                                   cogl_tex_coord_in[2].x);\n"
+
+static const gchar *rounded_rect_glsl_source =
+ROUNDED_RECT_GLSL_DISTANCE
+"  cogl_color_out *= clamp (0.5 - distance, 0.0, 1.0);\n";
+
+static const gchar *border_glsl_source =
+ROUNDED_RECT_GLSL_DISTANCE
+"  cogl_color_out *= clamp (0.5 - distance, 0.0, 1.0)\n"
+"                  * clamp (0.5 + distance + cogl_tex_coord_in[2].y, 0.0, 1.0);\n";
+
+static const gchar *shadow_glsl_source =
+ROUNDED_RECT_GLSL_DISTANCE
+"  float blur = cogl_tex_coord_in[2].y;\n"
+"\n"
+"  cogl_color_out *= 1.0 - smoothstep (-blur, blur, distance);\n";
+
+static CoglPipeline *
+create_rounded_rect_pipeline (CoglContext *ctx,
+                              const gchar *source)
+{
+  CoglPipeline *pipeline;
+  CoglColor cogl_color;
+  int i;
+
+  cogl_color_init_from_4f (&cogl_color, 1.0, 1.0, 1.0, 1.0);
+
+  pipeline = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_color (pipeline, &cogl_color);
+
+  /* without shaders the nodes fall back to plain rectangles */
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return pipeline;
+
+  /* the layers only carry the texture coordinates */
+  for (i = 0; i < 3; i++)
+    {
+      cogl_pipeline_set_layer_null_texture (pipeline, i, COGL_TEXTURE_TYPE_2D);
+      cogl_pipeline_set_layer_combine (pipeline, i,
+                                       "RGBA = REPLACE (PREVIOUS)",
+                                       NULL);
+    }
+
+  if (source != NULL)
+    {
+      CoglSnippet *snippet;
+
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_FRAGMENT,
+                                  rounded_rect_glsl_declarations,
+                                  source);
+      cogl_pipeline_add_snippet (pipeline, snippet);
+      cogl_object_unref (snippet);
+    }
+
+  return pipeline;
+}
+
 /*< private >
  * _clutter_paint_node_init_types:
  *
@@ -82,6 +169,13 @@ _clutter_paint_node_init_types (void)
   cogl_pipeline_set_color (default_texture_pipeline, &cogl_color);
   cogl_pipeline_set_layer_wrap_mode (default_texture_pipeline, 0,
                                      COGL_PIPELINE_WRAP_MODE_AUTOMATIC);
+
+  default_rounded_rect_pipeline =
+    create_rounded_rect_pipeline (ctx, rounded_rect_glsl_source);
+  default_border_pipeline =
+    create_rounded_rect_pipeline (ctx, border_glsl_source);
+  default_shadow_pipeline =
+    create_rounded_rect_pipeline (ctx, shadow_glsl_source);
 }
 
 /*
@@ -113,9 +207,18 @@ clutter_root_node_pre_draw (ClutterPaintNode *node)
 {
   ClutterRootNode *rnode = (ClutterRootNode *) node;
 
-  cogl_framebuffer_clear (rnode->framebuffer,
-                          rnode->clear_flags,
-                          &rnode->clear_color);
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_OVERDRAW))
+    {
+      CoglColor black;
+
+      /* the overdraw is counted from zero */
+      cogl_color_init_from_4ub (&black, 0, 0, 0, 255);
+      cogl_framebuffer_clear (rnode->framebuffer, rnode->clear_flags, &black);
+    }
+  else
+    cogl_framebuffer_clear (rnode->framebuffer,
+                            rnode->clear_flags,
+                            &rnode->clear_color);
 
   return TRUE;
 }
@@ -143,6 +246,19 @@ clutter_root_node_get_framebuffer (ClutterPaintNode *node)
   return rnode->framebuffer;
 }
 
+static gboolean
+clutter_root_node_record (ClutterPaintNode         *node,
+                          ClutterPaintStreamWriter *writer)
+{
+  ClutterRootNode *rnode = (ClutterRootNode *) node;
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_CLEAR);
+  _clutter_paint_stream_writer_put_uint32 (writer, rnode->clear_flags);
+  _clutter_paint_stream_writer_put_color (writer, &rnode->clear_color);
+
+  return TRUE;
+}
+
 static void
 clutter_root_node_class_init (ClutterRootNodeClass *klass)
 {
@@ -152,6 +268,7 @@ clutter_root_node_class_init (ClutterRootNodeClass *klass)
   node_class->post_draw = clutter_root_node_post_draw;
   node_class->finalize = clutter_root_node_finalize;
   node_class->get_framebuffer = clutter_root_node_get_framebuffer;
+  node_class->record = clutter_root_node_record;
 }
 
 static void
@@ -208,13 +325,14 @@ static gboolean
 clutter_transform_node_pre_draw (ClutterPaintNode *node)
 {
   ClutterTransformNode *tnode = (ClutterTransformNode *) node;
+  CoglFramebuffer *fb = cogl_get_draw_framebuffer ();
   CoglMatrix matrix;
 
-  cogl_push_matrix ();
+  cogl_framebuffer_push_matrix (fb);
 
-  cogl_get_modelview_matrix (&matrix);
+  cogl_framebuffer_get_modelview_matrix (fb, &matrix);
   cogl_matrix_multiply (&matrix, &matrix, &tnode->modelview);
-  cogl_set_modelview_matrix (&matrix);
+  cogl_framebuffer_set_modelview_matrix (fb, &matrix);
 
   return TRUE;
 }
@@ -222,7 +340,19 @@ clutter_transform_node_pre_draw (ClutterPaintNode *node)
 static void
 clutter_transform_node_post_draw (ClutterPaintNode *node)
 {
-  cogl_pop_matrix ();
+  cogl_framebuffer_pop_matrix (cogl_get_draw_framebuffer ());
+}
+
+static gboolean
+clutter_transform_node_record (ClutterPaintNode         *node,
+                               ClutterPaintStreamWriter *writer)
+{
+  ClutterTransformNode *tnode = (ClutterTransformNode *) node;
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_TRANSFORM);
+  _clutter_paint_stream_writer_put_matrix (writer, &tnode->modelview);
+
+  return TRUE;
 }
 
 static void
@@ -233,6 +363,7 @@ clutter_transform_node_class_init (ClutterTransformNodeClass *klass)
   node_class = CLUTTER_PAINT_NODE_CLASS (klass);
   node_class->pre_draw = clutter_transform_node_pre_draw;
   node_class->post_draw = clutter_transform_node_post_draw;
+  node_class->record = clutter_transform_node_record;
 }
 
 static void
@@ -344,6 +475,154 @@ _clutter_dummy_node_new (ClutterActor *actor)
   return res;
 }
 
+/*
+ * Depth pass, private
+ *
+ * while a stage paints with clutter_stage_set_depth_sorted_paint(), every
+ * actor gets a slice of the depth range in paint order, the later ones
+ * being nearer; the opaque backgrounds are drawn front-to-back into the
+ * depth buffer first, and the pipeline nodes drawing on the stage then
+ * test against it, so that the hidden fragments are rejected before
+ * being shaded while the result stays the same as the painter's order
+ */
+
+static CoglFramebuffer *depth_framebuffer = NULL;
+static CoglPipeline *depth_prepass_pipeline = NULL;
+static CoglMatrix depth_projection;
+static guint depth_n_slices = 0;
+static guint depth_slice = 0;
+static guint depth_applied_slice = 0;
+static gboolean depth_slice_applied = FALSE;
+
+/*< private >
+ * _clutter_paint_node_begin_depth_pass:
+ * @framebuffer: the framebuffer of the stage
+ * @n_slices: the number of depth slices assigned to the actors
+ *
+ * Starts testing the pipeline nodes drawing on @framebuffer against
+ * its depth buffer, which must have been cleared.
+ */
+void
+_clutter_paint_node_begin_depth_pass (CoglFramebuffer *framebuffer,
+                                      guint            n_slices)
+{
+  g_return_if_fail (depth_framebuffer == NULL);
+
+  depth_framebuffer = framebuffer;
+  depth_n_slices = MAX (n_slices, 1);
+  depth_slice = 0;
+  depth_slice_applied = FALSE;
+
+  cogl_framebuffer_get_projection_matrix (framebuffer, &depth_projection);
+}
+
+/*< private >
+ * _clutter_paint_node_end_depth_pass:
+ *
+ * Stops the depth pass started by _clutter_paint_node_begin_depth_pass(),
+ * and restores the projection of the framebuffer.
+ */
+void
+_clutter_paint_node_end_depth_pass (void)
+{
+  if (depth_framebuffer == NULL)
+    return;
+
+  if (depth_slice_applied)
+    cogl_framebuffer_set_projection_matrix (depth_framebuffer, &depth_projection);
+
+  depth_framebuffer = NULL;
+  depth_slice_applied = FALSE;
+}
+
+/*< private >
+ * _clutter_paint_node_set_depth_slice:
+ * @slice: the depth slice of the actor being painted
+ *
+ * Sets the depth slice used by the following pipeline nodes.
+ *
+ * Return value: the previous depth slice, to be restored once the
+ *   actor has been painted
+ */
+guint
+_clutter_paint_node_set_depth_slice (guint slice)
+{
+  guint old_slice = depth_slice;
+
+  depth_slice = slice;
+
+  return old_slice;
+}
+
+/* maps the depth of the projection into the slice, which only changes
+ * the depth of the vertices; the later slices are nearer. This flushes
+ * the batched primitives, so it is only done when the slice drawing
+ * something changes
+ */
+static void
+clutter_paint_node_apply_depth_slice (void)
+{
+  CoglMatrix slice_matrix, projection;
+  float near_z, far_z;
+
+  if (depth_slice_applied && depth_applied_slice == depth_slice)
+    return;
+
+  far_z = 1.f - 2.f * depth_slice / depth_n_slices;
+  near_z = 1.f - 2.f * (depth_slice + 1) / depth_n_slices;
+
+  cogl_matrix_init_identity (&slice_matrix);
+  slice_matrix.zz = (far_z - near_z) / 2.f;
+  slice_matrix.zw = (far_z + near_z) / 2.f;
+
+  cogl_matrix_multiply (&projection, &slice_matrix, &depth_projection);
+  cogl_framebuffer_set_projection_matrix (depth_framebuffer, &projection);
+
+  depth_applied_slice = depth_slice;
+  depth_slice_applied = TRUE;
+}
+
+/*< private >
+ * _clutter_paint_node_draw_depth_prepass:
+ * @slice: the depth slice of the actor
+ * @modelview: the modelview matrix of the actor
+ * @box: the opaque area of the actor, in actor coordinates
+ *
+ * Writes the depth of the opaque area of an actor, without
+ * touching the colors of the framebuffer.
+ */
+void
+_clutter_paint_node_draw_depth_prepass (guint                  slice,
+                                        const CoglMatrix      *modelview,
+                                        const ClutterActorBox *box)
+{
+  g_return_if_fail (depth_framebuffer != NULL);
+
+  if (G_UNLIKELY (depth_prepass_pipeline == NULL))
+    {
+      CoglDepthState depth_state;
+
+      depth_prepass_pipeline = cogl_pipeline_copy (default_color_pipeline);
+      cogl_pipeline_set_color_mask (depth_prepass_pipeline, COGL_COLOR_MASK_NONE);
+
+      cogl_depth_state_init (&depth_state);
+      cogl_depth_state_set_test_enabled (&depth_state, TRUE);
+      cogl_depth_state_set_write_enabled (&depth_state, TRUE);
+      cogl_pipeline_set_depth_state (depth_prepass_pipeline, &depth_state, NULL);
+    }
+
+  depth_slice = slice;
+  clutter_paint_node_apply_depth_slice ();
+
+  cogl_framebuffer_push_matrix (depth_framebuffer);
+  cogl_framebuffer_set_modelview_matrix (depth_framebuffer, modelview);
+  cogl_framebuffer_draw_rectangle (depth_framebuffer,
+                                   depth_prepass_pipeline,
+                                   box->x1, box->y1,
+                                   box->x2, box->y2);
+  cogl_framebuffer_pop_matrix (depth_framebuffer);
+}
+
 /*
  * Pipeline node
  */
@@ -353,6 +632,11 @@ struct _ClutterPipelineNode
   ClutterPaintNode parent_instance;
 
   CoglPipeline *pipeline;
+
+  /* a copy of the pipeline testing against the depth buffer, used
+   * during the depth pass of the stage
+   */
+  CoglPipeline *depth_pipeline;
 };
 
 /**
@@ -378,9 +662,55 @@ clutter_pipeline_node_finalize (ClutterPaintNode *node)
   if (pnode->pipeline != NULL)
     cogl_object_unref (pnode->pipeline);
 
+  if (pnode->depth_pipeline != NULL)
+    cogl_object_unref (pnode->depth_pipeline);
+
   CLUTTER_PAINT_NODE_CLASS (clutter_pipeline_node_parent_class)->finalize (node);
 }
 
+static CoglPipeline *
+clutter_pipeline_node_get_depth_pipeline (ClutterPipelineNode *pnode)
+{
+  if (pnode->depth_pipeline == NULL)
+    {
+      CoglDepthState depth_state;
+
+      /* the opaque areas drawn by the depth pre-pass are drawn again
+       * with the same depth, so the test has to let them through
+       */
+      cogl_depth_state_init (&depth_state);
+      cogl_depth_state_set_test_enabled (&depth_state, TRUE);
+      cogl_depth_state_set_test_function (&depth_state, COGL_DEPTH_TEST_FUNCTION_LEQUAL);
+      cogl_depth_state_set_write_enabled (&depth_state, FALSE);
+
+      pnode->depth_pipeline = cogl_pipeline_copy (pnode->pipeline);
+      cogl_pipeline_set_depth_state (pnode->depth_pipeline, &depth_state, NULL);
+    }
+
+  clutter_paint_node_apply_depth_slice ();
+
+  return pnode->depth_pipeline;
+}
+
+/* the pipeline to draw the operations of @pnode with; the paint debug
+ * modes replace it, or keep track of it, and the depth pass of the
+ * stage tests it against the depth buffer
+ */
+static inline CoglPipeline *
+clutter_pipeline_node_get_draw_pipeline (ClutterPipelineNode *pnode)
+{
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_OVERDRAW))
+    return _clutter_paint_debug_get_overdraw_pipeline ();
+
+  /* the offscreen effects redirect the drawing of their actors */
+  if (depth_framebuffer != NULL &&
+      clutter_paint_node_get_framebuffer (CLUTTER_PAINT_NODE (pnode)) == depth_framebuffer &&
+      cogl_get_draw_framebuffer () == depth_framebuffer)
+    return clutter_pipeline_node_get_depth_pipeline (pnode);
+
+  return pnode->pipeline;
+}
+
 static gboolean
 clutter_pipeline_node_pre_draw (ClutterPaintNode *node)
 {
@@ -389,17 +719,25 @@ clutter_pipeline_node_pre_draw (ClutterPaintNode *node)
   if (node->operations != NULL &&
       pnode->pipeline != NULL)
     {
-      cogl_push_source (pnode->pipeline);
+      if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_BATCH_BREAKS))
+        _clutter_paint_debug_note_pipeline (pnode->pipeline);
+
+      cogl_push_source (clutter_pipeline_node_get_draw_pipeline (pnode));
       return TRUE;
     }
 
   return FALSE;
 }
 
+/* the maximum number of consecutive rectangles submitted at once */
+#define MAX_BATCHED_RECTANGLES  16
+
 static void
 clutter_pipeline_node_draw (ClutterPaintNode *node)
 {
   ClutterPipelineNode *pnode = CLUTTER_PIPELINE_NODE (node);
+  float coords[MAX_BATCHED_RECTANGLES * 8];
+  guint n_rectangles = 0;
   CoglFramebuffer *fb;
   guint i;
 
@@ -417,20 +755,34 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
 
       op = &g_array_index (node->operations, ClutterPaintOperation, i);
 
+      /* consecutive rectangles are batched into a single submission;
+       * any other operation flushes the batch, to preserve the order
+       * of the operations
+       */
+      if (op->opcode == PAINT_OP_TEX_RECT)
+        {
+          memcpy (coords + n_rectangles * 8, op->op.texrect, sizeof (float) * 8);
+          n_rectangles += 1;
+
+          if (n_rectangles == MAX_BATCHED_RECTANGLES)
+            {
+              cogl_rectangles_with_texture_coords (coords, n_rectangles);
+              n_rectangles = 0;
+            }
+
+          continue;
+        }
+
+      if (n_rectangles > 0)
+        {
+          cogl_rectangles_with_texture_coords (coords, n_rectangles);
+          n_rectangles = 0;
+        }
+
       switch (op->opcode)
         {
         case PAINT_OP_INVALID:
-          break;
-
         case PAINT_OP_TEX_RECT:
-          cogl_rectangle_with_texture_coords (op->op.texrect[0],
-                                              op->op.texrect[1],
-                                              op->op.texrect[2],
-                                              op->op.texrect[3],
-                                              op->op.texrect[4],
-                                              op->op.texrect[5],
-                                              op->op.texrect[6],
-                                              op->op.texrect[7]);
           break;
 
         case PAINT_OP_PATH:
@@ -439,11 +791,14 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
 
         case PAINT_OP_PRIMITIVE:
           cogl_framebuffer_draw_primitive (fb,
-                                           pnode->pipeline,
+                                           clutter_pipeline_node_get_draw_pipeline (pnode),
                                            op->op.primitive);
           break;
         }
     }
+
+  if (n_rectangles > 0)
+    cogl_rectangles_with_texture_coords (coords, n_rectangles);
 }
 
 static void
@@ -492,6 +847,44 @@ clutter_pipeline_node_serialize (ClutterPaintNode *node)
   return res;
 }
 
+/* the pipelines are recorded as their color and the texture of their
+ * first layer, if any; the other layers and the snippets are lost
+ */
+static gboolean
+clutter_pipeline_node_record (ClutterPaintNode         *node,
+                              ClutterPaintStreamWriter *writer)
+{
+  ClutterPipelineNode *pnode = CLUTTER_PIPELINE_NODE (node);
+  CoglTexture *texture = NULL;
+  CoglColor color;
+
+  if (pnode->pipeline == NULL)
+    return FALSE;
+
+  if (cogl_pipeline_get_n_layers (pnode->pipeline) > 0)
+    texture = cogl_pipeline_get_layer_texture (pnode->pipeline, 0);
+
+  cogl_pipeline_get_color (pnode->pipeline, &color);
+
+  if (texture != NULL)
+    {
+      _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_TEXTURE);
+      _clutter_paint_stream_writer_put_texture (writer, texture);
+      _clutter_paint_stream_writer_put_color (writer, &color);
+      _clutter_paint_stream_writer_put_uint32 (writer,
+                                               cogl_pipeline_get_layer_min_filter (pnode->pipeline, 0));
+      _clutter_paint_stream_writer_put_uint32 (writer,
+                                               cogl_pipeline_get_layer_mag_filter (pnode->pipeline, 0));
+    }
+  else
+    {
+      _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_COLOR);
+      _clutter_paint_stream_writer_put_color (writer, &color);
+    }
+
+  return TRUE;
+}
+
 static void
 clutter_pipeline_node_class_init (ClutterPipelineNodeClass *klass)
 {
@@ -503,6 +896,7 @@ clutter_pipeline_node_class_init (ClutterPipelineNodeClass *klass)
   node_class->post_draw = clutter_pipeline_node_post_draw;
   node_class->finalize = clutter_pipeline_node_finalize;
   node_class->serialize = clutter_pipeline_node_serialize;
+  node_class->record = clutter_pipeline_node_record;
 }
 
 static void
@@ -540,6 +934,33 @@ clutter_pipeline_node_new (CoglPipeline *pipeline)
   return (ClutterPaintNode *) res;
 }
 
+/*< private >
+ * _clutter_pipeline_node_get_pipeline:
+ * @node: a #ClutterPipelineNode, or one of its sub-classes
+ *
+ * Retrieves the pipeline used by @node to paint its contents.
+ *
+ * Return value: (transfer none): a #CoglPipeline, or %NULL
+ */
+CoglPipeline *
+_clutter_pipeline_node_get_pipeline (ClutterPaintNode *node)
+{
+  ClutterPipelineNode *pnode;
+
+  g_return_val_if_fail (CLUTTER_IS_PIPELINE_NODE (node), NULL);
+
+  pnode = CLUTTER_PIPELINE_NODE (node);
+
+  /* the caller can change the pipeline */
+  if (pnode->depth_pipeline != NULL)
+    {
+      cogl_object_unref (pnode->depth_pipeline);
+      pnode->depth_pipeline = NULL;
+    }
+
+  return pnode->pipeline;
+}
+
 /*
  * Color node
  */
@@ -729,6 +1150,427 @@ clutter_texture_node_new (CoglTexture          *texture,
   return (ClutterPaintNode *) tnode;
 }
 
+/*
+ * Rounded rectangle nodes
+ */
+
+/* draws the rectangles of @node using the rounded rectangle pipelines,
+ * growing each rectangle by @padding on every side; @param is the width
+ * of the border, for the border nodes, or the blur of the shadow
+ */
+static void
+draw_rounded_rectangles (ClutterPaintNode *node,
+                         gfloat            radius,
+                         gfloat            param,
+                         gfloat            padding,
+                         gboolean          is_border)
+{
+  ClutterPipelineNode *pnode = CLUTTER_PIPELINE_NODE (node);
+  CoglPipeline *pipeline;
+  CoglFramebuffer *fb;
+  gboolean use_glsl;
+  guint i;
+
+  if (pnode->pipeline == NULL || node->operations == NULL)
+    return;
+
+  fb = clutter_paint_node_get_framebuffer (node);
+  pipeline = clutter_pipeline_node_get_draw_pipeline (pnode);
+
+  /* the overdraw pipeline has no shader, and fills the whole rectangles */
+  use_glsl = clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL) &&
+             (clutter_paint_debug_flags & CLUTTER_DEBUG_OVERDRAW) == 0;
+
+  for (i = 0; i < node->operations->len; i++)
+    {
+      const ClutterPaintOperation *op;
+      gfloat x1, y1, x2, y2;
+      gfloat half_width, half_height;
+      float coords[12];
+
+      op = &g_array_index (node->operations, ClutterPaintOperation, i);
+
+      if (op->opcode != PAINT_OP_TEX_RECT)
+        continue;
+
+      x1 = MIN (op->op.texrect[0], op->op.texrect[2]);
+      y1 = MIN (op->op.texrect[1], op->op.texrect[3]);
+      x2 = MAX (op->op.texrect[0], op->op.texrect[2]);
+      y2 = MAX (op->op.texrect[1], op->op.texrect[3]);
+
+      /* without shaders the corners are left square */
+      if (!use_glsl && is_border)
+        {
+          gfloat width = MIN (param, MIN (x2 - x1, y2 - y1) / 2.0f);
+
+          cogl_framebuffer_draw_rectangle (fb, pipeline,
+                                           x1, y1, x2, y1 + width);
+          cogl_framebuffer_draw_rectangle (fb, pipeline,
+                                           x1, y2 - width, x2, y2);
+          cogl_framebuffer_draw_rectangle (fb, pipeline,
+                                           x1, y1 + width, x1 + width, y2 - width);
+          cogl_framebuffer_draw_rectangle (fb, pipeline,
+                                           x2 - width, y1 + width, x2, y2 - width);
+          continue;
+        }
+      else if (!use_glsl)
+        {
+          cogl_framebuffer_draw_rectangle (fb, pipeline, x1, y1, x2, y2);
+          continue;
+        }
+
+      half_width = (x2 - x1) / 2.0f;
+      half_height = (y2 - y1) / 2.0f;
+
+      /* the position, relative to the center of the rectangle */
+      coords[0] = -half_width - padding;
+      coords[1] = -half_height - padding;
+      coords[2] = half_width + padding;
+      coords[3] = half_height + padding;
+
+      /* the half size, constant across the rectangle */
+      coords[4] = coords[6] = half_width;
+      coords[5] = coords[7] = half_height;
+
+      /* the radius, and the border width or the shadow blur */
+      coords[8] = coords[10] = CLAMP (radius, 0.0f, MIN (half_width, half_height));
+      coords[9] = coords[11] = param;
+
+      cogl_framebuffer_draw_multitextured_rectangle (fb, pipeline,
+                                                     x1 - padding,
+                                                     y1 - padding,
+                                                     x2 + padding,
+                                                     y2 + padding,
+                                                     coords, 12);
+    }
+}
+
+static void
+set_premultiplied_color (CoglPipeline       *pipeline,
+                         const ClutterColor *color)
+{
+  CoglColor cogl_color;
+
+  if (color == NULL)
+    return;
+
+  cogl_color_init_from_4ub (&cogl_color,
+                            color->red,
+                            color->green,
+                            color->blue,
+                            color->alpha);
+  cogl_color_premultiply (&cogl_color);
+
+  cogl_pipeline_set_color (pipeline, &cogl_color);
+}
+
+/*
+ * Rounded rectangle node
+ */
+
+struct _ClutterRoundedRectNode
+{
+  ClutterPipelineNode parent_instance;
+
+  gfloat radius;
+};
+
+/**
+ * ClutterRoundedRectNodeClass:
+ *
+ * The `ClutterRoundedRectNodeClass` structure is an
+ * opaque type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+struct _ClutterRoundedRectNodeClass
+{
+  ClutterPipelineNodeClass parent_class;
+};
+
+G_DEFINE_TYPE (ClutterRoundedRectNode, clutter_rounded_rect_node, CLUTTER_TYPE_PIPELINE_NODE)
+
+static void
+clutter_rounded_rect_node_draw (ClutterPaintNode *node)
+{
+  ClutterRoundedRectNode *rnode = CLUTTER_ROUNDED_RECT_NODE (node);
+
+  draw_rounded_rectangles (node, rnode->radius, 0.0f, 0.0f, FALSE);
+}
+
+static gboolean
+clutter_rounded_rect_node_record (ClutterPaintNode         *node,
+                                  ClutterPaintStreamWriter *writer)
+{
+  ClutterRoundedRectNode *rnode = CLUTTER_ROUNDED_RECT_NODE (node);
+  CoglColor color;
+
+  cogl_pipeline_get_color (CLUTTER_PIPELINE_NODE (node)->pipeline, &color);
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_ROUNDED_RECT);
+  _clutter_paint_stream_writer_put_color (writer, &color);
+  _clutter_paint_stream_writer_put_float (writer, rnode->radius);
+
+  return TRUE;
+}
+
+static void
+clutter_rounded_rect_node_class_init (ClutterRoundedRectNodeClass *klass)
+{
+  CLUTTER_PAINT_NODE_CLASS (klass)->draw = clutter_rounded_rect_node_draw;
+  CLUTTER_PAINT_NODE_CLASS (klass)->record = clutter_rounded_rect_node_record;
+}
+
+static void
+clutter_rounded_rect_node_init (ClutterRoundedRectNode *self)
+{
+  ClutterPipelineNode *pnode = CLUTTER_PIPELINE_NODE (self);
+
+  g_assert (default_rounded_rect_pipeline != NULL);
+  pnode->pipeline = cogl_pipeline_copy (default_rounded_rect_pipeline);
+}
+
+/**
+ * clutter_rounded_rect_node_new:
+ * @color: (allow-none): the color to paint, or %NULL
+ * @radius: the radius of the corners
+ *
+ * Creates a new #ClutterPaintNode that will fill the rectangles added
+ * to it using @color, with corners rounded by @radius.
+ *
+ * The corners are computed in a fragment shader when painting, so
+ * changing the size of the rectangles does not require drawing an
+ * image again; the rectangles of the rounded rectangle nodes are
+ * batched together like the rectangles of the color nodes.
+ *
+ * Return value: (transfer full): the newly created #ClutterPaintNode. Use
+ *   clutter_paint_node_unref() when done
+ *
+ * Since: 1.26
+ */
+ClutterPaintNode *
+clutter_rounded_rect_node_new (const ClutterColor *color,
+                               gfloat              radius)
+{
+  ClutterRoundedRectNode *rnode;
+
+  rnode = _clutter_paint_node_create (CLUTTER_TYPE_ROUNDED_RECT_NODE);
+  rnode->radius = MAX (radius, 0.0f);
+
+  set_premultiplied_color (CLUTTER_PIPELINE_NODE (rnode)->pipeline, color);
+
+  return (ClutterPaintNode *) rnode;
+}
+
+/*
+ * Border node
+ */
+
+struct _ClutterBorderNode
+{
+  ClutterPipelineNode parent_instance;
+
+  gfloat radius;
+  gfloat width;
+};
+
+/**
+ * ClutterBorderNodeClass:
+ *
+ * The `ClutterBorderNodeClass` structure is an
+ * opaque type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+struct _ClutterBorderNodeClass
+{
+  ClutterPipelineNodeClass parent_class;
+};
+
+G_DEFINE_TYPE (ClutterBorderNode, clutter_border_node, CLUTTER_TYPE_PIPELINE_NODE)
+
+static void
+clutter_border_node_draw (ClutterPaintNode *node)
+{
+  ClutterBorderNode *bnode = CLUTTER_BORDER_NODE (node);
+
+  draw_rounded_rectangles (node, bnode->radius, bnode->width, 0.0f, TRUE);
+}
+
+static gboolean
+clutter_border_node_record (ClutterPaintNode         *node,
+                            ClutterPaintStreamWriter *writer)
+{
+  ClutterBorderNode *bnode = CLUTTER_BORDER_NODE (node);
+  CoglColor color;
+
+  cogl_pipeline_get_color (CLUTTER_PIPELINE_NODE (node)->pipeline, &color);
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_BORDER);
+  _clutter_paint_stream_writer_put_color (writer, &color);
+  _clutter_paint_stream_writer_put_float (writer, bnode->radius);
+  _clutter_paint_stream_writer_put_float (writer, bnode->width);
+
+  return TRUE;
+}
+
+static void
+clutter_border_node_class_init (ClutterBorderNodeClass *klass)
+{
+  CLUTTER_PAINT_NODE_CLASS (klass)->draw = clutter_border_node_draw;
+  CLUTTER_PAINT_NODE_CLASS (klass)->record = clutter_border_node_record;
+}
+
+static void
+clutter_border_node_init (ClutterBorderNode *self)
+{
+  ClutterPipelineNode *pnode = CLUTTER_PIPELINE_NODE (self);
+
+  g_assert (default_border_pipeline != NULL);
+  pnode->pipeline = cogl_pipeline_copy (default_border_pipeline);
+}
+
+/**
+ * clutter_border_node_new:
+ * @color: (allow-none): the color of the border, or %NULL
+ * @radius: the radius of the outer corners
+ * @width: the width of the border
+ *
+ * Creates a new #ClutterPaintNode that will paint a border of the
+ * given @width inside the rectangles added to it, with the outer
+ * corners rounded by @radius.
+ *
+ * The inner corners are rounded by @radius minus @width, if the
+ * difference is positive.
+ *
+ * Return value: (transfer full): the newly created #ClutterPaintNode. Use
+ *   clutter_paint_node_unref() when done
+ *
+ * Since: 1.26
+ */
+ClutterPaintNode *
+clutter_border_node_new (const ClutterColor *color,
+                         gfloat              radius,
+                         gfloat              width)
+{
+  ClutterBorderNode *bnode;
+
+  bnode = _clutter_paint_node_create (CLUTTER_TYPE_BORDER_NODE);
+  bnode->radius = MAX (radius, 0.0f);
+  bnode->width = MAX (width, 0.0f);
+
+  set_premultiplied_color (CLUTTER_PIPELINE_NODE (bnode)->pipeline, color);
+
+  return (ClutterPaintNode *) bnode;
+}
+
+/*
+ * Box shadow node
+ */
+
+struct _ClutterBoxShadowNode
+{
+  ClutterPipelineNode parent_instance;
+
+  gfloat radius;
+  gfloat blur;
+};
+
+/**
+ * ClutterBoxShadowNodeClass:
+ *
+ * The `ClutterBoxShadowNodeClass` structure is an
+ * opaque type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+struct _ClutterBoxShadowNodeClass
+{
+  ClutterPipelineNodeClass parent_class;
+};
+
+G_DEFINE_TYPE (ClutterBoxShadowNode, clutter_box_shadow_node, CLUTTER_TYPE_PIPELINE_NODE)
+
+static void
+clutter_box_shadow_node_draw (ClutterPaintNode *node)
+{
+  ClutterBoxShadowNode *snode = CLUTTER_BOX_SHADOW_NODE (node);
+
+  /* the shadow fades out over the blur, on each side of the edge */
+  draw_rounded_rectangles (node, snode->radius, snode->blur, snode->blur, FALSE);
+}
+
+static gboolean
+clutter_box_shadow_node_record (ClutterPaintNode         *node,
+                                ClutterPaintStreamWriter *writer)
+{
+  ClutterBoxShadowNode *snode = CLUTTER_BOX_SHADOW_NODE (node);
+  CoglColor color;
+
+  cogl_pipeline_get_color (CLUTTER_PIPELINE_NODE (node)->pipeline, &color);
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_BOX_SHADOW);
+  _clutter_paint_stream_writer_put_color (writer, &color);
+  _clutter_paint_stream_writer_put_float (writer, snode->radius);
+  _clutter_paint_stream_writer_put_float (writer, snode->blur);
+
+  return TRUE;
+}
+
+static void
+clutter_box_shadow_node_class_init (ClutterBoxShadowNodeClass *klass)
+{
+  CLUTTER_PAINT_NODE_CLASS (klass)->draw = clutter_box_shadow_node_draw;
+  CLUTTER_PAINT_NODE_CLASS (klass)->record = clutter_box_shadow_node_record;
+}
+
+static void
+clutter_box_shadow_node_init (ClutterBoxShadowNode *self)
+{
+  ClutterPipelineNode *pnode = CLUTTER_PIPELINE_NODE (self);
+
+  g_assert (default_shadow_pipeline != NULL);
+  pnode->pipeline = cogl_pipeline_copy (default_shadow_pipeline);
+}
+
+/**
+ * clutter_box_shadow_node_new:
+ * @color: (allow-none): the color of the shadow, or %NULL
+ * @radius: the radius of the corners of the shadow
+ * @blur: the blur radius of the shadow
+ *
+ * Creates a new #ClutterPaintNode that will paint the shadow of the
+ * rectangles added to it; the shadow fades out over @blur pixels on
+ * each side of the edges of the rectangles, so it extends @blur pixels
+ * outside of them.
+ *
+ * The shadow is computed in a fragment shader, using an approximation
+ * of a blurred rounded rectangle. The actor painting the shadow should
+ * include the area outside of the rectangles in its paint volume.
+ *
+ * Return value: (transfer full): the newly created #ClutterPaintNode. Use
+ *   clutter_paint_node_unref() when done
+ *
+ * Since: 1.26
+ */
+ClutterPaintNode *
+clutter_box_shadow_node_new (const ClutterColor *color,
+                             gfloat              radius,
+                             gfloat              blur)
+{
+  ClutterBoxShadowNode *snode;
+
+  snode = _clutter_paint_node_create (CLUTTER_TYPE_BOX_SHADOW_NODE);
+  snode->radius = MAX (radius, 0.0f);
+
+  /* a shadow without blur still gets an anti-aliased edge */
+  snode->blur = MAX (blur, 0.5f);
+
+  set_premultiplied_color (CLUTTER_PIPELINE_NODE (snode)->pipeline, color);
+
+  return (ClutterPaintNode *) snode;
+}
+
 /*
  * Text node
  */
@@ -811,11 +1653,11 @@ clutter_text_node_draw (ClutterPaintNode *node)
           if (extents.width > op_width ||
               extents.height > op_height)
             {
-              cogl_framebuffer_push_rectangle_clip (fb,
-                                                    op->op.texrect[0],
-                                                    op->op.texrect[1],
-                                                    op->op.texrect[2],
-                                                    op->op.texrect[3]);
+              _clutter_util_push_rectangle_clip (fb,
+                                                 op->op.texrect[0],
+                                                 op->op.texrect[1],
+                                                 op->op.texrect[2],
+                                                 op->op.texrect[3]);
               clipped = TRUE;
             }
 
@@ -878,6 +1720,22 @@ clutter_text_node_serialize (ClutterPaintNode *node)
   return res;
 }
 
+static gboolean
+clutter_text_node_record (ClutterPaintNode         *node,
+                          ClutterPaintStreamWriter *writer)
+{
+  ClutterTextNode *tnode = CLUTTER_TEXT_NODE (node);
+
+  if (tnode->layout == NULL)
+    return FALSE;
+
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_TEXT);
+  _clutter_paint_stream_writer_put_layout (writer, tnode->layout);
+  _clutter_paint_stream_writer_put_color (writer, &tnode->color);
+
+  return TRUE;
+}
+
 static void
 clutter_text_node_class_init (ClutterTextNodeClass *klass)
 {
@@ -887,6 +1745,7 @@ clutter_text_node_class_init (ClutterTextNodeClass *klass)
   node_class->draw = clutter_text_node_draw;
   node_class->finalize = clutter_text_node_finalize;
   node_class->serialize = clutter_text_node_serialize;
+  node_class->record = clutter_text_node_record;
 }
 
 static void
@@ -981,11 +1840,11 @@ clutter_clip_node_pre_draw (ClutterPaintNode *node)
       switch (op->opcode)
         {
         case PAINT_OP_TEX_RECT:
-          cogl_framebuffer_push_rectangle_clip (fb,
-                                                op->op.texrect[0],
-                                                op->op.texrect[1],
-                                                op->op.texrect[2],
-                                                op->op.texrect[3]);
+          _clutter_util_push_rectangle_clip (fb,
+                                             op->op.texrect[0],
+                                             op->op.texrect[1],
+                                             op->op.texrect[2],
+                                             op->op.texrect[3]);
           retval = TRUE;
           break;
 
@@ -1000,6 +1859,9 @@ clutter_clip_node_pre_draw (ClutterPaintNode *node)
         }
     }
 
+  if (retval && G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_BATCH_BREAKS))
+    _clutter_paint_debug_note_batch_break (CLUTTER_BATCH_BREAK_CLIP);
+
   return retval;
 }
 
@@ -1034,6 +1896,15 @@ clutter_clip_node_post_draw (ClutterPaintNode *node)
     }
 }
 
+static gboolean
+clutter_clip_node_record (ClutterPaintNode         *node,
+                          ClutterPaintStreamWriter *writer)
+{
+  _clutter_paint_stream_writer_put_uint8 (writer, PAINT_STREAM_NODE_CLIP);
+
+  return TRUE;
+}
+
 static void
 clutter_clip_node_class_init (ClutterClipNodeClass *klass)
 {
@@ -1042,6 +1913,7 @@ clutter_clip_node_class_init (ClutterClipNodeClass *klass)
   node_class = CLUTTER_PAINT_NODE_CLASS (klass);
   node_class->pre_draw = clutter_clip_node_pre_draw;
   node_class->post_draw = clutter_clip_node_post_draw;
+  node_class->record = clutter_clip_node_record;
 }
 
 static void
@@ -1116,7 +1988,7 @@ clutter_layer_node_pre_draw (ClutterPaintNode *node)
   /* copy the same modelview from the current framebuffer to the one we
    * are going to use
    */
-  cogl_get_modelview_matrix (&matrix);
+  cogl_framebuffer_get_modelview_matrix (cogl_get_draw_framebuffer (), &matrix);
 
   cogl_push_framebuffer (lnode->offscreen);
 
@@ -1136,7 +2008,10 @@ clutter_layer_node_pre_draw (ClutterPaintNode *node)
                             COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH,
                             0.f, 0.f, 0.f, 0.f);
 
-  cogl_push_matrix ();
+  cogl_framebuffer_push_matrix (lnode->offscreen);
+
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_BATCH_BREAKS))
+    _clutter_paint_debug_note_batch_break (CLUTTER_BATCH_BREAK_OFFSCREEN);
 
   /* every draw operation after this point will happen an offscreen
    * framebuffer
@@ -1153,7 +2028,7 @@ clutter_layer_node_post_draw (ClutterPaintNode *node)
   guint i;
 
   /* switch to the previous framebuffer */
-  cogl_pop_matrix ();
+  cogl_framebuffer_pop_matrix (lnode->offscreen);
   cogl_pop_framebuffer ();
 
   fb = cogl_get_draw_framebuffer ();
@@ -1297,3 +2172,148 @@ _clutter_layer_node_new (const CoglMatrix        *projection,
 out:
   return (ClutterPaintNode *) res;
 }
+
+/*< private >
+ * _clutter_paint_node_decode:
+ * @reader: the reader of a block of a #ClutterPaintPlayer
+ * @tag: the #PaintStreamNodeTag of the node
+ *
+ * Creates the node written by the record implementation of the
+ * class matching @tag.
+ *
+ * Return value: (transfer full): the new node, or %NULL if @tag
+ *   is not valid
+ */
+ClutterPaintNode *
+_clutter_paint_node_decode (ClutterPaintStreamReader *reader,
+                            guint8                    tag)
+{
+  ClutterPaintNode *res = NULL;
+  CoglColor color;
+
+  switch (tag)
+    {
+    case PAINT_STREAM_NODE_CLEAR:
+      {
+        ClutterRootNode *rnode;
+
+        rnode = _clutter_paint_node_create (_clutter_root_node_get_type ());
+        rnode->framebuffer =
+          cogl_object_ref (_clutter_paint_stream_reader_get_framebuffer (reader));
+        rnode->clear_flags = _clutter_paint_stream_reader_get_uint32 (reader);
+        _clutter_paint_stream_reader_get_color (reader, &rnode->clear_color);
+
+        res = (ClutterPaintNode *) rnode;
+      }
+      break;
+
+    case PAINT_STREAM_NODE_TRANSFORM:
+      {
+        CoglMatrix modelview;
+
+        _clutter_paint_stream_reader_get_matrix (reader, &modelview);
+        res = _clutter_transform_node_new (&modelview);
+      }
+      break;
+
+    case PAINT_STREAM_NODE_CLIP:
+      res = clutter_clip_node_new ();
+      break;
+
+    case PAINT_STREAM_NODE_COLOR:
+      res = clutter_color_node_new (NULL);
+      _clutter_paint_stream_reader_get_color (reader, &color);
+      cogl_pipeline_set_color (CLUTTER_PIPELINE_NODE (res)->pipeline, &color);
+      break;
+
+    case PAINT_STREAM_NODE_TEXTURE:
+      {
+        CoglTexture *texture;
+        CoglPipelineFilter min_filter, mag_filter;
+
+        texture = _clutter_paint_stream_reader_get_texture (reader);
+        _clutter_paint_stream_reader_get_color (reader, &color);
+        min_filter = _clutter_paint_stream_reader_get_uint32 (reader);
+        mag_filter = _clutter_paint_stream_reader_get_uint32 (reader);
+
+        /* a texture that could not be read back is not painted */
+        if (texture == NULL)
+          {
+            res = clutter_pipeline_node_new (NULL);
+            break;
+          }
+
+        res = clutter_texture_node_new (texture, NULL,
+                                        CLUTTER_SCALING_FILTER_LINEAR,
+                                        CLUTTER_SCALING_FILTER_LINEAR);
+        cogl_pipeline_set_layer_filters (CLUTTER_PIPELINE_NODE (res)->pipeline, 0,
+                                         min_filter,
+                                         mag_filter);
+        cogl_pipeline_set_color (CLUTTER_PIPELINE_NODE (res)->pipeline, &color);
+      }
+      break;
+
+    case PAINT_STREAM_NODE_ROUNDED_RECT:
+      {
+        float radius;
+
+        _clutter_paint_stream_reader_get_color (reader, &color);
+        radius = _clutter_paint_stream_reader_get_float (reader);
+
+        res = clutter_rounded_rect_node_new (NULL, radius);
+        cogl_pipeline_set_color (CLUTTER_PIPELINE_NODE (res)->pipeline, &color);
+      }
+      break;
+
+    case PAINT_STREAM_NODE_BORDER:
+      {
+        float radius, width;
+
+        _clutter_paint_stream_reader_get_color (reader, &color);
+        radius = _clutter_paint_stream_reader_get_float (reader);
+        width = _clutter_paint_stream_reader_get_float (reader);
+
+        res = clutter_border_node_new (NULL, radius, width);
+        cogl_pipeline_set_color (CLUTTER_PIPELINE_NODE (res)->pipeline, &color);
+      }
+      break;
+
+    case PAINT_STREAM_NODE_BOX_SHADOW:
+      {
+        float radius, blur;
+
+        _clutter_paint_stream_reader_get_color (reader, &color);
+        radius = _clutter_paint_stream_reader_get_float (reader);
+        blur = _clutter_paint_stream_reader_get_float (reader);
+
+        res = clutter_box_shadow_node_new (NULL, radius, blur);
+        cogl_pipeline_set_color (CLUTTER_PIPELINE_NODE (res)->pipeline, &color);
+      }
+      break;
+
+    case PAINT_STREAM_NODE_TEXT:
+      {
+        ClutterTextNode *tnode;
+
+        tnode = _clutter_paint_node_create (CLUTTER_TYPE_TEXT_NODE);
+        tnode->layout = _clutter_paint_stream_reader_get_layout (reader);
+        if (tnode->layout != NULL)
+          g_object_ref (tnode->layout);
+        _clutter_paint_stream_reader_get_color (reader, &tnode->color);
+
+        res = (ClutterPaintNode *) tnode;
+      }
+      break;
+
+    default:
+      return NULL;
+    }
+
+  if (!_clutter_paint_stream_reader_is_valid (reader))
+    {
+      clutter_paint_node_unref (res);
+      return NULL;
+    }
+
+  return res;
+}
@@ -145,6 +145,74 @@ CLUTTER_AVAILABLE_IN_1_10
 ClutterPaintNode *      clutter_text_node_new           (PangoLayout           *layout,
                                                          const ClutterColor    *color);
 
+#define CLUTTER_TYPE_ROUNDED_RECT_NODE          (clutter_rounded_rect_node_get_type ())
+#define CLUTTER_ROUNDED_RECT_NODE(obj)          (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_ROUNDED_RECT_NODE, ClutterRoundedRectNode))
+#define CLUTTER_IS_ROUNDED_RECT_NODE(obj)       (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_ROUNDED_RECT_NODE))
+
+/**
+ * ClutterRoundedRectNode:
+ *
+ * The #ClutterRoundedRectNode structure is an opaque
+ * type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+typedef struct _ClutterRoundedRectNode          ClutterRoundedRectNode;
+typedef struct _ClutterRoundedRectNodeClass     ClutterRoundedRectNodeClass;
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_rounded_rect_node_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterPaintNode *      clutter_rounded_rect_node_new   (const ClutterColor    *color,
+                                                         gfloat                 radius);
+
+#define CLUTTER_TYPE_BORDER_NODE                (clutter_border_node_get_type ())
+#define CLUTTER_BORDER_NODE(obj)                (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_BORDER_NODE, ClutterBorderNode))
+#define CLUTTER_IS_BORDER_NODE(obj)             (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_BORDER_NODE))
+
+/**
+ * ClutterBorderNode:
+ *
+ * The #ClutterBorderNode structure is an opaque
+ * type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+typedef struct _ClutterBorderNode               ClutterBorderNode;
+typedef struct _ClutterBorderNodeClass          ClutterBorderNodeClass;
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_border_node_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterPaintNode *      clutter_border_node_new         (const ClutterColor    *color,
+                                                         gfloat                 radius,
+                                                         gfloat                 width);
+
+#define CLUTTER_TYPE_BOX_SHADOW_NODE            (clutter_box_shadow_node_get_type ())
+#define CLUTTER_BOX_SHADOW_NODE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_BOX_SHADOW_NODE, ClutterBoxShadowNode))
+#define CLUTTER_IS_BOX_SHADOW_NODE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_BOX_SHADOW_NODE))
+
+/**
+ * ClutterBoxShadowNode:
+ *
+ * The #ClutterBoxShadowNode structure is an opaque
+ * type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+typedef struct _ClutterBoxShadowNode            ClutterBoxShadowNode;
+typedef struct _ClutterBoxShadowNodeClass       ClutterBoxShadowNodeClass;
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_box_shadow_node_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterPaintNode *      clutter_box_shadow_node_new     (const ClutterColor    *color,
+                                                         gfloat                 radius,
+                                                         gfloat                 blur);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_PAINT_NODES_H__ */
@@ -0,0 +1,87 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_PAINT_STREAM_PRIVATE_H__
+#define __CLUTTER_PAINT_STREAM_PRIVATE_H__
+
+#include <pango/pango.h>
+
+#include "clutter-paint-stream.h"
+#include "clutter-paint-node.h"
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterPaintStreamWriter        ClutterPaintStreamWriter;
+typedef struct _ClutterPaintStreamReader        ClutterPaintStreamReader;
+
+/* the tags of the nodes in a block of the stream; every node is
+ * followed by its rectangles and by its children, and the children
+ * are terminated by PAINT_STREAM_NODE_END
+ */
+typedef enum {
+  PAINT_STREAM_NODE_END = 0,
+  PAINT_STREAM_NODE_CLEAR,
+  PAINT_STREAM_NODE_TRANSFORM,
+  PAINT_STREAM_NODE_CLIP,
+  PAINT_STREAM_NODE_COLOR,
+  PAINT_STREAM_NODE_TEXTURE,
+  PAINT_STREAM_NODE_ROUNDED_RECT,
+  PAINT_STREAM_NODE_BORDER,
+  PAINT_STREAM_NODE_BOX_SHADOW,
+  PAINT_STREAM_NODE_TEXT
+} PaintStreamNodeTag;
+
+void                    _clutter_paint_recorder_add_tree                (ClutterPaintNode         *root);
+void                    _clutter_paint_recorder_begin_frame             (ClutterPaintRecorder     *recorder,
+                                                                         CoglFramebuffer          *framebuffer);
+void                    _clutter_paint_recorder_end_frame               (ClutterPaintRecorder     *recorder);
+
+void                    _clutter_paint_stream_writer_put_uint8          (ClutterPaintStreamWriter *writer,
+                                                                         guint8                    value);
+void                    _clutter_paint_stream_writer_put_uint32         (ClutterPaintStreamWriter *writer,
+                                                                         guint32                   value);
+void                    _clutter_paint_stream_writer_put_float          (ClutterPaintStreamWriter *writer,
+                                                                         float                     value);
+void                    _clutter_paint_stream_writer_put_color          (ClutterPaintStreamWriter *writer,
+                                                                         const CoglColor          *color);
+void                    _clutter_paint_stream_writer_put_matrix         (ClutterPaintStreamWriter *writer,
+                                                                         const CoglMatrix         *matrix);
+void                    _clutter_paint_stream_writer_put_texture        (ClutterPaintStreamWriter *writer,
+                                                                         CoglTexture              *texture);
+void                    _clutter_paint_stream_writer_put_layout         (ClutterPaintStreamWriter *writer,
+                                                                         PangoLayout              *layout);
+
+gboolean                _clutter_paint_stream_reader_is_valid           (ClutterPaintStreamReader *reader);
+guint8                  _clutter_paint_stream_reader_get_uint8          (ClutterPaintStreamReader *reader);
+guint32                 _clutter_paint_stream_reader_get_uint32         (ClutterPaintStreamReader *reader);
+float                   _clutter_paint_stream_reader_get_float          (ClutterPaintStreamReader *reader);
+void                    _clutter_paint_stream_reader_get_color          (ClutterPaintStreamReader *reader,
+                                                                         CoglColor                *color);
+void                    _clutter_paint_stream_reader_get_matrix         (ClutterPaintStreamReader *reader,
+                                                                         CoglMatrix               *matrix);
+CoglTexture *           _clutter_paint_stream_reader_get_texture        (ClutterPaintStreamReader *reader);
+PangoLayout *           _clutter_paint_stream_reader_get_layout         (ClutterPaintStreamReader *reader);
+CoglFramebuffer *       _clutter_paint_stream_reader_get_framebuffer    (ClutterPaintStreamReader *reader);
+gsize                   _clutter_paint_stream_reader_get_remaining      (ClutterPaintStreamReader *reader);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_PAINT_STREAM_PRIVATE_H__ */
@@ -0,0 +1,1487 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-paint-stream
+ * @Title: ClutterPaintRecorder
+ * @Short_Description: Streams the paint nodes of a stage
+ *
+ * #ClutterPaintRecorder serializes the trees of #ClutterPaintNode
+ * painted on a #ClutterStage into a compact binary stream, one
+ * #GBytes per frame, emitted by the #ClutterPaintRecorder::frame
+ * signal; #ClutterPaintPlayer rebuilds the trees from the stream and
+ * paints them on a framebuffer, possibly in another process or on
+ * another device:
+ *
+ * |[<!-- language="C" -->
+ *   static void
+ *   on_frame (ClutterPaintRecorder *recorder,
+ *             GBytes               *frame,
+ *             gpointer              data)
+ *   {
+ *     send_to_the_viewer (data, frame);
+ *   }
+ *
+ *   recorder = clutter_paint_recorder_new (stage);
+ *   g_signal_connect (recorder, "frame", G_CALLBACK (on_frame), channel);
+ *
+ *   // in the viewer
+ *   if (!clutter_paint_player_push_frame (player, frame, &error))
+ *     request_a_keyframe (...);
+ *
+ *   clutter_paint_player_paint (player, framebuffer);
+ * ]|
+ *
+ * The stream is much smaller than the pixels of the frames: the
+ * contents of the textures and the text of the layouts are sent once,
+ * and referenced by an identifier until they are released; the trees
+ * of the actors that did not change are replaced by a reference to
+ * the same tree in the previous frame. The glyphs are rasterized by
+ * the player, using the fonts available to it.
+ *
+ * The first frame is a keyframe, which can be decoded without any of
+ * the previous frames; the following frames can only be decoded after
+ * the frame that precedes them. A player joining an existing stream,
+ * or failing to decode a frame, should have the recorder produce a
+ * new keyframe, using clutter_paint_recorder_request_keyframe().
+ *
+ * Only the nodes provided by Clutter are recorded: the paths and the
+ * primitives added to the nodes, the layers of a pipeline other than
+ * the first and its snippets, and the offscreen effects are lost; the
+ * textures are assumed not to change after being painted for the
+ * first time. While a recorder is attached to a stage the clipped
+ * redraws are disabled, so that every frame contains the whole scene.
+ *
+ * #ClutterPaintRecorder and #ClutterPaintPlayer are available since
+ * Clutter 1.26.
+ */
+
+/* The frames are written in little endian order:
+ *
+ *   header: magic "CPS1", serial (u32), flags (u8), viewport (4 f32),
+ *           projection (16 f32)
+ *   resources, up to RES_END (u8):
+ *     RES_RELEASE_TEXTURE (u8), id (u32)
+ *     RES_RELEASE_LAYOUT (u8), id (u32)
+ *     RES_DEFINE_TEXTURE (u8), id (u32), width (u32), height (u32),
+ *                              premultiplied RGBA pixels
+ *     RES_DEFINE_LAYOUT (u8), id (u32), size (u32), layout
+ *   blocks: count (u32), followed by each block:
+ *     BLOCK_COPY (u8), index of the block in the previous frame (u32)
+ *     BLOCK_DATA (u8), size (u32), modelview (16 f32), nodes
+ *
+ * Each block is a tree painted during the frame; the nodes are written
+ * by _clutter_paint_node_record(). The layouts contain their text and
+ * font description, as strings (u32 size, followed by the bytes), and
+ * their settings.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-paint-stream-private.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
+#include "clutter-marshal.h"
+#include "clutter-paint-node-private.h"
+#include "clutter-private.h"
+#include "clutter-stage-private.h"
+
+#define STREAM_MAGIC            "CPS1"
+#define STREAM_MAGIC_LEN        4
+
+/* the number of frames after which an unused layout is released */
+#define RESOURCE_MAX_AGE        300
+
+/* the largest texture accepted by the player */
+#define MAX_TEXTURE_SIZE        8192
+
+enum {
+  FRAME_KEYFRAME = 1 << 0
+};
+
+enum {
+  RES_END = 0,
+  RES_RELEASE_TEXTURE,
+  RES_RELEASE_LAYOUT,
+  RES_DEFINE_TEXTURE,
+  RES_DEFINE_LAYOUT
+};
+
+enum {
+  BLOCK_COPY = 0,
+  BLOCK_DATA
+};
+
+struct _ClutterPaintStreamWriter
+{
+  ClutterPaintRecorder *recorder;
+
+  GByteArray *data;
+};
+
+struct _ClutterPaintStreamReader
+{
+  ClutterPaintPlayer *player;
+  CoglFramebuffer *framebuffer;
+
+  const guint8 *data;
+  gsize size;
+  gsize offset;
+
+  gboolean valid;
+};
+
+typedef struct {
+  ClutterPaintRecorder *recorder;
+  guint32 id;
+} TextureEntry;
+
+typedef struct {
+  guint32 id;
+  guint32 last_used;
+} LayoutEntry;
+
+struct _ClutterPaintRecorder
+{
+  GObject parent_instance;
+
+  ClutterStage *stage;
+
+  guint32 serial;
+  guint needs_keyframe : 1;
+
+  /* the framebuffer of the frame being recorded */
+  CoglFramebuffer *framebuffer;
+
+  /* the recorded textures are tagged with a TextureEntry using this
+   * key; the entries are owned by the textures
+   */
+  CoglUserDataKey texture_key;
+  GHashTable *textures;
+  guint32 next_texture_id;
+  GArray *released_textures;
+
+  /* the layouts, by their serialized form */
+  GHashTable *layouts;
+  guint32 next_layout_id;
+
+  /* the resources defined during the current frame */
+  GByteArray *resources;
+
+  /* the blocks of the current frame, and the indices of the blocks
+   * of the previous one
+   */
+  GPtrArray *blocks;
+  GHashTable *previous_blocks;
+};
+
+struct _ClutterPaintRecorderClass
+{
+  GObjectClass parent_class;
+};
+
+typedef struct {
+  GBytes *data;
+
+  /* the tree decoded for framebuffer, built on demand */
+  ClutterPaintNode *tree;
+  CoglFramebuffer *framebuffer;
+} PlayerBlock;
+
+struct _ClutterPaintPlayer
+{
+  GObject parent_instance;
+
+  PangoContext *pango_context;
+
+  GHashTable *textures;
+  GHashTable *layouts;
+
+  guint has_keyframe : 1;
+
+  float viewport[4];
+  CoglMatrix projection;
+
+  GPtrArray *blocks;
+};
+
+struct _ClutterPaintPlayerClass
+{
+  GObjectClass parent_class;
+};
+
+enum
+{
+  FRAME,
+
+  LAST_SIGNAL
+};
+
+static guint recorder_signals[LAST_SIGNAL] = { 0, };
+
+/* the recorder of the frame being painted, if any */
+static ClutterPaintRecorder *current_recorder = NULL;
+
+G_DEFINE_TYPE (ClutterPaintRecorder, clutter_paint_recorder, G_TYPE_OBJECT)
+G_DEFINE_TYPE (ClutterPaintPlayer, clutter_paint_player, G_TYPE_OBJECT)
+
+static inline void
+byte_array_put_uint8 (GByteArray *array,
+                      guint8      value)
+{
+  g_byte_array_append (array, &value, 1);
+}
+
+static inline void
+byte_array_put_uint32 (GByteArray *array,
+                       guint32     value)
+{
+  guint32 le = GUINT32_TO_LE (value);
+
+  g_byte_array_append (array, (const guint8 *) &le, 4);
+}
+
+static inline void
+byte_array_put_float (GByteArray *array,
+                      float       value)
+{
+  union { float f; guint32 u; } v;
+
+  v.f = value;
+  byte_array_put_uint32 (array, v.u);
+}
+
+static void
+byte_array_put_string (GByteArray  *array,
+                       const gchar *str)
+{
+  gsize len = str != NULL ? strlen (str) : 0;
+
+  byte_array_put_uint32 (array, len);
+  g_byte_array_append (array, (const guint8 *) str, len);
+}
+
+static void
+byte_array_put_matrix (GByteArray       *array,
+                       const CoglMatrix *matrix)
+{
+  const float *m = cogl_matrix_get_array (matrix);
+  int i;
+
+  for (i = 0; i < 16; i++)
+    byte_array_put_float (array, m[i]);
+}
+
+/*
+ * ClutterPaintStreamWriter
+ */
+
+void
+_clutter_paint_stream_writer_put_uint8 (ClutterPaintStreamWriter *writer,
+                                        guint8                    value)
+{
+  byte_array_put_uint8 (writer->data, value);
+}
+
+void
+_clutter_paint_stream_writer_put_uint32 (ClutterPaintStreamWriter *writer,
+                                         guint32                   value)
+{
+  byte_array_put_uint32 (writer->data, value);
+}
+
+void
+_clutter_paint_stream_writer_put_float (ClutterPaintStreamWriter *writer,
+                                        float                     value)
+{
+  byte_array_put_float (writer->data, value);
+}
+
+void
+_clutter_paint_stream_writer_put_color (ClutterPaintStreamWriter *writer,
+                                        const CoglColor          *color)
+{
+  guint8 rgba[4];
+
+  rgba[0] = cogl_color_get_red_byte (color);
+  rgba[1] = cogl_color_get_green_byte (color);
+  rgba[2] = cogl_color_get_blue_byte (color);
+  rgba[3] = cogl_color_get_alpha_byte (color);
+
+  g_byte_array_append (writer->data, rgba, 4);
+}
+
+void
+_clutter_paint_stream_writer_put_matrix (ClutterPaintStreamWriter *writer,
+                                         const CoglMatrix         *matrix)
+{
+  byte_array_put_matrix (writer->data, matrix);
+}
+
+static void
+texture_entry_free (gpointer data)
+{
+  TextureEntry *entry = data;
+
+  /* the texture was destroyed while the recorder still knew it */
+  if (entry->recorder != NULL)
+    {
+      g_hash_table_remove (entry->recorder->textures,
+                           GUINT_TO_POINTER (entry->id));
+      g_array_append_val (entry->recorder->released_textures, entry->id);
+    }
+
+  g_slice_free (TextureEntry, entry);
+}
+
+static guint32
+clutter_paint_recorder_define_texture (ClutterPaintRecorder *recorder,
+                                       CoglTexture          *texture)
+{
+  TextureEntry *entry;
+  guint8 *pixels;
+  int width, height, size;
+
+  width = cogl_texture_get_width (texture);
+  height = cogl_texture_get_height (texture);
+
+  entry = g_slice_new (TextureEntry);
+  entry->recorder = recorder;
+  entry->id = 0;
+
+  /* the textures that cannot be read back are never sent */
+  size = cogl_texture_get_data (texture,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                width * 4,
+                                NULL);
+
+  if (width > 0 && height > 0 &&
+      width <= MAX_TEXTURE_SIZE && height <= MAX_TEXTURE_SIZE &&
+      size == width * height * 4)
+    {
+      pixels = g_malloc (size);
+
+      if (cogl_texture_get_data (texture,
+                                 COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                 width * 4,
+                                 pixels) == size)
+        {
+          entry->id = ++recorder->next_texture_id;
+
+          byte_array_put_uint8 (recorder->resources, RES_DEFINE_TEXTURE);
+          byte_array_put_uint32 (recorder->resources, entry->id);
+          byte_array_put_uint32 (recorder->resources, width);
+          byte_array_put_uint32 (recorder->resources, height);
+          g_byte_array_append (recorder->resources, pixels, size);
+
+          g_hash_table_insert (recorder->textures,
+                               GUINT_TO_POINTER (entry->id),
+                               texture);
+        }
+
+      g_free (pixels);
+    }
+
+  if (entry->id == 0)
+    entry->recorder = NULL;
+
+  cogl_object_set_user_data (COGL_OBJECT (texture), &recorder->texture_key,
+                             entry,
+                             texture_entry_free);
+
+  return entry->id;
+}
+
+void
+_clutter_paint_stream_writer_put_texture (ClutterPaintStreamWriter *writer,
+                                          CoglTexture              *texture)
+{
+  ClutterPaintRecorder *recorder = writer->recorder;
+  TextureEntry *entry;
+  guint32 id;
+
+  entry = cogl_object_get_user_data (COGL_OBJECT (texture),
+                                     &recorder->texture_key);
+  if (entry != NULL)
+    id = entry->id;
+  else
+    id = clutter_paint_recorder_define_texture (recorder, texture);
+
+  byte_array_put_uint32 (writer->data, id);
+}
+
+static GBytes *
+serialize_layout (PangoLayout *layout)
+{
+  const PangoFontDescription *desc;
+  GByteArray *array;
+  gchar *str;
+
+  array = g_byte_array_new ();
+
+  byte_array_put_string (array, pango_layout_get_text (layout));
+
+  desc = pango_layout_get_font_description (layout);
+  if (desc == NULL)
+    desc = pango_context_get_font_description (pango_layout_get_context (layout));
+
+  str = desc != NULL ? pango_font_description_to_string (desc) : NULL;
+  byte_array_put_string (array, str);
+  g_free (str);
+
+  byte_array_put_uint32 (array, pango_layout_get_width (layout));
+  byte_array_put_uint32 (array, pango_layout_get_height (layout));
+  byte_array_put_uint8 (array, pango_layout_get_wrap (layout));
+  byte_array_put_uint8 (array, pango_layout_get_ellipsize (layout));
+  byte_array_put_uint8 (array, pango_layout_get_alignment (layout));
+  byte_array_put_uint8 (array, pango_layout_get_justify (layout));
+  byte_array_put_uint8 (array, pango_layout_get_single_paragraph_mode (layout));
+  byte_array_put_uint32 (array, pango_layout_get_spacing (layout));
+  byte_array_put_uint32 (array, pango_layout_get_indent (layout));
+
+#if PANGO_VERSION_CHECK (1, 50, 0)
+  if (pango_layout_get_attributes (layout) != NULL)
+    str = pango_attr_list_to_string (pango_layout_get_attributes (layout));
+  else
+    str = NULL;
+
+  byte_array_put_string (array, str);
+  g_free (str);
+#else
+  byte_array_put_string (array, NULL);
+#endif
+
+  return g_byte_array_free_to_bytes (array);
+}
+
+void
+_clutter_paint_stream_writer_put_layout (ClutterPaintStreamWriter *writer,
+                                         PangoLayout              *layout)
+{
+  ClutterPaintRecorder *recorder = writer->recorder;
+  LayoutEntry *entry;
+  GBytes *blob;
+
+  blob = serialize_layout (layout);
+
+  entry = g_hash_table_lookup (recorder->layouts, blob);
+  if (entry == NULL)
+    {
+      gconstpointer data;
+      gsize size;
+
+      entry = g_slice_new (LayoutEntry);
+      entry->id = ++recorder->next_layout_id;
+
+      data = g_bytes_get_data (blob, &size);
+
+      byte_array_put_uint8 (recorder->resources, RES_DEFINE_LAYOUT);
+      byte_array_put_uint32 (recorder->resources, entry->id);
+      byte_array_put_uint32 (recorder->resources, size);
+      g_byte_array_append (recorder->resources, data, size);
+
+      g_hash_table_insert (recorder->layouts, g_bytes_ref (blob), entry);
+    }
+
+  entry->last_used = recorder->serial;
+
+  byte_array_put_uint32 (writer->data, entry->id);
+
+  g_bytes_unref (blob);
+}
+
+/*
+ * ClutterPaintStreamReader
+ */
+
+static void
+clutter_paint_stream_reader_init (ClutterPaintStreamReader *reader,
+                                  ClutterPaintPlayer       *player,
+                                  CoglFramebuffer          *framebuffer,
+                                  const guint8             *data,
+                                  gsize                     size)
+{
+  reader->player = player;
+  reader->framebuffer = framebuffer;
+  reader->data = data;
+  reader->size = size;
+  reader->offset = 0;
+  reader->valid = TRUE;
+}
+
+static const guint8 *
+clutter_paint_stream_reader_get_bytes (ClutterPaintStreamReader *reader,
+                                       gsize                     size)
+{
+  const guint8 *res;
+
+  if (!reader->valid || reader->size - reader->offset < size)
+    {
+      reader->valid = FALSE;
+      return NULL;
+    }
+
+  res = reader->data + reader->offset;
+  reader->offset += size;
+
+  return res;
+}
+
+static gchar *
+clutter_paint_stream_reader_get_string (ClutterPaintStreamReader *reader)
+{
+  const guint8 *bytes;
+  guint32 len;
+
+  len = _clutter_paint_stream_reader_get_uint32 (reader);
+  bytes = clutter_paint_stream_reader_get_bytes (reader, len);
+  if (bytes == NULL || len == 0)
+    return NULL;
+
+  return g_strndup ((const gchar *) bytes, len);
+}
+
+gboolean
+_clutter_paint_stream_reader_is_valid (ClutterPaintStreamReader *reader)
+{
+  return reader->valid;
+}
+
+gsize
+_clutter_paint_stream_reader_get_remaining (ClutterPaintStreamReader *reader)
+{
+  return reader->size - reader->offset;
+}
+
+CoglFramebuffer *
+_clutter_paint_stream_reader_get_framebuffer (ClutterPaintStreamReader *reader)
+{
+  return reader->framebuffer;
+}
+
+guint8
+_clutter_paint_stream_reader_get_uint8 (ClutterPaintStreamReader *reader)
+{
+  const guint8 *bytes = clutter_paint_stream_reader_get_bytes (reader, 1);
+
+  return bytes != NULL ? bytes[0] : 0;
+}
+
+guint32
+_clutter_paint_stream_reader_get_uint32 (ClutterPaintStreamReader *reader)
+{
+  const guint8 *bytes = clutter_paint_stream_reader_get_bytes (reader, 4);
+  guint32 le;
+
+  if (bytes == NULL)
+    return 0;
+
+  memcpy (&le, bytes, 4);
+
+  return GUINT32_FROM_LE (le);
+}
+
+float
+_clutter_paint_stream_reader_get_float (ClutterPaintStreamReader *reader)
+{
+  union { float f; guint32 u; } v;
+
+  v.u = _clutter_paint_stream_reader_get_uint32 (reader);
+
+  return v.f;
+}
+
+void
+_clutter_paint_stream_reader_get_color (ClutterPaintStreamReader *reader,
+                                        CoglColor                *color)
+{
+  const guint8 *rgba = clutter_paint_stream_reader_get_bytes (reader, 4);
+
+  if (rgba != NULL)
+    cogl_color_init_from_4ub (color, rgba[0], rgba[1], rgba[2], rgba[3]);
+  else
+    cogl_color_init_from_4ub (color, 0, 0, 0, 0);
+}
+
+void
+_clutter_paint_stream_reader_get_matrix (ClutterPaintStreamReader *reader,
+                                         CoglMatrix               *matrix)
+{
+  float m[16];
+  int i;
+
+  for (i = 0; i < 16; i++)
+    m[i] = _clutter_paint_stream_reader_get_float (reader);
+
+  if (reader->valid)
+    cogl_matrix_init_from_array (matrix, m);
+  else
+    cogl_matrix_init_identity (matrix);
+}
+
+CoglTexture *
+_clutter_paint_stream_reader_get_texture (ClutterPaintStreamReader *reader)
+{
+  CoglTexture *res;
+  guint32 id;
+
+  /* the id 0 is used for the textures that could not be sent */
+  id = _clutter_paint_stream_reader_get_uint32 (reader);
+  if (id == 0)
+    return NULL;
+
+  res = g_hash_table_lookup (reader->player->textures, GUINT_TO_POINTER (id));
+  if (res == NULL)
+    reader->valid = FALSE;
+
+  return res;
+}
+
+PangoLayout *
+_clutter_paint_stream_reader_get_layout (ClutterPaintStreamReader *reader)
+{
+  PangoLayout *res;
+  guint32 id;
+
+  id = _clutter_paint_stream_reader_get_uint32 (reader);
+
+  res = g_hash_table_lookup (reader->player->layouts, GUINT_TO_POINTER (id));
+  if (res == NULL)
+    reader->valid = FALSE;
+
+  return res;
+}
+
+/*
+ * ClutterPaintRecorder
+ */
+
+/* forgets the textures and the layouts sent so far, so that they are
+ * defined again by the next frame
+ */
+static void
+clutter_paint_recorder_reset (ClutterPaintRecorder *recorder)
+{
+  GHashTableIter iter;
+  gpointer value;
+  GList *textures, *l;
+
+  textures = NULL;
+
+  g_hash_table_iter_init (&iter, recorder->textures);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      TextureEntry *entry;
+
+      entry = cogl_object_get_user_data (COGL_OBJECT (value),
+                                         &recorder->texture_key);
+      entry->recorder = NULL;
+
+      textures = g_list_prepend (textures, value);
+    }
+
+  g_hash_table_remove_all (recorder->textures);
+
+  /* detaching the entries frees them */
+  for (l = textures; l != NULL; l = l->next)
+    cogl_object_set_user_data (COGL_OBJECT (l->data), &recorder->texture_key,
+                               NULL,
+                               NULL);
+
+  g_list_free (textures);
+
+  g_hash_table_remove_all (recorder->layouts);
+  g_array_set_size (recorder->released_textures, 0);
+  g_hash_table_remove_all (recorder->previous_blocks);
+}
+
+static void
+clutter_paint_recorder_dispose (GObject *gobject)
+{
+  ClutterPaintRecorder *recorder = CLUTTER_PAINT_RECORDER (gobject);
+
+  if (recorder->stage != NULL)
+    {
+      if (_clutter_stage_get_paint_recorder (recorder->stage) == recorder)
+        _clutter_stage_set_paint_recorder (recorder->stage, NULL);
+
+      g_object_remove_weak_pointer (G_OBJECT (recorder->stage),
+                                    (gpointer *) &recorder->stage);
+      recorder->stage = NULL;
+    }
+
+  if (current_recorder == recorder)
+    current_recorder = NULL;
+
+  G_OBJECT_CLASS (clutter_paint_recorder_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_paint_recorder_finalize (GObject *gobject)
+{
+  ClutterPaintRecorder *recorder = CLUTTER_PAINT_RECORDER (gobject);
+
+  clutter_paint_recorder_reset (recorder);
+
+  g_hash_table_unref (recorder->textures);
+  g_hash_table_unref (recorder->layouts);
+  g_hash_table_unref (recorder->previous_blocks);
+  g_array_unref (recorder->released_textures);
+  g_byte_array_unref (recorder->resources);
+
+  if (recorder->blocks != NULL)
+    g_ptr_array_unref (recorder->blocks);
+
+  G_OBJECT_CLASS (clutter_paint_recorder_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_paint_recorder_class_init (ClutterPaintRecorderClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->dispose = clutter_paint_recorder_dispose;
+  gobject_class->finalize = clutter_paint_recorder_finalize;
+
+  /**
+   * ClutterPaintRecorder::frame:
+   * @recorder: the #ClutterPaintRecorder that emitted the signal
+   * @frame: the encoded frame
+   *
+   * The ::frame signal is emitted after each paint of the stage, with
+   * the frame to pass to clutter_paint_player_push_frame(), in order.
+   *
+   * Since: 1.26
+   */
+  recorder_signals[FRAME] =
+    g_signal_new (I_("frame"),
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  _clutter_marshal_VOID__BOXED,
+                  G_TYPE_NONE, 1,
+                  G_TYPE_BYTES | G_SIGNAL_TYPE_STATIC_SCOPE);
+}
+
+static void
+clutter_paint_recorder_init (ClutterPaintRecorder *self)
+{
+  self->needs_keyframe = TRUE;
+
+  self->textures = g_hash_table_new (NULL, NULL);
+  self->released_textures = g_array_new (FALSE, FALSE, sizeof (guint32));
+  self->layouts = g_hash_table_new_full (g_bytes_hash, g_bytes_equal,
+                                         (GDestroyNotify) g_bytes_unref,
+                                         NULL);
+  self->resources = g_byte_array_new ();
+  self->previous_blocks = g_hash_table_new_full (g_bytes_hash, g_bytes_equal,
+                                                 (GDestroyNotify) g_bytes_unref,
+                                                 NULL);
+}
+
+/**
+ * clutter_paint_recorder_new:
+ * @stage: a #ClutterStage
+ *
+ * Creates a new #ClutterPaintRecorder recording the frames of @stage,
+ * replacing the recorder previously created for @stage, if any.
+ *
+ * The recorder stops when it is destroyed, or when @stage is.
+ *
+ * Return value: (transfer full): the newly created #ClutterPaintRecorder
+ *
+ * Since: 1.26
+ */
+ClutterPaintRecorder *
+clutter_paint_recorder_new (ClutterStage *stage)
+{
+  ClutterPaintRecorder *res;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+
+  res = g_object_new (CLUTTER_TYPE_PAINT_RECORDER, NULL);
+
+  res->stage = stage;
+  g_object_add_weak_pointer (G_OBJECT (stage), (gpointer *) &res->stage);
+
+  _clutter_stage_set_paint_recorder (stage, res);
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+
+  return res;
+}
+
+/**
+ * clutter_paint_recorder_get_stage:
+ * @recorder: a #ClutterPaintRecorder
+ *
+ * Retrieves the stage recorded by @recorder.
+ *
+ * Return value: (transfer none): the #ClutterStage, or %NULL if the
+ *   stage was destroyed
+ *
+ * Since: 1.26
+ */
+ClutterStage *
+clutter_paint_recorder_get_stage (ClutterPaintRecorder *recorder)
+{
+  g_return_val_if_fail (CLUTTER_IS_PAINT_RECORDER (recorder), NULL);
+
+  return recorder->stage;
+}
+
+/**
+ * clutter_paint_recorder_request_keyframe:
+ * @recorder: a #ClutterPaintRecorder
+ *
+ * Makes the next frame of @recorder a keyframe, which does not depend
+ * on the previous frames, and queues a redraw of the stage.
+ *
+ * Since: 1.26
+ */
+void
+clutter_paint_recorder_request_keyframe (ClutterPaintRecorder *recorder)
+{
+  g_return_if_fail (CLUTTER_IS_PAINT_RECORDER (recorder));
+
+  recorder->needs_keyframe = TRUE;
+
+  if (recorder->stage != NULL)
+    clutter_actor_queue_redraw (CLUTTER_ACTOR (recorder->stage));
+}
+
+/*< private >
+ * _clutter_paint_recorder_begin_frame:
+ * @recorder: a #ClutterPaintRecorder
+ * @framebuffer: the framebuffer of the stage
+ *
+ * Starts recording the trees painted on @framebuffer.
+ */
+void
+_clutter_paint_recorder_begin_frame (ClutterPaintRecorder *recorder,
+                                     CoglFramebuffer      *framebuffer)
+{
+  if (recorder->needs_keyframe)
+    clutter_paint_recorder_reset (recorder);
+
+  recorder->serial += 1;
+  recorder->framebuffer = framebuffer;
+  recorder->blocks = g_ptr_array_new_with_free_func ((GDestroyNotify) g_bytes_unref);
+
+  current_recorder = recorder;
+}
+
+/*< private >
+ * _clutter_paint_recorder_add_tree:
+ * @root: the root of a tree of #ClutterPaintNode being painted
+ *
+ * Adds @root to the frame being recorded, if @root is painted on the
+ * framebuffer of the recorded stage.
+ */
+void
+_clutter_paint_recorder_add_tree (ClutterPaintNode *root)
+{
+  ClutterPaintRecorder *recorder = current_recorder;
+  ClutterPaintStreamWriter writer;
+  CoglMatrix modelview;
+
+  if (G_LIKELY (recorder == NULL))
+    return;
+
+  if (clutter_paint_node_get_framebuffer (root) != recorder->framebuffer)
+    return;
+
+  writer.recorder = recorder;
+  writer.data = g_byte_array_new ();
+
+  cogl_framebuffer_get_modelview_matrix (recorder->framebuffer, &modelview);
+  _clutter_paint_stream_writer_put_matrix (&writer, &modelview);
+
+  _clutter_paint_node_record (root, &writer);
+  _clutter_paint_stream_writer_put_uint8 (&writer, PAINT_STREAM_NODE_END);
+
+  g_ptr_array_add (recorder->blocks, g_byte_array_free_to_bytes (writer.data));
+}
+
+/*< private >
+ * _clutter_paint_recorder_end_frame:
+ * @recorder: a #ClutterPaintRecorder
+ *
+ * Encodes the trees recorded since _clutter_paint_recorder_begin_frame()
+ * and emits the #ClutterPaintRecorder::frame signal.
+ */
+void
+_clutter_paint_recorder_end_frame (ClutterPaintRecorder *recorder)
+{
+  GHashTable *blocks_index;
+  GHashTableIter iter;
+  gpointer value;
+  CoglMatrix projection;
+  GByteArray *frame;
+  GBytes *bytes;
+  float viewport[4];
+  guint i;
+
+  current_recorder = NULL;
+
+  frame = g_byte_array_new ();
+
+  g_byte_array_append (frame, (const guint8 *) STREAM_MAGIC, STREAM_MAGIC_LEN);
+  byte_array_put_uint32 (frame, recorder->serial);
+  byte_array_put_uint8 (frame, recorder->needs_keyframe ? FRAME_KEYFRAME : 0);
+
+  cogl_framebuffer_get_viewport4fv (recorder->framebuffer, viewport);
+  for (i = 0; i < 4; i++)
+    byte_array_put_float (frame, viewport[i]);
+
+  cogl_framebuffer_get_projection_matrix (recorder->framebuffer, &projection);
+  byte_array_put_matrix (frame, &projection);
+
+  /* the resources */
+  for (i = 0; i < recorder->released_textures->len; i++)
+    {
+      byte_array_put_uint8 (frame, RES_RELEASE_TEXTURE);
+      byte_array_put_uint32 (frame, g_array_index (recorder->released_textures, guint32, i));
+    }
+
+  g_array_set_size (recorder->released_textures, 0);
+
+  g_hash_table_iter_init (&iter, recorder->layouts);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      LayoutEntry *entry = value;
+
+      if (recorder->serial - entry->last_used <= RESOURCE_MAX_AGE)
+        continue;
+
+      byte_array_put_uint8 (frame, RES_RELEASE_LAYOUT);
+      byte_array_put_uint32 (frame, entry->id);
+
+      g_slice_free (LayoutEntry, entry);
+      g_hash_table_iter_remove (&iter);
+    }
+
+  g_byte_array_append (frame, recorder->resources->data, recorder->resources->len);
+  g_byte_array_set_size (recorder->resources, 0);
+
+  byte_array_put_uint8 (frame, RES_END);
+
+  /* the blocks, replaced by a reference to the previous frame when
+   * they did not change
+   */
+  blocks_index = g_hash_table_new_full (g_bytes_hash, g_bytes_equal,
+                                        (GDestroyNotify) g_bytes_unref,
+                                        NULL);
+
+  byte_array_put_uint32 (frame, recorder->blocks->len);
+
+  for (i = 0; i < recorder->blocks->len; i++)
+    {
+      GBytes *block = g_ptr_array_index (recorder->blocks, i);
+      gpointer previous;
+
+      if (g_hash_table_lookup_extended (recorder->previous_blocks, block, NULL, &previous))
+        {
+          byte_array_put_uint8 (frame, BLOCK_COPY);
+          byte_array_put_uint32 (frame, GPOINTER_TO_UINT (previous));
+        }
+      else
+        {
+          gconstpointer data;
+          gsize size;
+
+          data = g_bytes_get_data (block, &size);
+
+          byte_array_put_uint8 (frame, BLOCK_DATA);
+          byte_array_put_uint32 (frame, size);
+          g_byte_array_append (frame, data, size);
+        }
+
+      if (!g_hash_table_contains (blocks_index, block))
+        g_hash_table_insert (blocks_index, g_bytes_ref (block), GUINT_TO_POINTER (i));
+    }
+
+  g_hash_table_unref (recorder->previous_blocks);
+  recorder->previous_blocks = blocks_index;
+
+  g_clear_pointer (&recorder->blocks, g_ptr_array_unref);
+
+  recorder->framebuffer = NULL;
+  recorder->needs_keyframe = FALSE;
+
+  bytes = g_byte_array_free_to_bytes (frame);
+
+  CLUTTER_NOTE (PAINT, "Recorded frame %u: %" G_GSIZE_FORMAT " bytes",
+                recorder->serial,
+                g_bytes_get_size (bytes));
+
+  g_signal_emit (recorder, recorder_signals[FRAME], 0, bytes);
+
+  g_bytes_unref (bytes);
+}
+
+/*
+ * ClutterPaintPlayer
+ */
+
+static void
+player_block_free (gpointer data)
+{
+  PlayerBlock *block = data;
+
+  g_bytes_unref (block->data);
+
+  if (block->tree != NULL)
+    clutter_paint_node_unref (block->tree);
+
+  g_slice_free (PlayerBlock, block);
+}
+
+static PlayerBlock *
+player_block_new (GBytes *data)
+{
+  PlayerBlock *block = g_slice_new0 (PlayerBlock);
+
+  block->data = data;
+
+  return block;
+}
+
+static void
+clutter_paint_player_clear (ClutterPaintPlayer *player)
+{
+  g_hash_table_remove_all (player->textures);
+  g_hash_table_remove_all (player->layouts);
+  g_ptr_array_set_size (player->blocks, 0);
+
+  player->has_keyframe = FALSE;
+}
+
+static void
+clutter_paint_player_finalize (GObject *gobject)
+{
+  ClutterPaintPlayer *player = CLUTTER_PAINT_PLAYER (gobject);
+
+  g_ptr_array_unref (player->blocks);
+  g_hash_table_unref (player->textures);
+  g_hash_table_unref (player->layouts);
+
+  g_clear_object (&player->pango_context);
+
+  G_OBJECT_CLASS (clutter_paint_player_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_paint_player_class_init (ClutterPaintPlayerClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = clutter_paint_player_finalize;
+}
+
+static void
+clutter_paint_player_init (ClutterPaintPlayer *self)
+{
+  self->textures = g_hash_table_new_full (NULL, NULL,
+                                          NULL,
+                                          cogl_object_unref);
+  self->layouts = g_hash_table_new_full (NULL, NULL,
+                                         NULL,
+                                         g_object_unref);
+  self->blocks = g_ptr_array_new_with_free_func (player_block_free);
+
+  cogl_matrix_init_identity (&self->projection);
+}
+
+/**
+ * clutter_paint_player_new:
+ *
+ * Creates a new #ClutterPaintPlayer, painting the frames recorded by
+ * a #ClutterPaintRecorder.
+ *
+ * Return value: (transfer full): the newly created #ClutterPaintPlayer
+ *
+ * Since: 1.26
+ */
+ClutterPaintPlayer *
+clutter_paint_player_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_PAINT_PLAYER, NULL);
+}
+
+static PangoLayout *
+clutter_paint_player_create_layout (ClutterPaintPlayer       *player,
+                                    ClutterPaintStreamReader *reader)
+{
+  PangoFontDescription *desc;
+  PangoLayout *layout;
+  gchar *str;
+
+  if (player->pango_context == NULL)
+    player->pango_context = _clutter_create_pango_context ();
+
+  layout = pango_layout_new (player->pango_context);
+
+  str = clutter_paint_stream_reader_get_string (reader);
+  pango_layout_set_text (layout, str != NULL ? str : "", -1);
+  g_free (str);
+
+  str = clutter_paint_stream_reader_get_string (reader);
+  if (str != NULL)
+    {
+      desc = pango_font_description_from_string (str);
+      pango_layout_set_font_description (layout, desc);
+      pango_font_description_free (desc);
+      g_free (str);
+    }
+
+  pango_layout_set_width (layout, (gint32) _clutter_paint_stream_reader_get_uint32 (reader));
+  pango_layout_set_height (layout, (gint32) _clutter_paint_stream_reader_get_uint32 (reader));
+  pango_layout_set_wrap (layout, _clutter_paint_stream_reader_get_uint8 (reader));
+  pango_layout_set_ellipsize (layout, _clutter_paint_stream_reader_get_uint8 (reader));
+  pango_layout_set_alignment (layout, _clutter_paint_stream_reader_get_uint8 (reader));
+  pango_layout_set_justify (layout, _clutter_paint_stream_reader_get_uint8 (reader));
+  pango_layout_set_single_paragraph_mode (layout, _clutter_paint_stream_reader_get_uint8 (reader));
+  pango_layout_set_spacing (layout, (gint32) _clutter_paint_stream_reader_get_uint32 (reader));
+  pango_layout_set_indent (layout, (gint32) _clutter_paint_stream_reader_get_uint32 (reader));
+
+  str = clutter_paint_stream_reader_get_string (reader);
+#if PANGO_VERSION_CHECK (1, 50, 0)
+  if (str != NULL)
+    {
+      PangoAttrList *attrs = pango_attr_list_from_string (str);
+
+      if (attrs != NULL)
+        {
+          pango_layout_set_attributes (layout, attrs);
+          pango_attr_list_unref (attrs);
+        }
+    }
+#endif
+  g_free (str);
+
+  if (!_clutter_paint_stream_reader_is_valid (reader))
+    {
+      g_object_unref (layout);
+      return NULL;
+    }
+
+  return layout;
+}
+
+static gboolean
+clutter_paint_player_read_resources (ClutterPaintPlayer       *player,
+                                     ClutterPaintStreamReader *reader)
+{
+  while (_clutter_paint_stream_reader_is_valid (reader))
+    {
+      guint8 kind = _clutter_paint_stream_reader_get_uint8 (reader);
+      guint32 id;
+
+      if (kind == RES_END)
+        return _clutter_paint_stream_reader_is_valid (reader);
+
+      id = _clutter_paint_stream_reader_get_uint32 (reader);
+
+      switch (kind)
+        {
+        case RES_RELEASE_TEXTURE:
+          g_hash_table_remove (player->textures, GUINT_TO_POINTER (id));
+          break;
+
+        case RES_RELEASE_LAYOUT:
+          g_hash_table_remove (player->layouts, GUINT_TO_POINTER (id));
+          break;
+
+        case RES_DEFINE_TEXTURE:
+          {
+            CoglTexture *texture;
+            const guint8 *pixels;
+            guint32 width, height;
+
+            width = _clutter_paint_stream_reader_get_uint32 (reader);
+            height = _clutter_paint_stream_reader_get_uint32 (reader);
+
+            if (id == 0 ||
+                width == 0 || width > MAX_TEXTURE_SIZE ||
+                height == 0 || height > MAX_TEXTURE_SIZE)
+              return FALSE;
+
+            pixels = clutter_paint_stream_reader_get_bytes (reader, width * height * 4);
+            if (pixels == NULL)
+              return FALSE;
+
+            texture = cogl_texture_new_from_data (width, height,
+                                                  COGL_TEXTURE_NONE,
+                                                  COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                                  COGL_PIXEL_FORMAT_ANY,
+                                                  width * 4,
+                                                  pixels);
+            if (texture == NULL)
+              return FALSE;
+
+            g_hash_table_replace (player->textures, GUINT_TO_POINTER (id), texture);
+          }
+          break;
+
+        case RES_DEFINE_LAYOUT:
+          {
+            ClutterPaintStreamReader layout_reader;
+            PangoLayout *layout;
+            const guint8 *data;
+            guint32 size;
+
+            size = _clutter_paint_stream_reader_get_uint32 (reader);
+            data = clutter_paint_stream_reader_get_bytes (reader, size);
+            if (data == NULL || id == 0)
+              return FALSE;
+
+            clutter_paint_stream_reader_init (&layout_reader, player, NULL, data, size);
+
+            layout = clutter_paint_player_create_layout (player, &layout_reader);
+            if (layout == NULL)
+              return FALSE;
+
+            g_hash_table_replace (player->layouts, GUINT_TO_POINTER (id), layout);
+          }
+          break;
+
+        default:
+          return FALSE;
+        }
+    }
+
+  return FALSE;
+}
+
+/**
+ * clutter_paint_player_push_frame:
+ * @player: a #ClutterPaintPlayer
+ * @frame: a frame emitted by the #ClutterPaintRecorder::frame signal
+ * @error: return location for a #GError, or %NULL
+ *
+ * Decodes @frame, which replaces the frame painted by
+ * clutter_paint_player_paint().
+ *
+ * The frames must be pushed in the order they were emitted, starting
+ * from a keyframe; if @frame cannot be decoded, the frames that follow
+ * are rejected until the next keyframe.
+ *
+ * Return value: %TRUE if @frame was decoded, and %FALSE otherwise
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_paint_player_push_frame (ClutterPaintPlayer  *player,
+                                 GBytes              *frame,
+                                 GError             **error)
+{
+  ClutterPaintStreamReader reader;
+  const guint8 *magic;
+  gconstpointer data;
+  GPtrArray *blocks;
+  guint32 n_blocks, i;
+  guint8 flags;
+  float projection[16];
+  gsize size;
+
+  g_return_val_if_fail (CLUTTER_IS_PAINT_PLAYER (player), FALSE);
+  g_return_val_if_fail (frame != NULL, FALSE);
+
+  data = g_bytes_get_data (frame, &size);
+  clutter_paint_stream_reader_init (&reader, player, NULL, data, size);
+
+  magic = clutter_paint_stream_reader_get_bytes (&reader, STREAM_MAGIC_LEN);
+  if (magic == NULL || memcmp (magic, STREAM_MAGIC, STREAM_MAGIC_LEN) != 0)
+    goto invalid;
+
+  _clutter_paint_stream_reader_get_uint32 (&reader);
+  flags = _clutter_paint_stream_reader_get_uint8 (&reader);
+
+  if (flags & FRAME_KEYFRAME)
+    clutter_paint_player_clear (player);
+  else if (!player->has_keyframe)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                           "The paint stream does not start with a keyframe");
+      return FALSE;
+    }
+
+  for (i = 0; i < 4; i++)
+    player->viewport[i] = _clutter_paint_stream_reader_get_float (&reader);
+
+  for (i = 0; i < 16; i++)
+    projection[i] = _clutter_paint_stream_reader_get_float (&reader);
+
+  if (!clutter_paint_player_read_resources (player, &reader))
+    goto invalid;
+
+  n_blocks = _clutter_paint_stream_reader_get_uint32 (&reader);
+  if (n_blocks > _clutter_paint_stream_reader_get_remaining (&reader) / 5)
+    goto invalid;
+
+  blocks = g_ptr_array_new_full (n_blocks, player_block_free);
+
+  for (i = 0; i < n_blocks; i++)
+    {
+      PlayerBlock *block;
+      guint8 kind;
+
+      kind = _clutter_paint_stream_reader_get_uint8 (&reader);
+
+      if (kind == BLOCK_COPY)
+        {
+          PlayerBlock *previous;
+          guint32 index_;
+
+          index_ = _clutter_paint_stream_reader_get_uint32 (&reader);
+          if (index_ >= player->blocks->len)
+            break;
+
+          /* the decoded tree is kept */
+          previous = g_ptr_array_index (player->blocks, index_);
+          block = player_block_new (g_bytes_ref (previous->data));
+          if (previous->tree != NULL)
+            block->tree = clutter_paint_node_ref (previous->tree);
+          block->framebuffer = previous->framebuffer;
+        }
+      else if (kind == BLOCK_DATA)
+        {
+          guint32 block_size;
+          gsize offset;
+
+          block_size = _clutter_paint_stream_reader_get_uint32 (&reader);
+          offset = reader.offset;
+          if (clutter_paint_stream_reader_get_bytes (&reader, block_size) == NULL)
+            break;
+
+          block = player_block_new (g_bytes_new_from_bytes (frame, offset, block_size));
+        }
+      else
+        break;
+
+      g_ptr_array_add (blocks, block);
+    }
+
+  if (i < n_blocks || !_clutter_paint_stream_reader_is_valid (&reader))
+    {
+      g_ptr_array_unref (blocks);
+      goto invalid;
+    }
+
+  cogl_matrix_init_from_array (&player->projection, projection);
+
+  g_ptr_array_unref (player->blocks);
+  player->blocks = blocks;
+  player->has_keyframe = TRUE;
+
+  return TRUE;
+
+invalid:
+  clutter_paint_player_clear (player);
+
+  g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                       "The paint stream frame is not valid");
+
+  return FALSE;
+}
+
+/**
+ * clutter_paint_player_paint:
+ * @player: a #ClutterPaintPlayer
+ * @framebuffer: a #CoglFramebuffer
+ *
+ * Paints the last frame pushed to @player on @framebuffer, using the
+ * viewport and the projection of the recorded stage.
+ *
+ * Since: 1.26
+ */
+void
+clutter_paint_player_paint (ClutterPaintPlayer *player,
+                            CoglFramebuffer    *framebuffer)
+{
+  CoglMatrix old_projection;
+  float old_viewport[4];
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_PAINT_PLAYER (player));
+  g_return_if_fail (cogl_is_framebuffer (framebuffer));
+
+  if (player->blocks->len == 0)
+    return;
+
+  cogl_framebuffer_get_viewport4fv (framebuffer, old_viewport);
+  cogl_framebuffer_get_projection_matrix (framebuffer, &old_projection);
+
+  cogl_push_framebuffer (framebuffer);
+  cogl_framebuffer_push_matrix (framebuffer);
+
+  cogl_framebuffer_set_viewport (framebuffer,
+                                 player->viewport[0],
+                                 player->viewport[1],
+                                 player->viewport[2],
+                                 player->viewport[3]);
+  cogl_framebuffer_set_projection_matrix (framebuffer, &player->projection);
+
+  for (i = 0; i < player->blocks->len; i++)
+    {
+      PlayerBlock *block = g_ptr_array_index (player->blocks, i);
+      ClutterPaintStreamReader reader;
+      CoglMatrix modelview;
+      gconstpointer data;
+      gsize size;
+
+      data = g_bytes_get_data (block->data, &size);
+      clutter_paint_stream_reader_init (&reader, player, framebuffer, data, size);
+
+      _clutter_paint_stream_reader_get_matrix (&reader, &modelview);
+
+      /* the trees are decoded once for each framebuffer */
+      if (block->tree == NULL || block->framebuffer != framebuffer)
+        {
+          g_clear_pointer (&block->tree, clutter_paint_node_unref);
+
+          block->tree = _clutter_paint_node_replay (&reader);
+          block->framebuffer = framebuffer;
+        }
+
+      if (block->tree == NULL)
+        continue;
+
+      cogl_framebuffer_set_modelview_matrix (framebuffer, &modelview);
+      _clutter_paint_node_paint (block->tree);
+    }
+
+  cogl_framebuffer_pop_matrix (framebuffer);
+  cogl_pop_framebuffer ();
+
+  cogl_framebuffer_set_projection_matrix (framebuffer, &old_projection);
+  cogl_framebuffer_set_viewport (framebuffer,
+                                 old_viewport[0],
+                                 old_viewport[1],
+                                 old_viewport[2],
+                                 old_viewport[3]);
+}
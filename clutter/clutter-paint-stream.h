@@ -0,0 +1,89 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_PAINT_STREAM_H__
+#define __CLUTTER_PAINT_STREAM_H__
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#include <cogl/cogl.h>
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_PAINT_RECORDER             (clutter_paint_recorder_get_type ())
+#define CLUTTER_PAINT_RECORDER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_PAINT_RECORDER, ClutterPaintRecorder))
+#define CLUTTER_IS_PAINT_RECORDER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_PAINT_RECORDER))
+
+#define CLUTTER_TYPE_PAINT_PLAYER               (clutter_paint_player_get_type ())
+#define CLUTTER_PAINT_PLAYER(obj)               (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_PAINT_PLAYER, ClutterPaintPlayer))
+#define CLUTTER_IS_PAINT_PLAYER(obj)            (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_PAINT_PLAYER))
+
+/**
+ * ClutterPaintRecorder:
+ *
+ * The #ClutterPaintRecorder structure is an opaque
+ * type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+typedef struct _ClutterPaintRecorder            ClutterPaintRecorder;
+typedef struct _ClutterPaintRecorderClass       ClutterPaintRecorderClass;
+
+/**
+ * ClutterPaintPlayer:
+ *
+ * The #ClutterPaintPlayer structure is an opaque
+ * type whose members cannot be directly accessed.
+ *
+ * Since: 1.26
+ */
+typedef struct _ClutterPaintPlayer              ClutterPaintPlayer;
+typedef struct _ClutterPaintPlayerClass         ClutterPaintPlayerClass;
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_paint_recorder_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterPaintRecorder *  clutter_paint_recorder_new              (ClutterStage         *stage);
+CLUTTER_AVAILABLE_IN_1_26
+ClutterStage *          clutter_paint_recorder_get_stage        (ClutterPaintRecorder *recorder);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_paint_recorder_request_keyframe (ClutterPaintRecorder *recorder);
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_paint_player_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterPaintPlayer *    clutter_paint_player_new                (void);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_paint_player_push_frame         (ClutterPaintPlayer   *player,
+                                                                 GBytes               *frame,
+                                                                 GError              **error);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_paint_player_paint              (ClutterPaintPlayer   *player,
+                                                                 CoglFramebuffer      *framebuffer);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_PAINT_STREAM_H__ */
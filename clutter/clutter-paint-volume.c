@@ -34,6 +34,7 @@
 #include <math.h>
 
 #include "clutter-actor-private.h"
+#include "clutter-box4-private.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 #include "clutter-stage-private.h"
@@ -534,6 +535,7 @@ clutter_paint_volume_union (ClutterPaintVolume *pv,
                             const ClutterPaintVolume *another_pv)
 {
   ClutterPaintVolume aligned_pv;
+  ClutterBox4 box;
 
   g_return_if_fail (pv != NULL);
   g_return_if_fail (another_pv != NULL);
@@ -567,55 +569,34 @@ clutter_paint_volume_union (ClutterPaintVolume *pv,
       another_pv = &aligned_pv;
     }
 
-  /* grow left*/
-  /* left vertices 0, 3, 4, 7 */
-  if (another_pv->vertices[0].x < pv->vertices[0].x)
-    {
-      int min_x = another_pv->vertices[0].x;
-      pv->vertices[0].x = min_x;
-      pv->vertices[3].x = min_x;
-      pv->vertices[4].x = min_x;
-      /* pv->vertices[7].x = min_x; */
-    }
-
-  /* grow right */
-  /* right vertices 1, 2, 5, 6 */
-  if (another_pv->vertices[1].x > pv->vertices[1].x)
-    {
-      int max_x = another_pv->vertices[1].x;
-      pv->vertices[1].x = max_x;
-      /* pv->vertices[2].x = max_x; */
-      /* pv->vertices[5].x = max_x; */
-      /* pv->vertices[6].x = max_x; */
-    }
-
-  /* grow up */
-  /* top vertices 0, 1, 4, 5 */
-  if (another_pv->vertices[0].y < pv->vertices[0].y)
-    {
-      int min_y = another_pv->vertices[0].y;
-      pv->vertices[0].y = min_y;
-      pv->vertices[1].y = min_y;
-      pv->vertices[4].y = min_y;
-      /* pv->vertices[5].y = min_y; */
-    }
-
-  /* grow down */
-  /* bottom vertices 2, 3, 6, 7 */
-  if (another_pv->vertices[3].y > pv->vertices[3].y)
-    {
-      int may_y = another_pv->vertices[3].y;
-      /* pv->vertices[2].y = may_y; */
-      pv->vertices[3].y = may_y;
-      /* pv->vertices[6].y = may_y; */
-      /* pv->vertices[7].y = may_y; */
-    }
+  /* grow left, right, up and down at once; the left vertices are
+   * 0, 3, 4, 7, the right ones 1, 2, 5, 6, the top ones 0, 1, 4, 5
+   * and the bottom ones 2, 3, 6, 7
+   */
+  box = _clutter_box4_union (_clutter_box4_init (pv->vertices[0].x,
+                                                 pv->vertices[0].y,
+                                                 pv->vertices[1].x,
+                                                 pv->vertices[3].y),
+                             _clutter_box4_init (another_pv->vertices[0].x,
+                                                 another_pv->vertices[0].y,
+                                                 another_pv->vertices[1].x,
+                                                 another_pv->vertices[3].y));
+
+  pv->vertices[0].x = box.v[0];
+  pv->vertices[3].x = box.v[0];
+  pv->vertices[4].x = box.v[0];
+  pv->vertices[1].x = -box.v[2];
+
+  pv->vertices[0].y = box.v[1];
+  pv->vertices[1].y = box.v[1];
+  pv->vertices[4].y = box.v[1];
+  pv->vertices[3].y = -box.v[3];
 
   /* grow forward */
   /* front vertices 0, 1, 2, 3 */
   if (another_pv->vertices[0].z < pv->vertices[0].z)
     {
-      int min_z = another_pv->vertices[0].z;
+      float min_z = another_pv->vertices[0].z;
       pv->vertices[0].z = min_z;
       pv->vertices[1].z = min_z;
       /* pv->vertices[2].z = min_z; */
@@ -626,7 +607,7 @@ clutter_paint_volume_union (ClutterPaintVolume *pv,
   /* back vertices 4, 5, 6, 7 */
   if (another_pv->vertices[4].z > pv->vertices[4].z)
     {
-      int maz_z = another_pv->vertices[4].z;
+      float maz_z = another_pv->vertices[4].z;
       pv->vertices[4].z = maz_z;
       /* pv->vertices[5].z = maz_z; */
       /* pv->vertices[6].z = maz_z; */
@@ -877,13 +858,10 @@ _clutter_paint_volume_transform (ClutterPaintVolume *pv,
   else
     transform_count = 8;
 
-  cogl_matrix_transform_points (matrix,
-                                3,
-                                sizeof (ClutterVertex),
-                                pv->vertices,
-                                sizeof (ClutterVertex),
-                                pv->vertices,
-                                transform_count);
+  _clutter_util_transform_vertices (matrix,
+                                    pv->vertices,
+                                    pv->vertices,
+                                    transform_count);
 
   pv->is_axis_aligned = FALSE;
 }
@@ -959,7 +937,27 @@ _clutter_paint_volume_axis_align (ClutterPaintVolume *pv)
   pv->vertices[4].y = origin.y;
   pv->vertices[4].z = max_z;
 
-  pv->is_complete = FALSE;
+  /* we already know all the corners of the box, so fill in the ones
+   * that would otherwise be completed lazily by the next bounding box,
+   * transformation or culling of the volume
+   */
+  pv->vertices[2].x = max_x;
+  pv->vertices[2].y = max_y;
+  pv->vertices[2].z = origin.z;
+
+  pv->vertices[5].x = max_x;
+  pv->vertices[5].y = origin.y;
+  pv->vertices[5].z = max_z;
+
+  pv->vertices[6].x = max_x;
+  pv->vertices[6].y = max_y;
+  pv->vertices[6].z = max_z;
+
+  pv->vertices[7].x = origin.x;
+  pv->vertices[7].y = max_y;
+  pv->vertices[7].z = max_z;
+
+  pv->is_complete = TRUE;
   pv->is_axis_aligned = TRUE;
 
   if (pv->vertices[4].z == pv->vertices[0].z)
@@ -1131,6 +1129,58 @@ _clutter_paint_volume_cull (ClutterPaintVolume *pv,
     return CLUTTER_CULL_RESULT_IN;
 }
 
+/* projects the paint volume of a 2D actor on a stage using an affine
+ * projection for the z = 0 plane, without any 4x4 matrix
+ */
+static gboolean
+clutter_paint_volume_get_stage_paint_box_2d (ClutterPaintVolume *pv,
+                                             ClutterStage       *stage,
+                                             ClutterActorBox    *box)
+{
+  cairo_matrix_t actor_transform, window_transform, transform;
+  double x[4], y[4];
+  int i;
+
+  if (pv->actor == NULL || pv->is_empty || !pv->is_2d)
+    return FALSE;
+
+  if (pv->vertices[0].z != 0.f ||
+      pv->vertices[1].z != 0.f ||
+      pv->vertices[3].z != 0.f)
+    return FALSE;
+
+  if (!_clutter_stage_get_window_transform (stage, &window_transform) ||
+      !_clutter_actor_get_stage_transform_2d (pv->actor, &actor_transform))
+    return FALSE;
+
+  cairo_matrix_multiply (&transform, &actor_transform, &window_transform);
+
+  x[0] = pv->vertices[0].x;
+  y[0] = pv->vertices[0].y;
+  x[1] = pv->vertices[1].x;
+  y[1] = pv->vertices[1].y;
+  x[2] = pv->vertices[3].x + (pv->vertices[1].x - pv->vertices[0].x);
+  y[2] = pv->vertices[3].y + (pv->vertices[1].y - pv->vertices[0].y);
+  x[3] = pv->vertices[3].x;
+  y[3] = pv->vertices[3].y;
+
+  for (i = 0; i < 4; i++)
+    cairo_matrix_transform_point (&transform, &x[i], &y[i]);
+
+  box->x1 = box->x2 = x[0];
+  box->y1 = box->y2 = y[0];
+
+  for (i = 1; i < 4; i++)
+    {
+      box->x1 = MIN (box->x1, x[i]);
+      box->x2 = MAX (box->x2, x[i]);
+      box->y1 = MIN (box->y1, y[i]);
+      box->y2 = MAX (box->y2, y[i]);
+    }
+
+  return TRUE;
+}
+
 void
 _clutter_paint_volume_get_stage_paint_box (ClutterPaintVolume *pv,
                                            ClutterStage *stage,
@@ -1143,6 +1193,9 @@ _clutter_paint_volume_get_stage_paint_box (ClutterPaintVolume *pv,
   float width;
   float height;
 
+  if (clutter_paint_volume_get_stage_paint_box_2d (pv, stage, box))
+    goto quantize;
+
   _clutter_paint_volume_copy_static (pv, &projected_pv);
 
   cogl_matrix_init_identity (&modelview);
@@ -1166,6 +1219,9 @@ _clutter_paint_volume_get_stage_paint_box (ClutterPaintVolume *pv,
 
   _clutter_paint_volume_get_bounding_box (&projected_pv, box);
 
+  clutter_paint_volume_free (&projected_pv);
+
+quantize:
   /* The aim here is that for a given rectangle defined with floating point
    * coordinates we want to determine a stable quantized size in pixels
    * that doesn't vary due to the original box's sub-pixel position.
@@ -1210,8 +1266,6 @@ _clutter_paint_volume_get_stage_paint_box (ClutterPaintVolume *pv,
    */
   box->x1 = box->x2 - width - 3;
   box->y1 = box->y2 - height - 3;
-
-  clutter_paint_volume_free (&projected_pv);
 }
 
 void
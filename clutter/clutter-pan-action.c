@@ -110,6 +110,7 @@ struct _ClutterPanActionPrivate
   gfloat release_y;
 
   guint should_interpolate : 1;
+  guint use_prediction : 1;
 
   PinState pin_state;
 };
@@ -122,6 +123,7 @@ enum
   PROP_INTERPOLATE,
   PROP_DECELERATION,
   PROP_ACCELERATION_FACTOR,
+  PROP_USE_PREDICTION,
 
   PROP_LAST
 };
@@ -372,6 +374,10 @@ clutter_pan_action_set_property (GObject      *gobject,
       clutter_pan_action_set_acceleration_factor (self, g_value_get_double (value));
       break;
 
+    case PROP_USE_PREDICTION:
+      clutter_pan_action_set_use_prediction (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -404,6 +410,10 @@ clutter_pan_action_get_property (GObject    *gobject,
       g_value_set_double (value, priv->acceleration_factor);
       break;
 
+    case PROP_USE_PREDICTION:
+      g_value_set_boolean (value, priv->use_prediction);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -530,6 +540,24 @@ clutter_pan_action_class_init (ClutterPanActionClass *klass)
                          1.0, G_MAXDOUBLE, default_acceleration_factor,
                          CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterPanAction:use-prediction:
+   *
+   * Whether the ::pan events should follow the position predicted for
+   * the time the frame is presented, instead of the position reported
+   * by the input device.
+   *
+   * See clutter_event_get_predicted_coords().
+   *
+   * Since: 1.26
+   */
+  pan_props[PROP_USE_PREDICTION] =
+    g_param_spec_boolean ("use-prediction",
+                          P_("Use Prediction"),
+                          P_("Whether to pan using the predicted position of the touch points"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
   gobject_class->constructed = clutter_pan_action_constructed;
   gobject_class->set_property = clutter_pan_action_set_property;
   gobject_class->get_property = clutter_pan_action_get_property;
@@ -957,6 +985,10 @@ clutter_pan_action_get_motion_delta (ClutterPanAction *self,
 
       return 0;
     case PAN_STATE_PANNING:
+      if (priv->use_prediction)
+        return _clutter_gesture_action_get_predicted_delta (CLUTTER_GESTURE_ACTION (self),
+                                                            point, delta_x, delta_y);
+
       return clutter_gesture_action_get_motion_delta (CLUTTER_GESTURE_ACTION (self),
                                                       point, delta_x, delta_y);
     case PAN_STATE_INTERPOLATING:
@@ -1007,8 +1039,12 @@ clutter_pan_action_get_motion_coords (ClutterPanAction *self,
         *motion_y = 0;
       break;
     case PAN_STATE_PANNING:
-      clutter_gesture_action_get_motion_coords (CLUTTER_GESTURE_ACTION (self),
-                                                point, motion_x, motion_y);
+      if (priv->use_prediction)
+        _clutter_gesture_action_get_predicted_coords (CLUTTER_GESTURE_ACTION (self),
+                                                      point, motion_x, motion_y);
+      else
+        clutter_gesture_action_get_motion_coords (CLUTTER_GESTURE_ACTION (self),
+                                                  point, motion_x, motion_y);
       break;
     case PAN_STATE_INTERPOLATING:
       clutter_pan_action_get_interpolated_coords (self, motion_x, motion_y);
@@ -1017,3 +1053,56 @@ clutter_pan_action_get_motion_coords (ClutterPanAction *self,
       g_assert_not_reached ();
     }
 }
+
+/**
+ * clutter_pan_action_set_use_prediction:
+ * @self: a #ClutterPanAction
+ * @use_prediction: whether to use the predicted touch point positions
+ *
+ * Sets whether the motion deltas and coordinates of @self, while
+ * panning, should follow the position that the touch point is
+ * predicted to have when the frame is presented, which reduces the
+ * perceived latency of the panning.
+ *
+ * The velocity used for the interpolated ::pan events is always
+ * measured on the positions reported by the input device.
+ *
+ * Since: 1.26
+ */
+void
+clutter_pan_action_set_use_prediction (ClutterPanAction *self,
+                                       gboolean          use_prediction)
+{
+  ClutterPanActionPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_PAN_ACTION (self));
+
+  priv = self->priv;
+
+  use_prediction = !!use_prediction;
+
+  if (priv->use_prediction == use_prediction)
+    return;
+
+  priv->use_prediction = use_prediction;
+
+  g_object_notify_by_pspec (G_OBJECT (self), pan_props[PROP_USE_PREDICTION]);
+}
+
+/**
+ * clutter_pan_action_get_use_prediction:
+ * @self: a #ClutterPanAction
+ *
+ * Retrieves the value set by clutter_pan_action_set_use_prediction().
+ *
+ * Return value: %TRUE if @self uses the predicted touch point positions
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_pan_action_get_use_prediction (ClutterPanAction *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_PAN_ACTION (self), FALSE);
+
+  return self->priv->use_prediction;
+}
@@ -147,6 +147,13 @@ gfloat          clutter_pan_action_get_constrained_motion_delta (ClutterPanActio
                                                                  guint             point,
                                                                  gfloat           *delta_x,
                                                                  gfloat           *delta_y);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_pan_action_set_use_prediction           (ClutterPanAction *self,
+                                                                 gboolean          use_prediction);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_pan_action_get_use_prediction           (ClutterPanAction *self);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_PAN_ACTION_H__ */
@@ -103,14 +103,40 @@ struct _ClutterPathNodeFull
   guint length;
 };
 
+typedef struct _ClutterPathNodeSpan
+{
+  /* the distance along the path at which the node starts */
+  guint start;
+
+  ClutterPathNodeFull *node;
+} ClutterPathNodeSpan;
+
 struct _ClutterPathPrivate
 {
   GSList *nodes, *nodes_tail;
   gboolean nodes_dirty;
 
   guint total_length;
+
+  /* the cumulative lengths of the nodes, rebuilt together with the
+   * node data so that the node covering a position can be found with
+   * a binary search instead of walking the list
+   */
+  GArray *node_spans;
+
+  /* incremented each time the nodes change */
+  guint generation;
+
+  /* the nodes as a Cogl path, which keeps its tessellation as long
+   * as it is not modified, and the generation it was built from
+   */
+  CoglPath *cogl_path;
+  guint cogl_path_generation;
 };
 
+/* the number of positions computed together by clutter_path_get_positions() */
+#define POSITIONS_BATCH_SIZE    64
+
 /* Character tests that don't pay attention to the locale */
 #define clutter_path_isspace(ch) memchr (" \f\n\r\t\v", (ch), 6)
 #define clutter_path_isdigit(ch) ((ch) >= '0' && (ch) <= '9')
@@ -238,6 +264,11 @@ clutter_path_finalize (GObject *object)
 
   clutter_path_clear (self);
 
+  if (self->priv->node_spans != NULL)
+    g_array_unref (self->priv->node_spans);
+
+  g_clear_pointer (&self->priv->cogl_path, cogl_object_unref);
+
   G_OBJECT_CLASS (clutter_path_parent_class)->finalize (object);
 }
 
@@ -302,6 +333,7 @@ clutter_path_clear (ClutterPath *path)
 
   priv->nodes = priv->nodes_tail = NULL;
   priv->nodes_dirty = TRUE;
+  priv->generation++;
 }
 
 /* Takes ownership of the node */
@@ -322,6 +354,7 @@ clutter_path_add_node_full (ClutterPath         *path,
   priv->nodes_tail = new_node;
 
   priv->nodes_dirty = TRUE;
+  priv->generation++;
 }
 
 /* Helper function to make the rest of teh add_* functions shorter */
@@ -685,6 +718,7 @@ clutter_path_add_nodes (ClutterPath *path,
     }
 
   priv->nodes_dirty = TRUE;
+  priv->generation++;
 }
 
 /**
@@ -880,6 +914,91 @@ clutter_path_to_cairo_path (ClutterPath *path,
   clutter_path_foreach (path, clutter_path_add_node_to_cairo_path, cr);
 }
 
+static void
+clutter_path_add_node_to_cogl_path (const ClutterPathNode *node,
+                                    gpointer               data)
+{
+  CoglPath *path = data;
+
+  switch (node->type)
+    {
+    case CLUTTER_PATH_MOVE_TO:
+      cogl_path_move_to (path, node->points[0].x, node->points[0].y);
+      break;
+
+    case CLUTTER_PATH_LINE_TO:
+      cogl_path_line_to (path, node->points[0].x, node->points[0].y);
+      break;
+
+    case CLUTTER_PATH_CURVE_TO:
+      cogl_path_curve_to (path,
+                          node->points[0].x, node->points[0].y,
+                          node->points[1].x, node->points[1].y,
+                          node->points[2].x, node->points[2].y);
+      break;
+
+    case CLUTTER_PATH_REL_MOVE_TO:
+      cogl_path_rel_move_to (path, node->points[0].x, node->points[0].y);
+      break;
+
+    case CLUTTER_PATH_REL_LINE_TO:
+      cogl_path_rel_line_to (path, node->points[0].x, node->points[0].y);
+      break;
+
+    case CLUTTER_PATH_REL_CURVE_TO:
+      cogl_path_rel_curve_to (path,
+                              node->points[0].x, node->points[0].y,
+                              node->points[1].x, node->points[1].y,
+                              node->points[2].x, node->points[2].y);
+      break;
+
+    case CLUTTER_PATH_CLOSE:
+      cogl_path_close (path);
+    }
+}
+
+/**
+ * clutter_path_get_cogl_path:
+ * @path: a #ClutterPath
+ *
+ * Retrieves the nodes of @path as a Cogl path, e.g. to be added to a
+ * #ClutterPaintNode using clutter_paint_node_add_path().
+ *
+ * The Cogl path is only built again when the nodes of @path change;
+ * since Cogl keeps the tessellation of a path until it is modified,
+ * filling, or clipping to, the returned path at every frame does not
+ * tessellate it again, whatever the transformation it is drawn with.
+ *
+ * Return value: (transfer none): a Cogl path, owned by @path and valid
+ *   until its nodes change
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+CoglPath *
+clutter_path_get_cogl_path (ClutterPath *path)
+{
+  ClutterPathPrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_PATH (path), NULL);
+
+  priv = path->priv;
+
+  if (priv->cogl_path == NULL ||
+      priv->cogl_path_generation != priv->generation)
+    {
+      g_clear_pointer (&priv->cogl_path, cogl_object_unref);
+
+      priv->cogl_path = cogl_path_new ();
+      clutter_path_foreach (path, clutter_path_add_node_to_cogl_path,
+                            priv->cogl_path);
+
+      priv->cogl_path_generation = priv->generation;
+    }
+
+  return priv->cogl_path;
+}
+
 /**
  * clutter_path_get_n_nodes:
  * @path: a #ClutterPath
@@ -1018,6 +1137,7 @@ clutter_path_insert_node (ClutterPath           *path,
     priv->nodes_tail = priv->nodes_tail->next;
 
   priv->nodes_dirty = TRUE;
+  priv->generation++;
 }
 
 /**
@@ -1058,6 +1178,7 @@ clutter_path_remove_node (ClutterPath *path,
       g_slist_free_1 (node);
 
       priv->nodes_dirty = TRUE;
+      priv->generation++;
     }
 }
 
@@ -1090,6 +1211,7 @@ clutter_path_replace_node (ClutterPath           *path,
       node_full->k = *node;
 
       priv->nodes_dirty = TRUE;
+      priv->generation++;
     }
 }
 
@@ -1246,10 +1368,17 @@ clutter_path_ensure_node_data (ClutterPath *path)
 
       priv->total_length = 0;
 
+      if (priv->node_spans == NULL)
+        priv->node_spans = g_array_new (FALSE, FALSE,
+                                        sizeof (ClutterPathNodeSpan));
+      else
+        g_array_set_size (priv->node_spans, 0);
+
       for (l = priv->nodes; l; l = l->next)
         {
           ClutterPathNodeFull *node = l->data;
           gboolean relative = (node->k.type & CLUTTER_PATH_RELATIVE) != 0;
+          ClutterPathNodeSpan span;
 
           switch (node->k.type & ~CLUTTER_PATH_RELATIVE)
             {
@@ -1331,6 +1460,10 @@ clutter_path_ensure_node_data (ClutterPath *path)
               break;
             }
 
+          span.start = priv->total_length;
+          span.node = node;
+          g_array_append_val (priv->node_spans, span);
+
           priv->total_length += node->length;
         }
 
@@ -1338,6 +1471,89 @@ clutter_path_ensure_node_data (ClutterPath *path)
     }
 }
 
+/* Finds the last node starting at or before @point_distance, looking
+ * only at the nodes from @first_node onwards; when several nodes start
+ * at the same distance because some of them have no length, this picks
+ * the last one
+ */
+static guint
+clutter_path_find_node (ClutterPath *path,
+                        guint        point_distance,
+                        guint        first_node)
+{
+  GArray *spans = path->priv->node_spans;
+  guint lo = first_node, hi = spans->len;
+
+  /* the result is in [lo, hi - 1]; the first node always starts at 0,
+   * and the callers never pass a @first_node starting after the distance
+   */
+  while (hi - lo > 1)
+    {
+      guint mid = lo + (hi - lo) / 2;
+
+      if (g_array_index (spans, ClutterPathNodeSpan, mid).start <= point_distance)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/* converts a distance along a curve to the relative length used by
+ * _clutter_bezier_advance() */
+static gint
+clutter_path_node_relative_length (ClutterPathNodeFull *node,
+                                   guint                point_distance)
+{
+  if (point_distance > node->length)
+    point_distance = node->length;
+
+  return (guint64) point_distance * CLUTTER_BEZIER_MAX_LENGTH / node->length;
+}
+
+static void
+clutter_path_get_node_position (ClutterPathNodeFull *node,
+                                guint                point_distance,
+                                ClutterKnot         *position)
+{
+  if (point_distance > node->length)
+    point_distance = node->length;
+
+  switch (node->k.type & ~CLUTTER_PATH_RELATIVE)
+    {
+    case CLUTTER_PATH_MOVE_TO:
+      *position = node->k.points[1];
+      break;
+
+    case CLUTTER_PATH_LINE_TO:
+    case CLUTTER_PATH_CLOSE:
+      if (node->length == 0)
+        *position = node->k.points[1];
+      else
+        {
+          position->x = (node->k.points[1].x
+                         + ((node->k.points[2].x - node->k.points[1].x)
+                            * (gint) point_distance / (gint) node->length));
+          position->y = (node->k.points[1].y
+                         + ((node->k.points[2].y - node->k.points[1].y)
+                            * (gint) point_distance / (gint) node->length));
+        }
+      break;
+
+    case CLUTTER_PATH_CURVE_TO:
+      if (node->length == 0)
+        *position = node->k.points[2];
+      else
+        {
+          gint L = clutter_path_node_relative_length (node, point_distance);
+
+          _clutter_bezier_advance (node->bezier, L, position);
+        }
+      break;
+    }
+}
+
 /**
  * clutter_path_get_position:
  * @path: a #ClutterPath
@@ -1358,9 +1574,8 @@ clutter_path_get_position (ClutterPath *path,
                            ClutterKnot *position)
 {
   ClutterPathPrivate *priv;
-  GSList *l;
-  guint point_distance, length = 0, node_num = 0;
-  ClutterPathNodeFull *node;
+  ClutterPathNodeSpan *span;
+  guint point_distance, node_num;
 
   g_return_val_if_fail (CLUTTER_IS_PATH (path), 0);
   g_return_val_if_fail (progress >= 0.0 && progress <= 1.0, 0);
@@ -1381,57 +1596,136 @@ clutter_path_get_position (ClutterPath *path,
   point_distance = progress * priv->total_length;
 
   /* Find the node that covers this point */
-  for (l = priv->nodes;
-       l->next && point_distance >= (((ClutterPathNodeFull *) l->data)->length
-                                     + length);
-       l = l->next)
-    {
-      length += ((ClutterPathNodeFull *) l->data)->length;
-      node_num++;
-    }
-
-  node = l->data;
+  node_num = clutter_path_find_node (path, point_distance, 0);
+  span = &g_array_index (priv->node_spans, ClutterPathNodeSpan, node_num);
 
   /* Convert the point distance to a distance along the node */
-  point_distance -= length;
-  if (point_distance > node->length)
-    point_distance = node->length;
+  clutter_path_get_node_position (span->node,
+                                  point_distance - span->start,
+                                  position);
 
-  switch (node->k.type & ~CLUTTER_PATH_RELATIVE)
+  return node_num;
+}
+
+/**
+ * clutter_path_get_positions:
+ * @path: a #ClutterPath
+ * @progress: (array length=n_positions): positions along the path as
+ *   fractions of its length
+ * @positions: (array length=n_positions) (out caller-allocates): return
+ *   location for the positions
+ * @nodes: (array length=n_positions) (out caller-allocates) (allow-none):
+ *   return location for the indices of the nodes used to calculate the
+ *   positions, or %NULL
+ * @n_positions: the number of positions to compute
+ *
+ * Computes many positions along @path at once, like calling
+ * clutter_path_get_position() for each value in @progress.
+ *
+ * This is faster than computing the positions one by one, especially
+ * when the values in @progress are sorted in increasing order, for
+ * instance when laying out many actors along the same path.
+ *
+ * Since: 1.26
+ */
+void
+clutter_path_get_positions (ClutterPath   *path,
+                            const gdouble *progress,
+                            ClutterKnot   *positions,
+                            guint         *nodes,
+                            guint          n_positions)
+{
+  ClutterPathPrivate *priv;
+  guint last_distance = 0, node_num = 0;
+  guint base;
+
+  g_return_if_fail (CLUTTER_IS_PATH (path));
+  g_return_if_fail (n_positions == 0 || (progress != NULL && positions != NULL));
+
+  priv = path->priv;
+
+  clutter_path_ensure_node_data (path);
+
+  if (priv->nodes == NULL)
     {
-    case CLUTTER_PATH_MOVE_TO:
-      *position = node->k.points[1];
-      break;
+      memset (positions, 0, sizeof (ClutterKnot) * n_positions);
+      if (nodes != NULL)
+        memset (nodes, 0, sizeof (guint) * n_positions);
 
-    case CLUTTER_PATH_LINE_TO:
-    case CLUTTER_PATH_CLOSE:
-      if (node->length == 0)
-        *position = node->k.points[1];
-      else
+      return;
+    }
+
+  for (base = 0; base < n_positions; base += POSITIONS_BATCH_SIZE)
+    {
+      guint batch_nodes[POSITIONS_BATCH_SIZE];
+      guint distances[POSITIONS_BATCH_SIZE];
+      gint lengths[POSITIONS_BATCH_SIZE];
+      guint count = MIN (n_positions - base, POSITIONS_BATCH_SIZE);
+      guint i, j;
+
+      /* find the nodes covering the positions first... */
+      for (i = 0; i < count; i++)
         {
-          position->x = (node->k.points[1].x
-                         + ((node->k.points[2].x - node->k.points[1].x)
-                            * (gint) point_distance / (gint) node->length));
-          position->y = (node->k.points[1].y
-                         + ((node->k.points[2].y - node->k.points[1].y)
-                            * (gint) point_distance / (gint) node->length));
+          ClutterPathNodeSpan *span;
+          guint point_distance;
+
+          point_distance =
+            CLAMP (progress[base + i], 0.0, 1.0) * priv->total_length;
+
+          /* when the distances are increasing, the node can only be
+           * the previous one or a later one
+           */
+          node_num = clutter_path_find_node (path, point_distance,
+                                             point_distance >= last_distance
+                                               ? node_num
+                                               : 0);
+          last_distance = point_distance;
+
+          span = &g_array_index (priv->node_spans, ClutterPathNodeSpan, node_num);
+
+          batch_nodes[i] = node_num;
+          distances[i] = point_distance - span->start;
         }
-      break;
 
-    case CLUTTER_PATH_CURVE_TO:
-      if (node->length == 0)
-        *position = node->k.points[2];
-      else
+      /* ...then compute the positions, evaluating the runs of positions
+       * on the same curve together
+       */
+      for (i = 0; i < count; i = j)
         {
-          _clutter_bezier_advance (node->bezier,
-                                   point_distance * CLUTTER_BEZIER_MAX_LENGTH
-                                   / node->length,
-                                   position);
+          ClutterPathNodeFull *node =
+            g_array_index (priv->node_spans, ClutterPathNodeSpan,
+                           batch_nodes[i]).node;
+
+          for (j = i + 1; j < count && batch_nodes[j] == batch_nodes[i]; j++)
+            ;
+
+          if ((node->k.type & ~CLUTTER_PATH_RELATIVE) == CLUTTER_PATH_CURVE_TO &&
+              node->length != 0)
+            {
+              guint k;
+
+              for (k = i; k < j; k++)
+                lengths[k] = clutter_path_node_relative_length (node,
+                                                                distances[k]);
+
+              _clutter_bezier_advance_n (node->bezier,
+                                         lengths + i,
+                                         positions + base + i,
+                                         j - i);
+            }
+          else
+            {
+              guint k;
+
+              for (k = i; k < j; k++)
+                clutter_path_get_node_position (node, distances[k],
+                                                &positions[base + k]);
+            }
         }
-      break;
-    }
 
-  return node_num;
+      if (nodes != NULL)
+        memcpy (nodes + base, batch_nodes, sizeof (guint) * count);
+    }
 }
 
 /**
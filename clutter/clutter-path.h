@@ -175,6 +175,14 @@ guint        clutter_path_get_position         (ClutterPath           *path,
                                                 ClutterKnot           *position);
 CLUTTER_AVAILABLE_IN_1_0
 guint        clutter_path_get_length           (ClutterPath           *path);
+CLUTTER_AVAILABLE_IN_1_26
+void         clutter_path_get_positions        (ClutterPath           *path,
+                                                const gdouble         *progress,
+                                                ClutterKnot           *positions,
+                                                guint                 *nodes,
+                                                guint                  n_positions);
+CLUTTER_AVAILABLE_IN_1_26
+CoglPath *   clutter_path_get_cogl_path        (ClutterPath           *path);
 
 G_END_DECLS
 
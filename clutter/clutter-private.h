@@ -165,6 +165,11 @@ struct _ClutterMainContext
   GList *repaint_funcs;
   guint last_repaint_id;
 
+  /* the time the repaint functions with a low priority can take in
+   * each phase of a frame, in microseconds, or 0
+   */
+  gint64 repaint_funcs_budget;
+
   /* main settings singleton */
   ClutterSettings *settings;
 
@@ -174,6 +179,7 @@ struct _ClutterMainContext
   guint defer_display_setup     : 1;
   guint options_parsed          : 1;
   guint show_fps                : 1;
+  guint show_hud                : 1;
 };
 
 /* shared between clutter-main.c and clutter-frame-source.c */
@@ -200,6 +206,7 @@ ClutterActor *          _clutter_context_pop_shader_stack               (Clutter
 ClutterActor *          _clutter_context_peek_shader_stack              (void);
 gboolean                _clutter_context_get_motion_events_enabled      (void);
 gboolean                _clutter_context_get_show_fps                   (void);
+gboolean                _clutter_context_get_show_hud                   (void);
 
 const gchar *_clutter_gettext (const gchar *str);
 
@@ -210,12 +217,46 @@ gboolean        _clutter_diagnostic_enabled     (void);
 void            _clutter_diagnostic_message     (const char *fmt, ...);
 
 /* Picking code */
+void            _clutter_set_pick_color_bits    (gint          red_bits,
+                                                 gint          green_bits,
+                                                 gint          blue_bits);
 guint           _clutter_pixel_to_id            (guchar        pixel[4]);
 void            _clutter_id_to_color            (guint         id,
                                                  ClutterColor *col);
 
 void            _clutter_set_sync_to_vblank     (gboolean      sync_to_vblank);
 gboolean        _clutter_get_sync_to_vblank     (void);
+guint           _clutter_get_measure_threads    (void);
+gsize           _clutter_get_text_layout_cache_size (void);
+gsize           _clutter_get_image_cache_size   (void);
+guint           _clutter_get_image_atlas_max_size (void);
+gsize           _clutter_get_upload_budget      (void);
+gboolean        _clutter_get_distance_field_text (void);
+
+gboolean        _clutter_get_staged_init        (void);
+gboolean        _clutter_get_pipelined_swaps    (void);
+const gchar *   _clutter_get_record_events_path (void);
+const gchar *   _clutter_get_replay_events_path (void);
+
+typedef enum {
+  CLUTTER_STARTUP_MARK_INIT_START,
+  CLUTTER_STARTUP_MARK_BACKEND_END,
+  CLUTTER_STARTUP_MARK_CONTEXT_END,
+  CLUTTER_STARTUP_MARK_EVENTS_END,
+  CLUTTER_STARTUP_MARK_INIT_END,
+  CLUTTER_STARTUP_MARK_WINDOW,
+  CLUTTER_STARTUP_MARK_FONT_MAP_START,
+  CLUTTER_STARTUP_MARK_FONT_MAP_END,
+  CLUTTER_STARTUP_MARK_ACCESSIBILITY_START,
+  CLUTTER_STARTUP_MARK_ACCESSIBILITY_END,
+  CLUTTER_STARTUP_MARK_FIRST_FRAME,
+  CLUTTER_STARTUP_MARK_FIRST_PRESENTATION
+} ClutterStartupMark;
+
+void            _clutter_startup_mark           (ClutterStartupMark mark,
+                                                 gint64             time_);
+
+PangoContext *  _clutter_create_pango_context   (void);
 
 /* use this function as the accumulator if you have a signal with
  * a G_TYPE_BOOLEAN return value; this will stop the emission as
@@ -237,7 +278,19 @@ gboolean _clutter_boolean_continue_accumulator (GSignalInvocationHint *ihint,
 
 void _clutter_run_repaint_functions (ClutterRepaintFlags flags);
 
+gboolean _clutter_threads_has_pending_tasks (void);
+void     _clutter_threads_run_tasks         (void);
+
 GType _clutter_layout_manager_get_child_meta_type (ClutterLayoutManager *manager);
+ClutterLayoutMeta *_clutter_layout_manager_get_child_meta (ClutterLayoutManager *manager,
+                                                          ClutterContainer     *container,
+                                                          ClutterActor         *actor);
+gboolean _clutter_layout_manager_animate_allocation (ClutterLayoutManager   *manager,
+                                                     ClutterActor           *child,
+                                                     const ClutterActorBox  *from,
+                                                     const ClutterActorBox  *to,
+                                                     ClutterAllocationFlags  flags,
+                                                     gboolean                animate);
 
 void  _clutter_util_fully_transform_vertices (const CoglMatrix    *modelview,
                                               const CoglMatrix    *projection,
@@ -245,6 +298,15 @@ void  _clutter_util_fully_transform_vertices (const CoglMatrix    *modelview,
                                               const ClutterVertex *vertices_in,
                                               ClutterVertex       *vertices_out,
                                               int                  n_vertices);
+void  _clutter_util_transform_vertices       (const CoglMatrix    *matrix,
+                                              const ClutterVertex *vertices_in,
+                                              ClutterVertex       *vertices_out,
+                                              int                  n_vertices);
+void  _clutter_util_push_rectangle_clip      (CoglFramebuffer     *framebuffer,
+                                              float                x_1,
+                                              float                y_1,
+                                              float                x_2,
+                                              float                y_2);
 
 void _clutter_util_rectangle_union (const cairo_rectangle_int_t *src1,
                                     const cairo_rectangle_int_t *src2,
@@ -281,6 +343,31 @@ void    _clutter_util_matrix_skew_xz            (ClutterMatrix *matrix,
 void    _clutter_util_matrix_skew_yz            (ClutterMatrix *matrix,
                                                  float          factor);
 
+/*< private >
+ * ClutterTransformKind:
+ * @CLUTTER_TRANSFORM_KIND_IDENTITY: the identity matrix
+ * @CLUTTER_TRANSFORM_KIND_TRANSLATE: a translation on the x and y axes
+ * @CLUTTER_TRANSFORM_KIND_AFFINE_2D: an affine transformation of the
+ *   z = 0 plane, like scaling and rotating around the z axis
+ * @CLUTTER_TRANSFORM_KIND_3D: any other transformation
+ *
+ * The kinds of transformation matrices; the kind of the product of two
+ * matrices is at most the greatest of their kinds.
+ */
+typedef enum _ClutterTransformKind
+{
+  CLUTTER_TRANSFORM_KIND_IDENTITY,
+  CLUTTER_TRANSFORM_KIND_TRANSLATE,
+  CLUTTER_TRANSFORM_KIND_AFFINE_2D,
+  CLUTTER_TRANSFORM_KIND_3D
+} ClutterTransformKind;
+
+ClutterTransformKind    _clutter_util_matrix_get_kind           (const ClutterMatrix *matrix);
+void                    _clutter_util_matrix_multiply_kind      (ClutterMatrix       *result,
+                                                                 const ClutterMatrix *a,
+                                                                 const ClutterMatrix *b,
+                                                                 ClutterTransformKind b_kind);
+
 gboolean        _clutter_util_matrix_decompose  (const ClutterMatrix *src,
                                                  ClutterVertex       *scale_p,
                                                  float                shear_p[3],
@@ -288,6 +375,33 @@ gboolean        _clutter_util_matrix_decompose  (const ClutterMatrix *src,
                                                  ClutterVertex       *translate_p,
                                                  ClutterVertex4      *perspective_p);
 
+/*< private >
+ * ClutterMatrixComponents:
+ * @scale: the scaling factors
+ * @shear: the skew factors (XY, XZ, and YZ respectively)
+ * @rotate: the Euler angles, in degrees
+ * @translate: the translation
+ * @perspective: the perspective
+ *
+ * A matrix decomposed by _clutter_util_matrix_decompose(), so that it
+ * can be interpolated with another matrix.
+ */
+typedef struct _ClutterMatrixComponents
+{
+  ClutterVertex scale;
+  float shear[3];
+  ClutterVertex rotate;
+  ClutterVertex translate;
+  ClutterVertex4 perspective;
+} ClutterMatrixComponents;
+
+void    _clutter_util_matrix_get_components             (const ClutterMatrix           *matrix,
+                                                         ClutterMatrixComponents       *components);
+void    _clutter_util_matrix_components_interpolate     (const ClutterMatrixComponents *a,
+                                                         const ClutterMatrixComponents *b,
+                                                         double                         progress,
+                                                         ClutterMatrix                 *res);
+
 typedef struct _ClutterPlane
 {
   float v0[3];
@@ -303,12 +417,19 @@ typedef enum _ClutterCullResult
 } ClutterCullResult;
 
 gboolean        _clutter_has_progress_function  (GType gtype);
+ClutterProgressFunc _clutter_get_progress_function (GType gtype);
+guint           _clutter_get_progress_functions_serial (void);
 gboolean        _clutter_run_progress_function  (GType gtype,
                                                  const GValue *initial,
                                                  const GValue *final,
                                                  gdouble progress,
                                                  GValue *retval);
 
+gboolean        _clutter_matrix_progress        (const GValue *a,
+                                                 const GValue *b,
+                                                 gdouble       progress,
+                                                 GValue       *retval);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_PRIVATE_H__ */
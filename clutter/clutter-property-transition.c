@@ -34,11 +34,13 @@
 #include "config.h"
 #endif
 
-#include "clutter-property-transition.h"
+#include "clutter-property-transition-private.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
+#include "clutter-master-clock.h"
 #include "clutter-private.h"
 #include "clutter-transition.h"
 
@@ -47,6 +49,16 @@ struct _ClutterPropertyTransitionPrivate
   char *property_name;
 
   GParamSpec *pspec;
+
+  /* the id of the property for the scalar fast path of ClutterActor,
+   * or 0 if the property goes through ClutterAnimatable
+   */
+  guint scalar_prop_id;
+
+  /* whether the value is sampled by the stage when painting, instead
+   * of being set on each frame of the timeline
+   */
+  guint paint_time : 1;
 };
 
 enum
@@ -111,6 +123,11 @@ clutter_property_transition_attached (ClutterTransition *transition,
   if (priv->pspec == NULL)
     return;
 
+  if (CLUTTER_IS_ACTOR (animatable))
+    priv->scalar_prop_id =
+      _clutter_actor_get_scalar_animatable_property (CLUTTER_ACTOR (animatable),
+                                                     priv->pspec);
+
   interval = clutter_transition_get_interval (transition);
   if (interval == NULL)
     return;
@@ -125,27 +142,130 @@ clutter_property_transition_detached (ClutterTransition *transition,
   ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (transition);
   ClutterPropertyTransitionPrivate *priv = self->priv;
 
-  priv->pspec = NULL; 
+  priv->pspec = NULL;
+  priv->scalar_prop_id = 0;
+}
+
+/* Interpolates the scalar properties of ClutterActor without going
+ * through GValues and the ClutterAnimatable interface; the result is
+ * the same as the one of clutter_interval_compute_value()
+ */
+static gboolean
+clutter_property_transition_interpolate_scalar (ClutterPropertyTransition *self,
+                                                ClutterInterval           *interval,
+                                                gdouble                    progress,
+                                                gdouble                   *value)
+{
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+  const GValue *initial, *final;
+  GType value_type;
+  gdouble res;
+
+  /* subclasses of ClutterInterval and progress functions may compute
+   * the value differently
+   */
+  if (G_TYPE_FROM_INSTANCE (interval) != CLUTTER_TYPE_INTERVAL)
+    return FALSE;
+
+  value_type = clutter_interval_get_value_type (interval);
+  if (value_type != G_PARAM_SPEC_VALUE_TYPE (priv->pspec) ||
+      _clutter_has_progress_function (value_type))
+    return FALSE;
+
+  initial = clutter_interval_peek_initial_value (interval);
+  final = clutter_interval_peek_final_value (interval);
+
+  switch (value_type)
+    {
+    case G_TYPE_FLOAT:
+      res = (progress * (g_value_get_float (final) - (gdouble) g_value_get_float (initial)))
+          + g_value_get_float (initial);
+      res = (gfloat) res;
+      break;
+
+    case G_TYPE_DOUBLE:
+      res = (progress * (g_value_get_double (final) - g_value_get_double (initial)))
+          + g_value_get_double (initial);
+      break;
+
+    case G_TYPE_UINT:
+      res = (guint) ((progress * (g_value_get_uint (final) - (gdouble) g_value_get_uint (initial)))
+                     + g_value_get_uint (initial));
+      break;
+
+    default:
+      return FALSE;
+    }
+
+  *value = res;
+
+  return TRUE;
 }
 
+static inline gboolean
+clutter_property_transition_compute_scalar (ClutterPropertyTransition *self,
+                                            ClutterAnimatable         *animatable,
+                                            ClutterInterval           *interval,
+                                            gdouble                    progress)
+{
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+  gdouble res;
+
+  if (!clutter_property_transition_interpolate_scalar (self, interval,
+                                                       progress,
+                                                       &res))
+    return FALSE;
+
+  _clutter_actor_set_scalar_animatable_property (CLUTTER_ACTOR (animatable),
+                                                 priv->scalar_prop_id,
+                                                 priv->pspec,
+                                                 res);
+
+  return TRUE;
+}
+
+static inline gboolean
+clutter_property_transition_is_paint_time (ClutterPropertyTransition *self)
+{
+  /* subclasses may remap the progress of the timeline, so we cannot
+   * sample them ourselves
+   */
+  return self->priv->paint_time &&
+         self->priv->scalar_prop_id != 0 &&
+         G_OBJECT_TYPE (self) == CLUTTER_TYPE_PROPERTY_TRANSITION;
+}
+
+static inline gboolean
+timeline_is_at_end (ClutterTimeline *timeline)
+{
+  gint64 elapsed = clutter_timeline_get_elapsed_time (timeline);
+
+  if (clutter_timeline_get_direction (timeline) == CLUTTER_TIMELINE_FORWARD)
+    return elapsed >= clutter_timeline_get_duration (timeline);
+
+  return elapsed <= 0;
+}
+
+/* sets the value of the property at @progress through the property
+ * system, notifying the change
+ */
 static void
-clutter_property_transition_compute_value (ClutterTransition *transition,
-                                           ClutterAnimatable *animatable,
-                                           ClutterInterval   *interval,
-                                           gdouble            progress)
+clutter_property_transition_apply (ClutterPropertyTransition *self,
+                                   ClutterAnimatable         *animatable,
+                                   ClutterInterval           *interval,
+                                   gdouble                    progress)
 {
-  ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (transition);
   ClutterPropertyTransitionPrivate *priv = self->priv;
   GValue value = G_VALUE_INIT;
   GType p_type, i_type;
   gboolean res;
 
-  /* if we have a GParamSpec we also have an animatable instance */
-  if (priv->pspec == NULL)
+  if (priv->scalar_prop_id != 0 &&
+      clutter_property_transition_compute_scalar (self, animatable,
+                                                  interval,
+                                                  progress))
     return;
 
-  clutter_property_transition_ensure_interval (self, animatable, interval);
-
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
@@ -192,6 +312,65 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
   g_value_unset (&value);
 }
 
+static void
+clutter_property_transition_compute_value (ClutterTransition *transition,
+                                           ClutterAnimatable *animatable,
+                                           ClutterInterval   *interval,
+                                           gdouble            progress)
+{
+  ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (transition);
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+  gdouble res;
+
+  /* if we have a GParamSpec we also have an animatable instance */
+  if (priv->pspec == NULL)
+    return;
+
+  clutter_property_transition_ensure_interval (self, animatable, interval);
+
+  /* paint time transitions only check that the interval can be
+   * sampled, and leave the update of the actor to the stage; the last
+   * frame of each run goes through the property system, so that the
+   * final state is notified before ::stopped is emitted
+   */
+  if (clutter_property_transition_is_paint_time (self) &&
+      !timeline_is_at_end (CLUTTER_TIMELINE (transition)) &&
+      clutter_property_transition_interpolate_scalar (self, interval,
+                                                      progress,
+                                                      &res) &&
+      _clutter_actor_queue_paint_time_sample (CLUTTER_ACTOR (animatable),
+                                              priv->scalar_prop_id))
+    return;
+
+  clutter_property_transition_apply (self, animatable, interval, progress);
+}
+
+static void
+clutter_property_transition_stopped (ClutterTimeline *timeline,
+                                     gboolean         is_finished)
+{
+  ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (timeline);
+  ClutterTransition *transition = CLUTTER_TRANSITION (timeline);
+  ClutterAnimatable *animatable;
+  ClutterInterval *interval;
+
+  /* the intermediate values of a paint time transition are never
+   * notified, so stopping it half way has to commit the current one
+   */
+  animatable = clutter_transition_get_animatable (transition);
+  interval = clutter_transition_get_interval (transition);
+
+  if (!is_finished &&
+      clutter_property_transition_is_paint_time (self) &&
+      animatable != NULL &&
+      interval != NULL)
+    clutter_property_transition_apply (self, animatable, interval,
+                                       clutter_timeline_get_progress (timeline));
+
+  CLUTTER_TIMELINE_CLASS (clutter_property_transition_parent_class)->stopped (timeline,
+                                                                              is_finished);
+}
+
 static void
 clutter_property_transition_set_property (GObject      *gobject,
                                           guint         prop_id,
@@ -247,12 +426,15 @@ static void
 clutter_property_transition_class_init (ClutterPropertyTransitionClass *klass)
 {
   ClutterTransitionClass *transition_class = CLUTTER_TRANSITION_CLASS (klass);
+  ClutterTimelineClass *timeline_class = CLUTTER_TIMELINE_CLASS (klass);
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   transition_class->attached = clutter_property_transition_attached;
   transition_class->detached = clutter_property_transition_detached;
   transition_class->compute_value = clutter_property_transition_compute_value;
 
+  timeline_class->stopped = clutter_property_transition_stopped;
+
   gobject_class->set_property = clutter_property_transition_set_property;
   gobject_class->get_property = clutter_property_transition_get_property;
   gobject_class->finalize = clutter_property_transition_finalize;
@@ -325,6 +507,7 @@ clutter_property_transition_set_property_name (ClutterPropertyTransition *transi
   g_free (priv->property_name);
   priv->property_name = g_strdup (property_name);
   priv->pspec = NULL;
+  priv->scalar_prop_id = 0;
 
   animatable =
     clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
@@ -332,6 +515,11 @@ clutter_property_transition_set_property_name (ClutterPropertyTransition *transi
     {
       priv->pspec = clutter_animatable_find_property (animatable,
                                                       priv->property_name);
+
+      if (priv->pspec != NULL && CLUTTER_IS_ACTOR (animatable))
+        priv->scalar_prop_id =
+          _clutter_actor_get_scalar_animatable_property (CLUTTER_ACTOR (animatable),
+                                                         priv->pspec);
     }
 
   g_object_notify_by_pspec (G_OBJECT (transition),
@@ -358,3 +546,67 @@ clutter_property_transition_get_property_name (ClutterPropertyTransition *transi
 
   return transition->priv->property_name;
 }
+
+/*< private >
+ * _clutter_property_transition_set_paint_time:
+ * @transition: a #ClutterPropertyTransition
+ * @paint_time: whether the transition should be sampled at paint time
+ *
+ * Makes @transition leave the intermediate values of the property it
+ * animates to the stage, which samples them through
+ * _clutter_property_transition_sample() right before painting a frame.
+ *
+ * Only the properties of #ClutterActor affecting its transformation or
+ * its opacity can be sampled; every other property, as well as the last
+ * frame of the transition, is set through the property system.
+ */
+void
+_clutter_property_transition_set_paint_time (ClutterPropertyTransition *transition,
+                                             gboolean                   paint_time)
+{
+  transition->priv->paint_time = !!paint_time;
+}
+
+/*< private >
+ * _clutter_property_transition_sample:
+ * @transition: a #ClutterPropertyTransition
+ * @frame_time: the time of the frame, in milliseconds
+ * @prop_id: (out): return location for the id of the property, to be
+ *   used with the scalar property setters of #ClutterActor
+ * @value: (out): return location for the value of the property
+ *
+ * Computes the value of the property animated by @transition at the
+ * time of the frame being painted.
+ *
+ * Return value: %TRUE if @transition is a playing paint time transition
+ *   and the value could be sampled
+ */
+gboolean
+_clutter_property_transition_sample (ClutterPropertyTransition *transition,
+                                     gint64                     frame_time,
+                                     guint                     *prop_id,
+                                     gdouble                   *value)
+{
+  ClutterTimeline *timeline = CLUTTER_TIMELINE (transition);
+  ClutterInterval *interval;
+  gdouble progress;
+
+  if (!clutter_property_transition_is_paint_time (transition) ||
+      !clutter_timeline_is_playing (timeline))
+    return FALSE;
+
+  interval = clutter_transition_get_interval (CLUTTER_TRANSITION (transition));
+  if (interval == NULL)
+    return FALSE;
+
+  progress = _clutter_timeline_get_progress_at_time (timeline, frame_time);
+
+  if (!clutter_property_transition_interpolate_scalar (transition, interval,
+                                                       progress,
+                                                       value))
+    return FALSE;
+
+  *prop_id = transition->priv->scalar_prop_id;
+
+  return TRUE;
+}
@@ -0,0 +1,1060 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * The compiled format of the ClutterScript definitions.
+ *
+ * A compiled file is a header, followed by the object definitions in
+ * the same order in which the parser created them, and by a table of
+ * NUL-terminated strings. Every field is a little endian 32 bit word,
+ * and strings are stored as offsets inside the table, with the offset
+ * 0 meaning NULL:
+ *
+ *   file     := MAGIC version n_objects strings_offset strings_size
+ *               object* strings
+ *   object   := id class_name type_name type_func flags
+ *               n_properties n_children n_signals
+ *               property* child_id* signal*
+ *   property := name flags node [value_type value_lo value_hi]
+ *   signal   := name handler object state target connect_flags flags
+ *   node     := NODE_NULL | NODE_BOOLEAN value | NODE_INT lo hi
+ *             | NODE_DOUBLE lo hi | NODE_STRING string
+ *             | NODE_ARRAY n_elements node*
+ *             | NODE_OBJECT n_members (name node)*
+ *
+ * The type name is the name of the GType resolved by the compiler, so
+ * that the loader can skip the look up of the type function for the
+ * types that have already been registered. The values of the properties
+ * with a fundamental type are converted by the compiler through
+ * _clutter_script_parse_node(), and stored using their fundamental type;
+ * enumerations and flags are stored as integers. Each property still
+ * carries its JSON node, rebuilt without parsing, for the properties
+ * that ClutterScriptable implementations parse by themselves and for
+ * the values that could not be converted ahead of time.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-script-binary.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+#define COMPILED_MAGIC          "CLTSCRPT"
+#define COMPILED_MAGIC_LEN      8
+#define COMPILED_VERSION        1
+#define COMPILED_HEADER_SIZE    (COMPILED_MAGIC_LEN + 4 * sizeof (guint32))
+
+/* guards against corrupted data nesting nodes forever */
+#define MAX_NODE_DEPTH          64
+
+enum
+{
+  NODE_NULL,
+  NODE_BOOLEAN,
+  NODE_INT,
+  NODE_DOUBLE,
+  NODE_STRING,
+  NODE_ARRAY,
+  NODE_OBJECT
+};
+
+enum
+{
+  OBJECT_ANONYMOUS     = 1 << 0,
+  OBJECT_STAGE_DEFAULT = 1 << 1
+};
+
+enum
+{
+  PROPERTY_HAS_VALUE = 1 << 0
+};
+
+enum
+{
+  SIGNAL_IS_HANDLER = 1 << 0,
+  SIGNAL_WARP_TO    = 1 << 1
+};
+
+typedef union {
+  gdouble d;
+  guint64 u;
+} DoubleBits;
+
+typedef struct {
+  GByteArray *data;
+  GString *strings;
+  GHashTable *string_offsets;
+} Writer;
+
+typedef struct {
+  const guint8 *data;
+  gsize size;
+  gsize pos;
+
+  const gchar *strings;
+  gsize strings_size;
+
+  /* maps the ids generated by the compiler to the ones we generate */
+  GHashTable *fake_ids;
+
+  gboolean is_valid;
+} Reader;
+
+static void
+write_uint32 (Writer  *writer,
+              guint32  value)
+{
+  value = GUINT32_TO_LE (value);
+  g_byte_array_append (writer->data, (const guint8 *) &value, sizeof (value));
+}
+
+static void
+write_uint64 (Writer  *writer,
+              guint64  value)
+{
+  write_uint32 (writer, value & 0xffffffff);
+  write_uint32 (writer, value >> 32);
+}
+
+static guint32
+intern_string (Writer      *writer,
+               const gchar *str)
+{
+  gpointer offset;
+
+  if (str == NULL)
+    return 0;
+
+  if (!g_hash_table_lookup_extended (writer->string_offsets, str, NULL, &offset))
+    {
+      offset = GUINT_TO_POINTER (writer->strings->len);
+      g_string_append_len (writer->strings, str, strlen (str) + 1);
+      g_hash_table_insert (writer->string_offsets, g_strdup (str), offset);
+    }
+
+  return GPOINTER_TO_UINT (offset);
+}
+
+static void
+write_string (Writer      *writer,
+              const gchar *str)
+{
+  write_uint32 (writer, intern_string (writer, str));
+}
+
+static void
+write_node (Writer   *writer,
+            JsonNode *node)
+{
+  switch (JSON_NODE_TYPE (node))
+    {
+    case JSON_NODE_OBJECT:
+      {
+        JsonObject *object = json_node_get_object (node);
+        GList *members, *l;
+
+        members = json_object_get_members (object);
+
+        write_uint32 (writer, NODE_OBJECT);
+        write_uint32 (writer, g_list_length (members));
+
+        for (l = members; l != NULL; l = l->next)
+          {
+            write_string (writer, l->data);
+            write_node (writer, json_object_get_member (object, l->data));
+          }
+
+        g_list_free (members);
+      }
+      break;
+
+    case JSON_NODE_ARRAY:
+      {
+        JsonArray *array = json_node_get_array (node);
+        guint i, n_elements;
+
+        n_elements = json_array_get_length (array);
+
+        write_uint32 (writer, NODE_ARRAY);
+        write_uint32 (writer, n_elements);
+
+        for (i = 0; i < n_elements; i++)
+          write_node (writer, json_array_get_element (array, i));
+      }
+      break;
+
+    case JSON_NODE_VALUE:
+      switch (json_node_get_value_type (node))
+        {
+        case G_TYPE_BOOLEAN:
+          write_uint32 (writer, NODE_BOOLEAN);
+          write_uint32 (writer, json_node_get_boolean (node));
+          break;
+
+        case G_TYPE_INT64:
+          write_uint32 (writer, NODE_INT);
+          write_uint64 (writer, (guint64) json_node_get_int (node));
+          break;
+
+        case G_TYPE_DOUBLE:
+          {
+            DoubleBits bits;
+
+            bits.d = json_node_get_double (node);
+
+            write_uint32 (writer, NODE_DOUBLE);
+            write_uint64 (writer, bits.u);
+          }
+          break;
+
+        case G_TYPE_STRING:
+          write_uint32 (writer, NODE_STRING);
+          write_string (writer, json_node_get_string (node));
+          break;
+
+        default:
+          write_uint32 (writer, NODE_NULL);
+          break;
+        }
+      break;
+
+    case JSON_NODE_NULL:
+      write_uint32 (writer, NODE_NULL);
+      break;
+    }
+}
+
+/* the types of the values that we convert when compiling */
+static gboolean
+is_compiled_value_type (GType gtype)
+{
+  switch (G_TYPE_FUNDAMENTAL (gtype))
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+    case G_TYPE_STRING:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+static void
+write_value (Writer       *writer,
+             const GValue *value)
+{
+  GType value_type = G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (value));
+  DoubleBits bits;
+
+  switch (value_type)
+    {
+    case G_TYPE_BOOLEAN:
+      bits.u = g_value_get_boolean (value);
+      break;
+
+    case G_TYPE_CHAR:
+      bits.u = (guint64) (gint64) g_value_get_schar (value);
+      break;
+
+    case G_TYPE_UCHAR:
+      bits.u = g_value_get_uchar (value);
+      break;
+
+    case G_TYPE_INT:
+      bits.u = (guint64) (gint64) g_value_get_int (value);
+      break;
+
+    case G_TYPE_UINT:
+      bits.u = g_value_get_uint (value);
+      break;
+
+    case G_TYPE_LONG:
+      bits.u = (guint64) (gint64) g_value_get_long (value);
+      break;
+
+    case G_TYPE_ULONG:
+      bits.u = g_value_get_ulong (value);
+      break;
+
+    case G_TYPE_INT64:
+      bits.u = (guint64) g_value_get_int64 (value);
+      break;
+
+    case G_TYPE_UINT64:
+      bits.u = g_value_get_uint64 (value);
+      break;
+
+    case G_TYPE_ENUM:
+      bits.u = (guint64) (gint64) g_value_get_enum (value);
+      value_type = G_TYPE_INT;
+      break;
+
+    case G_TYPE_FLAGS:
+      bits.u = g_value_get_flags (value);
+      value_type = G_TYPE_UINT;
+      break;
+
+    case G_TYPE_FLOAT:
+      bits.d = g_value_get_float (value);
+      break;
+
+    case G_TYPE_DOUBLE:
+      bits.d = g_value_get_double (value);
+      break;
+
+    case G_TYPE_STRING:
+      bits.u = intern_string (writer, g_value_get_string (value));
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  write_uint32 (writer, value_type >> G_TYPE_FUNDAMENTAL_SHIFT);
+  write_uint64 (writer, bits.u);
+}
+
+static void
+write_object (Writer        *writer,
+              ClutterScript *script,
+              ObjectInfo    *oinfo,
+              const gchar   *fake_id_prefix)
+{
+  GObjectClass *klass = NULL;
+  GType gtype;
+  guint32 flags = 0;
+  GList *l;
+
+  if (oinfo->type_func != NULL)
+    gtype = _clutter_script_get_type_from_symbol (oinfo->type_func);
+  else
+    gtype = clutter_script_get_type_from_name (script, oinfo->class_name);
+
+  if (g_type_is_a (gtype, G_TYPE_OBJECT))
+    klass = g_type_class_ref (gtype);
+  else
+    CLUTTER_NOTE (SCRIPT, "Unable to resolve the type '%s' of object '%s'",
+                  oinfo->class_name,
+                  oinfo->id);
+
+  if (g_str_has_prefix (oinfo->id, fake_id_prefix))
+    flags |= OBJECT_ANONYMOUS;
+
+  if (oinfo->is_stage_default)
+    flags |= OBJECT_STAGE_DEFAULT;
+
+  write_string (writer, oinfo->id);
+  write_string (writer, oinfo->class_name);
+  write_string (writer, klass != NULL ? g_type_name (gtype) : NULL);
+  write_string (writer, oinfo->type_func);
+  write_uint32 (writer, flags);
+  write_uint32 (writer, g_list_length (oinfo->properties));
+  write_uint32 (writer, g_list_length (oinfo->children));
+  write_uint32 (writer, g_list_length (oinfo->signals));
+
+  for (l = oinfo->properties; l != NULL; l = l->next)
+    {
+      PropertyInfo *pinfo = l->data;
+      GValue value = G_VALUE_INIT;
+      gboolean has_value = FALSE;
+
+      if (klass != NULL &&
+          !pinfo->is_child &&
+          !pinfo->is_layout &&
+          JSON_NODE_TYPE (pinfo->node) == JSON_NODE_VALUE)
+        {
+          GParamSpec *pspec;
+
+          pspec = _clutter_script_find_property (klass, pinfo->name);
+          if (pspec != NULL &&
+              is_compiled_value_type (G_PARAM_SPEC_VALUE_TYPE (pspec)))
+            has_value = _clutter_script_parse_node (script, &value,
+                                                    pinfo->name,
+                                                    pinfo->node,
+                                                    pspec);
+        }
+
+      write_string (writer, pinfo->name);
+      write_uint32 (writer, has_value ? PROPERTY_HAS_VALUE : 0);
+      write_node (writer, pinfo->node);
+
+      if (has_value)
+        {
+          write_value (writer, &value);
+          g_value_unset (&value);
+        }
+    }
+
+  for (l = oinfo->children; l != NULL; l = l->next)
+    write_string (writer, l->data);
+
+  for (l = oinfo->signals; l != NULL; l = l->next)
+    {
+      SignalInfo *sinfo = l->data;
+
+      flags = 0;
+      if (sinfo->is_handler)
+        flags |= SIGNAL_IS_HANDLER;
+      if (sinfo->warp_to)
+        flags |= SIGNAL_WARP_TO;
+
+      write_string (writer, sinfo->name);
+      write_string (writer, sinfo->handler);
+      write_string (writer, sinfo->object);
+      write_string (writer, sinfo->state);
+      write_string (writer, sinfo->target);
+      write_uint32 (writer, sinfo->flags);
+      write_uint32 (writer, flags);
+    }
+
+  if (klass != NULL)
+    g_type_class_unref (klass);
+}
+
+/*
+ * _clutter_script_binary_compile:
+ * @script: the #ClutterScript holding the definitions
+ * @objects: (element-type ObjectInfo): the definitions to compile,
+ *   in parsing order
+ *
+ * Serializes @objects in the compiled format.
+ *
+ * Return value: the compiled data
+ */
+GBytes *
+_clutter_script_binary_compile (ClutterScript *script,
+                                GPtrArray     *objects)
+{
+  Writer writer;
+  gchar *fake_id_prefix;
+  guint32 header[4];
+  guint i;
+
+  writer.data = g_byte_array_new ();
+  writer.strings = g_string_new_len ("", 1);
+  writer.string_offsets = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                 g_free,
+                                                 NULL);
+
+  /* see _clutter_script_generate_fake_id() */
+  fake_id_prefix = g_strdup_printf ("script-%d-",
+                                    _clutter_script_get_last_merge_id (script));
+
+  /* the header is filled in once we know the size of the objects */
+  g_byte_array_append (writer.data,
+                       (const guint8 *) COMPILED_MAGIC,
+                       COMPILED_MAGIC_LEN);
+  g_byte_array_set_size (writer.data, COMPILED_HEADER_SIZE);
+
+  for (i = 0; i < objects->len; i++)
+    write_object (&writer, script, g_ptr_array_index (objects, i),
+                  fake_id_prefix);
+
+  header[0] = GUINT32_TO_LE (COMPILED_VERSION);
+  header[1] = GUINT32_TO_LE (objects->len);
+  header[2] = GUINT32_TO_LE (writer.data->len);
+  header[3] = GUINT32_TO_LE (writer.strings->len);
+  memcpy (writer.data->data + COMPILED_MAGIC_LEN, header, sizeof (header));
+
+  g_byte_array_append (writer.data,
+                       (const guint8 *) writer.strings->str,
+                       writer.strings->len);
+
+  CLUTTER_NOTE (SCRIPT, "Compiled %u objects (%u bytes, %u of strings)",
+                objects->len,
+                writer.data->len,
+                (guint) writer.strings->len);
+
+  g_free (fake_id_prefix);
+  g_hash_table_destroy (writer.string_offsets);
+  g_string_free (writer.strings, TRUE);
+
+  return g_byte_array_free_to_bytes (writer.data);
+}
+
+static guint32
+read_uint32 (Reader *reader)
+{
+  guint32 value;
+
+  if (!reader->is_valid || reader->size - reader->pos < sizeof (value))
+    {
+      reader->is_valid = FALSE;
+      return 0;
+    }
+
+  memcpy (&value, reader->data + reader->pos, sizeof (value));
+  reader->pos += sizeof (value);
+
+  return GUINT32_FROM_LE (value);
+}
+
+static guint64
+read_uint64 (Reader *reader)
+{
+  guint64 lo = read_uint32 (reader);
+  guint64 hi = read_uint32 (reader);
+
+  return lo | (hi << 32);
+}
+
+static const gchar *
+lookup_string (Reader  *reader,
+               guint32  offset)
+{
+  if (offset == 0)
+    return NULL;
+
+  if (offset >= reader->strings_size)
+    {
+      reader->is_valid = FALSE;
+      return NULL;
+    }
+
+  return reader->strings + offset;
+}
+
+static const gchar *
+read_string (Reader *reader)
+{
+  return lookup_string (reader, read_uint32 (reader));
+}
+
+static const gchar *
+resolve_id (Reader      *reader,
+            const gchar *id)
+{
+  const gchar *fake_id;
+
+  if (id == NULL)
+    return NULL;
+
+  fake_id = g_hash_table_lookup (reader->fake_ids, id);
+
+  return fake_id != NULL ? fake_id : id;
+}
+
+static JsonNode *
+read_node (Reader *reader,
+           guint   depth)
+{
+  JsonNode *node = NULL;
+  guint32 i, n_items;
+
+  if (depth > MAX_NODE_DEPTH)
+    {
+      reader->is_valid = FALSE;
+      return NULL;
+    }
+
+  switch (read_uint32 (reader))
+    {
+    case NODE_NULL:
+      node = json_node_new (JSON_NODE_NULL);
+      break;
+
+    case NODE_BOOLEAN:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_boolean (node, read_uint32 (reader) != 0);
+      break;
+
+    case NODE_INT:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, (gint64) read_uint64 (reader));
+      break;
+
+    case NODE_DOUBLE:
+      {
+        DoubleBits bits;
+
+        bits.u = read_uint64 (reader);
+
+        node = json_node_new (JSON_NODE_VALUE);
+        json_node_set_double (node, bits.d);
+      }
+      break;
+
+    case NODE_STRING:
+      {
+        const gchar *str = read_string (reader);
+
+        node = json_node_new (JSON_NODE_VALUE);
+        json_node_set_string (node, str != NULL ? str : "");
+      }
+      break;
+
+    case NODE_ARRAY:
+      {
+        JsonArray *array = json_array_new ();
+
+        n_items = read_uint32 (reader);
+        for (i = 0; i < n_items && reader->is_valid; i++)
+          {
+            JsonNode *element = read_node (reader, depth + 1);
+
+            if (element != NULL)
+              json_array_add_element (array, element);
+          }
+
+        node = json_node_new (JSON_NODE_ARRAY);
+        json_node_take_array (node, array);
+      }
+      break;
+
+    case NODE_OBJECT:
+      {
+        JsonObject *object = json_object_new ();
+
+        n_items = read_uint32 (reader);
+        for (i = 0; i < n_items && reader->is_valid; i++)
+          {
+            const gchar *member = read_string (reader);
+            JsonNode *child = read_node (reader, depth + 1);
+
+            if (member == NULL || child == NULL)
+              {
+                if (child != NULL)
+                  json_node_free (child);
+
+                reader->is_valid = FALSE;
+                break;
+              }
+
+            /* objects defined inline are referenced by their id, which
+             * we might have replaced when loading
+             */
+            if (strcmp (member, "id") == 0 &&
+                JSON_NODE_HOLDS_VALUE (child) &&
+                json_node_get_value_type (child) == G_TYPE_STRING)
+              {
+                const gchar *fake_id;
+
+                fake_id = g_hash_table_lookup (reader->fake_ids,
+                                               json_node_get_string (child));
+                if (fake_id != NULL)
+                  json_node_set_string (child, fake_id);
+              }
+
+            json_object_set_member (object, member, child);
+          }
+
+        node = json_node_new (JSON_NODE_OBJECT);
+        json_node_take_object (node, object);
+      }
+      break;
+
+    default:
+      reader->is_valid = FALSE;
+      break;
+    }
+
+  if (!reader->is_valid && node != NULL)
+    {
+      json_node_free (node);
+      node = NULL;
+    }
+
+  return node;
+}
+
+static gboolean
+read_value (Reader *reader,
+            GValue *value)
+{
+  GType value_type;
+  DoubleBits bits;
+
+  value_type = G_TYPE_MAKE_FUNDAMENTAL (read_uint32 (reader));
+  bits.u = read_uint64 (reader);
+
+  if (!reader->is_valid)
+    return FALSE;
+
+  switch (value_type)
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+    case G_TYPE_STRING:
+      g_value_init (value, value_type);
+      break;
+
+    default:
+      reader->is_valid = FALSE;
+      return FALSE;
+    }
+
+  switch (value_type)
+    {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean (value, bits.u != 0);
+      break;
+
+    case G_TYPE_CHAR:
+      g_value_set_schar (value, (gint8) bits.u);
+      break;
+
+    case G_TYPE_UCHAR:
+      g_value_set_uchar (value, (guchar) bits.u);
+      break;
+
+    case G_TYPE_INT:
+      g_value_set_int (value, (gint) bits.u);
+      break;
+
+    case G_TYPE_UINT:
+      g_value_set_uint (value, (guint) bits.u);
+      break;
+
+    case G_TYPE_LONG:
+      g_value_set_long (value, (glong) bits.u);
+      break;
+
+    case G_TYPE_ULONG:
+      g_value_set_ulong (value, (gulong) bits.u);
+      break;
+
+    case G_TYPE_INT64:
+      g_value_set_int64 (value, (gint64) bits.u);
+      break;
+
+    case G_TYPE_UINT64:
+      g_value_set_uint64 (value, bits.u);
+      break;
+
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, bits.d);
+      break;
+
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, bits.d);
+      break;
+
+    case G_TYPE_STRING:
+      g_value_set_string (value, lookup_string (reader, bits.u & 0xffffffff));
+      break;
+    }
+
+  if (!reader->is_valid)
+    {
+      g_value_unset (value);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+static ObjectInfo *
+read_object (Reader        *reader,
+             ClutterScript *script)
+{
+  const gchar *id, *class_name, *type_name, *type_func;
+  guint32 flags, n_properties, n_children, n_signals, i;
+  ObjectInfo *oinfo;
+
+  id = read_string (reader);
+  class_name = read_string (reader);
+  type_name = read_string (reader);
+  type_func = read_string (reader);
+  flags = read_uint32 (reader);
+  n_properties = read_uint32 (reader);
+  n_children = read_uint32 (reader);
+  n_signals = read_uint32 (reader);
+
+  if (id == NULL || class_name == NULL)
+    reader->is_valid = FALSE;
+
+  if (!reader->is_valid)
+    return NULL;
+
+  oinfo = g_slice_new0 (ObjectInfo);
+  oinfo->merge_id = _clutter_script_get_last_merge_id (script);
+  oinfo->class_name = g_strdup (class_name);
+  oinfo->type_func = g_strdup (type_func);
+  oinfo->has_unresolved = TRUE;
+
+  /* objects without an id get a new one, unique inside @script */
+  if (flags & OBJECT_ANONYMOUS)
+    {
+      oinfo->id = _clutter_script_generate_fake_id (script);
+      g_hash_table_insert (reader->fake_ids, (gpointer) id, oinfo->id);
+    }
+  else
+    oinfo->id = g_strdup (id);
+
+  if (flags & OBJECT_STAGE_DEFAULT)
+    {
+      oinfo->is_actor = TRUE;
+      oinfo->is_stage = TRUE;
+      oinfo->is_stage_default = TRUE;
+    }
+
+  /* if the type has already been registered we don't need to look up
+   * its type function
+   */
+  if (type_name != NULL)
+    oinfo->gtype = g_type_from_name (type_name);
+
+  for (i = 0; i < n_properties && reader->is_valid; i++)
+    {
+      const gchar *name = read_string (reader);
+      guint32 property_flags = read_uint32 (reader);
+      JsonNode *node = read_node (reader, 0);
+      PropertyInfo *pinfo;
+
+      if (name == NULL || node == NULL)
+        {
+          if (node != NULL)
+            json_node_free (node);
+
+          reader->is_valid = FALSE;
+          break;
+        }
+
+      pinfo = g_slice_new0 (PropertyInfo);
+      pinfo->name = g_strdup (name);
+      pinfo->node = node;
+      pinfo->is_child = g_str_has_prefix (name, "child::") ? TRUE : FALSE;
+      pinfo->is_layout = g_str_has_prefix (name, "layout::") ? TRUE : FALSE;
+
+      if (property_flags & PROPERTY_HAS_VALUE)
+        pinfo->has_value = read_value (reader, &pinfo->value);
+
+      oinfo->properties = g_list_prepend (oinfo->properties, pinfo);
+    }
+
+  oinfo->properties = g_list_reverse (oinfo->properties);
+
+  for (i = 0; i < n_children && reader->is_valid; i++)
+    {
+      const gchar *child_id = resolve_id (reader, read_string (reader));
+
+      if (child_id == NULL)
+        {
+          reader->is_valid = FALSE;
+          break;
+        }
+
+      oinfo->children = g_list_prepend (oinfo->children, g_strdup (child_id));
+    }
+
+  oinfo->children = g_list_reverse (oinfo->children);
+
+  for (i = 0; i < n_signals && reader->is_valid; i++)
+    {
+      SignalInfo *sinfo;
+      guint32 signal_flags;
+
+      sinfo = g_slice_new0 (SignalInfo);
+      sinfo->name = g_strdup (read_string (reader));
+      sinfo->handler = g_strdup (read_string (reader));
+      sinfo->object = g_strdup (read_string (reader));
+      sinfo->state = g_strdup (read_string (reader));
+      sinfo->target = g_strdup (read_string (reader));
+      sinfo->flags = read_uint32 (reader);
+
+      signal_flags = read_uint32 (reader);
+      sinfo->is_handler = (signal_flags & SIGNAL_IS_HANDLER) != 0;
+      sinfo->warp_to = (signal_flags & SIGNAL_WARP_TO) != 0;
+
+      oinfo->signals = g_list_prepend (oinfo->signals, sinfo);
+
+      if (sinfo->name == NULL)
+        reader->is_valid = FALSE;
+    }
+
+  oinfo->signals = g_list_reverse (oinfo->signals);
+
+  if (!reader->is_valid)
+    {
+      object_info_free (oinfo);
+      return NULL;
+    }
+
+  return oinfo;
+}
+
+/* like the parser, redefinitions of an object are merged into it */
+static void
+merge_object_info (ObjectInfo *oinfo,
+                   ObjectInfo *new_info)
+{
+  oinfo->properties = g_list_concat (oinfo->properties, new_info->properties);
+  oinfo->children = g_list_concat (oinfo->children, new_info->children);
+  oinfo->signals = g_list_concat (oinfo->signals, new_info->signals);
+  oinfo->has_unresolved = TRUE;
+
+  new_info->properties = NULL;
+  new_info->children = NULL;
+  new_info->signals = NULL;
+
+  object_info_free (new_info);
+}
+
+/*
+ * _clutter_script_binary_load:
+ * @script: a #ClutterScript
+ * @data: the compiled data
+ * @size: the size of @data
+ * @error: return location for a #GError, or %NULL
+ *
+ * Adds the definitions compiled by _clutter_script_binary_compile()
+ * to @script, and constructs their objects unless @script constructs
+ * them lazily. Nothing is added if @data is not valid.
+ *
+ * Return value: %TRUE if the definitions were loaded
+ */
+gboolean
+_clutter_script_binary_load (ClutterScript  *script,
+                             const guint8   *data,
+                             gsize           size,
+                             GError        **error)
+{
+  guint32 version, n_objects, strings_offset, strings_size, i;
+  GPtrArray *objects;
+  Reader reader;
+
+  if (size < COMPILED_HEADER_SIZE ||
+      memcmp (data, COMPILED_MAGIC, COMPILED_MAGIC_LEN) != 0)
+    {
+      g_set_error_literal (error, CLUTTER_SCRIPT_ERROR,
+                           CLUTTER_SCRIPT_ERROR_INVALID_COMPILED_DATA,
+                           _("The data is not a compiled UI definition"));
+      return FALSE;
+    }
+
+  memset (&reader, 0, sizeof (reader));
+  reader.data = data;
+  reader.size = size;
+  reader.pos = COMPILED_MAGIC_LEN;
+  reader.is_valid = TRUE;
+
+  version = read_uint32 (&reader);
+  n_objects = read_uint32 (&reader);
+  strings_offset = read_uint32 (&reader);
+  strings_size = read_uint32 (&reader);
+
+  if (version != COMPILED_VERSION)
+    {
+      g_set_error (error, CLUTTER_SCRIPT_ERROR,
+                   CLUTTER_SCRIPT_ERROR_INVALID_COMPILED_DATA,
+                   _("Unsupported version %u of the compiled UI "
+                     "definition format"),
+                   version);
+      return FALSE;
+    }
+
+  if (strings_offset < COMPILED_HEADER_SIZE ||
+      strings_offset > size ||
+      strings_size == 0 ||
+      size - strings_offset < strings_size ||
+      data[strings_offset + strings_size - 1] != '\0')
+    goto corrupted;
+
+  /* the objects end where the strings start */
+  reader.size = strings_offset;
+  reader.strings = (const gchar *) data + strings_offset;
+  reader.strings_size = strings_size;
+  reader.fake_ids = g_hash_table_new (g_str_hash, g_str_equal);
+
+  objects = g_ptr_array_new ();
+
+  for (i = 0; i < n_objects; i++)
+    {
+      ObjectInfo *oinfo = read_object (&reader, script);
+
+      if (oinfo == NULL)
+        break;
+
+      g_ptr_array_add (objects, oinfo);
+    }
+
+  g_hash_table_destroy (reader.fake_ids);
+
+  if (!reader.is_valid)
+    {
+      g_ptr_array_foreach (objects, (GFunc) object_info_free, NULL);
+      g_ptr_array_free (objects, TRUE);
+      goto corrupted;
+    }
+
+  for (i = 0; i < objects->len; i++)
+    {
+      ObjectInfo *oinfo = g_ptr_array_index (objects, i);
+      ObjectInfo *existing;
+
+      CLUTTER_NOTE (SCRIPT,
+                    "Added compiled object '%s' (type:%s, id:%d, props:%d, signals:%d)",
+                    oinfo->id,
+                    oinfo->class_name,
+                    oinfo->merge_id,
+                    g_list_length (oinfo->properties),
+                    g_list_length (oinfo->signals));
+
+      existing = _clutter_script_get_object_info (script, oinfo->id);
+      if (existing != NULL)
+        {
+          merge_object_info (existing, oinfo);
+          oinfo = existing;
+        }
+      else
+        _clutter_script_add_object_info (script, oinfo);
+
+      if (!_clutter_script_is_lazy (script))
+        _clutter_script_construct_object (script, oinfo);
+    }
+
+  g_ptr_array_free (objects, TRUE);
+
+  return TRUE;
+
+corrupted:
+  g_set_error_literal (error, CLUTTER_SCRIPT_ERROR,
+                       CLUTTER_SCRIPT_ERROR_INVALID_COMPILED_DATA,
+                       _("The compiled UI definition is corrupted"));
+  return FALSE;
+}
@@ -0,0 +1,99 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+
+/* clutter-script-compiler: compiles the ClutterScript UI definitions
+ * into the format loaded by clutter_script_load_from_compiled_file().
+ *
+ * Only the types known to Clutter can be resolved ahead of time; the
+ * objects using types defined by the application are still resolved,
+ * and their properties converted, when loading the compiled file.
+ */
+
+#include <stdlib.h>
+
+#include <clutter/clutter.h>
+
+static gchar *output_file = NULL;
+static gchar **input_files = NULL;
+
+static GOptionEntry entries[] = {
+  {
+    "output", 'o',
+    0,
+    G_OPTION_ARG_FILENAME, &output_file,
+    "Write the compiled definitions to FILE", "FILE"
+  },
+  {
+    G_OPTION_REMAINING, 0,
+    0,
+    G_OPTION_ARG_FILENAME_ARRAY, &input_files,
+    NULL, NULL
+  },
+  { NULL }
+};
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context;
+  ClutterScript *script;
+  GError *error = NULL;
+  int retval = EXIT_SUCCESS;
+
+  context = g_option_context_new ("FILE - compile a ClutterScript UI definition");
+  g_option_context_add_main_entries (context, entries, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      g_option_context_free (context);
+      return EXIT_FAILURE;
+    }
+
+  if (input_files == NULL || input_files[0] == NULL || input_files[1] != NULL ||
+      output_file == NULL)
+    {
+      gchar *help = g_option_context_get_help (context, TRUE, NULL);
+
+      g_printerr ("%s", help);
+      g_free (help);
+      g_option_context_free (context);
+      return EXIT_FAILURE;
+    }
+
+  g_option_context_free (context);
+
+  script = clutter_script_new ();
+
+  if (!clutter_script_compile_file (script, input_files[0], output_file, &error))
+    {
+      g_printerr ("%s: %s\n", input_files[0], error->message);
+      g_error_free (error);
+      retval = EXIT_FAILURE;
+    }
+
+  g_object_unref (script);
+  g_strfreev (input_files);
+  g_free (output_file);
+
+  return retval;
+}
@@ -72,6 +72,160 @@ clutter_script_parser_init (ClutterScriptParser *parser)
 {
 }
 
+/* process-wide caches of the types and properties resolved by the
+ * parser, shared by every ClutterScript instance; types are never
+ * unregistered, so we only need to cache the successful look ups of
+ * the types, while the properties of a class never change after its
+ * initialization, so we cache the failed look ups as well
+ */
+typedef struct {
+  /* type function or class name -> GType */
+  GHashTable *types_by_symbol;
+  GHashTable *types_by_class;
+
+  /* GType -> (property name -> GParamSpec, or NULL) */
+  GHashTable *properties;
+
+  guint type_hits;
+  guint type_misses;
+  guint property_hits;
+  guint property_misses;
+} ScriptCache;
+
+G_LOCK_DEFINE_STATIC (script_cache);
+static ScriptCache script_cache;
+
+static GType
+script_cache_lookup_type (GHashTable  **types,
+                          const gchar  *name)
+{
+  gpointer gtype = NULL;
+
+  G_LOCK (script_cache);
+
+  if (*types != NULL)
+    gtype = g_hash_table_lookup (*types, name);
+
+  if (gtype != NULL)
+    script_cache.type_hits += 1;
+  else
+    {
+      script_cache.type_misses += 1;
+
+      CLUTTER_NOTE (SCRIPT, "Type cache miss for '%s' (hits: %u, misses: %u)",
+                    name,
+                    script_cache.type_hits,
+                    script_cache.type_misses);
+    }
+
+  G_UNLOCK (script_cache);
+
+  return (GType) GPOINTER_TO_SIZE (gtype);
+}
+
+static void
+script_cache_add_type (GHashTable  **types,
+                       const gchar  *name,
+                       GType         gtype)
+{
+  if (gtype == G_TYPE_INVALID)
+    return;
+
+  G_LOCK (script_cache);
+
+  if (*types == NULL)
+    *types = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  g_hash_table_replace (*types, g_strdup (name), GSIZE_TO_POINTER (gtype));
+
+  G_UNLOCK (script_cache);
+}
+
+static void
+script_cache_pspec_unref (gpointer data)
+{
+  if (data != NULL)
+    g_param_spec_unref (data);
+}
+
+/*
+ * _clutter_script_find_property:
+ * @klass: a #GObjectClass
+ * @name: the name of a property
+ *
+ * Looks up the property @name of @klass, like g_object_class_find_property(),
+ * using the process-wide cache of properties of ClutterScript.
+ *
+ * Return value: (transfer none): the #GParamSpec, or %NULL
+ */
+GParamSpec *
+_clutter_script_find_property (GObjectClass *klass,
+                               const gchar  *name)
+{
+  GType gtype = G_OBJECT_CLASS_TYPE (klass);
+  GHashTable *class_properties = NULL;
+  GParamSpec *pspec = NULL;
+  gboolean found = FALSE;
+
+  G_LOCK (script_cache);
+
+  if (script_cache.properties != NULL)
+    class_properties = g_hash_table_lookup (script_cache.properties,
+                                            GSIZE_TO_POINTER (gtype));
+
+  if (class_properties != NULL)
+    found = g_hash_table_lookup_extended (class_properties, name,
+                                          NULL,
+                                          (gpointer *) &pspec);
+
+  if (found)
+    {
+      script_cache.property_hits += 1;
+
+      G_UNLOCK (script_cache);
+
+      return pspec;
+    }
+
+  script_cache.property_misses += 1;
+
+  CLUTTER_NOTE (SCRIPT, "Property cache miss for '%s:%s' (hits: %u, misses: %u)",
+                g_type_name (gtype),
+                name,
+                script_cache.property_hits,
+                script_cache.property_misses);
+
+  /* the GParamSpec is owned by the class; we keep a reference for
+   * dynamic types, which can be unloaded
+   */
+  pspec = g_object_class_find_property (klass, name);
+
+  if (script_cache.properties == NULL)
+    script_cache.properties =
+      g_hash_table_new_full (NULL, NULL,
+                             NULL,
+                             (GDestroyNotify) g_hash_table_unref);
+
+  if (class_properties == NULL)
+    {
+      class_properties =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free,
+                               script_cache_pspec_unref);
+      g_hash_table_insert (script_cache.properties,
+                           GSIZE_TO_POINTER (gtype),
+                           class_properties);
+    }
+
+  g_hash_table_insert (class_properties,
+                       g_strdup (name),
+                       pspec != NULL ? g_param_spec_ref (pspec) : NULL);
+
+  G_UNLOCK (script_cache);
+
+  return pspec;
+}
+
 GType
 _clutter_script_get_type_from_symbol (const gchar *symbol)
 {
@@ -79,12 +233,18 @@ _clutter_script_get_type_from_symbol (const gchar *symbol)
   GTypeGetFunc func;
   GType gtype = G_TYPE_INVALID;
 
+  gtype = script_cache_lookup_type (&script_cache.types_by_symbol, symbol);
+  if (gtype != G_TYPE_INVALID)
+    return gtype;
+
   if (!module)
     module = g_module_open (NULL, 0);
   
   if (g_module_symbol (module, symbol, (gpointer)&func))
     gtype = func ();
-  
+
+  script_cache_add_type (&script_cache.types_by_symbol, symbol, gtype);
+
   return gtype;
 }
 
@@ -98,6 +258,13 @@ _clutter_script_get_type_from_class (const gchar *name)
   gchar *symbol;
   gint i;
 
+  gtype = script_cache_lookup_type (&script_cache.types_by_class, name);
+  if (gtype != G_TYPE_INVALID)
+    {
+      g_string_free (symbol_name, TRUE);
+      return gtype;
+    }
+
   if (G_UNLIKELY (!module))
     module = g_module_open (NULL, 0);
   
@@ -149,6 +316,8 @@ _clutter_script_get_type_from_class (const gchar *name)
   
   g_free (symbol);
 
+  script_cache_add_type (&script_cache.types_by_class, name, gtype);
+
   return gtype;
 }
 
@@ -1166,7 +1335,7 @@ clutter_script_parser_object_end (JsonParser *json_parser,
           continue;
         }
 
-      pinfo = g_slice_new (PropertyInfo);
+      pinfo = g_slice_new0 (PropertyInfo);
 
       pinfo->name = g_strdup (name);
       pinfo->node = json_node_copy (node);
@@ -1189,13 +1358,69 @@ clutter_script_parser_object_end (JsonParser *json_parser,
                 g_list_length (oinfo->signals));
 
   _clutter_script_add_object_info (script, oinfo);
-  _clutter_script_construct_object (script, oinfo);
+
+  /* when compiling, merging, or constructing lazily, we only collect
+   * the definitions
+   */
+  if (!_clutter_script_is_collecting (script) &&
+      !_clutter_script_is_lazy (script))
+    _clutter_script_construct_object (script, oinfo);
 }
 
 static void
 clutter_script_parser_parse_end (JsonParser *parser)
 {
-  clutter_script_ensure_objects (CLUTTER_SCRIPT_PARSER (parser)->script);
+  ClutterScript *script = CLUTTER_SCRIPT_PARSER (parser)->script;
+
+  if (!_clutter_script_is_collecting (script) &&
+      !_clutter_script_is_lazy (script))
+    clutter_script_ensure_objects (script);
+}
+
+/*
+ * _clutter_script_parser_add_node:
+ * @parser: a #ClutterScriptParser
+ * @node: the root of a JSON tree
+ *
+ * Adds the object definitions inside @node, which has been parsed by
+ * another #JsonParser, as if @parser had parsed them itself.
+ *
+ * The objects are visited in the same order as #JsonParser::object-end
+ * is emitted, that is the inner objects come before their container.
+ */
+void
+_clutter_script_parser_add_node (ClutterScriptParser *parser,
+                                 JsonNode            *node)
+{
+  GList *elements, *l;
+
+  switch (JSON_NODE_TYPE (node))
+    {
+    case JSON_NODE_OBJECT:
+      {
+        JsonObject *object = json_node_get_object (node);
+
+        elements = json_object_get_values (object);
+        for (l = elements; l != NULL; l = l->next)
+          _clutter_script_parser_add_node (parser, l->data);
+
+        g_list_free (elements);
+
+        clutter_script_parser_object_end (JSON_PARSER (parser), object);
+      }
+      break;
+
+    case JSON_NODE_ARRAY:
+      elements = json_array_get_elements (json_node_get_array (node));
+      for (l = elements; l != NULL; l = l->next)
+        _clutter_script_parser_add_node (parser, l->data);
+
+      g_list_free (elements);
+      break;
+
+    default:
+      break;
+    }
 }
 
 gboolean
@@ -1301,7 +1526,17 @@ _clutter_script_parse_node (ClutterScript *script,
                 return FALSE;
 
               oinfo = _clutter_script_get_object_info (script, id_);
-              if (oinfo == NULL || oinfo->gtype == G_TYPE_INVALID )
+              if (oinfo == NULL)
+                return FALSE;
+
+              /* objects are not constructed while parsing when
+               * constructing lazily, so the type is not resolved yet
+               */
+              if (oinfo->gtype == G_TYPE_INVALID &&
+                  _clutter_script_is_lazy (script))
+                _clutter_script_construct_object (script, oinfo);
+
+              if (oinfo->gtype == G_TYPE_INVALID)
                 return FALSE;
 
               if (g_type_is_a (oinfo->gtype, p_type))
@@ -1309,10 +1544,14 @@ _clutter_script_parse_node (ClutterScript *script,
                   /* force construction, even though it should
                    * not be necessary; we don't need the properties
                    * to be applied as well: they will when the
-                   * ScriptParser finishes
+                   * ScriptParser finishes, unless we are constructing
+                   * lazily
                    */
                   _clutter_script_construct_object (script, oinfo);
 
+                  if (_clutter_script_is_lazy (script))
+                    _clutter_script_apply_properties (script, oinfo);
+
                   g_value_set_object (value, oinfo->object);
 
                   return TRUE;
@@ -1633,6 +1872,44 @@ _clutter_script_parse_node (ClutterScript *script,
   return retval;
 }
 
+/* retrieves the value converted when compiling the script, if the
+ * type of the property matches the one we had at compile time
+ */
+static gboolean
+property_info_get_value (PropertyInfo *pinfo,
+                         GValue       *value)
+{
+  GType value_type;
+
+  if (!pinfo->has_value || pinfo->pspec == NULL)
+    return FALSE;
+
+  value_type = G_PARAM_SPEC_VALUE_TYPE (pinfo->pspec);
+
+  /* enumerations and flags are stored as plain integers, so that we
+   * don't need their types to be registered when loading
+   */
+  if (G_TYPE_IS_ENUM (value_type) && G_VALUE_HOLDS_INT (&pinfo->value))
+    {
+      g_value_init (value, value_type);
+      g_value_set_enum (value, g_value_get_int (&pinfo->value));
+    }
+  else if (G_TYPE_IS_FLAGS (value_type) && G_VALUE_HOLDS_UINT (&pinfo->value))
+    {
+      g_value_init (value, value_type);
+      g_value_set_flags (value, g_value_get_uint (&pinfo->value));
+    }
+  else if (G_VALUE_HOLDS (&pinfo->value, value_type))
+    {
+      g_value_init (value, value_type);
+      g_value_copy (&pinfo->value, value);
+    }
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
 static GList *
 clutter_script_translate_parameters (ClutterScript  *script,
                                      GObject        *object,
@@ -1682,6 +1959,9 @@ clutter_script_translate_parameters (ClutterScript  *script,
                                         pinfo->name,
                                         pinfo->node);
 
+      if (!res)
+        res = property_info_get_value (pinfo, &param.value);
+
       if (!res)
         res = _clutter_script_parse_node (script, &param.value,
                                           pinfo->name,
@@ -1735,7 +2015,7 @@ clutter_script_construct_parameters (ClutterScript  *script,
        * class we just skip it and let the class itself deal
        * with it later on
        */
-      pspec = g_object_class_find_property (klass, pinfo->name);
+      pspec = _clutter_script_find_property (klass, pinfo->name);
       if (pspec)
         pinfo->pspec = g_param_spec_ref (pspec);
       else
@@ -1751,9 +2031,8 @@ clutter_script_construct_parameters (ClutterScript  *script,
           continue;
         }
 
-      param.name = g_strdup (pinfo->name);
-
-      if (!_clutter_script_parse_node (script, &param.value,
+      if (!property_info_get_value (pinfo, &param.value) &&
+          !_clutter_script_parse_node (script, &param.value,
                                        pinfo->name,
                                        pinfo->node,
                                        pinfo->pspec))
@@ -1762,6 +2041,8 @@ clutter_script_construct_parameters (ClutterScript  *script,
           continue;
         }
 
+      param.name = g_strdup (pinfo->name);
+
       g_array_append_val (*construct_params, param);
 
       property_info_free (pinfo);
@@ -2021,6 +2302,12 @@ add_children (ClutterScript *script,
                     g_type_name (G_OBJECT_TYPE (container)));
 
       clutter_container_add_actor (container, CLUTTER_ACTOR (object));
+
+      /* when constructing lazily, nothing else is going to set up the
+       * children, so we do it now that they have a parent
+       */
+      if (_clutter_script_is_lazy (script))
+        _clutter_script_apply_properties (script, child_info);
     }
 
   g_list_foreach (oinfo->children, (GFunc) g_free, NULL);
@@ -2033,7 +2320,9 @@ static inline void
 _clutter_script_check_unresolved (ClutterScript *script,
                                   ObjectInfo    *oinfo)
 {
-  if (oinfo->children != NULL && CLUTTER_IS_CONTAINER (oinfo->object))
+  if (oinfo->children != NULL &&
+      CLUTTER_IS_CONTAINER (oinfo->object) &&
+      !_clutter_script_defer_children (script, oinfo))
     add_children (script, oinfo);
 
   /* this is a bit *eugh*, but it allows us to effectively make sure
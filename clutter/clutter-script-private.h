@@ -66,6 +66,9 @@ typedef struct {
 
   guint merge_id;
 
+  /* the children waiting for the actor to be added to a stage */
+  gpointer deferred_children;
+
   guint is_actor         : 1;
   guint is_stage         : 1;
   guint is_stage_default : 1;
@@ -80,8 +83,12 @@ typedef struct {
   JsonNode *node;
   GParamSpec *pspec;
 
+  /* pre-converted value, set when loading a compiled script */
+  GValue value;
+
   guint is_child : 1;
   guint is_layout : 1;
+  guint has_value : 1;
 } PropertyInfo;
 
 typedef struct {
@@ -101,6 +108,9 @@ void property_info_free (gpointer data);
 
 GType _clutter_script_parser_get_type (void) G_GNUC_CONST;
 
+void _clutter_script_parser_add_node (ClutterScriptParser *parser,
+                                      JsonNode            *node);
+
 gboolean _clutter_script_parse_node        (ClutterScript *script,
                                             GValue        *value,
                                             const gchar   *name,
@@ -110,6 +120,9 @@ gboolean _clutter_script_parse_node        (ClutterScript *script,
 GType    _clutter_script_get_type_from_symbol (const gchar *symbol);
 GType    _clutter_script_get_type_from_class  (const gchar *name);
 
+GParamSpec *_clutter_script_find_property (GObjectClass *klass,
+                                           const gchar  *name);
+
 gulong   _clutter_script_resolve_animation_mode (JsonNode *node);
 
 gboolean _clutter_script_enum_from_string  (GType          gtype,
@@ -165,6 +178,12 @@ guint _clutter_script_get_last_merge_id (ClutterScript *script);
 void _clutter_script_add_object_info (ClutterScript *script,
                                       ObjectInfo    *oinfo);
 
+gboolean _clutter_script_is_collecting (ClutterScript *script);
+gboolean _clutter_script_is_lazy       (ClutterScript *script);
+
+gboolean _clutter_script_defer_children (ClutterScript *script,
+                                         ObjectInfo    *oinfo);
+
 const gchar *_clutter_script_get_id_from_node (JsonNode *node);
 
 G_END_DECLS
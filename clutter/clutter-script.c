@@ -217,6 +217,12 @@
  *                   of creating a new #ClutterStage instance
  * ]]></programlisting>
  *
+ * UI definitions can also be compiled ahead of time, using
+ * clutter_script_compile_file() or the clutter-script-compiler tool,
+ * into a binary format that clutter_script_load_from_compiled_file()
+ * loads without parsing JSON, and with the types, the property names
+ * and the values of the simple properties already resolved.
+ *
  * #ClutterScript is available since Clutter 0.6
  */
 
@@ -236,10 +242,12 @@
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 
 #include "clutter-actor.h"
+#include "clutter-actor-private.h"
 #include "clutter-stage.h"
 #include "clutter-texture.h"
 
 #include "clutter-script.h"
+#include "clutter-script-binary.h"
 #include "clutter-script-private.h"
 #include "clutter-scriptable.h"
 
@@ -259,6 +267,7 @@ enum
   PROP_FILENAME_SET,
   PROP_FILENAME,
   PROP_TRANSLATION_DOMAIN,
+  PROP_LAZY_CONSTRUCTION,
 
   PROP_LAST
 };
@@ -284,8 +293,28 @@ struct _ClutterScriptPrivate
 
   gchar *filename;
   guint is_filename : 1;
+
+  /* the definitions, in parsing order, when compiling */
+  GPtrArray *compiled_objects;
+  guint is_compiling : 1;
+
+  guint is_lazy : 1;
+  guint is_ensuring : 1;
+  guint is_merging : 1;
 };
 
+typedef struct {
+  ClutterScript *script;
+  ObjectInfo *oinfo;
+
+  /* the top-level ancestor of the actor, if it has a parent */
+  ClutterActor *root;
+
+  gulong parent_set_id;
+  gulong mapped_id;
+  gulong root_parent_set_id;
+} DeferredChildren;
+
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterScript, clutter_script, G_TYPE_OBJECT)
 
 static GType
@@ -314,6 +343,9 @@ property_info_free (gpointer data)
       if (pinfo->pspec)
         g_param_spec_unref (pinfo->pspec);
 
+      if (pinfo->has_value)
+        g_value_unset (&pinfo->value);
+
       g_free (pinfo->name);
 
       g_slice_free (PropertyInfo, pinfo);
@@ -337,6 +369,76 @@ signal_info_free (gpointer data)
     }
 }
 
+static void
+deferred_children_unwatch_root (DeferredChildren *deferred)
+{
+  if (deferred->root == NULL)
+    return;
+
+  g_signal_handler_disconnect (deferred->root, deferred->root_parent_set_id);
+  g_object_remove_weak_pointer (G_OBJECT (deferred->root),
+                                (gpointer *) &deferred->root);
+
+  deferred->root = NULL;
+  deferred->root_parent_set_id = 0;
+}
+
+static void
+deferred_children_free (DeferredChildren *deferred)
+{
+  GObject *object = deferred->oinfo->object;
+
+  deferred_children_unwatch_root (deferred);
+
+  g_signal_handler_disconnect (object, deferred->parent_set_id);
+  g_signal_handler_disconnect (object, deferred->mapped_id);
+
+  deferred->oinfo->deferred_children = NULL;
+
+  g_slice_free (DeferredChildren, deferred);
+}
+
+static void
+deferred_children_update (DeferredChildren *deferred)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (deferred->oinfo->object);
+  ClutterActor *root, *parent;
+
+  if (clutter_actor_get_stage (actor) != NULL)
+    {
+      CLUTTER_NOTE (SCRIPT, "Adding the deferred children of '%s'",
+                    deferred->oinfo->id);
+
+      /* this will add the children, and free @deferred */
+      _clutter_script_apply_properties (deferred->script, deferred->oinfo);
+      return;
+    }
+
+  /* the actor has been added to a tree outside of a stage, so we need
+   * to know when the root of that tree is added to a stage
+   */
+  root = NULL;
+  for (parent = clutter_actor_get_parent (actor);
+       parent != NULL;
+       parent = clutter_actor_get_parent (parent))
+    root = parent;
+
+  if (root == deferred->root)
+    return;
+
+  deferred_children_unwatch_root (deferred);
+
+  if (root != NULL)
+    {
+      deferred->root = root;
+      g_object_add_weak_pointer (G_OBJECT (root), (gpointer *) &deferred->root);
+      deferred->root_parent_set_id =
+        g_signal_connect_swapped (root, "parent-set",
+                                  G_CALLBACK (deferred_children_update),
+                                  deferred);
+    }
+}
+
 void
 object_info_free (gpointer data)
 {
@@ -358,6 +460,9 @@ object_info_free (gpointer data)
       g_list_foreach (oinfo->children, (GFunc) g_free, NULL);
       g_list_free (oinfo->children);
 
+      if (oinfo->deferred_children != NULL)
+        deferred_children_free (oinfo->deferred_children);
+
       /* we unref top-level objects and leave the actors alone,
        * unless we are unmerging in which case we have to destroy
        * the actor to unparent them
@@ -391,6 +496,9 @@ clutter_script_finalize (GObject *gobject)
   g_hash_table_destroy (priv->states);
   g_free (priv->translation_domain);
 
+  if (priv->compiled_objects != NULL)
+    g_ptr_array_unref (priv->compiled_objects);
+
   G_OBJECT_CLASS (clutter_script_parent_class)->finalize (gobject);
 }
 
@@ -408,6 +516,10 @@ clutter_script_set_property (GObject      *gobject,
       clutter_script_set_translation_domain (script, g_value_get_string (value));
       break;
 
+    case PROP_LAZY_CONSTRUCTION:
+      clutter_script_set_lazy_construction (script, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -436,6 +548,10 @@ clutter_script_get_property (GObject    *gobject,
       g_value_set_string (value, script->priv->translation_domain);
       break;
 
+    case PROP_LAZY_CONSTRUCTION:
+      g_value_set_boolean (value, script->priv->is_lazy);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -498,6 +614,22 @@ clutter_script_class_init (ClutterScriptClass *klass)
                          NULL,
                          CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterScript:lazy-construction:
+   *
+   * Whether the objects are constructed only when they are requested.
+   *
+   * See clutter_script_set_lazy_construction().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_LAZY_CONSTRUCTION] =
+    g_param_spec_boolean ("lazy-construction",
+                          P_("Lazy Construction"),
+                          P_("Whether the objects are constructed only when requested"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
   gobject_class->set_property = clutter_script_set_property;
   gobject_class->get_property = clutter_script_get_property;
   gobject_class->finalize = clutter_script_finalize;
@@ -687,6 +819,381 @@ clutter_script_load_from_resource (ClutterScript  *script,
   return res;
 }
 
+typedef struct {
+  gchar **resource_paths;
+
+  /* the JsonParser of each resource, in the same order */
+  GPtrArray *parsers;
+
+  guint n_pending;
+  GError *error;
+} LoadResources;
+
+static void
+load_resources_free (gpointer data)
+{
+  LoadResources *load = data;
+
+  g_strfreev (load->resource_paths);
+  g_ptr_array_unref (load->parsers);
+  g_clear_error (&load->error);
+
+  g_slice_free (LoadResources, load);
+}
+
+static void
+load_resource_thread (GTask        *task,
+                      gpointer      source_object,
+                      gpointer      task_data,
+                      GCancellable *cancellable)
+{
+  const gchar *resource_path = task_data;
+  GError *error = NULL;
+  JsonParser *parser;
+  GBytes *data;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  data = g_resources_lookup_data (resource_path, 0, &error);
+  if (data == NULL)
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+
+  /* parsing does not touch the state of Clutter, which is why we use
+   * a plain JsonParser in here, and create the objects later
+   */
+  parser = json_parser_new ();
+  if (!json_parser_load_from_data (parser,
+                                   g_bytes_get_data (data, NULL),
+                                   g_bytes_get_size (data),
+                                   &error))
+    {
+      g_prefix_error (&error, "%s: ", resource_path);
+      g_task_return_error (task, error);
+      g_object_unref (parser);
+    }
+  else
+    g_task_return_pointer (task, parser, g_object_unref);
+
+  g_bytes_unref (data);
+}
+
+static void
+load_resources_merge (ClutterScript *script,
+                      LoadResources *load)
+{
+  ClutterScriptPrivate *priv = script->priv;
+  guint i;
+
+  g_free (priv->filename);
+  priv->filename = NULL;
+  priv->is_filename = FALSE;
+  priv->last_merge_id += 1;
+
+  /* first we collect the definitions of every resource, so that the
+   * objects can reference the ones defined in other resources; then
+   * we construct them, resolving the references on demand
+   */
+  priv->is_merging = TRUE;
+
+  for (i = 0; i < load->parsers->len; i++)
+    {
+      JsonParser *parser = g_ptr_array_index (load->parsers, i);
+      JsonNode *root = json_parser_get_root (parser);
+
+      CLUTTER_NOTE (SCRIPT, "Merging the definitions of '%s'",
+                    load->resource_paths[i]);
+
+      if (root != NULL)
+        _clutter_script_parser_add_node (priv->parser, root);
+    }
+
+  priv->is_merging = FALSE;
+
+  if (!priv->is_lazy)
+    clutter_script_ensure_objects (script);
+}
+
+static void
+load_resource_done (GObject      *gobject,
+                    GAsyncResult *result,
+                    gpointer      user_data)
+{
+  GTask *task = user_data;
+  LoadResources *load = g_task_get_task_data (task);
+  gpointer index = g_object_get_data (G_OBJECT (result), "-clutter-script-index");
+  GError *error = NULL;
+  JsonParser *parser;
+
+  parser = g_task_propagate_pointer (G_TASK (result), &error);
+  if (parser != NULL)
+    g_ptr_array_index (load->parsers, GPOINTER_TO_UINT (index)) = parser;
+  else if (load->error == NULL)
+    load->error = error;
+  else
+    g_error_free (error);
+
+  load->n_pending -= 1;
+  if (load->n_pending > 0)
+    {
+      g_object_unref (task);
+      return;
+    }
+
+  if (load->error != NULL)
+    {
+      g_task_return_error (task, load->error);
+      load->error = NULL;
+    }
+  else
+    {
+      ClutterScript *script = g_task_get_source_object (task);
+
+      load_resources_merge (script, load);
+      g_task_return_int (task, script->priv->last_merge_id);
+    }
+
+  g_object_unref (task);
+}
+
+/**
+ * clutter_script_load_from_resources_async:
+ * @script: a #ClutterScript
+ * @resource_paths: (array zero-terminated=1): a %NULL-terminated array
+ *   with the resource paths of the files to load
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): the function to call when the definitions
+ *   are loaded
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronously loads the definitions from the resource files at
+ * @resource_paths into @script, and merges them with the currently
+ * loaded ones, if any.
+ *
+ * The resource files are parsed concurrently, on worker threads; once
+ * every file has been parsed, the definitions are merged, and the
+ * objects are constructed, on the main thread. Since all the definitions
+ * are merged before constructing any object, an object can reference
+ * the objects defined in any of the files.
+ *
+ * If any of the files cannot be loaded, none of the definitions are
+ * merged.
+ *
+ * Call clutter_script_load_from_resources_finish() from within @callback
+ * to retrieve the result of the operation.
+ *
+ * Since: 1.26
+ */
+void
+clutter_script_load_from_resources_async (ClutterScript       *script,
+                                          const gchar * const *resource_paths,
+                                          GCancellable        *cancellable,
+                                          GAsyncReadyCallback  callback,
+                                          gpointer             user_data)
+{
+  LoadResources *load;
+  GTask *task;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_SCRIPT (script));
+  g_return_if_fail (resource_paths != NULL);
+
+  load = g_slice_new0 (LoadResources);
+  load->resource_paths = g_strdupv ((gchar **) resource_paths);
+  load->n_pending = g_strv_length (load->resource_paths);
+  load->parsers = g_ptr_array_new_full (load->n_pending, g_object_unref);
+  g_ptr_array_set_size (load->parsers, load->n_pending);
+
+  task = g_task_new (script, cancellable, callback, user_data);
+  g_task_set_task_data (task, load, load_resources_free);
+
+  if (load->n_pending == 0)
+    {
+      load_resources_merge (script, load);
+      g_task_return_int (task, script->priv->last_merge_id);
+      g_object_unref (task);
+      return;
+    }
+
+  /* each file holds a reference on @task, released once it is parsed */
+  for (i = 0; load->resource_paths[i] != NULL; i++)
+    {
+      GTask *parse_task;
+
+      parse_task = g_task_new (NULL, cancellable,
+                               load_resource_done,
+                               g_object_ref (task));
+      g_task_set_task_data (parse_task, load->resource_paths[i], NULL);
+      g_object_set_data (G_OBJECT (parse_task), "-clutter-script-index",
+                         GUINT_TO_POINTER (i));
+      g_task_run_in_thread (parse_task, load_resource_thread);
+      g_object_unref (parse_task);
+    }
+
+  g_object_unref (task);
+}
+
+/**
+ * clutter_script_load_from_resources_finish:
+ * @script: a #ClutterScript
+ * @result: the #GAsyncResult passed to the callback of
+ *   clutter_script_load_from_resources_async()
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes an operation started by
+ * clutter_script_load_from_resources_async().
+ *
+ * Return value: on error, zero is returned and @error is set
+ *   accordingly. On success, the merge id for the UI definitions of
+ *   every file is returned. You can use the merge id with
+ *   clutter_script_unmerge_objects().
+ *
+ * Since: 1.26
+ */
+guint
+clutter_script_load_from_resources_finish (ClutterScript  *script,
+                                           GAsyncResult   *result,
+                                           GError        **error)
+{
+  gssize res;
+
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), 0);
+  g_return_val_if_fail (g_task_is_valid (result, script), 0);
+
+  res = g_task_propagate_int (G_TASK (result), error);
+  if (res < 0)
+    return 0;
+
+  return res;
+}
+
+/**
+ * clutter_script_compile_file:
+ * @script: a #ClutterScript
+ * @filename: the full path to the definition file
+ * @compiled_filename: the path of the compiled file to write
+ * @error: return location for a #GError, or %NULL
+ *
+ * Compiles the definitions inside @filename into the binary format
+ * loaded by clutter_script_load_from_compiled_file().
+ *
+ * The type of each object is resolved, the property names are
+ * replaced by the canonical names of their #GParamSpec, and the
+ * values of the properties with a fundamental type, like numbers,
+ * strings, enumerations and flags, are converted ahead of time,
+ * using the types known to @script. The objects are not created, and
+ * the definitions are not merged inside @script.
+ *
+ * Return value: %TRUE if the compiled file was written, and %FALSE
+ *   otherwise, in which case @error is set accordingly
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_script_compile_file (ClutterScript  *script,
+                             const gchar    *filename,
+                             const gchar    *compiled_filename,
+                             GError        **error)
+{
+  ClutterScript *compiler;
+  GBytes *data;
+  gboolean res;
+
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), FALSE);
+  g_return_val_if_fail (filename != NULL, FALSE);
+  g_return_val_if_fail (compiled_filename != NULL, FALSE);
+
+  /* we use a new instance of the same class, so that overrides of
+   * the get_type_from_name() virtual function are honoured
+   */
+  compiler = g_object_new (G_OBJECT_TYPE (script), NULL);
+  compiler->priv->compiled_objects = g_ptr_array_new ();
+  compiler->priv->is_compiling = TRUE;
+
+  if (clutter_script_load_from_file (compiler, filename, error) == 0)
+    {
+      g_object_unref (compiler);
+      return FALSE;
+    }
+
+  data = _clutter_script_binary_compile (compiler,
+                                         compiler->priv->compiled_objects);
+
+  res = g_file_set_contents (compiled_filename,
+                             g_bytes_get_data (data, NULL),
+                             g_bytes_get_size (data),
+                             error);
+
+  g_bytes_unref (data);
+  g_object_unref (compiler);
+
+  return res;
+}
+
+/**
+ * clutter_script_load_from_compiled_file:
+ * @script: a #ClutterScript
+ * @filename: the full path to the compiled definition file
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the definitions compiled by clutter_script_compile_file() from
+ * @filename into @script and merges with the currently loaded ones, if
+ * any.
+ *
+ * The file is memory mapped, and the objects are built directly from
+ * its contents, without parsing JSON.
+ *
+ * Return value: on error, zero is returned and @error is set
+ *   accordingly. On success, the merge id for the UI definitions is
+ *   returned. You can use the merge id with clutter_script_unmerge_objects().
+ *
+ * Since: 1.26
+ */
+guint
+clutter_script_load_from_compiled_file (ClutterScript  *script,
+                                        const gchar    *filename,
+                                        GError        **error)
+{
+  ClutterScriptPrivate *priv;
+  GMappedFile *mapped_file;
+  gboolean res;
+
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), 0);
+  g_return_val_if_fail (filename != NULL, 0);
+
+  mapped_file = g_mapped_file_new (filename, FALSE, error);
+  if (mapped_file == NULL)
+    return 0;
+
+  priv = script->priv;
+
+  g_free (priv->filename);
+  priv->filename = g_strdup (filename);
+  priv->is_filename = TRUE;
+  priv->last_merge_id += 1;
+
+  res = _clutter_script_binary_load (script,
+                                     (const guint8 *) g_mapped_file_get_contents (mapped_file),
+                                     g_mapped_file_get_length (mapped_file),
+                                     error);
+
+  g_mapped_file_unref (mapped_file);
+
+  if (!res)
+    {
+      priv->last_merge_id -= 1;
+      return 0;
+    }
+
+  if (!priv->is_lazy)
+    clutter_script_ensure_objects (script);
+
+  return priv->last_merge_id;
+}
+
 /**
  * clutter_script_get_object:
  * @script: a #ClutterScript
@@ -818,6 +1325,17 @@ remove_by_merge_id (gpointer key,
     }
 }
 
+static void
+update_each_constructed_object (gpointer key,
+                                gpointer value,
+                                gpointer user_data)
+{
+  ObjectInfo *oinfo = value;
+
+  if (oinfo->object != NULL && oinfo->has_unresolved)
+    _clutter_script_apply_properties (user_data, oinfo);
+}
+
 /**
  * clutter_script_unmerge_objects:
  * @script: a #ClutterScript
@@ -851,7 +1369,13 @@ clutter_script_unmerge_objects (ClutterScript *script,
   g_slist_foreach (data.ids, (GFunc) g_free, NULL);
   g_slist_free (data.ids);
 
-  clutter_script_ensure_objects (script);
+  /* when constructing lazily, we only need to update the objects
+   * that have already been constructed
+   */
+  if (priv->is_lazy)
+    g_hash_table_foreach (priv->objects, update_each_constructed_object, script);
+  else
+    clutter_script_ensure_objects (script);
 }
 
 static void
@@ -895,7 +1419,13 @@ clutter_script_ensure_objects (ClutterScript *script)
   g_return_if_fail (CLUTTER_IS_SCRIPT (script));
 
   priv = script->priv;
+
+  /* this constructs everything, including the children waiting for
+   * their parent to be added to a stage
+   */
+  priv->is_ensuring = TRUE;
   g_hash_table_foreach (priv->objects, construct_each_objects, script);
+  priv->is_ensuring = FALSE;
 }
 
 /**
@@ -1052,6 +1582,7 @@ typedef struct {
   gulong signal_id;
   gulong hook_id;
   gboolean warp_to;
+  gboolean is_actor;
 } HookData;
 
 typedef struct {
@@ -1067,6 +1598,9 @@ hook_data_free (gpointer data)
     {
       HookData *hook_data = data;
 
+      if (hook_data->is_actor)
+        _clutter_actor_remove_event_emission_hook ();
+
       g_free (hook_data->target);
       g_slice_free (HookData, hook_data);
     }
@@ -1112,11 +1646,24 @@ connect_each_object (gpointer key,
   SignalConnectData *connect_data = data;
   ClutterScript *script = connect_data->script;
   ObjectInfo *oinfo = value;
-  GObject *object = oinfo->object;
   GList *unresolved, *l;
+  GObject *object;
+
+  /* do not construct the objects without signals when constructing
+   * lazily; the objects with signals need to exist, to be connected
+   */
+  if (oinfo->signals == NULL)
+    return;
 
   _clutter_script_construct_object (script, oinfo);
 
+  if (script->priv->is_lazy)
+    _clutter_script_apply_properties (script, oinfo);
+
+  object = oinfo->object;
+  if (object == NULL)
+    return;
+
   unresolved = NULL;
   for (l = oinfo->signals; l != NULL; l = l->next)
     {
@@ -1192,6 +1739,12 @@ connect_each_object (gpointer key,
           hook_data->target = g_strdup (sinfo->target);
           hook_data->warp_to = sinfo->warp_to;
           hook_data->signal_id = signal_id;
+
+          /* the actors skip the event signals without handlers */
+          hook_data->is_actor = CLUTTER_IS_ACTOR (object);
+          if (hook_data->is_actor)
+            _clutter_actor_add_event_emission_hook ();
+
           hook_data->hook_id =
             g_signal_add_emission_hook (signal_id, signal_quark,
                                         clutter_script_state_change_hook,
@@ -1535,6 +2088,64 @@ clutter_script_get_translation_domain (ClutterScript *script)
   return script->priv->translation_domain;
 }
 
+/**
+ * clutter_script_set_lazy_construction:
+ * @script: a #ClutterScript
+ * @lazy: whether the objects should be constructed lazily
+ *
+ * Sets whether @script should construct the objects only when they are
+ * requested.
+ *
+ * By default, every object defined inside a UI definition is constructed
+ * when the definition is loaded. If @lazy is %TRUE, loading a definition
+ * only records the definitions, and each object is constructed the first
+ * time it is requested through clutter_script_get_object(), along with
+ * the objects it references. Actors that are not on a stage when they are
+ * constructed get their children only once they are added to a stage, so
+ * that the parts of a UI that are never shown are never constructed.
+ *
+ * The objects that have signals are still constructed by
+ * clutter_script_connect_signals(), and clutter_script_ensure_objects()
+ * and clutter_script_list_objects() still construct every object.
+ *
+ * This function should be called before loading any definition.
+ *
+ * Since: 1.26
+ */
+void
+clutter_script_set_lazy_construction (ClutterScript *script,
+                                      gboolean       lazy)
+{
+  g_return_if_fail (CLUTTER_IS_SCRIPT (script));
+
+  lazy = !!lazy;
+
+  if (script->priv->is_lazy == lazy)
+    return;
+
+  script->priv->is_lazy = lazy;
+
+  g_object_notify_by_pspec (G_OBJECT (script), obj_props[PROP_LAZY_CONSTRUCTION]);
+}
+
+/**
+ * clutter_script_get_lazy_construction:
+ * @script: a #ClutterScript
+ *
+ * Retrieves the value set using clutter_script_set_lazy_construction().
+ *
+ * Return value: %TRUE if the objects are constructed lazily
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_script_get_lazy_construction (ClutterScript *script)
+{
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), FALSE);
+
+  return script->priv->is_lazy;
+}
+
 /*
  * _clutter_script_generate_fake_id:
  * @script: a #ClutterScript
@@ -1684,6 +2295,94 @@ _clutter_script_add_object_info (ClutterScript *script,
 {
   ClutterScriptPrivate *priv = script->priv;
 
+  if (priv->is_compiling &&
+      g_hash_table_lookup (priv->objects, oinfo->id) != oinfo)
+    g_ptr_array_add (priv->compiled_objects, oinfo);
+
   g_hash_table_steal (priv->objects, oinfo->id);
   g_hash_table_insert (priv->objects, oinfo->id, oinfo);
 }
+
+/*
+ * _clutter_script_is_collecting:
+ * @script: a #ClutterScript
+ *
+ * Checks whether @script is only collecting the definitions, instead
+ * of creating the objects while parsing; this happens when compiling
+ * with clutter_script_compile_file(), and when merging the definitions
+ * parsed by clutter_script_load_from_resources_async()
+ */
+gboolean
+_clutter_script_is_collecting (ClutterScript *script)
+{
+  return script->priv->is_compiling || script->priv->is_merging;
+}
+
+/*
+ * _clutter_script_is_lazy:
+ * @script: a #ClutterScript
+ *
+ * Checks whether @script constructs the objects only when they are
+ * requested; see clutter_script_set_lazy_construction()
+ */
+gboolean
+_clutter_script_is_lazy (ClutterScript *script)
+{
+  return script->priv->is_lazy;
+}
+
+/*
+ * _clutter_script_defer_children:
+ * @script: a #ClutterScript
+ * @oinfo: the #ObjectInfo of a container
+ *
+ * When constructing lazily, defers adding the children of @oinfo until
+ * its actor is added to a stage.
+ *
+ * Return value: %TRUE if the children have been deferred, and %FALSE
+ *   if they should be added now
+ */
+gboolean
+_clutter_script_defer_children (ClutterScript *script,
+                                ObjectInfo    *oinfo)
+{
+  ClutterScriptPrivate *priv = script->priv;
+  DeferredChildren *deferred = oinfo->deferred_children;
+
+  if (!priv->is_lazy ||
+      priv->is_ensuring ||
+      !CLUTTER_IS_ACTOR (oinfo->object) ||
+      clutter_actor_get_stage (CLUTTER_ACTOR (oinfo->object)) != NULL)
+    {
+      if (deferred != NULL)
+        deferred_children_free (deferred);
+
+      return FALSE;
+    }
+
+  if (deferred != NULL)
+    return TRUE;
+
+  CLUTTER_NOTE (SCRIPT, "Deferring the children of '%s' until it is "
+                        "added to a stage",
+                oinfo->id);
+
+  deferred = g_slice_new0 (DeferredChildren);
+  deferred->script = script;
+  deferred->oinfo = oinfo;
+  deferred->parent_set_id =
+    g_signal_connect_swapped (oinfo->object, "parent-set",
+                              G_CALLBACK (deferred_children_update),
+                              deferred);
+  deferred->mapped_id =
+    g_signal_connect_swapped (oinfo->object, "notify::mapped",
+                              G_CALLBACK (deferred_children_update),
+                              deferred);
+
+  oinfo->deferred_children = deferred;
+
+  /* the actor might already be inside a tree outside of a stage */
+  deferred_children_update (deferred);
+
+  return TRUE;
+}
@@ -28,6 +28,7 @@
 #error "Only <clutter/clutter.h> can be included directly."
 #endif
 
+#include <gio/gio.h>
 #include <clutter/clutter-types.h>
 
 G_BEGIN_DECLS
@@ -74,6 +75,8 @@ typedef void (* ClutterScriptConnectFunc) (ClutterScript *script,
  *   or invalid
  * @CLUTTER_SCRIPT_ERROR_INVALID_PROPERTY: Property not found or invalid
  * @CLUTTER_SCRIPT_ERROR_INVALID_VALUE: Invalid value
+ * @CLUTTER_SCRIPT_ERROR_INVALID_COMPILED_DATA: Invalid compiled data, or
+ *   compiled data using an unsupported version of the format. Since: 1.26
  *
  * #ClutterScript error enumeration.
  *
@@ -82,7 +85,8 @@ typedef void (* ClutterScriptConnectFunc) (ClutterScript *script,
 typedef enum {
   CLUTTER_SCRIPT_ERROR_INVALID_TYPE_FUNCTION,
   CLUTTER_SCRIPT_ERROR_INVALID_PROPERTY,
-  CLUTTER_SCRIPT_ERROR_INVALID_VALUE
+  CLUTTER_SCRIPT_ERROR_INVALID_VALUE,
+  CLUTTER_SCRIPT_ERROR_INVALID_COMPILED_DATA
 } ClutterScriptError;
 
 /**
@@ -162,6 +166,25 @@ CLUTTER_AVAILABLE_IN_1_10
 guint           clutter_script_load_from_resource       (ClutterScript             *script,
                                                          const gchar               *resource_path,
                                                          GError                   **error);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_script_load_from_resources_async (ClutterScript            *script,
+                                                          const gchar * const      *resource_paths,
+                                                          GCancellable             *cancellable,
+                                                          GAsyncReadyCallback       callback,
+                                                          gpointer                  user_data);
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_script_load_from_resources_finish (ClutterScript           *script,
+                                                           GAsyncResult            *result,
+                                                           GError                 **error);
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_script_load_from_compiled_file  (ClutterScript             *script,
+                                                         const gchar               *filename,
+                                                         GError                   **error);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_script_compile_file             (ClutterScript             *script,
+                                                         const gchar               *filename,
+                                                         const gchar               *compiled_filename,
+                                                         GError                   **error);
 
 CLUTTER_AVAILABLE_IN_ALL
 GObject *       clutter_script_get_object               (ClutterScript             *script,
@@ -212,6 +235,12 @@ void            clutter_script_set_translation_domain   (ClutterScript
 CLUTTER_AVAILABLE_IN_1_10
 const gchar *   clutter_script_get_translation_domain   (ClutterScript             *script);
 
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_script_set_lazy_construction    (ClutterScript             *script,
+                                                         gboolean                   lazy);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_script_get_lazy_construction    (ClutterScript             *script);
+
 CLUTTER_AVAILABLE_IN_ALL
 const gchar *   clutter_get_script_id                   (GObject                   *gobject);
 
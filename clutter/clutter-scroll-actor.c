@@ -33,8 +33,12 @@
  * clutter_scroll_actor_scroll_to_rect() to define a point or a rectangle
  * acting as the origin, respectively.
  *
- * #ClutterScrollActor does not provide pointer or keyboard event handling,
- * nor does it provide visible scroll handles.
+ * #ClutterScrollActor does not provide keyboard event handling, nor does
+ * it provide visible scroll handles. Dragging the contents with a pointer
+ * or a touch point, and flinging them, can be enabled using the
+ * #ClutterScrollActor:kinetic property; the flings decelerate at the
+ * rate set by the #ClutterScrollActor:deceleration property, and spring
+ * back when they go past the edges of the contents.
  *
  * See [scroll-actor.c](https://git.gnome.org/browse/clutter/tree/examples/scroll-actor.c?h=clutter-1.18)
  * for an example of how to use #ClutterScrollActor.
@@ -48,14 +52,53 @@
 
 #include "clutter-scroll-actor.h"
 
+#include <math.h>
+
 #include "clutter-actor-private.h"
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-private.h"
 #include "clutter-property-transition.h"
+#include "clutter-settings.h"
+#include "clutter-stage.h"
 #include "clutter-transition.h"
 
+#define FLOAT_EPSILON           (1e-15)
+
+/* the flings stop below this velocity, in px/ms */
+#define FLING_MIN_VELOCITY      0.05f
+
+/* the drag samples used to measure the velocity, in milliseconds */
+#define VELOCITY_WINDOW         50
+
+#define MAX_DRAG_SAMPLES        16
+
+/* the edge springs are critically damped, and settle in ~300ms */
+#define SPRING_FREQUENCY        0.0133f
+#define SPRING_STEP             4.f
+
+/* how much harder it gets to drag the contents past the edges */
+#define OVERSCROLL_RESISTANCE   0.55f
+
+static const gfloat reference_fps = 60.0f; /* the fps assumed for the deceleration rate */
+static const gfloat default_deceleration_rate = 0.95f;
+
+typedef struct
+{
+  /* the scroll range is [0, max] */
+  gfloat position;
+  gfloat velocity;
+  gfloat max;
+  gfloat size;
+} KineticAxis;
+
+typedef struct
+{
+  gint64 time;
+  gfloat x, y;
+} DragSample;
+
 struct _ClutterScrollActorPrivate
 {
   ClutterPoint scroll_to;
@@ -63,6 +106,31 @@ struct _ClutterScrollActorPrivate
   ClutterScrollMode scroll_mode;
 
   ClutterTransition *transition;
+
+  gdouble deceleration_rate;
+
+  ClutterTimeline *kinetic_timeline;
+  KineticAxis axis_x;
+  KineticAxis axis_y;
+
+  ClutterActor *stage;
+  gulong capture_id;
+  gulong stage_capture_id;
+
+  /* the device and the sequence dragging the contents */
+  ClutterInputDevice *drag_device;
+  ClutterEventSequence *drag_sequence;
+  gfloat press_x, press_y;
+  ClutterPoint press_scroll_to;
+
+  /* a ring of the latest positions, in actor coordinates */
+  DragSample samples[MAX_DRAG_SAMPLES];
+  guint n_samples;
+  guint sample_head;
+
+  guint kinetic : 1;
+  guint in_drag : 1;
+  guint dragging : 1;
 };
 
 enum
@@ -70,6 +138,8 @@ enum
   PROP_0,
 
   PROP_SCROLL_MODE,
+  PROP_KINETIC,
+  PROP_DECELERATION,
 
   PROP_LAST
 };
@@ -126,6 +196,530 @@ clutter_scroll_actor_set_scroll_to_internal (ClutterScrollActor *self,
   clutter_actor_set_child_transform (actor, &m);
 }
 
+static void
+kinetic_axis_init (KineticAxis *axis,
+                   gfloat       position,
+                   gfloat       content_size,
+                   gfloat       size)
+{
+  axis->position = position;
+  axis->velocity = 0.f;
+  axis->max = MAX (content_size - size, 0.f);
+  axis->size = size;
+}
+
+static gfloat
+kinetic_axis_get_bound (const KineticAxis *axis)
+{
+  return CLAMP (axis->position, 0.f, axis->max);
+}
+
+/* integrates @axis over @delta milliseconds; the velocity decays
+ * exponentially inside the scroll range, and the edge springs pull
+ * the position back into it
+ *
+ * returns %TRUE if the axis is still moving
+ */
+static gboolean
+kinetic_axis_step (KineticAxis *axis,
+                   gfloat       tau,
+                   gfloat       delta)
+{
+  gfloat bound;
+
+  while (delta > 0.f)
+    {
+      gfloat step = MIN (delta, SPRING_STEP);
+
+      delta -= step;
+      bound = kinetic_axis_get_bound (axis);
+
+      if (bound == axis->position)
+        {
+          /* x(t) = x(0) + v(0) * tau * [1 - exp(-t/tau)] */
+          gfloat decay = expf (-step / tau);
+
+          axis->position += axis->velocity * tau * (1.f - decay);
+          axis->velocity *= decay;
+        }
+      else
+        {
+          gfloat displacement = axis->position - bound;
+          gfloat acceleration;
+
+          acceleration = - SPRING_FREQUENCY * SPRING_FREQUENCY * displacement
+                         - 2.f * SPRING_FREQUENCY * axis->velocity;
+
+          axis->velocity += acceleration * step;
+          axis->position += axis->velocity * step;
+
+          /* do not bounce back past the edge */
+          if ((axis->position - bound) * displacement < 0.f)
+            {
+              axis->position = bound;
+              axis->velocity = 0.f;
+            }
+        }
+    }
+
+  bound = kinetic_axis_get_bound (axis);
+
+  if (fabsf (axis->velocity) >= FLING_MIN_VELOCITY)
+    return TRUE;
+
+  if (fabsf (axis->position - bound) >= 0.5f)
+    return TRUE;
+
+  axis->position = bound;
+  axis->velocity = 0.f;
+
+  return FALSE;
+}
+
+/* the contents follow the drag past the edges with a growing
+ * resistance, up to the size of the visible area
+ */
+static gfloat
+kinetic_axis_rubber_band (const KineticAxis *axis,
+                          gfloat             position)
+{
+  gfloat overscroll;
+
+  if (axis->size <= 0.f)
+    return CLAMP (position, 0.f, axis->max);
+
+  if (position < 0.f)
+    overscroll = -position;
+  else if (position > axis->max)
+    overscroll = position - axis->max;
+  else
+    return position;
+
+  overscroll = (1.f - 1.f / (overscroll * OVERSCROLL_RESISTANCE / axis->size + 1.f))
+             * axis->size;
+
+  return position < 0.f ? -overscroll : axis->max + overscroll;
+}
+
+static void
+clutter_scroll_actor_update_limits (ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  ClutterActor *actor = CLUTTER_ACTOR (self);
+  gfloat content_width = 0.f, content_height = 0.f;
+  gfloat width, height;
+  ClutterActorIter iter;
+  ClutterActor *child;
+
+  clutter_actor_get_size (actor, &width, &height);
+
+  clutter_actor_iter_init (&iter, actor);
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      ClutterActorBox box;
+
+      clutter_actor_get_allocation_box (child, &box);
+      content_width = MAX (content_width, box.x2);
+      content_height = MAX (content_height, box.y2);
+    }
+
+  kinetic_axis_init (&priv->axis_x, priv->scroll_to.x, content_width, width);
+  kinetic_axis_init (&priv->axis_y, priv->scroll_to.y, content_height, height);
+}
+
+static void
+clutter_scroll_actor_apply_kinetic (ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  ClutterPoint point;
+
+  clutter_point_init (&point, priv->axis_x.position, priv->axis_y.position);
+
+  /* only the child transform changes, so no relayout is needed */
+  clutter_scroll_actor_set_scroll_to_internal (self, &point);
+}
+
+static void
+on_kinetic_new_frame (ClutterTimeline    *timeline,
+                      gint                elapsed_time,
+                      ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  gboolean moving = FALSE;
+  gfloat delta, tau;
+
+  /* the delta is measured between the frame times of the master
+   * clock, so the fling keeps its speed if frames are dropped
+   */
+  delta = clutter_timeline_get_delta (timeline);
+  if (delta <= 0.f)
+    return;
+
+  /* v(t) = v(0) * exp(-t/tau), with tau derived from the decay per
+   * frame at the reference frame rate, like ClutterPanAction
+   */
+  tau = 1000.0f / (reference_fps * - logf (priv->deceleration_rate));
+
+  if (priv->scroll_mode & CLUTTER_SCROLL_HORIZONTALLY)
+    moving |= kinetic_axis_step (&priv->axis_x, tau, delta);
+
+  if (priv->scroll_mode & CLUTTER_SCROLL_VERTICALLY)
+    moving |= kinetic_axis_step (&priv->axis_y, tau, delta);
+
+  clutter_scroll_actor_apply_kinetic (self);
+
+  if (!moving)
+    clutter_timeline_stop (timeline);
+}
+
+static void
+clutter_scroll_actor_stop_kinetic (ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+
+  if (priv->kinetic_timeline != NULL)
+    clutter_timeline_stop (priv->kinetic_timeline);
+}
+
+static void
+clutter_scroll_actor_start_kinetic (ClutterScrollActor *self,
+                                    gfloat              velocity_x,
+                                    gfloat              velocity_y)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+
+  if (priv->transition != NULL)
+    {
+      clutter_actor_remove_transition (CLUTTER_ACTOR (self), "scroll-to");
+      priv->transition = NULL;
+    }
+
+  clutter_scroll_actor_update_limits (self);
+
+  if (priv->scroll_mode & CLUTTER_SCROLL_HORIZONTALLY)
+    priv->axis_x.velocity = velocity_x;
+
+  if (priv->scroll_mode & CLUTTER_SCROLL_VERTICALLY)
+    priv->axis_y.velocity = velocity_y;
+
+  if (priv->kinetic_timeline == NULL)
+    {
+      /* the timeline only provides the frame deltas; it runs until
+       * the contents come to rest
+       */
+      priv->kinetic_timeline = clutter_timeline_new (1000);
+      clutter_timeline_set_repeat_count (priv->kinetic_timeline, -1);
+      g_signal_connect (priv->kinetic_timeline, "new-frame",
+                        G_CALLBACK (on_kinetic_new_frame),
+                        self);
+    }
+
+  clutter_timeline_rewind (priv->kinetic_timeline);
+  clutter_timeline_start (priv->kinetic_timeline);
+}
+
+static void
+clutter_scroll_actor_add_drag_sample (ClutterScrollActor *self,
+                                      gint64              time_,
+                                      gfloat              stage_x,
+                                      gfloat              stage_y)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  DragSample *sample;
+  guint index_;
+
+  index_ = (priv->sample_head + priv->n_samples) % MAX_DRAG_SAMPLES;
+  if (priv->n_samples < MAX_DRAG_SAMPLES)
+    priv->n_samples += 1;
+  else
+    priv->sample_head = (priv->sample_head + 1) % MAX_DRAG_SAMPLES;
+
+  sample = &priv->samples[index_];
+  sample->time = time_;
+
+  if (!clutter_actor_transform_stage_point (CLUTTER_ACTOR (self),
+                                            stage_x, stage_y,
+                                            &sample->x, &sample->y))
+    {
+      sample->x = stage_x;
+      sample->y = stage_y;
+    }
+}
+
+/* adds the samples coalesced into @event, then the event itself */
+static void
+clutter_scroll_actor_add_drag_event (ClutterScrollActor *self,
+                                     const ClutterEvent *event)
+{
+  const ClutterEventSample *history;
+  guint i, n_samples;
+  gfloat x, y;
+
+  history = clutter_event_get_history (event, &n_samples);
+  for (i = 0; i < n_samples; i++)
+    clutter_scroll_actor_add_drag_sample (self,
+                                          history[i].time,
+                                          history[i].x,
+                                          history[i].y);
+
+  clutter_event_get_coords (event, &x, &y);
+  clutter_scroll_actor_add_drag_sample (self, clutter_event_get_time (event), x, y);
+}
+
+/* the velocity of the drag over the last VELOCITY_WINDOW milliseconds,
+ * in px/ms of the contents
+ */
+static void
+clutter_scroll_actor_get_drag_velocity (ClutterScrollActor *self,
+                                        gfloat             *velocity_x,
+                                        gfloat             *velocity_y)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  const DragSample *newest, *oldest;
+  gint64 delta_time;
+  guint i;
+
+  *velocity_x = *velocity_y = 0.f;
+
+  if (priv->n_samples < 2)
+    return;
+
+  newest = &priv->samples[(priv->sample_head + priv->n_samples - 1) % MAX_DRAG_SAMPLES];
+  oldest = newest;
+
+  for (i = priv->n_samples - 1; i > 0; i--)
+    {
+      const DragSample *sample;
+
+      sample = &priv->samples[(priv->sample_head + i - 1) % MAX_DRAG_SAMPLES];
+      if (newest->time - sample->time > VELOCITY_WINDOW)
+        break;
+
+      oldest = sample;
+    }
+
+  delta_time = newest->time - oldest->time;
+  if (delta_time <= 0)
+    return;
+
+  /* the contents scroll in the opposite direction of the drag */
+  *velocity_x = (oldest->x - newest->x) / delta_time;
+  *velocity_y = (oldest->y - newest->y) / delta_time;
+}
+
+static void
+clutter_scroll_actor_end_drag (ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+
+  if (priv->stage_capture_id != 0)
+    {
+      g_signal_handler_disconnect (priv->stage, priv->stage_capture_id);
+      priv->stage_capture_id = 0;
+    }
+
+  priv->stage = NULL;
+  priv->drag_device = NULL;
+  priv->drag_sequence = NULL;
+  priv->in_drag = FALSE;
+  priv->dragging = FALSE;
+}
+
+static void
+clutter_scroll_actor_drag_motion (ClutterScrollActor *self,
+                                  const ClutterEvent *event)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  const DragSample *sample;
+  ClutterPoint point;
+
+  clutter_scroll_actor_add_drag_event (self, event);
+
+  sample = &priv->samples[(priv->sample_head + priv->n_samples - 1) % MAX_DRAG_SAMPLES];
+
+  if (!priv->dragging)
+    {
+      ClutterSettings *settings = clutter_settings_get_default ();
+      gfloat dx = 0.f, dy = 0.f;
+      gint threshold;
+
+      g_object_get (settings, "dnd-drag-threshold", &threshold, NULL);
+
+      if (priv->scroll_mode & CLUTTER_SCROLL_HORIZONTALLY)
+        dx = fabsf (sample->x - priv->press_x);
+
+      if (priv->scroll_mode & CLUTTER_SCROLL_VERTICALLY)
+        dy = fabsf (sample->y - priv->press_y);
+
+      if (dx < threshold && dy < threshold)
+        return;
+
+      /* start following the drag from here, instead of jumping by
+       * the threshold
+       */
+      priv->dragging = TRUE;
+      priv->press_x = sample->x;
+      priv->press_y = sample->y;
+      priv->press_scroll_to = priv->scroll_to;
+
+      clutter_scroll_actor_update_limits (self);
+    }
+
+  point = priv->press_scroll_to;
+
+  if (priv->scroll_mode & CLUTTER_SCROLL_HORIZONTALLY)
+    point.x = kinetic_axis_rubber_band (&priv->axis_x,
+                                        point.x - (sample->x - priv->press_x));
+
+  if (priv->scroll_mode & CLUTTER_SCROLL_VERTICALLY)
+    point.y = kinetic_axis_rubber_band (&priv->axis_y,
+                                        point.y - (sample->y - priv->press_y));
+
+  clutter_scroll_actor_set_scroll_to_internal (self, &point);
+}
+
+static gboolean
+on_stage_captured_event (ClutterActor       *stage,
+                         ClutterEvent       *event,
+                         ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  gboolean was_dragging = priv->dragging;
+  gfloat velocity_x, velocity_y;
+
+  if (clutter_event_get_device (event) != priv->drag_device ||
+      clutter_event_get_event_sequence (event) != priv->drag_sequence)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  switch (clutter_event_type (event))
+    {
+    case CLUTTER_MOTION:
+      /* we might miss the button release in case of grabs */
+      if (!(clutter_event_get_state (event) & CLUTTER_BUTTON1_MASK))
+        {
+          clutter_scroll_actor_end_drag (self);
+          clutter_scroll_actor_start_kinetic (self, 0.f, 0.f);
+          break;
+        }
+
+      /* fall through */
+    case CLUTTER_TOUCH_UPDATE:
+      clutter_scroll_actor_drag_motion (self, event);
+
+      /* the children do not see the motion of a drag */
+      if (priv->dragging)
+        return CLUTTER_EVENT_STOP;
+      break;
+
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_TOUCH_END:
+      clutter_scroll_actor_add_drag_event (self, event);
+
+      if (was_dragging)
+        clutter_scroll_actor_get_drag_velocity (self, &velocity_x, &velocity_y);
+      else
+        velocity_x = velocity_y = 0.f;
+
+      clutter_scroll_actor_end_drag (self);
+
+      /* start even without velocity, to spring back from the edges */
+      if (was_dragging)
+        clutter_scroll_actor_start_kinetic (self, velocity_x, velocity_y);
+      break;
+
+    case CLUTTER_TOUCH_CANCEL:
+      clutter_scroll_actor_end_drag (self);
+
+      if (was_dragging)
+        clutter_scroll_actor_start_kinetic (self, 0.f, 0.f);
+      break;
+
+    default:
+      break;
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static gboolean
+on_captured_event (ClutterActor       *actor,
+                   ClutterEvent       *event,
+                   ClutterScrollActor *self)
+{
+  ClutterScrollActorPrivate *priv = self->priv;
+  gboolean was_flinging;
+  gfloat x, y;
+
+  if (clutter_event_type (event) != CLUTTER_BUTTON_PRESS &&
+      clutter_event_type (event) != CLUTTER_TOUCH_BEGIN)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  if (clutter_event_type (event) == CLUTTER_BUTTON_PRESS &&
+      clutter_event_get_button (event) != CLUTTER_BUTTON_PRIMARY)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  /* only one drag at a time */
+  if (priv->in_drag)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  was_flinging = priv->kinetic_timeline != NULL &&
+                 clutter_timeline_is_playing (priv->kinetic_timeline);
+
+  clutter_scroll_actor_stop_kinetic (self);
+
+  priv->stage = clutter_actor_get_stage (actor);
+  if (priv->stage == NULL)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  priv->in_drag = TRUE;
+  priv->dragging = FALSE;
+  priv->drag_device = clutter_event_get_device (event);
+  priv->drag_sequence = clutter_event_get_event_sequence (event);
+  priv->press_scroll_to = priv->scroll_to;
+  priv->n_samples = 0;
+  priv->sample_head = 0;
+
+  clutter_event_get_coords (event, &x, &y);
+  clutter_scroll_actor_add_drag_sample (self, clutter_event_get_time (event), x, y);
+  priv->press_x = priv->samples[0].x;
+  priv->press_y = priv->samples[0].y;
+
+  priv->stage_capture_id =
+    g_signal_connect (priv->stage, "captured-event",
+                      G_CALLBACK (on_stage_captured_event),
+                      self);
+
+  /* a press stopping a fling only stops it */
+  if (was_flinging)
+    {
+      priv->dragging = TRUE;
+      clutter_scroll_actor_update_limits (self);
+      return CLUTTER_EVENT_STOP;
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void
+clutter_scroll_actor_dispose (GObject *gobject)
+{
+  ClutterScrollActor *self = CLUTTER_SCROLL_ACTOR (gobject);
+  ClutterScrollActorPrivate *priv = self->priv;
+
+  clutter_scroll_actor_end_drag (self);
+
+  if (priv->kinetic_timeline != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (priv->kinetic_timeline,
+                                            on_kinetic_new_frame,
+                                            self);
+      clutter_timeline_stop (priv->kinetic_timeline);
+      g_clear_object (&priv->kinetic_timeline);
+    }
+
+  G_OBJECT_CLASS (clutter_scroll_actor_parent_class)->dispose (gobject);
+}
+
 static void
 clutter_scroll_actor_set_property (GObject      *gobject,
                                    guint         prop_id,
@@ -140,6 +734,14 @@ clutter_scroll_actor_set_property (GObject      *gobject,
       clutter_scroll_actor_set_scroll_mode (actor, g_value_get_flags (value));
       break;
 
+    case PROP_KINETIC:
+      clutter_scroll_actor_set_kinetic (actor, g_value_get_boolean (value));
+      break;
+
+    case PROP_DECELERATION:
+      clutter_scroll_actor_set_deceleration (actor, g_value_get_double (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -159,6 +761,14 @@ clutter_scroll_actor_get_property (GObject    *gobject,
       g_value_set_flags (value, actor->priv->scroll_mode);
       break;
 
+    case PROP_KINETIC:
+      g_value_set_boolean (value, actor->priv->kinetic);
+      break;
+
+    case PROP_DECELERATION:
+      g_value_set_double (value, actor->priv->deceleration_rate);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -171,6 +781,7 @@ clutter_scroll_actor_class_init (ClutterScrollActorClass *klass)
 
   gobject_class->set_property = clutter_scroll_actor_set_property;
   gobject_class->get_property = clutter_scroll_actor_get_property;
+  gobject_class->dispose = clutter_scroll_actor_dispose;
 
   /**
    * ClutterScrollActor:scroll-mode:
@@ -188,6 +799,40 @@ clutter_scroll_actor_class_init (ClutterScrollActorClass *klass)
                         G_PARAM_READWRITE |
                         G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterScrollActor:kinetic:
+   *
+   * Whether the contents can be dragged with a pointer or a touch
+   * point, and keep scrolling after being released.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_KINETIC] =
+    g_param_spec_boolean ("kinetic",
+                          P_("Kinetic"),
+                          P_("Whether the contents can be dragged and flung"),
+                          FALSE,
+                          G_PARAM_READWRITE |
+                          G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterScrollActor:deceleration:
+   *
+   * The rate at which the flings decelerate.
+   *
+   * The velocity is multiplied by this rate every 1/60th of a second,
+   * whatever the actual frame rate.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_DECELERATION] =
+    g_param_spec_double ("deceleration",
+                         P_("Deceleration"),
+                         P_("Rate at which the flings decelerate"),
+                         FLOAT_EPSILON, 1.0, default_deceleration_rate,
+                         G_PARAM_READWRITE |
+                         G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 }
 
@@ -196,6 +841,7 @@ clutter_scroll_actor_init (ClutterScrollActor *self)
 {
   self->priv = clutter_scroll_actor_get_instance_private (self);
   self->priv->scroll_mode = CLUTTER_SCROLL_BOTH;
+  self->priv->deceleration_rate = default_deceleration_rate;
 
   clutter_actor_set_clip_to_allocation (CLUTTER_ACTOR (self), TRUE);
 }
@@ -348,6 +994,8 @@ clutter_scroll_actor_scroll_to_point (ClutterScrollActor *actor,
 
   priv = actor->priv;
 
+  clutter_scroll_actor_stop_kinetic (actor);
+
   info = _clutter_actor_get_animation_info (CLUTTER_ACTOR (actor));
 
   /* jump to the end if there is no easing state, or if the easing
@@ -434,3 +1082,138 @@ clutter_scroll_actor_scroll_to_rect (ClutterScrollActor *actor,
 
   clutter_scroll_actor_scroll_to_point (actor, &n_rect.origin);
 }
+
+/**
+ * clutter_scroll_actor_set_kinetic:
+ * @actor: a #ClutterScrollActor
+ * @kinetic: whether the contents can be dragged and flung
+ *
+ * Sets the #ClutterScrollActor:kinetic property.
+ *
+ * The @actor should be reactive to receive the presses.
+ *
+ * Since: 1.26
+ */
+void
+clutter_scroll_actor_set_kinetic (ClutterScrollActor *actor,
+                                  gboolean            kinetic)
+{
+  ClutterScrollActorPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_SCROLL_ACTOR (actor));
+
+  priv = actor->priv;
+
+  kinetic = !!kinetic;
+  if (priv->kinetic == kinetic)
+    return;
+
+  priv->kinetic = kinetic;
+
+  if (priv->kinetic)
+    {
+      priv->capture_id =
+        g_signal_connect (actor, "captured-event",
+                          G_CALLBACK (on_captured_event),
+                          actor);
+    }
+  else
+    {
+      g_signal_handler_disconnect (actor, priv->capture_id);
+      priv->capture_id = 0;
+
+      clutter_scroll_actor_end_drag (actor);
+      clutter_scroll_actor_stop_kinetic (actor);
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_KINETIC]);
+}
+
+/**
+ * clutter_scroll_actor_get_kinetic:
+ * @actor: a #ClutterScrollActor
+ *
+ * Retrieves the #ClutterScrollActor:kinetic property.
+ *
+ * Return value: %TRUE if the contents can be dragged and flung
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_scroll_actor_get_kinetic (ClutterScrollActor *actor)
+{
+  g_return_val_if_fail (CLUTTER_IS_SCROLL_ACTOR (actor), FALSE);
+
+  return actor->priv->kinetic;
+}
+
+/**
+ * clutter_scroll_actor_set_deceleration:
+ * @actor: a #ClutterScrollActor
+ * @rate: the deceleration rate, between 0 and 1
+ *
+ * Sets the #ClutterScrollActor:deceleration property.
+ *
+ * Since: 1.26
+ */
+void
+clutter_scroll_actor_set_deceleration (ClutterScrollActor *actor,
+                                       gdouble             rate)
+{
+  g_return_if_fail (CLUTTER_IS_SCROLL_ACTOR (actor));
+  g_return_if_fail (rate <= 1.0);
+  g_return_if_fail (rate > 0.0);
+
+  if (actor->priv->deceleration_rate == rate)
+    return;
+
+  actor->priv->deceleration_rate = rate;
+
+  g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_DECELERATION]);
+}
+
+/**
+ * clutter_scroll_actor_get_deceleration:
+ * @actor: a #ClutterScrollActor
+ *
+ * Retrieves the #ClutterScrollActor:deceleration property.
+ *
+ * Return value: the deceleration rate
+ *
+ * Since: 1.26
+ */
+gdouble
+clutter_scroll_actor_get_deceleration (ClutterScrollActor *actor)
+{
+  g_return_val_if_fail (CLUTTER_IS_SCROLL_ACTOR (actor), default_deceleration_rate);
+
+  return actor->priv->deceleration_rate;
+}
+
+/**
+ * clutter_scroll_actor_fling:
+ * @actor: a #ClutterScrollActor
+ * @velocity_x: the horizontal velocity, in pixels per millisecond
+ * @velocity_y: the vertical velocity, in pixels per millisecond
+ *
+ * Starts scrolling the contents of @actor with the given velocity,
+ * decelerating at the #ClutterScrollActor:deceleration rate until
+ * they come to rest; the scrolling springs back from the edges of
+ * the contents.
+ *
+ * Positive velocities move the origin of the visible area towards
+ * the bottom right corner of the contents, like a drag towards the
+ * top left corner.
+ *
+ * Since: 1.26
+ */
+void
+clutter_scroll_actor_fling (ClutterScrollActor *actor,
+                            gfloat              velocity_x,
+                            gfloat              velocity_y)
+{
+  g_return_if_fail (CLUTTER_IS_SCROLL_ACTOR (actor));
+
+  clutter_scroll_actor_end_drag (actor);
+  clutter_scroll_actor_start_kinetic (actor, velocity_x, velocity_y);
+}
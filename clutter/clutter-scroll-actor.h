@@ -92,6 +92,21 @@ CLUTTER_AVAILABLE_IN_1_12
 void                    clutter_scroll_actor_scroll_to_rect     (ClutterScrollActor *actor,
                                                                  const ClutterRect  *rect);
 
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_scroll_actor_set_kinetic        (ClutterScrollActor *actor,
+                                                                 gboolean            kinetic);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_scroll_actor_get_kinetic        (ClutterScrollActor *actor);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_scroll_actor_set_deceleration   (ClutterScrollActor *actor,
+                                                                 gdouble             rate);
+CLUTTER_AVAILABLE_IN_1_26
+gdouble                 clutter_scroll_actor_get_deceleration   (ClutterScrollActor *actor);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_scroll_actor_fling              (ClutterScrollActor *actor,
+                                                                 gfloat              velocity_x,
+                                                                 gfloat              velocity_y);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_SCROLL_ACTOR_H__ */
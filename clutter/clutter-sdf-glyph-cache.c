@@ -0,0 +1,769 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterSdfGlyphCache: a cache of signed distance field glyphs.
+ *
+ * The glyph cache of CoglPango rasterizes each glyph at the size of the
+ * font, so a text that is scaled, or whose font size is animated, is
+ * either blurry or rasterized again for every size it goes through.
+ *
+ * This cache rasterizes each glyph once, at SDF_BASE_SIZE pixels and
+ * without hinting, and stores the distance of each texel from the edge
+ * of the glyph in an alpha-only atlas. The glyphs are then drawn at any
+ * size using linear filtering and a snippet which turns the distance
+ * back into coverage, with a smoothing factor depending on the final
+ * scale of the glyphs on the screen.
+ *
+ * The glyphs are keyed on the PangoFont used by the layout, so that the
+ * shaping of the text is not affected; only the rasterization is.
+ *
+ * The pipelines used to draw the glyphs are never modified once they
+ * have been used, since changing a pipeline referenced by the Cogl
+ * journal flushes it; instead, each atlas keeps one pipeline for each
+ * color and smoothing level. The journal can then batch the glyphs of
+ * every ClutterText using the same atlas into a single draw, until
+ * something else is painted in between.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include <pango/pangocairo.h>
+
+#include "clutter-sdf-glyph-cache.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-feature.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+/* the size at which the glyphs are rasterized, in pixels */
+#define SDF_BASE_SIZE   32
+
+/* the distance from the edge of the glyphs stored in the field, in
+ * pixels at SDF_BASE_SIZE
+ */
+#define SDF_SPREAD      4
+
+#define SDF_ATLAS_SIZE  1024
+
+/* the smoothing factors are rounded to SDF_SMOOTHING_STEPS levels per
+ * octave, starting at SDF_SMOOTHING_MIN, so that the texts drawn at
+ * similar scales share their pipelines
+ */
+#define SDF_SMOOTHING_MIN       0.01f
+#define SDF_SMOOTHING_MAX       0.5f
+#define SDF_SMOOTHING_STEPS     8
+
+/* the number of pipelines kept by each atlas before they are dropped,
+ * in case the color of a text is animated
+ */
+#define SDF_MAX_PIPELINES       64
+
+typedef struct _SdfAtlas
+{
+  CoglTexture *texture;
+
+  /* the pipeline with the texture of the atlas, copied for each color
+   * and smoothing level
+   */
+  CoglPipeline *pipeline;
+  int smoothing_uniform;
+
+  /* (color, smoothing level) → CoglPipeline */
+  GHashTable *pipelines;
+
+  /* the shelf currently being filled */
+  gint shelf_x;
+  gint shelf_y;
+  gint shelf_height;
+
+  /* the rectangles queued since the last submission */
+  GArray *rectangles;
+} SdfAtlas;
+
+typedef struct _SdfGlyph
+{
+  /* NULL for the glyphs without ink */
+  SdfAtlas *atlas;
+
+  /* the quad of the glyph relative to its origin, in pixels at
+   * SDF_BASE_SIZE
+   */
+  gfloat x, y;
+  gfloat width, height;
+
+  gfloat s1, t1, s2, t2;
+} SdfGlyph;
+
+typedef struct _SdfFont
+{
+  /* the font used by the layouts; the key of the entry */
+  PangoFont *font;
+
+  /* the same font at SDF_BASE_SIZE */
+  PangoFont *base_font;
+  cairo_scaled_font_t *scaled_font;
+
+  /* the ratio between the size of @font and SDF_BASE_SIZE */
+  gfloat scale;
+
+  /* PangoGlyph → SdfGlyph */
+  GHashTable *glyphs;
+} SdfFont;
+
+static GHashTable *sdf_fonts = NULL;
+static GPtrArray *sdf_atlases = NULL;
+static PangoContext *sdf_context = NULL;
+static CoglPipeline *sdf_base_pipeline = NULL;
+
+static const gchar sdf_glsl_declarations[] =
+"uniform float clutter_sdf_smoothing;\n";
+
+static const gchar sdf_glsl_post[] =
+"  cogl_texel = vec4 (smoothstep (0.5 - clutter_sdf_smoothing,\n"
+"                                 0.5 + clutter_sdf_smoothing,\n"
+"                                 cogl_texel.a));\n";
+
+/*< private >
+ * _clutter_sdf_glyph_cache_is_supported:
+ *
+ * Checks whether the distance field glyphs can be used; they need a
+ * snippet to be decoded.
+ *
+ * Return value: %TRUE if the distance field glyphs are supported
+ */
+gboolean
+_clutter_sdf_glyph_cache_is_supported (void)
+{
+  return clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL);
+}
+
+static void
+sdf_atlas_free (gpointer data)
+{
+  SdfAtlas *atlas = data;
+
+  g_hash_table_unref (atlas->pipelines);
+  cogl_object_unref (atlas->pipeline);
+  cogl_object_unref (atlas->texture);
+  g_array_unref (atlas->rectangles);
+
+  g_slice_free (SdfAtlas, atlas);
+}
+
+static void
+sdf_font_free (gpointer data)
+{
+  SdfFont *font = data;
+
+  g_hash_table_unref (font->glyphs);
+
+  if (font->scaled_font != NULL)
+    cairo_scaled_font_destroy (font->scaled_font);
+
+  g_clear_object (&font->base_font);
+  g_object_unref (font->font);
+
+  g_slice_free (SdfFont, font);
+}
+
+static void
+sdf_glyph_free (gpointer data)
+{
+  g_slice_free (SdfGlyph, data);
+}
+
+/*< private >
+ * _clutter_sdf_glyph_cache_clear:
+ *
+ * Drops every glyph from the cache, for instance because the font
+ * options changed.
+ */
+void
+_clutter_sdf_glyph_cache_clear (void)
+{
+  if (sdf_fonts == NULL)
+    return;
+
+  CLUTTER_NOTE (PANGO, "Clearing %u distance field fonts (%u atlases)",
+                g_hash_table_size (sdf_fonts),
+                sdf_atlases->len);
+
+  g_hash_table_remove_all (sdf_fonts);
+  g_ptr_array_set_size (sdf_atlases, 0);
+  g_clear_object (&sdf_context);
+}
+
+/*< private >
+ * _clutter_sdf_glyph_cache_get_size:
+ *
+ * Retrieves the size of the alpha-only textures of the atlases.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_sdf_glyph_cache_get_size (void)
+{
+  gsize size = 0;
+  guint i;
+
+  if (sdf_atlases == NULL)
+    return 0;
+
+  for (i = 0; i < sdf_atlases->len; i++)
+    {
+      SdfAtlas *atlas = g_ptr_array_index (sdf_atlases, i);
+
+      size += (gsize) cogl_texture_get_width (atlas->texture)
+            * cogl_texture_get_height (atlas->texture);
+    }
+
+  return size;
+}
+
+static void
+on_backend_changed (ClutterBackend *backend)
+{
+  _clutter_sdf_glyph_cache_clear ();
+}
+
+static PangoContext *
+sdf_get_context (void)
+{
+  if (G_UNLIKELY (sdf_context == NULL))
+    {
+      const cairo_font_options_t *context_options;
+      cairo_font_options_t *options;
+
+      sdf_context = _clutter_create_pango_context ();
+
+      context_options = pango_cairo_context_get_font_options (sdf_context);
+      if (context_options != NULL)
+        options = cairo_font_options_copy (context_options);
+      else
+        options = cairo_font_options_create ();
+
+      /* the outlines are scaled after the rasterization, so the hinting
+       * at the base size would be wrong at any other size
+       */
+      cairo_font_options_set_hint_style (options, CAIRO_HINT_STYLE_NONE);
+      cairo_font_options_set_hint_metrics (options, CAIRO_HINT_METRICS_OFF);
+      cairo_font_options_set_antialias (options, CAIRO_ANTIALIAS_GRAY);
+      pango_cairo_context_set_font_options (sdf_context, options);
+      cairo_font_options_destroy (options);
+    }
+
+  return sdf_context;
+}
+
+static SdfFont *
+sdf_font_lookup (PangoFont *font)
+{
+  PangoFontDescription *desc;
+  SdfFont *sdf_font;
+  gint size;
+
+  if (G_UNLIKELY (sdf_fonts == NULL))
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+
+      sdf_fonts = g_hash_table_new_full (NULL, NULL, NULL, sdf_font_free);
+      sdf_atlases = g_ptr_array_new_with_free_func (sdf_atlas_free);
+
+      g_signal_connect (backend, "font-changed",
+                        G_CALLBACK (on_backend_changed),
+                        NULL);
+    }
+
+  sdf_font = g_hash_table_lookup (sdf_fonts, font);
+  if (sdf_font != NULL)
+    return sdf_font;
+
+  sdf_font = g_slice_new0 (SdfFont);
+  sdf_font->font = g_object_ref (font);
+  sdf_font->glyphs = g_hash_table_new_full (NULL, NULL, NULL, sdf_glyph_free);
+
+  desc = pango_font_describe_with_absolute_size (font);
+  size = pango_font_description_get_size (desc);
+
+  if (size > 0)
+    {
+      pango_font_description_set_absolute_size (desc, SDF_BASE_SIZE * PANGO_SCALE);
+
+      sdf_font->scale = (gfloat) size / (SDF_BASE_SIZE * PANGO_SCALE);
+      sdf_font->base_font = pango_font_map_load_font (clutter_get_font_map (),
+                                                      sdf_get_context (),
+                                                      desc);
+
+      if (sdf_font->base_font != NULL && PANGO_IS_CAIRO_FONT (sdf_font->base_font))
+        {
+          sdf_font->scaled_font =
+            pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (sdf_font->base_font));
+
+          if (sdf_font->scaled_font != NULL)
+            cairo_scaled_font_reference (sdf_font->scaled_font);
+        }
+    }
+
+  pango_font_description_free (desc);
+
+  /* the fonts which could not be loaded are kept as well, so that we
+   * do not try again for each run
+   */
+  g_hash_table_insert (sdf_fonts, font, sdf_font);
+
+  return sdf_font;
+}
+
+static SdfAtlas *
+sdf_atlas_new (void)
+{
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  SdfAtlas *atlas;
+  guint8 *data;
+
+  if (G_UNLIKELY (sdf_base_pipeline == NULL))
+    {
+      CoglSnippet *snippet;
+
+      sdf_base_pipeline = cogl_pipeline_new (ctx);
+
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
+                                  sdf_glsl_declarations,
+                                  sdf_glsl_post);
+      cogl_pipeline_add_layer_snippet (sdf_base_pipeline, 0, snippet);
+      cogl_object_unref (snippet);
+
+      cogl_pipeline_set_layer_filters (sdf_base_pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (sdf_base_pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+    }
+
+  /* the gaps between the glyphs must not contain garbage */
+  data = g_malloc0 (SDF_ATLAS_SIZE * SDF_ATLAS_SIZE);
+
+  atlas = g_slice_new0 (SdfAtlas);
+  atlas->texture = cogl_texture_new_from_data (SDF_ATLAS_SIZE, SDF_ATLAS_SIZE,
+                                               COGL_TEXTURE_NO_SLICING |
+                                               COGL_TEXTURE_NO_AUTO_MIPMAP,
+                                               COGL_PIXEL_FORMAT_A_8,
+                                               COGL_PIXEL_FORMAT_A_8,
+                                               SDF_ATLAS_SIZE,
+                                               data);
+  g_free (data);
+
+  if (atlas->texture == NULL)
+    {
+      g_slice_free (SdfAtlas, atlas);
+      return NULL;
+    }
+
+  atlas->pipeline = cogl_pipeline_copy (sdf_base_pipeline);
+  cogl_pipeline_set_layer_texture (atlas->pipeline, 0, atlas->texture);
+  atlas->smoothing_uniform =
+    cogl_pipeline_get_uniform_location (atlas->pipeline, "clutter_sdf_smoothing");
+  atlas->pipelines = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+                                            g_free,
+                                            cogl_object_unref);
+  atlas->rectangles = g_array_new (FALSE, FALSE, sizeof (gfloat));
+
+  g_ptr_array_add (sdf_atlases, atlas);
+
+  CLUTTER_NOTE (PANGO, "Created distance field atlas %u", sdf_atlases->len);
+
+  return atlas;
+}
+
+/* reserves a @width x @height area in the last atlas, using a simple
+ * shelf packer, and creates a new atlas if it is full
+ */
+static SdfAtlas *
+sdf_atlas_reserve (gint  width,
+                   gint  height,
+                   gint *x,
+                   gint *y)
+{
+  SdfAtlas *atlas = NULL;
+
+  if (width > SDF_ATLAS_SIZE || height > SDF_ATLAS_SIZE)
+    return NULL;
+
+  if (sdf_atlases->len > 0)
+    {
+      atlas = g_ptr_array_index (sdf_atlases, sdf_atlases->len - 1);
+
+      if (atlas->shelf_x + width > SDF_ATLAS_SIZE)
+        {
+          atlas->shelf_y += atlas->shelf_height + 1;
+          atlas->shelf_x = 0;
+          atlas->shelf_height = 0;
+        }
+
+      if (atlas->shelf_y + height > SDF_ATLAS_SIZE)
+        atlas = NULL;
+    }
+
+  if (atlas == NULL)
+    {
+      atlas = sdf_atlas_new ();
+      if (atlas == NULL)
+        return NULL;
+    }
+
+  *x = atlas->shelf_x;
+  *y = atlas->shelf_y;
+
+  atlas->shelf_x += width + 1;
+  atlas->shelf_height = MAX (atlas->shelf_height, height);
+
+  return atlas;
+}
+
+/* computes the signed distance field of the coverage in @src; the
+ * texels inside the glyph are above 128, and the ones farther than
+ * SDF_SPREAD pixels from the edge are saturated
+ */
+static guint8 *
+sdf_compute_field (const guint8 *src,
+                   gint          stride,
+                   gint          width,
+                   gint          height)
+{
+  guint8 *field = g_malloc (width * height);
+  gint x, y;
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          gboolean inside = src[y * stride + x] >= 128;
+          gint best = (SDF_SPREAD + 1) * (SDF_SPREAD + 1);
+          gfloat distance, value;
+          gint dx, dy;
+
+          for (dy = -SDF_SPREAD; dy <= SDF_SPREAD; dy++)
+            {
+              gint sy = y + dy;
+
+              for (dx = -SDF_SPREAD; dx <= SDF_SPREAD; dx++)
+                {
+                  gint sx = x + dx;
+                  gboolean sample_inside;
+
+                  if (sx >= 0 && sx < width && sy >= 0 && sy < height)
+                    sample_inside = src[sy * stride + sx] >= 128;
+                  else
+                    sample_inside = FALSE;
+
+                  if (sample_inside != inside)
+                    best = MIN (best, dx * dx + dy * dy);
+                }
+            }
+
+          /* the edge lies half way between the two texel centers */
+          distance = MIN (sqrtf (best), SDF_SPREAD) - 0.5f;
+          if (!inside)
+            distance = -distance;
+
+          value = 0.5f + distance / (2.f * SDF_SPREAD);
+          field[y * width + x] = (guint8) (CLAMP (value, 0.f, 1.f) * 255.f + 0.5f);
+        }
+    }
+
+  return field;
+}
+
+static SdfGlyph *
+sdf_font_get_glyph (SdfFont    *font,
+                    PangoGlyph  glyph)
+{
+  cairo_text_extents_t extents;
+  cairo_surface_t *surface;
+  cairo_glyph_t cairo_glyph;
+  SdfGlyph *sdf_glyph;
+  guint8 *field;
+  cairo_t *cr;
+  gint x0, y0, width, height;
+  gint atlas_x, atlas_y;
+
+  sdf_glyph = g_hash_table_lookup (font->glyphs, GUINT_TO_POINTER (glyph));
+  if (sdf_glyph != NULL)
+    return sdf_glyph;
+
+  sdf_glyph = g_slice_new0 (SdfGlyph);
+  g_hash_table_insert (font->glyphs, GUINT_TO_POINTER (glyph), sdf_glyph);
+
+  cairo_glyph.index = glyph;
+  cairo_glyph.x = 0;
+  cairo_glyph.y = 0;
+  cairo_scaled_font_glyph_extents (font->scaled_font, &cairo_glyph, 1, &extents);
+
+  if (extents.width <= 0 || extents.height <= 0)
+    return sdf_glyph;
+
+  x0 = (gint) floor (extents.x_bearing) - SDF_SPREAD;
+  y0 = (gint) floor (extents.y_bearing) - SDF_SPREAD;
+  width = (gint) ceil (extents.x_bearing + extents.width) + SDF_SPREAD - x0;
+  height = (gint) ceil (extents.y_bearing + extents.height) + SDF_SPREAD - y0;
+
+  sdf_glyph->atlas = sdf_atlas_reserve (width, height, &atlas_x, &atlas_y);
+  if (sdf_glyph->atlas == NULL)
+    return sdf_glyph;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_A8, width, height);
+  cr = cairo_create (surface);
+  cairo_set_scaled_font (cr, font->scaled_font);
+  cairo_glyph.x = -x0;
+  cairo_glyph.y = -y0;
+  cairo_show_glyphs (cr, &cairo_glyph, 1);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  field = sdf_compute_field (cairo_image_surface_get_data (surface),
+                             cairo_image_surface_get_stride (surface),
+                             width, height);
+  cairo_surface_destroy (surface);
+
+  cogl_texture_set_region (sdf_glyph->atlas->texture,
+                           0, 0,
+                           atlas_x, atlas_y,
+                           width, height,
+                           width, height,
+                           COGL_PIXEL_FORMAT_A_8,
+                           width,
+                           field);
+  g_free (field);
+
+  sdf_glyph->x = x0;
+  sdf_glyph->y = y0;
+  sdf_glyph->width = width;
+  sdf_glyph->height = height;
+  sdf_glyph->s1 = (gfloat) atlas_x / SDF_ATLAS_SIZE;
+  sdf_glyph->t1 = (gfloat) atlas_y / SDF_ATLAS_SIZE;
+  sdf_glyph->s2 = (gfloat) (atlas_x + width) / SDF_ATLAS_SIZE;
+  sdf_glyph->t2 = (gfloat) (atlas_y + height) / SDF_ATLAS_SIZE;
+
+  return sdf_glyph;
+}
+
+static gint
+sdf_get_smoothing_level (gfloat smoothing)
+{
+  smoothing = CLAMP (smoothing, SDF_SMOOTHING_MIN, SDF_SMOOTHING_MAX);
+
+  return (gint) floorf (log2f (smoothing / SDF_SMOOTHING_MIN) * SDF_SMOOTHING_STEPS + 0.5f);
+}
+
+static CoglPipeline *
+sdf_atlas_get_pipeline (SdfAtlas        *atlas,
+                        const CoglColor *color,
+                        gint             level)
+{
+  CoglPipeline *pipeline;
+  gint64 key, *key_p;
+
+  key = ((gint64) level << 32) |
+        ((gint64) cogl_color_get_red_byte (color) << 24) |
+        ((gint64) cogl_color_get_green_byte (color) << 16) |
+        ((gint64) cogl_color_get_blue_byte (color) << 8) |
+        ((gint64) cogl_color_get_alpha_byte (color));
+
+  pipeline = g_hash_table_lookup (atlas->pipelines, &key);
+  if (pipeline != NULL)
+    return pipeline;
+
+  /* the journal keeps its own references on the pipelines */
+  if (g_hash_table_size (atlas->pipelines) >= SDF_MAX_PIPELINES)
+    g_hash_table_remove_all (atlas->pipelines);
+
+  pipeline = cogl_pipeline_copy (atlas->pipeline);
+  cogl_pipeline_set_color (pipeline, color);
+  cogl_pipeline_set_uniform_1f (pipeline,
+                                atlas->smoothing_uniform,
+                                SDF_SMOOTHING_MIN * exp2f ((gfloat) level / SDF_SMOOTHING_STEPS));
+
+  key_p = g_new (gint64, 1);
+  *key_p = key;
+  g_hash_table_insert (atlas->pipelines, key_p, pipeline);
+
+  return pipeline;
+}
+
+static void
+sdf_flush_atlases (CoglFramebuffer *framebuffer,
+                   const CoglColor *color,
+                   gint             level)
+{
+  guint i;
+
+  for (i = 0; i < sdf_atlases->len; i++)
+    {
+      SdfAtlas *atlas = g_ptr_array_index (sdf_atlases, i);
+
+      if (atlas->rectangles->len == 0)
+        continue;
+
+      cogl_framebuffer_draw_textured_rectangles (framebuffer,
+                                                 sdf_atlas_get_pipeline (atlas, color, level),
+                                                 (const float *) atlas->rectangles->data,
+                                                 atlas->rectangles->len / 8);
+
+      g_array_set_size (atlas->rectangles, 0);
+    }
+}
+
+/*< private >
+ * _clutter_sdf_glyph_cache_render_layout:
+ * @framebuffer: the framebuffer to draw on
+ * @layout: a #PangoLayout
+ * @x: the X coordinate of the layout
+ * @y: the Y coordinate of the layout
+ * @clip_y1: the top of the visible area, in Pango units relative to
+ *   the layout
+ * @clip_y2: the bottom of the visible area, in Pango units relative to
+ *   the layout
+ * @color: the color of the text
+ *
+ * Draws the lines of @layout intersecting the visible area using the
+ * distance field glyphs. The attributes changing the color of the text
+ * are ignored.
+ */
+void
+_clutter_sdf_glyph_cache_render_layout (CoglFramebuffer *framebuffer,
+                                        PangoLayout     *layout,
+                                        gint             x,
+                                        gint             y,
+                                        gint             clip_y1,
+                                        gint             clip_y2,
+                                        const CoglColor *color)
+{
+  PangoLayoutIter *iter;
+  CoglMatrix modelview;
+  CoglColor premult;
+  gfloat mv_scale;
+  gint current_level = -1;
+
+  g_return_if_fail (PANGO_IS_LAYOUT (layout));
+
+  premult = *color;
+  cogl_color_premultiply (&premult);
+
+  /* the scale of the text on the screen, to keep the edges one pixel
+   * wide regardless of the transformation of the actor
+   */
+  cogl_framebuffer_get_modelview_matrix (framebuffer, &modelview);
+  mv_scale = sqrtf (fabsf (modelview.xx * modelview.yy -
+                           modelview.xy * modelview.yx));
+  if (mv_scale <= 0.f)
+    return;
+
+  iter = pango_layout_get_iter (layout);
+
+  do
+    {
+      PangoLayoutRun *run = pango_layout_iter_get_run_readonly (iter);
+      PangoRectangle run_rect;
+      SdfFont *font;
+      gint line_y1, line_y2;
+      gfloat pen_x, pen_y;
+      gint level;
+      gint i;
+
+      if (run == NULL)
+        continue;
+
+      pango_layout_iter_get_line_yrange (iter, &line_y1, &line_y2);
+      if (line_y2 < clip_y1)
+        continue;
+
+      if (line_y1 > clip_y2)
+        break;
+
+      font = sdf_font_lookup (run->item->analysis.font);
+      if (font->scaled_font == NULL)
+        continue;
+
+      /* the runs drawn at the same smoothing level are submitted
+       * together
+       */
+      level = sdf_get_smoothing_level (0.7f / (2.f * SDF_SPREAD * font->scale * mv_scale));
+      if (level != current_level)
+        {
+          if (current_level >= 0)
+            sdf_flush_atlases (framebuffer, &premult, current_level);
+
+          current_level = level;
+        }
+
+      pango_layout_iter_get_run_extents (iter, NULL, &run_rect);
+
+      pen_x = x + (gfloat) run_rect.x / PANGO_SCALE;
+      pen_y = y + (gfloat) pango_layout_iter_get_baseline (iter) / PANGO_SCALE;
+
+      for (i = 0; i < run->glyphs->num_glyphs; i++)
+        {
+          PangoGlyphInfo *info = &run->glyphs->glyphs[i];
+          gfloat quad[8];
+
+          if (info->glyph != PANGO_GLYPH_EMPTY &&
+              (info->glyph & PANGO_GLYPH_UNKNOWN_FLAG) == 0)
+            {
+              SdfGlyph *glyph = sdf_font_get_glyph (font, info->glyph);
+
+              if (glyph->atlas != NULL)
+                {
+                  gfloat gx = pen_x + (gfloat) info->geometry.x_offset / PANGO_SCALE;
+                  gfloat gy = pen_y + (gfloat) info->geometry.y_offset / PANGO_SCALE;
+
+                  quad[0] = gx + glyph->x * font->scale;
+                  quad[1] = gy + glyph->y * font->scale;
+                  quad[2] = quad[0] + glyph->width * font->scale;
+                  quad[3] = quad[1] + glyph->height * font->scale;
+                  quad[4] = glyph->s1;
+                  quad[5] = glyph->t1;
+                  quad[6] = glyph->s2;
+                  quad[7] = glyph->t2;
+
+                  g_array_append_vals (glyph->atlas->rectangles, quad, 8);
+                }
+            }
+
+          pen_x += (gfloat) info->geometry.width / PANGO_SCALE;
+        }
+    }
+  while (pango_layout_iter_next_run (iter));
+
+  if (current_level >= 0)
+    sdf_flush_atlases (framebuffer, &premult, current_level);
+
+  pango_layout_iter_free (iter);
+}
@@ -0,0 +1,44 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_SDF_GLYPH_CACHE_H__
+#define __CLUTTER_SDF_GLYPH_CACHE_H__
+
+#include <clutter/clutter-types.h>
+#include <cogl/cogl.h>
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+gboolean        _clutter_sdf_glyph_cache_is_supported   (void);
+void            _clutter_sdf_glyph_cache_render_layout  (CoglFramebuffer *framebuffer,
+                                                         PangoLayout     *layout,
+                                                         gint             x,
+                                                         gint             y,
+                                                         gint             clip_y1,
+                                                         gint             clip_y2,
+                                                         const CoglColor *color);
+void            _clutter_sdf_glyph_cache_clear          (void);
+gsize           _clutter_sdf_glyph_cache_get_size       (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SDF_GLYPH_CACHE_H__ */
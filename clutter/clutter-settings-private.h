@@ -6,6 +6,32 @@
 
 G_BEGIN_DECLS
 
+/*< private >
+ * ClutterSettingsChange:
+ * @CLUTTER_SETTINGS_CHANGE_FONT_NAME: the default font changed; only
+ *   the text using the default font is affected
+ * @CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION: the font resolution
+ *   changed; the fonts with an absolute size are not affected
+ * @CLUTTER_SETTINGS_CHANGE_FONT_METRICS: the hinting or the installed
+ *   fonts changed; all the text has to be shaped again
+ * @CLUTTER_SETTINGS_CHANGE_FONT_RENDERING: the antialiasing or the
+ *   subpixel order changed; the glyphs change, but not their metrics
+ * @CLUTTER_SETTINGS_CHANGE_INPUT: the settings of the input handling,
+ *   or the password hint time, changed
+ * @CLUTTER_SETTINGS_CHANGE_SCALING: the window scaling factor changed
+ *
+ * The categories of the changes notified by #ClutterBackend::settings-changed,
+ * see _clutter_settings_get_changes().
+ */
+typedef enum {
+  CLUTTER_SETTINGS_CHANGE_FONT_NAME       = 1 << 0,
+  CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION = 1 << 1,
+  CLUTTER_SETTINGS_CHANGE_FONT_METRICS    = 1 << 2,
+  CLUTTER_SETTINGS_CHANGE_FONT_RENDERING  = 1 << 3,
+  CLUTTER_SETTINGS_CHANGE_INPUT           = 1 << 4,
+  CLUTTER_SETTINGS_CHANGE_SCALING         = 1 << 5
+} ClutterSettingsChange;
+
 void    _clutter_settings_set_backend           (ClutterSettings *settings,
                                                  ClutterBackend  *backend);
 void    _clutter_settings_read_from_key_file    (ClutterSettings *settings,
@@ -15,6 +41,8 @@ void    clutter_settings_set_property_internal (ClutterSettings *settings,
                                                 const char *property,
                                                 GValue *value);
 
+ClutterSettingsChange   _clutter_settings_get_changes   (ClutterSettings *settings);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_SETTINGS_PRIVATE_H__ */
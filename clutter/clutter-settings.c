@@ -79,6 +79,10 @@ struct _ClutterSettings
 
   gint window_scaling_factor;
   gint unscaled_font_dpi;
+
+  /* the changes since the last ::settings-changed emission */
+  ClutterSettingsChange changes;
+
   guint fixed_scaling_factor : 1;
 };
 
@@ -267,7 +271,10 @@ settings_update_fontmap (ClutterSettings *self,
       self->last_fontconfig_timestamp = stamp;
 
       if (update_needed)
-        g_signal_emit_by_name (self->backend, "font-changed");
+        {
+          self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_METRICS;
+          g_signal_emit_by_name (self->backend, "font-changed");
+        }
     }
 #endif /* HAVE_PANGO_FT2 */
 }
@@ -300,51 +307,61 @@ clutter_settings_set_property (GObject      *gobject,
 
     case PROP_DOUBLE_CLICK_TIME:
       self->double_click_time = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_INPUT;
       break;
 
     case PROP_DOUBLE_CLICK_DISTANCE:
       self->double_click_distance = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_INPUT;
       break;
 
     case PROP_DND_DRAG_THRESHOLD:
       self->dnd_drag_threshold = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_INPUT;
       break;
 
     case PROP_FONT_NAME:
       g_free (self->font_name);
       self->font_name = g_value_dup_string (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_NAME;
       settings_update_font_name (self);
       break;
 
     case PROP_FONT_ANTIALIAS:
       self->xft_antialias = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_RENDERING;
       settings_update_font_options (self);
       break;
 
     case PROP_FONT_DPI:
       self->font_dpi = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION;
       settings_update_resolution (self);
       break;
 
     case PROP_FONT_HINTING:
       self->xft_hinting = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_METRICS;
       settings_update_font_options (self);
       break;
 
     case PROP_FONT_HINT_STYLE:
       g_free (self->xft_hint_style);
       self->xft_hint_style = g_value_dup_string (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_METRICS;
       settings_update_font_options (self);
       break;
 
     case PROP_FONT_RGBA:
       g_free (self->xft_rgba);
       self->xft_rgba = g_value_dup_string (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_RENDERING;
       settings_update_font_options (self);
       break;
 
     case PROP_LONG_PRESS_DURATION:
       self->long_press_duration = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_INPUT;
       break;
 
     case PROP_FONTCONFIG_TIMESTAMP:
@@ -353,6 +370,7 @@ clutter_settings_set_property (GObject      *gobject,
 
     case PROP_PASSWORD_HINT_TIME:
       self->password_hint_time = g_value_get_uint (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_INPUT;
       break;
 
     case PROP_WINDOW_SCALING_FACTOR:
@@ -360,11 +378,13 @@ clutter_settings_set_property (GObject      *gobject,
         {
           self->window_scaling_factor = g_value_get_int (value);
           self->fixed_scaling_factor = TRUE;
+          self->changes |= CLUTTER_SETTINGS_CHANGE_SCALING;
         }
       break;
 
     case PROP_UNSCALED_FONT_DPI:
       self->font_dpi = g_value_get_int (value);
+      self->changes |= CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION;
       settings_update_resolution (self);
       break;
 
@@ -392,6 +412,24 @@ clutter_settings_set_property_internal (ClutterSettings *self,
     self->fixed_scaling_factor = FALSE;
 }
 
+/*< private >
+ * _clutter_settings_get_changes:
+ * @settings: a #ClutterSettings
+ *
+ * Retrieves the categories of the changes being notified; it is only
+ * meaningful from within the handlers of the #ClutterBackend::font-changed,
+ * #ClutterBackend::resolution-changed and #ClutterBackend::settings-changed
+ * signals emitted by @settings.
+ *
+ * Return value: the changes since the last emission of
+ *   #ClutterBackend::settings-changed
+ */
+ClutterSettingsChange
+_clutter_settings_get_changes (ClutterSettings *settings)
+{
+  return settings->changes;
+}
+
 static void
 clutter_settings_get_property (GObject    *gobject,
                                guint       prop_id,
@@ -471,6 +509,8 @@ clutter_settings_dispatch_properties_changed (GObject     *gobject,
   /* emit settings-changed just once for multiple properties */
   if (self->backend != NULL)
     g_signal_emit_by_name (self->backend, "settings-changed");
+
+  self->changes = 0;
 }
 
 static void
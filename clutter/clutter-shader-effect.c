@@ -115,6 +115,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 /* XXX: This file depends on the cogl_program_ api with has been
  * removed for Cogl 2.0 so we undef COGL_ENABLE_EXPERIMENTAL_2_0_API
  * for this file for now */
@@ -129,14 +131,62 @@
 #include "clutter-private.h"
 #include "clutter-shader-types.h"
 
+typedef enum
+{
+  SHADER_UNIFORM_INT,
+  SHADER_UNIFORM_FLOAT,
+  SHADER_UNIFORM_MATRIX
+} ShaderUniformType;
+
+/* the values of the uniforms are kept already converted from the
+ * GValues they are set with, and only the changed ones are uploaded
+ */
 typedef struct _ShaderUniform
 {
   gchar *name;
-  GType type;
-  GValue value;
+
+  /* the location of the uniform on the pipelines, resolved the first
+   * time it is uploaded
+   */
   int location;
+
+  ShaderUniformType type;
+
+  /* the number of components, or the size of the matrix */
+  int size;
+
+  union {
+    int ints[4];
+    float floats[16];
+  } value;
+
+  guint dirty : 1;
 } ShaderUniform;
 
+/* the shaders and programs are shared between all the effects using the
+ * same source, so that a source is only compiled and linked once
+ * regardless of how many effects use it at the same time
+ */
+typedef struct _ShaderCacheEntry
+{
+  /* the type of the shader, followed by its source */
+  gchar *key;
+
+  CoglHandle shader;
+
+  /* COGL_INVALID_HANDLE if the shader did not compile */
+  CoglHandle program;
+
+  guint use_count;
+} ShaderCacheEntry;
+
+static GHashTable *shader_cache = NULL;
+
+/* set on the target pipeline holding the uniforms of an effect, so
+ * that all of them are uploaded again if the pipeline is replaced
+ */
+static CoglUserDataKey uniforms_target_key;
+
 struct _ClutterShaderEffectPrivate
 {
   ClutterActor *actor;
@@ -146,7 +196,15 @@ struct _ClutterShaderEffectPrivate
   CoglHandle program;
   CoglHandle shader;
 
-  GHashTable *uniforms;
+  /* the entry of the source set using set_shader_source() */
+  ShaderCacheEntry *cache_entry;
+
+  /* the ShaderUniform structures, and their indices by name */
+  GArray *uniforms;
+  GHashTable *uniform_indices;
+
+  /* whether any of the uniforms has to be uploaded */
+  guint uniforms_dirty : 1;
 };
 
 typedef struct _ClutterShaderEffectClassPrivate
@@ -177,6 +235,102 @@ G_DEFINE_TYPE_WITH_CODE (ClutterShaderEffect,
                          g_type_add_class_private (g_define_type_id,
                                                    sizeof (ClutterShaderEffectClassPrivate)))
 
+static void
+shader_cache_entry_free (gpointer data)
+{
+  ShaderCacheEntry *entry = data;
+
+  if (entry->program != COGL_INVALID_HANDLE)
+    cogl_handle_unref (entry->program);
+
+  cogl_handle_unref (entry->shader);
+  g_free (entry->key);
+
+  g_slice_free (ShaderCacheEntry, entry);
+}
+
+static ShaderCacheEntry *
+shader_cache_acquire (ClutterShaderType  shader_type,
+                      const gchar       *source)
+{
+  ShaderCacheEntry *entry;
+  gchar *key;
+
+  if (G_UNLIKELY (shader_cache == NULL))
+    shader_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          NULL,
+                                          shader_cache_entry_free);
+
+  key = g_strconcat (shader_type == CLUTTER_VERTEX_SHADER ? "vertex\n"
+                                                          : "fragment\n",
+                     source,
+                     NULL);
+
+  entry = g_hash_table_lookup (shader_cache, key);
+  if (entry != NULL)
+    {
+      CLUTTER_NOTE (SHADER, "Reusing the compiled shader effect");
+
+      g_free (key);
+      entry->use_count += 1;
+
+      return entry;
+    }
+
+  entry = g_slice_new0 (ShaderCacheEntry);
+  entry->key = key;
+  entry->use_count = 1;
+
+  switch (shader_type)
+    {
+    case CLUTTER_FRAGMENT_SHADER:
+      entry->shader = cogl_create_shader (COGL_SHADER_TYPE_FRAGMENT);
+      break;
+
+    case CLUTTER_VERTEX_SHADER:
+      entry->shader = cogl_create_shader (COGL_SHADER_TYPE_VERTEX);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  cogl_shader_source (entry->shader, source);
+
+  CLUTTER_NOTE (SHADER, "Compiling shader effect");
+
+  cogl_shader_compile (entry->shader);
+
+  if (cogl_shader_is_compiled (entry->shader))
+    {
+      entry->program = cogl_create_program ();
+
+      cogl_program_attach_shader (entry->program, entry->shader);
+
+      cogl_program_link (entry->program);
+    }
+  else
+    {
+      gchar *log_buf = cogl_shader_get_info_log (entry->shader);
+
+      g_warning (G_STRLOC ": Unable to compile the GLSL shader: %s", log_buf);
+      g_free (log_buf);
+    }
+
+  g_hash_table_insert (shader_cache, entry->key, entry);
+
+  return entry;
+}
+
+static void
+shader_cache_release (ShaderCacheEntry *entry)
+{
+  entry->use_count -= 1;
+
+  if (entry->use_count == 0)
+    g_hash_table_remove (shader_cache, entry->key);
+}
+
 static inline void
 clutter_shader_effect_clear (ClutterShaderEffect *self,
                              gboolean             reset_uniforms)
@@ -197,97 +351,88 @@ clutter_shader_effect_clear (ClutterShaderEffect *self,
       priv->program = COGL_INVALID_HANDLE;
     }
 
+  if (priv->cache_entry != NULL)
+    {
+      shader_cache_release (priv->cache_entry);
+
+      priv->cache_entry = NULL;
+    }
+
   if (reset_uniforms && priv->uniforms != NULL)
     {
-      g_hash_table_destroy (priv->uniforms);
-      priv->uniforms = NULL;
+      g_clear_pointer (&priv->uniform_indices, g_hash_table_destroy);
+      g_clear_pointer (&priv->uniforms, g_array_unref);
+      priv->uniforms_dirty = FALSE;
     }
 
   priv->actor = NULL;
 }
 
 static void
-clutter_shader_effect_update_uniforms (ClutterShaderEffect *effect)
+clutter_shader_effect_update_uniforms (ClutterShaderEffect *effect,
+                                       CoglPipeline        *pipeline)
 {
   ClutterShaderEffectPrivate *priv = effect->priv;
-  GHashTableIter iter;
-  gpointer key, value;
-  gsize size;
-
-  if (priv->program == COGL_INVALID_HANDLE)
-    return;
+  guint i;
 
   if (priv->uniforms == NULL)
     return;
 
-  key = value = NULL;
-  g_hash_table_iter_init (&iter, priv->uniforms);
-  while (g_hash_table_iter_next (&iter, &key, &value))
+  /* a new target pipeline has none of the uniforms */
+  if (cogl_object_get_user_data (COGL_OBJECT (pipeline),
+                                 &uniforms_target_key) != effect)
     {
-      ShaderUniform *uniform = value;
+      cogl_object_set_user_data (COGL_OBJECT (pipeline),
+                                 &uniforms_target_key,
+                                 effect,
+                                 NULL);
 
-      if (uniform->location == -1)
-        uniform->location = cogl_program_get_uniform_location (priv->program,
-                                                               uniform->name);
+      for (i = 0; i < priv->uniforms->len; i++)
+        g_array_index (priv->uniforms, ShaderUniform, i).dirty = TRUE;
 
-      if (CLUTTER_VALUE_HOLDS_SHADER_FLOAT (&uniform->value))
-        {
-          const float *floats;
+      priv->uniforms_dirty = TRUE;
+    }
 
-          floats = clutter_value_get_shader_float (&uniform->value, &size);
-          cogl_program_set_uniform_float (priv->program, uniform->location,
-                                          size, 1,
-                                          floats);
-        }
-      else if (CLUTTER_VALUE_HOLDS_SHADER_INT (&uniform->value))
-        {
-          const int *ints;
+  if (!priv->uniforms_dirty)
+    return;
 
-          ints = clutter_value_get_shader_int (&uniform->value, &size);
-          cogl_program_set_uniform_int (priv->program, uniform->location,
-                                        size, 1,
-                                        ints);
-        }
-      else if (CLUTTER_VALUE_HOLDS_SHADER_MATRIX (&uniform->value))
-        {
-          const float *matrix;
+  for (i = 0; i < priv->uniforms->len; i++)
+    {
+      ShaderUniform *uniform = &g_array_index (priv->uniforms, ShaderUniform, i);
 
-          matrix = clutter_value_get_shader_matrix (&uniform->value, &size);
-          cogl_program_set_uniform_matrix (priv->program, uniform->location,
-                                           size, 1,
-                                           FALSE,
-                                           matrix);
-        }
-      else if (G_VALUE_HOLDS_FLOAT (&uniform->value))
-        {
-          const float float_val = g_value_get_float (&uniform->value);
+      if (!uniform->dirty)
+        continue;
 
-          cogl_program_set_uniform_float (priv->program, uniform->location,
-                                          1, 1,
-                                          &float_val);
-        }
-      else if (G_VALUE_HOLDS_DOUBLE (&uniform->value))
-        {
-          const float float_val =
-            (float) g_value_get_double (&uniform->value);
+      if (uniform->location == -1)
+        uniform->location = cogl_pipeline_get_uniform_location (pipeline,
+                                                                uniform->name);
 
-          cogl_program_set_uniform_float (priv->program, uniform->location,
-                                          1, 1,
-                                          &float_val);
-        }
-      else if (G_VALUE_HOLDS_INT (&uniform->value))
+      switch (uniform->type)
         {
-          const int int_val = g_value_get_int (&uniform->value);
-
-          cogl_program_set_uniform_int (priv->program, uniform->location,
-                                        1, 1,
-                                        &int_val);
+        case SHADER_UNIFORM_INT:
+          cogl_pipeline_set_uniform_int (pipeline, uniform->location,
+                                         uniform->size, 1,
+                                         uniform->value.ints);
+          break;
+
+        case SHADER_UNIFORM_FLOAT:
+          cogl_pipeline_set_uniform_float (pipeline, uniform->location,
+                                           uniform->size, 1,
+                                           uniform->value.floats);
+          break;
+
+        case SHADER_UNIFORM_MATRIX:
+          cogl_pipeline_set_uniform_matrix (pipeline, uniform->location,
+                                            uniform->size, 1,
+                                            FALSE,
+                                            uniform->value.floats);
+          break;
         }
-      else
-        g_warning ("Invalid uniform of type '%s' for name '%s'",
-                   g_type_name (G_VALUE_TYPE (&uniform->value)),
-                   uniform->name);
+
+      uniform->dirty = FALSE;
     }
+
+  priv->uniforms_dirty = FALSE;
 }
 
 static void
@@ -322,26 +467,6 @@ clutter_shader_effect_set_actor (ClutterActorMeta *meta,
                 G_OBJECT_TYPE_NAME (meta));
 }
 
-static CoglHandle
-clutter_shader_effect_create_shader (ClutterShaderEffect *self)
-{
-  ClutterShaderEffectPrivate *priv = self->priv;
-
-  switch (priv->shader_type)
-    {
-    case CLUTTER_FRAGMENT_SHADER:
-      return cogl_create_shader (COGL_SHADER_TYPE_FRAGMENT);
-      break;
-
-    case CLUTTER_VERTEX_SHADER:
-      return cogl_create_shader (COGL_SHADER_TYPE_VERTEX);
-      break;
-
-    default:
-      g_assert_not_reached ();
-    }
-}
-
 static void
 clutter_shader_effect_try_static_source (ClutterShaderEffect *self)
 {
@@ -360,36 +485,22 @@ clutter_shader_effect_try_static_source (ClutterShaderEffect *self)
 
       if (class_priv->shader == COGL_INVALID_HANDLE)
         {
+          ShaderCacheEntry *entry;
           gchar *source;
 
-          class_priv->shader = clutter_shader_effect_create_shader (self);
-
           source = shader_effect_class->get_static_shader_source (self);
 
-          cogl_shader_source (class_priv->shader, source);
+          /* the class keeps using the entry for as long as the
+           * process runs
+           */
+          entry = shader_cache_acquire (priv->shader_type, source);
 
           g_free (source);
 
-          CLUTTER_NOTE (SHADER, "Compiling shader effect");
-
-          cogl_shader_compile (class_priv->shader);
-
-          if (cogl_shader_is_compiled (class_priv->shader))
-            {
-              class_priv->program = cogl_create_program ();
+          class_priv->shader = cogl_handle_ref (entry->shader);
 
-              cogl_program_attach_shader (class_priv->program,
-                                          class_priv->shader);
-
-              cogl_program_link (class_priv->program);
-            }
-          else
-            {
-              gchar *log_buf = cogl_shader_get_info_log (class_priv->shader);
-
-              g_warning (G_STRLOC ": Unable to compile the GLSL shader: %s", log_buf);
-              g_free (log_buf);
-            }
+          if (entry->program != COGL_INVALID_HANDLE)
+            class_priv->program = cogl_handle_ref (entry->program);
         }
 
       priv->shader = cogl_handle_ref (class_priv->shader);
@@ -421,12 +532,12 @@ clutter_shader_effect_paint_target (ClutterOffscreenEffect *effect)
   CLUTTER_NOTE (SHADER, "Applying the shader effect of type '%s'",
                 G_OBJECT_TYPE_NAME (effect));
 
-  clutter_shader_effect_update_uniforms (CLUTTER_SHADER_EFFECT (effect));
-
   /* associate the program to the offscreen target material */
   material = clutter_offscreen_effect_get_target (effect);
   cogl_pipeline_set_user_program (material, priv->program);
 
+  clutter_shader_effect_update_uniforms (self, material);
+
 out:
   /* paint the offscreen buffer */
   parent = CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_shader_effect_parent_class);
@@ -572,44 +683,84 @@ clutter_shader_effect_get_program (ClutterShaderEffect *effect)
 }
 
 static void
-shader_uniform_free (gpointer data)
+shader_uniform_clear (gpointer data)
 {
-  if (data != NULL)
-    {
-      ShaderUniform *uniform = data;
-
-      g_value_unset (&uniform->value);
-      g_free (uniform->name);
+  ShaderUniform *uniform = data;
 
-      g_slice_free (ShaderUniform, uniform);
-    }
+  g_free (uniform->name);
 }
 
-static ShaderUniform *
-shader_uniform_new (const gchar  *name,
-                    const GValue *value)
+/* converts @value into the typed value of @uniform, returning whether
+ * the value changed
+ */
+static gboolean
+shader_uniform_set_value (ShaderUniform *uniform,
+                          const GValue  *value)
 {
-  ShaderUniform *retval;
-
-  retval = g_slice_new0 (ShaderUniform);
-  retval->name = g_strdup (name);
-  retval->type = G_VALUE_TYPE (value);
-  retval->location = -1;
+  ShaderUniformType type;
+  const void *values;
+  int ints[1];
+  float floats[1];
+  gsize size, n_values;
 
-  g_value_init (&retval->value, retval->type);
-  g_value_copy (value, &retval->value);
+  if (CLUTTER_VALUE_HOLDS_SHADER_FLOAT (value))
+    {
+      type = SHADER_UNIFORM_FLOAT;
+      values = clutter_value_get_shader_float (value, &size);
+      n_values = size;
+    }
+  else if (CLUTTER_VALUE_HOLDS_SHADER_INT (value))
+    {
+      type = SHADER_UNIFORM_INT;
+      values = clutter_value_get_shader_int (value, &size);
+      n_values = size;
+    }
+  else if (CLUTTER_VALUE_HOLDS_SHADER_MATRIX (value))
+    {
+      type = SHADER_UNIFORM_MATRIX;
+      values = clutter_value_get_shader_matrix (value, &size);
+      n_values = size * size;
+    }
+  else if (G_VALUE_HOLDS_FLOAT (value))
+    {
+      type = SHADER_UNIFORM_FLOAT;
+      floats[0] = g_value_get_float (value);
+      values = floats;
+      size = n_values = 1;
+    }
+  else if (G_VALUE_HOLDS_DOUBLE (value))
+    {
+      type = SHADER_UNIFORM_FLOAT;
+      floats[0] = (float) g_value_get_double (value);
+      values = floats;
+      size = n_values = 1;
+    }
+  else if (G_VALUE_HOLDS_INT (value))
+    {
+      type = SHADER_UNIFORM_INT;
+      ints[0] = g_value_get_int (value);
+      values = ints;
+      size = n_values = 1;
+    }
+  else
+    {
+      g_warning ("Invalid uniform of type '%s' for name '%s'",
+                 g_type_name (G_VALUE_TYPE (value)),
+                 uniform->name);
+      return FALSE;
+    }
 
-  return retval;
-}
+  if (uniform->type == type &&
+      uniform->size == (int) size &&
+      memcmp (&uniform->value, values, n_values * 4) == 0)
+    return FALSE;
 
-static void
-shader_uniform_update (ShaderUniform *uniform,
-                       const GValue  *value)
-{
-  g_value_unset (&uniform->value);
+  uniform->type = type;
+  uniform->size = size;
+  memcpy (&uniform->value, values, n_values * 4);
+  uniform->dirty = TRUE;
 
-  g_value_init (&uniform->value, G_VALUE_TYPE (value));
-  g_value_copy (value, &uniform->value);
+  return TRUE;
 }
 
 static inline void
@@ -619,22 +770,45 @@ clutter_shader_effect_add_uniform (ClutterShaderEffect *effect,
 {
   ClutterShaderEffectPrivate *priv = effect->priv;
   ShaderUniform *uniform;
+  gpointer index_p;
 
   if (priv->uniforms == NULL)
     {
-      priv->uniforms = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                              NULL,
-                                              shader_uniform_free);
+      priv->uniforms = g_array_new (FALSE, TRUE, sizeof (ShaderUniform));
+      g_array_set_clear_func (priv->uniforms, shader_uniform_clear);
+
+      priv->uniform_indices = g_hash_table_new (g_str_hash, g_str_equal);
     }
 
-  uniform = g_hash_table_lookup (priv->uniforms, name);
-  if (uniform == NULL)
+  if (g_hash_table_lookup_extended (priv->uniform_indices, name,
+                                    NULL, &index_p))
     {
-      uniform = shader_uniform_new (name, value);
-      g_hash_table_insert (priv->uniforms, uniform->name, uniform);
+      uniform = &g_array_index (priv->uniforms, ShaderUniform,
+                                GPOINTER_TO_UINT (index_p));
+
+      if (!shader_uniform_set_value (uniform, value))
+        return;
     }
   else
-    shader_uniform_update (uniform, value);
+    {
+      ShaderUniform new_uniform = { NULL, };
+
+      new_uniform.name = g_strdup (name);
+      new_uniform.location = -1;
+      new_uniform.size = -1;
+
+      if (!shader_uniform_set_value (&new_uniform, value))
+        {
+          g_free (new_uniform.name);
+          return;
+        }
+
+      g_hash_table_insert (priv->uniform_indices, new_uniform.name,
+                           GUINT_TO_POINTER (priv->uniforms->len));
+      g_array_append_val (priv->uniforms, new_uniform);
+    }
+
+  priv->uniforms_dirty = TRUE;
 
   if (priv->actor != NULL && !CLUTTER_ACTOR_IN_PAINT (priv->actor))
     clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
@@ -899,29 +1073,130 @@ clutter_shader_effect_set_shader_source (ClutterShaderEffect *effect,
   if (priv->shader != COGL_INVALID_HANDLE)
     return TRUE;
 
-  priv->shader = clutter_shader_effect_create_shader (effect);
+  priv->cache_entry = shader_cache_acquire (priv->shader_type, source);
 
-  cogl_shader_source (priv->shader, source);
+  priv->shader = cogl_handle_ref (priv->cache_entry->shader);
 
-  CLUTTER_NOTE (SHADER, "Compiling shader effect");
+  if (priv->cache_entry->program != COGL_INVALID_HANDLE)
+    priv->program = cogl_handle_ref (priv->cache_entry->program);
 
-  cogl_shader_compile (priv->shader);
+  return TRUE;
+}
 
-  if (cogl_shader_is_compiled (priv->shader))
-    {
-      priv->program = cogl_create_program ();
+/**
+ * clutter_shader_effect_precompile_types:
+ * @effect_types: (array length=n_types): the types of the effects to
+ *   compile, sub-types of #ClutterShaderEffect
+ * @n_types: the number of types in @effect_types
+ *
+ * Compiles and links the shaders of the given #ClutterShaderEffect
+ * sub-types, and uses them once, instead of doing so the first time
+ * an effect of each type is painted.
+ *
+ * Compiling a shader can take a noticeable time with some drivers, so
+ * this function can be called while showing a splash screen, with the
+ * effects used by the transitions of the application. The shaders are
+ * kept until the end of the process.
+ *
+ * The shaders of the types implementing the
+ * #ClutterShaderEffectClass.get_static_shader_source() virtual function,
+ * or calling clutter_shader_effect_set_shader_source() when an instance
+ * is created, are compiled; the other types are ignored.
+ *
+ * Return value: the number of types whose shaders were compiled
+ *
+ * Since: 1.26
+ */
+guint
+clutter_shader_effect_precompile_types (const GType *effect_types,
+                                        guint        n_types)
+{
+  CoglContext *ctx;
+  CoglTexture *texture;
+  CoglOffscreen *offscreen;
+  CoglFramebuffer *fb;
+  CoglError *error = NULL;
+  guint i, n_compiled = 0;
+
+  g_return_val_if_fail (effect_types != NULL || n_types == 0, 0);
+
+  if (n_types == 0)
+    return 0;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return 0;
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
 
-      cogl_program_attach_shader (priv->program, priv->shader);
+  texture = cogl_texture_new_with_size (1, 1,
+                                        COGL_TEXTURE_NO_SLICING,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  offscreen = cogl_offscreen_new_with_texture (texture);
+  fb = COGL_FRAMEBUFFER (offscreen);
 
-      cogl_program_link (priv->program);
+  if (!cogl_framebuffer_allocate (fb, &error))
+    {
+      g_warning ("Unable to precompile the shader effects: %s",
+                 error->message);
+      cogl_error_free (error);
+      goto out;
     }
-  else
+
+  cogl_framebuffer_orthographic (fb, 0, 0, 1, 1, -1, 100);
+
+  for (i = 0; i < n_types; i++)
     {
-      gchar *log_buf = cogl_shader_get_info_log (priv->shader);
+      ClutterShaderEffect *effect;
+      ClutterShaderEffectPrivate *priv;
 
-      g_warning (G_STRLOC ": Unable to compile the GLSL shader: %s", log_buf);
-      g_free (log_buf);
+      if (!g_type_is_a (effect_types[i], CLUTTER_TYPE_SHADER_EFFECT) ||
+          G_TYPE_IS_ABSTRACT (effect_types[i]))
+        {
+          g_warning ("The type '%s' is not an instantiable ClutterShaderEffect",
+                     g_type_name (effect_types[i]));
+          continue;
+        }
+
+      effect = g_object_new (effect_types[i], NULL);
+      priv = effect->priv;
+
+      if (priv->shader == COGL_INVALID_HANDLE)
+        clutter_shader_effect_try_static_source (effect);
+
+      if (priv->program != COGL_INVALID_HANDLE)
+        {
+          CoglPipeline *pipeline = cogl_pipeline_new (ctx);
+
+          CLUTTER_NOTE (SHADER, "Precompiling the shader effect of type '%s'",
+                        G_OBJECT_TYPE_NAME (effect));
+
+          /* the programs are generated for the layers of the pipeline,
+           * so this must match the target of the offscreen effect
+           */
+          cogl_pipeline_set_layer_null_texture (pipeline, 0,
+                                                COGL_TEXTURE_TYPE_2D);
+          cogl_pipeline_set_user_program (pipeline, priv->program);
+
+          cogl_framebuffer_draw_rectangle (fb, pipeline, 0, 0, 1, 1);
+
+          cogl_object_unref (pipeline);
+
+          /* keep the source compiled once the effect is gone */
+          if (priv->cache_entry != NULL)
+            priv->cache_entry->use_count += 1;
+
+          n_compiled += 1;
+        }
+
+      g_object_unref (effect);
     }
 
-  return TRUE;
+  /* the drivers can defer the compilation until the first draw */
+  cogl_framebuffer_finish (fb);
+
+out:
+  cogl_object_unref (offscreen);
+  cogl_object_unref (texture);
+
+  return n_compiled;
 }
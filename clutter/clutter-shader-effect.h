@@ -116,6 +116,10 @@ CoglHandle      clutter_shader_effect_get_shader        (ClutterShaderEffect *ef
 CLUTTER_AVAILABLE_IN_1_4
 CoglHandle      clutter_shader_effect_get_program       (ClutterShaderEffect *effect);
 
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_shader_effect_precompile_types  (const GType         *effect_types,
+                                                         guint                n_types);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_SHADER_EFFECT_H__ */
@@ -44,7 +44,7 @@
 #include "clutter-snap-constraint.h"
 
 #include "clutter-actor-private.h"
-#include "clutter-constraint.h"
+#include "clutter-constraint-private.h"
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-private.h"
@@ -89,19 +89,13 @@ G_DEFINE_TYPE (ClutterSnapConstraint,
 
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
 
-static void
-source_queue_relayout (ClutterActor          *source,
-                       ClutterSnapConstraint *constraint)
-{
-  if (constraint->actor != NULL)
-    _clutter_actor_queue_only_relayout (constraint->actor);
-}
-
 static void
 source_destroyed (ClutterActor          *actor,
                   ClutterSnapConstraint *constraint)
 {
   constraint->source = NULL;
+
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (constraint), NULL);
 }
 
 static inline void
@@ -222,9 +216,6 @@ clutter_snap_constraint_dispose (GObject *gobject)
       g_signal_handlers_disconnect_by_func (snap->source,
                                             G_CALLBACK (source_destroyed),
                                             snap);
-      g_signal_handlers_disconnect_by_func (snap->source,
-                                            G_CALLBACK (source_queue_relayout),
-                                            snap);
       snap->source = NULL;
     }
 
@@ -445,17 +436,13 @@ clutter_snap_constraint_set_source (ClutterSnapConstraint *constraint,
       g_signal_handlers_disconnect_by_func (old_source,
                                             G_CALLBACK (source_destroyed),
                                             constraint);
-      g_signal_handlers_disconnect_by_func (old_source,
-                                            G_CALLBACK (source_queue_relayout),
-                                            constraint);
     }
 
   constraint->source = source;
+  _clutter_constraint_set_source (CLUTTER_CONSTRAINT (constraint), source);
+
   if (constraint->source != NULL)
     {
-      g_signal_connect (constraint->source, "queue-relayout",
-                        G_CALLBACK (source_queue_relayout),
-                        constraint);
       g_signal_connect (constraint->source, "destroy",
                         G_CALLBACK (source_destroyed),
                         constraint);
@@ -0,0 +1,524 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ * ClutterSpatialIndex: a bounding volume hierarchy of 2D boxes.
+ *
+ * The index is a dynamic AABB tree: every leaf holds a box and a data
+ * pointer, and every inner node holds the union of the boxes of its two
+ * children. Leaves are inserted next to the sibling that minimizes the
+ * growth of the perimeter of the enclosing boxes, and the tree is kept
+ * balanced using AVL-like rotations, so that queries run in logarithmic
+ * time with respect to the number of leaves, plus the number of results.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-spatial-index.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+#define NULL_NODE       (-1)
+
+typedef struct _SpatialNode
+{
+  ClutterActorBox box;
+
+  gpointer data;
+
+  /* the parent node for nodes in the tree, and the next node
+   * for nodes in the free list
+   */
+  gint parent;
+
+  gint child1;
+  gint child2;
+
+  /* 0 for leaves, -1 for free nodes */
+  gint height;
+} SpatialNode;
+
+struct _ClutterSpatialIndex
+{
+  SpatialNode *nodes;
+  gint n_allocated;
+
+  gint root;
+  gint free_list;
+
+  guint n_leaves;
+};
+
+#define NODE_IS_LEAF(n)         ((n)->child1 == NULL_NODE)
+
+static inline void
+box_union (const ClutterActorBox *a,
+           const ClutterActorBox *b,
+           ClutterActorBox       *res)
+{
+  res->x1 = MIN (a->x1, b->x1);
+  res->y1 = MIN (a->y1, b->y1);
+  res->x2 = MAX (a->x2, b->x2);
+  res->y2 = MAX (a->y2, b->y2);
+}
+
+static inline float
+box_perimeter (const ClutterActorBox *box)
+{
+  return 2.f * ((box->x2 - box->x1) + (box->y2 - box->y1));
+}
+
+static inline gboolean
+box_intersects (const ClutterActorBox *a,
+                const ClutterActorBox *b)
+{
+  return a->x1 <= b->x2 && b->x1 <= a->x2 &&
+         a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+static gint
+spatial_index_alloc_node (ClutterSpatialIndex *index_)
+{
+  SpatialNode *node;
+  gint res;
+
+  if (index_->free_list == NULL_NODE)
+    {
+      gint old_size = index_->n_allocated;
+      gint i;
+
+      index_->n_allocated = MAX (16, old_size * 2);
+      index_->nodes = g_renew (SpatialNode, index_->nodes, index_->n_allocated);
+
+      for (i = old_size; i < index_->n_allocated; i++)
+        {
+          index_->nodes[i].parent = i + 1 < index_->n_allocated ? i + 1 : NULL_NODE;
+          index_->nodes[i].height = -1;
+        }
+
+      index_->free_list = old_size;
+    }
+
+  res = index_->free_list;
+  node = &index_->nodes[res];
+
+  index_->free_list = node->parent;
+
+  node->parent = NULL_NODE;
+  node->child1 = NULL_NODE;
+  node->child2 = NULL_NODE;
+  node->height = 0;
+  node->data = NULL;
+
+  return res;
+}
+
+static void
+spatial_index_free_node (ClutterSpatialIndex *index_,
+                         gint                 node_id)
+{
+  SpatialNode *node = &index_->nodes[node_id];
+
+  node->parent = index_->free_list;
+  node->height = -1;
+  node->data = NULL;
+
+  index_->free_list = node_id;
+}
+
+static void
+spatial_index_fix_node (ClutterSpatialIndex *index_,
+                        gint                 node_id)
+{
+  SpatialNode *node = &index_->nodes[node_id];
+  SpatialNode *child1 = &index_->nodes[node->child1];
+  SpatialNode *child2 = &index_->nodes[node->child2];
+
+  node->height = 1 + MAX (child1->height, child2->height);
+  box_union (&child1->box, &child2->box, &node->box);
+}
+
+static void
+spatial_index_replace_child (ClutterSpatialIndex *index_,
+                             gint                 parent_id,
+                             gint                 old_child,
+                             gint                 new_child)
+{
+  if (parent_id == NULL_NODE)
+    {
+      index_->root = new_child;
+      return;
+    }
+
+  if (index_->nodes[parent_id].child1 == old_child)
+    index_->nodes[parent_id].child1 = new_child;
+  else
+    index_->nodes[parent_id].child2 = new_child;
+}
+
+/* Performs a left or right rotation if the subtree rooted in @a_id
+ * is imbalanced, and returns the new root of the subtree
+ */
+static gint
+spatial_index_balance (ClutterSpatialIndex *index_,
+                       gint                 a_id)
+{
+  SpatialNode *nodes = index_->nodes;
+  SpatialNode *a = &nodes[a_id];
+  gint b_id, c_id;
+  gint balance;
+
+  if (NODE_IS_LEAF (a) || a->height < 2)
+    return a_id;
+
+  b_id = a->child1;
+  c_id = a->child2;
+
+  balance = nodes[c_id].height - nodes[b_id].height;
+
+  /* rotate c up */
+  if (balance > 1)
+    {
+      SpatialNode *c = &nodes[c_id];
+      gint f_id = c->child1;
+      gint g_id = c->child2;
+
+      c->child1 = a_id;
+      c->parent = a->parent;
+      a->parent = c_id;
+
+      spatial_index_replace_child (index_, c->parent, a_id, c_id);
+
+      if (nodes[f_id].height > nodes[g_id].height)
+        {
+          c->child2 = f_id;
+          a->child2 = g_id;
+          nodes[g_id].parent = a_id;
+        }
+      else
+        {
+          c->child2 = g_id;
+          a->child2 = f_id;
+          nodes[f_id].parent = a_id;
+        }
+
+      spatial_index_fix_node (index_, a_id);
+      spatial_index_fix_node (index_, c_id);
+
+      return c_id;
+    }
+
+  /* rotate b up */
+  if (balance < -1)
+    {
+      SpatialNode *b = &nodes[b_id];
+      gint d_id = b->child1;
+      gint e_id = b->child2;
+
+      b->child1 = a_id;
+      b->parent = a->parent;
+      a->parent = b_id;
+
+      spatial_index_replace_child (index_, b->parent, a_id, b_id);
+
+      if (nodes[d_id].height > nodes[e_id].height)
+        {
+          b->child2 = d_id;
+          a->child1 = e_id;
+          nodes[e_id].parent = a_id;
+        }
+      else
+        {
+          b->child2 = e_id;
+          a->child1 = d_id;
+          nodes[d_id].parent = a_id;
+        }
+
+      spatial_index_fix_node (index_, a_id);
+      spatial_index_fix_node (index_, b_id);
+
+      return b_id;
+    }
+
+  return a_id;
+}
+
+static void
+spatial_index_refit_from (ClutterSpatialIndex *index_,
+                          gint                 node_id)
+{
+  while (node_id != NULL_NODE)
+    {
+      node_id = spatial_index_balance (index_, node_id);
+
+      spatial_index_fix_node (index_, node_id);
+
+      node_id = index_->nodes[node_id].parent;
+    }
+}
+
+static void
+spatial_index_insert_leaf (ClutterSpatialIndex *index_,
+                           gint                 leaf_id)
+{
+  ClutterActorBox leaf_box;
+  gint sibling_id, old_parent_id, new_parent_id;
+
+  if (index_->root == NULL_NODE)
+    {
+      index_->root = leaf_id;
+      index_->nodes[leaf_id].parent = NULL_NODE;
+      return;
+    }
+
+  leaf_box = index_->nodes[leaf_id].box;
+
+  /* find the best sibling for the new leaf, by descending the tree
+   * along the path that minimizes the cost of the insertion
+   */
+  sibling_id = index_->root;
+  while (!NODE_IS_LEAF (&index_->nodes[sibling_id]))
+    {
+      const SpatialNode *node = &index_->nodes[sibling_id];
+      const SpatialNode *child1 = &index_->nodes[node->child1];
+      const SpatialNode *child2 = &index_->nodes[node->child2];
+      ClutterActorBox combined;
+      float perimeter, combined_perimeter;
+      float cost, inheritance_cost;
+      float cost1, cost2;
+
+      perimeter = box_perimeter (&node->box);
+
+      box_union (&node->box, &leaf_box, &combined);
+      combined_perimeter = box_perimeter (&combined);
+
+      /* the cost of creating a new parent for this node and the leaf */
+      cost = 2.f * combined_perimeter;
+
+      /* the minimum cost of pushing the leaf further down the tree */
+      inheritance_cost = 2.f * (combined_perimeter - perimeter);
+
+      box_union (&child1->box, &leaf_box, &combined);
+      cost1 = box_perimeter (&combined) + inheritance_cost;
+      if (!NODE_IS_LEAF (child1))
+        cost1 -= box_perimeter (&child1->box);
+
+      box_union (&child2->box, &leaf_box, &combined);
+      cost2 = box_perimeter (&combined) + inheritance_cost;
+      if (!NODE_IS_LEAF (child2))
+        cost2 -= box_perimeter (&child2->box);
+
+      if (cost < cost1 && cost < cost2)
+        break;
+
+      sibling_id = cost1 < cost2 ? node->child1 : node->child2;
+    }
+
+  /* this may reallocate the nodes, so we cannot keep pointers around */
+  new_parent_id = spatial_index_alloc_node (index_);
+
+  old_parent_id = index_->nodes[sibling_id].parent;
+
+  index_->nodes[new_parent_id].parent = old_parent_id;
+  index_->nodes[new_parent_id].child1 = sibling_id;
+  index_->nodes[new_parent_id].child2 = leaf_id;
+
+  spatial_index_replace_child (index_, old_parent_id, sibling_id, new_parent_id);
+
+  index_->nodes[sibling_id].parent = new_parent_id;
+  index_->nodes[leaf_id].parent = new_parent_id;
+
+  spatial_index_refit_from (index_, new_parent_id);
+}
+
+static void
+spatial_index_remove_leaf (ClutterSpatialIndex *index_,
+                           gint                 leaf_id)
+{
+  gint parent_id, grand_parent_id, sibling_id;
+
+  if (leaf_id == index_->root)
+    {
+      index_->root = NULL_NODE;
+      return;
+    }
+
+  parent_id = index_->nodes[leaf_id].parent;
+  grand_parent_id = index_->nodes[parent_id].parent;
+
+  if (index_->nodes[parent_id].child1 == leaf_id)
+    sibling_id = index_->nodes[parent_id].child2;
+  else
+    sibling_id = index_->nodes[parent_id].child1;
+
+  spatial_index_replace_child (index_, grand_parent_id, parent_id, sibling_id);
+  index_->nodes[sibling_id].parent = grand_parent_id;
+
+  spatial_index_free_node (index_, parent_id);
+
+  spatial_index_refit_from (index_, grand_parent_id);
+}
+
+/*< private >
+ * _clutter_spatial_index_new:
+ *
+ * Creates a new, empty spatial index.
+ *
+ * Return value: the newly created index; use _clutter_spatial_index_free()
+ *   to free the resources it uses
+ */
+ClutterSpatialIndex *
+_clutter_spatial_index_new (void)
+{
+  ClutterSpatialIndex *index_;
+
+  index_ = g_slice_new (ClutterSpatialIndex);
+  index_->nodes = NULL;
+  index_->n_allocated = 0;
+  index_->root = NULL_NODE;
+  index_->free_list = NULL_NODE;
+  index_->n_leaves = 0;
+
+  return index_;
+}
+
+void
+_clutter_spatial_index_free (ClutterSpatialIndex *index_)
+{
+  if (index_ == NULL)
+    return;
+
+  g_free (index_->nodes);
+  g_slice_free (ClutterSpatialIndex, index_);
+}
+
+/*< private >
+ * _clutter_spatial_index_insert:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the bounding box of the new leaf
+ * @data: the data associated to the leaf
+ *
+ * Inserts a new leaf inside the index.
+ *
+ * Return value: the identifier of the leaf, to be used with
+ *   _clutter_spatial_index_remove()
+ */
+gint
+_clutter_spatial_index_insert (ClutterSpatialIndex   *index_,
+                               const ClutterActorBox *box,
+                               gpointer               data)
+{
+  gint leaf_id;
+
+  g_return_val_if_fail (index_ != NULL, NULL_NODE);
+  g_return_val_if_fail (box != NULL, NULL_NODE);
+
+  leaf_id = spatial_index_alloc_node (index_);
+  index_->nodes[leaf_id].box = *box;
+  index_->nodes[leaf_id].data = data;
+
+  spatial_index_insert_leaf (index_, leaf_id);
+
+  index_->n_leaves += 1;
+
+  return leaf_id;
+}
+
+void
+_clutter_spatial_index_remove (ClutterSpatialIndex *index_,
+                               gint                 leaf)
+{
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (leaf >= 0 && leaf < index_->n_allocated);
+  g_return_if_fail (index_->nodes[leaf].height == 0);
+
+  spatial_index_remove_leaf (index_, leaf);
+  spatial_index_free_node (index_, leaf);
+
+  index_->n_leaves -= 1;
+}
+
+guint
+_clutter_spatial_index_get_n_leaves (ClutterSpatialIndex *index_)
+{
+  g_return_val_if_fail (index_ != NULL, 0);
+
+  return index_->n_leaves;
+}
+
+/*< private >
+ * _clutter_spatial_index_query:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the box to query
+ * @func: the function called for each leaf intersecting @box
+ * @user_data: data passed to @func
+ *
+ * Calls @func for each leaf whose bounding box intersects @box. The
+ * order in which the leaves are visited is undefined.
+ *
+ * The index must not be modified from within @func.
+ */
+void
+_clutter_spatial_index_query (ClutterSpatialIndex     *index_,
+                              const ClutterActorBox   *box,
+                              ClutterSpatialIndexFunc  func,
+                              gpointer                 user_data)
+{
+  gint *stack;
+  gint stack_size;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (box != NULL);
+  g_return_if_fail (func != NULL);
+
+  if (index_->root == NULL_NODE)
+    return;
+
+  /* a depth-first visit never keeps more than height + 1 nodes on
+   * the stack at the same time
+   */
+  stack = g_newa (gint, index_->nodes[index_->root].height + 1);
+  stack_size = 0;
+
+  stack[stack_size++] = index_->root;
+
+  while (stack_size > 0)
+    {
+      const SpatialNode *node = &index_->nodes[stack[--stack_size]];
+
+      if (!box_intersects (&node->box, box))
+        continue;
+
+      if (NODE_IS_LEAF (node))
+        {
+          if (!func (node->data, &node->box, user_data))
+            return;
+        }
+      else
+        {
+          stack[stack_size++] = node->child1;
+          stack[stack_size++] = node->child2;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_SPATIAL_INDEX_H__
+#define __CLUTTER_SPATIAL_INDEX_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterSpatialIndex     ClutterSpatialIndex;
+
+/*< private >
+ * ClutterSpatialIndexFunc:
+ * @data: the data associated to the leaf
+ * @box: the bounding box of the leaf
+ * @user_data: data passed to _clutter_spatial_index_query()
+ *
+ * The function used to iterate over the results of a query.
+ *
+ * Return value: %TRUE to continue the query, %FALSE to stop it
+ */
+typedef gboolean (* ClutterSpatialIndexFunc) (gpointer               data,
+                                              const ClutterActorBox *box,
+                                              gpointer               user_data);
+
+ClutterSpatialIndex *   _clutter_spatial_index_new              (void);
+void                    _clutter_spatial_index_free             (ClutterSpatialIndex     *index_);
+
+gint                    _clutter_spatial_index_insert           (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 gpointer                 data);
+void                    _clutter_spatial_index_remove           (ClutterSpatialIndex     *index_,
+                                                                 gint                     leaf);
+guint                   _clutter_spatial_index_get_n_leaves     (ClutterSpatialIndex     *index_);
+
+void                    _clutter_spatial_index_query            (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SPATIAL_INDEX_H__ */
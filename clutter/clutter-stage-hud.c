@@ -0,0 +1,388 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterStageHud: the performance overlay of a stage.
+ *
+ * The overlay is drawn on top of the stage at the end of each paint;
+ * see clutter_stage_set_show_hud(). It shows the cost of the last
+ * HUD_N_FRAMES frames as a graph of stacked bars, one color for each
+ * phase of the frame, against a line marking the frame budget; below
+ * the graph, the frame rate, the number of missed frames, the memory
+ * held by the stage and the number of actors painted and culled by the
+ * last paint.
+ *
+ * The frames come from the same collection as the #ClutterFrameInfo
+ * of clutter_stage_set_collect_frame_info(), so the graph lags behind
+ * by the frames still waiting for their presentation. The memory is
+ * walked at most once per second.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-stage-hud.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+#include "clutter-stage-private.h"
+
+/* the number of frames in the graph */
+#define HUD_N_FRAMES            120
+
+#define HUD_MARGIN              8.f
+#define HUD_BAR_WIDTH           2.f
+#define HUD_GRAPH_HEIGHT        100.f
+
+/* the height of the graph is twice the frame budget */
+#define HUD_GRAPH_BUDGETS       2
+
+#define HUD_MEMORY_INTERVAL     G_USEC_PER_SEC
+
+typedef enum {
+  HUD_PHASE_EVENTS,
+  HUD_PHASE_TIMELINES,
+  HUD_PHASE_LAYOUT,
+  HUD_PHASE_PAINT,
+  HUD_PHASE_PICK,
+  HUD_PHASE_SWAP,
+
+  HUD_N_PHASES
+} HudPhase;
+
+static const guint8 hud_phase_colors[HUD_N_PHASES][3] = {
+  {  66, 133, 244 },    /* events */
+  { 171,  71, 188 },    /* timelines */
+  {   0, 172, 193 },    /* layout */
+  {  67, 160,  71 },    /* paint */
+  { 253, 216,  53 },    /* pick */
+  { 229,  57,  53 },    /* swap */
+};
+
+typedef struct {
+  gint64 frame_time;
+  gint64 phases[HUD_N_PHASES];
+} HudFrame;
+
+struct _ClutterStageHud
+{
+  /* a ring of the last frames, the oldest at frames[next] once full */
+  HudFrame frames[HUD_N_FRAMES];
+  guint next;
+  guint len;
+
+  gint64 last_frame_time;
+  gint64 last_paint_end;
+  gint64 last_presentation_time;
+  guint n_missed;
+
+  gint64 budget;
+
+  gint64 memory_time;
+  gsize gpu_bytes;
+  gsize cpu_bytes;
+
+  PangoLayout *layout;
+
+  CoglPipeline *background;
+  CoglPipeline *budget_line;
+  CoglPipeline *phases[HUD_N_PHASES];
+};
+
+static inline gint64
+phase_duration (gint64 start,
+                gint64 end)
+{
+  if (start == 0 || end < start)
+    return 0;
+
+  return end - start;
+}
+
+ClutterStageHud *
+_clutter_stage_hud_new (void)
+{
+  return g_slice_new0 (ClutterStageHud);
+}
+
+void
+_clutter_stage_hud_free (ClutterStageHud *hud)
+{
+  int i;
+
+  g_clear_object (&hud->layout);
+
+  if (hud->background != NULL)
+    {
+      cogl_object_unref (hud->background);
+      cogl_object_unref (hud->budget_line);
+
+      for (i = 0; i < HUD_N_PHASES; i++)
+        cogl_object_unref (hud->phases[i]);
+    }
+
+  g_slice_free (ClutterStageHud, hud);
+}
+
+/*< private >
+ * _clutter_stage_hud_add_frame:
+ * @hud: a #ClutterStageHud
+ * @info: the timing information of a completed frame
+ * @budget: the frame budget of the stage, in microseconds
+ *
+ * Adds a frame to the graph; a frame is counted as missed when it
+ * was presented, or started, more than one and a half budgets after
+ * the previous one, unless the stage was idle in between.
+ */
+void
+_clutter_stage_hud_add_frame (ClutterStageHud        *hud,
+                              const ClutterFrameInfo *info,
+                              gint64                  budget)
+{
+  HudFrame *frame = &hud->frames[hud->next];
+  gint64 interval = 0;
+
+  frame->frame_time = info->frame_time;
+  frame->phases[HUD_PHASE_EVENTS] =
+    phase_duration (info->events_start, info->events_end);
+  frame->phases[HUD_PHASE_TIMELINES] =
+    phase_duration (info->timelines_start, info->timelines_end);
+  frame->phases[HUD_PHASE_LAYOUT] =
+    phase_duration (info->layout_start, info->layout_end);
+  frame->phases[HUD_PHASE_PAINT] =
+    phase_duration (info->paint_start, info->paint_end);
+  frame->phases[HUD_PHASE_PICK] = info->pick_time;
+  frame->phases[HUD_PHASE_SWAP] =
+    phase_duration (info->swap_start, info->swap_end);
+
+  hud->next = (hud->next + 1) % HUD_N_FRAMES;
+  if (hud->len < HUD_N_FRAMES)
+    hud->len += 1;
+
+  /* a stage that stops redrawing does not miss any frame, so only
+   * the frames started right after the previous one are compared
+   */
+  if (info->presentation_time != 0 && hud->last_presentation_time != 0)
+    interval = info->presentation_time - hud->last_presentation_time;
+  else if (hud->last_frame_time != 0)
+    interval = info->frame_time - hud->last_frame_time;
+
+  if (interval > budget + budget / 2 &&
+      info->frame_time - hud->last_paint_end < budget)
+    hud->n_missed += 1;
+
+  hud->last_frame_time = info->frame_time;
+  hud->last_paint_end = info->paint_end;
+  hud->last_presentation_time = info->presentation_time;
+  hud->budget = budget;
+}
+
+static void
+clutter_stage_hud_ensure_pipelines (ClutterStageHud *hud)
+{
+  CoglContext *ctx;
+  int i;
+
+  if (hud->background != NULL)
+    return;
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  hud->background = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_color4ub (hud->background, 0, 0, 0, 176);
+
+  hud->budget_line = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_color4ub (hud->budget_line, 255, 255, 255, 255);
+
+  for (i = 0; i < HUD_N_PHASES; i++)
+    {
+      hud->phases[i] = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (hud->phases[i],
+                                  hud_phase_colors[i][0],
+                                  hud_phase_colors[i][1],
+                                  hud_phase_colors[i][2],
+                                  255);
+    }
+}
+
+static guint
+clutter_stage_hud_get_frame_rate (ClutterStageHud *hud)
+{
+  gint64 newest;
+  guint i, n_frames = 0;
+
+  if (hud->len == 0)
+    return 0;
+
+  newest = hud->frames[(hud->next + HUD_N_FRAMES - 1) % HUD_N_FRAMES].frame_time;
+
+  for (i = 0; i < hud->len; i++)
+    {
+      const HudFrame *frame = &hud->frames[(hud->next + HUD_N_FRAMES - 1 - i) % HUD_N_FRAMES];
+
+      if (newest - frame->frame_time >= G_USEC_PER_SEC)
+        break;
+
+      n_frames += 1;
+    }
+
+  return n_frames;
+}
+
+static void
+clutter_stage_hud_draw_graph (ClutterStageHud *hud,
+                              CoglFramebuffer *fb,
+                              float            x,
+                              float            y)
+{
+  float coords[HUD_N_FRAMES * 4];
+  float bar_bottom[HUD_N_FRAMES];
+  float scale;
+  guint first, i;
+  int phase;
+
+  if (hud->len == 0 || hud->budget <= 0)
+    return;
+
+  scale = HUD_GRAPH_HEIGHT / (float) (hud->budget * HUD_GRAPH_BUDGETS);
+  first = (hud->next + HUD_N_FRAMES - hud->len) % HUD_N_FRAMES;
+
+  for (i = 0; i < hud->len; i++)
+    bar_bottom[i] = y + HUD_GRAPH_HEIGHT;
+
+  /* one batch of rectangles for each phase, stacked from the bottom */
+  for (phase = 0; phase < HUD_N_PHASES; phase++)
+    {
+      int n_rects = 0;
+
+      for (i = 0; i < hud->len; i++)
+        {
+          const HudFrame *frame = &hud->frames[(first + i) % HUD_N_FRAMES];
+          float height, top;
+
+          if (frame->phases[phase] == 0)
+            continue;
+
+          height = frame->phases[phase] * scale;
+          top = MAX (bar_bottom[i] - height, y);
+          if (top >= bar_bottom[i])
+            continue;
+
+          coords[n_rects * 4 + 0] = x + i * HUD_BAR_WIDTH;
+          coords[n_rects * 4 + 1] = top;
+          coords[n_rects * 4 + 2] = x + (i + 1) * HUD_BAR_WIDTH;
+          coords[n_rects * 4 + 3] = bar_bottom[i];
+          n_rects += 1;
+
+          bar_bottom[i] = top;
+        }
+
+      if (n_rects > 0)
+        cogl_framebuffer_draw_rectangles (fb, hud->phases[phase],
+                                          coords,
+                                          n_rects);
+    }
+
+  /* the budget line */
+  cogl_framebuffer_draw_rectangle (fb, hud->budget_line,
+                                   x,
+                                   y + HUD_GRAPH_HEIGHT - hud->budget * scale,
+                                   x + HUD_N_FRAMES * HUD_BAR_WIDTH,
+                                   y + HUD_GRAPH_HEIGHT - hud->budget * scale + 1.f);
+}
+
+/*< private >
+ * _clutter_stage_hud_draw:
+ * @hud: a #ClutterStageHud
+ * @stage: the #ClutterStage owning @hud
+ * @framebuffer: the framebuffer of @stage
+ *
+ * Draws the overlay in the top left corner of @stage; the modelview
+ * of @framebuffer must be the one of the stage, and the paint of the
+ * actors must have just ended, for the painted and culled counts.
+ */
+void
+_clutter_stage_hud_draw (ClutterStageHud *hud,
+                         ClutterStage    *stage,
+                         CoglFramebuffer *framebuffer)
+{
+  PangoRectangle logical;
+  CoglColor text_color;
+  guint n_painted, n_culled;
+  gint64 now;
+  gchar *text;
+  float width, height;
+
+  clutter_stage_hud_ensure_pipelines (hud);
+
+  now = g_get_monotonic_time ();
+  if (hud->memory_time == 0 || now - hud->memory_time >= HUD_MEMORY_INTERVAL)
+    {
+      _clutter_stage_get_memory_usage (stage, &hud->gpu_bytes, &hud->cpu_bytes);
+      hud->memory_time = now;
+    }
+
+  _clutter_actor_get_paint_stats (&n_painted, &n_culled);
+
+  if (hud->layout == NULL)
+    {
+      PangoFontDescription *font_desc;
+
+      hud->layout = pango_layout_new (clutter_actor_get_pango_context (CLUTTER_ACTOR (stage)));
+
+      font_desc = pango_font_description_from_string ("Monospace 9");
+      pango_layout_set_font_description (hud->layout, font_desc);
+      pango_font_description_free (font_desc);
+    }
+
+  text = g_strdup_printf ("%u fps, %u missed\n"
+                          "GPU %.1f MiB, CPU %.1f MiB\n"
+                          "%u painted, %u culled",
+                          clutter_stage_hud_get_frame_rate (hud),
+                          hud->n_missed,
+                          hud->gpu_bytes / (1024.0 * 1024.0),
+                          hud->cpu_bytes / (1024.0 * 1024.0),
+                          n_painted,
+                          n_culled);
+  pango_layout_set_text (hud->layout, text, -1);
+  g_free (text);
+
+  pango_layout_get_pixel_extents (hud->layout, NULL, &logical);
+
+  width = MAX (HUD_N_FRAMES * HUD_BAR_WIDTH, logical.width) + HUD_MARGIN * 2;
+  height = HUD_GRAPH_HEIGHT + logical.height + HUD_MARGIN * 3;
+
+  cogl_framebuffer_draw_rectangle (framebuffer, hud->background,
+                                   0, 0, width, height);
+
+  clutter_stage_hud_draw_graph (hud, framebuffer, HUD_MARGIN, HUD_MARGIN);
+
+  cogl_color_init_from_4ub (&text_color, 255, 255, 255, 255);
+  cogl_pango_render_layout (hud->layout,
+                            HUD_MARGIN,
+                            HUD_GRAPH_HEIGHT + HUD_MARGIN * 2,
+                            &text_color,
+                            0);
+}
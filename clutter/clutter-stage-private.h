@@ -25,6 +25,8 @@
 #include <clutter/clutter-stage-window.h>
 #include <clutter/clutter-stage.h>
 #include <clutter/clutter-input-device.h>
+#include <clutter/clutter-offscreen-pool.h>
+#include <clutter/clutter-paint-stream.h>
 #include <clutter/clutter-private.h>
 
 #include <cogl/cogl.h>
@@ -33,11 +35,28 @@ G_BEGIN_DECLS
 
 typedef struct _ClutterStageQueueRedrawEntry ClutterStageQueueRedrawEntry;
 
+/* the phases of a frame recorded in a ClutterFrameInfo */
+typedef enum {
+  CLUTTER_FRAME_MARK_EVENTS_START,
+  CLUTTER_FRAME_MARK_EVENTS_END,
+  CLUTTER_FRAME_MARK_TIMELINES_START,
+  CLUTTER_FRAME_MARK_TIMELINES_END,
+  CLUTTER_FRAME_MARK_LAYOUT_START,
+  CLUTTER_FRAME_MARK_LAYOUT_END,
+  CLUTTER_FRAME_MARK_PAINT_START,
+  CLUTTER_FRAME_MARK_PAINT_END,
+  CLUTTER_FRAME_MARK_SWAP_START,
+  CLUTTER_FRAME_MARK_SWAP_END
+} ClutterFrameMark;
+
 /* stage */
 ClutterStageWindow *_clutter_stage_get_default_window    (void);
 
 void                _clutter_stage_do_paint              (ClutterStage                *stage,
                                                           const cairo_rectangle_int_t *clip);
+void                _clutter_stage_get_memory_usage      (ClutterStage                *stage,
+                                                          gsize                       *gpu_bytes,
+                                                          gsize                       *cpu_bytes);
 
 void                _clutter_stage_set_window            (ClutterStage          *stage,
                                                           ClutterStageWindow    *stage_window);
@@ -55,6 +74,8 @@ void                _clutter_stage_get_viewport          (ClutterStage
                                                           float                 *y,
                                                           float                 *width,
                                                           float                 *height);
+gboolean            _clutter_stage_get_window_transform  (ClutterStage          *stage,
+                                                          cairo_matrix_t        *matrix);
 void                _clutter_stage_dirty_viewport        (ClutterStage          *stage);
 void                _clutter_stage_maybe_setup_viewport  (ClutterStage          *stage);
 void                _clutter_stage_maybe_relayout        (ClutterActor          *stage);
@@ -70,26 +91,87 @@ void     _clutter_stage_update_input_devices              (ClutterStage *stage);
 void     _clutter_stage_schedule_update                   (ClutterStage *stage);
 gint64    _clutter_stage_get_update_time                  (ClutterStage *stage);
 void     _clutter_stage_clear_update_time                 (ClutterStage *stage);
+gint64   _clutter_stage_get_next_presentation_time        (ClutterStage *stage);
 gboolean _clutter_stage_has_full_redraw_queued            (ClutterStage *stage);
+void     _clutter_stage_queue_paint_time_sample           (ClutterStage *stage,
+                                                           ClutterActor *actor);
+void     _clutter_stage_queue_relayout_boundary           (ClutterStage *stage,
+                                                           ClutterActor *actor);
+void     _clutter_stage_defer_relayout_boundary           (ClutterStage *stage,
+                                                           ClutterActor *actor);
+gboolean _clutter_stage_relayout_deadline_expired         (ClutterStage *stage);
+void     _clutter_stage_begin_resize_transition           (ClutterStage *stage,
+                                                           guint         n_frames);
+void     _clutter_stage_queue_constraint_source           (ClutterStage *stage,
+                                                           ClutterActor *actor);
+
+void     _clutter_stage_read_captures                     (ClutterStage    *stage,
+                                                           CoglFramebuffer *framebuffer);
+
+void     _clutter_stage_frame_info_begin                  (ClutterStage     *stage,
+                                                           gint64            frame_time);
+void     _clutter_stage_frame_info_mark                   (ClutterStage     *stage,
+                                                           ClutterFrameMark  mark);
+void     _clutter_stage_frame_info_presented              (ClutterStage     *stage,
+                                                           gint64            presentation_time);
+void     _clutter_stage_frame_info_presented_full         (ClutterStage     *stage,
+                                                           gint64            presentation_time,
+                                                           gint64            refresh_interval,
+                                                           ClutterPresentationFlags flags);
+void     _clutter_stage_frame_info_add_repaint_funcs      (ClutterStage     *stage,
+                                                           gint64            elapsed,
+                                                           guint             n_deferred);
+
+ClutterQualityLevel _clutter_stage_get_quality_level      (ClutterStage     *stage);
+gfloat          _clutter_stage_get_resolution_scale     (ClutterStage     *stage);
 
 ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
                                       gint             x,
                                       gint             y,
                                       ClutterPickMode  mode);
+void          _clutter_stage_do_pick_multiple      (ClutterStage       *stage,
+                                                    const ClutterPoint *positions,
+                                                    guint               n_positions,
+                                                    ClutterPickMode     mode,
+                                                    ClutterActor      **actors);
+void          _clutter_stage_invalidate_pick_cache (ClutterStage    *stage);
+
+gboolean      _clutter_stage_in_geometric_pick     (ClutterStage          *stage);
+void          _clutter_stage_log_pick              (ClutterStage          *stage,
+                                                    const ClutterActorBox *box,
+                                                    ClutterActor          *actor);
+void          _clutter_stage_push_pick_clip        (ClutterStage          *stage,
+                                                    const ClutterActorBox *box);
+void          _clutter_stage_pop_pick_clip         (ClutterStage          *stage);
+void          _clutter_stage_request_pick_fallback (ClutterStage          *stage);
+gboolean      _clutter_stage_needs_pick_fallback   (ClutterStage          *stage);
 
 ClutterPaintVolume *_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage);
 void                _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage);
 
 const ClutterPlane *_clutter_stage_get_clip (ClutterStage *stage);
+void                _clutter_stage_get_clip_box (ClutterStage    *stage,
+                                                 ClutterActorBox *box);
 
 ClutterStageQueueRedrawEntry *_clutter_stage_queue_actor_redraw            (ClutterStage                 *stage,
                                                                             ClutterStageQueueRedrawEntry *entry,
                                                                             ClutterActor                 *actor,
                                                                             ClutterPaintVolume           *clip);
+void                          _clutter_stage_queue_redraw_entry_add_clip   (ClutterStageQueueRedrawEntry *entry,
+                                                                            ClutterPaintVolume           *clip);
+gboolean                      _clutter_stage_queue_redraw_entry_has_clip   (ClutterStageQueueRedrawEntry *entry);
 void                          _clutter_stage_queue_redraw_entry_invalidate (ClutterStageQueueRedrawEntry *entry);
 
 CoglFramebuffer *_clutter_stage_get_active_framebuffer (ClutterStage *stage);
 
+ClutterOffscreenPool *_clutter_stage_get_offscreen_pool (ClutterStage *stage);
+
+void                    _clutter_stage_set_paint_recorder (ClutterStage         *stage,
+                                                           ClutterPaintRecorder *recorder);
+ClutterPaintRecorder *  _clutter_stage_get_paint_recorder (ClutterStage         *stage);
+void            _clutter_stage_trim_memory              (ClutterStage           *stage,
+                                                         ClutterTrimMemoryFlags  flags);
+
 gint32          _clutter_stage_acquire_pick_id          (ClutterStage *stage,
                                                          ClutterActor *actor);
 void            _clutter_stage_release_pick_id          (ClutterStage *stage,
@@ -97,6 +179,23 @@ void            _clutter_stage_release_pick_id          (ClutterStage *stage,
 ClutterActor *  _clutter_stage_get_actor_by_pick_id     (ClutterStage *stage,
                                                          gint32        pick_id);
 
+void            _clutter_stage_add_visibility_tracker    (ClutterStage *stage,
+                                                          ClutterActor *actor);
+void            _clutter_stage_remove_visibility_tracker (ClutterStage *stage,
+                                                          ClutterActor *actor);
+
+void            _clutter_stage_freeze_notify             (ClutterStage *stage,
+                                                          ClutterActor *actor);
+
+gboolean        _clutter_stage_reserve_raster_cache      (ClutterStage *stage,
+                                                          ClutterActor *actor,
+                                                          gint          width,
+                                                          gint          height);
+void            _clutter_stage_touch_raster_cache        (ClutterStage *stage,
+                                                          ClutterActor *actor);
+void            _clutter_stage_release_raster_cache      (ClutterStage *stage,
+                                                          ClutterActor *actor);
+
 void            _clutter_stage_add_pointer_drag_actor    (ClutterStage       *stage,
                                                           ClutterInputDevice *device,
                                                           ClutterActor       *actor);
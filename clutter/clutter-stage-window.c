@@ -174,6 +174,23 @@ _clutter_stage_window_clear_update_time (ClutterStageWindow *window)
   iface->clear_update_time (window);
 }
 
+/* Returns the expected presentation time of the next frame, or 0 if
+ * the stage window cannot tell
+ */
+gint64
+_clutter_stage_window_get_next_presentation_time (ClutterStageWindow *window)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE_WINDOW (window), 0);
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->get_next_presentation_time == NULL)
+    return 0;
+
+  return iface->get_next_presentation_time (window);
+}
+
 void
 _clutter_stage_window_add_redraw_clip (ClutterStageWindow    *window,
                                        cairo_rectangle_int_t *stage_clip)
@@ -271,6 +288,36 @@ _clutter_stage_window_redraw (ClutterStageWindow *window)
     iface->redraw (window);
 }
 
+/* While the swap is deferred, the redraw of @window only records the
+ * damage of the frame; the swap itself, which may block on the vblank,
+ * is issued by _clutter_stage_window_finish_swap(). This lets the
+ * master clock paint all the stages before blocking on any of them.
+ */
+void
+_clutter_stage_window_set_defer_swap (ClutterStageWindow *window,
+                                      gboolean            defer)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_if_fail (CLUTTER_IS_STAGE_WINDOW (window));
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->set_defer_swap)
+    iface->set_defer_swap (window, defer);
+}
+
+void
+_clutter_stage_window_finish_swap (ClutterStageWindow *window)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_if_fail (CLUTTER_IS_STAGE_WINDOW (window));
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->finish_swap)
+    iface->finish_swap (window);
+}
+
 
 void
 _clutter_stage_window_get_dirty_pixel (ClutterStageWindow *window,
@@ -360,3 +407,45 @@ _clutter_stage_window_get_scale_factor (ClutterStageWindow *window)
 
   return 1;
 }
+
+gboolean
+_clutter_stage_window_can_scanout (ClutterStageWindow *window)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE_WINDOW (window), FALSE);
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+
+  return iface->scanout_actor != NULL;
+}
+
+/*< private >
+ * _clutter_stage_window_scanout_actor:
+ * @window: a #ClutterStageWindow
+ * @actor: (nullable): the actor whose client buffer covers the stage,
+ *   or %NULL
+ *
+ * Asks @window to present the client buffer of @actor directly, by
+ * scanning it out or by putting it on a hardware overlay, instead of
+ * painting the stage; a %NULL @actor means that the stage has to be
+ * painted again, and that @window should stop presenting the buffer
+ * it was presenting, if any.
+ *
+ * Return value: %TRUE if the buffer of @actor is presented, and the
+ *   stage does not need to be painted
+ */
+gboolean
+_clutter_stage_window_scanout_actor (ClutterStageWindow *window,
+                                     ClutterActor       *actor)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE_WINDOW (window), FALSE);
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->scanout_actor != NULL)
+    return iface->scanout_actor (window, actor);
+
+  return FALSE;
+}
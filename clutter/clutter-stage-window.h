@@ -11,6 +11,13 @@ G_BEGIN_DECLS
 #define CLUTTER_IS_STAGE_WINDOW(obj)            (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_STAGE_WINDOW))
 #define CLUTTER_STAGE_WINDOW_GET_IFACE(obj)     (G_TYPE_INSTANCE_GET_INTERFACE ((obj), CLUTTER_TYPE_STAGE_WINDOW, ClutterStageWindowIface))
 
+/* The sync delay passed to schedule_update() when the stage window should
+ * pick the delay itself, from the presentation times and the cost of the
+ * previous frames; backends that do not track those treat it like any
+ * other negative delay, and update as soon as possible
+ */
+#define CLUTTER_STAGE_WINDOW_SYNC_DELAY_ADAPTIVE        (-2)
+
 /*
  * ClutterStageWindow: (skip)
  *
@@ -62,6 +69,7 @@ struct _ClutterStageWindowIface
                                                  int                 sync_delay);
   gint64            (* get_update_time)         (ClutterStageWindow *stage_window);
   void              (* clear_update_time)       (ClutterStageWindow *stage_window);
+  gint64            (* get_next_presentation_time) (ClutterStageWindow *stage_window);
 
   void              (* add_redraw_clip)         (ClutterStageWindow    *stage_window,
                                                  cairo_rectangle_int_t *stage_rectangle);
@@ -75,6 +83,9 @@ struct _ClutterStageWindowIface
                                                  gboolean            accept_focus);
 
   void              (* redraw)                  (ClutterStageWindow *stage_window);
+  void              (* set_defer_swap)          (ClutterStageWindow *stage_window,
+                                                 gboolean            defer);
+  void              (* finish_swap)             (ClutterStageWindow *stage_window);
 
   void              (* dirty_back_buffer)       (ClutterStageWindow *stage_window);
 
@@ -88,6 +99,9 @@ struct _ClutterStageWindowIface
   void              (* set_scale_factor)        (ClutterStageWindow *stage_window,
                                                  int                 factor);
   int               (* get_scale_factor)        (ClutterStageWindow *stage_window);
+
+  gboolean          (* scanout_actor)           (ClutterStageWindow *stage_window,
+                                                 ClutterActor       *actor);
 };
 
 GType _clutter_stage_window_get_type (void) G_GNUC_CONST;
@@ -119,6 +133,7 @@ void              _clutter_stage_window_schedule_update         (ClutterStageWin
                                                                  int                 sync_delay);
 gint64            _clutter_stage_window_get_update_time         (ClutterStageWindow *window);
 void              _clutter_stage_window_clear_update_time       (ClutterStageWindow *window);
+gint64            _clutter_stage_window_get_next_presentation_time (ClutterStageWindow *window);
 
 void              _clutter_stage_window_add_redraw_clip         (ClutterStageWindow    *window,
                                                                  cairo_rectangle_int_t *stage_clip);
@@ -131,6 +146,9 @@ void              _clutter_stage_window_set_accept_focus        (ClutterStageWin
                                                                  gboolean            accept_focus);
 
 void              _clutter_stage_window_redraw                  (ClutterStageWindow *window);
+void              _clutter_stage_window_set_defer_swap          (ClutterStageWindow *window,
+                                                                 gboolean            defer);
+void              _clutter_stage_window_finish_swap             (ClutterStageWindow *window);
 
 void              _clutter_stage_window_dirty_back_buffer       (ClutterStageWindow *window);
 
@@ -145,6 +163,10 @@ void              _clutter_stage_window_set_scale_factor        (ClutterStageWin
                                                                  int                 factor);
 int               _clutter_stage_window_get_scale_factor        (ClutterStageWindow *window);
 
+gboolean          _clutter_stage_window_can_scanout             (ClutterStageWindow *window);
+gboolean          _clutter_stage_window_scanout_actor           (ClutterStageWindow *window,
+                                                                 ClutterActor       *actor);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_STAGE_WINDOW_H__ */
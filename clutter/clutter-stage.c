@@ -56,8 +56,10 @@
 #include "deprecated/clutter-stage.h"
 #include "deprecated/clutter-container.h"
 
+#include "clutter-actor-meta-private.h"
 #include "clutter-actor-private.h"
 #include "clutter-backend-private.h"
+#include "clutter-box4-private.h"
 #include "clutter-cairo.h"
 #include "clutter-color.h"
 #include "clutter-container.h"
@@ -66,13 +68,22 @@
 #include "clutter-enum-types.h"
 #include "clutter-event-private.h"
 #include "clutter-id-pool.h"
+#include "clutter-image-atlas.h"
+#include "clutter-image-cache.h"
+#include "clutter-input-predictor.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
 #include "clutter-master-clock.h"
+#include "clutter-paint-debug.h"
+#include "clutter-paint-stream-private.h"
 #include "clutter-paint-volume-private.h"
+#include "clutter-stage-hud.h"
 #include "clutter-private.h"
+#include "clutter-sdf-glyph-cache.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
+#include "clutter-text-layout-cache.h"
+#include "clutter-trace.h"
 #include "clutter-version.h" 	/* For flavour */
 #include "clutter-private.h"
 
@@ -99,11 +110,181 @@ typedef enum { /*< prefix=CLUTTER_STAGE >*/
 
 struct _ClutterStageQueueRedrawEntry
 {
+  /* the stage owning the entry; it is not referenced, as the stage
+   * frees its entries when it is destroyed
+   */
+  ClutterStage *stage;
+
   ClutterActor *actor;
   gboolean has_clip;
   ClutterPaintVolume clip;
+
+  /* the next entry in the pending list, or in the free list */
+  ClutterStageQueueRedrawEntry *next;
 };
 
+/* the number of processed queue redraw entries kept around for reuse,
+ * so that the redraws queued by every frame of an animation do not
+ * allocate
+ */
+#define QUEUE_REDRAW_ENTRY_POOL_SIZE    256
+
+/* the number of paint volumes in each chunk of the paint volume stack;
+ * the chunks are never moved, so the volumes handed out stay valid
+ * until the stack is reset
+ */
+#define PAINT_VOLUME_CHUNK_SIZE         64
+
+/* <private>
+ * PickRecord:
+ * @vertex: the stage-space vertices of the actor's pick rectangle
+ * @actor: the actor that was picked
+ * @clip_stack_top: the index of the innermost clip in the pick clip
+ *   stack at the time the record was logged, or -1
+ *
+ * A record of the silhouette of an actor, logged while performing
+ * a geometric pick.
+ */
+typedef struct _PickRecord
+{
+  ClutterVertex vertex[4];
+  ClutterActor *actor;
+  int clip_stack_top;
+} PickRecord;
+
+/* <private>
+ * PickClipRecord:
+ * @prev: the index of the enclosing clip, or -1
+ * @vertex: the stage-space vertices of the clip rectangle
+ *
+ * A clip rectangle pushed while performing a geometric pick.
+ */
+typedef struct _PickClipRecord
+{
+  int prev;
+  ClutterVertex vertex[4];
+} PickClipRecord;
+
+/* <private>
+ * PickCacheEntry:
+ * @generation: the scene generation at the time of the pick
+ * @x: the X coordinate of the pick
+ * @y: the Y coordinate of the pick
+ * @mode: the pick mode
+ * @actor: the picked actor
+ *
+ * A pick result, valid as long as the scene generation is the same.
+ */
+typedef struct _PickCacheEntry
+{
+  guint generation;
+  gint x;
+  gint y;
+  ClutterPickMode mode;
+  ClutterActor *actor;
+} PickCacheEntry;
+
+/* large enough to hold a pick for each finger of a multi-touch frame */
+#define PICK_CACHE_SIZE         16
+
+/*
+ * RasterCacheEntry:
+ * @actor: an actor flattened with CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC
+ * @size: the size of its offscreen image, in bytes
+ *
+ * An offscreen image accounted by the raster cache of the stage.
+ */
+typedef struct _RasterCacheEntry
+{
+  ClutterActor *actor;
+  gsize size;
+} RasterCacheEntry;
+
+/* the default limits of the raster cache */
+#define RASTER_CACHE_MAX_SIZE   2048
+#define RASTER_CACHE_BUDGET     (32 * 1024 * 1024)
+
+/* the size, in framebuffer pixels, of the offscreen target of the
+ * color-based pick; positions that fit inside it are picked together
+ */
+#define PICK_FRAMEBUFFER_SIZE   16
+
+/* the number of frames kept by the frame info history */
+#define FRAME_HISTORY_SIZE      128
+
+/* the number of swapped frames waiting for their presentation time */
+#define FRAME_PENDING_SIZE      4
+
+/* the number of frames in a row over the budget after which the
+ * adaptive quality is lowered, and the number of frames in a row with
+ * enough headroom after which it is raised again; the quality comes
+ * back slowly, so that it does not flip between two levels
+ */
+#define QUALITY_MISSES_TO_LOWER         3
+#define QUALITY_FRAMES_TO_RAISE         120
+
+/* the fraction of the budget, in percent, under which a frame leaves
+ * enough headroom to raise the quality
+ */
+#define QUALITY_HEADROOM_PERCENT        60
+
+/* the amount the dynamic resolution scale changes by at each step */
+#define RESOLUTION_SCALE_STEP           0.125f
+
+/* the initial capacity of the event queue; it must be a power of two */
+#define EVENT_QUEUE_MIN_SIZE    16
+
+/* a ring of the events queued for the next frame, which only grows */
+typedef struct _EventQueue
+{
+  ClutterEvent **events;
+  guint size;
+  guint head;
+  guint length;
+} EventQueue;
+
+/* the number of frames between reading a capture back and mapping
+ * it, which leaves the GPU the time to finish the transfer
+ */
+#define CAPTURE_MAP_DELAY       2
+
+/* the captures still in flight are delivered after this many
+ * milliseconds without a paint of the stage
+ */
+#define CAPTURE_FLUSH_TIMEOUT   50
+#define CAPTURE_FLUSH_SLACK     16
+
+/* the number of pixel buffers kept around for the next captures */
+#define CAPTURE_BUFFER_POOL_SIZE 3
+
+/* <private>
+ * StageCapture:
+ * @rect: the area to capture, in stage coordinates, or a negative
+ *   width for the whole stage
+ * @downscale: the factor the capture is scaled down by
+ * @func: the function called with the captured pixels
+ * @buffer: the pixel buffer the framebuffer was read back into
+ * @width: the width of the area read back, in framebuffer pixels
+ * @height: the height of the area read back, in framebuffer pixels
+ * @frames_left: the number of frames before @buffer is mapped
+ *
+ * A capture requested with clutter_stage_capture_async().
+ */
+typedef struct _StageCapture
+{
+  cairo_rectangle_int_t rect;
+  guint downscale;
+
+  ClutterStageCaptureFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+
+  CoglPixelBuffer *buffer;
+  gint width;
+  gint height;
+  guint frames_left;
+} StageCapture;
+
 struct _ClutterStagePrivate
 {
   /* the stage implementation */
@@ -115,20 +296,30 @@ struct _ClutterStagePrivate
   CoglMatrix view;
   float viewport[4];
 
+  /* the mapping from the z = 0 plane of the stage to window
+   * coordinates, if it is affine; see _clutter_stage_get_window_transform()
+   */
+  cairo_matrix_t window_transform;
+
   ClutterFog fog;
 
   gchar *title;
   ClutterActor *key_focused_actor;
 
-  GQueue *event_queue;
+  EventQueue event_queue;
+  ClutterInputPredictor *input_predictor;
 
   ClutterStageHint stage_hints;
 
-  GArray *paint_volume_stack;
+  GPtrArray *paint_volume_stack;
+  guint n_stack_paint_volumes;
 
   ClutterPlane current_clip_planes[4];
+  ClutterActorBox current_clip_box;
 
-  GList *pending_queue_redraws;
+  ClutterStageQueueRedrawEntry *pending_queue_redraws;
+  ClutterStageQueueRedrawEntry *free_queue_redraws;
+  guint n_free_queue_redraws;
 
   CoglFramebuffer *active_framebuffer;
 
@@ -139,8 +330,135 @@ struct _ClutterStagePrivate
 
   ClutterIDPool *pick_id_pool;
 
+  /* the RGBA8 target of the color-based pick, independent of the
+   * format of the onscreen framebuffer; pick_framebuffer is set while
+   * the pick is being painted into it
+   */
+  CoglTexture *pick_texture;
+  CoglOffscreen *pick_offscreen;
+  CoglFramebuffer *pick_framebuffer;
+
+  GArray *pick_stack;
+  GArray *pick_clip_stack;
+  int pick_clip_stack_top;
+
+  /* incremented every time the result of a pick could change */
+  guint scene_generation;
+
+  /* the scene generation at which the geometric pick last fell back
+   * to the color-based pick
+   */
+  guint pick_fallback_generation;
+
+  PickCacheEntry pick_cache[PICK_CACHE_SIZE];
+  guint pick_cache_next;
+
+  /* the actors with paint time transitions to sample before the
+   * next redraw
+   */
+  GHashTable *paint_time_actors;
+
+  /* the mapped actors whose visibility is tracked; they are removed
+   * when unmapped, so they are not referenced
+   */
+  GHashTable *visibility_trackers;
+
+  /* the actors whose notifications are held until the end of the
+   * layout phase, with a reference
+   */
+  GHashTable *frozen_actors;
+
+  /* the RasterCacheEntry of the flattened static actors, from the
+   * least recently painted; they are removed when unmapped, so the
+   * actors are not referenced
+   */
+  GQueue raster_cache;
+  gsize raster_cache_size;
+  gint raster_cache_max_size;
+  gsize raster_cache_budget;
+
+  /* the actors evicted from the raster cache while painting, whose
+   * images are released after the redraw
+   */
+  GPtrArray *raster_cache_evicted;
+
+  /* the relayout boundaries that need to be allocated again */
+  GHashTable *relayout_boundaries;
+
+  /* the relayout boundaries whose children are allocated during the
+   * next frame, because the budget of the current one was spent; the
+   * allocations inside them are stale until then
+   */
+  GHashTable *deferred_relayouts;
+
+  /* the time after which the relayout boundaries are deferred to the
+   * next frame, or 0 while the layout is computed at once
+   */
+  gint64 relayout_deadline;
+
+  /* the image of the stage at its previous size, blended over the new
+   * layout during a resize transition; the frames left to complete the
+   * layout, and the frames of the fade out once the layout is complete
+   */
+  CoglPipeline *resize_pipeline;
+  float resize_snapshot_width;
+  float resize_snapshot_height;
+  guint resize_layout_frames;
+  guint resize_fade_frames;
+  guint resize_n_fade_frames;
+
+  /* the sources of constraints whose allocation changed */
+  GHashTable *constraint_sources;
+
+  /* the render targets of the offscreen effects */
+  ClutterOffscreenPool *offscreen_pool;
+
+  /* the captures waiting for the next paint, and the captures read
+   * back and waiting to be mapped
+   */
+  GQueue pending_captures;
+  GQueue in_flight_captures;
+  GSList *capture_buffers;
+  guint capture_flush_id;
+
+  /* the timing information of the frame being updated, of the frames
+   * waiting to be presented, and of the last FRAME_HISTORY_SIZE frames
+   */
+  ClutterFrameInfo frame_current;
+  ClutterFrameInfo frame_pending[FRAME_PENDING_SIZE];
+  guint n_frames_pending;
+  ClutterFrameInfo *frame_history;
+  guint frame_history_next;
+  guint frame_history_len;
+  gint64 frame_counter;
+
+  /* the adaptive quality controller; see
+   * clutter_stage_set_adaptive_quality()
+   */
+  ClutterQualityLevel quality_level;
+  gint64 frame_budget;
+  guint quality_misses;
+  guint quality_good_frames;
+  gint64 last_presentation_time;
+  gint64 last_paint_end;
+
+  /* the scale of the offscreen buffer the stage is rendered into, and
+   * its lower bound; see clutter_stage_set_dynamic_resolution()
+   */
+  gfloat resolution_scale;
+  gfloat min_resolution_scale;
+
+  /* the performance overlay; see clutter_stage_set_show_hud() */
+  ClutterStageHud *hud;
+
+  /* not owned; see clutter_paint_recorder_new() */
+  ClutterPaintRecorder *paint_recorder;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gulong redraw_count;
+
+  gulong pick_cache_hits;
+  gulong pick_cache_misses;
 #endif /* CLUTTER_ENABLE_DEBUG */
 
   ClutterStageState current_state;
@@ -162,6 +480,20 @@ struct _ClutterStagePrivate
   guint accept_focus           : 1;
   guint motion_events_enabled  : 1;
   guint has_custom_perspective : 1;
+  guint geometric_picking      : 1;
+  guint coalesce_notifications : 1;
+  guint in_geometric_pick      : 1;
+  guint pick_needs_fallback    : 1;
+  guint adaptive_sync_delay    : 1;
+  guint collect_frame_info     : 1;
+  guint in_frame               : 1;
+  guint pick_offscreen_failed  : 1;
+  guint window_transform_valid : 1;
+  guint window_transform_is_2d : 1;
+  guint in_constraint_update   : 1;
+  guint in_scanout             : 1;
+  guint adaptive_quality       : 1;
+  guint depth_sorted_paint     : 1;
 };
 
 enum
@@ -192,6 +524,7 @@ enum
   DEACTIVATE,
   DELETE_EVENT,
   AFTER_PAINT,
+  FRAME_INFO,
 
   LAST_SIGNAL
 };
@@ -201,7 +534,15 @@ static guint stage_signals[LAST_SIGNAL] = { 0, };
 static const ClutterColor default_stage_color = { 255, 255, 255, 255 };
 
 static void clutter_stage_maybe_finish_queue_redraws (ClutterStage *stage);
-static void free_queue_redraw_entry (ClutterStageQueueRedrawEntry *entry);
+static void free_queue_redraw_entry (ClutterStage                 *stage,
+                                     ClutterStageQueueRedrawEntry *entry);
+static void clear_queue_redraw_entries (ClutterStage *stage);
+static void clutter_stage_clear_captures (ClutterStage *stage);
+static void clutter_stage_update_visibility (ClutterStage *stage);
+static void clutter_stage_thaw_notifications (ClutterStage *stage);
+static void clutter_stage_release_evicted_raster_cache (ClutterStage *stage);
+static void clutter_stage_paint_resize_snapshot (ClutterStage    *stage,
+                                                 CoglFramebuffer *fb);
 
 static void clutter_container_iface_init (ClutterContainerIface *iface);
 
@@ -611,6 +952,12 @@ _clutter_stage_update_active_framebuffer (ClutterStage *stage)
    * offscreen framebuffer.
    */
 
+  if (priv->pick_framebuffer != NULL)
+    {
+      priv->active_framebuffer = priv->pick_framebuffer;
+      return;
+    }
+
   priv->active_framebuffer =
     _clutter_stage_window_get_active_framebuffer (priv->impl);
 
@@ -670,6 +1017,11 @@ _clutter_stage_do_paint (ClutterStage                *stage,
       clip_poly[7] = geom.height * window_scale;
     }
 
+  priv->current_clip_box.x1 = clip_poly[0] / window_scale;
+  priv->current_clip_box.y1 = clip_poly[1] / window_scale;
+  priv->current_clip_box.x2 = clip_poly[4] / window_scale;
+  priv->current_clip_box.y2 = clip_poly[5] / window_scale;
+
   CLUTTER_NOTE (CLIPPING, "Setting stage clip too: "
                 "x=%f, y=%f, width=%f, height=%f",
                 clip_poly[0], clip_poly[1],
@@ -685,7 +1037,43 @@ _clutter_stage_do_paint (ClutterStage                *stage,
 
   _clutter_stage_paint_volume_stack_free_all (stage);
   _clutter_stage_update_active_framebuffer (stage);
+
+  CLUTTER_TRACE_BEGIN (PAINT, "ClutterStage::occlusion");
+  _clutter_actor_compute_occlusion (CLUTTER_ACTOR (stage));
+  CLUTTER_TRACE_END (PAINT);
+
+  if (G_UNLIKELY (clutter_paint_debug_flags & (CLUTTER_DEBUG_OVERDRAW |
+                                                CLUTTER_DEBUG_BATCH_BREAKS)))
+    _clutter_paint_debug_begin_frame ();
+
+  _clutter_actor_reset_paint_stats ();
+
+  if (priv->paint_recorder != NULL &&
+      _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+    _clutter_paint_recorder_begin_frame (priv->paint_recorder,
+                                         _clutter_stage_get_active_framebuffer (stage));
+
+  CLUTTER_TRACE_BEGIN (PAINT, "ClutterStage::paint");
   clutter_actor_paint (CLUTTER_ACTOR (stage));
+  CLUTTER_TRACE_END (PAINT);
+
+  if (priv->paint_recorder != NULL &&
+      _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+    _clutter_paint_recorder_end_frame (priv->paint_recorder);
+
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_OVERDRAW))
+    {
+      gfloat width, height;
+
+      clutter_actor_get_size (CLUTTER_ACTOR (stage), &width, &height);
+      _clutter_paint_debug_end_frame (_clutter_stage_get_active_framebuffer (stage),
+                                      width, height);
+    }
+
+  if (priv->hud != NULL &&
+      _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+    _clutter_stage_hud_draw (priv->hud, stage,
+                             _clutter_stage_get_active_framebuffer (stage));
 
   g_signal_emit (stage, stage_signals[AFTER_PAINT], 0);
 }
@@ -697,28 +1085,41 @@ _clutter_stage_do_paint (ClutterStage                *stage,
 static void
 clutter_stage_paint (ClutterActor *self)
 {
-  ClutterActorIter iter;
-  ClutterActor *child;
+  ClutterStage *stage = CLUTTER_STAGE (self);
+  CoglFramebuffer *fb = cogl_get_draw_framebuffer ();
+  gboolean depth_pass = FALSE;
 
-  clutter_actor_iter_init (&iter, self);
-  while (clutter_actor_iter_next (&iter, &child))
-    clutter_actor_paint (child);
+  /* the depth pass is only useful on the stage itself, and not
+   * while picking or painting the stage offscreen
+   */
+  if (stage->priv->depth_sorted_paint &&
+      _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE &&
+      fb == _clutter_stage_get_active_framebuffer (stage))
+    {
+      _clutter_actor_begin_depth_pass (self, fb);
+      depth_pass = TRUE;
+    }
+
+  _clutter_actor_paint_children (self);
+
+  if (depth_pass)
+    _clutter_actor_end_depth_pass ();
+
+  if (stage->priv->resize_pipeline != NULL &&
+      _clutter_context_get_pick_mode () == CLUTTER_PICK_NONE &&
+      fb == _clutter_stage_get_active_framebuffer (stage))
+    clutter_stage_paint_resize_snapshot (stage, fb);
 }
 
 static void
 clutter_stage_pick (ClutterActor       *self,
 		    const ClutterColor *color)
 {
-  ClutterActorIter iter;
-  ClutterActor *child;
-
   /* Note: we don't chain up to our parent as we don't want any geometry
    * emitted for the stage itself. The stage's pick id is effectively handled
    * by the call to cogl_clear done in clutter-main.c:_clutter_do_pick_async()
    */
-  clutter_actor_iter_init (&iter, self);
-  while (clutter_actor_iter_next (&iter, &child))
-    clutter_actor_paint (child);
+  _clutter_actor_paint_children (self);
 }
 
 static gboolean
@@ -899,6 +1300,160 @@ clutter_stage_real_fullscreen (ClutterStage *stage)
                           CLUTTER_ALLOCATION_NONE);
 }
 
+static inline ClutterEvent **
+event_queue_nth (EventQueue *queue,
+                 guint       n)
+{
+  return &queue->events[(queue->head + n) & (queue->size - 1)];
+}
+
+static void
+event_queue_push_tail (EventQueue   *queue,
+                       ClutterEvent *event)
+{
+  if (queue->length == queue->size)
+    {
+      guint new_size = MAX (queue->size * 2, EVENT_QUEUE_MIN_SIZE);
+      ClutterEvent **events = g_new (ClutterEvent *, new_size);
+      guint i;
+
+      for (i = 0; i < queue->length; i++)
+        events[i] = *event_queue_nth (queue, i);
+
+      g_free (queue->events);
+
+      queue->events = events;
+      queue->size = new_size;
+      queue->head = 0;
+    }
+
+  *event_queue_nth (queue, queue->length) = event;
+  queue->length += 1;
+}
+
+static ClutterEvent *
+event_queue_pop_head (EventQueue *queue)
+{
+  ClutterEvent *event;
+
+  if (queue->length == 0)
+    return NULL;
+
+  event = queue->events[queue->head];
+
+  queue->head = (queue->head + 1) & (queue->size - 1);
+  queue->length -= 1;
+
+  return event;
+}
+
+/* the picking pass needs the queued events in a single array */
+static ClutterEvent **
+event_queue_linearize (EventQueue *queue)
+{
+  if (queue->head + queue->length > queue->size)
+    {
+      ClutterEvent **events = g_new (ClutterEvent *, queue->size);
+      guint i;
+
+      for (i = 0; i < queue->length; i++)
+        events[i] = *event_queue_nth (queue, i);
+
+      g_free (queue->events);
+
+      queue->events = events;
+      queue->head = 0;
+    }
+
+  return queue->events + queue->head;
+}
+
+static void
+event_queue_clear (EventQueue *queue)
+{
+  ClutterEvent *event;
+
+  while ((event = event_queue_pop_head (queue)) != NULL)
+    clutter_event_free (event);
+
+  g_free (queue->events);
+  queue->events = NULL;
+  queue->size = 0;
+}
+
+/* Replaces a queued motion or touch update event with @event, if they
+ * come from the same pointer or touch point, so that a burst of input
+ * does not make the queue grow. The motion events only replace the
+ * last queued event, while the touch updates replace the update of
+ * their sequence inside the run of touch updates at the end of the
+ * queue, so that the fingers of a multi-touch gesture are compressed
+ * as well.
+ */
+static gboolean
+clutter_stage_compress_event (ClutterStage *stage,
+                              ClutterEvent *event)
+{
+  EventQueue *queue = &stage->priv->event_queue;
+  ClutterInputDevice *device;
+  guint n;
+
+  if (!stage->priv->throttle_motion_events || queue->length == 0)
+    return FALSE;
+
+  device = clutter_event_get_device (event);
+
+  for (n = queue->length; n > 0; n--)
+    {
+      ClutterEvent **slot = event_queue_nth (queue, n - 1);
+      ClutterEvent *queued = *slot;
+      ClutterInputDevice *queued_device = clutter_event_get_device (queued);
+
+      if (device != NULL && queued_device != NULL && device != queued_device)
+        return FALSE;
+
+      if (event->type == CLUTTER_MOTION || event->type == CLUTTER_LEAVE)
+        {
+          if (queued->type != CLUTTER_MOTION)
+            return FALSE;
+
+          CLUTTER_NOTE (EVENT,
+                        "Omitting motion event at %d, %d",
+                        (int) queued->motion.x,
+                        (int) queued->motion.y);
+
+          /* a leave event takes the place of the motion */
+          if (event->type == CLUTTER_MOTION)
+            _clutter_event_coalesce (event, queued);
+
+          clutter_event_free (queued);
+          *slot = event;
+
+          return TRUE;
+        }
+
+      if (event->type != CLUTTER_TOUCH_UPDATE ||
+          queued->type != CLUTTER_TOUCH_UPDATE)
+        return FALSE;
+
+      if (queued->touch.sequence == event->touch.sequence)
+        {
+          CLUTTER_NOTE (EVENT,
+                        "Omitting touch update event at %d, %d",
+                        (int) queued->touch.x,
+                        (int) queued->touch.y);
+
+          _clutter_event_coalesce (event, queued);
+
+          clutter_event_free (queued);
+          *slot = event;
+
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
 void
 _clutter_stage_queue_event (ClutterStage *stage,
                             ClutterEvent *event,
@@ -912,12 +1467,13 @@ _clutter_stage_queue_event (ClutterStage *stage,
 
   priv = stage->priv;
 
-  first_event = priv->event_queue->length == 0;
+  first_event = priv->event_queue.length == 0;
 
   if (copy_event)
     event = clutter_event_copy (event);
 
-  g_queue_push_tail (priv->event_queue, event);
+  if (!clutter_stage_compress_event (stage, event))
+    event_queue_push_tail (&priv->event_queue, event);
 
   if (first_event)
     {
@@ -955,88 +1511,85 @@ _clutter_stage_has_queued_events (ClutterStage *stage)
 
   priv = stage->priv;
 
-  return priv->event_queue->length > 0;
+  return priv->event_queue.length > 0;
+}
+
+/* records the input device time of an event processed by the frame */
+static void
+clutter_stage_frame_info_add_input (ClutterStage       *stage,
+                                    const ClutterEvent *event)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterFrameInfo *info = &priv->frame_current;
+  gint64 hardware_time;
+
+  if (!priv->in_frame)
+    return;
+
+  hardware_time = clutter_event_get_hardware_time (event);
+  if (hardware_time == 0)
+    return;
+
+  if (info->n_input_events == 0 || hardware_time < info->oldest_input_time)
+    info->oldest_input_time = hardware_time;
+
+  if (info->n_input_events == 0 || hardware_time > info->newest_input_time)
+    info->newest_input_time = hardware_time;
+
+  info->n_input_events += 1;
 }
 
 void
 _clutter_stage_process_queued_events (ClutterStage *stage)
 {
   ClutterStagePrivate *priv;
-  GList *events, *l;
+  ClutterStageWindow *stage_window;
+  ClutterEvent *event;
+  gint64 presentation_time = 0;
+  guint n_events;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
 
-  if (priv->event_queue->length == 0)
+  if (priv->event_queue.length == 0)
     return;
 
+  /* the events are going to be handled by the next frame */
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window != NULL)
+    presentation_time =
+      _clutter_stage_window_get_next_presentation_time (stage_window);
+
   /* In case the stage gets destroyed during event processing */
   g_object_ref (stage);
 
-  /* Steal events before starting processing to avoid reentrancy
-   * issues */
-  events = priv->event_queue->head;
-  priv->event_queue->head =  NULL;
-  priv->event_queue->tail = NULL;
-  priv->event_queue->length = 0;
-
-  for (l = events; l != NULL; l = l->next)
-    {
-      ClutterEvent *event;
-      ClutterEvent *next_event;
-      ClutterInputDevice *device;
-      ClutterInputDevice *next_device;
-      gboolean check_device = FALSE;
-
-      event = l->data;
-      next_event = l->next ? l->next->data : NULL;
-
-      device = clutter_event_get_device (event);
+  /* resolve all the touch points of the frame at once */
+  _clutter_pick_queued_touch_events (stage,
+                                     event_queue_linearize (&priv->event_queue),
+                                     priv->event_queue.length);
 
-      if (next_event != NULL)
-        next_device = clutter_event_get_device (next_event);
-      else
-        next_device = NULL;
+  /* only process the events queued so far, to avoid reentrancy
+   * issues; the events queued by the handlers go to the next frame,
+   * and the consecutive motion events have already been compressed
+   * when queueing them
+   */
+  n_events = priv->event_queue.length;
 
-      if (device != NULL && next_device != NULL)
-        check_device = TRUE;
+  while (n_events-- > 0 &&
+         (event = event_queue_pop_head (&priv->event_queue)) != NULL)
+    {
+      _clutter_input_predictor_process_event (priv->input_predictor,
+                                              event,
+                                              presentation_time);
 
-      /* Skip consecutive motion events coming from the same device */
-      if (priv->throttle_motion_events && next_event != NULL)
-        {
-          if (event->type == CLUTTER_MOTION &&
-              (next_event->type == CLUTTER_MOTION ||
-               next_event->type == CLUTTER_LEAVE) &&
-              (!check_device || (device == next_device)))
-            {
-              CLUTTER_NOTE (EVENT,
-                            "Omitting motion event at %d, %d",
-                            (int) event->motion.x,
-                            (int) event->motion.y);
-              goto next_event;
-            }
-          else if (event->type == CLUTTER_TOUCH_UPDATE &&
-                   next_event->type == CLUTTER_TOUCH_UPDATE &&
-                   event->touch.sequence == next_event->touch.sequence &&
-                   (!check_device || (device == next_device)))
-            {
-              CLUTTER_NOTE (EVENT,
-                            "Omitting touch update event at %d, %d",
-                            (int) event->touch.x,
-                            (int) event->touch.y);
-              goto next_event;
-            }
-        }
+      clutter_stage_frame_info_add_input (stage, event);
 
       _clutter_process_event (event);
 
-    next_event:
       clutter_event_free (event);
     }
 
-  g_list_free (events);
-
   g_object_unref (stage);
 }
 
@@ -1057,2597 +1610,5867 @@ _clutter_stage_needs_update (ClutterStage *stage)
 
   priv = stage->priv;
 
-  return priv->relayout_pending || priv->redraw_pending;
+  return priv->relayout_pending ||
+         priv->redraw_pending ||
+         priv->relayout_boundaries != NULL ||
+         priv->deferred_relayouts != NULL ||
+         priv->resize_pipeline != NULL ||
+         priv->constraint_sources != NULL ||
+         priv->paint_time_actors != NULL;
 }
 
+/*< private >
+ * _clutter_stage_queue_paint_time_sample:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor inside @stage
+ *
+ * Queues @actor for sampling its paint time transitions during the
+ * next update of @stage.
+ */
 void
-_clutter_stage_maybe_relayout (ClutterActor *actor)
+_clutter_stage_queue_paint_time_sample (ClutterStage *stage,
+                                        ClutterActor *actor)
 {
-  ClutterStage *stage = CLUTTER_STAGE (actor);
   ClutterStagePrivate *priv = stage->priv;
-  gfloat natural_width, natural_height;
-  ClutterActorBox box = { 0, };
-
-  if (!priv->relayout_pending)
-    return;
 
-  /* avoid reentrancy */
-  if (!CLUTTER_ACTOR_IN_RELAYOUT (stage))
+  if (priv->paint_time_actors == NULL)
     {
-      priv->relayout_pending = FALSE;
+      priv->paint_time_actors = g_hash_table_new_full (NULL, NULL,
+                                                       g_object_unref,
+                                                       NULL);
+      _clutter_stage_schedule_update (stage);
+    }
 
-      CLUTTER_NOTE (ACTOR, "Recomputing layout");
+  if (!g_hash_table_contains (priv->paint_time_actors, actor))
+    g_hash_table_add (priv->paint_time_actors, g_object_ref (actor));
+}
 
-      CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+/*< private >
+ * _clutter_stage_queue_relayout_boundary:
+ * @stage: a #ClutterStage
+ * @actor: a relayout boundary inside @stage
+ *
+ * Queues @actor to be allocated again during the next relayout of
+ * @stage, without a relayout of the whole stage.
+ */
+void
+_clutter_stage_queue_relayout_boundary (ClutterStage *stage,
+                                        ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
 
-      natural_width = natural_height = 0;
-      clutter_actor_get_preferred_size (CLUTTER_ACTOR (stage),
-                                        NULL, NULL,
-                                        &natural_width, &natural_height);
+  if (priv->relayout_boundaries == NULL)
+    {
+      priv->relayout_boundaries = g_hash_table_new_full (NULL, NULL,
+                                                         g_object_unref,
+                                                         NULL);
+      _clutter_stage_schedule_update (stage);
+    }
 
-      box.x1 = 0;
-      box.y1 = 0;
-      box.x2 = natural_width;
-      box.y2 = natural_height;
+  if (!g_hash_table_contains (priv->relayout_boundaries, actor))
+    g_hash_table_add (priv->relayout_boundaries, g_object_ref (actor));
 
-      CLUTTER_NOTE (ACTOR, "Allocating (0, 0 - %d, %d) for the stage",
-                    (int) natural_width,
-                    (int) natural_height);
+  _clutter_stage_invalidate_pick_cache (stage);
+}
 
-      clutter_actor_allocate (CLUTTER_ACTOR (stage),
-                              &box, CLUTTER_ALLOCATION_NONE);
+/*< private >
+ * _clutter_stage_defer_relayout_boundary:
+ * @stage: a #ClutterStage
+ * @actor: a relayout boundary inside @stage
+ *
+ * Queues @actor to be allocated again during the next frame, once the
+ * relayout deadline of the current frame has expired.
+ */
+void
+_clutter_stage_defer_relayout_boundary (ClutterStage *stage,
+                                        ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
 
-      CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+  if (priv->deferred_relayouts == NULL)
+    {
+      priv->deferred_relayouts = g_hash_table_new_full (NULL, NULL,
+                                                        g_object_unref,
+                                                        NULL);
+      _clutter_stage_schedule_update (stage);
     }
+
+  if (!g_hash_table_contains (priv->deferred_relayouts, actor))
+    g_hash_table_add (priv->deferred_relayouts, g_object_ref (actor));
 }
 
-static void
-clutter_stage_do_redraw (ClutterStage *stage)
+/*< private >
+ * _clutter_stage_relayout_deadline_expired:
+ * @stage: a #ClutterStage
+ *
+ * Checks whether the layout of the current frame has spent its budget,
+ * in which case the relayout boundaries defer the allocation of their
+ * children using _clutter_stage_defer_relayout_boundary().
+ *
+ * Return value: %TRUE if the relayout deadline has expired
+ */
+gboolean
+_clutter_stage_relayout_deadline_expired (ClutterStage *stage)
 {
-  ClutterBackend *backend = clutter_get_default_backend ();
-  ClutterActor *actor = CLUTTER_ACTOR (stage);
   ClutterStagePrivate *priv = stage->priv;
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
-    return;
+  return priv->relayout_deadline != 0 &&
+         g_get_monotonic_time () >= priv->relayout_deadline;
+}
 
-  if (priv->impl == NULL)
-    return;
+/* paints the stage at its current size into a texture, which is
+ * blended over the stage while its new layout is computed
+ */
+static gboolean
+clutter_stage_capture_resize_snapshot (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  CoglContext *ctx;
+  CoglTexture *texture;
+  CoglOffscreen *offscreen;
+  CoglFramebuffer *fb;
+  CoglError *error = NULL;
+  CoglMatrix modelview;
+  int window_scale, width, height;
 
-  CLUTTER_NOTE (PAINT, "Redraw started for stage '%s'[%p]",
-                _clutter_actor_get_debug_name (actor),
-                stage);
+  if (!clutter_feature_available (CLUTTER_FEATURE_OFFSCREEN))
+    return FALSE;
 
-  _clutter_backend_ensure_context (backend, stage);
+  window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+  width = priv->viewport[2] * window_scale;
+  height = priv->viewport[3] * window_scale;
 
-  if (_clutter_context_get_show_fps ())
-    {
-      if (priv->fps_timer == NULL)
-        priv->fps_timer = g_timer_new ();
-    }
+  if (width <= 0 || height <= 0)
+    return FALSE;
 
-  _clutter_stage_maybe_setup_viewport (stage);
+  texture = cogl_texture_new_with_size (width, height,
+                                        COGL_TEXTURE_NO_SLICING |
+                                        COGL_TEXTURE_NO_AUTO_MIPMAP,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (texture == NULL)
+    return FALSE;
 
-  _clutter_stage_window_redraw (priv->impl);
+  offscreen = cogl_offscreen_new_with_texture (texture);
+  fb = COGL_FRAMEBUFFER (offscreen);
 
-  if (_clutter_context_get_show_fps ())
+  if (!cogl_framebuffer_allocate (fb, &error))
     {
-      priv->timer_n_frames += 1;
+      CLUTTER_NOTE (PAINT, "Unable to allocate the resize snapshot: %s",
+                    error->message);
+      cogl_error_free (error);
 
-      if (g_timer_elapsed (priv->fps_timer, NULL) >= 1.0)
-        {
-          g_print ("*** FPS for %s: %i ***\n",
-                   _clutter_actor_get_debug_name (actor),
-                   priv->timer_n_frames);
+      cogl_object_unref (offscreen);
+      cogl_object_unref (texture);
 
-          priv->timer_n_frames = 0;
-          g_timer_start (priv->fps_timer);
-        }
+      return FALSE;
     }
 
-  CLUTTER_NOTE (PAINT, "Redraw finished for stage '%s'[%p]",
-                _clutter_actor_get_debug_name (actor),
-                stage);
+  /* the layout is still the one of the previous size, and the stage
+   * applies its own view transformation
+   */
+  cogl_framebuffer_set_viewport (fb, 0, 0, width, height);
+  cogl_framebuffer_set_projection_matrix (fb, &priv->projection);
+  cogl_matrix_init_identity (&modelview);
+  cogl_framebuffer_set_modelview_matrix (fb, &modelview);
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR, 0.f, 0.f, 0.f, 0.f);
+
+  cogl_push_framebuffer (fb);
+  clutter_actor_paint (CLUTTER_ACTOR (stage));
+  cogl_pop_framebuffer ();
+
+  cogl_object_unref (offscreen);
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  priv->resize_pipeline = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_layer_texture (priv->resize_pipeline, 0, texture);
+  cogl_object_unref (texture);
+
+  priv->resize_snapshot_width = priv->viewport[2];
+  priv->resize_snapshot_height = priv->viewport[3];
+
+  return TRUE;
 }
 
-/**
- * _clutter_stage_do_update:
- * @stage: A #ClutterStage
+/*< private >
+ * _clutter_stage_begin_resize_transition:
+ * @stage: a #ClutterStage about to be resized
+ * @n_frames: the number of frames of the transition
  *
- * Handles per-frame layout and repaint for the stage.
+ * Keeps an image of @stage at its current size, and blends it over the
+ * stage during the next @n_frames frames: the first half of them
+ * spread the relayout of the relayout boundaries over several frames,
+ * and the image fades out once the layout is complete.
  *
- * Return value: %TRUE if the stage was updated
+ * A resize during a transition keeps the image of the first size, as
+ * the stage is not fully laid out in the meantime.
  */
-gboolean
-_clutter_stage_do_update (ClutterStage *stage)
+void
+_clutter_stage_begin_resize_transition (ClutterStage *stage,
+                                        guint         n_frames)
 {
   ClutterStagePrivate *priv = stage->priv;
 
-  /* if the stage is being destroyed, or if the destruction already
-   * happened and we don't have an StageWindow any more, then we
-   * should bail out
-   */
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage) || priv->impl == NULL)
-    return FALSE;
-
-  if (!CLUTTER_ACTOR_IS_REALIZED (stage))
-    return FALSE;
+  if (n_frames == 0 || priv->impl == NULL ||
+      !CLUTTER_ACTOR_IS_MAPPED (stage))
+    return;
 
-  /* NB: We need to ensure we have an up to date layout *before* we
-   * check or clear the pending redraws flag since a relayout may
-   * queue a redraw.
-   */
-  _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+  if (priv->resize_pipeline == NULL &&
+      !clutter_stage_capture_resize_snapshot (stage))
+    return;
 
-  if (!priv->redraw_pending)
-    return FALSE;
+  CLUTTER_NOTE (LAYOUT, "Starting a resize transition of %u frames",
+                n_frames);
 
-  clutter_stage_maybe_finish_queue_redraws (stage);
+  priv->resize_layout_frames = MAX (n_frames / 2, 1);
+  priv->resize_n_fade_frames = MAX (n_frames - priv->resize_layout_frames, 1);
+  priv->resize_fade_frames = priv->resize_n_fade_frames;
 
-  clutter_stage_do_redraw (stage);
+  _clutter_stage_schedule_update (stage);
+}
 
-  /* reset the guard, so that new redraws are possible */
-  priv->redraw_pending = FALSE;
+/* sets the budget of the layout of the frame during a resize
+ * transition, and queues the relayout boundaries deferred by the
+ * previous frame
+ */
+static void
+clutter_stage_begin_relayout_slice (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  GHashTable *deferred;
+  GHashTableIter iter;
+  gpointer actor;
 
-#ifdef CLUTTER_ENABLE_DEBUG
-  if (priv->redraw_count > 0)
+  if (priv->resize_layout_frames > 0)
     {
-      CLUTTER_NOTE (SCHEDULER, "Queued %lu redraws during the last cycle",
-                    priv->redraw_count);
+      priv->resize_layout_frames -= 1;
 
-      priv->redraw_count = 0;
+      /* the last frame of the transition completes the layout */
+      if (priv->resize_layout_frames > 0)
+        priv->relayout_deadline = g_get_monotonic_time () +
+                                  G_USEC_PER_SEC / clutter_get_default_frame_rate () / 2;
     }
-#endif /* CLUTTER_ENABLE_DEBUG */
 
-  return TRUE;
+  /* the image is painted again on every frame of the transition */
+  if (priv->resize_pipeline != NULL)
+    clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+
+  if (priv->deferred_relayouts == NULL)
+    return;
+
+  deferred = priv->deferred_relayouts;
+  priv->deferred_relayouts = NULL;
+
+  g_hash_table_iter_init (&iter, deferred);
+  while (g_hash_table_iter_next (&iter, &actor, NULL))
+    _clutter_stage_queue_relayout_boundary (stage, actor);
+
+  g_hash_table_unref (deferred);
 }
 
 static void
-clutter_stage_real_queue_relayout (ClutterActor *self)
+clutter_stage_advance_resize_transition (ClutterStage *stage)
 {
-  ClutterStage *stage = CLUTTER_STAGE (self);
   ClutterStagePrivate *priv = stage->priv;
-  ClutterActorClass *parent_class;
 
-  if (!priv->relayout_pending)
+  if (priv->resize_pipeline == NULL)
+    return;
+
+  /* the image covers the stage until the layout is complete */
+  if (priv->deferred_relayouts != NULL)
+    return;
+
+  priv->resize_layout_frames = 0;
+
+  if (priv->resize_fade_frames > 0)
+    priv->resize_fade_frames -= 1;
+
+  if (priv->resize_fade_frames == 0)
     {
-      _clutter_stage_schedule_update (stage);
-      priv->relayout_pending = TRUE;
-    }
+      CLUTTER_NOTE (LAYOUT, "Resize transition complete");
 
-  /* chain up */
-  parent_class = CLUTTER_ACTOR_CLASS (clutter_stage_parent_class);
-  parent_class->queue_relayout (self);
+      g_clear_pointer (&priv->resize_pipeline, cogl_object_unref);
+      clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+    }
 }
 
 static void
-clutter_stage_real_queue_redraw (ClutterActor *actor,
-                                 ClutterActor *leaf)
+clutter_stage_paint_resize_snapshot (ClutterStage    *stage,
+                                     CoglFramebuffer *fb)
 {
-  ClutterStage *stage = CLUTTER_STAGE (actor);
-  ClutterStageWindow *stage_window;
-  ClutterPaintVolume *redraw_clip;
-  ClutterActorBox bounding_box;
-  ClutterActorBox intersection_box;
-  cairo_rectangle_int_t geom, stage_clip;
+  ClutterStagePrivate *priv = stage->priv;
+  float width, height, scale;
+  float x, y, w, h;
+  guint8 opacity;
+
+  clutter_actor_get_size (CLUTTER_ACTOR (stage), &width, &height);
+
+  /* the image keeps its aspect ratio, centered on the stage */
+  scale = MIN (width / priv->resize_snapshot_width,
+               height / priv->resize_snapshot_height);
+  w = priv->resize_snapshot_width * scale;
+  h = priv->resize_snapshot_height * scale;
+  x = (width - w) / 2.f;
+  y = (height - h) / 2.f;
+
+  if (priv->deferred_relayouts != NULL)
+    opacity = 255;
+  else
+    opacity = 255 * priv->resize_fade_frames / (priv->resize_n_fade_frames + 1);
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (actor))
-    return;
+  cogl_pipeline_set_color4ub (priv->resize_pipeline,
+                              opacity, opacity, opacity, opacity);
+  cogl_framebuffer_draw_textured_rectangle (fb, priv->resize_pipeline,
+                                            x, y, x + w, y + h,
+                                            0.f, 0.f, 1.f, 1.f);
+}
 
-  /* If the backend can't do anything with redraw clips (e.g. it already knows
-   * it needs to redraw everything anyway) then don't spend time transforming
-   * any clip volume into stage coordinates... */
-  stage_window = _clutter_stage_get_window (stage);
-  if (stage_window == NULL)
+/*< private >
+ * _clutter_stage_queue_constraint_source:
+ * @stage: a #ClutterStage
+ * @actor: the source of a constraint inside @stage
+ *
+ * Queues the actors depending on the allocation of @actor through
+ * their constraints to be allocated again during the next relayout
+ * of @stage.
+ */
+void
+_clutter_stage_queue_constraint_source (ClutterStage *stage,
+                                        ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  /* the dependents are already being allocated in order */
+  if (priv->in_constraint_update)
     return;
 
-  if (_clutter_stage_window_ignoring_redraw_clips (stage_window))
+  if (priv->constraint_sources == NULL)
     {
-      _clutter_stage_window_add_redraw_clip (stage_window, NULL);
-      return;
+      priv->constraint_sources = g_hash_table_new_full (NULL, NULL,
+                                                        g_object_unref,
+                                                        NULL);
+      _clutter_stage_schedule_update (stage);
     }
 
-  /* Convert the clip volume into stage coordinates and then into an
-   * axis aligned stage coordinates bounding box...
-   */
-  redraw_clip = _clutter_actor_get_queue_redraw_clip (leaf);
-  if (redraw_clip == NULL)
-    {
-      _clutter_stage_window_add_redraw_clip (stage_window, NULL);
-      return;
-    }
+  if (!g_hash_table_contains (priv->constraint_sources, actor))
+    g_hash_table_add (priv->constraint_sources, g_object_ref (actor));
+}
 
-  if (redraw_clip->is_empty)
-    return;
+enum
+{
+  CONSTRAINT_NODE_VISITING = 1,
+  CONSTRAINT_NODE_VISITED
+};
 
-  _clutter_paint_volume_get_stage_paint_box (redraw_clip,
-                                             stage,
-                                             &bounding_box);
+/* appends @actor to @order after all the actors depending on it */
+static void
+clutter_stage_sort_constraint_dependents (ClutterStage *stage,
+                                          ClutterActor *actor,
+                                          GHashTable   *marks,
+                                          GPtrArray    *order)
+{
+  GPtrArray *dependents;
+  guint i;
 
-  _clutter_stage_window_get_geometry (stage_window, &geom);
+  g_hash_table_insert (marks, actor, GINT_TO_POINTER (CONSTRAINT_NODE_VISITING));
 
-  intersection_box.x1 = MAX (bounding_box.x1, 0);
-  intersection_box.y1 = MAX (bounding_box.y1, 0);
-  intersection_box.x2 = MIN (bounding_box.x2, geom.width);
-  intersection_box.y2 = MIN (bounding_box.y2, geom.height);
+  dependents = _clutter_actor_peek_constraint_dependents (actor);
 
-  /* There is no need to track degenerate/empty redraw clips */
-  if (intersection_box.x2 <= intersection_box.x1 ||
-      intersection_box.y2 <= intersection_box.y1)
-    return;
+  for (i = 0; dependents != NULL && i < dependents->len; i++)
+    {
+      ClutterActorMeta *meta = g_ptr_array_index (dependents, i);
+      ClutterActor *dependent = clutter_actor_meta_get_actor (meta);
+      gint mark;
 
-  /* when converting to integer coordinates make sure we round the edges of the
-   * clip rectangle outwards... */
-  stage_clip.x = intersection_box.x1;
-  stage_clip.y = intersection_box.y1;
-  stage_clip.width = intersection_box.x2 - stage_clip.x;
-  stage_clip.height = intersection_box.y2 - stage_clip.y;
+      if (dependent == NULL || !clutter_actor_meta_get_enabled (meta))
+        continue;
 
-  _clutter_stage_window_add_redraw_clip (stage_window, &stage_clip);
-}
+      if (_clutter_actor_get_stage_internal (dependent) != CLUTTER_ACTOR (stage))
+        continue;
 
-gboolean
-_clutter_stage_has_full_redraw_queued (ClutterStage *stage)
-{
-  ClutterStageWindow *stage_window = _clutter_stage_get_window (stage);
+      mark = GPOINTER_TO_INT (g_hash_table_lookup (marks, dependent));
+      if (mark == CONSTRAINT_NODE_VISITING)
+        {
+          CLUTTER_NOTE (LAYOUT, "The constraint '%s' of '%s' is part of "
+                        "a cycle, and it is not applied again",
+                        _clutter_actor_meta_get_debug_name (meta),
+                        _clutter_actor_get_debug_name (dependent));
+          continue;
+        }
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage) || stage_window == NULL)
-    return FALSE;
+      if (mark == 0)
+        clutter_stage_sort_constraint_dependents (stage, dependent, marks, order);
+    }
 
-  if (stage->priv->redraw_pending &&
-      !_clutter_stage_window_has_redraw_clips (stage_window))
-    return TRUE;
-  else
-    return FALSE;
+  g_hash_table_insert (marks, actor, GINT_TO_POINTER (CONSTRAINT_NODE_VISITED));
+  g_ptr_array_add (order, g_object_ref (actor));
 }
 
-/**
- * clutter_stage_get_redraw_clip_bounds:
- * @stage: A #ClutterStage
- * @clip: (out caller-allocates): Return location for the clip bounds
- *
- * Gets the bounds of the current redraw for @stage in stage pixel
- * coordinates. E.g., if only a single actor has queued a redraw then
- * Clutter may redraw the stage with a clip so that it doesn't have to
- * paint every pixel in the stage. This function would then return the
- * bounds of that clip. An application can use this information to
- * avoid some extra work if it knows that some regions of the stage
- * aren't going to be painted. This should only be called while the
- * stage is being painted. If there is no current redraw clip then
- * this function will set @clip to the full extents of the stage.
- *
- * Since: 1.8
+/* allocates again, once and after their sources, all the actors that
+ * depend on the actors whose allocation changed
  */
-void
-clutter_stage_get_redraw_clip_bounds (ClutterStage          *stage,
-                                      cairo_rectangle_int_t *clip)
+static void
+clutter_stage_update_constraints (ClutterStage *stage)
 {
-  ClutterStagePrivate *priv;
+  ClutterStagePrivate *priv = stage->priv;
+  GHashTable *sources, *marks;
+  GHashTableIter iter;
+  GPtrArray *order;
+  gpointer actor;
+  guint i;
 
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (clip != NULL);
+  if (priv->constraint_sources == NULL)
+    return;
 
-  priv = stage->priv;
+  sources = priv->constraint_sources;
+  priv->constraint_sources = NULL;
 
-  if (!_clutter_stage_window_get_redraw_clip_bounds (priv->impl, clip))
+  marks = g_hash_table_new (NULL, NULL);
+  order = g_ptr_array_new_with_free_func (g_object_unref);
+
+  g_hash_table_iter_init (&iter, sources);
+  while (g_hash_table_iter_next (&iter, &actor, NULL))
     {
-      /* Set clip to the full extents of the stage */
-      _clutter_stage_window_get_geometry (priv->impl, clip);
+      if (!g_hash_table_contains (marks, actor))
+        clutter_stage_sort_constraint_dependents (stage, actor, marks, order);
     }
+
+  CLUTTER_NOTE (ACTOR, "Applying the constraints of %u actors depending "
+                "on %u sources",
+                order->len - g_hash_table_size (sources),
+                g_hash_table_size (sources));
+
+  priv->in_constraint_update = TRUE;
+  CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+
+  /* the sources come last in the post-order */
+  for (i = order->len; i > 0; i--)
+    _clutter_actor_update_constraints_allocation (g_ptr_array_index (order, i - 1));
+
+  CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+  priv->in_constraint_update = FALSE;
+
+  g_ptr_array_unref (order);
+  g_hash_table_unref (marks);
+  g_hash_table_unref (sources);
 }
 
 static void
-read_pixels_to_file (char *filename_stem,
-                     int   x,
-                     int   y,
-                     int   width,
-                     int   height)
+clutter_stage_relayout_boundaries (ClutterStage *stage)
 {
-  guint8 *data;
-  cairo_surface_t *surface;
-  static int read_count = 0;
-  char *filename = g_strdup_printf ("%s-%05d.png",
-                                    filename_stem,
-                                    read_count);
+  ClutterStagePrivate *priv = stage->priv;
+  GHashTable *boundaries;
+  GHashTableIter iter;
+  gpointer actor;
 
-  data = g_malloc (4 * width * height);
-  cogl_read_pixels (x, y, width, height,
-                    COGL_READ_PIXELS_COLOR_BUFFER,
-                    CLUTTER_CAIRO_FORMAT_ARGB32,
-                    data);
+  if (priv->relayout_boundaries == NULL)
+    return;
 
-  surface = cairo_image_surface_create_for_data (data, CAIRO_FORMAT_RGB24,
-                                                 width, height,
-                                                 width * 4);
+  boundaries = priv->relayout_boundaries;
+  priv->relayout_boundaries = NULL;
 
-  cairo_surface_write_to_png (surface, filename);
-  cairo_surface_destroy (surface);
+  CLUTTER_NOTE (ACTOR, "Recomputing the layout of %u relayout boundaries",
+                g_hash_table_size (boundaries));
 
-  g_free (data);
-  g_free (filename);
+  g_hash_table_iter_init (&iter, boundaries);
+  while (g_hash_table_iter_next (&iter, &actor, NULL))
+    _clutter_actor_relayout_boundary (actor);
 
-  read_count++;
+  g_hash_table_unref (boundaries);
 }
 
-ClutterActor *
-_clutter_stage_do_pick (ClutterStage   *stage,
-                        gint            x,
-                        gint            y,
-                        ClutterPickMode mode)
+static void
+clutter_stage_sample_paint_time_transitions (ClutterStage *stage)
 {
-  ClutterActor *actor = CLUTTER_ACTOR (stage);
   ClutterStagePrivate *priv = stage->priv;
-  ClutterMainContext *context;
-  guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
-  CoglColor stage_pick_id;
-  gboolean dither_enabled_save;
-  ClutterActor *retval;
-  CoglFramebuffer *fb;
-  gint dirty_x;
-  gint dirty_y;
-  gint read_x;
-  gint read_y;
-  float stage_width, stage_height;
-  int window_scale;
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer actor;
+  gint64 frame_time;
 
-  priv = stage->priv;
+  if (priv->paint_time_actors == NULL)
+    return;
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
-    return actor;
+  /* the transitions are sampled after the events have been processed
+   * and the layout has been computed, which may take a while after the
+   * master clock advanced the timelines
+   */
+  frame_time = g_get_monotonic_time () / 1000;
 
-  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING))
-    return actor;
+  actors = priv->paint_time_actors;
+  priv->paint_time_actors = NULL;
 
-  if (G_UNLIKELY (priv->impl == NULL))
-    return actor;
+  g_hash_table_iter_init (&iter, actors);
+  while (g_hash_table_iter_next (&iter, &actor, NULL))
+    _clutter_actor_sample_paint_time_transitions (actor, frame_time);
 
-  clutter_actor_get_size (CLUTTER_ACTOR (stage), &stage_width, &stage_height);
-  if (x < 0 || x >= stage_width || y < 0 || y >= stage_height)
-    return actor;
+  g_hash_table_unref (actors);
+}
 
-  context = _clutter_context_get_default ();
-  clutter_stage_ensure_current (stage);
-  window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+static void
+clutter_stage_relayout (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gfloat natural_width, natural_height;
+  ClutterActorBox box = { 0, };
 
-  fb = cogl_get_draw_framebuffer ();
+  if (priv->relayout_pending)
+    {
+      priv->relayout_pending = FALSE;
 
-  _clutter_backend_ensure_context (context->backend, stage);
+      CLUTTER_NOTE (ACTOR, "Recomputing layout");
 
-  /* needed for when a context switch happens */
-  _clutter_stage_maybe_setup_viewport (stage);
+      _clutter_stage_invalidate_pick_cache (stage);
+
+      CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
 
-  _clutter_stage_window_get_dirty_pixel (priv->impl, &dirty_x, &dirty_y);
+      natural_width = natural_height = 0;
+      clutter_actor_get_preferred_size (CLUTTER_ACTOR (stage),
+                                        NULL, NULL,
+                                        &natural_width, &natural_height);
 
-  if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
-    cogl_framebuffer_push_scissor_clip (fb, dirty_x * window_scale, dirty_y * window_scale, 1, 1);
+      box.x1 = 0;
+      box.y1 = 0;
+      box.x2 = natural_width;
+      box.y2 = natural_height;
 
-  cogl_set_viewport (priv->viewport[0] * window_scale - x * window_scale + dirty_x * window_scale,
-                     priv->viewport[1] * window_scale - y * window_scale + dirty_y * window_scale,
-                     priv->viewport[2] * window_scale,
-                     priv->viewport[3] * window_scale);
+      CLUTTER_NOTE (ACTOR, "Allocating (0, 0 - %d, %d) for the stage",
+                    (int) natural_width,
+                    (int) natural_height);
 
-  read_x = dirty_x * window_scale;
-  read_y = dirty_y * window_scale;
+      clutter_actor_allocate (CLUTTER_ACTOR (stage),
+                              &box, CLUTTER_ALLOCATION_NONE);
 
-  CLUTTER_NOTE (PICK, "Performing pick at %i,%i", x, y);
+      CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+    }
+}
 
-  cogl_color_init_from_4ub (&stage_pick_id, 255, 255, 255, 255);
-  cogl_clear (&stage_pick_id, COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH);
+void
+_clutter_stage_maybe_relayout (ClutterActor *actor)
+{
+  ClutterStage *stage = CLUTTER_STAGE (actor);
+  ClutterStagePrivate *priv = stage->priv;
 
-  /* Disable dithering (if any) when doing the painting in pick mode */
-  dither_enabled_save = cogl_framebuffer_get_dither_enabled (fb);
-  cogl_framebuffer_set_dither_enabled (fb, FALSE);
+  if (!priv->relayout_pending &&
+      priv->relayout_boundaries == NULL &&
+      priv->constraint_sources == NULL)
+    return;
 
-  /* Render the entire scence in pick mode - just single colored silhouette's
-   * are drawn offscreen (as we never swap buffers)
-  */
-  context->pick_mode = mode;
-  _clutter_stage_do_paint (stage, NULL);
-  context->pick_mode = CLUTTER_PICK_NONE;
+  /* avoid reentrancy */
+  if (CLUTTER_ACTOR_IN_RELAYOUT (stage))
+    return;
 
-  /* Read the color of the screen co-ords pixel. RGBA_8888_PRE is used
-     even though we don't care about the alpha component because under
-     GLES this is the only format that is guaranteed to work so Cogl
-     will end up having to do a conversion if any other format is
-     used. The format is requested as pre-multiplied because Cogl
-     assumes that all pixels in the framebuffer are premultiplied so
-     it avoids a conversion. */
-  cogl_read_pixels (read_x, read_y, 1, 1,
-                    COGL_READ_PIXELS_COLOR_BUFFER,
-                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
-                    pixel);
+  clutter_stage_relayout (stage);
 
-  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS))
+  if (priv->relayout_boundaries != NULL)
     {
-      char *file_name =
-        g_strconcat ("pick-buffer-",
-                     _clutter_actor_get_debug_name (actor),
-                     NULL);
+      CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
+      clutter_stage_relayout_boundaries (stage);
+      CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
 
-      read_pixels_to_file (file_name, 0, 0, stage_width, stage_height);
+      /* allocating the boundaries might have queued a relayout
+       * outside of them
+       */
+      clutter_stage_relayout (stage);
+    }
 
-      g_free (file_name);
+  if (priv->constraint_sources != NULL)
+    {
+      clutter_stage_update_constraints (stage);
+
+      /* the constrained actors might have queued a relayout of their
+       * children
+       */
+      clutter_stage_relayout (stage);
     }
+}
 
-  /* Restore whether GL_DITHER was enabled */
-  cogl_framebuffer_set_dither_enabled (fb, dither_enabled_save);
+static void
+clutter_stage_do_redraw (ClutterStage *stage)
+{
+  ClutterBackend *backend = clutter_get_default_backend ();
+  ClutterActor *actor = CLUTTER_ACTOR (stage);
+  ClutterStagePrivate *priv = stage->priv;
+  gboolean scanout = FALSE;
 
-  if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
-    cogl_framebuffer_pop_clip (fb);
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return;
 
-  _clutter_stage_dirty_viewport (stage);
+  if (priv->impl == NULL)
+    return;
 
-  if (pixel[0] == 0xff && pixel[1] == 0xff && pixel[2] == 0xff)
-    retval = actor;
-  else
-    {
-      guint32 id_ = _clutter_pixel_to_id (pixel);
+  CLUTTER_NOTE (PAINT, "Redraw started for stage '%s'[%p]",
+                _clutter_actor_get_debug_name (actor),
+                stage);
 
-      retval = _clutter_stage_get_actor_by_pick_id (stage, id_);
-    }
+  _clutter_backend_ensure_context (backend, stage);
 
-  return retval;
-}
+  if (_clutter_context_get_show_fps ())
+    {
+      if (priv->fps_timer == NULL)
+        priv->fps_timer = g_timer_new ();
+    }
 
-static gboolean
-clutter_stage_real_delete_event (ClutterStage *stage,
-                                 ClutterEvent *event)
-{
-  if (stage_is_default (stage))
-    clutter_main_quit ();
-  else
-    clutter_actor_destroy (CLUTTER_ACTOR (stage));
+  _clutter_stage_maybe_setup_viewport (stage);
 
-  return CLUTTER_EVENT_STOP;
-}
+  if (_clutter_stage_window_can_scanout (priv->impl))
+    {
+      ClutterActor *candidate = _clutter_actor_get_scanout_candidate (actor);
 
-static void
-clutter_stage_real_apply_transform (ClutterActor *stage,
-                                    CoglMatrix   *matrix)
-{
-  ClutterStagePrivate *priv = CLUTTER_STAGE (stage)->priv;
+      /* the window also has to know when it should stop presenting
+       * the last buffer, so it is called even without a candidate
+       */
+      scanout = _clutter_stage_window_scanout_actor (priv->impl, candidate) &&
+                candidate != NULL;
 
-  /* FIXME: we probably shouldn't be explicitly reseting the matrix
-   * here... */
-  cogl_matrix_init_identity (matrix);
-  cogl_matrix_multiply (matrix, matrix, &priv->view);
-}
+      if (scanout)
+        CLUTTER_NOTE (PAINT, "The buffer of actor '%s' is presented directly",
+                      _clutter_actor_get_debug_name (candidate));
+      else if (priv->in_scanout)
+        {
+          /* the back buffer was not updated while the buffer was
+           * presented directly
+           */
+          _clutter_stage_window_add_redraw_clip (priv->impl, NULL);
+        }
 
-static void
-clutter_stage_constructed (GObject *gobject)
-{
-  ClutterStage *self = CLUTTER_STAGE (gobject);
-  ClutterStageManager *stage_manager;
+      priv->in_scanout = scanout;
+    }
 
-  stage_manager = clutter_stage_manager_get_default ();
+  if (!scanout)
+    {
+      /* the overlay changes on every frame, wherever the damage is,
+       * and the recorded frames contain the whole scene
+       */
+      if (priv->hud != NULL || priv->paint_recorder != NULL)
+        _clutter_stage_window_add_redraw_clip (priv->impl, NULL);
 
-  /* this will take care to sinking the floating reference */
-  _clutter_stage_manager_add_stage (stage_manager, self);
+      _clutter_stage_window_redraw (priv->impl);
+    }
 
-  /* if this stage has been created on a backend that does not
-   * support multiple stages then it becomes the default stage
-   * as well; any other attempt at creating a ClutterStage will
-   * fail.
+  /* the stage windows that do not read back the captures after
+   * painting cannot capture the stage
    */
-  if (!clutter_feature_available (CLUTTER_FEATURE_STAGE_MULTIPLE))
+  if (priv->pending_captures.length != 0)
+    clutter_stage_fail_pending_captures (stage);
+
+  if (_clutter_context_get_show_fps ())
     {
-      if (G_UNLIKELY (clutter_stage_manager_get_default_stage (stage_manager) != NULL))
+      priv->timer_n_frames += 1;
+
+      if (g_timer_elapsed (priv->fps_timer, NULL) >= 1.0)
         {
-          g_error ("Unable to create another stage: the backend of "
-                   "type '%s' does not support multiple stages. Use "
-                   "clutter_stage_manager_get_default_stage() instead "
-                   "to access the stage singleton.",
-                   G_OBJECT_TYPE_NAME (clutter_get_default_backend ()));
-        }
+          g_print ("*** FPS for %s: %i ***\n",
+                   _clutter_actor_get_debug_name (actor),
+                   priv->timer_n_frames);
 
-      _clutter_stage_manager_set_default_stage (stage_manager, self);
+          priv->timer_n_frames = 0;
+          g_timer_start (priv->fps_timer);
+        }
     }
 
-  G_OBJECT_CLASS (clutter_stage_parent_class)->constructed (gobject);
+  CLUTTER_NOTE (PAINT, "Redraw finished for stage '%s'[%p]",
+                _clutter_actor_get_debug_name (actor),
+                stage);
 }
 
-static void
-clutter_stage_set_property (GObject      *object,
-			    guint         prop_id,
-			    const GValue *value,
-			    GParamSpec   *pspec)
+/*< private >
+ * _clutter_stage_frame_info_begin:
+ * @stage: a #ClutterStage
+ * @frame_time: the time of the master clock tick, in microseconds
+ *
+ * Starts collecting the timing information of a new frame, if
+ * clutter_stage_set_collect_frame_info() was called on @stage.
+ *
+ * The frame is discarded if the stage is not painted.
+ */
+void
+_clutter_stage_frame_info_begin (ClutterStage *stage,
+                                 gint64        frame_time)
 {
-  ClutterStage *stage = CLUTTER_STAGE (object);
+  ClutterStagePrivate *priv = stage->priv;
 
-  switch (prop_id)
+  if (!priv->collect_frame_info &&
+      !priv->adaptive_quality &&
+      priv->min_resolution_scale >= 1.f &&
+      priv->hud == NULL)
+    return;
+
+  memset (&priv->frame_current, 0, sizeof (ClutterFrameInfo));
+  priv->frame_current.frame_time = frame_time;
+  priv->in_frame = TRUE;
+
+  /* the counts at the start of the frame, replaced by the work done
+   * during the frame in clutter_stage_frame_info_end()
+   */
+  clutter_actor_get_layout_stats (&priv->frame_current.layout_stats);
+}
+
+/*< private >
+ * _clutter_stage_frame_info_mark:
+ * @stage: a #ClutterStage
+ * @mark: the phase of the frame
+ *
+ * Records the current time for @mark in the frame being collected.
+ */
+void
+_clutter_stage_frame_info_mark (ClutterStage     *stage,
+                                ClutterFrameMark  mark)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterFrameInfo *info = &priv->frame_current;
+  gint64 now;
+
+  if (!priv->in_frame)
+    return;
+
+  now = g_get_monotonic_time ();
+
+  switch (mark)
     {
-    case PROP_COLOR:
-      clutter_actor_set_background_color (CLUTTER_ACTOR (stage),
-                                          clutter_value_get_color (value));
+    case CLUTTER_FRAME_MARK_EVENTS_START:
+      info->events_start = now;
       break;
 
-    case PROP_OFFSCREEN:
-      if (g_value_get_boolean (value))
-        g_warning ("Offscreen stages are currently not supported\n");
+    case CLUTTER_FRAME_MARK_EVENTS_END:
+      info->events_end = now;
       break;
 
-    case PROP_CURSOR_VISIBLE:
-      if (g_value_get_boolean (value))
-        clutter_stage_show_cursor (stage);
-      else
-        clutter_stage_hide_cursor (stage);
+    case CLUTTER_FRAME_MARK_TIMELINES_START:
+      info->timelines_start = now;
       break;
 
-    case PROP_PERSPECTIVE:
-      clutter_stage_set_perspective (stage, g_value_get_boxed (value));
+    case CLUTTER_FRAME_MARK_TIMELINES_END:
+      info->timelines_end = now;
       break;
 
-    case PROP_TITLE:
-      clutter_stage_set_title (stage, g_value_get_string (value));
+    case CLUTTER_FRAME_MARK_LAYOUT_START:
+      info->layout_start = now;
       break;
 
-    case PROP_USER_RESIZABLE:
-      clutter_stage_set_user_resizable (stage, g_value_get_boolean (value));
+    case CLUTTER_FRAME_MARK_LAYOUT_END:
+      info->layout_end = now;
       break;
 
-    case PROP_USE_FOG:
-      clutter_stage_set_use_fog (stage, g_value_get_boolean (value));
+    case CLUTTER_FRAME_MARK_PAINT_START:
+      info->paint_start = now;
       break;
 
-    case PROP_FOG:
-      clutter_stage_set_fog (stage, g_value_get_boxed (value));
+    case CLUTTER_FRAME_MARK_PAINT_END:
+      info->paint_end = now;
       break;
 
-    case PROP_USE_ALPHA:
-      clutter_stage_set_use_alpha (stage, g_value_get_boolean (value));
+    case CLUTTER_FRAME_MARK_SWAP_START:
+      info->swap_start = now;
       break;
 
-    case PROP_KEY_FOCUS:
-      clutter_stage_set_key_focus (stage, g_value_get_object (value));
+    case CLUTTER_FRAME_MARK_SWAP_END:
+      info->swap_end = now;
       break;
+    }
+}
 
-    case PROP_NO_CLEAR_HINT:
-      clutter_stage_set_no_clear_hint (stage, g_value_get_boolean (value));
-      break;
+/*< private >
+ * _clutter_stage_frame_info_add_repaint_funcs:
+ * @stage: a #ClutterStage
+ * @elapsed: the time spent running the repaint functions, in microseconds
+ * @n_deferred: the number of repaint functions deferred to the next frame
+ *
+ * Records the run of the repaint functions in the frame being
+ * collected; the post-paint functions run after the paint of the
+ * frame are recorded if it is still waiting for its presentation.
+ */
+void
+_clutter_stage_frame_info_add_repaint_funcs (ClutterStage *stage,
+                                             gint64        elapsed,
+                                             guint         n_deferred)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterFrameInfo *info;
 
-    case PROP_ACCEPT_FOCUS:
-      clutter_stage_set_accept_focus (stage, g_value_get_boolean (value));
-      break;
+  if (priv->in_frame)
+    info = &priv->frame_current;
+  else if (priv->n_frames_pending > 0)
+    info = &priv->frame_pending[priv->n_frames_pending - 1];
+  else
+    return;
 
-    case PROP_SAMPLES_PER_PIXEL:
-      cogl_framebuffer_set_samples_per_pixel (
-        _clutter_stage_window_get_active_framebuffer (CLUTTER_STAGE_WINDOW (stage->priv->impl)),
-        g_value_get_uint (value));
-      break;
+  info->repaint_funcs_time += elapsed;
+  info->n_deferred_repaint_funcs += n_deferred;
+}
 
-    default:
-      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-      break;
-  }
+static gint64
+clutter_stage_get_frame_budget_internal (ClutterStage *stage)
+{
+  if (stage->priv->frame_budget > 0)
+    return stage->priv->frame_budget;
+
+  return G_USEC_PER_SEC / MAX (clutter_get_default_frame_rate (), 1);
 }
 
 static void
-clutter_stage_get_property (GObject    *gobject,
-			    guint       prop_id,
-			    GValue     *value,
-			    GParamSpec *pspec)
+clutter_stage_set_quality_level (ClutterStage        *stage,
+                                 ClutterQualityLevel  level)
 {
-  ClutterStagePrivate *priv = CLUTTER_STAGE (gobject)->priv;
+  ClutterStagePrivate *priv = stage->priv;
 
-  switch (prop_id)
-    {
-    case PROP_COLOR:
-      {
-        ClutterColor bg_color;
+  if (priv->quality_level == level)
+    return;
 
-        clutter_actor_get_background_color (CLUTTER_ACTOR (gobject),
-                                            &bg_color);
-        clutter_value_set_color (value, &bg_color);
-      }
-      break;
+  CLUTTER_NOTE (SCHEDULER, "Quality of stage '%s' going from %d to %d",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (stage)),
+                priv->quality_level,
+                level);
 
-    case PROP_OFFSCREEN:
-      g_value_set_boolean (value, FALSE);
-      break;
+  priv->quality_level = level;
+  priv->quality_misses = 0;
+  priv->quality_good_frames = 0;
 
-    case PROP_FULLSCREEN_SET:
-      g_value_set_boolean (value, priv->is_fullscreen);
-      break;
+  /* the effects and the contents pick up the new level when painted */
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
 
-    case PROP_CURSOR_VISIBLE:
-      g_value_set_boolean (value, priv->is_cursor_visible);
-      break;
+static void
+clutter_stage_set_resolution_scale (ClutterStage *stage,
+                                    gfloat        scale)
+{
+  ClutterStagePrivate *priv = stage->priv;
 
-    case PROP_PERSPECTIVE:
-      g_value_set_boxed (value, &priv->perspective);
-      break;
+  scale = CLAMP (scale, priv->min_resolution_scale, 1.f);
+  if (priv->resolution_scale == scale)
+    return;
 
-    case PROP_TITLE:
-      g_value_set_string (value, priv->title);
-      break;
+  CLUTTER_NOTE (SCHEDULER, "Resolution of stage '%s' going from %.3f to %.3f",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (stage)),
+                priv->resolution_scale,
+                scale);
 
-    case PROP_USER_RESIZABLE:
-      g_value_set_boolean (value, priv->is_user_resizable);
-      break;
+  priv->resolution_scale = scale;
+  priv->quality_misses = 0;
+  priv->quality_good_frames = 0;
 
-    case PROP_USE_FOG:
-      g_value_set_boolean (value, priv->use_fog);
-      break;
+  /* the whole stage is rendered again at the new scale */
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
 
-    case PROP_FOG:
-      g_value_set_boxed (value, &priv->fog);
-      break;
+/* lowers the resolution, and then the quality, of @stage when its
+ * frames keep going over the budget, and raises them again in the
+ * opposite order once there is enough headroom
+ */
+static void
+clutter_stage_update_quality (ClutterStage           *stage,
+                              const ClutterFrameInfo *info)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gint64 budget = clutter_stage_get_frame_budget_internal (stage);
+  gint64 cost;
+  gboolean missed;
 
-    case PROP_USE_ALPHA:
-      g_value_set_boolean (value, priv->use_alpha);
-      break;
+  /* the time spent by the CPU on the frame */
+  cost = info->paint_end - info->frame_time;
+  missed = cost > budget;
 
-    case PROP_KEY_FOCUS:
-      g_value_set_object (value, priv->key_focused_actor);
-      break;
+  /* the time spent by the GPU only shows in the presentation times,
+   * when the frames are painted back to back
+   */
+  if (info->presentation_time != 0 &&
+      priv->last_presentation_time != 0 &&
+      info->frame_time - priv->last_paint_end < budget)
+    {
+      gint64 interval = info->presentation_time - priv->last_presentation_time;
 
-    case PROP_NO_CLEAR_HINT:
-      {
-        gboolean hint =
-          (priv->stage_hints & CLUTTER_STAGE_NO_CLEAR_ON_PAINT) != 0;
+      missed = missed || interval > budget + budget / 2;
+      cost = MAX (cost, interval - budget);
+    }
 
-        g_value_set_boolean (value, hint);
-      }
-      break;
+  priv->last_presentation_time = info->presentation_time;
+  priv->last_paint_end = info->paint_end;
 
-    case PROP_ACCEPT_FOCUS:
-      g_value_set_boolean (value, priv->accept_focus);
-      break;
+  if (missed)
+    {
+      priv->quality_good_frames = 0;
+      priv->quality_misses += 1;
+
+      if (priv->quality_misses < QUALITY_MISSES_TO_LOWER)
+        return;
+
+      if (priv->resolution_scale > priv->min_resolution_scale)
+        clutter_stage_set_resolution_scale (stage,
+                                            priv->resolution_scale -
+                                            RESOLUTION_SCALE_STEP);
+      else if (priv->adaptive_quality &&
+               priv->quality_level < CLUTTER_QUALITY_MINIMAL)
+        clutter_stage_set_quality_level (stage, priv->quality_level + 1);
+    }
+  else
+    {
+      priv->quality_misses = 0;
 
-    case PROP_SAMPLES_PER_PIXEL:
-      g_value_set_uint (value,
-        cogl_framebuffer_get_samples_per_pixel (
-        _clutter_stage_window_get_active_framebuffer (CLUTTER_STAGE_WINDOW (priv->impl))));
-      break;
+      if (cost * 100 < budget * QUALITY_HEADROOM_PERCENT)
+        priv->quality_good_frames += 1;
+      else
+        priv->quality_good_frames = 0;
 
+      if (priv->quality_good_frames < QUALITY_FRAMES_TO_RAISE)
+        return;
 
-    default:
-      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
-      break;
+      if (priv->quality_level > CLUTTER_QUALITY_FULL)
+        clutter_stage_set_quality_level (stage, priv->quality_level - 1);
+      else if (priv->resolution_scale < 1.f)
+        clutter_stage_set_resolution_scale (stage,
+                                            priv->resolution_scale +
+                                            RESOLUTION_SCALE_STEP);
     }
 }
 
 static void
-clutter_stage_dispose (GObject *object)
+clutter_stage_commit_frame_info (ClutterStage           *stage,
+                                 const ClutterFrameInfo *info)
 {
-  ClutterStage        *stage = CLUTTER_STAGE (object);
   ClutterStagePrivate *priv = stage->priv;
-  ClutterStageManager *stage_manager;
+  ClutterFrameInfo *slot;
 
-  clutter_actor_hide (CLUTTER_ACTOR (object));
+  if (priv->adaptive_quality || priv->min_resolution_scale < 1.f)
+    clutter_stage_update_quality (stage, info);
 
-  _clutter_clear_events_queue_for_stage (stage);
+  if (priv->hud != NULL)
+    _clutter_stage_hud_add_frame (priv->hud, info,
+                                  clutter_stage_get_frame_budget_internal (stage));
 
-  if (priv->impl != NULL)
-    {
-      CLUTTER_NOTE (BACKEND, "Disposing of the stage implementation");
+  if (!priv->collect_frame_info)
+    return;
 
-      if (CLUTTER_ACTOR_IS_REALIZED (object))
-        _clutter_stage_window_unrealize (priv->impl);
+  slot = &priv->frame_history[priv->frame_history_next];
+  *slot = *info;
+  slot->frame_counter = ++priv->frame_counter;
 
-      g_object_unref (priv->impl);
-      priv->impl = NULL;
-    }
+  priv->frame_history_next = (priv->frame_history_next + 1) % FRAME_HISTORY_SIZE;
+  if (priv->frame_history_len < FRAME_HISTORY_SIZE)
+    priv->frame_history_len += 1;
 
-  clutter_actor_destroy_all_children (CLUTTER_ACTOR (object));
+  g_signal_emit (stage, stage_signals[FRAME_INFO], 0, slot);
+}
 
-  g_list_free_full (priv->pending_queue_redraws,
-                    (GDestroyNotify) free_queue_redraw_entry);
-  priv->pending_queue_redraws = NULL;
+static void
+clutter_stage_commit_pending_frame_info (ClutterStage             *stage,
+                                         gint64                    presentation_time,
+                                         gint64                    refresh_interval,
+                                         ClutterPresentationFlags  flags)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterFrameInfo info;
 
-  /* this will release the reference on the stage */
-  stage_manager = clutter_stage_manager_get_default ();
-  _clutter_stage_manager_remove_stage (stage_manager, stage);
+  if (priv->n_frames_pending == 0)
+    return;
 
-  G_OBJECT_CLASS (clutter_stage_parent_class)->dispose (object);
+  info = priv->frame_pending[0];
+  info.presentation_time = presentation_time;
+  info.refresh_interval = refresh_interval;
+  info.presentation_flags = flags;
+
+  priv->n_frames_pending -= 1;
+  memmove (&priv->frame_pending[0], &priv->frame_pending[1],
+           priv->n_frames_pending * sizeof (ClutterFrameInfo));
+
+  clutter_stage_commit_frame_info (stage, &info);
+}
+
+/*< private >
+ * _clutter_stage_frame_info_presented:
+ * @stage: a #ClutterStage
+ * @presentation_time: the time the oldest swapped frame was presented,
+ *   in microseconds, or 0 if unknown
+ *
+ * Completes the oldest frame of @stage that is waiting to be presented.
+ */
+void
+_clutter_stage_frame_info_presented (ClutterStage *stage,
+                                     gint64        presentation_time)
+{
+  _clutter_stage_frame_info_presented_full (stage, presentation_time, 0,
+                                            CLUTTER_PRESENTATION_NONE);
+}
+
+/*< private >
+ * _clutter_stage_frame_info_presented_full:
+ * @stage: a #ClutterStage
+ * @presentation_time: the time the oldest swapped frame was presented,
+ *   in microseconds, or 0 if unknown
+ * @refresh_interval: the refresh interval of the display, in
+ *   microseconds, or 0 if unknown
+ * @flags: how the frame was presented
+ *
+ * Like _clutter_stage_frame_info_presented(), for the stage windows
+ * whose windowing system reports the details of the presentation.
+ */
+void
+_clutter_stage_frame_info_presented_full (ClutterStage             *stage,
+                                          gint64                    presentation_time,
+                                          gint64                    refresh_interval,
+                                          ClutterPresentationFlags  flags)
+{
+  if (presentation_time != 0)
+    _clutter_startup_mark (CLUTTER_STARTUP_MARK_FIRST_PRESENTATION,
+                           presentation_time);
+
+  clutter_stage_commit_pending_frame_info (stage, presentation_time,
+                                           refresh_interval, flags);
 }
 
 static void
-clutter_stage_finalize (GObject *object)
+clutter_stage_frame_info_end (ClutterStage *stage)
 {
-  ClutterStage *stage = CLUTTER_STAGE (object);
   ClutterStagePrivate *priv = stage->priv;
+  ClutterLayoutStats *layout_stats;
+  ClutterLayoutStats now;
 
-  g_queue_foreach (priv->event_queue, (GFunc) clutter_event_free, NULL);
-  g_queue_free (priv->event_queue);
+  if (!priv->in_frame)
+    return;
 
-  g_free (priv->title);
+  priv->in_frame = FALSE;
 
-  g_array_free (priv->paint_volume_stack, TRUE);
+  clutter_actor_get_layout_stats (&now);
 
-  _clutter_id_pool_free (priv->pick_id_pool);
+  layout_stats = &priv->frame_current.layout_stats;
+  layout_stats->n_measures = now.n_measures - layout_stats->n_measures;
+  layout_stats->n_measure_cache_hits = now.n_measure_cache_hits - layout_stats->n_measure_cache_hits;
+  layout_stats->n_allocations = now.n_allocations - layout_stats->n_allocations;
+  layout_stats->n_relayout_roots = now.n_relayout_roots - layout_stats->n_relayout_roots;
 
-  if (priv->fps_timer != NULL)
-    g_timer_destroy (priv->fps_timer);
+  if (priv->frame_current.paint_end == 0)
+    priv->frame_current.paint_end = g_get_monotonic_time ();
 
-  if (priv->paint_notify != NULL)
-    priv->paint_notify (priv->paint_data);
+  /* stage windows that do not report the swap will not report the
+   * presentation either
+   */
+  if (priv->frame_current.swap_start == 0)
+    {
+      clutter_stage_commit_frame_info (stage, &priv->frame_current);
+      return;
+    }
 
-  G_OBJECT_CLASS (clutter_stage_parent_class)->finalize (object);
+  /* do not keep too many frames around if the presentation times
+   * are not delivered
+   */
+  if (priv->n_frames_pending == FRAME_PENDING_SIZE)
+    clutter_stage_commit_pending_frame_info (stage, 0, 0,
+                                             CLUTTER_PRESENTATION_NONE);
+
+  priv->frame_pending[priv->n_frames_pending++] = priv->frame_current;
 }
 
-static void
-clutter_stage_class_init (ClutterStageClass *klass)
+/**
+ * _clutter_stage_do_update:
+ * @stage: A #ClutterStage
+ *
+ * Handles per-frame layout and repaint for the stage.
+ *
+ * Return value: %TRUE if the stage was updated
+ */
+gboolean
+_clutter_stage_do_update (ClutterStage *stage)
 {
-  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
-  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
-  GParamSpec *pspec;
+  ClutterStagePrivate *priv = stage->priv;
 
-  gobject_class->constructed = clutter_stage_constructed;
-  gobject_class->set_property = clutter_stage_set_property;
-  gobject_class->get_property = clutter_stage_get_property;
-  gobject_class->dispose = clutter_stage_dispose;
-  gobject_class->finalize = clutter_stage_finalize;
+  /* if the stage is being destroyed, or if the destruction already
+   * happened and we don't have an StageWindow any more, then we
+   * should bail out
+   */
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage) || priv->impl == NULL)
+    return FALSE;
 
-  actor_class->allocate = clutter_stage_allocate;
-  actor_class->get_preferred_width = clutter_stage_get_preferred_width;
-  actor_class->get_preferred_height = clutter_stage_get_preferred_height;
-  actor_class->paint = clutter_stage_paint;
-  actor_class->pick = clutter_stage_pick;
-  actor_class->get_paint_volume = clutter_stage_get_paint_volume;
-  actor_class->realize = clutter_stage_realize;
-  actor_class->unrealize = clutter_stage_unrealize;
-  actor_class->show = clutter_stage_show;
-  actor_class->show_all = clutter_stage_show_all;
-  actor_class->hide = clutter_stage_hide;
-  actor_class->hide_all = clutter_stage_hide_all;
-  actor_class->queue_relayout = clutter_stage_real_queue_relayout;
-  actor_class->queue_redraw = clutter_stage_real_queue_redraw;
-  actor_class->apply_transform = clutter_stage_real_apply_transform;
+  if (!CLUTTER_ACTOR_IS_REALIZED (stage))
+    return FALSE;
 
-  /**
-   * ClutterStage:fullscreen:
-   *
-   * Whether the stage should be fullscreen or not.
-   *
-   * This property is set by calling clutter_stage_set_fullscreen()
-   * but since the actual implementation is delegated to the backend
-   * you should connect to the notify::fullscreen-set signal in order
-   * to get notification if the fullscreen state has been successfully
-   * achieved.
-   *
-   * Since: 1.0
-   */
-  pspec = g_param_spec_boolean ("fullscreen-set",
-                                P_("Fullscreen Set"),
-                                P_("Whether the main stage is fullscreen"),
-                                FALSE,
-                                CLUTTER_PARAM_READABLE);
-  g_object_class_install_property (gobject_class,
-                                   PROP_FULLSCREEN_SET,
-                                   pspec);
-  /**
-   * ClutterStage:offscreen:
-   *
-   * Whether the stage should be rendered in an offscreen buffer.
-   *
-   * Deprecated: 1.10: This property does not do anything.
+  /* NB: We need to ensure we have an up to date layout *before* we
+   * check or clear the pending redraws flag since a relayout may
+   * queue a redraw.
    */
-  pspec = g_param_spec_boolean ("offscreen",
-                                P_("Offscreen"),
-                                P_("Whether the main stage should be rendered offscreen"),
-                                FALSE,
-                                CLUTTER_PARAM_READWRITE | G_PARAM_DEPRECATED);
-  g_object_class_install_property (gobject_class,
-                                   PROP_OFFSCREEN,
-                                   pspec);
-  /**
-   * ClutterStage:cursor-visible:
-   *
-   * Whether the mouse pointer should be visible
-   */
-  pspec = g_param_spec_boolean ("cursor-visible",
-                                P_("Cursor Visible"),
-                                P_("Whether the mouse pointer is visible on the main stage"),
-                                TRUE,
-                                CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class,
-                                   PROP_CURSOR_VISIBLE,
-                                   pspec);
-  /**
-   * ClutterStage:user-resizable:
-   *
-   * Whether the stage is resizable via user interaction.
-   *
-   * Since: 0.4
+  _clutter_stage_frame_info_mark (stage, CLUTTER_FRAME_MARK_LAYOUT_START);
+  CLUTTER_TRACE_BEGIN (STAGE, "ClutterStage::relayout");
+  clutter_stage_begin_relayout_slice (stage);
+  _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+  priv->relayout_deadline = 0;
+
+  /* sampling the transitions queues the redraws of the actors */
+  clutter_stage_sample_paint_time_transitions (stage);
+  CLUTTER_TRACE_END (STAGE);
+
+  /* the layout is final, so the coalesced notifications can go out */
+  clutter_stage_thaw_notifications (stage);
+  _clutter_stage_frame_info_mark (stage, CLUTTER_FRAME_MARK_LAYOUT_END);
+
+  if (!priv->redraw_pending)
+    {
+      /* nothing reached the screen, so there is nothing to time */
+      priv->in_frame = FALSE;
+      return FALSE;
+    }
+
+  _clutter_stage_frame_info_mark (stage, CLUTTER_FRAME_MARK_PAINT_START);
+
+  CLUTTER_TRACE_BEGIN (STAGE, "ClutterStage::redraw");
+  clutter_stage_maybe_finish_queue_redraws (stage);
+
+  clutter_stage_do_redraw (stage);
+  CLUTTER_TRACE_END (STAGE);
+
+  clutter_stage_release_evicted_raster_cache (stage);
+
+  _clutter_startup_mark (CLUTTER_STARTUP_MARK_FIRST_FRAME, 0);
+
+  /* reset the guard, so that new redraws are possible */
+  priv->redraw_pending = FALSE;
+
+  clutter_stage_advance_resize_transition (stage);
+
+  clutter_stage_frame_info_end (stage);
+
+  clutter_stage_update_visibility (stage);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (priv->redraw_count > 0)
+    {
+      CLUTTER_NOTE (SCHEDULER, "Queued %lu redraws during the last cycle",
+                    priv->redraw_count);
+
+      priv->redraw_count = 0;
+    }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  return TRUE;
+}
+
+static void
+clutter_stage_real_queue_relayout (ClutterActor *self)
+{
+  ClutterStage *stage = CLUTTER_STAGE (self);
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterActorClass *parent_class;
+
+  if (!priv->relayout_pending)
+    {
+      _clutter_stage_schedule_update (stage);
+      priv->relayout_pending = TRUE;
+    }
+
+  _clutter_stage_invalidate_pick_cache (stage);
+
+  /* chain up */
+  parent_class = CLUTTER_ACTOR_CLASS (clutter_stage_parent_class);
+  parent_class->queue_relayout (self);
+}
+
+static void
+clutter_stage_real_queue_redraw (ClutterActor *actor,
+                                 ClutterActor *leaf)
+{
+  ClutterStage *stage = CLUTTER_STAGE (actor);
+  ClutterStageWindow *stage_window;
+  ClutterPaintVolume *redraw_clip;
+  ClutterActorBox bounding_box;
+  ClutterActorBox intersection_box;
+  ClutterBox4 intersection;
+  cairo_rectangle_int_t geom, stage_clip;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (actor))
+    return;
+
+  /* If the backend can't do anything with redraw clips (e.g. it already knows
+   * it needs to redraw everything anyway) then don't spend time transforming
+   * any clip volume into stage coordinates... */
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window == NULL)
+    return;
+
+  if (_clutter_stage_window_ignoring_redraw_clips (stage_window))
+    {
+      _clutter_stage_window_add_redraw_clip (stage_window, NULL);
+      return;
+    }
+
+  /* Convert the clip volume into stage coordinates and then into an
+   * axis aligned stage coordinates bounding box...
    */
-  pspec = g_param_spec_boolean ("user-resizable",
-                                P_("User Resizable"),
-                                P_("Whether the stage is able to be resized via user interaction"),
-                                FALSE,
-                                CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class,
-                                   PROP_USER_RESIZABLE,
-                                   pspec);
-  /**
-   * ClutterStage:color:
-   *
-   * The background color of the main stage.
-   *
-   * Deprecated: 1.10: Use the #ClutterActor:background-color property of
-   *   #ClutterActor instead.
+  redraw_clip = _clutter_actor_get_queue_redraw_clip (leaf);
+  if (redraw_clip == NULL)
+    {
+      _clutter_stage_window_add_redraw_clip (stage_window, NULL);
+      return;
+    }
+
+  if (redraw_clip->is_empty)
+    return;
+
+  _clutter_paint_volume_get_stage_paint_box (redraw_clip,
+                                             stage,
+                                             &bounding_box);
+
+  _clutter_stage_window_get_geometry (stage_window, &geom);
+
+  intersection = _clutter_box4_intersect (_clutter_box4_from_actor_box (&bounding_box),
+                                          _clutter_box4_init (0, 0,
+                                                              geom.width,
+                                                              geom.height));
+
+  /* There is no need to track degenerate/empty redraw clips */
+  if (_clutter_box4_is_empty (intersection))
+    return;
+
+  _clutter_box4_to_actor_box (intersection, &intersection_box);
+
+  /* when converting to integer coordinates make sure we round the edges of the
+   * clip rectangle outwards... */
+  stage_clip.x = intersection_box.x1;
+  stage_clip.y = intersection_box.y1;
+  stage_clip.width = intersection_box.x2 - stage_clip.x;
+  stage_clip.height = intersection_box.y2 - stage_clip.y;
+
+  _clutter_stage_window_add_redraw_clip (stage_window, &stage_clip);
+}
+
+gboolean
+_clutter_stage_has_full_redraw_queued (ClutterStage *stage)
+{
+  ClutterStageWindow *stage_window = _clutter_stage_get_window (stage);
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage) || stage_window == NULL)
+    return FALSE;
+
+  if (stage->priv->redraw_pending &&
+      !_clutter_stage_window_has_redraw_clips (stage_window))
+    return TRUE;
+  else
+    return FALSE;
+}
+
+/**
+ * clutter_stage_get_redraw_clip_bounds:
+ * @stage: A #ClutterStage
+ * @clip: (out caller-allocates): Return location for the clip bounds
+ *
+ * Gets the bounds of the current redraw for @stage in stage pixel
+ * coordinates. E.g., if only a single actor has queued a redraw then
+ * Clutter may redraw the stage with a clip so that it doesn't have to
+ * paint every pixel in the stage. This function would then return the
+ * bounds of that clip. An application can use this information to
+ * avoid some extra work if it knows that some regions of the stage
+ * aren't going to be painted. This should only be called while the
+ * stage is being painted. If there is no current redraw clip then
+ * this function will set @clip to the full extents of the stage.
+ *
+ * Since: 1.8
+ */
+void
+clutter_stage_get_redraw_clip_bounds (ClutterStage          *stage,
+                                      cairo_rectangle_int_t *clip)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (clip != NULL);
+
+  priv = stage->priv;
+
+  if (!_clutter_stage_window_get_redraw_clip_bounds (priv->impl, clip))
+    {
+      /* Set clip to the full extents of the stage */
+      _clutter_stage_window_get_geometry (priv->impl, clip);
+    }
+}
+
+static void
+read_pixels_to_file (CoglFramebuffer *fb,
+                     char            *filename_stem,
+                     int              x,
+                     int              y,
+                     int              width,
+                     int              height)
+{
+  guint8 *data;
+  cairo_surface_t *surface;
+  static int read_count = 0;
+  char *filename = g_strdup_printf ("%s-%05d.png",
+                                    filename_stem,
+                                    read_count);
+
+  data = g_malloc (4 * width * height);
+  cogl_framebuffer_read_pixels (fb, x, y, width, height,
+                                CLUTTER_CAIRO_FORMAT_ARGB32,
+                                data);
+
+  surface = cairo_image_surface_create_for_data (data, CAIRO_FORMAT_RGB24,
+                                                 width, height,
+                                                 width * 4);
+
+  cairo_surface_write_to_png (surface, filename);
+  cairo_surface_destroy (surface);
+
+  g_free (data);
+  g_free (filename);
+
+  read_count++;
+}
+
+static void
+clutter_stage_transform_pick_box (ClutterStage          *stage,
+                                  const ClutterActorBox *box,
+                                  ClutterVertex          vertex[4])
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterVertex box_vertex[4];
+  CoglMatrix modelview;
+
+  box_vertex[0].x = box->x1;
+  box_vertex[0].y = box->y1;
+  box_vertex[0].z = 0.f;
+  box_vertex[1].x = box->x2;
+  box_vertex[1].y = box->y1;
+  box_vertex[1].z = 0.f;
+  box_vertex[2].x = box->x2;
+  box_vertex[2].y = box->y2;
+  box_vertex[2].z = 0.f;
+  box_vertex[3].x = box->x1;
+  box_vertex[3].y = box->y2;
+  box_vertex[3].z = 0.f;
+
+  /* the modelview matrix is the one built up by the paint traversal,
+   * so we don't have to walk the hierarchy again for each actor
    */
-  pspec = clutter_param_spec_color ("color",
-                                    P_("Color"),
-                                    P_("The color of the stage"),
-                                    &default_stage_color,
-                                    CLUTTER_PARAM_READWRITE |
-                                    G_PARAM_DEPRECATED);
-  g_object_class_install_property (gobject_class, PROP_COLOR, pspec);
+  cogl_framebuffer_get_modelview_matrix (priv->active_framebuffer, &modelview);
+
+  _clutter_util_fully_transform_vertices (&modelview,
+                                          &priv->projection,
+                                          priv->viewport,
+                                          box_vertex,
+                                          vertex,
+                                          4);
+}
+
+/* The vertices are in the same order as the corners of the box they
+ * have been projected from, so they form a convex quadrilateral; the
+ * point is inside if it lies on the same side of each edge, regardless
+ * of the winding order introduced by the transformation.
+ */
+static gboolean
+quadrilateral_contains_point (const ClutterVertex *vertex,
+                              float                x,
+                              float                y)
+{
+  int sign = 0;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      const ClutterVertex *a = &vertex[i];
+      const ClutterVertex *b = &vertex[(i + 1) % 4];
+      float cross;
+
+      cross = (b->x - a->x) * (y - a->y) - (b->y - a->y) * (x - a->x);
+      if (cross == 0.f)
+        continue;
+
+      if (sign == 0)
+        sign = cross > 0.f ? 1 : -1;
+      else if ((cross > 0.f ? 1 : -1) != sign)
+        return FALSE;
+    }
+
+  return sign != 0;
+}
+
+static gboolean
+pick_record_contains_point (ClutterStage     *stage,
+                            const PickRecord *rec,
+                            float             x,
+                            float             y)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  int clip_index;
+
+  if (!quadrilateral_contains_point (rec->vertex, x, y))
+    return FALSE;
+
+  clip_index = rec->clip_stack_top;
+  while (clip_index >= 0)
+    {
+      const PickClipRecord *clip =
+        &g_array_index (priv->pick_clip_stack, PickClipRecord, clip_index);
+
+      if (!quadrilateral_contains_point (clip->vertex, x, y))
+        return FALSE;
+
+      clip_index = clip->prev;
+    }
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_stage_in_geometric_pick:
+ * @stage: a #ClutterStage
+ *
+ * Checks whether @stage is currently performing a geometric pick; in
+ * that case actors should log their pick silhouette using
+ * _clutter_stage_log_pick() instead of painting it.
+ *
+ * Return value: %TRUE if a geometric pick is in progress
+ */
+gboolean
+_clutter_stage_in_geometric_pick (ClutterStage *stage)
+{
+  return stage != NULL && stage->priv->in_geometric_pick;
+}
+
+/*< private >
+ * _clutter_stage_log_pick:
+ * @stage: a #ClutterStage
+ * @box: the pick rectangle, in @actor's coordinate space
+ * @actor: the #ClutterActor being picked
+ *
+ * Records the pick rectangle of @actor, using the modelview matrix
+ * of the current paint traversal.
+ */
+void
+_clutter_stage_log_pick (ClutterStage          *stage,
+                         const ClutterActorBox *box,
+                         ClutterActor          *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickRecord rec;
+
+  g_assert (priv->in_geometric_pick);
+
+  /* degenerate boxes would not produce any fragment when painted */
+  if (box->x2 <= box->x1 || box->y2 <= box->y1)
+    return;
+
+  clutter_stage_transform_pick_box (stage, box, rec.vertex);
+  rec.actor = actor;
+  rec.clip_stack_top = priv->pick_clip_stack_top;
+
+  g_array_append_val (priv->pick_stack, rec);
+}
+
+/*< private >
+ * _clutter_stage_push_pick_clip:
+ * @stage: a #ClutterStage
+ * @box: the clip rectangle, in the coordinate space of the actor
+ *   currently being painted
+ *
+ * Pushes a clip rectangle that will be applied to every pick record
+ * logged until the matching _clutter_stage_pop_pick_clip().
+ */
+void
+_clutter_stage_push_pick_clip (ClutterStage          *stage,
+                               const ClutterActorBox *box)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickClipRecord clip;
+
+  g_assert (priv->in_geometric_pick);
+
+  clutter_stage_transform_pick_box (stage, box, clip.vertex);
+  clip.prev = priv->pick_clip_stack_top;
+
+  g_array_append_val (priv->pick_clip_stack, clip);
+  priv->pick_clip_stack_top = priv->pick_clip_stack->len - 1;
+}
+
+void
+_clutter_stage_pop_pick_clip (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  const PickClipRecord *top;
+
+  g_assert (priv->in_geometric_pick);
+  g_assert (priv->pick_clip_stack_top >= 0);
+
+  /* we keep the records around, since the pick records that have been
+   * logged inside the clip still reference them
+   */
+  top = &g_array_index (priv->pick_clip_stack,
+                        PickClipRecord,
+                        priv->pick_clip_stack_top);
+  priv->pick_clip_stack_top = top->prev;
+}
+
+/*< private >
+ * _clutter_stage_request_pick_fallback:
+ * @stage: a #ClutterStage
+ *
+ * Notifies @stage that an actor or an effect cannot describe its pick
+ * silhouette as a rectangle; the current geometric pick will be
+ * discarded, and the color-based pick will be used instead.
+ */
+void
+_clutter_stage_request_pick_fallback (ClutterStage *stage)
+{
+  g_assert (stage->priv->in_geometric_pick);
+
+  stage->priv->pick_needs_fallback = TRUE;
+}
+
+/*< private >
+ * _clutter_stage_needs_pick_fallback:
+ * @stage: a #ClutterStage
+ *
+ * Checks whether the current geometric pick has already been discarded
+ * in favour of the color-based pick.
+ *
+ * Return value: %TRUE if the geometric pick is going to be discarded
+ */
+gboolean
+_clutter_stage_needs_pick_fallback (ClutterStage *stage)
+{
+  return stage->priv->pick_needs_fallback;
+}
+
+/* Runs the paint traversal in pick mode without emitting any geometry;
+ * every actor intersecting @clip logs its transformed pick rectangle.
+ * Returns %FALSE if any actor in the scene requested the color-based
+ * pick.
+ */
+static gboolean
+clutter_stage_log_pick_records (ClutterStage                *stage,
+                                const cairo_rectangle_int_t *clip,
+                                ClutterPickMode              mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  g_array_set_size (priv->pick_stack, 0);
+  g_array_set_size (priv->pick_clip_stack, 0);
+  priv->pick_clip_stack_top = -1;
+  priv->pick_needs_fallback = FALSE;
+
+  /* the clip lets containers with many children skip the ones
+   * that are nowhere near the pick positions
+   */
+  priv->in_geometric_pick = TRUE;
+  context->pick_mode = mode;
+  _clutter_stage_do_paint (stage, clip);
+  context->pick_mode = CLUTTER_PICK_NONE;
+  priv->in_geometric_pick = FALSE;
+
+  if (priv->pick_needs_fallback)
+    {
+      CLUTTER_NOTE (PICK, "Falling back to the color-based pick");
+
+      /* no point in trying again until the scene changes */
+      priv->pick_fallback_generation = priv->scene_generation;
+
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Finds the actor at (@x, @y) by hit testing the records logged by
+ * clutter_stage_log_pick_records() from the top-most down.
+ */
+static ClutterActor *
+clutter_stage_hit_test_pick_records (ClutterStage *stage,
+                                     gint          x,
+                                     gint          y)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  float pick_x, pick_y;
+  int i;
+
+  /* sample the center of the pixel, like the rasterizer would */
+  pick_x = x + 0.5f;
+  pick_y = y + 0.5f;
+
+  for (i = (int) priv->pick_stack->len - 1; i >= 0; i--)
+    {
+      const PickRecord *rec = &g_array_index (priv->pick_stack, PickRecord, i);
+
+      if (pick_record_contains_point (stage, rec, pick_x, pick_y))
+        return rec->actor;
+    }
+
+  return CLUTTER_ACTOR (stage);
+}
+
+/* Performs a pick by logging the pick rectangles of the actors and hit
+ * testing them. Returns %NULL if any actor in the scene requested the
+ * color-based pick.
+ */
+static ClutterActor *
+clutter_stage_do_pick_geometric (ClutterStage    *stage,
+                                 gint             x,
+                                 gint             y,
+                                 ClutterPickMode  mode)
+{
+  cairo_rectangle_int_t clip = { x, y, 1, 1 };
+
+  CLUTTER_NOTE (PICK, "Performing geometric pick at %i,%i", x, y);
+
+  if (!clutter_stage_log_pick_records (stage, &clip, mode))
+    return NULL;
+
+  return clutter_stage_hit_test_pick_records (stage, x, y);
+}
+
+/* Retrieves the offscreen framebuffer used by the color-based pick, or
+ * %NULL if offscreen rendering is not available; the pick is painted
+ * into a small RGBA8 texture, which lets us use 24 bits for the
+ * identifiers even when the onscreen framebuffer is RGB565, and keeps
+ * the pick from touching the contents of the back buffer.
+ */
+static CoglFramebuffer *
+clutter_stage_ensure_pick_framebuffer (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  CoglError *error = NULL;
+
+  if (priv->pick_offscreen != NULL)
+    return COGL_FRAMEBUFFER (priv->pick_offscreen);
+
+  if (priv->pick_offscreen_failed)
+    return NULL;
+
+  /* we only try once */
+  priv->pick_offscreen_failed = TRUE;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_OFFSCREEN))
+    return NULL;
+
+  priv->pick_texture =
+    cogl_texture_new_with_size (PICK_FRAMEBUFFER_SIZE, PICK_FRAMEBUFFER_SIZE,
+                                COGL_TEXTURE_NO_SLICING |
+                                COGL_TEXTURE_NO_AUTO_MIPMAP,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (priv->pick_texture == NULL)
+    return NULL;
+
+  priv->pick_offscreen = cogl_offscreen_new_with_texture (priv->pick_texture);
+  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (priv->pick_offscreen),
+                                  &error))
+    {
+      CLUTTER_NOTE (PICK, "Unable to allocate the pick framebuffer: %s",
+                    error->message);
+      cogl_error_free (error);
+
+      cogl_object_unref (priv->pick_offscreen);
+      priv->pick_offscreen = NULL;
+      cogl_object_unref (priv->pick_texture);
+      priv->pick_texture = NULL;
+
+      return NULL;
+    }
+
+  priv->pick_offscreen_failed = FALSE;
+
+  return COGL_FRAMEBUFFER (priv->pick_offscreen);
+}
+
+/* Returns the side, in stage pixels, of the largest region that can be
+ * picked with a single paint, or 0 if only single pixels can be picked
+ */
+static gint
+clutter_stage_get_pick_region_size (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  int window_scale;
+
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS))
+    return 0;
+
+  if (clutter_stage_ensure_pick_framebuffer (stage) == NULL)
+    return 0;
+
+  window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+
+  return PICK_FRAMEBUFFER_SIZE / MAX (window_scale, 1);
+}
+
+static ClutterActor *
+clutter_stage_get_actor_for_pick_pixel (ClutterStage *stage,
+                                        const guchar *pixel)
+{
+  guint32 id_;
+
+  if (pixel[0] == 0xff && pixel[1] == 0xff && pixel[2] == 0xff)
+    return CLUTTER_ACTOR (stage);
+
+  id_ = _clutter_pixel_to_id (pixel);
+
+  return _clutter_stage_get_actor_by_pick_id (stage, id_);
+}
+
+/* Paints the scene in pick mode and reads back the pick colors of the
+ * @width by @height stage pixels whose top left corner is at @x, @y;
+ * @pixels must hold 4 bytes for each of them. Regions larger than a
+ * single pixel need the offscreen pick framebuffer, and must fit
+ * inside the size returned by clutter_stage_get_pick_region_size().
+ *
+ * The stage must be current, and its viewport set up.
+ */
+static void
+clutter_stage_paint_pick_region (ClutterStage    *stage,
+                                 gint             x,
+                                 gint             y,
+                                 gint             width,
+                                 gint             height,
+                                 ClutterPickMode  mode,
+                                 guchar          *pixels)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (stage);
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterMainContext *context;
+  guchar region[PICK_FRAMEBUFFER_SIZE * PICK_FRAMEBUFFER_SIZE * 4];
+  CoglColor stage_pick_id;
+  gboolean dither_enabled_save;
+  CoglFramebuffer *fb;
+  CoglFramebuffer *pick_fb = NULL;
+  gint dirty_x;
+  gint dirty_y;
+  gint read_x;
+  gint read_y;
+  int window_scale;
+  int i, j;
+
+  context = _clutter_context_get_default ();
+  window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+
+  fb = cogl_get_draw_framebuffer ();
+
+  /* dumping the pick buffers needs the whole scene, so it always uses
+   * the onscreen framebuffer
+   */
+  if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+    pick_fb = clutter_stage_ensure_pick_framebuffer (stage);
+
+  g_assert (pick_fb != NULL || (width == 1 && height == 1));
+
+  if (pick_fb != NULL)
+    {
+      /* the top left pixel of the region ends up at the origin of the
+       * pick framebuffer, which uses the same projection as the stage
+       */
+      cogl_push_framebuffer (pick_fb);
+      priv->pick_framebuffer = pick_fb;
+      fb = pick_fb;
+
+      cogl_framebuffer_set_projection_matrix (fb, &priv->projection);
+      cogl_framebuffer_set_viewport (fb,
+                                     priv->viewport[0] * window_scale - x * window_scale,
+                                     priv->viewport[1] * window_scale - y * window_scale,
+                                     priv->viewport[2] * window_scale,
+                                     priv->viewport[3] * window_scale);
+
+      read_x = 0;
+      read_y = 0;
+    }
+  else
+    {
+      _clutter_stage_window_get_dirty_pixel (priv->impl, &dirty_x, &dirty_y);
+
+      if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+        cogl_framebuffer_push_scissor_clip (fb, dirty_x * window_scale, dirty_y * window_scale, 1, 1);
+
+      cogl_framebuffer_set_viewport (fb,
+                                     priv->viewport[0] * window_scale - x * window_scale + dirty_x * window_scale,
+                                     priv->viewport[1] * window_scale - y * window_scale + dirty_y * window_scale,
+                                     priv->viewport[2] * window_scale,
+                                     priv->viewport[3] * window_scale);
+
+      read_x = dirty_x * window_scale;
+      read_y = dirty_y * window_scale;
+    }
+
+  _clutter_set_pick_color_bits (cogl_framebuffer_get_red_bits (fb),
+                                cogl_framebuffer_get_green_bits (fb),
+                                cogl_framebuffer_get_blue_bits (fb));
+
+  CLUTTER_NOTE (PICK, "Performing pick at %i,%i - %ix%i", x, y, width, height);
+
+  cogl_color_init_from_4ub (&stage_pick_id, 255, 255, 255, 255);
+  cogl_framebuffer_clear (fb,
+                          COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH,
+                          &stage_pick_id);
+
+  /* Disable dithering (if any) when doing the painting in pick mode */
+  dither_enabled_save = cogl_framebuffer_get_dither_enabled (fb);
+  cogl_framebuffer_set_dither_enabled (fb, FALSE);
+
+  /* Render the entire scence in pick mode - just single colored silhouette's
+   * are drawn offscreen (as we never swap buffers)
+  */
+  context->pick_mode = mode;
+  _clutter_stage_do_paint (stage, NULL);
+  context->pick_mode = CLUTTER_PICK_NONE;
+
+  /* Read the color of the screen co-ords pixels. RGBA_8888_PRE is used
+     even though we don't care about the alpha component because under
+     GLES this is the only format that is guaranteed to work so Cogl
+     will end up having to do a conversion if any other format is
+     used. The format is requested as pre-multiplied because Cogl
+     assumes that all pixels in the framebuffer are premultiplied so
+     it avoids a conversion. */
+  if (width == 1 && height == 1)
+    cogl_framebuffer_read_pixels (fb, read_x, read_y, 1, 1,
+                                  COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                  pixels);
+  else
+    {
+      gint fb_width = width * window_scale;
+      gint fb_height = height * window_scale;
+
+      cogl_framebuffer_read_pixels (fb, read_x, read_y, fb_width, fb_height,
+                                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                    region);
+
+      /* each stage pixel covers window_scale framebuffer pixels on
+       * each side; we sample the top left one, like the single pick
+       */
+      for (j = 0; j < height; j++)
+        for (i = 0; i < width; i++)
+          memcpy (pixels + (j * width + i) * 4,
+                  region + ((j * window_scale) * fb_width + i * window_scale) * 4,
+                  4);
+    }
+
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS))
+    {
+      char *file_name =
+        g_strconcat ("pick-buffer-",
+                     _clutter_actor_get_debug_name (actor),
+                     NULL);
+      float stage_width, stage_height;
+
+      clutter_actor_get_size (actor, &stage_width, &stage_height);
+      read_pixels_to_file (fb, file_name, 0, 0, stage_width, stage_height);
+
+      g_free (file_name);
+    }
+
+  /* Restore whether GL_DITHER was enabled */
+  cogl_framebuffer_set_dither_enabled (fb, dither_enabled_save);
+
+  if (pick_fb != NULL)
+    {
+      priv->pick_framebuffer = NULL;
+      cogl_pop_framebuffer ();
+    }
+  else if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+    cogl_framebuffer_pop_clip (fb);
+
+  _clutter_stage_dirty_viewport (stage);
+}
+
+static ClutterActor *
+clutter_stage_do_pick_internal (ClutterStage    *stage,
+                                gint             x,
+                                gint             y,
+                                ClutterPickMode  mode)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (stage);
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterMainContext *context;
+  guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
+  ClutterActor *retval;
+  float stage_width, stage_height;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return actor;
+
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING))
+    return actor;
+
+  if (G_UNLIKELY (priv->impl == NULL))
+    return actor;
+
+  clutter_actor_get_size (CLUTTER_ACTOR (stage), &stage_width, &stage_height);
+  if (x < 0 || x >= stage_width || y < 0 || y >= stage_height)
+    return actor;
+
+  context = _clutter_context_get_default ();
+  clutter_stage_ensure_current (stage);
+
+  _clutter_backend_ensure_context (context->backend, stage);
+
+  /* needed for when a context switch happens */
+  _clutter_stage_maybe_setup_viewport (stage);
+
+  if (priv->geometric_picking &&
+      priv->pick_fallback_generation != priv->scene_generation &&
+      G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+    {
+      retval = clutter_stage_do_pick_geometric (stage, x, y, mode);
+      if (retval != NULL)
+        return retval;
+    }
+
+  clutter_stage_paint_pick_region (stage, x, y, 1, 1, mode, pixel);
+
+  return clutter_stage_get_actor_for_pick_pixel (stage, pixel);
+}
+
+/*< private >
+ * _clutter_stage_invalidate_pick_cache:
+ * @stage: a #ClutterStage
+ *
+ * Discards the results of the previous picks; this function is called
+ * whenever a redraw or a relayout is queued, and whenever the scene
+ * graph or the reactivity of an actor changes.
+ */
+void
+_clutter_stage_invalidate_pick_cache (ClutterStage *stage)
+{
+  stage->priv->scene_generation += 1;
+}
+
+static ClutterActor *
+clutter_stage_lookup_pick_cache (ClutterStage    *stage,
+                                 gint             x,
+                                 gint             y,
+                                 ClutterPickMode  mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  int i;
+
+  for (i = 0; i < PICK_CACHE_SIZE; i++)
+    {
+      const PickCacheEntry *entry = &priv->pick_cache[i];
+
+      if (entry->actor != NULL &&
+          entry->generation == priv->scene_generation &&
+          entry->x == x &&
+          entry->y == y &&
+          entry->mode == mode)
+        {
+#ifdef CLUTTER_ENABLE_DEBUG
+          priv->pick_cache_hits += 1;
+
+          CLUTTER_NOTE (PICK, "Pick cache hit at %i,%i (hits: %lu, misses: %lu)",
+                        x, y,
+                        priv->pick_cache_hits,
+                        priv->pick_cache_misses);
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+          return entry->actor;
+        }
+    }
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  priv->pick_cache_misses += 1;
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  return NULL;
+}
+
+/* the picked actor cannot go away without bumping the generation,
+ * since it has to be removed from the scene graph first
+ */
+static void
+clutter_stage_store_pick_cache (ClutterStage    *stage,
+                                gint             x,
+                                gint             y,
+                                ClutterPickMode  mode,
+                                ClutterActor    *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickCacheEntry *entry;
+
+  entry = &priv->pick_cache[priv->pick_cache_next];
+  entry->generation = priv->scene_generation;
+  entry->x = x;
+  entry->y = y;
+  entry->mode = mode;
+  entry->actor = actor;
+
+  priv->pick_cache_next = (priv->pick_cache_next + 1) % PICK_CACHE_SIZE;
+}
+
+static inline gboolean
+clutter_stage_use_pick_cache (void)
+{
+  return G_LIKELY (!(clutter_pick_debug_flags &
+                     (CLUTTER_DEBUG_DISABLE_PICK_CACHE |
+                      CLUTTER_DEBUG_DUMP_PICK_BUFFERS)));
+}
+
+ClutterActor *
+_clutter_stage_do_pick (ClutterStage   *stage,
+                        gint            x,
+                        gint            y,
+                        ClutterPickMode mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterActor *retval;
+  gboolean use_cache;
+  gint64 pick_start = 0;
+
+  use_cache = clutter_stage_use_pick_cache ();
+
+  if (use_cache)
+    {
+      retval = clutter_stage_lookup_pick_cache (stage, x, y, mode);
+      if (retval != NULL)
+        return retval;
+    }
+
+  if (priv->in_frame)
+    pick_start = g_get_monotonic_time ();
+
+  CLUTTER_TRACE_BEGIN (PICK, "ClutterStage::pick");
+  retval = clutter_stage_do_pick_internal (stage, x, y, mode);
+  CLUTTER_TRACE_END (PICK);
+
+  if (priv->in_frame)
+    priv->frame_current.pick_time += g_get_monotonic_time () - pick_start;
+
+  if (use_cache && retval != NULL)
+    clutter_stage_store_pick_cache (stage, x, y, mode, retval);
+
+  return retval;
+}
+
+/* Picks the positions without an actor that fit inside a region of the
+ * pick framebuffer with a single paint of the scene
+ */
+static void
+clutter_stage_do_pick_batched (ClutterStage       *stage,
+                               const ClutterPoint *positions,
+                               guint               n_positions,
+                               ClutterPickMode     mode,
+                               gboolean            use_cache,
+                               ClutterActor      **actors)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+  guchar pixels[PICK_FRAMEBUFFER_SIZE * PICK_FRAMEBUFFER_SIZE * 4];
+  gboolean in_batch[PICK_CACHE_SIZE];
+  float stage_width, stage_height;
+  gint region_size;
+  guint first, i;
+
+  clutter_actor_get_size (CLUTTER_ACTOR (stage), &stage_width, &stage_height);
+
+  clutter_stage_ensure_current (stage);
+  _clutter_backend_ensure_context (context->backend, stage);
+  _clutter_stage_maybe_setup_viewport (stage);
+
+  region_size = clutter_stage_get_pick_region_size (stage);
+  if (region_size <= 1)
+    return;
+
+  for (first = 0; first < n_positions; first++)
+    {
+      gint x1, y1, x2, y2;
+      guint n_batch = 0;
+
+      if (actors[first] != NULL ||
+          positions[first].x < 0 || positions[first].x >= stage_width ||
+          positions[first].y < 0 || positions[first].y >= stage_height)
+        continue;
+
+      x1 = x2 = positions[first].x;
+      y1 = y2 = positions[first].y;
+
+      /* grow the region around the first missing position with the
+       * following ones, as long as it fits the pick framebuffer
+       */
+      for (i = first; i < n_positions && i - first < PICK_CACHE_SIZE; i++)
+        {
+          gint x = positions[i].x;
+          gint y = positions[i].y;
+
+          in_batch[i - first] = FALSE;
+
+          if (actors[i] != NULL ||
+              x < 0 || x >= stage_width || y < 0 || y >= stage_height)
+            continue;
+
+          if (MAX (x2, x) - MIN (x1, x) >= region_size ||
+              MAX (y2, y) - MIN (y1, y) >= region_size)
+            continue;
+
+          x1 = MIN (x1, x);
+          y1 = MIN (y1, y);
+          x2 = MAX (x2, x);
+          y2 = MAX (y2, y);
+
+          in_batch[i - first] = TRUE;
+          n_batch += 1;
+        }
+
+      /* a lone position goes through the single pick, which can use
+       * the geometric pick
+       */
+      if (n_batch < 2)
+        continue;
+
+      clutter_stage_paint_pick_region (stage, x1, y1,
+                                       x2 - x1 + 1,
+                                       y2 - y1 + 1,
+                                       mode,
+                                       pixels);
+
+      for (i = first; i < n_positions && i - first < PICK_CACHE_SIZE; i++)
+        {
+          gint x = positions[i].x;
+          gint y = positions[i].y;
+          gint offset;
+
+          if (!in_batch[i - first])
+            continue;
+
+          offset = ((y - y1) * (x2 - x1 + 1) + (x - x1)) * 4;
+          actors[i] = clutter_stage_get_actor_for_pick_pixel (stage,
+                                                              pixels + offset);
+
+          if (use_cache && actors[i] != NULL)
+            clutter_stage_store_pick_cache (stage, x, y, mode, actors[i]);
+        }
+    }
+}
+
+/*< private >
+ * _clutter_stage_do_pick_multiple:
+ * @stage: a #ClutterStage
+ * @positions: (array length=n_positions): the positions to pick
+ * @n_positions: the number of positions
+ * @mode: the pick mode
+ * @actors: (array length=n_positions): return location for the actors
+ *
+ * Picks all the @positions at once. If the stage uses the geometric
+ * picking, a single traversal of the scene graph resolves all of them;
+ * otherwise, the positions that are close to each other are resolved
+ * by a single paint into the offscreen pick framebuffer. The results are stored in the pick cache, so that the following
+ * calls to _clutter_stage_do_pick() at the same positions are cheap.
+ */
+void
+_clutter_stage_do_pick_multiple (ClutterStage       *stage,
+                                 const ClutterPoint *positions,
+                                 guint               n_positions,
+                                 ClutterPickMode     mode,
+                                 ClutterActor      **actors)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gboolean use_cache;
+  guint n_missing;
+  gint x1, y1, x2, y2;
+  float stage_width, stage_height;
+  guint i;
+
+  use_cache = clutter_stage_use_pick_cache ();
+
+  clutter_actor_get_size (CLUTTER_ACTOR (stage), &stage_width, &stage_height);
+
+  n_missing = 0;
+  x1 = y1 = G_MAXINT;
+  x2 = y2 = G_MININT;
+
+  for (i = 0; i < n_positions; i++)
+    {
+      gint x = positions[i].x;
+      gint y = positions[i].y;
+
+      actors[i] = use_cache
+                ? clutter_stage_lookup_pick_cache (stage, x, y, mode)
+                : NULL;
+
+      if (actors[i] != NULL)
+        continue;
+
+      /* positions outside of the stage are handled by the single pick */
+      if (x < 0 || x >= stage_width || y < 0 || y >= stage_height)
+        continue;
+
+      n_missing += 1;
+
+      x1 = MIN (x1, x);
+      y1 = MIN (y1, y);
+      x2 = MAX (x2, x + 1);
+      y2 = MAX (y2, y + 1);
+    }
+
+  if (n_missing > 1 &&
+      priv->geometric_picking &&
+      priv->pick_fallback_generation != priv->scene_generation &&
+      priv->impl != NULL &&
+      !CLUTTER_ACTOR_IN_DESTRUCTION (stage) &&
+      G_LIKELY (!(clutter_pick_debug_flags & (CLUTTER_DEBUG_NOP_PICKING |
+                                              CLUTTER_DEBUG_DUMP_PICK_BUFFERS))))
+    {
+      ClutterMainContext *context = _clutter_context_get_default ();
+      cairo_rectangle_int_t clip = { x1, y1, x2 - x1, y2 - y1 };
+
+      CLUTTER_NOTE (PICK, "Performing geometric pick of %u positions "
+                    "inside %i,%i - %ix%i",
+                    n_missing,
+                    clip.x, clip.y,
+                    clip.width, clip.height);
+
+      clutter_stage_ensure_current (stage);
+      _clutter_backend_ensure_context (context->backend, stage);
+      _clutter_stage_maybe_setup_viewport (stage);
+
+      if (clutter_stage_log_pick_records (stage, &clip, mode))
+        {
+          for (i = 0; i < n_positions; i++)
+            {
+              gint x = positions[i].x;
+              gint y = positions[i].y;
+
+              if (actors[i] != NULL ||
+                  x < 0 || x >= stage_width || y < 0 || y >= stage_height)
+                continue;
+
+              actors[i] = clutter_stage_hit_test_pick_records (stage, x, y);
+
+              if (use_cache)
+                clutter_stage_store_pick_cache (stage, x, y, mode, actors[i]);
+            }
+        }
+    }
+
+  /* positions close to each other share a paint of the pick */
+  if (n_missing > 1 &&
+      priv->impl != NULL &&
+      !CLUTTER_ACTOR_IN_DESTRUCTION (stage) &&
+      G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING)))
+    clutter_stage_do_pick_batched (stage, positions, n_positions,
+                                   mode, use_cache,
+                                   actors);
+
+  /* anything left is picked one position at a time */
+  for (i = 0; i < n_positions; i++)
+    {
+      gint x = positions[i].x;
+      gint y = positions[i].y;
+
+      if (actors[i] != NULL)
+        continue;
+
+      actors[i] = clutter_stage_do_pick_internal (stage, x, y, mode);
+
+      if (use_cache && actors[i] != NULL)
+        clutter_stage_store_pick_cache (stage, x, y, mode, actors[i]);
+    }
+}
+
+static gboolean
+clutter_stage_real_delete_event (ClutterStage *stage,
+                                 ClutterEvent *event)
+{
+  if (stage_is_default (stage))
+    clutter_main_quit ();
+  else
+    clutter_actor_destroy (CLUTTER_ACTOR (stage));
+
+  return CLUTTER_EVENT_STOP;
+}
+
+static void
+clutter_stage_real_apply_transform (ClutterActor *stage,
+                                    CoglMatrix   *matrix)
+{
+  ClutterStagePrivate *priv = CLUTTER_STAGE (stage)->priv;
+
+  /* FIXME: we probably shouldn't be explicitly reseting the matrix
+   * here... */
+  cogl_matrix_init_identity (matrix);
+  cogl_matrix_multiply (matrix, matrix, &priv->view);
+}
+
+static void
+clutter_stage_constructed (GObject *gobject)
+{
+  ClutterStage *self = CLUTTER_STAGE (gobject);
+  ClutterStageManager *stage_manager;
+
+  stage_manager = clutter_stage_manager_get_default ();
+
+  /* this will take care to sinking the floating reference */
+  _clutter_stage_manager_add_stage (stage_manager, self);
+
+  /* if this stage has been created on a backend that does not
+   * support multiple stages then it becomes the default stage
+   * as well; any other attempt at creating a ClutterStage will
+   * fail.
+   */
+  if (!clutter_feature_available (CLUTTER_FEATURE_STAGE_MULTIPLE))
+    {
+      if (G_UNLIKELY (clutter_stage_manager_get_default_stage (stage_manager) != NULL))
+        {
+          g_error ("Unable to create another stage: the backend of "
+                   "type '%s' does not support multiple stages. Use "
+                   "clutter_stage_manager_get_default_stage() instead "
+                   "to access the stage singleton.",
+                   G_OBJECT_TYPE_NAME (clutter_get_default_backend ()));
+        }
+
+      _clutter_stage_manager_set_default_stage (stage_manager, self);
+    }
+
+  G_OBJECT_CLASS (clutter_stage_parent_class)->constructed (gobject);
+}
+
+static void
+clutter_stage_set_property (GObject      *object,
+			    guint         prop_id,
+			    const GValue *value,
+			    GParamSpec   *pspec)
+{
+  ClutterStage *stage = CLUTTER_STAGE (object);
+
+  switch (prop_id)
+    {
+    case PROP_COLOR:
+      clutter_actor_set_background_color (CLUTTER_ACTOR (stage),
+                                          clutter_value_get_color (value));
+      break;
+
+    case PROP_OFFSCREEN:
+      if (g_value_get_boolean (value))
+        g_warning ("Offscreen stages are currently not supported\n");
+      break;
+
+    case PROP_CURSOR_VISIBLE:
+      if (g_value_get_boolean (value))
+        clutter_stage_show_cursor (stage);
+      else
+        clutter_stage_hide_cursor (stage);
+      break;
+
+    case PROP_PERSPECTIVE:
+      clutter_stage_set_perspective (stage, g_value_get_boxed (value));
+      break;
+
+    case PROP_TITLE:
+      clutter_stage_set_title (stage, g_value_get_string (value));
+      break;
+
+    case PROP_USER_RESIZABLE:
+      clutter_stage_set_user_resizable (stage, g_value_get_boolean (value));
+      break;
+
+    case PROP_USE_FOG:
+      clutter_stage_set_use_fog (stage, g_value_get_boolean (value));
+      break;
+
+    case PROP_FOG:
+      clutter_stage_set_fog (stage, g_value_get_boxed (value));
+      break;
+
+    case PROP_USE_ALPHA:
+      clutter_stage_set_use_alpha (stage, g_value_get_boolean (value));
+      break;
+
+    case PROP_KEY_FOCUS:
+      clutter_stage_set_key_focus (stage, g_value_get_object (value));
+      break;
+
+    case PROP_NO_CLEAR_HINT:
+      clutter_stage_set_no_clear_hint (stage, g_value_get_boolean (value));
+      break;
+
+    case PROP_ACCEPT_FOCUS:
+      clutter_stage_set_accept_focus (stage, g_value_get_boolean (value));
+      break;
+
+    case PROP_SAMPLES_PER_PIXEL:
+      cogl_framebuffer_set_samples_per_pixel (
+        _clutter_stage_window_get_active_framebuffer (CLUTTER_STAGE_WINDOW (stage->priv->impl)),
+        g_value_get_uint (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+clutter_stage_get_property (GObject    *gobject,
+			    guint       prop_id,
+			    GValue     *value,
+			    GParamSpec *pspec)
+{
+  ClutterStagePrivate *priv = CLUTTER_STAGE (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_COLOR:
+      {
+        ClutterColor bg_color;
+
+        clutter_actor_get_background_color (CLUTTER_ACTOR (gobject),
+                                            &bg_color);
+        clutter_value_set_color (value, &bg_color);
+      }
+      break;
+
+    case PROP_OFFSCREEN:
+      g_value_set_boolean (value, FALSE);
+      break;
+
+    case PROP_FULLSCREEN_SET:
+      g_value_set_boolean (value, priv->is_fullscreen);
+      break;
+
+    case PROP_CURSOR_VISIBLE:
+      g_value_set_boolean (value, priv->is_cursor_visible);
+      break;
+
+    case PROP_PERSPECTIVE:
+      g_value_set_boxed (value, &priv->perspective);
+      break;
+
+    case PROP_TITLE:
+      g_value_set_string (value, priv->title);
+      break;
+
+    case PROP_USER_RESIZABLE:
+      g_value_set_boolean (value, priv->is_user_resizable);
+      break;
+
+    case PROP_USE_FOG:
+      g_value_set_boolean (value, priv->use_fog);
+      break;
+
+    case PROP_FOG:
+      g_value_set_boxed (value, &priv->fog);
+      break;
+
+    case PROP_USE_ALPHA:
+      g_value_set_boolean (value, priv->use_alpha);
+      break;
+
+    case PROP_KEY_FOCUS:
+      g_value_set_object (value, priv->key_focused_actor);
+      break;
+
+    case PROP_NO_CLEAR_HINT:
+      {
+        gboolean hint =
+          (priv->stage_hints & CLUTTER_STAGE_NO_CLEAR_ON_PAINT) != 0;
+
+        g_value_set_boolean (value, hint);
+      }
+      break;
+
+    case PROP_ACCEPT_FOCUS:
+      g_value_set_boolean (value, priv->accept_focus);
+      break;
+
+    case PROP_SAMPLES_PER_PIXEL:
+      g_value_set_uint (value,
+        cogl_framebuffer_get_samples_per_pixel (
+        _clutter_stage_window_get_active_framebuffer (CLUTTER_STAGE_WINDOW (priv->impl))));
+      break;
+
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_stage_dispose (GObject *object)
+{
+  ClutterStage        *stage = CLUTTER_STAGE (object);
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterStageManager *stage_manager;
+
+  clutter_actor_hide (CLUTTER_ACTOR (object));
+
+  _clutter_clear_events_queue_for_stage (stage);
+
+  if (priv->impl != NULL)
+    {
+      CLUTTER_NOTE (BACKEND, "Disposing of the stage implementation");
+
+      if (CLUTTER_ACTOR_IS_REALIZED (object))
+        _clutter_stage_window_unrealize (priv->impl);
+
+      g_object_unref (priv->impl);
+      priv->impl = NULL;
+    }
+
+  clutter_actor_destroy_all_children (CLUTTER_ACTOR (object));
+
+  clear_queue_redraw_entries (stage);
+
+  g_clear_pointer (&priv->paint_time_actors, g_hash_table_unref);
+  g_clear_pointer (&priv->constraint_sources, g_hash_table_unref);
+  g_clear_pointer (&priv->visibility_trackers, g_hash_table_unref);
+
+  clutter_stage_thaw_notifications (stage);
+
+  /* the children are gone, and released their images when unmapped */
+  g_queue_foreach (&priv->raster_cache, (GFunc) g_free, NULL);
+  g_queue_clear (&priv->raster_cache);
+  priv->raster_cache_size = 0;
+  g_clear_pointer (&priv->raster_cache_evicted, g_ptr_array_unref);
+
+  /* the children are gone, so this only resets the queued boundaries */
+  clutter_stage_relayout_boundaries (stage);
+  g_clear_pointer (&priv->deferred_relayouts, g_hash_table_unref);
+  g_clear_pointer (&priv->resize_pipeline, cogl_object_unref);
+
+  /* the targets still borrowed by effects of actors outside of the
+   * stage are freed when they are given back
+   */
+  g_clear_pointer (&priv->offscreen_pool, _clutter_offscreen_pool_destroy);
+
+  g_clear_pointer (&priv->hud, _clutter_stage_hud_free);
+
+  g_clear_pointer (&priv->pick_offscreen, cogl_object_unref);
+  g_clear_pointer (&priv->pick_texture, cogl_object_unref);
+
+  clutter_stage_clear_captures (stage);
+
+  /* this will release the reference on the stage */
+  stage_manager = clutter_stage_manager_get_default ();
+  _clutter_stage_manager_remove_stage (stage_manager, stage);
+
+  G_OBJECT_CLASS (clutter_stage_parent_class)->dispose (object);
+}
+
+static void
+clutter_stage_finalize (GObject *object)
+{
+  ClutterStage *stage = CLUTTER_STAGE (object);
+  ClutterStagePrivate *priv = stage->priv;
+
+  event_queue_clear (&priv->event_queue);
+
+  _clutter_input_predictor_free (priv->input_predictor);
+
+  g_free (priv->title);
+
+  g_ptr_array_unref (priv->paint_volume_stack);
+
+  _clutter_id_pool_free (priv->pick_id_pool);
+
+  g_array_free (priv->pick_stack, TRUE);
+  g_array_free (priv->pick_clip_stack, TRUE);
+
+  g_free (priv->frame_history);
+
+  if (priv->fps_timer != NULL)
+    g_timer_destroy (priv->fps_timer);
+
+  if (priv->paint_notify != NULL)
+    priv->paint_notify (priv->paint_data);
+
+  G_OBJECT_CLASS (clutter_stage_parent_class)->finalize (object);
+}
+
+static void
+clutter_stage_class_init (ClutterStageClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+  GParamSpec *pspec;
+
+  gobject_class->constructed = clutter_stage_constructed;
+  gobject_class->set_property = clutter_stage_set_property;
+  gobject_class->get_property = clutter_stage_get_property;
+  gobject_class->dispose = clutter_stage_dispose;
+  gobject_class->finalize = clutter_stage_finalize;
+
+  actor_class->allocate = clutter_stage_allocate;
+  actor_class->get_preferred_width = clutter_stage_get_preferred_width;
+  actor_class->get_preferred_height = clutter_stage_get_preferred_height;
+  actor_class->paint = clutter_stage_paint;
+  actor_class->pick = clutter_stage_pick;
+  actor_class->get_paint_volume = clutter_stage_get_paint_volume;
+  actor_class->realize = clutter_stage_realize;
+  actor_class->unrealize = clutter_stage_unrealize;
+  actor_class->show = clutter_stage_show;
+  actor_class->show_all = clutter_stage_show_all;
+  actor_class->hide = clutter_stage_hide;
+  actor_class->hide_all = clutter_stage_hide_all;
+  actor_class->queue_relayout = clutter_stage_real_queue_relayout;
+  actor_class->queue_redraw = clutter_stage_real_queue_redraw;
+  actor_class->apply_transform = clutter_stage_real_apply_transform;
+
+  /**
+   * ClutterStage:fullscreen:
+   *
+   * Whether the stage should be fullscreen or not.
+   *
+   * This property is set by calling clutter_stage_set_fullscreen()
+   * but since the actual implementation is delegated to the backend
+   * you should connect to the notify::fullscreen-set signal in order
+   * to get notification if the fullscreen state has been successfully
+   * achieved.
+   *
+   * Since: 1.0
+   */
+  pspec = g_param_spec_boolean ("fullscreen-set",
+                                P_("Fullscreen Set"),
+                                P_("Whether the main stage is fullscreen"),
+                                FALSE,
+                                CLUTTER_PARAM_READABLE);
+  g_object_class_install_property (gobject_class,
+                                   PROP_FULLSCREEN_SET,
+                                   pspec);
+  /**
+   * ClutterStage:offscreen:
+   *
+   * Whether the stage should be rendered in an offscreen buffer.
+   *
+   * Deprecated: 1.10: This property does not do anything.
+   */
+  pspec = g_param_spec_boolean ("offscreen",
+                                P_("Offscreen"),
+                                P_("Whether the main stage should be rendered offscreen"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE | G_PARAM_DEPRECATED);
+  g_object_class_install_property (gobject_class,
+                                   PROP_OFFSCREEN,
+                                   pspec);
+  /**
+   * ClutterStage:cursor-visible:
+   *
+   * Whether the mouse pointer should be visible
+   */
+  pspec = g_param_spec_boolean ("cursor-visible",
+                                P_("Cursor Visible"),
+                                P_("Whether the mouse pointer is visible on the main stage"),
+                                TRUE,
+                                CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class,
+                                   PROP_CURSOR_VISIBLE,
+                                   pspec);
+  /**
+   * ClutterStage:user-resizable:
+   *
+   * Whether the stage is resizable via user interaction.
+   *
+   * Since: 0.4
+   */
+  pspec = g_param_spec_boolean ("user-resizable",
+                                P_("User Resizable"),
+                                P_("Whether the stage is able to be resized via user interaction"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class,
+                                   PROP_USER_RESIZABLE,
+                                   pspec);
+  /**
+   * ClutterStage:color:
+   *
+   * The background color of the main stage.
+   *
+   * Deprecated: 1.10: Use the #ClutterActor:background-color property of
+   *   #ClutterActor instead.
+   */
+  pspec = clutter_param_spec_color ("color",
+                                    P_("Color"),
+                                    P_("The color of the stage"),
+                                    &default_stage_color,
+                                    CLUTTER_PARAM_READWRITE |
+                                    G_PARAM_DEPRECATED);
+  g_object_class_install_property (gobject_class, PROP_COLOR, pspec);
+
+  /**
+   * ClutterStage:perspective:
+   *
+   * The parameters used for the perspective projection from 3D
+   * coordinates to 2D
+   *
+   * Since: 0.8
+   */
+  pspec = g_param_spec_boxed ("perspective",
+                              P_("Perspective"),
+                              P_("Perspective projection parameters"),
+                              CLUTTER_TYPE_PERSPECTIVE,
+                              CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class,
+                                   PROP_PERSPECTIVE,
+                                   pspec);
+
+  /**
+   * ClutterStage:title:
+   *
+   * The stage's title - usually displayed in stage windows title decorations.
+   *
+   * Since: 0.4
+   */
+  pspec = g_param_spec_string ("title",
+                               P_("Title"),
+                               P_("Stage Title"),
+                               NULL,
+                               CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_TITLE, pspec);
+
+  /**
+   * ClutterStage:use-fog:
+   *
+   * Whether the stage should use a linear GL "fog" in creating the
+   * depth-cueing effect, to enhance the perception of depth by fading
+   * actors farther from the viewpoint.
+   *
+   * Since: 0.6
+   *
+   * Deprecated: 1.10: This property does not do anything.
+   */
+  pspec = g_param_spec_boolean ("use-fog",
+                                P_("Use Fog"),
+                                P_("Whether to enable depth cueing"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE | G_PARAM_DEPRECATED);
+  g_object_class_install_property (gobject_class, PROP_USE_FOG, pspec);
+
+  /**
+   * ClutterStage:fog:
+   *
+   * The settings for the GL "fog", used only if #ClutterStage:use-fog
+   * is set to %TRUE
+   *
+   * Since: 1.0
+   *
+   * Deprecated: 1.10: This property does not do anything.
+   */
+  pspec = g_param_spec_boxed ("fog",
+                              P_("Fog"),
+                              P_("Settings for the depth cueing"),
+                              CLUTTER_TYPE_FOG,
+                              CLUTTER_PARAM_READWRITE | G_PARAM_DEPRECATED);
+  g_object_class_install_property (gobject_class, PROP_FOG, pspec);
+
+  /**
+   * ClutterStage:use-alpha:
+   *
+   * Whether the #ClutterStage should honour the alpha component of the
+   * #ClutterStage:color property when painting. If Clutter is run under
+   * a compositing manager this will result in the stage being blended
+   * with the underlying window(s)
+   *
+   * Since: 1.2
+   */
+  pspec = g_param_spec_boolean ("use-alpha",
+                                P_("Use Alpha"),
+                                P_("Whether to honour the alpha component of the stage color"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_USE_ALPHA, pspec);
+
+  /**
+   * ClutterStage:key-focus:
+   *
+   * The #ClutterActor that will receive key events from the underlying
+   * windowing system.
+   *
+   * If %NULL, the #ClutterStage will receive the events.
+   *
+   * Since: 1.2
+   */
+  pspec = g_param_spec_object ("key-focus",
+                               P_("Key Focus"),
+                               P_("The currently key focused actor"),
+                               CLUTTER_TYPE_ACTOR,
+                               CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_KEY_FOCUS, pspec);
+
+  /**
+   * ClutterStage:no-clear-hint:
+   *
+   * Whether or not the #ClutterStage should clear its contents
+   * before each paint cycle.
+   *
+   * See clutter_stage_set_no_clear_hint() for further information.
+   *
+   * Since: 1.4
+   */
+  pspec = g_param_spec_boolean ("no-clear-hint",
+                                P_("No Clear Hint"),
+                                P_("Whether the stage should clear its contents"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_NO_CLEAR_HINT, pspec);
+
+  /**
+   * ClutterStage:samples-per-pixel:
+   *
+   * Set the number of samples per pixel on #ClutterStage.
+   *
+   * Since: 1.12
+   */
+  pspec = g_param_spec_uint ("samples-per-pixel",
+                             P_("Samples per pixel"),
+                             P_("Number of samples per pixel"),
+                             0, G_MAXUINT, 0,
+                             CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_SAMPLES_PER_PIXEL, pspec);
+
+  /**
+   * ClutterStage:accept-focus:
+   *
+   * Whether the #ClutterStage should accept key focus when shown.
+   *
+   * Since: 1.6
+   */
+  pspec = g_param_spec_boolean ("accept-focus",
+                                P_("Accept Focus"),
+                                P_("Whether the stage should accept focus on show"),
+                                TRUE,
+                                CLUTTER_PARAM_READWRITE);
+  g_object_class_install_property (gobject_class, PROP_ACCEPT_FOCUS, pspec);
+
+  /**
+   * ClutterStage::fullscreen:
+   * @stage: the stage which was fullscreened
+   *
+   * The ::fullscreen signal is emitted when the stage is made fullscreen.
+   *
+   * Since: 0.6
+   */
+  stage_signals[FULLSCREEN] =
+    g_signal_new (I_("fullscreen"),
+		  G_TYPE_FROM_CLASS (gobject_class),
+		  G_SIGNAL_RUN_FIRST,
+		  G_STRUCT_OFFSET (ClutterStageClass, fullscreen),
+		  NULL, NULL,
+		  _clutter_marshal_VOID__VOID,
+		  G_TYPE_NONE, 0);
+  /**
+   * ClutterStage::unfullscreen:
+   * @stage: the stage which has left a fullscreen state.
+   *
+   * The ::unfullscreen signal is emitted when the stage leaves a fullscreen
+   * state.
+   *
+   * Since: 0.6
+   */
+  stage_signals[UNFULLSCREEN] =
+    g_signal_new (I_("unfullscreen"),
+		  G_TYPE_FROM_CLASS (gobject_class),
+		  G_SIGNAL_RUN_LAST,
+		  G_STRUCT_OFFSET (ClutterStageClass, unfullscreen),
+		  NULL, NULL,
+		  _clutter_marshal_VOID__VOID,
+		  G_TYPE_NONE, 0);
+  /**
+   * ClutterStage::activate:
+   * @stage: the stage which was activated
+   *
+   * The ::activate signal is emitted when the stage receives key focus
+   * from the underlying window system.
+   *
+   * Since: 0.6
+   */
+  stage_signals[ACTIVATE] =
+    g_signal_new (I_("activate"),
+		  G_TYPE_FROM_CLASS (gobject_class),
+		  G_SIGNAL_RUN_LAST,
+		  G_STRUCT_OFFSET (ClutterStageClass, activate),
+		  NULL, NULL,
+		  _clutter_marshal_VOID__VOID,
+		  G_TYPE_NONE, 0);
+  /**
+   * ClutterStage::deactivate:
+   * @stage: the stage which was deactivated
+   *
+   * The ::deactivate signal is emitted when the stage loses key focus
+   * from the underlying window system.
+   *
+   * Since: 0.6
+   */
+  stage_signals[DEACTIVATE] =
+    g_signal_new (I_("deactivate"),
+		  G_TYPE_FROM_CLASS (gobject_class),
+		  G_SIGNAL_RUN_LAST,
+		  G_STRUCT_OFFSET (ClutterStageClass, deactivate),
+		  NULL, NULL,
+		  _clutter_marshal_VOID__VOID,
+		  G_TYPE_NONE, 0);
+
+  /**
+   * ClutterStage::delete-event:
+   * @stage: the stage that received the event
+   * @event: a #ClutterEvent of type %CLUTTER_DELETE
+   *
+   * The ::delete-event signal is emitted when the user closes a
+   * #ClutterStage window using the window controls.
+   *
+   * Clutter by default will call clutter_main_quit() if @stage is
+   * the default stage, and clutter_actor_destroy() for any other
+   * stage.
+   *
+   * It is possible to override the default behaviour by connecting
+   * a new handler and returning %TRUE there.
+   *
+   * This signal is emitted only on Clutter backends that
+   * embed #ClutterStage in native windows. It is not emitted for
+   * backends that use a static frame buffer.
+   *
+   * Since: 1.2
+   */
+  stage_signals[DELETE_EVENT] =
+    g_signal_new (I_("delete-event"),
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  G_STRUCT_OFFSET (ClutterStageClass, delete_event),
+                  _clutter_boolean_handled_accumulator, NULL,
+                  _clutter_marshal_BOOLEAN__BOXED,
+                  G_TYPE_BOOLEAN, 1,
+                  CLUTTER_TYPE_EVENT | G_SIGNAL_TYPE_STATIC_SCOPE);
+
+  /**
+   * ClutterStage::after-paint:
+   * @stage: the stage that received the event
+   *
+   * The ::after-paint signal is emitted after the stage is painted,
+   * but before the results are displayed on the screen.
+   *
+   * Since: 1.20
+   */
+  stage_signals[AFTER_PAINT] =
+    g_signal_new (I_("after-paint"),
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  0, /* no corresponding vfunc */
+                  NULL, NULL, NULL,
+                  G_TYPE_NONE, 0);
+
+  /**
+   * ClutterStage::frame-info:
+   * @stage: the stage that received the signal
+   * @info: the timing information of the frame
+   *
+   * The ::frame-info signal is emitted when the timing information of
+   * a frame has been collected, after the frame has been presented if
+   * the stage window reports the presentation time.
+   *
+   * The signal is only emitted if clutter_stage_set_collect_frame_info()
+   * has been called. The @info structure is owned by the stage, and
+   * should be copied if needed after the signal emission.
+   *
+   * Since: 1.26
+   */
+  stage_signals[FRAME_INFO] =
+    g_signal_new (I_("frame-info"),
+                  G_TYPE_FROM_CLASS (gobject_class),
+                  G_SIGNAL_RUN_LAST,
+                  0, /* no corresponding vfunc */
+                  NULL, NULL,
+                  _clutter_marshal_VOID__BOXED,
+                  G_TYPE_NONE, 1,
+                  CLUTTER_TYPE_FRAME_INFO | G_SIGNAL_TYPE_STATIC_SCOPE);
+
+  klass->fullscreen = clutter_stage_real_fullscreen;
+  klass->activate = clutter_stage_real_activate;
+  klass->deactivate = clutter_stage_real_deactivate;
+  klass->delete_event = clutter_stage_real_delete_event;
+}
+
+static void
+clutter_stage_notify_min_size (ClutterStage *self)
+{
+  self->priv->min_size_changed = TRUE;
+}
+
+static void
+clutter_stage_init (ClutterStage *self)
+{
+  cairo_rectangle_int_t geom = { 0, };
+  ClutterStagePrivate *priv;
+  ClutterStageWindow *impl;
+  ClutterBackend *backend;
+  int window_scale = 1;
+  GError *error;
+
+  /* a stage is a top-level object */
+  CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IS_TOPLEVEL);
+
+  self->priv = priv = clutter_stage_get_instance_private (self);
+
+  CLUTTER_NOTE (BACKEND, "Creating stage from the default backend");
+  backend = clutter_get_default_backend ();
+
+  error = NULL;
+  impl = _clutter_backend_create_stage (backend, self, &error);
+
+  if (G_LIKELY (impl != NULL))
+    {
+      _clutter_stage_set_window (self, impl);
+      _clutter_stage_window_get_geometry (priv->impl, &geom);
+      window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+    }
+  else
+    {
+      if (error != NULL)
+        {
+          g_critical ("Unable to create a new stage implementation: %s",
+                      error->message);
+          g_error_free (error);
+        }
+      else
+        g_critical ("Unable to create a new stage implementation.");
+    }
+
+  priv->input_predictor = _clutter_input_predictor_new ();
+
+  priv->is_fullscreen = FALSE;
+  priv->is_user_resizable = FALSE;
+  priv->is_cursor_visible = TRUE;
+  priv->use_fog = FALSE;
+  priv->throttle_motion_events = TRUE;
+  priv->min_size_changed = FALSE;
+  priv->sync_delay = -1;
+
+  priv->raster_cache_max_size = RASTER_CACHE_MAX_SIZE;
+  priv->raster_cache_budget = RASTER_CACHE_BUDGET;
+
+  priv->resolution_scale = 1.f;
+  priv->min_resolution_scale = 1.f;
+
+  /* XXX - we need to keep the invariant that calling
+   * clutter_set_motion_event_enabled() before the stage creation
+   * will cause motion event delivery to be disabled on any newly
+   * created stage. this can go away when we break API and remove
+   * deprecated functions.
+   */
+  priv->motion_events_enabled = _clutter_context_get_motion_events_enabled ();
+
+  clutter_actor_set_background_color (CLUTTER_ACTOR (self),
+                                      &default_stage_color);
+
+  priv->perspective.fovy   = 60.0; /* 60 Degrees */
+  priv->perspective.aspect = (float) geom.width / (float) geom.height;
+  priv->perspective.z_near = 0.1;
+  priv->perspective.z_far  = 100.0;
+
+  cogl_matrix_init_identity (&priv->projection);
+  cogl_matrix_perspective (&priv->projection,
+                           priv->perspective.fovy,
+                           priv->perspective.aspect,
+                           priv->perspective.z_near,
+                           priv->perspective.z_far);
+  cogl_matrix_get_inverse (&priv->projection,
+                           &priv->inverse_projection);
+  cogl_matrix_init_identity (&priv->view);
+  cogl_matrix_view_2d_in_perspective (&priv->view,
+                                      priv->perspective.fovy,
+                                      priv->perspective.aspect,
+                                      priv->perspective.z_near,
+                                      50, /* distance to 2d plane */
+                                      geom.width * window_scale,
+                                      geom.height * window_scale);
+
+
+  /* FIXME - remove for 2.0 */
+  priv->fog.z_near = 1.0;
+  priv->fog.z_far  = 2.0;
+
+  priv->relayout_pending = TRUE;
+
+  clutter_actor_set_reactive (CLUTTER_ACTOR (self), TRUE);
+  clutter_stage_set_title (self, g_get_prgname ());
+  clutter_stage_set_key_focus (self, NULL);
+
+  g_signal_connect (self, "notify::min-width",
+                    G_CALLBACK (clutter_stage_notify_min_size), NULL);
+  g_signal_connect (self, "notify::min-height",
+                    G_CALLBACK (clutter_stage_notify_min_size), NULL);
+
+  _clutter_stage_set_viewport (self,
+                               0, 0,
+                               geom.width,
+                               geom.height);
+
+  priv->paint_volume_stack = g_ptr_array_new_with_free_func (g_free);
+
+  priv->pick_id_pool = _clutter_id_pool_new (256);
+
+  priv->pick_stack = g_array_new (FALSE, FALSE, sizeof (PickRecord));
+  priv->pick_clip_stack = g_array_new (FALSE, FALSE, sizeof (PickClipRecord));
+  priv->pick_clip_stack_top = -1;
+
+  /* the entries of the pick cache start from generation 0 */
+  priv->scene_generation = 1;
+
+  if (_clutter_context_get_show_hud ())
+    clutter_stage_set_show_hud (self, TRUE);
+}
+
+/**
+ * clutter_stage_get_default:
+ *
+ * Retrieves a #ClutterStage singleton.
+ *
+ * This function is not as useful as it sounds, and will most likely
+ * by deprecated in the future. Application code should only create
+ * a #ClutterStage instance using clutter_stage_new(), and manage the
+ * lifetime of the stage manually.
+ *
+ * The default stage singleton has a platform-specific behaviour: on
+ * platforms without the %CLUTTER_FEATURE_STAGE_MULTIPLE feature flag
+ * set, the first #ClutterStage instance will also be set to be the
+ * default stage instance, and this function will always return a
+ * pointer to it.
+ *
+ * On platforms with the %CLUTTER_FEATURE_STAGE_MULTIPLE feature flag
+ * set, the default stage will be created by the first call to this
+ * function, and every following call will return the same pointer to
+ * it.
+ *
+ * Return value: (transfer none) (type Clutter.Stage): the main
+ *   #ClutterStage. You should never destroy or unref the returned
+ *   actor.
+ *
+ * Deprecated: 1.10: Use clutter_stage_new() instead.
+ */
+ClutterActor *
+clutter_stage_get_default (void)
+{
+  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
+  ClutterStage *stage;
+
+  stage = clutter_stage_manager_get_default_stage (stage_manager);
+  if (G_UNLIKELY (stage == NULL))
+    {
+      /* This will take care of automatically adding the stage to the
+       * stage manager and setting it as the default. Its floating
+       * reference will be claimed by the stage manager.
+       */
+      stage = g_object_new (CLUTTER_TYPE_STAGE, NULL);
+      _clutter_stage_manager_set_default_stage (stage_manager, stage);
+
+      /* the default stage is realized by default */
+      clutter_actor_realize (CLUTTER_ACTOR (stage));
+    }
+
+  return CLUTTER_ACTOR (stage);
+}
+
+/**
+ * clutter_stage_set_color:
+ * @stage: A #ClutterStage
+ * @color: A #ClutterColor
+ *
+ * Sets the stage color.
+ *
+ * Deprecated: 1.10: Use clutter_actor_set_background_color() instead.
+ */
+void
+clutter_stage_set_color (ClutterStage       *stage,
+			 const ClutterColor *color)
+{
+  clutter_actor_set_background_color (CLUTTER_ACTOR (stage), color);
+
+  g_object_notify (G_OBJECT (stage), "color");
+}
+
+/**
+ * clutter_stage_get_color:
+ * @stage: A #ClutterStage
+ * @color: (out caller-allocates): return location for a #ClutterColor
+ *
+ * Retrieves the stage color.
+ *
+ * Deprecated: 1.10: Use clutter_actor_get_background_color() instead.
+ */
+void
+clutter_stage_get_color (ClutterStage *stage,
+			 ClutterColor *color)
+{
+  clutter_actor_get_background_color (CLUTTER_ACTOR (stage), color);
+}
+
+static void
+clutter_stage_set_perspective_internal (ClutterStage       *stage,
+                                        ClutterPerspective *perspective)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->perspective.fovy == perspective->fovy &&
+      priv->perspective.aspect == perspective->aspect &&
+      priv->perspective.z_near == perspective->z_near &&
+      priv->perspective.z_far == perspective->z_far)
+    return;
+
+  priv->perspective = *perspective;
+
+  cogl_matrix_init_identity (&priv->projection);
+  cogl_matrix_perspective (&priv->projection,
+                           priv->perspective.fovy,
+                           priv->perspective.aspect,
+                           priv->perspective.z_near,
+                           priv->perspective.z_far);
+  cogl_matrix_get_inverse (&priv->projection,
+                           &priv->inverse_projection);
+
+  priv->window_transform_valid = FALSE;
+  priv->dirty_projection = TRUE;
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
+
+/**
+ * clutter_stage_set_perspective:
+ * @stage: A #ClutterStage
+ * @perspective: A #ClutterPerspective
+ *
+ * Sets the stage perspective. Using this function is not recommended
+ * because it will disable Clutter's attempts to generate an
+ * appropriate perspective based on the size of the stage.
+ */
+void
+clutter_stage_set_perspective (ClutterStage       *stage,
+                               ClutterPerspective *perspective)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (perspective != NULL);
+  g_return_if_fail (perspective->z_far - perspective->z_near != 0);
+
+  priv = stage->priv;
+
+  /* If the application ever calls this function then we'll stop
+     automatically updating the perspective when the stage changes
+     size */
+  priv->has_custom_perspective = TRUE;
+
+  clutter_stage_set_perspective_internal (stage, perspective);
+}
+
+/**
+ * clutter_stage_get_perspective:
+ * @stage: A #ClutterStage
+ * @perspective: (out caller-allocates) (allow-none): return location for a
+ *   #ClutterPerspective
+ *
+ * Retrieves the stage perspective.
+ */
+void
+clutter_stage_get_perspective (ClutterStage       *stage,
+                               ClutterPerspective *perspective)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (perspective != NULL);
+
+  *perspective = stage->priv->perspective;
+}
+
+/*
+ * clutter_stage_get_projection_matrix:
+ * @stage: A #ClutterStage
+ * @projection: return location for a #CoglMatrix representing the
+ *              perspective projection applied to actors on the given
+ *              @stage.
+ *
+ * Retrieves the @stage's projection matrix. This is derived from the
+ * current perspective set using clutter_stage_set_perspective().
+ *
+ * Since: 1.6
+ */
+void
+_clutter_stage_get_projection_matrix (ClutterStage *stage,
+                                      CoglMatrix *projection)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (projection != NULL);
+
+  *projection = stage->priv->projection;
+}
+
+/* This simply provides a simple mechanism for us to ensure that
+ * the projection matrix gets re-asserted before painting.
+ *
+ * This is used when switching between multiple stages */
+void
+_clutter_stage_dirty_projection (ClutterStage *stage)
+{
+  stage->priv->dirty_projection = TRUE;
+}
+
+/*
+ * clutter_stage_set_viewport:
+ * @stage: A #ClutterStage
+ * @x: The X postition to render the stage at, in window coordinates
+ * @y: The Y position to render the stage at, in window coordinates
+ * @width: The width to render the stage at, in window coordinates
+ * @height: The height to render the stage at, in window coordinates
+ *
+ * Sets the stage viewport. The viewport defines a final scale and
+ * translation of your rendered stage and actors. This lets you render
+ * your stage into a subregion of the stage window or you could use it to
+ * pan a subregion of the stage if your stage window is smaller then
+ * the stage. (XXX: currently this isn't possible)
+ *
+ * Unlike a scale and translation done using the modelview matrix this
+ * is done after everything has had perspective projection applied, so
+ * for example if you were to pan across a subregion of the stage using
+ * the viewport then you would not see a change in perspective for the
+ * actors on the stage.
+ *
+ * Normally the stage viewport will automatically track the size of the
+ * stage window with no offset so the stage will fill your window. This
+ * behaviour can be changed with the "viewport-mimics-window" property
+ * which will automatically be set to FALSE if you use this API. If
+ * you want to revert to the original behaviour then you should set
+ * this property back to %TRUE using
+ * clutter_stage_set_viewport_mimics_window().
+ * (XXX: If we were to make this API public then we might want to do
+ *  add that property.)
+ *
+ * Note: currently this interface only support integer precision
+ * offsets and sizes for viewports but the interface takes floats because
+ * OpenGL 4.0 has introduced floating point viewports which we might
+ * want to expose via this API eventually.
+ *
+ * Since: 1.6
+ */
+void
+_clutter_stage_set_viewport (ClutterStage *stage,
+                             float         x,
+                             float         y,
+                             float         width,
+                             float         height)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+
+  if (x == priv->viewport[0] &&
+      y == priv->viewport[1] &&
+      width == priv->viewport[2] &&
+      height == priv->viewport[3])
+    return;
+
+  priv->viewport[0] = x;
+  priv->viewport[1] = y;
+  priv->viewport[2] = width;
+  priv->viewport[3] = height;
+
+  priv->window_transform_valid = FALSE;
+  priv->dirty_viewport = TRUE;
+
+  queue_full_redraw (stage);
+}
+
+/* This simply provides a simple mechanism for us to ensure that
+ * the viewport gets re-asserted before next painting.
+ *
+ * This is used when switching between multiple stages */
+void
+_clutter_stage_dirty_viewport (ClutterStage *stage)
+{
+  stage->priv->dirty_viewport = TRUE;
+}
+
+/*
+ * clutter_stage_get_viewport:
+ * @stage: A #ClutterStage
+ * @x: A location for the X position where the stage is rendered,
+ *     in window coordinates.
+ * @y: A location for the Y position where the stage is rendered,
+ *     in window coordinates.
+ * @width: A location for the width the stage is rendered at,
+ *         in window coordinates.
+ * @height: A location for the height the stage is rendered at,
+ *          in window coordinates.
+ *
+ * Returns the viewport offset and size set using
+ * clutter_stage_set_viewport() or if the "viewport-mimics-window" property
+ * is TRUE then @x and @y will be set to 0 and @width and @height will equal
+ * the width if the stage window.
+ *
+ * Since: 1.6
+ */
+void
+_clutter_stage_get_viewport (ClutterStage *stage,
+                             float        *x,
+                             float        *y,
+                             float        *width,
+                             float        *height)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  *x = priv->viewport[0];
+  *y = priv->viewport[1];
+  *width = priv->viewport[2];
+  *height = priv->viewport[3];
+}
+
+/*< private >
+ * _clutter_stage_get_window_transform:
+ * @stage: a #ClutterStage
+ * @matrix: (out): return location for the transformation
+ *
+ * Retrieves the mapping from the z = 0 plane of @stage to window
+ * coordinates, through the view, the projection and the viewport of
+ * @stage; with the default perspective this is just a translation and
+ * a scale, so the 2D actors can be projected without 4x4 matrices.
+ *
+ * Return value: %TRUE if the mapping is an affine transformation
+ */
+gboolean
+_clutter_stage_get_window_transform (ClutterStage   *stage,
+                                     cairo_matrix_t *matrix)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (!priv->window_transform_valid)
+    {
+      CoglMatrix m;
+
+      cogl_matrix_multiply (&m, &priv->projection, &priv->view);
+
+      /* the w coordinate must not depend on the position on the plane */
+      priv->window_transform_is_2d =
+        m.wx == 0.f && m.wy == 0.f && m.ww != 0.f;
+
+      if (priv->window_transform_is_2d)
+        {
+          float half_width = priv->viewport[2] / 2.f;
+          float half_height = priv->viewport[3] / 2.f;
+          float sx = half_width / m.ww;
+          float sy = -half_height / m.ww;
+
+          cairo_matrix_init (&priv->window_transform,
+                             m.xx * sx, m.yx * sy,
+                             m.xy * sx, m.yy * sy,
+                             m.xw * sx + half_width + priv->viewport[0],
+                             m.yw * sy + half_height + priv->viewport[1]);
+        }
+
+      priv->window_transform_valid = TRUE;
+    }
+
+  if (!priv->window_transform_is_2d)
+    return FALSE;
+
+  *matrix = priv->window_transform;
+
+  return TRUE;
+}
+
+/**
+ * clutter_stage_set_fullscreen:
+ * @stage: a #ClutterStage
+ * @fullscreen: %TRUE to to set the stage fullscreen
+ *
+ * Asks to place the stage window in the fullscreen or unfullscreen
+ * states.
+ *
+ ( Note that you shouldn't assume the window is definitely full screen
+ * afterward, because other entities (e.g. the user or window manager)
+ * could unfullscreen it again, and not all window managers honor
+ * requests to fullscreen windows.
+ *
+ * If you want to receive notification of the fullscreen state you
+ * should either use the #ClutterStage::fullscreen and
+ * #ClutterStage::unfullscreen signals, or use the notify signal
+ * for the #ClutterStage:fullscreen-set property
+ *
+ * Since: 1.0
+ */
+void
+clutter_stage_set_fullscreen (ClutterStage *stage,
+                              gboolean      fullscreen)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  if (priv->is_fullscreen != fullscreen)
+    {
+      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
+      ClutterStageWindowIface *iface;
+
+      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
+
+      /* Only set if backend implements.
+       *
+       * Also see clutter_stage_event() for setting priv->is_fullscreen
+       * on state change event.
+       */
+      if (iface->set_fullscreen)
+	iface->set_fullscreen (impl, fullscreen);
+    }
+
+  /* If the backend did fullscreen the stage window then we need to resize
+   * the stage and update its viewport so we queue a relayout.  Note: if the
+   * fullscreen request is handled asynchronously we can't rely on this
+   * queue_relayout to update the viewport, but for example the X backend
+   * will recieve a ConfigureNotify after a successful resize which is how
+   * we ensure the viewport is updated on X.
+   */
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (stage));
+}
+
+/**
+ * clutter_stage_get_fullscreen:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves whether the stage is full screen or not
+ *
+ * Return value: %TRUE if the stage is full screen
+ *
+ * Since: 1.0
+ */
+gboolean
+clutter_stage_get_fullscreen (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->is_fullscreen;
+}
+
+/**
+ * clutter_stage_set_user_resizable:
+ * @stage: a #ClutterStage
+ * @resizable: whether the stage should be user resizable.
+ *
+ * Sets if the stage is resizable by user interaction (e.g. via
+ * window manager controls)
+ *
+ * Since: 0.4
+ */
+void
+clutter_stage_set_user_resizable (ClutterStage *stage,
+                                  gboolean      resizable)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  if (clutter_feature_available (CLUTTER_FEATURE_STAGE_USER_RESIZE)
+      && priv->is_user_resizable != resizable)
+    {
+      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
+      ClutterStageWindowIface *iface;
+
+      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
+      if (iface->set_user_resizable)
+        {
+          priv->is_user_resizable = resizable;
+
+          iface->set_user_resizable (impl, resizable);
+
+          g_object_notify (G_OBJECT (stage), "user-resizable");
+        }
+    }
+}
+
+/**
+ * clutter_stage_get_user_resizable:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_user_resizable().
+ *
+ * Return value: %TRUE if the stage is resizable by the user.
+ *
+ * Since: 0.4
+ */
+gboolean
+clutter_stage_get_user_resizable (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->is_user_resizable;
+}
+
+/**
+ * clutter_stage_show_cursor:
+ * @stage: a #ClutterStage
+ *
+ * Shows the cursor on the stage window
+ */
+void
+clutter_stage_show_cursor (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+  if (!priv->is_cursor_visible)
+    {
+      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
+      ClutterStageWindowIface *iface;
+
+      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
+      if (iface->set_cursor_visible)
+        {
+          priv->is_cursor_visible = TRUE;
+
+          iface->set_cursor_visible (impl, TRUE);
+
+          g_object_notify (G_OBJECT (stage), "cursor-visible");
+        }
+    }
+}
+
+/**
+ * clutter_stage_hide_cursor:
+ * @stage: a #ClutterStage
+ *
+ * Makes the cursor invisible on the stage window
+ *
+ * Since: 0.4
+ */
+void
+clutter_stage_hide_cursor (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv;
 
-  /**
-   * ClutterStage:perspective:
-   *
-   * The parameters used for the perspective projection from 3D
-   * coordinates to 2D
-   *
-   * Since: 0.8
-   */
-  pspec = g_param_spec_boxed ("perspective",
-                              P_("Perspective"),
-                              P_("Perspective projection parameters"),
-                              CLUTTER_TYPE_PERSPECTIVE,
-                              CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class,
-                                   PROP_PERSPECTIVE,
-                                   pspec);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-  /**
-   * ClutterStage:title:
-   *
-   * The stage's title - usually displayed in stage windows title decorations.
-   *
-   * Since: 0.4
+  priv = stage->priv;
+  if (priv->is_cursor_visible)
+    {
+      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
+      ClutterStageWindowIface *iface;
+
+      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
+      if (iface->set_cursor_visible)
+        {
+          priv->is_cursor_visible = FALSE;
+
+          iface->set_cursor_visible (impl, FALSE);
+
+          g_object_notify (G_OBJECT (stage), "cursor-visible");
+        }
+    }
+}
+
+/**
+ * clutter_stage_read_pixels:
+ * @stage: A #ClutterStage
+ * @x: x coordinate of the first pixel that is read from stage
+ * @y: y coordinate of the first pixel that is read from stage
+ * @width: Width dimention of pixels to be read, or -1 for the
+ *   entire stage width
+ * @height: Height dimention of pixels to be read, or -1 for the
+ *   entire stage height
+ *
+ * Makes a screenshot of the stage in RGBA 8bit data, returns a
+ * linear buffer with @width * 4 as rowstride.
+ *
+ * The alpha data contained in the returned buffer is driver-dependent,
+ * and not guaranteed to hold any sensible value.
+ *
+ * Return value: (transfer full) (array): a pointer to newly allocated memory with the buffer
+ *   or %NULL if the read failed. Use g_free() on the returned data
+ *   to release the resources it has allocated.
+ */
+guchar *
+clutter_stage_read_pixels (ClutterStage *stage,
+                           gint          x,
+                           gint          y,
+                           gint          width,
+                           gint          height)
+{
+  ClutterActorBox box;
+  guchar *pixels;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+
+  /* Force a redraw of the stage before reading back pixels */
+  clutter_stage_ensure_current (stage);
+  clutter_actor_paint (CLUTTER_ACTOR (stage));
+
+  clutter_actor_get_allocation_box (CLUTTER_ACTOR (stage), &box);
+
+  if (width < 0)
+    width = ceilf (box.x2 - box.x1);
+
+  if (height < 0)
+    height = ceilf (box.y2 - box.y1);
+
+  pixels = g_malloc (height * width * 4);
+
+  cogl_framebuffer_read_pixels (cogl_get_draw_framebuffer (),
+                                x, y, width, height,
+                                COGL_PIXEL_FORMAT_RGBA_8888,
+                                pixels);
+
+  return pixels;
+}
+
+static void
+clutter_stage_release_capture (ClutterStage *stage,
+                               StageCapture *capture)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (capture->buffer != NULL)
+    {
+      if (g_slist_length (priv->capture_buffers) < CAPTURE_BUFFER_POOL_SIZE)
+        priv->capture_buffers = g_slist_prepend (priv->capture_buffers,
+                                                 capture->buffer);
+      else
+        cogl_object_unref (capture->buffer);
+    }
+
+  if (capture->notify != NULL)
+    capture->notify (capture->user_data);
+
+  g_slice_free (StageCapture, capture);
+}
+
+static CoglPixelBuffer *
+clutter_stage_get_capture_buffer (ClutterStage *stage,
+                                  CoglContext  *context,
+                                  gsize         size)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  CoglPixelBuffer *buffer;
+  GSList *l;
+
+  /* the captures of a stream usually have the same size */
+  for (l = priv->capture_buffers; l != NULL; l = l->next)
+    {
+      buffer = l->data;
+
+      if (cogl_buffer_get_size (COGL_BUFFER (buffer)) >= size)
+        {
+          priv->capture_buffers = g_slist_delete_link (priv->capture_buffers, l);
+          return buffer;
+        }
+    }
+
+  buffer = cogl_pixel_buffer_new (context, size, NULL);
+  if (buffer != NULL)
+    cogl_buffer_set_update_hint (COGL_BUFFER (buffer),
+                                 COGL_BUFFER_UPDATE_HINT_STREAM);
+
+  return buffer;
+}
+
+static void
+clutter_stage_deliver_capture (ClutterStage *stage,
+                               StageCapture *capture)
+{
+  const guint8 *data = NULL;
+  guint8 *scaled;
+  gint width, height;
+  gint stride, d;
+  gint x, y, i, j;
+
+  if (capture->buffer != NULL)
+    data = cogl_buffer_map (COGL_BUFFER (capture->buffer),
+                            COGL_BUFFER_ACCESS_READ,
+                            0);
+
+  if (data == NULL)
+    {
+      capture->func (stage, NULL, 0, 0, 0, capture->user_data);
+      return;
+    }
+
+  d = capture->downscale;
+  stride = capture->width * 4;
+
+  if (d == 1)
+    {
+      capture->func (stage, data,
+                     capture->width,
+                     capture->height,
+                     stride,
+                     capture->user_data);
+      cogl_buffer_unmap (COGL_BUFFER (capture->buffer));
+      return;
+    }
+
+  /* average each block of d × d pixels; the pixels are premultiplied,
+   * so the channels can be averaged independently
    */
-  pspec = g_param_spec_string ("title",
-                               P_("Title"),
-                               P_("Stage Title"),
-                               NULL,
-                               CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class, PROP_TITLE, pspec);
+  width = capture->width / d;
+  height = capture->height / d;
+  scaled = g_malloc (width * height * 4);
 
-  /**
-   * ClutterStage:use-fog:
-   *
-   * Whether the stage should use a linear GL "fog" in creating the
-   * depth-cueing effect, to enhance the perception of depth by fading
-   * actors farther from the viewpoint.
-   *
-   * Since: 0.6
-   *
-   * Deprecated: 1.10: This property does not do anything.
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          guint sum[4] = { 0, };
+          guint8 *out = scaled + (y * width + x) * 4;
+
+          for (j = 0; j < d; j++)
+            {
+              const guint8 *in = data + (y * d + j) * stride + x * d * 4;
+
+              for (i = 0; i < d * 4; i += 4)
+                {
+                  sum[0] += in[i + 0];
+                  sum[1] += in[i + 1];
+                  sum[2] += in[i + 2];
+                  sum[3] += in[i + 3];
+                }
+            }
+
+          for (i = 0; i < 4; i++)
+            out[i] = (sum[i] + (d * d) / 2) / (d * d);
+        }
+    }
+
+  cogl_buffer_unmap (COGL_BUFFER (capture->buffer));
+
+  capture->func (stage, scaled, width, height, width * 4, capture->user_data);
+
+  g_free (scaled);
+}
+
+static void
+clutter_stage_flush_captures (ClutterStage *stage,
+                              gboolean      all)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  StageCapture *capture;
+  GList *l;
+
+  if (!all)
+    {
+      for (l = priv->in_flight_captures.head; l != NULL; l = l->next)
+        {
+          capture = l->data;
+          capture->frames_left -= 1;
+        }
+    }
+
+  /* the captures are kept in the order they were read back, so the
+   * ones that are ready are at the head of the queue
    */
-  pspec = g_param_spec_boolean ("use-fog",
-                                P_("Use Fog"),
-                                P_("Whether to enable depth cueing"),
-                                FALSE,
-                                CLUTTER_PARAM_READWRITE | G_PARAM_DEPRECATED);
-  g_object_class_install_property (gobject_class, PROP_USE_FOG, pspec);
+  while ((capture = g_queue_peek_head (&priv->in_flight_captures)) != NULL)
+    {
+      if (!all && capture->frames_left > 0)
+        break;
 
-  /**
-   * ClutterStage:fog:
-   *
-   * The settings for the GL "fog", used only if #ClutterStage:use-fog
-   * is set to %TRUE
-   *
-   * Since: 1.0
-   *
-   * Deprecated: 1.10: This property does not do anything.
+      g_queue_pop_head (&priv->in_flight_captures);
+
+      clutter_stage_deliver_capture (stage, capture);
+      clutter_stage_release_capture (stage, capture);
+    }
+}
+
+static gboolean
+clutter_stage_capture_timeout (gpointer data)
+{
+  ClutterStage *stage = data;
+
+  stage->priv->capture_flush_id = 0;
+
+  clutter_stage_flush_captures (stage, TRUE);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+clutter_stage_clear_captures (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  StageCapture *capture;
+
+  if (priv->capture_flush_id != 0)
+    {
+      g_source_remove (priv->capture_flush_id);
+      priv->capture_flush_id = 0;
+    }
+
+  while ((capture = g_queue_pop_head (&priv->pending_captures)) != NULL)
+    clutter_stage_release_capture (stage, capture);
+
+  while ((capture = g_queue_pop_head (&priv->in_flight_captures)) != NULL)
+    clutter_stage_release_capture (stage, capture);
+
+  g_slist_free_full (priv->capture_buffers, cogl_object_unref);
+  priv->capture_buffers = NULL;
+}
+
+static void
+clutter_stage_fail_pending_captures (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  StageCapture *capture;
+
+  while ((capture = g_queue_pop_head (&priv->pending_captures)) != NULL)
+    {
+      capture->func (stage, NULL, 0, 0, 0, capture->user_data);
+      clutter_stage_release_capture (stage, capture);
+    }
+}
+
+/*< private >
+ * _clutter_stage_read_captures:
+ * @stage: a #ClutterStage
+ * @framebuffer: the framebuffer the stage was painted on
+ *
+ * Reads back the captures requested since the previous frame into
+ * pixel buffers, and delivers the captures read back
+ * %CAPTURE_MAP_DELAY frames ago.
+ *
+ * This function must be called by the stage window after the stage
+ * is painted, and before the buffers are swapped.
+ */
+void
+_clutter_stage_read_captures (ClutterStage    *stage,
+                              CoglFramebuffer *framebuffer)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  CoglContext *context;
+  StageCapture *capture;
+  gint fb_width, fb_height;
+  gint window_scale;
+
+  if (priv->in_flight_captures.length == 0 &&
+      priv->pending_captures.length == 0)
+    return;
+
+  /* deliver the older captures first, so that the callbacks are
+   * called in the order the captures were requested
    */
-  pspec = g_param_spec_boxed ("fog",
-                              P_("Fog"),
-                              P_("Settings for the depth cueing"),
-                              CLUTTER_TYPE_FOG,
-                              CLUTTER_PARAM_READWRITE | G_PARAM_DEPRECATED);
-  g_object_class_install_property (gobject_class, PROP_FOG, pspec);
+  clutter_stage_flush_captures (stage, FALSE);
+
+  context = cogl_framebuffer_get_context (framebuffer);
+  fb_width = cogl_framebuffer_get_width (framebuffer);
+  fb_height = cogl_framebuffer_get_height (framebuffer);
+  window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+
+  while ((capture = g_queue_pop_head (&priv->pending_captures)) != NULL)
+    {
+      cairo_rectangle_int_t rect;
+      CoglBitmap *bitmap;
+      gboolean res = FALSE;
+
+      if (capture->rect.width < 0)
+        {
+          rect.x = rect.y = 0;
+          rect.width = fb_width;
+          rect.height = fb_height;
+        }
+      else
+        {
+          gint x2 = (capture->rect.x + capture->rect.width) * window_scale;
+          gint y2 = (capture->rect.y + capture->rect.height) * window_scale;
+
+          rect.x = CLAMP (capture->rect.x * window_scale, 0, fb_width);
+          rect.y = CLAMP (capture->rect.y * window_scale, 0, fb_height);
+          rect.width = CLAMP (x2, rect.x, fb_width) - rect.x;
+          rect.height = CLAMP (y2, rect.y, fb_height) - rect.y;
+        }
+
+      capture->width = rect.width;
+      capture->height = rect.height;
+
+      if (rect.width >= (gint) capture->downscale &&
+          rect.height >= (gint) capture->downscale)
+        capture->buffer =
+          clutter_stage_get_capture_buffer (stage, context,
+                                            rect.width * rect.height * 4);
+
+      if (capture->buffer != NULL)
+        {
+          bitmap = cogl_bitmap_new_from_buffer (COGL_BUFFER (capture->buffer),
+                                                COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                                                rect.width,
+                                                rect.height,
+                                                rect.width * 4,
+                                                0);
+
+          res = cogl_framebuffer_read_pixels_into_bitmap (framebuffer,
+                                                          rect.x, rect.y,
+                                                          COGL_READ_PIXELS_COLOR_BUFFER,
+                                                          bitmap);
+          cogl_object_unref (bitmap);
+        }
+
+      if (!res)
+        {
+          CLUTTER_NOTE (PAINT, "Unable to read back a capture of %dx%d pixels",
+                        rect.width, rect.height);
+
+          capture->func (stage, NULL, 0, 0, 0, capture->user_data);
+          clutter_stage_release_capture (stage, capture);
+          continue;
+        }
+
+      capture->frames_left = CAPTURE_MAP_DELAY;
+      g_queue_push_tail (&priv->in_flight_captures, capture);
+    }
 
-  /**
-   * ClutterStage:use-alpha:
-   *
-   * Whether the #ClutterStage should honour the alpha component of the
-   * #ClutterStage:color property when painting. If Clutter is run under
-   * a compositing manager this will result in the stage being blended
-   * with the underlying window(s)
-   *
-   * Since: 1.2
+  /* if the stage stops painting, the captures in flight are delivered
+   * once the timeout expires
    */
-  pspec = g_param_spec_boolean ("use-alpha",
-                                P_("Use Alpha"),
-                                P_("Whether to honour the alpha component of the stage color"),
-                                FALSE,
-                                CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class, PROP_USE_ALPHA, pspec);
+  if (priv->capture_flush_id != 0)
+    g_source_remove (priv->capture_flush_id);
+
+  if (priv->in_flight_captures.length != 0)
+    priv->capture_flush_id =
+      clutter_threads_add_coalesced_timeout (CAPTURE_FLUSH_TIMEOUT,
+                                             CAPTURE_FLUSH_SLACK,
+                                             clutter_stage_capture_timeout,
+                                             stage);
+  else
+    priv->capture_flush_id = 0;
+}
 
-  /**
-   * ClutterStage:key-focus:
-   *
-   * The #ClutterActor that will receive key events from the underlying
-   * windowing system.
-   *
-   * If %NULL, the #ClutterStage will receive the events.
-   *
-   * Since: 1.2
-   */
-  pspec = g_param_spec_object ("key-focus",
-                               P_("Key Focus"),
-                               P_("The currently key focused actor"),
-                               CLUTTER_TYPE_ACTOR,
-                               CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class, PROP_KEY_FOCUS, pspec);
+/**
+ * clutter_stage_capture_async:
+ * @stage: a #ClutterStage
+ * @rect: (nullable): the area of the stage to capture, or %NULL for
+ *   the whole stage
+ * @downscale: the factor to scale the capture down by, or 1
+ * @func: (scope notified): the function called with the captured pixels
+ * @user_data: (closure): data to pass to @func
+ * @notify: (nullable): the function called when @func is not needed
+ *   anymore
+ *
+ * Asynchronously captures the contents of @stage, in premultiplied
+ * RGBA 8bit format.
+ *
+ * Unlike clutter_stage_read_pixels(), this function does not paint
+ * the stage and wait for the pixels: the area is read into a pixel
+ * buffer after the next paint of the stage, and the pixels are only
+ * mapped a couple of frames later, when the GPU is done with the
+ * transfer, so that capturing every frame does not stall the
+ * rendering.
+ *
+ * If @downscale is bigger than 1, each block of @downscale by
+ * @downscale pixels of the capture is averaged into a single pixel.
+ *
+ * If the capture fails, @func is called with %NULL data. The captures
+ * still in progress when @stage is destroyed are discarded, and only
+ * their @notify function is called.
+ *
+ * Since: 1.26
+ */
+void
+clutter_stage_capture_async (ClutterStage                *stage,
+                             const cairo_rectangle_int_t *rect,
+                             guint                        downscale,
+                             ClutterStageCaptureFunc      func,
+                             gpointer                     user_data,
+                             GDestroyNotify               notify)
+{
+  StageCapture *capture;
 
-  /**
-   * ClutterStage:no-clear-hint:
-   *
-   * Whether or not the #ClutterStage should clear its contents
-   * before each paint cycle.
-   *
-   * See clutter_stage_set_no_clear_hint() for further information.
-   *
-   * Since: 1.4
-   */
-  pspec = g_param_spec_boolean ("no-clear-hint",
-                                P_("No Clear Hint"),
-                                P_("Whether the stage should clear its contents"),
-                                FALSE,
-                                CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class, PROP_NO_CLEAR_HINT, pspec);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (func != NULL);
+  g_return_if_fail (downscale > 0);
 
-  /**
-   * ClutterStage:samples-per-pixel:
-   *
-   * Set the number of samples per pixel on #ClutterStage.
-   *
-   * Since: 1.12
-   */
-  pspec = g_param_spec_uint ("samples-per-pixel",
-                             P_("Samples per pixel"),
-                             P_("Number of samples per pixel"),
-                             0, G_MAXUINT, 0,
-                             CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class, PROP_SAMPLES_PER_PIXEL, pspec);
+  capture = g_slice_new0 (StageCapture);
+  capture->downscale = downscale;
+  capture->func = func;
+  capture->user_data = user_data;
+  capture->notify = notify;
 
-  /**
-   * ClutterStage:accept-focus:
-   *
-   * Whether the #ClutterStage should accept key focus when shown.
-   *
-   * Since: 1.6
-   */
-  pspec = g_param_spec_boolean ("accept-focus",
-                                P_("Accept Focus"),
-                                P_("Whether the stage should accept focus on show"),
-                                TRUE,
-                                CLUTTER_PARAM_READWRITE);
-  g_object_class_install_property (gobject_class, PROP_ACCEPT_FOCUS, pspec);
+  if (rect != NULL)
+    capture->rect = *rect;
+  else
+    capture->rect.width = -1;
 
-  /**
-   * ClutterStage::fullscreen:
-   * @stage: the stage which was fullscreened
-   *
-   * The ::fullscreen signal is emitted when the stage is made fullscreen.
-   *
-   * Since: 0.6
-   */
-  stage_signals[FULLSCREEN] =
-    g_signal_new (I_("fullscreen"),
-		  G_TYPE_FROM_CLASS (gobject_class),
-		  G_SIGNAL_RUN_FIRST,
-		  G_STRUCT_OFFSET (ClutterStageClass, fullscreen),
-		  NULL, NULL,
-		  _clutter_marshal_VOID__VOID,
-		  G_TYPE_NONE, 0);
-  /**
-   * ClutterStage::unfullscreen:
-   * @stage: the stage which has left a fullscreen state.
-   *
-   * The ::unfullscreen signal is emitted when the stage leaves a fullscreen
-   * state.
-   *
-   * Since: 0.6
-   */
-  stage_signals[UNFULLSCREEN] =
-    g_signal_new (I_("unfullscreen"),
-		  G_TYPE_FROM_CLASS (gobject_class),
-		  G_SIGNAL_RUN_LAST,
-		  G_STRUCT_OFFSET (ClutterStageClass, unfullscreen),
-		  NULL, NULL,
-		  _clutter_marshal_VOID__VOID,
-		  G_TYPE_NONE, 0);
-  /**
-   * ClutterStage::activate:
-   * @stage: the stage which was activated
-   *
-   * The ::activate signal is emitted when the stage receives key focus
-   * from the underlying window system.
-   *
-   * Since: 0.6
-   */
-  stage_signals[ACTIVATE] =
-    g_signal_new (I_("activate"),
-		  G_TYPE_FROM_CLASS (gobject_class),
-		  G_SIGNAL_RUN_LAST,
-		  G_STRUCT_OFFSET (ClutterStageClass, activate),
-		  NULL, NULL,
-		  _clutter_marshal_VOID__VOID,
-		  G_TYPE_NONE, 0);
-  /**
-   * ClutterStage::deactivate:
-   * @stage: the stage which was deactivated
-   *
-   * The ::deactivate signal is emitted when the stage loses key focus
-   * from the underlying window system.
-   *
-   * Since: 0.6
-   */
-  stage_signals[DEACTIVATE] =
-    g_signal_new (I_("deactivate"),
-		  G_TYPE_FROM_CLASS (gobject_class),
-		  G_SIGNAL_RUN_LAST,
-		  G_STRUCT_OFFSET (ClutterStageClass, deactivate),
-		  NULL, NULL,
-		  _clutter_marshal_VOID__VOID,
-		  G_TYPE_NONE, 0);
+  g_queue_push_tail (&stage->priv->pending_captures, capture);
 
-  /**
-   * ClutterStage::delete-event:
-   * @stage: the stage that received the event
-   * @event: a #ClutterEvent of type %CLUTTER_DELETE
-   *
-   * The ::delete-event signal is emitted when the user closes a
-   * #ClutterStage window using the window controls.
-   *
-   * Clutter by default will call clutter_main_quit() if @stage is
-   * the default stage, and clutter_actor_destroy() for any other
-   * stage.
-   *
-   * It is possible to override the default behaviour by connecting
-   * a new handler and returning %TRUE there.
-   *
-   * This signal is emitted only on Clutter backends that
-   * embed #ClutterStage in native windows. It is not emitted for
-   * backends that use a static frame buffer.
-   *
-   * Since: 1.2
+  /* the back buffer is complete after a paint, so repainting the
+   * captured area is enough to get a new frame
    */
-  stage_signals[DELETE_EVENT] =
-    g_signal_new (I_("delete-event"),
-                  G_TYPE_FROM_CLASS (gobject_class),
-                  G_SIGNAL_RUN_LAST,
-                  G_STRUCT_OFFSET (ClutterStageClass, delete_event),
-                  _clutter_boolean_handled_accumulator, NULL,
-                  _clutter_marshal_BOOLEAN__BOXED,
-                  G_TYPE_BOOLEAN, 1,
-                  CLUTTER_TYPE_EVENT | G_SIGNAL_TYPE_STATIC_SCOPE);
+  if (rect != NULL)
+    clutter_actor_queue_redraw_with_clip (CLUTTER_ACTOR (stage), rect);
+  else
+    clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
 
-  /**
-   * ClutterStage::after-paint:
-   * @stage: the stage that received the event
-   *
-   * The ::after-paint signal is emitted after the stage is painted,
-   * but before the results are displayed on the screen.
-   *
-   * Since: 1.20
-   */
-  stage_signals[AFTER_PAINT] =
-    g_signal_new (I_("after-paint"),
-                  G_TYPE_FROM_CLASS (gobject_class),
-                  G_SIGNAL_RUN_LAST,
-                  0, /* no corresponding vfunc */
-                  NULL, NULL, NULL,
-                  G_TYPE_NONE, 0);
+/**
+ * clutter_stage_get_actor_at_pos:
+ * @stage: a #ClutterStage
+ * @pick_mode: how the scene graph should be painted
+ * @x: X coordinate to check
+ * @y: Y coordinate to check
+ *
+ * Checks the scene at the coordinates @x and @y and returns a pointer
+ * to the #ClutterActor at those coordinates.
+ *
+ * By using @pick_mode it is possible to control which actors will be
+ * painted and thus available.
+ *
+ * Return value: (transfer none): the actor at the specified coordinates,
+ *   if any
+ */
+ClutterActor *
+clutter_stage_get_actor_at_pos (ClutterStage    *stage,
+                                ClutterPickMode  pick_mode,
+                                gint             x,
+                                gint             y)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+
+  return _clutter_stage_do_pick (stage, x, y, pick_mode);
+}
+
+/**
+ * clutter_stage_get_actors_at_positions:
+ * @stage: a #ClutterStage
+ * @pick_mode: how the scene graph should be painted
+ * @positions: (array length=n_positions): the positions to check
+ * @n_positions: the number of positions
+ * @actors: (out caller-allocates) (array length=n_positions) (transfer none):
+ *   return location for the actors at each one of the @positions; the
+ *   array must be large enough to hold @n_positions actors
+ *
+ * Checks the scene at each one of the @positions, and stores a pointer
+ * to the #ClutterActor at that position inside @actors, like
+ * clutter_stage_get_actor_at_pos() does for a single position.
+ *
+ * If geometric picking has been enabled using
+ * clutter_stage_set_geometric_picking(), all the positions are resolved
+ * in a single pass over the scene graph, which is cheaper than checking
+ * each position on its own.
+ *
+ * Since: 1.26
+ */
+void
+clutter_stage_get_actors_at_positions (ClutterStage       *stage,
+                                       ClutterPickMode     pick_mode,
+                                       const ClutterPoint *positions,
+                                       guint               n_positions,
+                                       ClutterActor      **actors)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (n_positions == 0 || positions != NULL);
+  g_return_if_fail (n_positions == 0 || actors != NULL);
+
+  if (n_positions == 0)
+    return;
+
+  _clutter_stage_do_pick_multiple (stage, positions, n_positions,
+                                   pick_mode,
+                                   actors);
+}
+
+/**
+ * clutter_stage_event:
+ * @stage: a #ClutterStage
+ * @event: a #ClutterEvent
+ *
+ * This function is used to emit an event on the main stage.
+ *
+ * You should rarely need to use this function, except for
+ * synthetised events.
+ *
+ * Return value: the return value from the signal emission
+ *
+ * Since: 0.4
+ */
+gboolean
+clutter_stage_event (ClutterStage *stage,
+                     ClutterEvent *event)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+  g_return_val_if_fail (event != NULL, FALSE);
 
-  klass->fullscreen = clutter_stage_real_fullscreen;
-  klass->activate = clutter_stage_real_activate;
-  klass->deactivate = clutter_stage_real_deactivate;
-  klass->delete_event = clutter_stage_real_delete_event;
-}
+  priv = stage->priv;
 
-static void
-clutter_stage_notify_min_size (ClutterStage *self)
-{
-  self->priv->min_size_changed = TRUE;
-}
+  if (event->type == CLUTTER_DELETE)
+    {
+      gboolean retval = FALSE;
 
-static void
-clutter_stage_init (ClutterStage *self)
-{
-  cairo_rectangle_int_t geom = { 0, };
-  ClutterStagePrivate *priv;
-  ClutterStageWindow *impl;
-  ClutterBackend *backend;
-  int window_scale = 1;
-  GError *error;
+      g_signal_emit_by_name (stage, "event", event, &retval);
 
-  /* a stage is a top-level object */
-  CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IS_TOPLEVEL);
+      if (!retval)
+        g_signal_emit_by_name (stage, "delete-event", event, &retval);
 
-  self->priv = priv = clutter_stage_get_instance_private (self);
+      return retval;
+    }
 
-  CLUTTER_NOTE (BACKEND, "Creating stage from the default backend");
-  backend = clutter_get_default_backend ();
+  if (event->type != CLUTTER_STAGE_STATE)
+    return FALSE;
 
-  error = NULL;
-  impl = _clutter_backend_create_stage (backend, self, &error);
+  /* emit raw event */
+  if (clutter_actor_event (CLUTTER_ACTOR (stage), event, FALSE))
+    return TRUE;
 
-  if (G_LIKELY (impl != NULL))
+  if (event->stage_state.changed_mask & CLUTTER_STAGE_STATE_FULLSCREEN)
     {
-      _clutter_stage_set_window (self, impl);
-      _clutter_stage_window_get_geometry (priv->impl, &geom);
-      window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+      if (event->stage_state.new_state & CLUTTER_STAGE_STATE_FULLSCREEN)
+	{
+	  priv->is_fullscreen = TRUE;
+	  g_signal_emit (stage, stage_signals[FULLSCREEN], 0);
+
+          g_object_notify (G_OBJECT (stage), "fullscreen-set");
+	}
+      else
+	{
+	  priv->is_fullscreen = FALSE;
+	  g_signal_emit (stage, stage_signals[UNFULLSCREEN], 0);
+
+          g_object_notify (G_OBJECT (stage), "fullscreen-set");
+	}
     }
-  else
+
+  if (event->stage_state.changed_mask & CLUTTER_STAGE_STATE_ACTIVATED)
     {
-      if (error != NULL)
-        {
-          g_critical ("Unable to create a new stage implementation: %s",
-                      error->message);
-          g_error_free (error);
-        }
+      if (event->stage_state.new_state & CLUTTER_STAGE_STATE_ACTIVATED)
+	g_signal_emit (stage, stage_signals[ACTIVATE], 0);
       else
-        g_critical ("Unable to create a new stage implementation.");
+	g_signal_emit (stage, stage_signals[DEACTIVATE], 0);
     }
 
-  priv->event_queue = g_queue_new ();
+  return TRUE;
+}
 
-  priv->is_fullscreen = FALSE;
-  priv->is_user_resizable = FALSE;
-  priv->is_cursor_visible = TRUE;
-  priv->use_fog = FALSE;
-  priv->throttle_motion_events = TRUE;
-  priv->min_size_changed = FALSE;
-  priv->sync_delay = -1;
+/**
+ * clutter_stage_set_title:
+ * @stage: A #ClutterStage
+ * @title: A utf8 string for the stage windows title.
+ *
+ * Sets the stage title.
+ *
+ * Since: 0.4
+ **/
+void
+clutter_stage_set_title (ClutterStage       *stage,
+			 const gchar        *title)
+{
+  ClutterStagePrivate *priv;
+  ClutterStageWindow *impl;
 
-  /* XXX - we need to keep the invariant that calling
-   * clutter_set_motion_event_enabled() before the stage creation
-   * will cause motion event delivery to be disabled on any newly
-   * created stage. this can go away when we break API and remove
-   * deprecated functions.
-   */
-  priv->motion_events_enabled = _clutter_context_get_motion_events_enabled ();
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-  clutter_actor_set_background_color (CLUTTER_ACTOR (self),
-                                      &default_stage_color);
+  priv = stage->priv;
 
-  priv->perspective.fovy   = 60.0; /* 60 Degrees */
-  priv->perspective.aspect = (float) geom.width / (float) geom.height;
-  priv->perspective.z_near = 0.1;
-  priv->perspective.z_far  = 100.0;
+  g_free (priv->title);
+  priv->title = g_strdup (title);
 
-  cogl_matrix_init_identity (&priv->projection);
-  cogl_matrix_perspective (&priv->projection,
-                           priv->perspective.fovy,
-                           priv->perspective.aspect,
-                           priv->perspective.z_near,
-                           priv->perspective.z_far);
-  cogl_matrix_get_inverse (&priv->projection,
-                           &priv->inverse_projection);
-  cogl_matrix_init_identity (&priv->view);
-  cogl_matrix_view_2d_in_perspective (&priv->view,
-                                      priv->perspective.fovy,
-                                      priv->perspective.aspect,
-                                      priv->perspective.z_near,
-                                      50, /* distance to 2d plane */
-                                      geom.width * window_scale,
-                                      geom.height * window_scale);
+  impl = CLUTTER_STAGE_WINDOW (priv->impl);
+  if (CLUTTER_STAGE_WINDOW_GET_IFACE(impl)->set_title != NULL)
+    CLUTTER_STAGE_WINDOW_GET_IFACE (impl)->set_title (impl, priv->title);
 
+  g_object_notify (G_OBJECT (stage), "title");
+}
 
-  /* FIXME - remove for 2.0 */
-  priv->fog.z_near = 1.0;
-  priv->fog.z_far  = 2.0;
+/**
+ * clutter_stage_get_title:
+ * @stage: A #ClutterStage
+ *
+ * Gets the stage title.
+ *
+ * Return value: pointer to the title string for the stage. The
+ * returned string is owned by the actor and should not
+ * be modified or freed.
+ *
+ * Since: 0.4
+ **/
+const gchar *
+clutter_stage_get_title (ClutterStage       *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
 
-  priv->relayout_pending = TRUE;
+  return stage->priv->title;
+}
 
-  clutter_actor_set_reactive (CLUTTER_ACTOR (self), TRUE);
-  clutter_stage_set_title (self, g_get_prgname ());
-  clutter_stage_set_key_focus (self, NULL);
+static void
+on_key_focus_destroy (ClutterActor *actor,
+                      ClutterStage *stage)
+{
+  /* unset the key focus */
+  clutter_stage_set_key_focus (stage, NULL);
+}
 
-  g_signal_connect (self, "notify::min-width",
-                    G_CALLBACK (clutter_stage_notify_min_size), NULL);
-  g_signal_connect (self, "notify::min-height",
-                    G_CALLBACK (clutter_stage_notify_min_size), NULL);
+/**
+ * clutter_stage_set_key_focus:
+ * @stage: the #ClutterStage
+ * @actor: (allow-none): the actor to set key focus to, or %NULL
+ *
+ * Sets the key focus on @actor. An actor with key focus will receive
+ * all the key events. If @actor is %NULL, the stage will receive
+ * focus.
+ *
+ * Since: 0.6
+ */
+void
+clutter_stage_set_key_focus (ClutterStage *stage,
+			     ClutterActor *actor)
+{
+  ClutterStagePrivate *priv;
 
-  _clutter_stage_set_viewport (self,
-                               0, 0,
-                               geom.width,
-                               geom.height);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (actor == NULL || CLUTTER_IS_ACTOR (actor));
+
+  priv = stage->priv;
+
+  /* normalize the key focus. NULL == stage */
+  if (actor == CLUTTER_ACTOR (stage))
+    actor = NULL;
+
+  /* avoid emitting signals and notifications if we're setting the same
+   * actor as the key focus
+   */
+  if (priv->key_focused_actor == actor)
+    return;
+
+  if (priv->key_focused_actor != NULL)
+    {
+      ClutterActor *old_focused_actor;
+
+      old_focused_actor = priv->key_focused_actor;
+
+      /* set key_focused_actor to NULL before emitting the signal or someone
+       * might hide the previously focused actor in the signal handler and we'd
+       * get re-entrant call and get glib critical from g_object_weak_unref
+       */
+      g_signal_handlers_disconnect_by_func (priv->key_focused_actor,
+                                            G_CALLBACK (on_key_focus_destroy),
+                                            stage);
+      priv->key_focused_actor = NULL;
+
+      g_signal_emit_by_name (old_focused_actor, "key-focus-out");
+    }
+  else
+    g_signal_emit_by_name (stage, "key-focus-out");
+
+  /* Note, if someone changes key focus in focus-out signal handler we'd be
+   * overriding the latter call below moving the focus where it was originally
+   * intended. The order of events would be:
+   *   1st focus-out, 2nd focus-out (on stage), 2nd focus-in, 1st focus-in
+   */
+  if (actor != NULL)
+    {
+      priv->key_focused_actor = actor;
+
+      g_signal_connect (actor,
+                        "destroy", G_CALLBACK (on_key_focus_destroy),
+                        stage);
+      g_signal_emit_by_name (priv->key_focused_actor, "key-focus-in");
+    }
+  else
+    g_signal_emit_by_name (stage, "key-focus-in");
+
+  g_object_notify (G_OBJECT (stage), "key-focus");
+}
+
+/**
+ * clutter_stage_get_key_focus:
+ * @stage: the #ClutterStage
+ *
+ * Retrieves the actor that is currently under key focus.
+ *
+ * Return value: (transfer none): the actor with key focus, or the stage
+ *
+ * Since: 0.6
+ */
+ClutterActor *
+clutter_stage_get_key_focus (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
 
-  priv->paint_volume_stack =
-    g_array_new (FALSE, FALSE, sizeof (ClutterPaintVolume));
+  if (stage->priv->key_focused_actor)
+    return stage->priv->key_focused_actor;
 
-  priv->pick_id_pool = _clutter_id_pool_new (256);
+  return CLUTTER_ACTOR (stage);
 }
 
 /**
- * clutter_stage_get_default:
- *
- * Retrieves a #ClutterStage singleton.
- *
- * This function is not as useful as it sounds, and will most likely
- * by deprecated in the future. Application code should only create
- * a #ClutterStage instance using clutter_stage_new(), and manage the
- * lifetime of the stage manually.
+ * clutter_stage_get_use_fog:
+ * @stage: the #ClutterStage
  *
- * The default stage singleton has a platform-specific behaviour: on
- * platforms without the %CLUTTER_FEATURE_STAGE_MULTIPLE feature flag
- * set, the first #ClutterStage instance will also be set to be the
- * default stage instance, and this function will always return a
- * pointer to it.
+ * Gets whether the depth cueing effect is enabled on @stage.
  *
- * On platforms with the %CLUTTER_FEATURE_STAGE_MULTIPLE feature flag
- * set, the default stage will be created by the first call to this
- * function, and every following call will return the same pointer to
- * it.
+ * Return value: %TRUE if the depth cueing effect is enabled
  *
- * Return value: (transfer none) (type Clutter.Stage): the main
- *   #ClutterStage. You should never destroy or unref the returned
- *   actor.
+ * Since: 0.6
  *
- * Deprecated: 1.10: Use clutter_stage_new() instead.
+ * Deprecated: 1.10: This function will always return %FALSE
  */
-ClutterActor *
-clutter_stage_get_default (void)
+gboolean
+clutter_stage_get_use_fog (ClutterStage *stage)
 {
-  ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
-  ClutterStage *stage;
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  stage = clutter_stage_manager_get_default_stage (stage_manager);
-  if (G_UNLIKELY (stage == NULL))
-    {
-      /* This will take care of automatically adding the stage to the
-       * stage manager and setting it as the default. Its floating
-       * reference will be claimed by the stage manager.
-       */
-      stage = g_object_new (CLUTTER_TYPE_STAGE, NULL);
-      _clutter_stage_manager_set_default_stage (stage_manager, stage);
+  return stage->priv->use_fog;
+}
 
-      /* the default stage is realized by default */
-      clutter_actor_realize (CLUTTER_ACTOR (stage));
-    }
+/**
+ * clutter_stage_set_use_fog:
+ * @stage: the #ClutterStage
+ * @fog: %TRUE for enabling the depth cueing effect
+ *
+ * Sets whether the depth cueing effect on the stage should be enabled
+ * or not.
+ *
+ * Depth cueing is a 3D effect that makes actors farther away from the
+ * viewing point less opaque, by fading them with the stage color.
 
-  return CLUTTER_ACTOR (stage);
+ * The parameters of the GL fog used can be changed using the
+ * clutter_stage_set_fog() function.
+ *
+ * Since: 0.6
+ *
+ * Deprecated: 1.10: Calling this function produces no visible effect
+ */
+void
+clutter_stage_set_use_fog (ClutterStage *stage,
+                           gboolean      fog)
+{
 }
 
 /**
- * clutter_stage_set_color:
- * @stage: A #ClutterStage
- * @color: A #ClutterColor
+ * clutter_stage_set_fog:
+ * @stage: the #ClutterStage
+ * @fog: a #ClutterFog structure
  *
- * Sets the stage color.
+ * Sets the fog (also known as "depth cueing") settings for the @stage.
  *
- * Deprecated: 1.10: Use clutter_actor_set_background_color() instead.
+ * A #ClutterStage will only use a linear fog progression, which
+ * depends solely on the distance from the viewer. The cogl_set_fog()
+ * function in COGL exposes more of the underlying implementation,
+ * and allows changing the for progression function. It can be directly
+ * used by disabling the #ClutterStage:use-fog property and connecting
+ * a signal handler to the #ClutterActor::paint signal on the @stage,
+ * like:
+ *
+ * |[
+ *   clutter_stage_set_use_fog (stage, FALSE);
+ *   g_signal_connect (stage, "paint", G_CALLBACK (on_stage_paint), NULL);
+ * ]|
+ *
+ * The paint signal handler will call cogl_set_fog() with the
+ * desired settings:
+ *
+ * |[
+ *   static void
+ *   on_stage_paint (ClutterActor *actor)
+ *   {
+ *     ClutterColor stage_color = { 0, };
+ *     CoglColor fog_color = { 0, };
+ *
+ *     // set the fog color to the stage background color
+ *     clutter_stage_get_color (CLUTTER_STAGE (actor), &stage_color);
+ *     cogl_color_init_from_4ub (&fog_color,
+ *                               stage_color.red,
+ *                               stage_color.green,
+ *                               stage_color.blue,
+ *                               stage_color.alpha);
+ *
+ *     // enable fog //
+ *     cogl_set_fog (&fog_color,
+ *                   COGL_FOG_MODE_EXPONENTIAL, // mode
+ *                   0.5,                       // density
+ *                   5.0, 30.0);                // z_near and z_far
+ *   }
+ * ]|
+ *
+ * The fogging functions only work correctly when the visible actors use
+ * unmultiplied alpha colors. By default Cogl will premultiply textures and
+ * cogl_set_source_color() will premultiply colors, so unless you explicitly
+ * load your textures requesting an unmultiplied internal format and use
+ * cogl_material_set_color() you can only use fogging with fully opaque actors.
+ * Support for premultiplied colors will improve in the future when we can
+ * depend on fragment shaders.
+ *
+ * Since: 0.6
+ *
+ * Deprecated: 1.10: Fog settings are ignored.
  */
 void
-clutter_stage_set_color (ClutterStage       *stage,
-			 const ClutterColor *color)
+clutter_stage_set_fog (ClutterStage *stage,
+                       ClutterFog   *fog)
 {
-  clutter_actor_set_background_color (CLUTTER_ACTOR (stage), color);
-
-  g_object_notify (G_OBJECT (stage), "color");
 }
 
 /**
- * clutter_stage_get_color:
- * @stage: A #ClutterStage
- * @color: (out caller-allocates): return location for a #ClutterColor
+ * clutter_stage_get_fog:
+ * @stage: the #ClutterStage
+ * @fog: (out): return location for a #ClutterFog structure
  *
- * Retrieves the stage color.
+ * Retrieves the current depth cueing settings from the stage.
  *
- * Deprecated: 1.10: Use clutter_actor_get_background_color() instead.
+ * Since: 0.6
+ *
+ * Deprecated: 1.10: This function will always return the default
+ *   values of #ClutterFog
  */
 void
-clutter_stage_get_color (ClutterStage *stage,
-			 ClutterColor *color)
+clutter_stage_get_fog (ClutterStage *stage,
+                        ClutterFog   *fog)
 {
-  clutter_actor_get_background_color (CLUTTER_ACTOR (stage), color);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (fog != NULL);
+
+  *fog = stage->priv->fog;
 }
 
-static void
-clutter_stage_set_perspective_internal (ClutterStage       *stage,
-                                        ClutterPerspective *perspective)
+/*** Perspective boxed type ******/
+
+static gpointer
+clutter_perspective_copy (gpointer data)
 {
-  ClutterStagePrivate *priv = stage->priv;
+  if (G_LIKELY (data))
+    return g_slice_dup (ClutterPerspective, data);
 
-  if (priv->perspective.fovy == perspective->fovy &&
-      priv->perspective.aspect == perspective->aspect &&
-      priv->perspective.z_near == perspective->z_near &&
-      priv->perspective.z_far == perspective->z_far)
-    return;
+  return NULL;
+}
 
-  priv->perspective = *perspective;
+static void
+clutter_perspective_free (gpointer data)
+{
+  if (G_LIKELY (data))
+    g_slice_free (ClutterPerspective, data);
+}
 
-  cogl_matrix_init_identity (&priv->projection);
-  cogl_matrix_perspective (&priv->projection,
-                           priv->perspective.fovy,
-                           priv->perspective.aspect,
-                           priv->perspective.z_near,
-                           priv->perspective.z_far);
-  cogl_matrix_get_inverse (&priv->projection,
-                           &priv->inverse_projection);
+G_DEFINE_BOXED_TYPE (ClutterPerspective, clutter_perspective,
+                     clutter_perspective_copy,
+                     clutter_perspective_free);
 
-  priv->dirty_projection = TRUE;
-  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+static gpointer
+clutter_fog_copy (gpointer data)
+{
+  if (G_LIKELY (data))
+    return g_slice_dup (ClutterFog, data);
+
+  return NULL;
 }
 
-/**
- * clutter_stage_set_perspective:
- * @stage: A #ClutterStage
- * @perspective: A #ClutterPerspective
- *
- * Sets the stage perspective. Using this function is not recommended
- * because it will disable Clutter's attempts to generate an
- * appropriate perspective based on the size of the stage.
- */
-void
-clutter_stage_set_perspective (ClutterStage       *stage,
-                               ClutterPerspective *perspective)
+static void
+clutter_fog_free (gpointer data)
 {
-  ClutterStagePrivate *priv;
+  if (G_LIKELY (data))
+    g_slice_free (ClutterFog, data);
+}
 
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (perspective != NULL);
-  g_return_if_fail (perspective->z_far - perspective->z_near != 0);
+G_DEFINE_BOXED_TYPE (ClutterFog, clutter_fog, clutter_fog_copy, clutter_fog_free);
 
-  priv = stage->priv;
+static gpointer
+clutter_frame_info_copy (gpointer data)
+{
+  if (G_LIKELY (data))
+    return g_slice_dup (ClutterFrameInfo, data);
 
-  /* If the application ever calls this function then we'll stop
-     automatically updating the perspective when the stage changes
-     size */
-  priv->has_custom_perspective = TRUE;
+  return NULL;
+}
 
-  clutter_stage_set_perspective_internal (stage, perspective);
+static void
+clutter_frame_info_free (gpointer data)
+{
+  if (G_LIKELY (data))
+    g_slice_free (ClutterFrameInfo, data);
 }
 
+G_DEFINE_BOXED_TYPE (ClutterFrameInfo, clutter_frame_info,
+                     clutter_frame_info_copy,
+                     clutter_frame_info_free);
+
 /**
- * clutter_stage_get_perspective:
- * @stage: A #ClutterStage
- * @perspective: (out caller-allocates) (allow-none): return location for a
- *   #ClutterPerspective
+ * clutter_stage_new:
+ *
+ * Creates a new, non-default stage. A non-default stage is a new
+ * top-level actor which can be used as another container. It works
+ * exactly like the default stage, but while clutter_stage_get_default()
+ * will always return the same instance, you will have to keep a pointer
+ * to any #ClutterStage returned by clutter_stage_new().
  *
- * Retrieves the stage perspective.
+ * The ability to support multiple stages depends on the current
+ * backend. Use clutter_feature_available() and
+ * %CLUTTER_FEATURE_STAGE_MULTIPLE to check at runtime whether a
+ * backend supports multiple stages.
+ *
+ * Return value: a new stage, or %NULL if the default backend does
+ *   not support multiple stages. Use clutter_actor_destroy() to
+ *   programmatically close the returned stage.
+ *
+ * Since: 0.8
  */
-void
-clutter_stage_get_perspective (ClutterStage       *stage,
-                               ClutterPerspective *perspective)
+ClutterActor *
+clutter_stage_new (void)
 {
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (perspective != NULL);
-
-  *perspective = stage->priv->perspective;
+  return g_object_new (CLUTTER_TYPE_STAGE, NULL);
 }
 
-/*
- * clutter_stage_get_projection_matrix:
- * @stage: A #ClutterStage
- * @projection: return location for a #CoglMatrix representing the
- *              perspective projection applied to actors on the given
- *              @stage.
+/**
+ * clutter_stage_ensure_current:
+ * @stage: the #ClutterStage
  *
- * Retrieves the @stage's projection matrix. This is derived from the
- * current perspective set using clutter_stage_set_perspective().
+ * This function essentially makes sure the right GL context is
+ * current for the passed stage. It is not intended to
+ * be used by applications.
  *
- * Since: 1.6
+ * Since: 0.8
  */
 void
-_clutter_stage_get_projection_matrix (ClutterStage *stage,
-                                      CoglMatrix *projection)
+clutter_stage_ensure_current (ClutterStage *stage)
 {
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (projection != NULL);
+  ClutterBackend *backend;
 
-  *projection = stage->priv->projection;
-}
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-/* This simply provides a simple mechanism for us to ensure that
- * the projection matrix gets re-asserted before painting.
- *
- * This is used when switching between multiple stages */
-void
-_clutter_stage_dirty_projection (ClutterStage *stage)
-{
-  stage->priv->dirty_projection = TRUE;
+  backend = clutter_get_default_backend ();
+  _clutter_backend_ensure_context (backend, stage);
 }
 
-/*
- * clutter_stage_set_viewport:
- * @stage: A #ClutterStage
- * @x: The X postition to render the stage at, in window coordinates
- * @y: The Y position to render the stage at, in window coordinates
- * @width: The width to render the stage at, in window coordinates
- * @height: The height to render the stage at, in window coordinates
- *
- * Sets the stage viewport. The viewport defines a final scale and
- * translation of your rendered stage and actors. This lets you render
- * your stage into a subregion of the stage window or you could use it to
- * pan a subregion of the stage if your stage window is smaller then
- * the stage. (XXX: currently this isn't possible)
+/**
+ * clutter_stage_ensure_viewport:
+ * @stage: a #ClutterStage
  *
- * Unlike a scale and translation done using the modelview matrix this
- * is done after everything has had perspective projection applied, so
- * for example if you were to pan across a subregion of the stage using
- * the viewport then you would not see a change in perspective for the
- * actors on the stage.
+ * Ensures that the GL viewport is updated with the current
+ * stage window size.
  *
- * Normally the stage viewport will automatically track the size of the
- * stage window with no offset so the stage will fill your window. This
- * behaviour can be changed with the "viewport-mimics-window" property
- * which will automatically be set to FALSE if you use this API. If
- * you want to revert to the original behaviour then you should set
- * this property back to %TRUE using
- * clutter_stage_set_viewport_mimics_window().
- * (XXX: If we were to make this API public then we might want to do
- *  add that property.)
+ * This function will queue a redraw of @stage.
  *
- * Note: currently this interface only support integer precision
- * offsets and sizes for viewports but the interface takes floats because
- * OpenGL 4.0 has introduced floating point viewports which we might
- * want to expose via this API eventually.
+ * This function should not be called by applications; it is used
+ * when embedding a #ClutterStage into a toolkit with another
+ * windowing system, like GTK+.
  *
- * Since: 1.6
+ * Since: 1.0
  */
 void
-_clutter_stage_set_viewport (ClutterStage *stage,
-                             float         x,
-                             float         y,
-                             float         width,
-                             float         height)
+clutter_stage_ensure_viewport (ClutterStage *stage)
 {
-  ClutterStagePrivate *priv;
-
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-  priv = stage->priv;
-
+  _clutter_stage_dirty_viewport (stage);
 
-  if (x == priv->viewport[0] &&
-      y == priv->viewport[1] &&
-      width == priv->viewport[2] &&
-      height == priv->viewport[3])
-    return;
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
 
-  priv->viewport[0] = x;
-  priv->viewport[1] = y;
-  priv->viewport[2] = width;
-  priv->viewport[3] = height;
+static void
+clutter_stage_apply_scale (ClutterStage *stage)
+{
+  int factor;
 
-  priv->dirty_viewport = TRUE;
+  factor = _clutter_stage_window_get_scale_factor (stage->priv->impl);
+  if (factor != 1)
+    cogl_matrix_scale (&stage->priv->view, factor, factor, 1.f);
 
-  queue_full_redraw (stage);
+  stage->priv->window_transform_valid = FALSE;
 }
 
-/* This simply provides a simple mechanism for us to ensure that
- * the viewport gets re-asserted before next painting.
- *
- * This is used when switching between multiple stages */
-void
-_clutter_stage_dirty_viewport (ClutterStage *stage)
-{
-  stage->priv->dirty_viewport = TRUE;
-}
+# define _DEG_TO_RAD(d)         ((d) * ((float) G_PI / 180.0f))
 
-/*
- * clutter_stage_get_viewport:
- * @stage: A #ClutterStage
- * @x: A location for the X position where the stage is rendered,
- *     in window coordinates.
- * @y: A location for the Y position where the stage is rendered,
- *     in window coordinates.
- * @width: A location for the width the stage is rendered at,
- *         in window coordinates.
- * @height: A location for the height the stage is rendered at,
- *          in window coordinates.
+/* This calculates a distance into the view frustum to position the
+ * stage so there is a decent amount of space to position geometry
+ * between the stage and the near clipping plane.
  *
- * Returns the viewport offset and size set using
- * clutter_stage_set_viewport() or if the "viewport-mimics-window" property
- * is TRUE then @x and @y will be set to 0 and @width and @height will equal
- * the width if the stage window.
+ * Some awkward issues with this problem are:
+ * - It's not possible to have a gap as large as the stage size with
+ *   a fov > 53° which is basically always the case since the default
+ *   fov is 60°.
+ *    - This can be deduced if you consider that this requires a
+ *      triangle as wide as it is deep to fit in the frustum in front
+ *      of the z_near plane. That triangle will always have an angle
+ *      of 53.13° at the point sitting on the z_near plane, but if the
+ *      frustum has a wider fov angle the left/right clipping planes
+ *      can never converge with the two corners of our triangle no
+ *      matter what size the triangle has.
+ * - With a fov > 53° there is a trade off between maximizing the gap
+ *   size relative to the stage size but not loosing depth precision.
+ * - Perhaps ideally we wouldn't just consider the fov on the y-axis
+ *   that is usually used to define a perspective, we would consider
+ *   the fov of the axis with the largest stage size so the gap would
+ *   accommodate that size best.
  *
- * Since: 1.6
+ * After going around in circles a few times with how to handle these
+ * issues, we decided in the end to go for the simplest solution to
+ * start with instead of an elaborate function that handles arbitrary
+ * fov angles that we currently have no use-case for.
+ *
+ * The solution assumes a fovy of 60° and for that case gives a gap
+ * that's 85% of the stage height. We can consider more elaborate
+ * functions if necessary later.
+ *
+ * One guide we had to steer the gap size we support is the
+ * interactive test, test-texture-quality which expects to animate an
+ * actor to +400 on the z axis with a stage size of 640x480. A gap
+ * that's 85% of the stage height gives a gap of 408 in that case.
  */
-void
-_clutter_stage_get_viewport (ClutterStage *stage,
-                             float        *x,
-                             float        *y,
-                             float        *width,
-                             float        *height)
+static float
+calculate_z_translation (float z_near)
 {
-  ClutterStagePrivate *priv;
-
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  /* This solution uses fairly basic trigonometry, but is seems worth
+   * clarifying the particular geometry we are looking at in-case
+   * anyone wants to develop this further later. Not sure how well an
+   * ascii diagram is going to work :-)
+   *
+   *    |--- stage_height ---|
+   *    |     stage line     |
+   *   ╲━━━━━━━━━━━━━━━━━━━━━╱------------
+   *    ╲.  (2)   │        .╱       |   |
+   *   C ╲ .      │      . ╱     gap|   |
+   * =0.5°╲  . a  │    .  ╱         |   |
+   *      b╲(1). D│  .   ╱          |   |
+   *        ╲   B.│.    ╱near plane |   |
+   *      A= ╲━━━━━━━━━╱-------------   |
+   *     120° ╲ c │   ╱  |            z_2d
+   *           ╲  │  ╱  z_near          |
+   *       left ╲ │ ╱    |              |
+   *       clip  60°fovy |              |
+   *       plane  ╳----------------------
+   *              |
+   *              |
+   *         origin line
+   *
+   * The area of interest is the triangle labeled (1) at the top left
+   * marked with the ... line (a) from where the origin line crosses
+   * the near plane to the top left where the stage line cross the
+   * left clip plane.
+   *
+   * The sides of the triangle are a, b and c and the corresponding
+   * angles opposite those sides are A, B and C.
+   *
+   * The angle of C is what trades off the gap size we have relative
+   * to the stage size vs the depth precision we have.
+   *
+   * As mentioned above we arove at the angle for C is by working
+   * backwards from how much space we want for test-texture-quality.
+   * With a stage_height of 480 we want a gap > 400, ideally we also
+   * wanted a somewhat round number as a percentage of the height for
+   * documentation purposes. ~87% or a gap of ~416 is the limit
+   * because that's where we approach a C angle of 0° and effectively
+   * loose all depth precision.
+   *
+   * So for our test app with a stage_height of 480 if we aim for a
+   * gap of 408 (85% of 480) we can get the angle D as
+   * atan (stage_height/2/408) = 30.5°.
+   *
+   * That gives us the angle for B as 90° - 30.5° = 59.5°
+   *
+   * We can already determine that A has an angle of (fovy/2 + 90°) =
+   * 120°
+   *
+   * Therefore C = 180 - A - B = 0.5°
+   *
+   * The length of c = z_near * tan (30°)
+   *
+   * Now we can use the rule a/SinA = c/SinC to calculate the
+   * length of a. After some rearranging that gives us:
+   *
+   *      a              c
+   *  ----------  =  ----------
+   *  sin (120°)     sin (0.5°)
+   *
+   *      c * sin (120°)
+   *  a = --------------
+   *        sin (0.5°)
+   *
+   * And with that we can determine z_2d = cos (D) * a =
+   * cos (30.5°) * a + z_near:
+   *
+   *         c * sin (120°) * cos (30.5°)
+   *  z_2d = --------------------------- + z_near
+   *                 sin (0.5°)
+   */
 
-  priv = stage->priv;
+   /* We expect the compiler should boil this down to z_near * CONSTANT
+    * already, but just in case we use precomputed constants
+    */
+#if 0
+# define A      tanf (_DEG_TO_RAD (30.f))
+# define B      sinf (_DEG_TO_RAD (120.f))
+# define C      cosf (_DEG_TO_RAD (30.5f))
+# define D      sinf (_DEG_TO_RAD (.5f))
+#else
+# define A      0.57735025882720947265625f
+# define B      0.866025388240814208984375f
+# define C      0.86162912845611572265625f
+# define D      0.00872653536498546600341796875f
+#endif
 
-  *x = priv->viewport[0];
-  *y = priv->viewport[1];
-  *width = priv->viewport[2];
-  *height = priv->viewport[3];
+  return z_near
+       * A * B * C
+       / D
+       + z_near;
 }
 
-/**
- * clutter_stage_set_fullscreen:
- * @stage: a #ClutterStage
- * @fullscreen: %TRUE to to set the stage fullscreen
- *
- * Asks to place the stage window in the fullscreen or unfullscreen
- * states.
- *
- ( Note that you shouldn't assume the window is definitely full screen
- * afterward, because other entities (e.g. the user or window manager)
- * could unfullscreen it again, and not all window managers honor
- * requests to fullscreen windows.
- *
- * If you want to receive notification of the fullscreen state you
- * should either use the #ClutterStage::fullscreen and
- * #ClutterStage::unfullscreen signals, or use the notify signal
- * for the #ClutterStage:fullscreen-set property
- *
- * Since: 1.0
- */
 void
-clutter_stage_set_fullscreen (ClutterStage *stage,
-                              gboolean      fullscreen)
+_clutter_stage_maybe_setup_viewport (ClutterStage *stage)
 {
-  ClutterStagePrivate *priv;
-
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-
-  priv = stage->priv;
+  ClutterStagePrivate *priv = stage->priv;
 
-  if (priv->is_fullscreen != fullscreen)
+  if (priv->dirty_viewport)
     {
-      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
-      ClutterStageWindowIface *iface;
+      CoglFramebuffer *fb = cogl_get_draw_framebuffer ();
+      ClutterPerspective perspective;
+      int window_scale;
+      float z_2d;
 
-      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
+      CLUTTER_NOTE (PAINT,
+                    "Setting up the viewport { w:%f, h:%f }",
+                    priv->viewport[2],
+                    priv->viewport[3]);
 
-      /* Only set if backend implements.
-       *
-       * Also see clutter_stage_event() for setting priv->is_fullscreen
-       * on state change event.
-       */
-      if (iface->set_fullscreen)
-	iface->set_fullscreen (impl, fullscreen);
-    }
+      window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
 
-  /* If the backend did fullscreen the stage window then we need to resize
-   * the stage and update its viewport so we queue a relayout.  Note: if the
-   * fullscreen request is handled asynchronously we can't rely on this
-   * queue_relayout to update the viewport, but for example the X backend
-   * will recieve a ConfigureNotify after a successful resize which is how
-   * we ensure the viewport is updated on X.
-   */
-  clutter_actor_queue_relayout (CLUTTER_ACTOR (stage));
-}
+      cogl_framebuffer_set_viewport (fb,
+                                     priv->viewport[0] * window_scale,
+                                     priv->viewport[1] * window_scale,
+                                     priv->viewport[2] * window_scale,
+                                     priv->viewport[3] * window_scale);
 
-/**
- * clutter_stage_get_fullscreen:
- * @stage: a #ClutterStage
- *
- * Retrieves whether the stage is full screen or not
- *
- * Return value: %TRUE if the stage is full screen
- *
- * Since: 1.0
- */
-gboolean
-clutter_stage_get_fullscreen (ClutterStage *stage)
-{
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+      perspective = priv->perspective;
 
-  return stage->priv->is_fullscreen;
-}
+      /* Ideally we want to regenerate the perspective matrix whenever
+       * the size changes but if the user has provided a custom matrix
+       * then we don't want to override it */
+      if (!priv->has_custom_perspective)
+        {
+          perspective.aspect = priv->viewport[2] / priv->viewport[3];
+          z_2d = calculate_z_translation (perspective.z_near);
 
-/**
- * clutter_stage_set_user_resizable:
- * @stage: a #ClutterStage
- * @resizable: whether the stage should be user resizable.
- *
- * Sets if the stage is resizable by user interaction (e.g. via
- * window manager controls)
- *
- * Since: 0.4
- */
-void
-clutter_stage_set_user_resizable (ClutterStage *stage,
-                                  gboolean      resizable)
-{
-  ClutterStagePrivate *priv;
+          /* NB: z_2d is only enough room for 85% of the stage_height between
+           * the stage and the z_near plane. For behind the stage plane we
+           * want a more consistent gap of 10 times the stage_height before
+           * hitting the far plane so we calculate that relative to the final
+           * height of the stage plane at the z_2d_distance we got... */
+          perspective.z_far = z_2d +
+            tanf (_DEG_TO_RAD (perspective.fovy / 2.0f)) * z_2d * 20.0f;
 
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+          clutter_stage_set_perspective_internal (stage, &perspective);
+        }
+      else
+        z_2d = calculate_z_translation (perspective.z_near);
 
-  priv = stage->priv;
+      cogl_matrix_init_identity (&priv->view);
+      cogl_matrix_view_2d_in_perspective (&priv->view,
+                                          perspective.fovy,
+                                          perspective.aspect,
+                                          perspective.z_near,
+                                          z_2d,
+                                          priv->viewport[2] * window_scale,
+                                          priv->viewport[3] * window_scale);
 
-  if (clutter_feature_available (CLUTTER_FEATURE_STAGE_USER_RESIZE)
-      && priv->is_user_resizable != resizable)
-    {
-      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
-      ClutterStageWindowIface *iface;
+      clutter_stage_apply_scale (stage);
 
-      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
-      if (iface->set_user_resizable)
-        {
-          priv->is_user_resizable = resizable;
+      priv->dirty_viewport = FALSE;
+    }
 
-          iface->set_user_resizable (impl, resizable);
+  if (priv->dirty_projection)
+    {
+      cogl_framebuffer_set_projection_matrix (cogl_get_draw_framebuffer (),
+                                              &priv->projection);
 
-          g_object_notify (G_OBJECT (stage), "user-resizable");
-        }
+      priv->dirty_projection = FALSE;
     }
 }
 
+#undef _DEG_TO_RAD
+
 /**
- * clutter_stage_get_user_resizable:
+ * clutter_stage_ensure_redraw:
  * @stage: a #ClutterStage
  *
- * Retrieves the value set with clutter_stage_set_user_resizable().
- *
- * Return value: %TRUE if the stage is resizable by the user.
+ * Ensures that @stage is redrawn
  *
- * Since: 0.4
- */
-gboolean
-clutter_stage_get_user_resizable (ClutterStage *stage)
-{
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
-
-  return stage->priv->is_user_resizable;
-}
-
-/**
- * clutter_stage_show_cursor:
- * @stage: a #ClutterStage
+ * This function should not be called by applications: it is
+ * used when embedding a #ClutterStage into a toolkit with
+ * another windowing system, like GTK+.
  *
- * Shows the cursor on the stage window
+ * Since: 1.0
  */
 void
-clutter_stage_show_cursor (ClutterStage *stage)
+clutter_stage_ensure_redraw (ClutterStage *stage)
 {
+  ClutterMasterClock *master_clock;
   ClutterStagePrivate *priv;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
-  if (!priv->is_cursor_visible)
-    {
-      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
-      ClutterStageWindowIface *iface;
 
-      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
-      if (iface->set_cursor_visible)
-        {
-          priv->is_cursor_visible = TRUE;
+  if (!priv->relayout_pending && !priv->redraw_pending)
+    _clutter_stage_schedule_update (stage);
 
-          iface->set_cursor_visible (impl, TRUE);
+  priv->relayout_pending = TRUE;
+  priv->redraw_pending = TRUE;
 
-          g_object_notify (G_OBJECT (stage), "cursor-visible");
-        }
-    }
+  master_clock = _clutter_master_clock_get_default ();
+  _clutter_master_clock_start_running (master_clock);
 }
 
 /**
- * clutter_stage_hide_cursor:
- * @stage: a #ClutterStage
+ * clutter_stage_queue_redraw:
+ * @stage: the #ClutterStage
  *
- * Makes the cursor invisible on the stage window
+ * Queues a redraw for the passed stage.
  *
- * Since: 0.4
+ * Applications should call clutter_actor_queue_redraw() and not
+ * this function.
+ *
+ * Since: 0.8
+ *
+ * Deprecated: 1.10: Use clutter_actor_queue_redraw() instead.
  */
 void
-clutter_stage_hide_cursor (ClutterStage *stage)
+clutter_stage_queue_redraw (ClutterStage *stage)
 {
-  ClutterStagePrivate *priv;
-
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-
-  priv = stage->priv;
-  if (priv->is_cursor_visible)
-    {
-      ClutterStageWindow *impl = CLUTTER_STAGE_WINDOW (priv->impl);
-      ClutterStageWindowIface *iface;
-
-      iface = CLUTTER_STAGE_WINDOW_GET_IFACE (impl);
-      if (iface->set_cursor_visible)
-        {
-          priv->is_cursor_visible = FALSE;
-
-          iface->set_cursor_visible (impl, FALSE);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-          g_object_notify (G_OBJECT (stage), "cursor-visible");
-        }
-    }
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
 }
 
 /**
- * clutter_stage_read_pixels:
- * @stage: A #ClutterStage
- * @x: x coordinate of the first pixel that is read from stage
- * @y: y coordinate of the first pixel that is read from stage
- * @width: Width dimention of pixels to be read, or -1 for the
- *   entire stage width
- * @height: Height dimention of pixels to be read, or -1 for the
- *   entire stage height
+ * clutter_stage_is_default:
+ * @stage: a #ClutterStage
  *
- * Makes a screenshot of the stage in RGBA 8bit data, returns a
- * linear buffer with @width * 4 as rowstride.
+ * Checks if @stage is the default stage, or an instance created using
+ * clutter_stage_new() but internally using the same implementation.
  *
- * The alpha data contained in the returned buffer is driver-dependent,
- * and not guaranteed to hold any sensible value.
+ * Return value: %TRUE if the passed stage is the default one
  *
- * Return value: (transfer full) (array): a pointer to newly allocated memory with the buffer
- *   or %NULL if the read failed. Use g_free() on the returned data
- *   to release the resources it has allocated.
+ * Since: 0.8
+ *
+ * Deprecated: 1.10: Track the stage pointer inside your application
+ *   code, or use clutter_actor_get_stage() to retrieve the stage for
+ *   a given actor.
  */
-guchar *
-clutter_stage_read_pixels (ClutterStage *stage,
-                           gint          x,
-                           gint          y,
-                           gint          width,
-                           gint          height)
+gboolean
+clutter_stage_is_default (ClutterStage *stage)
 {
-  ClutterActorBox box;
-  guchar *pixels;
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+  return stage_is_default (stage);
+}
 
-  /* Force a redraw of the stage before reading back pixels */
-  clutter_stage_ensure_current (stage);
-  clutter_actor_paint (CLUTTER_ACTOR (stage));
+void
+_clutter_stage_set_window (ClutterStage       *stage,
+                           ClutterStageWindow *stage_window)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (CLUTTER_IS_STAGE_WINDOW (stage_window));
 
-  clutter_actor_get_allocation_box (CLUTTER_ACTOR (stage), &box);
+  if (stage->priv->impl != NULL)
+    g_object_unref (stage->priv->impl);
 
-  if (width < 0)
-    width = ceilf (box.x2 - box.x1);
+  stage->priv->impl = stage_window;
+}
 
-  if (height < 0)
-    height = ceilf (box.y2 - box.y1);
+ClutterStageWindow *
+_clutter_stage_get_window (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
 
-  pixels = g_malloc (height * width * 4);
+  return CLUTTER_STAGE_WINDOW (stage->priv->impl);
+}
+
+ClutterStageWindow *
+_clutter_stage_get_default_window (void)
+{
+  ClutterStageManager *manager = clutter_stage_manager_get_default ();
+  ClutterStage *stage;
 
-  cogl_read_pixels (x, y, width, height,
-                    COGL_READ_PIXELS_COLOR_BUFFER,
-                    COGL_PIXEL_FORMAT_RGBA_8888,
-                    pixels);
+  stage = clutter_stage_manager_get_default_stage (manager);
+  if (stage == NULL)
+    return NULL;
 
-  return pixels;
+  return _clutter_stage_get_window (stage);
 }
 
 /**
- * clutter_stage_get_actor_at_pos:
+ * clutter_stage_set_throttle_motion_events:
  * @stage: a #ClutterStage
- * @pick_mode: how the scene graph should be painted
- * @x: X coordinate to check
- * @y: Y coordinate to check
+ * @throttle: %TRUE to throttle motion events
  *
- * Checks the scene at the coordinates @x and @y and returns a pointer
- * to the #ClutterActor at those coordinates.
+ * Sets whether motion events received between redraws should
+ * be throttled or not. If motion events are throttled, those
+ * events received by the windowing system between redraws will
+ * be compressed so that only the last event will be propagated
+ * to the @stage and its actors.
  *
- * By using @pick_mode it is possible to control which actors will be
- * painted and thus available.
+ * This function should only be used if you want to have all
+ * the motion events delivered to your application code.
  *
- * Return value: (transfer none): the actor at the specified coordinates,
- *   if any
+ * Since: 1.0
  */
-ClutterActor *
-clutter_stage_get_actor_at_pos (ClutterStage    *stage,
-                                ClutterPickMode  pick_mode,
-                                gint             x,
-                                gint             y)
+void
+clutter_stage_set_throttle_motion_events (ClutterStage *stage,
+                                          gboolean      throttle)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+  ClutterStagePrivate *priv;
 
-  return _clutter_stage_do_pick (stage, x, y, pick_mode);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  if (priv->throttle_motion_events != throttle)
+    priv->throttle_motion_events = throttle;
 }
 
 /**
- * clutter_stage_event:
+ * clutter_stage_get_throttle_motion_events:
  * @stage: a #ClutterStage
- * @event: a #ClutterEvent
  *
- * This function is used to emit an event on the main stage.
- *
- * You should rarely need to use this function, except for
- * synthetised events.
+ * Retrieves the value set with clutter_stage_set_throttle_motion_events()
  *
- * Return value: the return value from the signal emission
+ * Return value: %TRUE if the motion events are being throttled,
+ *   and %FALSE otherwise
  *
- * Since: 0.4
+ * Since: 1.0
  */
 gboolean
-clutter_stage_event (ClutterStage *stage,
-                     ClutterEvent *event)
+clutter_stage_get_throttle_motion_events (ClutterStage *stage)
 {
-  ClutterStagePrivate *priv;
-
   g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
-  g_return_val_if_fail (event != NULL, FALSE);
-
-  priv = stage->priv;
-
-  if (event->type == CLUTTER_DELETE)
-    {
-      gboolean retval = FALSE;
-
-      g_signal_emit_by_name (stage, "event", event, &retval);
-
-      if (!retval)
-        g_signal_emit_by_name (stage, "delete-event", event, &retval);
-
-      return retval;
-    }
-
-  if (event->type != CLUTTER_STAGE_STATE)
-    return FALSE;
-
-  /* emit raw event */
-  if (clutter_actor_event (CLUTTER_ACTOR (stage), event, FALSE))
-    return TRUE;
-
-  if (event->stage_state.changed_mask & CLUTTER_STAGE_STATE_FULLSCREEN)
-    {
-      if (event->stage_state.new_state & CLUTTER_STAGE_STATE_FULLSCREEN)
-	{
-	  priv->is_fullscreen = TRUE;
-	  g_signal_emit (stage, stage_signals[FULLSCREEN], 0);
-
-          g_object_notify (G_OBJECT (stage), "fullscreen-set");
-	}
-      else
-	{
-	  priv->is_fullscreen = FALSE;
-	  g_signal_emit (stage, stage_signals[UNFULLSCREEN], 0);
-
-          g_object_notify (G_OBJECT (stage), "fullscreen-set");
-	}
-    }
-
-  if (event->stage_state.changed_mask & CLUTTER_STAGE_STATE_ACTIVATED)
-    {
-      if (event->stage_state.new_state & CLUTTER_STAGE_STATE_ACTIVATED)
-	g_signal_emit (stage, stage_signals[ACTIVATE], 0);
-      else
-	g_signal_emit (stage, stage_signals[DEACTIVATE], 0);
-    }
 
-  return TRUE;
+  return stage->priv->throttle_motion_events;
 }
 
 /**
- * clutter_stage_set_title:
- * @stage: A #ClutterStage
- * @title: A utf8 string for the stage windows title.
+ * clutter_stage_set_use_alpha:
+ * @stage: a #ClutterStage
+ * @use_alpha: whether the stage should honour the opacity or the
+ *   alpha channel of the stage color
  *
- * Sets the stage title.
+ * Sets whether the @stage should honour the #ClutterActor:opacity and
+ * the alpha channel of the #ClutterStage:color
  *
- * Since: 0.4
- **/
+ * Since: 1.2
+ */
 void
-clutter_stage_set_title (ClutterStage       *stage,
-			 const gchar        *title)
+clutter_stage_set_use_alpha (ClutterStage *stage,
+                             gboolean      use_alpha)
 {
   ClutterStagePrivate *priv;
-  ClutterStageWindow *impl;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
 
-  g_free (priv->title);
-  priv->title = g_strdup (title);
+  if (priv->use_alpha != use_alpha)
+    {
+      priv->use_alpha = use_alpha;
 
-  impl = CLUTTER_STAGE_WINDOW (priv->impl);
-  if (CLUTTER_STAGE_WINDOW_GET_IFACE(impl)->set_title != NULL)
-    CLUTTER_STAGE_WINDOW_GET_IFACE (impl)->set_title (impl, priv->title);
+      clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
 
-  g_object_notify (G_OBJECT (stage), "title");
+      g_object_notify (G_OBJECT (stage), "use-alpha");
+    }
 }
 
 /**
- * clutter_stage_get_title:
- * @stage: A #ClutterStage
+ * clutter_stage_get_use_alpha:
+ * @stage: a #ClutterStage
  *
- * Gets the stage title.
+ * Retrieves the value set using clutter_stage_set_use_alpha()
  *
- * Return value: pointer to the title string for the stage. The
- * returned string is owned by the actor and should not
- * be modified or freed.
+ * Return value: %TRUE if the stage should honour the opacity and the
+ *   alpha channel of the stage color
  *
- * Since: 0.4
- **/
-const gchar *
-clutter_stage_get_title (ClutterStage       *stage)
+ * Since: 1.2
+ */
+gboolean
+clutter_stage_get_use_alpha (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->use_alpha;
+}
+
+/**
+ * clutter_stage_set_minimum_size:
+ * @stage: a #ClutterStage
+ * @width: width, in pixels
+ * @height: height, in pixels
+ *
+ * Sets the minimum size for a stage window, if the default backend
+ * uses #ClutterStage inside a window
+ *
+ * This is a convenience function, and it is equivalent to setting the
+ * #ClutterActor:min-width and #ClutterActor:min-height on @stage
+ *
+ * If the current size of @stage is smaller than the minimum size, the
+ * @stage will be resized to the new @width and @height
+ *
+ * This function has no effect if @stage is fullscreen
+ *
+ * Since: 1.2
+ */
+void
+clutter_stage_set_minimum_size (ClutterStage *stage,
+                                guint         width,
+                                guint         height)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
-
-  return stage->priv->title;
-}
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail ((width > 0) && (height > 0));
 
-static void
-on_key_focus_destroy (ClutterActor *actor,
-                      ClutterStage *stage)
-{
-  /* unset the key focus */
-  clutter_stage_set_key_focus (stage, NULL);
+  g_object_set (G_OBJECT (stage),
+                "min-width", (gfloat) width,
+                "min-height", (gfloat )height,
+                NULL);
 }
 
 /**
- * clutter_stage_set_key_focus:
- * @stage: the #ClutterStage
- * @actor: (allow-none): the actor to set key focus to, or %NULL
+ * clutter_stage_get_minimum_size:
+ * @stage: a #ClutterStage
+ * @width: (out): return location for the minimum width, in pixels,
+ *   or %NULL
+ * @height: (out): return location for the minimum height, in pixels,
+ *   or %NULL
  *
- * Sets the key focus on @actor. An actor with key focus will receive
- * all the key events. If @actor is %NULL, the stage will receive
- * focus.
+ * Retrieves the minimum size for a stage window as set using
+ * clutter_stage_set_minimum_size().
  *
- * Since: 0.6
+ * The returned size may not correspond to the actual minimum size and
+ * it is specific to the #ClutterStage implementation inside the
+ * Clutter backend
+ *
+ * Since: 1.2
  */
 void
-clutter_stage_set_key_focus (ClutterStage *stage,
-			     ClutterActor *actor)
+clutter_stage_get_minimum_size (ClutterStage *stage,
+                                guint        *width_p,
+                                guint        *height_p)
 {
-  ClutterStagePrivate *priv;
+  gfloat width, height;
+  gboolean width_set, height_set;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (actor == NULL || CLUTTER_IS_ACTOR (actor));
-
-  priv = stage->priv;
 
-  /* normalize the key focus. NULL == stage */
-  if (actor == CLUTTER_ACTOR (stage))
-    actor = NULL;
+  g_object_get (G_OBJECT (stage),
+                "min-width", &width,
+                "min-width-set", &width_set,
+                "min-height", &height,
+                "min-height-set", &height_set,
+                NULL);
 
-  /* avoid emitting signals and notifications if we're setting the same
-   * actor as the key focus
+  /* if not width or height have been set, then the Stage
+   * minimum size is defined to be 1x1
    */
-  if (priv->key_focused_actor == actor)
-    return;
+  if (!width_set)
+    width = 1;
 
-  if (priv->key_focused_actor != NULL)
-    {
-      ClutterActor *old_focused_actor;
+  if (!height_set)
+    height = 1;
 
-      old_focused_actor = priv->key_focused_actor;
+  if (width_p)
+    *width_p = (guint) width;
 
-      /* set key_focused_actor to NULL before emitting the signal or someone
-       * might hide the previously focused actor in the signal handler and we'd
-       * get re-entrant call and get glib critical from g_object_weak_unref
-       */
-      g_signal_handlers_disconnect_by_func (priv->key_focused_actor,
-                                            G_CALLBACK (on_key_focus_destroy),
-                                            stage);
-      priv->key_focused_actor = NULL;
+  if (height_p)
+    *height_p = (guint) height;
+}
 
-      g_signal_emit_by_name (old_focused_actor, "key-focus-out");
-    }
-  else
-    g_signal_emit_by_name (stage, "key-focus-out");
+void
+_clutter_stage_schedule_update (ClutterStage *stage)
+{
+  ClutterStageWindow *stage_window;
 
-  /* Note, if someone changes key focus in focus-out signal handler we'd be
-   * overriding the latter call below moving the focus where it was originally
-   * intended. The order of events would be:
-   *   1st focus-out, 2nd focus-out (on stage), 2nd focus-in, 1st focus-in
-   */
-  if (actor != NULL)
-    {
-      priv->key_focused_actor = actor;
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return;
 
-      g_signal_connect (actor,
-                        "destroy", G_CALLBACK (on_key_focus_destroy),
-                        stage);
-      g_signal_emit_by_name (priv->key_focused_actor, "key-focus-in");
-    }
-  else
-    g_signal_emit_by_name (stage, "key-focus-in");
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window == NULL)
+    return;
 
-  g_object_notify (G_OBJECT (stage), "key-focus");
+  if (stage->priv->adaptive_sync_delay)
+    _clutter_stage_window_schedule_update (stage_window,
+                                           CLUTTER_STAGE_WINDOW_SYNC_DELAY_ADAPTIVE);
+  else
+    _clutter_stage_window_schedule_update (stage_window,
+                                           stage->priv->sync_delay);
 }
 
-/**
- * clutter_stage_get_key_focus:
- * @stage: the #ClutterStage
- *
- * Retrieves the actor that is currently under key focus.
- *
- * Return value: (transfer none): the actor with key focus, or the stage
- *
- * Since: 0.6
- */
-ClutterActor *
-clutter_stage_get_key_focus (ClutterStage *stage)
+/* Returns the earliest time the stage is ready to update */
+gint64
+_clutter_stage_get_update_time (ClutterStage *stage)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+  ClutterStageWindow *stage_window;
 
-  if (stage->priv->key_focused_actor)
-    return stage->priv->key_focused_actor;
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return 0;
 
-  return CLUTTER_ACTOR (stage);
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window == NULL)
+    return 0;
+
+  return _clutter_stage_window_get_update_time (stage_window);
 }
 
-/**
- * clutter_stage_get_use_fog:
- * @stage: the #ClutterStage
- *
- * Gets whether the depth cueing effect is enabled on @stage.
- *
- * Return value: %TRUE if the depth cueing effect is enabled
- *
- * Since: 0.6
- *
- * Deprecated: 1.10: This function will always return %FALSE
+/* Returns the time the next frame of the stage is expected to be
+ * presented, or 0 if it is not known
  */
-gboolean
-clutter_stage_get_use_fog (ClutterStage *stage)
+gint64
+_clutter_stage_get_next_presentation_time (ClutterStage *stage)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+  ClutterStageWindow *stage_window;
 
-  return stage->priv->use_fog;
-}
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return 0;
 
-/**
- * clutter_stage_set_use_fog:
- * @stage: the #ClutterStage
- * @fog: %TRUE for enabling the depth cueing effect
- *
- * Sets whether the depth cueing effect on the stage should be enabled
- * or not.
- *
- * Depth cueing is a 3D effect that makes actors farther away from the
- * viewing point less opaque, by fading them with the stage color.
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window == NULL)
+    return 0;
+
+  return _clutter_stage_window_get_next_presentation_time (stage_window);
+}
 
- * The parameters of the GL fog used can be changed using the
- * clutter_stage_set_fog() function.
- *
- * Since: 0.6
- *
- * Deprecated: 1.10: Calling this function produces no visible effect
- */
 void
-clutter_stage_set_use_fog (ClutterStage *stage,
-                           gboolean      fog)
+_clutter_stage_clear_update_time (ClutterStage *stage)
 {
+  ClutterStageWindow *stage_window;
+
+  stage_window = _clutter_stage_get_window (stage);
+  if (stage_window)
+    _clutter_stage_window_clear_update_time (stage_window);
 }
 
 /**
- * clutter_stage_set_fog:
- * @stage: the #ClutterStage
- * @fog: a #ClutterFog structure
- *
- * Sets the fog (also known as "depth cueing") settings for the @stage.
- *
- * A #ClutterStage will only use a linear fog progression, which
- * depends solely on the distance from the viewer. The cogl_set_fog()
- * function in COGL exposes more of the underlying implementation,
- * and allows changing the for progression function. It can be directly
- * used by disabling the #ClutterStage:use-fog property and connecting
- * a signal handler to the #ClutterActor::paint signal on the @stage,
- * like:
- *
- * |[
- *   clutter_stage_set_use_fog (stage, FALSE);
- *   g_signal_connect (stage, "paint", G_CALLBACK (on_stage_paint), NULL);
- * ]|
- *
- * The paint signal handler will call cogl_set_fog() with the
- * desired settings:
- *
- * |[
- *   static void
- *   on_stage_paint (ClutterActor *actor)
- *   {
- *     ClutterColor stage_color = { 0, };
- *     CoglColor fog_color = { 0, };
- *
- *     // set the fog color to the stage background color
- *     clutter_stage_get_color (CLUTTER_STAGE (actor), &stage_color);
- *     cogl_color_init_from_4ub (&fog_color,
- *                               stage_color.red,
- *                               stage_color.green,
- *                               stage_color.blue,
- *                               stage_color.alpha);
+ * clutter_stage_set_no_clear_hint:
+ * @stage: a #ClutterStage
+ * @no_clear: %TRUE if the @stage should not clear itself on every
+ *   repaint cycle
  *
- *     // enable fog //
- *     cogl_set_fog (&fog_color,
- *                   COGL_FOG_MODE_EXPONENTIAL, // mode
- *                   0.5,                       // density
- *                   5.0, 30.0);                // z_near and z_far
- *   }
- * ]|
+ * Sets whether the @stage should clear itself at the beginning
+ * of each paint cycle or not.
  *
- * The fogging functions only work correctly when the visible actors use
- * unmultiplied alpha colors. By default Cogl will premultiply textures and
- * cogl_set_source_color() will premultiply colors, so unless you explicitly
- * load your textures requesting an unmultiplied internal format and use
- * cogl_material_set_color() you can only use fogging with fully opaque actors.
- * Support for premultiplied colors will improve in the future when we can
- * depend on fragment shaders.
+ * Clearing the #ClutterStage can be a costly operation, especially
+ * if the stage is always covered - for instance, in a full-screen
+ * video player or in a game with a background texture.
  *
- * Since: 0.6
+ * This setting is a hint; Clutter might discard this hint
+ * depending on its internal state.
  *
- * Deprecated: 1.10: Fog settings are ignored.
+ * If parts of the stage are visible and you disable clearing you
+ * might end up with visual artifacts while painting the contents of
+ * the stage.
+ *
+ * Since: 1.4
  */
 void
-clutter_stage_set_fog (ClutterStage *stage,
-                       ClutterFog   *fog)
+clutter_stage_set_no_clear_hint (ClutterStage *stage,
+                                 gboolean      no_clear)
 {
+  ClutterStagePrivate *priv;
+  ClutterStageHint new_hints;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+  new_hints = priv->stage_hints;
+
+  if (no_clear)
+    new_hints |= CLUTTER_STAGE_NO_CLEAR_ON_PAINT;
+  else
+    new_hints &= ~CLUTTER_STAGE_NO_CLEAR_ON_PAINT;
+
+  if (priv->stage_hints == new_hints)
+    return;
+
+  priv->stage_hints = new_hints;
+
+  g_object_notify (G_OBJECT (stage), "no-clear-hint");
 }
 
 /**
- * clutter_stage_get_fog:
- * @stage: the #ClutterStage
- * @fog: (out): return location for a #ClutterFog structure
+ * clutter_stage_get_no_clear_hint:
+ * @stage: a #ClutterStage
  *
- * Retrieves the current depth cueing settings from the stage.
+ * Retrieves the hint set with clutter_stage_set_no_clear_hint()
  *
- * Since: 0.6
+ * Return value: %TRUE if the stage should not clear itself on every paint
+ *   cycle, and %FALSE otherwise
  *
- * Deprecated: 1.10: This function will always return the default
- *   values of #ClutterFog
+ * Since: 1.4
  */
-void
-clutter_stage_get_fog (ClutterStage *stage,
-                        ClutterFog   *fog)
+gboolean
+clutter_stage_get_no_clear_hint (ClutterStage *stage)
 {
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (fog != NULL);
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  *fog = stage->priv->fog;
+  return (stage->priv->stage_hints & CLUTTER_STAGE_NO_CLEAR_ON_PAINT) != 0;
 }
 
-/*** Perspective boxed type ******/
-
-static gpointer
-clutter_perspective_copy (gpointer data)
+/* The paint volumes returned by clutter_actor_get_transformed_paint_volume()
+ * live on a per-frame stack owned by the stage; the stack keeps its chunks
+ * around when it is reset, so after the first few frames getting a volume
+ * does not allocate.
+ */
+ClutterPaintVolume *
+_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage)
 {
-  if (G_LIKELY (data))
-    return g_slice_dup (ClutterPerspective, data);
+  ClutterStagePrivate *priv = stage->priv;
+  guint chunk = priv->n_stack_paint_volumes / PAINT_VOLUME_CHUNK_SIZE;
+  ClutterPaintVolume *volumes;
 
-  return NULL;
+  if (chunk == priv->paint_volume_stack->len)
+    g_ptr_array_add (priv->paint_volume_stack,
+                     g_new (ClutterPaintVolume, PAINT_VOLUME_CHUNK_SIZE));
+
+  volumes = g_ptr_array_index (priv->paint_volume_stack, chunk);
+
+  return &volumes[priv->n_stack_paint_volumes++ % PAINT_VOLUME_CHUNK_SIZE];
 }
 
-static void
-clutter_perspective_free (gpointer data)
+void
+_clutter_stage_paint_volume_stack_free_all (ClutterStage *stage)
 {
-  if (G_LIKELY (data))
-    g_slice_free (ClutterPerspective, data);
-}
+  ClutterStagePrivate *priv = stage->priv;
+  guint i;
 
-G_DEFINE_BOXED_TYPE (ClutterPerspective, clutter_perspective,
-                     clutter_perspective_copy,
-                     clutter_perspective_free);
+  for (i = 0; i < priv->n_stack_paint_volumes; i++)
+    {
+      ClutterPaintVolume *volumes =
+        g_ptr_array_index (priv->paint_volume_stack,
+                           i / PAINT_VOLUME_CHUNK_SIZE);
 
-static gpointer
-clutter_fog_copy (gpointer data)
-{
-  if (G_LIKELY (data))
-    return g_slice_dup (ClutterFog, data);
+      clutter_paint_volume_free (&volumes[i % PAINT_VOLUME_CHUNK_SIZE]);
+    }
 
-  return NULL;
+  priv->n_stack_paint_volumes = 0;
 }
 
-static void
-clutter_fog_free (gpointer data)
+/* The is an out-of-band paramater available while painting that
+ * can be used to cull actors. */
+const ClutterPlane *
+_clutter_stage_get_clip (ClutterStage *stage)
 {
-  if (G_LIKELY (data))
-    g_slice_free (ClutterFog, data);
+  return stage->priv->current_clip_planes;
 }
 
-G_DEFINE_BOXED_TYPE (ClutterFog, clutter_fog, clutter_fog_copy, clutter_fog_free);
-
-/**
- * clutter_stage_new:
- *
- * Creates a new, non-default stage. A non-default stage is a new
- * top-level actor which can be used as another container. It works
- * exactly like the default stage, but while clutter_stage_get_default()
- * will always return the same instance, you will have to keep a pointer
- * to any #ClutterStage returned by clutter_stage_new().
- *
- * The ability to support multiple stages depends on the current
- * backend. Use clutter_feature_available() and
- * %CLUTTER_FEATURE_STAGE_MULTIPLE to check at runtime whether a
- * backend supports multiple stages.
- *
- * Return value: a new stage, or %NULL if the default backend does
- *   not support multiple stages. Use clutter_actor_destroy() to
- *   programmatically close the returned stage.
- *
- * Since: 0.8
- */
-ClutterActor *
-clutter_stage_new (void)
+/* The rectangle of the stage being painted, in stage coordinates;
+ * like the clip planes, it is only valid while painting. */
+void
+_clutter_stage_get_clip_box (ClutterStage    *stage,
+                             ClutterActorBox *box)
 {
-  return g_object_new (CLUTTER_TYPE_STAGE, NULL);
+  *box = stage->priv->current_clip_box;
 }
 
-/**
- * clutter_stage_ensure_current:
- * @stage: the #ClutterStage
- *
- * This function essentially makes sure the right GL context is
- * current for the passed stage. It is not intended to
- * be used by applications.
+/* When an actor queues a redraw we add it to a list on the stage that
+ * gets processed once all updates to the stage have been finished.
  *
- * Since: 0.8
+ * This deferred approach to processing queue_redraw requests means
+ * that we can avoid redundant transformations of clip volumes if
+ * something later triggers a full stage redraw anyway. It also means
+ * we can be more sure that all the referenced actors will have valid
+ * allocations improving the chance that we can determine the actors
+ * paint volume so we can clip the redraw request even if the user
+ * didn't explicitly do so.
  */
-void
-clutter_stage_ensure_current (ClutterStage *stage)
+ClutterStageQueueRedrawEntry *
+_clutter_stage_queue_actor_redraw (ClutterStage *stage,
+                                   ClutterStageQueueRedrawEntry *entry,
+                                   ClutterActor *actor,
+                                   ClutterPaintVolume *clip)
 {
-  ClutterBackend *backend;
+  ClutterStagePrivate *priv = stage->priv;
 
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  CLUTTER_NOTE (CLIPPING, "stage_queue_actor_redraw (actor=%s, clip=%p): ",
+                _clutter_actor_get_debug_name (actor), clip);
 
-  backend = clutter_get_default_backend ();
-  _clutter_backend_ensure_context (backend, stage);
-}
+  if (entry != NULL && entry->actor != NULL)
+    {
+      _clutter_stage_queue_redraw_entry_add_clip (entry, clip);
+      return entry;
+    }
 
-/**
- * clutter_stage_ensure_viewport:
- * @stage: a #ClutterStage
- *
- * Ensures that the GL viewport is updated with the current
- * stage window size.
- *
- * This function will queue a redraw of @stage.
- *
- * This function should not be called by applications; it is used
- * when embedding a #ClutterStage into a toolkit with another
- * windowing system, like GTK+.
- *
- * Since: 1.0
- */
-void
-clutter_stage_ensure_viewport (ClutterStage *stage)
-{
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  _clutter_stage_invalidate_pick_cache (stage);
 
-  _clutter_stage_dirty_viewport (stage);
+  if (!priv->redraw_pending)
+    {
+      ClutterMasterClock *master_clock;
 
-  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
-}
+      CLUTTER_NOTE (PAINT, "First redraw request");
 
-static void
-clutter_stage_apply_scale (ClutterStage *stage)
-{
-  int factor;
+      _clutter_stage_schedule_update (stage);
+      priv->redraw_pending = TRUE;
 
-  factor = _clutter_stage_window_get_scale_factor (stage->priv->impl);
-  if (factor != 1)
-    cogl_matrix_scale (&stage->priv->view, factor, factor, 1.f);
+      master_clock = _clutter_master_clock_get_default ();
+      _clutter_master_clock_start_running (master_clock);
+    }
+#ifdef CLUTTER_ENABLE_DEBUG
+  else
+    {
+      CLUTTER_NOTE (PAINT, "Redraw request number %lu",
+                    priv->redraw_count + 1);
+
+      priv->redraw_count += 1;
+    }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  if (priv->free_queue_redraws != NULL)
+    {
+      entry = priv->free_queue_redraws;
+      priv->free_queue_redraws = entry->next;
+      priv->n_free_queue_redraws -= 1;
+    }
+  else
+    entry = g_slice_new (ClutterStageQueueRedrawEntry);
+
+  entry->stage = stage;
+  entry->actor = g_object_ref (actor);
+
+  if (clip)
+    {
+      entry->has_clip = TRUE;
+      _clutter_paint_volume_init_static (&entry->clip, actor);
+      _clutter_paint_volume_set_from_volume (&entry->clip, clip);
+    }
+  else
+    entry->has_clip = FALSE;
+
+  entry->next = priv->pending_queue_redraws;
+  priv->pending_queue_redraws = entry;
+
+  return entry;
 }
 
-# define _DEG_TO_RAD(d)         ((d) * ((float) G_PI / 180.0f))
+/*< private >
+ * _clutter_stage_queue_redraw_entry_add_clip:
+ * @entry: an entry returned by _clutter_stage_queue_actor_redraw()
+ * @clip: (allow-none): the volume to redraw, in the coordinates of the
+ *   actor of @entry, or %NULL to redraw the whole actor
+ *
+ * Merges a further redraw of the actor of @entry into the pending
+ * entry. The stage already knows that a redraw is pending, so neither
+ * the stage nor the stage coordinates of @clip are needed; the clip
+ * is transformed once, when the entry is processed.
+ */
+void
+_clutter_stage_queue_redraw_entry_add_clip (ClutterStageQueueRedrawEntry *entry,
+                                            ClutterPaintVolume           *clip)
+{
+  _clutter_stage_invalidate_pick_cache (entry->stage);
 
-/* This calculates a distance into the view frustum to position the
- * stage so there is a decent amount of space to position geometry
- * between the stage and the near clipping plane.
- *
- * Some awkward issues with this problem are:
- * - It's not possible to have a gap as large as the stage size with
- *   a fov > 53° which is basically always the case since the default
- *   fov is 60°.
- *    - This can be deduced if you consider that this requires a
- *      triangle as wide as it is deep to fit in the frustum in front
- *      of the z_near plane. That triangle will always have an angle
- *      of 53.13° at the point sitting on the z_near plane, but if the
- *      frustum has a wider fov angle the left/right clipping planes
- *      can never converge with the two corners of our triangle no
- *      matter what size the triangle has.
- * - With a fov > 53° there is a trade off between maximizing the gap
- *   size relative to the stage size but not loosing depth precision.
- * - Perhaps ideally we wouldn't just consider the fov on the y-axis
- *   that is usually used to define a perspective, we would consider
- *   the fov of the axis with the largest stage size so the gap would
- *   accommodate that size best.
- *
- * After going around in circles a few times with how to handle these
- * issues, we decided in the end to go for the simplest solution to
- * start with instead of an elaborate function that handles arbitrary
- * fov angles that we currently have no use-case for.
- *
- * The solution assumes a fovy of 60° and for that case gives a gap
- * that's 85% of the stage height. We can consider more elaborate
- * functions if necessary later.
+#ifdef CLUTTER_ENABLE_DEBUG
+  entry->stage->priv->redraw_count += 1;
+#endif
+
+  /* Ignore all requests to queue a redraw for an actor if a full
+   * (non-clipped) redraw of the actor has already been queued. */
+  if (!entry->has_clip)
+    {
+      CLUTTER_NOTE (CLIPPING, "Bail from stage_queue_actor_redraw (%s): "
+                    "Unclipped redraw of actor already queued",
+                    _clutter_actor_get_debug_name (entry->actor));
+      return;
+    }
+
+  /* If queuing a clipped redraw and a clipped redraw has
+   * previously been queued for this actor then combine the latest
+   * clip together with the existing clip */
+  if (clip)
+    clutter_paint_volume_union (&entry->clip, clip);
+  else
+    {
+      clutter_paint_volume_free (&entry->clip);
+      entry->has_clip = FALSE;
+    }
+}
+
+/*< private >
+ * _clutter_stage_queue_redraw_entry_has_clip:
+ * @entry: an entry returned by _clutter_stage_queue_actor_redraw()
  *
- * One guide we had to steer the gap size we support is the
- * interactive test, test-texture-quality which expects to animate an
- * actor to +400 on the z axis with a stage size of 640x480. A gap
- * that's 85% of the stage height gives a gap of 408 in that case.
+ * Checks whether the redraw of @entry is clipped; further redraws of
+ * an actor whose whole redraw is already queued are no-ops.
  */
-static float
-calculate_z_translation (float z_near)
+gboolean
+_clutter_stage_queue_redraw_entry_has_clip (ClutterStageQueueRedrawEntry *entry)
 {
-  /* This solution uses fairly basic trigonometry, but is seems worth
-   * clarifying the particular geometry we are looking at in-case
-   * anyone wants to develop this further later. Not sure how well an
-   * ascii diagram is going to work :-)
-   *
-   *    |--- stage_height ---|
-   *    |     stage line     |
-   *   ╲━━━━━━━━━━━━━━━━━━━━━╱------------
-   *    ╲.  (2)   │        .╱       |   |
-   *   C ╲ .      │      . ╱     gap|   |
-   * =0.5°╲  . a  │    .  ╱         |   |
-   *      b╲(1). D│  .   ╱          |   |
-   *        ╲   B.│.    ╱near plane |   |
-   *      A= ╲━━━━━━━━━╱-------------   |
-   *     120° ╲ c │   ╱  |            z_2d
-   *           ╲  │  ╱  z_near          |
-   *       left ╲ │ ╱    |              |
-   *       clip  60°fovy |              |
-   *       plane  ╳----------------------
-   *              |
-   *              |
-   *         origin line
-   *
-   * The area of interest is the triangle labeled (1) at the top left
-   * marked with the ... line (a) from where the origin line crosses
-   * the near plane to the top left where the stage line cross the
-   * left clip plane.
-   *
-   * The sides of the triangle are a, b and c and the corresponding
-   * angles opposite those sides are A, B and C.
-   *
-   * The angle of C is what trades off the gap size we have relative
-   * to the stage size vs the depth precision we have.
-   *
-   * As mentioned above we arove at the angle for C is by working
-   * backwards from how much space we want for test-texture-quality.
-   * With a stage_height of 480 we want a gap > 400, ideally we also
-   * wanted a somewhat round number as a percentage of the height for
-   * documentation purposes. ~87% or a gap of ~416 is the limit
-   * because that's where we approach a C angle of 0° and effectively
-   * loose all depth precision.
-   *
-   * So for our test app with a stage_height of 480 if we aim for a
-   * gap of 408 (85% of 480) we can get the angle D as
-   * atan (stage_height/2/408) = 30.5°.
-   *
-   * That gives us the angle for B as 90° - 30.5° = 59.5°
-   *
-   * We can already determine that A has an angle of (fovy/2 + 90°) =
-   * 120°
-   *
-   * Therefore C = 180 - A - B = 0.5°
-   *
-   * The length of c = z_near * tan (30°)
-   *
-   * Now we can use the rule a/SinA = c/SinC to calculate the
-   * length of a. After some rearranging that gives us:
-   *
-   *      a              c
-   *  ----------  =  ----------
-   *  sin (120°)     sin (0.5°)
-   *
-   *      c * sin (120°)
-   *  a = --------------
-   *        sin (0.5°)
-   *
-   * And with that we can determine z_2d = cos (D) * a =
-   * cos (30.5°) * a + z_near:
-   *
-   *         c * sin (120°) * cos (30.5°)
-   *  z_2d = --------------------------- + z_near
-   *                 sin (0.5°)
-   */
+  return entry->has_clip;
+}
 
-   /* We expect the compiler should boil this down to z_near * CONSTANT
-    * already, but just in case we use precomputed constants
-    */
-#if 0
-# define A      tanf (_DEG_TO_RAD (30.f))
-# define B      sinf (_DEG_TO_RAD (120.f))
-# define C      cosf (_DEG_TO_RAD (30.5f))
-# define D      sinf (_DEG_TO_RAD (.5f))
-#else
-# define A      0.57735025882720947265625f
-# define B      0.866025388240814208984375f
-# define C      0.86162912845611572265625f
-# define D      0.00872653536498546600341796875f
-#endif
+/* releases the actor and the clip of @entry, and puts it back in the
+ * pool of @stage; the entry must not be referenced by its actor */
+static void
+free_queue_redraw_entry (ClutterStage                 *stage,
+                         ClutterStageQueueRedrawEntry *entry)
+{
+  ClutterStagePrivate *priv = stage->priv;
 
-  return z_near
-       * A * B * C
-       / D
-       + z_near;
+  if (entry->actor)
+    g_object_unref (entry->actor);
+  if (entry->has_clip)
+    clutter_paint_volume_free (&entry->clip);
+
+  if (priv->n_free_queue_redraws < QUEUE_REDRAW_ENTRY_POOL_SIZE)
+    {
+      entry->actor = NULL;
+      entry->has_clip = FALSE;
+      entry->next = priv->free_queue_redraws;
+      priv->free_queue_redraws = entry;
+      priv->n_free_queue_redraws += 1;
+    }
+  else
+    g_slice_free (ClutterStageQueueRedrawEntry, entry);
 }
 
-void
-_clutter_stage_maybe_setup_viewport (ClutterStage *stage)
+/* frees the pending queue redraw entries, and the pool */
+static void
+clear_queue_redraw_entries (ClutterStage *stage)
 {
   ClutterStagePrivate *priv = stage->priv;
+  ClutterStageQueueRedrawEntry *entry, *next;
 
-  if (priv->dirty_viewport)
+  for (entry = priv->pending_queue_redraws; entry != NULL; entry = next)
     {
-      ClutterPerspective perspective;
-      int window_scale;
-      float z_2d;
+      next = entry->next;
+      free_queue_redraw_entry (stage, entry);
+    }
 
-      CLUTTER_NOTE (PAINT,
-                    "Setting up the viewport { w:%f, h:%f }",
-                    priv->viewport[2],
-                    priv->viewport[3]);
+  priv->pending_queue_redraws = NULL;
 
-      window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+  for (entry = priv->free_queue_redraws; entry != NULL; entry = next)
+    {
+      next = entry->next;
+      g_slice_free (ClutterStageQueueRedrawEntry, entry);
+    }
 
-      cogl_set_viewport (priv->viewport[0] * window_scale,
-                         priv->viewport[1] * window_scale,
-                         priv->viewport[2] * window_scale,
-                         priv->viewport[3] * window_scale);
+  priv->free_queue_redraws = NULL;
+  priv->n_free_queue_redraws = 0;
+}
 
-      perspective = priv->perspective;
+void
+_clutter_stage_queue_redraw_entry_invalidate (ClutterStageQueueRedrawEntry *entry)
+{
+  if (entry == NULL)
+    return;
 
-      /* Ideally we want to regenerate the perspective matrix whenever
-       * the size changes but if the user has provided a custom matrix
-       * then we don't want to override it */
-      if (!priv->has_custom_perspective)
+  if (entry->actor != NULL)
+    {
+      g_object_unref (entry->actor);
+      entry->actor = NULL;
+    }
+
+  if (entry->has_clip)
+    {
+      clutter_paint_volume_free (&entry->clip);
+      entry->has_clip = FALSE;
+    }
+}
+
+static void
+clutter_stage_maybe_finish_queue_redraws (ClutterStage *stage)
+{
+  /* Note: we have to repeat until the pending_queue_redraws list is
+   * empty because actors are allowed to queue redraws in response to
+   * the queue-redraw signal. For example Clone actors or
+   * texture_new_from_actor actors will have to queue a redraw if
+   * their source queues a redraw.
+   */
+  while (stage->priv->pending_queue_redraws)
+    {
+      ClutterStageQueueRedrawEntry *entry, *next;
+      /* XXX: we need to allow stage->priv->pending_queue_redraws to
+       * be updated while we process the current entries in the list
+       * so we steal the list pointer and then reset it to an empty
+       * list before processing... */
+      ClutterStageQueueRedrawEntry *stolen_list =
+        stage->priv->pending_queue_redraws;
+      stage->priv->pending_queue_redraws = NULL;
+
+      for (entry = stolen_list; entry != NULL; entry = next)
         {
-          perspective.aspect = priv->viewport[2] / priv->viewport[3];
-          z_2d = calculate_z_translation (perspective.z_near);
+          ClutterPaintVolume *clip;
 
-          /* NB: z_2d is only enough room for 85% of the stage_height between
-           * the stage and the z_near plane. For behind the stage plane we
-           * want a more consistent gap of 10 times the stage_height before
-           * hitting the far plane so we calculate that relative to the final
-           * height of the stage plane at the z_2d_distance we got... */
-          perspective.z_far = z_2d +
-            tanf (_DEG_TO_RAD (perspective.fovy / 2.0f)) * z_2d * 20.0f;
+          next = entry->next;
 
-          clutter_stage_set_perspective_internal (stage, &perspective);
+          /* NB: Entries may be invalidated if the actor gets destroyed */
+          if (G_LIKELY (entry->actor != NULL))
+	    {
+	      clip = entry->has_clip ? &entry->clip : NULL;
+
+	      _clutter_actor_finish_queue_redraw (entry->actor, clip);
+	    }
+
+          free_queue_redraw_entry (stage, entry);
         }
-      else
-        z_2d = calculate_z_translation (perspective.z_near);
+    }
+}
 
-      cogl_matrix_init_identity (&priv->view);
-      cogl_matrix_view_2d_in_perspective (&priv->view,
-                                          perspective.fovy,
-                                          perspective.aspect,
-                                          perspective.z_near,
-                                          z_2d,
-                                          priv->viewport[2] * window_scale,
-                                          priv->viewport[3] * window_scale);
+/**
+ * clutter_stage_set_accept_focus:
+ * @stage: a #ClutterStage
+ * @accept_focus: %TRUE to accept focus on show
+ *
+ * Sets whether the @stage should accept the key focus when shown.
+ *
+ * This function should be called before showing @stage using
+ * clutter_actor_show().
+ *
+ * Since: 1.6
+ */
+void
+clutter_stage_set_accept_focus (ClutterStage *stage,
+                                gboolean      accept_focus)
+{
+  ClutterStagePrivate *priv;
 
-      clutter_stage_apply_scale (stage);
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-      priv->dirty_viewport = FALSE;
-    }
+  accept_focus = !!accept_focus;
 
-  if (priv->dirty_projection)
+  priv = stage->priv;
+
+  if (priv->accept_focus != accept_focus)
     {
-      cogl_set_projection_matrix (&priv->projection);
+      _clutter_stage_window_set_accept_focus (priv->impl, accept_focus);
+      g_object_notify (G_OBJECT (stage), "accept-focus");
+    }
+}
+
+/**
+ * clutter_stage_get_accept_focus:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_accept_focus().
+ *
+ * Return value: %TRUE if the #ClutterStage should accept focus, and %FALSE
+ *   otherwise
+ *
+ * Since: 1.6
+ */
+gboolean
+clutter_stage_get_accept_focus (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), TRUE);
 
-      priv->dirty_projection = FALSE;
-    }
+  return stage->priv->accept_focus;
 }
 
-#undef _DEG_TO_RAD
-
 /**
- * clutter_stage_ensure_redraw:
+ * clutter_stage_set_motion_events_enabled:
  * @stage: a #ClutterStage
+ * @enabled: %TRUE to enable the motion events delivery, and %FALSE
+ *   otherwise
  *
- * Ensures that @stage is redrawn
+ * Sets whether per-actor motion events (and relative crossing
+ * events) should be disabled or not.
  *
- * This function should not be called by applications: it is
- * used when embedding a #ClutterStage into a toolkit with
- * another windowing system, like GTK+.
+ * The default is %TRUE.
  *
- * Since: 1.0
+ * If @enable is %FALSE the following signals will not be emitted
+ * by the actors children of @stage:
+ *
+ *  - #ClutterActor::motion-event
+ *  - #ClutterActor::enter-event
+ *  - #ClutterActor::leave-event
+ *
+ * The events will still be delivered to the #ClutterStage.
+ *
+ * The main side effect of this function is that disabling the motion
+ * events will disable picking to detect the #ClutterActor underneath
+ * the pointer for each motion event. This is useful, for instance,
+ * when dragging a #ClutterActor across the @stage: the actor underneath
+ * the pointer is not going to change, so it's meaningless to perform
+ * a pick.
+ *
+ * Since: 1.8
  */
 void
-clutter_stage_ensure_redraw (ClutterStage *stage)
+clutter_stage_set_motion_events_enabled (ClutterStage *stage,
+                                         gboolean      enabled)
 {
-  ClutterMasterClock *master_clock;
   ClutterStagePrivate *priv;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
 
-  if (!priv->relayout_pending && !priv->redraw_pending)
-    _clutter_stage_schedule_update (stage);
+  enabled = !!enabled;
 
-  priv->relayout_pending = TRUE;
-  priv->redraw_pending = TRUE;
+  if (priv->motion_events_enabled != enabled)
+    priv->motion_events_enabled = enabled;
+}
 
-  master_clock = _clutter_master_clock_get_default ();
-  _clutter_master_clock_start_running (master_clock);
+/**
+ * clutter_stage_get_motion_events_enabled:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set using clutter_stage_set_motion_events_enabled().
+ *
+ * Return value: %TRUE if the per-actor motion event delivery is enabled
+ *   and %FALSE otherwise
+ *
+ * Since: 1.8
+ */
+gboolean
+clutter_stage_get_motion_events_enabled (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->motion_events_enabled;
 }
 
 /**
- * clutter_stage_queue_redraw:
- * @stage: the #ClutterStage
+ * clutter_stage_set_geometric_picking:
+ * @stage: a #ClutterStage
+ * @enabled: %TRUE to enable geometric picking
  *
- * Queues a redraw for the passed stage.
+ * Sets whether @stage should find the actor underneath a point by
+ * hit testing the transformed allocation of each actor on the CPU,
+ * instead of painting the scene in pick mode and reading back the
+ * color of a pixel from the GPU.
  *
- * Applications should call clutter_actor_queue_redraw() and not
- * this function.
+ * Geometric picking avoids flushing the GPU pipeline and stalling on
+ * the read back for every pick. Actors overriding the
+ * #ClutterActorClass.pick virtual function, or that have effects
+ * overriding the #ClutterEffectClass.pick virtual function, cannot be
+ * reliably described by a rectangle; if any of those are painted,
+ * the stage will transparently fall back to the color-based picking.
  *
- * Since: 0.8
+ * The default is %FALSE.
  *
- * Deprecated: 1.10: Use clutter_actor_queue_redraw() instead.
+ * Since: 1.26
  */
 void
-clutter_stage_queue_redraw (ClutterStage *stage)
+clutter_stage_set_geometric_picking (ClutterStage *stage,
+                                     gboolean      enabled)
 {
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+  stage->priv->geometric_picking = !!enabled;
 }
 
 /**
- * clutter_stage_is_default:
+ * clutter_stage_get_geometric_picking:
  * @stage: a #ClutterStage
  *
- * Checks if @stage is the default stage, or an instance created using
- * clutter_stage_new() but internally using the same implementation.
- *
- * Return value: %TRUE if the passed stage is the default one
+ * Retrieves the value set using clutter_stage_set_geometric_picking().
  *
- * Since: 0.8
+ * Return value: %TRUE if geometric picking is enabled
  *
- * Deprecated: 1.10: Track the stage pointer inside your application
- *   code, or use clutter_actor_get_stage() to retrieve the stage for
- *   a given actor.
+ * Since: 1.26
  */
 gboolean
-clutter_stage_is_default (ClutterStage *stage)
+clutter_stage_get_geometric_picking (ClutterStage *stage)
 {
   g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  return stage_is_default (stage);
+  return stage->priv->geometric_picking;
 }
 
+/**
+ * clutter_stage_set_collect_frame_info:
+ * @stage: a #ClutterStage
+ * @collect: whether to collect the timing information of each frame
+ *
+ * Sets whether @stage should collect the timing information of each
+ * frame it paints: the time spent processing events, advancing the
+ * timelines, laying out, painting and picking, as well as the swap and
+ * presentation times, when available.
+ *
+ * Each frame is delivered through the #ClutterStage::frame-info signal,
+ * and the last frames can be retrieved at any time using
+ * clutter_stage_get_frame_info_history().
+ *
+ * Disabling the collection drops the history.
+ *
+ * The default is %FALSE.
+ *
+ * Since: 1.26
+ */
 void
-_clutter_stage_set_window (ClutterStage       *stage,
-                           ClutterStageWindow *stage_window)
+clutter_stage_set_collect_frame_info (ClutterStage *stage,
+                                      gboolean      collect)
 {
+  ClutterStagePrivate *priv;
+
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail (CLUTTER_IS_STAGE_WINDOW (stage_window));
 
-  if (stage->priv->impl != NULL)
-    g_object_unref (stage->priv->impl);
+  priv = stage->priv;
 
-  stage->priv->impl = stage_window;
+  collect = !!collect;
+
+  if (priv->collect_frame_info == collect)
+    return;
+
+  priv->collect_frame_info = collect;
+
+  if (collect)
+    priv->frame_history = g_new0 (ClutterFrameInfo, FRAME_HISTORY_SIZE);
+  else
+    g_clear_pointer (&priv->frame_history, g_free);
+
+  priv->in_frame = FALSE;
+  priv->frame_history_next = 0;
+  priv->frame_history_len = 0;
+  priv->n_frames_pending = 0;
 }
 
-ClutterStageWindow *
-_clutter_stage_get_window (ClutterStage *stage)
+/**
+ * clutter_stage_get_collect_frame_info:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set using clutter_stage_set_collect_frame_info().
+ *
+ * Return value: %TRUE if the stage collects the frame timings
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_stage_get_collect_frame_info (ClutterStage *stage)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  return CLUTTER_STAGE_WINDOW (stage->priv->impl);
+  return stage->priv->collect_frame_info;
 }
 
-ClutterStageWindow *
-_clutter_stage_get_default_window (void)
+/**
+ * clutter_stage_get_frame_info_history:
+ * @stage: a #ClutterStage
+ * @frames: (out caller-allocates) (array length=n_frames): return
+ *   location for the frames
+ * @n_frames: the number of frames that @frames can hold
+ *
+ * Copies the timing information of the most recently collected frames
+ * of @stage into @frames, from the oldest to the newest.
+ *
+ * The stage keeps the last 128 frames.
+ *
+ * Return value: the number of frames copied into @frames
+ *
+ * Since: 1.26
+ */
+guint
+clutter_stage_get_frame_info_history (ClutterStage     *stage,
+                                      ClutterFrameInfo *frames,
+                                      guint             n_frames)
 {
-  ClutterStageManager *manager = clutter_stage_manager_get_default ();
-  ClutterStage *stage;
+  ClutterStagePrivate *priv;
+  guint i, first;
 
-  stage = clutter_stage_manager_get_default_stage (manager);
-  if (stage == NULL)
-    return NULL;
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), 0);
+  g_return_val_if_fail (frames != NULL || n_frames == 0, 0);
 
-  return _clutter_stage_get_window (stage);
+  priv = stage->priv;
+
+  n_frames = MIN (n_frames, priv->frame_history_len);
+
+  first = priv->frame_history_next + FRAME_HISTORY_SIZE - n_frames;
+  for (i = 0; i < n_frames; i++)
+    frames[i] = priv->frame_history[(first + i) % FRAME_HISTORY_SIZE];
+
+  return n_frames;
 }
 
 /**
- * clutter_stage_set_throttle_motion_events:
+ * clutter_stage_set_adaptive_quality:
  * @stage: a #ClutterStage
- * @throttle: %TRUE to throttle motion events
+ * @adaptive: whether the quality adapts to the frame budget
  *
- * Sets whether motion events received between redraws should
- * be throttled or not. If motion events are throttled, those
- * events received by the windowing system between redraws will
- * be compressed so that only the last event will be propagated
- * to the @stage and its actors.
+ * Sets whether @stage lowers the quality of its rendering when its
+ * frames keep going over the frame budget, and raises it again once
+ * the frames leave enough headroom.
  *
- * This function should only be used if you want to have all
- * the motion events delivered to your application code.
+ * The quality level is passed to the #ClutterEffectClass.set_quality()
+ * virtual function of the effects before they are painted: the
+ * offscreen effects paint at a lower resolution, #ClutterBlurEffect
+ * stops blurring and #ClutterDeformEffect uses fewer tiles. The
+ * textures of the contents are sampled without filtering from
+ * %CLUTTER_QUALITY_LOW.
  *
- * Since: 1.0
+ * Disabling the adaptive quality brings @stage back to
+ * %CLUTTER_QUALITY_FULL.
+ *
+ * The default is %FALSE.
+ *
+ * Since: 1.26
  */
 void
-clutter_stage_set_throttle_motion_events (ClutterStage *stage,
-                                          gboolean      throttle)
+clutter_stage_set_adaptive_quality (ClutterStage *stage,
+                                    gboolean      adaptive)
 {
   ClutterStagePrivate *priv;
 
@@ -3655,620 +7478,1040 @@ clutter_stage_set_throttle_motion_events (ClutterStage *stage,
 
   priv = stage->priv;
 
-  if (priv->throttle_motion_events != throttle)
-    priv->throttle_motion_events = throttle;
+  adaptive = !!adaptive;
+
+  if (priv->adaptive_quality == adaptive)
+    return;
+
+  priv->adaptive_quality = adaptive;
+  priv->last_presentation_time = 0;
+  priv->last_paint_end = 0;
+
+  if (!adaptive)
+    clutter_stage_set_quality_level (stage, CLUTTER_QUALITY_FULL);
 }
 
 /**
- * clutter_stage_get_throttle_motion_events:
+ * clutter_stage_get_adaptive_quality:
  * @stage: a #ClutterStage
  *
- * Retrieves the value set with clutter_stage_set_throttle_motion_events()
+ * Retrieves the value set using clutter_stage_set_adaptive_quality().
  *
- * Return value: %TRUE if the motion events are being throttled,
- *   and %FALSE otherwise
+ * Return value: %TRUE if the quality adapts to the frame budget
  *
- * Since: 1.0
+ * Since: 1.26
  */
 gboolean
-clutter_stage_get_throttle_motion_events (ClutterStage *stage)
+clutter_stage_get_adaptive_quality (ClutterStage *stage)
 {
   g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  return stage->priv->throttle_motion_events;
+  return stage->priv->adaptive_quality;
 }
 
 /**
- * clutter_stage_set_use_alpha:
+ * clutter_stage_set_frame_budget:
  * @stage: a #ClutterStage
- * @use_alpha: whether the stage should honour the opacity or the
- *   alpha channel of the stage color
+ * @budget: the time budget of a frame, in microseconds, or 0
  *
- * Sets whether the @stage should honour the #ClutterActor:opacity and
- * the alpha channel of the #ClutterStage:color
+ * Sets the time a frame of @stage can take before the adaptive
+ * quality is lowered; see clutter_stage_set_adaptive_quality().
  *
- * Since: 1.2
+ * If @budget is 0, the budget is the interval between two frames at
+ * the default frame rate.
+ *
+ * Since: 1.26
  */
 void
-clutter_stage_set_use_alpha (ClutterStage *stage,
-                             gboolean      use_alpha)
+clutter_stage_set_frame_budget (ClutterStage *stage,
+                                gint64        budget)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (budget >= 0);
+
+  stage->priv->frame_budget = budget;
+}
+
+/**
+ * clutter_stage_get_frame_budget:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the time budget of a frame of @stage.
+ *
+ * Return value: the budget, in microseconds
+ *
+ * Since: 1.26
+ */
+gint64
+clutter_stage_get_frame_budget (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), 0);
+
+  return clutter_stage_get_frame_budget_internal (stage);
+}
+
+/**
+ * clutter_stage_get_quality_level:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the current quality level of @stage; it is always
+ * %CLUTTER_QUALITY_FULL unless clutter_stage_set_adaptive_quality()
+ * was used.
+ *
+ * Return value: the quality level
+ *
+ * Since: 1.26
+ */
+ClutterQualityLevel
+clutter_stage_get_quality_level (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), CLUTTER_QUALITY_FULL);
+
+  return stage->priv->quality_level;
+}
+
+/**
+ * clutter_stage_set_dynamic_resolution:
+ * @stage: a #ClutterStage
+ * @min_scale: the lowest scale of the resolution, between 0.25 and 1.0
+ *
+ * Sets whether @stage is rendered at a reduced resolution when its
+ * frames keep going over the frame budget, for GPU limited devices.
+ *
+ * With a @min_scale lower than 1.0, the frame timings drive the scale
+ * of the resolution like they drive the adaptive quality, see
+ * clutter_stage_set_adaptive_quality(): the scale is lowered by steps
+ * down to @min_scale before the quality is lowered, and raised again
+ * after the quality is back to %CLUTTER_QUALITY_FULL. At a scale lower
+ * than 1.0, the stage is painted into an offscreen buffer of the size
+ * of the window multiplied by the scale, which is then stretched to
+ * the window; the size and the coordinates of the stage do not change.
+ *
+ * A @min_scale of 1.0 disables the dynamic resolution, which is the
+ * default.
+ *
+ * Since: 1.26
+ */
+void
+clutter_stage_set_dynamic_resolution (ClutterStage *stage,
+                                      gfloat        min_scale)
 {
   ClutterStagePrivate *priv;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (min_scale >= 0.25f && min_scale <= 1.f);
 
   priv = stage->priv;
 
-  if (priv->use_alpha != use_alpha)
+  if (priv->min_resolution_scale == min_scale)
+    return;
+
+  if (priv->min_resolution_scale >= 1.f)
     {
-      priv->use_alpha = use_alpha;
+      priv->last_presentation_time = 0;
+      priv->last_paint_end = 0;
+    }
 
-      clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+  priv->min_resolution_scale = min_scale;
 
-      g_object_notify (G_OBJECT (stage), "use-alpha");
-    }
+  if (priv->resolution_scale < min_scale)
+    clutter_stage_set_resolution_scale (stage, min_scale);
 }
 
 /**
- * clutter_stage_get_use_alpha:
+ * clutter_stage_get_dynamic_resolution:
  * @stage: a #ClutterStage
  *
- * Retrieves the value set using clutter_stage_set_use_alpha()
+ * Retrieves the value set using clutter_stage_set_dynamic_resolution().
  *
- * Return value: %TRUE if the stage should honour the opacity and the
- *   alpha channel of the stage color
+ * Return value: the lowest scale of the resolution
  *
- * Since: 1.2
+ * Since: 1.26
  */
-gboolean
-clutter_stage_get_use_alpha (ClutterStage *stage)
+gfloat
+clutter_stage_get_dynamic_resolution (ClutterStage *stage)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), 1.f);
 
-  return stage->priv->use_alpha;
+  return stage->priv->min_resolution_scale;
 }
 
 /**
- * clutter_stage_set_minimum_size:
+ * clutter_stage_get_resolution_scale:
  * @stage: a #ClutterStage
- * @width: width, in pixels
- * @height: height, in pixels
- *
- * Sets the minimum size for a stage window, if the default backend
- * uses #ClutterStage inside a window
  *
- * This is a convenience function, and it is equivalent to setting the
- * #ClutterActor:min-width and #ClutterActor:min-height on @stage
- *
- * If the current size of @stage is smaller than the minimum size, the
- * @stage will be resized to the new @width and @height
+ * Retrieves the scale of the resolution @stage is currently rendered
+ * at; it is always 1.0 unless clutter_stage_set_dynamic_resolution()
+ * was used.
  *
- * This function has no effect if @stage is fullscreen
+ * Return value: the scale of the resolution
  *
- * Since: 1.2
+ * Since: 1.26
  */
-void
-clutter_stage_set_minimum_size (ClutterStage *stage,
-                                guint         width,
-                                guint         height)
+gfloat
+clutter_stage_get_resolution_scale (ClutterStage *stage)
 {
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
-  g_return_if_fail ((width > 0) && (height > 0));
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), 1.f);
 
-  g_object_set (G_OBJECT (stage),
-                "min-width", (gfloat) width,
-                "min-height", (gfloat )height,
-                NULL);
+  return stage->priv->resolution_scale;
+}
+
+/*< private >
+ * _clutter_stage_get_resolution_scale:
+ * @stage: a #ClutterStage
+ *
+ * Unchecked version of clutter_stage_get_resolution_scale(), for the
+ * stage windows.
+ */
+gfloat
+_clutter_stage_get_resolution_scale (ClutterStage *stage)
+{
+  return stage->priv->resolution_scale;
 }
 
-/**
- * clutter_stage_get_minimum_size:
+/*< private >
+ * _clutter_stage_get_quality_level:
  * @stage: a #ClutterStage
- * @width: (out): return location for the minimum width, in pixels,
- *   or %NULL
- * @height: (out): return location for the minimum height, in pixels,
- *   or %NULL
- *
- * Retrieves the minimum size for a stage window as set using
- * clutter_stage_set_minimum_size().
- *
- * The returned size may not correspond to the actual minimum size and
- * it is specific to the #ClutterStage implementation inside the
- * Clutter backend
  *
- * Since: 1.2
+ * Unchecked version of clutter_stage_get_quality_level(), for the
+ * paint paths.
  */
-void
-clutter_stage_get_minimum_size (ClutterStage *stage,
-                                guint        *width_p,
-                                guint        *height_p)
+ClutterQualityLevel
+_clutter_stage_get_quality_level (ClutterStage *stage)
 {
-  gfloat width, height;
-  gboolean width_set, height_set;
+  return stage->priv->quality_level;
+}
 
-  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+static void
+clutter_stage_report_actor_memory (ClutterActor       *actor,
+                                   int                 depth,
+                                   GHashTable         *contents,
+                                   ClutterMemoryUsage *totals,
+                                   GString            *report)
+{
+  ClutterMemoryUsage usage;
+  ClutterActor *child;
+  gsize total;
 
-  g_object_get (G_OBJECT (stage),
-                "min-width", &width,
-                "min-width-set", &width_set,
-                "min-height", &height,
-                "min-height-set", &height_set,
-                NULL);
+  _clutter_actor_get_memory_usage (actor, contents, &usage);
 
-  /* if not width or height have been set, then the Stage
-   * minimum size is defined to be 1x1
-   */
-  if (!width_set)
-    width = 1;
+  total = usage.offscreen_effects
+        + usage.images
+        + usage.canvases
+        + usage.text_layouts
+        + usage.paint_nodes;
 
-  if (!height_set)
-    height = 1;
+  if (total > 0)
+    {
+      g_string_append_printf (report,
+                              "%*s%s: %" G_GSIZE_FORMAT " bytes "
+                              "(effects: %" G_GSIZE_FORMAT ", "
+                              "image: %" G_GSIZE_FORMAT ", "
+                              "canvas: %" G_GSIZE_FORMAT ", "
+                              "text: %" G_GSIZE_FORMAT ", "
+                              "paint nodes: %" G_GSIZE_FORMAT ")\n",
+                              depth * 2, "",
+                              _clutter_actor_get_debug_name (actor),
+                              total,
+                              usage.offscreen_effects,
+                              usage.images,
+                              usage.canvases,
+                              usage.text_layouts,
+                              usage.paint_nodes);
+    }
 
-  if (width_p)
-    *width_p = (guint) width;
+  totals->offscreen_effects += usage.offscreen_effects;
+  totals->images += usage.images;
+  totals->canvases += usage.canvases;
+  totals->text_layouts += usage.text_layouts;
+  totals->paint_nodes += usage.paint_nodes;
 
-  if (height_p)
-    *height_p = (guint) height;
+  for (child = clutter_actor_get_first_child (actor);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    clutter_stage_report_actor_memory (child, depth + 1, contents, totals, report);
 }
 
-void
-_clutter_stage_schedule_update (ClutterStage *stage)
+/**
+ * clutter_stage_get_memory_report:
+ * @stage: a #ClutterStage
+ *
+ * Builds a human readable report of the memory held by the actors of
+ * @stage and by the caches shared by all the stages.
+ *
+ * For each actor holding memory, the report lists the estimated size
+ * of the offscreen buffers of its effects, the textures and buffers of
+ * its #ClutterImage or #ClutterCanvas content, the cached layouts of a
+ * #ClutterText, and the retained paint nodes; the actors are indented
+ * by their depth in the scene graph. A content shared by several
+ * actors is only counted for the first of them.
+ *
+ * The report ends with the totals for each kind of resource, and the
+ * sizes of the pool of offscreen buffers of @stage, of the cache of
+ * images, of the cache of text layouts and of the distance field
+ * glyph cache.
+ *
+ * The sizes are estimates, assuming 4 bytes per pixel for textures;
+ * the glyph cache of CoglPango is not included.
+ *
+ * Return value: (transfer full): the report; use g_free() when done
+ *
+ * Since: 1.26
+ */
+gchar *
+clutter_stage_get_memory_report (ClutterStage *stage)
 {
-  ClutterStageWindow *stage_window;
+  ClutterStagePrivate *priv;
+  ClutterMemoryUsage totals = { 0, };
+  GHashTable *contents;
+  GString *report;
+  gsize pool_bytes = 0;
+  guint n_borrowed = 0, n_idle = 0;
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
-    return;
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
 
-  stage_window = _clutter_stage_get_window (stage);
-  if (stage_window == NULL)
-    return;
+  priv = stage->priv;
 
-  return _clutter_stage_window_schedule_update (stage_window,
-                                                stage->priv->sync_delay);
+  report = g_string_new (NULL);
+  g_string_append_printf (report, "Memory report for stage '%s':\n",
+                          _clutter_actor_get_debug_name (CLUTTER_ACTOR (stage)));
+
+  contents = g_hash_table_new (NULL, NULL);
+  clutter_stage_report_actor_memory (CLUTTER_ACTOR (stage), 1,
+                                     contents,
+                                     &totals,
+                                     report);
+  g_hash_table_unref (contents);
+
+  if (priv->offscreen_pool != NULL)
+    _clutter_offscreen_pool_get_stats (priv->offscreen_pool,
+                                       &n_borrowed,
+                                       &n_idle,
+                                       &pool_bytes);
+
+  g_string_append_printf (report,
+                          "Totals:\n"
+                          "  offscreen effects: %" G_GSIZE_FORMAT " bytes\n"
+                          "  images: %" G_GSIZE_FORMAT " bytes\n"
+                          "  canvases: %" G_GSIZE_FORMAT " bytes\n"
+                          "  text layouts: %" G_GSIZE_FORMAT " bytes\n"
+                          "  paint nodes: %" G_GSIZE_FORMAT " bytes\n"
+                          "  offscreen pool: %" G_GSIZE_FORMAT " bytes "
+                          "(%u borrowed, %u idle targets)\n"
+                          "  image cache: %" G_GSIZE_FORMAT " bytes\n"
+                          "  image atlases: %" G_GSIZE_FORMAT " bytes\n"
+                          "  text layout cache: %" G_GSIZE_FORMAT " bytes\n"
+                          "  distance field glyph cache: %" G_GSIZE_FORMAT " bytes\n",
+                          totals.offscreen_effects,
+                          totals.images,
+                          totals.canvases,
+                          totals.text_layouts,
+                          totals.paint_nodes,
+                          pool_bytes, n_borrowed, n_idle,
+                          _clutter_image_cache_get_size (),
+                          _clutter_image_atlas_get_size (),
+                          _clutter_text_layout_cache_get_size (),
+                          _clutter_sdf_glyph_cache_get_size ());
+
+  return g_string_free (report, FALSE);
 }
 
-/* Returns the earliest time the stage is ready to update */
-gint64
-_clutter_stage_get_update_time (ClutterStage *stage)
+static void
+clutter_stage_sum_actor_memory (ClutterActor       *actor,
+                                GHashTable         *contents,
+                                ClutterMemoryUsage *totals)
 {
-  ClutterStageWindow *stage_window;
+  ClutterMemoryUsage usage;
+  ClutterActor *child;
 
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
-    return 0;
+  _clutter_actor_get_memory_usage (actor, contents, &usage);
 
-  stage_window = _clutter_stage_get_window (stage);
-  if (stage_window == NULL)
-    return 0;
+  totals->offscreen_effects += usage.offscreen_effects;
+  totals->images += usage.images;
+  totals->canvases += usage.canvases;
+  totals->text_layouts += usage.text_layouts;
+  totals->paint_nodes += usage.paint_nodes;
 
-  return _clutter_stage_window_get_update_time (stage_window);
+  for (child = clutter_actor_get_first_child (actor);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    clutter_stage_sum_actor_memory (child, contents, totals);
 }
 
+/*< private >
+ * _clutter_stage_get_memory_usage:
+ * @stage: a #ClutterStage
+ * @gpu_bytes: (out): return location for the memory held in textures
+ * @cpu_bytes: (out): return location for the memory held by the CPU
+ *
+ * Sums the totals of clutter_stage_get_memory_report(), splitting them
+ * between the textures and buffers, and the layouts and paint nodes.
+ */
 void
-_clutter_stage_clear_update_time (ClutterStage *stage)
+_clutter_stage_get_memory_usage (ClutterStage *stage,
+                                 gsize        *gpu_bytes,
+                                 gsize        *cpu_bytes)
 {
-  ClutterStageWindow *stage_window;
-
-  stage_window = _clutter_stage_get_window (stage);
-  if (stage_window)
-    _clutter_stage_window_clear_update_time (stage_window);
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterMemoryUsage totals = { 0, };
+  GHashTable *contents;
+  gsize pool_bytes = 0;
+  guint n_borrowed, n_idle;
+
+  contents = g_hash_table_new (NULL, NULL);
+  clutter_stage_sum_actor_memory (CLUTTER_ACTOR (stage), contents, &totals);
+  g_hash_table_unref (contents);
+
+  if (priv->offscreen_pool != NULL)
+    _clutter_offscreen_pool_get_stats (priv->offscreen_pool,
+                                       &n_borrowed,
+                                       &n_idle,
+                                       &pool_bytes);
+
+  *gpu_bytes = totals.offscreen_effects
+             + totals.images
+             + totals.canvases
+             + pool_bytes
+             + _clutter_image_cache_get_size ()
+             + _clutter_image_atlas_get_size ()
+             + _clutter_sdf_glyph_cache_get_size ();
+
+  *cpu_bytes = totals.text_layouts
+             + totals.paint_nodes
+             + _clutter_text_layout_cache_get_size ();
 }
 
 /**
- * clutter_stage_set_no_clear_hint:
+ * clutter_stage_set_show_hud:
  * @stage: a #ClutterStage
- * @no_clear: %TRUE if the @stage should not clear itself on every
- *   repaint cycle
- *
- * Sets whether the @stage should clear itself at the beginning
- * of each paint cycle or not.
+ * @show: whether to show the performance overlay
  *
- * Clearing the #ClutterStage can be a costly operation, especially
- * if the stage is always covered - for instance, in a full-screen
- * video player or in a game with a background texture.
+ * Sets whether @stage should draw a performance overlay on top of its
+ * contents: a graph of the time spent in each phase of the last frames
+ * against the frame budget, the frame rate and the number of missed
+ * frames, the memory held by @stage, as reported by
+ * clutter_stage_get_memory_report(), and the number of actors painted
+ * and culled by the last paint.
  *
- * This setting is a hint; Clutter might discard this hint
- * depending on its internal state.
+ * The overlay is only updated when @stage is redrawn. It does not cost
+ * anything while it is hidden.
  *
- * If parts of the stage are visible and you disable clearing you
- * might end up with visual artifacts while painting the contents of
- * the stage.
+ * The default is %FALSE, unless the `CLUTTER_SHOW_HUD` environment
+ * variable is set; on Android, touching the screen with four fingers
+ * toggles the overlay of the default stage.
  *
- * Since: 1.4
+ * Since: 1.26
  */
 void
-clutter_stage_set_no_clear_hint (ClutterStage *stage,
-                                 gboolean      no_clear)
+clutter_stage_set_show_hud (ClutterStage *stage,
+                            gboolean      show)
 {
   ClutterStagePrivate *priv;
-  ClutterStageHint new_hints;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
-  new_hints = priv->stage_hints;
-
-  if (no_clear)
-    new_hints |= CLUTTER_STAGE_NO_CLEAR_ON_PAINT;
-  else
-    new_hints &= ~CLUTTER_STAGE_NO_CLEAR_ON_PAINT;
 
-  if (priv->stage_hints == new_hints)
+  if ((priv->hud != NULL) == !!show)
     return;
 
-  priv->stage_hints = new_hints;
+  if (show)
+    priv->hud = _clutter_stage_hud_new ();
+  else
+    g_clear_pointer (&priv->hud, _clutter_stage_hud_free);
 
-  g_object_notify (G_OBJECT (stage), "no-clear-hint");
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
 }
 
 /**
- * clutter_stage_get_no_clear_hint:
+ * clutter_stage_get_show_hud:
  * @stage: a #ClutterStage
  *
- * Retrieves the hint set with clutter_stage_set_no_clear_hint()
+ * Retrieves the value set using clutter_stage_set_show_hud().
  *
- * Return value: %TRUE if the stage should not clear itself on every paint
- *   cycle, and %FALSE otherwise
+ * Return value: %TRUE if the performance overlay is shown
  *
- * Since: 1.4
+ * Since: 1.26
  */
 gboolean
-clutter_stage_get_no_clear_hint (ClutterStage *stage)
+clutter_stage_get_show_hud (ClutterStage *stage)
 {
   g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  return (stage->priv->stage_hints & CLUTTER_STAGE_NO_CLEAR_ON_PAINT) != 0;
+  return stage->priv->hud != NULL;
 }
 
-ClutterPaintVolume *
-_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage)
+/* NB: The presumption shouldn't be that a stage can't be comprised
+ * of multiple internal framebuffers, so instead of simply naming
+ * this function _clutter_stage_get_framebuffer(), the "active"
+ * infix is intended to clarify that it gets the framebuffer that
+ * is currently in use/being painted.
+ */
+CoglFramebuffer *
+_clutter_stage_get_active_framebuffer (ClutterStage *stage)
+{
+  return stage->priv->active_framebuffer;
+}
+
+/*< private >
+ * _clutter_stage_get_offscreen_pool:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the pool of render targets shared by the offscreen effects
+ * of the actors of @stage.
+ *
+ * Return value: (transfer none): the pool of @stage
+ */
+ClutterOffscreenPool *
+_clutter_stage_get_offscreen_pool (ClutterStage *stage)
 {
-  GArray *paint_volume_stack = stage->priv->paint_volume_stack;
+  ClutterStagePrivate *priv = stage->priv;
 
-  g_array_set_size (paint_volume_stack,
-                    paint_volume_stack->len+1);
+  if (priv->offscreen_pool == NULL)
+    priv->offscreen_pool = _clutter_offscreen_pool_new ();
 
-  return &g_array_index (paint_volume_stack,
-                         ClutterPaintVolume,
-                         paint_volume_stack->len - 1);
+  return priv->offscreen_pool;
 }
 
+/*< private >
+ * _clutter_stage_set_paint_recorder:
+ * @stage: a #ClutterStage
+ * @recorder: (allow-none): a #ClutterPaintRecorder, or %NULL
+ *
+ * Sets the recorder of the frames of @stage. The stage does not hold
+ * a reference on @recorder, which unsets itself when disposed.
+ */
 void
-_clutter_stage_paint_volume_stack_free_all (ClutterStage *stage)
+_clutter_stage_set_paint_recorder (ClutterStage         *stage,
+                                   ClutterPaintRecorder *recorder)
 {
-  GArray *paint_volume_stack = stage->priv->paint_volume_stack;
-  int i;
+  stage->priv->paint_recorder = recorder;
+}
+
+ClutterPaintRecorder *
+_clutter_stage_get_paint_recorder (ClutterStage *stage)
+{
+  return stage->priv->paint_recorder;
+}
+
+static ClutterActorTraverseVisitFlags
+release_resources_cb (ClutterActor *actor,
+                      gint          depth,
+                      gpointer      user_data)
+{
+  _clutter_actor_release_resources (actor, GPOINTER_TO_UINT (user_data));
 
-  for (i = 0; i < paint_volume_stack->len; i++)
+  return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
+}
+
+/*< private >
+ * _clutter_stage_trim_memory:
+ * @stage: a #ClutterStage
+ * @flags: the resources to release
+ *
+ * Releases the resources described by @flags held by @stage and by
+ * its actors; see clutter_trim_memory().
+ */
+void
+_clutter_stage_trim_memory (ClutterStage           *stage,
+                            ClutterTrimMemoryFlags  flags)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  _clutter_actor_traverse (CLUTTER_ACTOR (stage),
+                           CLUTTER_ACTOR_TRAVERSE_DEPTH_FIRST,
+                           release_resources_cb,
+                           NULL,
+                           GUINT_TO_POINTER (flags));
+
+  if (flags & CLUTTER_TRIM_MEMORY_OFFSCREEN_TARGETS)
     {
-      ClutterPaintVolume *pv =
-        &g_array_index (paint_volume_stack, ClutterPaintVolume, i);
-      clutter_paint_volume_free (pv);
+      /* the targets of the effects were given back to the pool above */
+      if (priv->offscreen_pool != NULL)
+        _clutter_offscreen_pool_release_idle (priv->offscreen_pool);
+
+      g_clear_pointer (&priv->pick_offscreen, cogl_object_unref);
+      g_clear_pointer (&priv->pick_texture, cogl_object_unref);
     }
+}
+
+gint32
+_clutter_stage_acquire_pick_id (ClutterStage *stage,
+                                ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_assert (priv->pick_id_pool != NULL);
 
-  g_array_set_size (paint_volume_stack, 0);
+  return _clutter_id_pool_add (priv->pick_id_pool, actor);
 }
 
-/* The is an out-of-band paramater available while painting that
- * can be used to cull actors. */
-const ClutterPlane *
-_clutter_stage_get_clip (ClutterStage *stage)
+void
+_clutter_stage_release_pick_id (ClutterStage *stage,
+                                gint32        pick_id)
 {
-  return stage->priv->current_clip_planes;
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_assert (priv->pick_id_pool != NULL);
+
+  _clutter_id_pool_remove (priv->pick_id_pool, pick_id);
 }
 
-/* When an actor queues a redraw we add it to a list on the stage that
- * gets processed once all updates to the stage have been finished.
+ClutterActor *
+_clutter_stage_get_actor_by_pick_id (ClutterStage *stage,
+                                     gint32        pick_id)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_assert (priv->pick_id_pool != NULL);
+
+  return _clutter_id_pool_lookup (priv->pick_id_pool, pick_id);
+}
+
+/*< private >
+ * _clutter_stage_add_visibility_tracker:
+ * @stage: a #ClutterStage
+ * @actor: a mapped #ClutterActor inside @stage
  *
- * This deferred approach to processing queue_redraw requests means
- * that we can avoid redundant transformations of clip volumes if
- * something later triggers a full stage redraw anyway. It also means
- * we can be more sure that all the referenced actors will have valid
- * allocations improving the chance that we can determine the actors
- * paint volume so we can clip the redraw request even if the user
- * didn't explicitly do so.
+ * Adds @actor to the actors whose #ClutterActor:on-screen property
+ * is updated at the end of each frame of @stage.
  */
-ClutterStageQueueRedrawEntry *
-_clutter_stage_queue_actor_redraw (ClutterStage *stage,
-                                   ClutterStageQueueRedrawEntry *entry,
-                                   ClutterActor *actor,
-                                   ClutterPaintVolume *clip)
+void
+_clutter_stage_add_visibility_tracker (ClutterStage *stage,
+                                       ClutterActor *actor)
 {
   ClutterStagePrivate *priv = stage->priv;
 
-  CLUTTER_NOTE (CLIPPING, "stage_queue_actor_redraw (actor=%s, clip=%p): ",
-                _clutter_actor_get_debug_name (actor), clip);
-
-  if (!priv->redraw_pending)
-    {
-      ClutterMasterClock *master_clock;
+  if (priv->visibility_trackers == NULL)
+    priv->visibility_trackers = g_hash_table_new (NULL, NULL);
 
-      CLUTTER_NOTE (PAINT, "First redraw request");
+  g_hash_table_add (priv->visibility_trackers, actor);
+}
 
-      _clutter_stage_schedule_update (stage);
-      priv->redraw_pending = TRUE;
+void
+_clutter_stage_remove_visibility_tracker (ClutterStage *stage,
+                                          ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
 
-      master_clock = _clutter_master_clock_get_default ();
-      _clutter_master_clock_start_running (master_clock);
-    }
-#ifdef CLUTTER_ENABLE_DEBUG
-  else
-    {
-      CLUTTER_NOTE (PAINT, "Redraw request number %lu",
-                    priv->redraw_count + 1);
+  if (priv->visibility_trackers != NULL)
+    g_hash_table_remove (priv->visibility_trackers, actor);
+}
 
-      priv->redraw_count += 1;
-    }
-#endif /* CLUTTER_ENABLE_DEBUG */
+/* updates the visibility of the tracked actors once the frame has been
+ * painted; the handlers of the notifications can change the set of
+ * tracked actors, so it is copied first
+ */
+static void
+clutter_stage_update_visibility (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  GHashTableIter iter;
+  gpointer actor;
+  GPtrArray *actors;
+  guint i;
 
-  if (entry)
-    {
-      /* Ignore all requests to queue a redraw for an actor if a full
-       * (non-clipped) redraw of the actor has already been queued. */
-      if (!entry->has_clip)
-        {
-          CLUTTER_NOTE (CLIPPING, "Bail from stage_queue_actor_redraw (%s): "
-                        "Unclipped redraw of actor already queued",
-                        _clutter_actor_get_debug_name (actor));
-          return entry;
-        }
+  if (priv->visibility_trackers == NULL ||
+      g_hash_table_size (priv->visibility_trackers) == 0)
+    return;
 
-      /* If queuing a clipped redraw and a clipped redraw has
-       * previously been queued for this actor then combine the latest
-       * clip together with the existing clip */
-      if (clip)
-        clutter_paint_volume_union (&entry->clip, clip);
-      else
-        {
-          clutter_paint_volume_free (&entry->clip);
-          entry->has_clip = FALSE;
-        }
-      return entry;
-    }
-  else
-    {
-      entry = g_slice_new (ClutterStageQueueRedrawEntry);
-      entry->actor = g_object_ref (actor);
+  actors = g_ptr_array_new_full (g_hash_table_size (priv->visibility_trackers),
+                                 g_object_unref);
 
-      if (clip)
-        {
-          entry->has_clip = TRUE;
-          _clutter_paint_volume_init_static (&entry->clip, actor);
-          _clutter_paint_volume_set_from_volume (&entry->clip, clip);
-        }
-      else
-        entry->has_clip = FALSE;
+  g_hash_table_iter_init (&iter, priv->visibility_trackers);
+  while (g_hash_table_iter_next (&iter, &actor, NULL))
+    g_ptr_array_add (actors, g_object_ref (actor));
 
-      stage->priv->pending_queue_redraws =
-        g_list_prepend (stage->priv->pending_queue_redraws, entry);
+  for (i = 0; i < actors->len; i++)
+    {
+      ClutterActor *tracked = g_ptr_array_index (actors, i);
 
-      return entry;
+      _clutter_actor_update_on_screen (tracked);
     }
-}
 
-static void
-free_queue_redraw_entry (ClutterStageQueueRedrawEntry *entry)
-{
-  if (entry->actor)
-    g_object_unref (entry->actor);
-  if (entry->has_clip)
-    clutter_paint_volume_free (&entry->clip);
-  g_slice_free (ClutterStageQueueRedrawEntry, entry);
+  g_ptr_array_unref (actors);
 }
 
+/*< private >
+ * _clutter_stage_freeze_notify:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor on @stage
+ *
+ * Freezes the notifications of @actor until the end of the layout
+ * phase of the next frame, if @stage coalesces notifications; the
+ * notification queue of GObject ensures that each property is only
+ * notified once when thawing.
+ */
 void
-_clutter_stage_queue_redraw_entry_invalidate (ClutterStageQueueRedrawEntry *entry)
+_clutter_stage_freeze_notify (ClutterStage *stage,
+                              ClutterActor *actor)
 {
-  if (entry == NULL)
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (!priv->coalesce_notifications || CLUTTER_ACTOR_IN_DESTRUCTION (stage))
     return;
 
-  if (entry->actor != NULL)
-    {
-      g_object_unref (entry->actor);
-      entry->actor = NULL;
-    }
+  if (priv->frozen_actors == NULL)
+    priv->frozen_actors = g_hash_table_new_full (NULL, NULL,
+                                                 g_object_unref,
+                                                 NULL);
+  else if (g_hash_table_contains (priv->frozen_actors, actor))
+    return;
 
-  if (entry->has_clip)
-    {
-      clutter_paint_volume_free (&entry->clip);
-      entry->has_clip = FALSE;
-    }
+  g_hash_table_add (priv->frozen_actors, g_object_ref (actor));
+  g_object_freeze_notify (G_OBJECT (actor));
+
+  /* the notifications should not wait for an unrelated frame */
+  _clutter_stage_schedule_update (stage);
 }
 
 static void
-clutter_stage_maybe_finish_queue_redraws (ClutterStage *stage)
+clutter_stage_thaw_notifications (ClutterStage *stage)
 {
-  /* Note: we have to repeat until the pending_queue_redraws list is
-   * empty because actors are allowed to queue redraws in response to
-   * the queue-redraw signal. For example Clone actors or
-   * texture_new_from_actor actors will have to queue a redraw if
-   * their source queues a redraw.
-   */
-  while (stage->priv->pending_queue_redraws)
-    {
-      GList *l;
-      /* XXX: we need to allow stage->priv->pending_queue_redraws to
-       * be updated while we process the current entries in the list
-       * so we steal the list pointer and then reset it to an empty
-       * list before processing... */
-      GList *stolen_list = stage->priv->pending_queue_redraws;
-      stage->priv->pending_queue_redraws = NULL;
+  GHashTable *frozen_actors = stage->priv->frozen_actors;
+  GHashTableIter iter;
+  gpointer actor;
 
-      for (l = stolen_list; l; l = l->next)
-        {
-          ClutterStageQueueRedrawEntry *entry = l->data;
-          ClutterPaintVolume *clip;
+  if (frozen_actors == NULL)
+    return;
 
-          /* NB: Entries may be invalidated if the actor gets destroyed */
-          if (G_LIKELY (entry->actor != NULL))
-	    {
-	      clip = entry->has_clip ? &entry->clip : NULL;
+  /* the handlers can change other actors, and freeze them again;
+   * their notifications are emitted in the next frame
+   */
+  stage->priv->frozen_actors = NULL;
 
-	      _clutter_actor_finish_queue_redraw (entry->actor, clip);
-	    }
+  g_hash_table_iter_init (&iter, frozen_actors);
+  while (g_hash_table_iter_next (&iter, &actor, NULL))
+    g_object_thaw_notify (actor);
 
-          free_queue_redraw_entry (entry);
-        }
-      g_list_free (stolen_list);
-    }
+  g_hash_table_unref (frozen_actors);
 }
 
 /**
- * clutter_stage_set_accept_focus:
+ * clutter_stage_set_coalesce_notifications:
  * @stage: a #ClutterStage
- * @accept_focus: %TRUE to accept focus on show
+ * @coalesce: whether to coalesce the property notifications
  *
- * Sets whether the @stage should accept the key focus when shown.
+ * Sets whether the #GObject::notify signals of the actors on @stage
+ * should be held until the layout of the next frame is done.
  *
- * This function should be called before showing @stage using
- * clutter_actor_show().
+ * When coalescing, each property of an actor is notified at most once
+ * per frame, regardless of how many times it changed, and the handlers
+ * always observe the final layout of the frame. This is especially
+ * useful during layout animations, where the position and size of
+ * many actors change multiple times during a single frame.
  *
- * Since: 1.6
+ * Notifications are never emitted for actors without handlers,
+ * regardless of this setting.
+ *
+ * The default is %FALSE.
+ *
+ * Since: 1.26
  */
 void
-clutter_stage_set_accept_focus (ClutterStage *stage,
-                                gboolean      accept_focus)
+clutter_stage_set_coalesce_notifications (ClutterStage *stage,
+                                          gboolean      coalesce)
 {
-  ClutterStagePrivate *priv;
-
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-  accept_focus = !!accept_focus;
+  if (stage->priv->coalesce_notifications == !!coalesce)
+    return;
 
-  priv = stage->priv;
+  stage->priv->coalesce_notifications = !!coalesce;
 
-  if (priv->accept_focus != accept_focus)
-    {
-      _clutter_stage_window_set_accept_focus (priv->impl, accept_focus);
-      g_object_notify (G_OBJECT (stage), "accept-focus");
-    }
+  if (!stage->priv->coalesce_notifications)
+    clutter_stage_thaw_notifications (stage);
 }
 
 /**
- * clutter_stage_get_accept_focus:
+ * clutter_stage_get_coalesce_notifications:
  * @stage: a #ClutterStage
  *
- * Retrieves the value set with clutter_stage_set_accept_focus().
+ * Retrieves the value set using clutter_stage_set_coalesce_notifications().
  *
- * Return value: %TRUE if the #ClutterStage should accept focus, and %FALSE
- *   otherwise
+ * Return value: %TRUE if the notifications are coalesced
  *
- * Since: 1.6
+ * Since: 1.26
  */
 gboolean
-clutter_stage_get_accept_focus (ClutterStage *stage)
+clutter_stage_get_coalesce_notifications (ClutterStage *stage)
 {
-  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), TRUE);
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  return stage->priv->accept_focus;
+  return stage->priv->coalesce_notifications;
 }
 
 /**
- * clutter_stage_set_motion_events_enabled:
+ * clutter_stage_set_depth_sorted_paint:
  * @stage: a #ClutterStage
- * @enabled: %TRUE to enable the motion events delivery, and %FALSE
- *   otherwise
- *
- * Sets whether per-actor motion events (and relative crossing
- * events) should be disabled or not.
- *
- * The default is %TRUE.
- *
- * If @enable is %FALSE the following signals will not be emitted
- * by the actors children of @stage:
+ * @depth_sorted: whether to paint using the depth buffer
  *
- *  - #ClutterActor::motion-event
- *  - #ClutterActor::enter-event
- *  - #ClutterActor::leave-event
+ * Sets whether @stage should use the depth buffer to skip the parts
+ * of the actors that are hidden by opaque actors painted after them.
  *
- * The events will still be delivered to the #ClutterStage.
+ * Each actor is given its own range of depth, following the paint
+ * order, and the areas covered by opaque background colors and images
+ * are written to the depth buffer, nearest first, before the actors
+ * are painted; the painted result is the same, but the GPU does not
+ * shade the hidden fragments. This is useful for scenes with many
+ * overlapping layers, like stacks of full screen cards, and has a
+ * small cost on the CPU for every painted actor.
  *
- * The main side effect of this function is that disabling the motion
- * events will disable picking to detect the #ClutterActor underneath
- * the pointer for each motion event. This is useful, for instance,
- * when dragging a #ClutterActor across the @stage: the actor underneath
- * the pointer is not going to change, so it's meaningless to perform
- * a pick.
+ * The default is %FALSE.
  *
- * Since: 1.8
+ * Since: 1.26
  */
 void
-clutter_stage_set_motion_events_enabled (ClutterStage *stage,
-                                         gboolean      enabled)
+clutter_stage_set_depth_sorted_paint (ClutterStage *stage,
+                                      gboolean      depth_sorted)
 {
-  ClutterStagePrivate *priv;
-
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
-  priv = stage->priv;
+  if (stage->priv->depth_sorted_paint == !!depth_sorted)
+    return;
 
-  enabled = !!enabled;
+  stage->priv->depth_sorted_paint = !!depth_sorted;
 
-  if (priv->motion_events_enabled != enabled)
-    priv->motion_events_enabled = enabled;
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
 }
 
 /**
- * clutter_stage_get_motion_events_enabled:
+ * clutter_stage_get_depth_sorted_paint:
  * @stage: a #ClutterStage
  *
- * Retrieves the value set using clutter_stage_set_motion_events_enabled().
+ * Retrieves the value set using clutter_stage_set_depth_sorted_paint().
  *
- * Return value: %TRUE if the per-actor motion event delivery is enabled
- *   and %FALSE otherwise
+ * Return value: %TRUE if the stage paints using the depth buffer
  *
- * Since: 1.8
+ * Since: 1.26
  */
 gboolean
-clutter_stage_get_motion_events_enabled (ClutterStage *stage)
+clutter_stage_get_depth_sorted_paint (ClutterStage *stage)
 {
   g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
 
-  return stage->priv->motion_events_enabled;
+  return stage->priv->depth_sorted_paint;
 }
 
-/* NB: The presumption shouldn't be that a stage can't be comprised
- * of multiple internal framebuffers, so instead of simply naming
- * this function _clutter_stage_get_framebuffer(), the "active"
- * infix is intended to clarify that it gets the framebuffer that
- * is currently in use/being painted.
- */
-CoglFramebuffer *
-_clutter_stage_get_active_framebuffer (ClutterStage *stage)
+static GList *
+clutter_stage_find_raster_cache_entry (ClutterStage *stage,
+                                       ClutterActor *actor)
 {
-  return stage->priv->active_framebuffer;
+  GList *l;
+
+  for (l = stage->priv->raster_cache.head; l != NULL; l = l->next)
+    {
+      RasterCacheEntry *entry = l->data;
+
+      if (entry->actor == actor)
+        return l;
+    }
+
+  return NULL;
 }
 
-gint32
-_clutter_stage_acquire_pick_id (ClutterStage *stage,
-                                ClutterActor *actor)
+/*< private >
+ * _clutter_stage_reserve_raster_cache:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor on @stage
+ * @width: the width of the offscreen image of @actor
+ * @height: the height of the offscreen image of @actor
+ *
+ * Accounts for the offscreen image of a static @actor, evicting the
+ * least recently painted images if the budget of the raster cache is
+ * exceeded.
+ *
+ * Return value: %TRUE if @actor can be flattened
+ */
+gboolean
+_clutter_stage_reserve_raster_cache (ClutterStage *stage,
+                                     ClutterActor *actor,
+                                     gint          width,
+                                     gint          height)
 {
   ClutterStagePrivate *priv = stage->priv;
+  RasterCacheEntry *entry;
+  gsize size;
 
-  g_assert (priv->pick_id_pool != NULL);
+  if (width <= 0 || height <= 0 ||
+      width > priv->raster_cache_max_size ||
+      height > priv->raster_cache_max_size)
+    return FALSE;
 
-  return _clutter_id_pool_add (priv->pick_id_pool, actor);
+  size = (gsize) width * height * 4;
+  if (size > priv->raster_cache_budget)
+    return FALSE;
+
+  while (priv->raster_cache_size + size > priv->raster_cache_budget)
+    {
+      entry = g_queue_pop_head (&priv->raster_cache);
+
+      CLUTTER_NOTE (PAINT, "Evicting the raster cache of '%s' (%" G_GSIZE_FORMAT " bytes)",
+                    _clutter_actor_get_debug_name (entry->actor),
+                    entry->size);
+
+      priv->raster_cache_size -= entry->size;
+
+      if (priv->raster_cache_evicted == NULL)
+        priv->raster_cache_evicted = g_ptr_array_new_with_free_func (g_object_unref);
+
+      g_ptr_array_add (priv->raster_cache_evicted, g_object_ref (entry->actor));
+      _clutter_actor_evict_raster_cache (entry->actor);
+
+      g_free (entry);
+    }
+
+  entry = g_new (RasterCacheEntry, 1);
+  entry->actor = actor;
+  entry->size = size;
+
+  g_queue_push_tail (&priv->raster_cache, entry);
+  priv->raster_cache_size += size;
+
+  return TRUE;
 }
 
+/*< private >
+ * _clutter_stage_touch_raster_cache:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor painted using its cached image
+ *
+ * Marks the image of @actor as the most recently painted one.
+ */
 void
-_clutter_stage_release_pick_id (ClutterStage *stage,
-                                gint32        pick_id)
+_clutter_stage_touch_raster_cache (ClutterStage *stage,
+                                   ClutterActor *actor)
 {
-  ClutterStagePrivate *priv = stage->priv;
+  GList *link = clutter_stage_find_raster_cache_entry (stage, actor);
 
-  g_assert (priv->pick_id_pool != NULL);
+  if (link == NULL || link == stage->priv->raster_cache.tail)
+    return;
 
-  _clutter_id_pool_remove (priv->pick_id_pool, pick_id);
+  g_queue_unlink (&stage->priv->raster_cache, link);
+  g_queue_push_tail_link (&stage->priv->raster_cache, link);
 }
 
-ClutterActor *
-_clutter_stage_get_actor_by_pick_id (ClutterStage *stage,
-                                     gint32        pick_id)
+/*< private >
+ * _clutter_stage_release_raster_cache:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor
+ *
+ * Stops accounting for the image of @actor, after the actor
+ * changed or was unmapped.
+ */
+void
+_clutter_stage_release_raster_cache (ClutterStage *stage,
+                                     ClutterActor *actor)
 {
   ClutterStagePrivate *priv = stage->priv;
+  RasterCacheEntry *entry;
+  GList *link;
 
-  g_assert (priv->pick_id_pool != NULL);
+  link = clutter_stage_find_raster_cache_entry (stage, actor);
+  if (link == NULL)
+    return;
 
-  return _clutter_id_pool_lookup (priv->pick_id_pool, pick_id);
+  entry = link->data;
+  priv->raster_cache_size -= entry->size;
+
+  g_queue_delete_link (&priv->raster_cache, link);
+  g_free (entry);
+}
+
+static void
+clutter_stage_release_evicted_raster_cache (ClutterStage *stage)
+{
+  GPtrArray *evicted = stage->priv->raster_cache_evicted;
+  guint i;
+
+  if (evicted == NULL)
+    return;
+
+  stage->priv->raster_cache_evicted = NULL;
+
+  /* outside of the paint, the flattening effects can be removed */
+  for (i = 0; i < evicted->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (evicted, i);
+
+      if (!clutter_stage_find_raster_cache_entry (stage, actor))
+        _clutter_actor_evict_raster_cache (actor);
+    }
+
+  g_ptr_array_unref (evicted);
+}
+
+/**
+ * clutter_stage_set_raster_cache_limits:
+ * @stage: a #ClutterStage
+ * @max_size: the maximum width and height of a cached image, in pixels
+ * @budget: the maximum amount of memory used by the cached images,
+ *   in bytes
+ *
+ * Sets the limits of the images cached for the actors using the
+ * %CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC offscreen redirect
+ * flag.
+ *
+ * Actors larger than @max_size in either direction are never cached.
+ * When the images would use more than @budget bytes, the least
+ * recently painted ones are evicted.
+ *
+ * The defaults are 2048 pixels and 32 megabytes.
+ *
+ * Since: 1.26
+ */
+void
+clutter_stage_set_raster_cache_limits (ClutterStage *stage,
+                                       gint          max_size,
+                                       gsize         budget)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (max_size >= 0);
+
+  priv = stage->priv;
+
+  priv->raster_cache_max_size = max_size;
+  priv->raster_cache_budget = budget;
+
+  /* the images over the new limits are dropped on their next paint */
+  while (priv->raster_cache_size > priv->raster_cache_budget)
+    {
+      RasterCacheEntry *entry = g_queue_pop_head (&priv->raster_cache);
+
+      priv->raster_cache_size -= entry->size;
+      _clutter_actor_evict_raster_cache (entry->actor);
+      g_free (entry);
+    }
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
+
+/**
+ * clutter_stage_get_raster_cache_limits:
+ * @stage: a #ClutterStage
+ * @max_size: (out) (allow-none): return location for the maximum
+ *   size of a cached image, or %NULL
+ * @budget: (out) (allow-none): return location for the maximum
+ *   amount of memory used by the cached images, or %NULL
+ *
+ * Retrieves the limits set using clutter_stage_set_raster_cache_limits().
+ *
+ * Since: 1.26
+ */
+void
+clutter_stage_get_raster_cache_limits (ClutterStage *stage,
+                                       gint         *max_size,
+                                       gsize        *budget)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  if (max_size != NULL)
+    *max_size = stage->priv->raster_cache_max_size;
+
+  if (budget != NULL)
+    *budget = stage->priv->raster_cache_budget;
 }
 
 void
@@ -4498,6 +8741,39 @@ clutter_stage_set_sync_delay (ClutterStage *stage,
   stage->priv->sync_delay = sync_delay;
 }
 
+/**
+ * clutter_stage_set_adaptive_sync_delay:
+ * @stage: a #ClutterStage
+ * @adaptive: whether the sync delay should be adaptive
+ *
+ * Sets whether Clutter should pick the delay after the frame
+ * presentation time by itself, instead of using the fixed delay set
+ * with clutter_stage_set_sync_delay().
+ *
+ * An adaptive sync delay predicts the time of the next presentation
+ * from the timing of the previous ones, and estimates how long the
+ * next frame will take to draw from the cost of the most recent
+ * frames; the update of the @stage is then started as late as
+ * possible while still being in time for the next presentation.
+ * This gives the lowest latency the complexity of the scene allows
+ * for, without having to tune the sync delay by hand.
+ *
+ * If the windowing system does not report presentation times, or
+ * if the @stage has been idle for a while, the @stage is updated as
+ * soon as possible.
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+void
+clutter_stage_set_adaptive_sync_delay (ClutterStage *stage,
+                                       gboolean      adaptive)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  stage->priv->adaptive_sync_delay = !!adaptive;
+}
+
 /**
  * clutter_stage_skip_sync_delay:
  * @stage: a #ClutterStage
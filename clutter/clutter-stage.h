@@ -135,6 +135,117 @@ struct _ClutterFog
   gfloat z_far;
 };
 
+/**
+ * ClutterFrameInfo:
+ * @frame_counter: a monotonically increasing counter of the frames
+ *   collected for the stage
+ * @frame_time: the time of the master clock tick that started the frame
+ * @events_start: the time the event processing started
+ * @events_end: the time the event processing ended
+ * @timelines_start: the time the timelines started advancing
+ * @timelines_end: the time the timelines finished advancing
+ * @layout_start: the time the relayout of the stage started
+ * @layout_end: the time the relayout of the stage ended
+ * @paint_start: the time the paint of the stage started
+ * @paint_end: the time the paint of the stage ended
+ * @swap_start: the time the swap of the buffers was requested, or 0
+ *   if the stage window does not report it
+ * @swap_end: the time the swap request returned, or 0
+ * @presentation_time: the time the frame was presented on screen,
+ *   or 0 if it is not known
+ * @refresh_interval: the refresh interval of the display the frame
+ *   was presented on, or 0 if it is not known
+ * @presentation_flags: how the frame was presented, if the windowing
+ *   system reports it
+ * @pick_time: the total time spent picking during the frame
+ * @repaint_funcs_time: the total time spent running the repaint
+ *   functions during the frame
+ * @n_deferred_repaint_funcs: the number of repaint functions deferred
+ *   to the next frame because their budget was exhausted; see
+ *   clutter_threads_set_repaint_func_budget()
+ * @n_input_events: the number of events processed by the frame that
+ *   carry the time they were reported by the input device
+ * @oldest_input_time: the oldest time reported by the input device
+ *   for the events processed by the frame, or 0
+ * @newest_input_time: the newest time reported by the input device
+ *   for the events processed by the frame, or 0
+ * @layout_stats: the layout work done during the frame, by the actors
+ *   of all the stages; see clutter_actor_get_layout_stats()
+ *
+ * Timing information for a frame of a #ClutterStage; all the times are
+ * in microseconds, and use the same clock as g_get_monotonic_time().
+ *
+ * The difference between @presentation_time and @oldest_input_time,
+ * or @newest_input_time, is the latency between the input device and
+ * the screen for the frame; see clutter_event_get_hardware_time().
+ *
+ * See clutter_stage_set_collect_frame_info().
+ *
+ * Since: 1.26
+ */
+struct _ClutterFrameInfo
+{
+  gint64 frame_counter;
+  gint64 frame_time;
+
+  gint64 events_start;
+  gint64 events_end;
+
+  gint64 timelines_start;
+  gint64 timelines_end;
+
+  gint64 layout_start;
+  gint64 layout_end;
+
+  gint64 paint_start;
+  gint64 paint_end;
+
+  gint64 swap_start;
+  gint64 swap_end;
+
+  gint64 presentation_time;
+  gint64 refresh_interval;
+  ClutterPresentationFlags presentation_flags;
+
+  gint64 pick_time;
+
+  gint64 repaint_funcs_time;
+  guint n_deferred_repaint_funcs;
+
+  guint n_input_events;
+  gint64 oldest_input_time;
+  gint64 newest_input_time;
+
+  ClutterLayoutStats layout_stats;
+};
+
+/**
+ * ClutterStageCaptureFunc:
+ * @stage: the #ClutterStage that was captured
+ * @data: (array) (nullable): the captured pixels, in premultiplied RGBA
+ *   8bit format, or %NULL if the capture failed
+ * @width: the width of the captured image, in pixels
+ * @height: the height of the captured image, in pixels
+ * @rowstride: the number of bytes between the start of two rows
+ * @user_data: the data passed to clutter_stage_capture_async()
+ *
+ * The function called when a capture requested with
+ * clutter_stage_capture_async() is ready.
+ *
+ * The @data is owned by Clutter, and it is only valid until the
+ * function returns.
+ *
+ * Since: 1.26
+ */
+typedef void (* ClutterStageCaptureFunc) (ClutterStage *stage,
+                                          const guint8 *data,
+                                          gint          width,
+                                          gint          height,
+                                          gint          rowstride,
+                                          gpointer      user_data);
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_frame_info_get_type (void) G_GNUC_CONST;
 CLUTTER_AVAILABLE_IN_ALL
 GType clutter_perspective_get_type (void) G_GNUC_CONST;
 CLUTTER_DEPRECATED_IN_1_10
@@ -219,12 +330,25 @@ ClutterActor *  clutter_stage_get_actor_at_pos                  (ClutterStage
                                                                  ClutterPickMode        pick_mode,
                                                                  gint                   x,
                                                                  gint                   y);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_get_actors_at_positions           (ClutterStage          *stage,
+                                                                 ClutterPickMode        pick_mode,
+                                                                 const ClutterPoint    *positions,
+                                                                 guint                  n_positions,
+                                                                 ClutterActor         **actors);
 CLUTTER_AVAILABLE_IN_ALL
 guchar *        clutter_stage_read_pixels                       (ClutterStage          *stage,
                                                                  gint                   x,
                                                                  gint                   y,
                                                                  gint                   width,
                                                                  gint                   height);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_capture_async                     (ClutterStage                *stage,
+                                                                 const cairo_rectangle_int_t *rect,
+                                                                 guint                        downscale,
+                                                                 ClutterStageCaptureFunc      func,
+                                                                 gpointer                     user_data,
+                                                                 GDestroyNotify               notify);
 
 CLUTTER_AVAILABLE_IN_ALL
 void            clutter_stage_get_redraw_clip_bounds            (ClutterStage          *stage,
@@ -237,12 +361,81 @@ void            clutter_stage_ensure_viewport                   (ClutterStage
 CLUTTER_AVAILABLE_IN_ALL
 void            clutter_stage_ensure_redraw                     (ClutterStage          *stage);
 
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_geometric_picking             (ClutterStage          *stage,
+                                                                 gboolean               enabled);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_geometric_picking             (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_collect_frame_info            (ClutterStage          *stage,
+                                                                 gboolean               collect);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_collect_frame_info            (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_stage_get_frame_info_history            (ClutterStage          *stage,
+                                                                 ClutterFrameInfo      *frames,
+                                                                 guint                  n_frames);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_adaptive_quality              (ClutterStage          *stage,
+                                                                 gboolean               adaptive);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_adaptive_quality              (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_frame_budget                  (ClutterStage          *stage,
+                                                                 gint64                 budget);
+CLUTTER_AVAILABLE_IN_1_26
+gint64          clutter_stage_get_frame_budget                  (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+ClutterQualityLevel clutter_stage_get_quality_level             (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_dynamic_resolution            (ClutterStage          *stage,
+                                                                 gfloat                 min_scale);
+CLUTTER_AVAILABLE_IN_1_26
+gfloat          clutter_stage_get_dynamic_resolution            (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+gfloat          clutter_stage_get_resolution_scale              (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+gchar *         clutter_stage_get_memory_report                 (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_show_hud                      (ClutterStage          *stage,
+                                                                 gboolean               show);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_show_hud                      (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_coalesce_notifications        (ClutterStage          *stage,
+                                                                 gboolean               coalesce);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_coalesce_notifications        (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_raster_cache_limits           (ClutterStage          *stage,
+                                                                 gint                   max_size,
+                                                                 gsize                  budget);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_get_raster_cache_limits           (ClutterStage          *stage,
+                                                                 gint                  *max_size,
+                                                                 gsize                 *budget);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_depth_sorted_paint            (ClutterStage          *stage,
+                                                                 gboolean               depth_sorted);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_depth_sorted_paint            (ClutterStage          *stage);
+
 #ifdef CLUTTER_ENABLE_EXPERIMENTAL_API
 CLUTTER_AVAILABLE_IN_1_14
 void            clutter_stage_set_sync_delay                    (ClutterStage          *stage,
                                                                  gint                   sync_delay);
 CLUTTER_AVAILABLE_IN_1_14
 void            clutter_stage_skip_sync_delay                   (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_adaptive_sync_delay           (ClutterStage          *stage,
+                                                                 gboolean               adaptive);
 #endif
 
 G_END_DECLS
@@ -52,6 +52,11 @@
 /* Initial size of buffer, in bytes */
 #define MIN_SIZE 16
 
+/* Maximum number of characters walked to convert an offset into a
+ * byte index before a new checkpoint is added
+ */
+#define CHECKPOINT_INTERVAL 256
+
 enum {
   PROP_0,
   PROP_TEXT,
@@ -79,8 +84,18 @@ struct _ClutterTextBufferPrivate
   gsize  normal_text_size;
   gsize  normal_text_bytes;
   guint  normal_text_chars;
+
+  /* Checkpoints, sorted by character offset */
+  GArray *normal_checkpoints;
 };
 
+/* A character offset inside normal_text, and its byte index */
+typedef struct
+{
+  guint chars;
+  gsize bytes;
+} Checkpoint;
+
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterTextBuffer, clutter_text_buffer, G_TYPE_OBJECT)
 
 /* --------------------------------------------------------------------------------
@@ -118,6 +133,96 @@ clutter_text_buffer_normal_get_length (ClutterTextBuffer *buffer)
   return buffer->priv->normal_text_chars;
 }
 
+/*
+ * Converts the character offset @position into a byte index inside
+ * normal_text, starting from the closest checkpoint before it instead
+ * of the start of the text.
+ */
+static gsize
+clutter_text_buffer_normal_offset_to_bytes (ClutterTextBuffer *buffer,
+                                            guint              position)
+{
+  ClutterTextBufferPrivate *pv = buffer->priv;
+  GArray *checkpoints = pv->normal_checkpoints;
+  guint start_chars = 0;
+  gsize start_bytes = 0;
+  guint lo, hi;
+  gsize bytes;
+
+  if (position == 0)
+    return 0;
+
+  if (position >= pv->normal_text_chars)
+    return pv->normal_text_bytes;
+
+  /* find the number of checkpoints at or before position */
+  lo = 0;
+  hi = checkpoints->len;
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+
+      if (g_array_index (checkpoints, Checkpoint, mid).chars <= position)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo > 0)
+    {
+      const Checkpoint *checkpoint = &g_array_index (checkpoints, Checkpoint, lo - 1);
+
+      start_chars = checkpoint->chars;
+      start_bytes = checkpoint->bytes;
+    }
+
+  bytes = g_utf8_offset_to_pointer (pv->normal_text + start_bytes,
+                                    position - start_chars)
+        - pv->normal_text;
+
+  if (position - start_chars >= CHECKPOINT_INTERVAL)
+    {
+      Checkpoint checkpoint = { position, bytes };
+
+      g_array_insert_val (checkpoints, lo, checkpoint);
+    }
+
+  return bytes;
+}
+
+/*
+ * Updates the checkpoints after @removed_chars characters at @position
+ * were replaced by @added_chars characters; the checkpoints inside the
+ * removed text are dropped, and the ones after it are shifted.
+ */
+static void
+clutter_text_buffer_normal_update_checkpoints (ClutterTextBuffer *buffer,
+                                               guint              position,
+                                               guint              removed_chars,
+                                               gsize              removed_bytes,
+                                               guint              added_chars,
+                                               gsize              added_bytes)
+{
+  GArray *checkpoints = buffer->priv->normal_checkpoints;
+  guint i = 0;
+
+  while (i < checkpoints->len)
+    {
+      Checkpoint *checkpoint = &g_array_index (checkpoints, Checkpoint, i);
+
+      if (checkpoint->chars <= position)
+        i += 1;
+      else if (checkpoint->chars < position + removed_chars)
+        g_array_remove_index (checkpoints, i);
+      else
+        {
+          checkpoint->chars = checkpoint->chars - removed_chars + added_chars;
+          checkpoint->bytes = checkpoint->bytes - removed_bytes + added_bytes;
+          i += 1;
+        }
+    }
+}
+
 static guint
 clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
                                      guint           position,
@@ -170,10 +275,12 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
     }
 
   /* Actual text insertion */
-  at = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
+  at = clutter_text_buffer_normal_offset_to_bytes (buffer, position);
   g_memmove (pv->normal_text + at + n_bytes, pv->normal_text + at, pv->normal_text_bytes - at);
   memcpy (pv->normal_text + at, chars, n_bytes);
 
+  clutter_text_buffer_normal_update_checkpoints (buffer, position, 0, 0, n_chars, n_bytes);
+
   /* Book keeping */
   pv->normal_text_bytes += n_bytes;
   pv->normal_text_chars += n_chars;
@@ -198,8 +305,10 @@ clutter_text_buffer_normal_delete_text (ClutterTextBuffer *buffer,
 
   if (n_chars > 0)
     {
-      start = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-      end = g_utf8_offset_to_pointer (pv->normal_text, position + n_chars) - pv->normal_text;
+      start = clutter_text_buffer_normal_offset_to_bytes (buffer, position);
+      end = clutter_text_buffer_normal_offset_to_bytes (buffer, position + n_chars);
+
+      clutter_text_buffer_normal_update_checkpoints (buffer, position, n_chars, end - start, 0, 0);
 
       g_memmove (pv->normal_text + start, pv->normal_text + end, pv->normal_text_bytes + 1 - end);
       pv->normal_text_chars -= n_chars;
@@ -254,6 +363,7 @@ clutter_text_buffer_init (ClutterTextBuffer *self)
   self->priv->normal_text_chars = 0;
   self->priv->normal_text_bytes = 0;
   self->priv->normal_text_size = 0;
+  self->priv->normal_checkpoints = g_array_new (FALSE, FALSE, sizeof (Checkpoint));
 }
 
 static void
@@ -271,6 +381,8 @@ clutter_text_buffer_finalize (GObject *obj)
       pv->normal_text_chars = 0;
     }
 
+  g_array_unref (pv->normal_checkpoints);
+
   G_OBJECT_CLASS (clutter_text_buffer_parent_class)->finalize (obj);
 }
 
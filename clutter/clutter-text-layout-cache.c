@@ -0,0 +1,302 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * ClutterTextLayoutCache: a cache of PangoLayouts shared between the
+ * ClutterText actors.
+ *
+ * Many actors show the same short strings using the same font; instead
+ * of shaping the text for each of them, the layouts without attributes
+ * are looked up in a process-wide cache, keyed on the text and on the
+ * parameters of the layout. The layouts are created using PangoContexts
+ * owned by the cache, one for each base direction, so that the changes
+ * to the context of an actor do not affect the other actors.
+ *
+ * The layouts returned by the cache are shared, and must not be
+ * modified. The cache holds a reference on each layout, and evicts the
+ * least recently used ones once their estimated size goes over the size
+ * set using the CLUTTER_TEXT_LAYOUT_CACHE environment variable; evicted
+ * layouts stay alive as long as an actor uses them.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-text-layout-cache.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+#include "clutter-settings-private.h"
+
+typedef struct _CacheEntry
+{
+  /* the key; the text and font description are owned by the entry */
+  ClutterTextLayoutParams params;
+
+  PangoLayout *layout;
+
+  /* the estimated size of the entry, in bytes */
+  gsize size;
+
+  /* the link inside the LRU queue; the data is the entry */
+  GList link;
+} CacheEntry;
+
+static GHashTable *cache_entries = NULL;
+
+/* the most recently used entry is at the head */
+static GQueue cache_lru = G_QUEUE_INIT;
+
+static gsize cache_size = 0;
+
+/* the contexts used to create the layouts, one per base direction */
+static PangoContext *cache_contexts[PANGO_DIRECTION_NEUTRAL + 1] = { NULL, };
+
+static guint
+cache_entry_hash (gconstpointer data)
+{
+  const ClutterTextLayoutParams *params = data;
+  guint hash;
+
+  hash = g_str_hash (params->text);
+  hash = hash * 31 + pango_font_description_hash (params->font_desc);
+  hash = hash * 31 + (guint) params->width;
+  hash = hash * 31 + (guint) params->height;
+  hash = hash * 31 + params->direction;
+  hash = hash * 31 + params->ellipsize;
+
+  return hash;
+}
+
+static gboolean
+cache_entry_equal (gconstpointer a,
+                   gconstpointer b)
+{
+  const ClutterTextLayoutParams *params_a = a;
+  const ClutterTextLayoutParams *params_b = b;
+
+  return params_a->width == params_b->width &&
+         params_a->height == params_b->height &&
+         params_a->direction == params_b->direction &&
+         params_a->alignment == params_b->alignment &&
+         params_a->wrap_mode == params_b->wrap_mode &&
+         params_a->ellipsize == params_b->ellipsize &&
+         params_a->justify == params_b->justify &&
+         params_a->single_line_mode == params_b->single_line_mode &&
+         strcmp (params_a->text, params_b->text) == 0 &&
+         pango_font_description_equal (params_a->font_desc,
+                                       params_b->font_desc);
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_object_unref (entry->layout);
+  g_free ((gchar *) entry->params.text);
+  pango_font_description_free ((PangoFontDescription *) entry->params.font_desc);
+
+  g_slice_free (CacheEntry, entry);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_clear:
+ *
+ * Drops every layout from the cache, for instance because the font
+ * options or the resolution of the backend changed.
+ */
+void
+_clutter_text_layout_cache_clear (void)
+{
+  guint i;
+
+  if (cache_entries == NULL)
+    return;
+
+  CLUTTER_NOTE (PANGO, "Clearing %u shared layouts (%" G_GSIZE_FORMAT " bytes)",
+                g_hash_table_size (cache_entries),
+                cache_size);
+
+  /* the links are embedded inside the entries */
+  g_queue_init (&cache_lru);
+  g_hash_table_remove_all (cache_entries);
+  cache_size = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (cache_contexts); i++)
+    g_clear_object (&cache_contexts[i]);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_get_size:
+ *
+ * Retrieves the estimated size of the layouts inside the cache.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_text_layout_cache_get_size (void)
+{
+  return cache_size;
+}
+
+static void
+on_backend_changed (ClutterBackend *backend)
+{
+  ClutterSettingsChange changes;
+
+  /* the layouts are keyed on their own font description, so a change
+   * of the default font does not affect them
+   */
+  changes = _clutter_settings_get_changes (clutter_settings_get_default ());
+  if (changes == CLUTTER_SETTINGS_CHANGE_FONT_NAME)
+    return;
+
+  _clutter_text_layout_cache_clear ();
+}
+
+/*< private >
+ * _clutter_text_layout_cache_is_enabled:
+ *
+ * Checks whether the shared layout cache is enabled.
+ *
+ * Return value: %TRUE if the cache can be used
+ */
+gboolean
+_clutter_text_layout_cache_is_enabled (void)
+{
+  return _clutter_get_text_layout_cache_size () > 0;
+}
+
+static PangoContext *
+clutter_text_layout_cache_get_context (PangoDirection direction)
+{
+  if (G_UNLIKELY (cache_contexts[direction] == NULL))
+    {
+      cache_contexts[direction] = _clutter_create_pango_context ();
+      pango_context_set_base_dir (cache_contexts[direction], direction);
+    }
+
+  return cache_contexts[direction];
+}
+
+static void
+clutter_text_layout_cache_evict (gsize max_size)
+{
+  while (cache_size > max_size && cache_lru.tail != NULL)
+    {
+      CacheEntry *entry = cache_lru.tail->data;
+
+      g_queue_unlink (&cache_lru, &entry->link);
+      cache_size -= entry->size;
+
+      g_hash_table_remove (cache_entries, &entry->params);
+    }
+}
+
+/*< private >
+ * _clutter_text_layout_cache_get:
+ * @params: the parameters of the layout
+ *
+ * Retrieves a #PangoLayout for @params from the shared cache, creating
+ * it if needed.
+ *
+ * The returned layout is shared with the other users of the cache, and
+ * must not be modified.
+ *
+ * Return value: (transfer full): a #PangoLayout
+ */
+PangoLayout *
+_clutter_text_layout_cache_get (const ClutterTextLayoutParams *params)
+{
+  gsize max_size = _clutter_get_text_layout_cache_size ();
+  PangoLayout *layout;
+  CacheEntry *entry;
+
+  g_return_val_if_fail (params != NULL, NULL);
+  g_return_val_if_fail (params->direction <= PANGO_DIRECTION_NEUTRAL, NULL);
+
+  if (G_UNLIKELY (cache_entries == NULL))
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+
+      cache_entries = g_hash_table_new_full (cache_entry_hash,
+                                             cache_entry_equal,
+                                             NULL,
+                                             cache_entry_free);
+
+      /* the contexts need to be configured again */
+      g_signal_connect (backend, "resolution-changed",
+                        G_CALLBACK (on_backend_changed),
+                        NULL);
+      g_signal_connect (backend, "font-changed",
+                        G_CALLBACK (on_backend_changed),
+                        NULL);
+    }
+
+  entry = g_hash_table_lookup (cache_entries, params);
+  if (entry != NULL)
+    {
+      g_queue_unlink (&cache_lru, &entry->link);
+      g_queue_push_head_link (&cache_lru, &entry->link);
+
+      return g_object_ref (entry->layout);
+    }
+
+  layout = pango_layout_new (clutter_text_layout_cache_get_context (params->direction));
+  pango_layout_set_font_description (layout, params->font_desc);
+  pango_layout_set_text (layout, params->text, -1);
+  pango_layout_set_alignment (layout, params->alignment);
+  pango_layout_set_single_paragraph_mode (layout, params->single_line_mode);
+  pango_layout_set_justify (layout, params->justify);
+  pango_layout_set_wrap (layout, params->wrap_mode);
+  pango_layout_set_ellipsize (layout, params->ellipsize);
+  pango_layout_set_width (layout, params->width);
+  pango_layout_set_height (layout, params->height);
+
+  entry = g_slice_new0 (CacheEntry);
+  entry->params = *params;
+  entry->params.text = g_strdup (params->text);
+  entry->params.font_desc = pango_font_description_copy (params->font_desc);
+  entry->layout = layout;
+  entry->link.data = entry;
+
+  /* a rough estimate of the memory used by the shaped glyphs, the
+   * logical attributes and the lines of the layout
+   */
+  entry->size = sizeof (CacheEntry)
+              + 512
+              + strlen (params->text) * 48;
+
+  g_hash_table_insert (cache_entries, &entry->params, entry);
+  g_queue_push_head_link (&cache_lru, &entry->link);
+  cache_size += entry->size;
+
+  clutter_text_layout_cache_evict (max_size);
+
+  return g_object_ref (layout);
+}
@@ -0,0 +1,72 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_TEXT_LAYOUT_CACHE_H__
+#define __CLUTTER_TEXT_LAYOUT_CACHE_H__
+
+#include <clutter/clutter-types.h>
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTextLayoutParams ClutterTextLayoutParams;
+
+/*< private >
+ * ClutterTextLayoutParams:
+ * @text: the text of the layout
+ * @font_desc: the font of the layout
+ * @direction: the base direction of the text
+ * @alignment: the alignment of the lines
+ * @wrap_mode: the wrapping mode
+ * @ellipsize: the ellipsization mode
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @justify: whether the lines are justified
+ * @single_line_mode: whether the layout is a single paragraph
+ *
+ * The state defining a #PangoLayout without attributes, used as the
+ * key of the shared layout cache.
+ */
+struct _ClutterTextLayoutParams
+{
+  const gchar *text;
+  const PangoFontDescription *font_desc;
+
+  PangoDirection direction;
+  PangoAlignment alignment;
+  PangoWrapMode wrap_mode;
+  PangoEllipsizeMode ellipsize;
+
+  gint width;
+  gint height;
+
+  guint justify          : 1;
+  guint single_line_mode : 1;
+};
+
+gboolean        _clutter_text_layout_cache_is_enabled   (void);
+PangoLayout *   _clutter_text_layout_cache_get          (const ClutterTextLayoutParams *params);
+void            _clutter_text_layout_cache_clear        (void);
+gsize           _clutter_text_layout_cache_get_size     (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_LAYOUT_CACHE_H__ */
@@ -46,6 +46,7 @@
 #include <math.h>
 
 #include "clutter-text.h"
+#include "clutter-text-private.h"
 
 #include "clutter-actor-private.h"
 #include "clutter-animatable.h"
@@ -57,12 +58,17 @@
 #include "clutter-keysyms.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
+#include "clutter-measure-pool.h"
 #include "clutter-private.h"    /* includes <cogl-pango/cogl-pango.h> */
 #include "clutter-property-transition.h"
 #include "clutter-text-buffer.h"
+#include "clutter-text-layout-cache.h"
+#include "clutter-trace.h"
 #include "clutter-units.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-scriptable.h"
+#include "clutter-sdf-glyph-cache.h"
+#include "clutter-settings-private.h"
 
 /* cursor width in pixels */
 #define DEFAULT_CURSOR_SIZE     2
@@ -82,6 +88,11 @@
  */
 #define N_CACHED_LAYOUTS        6
 
+/* shorter texts are shaped on the main thread even if the
+ * :async-layout property is set
+ */
+#define ASYNC_LAYOUT_MIN_BYTES  4096
+
 typedef struct _LayoutCache     LayoutCache;
 
 struct _LayoutCache
@@ -114,6 +125,29 @@ struct _ClutterTextPrivate
   LayoutCache cached_layouts[N_CACHED_LAYOUTS];
   guint cache_age;
 
+  /* the layout displayed while the contents are shaped off the main
+   * thread, and the pending AsyncLayout jobs
+   */
+  PangoLayout *async_placeholder;
+  GCancellable *async_cancellable;
+  GSList *async_jobs;
+
+  /* the extents of each paragraph of editable texts, keyed by the
+   * contents of the paragraph; see clutter_text_get_paragraph_extents()
+   */
+  GHashTable *paragraph_extents;
+  guint paragraph_serial;
+
+  /* the path of the selection, kept between frames together with
+   * the layout and the selection it was built for, so that Cogl can
+   * reuse its tessellation
+   */
+  CoglPath *selection_path;
+  PangoLayout *selection_path_layout;
+  gint selection_path_position;
+  gint selection_path_bound;
+  gint selection_path_text_x;
+
   /* These are the attributes set by the attributes property */
   PangoAttrList *attrs;
   /* These are the attributes derived from the text when the
@@ -123,6 +157,9 @@ struct _ClutterTextPrivate
      whenever either of them changes and then regenerated by merging
      the two lists whenever a layout is needed */
   PangoAttrList *effective_attrs;
+  /* The string of invisible characters shown by password texts; it
+     is set to NULL whenever the contents change */
+  gchar *display_text;
   /* These are the attributes for the preedit string. These are merged
      with the effective attributes into a temporary list before
      creating a layout */
@@ -173,6 +210,9 @@ struct _ClutterTextPrivate
   /* Signal handler for when the backend changes its font settings */
   guint settings_changed_id;
 
+  /* the changes of the settings not applied while unmapped */
+  ClutterSettingsChange pending_settings_changes;
+
   /* Signal handler for when the :text-direction changes */
   guint direction_changed_id;
 
@@ -201,6 +241,8 @@ struct _ClutterTextPrivate
   guint show_password_hint      : 1;
   guint password_hint_visible   : 1;
   guint resolved_direction      : 4;
+  guint async_layout            : 1;
+  guint use_distance_field      : 1;
 };
 
 enum
@@ -236,6 +278,8 @@ enum
   PROP_SINGLE_LINE_MODE,
   PROP_SELECTED_TEXT_COLOR,
   PROP_SELECTED_TEXT_COLOR_SET,
+  PROP_ASYNC_LAYOUT,
+  PROP_USE_DISTANCE_FIELD,
 
   PROP_LAST
 };
@@ -357,7 +401,20 @@ clutter_text_is_empty (ClutterText *self)
   return FALSE;
 }
 
-static gchar *
+/*
+ * clutter_text_get_display_text:
+ * @self: a #ClutterText
+ *
+ * Retrieves the text shown by @self, which is the contents of the buffer
+ * or, for password texts, a string of invisible characters.
+ *
+ * The string of invisible characters is built once for each change of
+ * the contents, instead of once for each layout.
+ *
+ * Return value: the displayed text; the string is owned by @self or by
+ *   its buffer, and is only valid until the contents change
+ */
+static const gchar *
 clutter_text_get_display_text (ClutterText *self)
 {
   ClutterTextPrivate *priv = self->priv;
@@ -369,7 +426,7 @@ clutter_text_get_display_text (ClutterText *self)
    * notifications with it
    */
   if (clutter_text_is_empty (self))
-    return g_strdup ("");
+    return "";
 
   buffer = get_buffer (self);
   text = clutter_text_buffer_get_text (buffer);
@@ -378,11 +435,12 @@ clutter_text_get_display_text (ClutterText *self)
    * with an empty text and a password char set
    */
   if (text[0] == '\0')
-    return g_strdup ("");
+    return "";
 
   if (G_LIKELY (priv->password_char == 0))
-    return g_strdup (text);
-  else
+    return text;
+
+  if (priv->display_text == NULL)
     {
       GString *str;
       gunichar invisible_char;
@@ -417,8 +475,10 @@ clutter_text_get_display_text (ClutterText *self)
             g_string_append_len (str, buf, char_len);
         }
 
-      return g_string_free (str, FALSE);
+      priv->display_text = g_string_free (str, FALSE);
     }
+
+  return priv->display_text;
 }
 
 static inline void
@@ -476,18 +536,62 @@ clutter_text_ensure_effective_attributes (ClutterText *self)
     }
 }
 
-static PangoLayout *
-clutter_text_create_layout_no_cache (ClutterText       *text,
-				     gint               width,
-				     gint               height,
-				     PangoEllipsizeMode ellipsize)
+static PangoDirection
+clutter_text_get_base_direction (ClutterText *text,
+                                 const gchar *contents,
+                                 gsize        contents_len)
 {
   ClutterTextPrivate *priv = text->priv;
-  PangoLayout *layout;
-  gchar *contents;
+  PangoDirection pango_dir;
+
+  if (priv->password_char != 0)
+    pango_dir = PANGO_DIRECTION_NEUTRAL;
+  else
+    pango_dir = pango_find_base_dir (contents, contents_len);
+
+  if (pango_dir == PANGO_DIRECTION_NEUTRAL)
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+      ClutterTextDirection text_dir;
+
+      if (clutter_actor_has_key_focus (CLUTTER_ACTOR (text)))
+        pango_dir = _clutter_backend_get_keymap_direction (backend);
+      else
+        {
+          text_dir = clutter_actor_get_text_direction (CLUTTER_ACTOR (text));
+
+          if (text_dir == CLUTTER_TEXT_DIRECTION_RTL)
+            pango_dir = PANGO_DIRECTION_RTL;
+          else
+            pango_dir = PANGO_DIRECTION_LTR;
+        }
+    }
+
+  return pango_dir;
+}
+
+/*
+ * clutter_text_setup_layout:
+ * @text: a #ClutterText
+ * @layout: a newly created #PangoLayout
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode
+ *
+ * Sets the contents and the properties of @text on @layout; the base
+ * direction is set on the context of @layout.
+ */
+static void
+clutter_text_setup_layout (ClutterText       *text,
+                           PangoLayout       *layout,
+                           gint               width,
+                           gint               height,
+                           PangoEllipsizeMode ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  const gchar *contents;
   gsize contents_len;
 
-  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
   pango_layout_set_font_description (layout, priv->font_desc);
 
   contents = clutter_text_get_display_text (text);
@@ -524,30 +628,9 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
     {
       PangoDirection pango_dir;
 
-      if (priv->password_char != 0)
-        pango_dir = PANGO_DIRECTION_NEUTRAL;
-      else
-        pango_dir = pango_find_base_dir (contents, contents_len);
-
-      if (pango_dir == PANGO_DIRECTION_NEUTRAL)
-        {
-          ClutterBackend *backend = clutter_get_default_backend ();
-          ClutterTextDirection text_dir;
-
-          if (clutter_actor_has_key_focus (CLUTTER_ACTOR (text)))
-            pango_dir = _clutter_backend_get_keymap_direction (backend);
-          else
-            {
-              text_dir = clutter_actor_get_text_direction (CLUTTER_ACTOR (text));
-
-              if (text_dir == CLUTTER_TEXT_DIRECTION_RTL)
-                pango_dir = PANGO_DIRECTION_RTL;
-              else
-                pango_dir = PANGO_DIRECTION_LTR;
-           }
-        }
+      pango_dir = clutter_text_get_base_direction (text, contents, contents_len);
 
-      pango_context_set_base_dir (clutter_actor_get_pango_context (CLUTTER_ACTOR (text)), pango_dir);
+      pango_context_set_base_dir (pango_layout_get_context (layout), pango_dir);
 
       priv->resolved_direction = pango_dir;
 
@@ -570,17 +653,135 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   pango_layout_set_width (layout, width);
   pango_layout_set_height (layout, height);
 
-  g_free (contents);
+}
+
+static PangoLayout *
+clutter_text_create_layout_no_cache (ClutterText       *text,
+				     gint               width,
+				     gint               height,
+				     PangoEllipsizeMode ellipsize)
+{
+  PangoLayout *layout;
+
+  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+  clutter_text_setup_layout (text, layout, width, height, ellipsize);
+
+  return layout;
+}
+
+/*
+ * clutter_text_create_shared_layout:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode
+ *
+ * Retrieves a layout for the contents of @text from the shared layout
+ * cache, if the cache is enabled and the layout does not depend on
+ * the state of @text beyond its text and font.
+ *
+ * Return value: (transfer full): a shared #PangoLayout, or %NULL
+ */
+static PangoLayout *
+clutter_text_create_shared_layout (ClutterText       *text,
+                                   gint               width,
+                                   gint               height,
+                                   PangoEllipsizeMode ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextLayoutParams params;
+  PangoLayout *layout;
+  const gchar *contents;
+
+  if (!_clutter_text_layout_cache_is_enabled ())
+    return NULL;
+
+  /* editable texts change too often, and have a pre-edit string and
+   * per-actor attributes; password texts should not leave their
+   * contents around
+   */
+  if (priv->editable || priv->password_char != 0)
+    return NULL;
+
+  clutter_text_ensure_effective_attributes (text);
+  if (priv->effective_attrs != NULL)
+    return NULL;
+
+  contents = clutter_text_get_display_text (text);
+
+  params.text = contents;
+  params.font_desc = priv->font_desc;
+  params.direction = clutter_text_get_base_direction (text,
+                                                      contents,
+                                                      strlen (contents));
+  params.alignment = priv->alignment;
+  params.wrap_mode = priv->wrap_mode;
+  params.ellipsize = ellipsize;
+  params.width = width;
+  params.height = height;
+  params.justify = priv->justify;
+  params.single_line_mode = priv->single_line_mode;
+
+  priv->resolved_direction = params.direction;
+
+  layout = _clutter_text_layout_cache_get (&params);
 
   return layout;
 }
 
 static void
-clutter_text_dirty_cache (ClutterText *text)
+clutter_text_cancel_async_layouts (ClutterText *text)
 {
   ClutterTextPrivate *priv = text->priv;
+
+  if (priv->async_cancellable == NULL)
+    return;
+
+  /* the jobs are owned by their tasks, which are still running */
+  g_cancellable_cancel (priv->async_cancellable);
+  g_clear_object (&priv->async_cancellable);
+
+  g_slist_free (priv->async_jobs);
+  priv->async_jobs = NULL;
+}
+
+/*
+ * clutter_text_dirty_layouts:
+ * @text: a #ClutterText
+ *
+ * Drops the cached layouts of @text after its contents changed; the
+ * extents of the paragraphs do not depend on the contents of the other
+ * paragraphs, so they are kept.
+ */
+static void
+clutter_text_dirty_layouts (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *newest_cache = NULL;
   int i;
 
+  clutter_text_cancel_async_layouts (text);
+
+  g_clear_pointer (&priv->display_text, g_free);
+
+  /* Keep the most recent layout around while the new ones are
+   * shaped, instead of showing nothing
+   */
+  if (priv->async_layout)
+    {
+      for (i = 0; i < N_CACHED_LAYOUTS; i++)
+        if (priv->cached_layouts[i].layout != NULL &&
+            (newest_cache == NULL ||
+             priv->cached_layouts[i].age > newest_cache->age))
+          newest_cache = priv->cached_layouts + i;
+
+      if (newest_cache != NULL)
+        {
+          g_clear_object (&priv->async_placeholder);
+          priv->async_placeholder = g_object_ref (newest_cache->layout);
+        }
+    }
+
   /* Delete the cached layouts so they will be recreated the next time
      they are needed */
   for (i = 0; i < N_CACHED_LAYOUTS; i++)
@@ -593,6 +794,288 @@ clutter_text_dirty_cache (ClutterText *text)
   clutter_text_dirty_paint_volume (text);
 }
 
+/* a rough estimate of the memory used by the shaped glyphs, the
+ * logical attributes and the lines of a layout; see the layout cache
+ */
+static gsize
+layout_get_memory_size (PangoLayout *layout)
+{
+  return 512 + strlen (pango_layout_get_text (layout)) * 48;
+}
+
+/*< private >
+ * _clutter_text_get_memory_size:
+ * @text: a #ClutterText
+ *
+ * Estimates the memory used by the layouts cached by @text.
+ *
+ * Return value: the size, in bytes
+ */
+gsize
+_clutter_text_get_memory_size (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  gsize size = 0;
+  int i;
+
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      if (priv->cached_layouts[i].layout != NULL)
+        size += layout_get_memory_size (priv->cached_layouts[i].layout);
+    }
+
+  if (priv->async_placeholder != NULL)
+    size += layout_get_memory_size (priv->async_placeholder);
+
+  return size;
+}
+
+static void
+clutter_text_dirty_cache (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  clutter_text_dirty_layouts (text);
+
+  if (priv->paragraph_extents != NULL)
+    g_hash_table_remove_all (priv->paragraph_extents);
+
+  g_clear_pointer (&priv->selection_path, cogl_object_unref);
+  g_clear_object (&priv->selection_path_layout);
+}
+
+/*
+ * clutter_text_store_layout:
+ * @text: a #ClutterText
+ * @layout: (transfer full): a #PangoLayout
+ *
+ * Stores @layout in the free or least recently created slot of the
+ * layout cache of @text.
+ */
+static void
+clutter_text_store_layout (ClutterText *text,
+                           PangoLayout *layout)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *oldest_cache = NULL;
+  int i;
+
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      if (priv->cached_layouts[i].layout == NULL)
+        {
+          oldest_cache = priv->cached_layouts + i;
+          break;
+        }
+
+      if (oldest_cache == NULL ||
+          priv->cached_layouts[i].age < oldest_cache->age)
+        oldest_cache = priv->cached_layouts + i;
+    }
+
+  if (oldest_cache->layout != NULL)
+    g_object_unref (oldest_cache->layout);
+
+  oldest_cache->layout = layout;
+  oldest_cache->age = priv->cache_age++;
+
+  cogl_pango_ensure_glyph_cache_for_layout (layout);
+}
+
+typedef struct _AsyncLayout
+{
+  /* only accessed by the worker thread until the task returns */
+  PangoLayout *layout;
+
+  gint width;
+  gint height;
+  PangoEllipsizeMode ellipsize;
+} AsyncLayout;
+
+static void
+async_layout_free (gpointer data)
+{
+  AsyncLayout *job = data;
+
+  g_object_unref (job->layout);
+
+  g_slice_free (AsyncLayout, job);
+}
+
+static gboolean
+clutter_text_should_layout_async (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  if (!priv->async_layout || priv->editable)
+    return FALSE;
+
+  if (clutter_text_is_empty (text))
+    return FALSE;
+
+  return clutter_text_buffer_get_bytes (get_buffer (text)) >= ASYNC_LAYOUT_MIN_BYTES;
+}
+
+/*
+ * clutter_text_create_async_context:
+ * @text: a #ClutterText
+ *
+ * Creates a #PangoContext with the same settings as the context of
+ * @text, using a font map of its own: font maps cannot be used by two
+ * threads at the same time, and the font map is used by the worker
+ * thread until the layout has been shaped.
+ */
+static PangoContext *
+clutter_text_create_async_context (ClutterText *text)
+{
+  PangoContext *actor_context, *context;
+  CoglPangoFontMap *default_font_map;
+  PangoFontMap *font_map;
+  gdouble resolution;
+
+  actor_context = clutter_actor_get_pango_context (CLUTTER_ACTOR (text));
+  resolution = pango_cairo_context_get_resolution (actor_context);
+
+  default_font_map = COGL_PANGO_FONT_MAP (clutter_get_font_map ());
+
+  font_map = cogl_pango_font_map_new ();
+  cogl_pango_font_map_set_resolution (COGL_PANGO_FONT_MAP (font_map),
+                                      resolution);
+  cogl_pango_font_map_set_use_mipmapping (COGL_PANGO_FONT_MAP (font_map),
+                                          cogl_pango_font_map_get_use_mipmapping (default_font_map));
+
+  context = cogl_pango_font_map_create_context (COGL_PANGO_FONT_MAP (font_map));
+  g_object_unref (font_map);
+
+  pango_context_set_font_description (context, pango_context_get_font_description (actor_context));
+  pango_context_set_language (context, pango_context_get_language (actor_context));
+  pango_cairo_context_set_font_options (context, pango_cairo_context_get_font_options (actor_context));
+  pango_cairo_context_set_resolution (context, resolution);
+
+  return context;
+}
+
+static void
+clutter_text_async_layout_thread (GTask        *task,
+                                  gpointer      source_object,
+                                  gpointer      task_data,
+                                  GCancellable *cancellable)
+{
+  AsyncLayout *job = task_data;
+
+  /* shapes the text and breaks it into lines */
+  pango_layout_get_extents (job->layout, NULL, NULL);
+
+  g_task_return_boolean (task, TRUE);
+}
+
+static void
+clutter_text_async_layout_done (GObject      *gobject,
+                                GAsyncResult *result,
+                                gpointer      user_data)
+{
+  ClutterText *text = CLUTTER_TEXT (gobject);
+  ClutterTextPrivate *priv = text->priv;
+  AsyncLayout *job = g_task_get_task_data (G_TASK (result));
+
+  priv->async_jobs = g_slist_remove (priv->async_jobs, job);
+
+  /* the contents changed, or the actor was disposed */
+  if (!g_task_propagate_boolean (G_TASK (result), NULL))
+    return;
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: shaped layout for size %dx%d",
+                text,
+                job->width,
+                job->height);
+
+  clutter_text_store_layout (text, g_object_ref (job->layout));
+
+  if (priv->async_jobs == NULL)
+    g_clear_object (&priv->async_placeholder);
+
+  clutter_text_dirty_paint_volume (text);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+}
+
+/*
+ * clutter_text_create_async_layout:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode
+ *
+ * Starts shaping a layout for @text on a worker thread, unless one
+ * with the same size is already being shaped; the layout is stored in
+ * the cache once it is ready.
+ *
+ * Return value: (transfer none): the layout to use in the meantime
+ */
+static PangoLayout *
+clutter_text_create_async_layout (ClutterText       *text,
+                                  gint               width,
+                                  gint               height,
+                                  PangoEllipsizeMode ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  gboolean is_pending = FALSE;
+  GSList *l;
+
+  for (l = priv->async_jobs; l != NULL; l = l->next)
+    {
+      AsyncLayout *job = l->data;
+
+      if (job->width == width &&
+          job->height == height &&
+          job->ellipsize == ellipsize)
+        {
+          is_pending = TRUE;
+          break;
+        }
+    }
+
+  if (!is_pending)
+    {
+      AsyncLayout *job;
+      PangoContext *context;
+      GTask *task;
+
+      if (priv->async_cancellable == NULL)
+        priv->async_cancellable = g_cancellable_new ();
+
+      context = clutter_text_create_async_context (text);
+
+      job = g_slice_new (AsyncLayout);
+      job->layout = pango_layout_new (context);
+      job->width = width;
+      job->height = height;
+      job->ellipsize = ellipsize;
+
+      g_object_unref (context);
+
+      clutter_text_setup_layout (text, job->layout, width, height, ellipsize);
+
+      task = g_task_new (text, priv->async_cancellable,
+                         clutter_text_async_layout_done,
+                         NULL);
+      g_task_set_task_data (task, job, async_layout_free);
+      g_task_run_in_thread (task, clutter_text_async_layout_thread);
+      g_object_unref (task);
+
+      priv->async_jobs = g_slist_prepend (priv->async_jobs, job);
+    }
+
+  if (priv->async_placeholder == NULL)
+    {
+      priv->async_placeholder =
+        clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+      pango_layout_set_font_description (priv->async_placeholder,
+                                         priv->font_desc);
+    }
+
+  return priv->async_placeholder;
+}
+
 /*
  * clutter_text_set_font_description_internal:
  * @self: a #ClutterText
@@ -637,25 +1120,17 @@ clutter_text_set_font_description_internal (ClutterText          *self,
 }
 
 static void
-clutter_text_settings_changed_cb (ClutterText *text)
+clutter_text_apply_settings_changes (ClutterText           *text,
+                                     ClutterSettingsChange  changes)
 {
   ClutterTextPrivate *priv = text->priv;
-  guint password_hint_time = 0;
-  ClutterSettings *settings;
-
-  settings = clutter_settings_get_default ();
-
-  g_object_get (settings, "password-hint-time", &password_hint_time, NULL);
-
-  priv->show_password_hint = password_hint_time > 0;
-  priv->password_hint_timeout = password_hint_time;
 
-  if (priv->is_default_font)
+  if ((changes & CLUTTER_SETTINGS_CHANGE_FONT_NAME) && priv->is_default_font)
     {
       PangoFontDescription *font_desc;
       gchar *font_name = NULL;
 
-      g_object_get (settings, "font-name", &font_name, NULL);
+      g_object_get (clutter_settings_get_default (), "font-name", &font_name, NULL);
 
       CLUTTER_NOTE (ACTOR, "Text[%p]: default font changed to '%s'",
                     text,
@@ -668,8 +1143,77 @@ clutter_text_settings_changed_cb (ClutterText *text)
       g_free (font_name);
     }
 
-  clutter_text_dirty_cache (text);
-  clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+  if (changes & (CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION |
+                 CLUTTER_SETTINGS_CHANGE_FONT_METRICS))
+    {
+      clutter_text_dirty_cache (text);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+    }
+  else if (changes & CLUTTER_SETTINGS_CHANGE_FONT_RENDERING)
+    {
+      /* the glyphs are rasterized again, but the layouts stay valid */
+      clutter_actor_queue_redraw (CLUTTER_ACTOR (text));
+    }
+}
+
+static void
+clutter_text_settings_changed_cb (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterSettingsChange changes;
+  ClutterSettings *settings;
+
+  settings = clutter_settings_get_default ();
+  changes = _clutter_settings_get_changes (settings);
+
+  if (changes & CLUTTER_SETTINGS_CHANGE_INPUT)
+    {
+      guint password_hint_time = 0;
+
+      g_object_get (settings, "password-hint-time", &password_hint_time, NULL);
+
+      priv->show_password_hint = password_hint_time > 0;
+      priv->password_hint_timeout = password_hint_time;
+    }
+
+  /* only the changes that can affect this text are considered */
+  if (!priv->is_default_font)
+    changes &= ~CLUTTER_SETTINGS_CHANGE_FONT_NAME;
+
+  if (priv->font_desc != NULL &&
+      pango_font_description_get_size_is_absolute (priv->font_desc))
+    changes &= ~CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION;
+
+  changes &= (CLUTTER_SETTINGS_CHANGE_FONT_NAME |
+              CLUTTER_SETTINGS_CHANGE_FONT_RESOLUTION |
+              CLUTTER_SETTINGS_CHANGE_FONT_METRICS |
+              CLUTTER_SETTINGS_CHANGE_FONT_RENDERING);
+  if (changes == 0)
+    return;
+
+  /* the text that is not on screen is shaped again once it is mapped,
+   * so that a theme change does not shape every text at once
+   */
+  if (!CLUTTER_ACTOR_IS_MAPPED (text))
+    {
+      priv->pending_settings_changes |= changes;
+      return;
+    }
+
+  clutter_text_apply_settings_changes (text, changes);
+}
+
+static void
+clutter_text_flush_settings_changes (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterSettingsChange changes = priv->pending_settings_changes;
+
+  if (G_LIKELY (changes == 0))
+    return;
+
+  priv->pending_settings_changes = 0;
+  clutter_text_apply_settings_changes (text, changes);
 }
 
 static void
@@ -682,28 +1226,29 @@ clutter_text_direction_changed_cb (GObject    *gobject,
 }
 
 /*
- * clutter_text_create_layout:
+ * clutter_text_get_layout_params:
  * @text: a #ClutterText
  * @allocation_width: the allocation width
  * @allocation_height: the allocation height
+ * @width_p: (out): return location for the width of the layout
+ * @height_p: (out): return location for the height of the layout
+ * @ellipsize_p: (out): return location for the ellipsize mode
  *
- * Like clutter_text_create_layout_no_cache(), but will also ensure
- * the glyphs cache. If a previously cached layout generated using the
- * same width is available then that will be used instead of
- * generating a new one.
+ * Computes the width, height and ellipsize mode of the layout created
+ * by clutter_text_create_layout() for the given allocation.
  */
-static PangoLayout *
-clutter_text_create_layout (ClutterText *text,
-                            gfloat       allocation_width,
-                            gfloat       allocation_height)
+static void
+clutter_text_get_layout_params (ClutterText        *text,
+                                gfloat              allocation_width,
+                                gfloat              allocation_height,
+                                gint               *width_p,
+                                gint               *height_p,
+                                PangoEllipsizeMode *ellipsize_p)
 {
   ClutterTextPrivate *priv = text->priv;
-  LayoutCache *oldest_cache = priv->cached_layouts;
-  gboolean found_free_cache = FALSE;
   gint width = -1;
   gint height = -1;
   PangoEllipsizeMode ellipsize = PANGO_ELLIPSIZE_NONE;
-  int i;
 
   /* First determine the width, height, and ellipsize mode that
    * we need for the layout. The ellipsize mode depends on
@@ -768,6 +1313,42 @@ clutter_text_create_layout (ClutterText *text,
       height = allocation_height * 1024 + 0.5f;
     }
 
+  *width_p = width;
+  *height_p = height;
+  *ellipsize_p = ellipsize;
+}
+
+/*
+ * clutter_text_create_layout:
+ * @text: a #ClutterText
+ * @allocation_width: the allocation width
+ * @allocation_height: the allocation height
+ *
+ * Like clutter_text_create_layout_no_cache(), but will also ensure
+ * the glyphs cache. If a previously cached layout generated using the
+ * same width is available then that will be used instead of
+ * generating a new one.
+ */
+static PangoLayout *
+clutter_text_create_layout (ClutterText *text,
+                            gfloat       allocation_width,
+                            gfloat       allocation_height)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *oldest_cache = priv->cached_layouts;
+  gboolean found_free_cache = FALSE;
+  gint width;
+  gint height;
+  PangoEllipsizeMode ellipsize;
+  int i;
+
+  clutter_text_get_layout_params (text,
+                                  allocation_width,
+                                  allocation_height,
+                                  &width,
+                                  &height,
+                                  &ellipsize);
+
   /* Search for a cached layout with the same width and keep
    * track of the oldest one
    */
@@ -847,16 +1428,29 @@ clutter_text_create_layout (ClutterText *text,
                 allocation_width,
                 allocation_height);
 
+  if (clutter_text_should_layout_async (text))
+    return clutter_text_create_async_layout (text, width, height, ellipsize);
+
+  g_clear_object (&priv->async_placeholder);
+
   /* If we make it here then we didn't have a cached version so we
      need to recreate the layout */
   if (oldest_cache->layout)
     g_object_unref (oldest_cache->layout);
 
+  CLUTTER_TRACE_BEGIN (TEXT, "ClutterText::create-layout");
+
   oldest_cache->layout =
-    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+    clutter_text_create_shared_layout (text, width, height, ellipsize);
+
+  if (oldest_cache->layout == NULL)
+    oldest_cache->layout =
+      clutter_text_create_layout_no_cache (text, width, height, ellipsize);
 
   cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
 
+  CLUTTER_TRACE_END (TEXT);
+
   /* Mark the 'time' this cache was created and advance the time */
   oldest_cache->age = priv->cache_age++;
   return oldest_cache->layout;
@@ -959,7 +1553,7 @@ clutter_text_position_to_coords (ClutterText *self,
     }
   else
     {
-      gchar *text = clutter_text_get_display_text (self);
+      const gchar *text = clutter_text_get_display_text (self);
       GString *tmp = g_string_new (text);
       gint cursor_index;
 
@@ -973,7 +1567,6 @@ clutter_text_position_to_coords (ClutterText *self,
       else
         index_ = position * password_char_bytes;
 
-      g_free (text);
       g_string_free (tmp, TRUE);
     }
 
@@ -1246,6 +1839,14 @@ clutter_text_set_property (GObject      *gobject,
       clutter_text_set_justify (self, g_value_get_boolean (value));
       break;
 
+    case PROP_ASYNC_LAYOUT:
+      clutter_text_set_async_layout (self, g_value_get_boolean (value));
+      break;
+
+    case PROP_USE_DISTANCE_FIELD:
+      clutter_text_set_use_distance_field (self, g_value_get_boolean (value));
+      break;
+
     case PROP_ELLIPSIZE:
       clutter_text_set_ellipsize (self, g_value_get_enum (value));
       break;
@@ -1420,6 +2021,14 @@ clutter_text_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->justify);
       break;
 
+    case PROP_ASYNC_LAYOUT:
+      g_value_set_boolean (value, priv->async_layout);
+      break;
+
+    case PROP_USE_DISTANCE_FIELD:
+      g_value_set_boolean (value, priv->use_distance_field);
+      break;
+
     case PROP_ATTRIBUTES:
       g_value_set_boxed (value, priv->attrs);
       break;
@@ -1445,6 +2054,7 @@ clutter_text_dispose (GObject *gobject)
 
   /* get rid of the entire cache */
   clutter_text_dirty_cache (self);
+  g_clear_object (&priv->async_placeholder);
 
   if (priv->direction_changed_id)
     {
@@ -1479,6 +2089,9 @@ clutter_text_finalize (GObject *gobject)
   if (priv->font_desc)
     pango_font_description_free (priv->font_desc);
 
+  if (priv->paragraph_extents != NULL)
+    g_hash_table_unref (priv->paragraph_extents);
+
   if (priv->attrs)
     pango_attr_list_unref (priv->attrs);
   if (priv->markup_attrs)
@@ -1507,7 +2120,7 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
 {
   ClutterTextPrivate *priv = self->priv;
   PangoLayout *layout = clutter_text_get_layout (self);
-  gchar *utf8 = clutter_text_get_display_text (self);
+  const gchar *utf8 = clutter_text_get_display_text (self);
   gint lines;
   gint start_index;
   gint end_index;
@@ -1583,8 +2196,6 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
 
       g_free (ranges);
     }
-
-  g_free (utf8);
 }
 
 static void
@@ -1595,6 +2206,178 @@ add_selection_rectangle_to_path (ClutterText           *text,
   cogl_path_rectangle (user_data, box->x1, box->y1, box->x2, box->y2);
 }
 
+/* retrieves the path of the selection for @layout, which is only
+ * built again when the selection or the layout change
+ */
+static CoglPath *
+clutter_text_get_selection_path (ClutterText *self,
+                                 PangoLayout *layout)
+{
+  ClutterTextPrivate *priv = self->priv;
+
+  if (priv->selection_path != NULL &&
+      priv->selection_path_layout == layout &&
+      priv->selection_path_position == priv->position &&
+      priv->selection_path_bound == priv->selection_bound &&
+      priv->selection_path_text_x == priv->text_x)
+    return priv->selection_path;
+
+  g_clear_pointer (&priv->selection_path, cogl_object_unref);
+  g_clear_object (&priv->selection_path_layout);
+
+  priv->selection_path = cogl_path_new ();
+  clutter_text_foreach_selection_rectangle (self,
+                                            add_selection_rectangle_to_path,
+                                            priv->selection_path);
+
+  priv->selection_path_layout = g_object_ref (layout);
+  priv->selection_path_position = priv->position;
+  priv->selection_path_bound = priv->selection_bound;
+  priv->selection_path_text_x = priv->text_x;
+
+  return priv->selection_path;
+}
+
+/* layouts with fewer lines are always rendered at once, since
+ * cogl-pango keeps the geometry of whole layouts between frames,
+ * while lines are rendered from scratch
+ */
+#define CLIPPED_RENDER_MIN_LINES        64
+
+/*
+ * clutter_text_use_distance_field:
+ * @text: a #ClutterText
+ *
+ * Checks whether the layout of @text should be drawn using the distance
+ * field glyphs. The attributes of the text can change the color of
+ * parts of it, and the pre-edit string is underlined, so those layouts
+ * always go through cogl-pango.
+ */
+static gboolean
+clutter_text_use_distance_field (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  if (!priv->use_distance_field && !_clutter_get_distance_field_text ())
+    return FALSE;
+
+  if (priv->effective_attrs != NULL || priv->preedit_set)
+    return FALSE;
+
+  return _clutter_sdf_glyph_cache_is_supported ();
+}
+
+/*
+ * clutter_text_render_layout:
+ * @text: a #ClutterText
+ * @layout: the #PangoLayout to render
+ * @x: the X coordinate of @layout
+ * @y: the Y coordinate of @layout
+ * @color: the color of the text
+ *
+ * Renders @layout; if it has many lines and only a part of them is
+ * inside the region of the stage being painted, for instance because
+ * @text is inside a #ClutterScrollActor, only the visible lines are
+ * rendered.
+ */
+static void
+clutter_text_render_layout (ClutterText     *text,
+                            PangoLayout     *layout,
+                            gint             x,
+                            gint             y,
+                            const CoglColor *color)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (text);
+  ClutterActor *stage;
+  ClutterActorBox clip;
+  PangoRectangle logical_rect;
+  PangoLayoutIter *iter;
+  CoglFramebuffer *fb;
+  gint clip_y1, clip_y2;
+  guint n_lines = 0;
+
+  if (clutter_text_use_distance_field (text))
+    {
+      /* the distance field glyphs are always drawn line by line */
+      stage = _clutter_actor_get_stage_internal (actor);
+      if (stage != NULL &&
+          _clutter_actor_get_paint_clip_box (actor, CLUTTER_STAGE (stage), &clip))
+        {
+          clip_y1 = floorf ((clip.y1 - y) * PANGO_SCALE);
+          clip_y2 = ceilf ((clip.y2 - y) * PANGO_SCALE);
+        }
+      else
+        {
+          clip_y1 = G_MININT;
+          clip_y2 = G_MAXINT;
+        }
+
+      _clutter_sdf_glyph_cache_render_layout (cogl_get_draw_framebuffer (),
+                                              layout,
+                                              x, y,
+                                              clip_y1, clip_y2,
+                                              color);
+      return;
+    }
+
+  if (pango_layout_get_line_count (layout) < CLIPPED_RENDER_MIN_LINES)
+    goto render_all;
+
+  stage = _clutter_actor_get_stage_internal (actor);
+  if (stage == NULL ||
+      !_clutter_actor_get_paint_clip_box (actor, CLUTTER_STAGE (stage), &clip))
+    goto render_all;
+
+  /* the clip, in Pango units relative to the layout */
+  clip_y1 = floorf ((clip.y1 - y) * PANGO_SCALE);
+  clip_y2 = ceilf ((clip.y2 - y) * PANGO_SCALE);
+
+  pango_layout_get_extents (layout, NULL, &logical_rect);
+  if (logical_rect.y >= clip_y1 &&
+      logical_rect.y + logical_rect.height <= clip_y2)
+    goto render_all;
+
+  fb = cogl_get_draw_framebuffer ();
+
+  iter = pango_layout_get_iter (layout);
+
+  do
+    {
+      PangoRectangle line_rect;
+      gint line_y1, line_y2, baseline;
+
+      pango_layout_iter_get_line_yrange (iter, &line_y1, &line_y2);
+
+      if (line_y2 < clip_y1)
+        continue;
+
+      if (line_y1 > clip_y2)
+        break;
+
+      pango_layout_iter_get_line_extents (iter, NULL, &line_rect);
+      baseline = pango_layout_iter_get_baseline (iter);
+
+      cogl_pango_show_layout_line (fb,
+                                   pango_layout_iter_get_line_readonly (iter),
+                                   x + (float) line_rect.x / PANGO_SCALE,
+                                   y + (float) baseline / PANGO_SCALE,
+                                   color);
+      n_lines += 1;
+    }
+  while (pango_layout_iter_next_line (iter));
+
+  pango_layout_iter_free (iter);
+
+  CLUTTER_NOTE (PAINT, "Rendered %u of the %d lines of the layout",
+                n_lines,
+                pango_layout_get_line_count (layout));
+
+  return;
+
+render_all:
+  cogl_pango_render_layout (layout, x, y, color, 0);
+}
+
 /* Draws the selected text, its background, and the cursor */
 static void
 selection_paint (ClutterText *self)
@@ -1635,7 +2418,7 @@ selection_paint (ClutterText *self)
         {
           /* Paint selection background first */
           PangoLayout *layout = clutter_text_get_layout (self);
-          CoglPath *selection_path = cogl_path_new ();
+          CoglPath *selection_path;
           CoglColor cogl_color = { 0, };
           CoglFramebuffer *fb;
 
@@ -1656,15 +2439,12 @@ selection_paint (ClutterText *self)
                                     color->blue,
                                     paint_opacity * color->alpha / 255);
 
-          clutter_text_foreach_selection_rectangle (self,
-                                                    add_selection_rectangle_to_path,
-                                                    selection_path);
+          selection_path = clutter_text_get_selection_path (self, layout);
 
           cogl_path_fill (selection_path);
 
           /* Paint selected text */
           cogl_framebuffer_push_path_clip (fb, selection_path);
-          cogl_object_unref (selection_path);
 
           if (priv->selected_text_color_set)
             color = &priv->selected_text_color;
@@ -1677,7 +2457,7 @@ selection_paint (ClutterText *self)
                                     color->blue,
                                     paint_opacity * color->alpha / 255);
 
-          cogl_pango_render_layout (layout, priv->text_x, 0, &cogl_color, 0);
+          clutter_text_render_layout (self, layout, priv->text_x, 0, &cogl_color);
 
           cogl_framebuffer_pop_clip (fb);
         }
@@ -2125,10 +2905,13 @@ clutter_text_key_press (ClutterActor    *actor,
                 g_source_remove (priv->password_hint_id);
 
               priv->password_hint_visible = TRUE;
+              g_clear_pointer (&priv->display_text, g_free);
+              /* hiding the hint does not need to be accurate */
               priv->password_hint_id =
-                clutter_threads_add_timeout (priv->password_hint_timeout,
-                                             clutter_text_remove_password_hint,
-                                             self);
+                clutter_threads_add_coalesced_timeout (priv->password_hint_timeout,
+                                                       priv->password_hint_timeout / 4,
+                                                       clutter_text_remove_password_hint,
+                                                       self);
             }
 
           return CLUTTER_EVENT_STOP;
@@ -2209,6 +2992,14 @@ clutter_text_compute_layout_offsets (ClutterText           *self,
 
 #define TEXT_PADDING    2
 
+static void
+clutter_text_map (ClutterActor *self)
+{
+  CLUTTER_ACTOR_CLASS (clutter_text_parent_class)->map (self);
+
+  clutter_text_flush_settings_changes (CLUTTER_TEXT (self));
+}
+
 static void
 clutter_text_paint (ClutterActor *self)
 {
@@ -2310,7 +3101,7 @@ clutter_text_paint (ClutterActor *self)
 
       pango_layout_get_extents (layout, NULL, &logical_rect);
 
-      cogl_framebuffer_push_rectangle_clip (fb, 0, 0, alloc_width, alloc_height);
+      _clutter_util_push_rectangle_clip (fb, 0, 0, alloc_width, alloc_height);
       clip_set = TRUE;
 
       actor_width = alloc_width - 2 * TEXT_PADDING;
@@ -2357,7 +3148,7 @@ clutter_text_paint (ClutterActor *self)
       if (logical_rect.width > alloc_width ||
           logical_rect.height > alloc_height)
         {
-          cogl_framebuffer_push_rectangle_clip (fb, 0, 0, alloc_width, alloc_height);
+          _clutter_util_push_rectangle_clip (fb, 0, 0, alloc_width, alloc_height);
           clip_set = TRUE;
         }
 
@@ -2387,7 +3178,7 @@ clutter_text_paint (ClutterActor *self)
                             priv->text_color.green,
                             priv->text_color.blue,
                             real_opacity);
-  cogl_pango_render_layout (layout, priv->text_x, priv->text_y, &color, 0);
+  clutter_text_render_layout (text, layout, priv->text_x, priv->text_y, &color);
 
   selection_paint (text);
 
@@ -2445,74 +3236,384 @@ clutter_text_get_paint_volume_for_cursor (ClutterText        *text,
     }
 }
 
-static gboolean
-clutter_text_get_paint_volume (ClutterActor       *self,
-                               ClutterPaintVolume *volume)
+static gboolean
+clutter_text_get_paint_volume (ClutterActor       *self,
+                               ClutterPaintVolume *volume)
+{
+  ClutterText *text = CLUTTER_TEXT (self);
+  ClutterTextPrivate *priv = text->priv;
+
+  /* ClutterText uses the logical layout as the natural size of the
+     actor. This means that it can sometimes paint outside of its
+     allocation for example with italic fonts with serifs. Therefore
+     we should use the ink rectangle of the layout instead */
+
+  if (!priv->paint_volume_valid)
+    {
+      PangoLayout *layout;
+      PangoRectangle ink_rect, logical_rect;
+      ClutterActorBox alloc;
+      ClutterVertex origin;
+      gfloat x1, y1, x2, y2;
+
+      /* If the text is single line editable then it gets clipped to
+         the allocation anyway so we can just use that */
+      if (priv->editable && priv->single_line_mode)
+        return _clutter_actor_set_default_paint_volume (self,
+                                                        CLUTTER_TYPE_TEXT,
+                                                        volume);
+
+      if (G_OBJECT_TYPE (self) != CLUTTER_TYPE_TEXT)
+        return FALSE;
+
+      if (!clutter_actor_has_allocation (self))
+        return FALSE;
+
+      _clutter_paint_volume_init_static (&priv->paint_volume, self);
+
+      layout = clutter_text_get_layout (text);
+      pango_layout_get_extents (layout, &ink_rect, NULL);
+      pango_layout_get_pixel_extents (layout, NULL, &logical_rect);
+
+      x1 = ink_rect.x / (float) PANGO_SCALE;
+      y1 = ink_rect.y / (float) PANGO_SCALE;
+      x2 = (ink_rect.x + ink_rect.width) / (float) PANGO_SCALE;
+      y2 = (ink_rect.y + ink_rect.height) / (float) PANGO_SCALE;
+
+      /* clutter_text_paint() clips the layouts overflowing the
+       * allocation of non-editable texts, so the parts outside of
+       * the allocation are never painted
+       */
+      clutter_actor_get_allocation_box (self, &alloc);
+      if (!priv->editable && !(priv->wrap && priv->ellipsize) &&
+          (logical_rect.width > alloc.x2 - alloc.x1 ||
+           logical_rect.height > alloc.y2 - alloc.y1))
+        {
+          x1 = CLAMP (x1, 0, alloc.x2 - alloc.x1);
+          y1 = CLAMP (y1, 0, alloc.y2 - alloc.y1);
+          x2 = CLAMP (x2, 0, alloc.x2 - alloc.x1);
+          y2 = CLAMP (y2, 0, alloc.y2 - alloc.y1);
+        }
+
+      origin.x = x1;
+      origin.y = y1;
+      origin.z = 0;
+      clutter_paint_volume_set_origin (&priv->paint_volume, &origin);
+      clutter_paint_volume_set_width (&priv->paint_volume, x2 - x1);
+      clutter_paint_volume_set_height (&priv->paint_volume, y2 - y1);
+
+      /* If the cursor is visible then that will likely be drawn
+         outside of the ink rectangle so we should merge that in */
+      if (priv->editable && priv->cursor_visible && priv->has_focus)
+        {
+          ClutterPaintVolume cursor_paint_volume;
+
+          _clutter_paint_volume_init_static (&cursor_paint_volume,
+                                             self);
+
+          clutter_text_get_paint_volume_for_cursor (text, &cursor_paint_volume);
+
+          clutter_paint_volume_union (&priv->paint_volume,
+                                      &cursor_paint_volume);
+
+          clutter_paint_volume_free (&cursor_paint_volume);
+        }
+
+      priv->paint_volume_valid = TRUE;
+    }
+
+  _clutter_paint_volume_copy_static (&priv->paint_volume, volume);
+
+  return TRUE;
+}
+
+/* computes the width request of a text from its unconstrained @layout;
+ * @shrinkable texts can be allocated less than their natural width,
+ * and @padded texts leave room for the cursor
+ */
+static void
+clutter_text_get_width_request (gint      logical_width,
+                                gboolean  shrinkable,
+                                gboolean  padded,
+                                gfloat   *min_width_p,
+                                gfloat   *natural_width_p)
+{
+  gfloat layout_width;
+
+  layout_width = logical_width > 0
+    ? ceilf (logical_width / 1024.0f)
+    : 1;
+
+  if (min_width_p)
+    {
+      if (shrinkable)
+        *min_width_p = 1;
+      else
+        *min_width_p = layout_width;
+    }
+
+  if (natural_width_p)
+    {
+      if (padded)
+        *natural_width_p = layout_width + TEXT_PADDING * 2;
+      else
+        *natural_width_p = layout_width;
+    }
+}
+
+static void
+clutter_text_layout_get_width_request (PangoLayout *layout,
+                                       gboolean     shrinkable,
+                                       gboolean     padded,
+                                       gfloat      *min_width_p,
+                                       gfloat      *natural_width_p)
+{
+  PangoRectangle logical_rect = { 0, };
+
+  pango_layout_get_extents (layout, NULL, &logical_rect);
+
+  /* the X coordinate of the logical rectangle might be non-zero
+   * according to the Pango documentation; hence, we need to offset
+   * the width accordingly
+   */
+  clutter_text_get_width_request (logical_rect.x + logical_rect.width,
+                                  shrinkable,
+                                  padded,
+                                  min_width_p,
+                                  natural_width_p);
+}
+
+/* computes the height request of a text from its @layout; the minimum
+ * height is the height of the first line if @first_line_min is set
+ */
+static void
+clutter_text_layout_get_height_request (PangoLayout *layout,
+                                        gboolean     first_line_min,
+                                        gfloat      *min_height_p,
+                                        gfloat      *natural_height_p)
+{
+  PangoRectangle logical_rect = { 0, };
+  gint logical_height;
+  gfloat layout_height;
+
+  pango_layout_get_extents (layout, NULL, &logical_rect);
+
+  /* the Y coordinate of the logical rectangle might be non-zero
+   * according to the Pango documentation; hence, we need to offset
+   * the height accordingly
+   */
+  logical_height = logical_rect.y + logical_rect.height;
+  layout_height = ceilf (logical_height / 1024.0f);
+
+  if (min_height_p)
+    {
+      if (first_line_min)
+        {
+          PangoLayoutLine *line;
+          gfloat line_height;
+
+          line = pango_layout_get_line_readonly (layout, 0);
+          pango_layout_line_get_extents (line, NULL, &logical_rect);
+
+          logical_height = logical_rect.y + logical_rect.height;
+          line_height = ceilf (logical_height / 1024.0f);
+
+          *min_height_p = line_height;
+        }
+      else
+        *min_height_p = layout_height;
+    }
+
+  if (natural_height_p)
+    *natural_height_p = layout_height;
+}
+
+typedef struct _ParagraphExtents
+{
+  /* the logical extents of the unwrapped paragraph, in Pango units */
+  gint width;
+  gint height;
+
+  /* the height of the paragraph wrapped at wrap_width, or -1 */
+  gint wrap_width;
+  gint wrapped_height;
+
+  /* the last measure using the paragraph */
+  guint serial;
+} ParagraphExtents;
+
+static void
+paragraph_extents_free (gpointer data)
+{
+  g_slice_free (ParagraphExtents, data);
+}
+
+static gboolean
+paragraph_extents_is_stale (gpointer key,
+                            gpointer value,
+                            gpointer user_data)
+{
+  ParagraphExtents *extents = value;
+
+  return extents->serial != GPOINTER_TO_UINT (user_data);
+}
+
+/* editable multi-line texts without attributes are measured one
+ * paragraph at a time, so that editing a paragraph only requires
+ * shaping that paragraph again to compute the size of the text
+ */
+static gboolean
+clutter_text_use_paragraph_extents (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  if (!priv->editable || priv->single_line_mode)
+    return FALSE;
+
+  if (priv->preedit_set ||
+      priv->password_char != 0 ||
+      priv->ellipsize != PANGO_ELLIPSIZE_NONE)
+    return FALSE;
+
+  clutter_text_ensure_effective_attributes (text);
+
+  return priv->effective_attrs == NULL;
+}
+
+static void
+clutter_text_measure_paragraph (ClutterText       *text,
+                                const gchar       *paragraph,
+                                gint               width,
+                                PangoRectangle    *logical_rect)
+{
+  ClutterTextPrivate *priv = text->priv;
+  PangoLayout *layout;
+
+  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), paragraph);
+  pango_layout_set_font_description (layout, priv->font_desc);
+  pango_layout_set_alignment (layout, priv->alignment);
+  pango_layout_set_justify (layout, priv->justify);
+  pango_layout_set_wrap (layout, priv->wrap_mode);
+  pango_layout_set_width (layout, width);
+
+  pango_layout_get_extents (layout, NULL, logical_rect);
+
+  g_object_unref (layout);
+}
+
+/*
+ * clutter_text_get_paragraph_extents:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @width_p: (out): return location for the logical width of the
+ *   unwrapped contents, in Pango units
+ * @height_p: (out): return location for the logical height of the
+ *   contents laid out at @width, in Pango units
+ *
+ * Computes the extents of the layout of @text from the extents of each
+ * of its paragraphs, which Pango lays out independently; only the
+ * paragraphs that were not measured yet are shaped.
+ */
+static void
+clutter_text_get_paragraph_extents (ClutterText *text,
+                                    gint         width,
+                                    gint        *width_p,
+                                    gint        *height_p)
 {
-  ClutterText *text = CLUTTER_TEXT (self);
   ClutterTextPrivate *priv = text->priv;
+  PangoContext *context;
+  const gchar *contents;
+  const gchar *paragraph;
+  gint remaining, max_width, total_height;
+  guint n_paragraphs, serial;
 
-  /* ClutterText uses the logical layout as the natural size of the
-     actor. This means that it can sometimes paint outside of its
-     allocation for example with italic fonts with serifs. Therefore
-     we should use the ink rectangle of the layout instead */
-
-  if (!priv->paint_volume_valid)
-    {
-      PangoLayout *layout;
-      PangoRectangle ink_rect;
-      ClutterVertex origin;
+  if (priv->paragraph_extents == NULL)
+    priv->paragraph_extents = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                     g_free,
+                                                     paragraph_extents_free);
 
-      /* If the text is single line editable then it gets clipped to
-         the allocation anyway so we can just use that */
-      if (priv->editable && priv->single_line_mode)
-        return _clutter_actor_set_default_paint_volume (self,
-                                                        CLUTTER_TYPE_TEXT,
-                                                        volume);
+  contents = clutter_text_get_display_text (text);
+  remaining = strlen (contents);
 
-      if (G_OBJECT_TYPE (self) != CLUTTER_TYPE_TEXT)
-        return FALSE;
+  context = clutter_actor_get_pango_context (CLUTTER_ACTOR (text));
+  priv->resolved_direction =
+    clutter_text_get_base_direction (text, contents, remaining);
+  pango_context_set_base_dir (context, priv->resolved_direction);
 
-      if (!clutter_actor_has_allocation (self))
-        return FALSE;
+  serial = ++priv->paragraph_serial;
+  n_paragraphs = 0;
+  max_width = 0;
+  total_height = 0;
 
-      _clutter_paint_volume_init_static (&priv->paint_volume, self);
+  paragraph = contents;
+  while (TRUE)
+    {
+      ParagraphExtents *extents;
+      PangoRectangle logical_rect;
+      gint delimiter, next;
+      gchar *key;
 
-      layout = clutter_text_get_layout (text);
-      pango_layout_get_extents (layout, &ink_rect, NULL);
+      pango_find_paragraph_boundary (paragraph, remaining, &delimiter, &next);
 
-      origin.x = ink_rect.x / (float) PANGO_SCALE;
-      origin.y = ink_rect.y / (float) PANGO_SCALE;
-      origin.z = 0;
-      clutter_paint_volume_set_origin (&priv->paint_volume, &origin);
-      clutter_paint_volume_set_width (&priv->paint_volume,
-                                      ink_rect.width / (float) PANGO_SCALE);
-      clutter_paint_volume_set_height (&priv->paint_volume,
-                                       ink_rect.height / (float) PANGO_SCALE);
+      key = g_strndup (paragraph, delimiter);
 
-      /* If the cursor is visible then that will likely be drawn
-         outside of the ink rectangle so we should merge that in */
-      if (priv->editable && priv->cursor_visible && priv->has_focus)
+      extents = g_hash_table_lookup (priv->paragraph_extents, key);
+      if (extents == NULL)
         {
-          ClutterPaintVolume cursor_paint_volume;
+          clutter_text_measure_paragraph (text, key, -1, &logical_rect);
 
-          _clutter_paint_volume_init_static (&cursor_paint_volume,
-                                             self);
+          extents = g_slice_new (ParagraphExtents);
+          extents->width = logical_rect.x + logical_rect.width;
+          extents->height = logical_rect.y + logical_rect.height;
+          extents->wrap_width = -1;
+          extents->wrapped_height = extents->height;
 
-          clutter_text_get_paint_volume_for_cursor (text, &cursor_paint_volume);
+          g_hash_table_insert (priv->paragraph_extents, key, extents);
+        }
+      else
+        g_free (key);
 
-          clutter_paint_volume_union (&priv->paint_volume,
-                                      &cursor_paint_volume);
+      if (width >= 0 && extents->wrap_width != width)
+        {
+          if (extents->width <= width)
+            extents->wrapped_height = extents->height;
+          else
+            {
+              key = g_strndup (paragraph, delimiter);
+              clutter_text_measure_paragraph (text, key, width, &logical_rect);
+              g_free (key);
 
-          clutter_paint_volume_free (&cursor_paint_volume);
+              extents->wrapped_height = logical_rect.y + logical_rect.height;
+            }
+
+          extents->wrap_width = width;
         }
 
-      priv->paint_volume_valid = TRUE;
+      extents->serial = serial;
+      n_paragraphs += 1;
+
+      max_width = MAX (max_width, extents->width);
+      total_height += width >= 0 ? extents->wrapped_height : extents->height;
+
+      /* the last paragraph has no delimiter */
+      if (next == delimiter)
+        break;
+
+      paragraph += next;
+      remaining -= next;
     }
 
-  _clutter_paint_volume_copy_static (&priv->paint_volume, volume);
+  /* drop the paragraphs that were edited away */
+  if (g_hash_table_size (priv->paragraph_extents) > 2 * n_paragraphs)
+    g_hash_table_foreach_remove (priv->paragraph_extents,
+                                 paragraph_extents_is_stale,
+                                 GUINT_TO_POINTER (serial));
 
-  return TRUE;
+  if (width_p != NULL)
+    *width_p = max_width;
+
+  if (height_p != NULL)
+    *height_p = total_height;
 }
 
 static void
@@ -2523,40 +3624,30 @@ clutter_text_get_preferred_width (ClutterActor *self,
 {
   ClutterText *text = CLUTTER_TEXT (self);
   ClutterTextPrivate *priv = text->priv;
-  PangoRectangle logical_rect = { 0, };
   PangoLayout *layout;
-  gint logical_width;
-  gfloat layout_width;
-
-  layout = clutter_text_create_layout (text, -1, -1);
-
-  pango_layout_get_extents (layout, NULL, &logical_rect);
-
-  /* the X coordinate of the logical rectangle might be non-zero
-   * according to the Pango documentation; hence, we need to offset
-   * the width accordingly
-   */
-  logical_width = logical_rect.x + logical_rect.width;
-
-  layout_width = logical_width > 0
-    ? ceilf (logical_width / 1024.0f)
-    : 1;
 
-  if (min_width_p)
+  if (clutter_text_use_paragraph_extents (text))
     {
-      if (priv->wrap || priv->ellipsize || priv->editable)
-        *min_width_p = 1;
-      else
-        *min_width_p = layout_width;
-    }
+      gint logical_width;
 
-  if (natural_width_p)
-    {
-      if (priv->editable && priv->single_line_mode)
-        *natural_width_p = layout_width + TEXT_PADDING * 2;
-      else
-        *natural_width_p = layout_width;
+      clutter_text_get_paragraph_extents (text, -1, &logical_width, NULL);
+      clutter_text_get_width_request (logical_width,
+                                      TRUE, FALSE,
+                                      min_width_p,
+                                      natural_width_p);
+      return;
     }
+
+  layout = clutter_text_create_layout (text, -1, -1);
+
+  clutter_text_layout_get_width_request (layout,
+                                         priv->wrap ||
+                                         priv->ellipsize ||
+                                         priv->editable,
+                                         priv->editable &&
+                                         priv->single_line_mode,
+                                         min_width_p,
+                                         natural_width_p);
 }
 
 static void
@@ -2578,52 +3669,237 @@ clutter_text_get_preferred_height (ClutterActor *self,
   else
     {
       PangoLayout *layout;
-      PangoRectangle logical_rect = { 0, };
-      gint logical_height;
-      gfloat layout_height;
 
       if (priv->single_line_mode)
         for_width = -1;
 
+      if (clutter_text_use_paragraph_extents (CLUTTER_TEXT (self)))
+        {
+          PangoEllipsizeMode ellipsize;
+          gint width, height, logical_height;
+          gfloat layout_height;
+
+          clutter_text_get_layout_params (CLUTTER_TEXT (self),
+                                          for_width, -1,
+                                          &width, &height,
+                                          &ellipsize);
+          clutter_text_get_paragraph_extents (CLUTTER_TEXT (self),
+                                              width,
+                                              NULL,
+                                              &logical_height);
+
+          layout_height = ceilf (logical_height / 1024.0f);
+
+          if (min_height_p)
+            *min_height_p = layout_height;
+
+          if (natural_height_p)
+            *natural_height_p = layout_height;
+
+          return;
+        }
+
       layout = clutter_text_create_layout (CLUTTER_TEXT (self),
                                            for_width, -1);
 
-      pango_layout_get_extents (layout, NULL, &logical_rect);
-
-      /* the Y coordinate of the logical rectangle might be non-zero
-       * according to the Pango documentation; hence, we need to offset
-       * the height accordingly
+      /* if we wrap and ellipsize then the minimum height is
+       * going to be at least the size of the first line
        */
-      logical_height = logical_rect.y + logical_rect.height;
-      layout_height = ceilf (logical_height / 1024.0f);
+      clutter_text_layout_get_height_request (layout,
+                                              (priv->ellipsize && priv->wrap) &&
+                                              !priv->single_line_mode,
+                                              min_height_p,
+                                              natural_height_p);
+    }
+}
 
-      if (min_height_p)
-        {
-          /* if we wrap and ellipsize then the minimum height is
-           * going to be at least the size of the first line
-           */
-          if ((priv->ellipsize && priv->wrap) && !priv->single_line_mode)
-            {
-              PangoLayoutLine *line;
-              gfloat line_height;
+/* a snapshot of the state of a ClutterText needed to measure it off
+ * the main thread; see clutter-measure-pool.c
+ */
+typedef struct _TextMeasure
+{
+  ClutterOrientation orientation;
+
+  gchar *contents;
+  PangoAttrList *attrs;
+  PangoFontDescription *font_desc;
 
-              line = pango_layout_get_line_readonly (layout, 0);
-              pango_layout_line_get_extents (line, NULL, &logical_rect);
+  PangoDirection direction;
+  PangoAlignment alignment;
+  PangoWrapMode wrap_mode;
+  PangoEllipsizeMode ellipsize;
+  gint width;
+  gint height;
+
+  /* the configuration of the PangoContext of the actor */
+  PangoFontDescription *context_font_desc;
+  cairo_font_options_t *font_options;
+  gdouble resolution;
+
+  guint justify          : 1;
+  guint single_line_mode : 1;
+  guint empty            : 1;
+  guint shrinkable       : 1;
+  guint padded           : 1;
+  guint first_line_min   : 1;
+} TextMeasure;
+
+static gpointer
+clutter_text_measure_prepare (ClutterActor       *actor,
+                              ClutterOrientation  orientation,
+                              gfloat              for_size)
+{
+  ClutterText *text = CLUTTER_TEXT (actor);
+  ClutterTextPrivate *priv = text->priv;
+  const cairo_font_options_t *font_options;
+  PangoContext *context;
+  TextMeasure *measure;
 
-              logical_height = logical_rect.y + logical_rect.height;
-              line_height = ceilf (logical_height / 1024.0f);
+  /* the preedit string is spliced in by create_layout_no_cache() */
+  if (priv->editable && priv->preedit_set)
+    return NULL;
 
-              *min_height_p = line_height;
-            }
-          else
-            *min_height_p = layout_height;
+  measure = g_slice_new0 (TextMeasure);
+  measure->orientation = orientation;
+
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      clutter_text_get_layout_params (text, -1, -1,
+                                      &measure->width,
+                                      &measure->height,
+                                      &measure->ellipsize);
+
+      measure->shrinkable = priv->wrap || priv->ellipsize || priv->editable;
+      measure->padded = priv->editable && priv->single_line_mode;
+    }
+  else
+    {
+      if (for_size == 0)
+        {
+          measure->empty = TRUE;
+          return measure;
         }
 
-      if (natural_height_p)
-        *natural_height_p = layout_height;
+      if (priv->single_line_mode)
+        for_size = -1;
+
+      clutter_text_get_layout_params (text, for_size, -1,
+                                      &measure->width,
+                                      &measure->height,
+                                      &measure->ellipsize);
+
+      measure->first_line_min = (priv->ellipsize && priv->wrap) &&
+                                !priv->single_line_mode;
+    }
+
+  measure->contents = g_strdup (clutter_text_get_display_text (text));
+  measure->direction =
+    clutter_text_get_base_direction (text,
+                                     measure->contents,
+                                     strlen (measure->contents));
+
+  clutter_text_ensure_effective_attributes (text);
+  if (priv->effective_attrs != NULL)
+    measure->attrs = pango_attr_list_copy (priv->effective_attrs);
+
+  measure->font_desc = pango_font_description_copy (priv->font_desc);
+  measure->alignment = priv->alignment;
+  measure->wrap_mode = priv->wrap_mode;
+  measure->justify = priv->justify;
+  measure->single_line_mode = priv->single_line_mode;
+
+  context = clutter_actor_get_pango_context (actor);
+  measure->context_font_desc =
+    pango_font_description_copy (pango_context_get_font_description (context));
+  measure->resolution = pango_cairo_context_get_resolution (context);
+
+  font_options = pango_cairo_context_get_font_options (context);
+  if (font_options != NULL)
+    measure->font_options = cairo_font_options_copy (font_options);
+
+  return measure;
+}
+
+static void
+clutter_text_measure (gpointer  data,
+                      gfloat   *min_size_p,
+                      gfloat   *natural_size_p)
+{
+  TextMeasure *measure = data;
+  PangoContext *context;
+  PangoLayout *layout;
+
+  if (measure->empty)
+    {
+      *min_size_p = *natural_size_p = 0;
+      return;
     }
+
+  context = _clutter_measure_pool_get_pango_context ();
+  pango_context_set_base_dir (context, measure->direction);
+  pango_context_set_font_description (context, measure->context_font_desc);
+  pango_cairo_context_set_font_options (context, measure->font_options);
+  pango_cairo_context_set_resolution (context, measure->resolution);
+
+  layout = pango_layout_new (context);
+  pango_layout_set_font_description (layout, measure->font_desc);
+  pango_layout_set_text (layout, measure->contents, -1);
+
+  if (measure->attrs != NULL)
+    pango_layout_set_attributes (layout, measure->attrs);
+
+  pango_layout_set_alignment (layout, measure->alignment);
+  pango_layout_set_single_paragraph_mode (layout, measure->single_line_mode);
+  pango_layout_set_justify (layout, measure->justify);
+  pango_layout_set_wrap (layout, measure->wrap_mode);
+
+  pango_layout_set_ellipsize (layout, measure->ellipsize);
+  pango_layout_set_width (layout, measure->width);
+  pango_layout_set_height (layout, measure->height);
+
+  if (measure->orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    clutter_text_layout_get_width_request (layout,
+                                           measure->shrinkable,
+                                           measure->padded,
+                                           min_size_p,
+                                           natural_size_p);
+  else
+    clutter_text_layout_get_height_request (layout,
+                                            measure->first_line_min,
+                                            min_size_p,
+                                            natural_size_p);
+
+  g_object_unref (layout);
+}
+
+static void
+clutter_text_measure_free (gpointer data)
+{
+  TextMeasure *measure = data;
+
+  g_free (measure->contents);
+
+  if (measure->attrs != NULL)
+    pango_attr_list_unref (measure->attrs);
+
+  if (measure->font_desc != NULL)
+    pango_font_description_free (measure->font_desc);
+
+  if (measure->context_font_desc != NULL)
+    pango_font_description_free (measure->context_font_desc);
+
+  if (measure->font_options != NULL)
+    cairo_font_options_destroy (measure->font_options);
+
+  g_slice_free (TextMeasure, measure);
 }
 
+static const ClutterMeasureFuncs text_measure_funcs = {
+  clutter_text_measure_prepare,
+  clutter_text_measure,
+  clutter_text_measure_free,
+};
+
 static void
 clutter_text_allocate (ClutterActor           *self,
                        const ClutterActorBox  *box,
@@ -2632,6 +3908,9 @@ clutter_text_allocate (ClutterActor           *self,
   ClutterText *text = CLUTTER_TEXT (self);
   ClutterActorClass *parent_class;
 
+  /* the paint volume is clipped to the allocation */
+  clutter_text_dirty_paint_volume (text);
+
   /* Ensure that there is a cached layout with the right width so
    * that we don't need to create the text during the paint run
    *
@@ -3364,6 +4643,7 @@ clutter_text_class_init (ClutterTextClass *klass)
   gobject_class->dispose = clutter_text_dispose;
   gobject_class->finalize = clutter_text_finalize;
 
+  actor_class->map = clutter_text_map;
   actor_class->paint = clutter_text_paint;
   actor_class->get_paint_volume = clutter_text_get_paint_volume;
   actor_class->get_preferred_width = clutter_text_get_preferred_width;
@@ -3378,6 +4658,12 @@ clutter_text_class_init (ClutterTextClass *klass)
   actor_class->key_focus_out = clutter_text_key_focus_out;
   actor_class->has_overlaps = clutter_text_has_overlaps;
 
+  /* the size requests only depend on Pango, and can be computed on the
+   * worker threads of the measure pool
+   */
+  _clutter_measure_pool_register_type (G_OBJECT_CLASS_TYPE (klass),
+                                       &text_measure_funcs);
+
   /**
    * ClutterText:buffer:
    *
@@ -3865,6 +5151,46 @@ clutter_text_class_init (ClutterTextClass *klass)
   obj_props[PROP_SELECTED_TEXT_COLOR_SET] = pspec;
   g_object_class_install_property (gobject_class, PROP_SELECTED_TEXT_COLOR_SET, pspec);
 
+  /**
+   * ClutterText:async-layout:
+   *
+   * Whether long, non-editable contents should be shaped on a worker
+   * thread. While the contents are being shaped, the #ClutterText
+   * keeps showing the previous layout.
+   *
+   * Since: 1.26
+   */
+  pspec = g_param_spec_boolean ("async-layout",
+                                P_("Asynchronous Layout"),
+                                P_("Whether long contents should be shaped off the main thread"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_ASYNC_LAYOUT] = pspec;
+  g_object_class_install_property (gobject_class, PROP_ASYNC_LAYOUT, pspec);
+
+  /**
+   * ClutterText:use-distance-field:
+   *
+   * Whether the text should be drawn using signed distance field
+   * glyphs, which stay sharp when the #ClutterText is scaled or when
+   * the size of its font is animated, instead of being rasterized
+   * again at each size.
+   *
+   * The distance field glyphs need GLSL support; texts with attributes
+   * or with a pre-edit string are always drawn normally.
+   *
+   * See also clutter_set_font_flags().
+   *
+   * Since: 1.26
+   */
+  pspec = g_param_spec_boolean ("use-distance-field",
+                                P_("Use Distance Field"),
+                                P_("Whether the text should be drawn using distance field glyphs"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_USE_DISTANCE_FIELD] = pspec;
+  g_object_class_install_property (gobject_class, PROP_USE_DISTANCE_FIELD, pspec);
+
   /**
    * ClutterText::text-changed:
    * @self: the #ClutterText that emitted the signal
@@ -4314,7 +5640,7 @@ buffer_notify_text (ClutterTextBuffer *buffer,
 {
   g_object_freeze_notify (G_OBJECT (self));
 
-  clutter_text_dirty_cache (self);
+  clutter_text_dirty_layouts (self);
 
   clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
 
@@ -4426,6 +5752,8 @@ clutter_text_set_buffer (ClutterText       *self,
   if (priv->buffer)
      buffer_connect_signals (self);
 
+  g_clear_pointer (&priv->display_text, g_free);
+
   obj = G_OBJECT (self);
   g_object_freeze_notify (obj);
   g_object_notify (obj, "buffer");
@@ -5245,6 +6573,8 @@ clutter_text_get_layout (ClutterText *self)
 
   g_return_val_if_fail (CLUTTER_IS_TEXT (self), NULL);
 
+  clutter_text_flush_settings_changes (self);
+
   if (self->priv->editable && self->priv->single_line_mode)
     return clutter_text_create_layout (self, -1, -1);
 
@@ -5691,6 +7021,125 @@ clutter_text_get_justify (ClutterText *self)
   return self->priv->justify;
 }
 
+/**
+ * clutter_text_set_async_layout:
+ * @self: a #ClutterText
+ * @async_layout: whether the contents should be shaped asynchronously
+ *
+ * Sets whether the contents of @self should be shaped on a worker
+ * thread, instead of blocking the main thread when the size of @self
+ * is first requested after they change.
+ *
+ * Only contents longer than a few kilobytes of non-editable #ClutterText
+ * actors are shaped asynchronously. Until the new layout is ready,
+ * @self keeps showing and measuring the previous one, and then queues
+ * a relayout; this means that clutter_text_get_layout() and the
+ * functions mapping positions to coordinates refer to the previous
+ * contents in the meantime.
+ *
+ * Since: 1.26
+ */
+void
+clutter_text_set_async_layout (ClutterText *self,
+                               gboolean     async_layout)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  async_layout = !!async_layout;
+
+  if (priv->async_layout != async_layout)
+    {
+      priv->async_layout = async_layout;
+
+      clutter_text_dirty_cache (self);
+      g_clear_object (&priv->async_placeholder);
+
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ASYNC_LAYOUT]);
+    }
+}
+
+/**
+ * clutter_text_get_async_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves the value set using clutter_text_set_async_layout().
+ *
+ * Return value: %TRUE if long contents are shaped asynchronously
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_text_get_async_layout (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->async_layout;
+}
+
+/**
+ * clutter_text_set_use_distance_field:
+ * @self: a #ClutterText
+ * @use_distance_field: whether to use distance field glyphs
+ *
+ * Sets whether the text of @self should be drawn using signed distance
+ * field glyphs.
+ *
+ * The distance field glyphs are rasterized once, and can then be drawn
+ * at any scale without being rasterized again; this is useful for texts
+ * that are scaled or whose font size is animated. Static text at small
+ * sizes looks better using the default glyphs, which are hinted.
+ *
+ * Distance field glyphs can also be enabled for every #ClutterText
+ * using %CLUTTER_FONT_DISTANCE_FIELD with clutter_set_font_flags().
+ *
+ * Since: 1.26
+ */
+void
+clutter_text_set_use_distance_field (ClutterText *self,
+                                     gboolean     use_distance_field)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  use_distance_field = !!use_distance_field;
+
+  if (priv->use_distance_field != use_distance_field)
+    {
+      priv->use_distance_field = use_distance_field;
+
+      clutter_actor_queue_redraw (CLUTTER_ACTOR (self));
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_USE_DISTANCE_FIELD]);
+    }
+}
+
+/**
+ * clutter_text_get_use_distance_field:
+ * @self: a #ClutterText
+ *
+ * Retrieves the value set using clutter_text_set_use_distance_field().
+ *
+ * Return value: %TRUE if the text is drawn using distance field glyphs
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_text_get_use_distance_field (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->use_distance_field;
+}
+
 /**
  * clutter_text_get_cursor_position:
  * @self: a #ClutterText
@@ -302,6 +302,17 @@ void                  clutter_text_get_layout_offsets   (ClutterText           *
                                                          gint                  *x,
                                                          gint                  *y);
 
+CLUTTER_AVAILABLE_IN_1_26
+void                  clutter_text_set_async_layout     (ClutterText          *self,
+                                                         gboolean              async_layout);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean              clutter_text_get_async_layout     (ClutterText          *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                  clutter_text_set_use_distance_field (ClutterText        *self,
+                                                           gboolean            use_distance_field);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean              clutter_text_get_use_distance_field (ClutterText        *self);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_TEXT_H__ */
@@ -97,6 +97,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "clutter-timeline.h"
 
 #include "clutter-debug.h"
@@ -128,12 +130,26 @@ struct _ClutterTimelinePrivate
 
   GHashTable *markers_by_name;
 
+  /* the markers sorted by time, as an array of SortedMarker; it is
+   * rebuilt lazily when markers are added or removed, or when the
+   * duration changes
+   */
+  GArray *sorted_markers;
+
+  /* the index in sorted_markers where the last check of the markers
+   * stopped, which is where the next one usually starts
+   */
+  guint marker_cursor;
+
   /* Time we last advanced the elapsed time and showed a frame */
   gint64 last_frame_time;
 
   /* How many times the timeline should repeat */
   gint repeat_count;
 
+  /* the highest number of frames per second, or 0 for no limit */
+  guint max_frame_rate;
+
   /* The number of times the timeline has repeated */
   gint current_repeat;
 
@@ -150,6 +166,20 @@ struct _ClutterTimelinePrivate
   ClutterPoint cb_1;
   ClutterPoint cb_2;
 
+  /* the easing table of the cubic-bezier() parameters, created
+   * on demand if use_progress_table is set
+   */
+  ClutterEasingTable *cb_table;
+
+  /* the timeline sharing its progress with this one, set by the
+   * transition groups while they advance their transitions
+   */
+  ClutterTimeline *progress_leader;
+
+  /* the progress computed by a leader, for its elapsed time */
+  gdouble cached_progress;
+  gint64 cached_progress_elapsed;
+
   guint is_playing         : 1;
 
   /* If we've just started playing and haven't yet gotten
@@ -157,6 +187,16 @@ struct _ClutterTimelinePrivate
    */
   guint waiting_first_tick : 1;
   guint auto_reverse       : 1;
+
+  /* TRUE while the master clock waits for the delay to elapse, when
+   * it handles delayed timelines instead of delay_id
+   */
+  guint is_delayed         : 1;
+
+  guint use_progress_table : 1;
+
+  guint is_progress_leader  : 1;
+  guint has_cached_progress : 1;
 };
 
 typedef struct {
@@ -171,6 +211,11 @@ typedef struct {
   guint is_relative : 1;
 } TimelineMarker;
 
+typedef struct {
+  gint msecs;
+  GQuark quark;
+} SortedMarker;
+
 enum
 {
   PROP_0,
@@ -182,6 +227,7 @@ enum
   PROP_AUTO_REVERSE,
   PROP_REPEAT_COUNT,
   PROP_PROGRESS_MODE,
+  PROP_MAX_FRAME_RATE,
 
   PROP_LAST
 };
@@ -291,6 +337,7 @@ clutter_timeline_add_marker_internal (ClutterTimeline *timeline,
     }
 
   g_hash_table_insert (priv->markers_by_name, marker->name, marker);
+  g_clear_pointer (&priv->sorted_markers, g_array_unref);
 }
 
 static inline void
@@ -474,6 +521,10 @@ clutter_timeline_set_property (GObject      *object,
       clutter_timeline_set_progress_mode (timeline, g_value_get_enum (value));
       break;
 
+    case PROP_MAX_FRAME_RATE:
+      clutter_timeline_set_max_frame_rate (timeline, g_value_get_uint (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -519,6 +570,10 @@ clutter_timeline_get_property (GObject    *object,
       g_value_set_enum (value, priv->progress_mode);
       break;
 
+    case PROP_MAX_FRAME_RATE:
+      g_value_set_uint (value, priv->max_frame_rate);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -535,6 +590,11 @@ clutter_timeline_finalize (GObject *object)
   if (priv->markers_by_name)
     g_hash_table_destroy (priv->markers_by_name);
 
+  if (priv->sorted_markers)
+    g_array_unref (priv->sorted_markers);
+
+  clutter_easing_table_free (priv->cb_table);
+
   if (priv->is_playing)
     {
       master_clock = _clutter_master_clock_get_default ();
@@ -558,6 +618,14 @@ clutter_timeline_dispose (GObject *object)
       priv->delay_id = 0;
     }
 
+  if (priv->is_delayed)
+    {
+      ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
+
+      _clutter_master_clock_remove_delayed_timeline (master_clock, self);
+      priv->is_delayed = FALSE;
+    }
+
   if (priv->progress_notify != NULL)
     {
       priv->progress_notify (priv->progress_data);
@@ -691,6 +759,22 @@ clutter_timeline_class_init (ClutterTimelineClass *klass)
                        CLUTTER_LINEAR,
                        CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterTimeline:max-frame-rate:
+   *
+   * The highest number of frames per second at which the timeline is
+   * advanced, or 0 to follow the refresh rate of the display.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_MAX_FRAME_RATE] =
+    g_param_spec_uint ("max-frame-rate",
+                       P_("Maximum Frame Rate"),
+                       P_("The highest number of frames per second"),
+                       0, 1000,
+                       0,
+                       CLUTTER_PARAM_READWRITE);
+
   object_class->dispose = clutter_timeline_dispose;
   object_class->finalize = clutter_timeline_finalize;
   object_class->set_property = clutter_timeline_set_property;
@@ -903,38 +987,72 @@ have_passed_time (const struct CheckIfMarkerHitClosure *data,
     }
 }
 
-static void
-check_if_marker_hit (const gchar *name,
-                     TimelineMarker *marker,
-                     struct CheckIfMarkerHitClosure *data)
+static gint
+sorted_marker_compare (gconstpointer a,
+                       gconstpointer b)
 {
-  gint msecs;
+  const SortedMarker *marker_a = a;
+  const SortedMarker *marker_b = b;
 
-  if (marker->is_relative)
-    msecs = (gdouble) data->duration * marker->data.progress;
-  else
-    msecs = marker->data.msecs;
+  return marker_a->msecs - marker_b->msecs;
+}
 
-  if (have_passed_time (data, msecs))
+static GArray *
+clutter_timeline_get_sorted_markers (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  GHashTableIter iter;
+  gpointer value;
+
+  if (priv->sorted_markers != NULL)
+    return priv->sorted_markers;
+
+  priv->marker_cursor = 0;
+  priv->sorted_markers =
+    g_array_sized_new (FALSE, FALSE, sizeof (SortedMarker),
+                       g_hash_table_size (priv->markers_by_name));
+
+  g_hash_table_iter_init (&iter, priv->markers_by_name);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
     {
-      CLUTTER_NOTE (SCHEDULER, "Marker '%s' reached", name);
+      TimelineMarker *marker = value;
+      SortedMarker sorted;
+
+      if (marker->is_relative)
+        sorted.msecs = (gdouble) priv->duration * marker->data.progress;
+      else
+        sorted.msecs = marker->data.msecs;
+
+      sorted.quark = marker->quark;
 
-      g_signal_emit (data->timeline, timeline_signals[MARKER_REACHED],
-                     marker->quark,
-                     name,
-                     msecs);
+      g_array_append_val (priv->sorted_markers, sorted);
     }
+
+  g_array_sort (priv->sorted_markers, sorted_marker_compare);
+
+  return priv->sorted_markers;
 }
 
+/* the number of markers reached in a single frame that can be emitted
+ * without allocating
+ */
+#define N_STATIC_MARKER_HITS    8
+
 static void
 check_markers (ClutterTimeline *timeline,
                gint delta)
 {
   ClutterTimelinePrivate *priv = timeline->priv;
   struct CheckIfMarkerHitClosure data;
+  SortedMarker static_hits[N_STATIC_MARKER_HITS];
+  SortedMarker *hits;
+  GArray *markers;
+  guint first, last, lo, hi, i, n_hits;
+  gint start, end;
 
   /* shortcircuit here if we don't have any marker installed */
-  if (priv->markers_by_name == NULL)
+  if (priv->markers_by_name == NULL ||
+      g_hash_table_size (priv->markers_by_name) == 0)
     return;
 
   /* store the details of the timeline so that changing them in a
@@ -945,9 +1063,93 @@ check_markers (ClutterTimeline *timeline,
   data.duration = priv->duration;
   data.delta = delta;
 
-  g_hash_table_foreach (priv->markers_by_name,
-                        (GHFunc) check_if_marker_hit,
-                        &data);
+  /* every marker that can be hit lies between the previous time and
+   * the new time, bounds included; the exact test is left to
+   * have_passed_time()
+   */
+  if (data.direction == CLUTTER_TIMELINE_FORWARD)
+    {
+      start = data.new_time - data.delta;
+      end = data.new_time;
+    }
+  else
+    {
+      start = data.new_time;
+      end = data.new_time + data.delta;
+    }
+
+  markers = clutter_timeline_get_sorted_markers (timeline);
+
+  /* find the first marker at or after start; while the timeline plays
+   * this is where the previous check stopped, otherwise we look it up
+   */
+  first = MIN (priv->marker_cursor, markers->len);
+  if (!((first == 0 ||
+         g_array_index (markers, SortedMarker, first - 1).msecs < start) &&
+        (first == markers->len ||
+         g_array_index (markers, SortedMarker, first).msecs >= start)))
+    {
+      lo = 0;
+      hi = markers->len;
+      while (lo < hi)
+        {
+          guint mid = (lo + hi) / 2;
+
+          if (g_array_index (markers, SortedMarker, mid).msecs < start)
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+
+      first = lo;
+    }
+
+  for (last = first; last < markers->len; last++)
+    {
+      if (g_array_index (markers, SortedMarker, last).msecs > end)
+        break;
+    }
+
+  /* the next check starts after this one when moving forward, and
+   * before it when moving backward
+   */
+  priv->marker_cursor = data.direction == CLUTTER_TIMELINE_FORWARD
+                      ? last
+                      : first;
+
+  if (first == last)
+    return;
+
+  /* the signal handlers may add or remove markers, which would
+   * rebuild the sorted array, so we iterate over a copy
+   */
+  n_hits = last - first;
+  if (n_hits <= N_STATIC_MARKER_HITS)
+    hits = static_hits;
+  else
+    hits = g_new (SortedMarker, n_hits);
+
+  memcpy (hits,
+          &g_array_index (markers, SortedMarker, first),
+          n_hits * sizeof (SortedMarker));
+
+  for (i = 0; i < n_hits; i++)
+    {
+      const gchar *name = g_quark_to_string (hits[i].quark);
+
+      if (have_passed_time (&data, hits[i].msecs))
+        {
+          CLUTTER_NOTE (SCHEDULER, "Marker '%s' reached", name);
+
+          g_signal_emit (data.timeline, timeline_signals[MARKER_REACHED],
+                         hits[i].quark,
+                         name,
+                         hits[i].msecs);
+        }
+    }
+
+  if (hits != static_hits)
+    g_free (hits);
 }
 
 static void
@@ -1156,17 +1358,33 @@ clutter_timeline_do_frame (ClutterTimeline *timeline)
     }
 }
 
-static gboolean
-delay_timeout_func (gpointer data)
+/*< private >
+ * _clutter_timeline_delay_elapsed:
+ * @timeline: a #ClutterTimeline
+ *
+ * Starts @timeline once its delay has elapsed. This function is called
+ * by the master clocks that handle delayed timelines.
+ */
+void
+_clutter_timeline_delay_elapsed (ClutterTimeline *timeline)
 {
-  ClutterTimeline *timeline = data;
   ClutterTimelinePrivate *priv = timeline->priv;
 
-  priv->delay_id = 0;
+  priv->is_delayed = FALSE;
   priv->msecs_delta = 0;
   set_is_playing (timeline, TRUE);
 
   g_signal_emit (timeline, timeline_signals[STARTED], 0);
+}
+
+static gboolean
+delay_timeout_func (gpointer data)
+{
+  ClutterTimeline *timeline = data;
+
+  timeline->priv->delay_id = 0;
+
+  _clutter_timeline_delay_elapsed (timeline);
 
   return FALSE;
 }
@@ -1186,16 +1404,32 @@ clutter_timeline_start (ClutterTimeline *timeline)
 
   priv = timeline->priv;
 
-  if (priv->delay_id || priv->is_playing)
+  if (priv->delay_id || priv->is_delayed || priv->is_playing)
     return;
 
   if (priv->duration == 0)
     return;
 
   if (priv->delay)
-    priv->delay_id = clutter_threads_add_timeout (priv->delay,
-                                                  delay_timeout_func,
-                                                  timeline);
+    {
+      ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
+      gint64 start_time;
+
+      /* the master clock keeps all the delayed timelines in a single
+       * queue, which is cheaper than a timeout source for each of them
+       * when many staggered transitions are started at once
+       */
+      start_time = g_get_monotonic_time () + (gint64) priv->delay * 1000;
+
+      if (_clutter_master_clock_add_delayed_timeline (master_clock,
+                                                      timeline,
+                                                      start_time))
+        priv->is_delayed = TRUE;
+      else
+        priv->delay_id = clutter_threads_add_timeout (priv->delay,
+                                                      delay_timeout_func,
+                                                      timeline);
+    }
   else
     {
       priv->msecs_delta = 0;
@@ -1220,7 +1454,7 @@ clutter_timeline_pause (ClutterTimeline *timeline)
 
   priv = timeline->priv;
 
-  if (priv->delay_id == 0 && !priv->is_playing)
+  if (priv->delay_id == 0 && !priv->is_delayed && !priv->is_playing)
     return;
 
   if (priv->delay_id)
@@ -1229,6 +1463,14 @@ clutter_timeline_pause (ClutterTimeline *timeline)
       priv->delay_id = 0;
     }
 
+  if (priv->is_delayed)
+    {
+      ClutterMasterClock *master_clock = _clutter_master_clock_get_default ();
+
+      _clutter_master_clock_remove_delayed_timeline (master_clock, timeline);
+      priv->is_delayed = FALSE;
+    }
+
   priv->msecs_delta = 0;
   set_is_playing (timeline, FALSE);
 
@@ -1565,10 +1807,29 @@ clutter_timeline_set_duration (ClutterTimeline *timeline,
     {
       priv->duration = msecs;
 
+      /* the time of the relative markers has changed */
+      g_clear_pointer (&priv->sorted_markers, g_array_unref);
+
       g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_DURATION]);
     }
 }
 
+static inline gdouble
+clutter_timeline_progress_for_elapsed (ClutterTimeline *timeline,
+                                       gint64           elapsed_time)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  /* short-circuit linear progress */
+  if (priv->progress_func == NULL)
+    return (gdouble) elapsed_time / (gdouble) priv->duration;
+  else
+    return priv->progress_func (timeline,
+                                (gdouble) elapsed_time,
+                                (gdouble) priv->duration,
+                                priv->progress_data);
+}
+
 /**
  * clutter_timeline_get_progress:
  * @timeline: a #ClutterTimeline
@@ -1587,19 +1848,131 @@ gdouble
 clutter_timeline_get_progress (ClutterTimeline *timeline)
 {
   ClutterTimelinePrivate *priv;
+  gdouble progress;
 
   g_return_val_if_fail (CLUTTER_IS_TIMELINE (timeline), 0.0);
 
   priv = timeline->priv;
 
-  /* short-circuit linear progress */
-  if (priv->progress_func == NULL)
-    return (gdouble) priv->elapsed_time / (gdouble) priv->duration;
+  if (priv->progress_leader != NULL)
+    {
+      ClutterTimelinePrivate *leader_priv = priv->progress_leader->priv;
+
+      if (leader_priv->has_cached_progress &&
+          leader_priv->cached_progress_elapsed == priv->elapsed_time &&
+          _clutter_timeline_shares_progress (timeline, priv->progress_leader))
+        return leader_priv->cached_progress;
+    }
+
+  progress = clutter_timeline_progress_for_elapsed (timeline,
+                                                    priv->elapsed_time);
+
+  if (priv->is_progress_leader)
+    {
+      priv->cached_progress = progress;
+      priv->cached_progress_elapsed = priv->elapsed_time;
+      priv->has_cached_progress = TRUE;
+    }
+
+  return progress;
+}
+
+/*< private >
+ * _clutter_timeline_shares_progress:
+ * @timeline: a #ClutterTimeline
+ * @other: another #ClutterTimeline
+ *
+ * Checks whether @timeline and @other compute the same progress for
+ * the same elapsed time.
+ *
+ * Return value: %TRUE if the progress of the timelines is the same
+ */
+gboolean
+_clutter_timeline_shares_progress (ClutterTimeline *timeline,
+                                   ClutterTimeline *other)
+{
+  ClutterTimelinePrivate *a = timeline->priv;
+  ClutterTimelinePrivate *b = other->priv;
+
+  return a->duration == b->duration &&
+         a->progress_mode == b->progress_mode &&
+         a->progress_func == b->progress_func &&
+         a->progress_data == b->progress_data &&
+         a->use_progress_table == b->use_progress_table &&
+         a->n_steps == b->n_steps &&
+         a->step_mode == b->step_mode &&
+         clutter_point_equals (&a->cb_1, &b->cb_1) &&
+         clutter_point_equals (&a->cb_2, &b->cb_2);
+}
+
+/*< private >
+ * _clutter_timeline_set_progress_leader:
+ * @timeline: a #ClutterTimeline
+ * @leader: (allow-none): the #ClutterTimeline to share the progress of,
+ *   @timeline itself, or %NULL
+ *
+ * Sets the timeline whose progress @timeline uses when they share
+ * their progress mode and their elapsed time, instead of computing
+ * it again.
+ *
+ * If @leader is @timeline then the progress computed by @timeline is
+ * kept for the other timelines. The leader must be unset before it
+ * goes away.
+ */
+void
+_clutter_timeline_set_progress_leader (ClutterTimeline *timeline,
+                                       ClutterTimeline *leader)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  priv->has_cached_progress = FALSE;
+
+  if (leader == timeline)
+    {
+      priv->is_progress_leader = TRUE;
+      priv->progress_leader = NULL;
+    }
   else
-    return priv->progress_func (timeline,
-                                (gdouble) priv->elapsed_time,
-                                (gdouble) priv->duration,
-                                priv->progress_data);
+    {
+      priv->is_progress_leader = FALSE;
+      priv->progress_leader = leader;
+    }
+}
+
+/*< private >
+ * _clutter_timeline_get_progress_at_time:
+ * @timeline: a #ClutterTimeline
+ * @frame_time: a time, in milliseconds, on the same clock used by
+ *   the master clock to advance the timelines
+ *
+ * Computes the progress that @timeline would have if it were advanced
+ * at @frame_time, without actually advancing it.
+ *
+ * The elapsed time is clamped to the current run of @timeline, so this
+ * function never wraps around repeats or reverses the direction.
+ *
+ * Return value: the progress of @timeline at @frame_time
+ */
+gdouble
+_clutter_timeline_get_progress_at_time (ClutterTimeline *timeline,
+                                        gint64           frame_time)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  gint64 elapsed_time = priv->elapsed_time;
+
+  if (priv->is_playing &&
+      !priv->waiting_first_tick &&
+      frame_time > priv->last_frame_time)
+    {
+      gint64 delta = frame_time - priv->last_frame_time;
+
+      if (priv->direction == CLUTTER_TIMELINE_FORWARD)
+        elapsed_time = MIN (elapsed_time + delta, priv->duration);
+      else
+        elapsed_time = MAX (elapsed_time - delta, 0);
+    }
+
+  return clutter_timeline_progress_for_elapsed (timeline, elapsed_time);
 }
 
 /**
@@ -1765,6 +2138,17 @@ _clutter_timeline_do_tick (ClutterTimeline *timeline,
           return;
         }
 
+      /* a capped timeline skips the ticks that come too early; the
+       * slack accounts for the rounding of the tick times to msecs
+       */
+      if (priv->max_frame_rate != 0)
+        {
+          gint64 interval = 1000 / priv->max_frame_rate;
+
+          if (msecs < interval - interval / 8)
+            return;
+        }
+
       if (msecs != 0)
 	{
 	  /* Avoid accumulating error */
@@ -2028,6 +2412,7 @@ clutter_timeline_remove_marker (ClutterTimeline *timeline,
 
   /* this will take care of freeing the marker as well */
   g_hash_table_remove (priv->markers_by_name, marker_name);
+  g_clear_pointer (&priv->sorted_markers, g_array_unref);
 }
 
 /**
@@ -2224,6 +2609,8 @@ clutter_timeline_set_progress_func (ClutterTimeline             *timeline,
 
   priv = timeline->priv;
 
+  priv->has_cached_progress = FALSE;
+
   if (priv->progress_notify != NULL)
     priv->progress_notify (priv->progress_data);
 
@@ -2246,6 +2633,27 @@ clutter_timeline_progress_func (ClutterTimeline *timeline,
                                 gpointer         user_data G_GNUC_UNUSED)
 {
   ClutterTimelinePrivate *priv = timeline->priv;
+  double x_1, y_1, x_2, y_2;
+
+  if (priv->use_progress_table)
+    {
+      const ClutterEasingTable *table;
+
+      if (priv->progress_mode == CLUTTER_CUBIC_BEZIER)
+        {
+          if (priv->cb_table == NULL)
+            priv->cb_table =
+              clutter_easing_table_new_cubic_bezier (priv->cb_1.x, priv->cb_1.y,
+                                                     priv->cb_2.x, priv->cb_2.y);
+
+          table = priv->cb_table;
+        }
+      else
+        table = clutter_easing_table_for_mode (priv->progress_mode);
+
+      if (table != NULL)
+        return clutter_easing_table_lookup (table, elapsed, duration);
+    }
 
   /* parametrized easing functions need to be handled separately */
   switch (priv->progress_mode)
@@ -2271,20 +2679,15 @@ clutter_timeline_progress_func (ClutterTimeline *timeline,
                                         priv->cb_2.x, priv->cb_2.y);
 
     case CLUTTER_EASE:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.25, 0.1, 0.25, 1.0);
-
     case CLUTTER_EASE_IN:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 1.0, 1.0);
-
     case CLUTTER_EASE_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.0, 0.0, 0.58, 1.0);
-
     case CLUTTER_EASE_IN_OUT:
+      clutter_easing_get_cubic_bezier_points (priv->progress_mode,
+                                              &x_1, &y_1,
+                                              &x_2, &y_2);
       return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 0.58, 1.0);
+                                        x_1, y_1,
+                                        x_2, y_2);
 
     default:
       break;
@@ -2316,6 +2719,8 @@ clutter_timeline_set_progress_mode (ClutterTimeline      *timeline,
 
   priv = timeline->priv;
 
+  priv->has_cached_progress = FALSE;
+
   if (priv->progress_mode == mode)
     return;
 
@@ -2440,6 +2845,7 @@ clutter_timeline_set_step_progress (ClutterTimeline *timeline,
 
   priv->n_steps = n_steps;
   priv->step_mode = step_mode;
+  priv->has_cached_progress = FALSE;
   clutter_timeline_set_progress_mode (timeline, CLUTTER_STEPS);
 }
 
@@ -2513,6 +2919,9 @@ clutter_timeline_set_cubic_bezier_progress (ClutterTimeline    *timeline,
   priv->cb_1.x = CLAMP (priv->cb_1.x, 0.f, 1.f);
   priv->cb_2.x = CLAMP (priv->cb_2.x, 0.f, 1.f);
 
+  g_clear_pointer (&priv->cb_table, clutter_easing_table_free);
+  priv->has_cached_progress = FALSE;
+
   clutter_timeline_set_progress_mode (timeline, CLUTTER_CUBIC_BEZIER);
 }
 
@@ -2553,3 +2962,124 @@ clutter_timeline_get_cubic_bezier_progress (ClutterTimeline *timeline,
 
   return TRUE;
 }
+
+/**
+ * clutter_timeline_set_use_progress_table:
+ * @timeline: a #ClutterTimeline
+ * @use_table: whether the progress should be looked up in a table
+ *
+ * Sets whether the progress of @timeline should be computed by looking
+ * up a table of precomputed values of its #ClutterTimeline:progress-mode,
+ * instead of evaluating the easing function at each frame.
+ *
+ * The tables are computed once, the first time they are needed, and
+ * they are shared by all the timelines using the same progress mode,
+ * except for the cubic bezier set with
+ * clutter_timeline_set_cubic_bezier_progress(); the progress is then linearly interpolated between the closest two
+ * values of the table, which is precise enough for any animation.
+ *
+ * Only the trigonometric, exponential, elastic and bounce progress modes,
+ * as well as the cubic bezier ones, are affected; the polynomial and
+ * the steps progress modes, and the progress functions set using
+ * clutter_timeline_set_progress_func(), are always evaluated.
+ *
+ * Since: 1.26
+ */
+void
+clutter_timeline_set_use_progress_table (ClutterTimeline *timeline,
+                                         gboolean         use_table)
+{
+  g_return_if_fail (CLUTTER_IS_TIMELINE (timeline));
+
+  timeline->priv->use_progress_table = !!use_table;
+  timeline->priv->has_cached_progress = FALSE;
+}
+
+/**
+ * clutter_timeline_get_use_progress_table:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves the value set by clutter_timeline_set_use_progress_table().
+ *
+ * Return value: %TRUE if the progress is looked up in a table
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_timeline_get_use_progress_table (ClutterTimeline *timeline)
+{
+  g_return_val_if_fail (CLUTTER_IS_TIMELINE (timeline), FALSE);
+
+  return timeline->priv->use_progress_table;
+}
+
+/**
+ * clutter_timeline_set_max_frame_rate:
+ * @timeline: a #ClutterTimeline
+ * @frame_rate: the highest number of frames per second, or 0
+ *
+ * Sets the highest number of frames per second at which @timeline is
+ * advanced; the frames of the master clock coming sooner than that are
+ * skipped, and the elapsed time catches up at the next frame.
+ *
+ * While only capped timelines are running, and no stage needs to be
+ * redrawn for other reasons, the master clock runs at the highest of
+ * their frame rates instead of the refresh rate of the display; for
+ * instance, a small spinner animated at 10 frames per second does not
+ * keep a 120 Hz display busy. On Android, the display is also asked to
+ * switch to a matching refresh rate, when it can.
+ *
+ * A @frame_rate of 0, the default, advances @timeline at every frame.
+ *
+ * Since: 1.26
+ */
+void
+clutter_timeline_set_max_frame_rate (ClutterTimeline *timeline,
+                                     guint            frame_rate)
+{
+  ClutterTimelinePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TIMELINE (timeline));
+  g_return_if_fail (frame_rate <= 1000);
+
+  priv = timeline->priv;
+
+  if (priv->max_frame_rate != frame_rate)
+    {
+      priv->max_frame_rate = frame_rate;
+
+      g_object_notify_by_pspec (G_OBJECT (timeline),
+                                obj_props[PROP_MAX_FRAME_RATE]);
+    }
+}
+
+/**
+ * clutter_timeline_get_max_frame_rate:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves the value set by clutter_timeline_set_max_frame_rate().
+ *
+ * Return value: the highest number of frames per second, or 0
+ *
+ * Since: 1.26
+ */
+guint
+clutter_timeline_get_max_frame_rate (ClutterTimeline *timeline)
+{
+  g_return_val_if_fail (CLUTTER_IS_TIMELINE (timeline), 0);
+
+  return timeline->priv->max_frame_rate;
+}
+
+/*< private >
+ * _clutter_timeline_get_max_frame_rate:
+ * @timeline: a #ClutterTimeline
+ *
+ * Unchecked version of clutter_timeline_get_max_frame_rate(), for
+ * the master clock.
+ */
+guint
+_clutter_timeline_get_max_frame_rate (ClutterTimeline *timeline)
+{
+  return timeline->priv->max_frame_rate;
+}
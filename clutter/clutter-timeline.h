@@ -215,6 +215,16 @@ CLUTTER_AVAILABLE_IN_1_12
 gboolean                        clutter_timeline_get_cubic_bezier_progress      (ClutterTimeline          *timeline,
                                                                                  ClutterPoint             *c_1,
                                                                                  ClutterPoint             *c_2);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_timeline_set_use_progress_table         (ClutterTimeline          *timeline,
+                                                                                 gboolean                  use_table);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                        clutter_timeline_get_use_progress_table         (ClutterTimeline          *timeline);
+CLUTTER_AVAILABLE_IN_1_26
+void                            clutter_timeline_set_max_frame_rate             (ClutterTimeline          *timeline,
+                                                                                 guint                     frame_rate);
+CLUTTER_AVAILABLE_IN_1_26
+guint                           clutter_timeline_get_max_frame_rate             (ClutterTimeline          *timeline);
 
 CLUTTER_AVAILABLE_IN_1_10
 gint64                          clutter_timeline_get_duration_hint              (ClutterTimeline          *timeline);
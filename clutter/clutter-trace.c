@@ -0,0 +1,141 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Trace spans for the hot paths of the library; they are compiled in
+ * only when configuring with --enable-tracing, and recorded only for
+ * the categories listed in the CLUTTER_TRACE environment variable.
+ *
+ * On Android the spans are forwarded to ATrace, and show up in systrace
+ * and Perfetto captures; elsewhere they are written as sysprof marks, if
+ * the capture library was found at configure time.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-trace.h"
+
+#if defined(CLUTTER_ENABLE_TRACING) && defined(__ANDROID__)
+#include <android/trace.h>
+#elif defined(CLUTTER_ENABLE_TRACING) && defined(HAVE_SYSPROF)
+#include <sysprof-capture.h>
+#endif
+
+#if defined(CLUTTER_ENABLE_TRACING) && !defined(__ANDROID__) && defined(HAVE_SYSPROF)
+#define TRACE_MAX_DEPTH 64
+
+/* sysprof marks carry both ends of the span, so each thread keeps the
+ * start time and name of the spans it has open
+ */
+typedef struct {
+  gint64 begin_time[TRACE_MAX_DEPTH];
+  char *name[TRACE_MAX_DEPTH];
+  guint depth;
+  guint overflow;
+} TraceStack;
+
+static void
+trace_stack_free (gpointer data)
+{
+  TraceStack *stack = data;
+  guint i;
+
+  for (i = 0; i < stack->depth; i++)
+    g_free (stack->name[i]);
+
+  g_free (stack);
+}
+
+static GPrivate trace_stack_key = G_PRIVATE_INIT (trace_stack_free);
+
+static TraceStack *
+trace_stack_get (void)
+{
+  TraceStack *stack = g_private_get (&trace_stack_key);
+
+  if (G_UNLIKELY (stack == NULL))
+    {
+      stack = g_new0 (TraceStack, 1);
+      g_private_set (&trace_stack_key, stack);
+    }
+
+  return stack;
+}
+#endif
+
+void
+_clutter_trace_begin (const char *name)
+{
+#if defined(CLUTTER_ENABLE_TRACING) && defined(__ANDROID__)
+  if (ATrace_isEnabled ())
+    ATrace_beginSection (name);
+#elif defined(CLUTTER_ENABLE_TRACING) && defined(HAVE_SYSPROF)
+  TraceStack *stack = trace_stack_get ();
+
+  if (stack->depth == TRACE_MAX_DEPTH)
+    {
+      stack->overflow += 1;
+      return;
+    }
+
+  stack->begin_time[stack->depth] = SYSPROF_CAPTURE_CURRENT_TIME;
+  stack->name[stack->depth] = g_strdup (name);
+  stack->depth += 1;
+#endif
+}
+
+void
+_clutter_trace_end (void)
+{
+#if defined(CLUTTER_ENABLE_TRACING) && defined(__ANDROID__)
+  /* the section is closed even if tracing was turned off after it was
+   * opened; ATrace ignores unbalanced ends
+   */
+  ATrace_endSection ();
+#elif defined(CLUTTER_ENABLE_TRACING) && defined(HAVE_SYSPROF)
+  TraceStack *stack = trace_stack_get ();
+  gint64 begin_time;
+  char *name;
+
+  if (stack->overflow > 0)
+    {
+      stack->overflow -= 1;
+      return;
+    }
+
+  if (stack->depth == 0)
+    return;
+
+  stack->depth -= 1;
+  begin_time = stack->begin_time[stack->depth];
+  name = stack->name[stack->depth];
+
+  sysprof_collector_mark (begin_time,
+                          SYSPROF_CAPTURE_CURRENT_TIME - begin_time,
+                          "Clutter",
+                          name,
+                          NULL);
+
+  g_free (name);
+#endif
+}
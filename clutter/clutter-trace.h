@@ -0,0 +1,73 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_TRACE_H__
+#define __CLUTTER_TRACE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+  CLUTTER_TRACE_STAGE           = 1 << 0,
+  CLUTTER_TRACE_LAYOUT          = 1 << 1,
+  CLUTTER_TRACE_PAINT           = 1 << 2,
+  CLUTTER_TRACE_PAINT_ACTORS    = 1 << 3,
+  CLUTTER_TRACE_PICK            = 1 << 4,
+  CLUTTER_TRACE_TEXT            = 1 << 5,
+  CLUTTER_TRACE_EFFECTS         = 1 << 6,
+  CLUTTER_TRACE_CLOCK           = 1 << 7
+} ClutterTraceFlag;
+
+#ifdef CLUTTER_ENABLE_TRACING
+
+#define CLUTTER_HAS_TRACE(type)         ((clutter_trace_flags & CLUTTER_TRACE_##type) != FALSE)
+
+/* Every CLUTTER_TRACE_BEGIN() must be matched by a CLUTTER_TRACE_END()
+ * with the same category on the same thread; the name is only read
+ * while the span is being opened, so it can be a temporary string.
+ */
+#define CLUTTER_TRACE_BEGIN(type,name)                  G_STMT_START {  \
+        if (G_UNLIKELY (CLUTTER_HAS_TRACE (type)))                      \
+          _clutter_trace_begin ((name));                                \
+                                                        } G_STMT_END
+
+#define CLUTTER_TRACE_END(type)                         G_STMT_START {  \
+        if (G_UNLIKELY (CLUTTER_HAS_TRACE (type)))                      \
+          _clutter_trace_end ();                                        \
+                                                        } G_STMT_END
+
+#else /* !CLUTTER_ENABLE_TRACING */
+
+#define CLUTTER_HAS_TRACE(type)         FALSE
+#define CLUTTER_TRACE_BEGIN(type,name)  G_STMT_START { } G_STMT_END
+#define CLUTTER_TRACE_END(type)         G_STMT_START { } G_STMT_END
+
+#endif /* CLUTTER_ENABLE_TRACING */
+
+extern guint clutter_trace_flags;
+
+void    _clutter_trace_begin    (const char *name);
+void    _clutter_trace_end      (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TRACE_H__ */
@@ -44,11 +44,20 @@
 #include "clutter-transition-group.h"
 
 #include "clutter-debug.h"
+#include "clutter-master-clock.h"
 #include "clutter-private.h"
 
+/* the number of distinct progress modes whose progress is computed
+ * once per frame for all the transitions using them
+ */
+#define MAX_PROGRESS_LEADERS    8
+
 struct _ClutterTransitionGroupPrivate
 {
   GHashTable *transitions;
+
+  /* the transitions, in the order they were added */
+  GPtrArray *children;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterTransitionGroup, clutter_transition_group, CLUTTER_TYPE_TRANSITION)
@@ -58,8 +67,10 @@ clutter_transition_group_new_frame (ClutterTimeline *timeline,
                                     gint             elapsed)
 {
   ClutterTransitionGroupPrivate *priv;
-  GHashTableIter iter;
-  gpointer element;
+  ClutterTimeline *leaders[MAX_PROGRESS_LEADERS];
+  ClutterTimelineDirection direction;
+  guint duration;
+  guint i, j, n_leaders;
   gint64 msecs;
 
   priv = CLUTTER_TRANSITION_GROUP (timeline)->priv;
@@ -67,16 +78,54 @@ clutter_transition_group_new_frame (ClutterTimeline *timeline,
   /* get the time elapsed since the last ::new-frame... */
   msecs = clutter_timeline_get_delta (timeline);
 
-  g_hash_table_iter_init (&iter, priv->transitions);
-  while (g_hash_table_iter_next (&iter, &element, NULL))
+  direction = clutter_timeline_get_direction (timeline);
+  duration = clutter_timeline_get_duration (timeline);
+
+  n_leaders = 0;
+
+  for (i = 0; i < priv->children->len; i++)
     {
-      ClutterTimeline *t = element;
+      ClutterTimeline *t = g_ptr_array_index (priv->children, i);
+      ClutterTimeline *leader = NULL;
+
+      clutter_timeline_set_direction (t, direction);
+      clutter_timeline_set_duration (t, duration);
+
+      /* the transitions using the same progress mode are advanced by
+       * the same amount, so the first one computes the progress for
+       * all the others
+       */
+      for (j = 0; j < n_leaders; j++)
+        {
+          if (_clutter_timeline_shares_progress (t, leaders[j]))
+            {
+              leader = leaders[j];
+              break;
+            }
+        }
+
+      /* the leaders are kept alive until the end of the frame, in
+       * case they are removed from the group while advancing
+       */
+      if (leader == NULL && n_leaders < MAX_PROGRESS_LEADERS)
+        {
+          leaders[n_leaders++] = g_object_ref (t);
+          leader = t;
+        }
+
+      _clutter_timeline_set_progress_leader (t, leader);
 
       /* ... and advance every timeline */
-      clutter_timeline_set_direction (t, clutter_timeline_get_direction (timeline));
-      clutter_timeline_set_duration (t, clutter_timeline_get_duration (timeline));
-
       _clutter_timeline_advance (t, msecs);
+
+      if (leader != t)
+        _clutter_timeline_set_progress_leader (t, NULL);
+    }
+
+  for (j = 0; j < n_leaders; j++)
+    {
+      _clutter_timeline_set_progress_leader (leaders[j], NULL);
+      g_object_unref (leaders[j]);
     }
 }
 
@@ -85,15 +134,13 @@ clutter_transition_group_attached (ClutterTransition *transition,
                                    ClutterAnimatable *animatable)
 {
   ClutterTransitionGroupPrivate *priv;
-  GHashTableIter iter;
-  gpointer element;
+  guint i;
 
   priv = CLUTTER_TRANSITION_GROUP (transition)->priv;
 
-  g_hash_table_iter_init (&iter, priv->transitions);
-  while (g_hash_table_iter_next (&iter, &element, NULL))
+  for (i = 0; i < priv->children->len; i++)
     {
-      ClutterTransition *t = element;
+      ClutterTransition *t = g_ptr_array_index (priv->children, i);
 
       clutter_transition_set_animatable (t, animatable);
     }
@@ -104,15 +151,13 @@ clutter_transition_group_detached (ClutterTransition *transition,
                                    ClutterAnimatable *animatable)
 {
   ClutterTransitionGroupPrivate *priv;
-  GHashTableIter iter;
-  gpointer element;
+  guint i;
 
   priv = CLUTTER_TRANSITION_GROUP (transition)->priv;
 
-  g_hash_table_iter_init (&iter, priv->transitions);
-  while (g_hash_table_iter_next (&iter, &element, NULL))
+  for (i = 0; i < priv->children->len; i++)
     {
-      ClutterTransition *t = element;
+      ClutterTransition *t = g_ptr_array_index (priv->children, i);
 
       clutter_transition_set_animatable (t, NULL);
     }
@@ -122,15 +167,13 @@ static void
 clutter_transition_group_started (ClutterTimeline *timeline)
 {
   ClutterTransitionGroupPrivate *priv;
-  GHashTableIter iter;
-  gpointer element;
+  guint i;
 
   priv = CLUTTER_TRANSITION_GROUP (timeline)->priv;
 
-  g_hash_table_iter_init (&iter, priv->transitions);
-  while (g_hash_table_iter_next (&iter, &element, NULL))
+  for (i = 0; i < priv->children->len; i++)
     {
-      ClutterTransition *t = element;
+      ClutterTransition *t = g_ptr_array_index (priv->children, i);
 
       g_signal_emit_by_name (t, "started");
     }
@@ -143,6 +186,7 @@ clutter_transition_group_finalize (GObject *gobject)
 
   priv = CLUTTER_TRANSITION_GROUP (gobject)->priv;
 
+  g_ptr_array_unref (priv->children);
   g_hash_table_unref (priv->transitions);
 
   G_OBJECT_CLASS (clutter_transition_group_parent_class)->finalize (gobject);
@@ -170,6 +214,7 @@ clutter_transition_group_init (ClutterTransitionGroup *self)
   self->priv = clutter_transition_group_get_instance_private (self);
   self->priv->transitions =
     g_hash_table_new_full (NULL, NULL, (GDestroyNotify) g_object_unref, NULL);
+  self->priv->children = g_ptr_array_new ();
 }
 
 /**
@@ -208,7 +253,11 @@ clutter_transition_group_add_transition (ClutterTransitionGroup *group,
   g_return_if_fail (CLUTTER_IS_TRANSITION_GROUP (group));
   g_return_if_fail (CLUTTER_IS_TRANSITION (transition));
 
+  if (g_hash_table_contains (group->priv->transitions, transition))
+    return;
+
   g_hash_table_add (group->priv->transitions, g_object_ref (transition));
+  g_ptr_array_add (group->priv->children, transition);
 }
 
 /**
@@ -229,6 +278,10 @@ clutter_transition_group_remove_transition (ClutterTransitionGroup *group,
 {
   g_return_if_fail (CLUTTER_IS_TRANSITION_GROUP (group));
 
+  if (!g_hash_table_contains (group->priv->transitions, transition))
+    return;
+
+  g_ptr_array_remove (group->priv->children, transition);
   g_hash_table_remove (group->priv->transitions, transition);
 }
 
@@ -248,5 +301,6 @@ clutter_transition_group_remove_all (ClutterTransitionGroup *group)
 {
   g_return_if_fail (CLUTTER_IS_TRANSITION_GROUP (group));
 
+  g_ptr_array_set_size (group->priv->children, 0);
   g_hash_table_remove_all (group->priv->transitions);
 }
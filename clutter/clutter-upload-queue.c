@@ -0,0 +1,184 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ *
+ * ClutterUploadQueue: spreads the texture uploads of the contents
+ * over several frames.
+ *
+ * The uploads pushed on the queue are run by a pre-paint repaint
+ * function, until the number of bytes uploaded during the frame goes
+ * over the budget set using the CLUTTER_UPLOAD_BUDGET environment
+ * variable; the remaining uploads wait for the next frame. At least
+ * one upload is run for each frame, however large it is.
+ *
+ * The uploads of the contents painted by an actor whose paint box is
+ * inside its stage go first; the other ones keep the order in which
+ * they were pushed.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-upload-queue.h"
+
+#include "clutter-content-private.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-master-clock.h"
+#include "clutter-private.h"
+
+typedef struct _UploadEntry
+{
+  /* the content the texture is for, or NULL */
+  ClutterContent *content;
+
+  /* the estimated size of the upload, in bytes */
+  gsize size;
+
+  ClutterUploadFunc func;
+  gpointer data;
+  GDestroyNotify notify;
+} UploadEntry;
+
+static GQueue upload_queue = G_QUEUE_INIT;
+
+static guint upload_repaint_id = 0;
+
+static void
+upload_entry_run (UploadEntry *entry)
+{
+  entry->func (entry->data);
+
+  if (entry->notify != NULL)
+    entry->notify (entry->data);
+
+  if (entry->content != NULL)
+    g_object_unref (entry->content);
+
+  g_slice_free (UploadEntry, entry);
+}
+
+static gboolean
+upload_queue_run (gpointer dummy G_GNUC_UNUSED)
+{
+  gsize budget = _clutter_get_upload_budget ();
+  gsize uploaded = 0;
+  guint n_uploads = 0;
+  int pass;
+
+  /* the first pass only runs the uploads of the contents on screen */
+  for (pass = 0; pass < 2; pass++)
+    {
+      GList *l, *next;
+
+      for (l = upload_queue.head; l != NULL; l = next)
+        {
+          UploadEntry *entry = l->data;
+
+          next = l->next;
+
+          if (pass == 0 &&
+              (entry->content == NULL ||
+               !_clutter_content_is_on_screen (entry->content)))
+            continue;
+
+          if (n_uploads > 0 && uploaded + entry->size > budget)
+            goto out;
+
+          g_queue_delete_link (&upload_queue, l);
+
+          uploaded += entry->size;
+          n_uploads += 1;
+
+          upload_entry_run (entry);
+        }
+    }
+
+out:
+  CLUTTER_NOTE (TEXTURE, "Uploaded %u textures (%" G_GSIZE_FORMAT " bytes), "
+                         "%u left for the next frames",
+                n_uploads,
+                uploaded,
+                upload_queue.length);
+
+  if (g_queue_is_empty (&upload_queue))
+    {
+      upload_repaint_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  /* the remaining uploads need a frame, even if nothing else changes */
+  _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+
+  return G_SOURCE_CONTINUE;
+}
+
+/*< private >
+ * _clutter_upload_queue_push:
+ * @content: (allow-none): the #ClutterContent the upload is for, or %NULL
+ * @size: the estimated size of the upload, in bytes
+ * @func: the function uploading the texture
+ * @data: the data to pass to @func
+ * @notify: the function called to free @data after @func
+ *
+ * Queues the upload of a texture, which is run before painting one
+ * of the next frames, depending on the upload budget and on whether
+ * @content is visible.
+ *
+ * If the CLUTTER_UPLOAD_BUDGET environment variable is set to 0, @func
+ * is called immediately.
+ */
+void
+_clutter_upload_queue_push (ClutterContent    *content,
+                            gsize              size,
+                            ClutterUploadFunc  func,
+                            gpointer           data,
+                            GDestroyNotify     notify)
+{
+  UploadEntry *entry;
+
+  entry = g_slice_new (UploadEntry);
+  entry->content = content != NULL ? g_object_ref (content) : NULL;
+  entry->size = size;
+  entry->func = func;
+  entry->data = data;
+  entry->notify = notify;
+
+  if (_clutter_get_upload_budget () == 0)
+    {
+      upload_entry_run (entry);
+      return;
+    }
+
+  g_queue_push_tail (&upload_queue, entry);
+
+  if (upload_repaint_id == 0)
+    {
+      upload_repaint_id =
+        clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                               CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                               upload_queue_run,
+                                               NULL, NULL);
+    }
+}
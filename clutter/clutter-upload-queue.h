@@ -0,0 +1,46 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __CLUTTER_UPLOAD_QUEUE_H__
+#define __CLUTTER_UPLOAD_QUEUE_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+/*< private >
+ * ClutterUploadFunc:
+ * @data: the data passed to _clutter_upload_queue_push()
+ *
+ * Uploads the data of a queued texture to the GPU.
+ */
+typedef void (* ClutterUploadFunc) (gpointer data);
+
+void    _clutter_upload_queue_push      (ClutterContent    *content,
+                                         gsize              size,
+                                         ClutterUploadFunc  func,
+                                         gpointer           data,
+                                         GDestroyNotify     notify);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_UPLOAD_QUEUE_H__ */
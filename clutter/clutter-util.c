@@ -38,10 +38,12 @@
 
 #include <glib/gi18n-lib.h>
 
+#include "clutter-box4-private.h"
 #include "clutter-debug.h"
 #include "clutter-main.h"
 #include "clutter-interval.h"
 #include "clutter-private.h"
+#include "clutter-vertex-kernels.h"
 
 #include "deprecated/clutter-util.h"
 
@@ -80,13 +82,6 @@ _clutter_gettext (const gchar *str)
   return g_dgettext (GETTEXT_PACKAGE, str);
 }
 
-/* Help macros to scale from OpenGL <-1,1> coordinates system to
- * window coordinates ranging [0,window-size]
- */
-#define MTX_GL_SCALE_X(x,w,v1,v2) ((((((x) / (w)) + 1.0f) / 2.0f) * (v1)) + (v2))
-#define MTX_GL_SCALE_Y(y,w,v1,v2) ((v1) - (((((y) / (w)) + 1.0f) / 2.0f) * (v1)) + (v2))
-#define MTX_GL_SCALE_Z(z,w,v1,v2) (MTX_GL_SCALE_X ((z), (w), (v1), (v2)))
-
 void
 _clutter_util_fully_transform_vertices (const CoglMatrix *modelview,
                                         const CoglMatrix *projection,
@@ -95,55 +90,195 @@ _clutter_util_fully_transform_vertices (const CoglMatrix *modelview,
                                         ClutterVertex *vertices_out,
                                         int n_vertices)
 {
-  CoglMatrix modelview_projection;
-  ClutterVertex4 *vertices_tmp;
-  int i;
-
-  vertices_tmp = g_alloca (sizeof (ClutterVertex4) * n_vertices);
+  const ClutterVertexKernel *kernel = _clutter_vertex_kernel_get_default ();
 
   if (n_vertices >= 4)
     {
+      CoglMatrix modelview_projection;
+
       /* XXX: we should find a way to cache this per actor */
       cogl_matrix_multiply (&modelview_projection,
                             projection,
                             modelview);
-      cogl_matrix_project_points (&modelview_projection,
-                                  3,
-                                  sizeof (ClutterVertex),
-                                  vertices_in,
-                                  sizeof (ClutterVertex4),
-                                  vertices_tmp,
-                                  n_vertices);
+      kernel->project (cogl_matrix_get_array (&modelview_projection),
+                       viewport,
+                       vertices_in,
+                       vertices_out,
+                       n_vertices);
     }
   else
     {
-      cogl_matrix_transform_points (modelview,
-                                    3,
-                                    sizeof (ClutterVertex),
-                                    vertices_in,
-                                    sizeof (ClutterVertex4),
-                                    vertices_tmp,
-                                    n_vertices);
-
-      cogl_matrix_project_points (projection,
-                                  3,
-                                  sizeof (ClutterVertex4),
-                                  vertices_tmp,
-                                  sizeof (ClutterVertex4),
-                                  vertices_tmp,
-                                  n_vertices);
+      ClutterVertex *vertices_tmp;
+      int i;
+
+      /* multiplying the matrices costs more than transforming a few
+       * vertices twice
+       */
+      vertices_tmp = g_alloca (sizeof (ClutterVertex) * n_vertices);
+
+      kernel->transform (cogl_matrix_get_array (modelview),
+                         vertices_in,
+                         vertices_tmp,
+                         n_vertices);
+      kernel->project (cogl_matrix_get_array (projection),
+                       viewport,
+                       vertices_tmp,
+                       vertices_tmp,
+                       n_vertices);
+
+      for (i = 0; i < n_vertices; i++)
+        {
+          vertices_out[i].x = vertices_tmp[i].x;
+          vertices_out[i].y = vertices_tmp[i].y;
+        }
     }
+}
 
-  for (i = 0; i < n_vertices; i++)
+/*< private >
+ * _clutter_util_transform_vertices:
+ * @matrix: the matrix to apply
+ * @vertices_in: the vertices to transform
+ * @vertices_out: return location for the transformed vertices; this
+ *   can be the same as @vertices_in
+ * @n_vertices: the number of vertices
+ *
+ * Transforms @n_vertices vertices by the affine part of @matrix, like
+ * cogl_matrix_transform_points() with 3 components.
+ */
+void
+_clutter_util_transform_vertices (const CoglMatrix    *matrix,
+                                  const ClutterVertex *vertices_in,
+                                  ClutterVertex       *vertices_out,
+                                  int                  n_vertices)
+{
+  const ClutterVertexKernel *kernel = _clutter_vertex_kernel_get_default ();
+
+  kernel->transform (cogl_matrix_get_array (matrix),
+                     vertices_in,
+                     vertices_out,
+                     n_vertices);
+}
+
+/* the distance, in pixels, under which two window coordinates are
+ * considered the same when checking whether a clip is axis-aligned
+ */
+#define CLIP_ALIGNMENT_EPSILON  0.01f
+
+#define CLIP_COORDS_EQUAL(a,b)  (fabsf ((a) - (b)) < CLIP_ALIGNMENT_EPSILON)
+
+#ifdef CLUTTER_ENABLE_DEBUG
+static gulong n_scissor_clips = 0;
+static gulong n_rectangle_clips = 0;
+#endif
+
+/*< private >
+ * _clutter_util_push_rectangle_clip:
+ * @framebuffer: a #CoglFramebuffer
+ * @x_1: x coordinate of the top-left corner of the clip
+ * @y_1: y coordinate of the top-left corner of the clip
+ * @x_2: x coordinate of the bottom-right corner of the clip
+ * @y_2: y coordinate of the bottom-right corner of the clip
+ *
+ * Pushes a rectangle clip, in the coordinates of the current model-view
+ * matrix of @framebuffer, like cogl_framebuffer_push_rectangle_clip().
+ *
+ * If the rectangle is still axis-aligned once it is transformed into
+ * window coordinates, which is the case for any combination of
+ * translations, scales and rotations by multiples of 90 degrees around
+ * the Z axis, then it is pushed as a scissor clip, which does not need
+ * the stencil buffer and does not break the batching of the journal.
+ * Only the truly rotated clips go through Cogl.
+ *
+ * Use cogl_framebuffer_pop_clip() to remove the clip.
+ */
+void
+_clutter_util_push_rectangle_clip (CoglFramebuffer *framebuffer,
+                                   float            x_1,
+                                   float            y_1,
+                                   float            x_2,
+                                   float            y_2)
+{
+  CoglMatrix modelview, projection;
+  ClutterVertex rect[4], vertices[4];
+  float viewport[4];
+  float min_x, min_y, max_x, max_y;
+  gboolean is_aligned;
+  int i;
+
+  cogl_framebuffer_get_modelview_matrix (framebuffer, &modelview);
+  cogl_framebuffer_get_projection_matrix (framebuffer, &projection);
+  cogl_framebuffer_get_viewport4fv (framebuffer, viewport);
+
+  clutter_vertex_init (&rect[0], x_1, y_1, 0.f);
+  clutter_vertex_init (&rect[1], x_2, y_1, 0.f);
+  clutter_vertex_init (&rect[2], x_2, y_2, 0.f);
+  clutter_vertex_init (&rect[3], x_1, y_2, 0.f);
+
+  _clutter_util_fully_transform_vertices (&modelview, &projection, viewport,
+                                          rect, vertices,
+                                          4);
+
+  /* the edges of the quad must be either horizontal and vertical, or
+   * vertical and horizontal if the clip was rotated by 90 degrees
+   */
+  is_aligned =
+    (CLIP_COORDS_EQUAL (vertices[0].y, vertices[1].y) &&
+     CLIP_COORDS_EQUAL (vertices[1].x, vertices[2].x) &&
+     CLIP_COORDS_EQUAL (vertices[2].y, vertices[3].y) &&
+     CLIP_COORDS_EQUAL (vertices[3].x, vertices[0].x)) ||
+    (CLIP_COORDS_EQUAL (vertices[0].x, vertices[1].x) &&
+     CLIP_COORDS_EQUAL (vertices[1].y, vertices[2].y) &&
+     CLIP_COORDS_EQUAL (vertices[2].x, vertices[3].x) &&
+     CLIP_COORDS_EQUAL (vertices[3].y, vertices[0].y));
+
+  if (!is_aligned)
+    {
+#ifdef CLUTTER_ENABLE_DEBUG
+      n_rectangle_clips += 1;
+      CLUTTER_NOTE (CLIPPING, "Transformed rectangle clip (scissor: %lu, "
+                              "rectangle: %lu)",
+                    n_scissor_clips,
+                    n_rectangle_clips);
+#endif
+
+      cogl_framebuffer_push_rectangle_clip (framebuffer, x_1, y_1, x_2, y_2);
+      return;
+    }
+
+  min_x = max_x = vertices[0].x;
+  min_y = max_y = vertices[0].y;
+
+  for (i = 1; i < 4; i++)
     {
-      ClutterVertex4 vertex_tmp = vertices_tmp[i];
-      ClutterVertex *vertex_out = &vertices_out[i];
-      /* Finally translate from OpenGL coords to window coords */
-      vertex_out->x = MTX_GL_SCALE_X (vertex_tmp.x, vertex_tmp.w,
-                                      viewport[2], viewport[0]);
-      vertex_out->y = MTX_GL_SCALE_Y (vertex_tmp.y, vertex_tmp.w,
-                                      viewport[3], viewport[1]);
+      min_x = MIN (min_x, vertices[i].x);
+      min_y = MIN (min_y, vertices[i].y);
+      max_x = MAX (max_x, vertices[i].x);
+      max_y = MAX (max_y, vertices[i].y);
     }
+
+  /* a pixel is inside the clip if its center is, like with the
+   * stencil buffer
+   */
+  min_x = nearbyintf (min_x);
+  min_y = nearbyintf (min_y);
+  max_x = nearbyintf (max_x);
+  max_y = nearbyintf (max_y);
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  n_scissor_clips += 1;
+  CLUTTER_NOTE (CLIPPING, "Scissor clip [%d, %d, %d, %d] (scissor: %lu, "
+                          "rectangle: %lu)",
+                (int) min_x, (int) min_y,
+                (int) (max_x - min_x), (int) (max_y - min_y),
+                n_scissor_clips,
+                n_rectangle_clips);
+#endif
+
+  cogl_framebuffer_push_scissor_clip (framebuffer,
+                                      (int) min_x,
+                                      (int) min_y,
+                                      (int) (max_x - min_x),
+                                      (int) (max_y - min_y));
 }
 
 /*< private >
@@ -166,15 +301,9 @@ _clutter_util_rectangle_union (const cairo_rectangle_int_t *src1,
                                const cairo_rectangle_int_t *src2,
                                cairo_rectangle_int_t       *dest)
 {
-  int dest_x, dest_y;
-
-  dest_x = MIN (src1->x, src2->x);
-  dest_y = MIN (src1->y, src2->y);
-
-  dest->width = MAX (src1->x + src1->width, src2->x + src2->width) - dest_x;
-  dest->height = MAX (src1->y + src1->height, src2->y + src2->height) - dest_y;
-  dest->x = dest_x;
-  dest->y = dest_y;
+  _clutter_box4i_to_rectangle (_clutter_box4i_union (_clutter_box4i_from_rectangle (src1),
+                                                     _clutter_box4i_from_rectangle (src2)),
+                               dest);
 }
 
 float
@@ -262,6 +391,89 @@ _clutter_util_matrix_skew_yz (ClutterMatrix *matrix,
   matrix->zw += matrix->yw * factor;
 }
 
+/*< private >
+ * _clutter_util_matrix_get_kind:
+ * @matrix: a #ClutterMatrix
+ *
+ * Classifies @matrix according to the operations it performs; only the
+ * matrices keeping the z = 0 plane in place, without any perspective,
+ * are 2D transformations.
+ *
+ * Return value: the kind of @matrix
+ */
+ClutterTransformKind
+_clutter_util_matrix_get_kind (const ClutterMatrix *matrix)
+{
+  if (matrix->zx != 0.f || matrix->zy != 0.f ||
+      matrix->xz != 0.f || matrix->yz != 0.f ||
+      matrix->zz != 1.f || matrix->zw != 0.f ||
+      matrix->wx != 0.f || matrix->wy != 0.f ||
+      matrix->wz != 0.f || matrix->ww != 1.f)
+    return CLUTTER_TRANSFORM_KIND_3D;
+
+  if (matrix->xx != 1.f || matrix->yx != 0.f ||
+      matrix->xy != 0.f || matrix->yy != 1.f)
+    return CLUTTER_TRANSFORM_KIND_AFFINE_2D;
+
+  if (matrix->xw != 0.f || matrix->yw != 0.f)
+    return CLUTTER_TRANSFORM_KIND_TRANSLATE;
+
+  return CLUTTER_TRANSFORM_KIND_IDENTITY;
+}
+
+/*< private >
+ * _clutter_util_matrix_multiply_kind:
+ * @result: return location for the product; this can be the same as @a
+ * @a: the left matrix
+ * @b: the right matrix
+ * @b_kind: the kind of @b, as returned by _clutter_util_matrix_get_kind()
+ *
+ * Multiplies @a by @b like cogl_matrix_multiply(), only computing the
+ * columns of @a that are affected by @b if @b is a 2D transformation.
+ */
+void
+_clutter_util_matrix_multiply_kind (ClutterMatrix       *result,
+                                    const ClutterMatrix *a,
+                                    const ClutterMatrix *b,
+                                    ClutterTransformKind b_kind)
+{
+  const float *m;
+  float r[16];
+  int i;
+
+  switch (b_kind)
+    {
+    case CLUTTER_TRANSFORM_KIND_IDENTITY:
+      if (result != a)
+        *result = *a;
+      return;
+
+    case CLUTTER_TRANSFORM_KIND_3D:
+      cogl_matrix_multiply (result, a, b);
+      return;
+
+    case CLUTTER_TRANSFORM_KIND_TRANSLATE:
+    case CLUTTER_TRANSFORM_KIND_AFFINE_2D:
+      break;
+    }
+
+  /* the columns of @b are (xx, yx, 0, 0), (xy, yy, 0, 0), (0, 0, 1, 0)
+   * and (xw, yw, 0, 1), so the third column of @a does not change
+   */
+  m = cogl_matrix_get_array (a);
+
+  for (i = 0; i < 4; i++)
+    {
+      r[i] = m[i] * b->xx + m[4 + i] * b->yx;
+      r[4 + i] = m[i] * b->xy + m[4 + i] * b->yy;
+      r[8 + i] = m[8 + i];
+      r[12 + i] = m[i] * b->xw + m[4 + i] * b->yw + m[12 + i];
+    }
+
+  /* this also resets the cached type and inverse of @result */
+  cogl_matrix_init_from_array (result, r);
+}
+
 static float
 _clutter_util_vertex_length (const ClutterVertex *vertex)
 {
@@ -517,6 +729,92 @@ _clutter_util_matrix_decompose (const ClutterMatrix *src,
   return TRUE;
 }
 
+/*< private >
+ * _clutter_util_matrix_get_components:
+ * @matrix: the matrix to decompose
+ * @components: (out caller-allocates): return location for the components
+ *
+ * Decomposes @matrix with _clutter_util_matrix_decompose(); if @matrix
+ * cannot be decomposed, @components describes the identity.
+ */
+void
+_clutter_util_matrix_get_components (const ClutterMatrix     *matrix,
+                                     ClutterMatrixComponents *components)
+{
+  clutter_vertex_init (&components->scale, 1.f, 1.f, 1.f);
+  components->shear[0] = components->shear[1] = components->shear[2] = 0.f;
+  clutter_vertex_init (&components->rotate, 0.f, 0.f, 0.f);
+  clutter_vertex_init (&components->translate, 0.f, 0.f, 0.f);
+  components->perspective.x = components->perspective.y = 0.f;
+  components->perspective.z = components->perspective.w = 0.f;
+
+  _clutter_util_matrix_decompose (matrix,
+                                  &components->scale,
+                                  components->shear,
+                                  &components->rotate,
+                                  &components->translate,
+                                  &components->perspective);
+}
+
+/*< private >
+ * _clutter_util_matrix_components_interpolate:
+ * @a: the initial components
+ * @b: the final components
+ * @progress: the interpolation progress
+ * @res: (out caller-allocates): return location for the interpolated matrix
+ *
+ * Interpolates the components of two decomposed matrices, and composes
+ * the resulting matrix.
+ */
+void
+_clutter_util_matrix_components_interpolate (const ClutterMatrixComponents *a,
+                                             const ClutterMatrixComponents *b,
+                                             double                         progress,
+                                             ClutterMatrix                 *res)
+{
+  ClutterVertex4 perspective_res;
+  ClutterVertex vertex_res;
+  float shear_res;
+
+  clutter_matrix_init_identity (res);
+
+  /* perspective */
+  _clutter_util_vertex4_interpolate (&a->perspective, &b->perspective,
+                                     progress,
+                                     &perspective_res);
+  res->wx = perspective_res.x;
+  res->wy = perspective_res.y;
+  res->wz = perspective_res.z;
+  res->ww = perspective_res.w;
+
+  /* translation */
+  clutter_vertex_interpolate (&a->translate, &b->translate, progress, &vertex_res);
+  cogl_matrix_translate (res, vertex_res.x, vertex_res.y, vertex_res.z);
+
+  /* rotation */
+  clutter_vertex_interpolate (&a->rotate, &b->rotate, progress, &vertex_res);
+  cogl_matrix_rotate (res, vertex_res.x, 1.0f, 0.0f, 0.0f);
+  cogl_matrix_rotate (res, vertex_res.y, 0.0f, 1.0f, 0.0f);
+  cogl_matrix_rotate (res, vertex_res.z, 0.0f, 0.0f, 1.0f);
+
+  /* skew */
+  shear_res = a->shear[2] + (b->shear[2] - a->shear[2]) * progress; /* YZ */
+  if (shear_res != 0.f)
+    _clutter_util_matrix_skew_yz (res, shear_res);
+
+  shear_res = a->shear[1] + (b->shear[1] - a->shear[1]) * progress; /* XZ */
+  if (shear_res != 0.f)
+    _clutter_util_matrix_skew_xz (res, shear_res);
+
+  shear_res = a->shear[0] + (b->shear[0] - a->shear[0]) * progress; /* XY */
+  if (shear_res != 0.f)
+    _clutter_util_matrix_skew_xy (res, shear_res);
+
+  /* scale */
+  clutter_vertex_interpolate (&a->scale, &b->scale, progress, &vertex_res);
+  cogl_matrix_scale (res, vertex_res.x, vertex_res.y, vertex_res.z);
+}
+
 typedef struct
 {
   GType value_type;
@@ -526,6 +824,24 @@ typedef struct
 G_LOCK_DEFINE_STATIC (progress_funcs);
 static GHashTable *progress_funcs = NULL;
 
+/* changed every time a progress function is registered or unset */
+static volatile gint progress_funcs_serial = 0;
+
+/*< private >
+ * _clutter_get_progress_functions_serial:
+ *
+ * Retrieves a serial number that changes whenever a progress function
+ * is registered, which allows caching the result of
+ * _clutter_get_progress_function().
+ *
+ * Return value: the serial number of the progress functions
+ */
+guint
+_clutter_get_progress_functions_serial (void)
+{
+  return (guint) g_atomic_int_get (&progress_funcs_serial);
+}
+
 gboolean
 _clutter_has_progress_function (GType gtype)
 {
@@ -537,6 +853,26 @@ _clutter_has_progress_function (GType gtype)
   return g_hash_table_lookup (progress_funcs, type_name) != NULL;
 }
 
+ClutterProgressFunc
+_clutter_get_progress_function (GType gtype)
+{
+  ProgressData *pdata;
+  ClutterProgressFunc res = NULL;
+
+  G_LOCK (progress_funcs);
+
+  if (progress_funcs != NULL)
+    {
+      pdata = g_hash_table_lookup (progress_funcs, g_type_name (gtype));
+      if (pdata != NULL)
+        res = pdata->func;
+    }
+
+  G_UNLOCK (progress_funcs);
+
+  return res;
+}
+
 gboolean
 _clutter_run_progress_function (GType gtype,
                                 const GValue *initial,
@@ -661,5 +997,7 @@ clutter_interval_register_progress_func (GType               value_type,
                             progress_func);
     }
 
+  g_atomic_int_inc (&progress_funcs_serial);
+
   G_UNLOCK (progress_funcs);
 }
@@ -0,0 +1,1235 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * The recorder of the vector drawings of ClutterCanvas.
+ *
+ * The drawing handlers draw with a cairo_t on an observer surface,
+ * wrapping a recording surface. The observer calls us back after each
+ * fill, stroke and paint, while the path, the source and the rest of
+ * the state of the context are still the ones of the operation: the
+ * path is flattened and turned into a CoglPath in device space, which
+ * Cogl tessellates; the strokes are turned into the outline of their
+ * segments, joins and caps, filled with the non-zero rule so that the
+ * overlapping parts are only filled once; the solid sources become the
+ * color of a pipeline, and the linear and radial gradients a snippet
+ * looking up a ramp of their color stops.
+ *
+ * What the commands cannot express, e.g. text, masks, images, dashes,
+ * groups, operators other than OVER, or clips that are not a single
+ * rectangle, makes the whole drawing fall back to the image backend:
+ * the recording surface is replayed on the CPU by the canvas.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include "clutter-vector-recorder.h"
+
+#include "clutter-backend.h"
+#include "clutter-cairo.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+/* the number of texels of the color ramps of the gradients */
+#define RAMP_SIZE               256
+
+/* the largest number of segments of the round joins and caps */
+#define MAX_CIRCLE_SEGMENTS     64
+
+typedef struct {
+  CoglPath *path;
+  CoglPipeline *pipeline;
+
+  /* the clip of the operation, in device pixels */
+  cairo_rectangle_int_t clip;
+  gboolean has_clip;
+} VectorCommand;
+
+typedef struct {
+  float x, y;
+} VectorPoint;
+
+typedef enum {
+  GRADIENT_LINEAR,
+  GRADIENT_RADIAL,
+
+  N_GRADIENT_KINDS
+} GradientKind;
+
+struct _ClutterVectorRecorder
+{
+  cairo_surface_t *recording;
+  cairo_surface_t *observer;
+
+  /* the context of the drawing, while it is running */
+  cairo_t *cr;
+
+  /* the size of the drawing, in device pixels */
+  int width;
+  int height;
+
+  /* the array of VectorCommand, in drawing order */
+  GArray *commands;
+
+  guint fallback : 1;
+};
+
+static const char *gradient_declarations[N_GRADIENT_KINDS] = {
+  "varying vec2 clutter_gradient_pos;\n"
+  "uniform vec3 clutter_gradient_line;\n",
+
+  "varying vec2 clutter_gradient_pos;\n"
+  "uniform vec3 clutter_gradient_row_x;\n"
+  "uniform vec3 clutter_gradient_row_y;\n"
+  "uniform vec3 clutter_gradient_c0;\n"
+  "uniform vec3 clutter_gradient_dc;\n",
+};
+
+/* computes the parameter t of the gradient at the fragment, and
+ * whether the gradient is defined there
+ */
+static const char *gradient_sources[N_GRADIENT_KINDS] = {
+  "  bool valid = true;\n"
+  "  float t = dot (clutter_gradient_line, vec3 (clutter_gradient_pos, 1.0));\n",
+
+  /* the largest t for which the point is on the circle interpolated
+   * between the two circles, with a positive radius
+   */
+  "  bool valid = true;\n"
+  "  float t = 0.0;\n"
+  "  vec3 pos = vec3 (clutter_gradient_pos, 1.0);\n"
+  "  vec2 pd = vec2 (dot (clutter_gradient_row_x, pos),\n"
+  "                  dot (clutter_gradient_row_y, pos)) - clutter_gradient_c0.xy;\n"
+  "  float r0 = clutter_gradient_c0.z;\n"
+  "  float dr = clutter_gradient_dc.z;\n"
+  "  float a = dot (clutter_gradient_dc.xy, clutter_gradient_dc.xy) - dr * dr;\n"
+  "  float b = dot (pd, clutter_gradient_dc.xy) + r0 * dr;\n"
+  "  float c = dot (pd, pd) - r0 * r0;\n"
+  "  if (abs (a) < 0.00001)\n"
+  "    {\n"
+  "      valid = b != 0.0;\n"
+  "      if (valid)\n"
+  "        t = c / (2.0 * b);\n"
+  "    }\n"
+  "  else\n"
+  "    {\n"
+  "      float disc = b * b - a * c;\n"
+  "      valid = disc >= 0.0;\n"
+  "      if (valid)\n"
+  "        {\n"
+  "          float s = sqrt (disc);\n"
+  "          float t1 = (b + s) / a;\n"
+  "          float t2 = (b - s) / a;\n"
+  "          t = max (t1, t2);\n"
+  "          if (r0 + t * dr < 0.0)\n"
+  "            t = min (t1, t2);\n"
+  "        }\n"
+  "    }\n"
+  "  valid = valid && r0 + t * dr >= 0.0;\n",
+};
+
+/* maps t to [0, 1] according to the extend of the gradient */
+static const char *extend_sources[] = {
+  /* CAIRO_EXTEND_NONE */
+  "  valid = valid && t >= 0.0 && t <= 1.0;\n",
+  /* CAIRO_EXTEND_REPEAT */
+  "  t = fract (t);\n",
+  /* CAIRO_EXTEND_REFLECT */
+  "  t = 1.0 - abs (mod (t, 2.0) - 1.0);\n",
+  /* CAIRO_EXTEND_PAD */
+  "",
+};
+
+/* texel i of the ramp holds the color of the gradient at i / 255 */
+static const char *ramp_lookup_source =
+  "  t = clamp (t, 0.0, 1.0);\n"
+  "  cogl_color_out = valid\n"
+  "                 ? texture2D (cogl_sampler0, vec2 ((t * 255.0 + 0.5) / 256.0, 0.5))\n"
+  "                 : vec4 (0.0);\n";
+
+static CoglContext *
+get_cogl_context (void)
+{
+  return clutter_backend_get_cogl_context (clutter_get_default_backend ());
+}
+
+static void
+vector_command_clear (gpointer data)
+{
+  VectorCommand *command = data;
+
+  cogl_object_unref (command->path);
+  cogl_object_unref (command->pipeline);
+}
+
+static void
+recorder_set_fallback (ClutterVectorRecorder *recorder,
+                       const char            *reason)
+{
+  if (recorder->fallback)
+    return;
+
+  CLUTTER_NOTE (MISC, "Vector drawing falling back to the image backend: %s",
+                reason);
+
+  recorder->fallback = TRUE;
+  g_array_set_size (recorder->commands, 0);
+}
+
+/* retrieves the clip of the context in device pixels; the clips that
+ * are not a single rectangle are not supported
+ */
+static gboolean
+recorder_get_clip (ClutterVectorRecorder *recorder,
+                   cairo_rectangle_int_t *clip)
+{
+  cairo_rectangle_list_t *list;
+  gboolean res = TRUE;
+
+  list = cairo_copy_clip_rectangle_list (recorder->cr);
+
+  if (list->status != CAIRO_STATUS_SUCCESS || list->num_rectangles > 1)
+    res = FALSE;
+  else if (list->num_rectangles == 0)
+    {
+      clip->x = clip->y = 0;
+      clip->width = clip->height = 0;
+    }
+  else
+    {
+      const cairo_rectangle_t *rect = &list->rectangles[0];
+      double x_1 = rect->x, y_1 = rect->y;
+      double x_2 = rect->x + rect->width, y_2 = rect->y + rect->height;
+      int left, top, right, bottom;
+
+      cairo_user_to_device (recorder->cr, &x_1, &y_1);
+      cairo_user_to_device (recorder->cr, &x_2, &y_2);
+
+      left = CLAMP (floor (MIN (x_1, x_2)), 0, recorder->width);
+      top = CLAMP (floor (MIN (y_1, y_2)), 0, recorder->height);
+      right = CLAMP (ceil (MAX (x_1, x_2)), 0, recorder->width);
+      bottom = CLAMP (ceil (MAX (y_1, y_2)), 0, recorder->height);
+
+      clip->x = left;
+      clip->y = top;
+      clip->width = right - left;
+      clip->height = bottom - top;
+    }
+
+  cairo_rectangle_list_destroy (list);
+
+  return res;
+}
+
+/* the matrix from device space to the space of @pattern */
+static void
+recorder_get_pattern_matrix (ClutterVectorRecorder *recorder,
+                             cairo_pattern_t       *pattern,
+                             cairo_matrix_t        *matrix)
+{
+  cairo_matrix_t device_to_user, pattern_matrix;
+  double x_0 = 0, y_0 = 0, x_1 = 1, y_1 = 0, x_2 = 0, y_2 = 1;
+
+  cairo_device_to_user (recorder->cr, &x_0, &y_0);
+  cairo_device_to_user (recorder->cr, &x_1, &y_1);
+  cairo_device_to_user (recorder->cr, &x_2, &y_2);
+
+  cairo_matrix_init (&device_to_user,
+                     x_1 - x_0, y_1 - y_0,
+                     x_2 - x_0, y_2 - y_0,
+                     x_0, y_0);
+
+  cairo_pattern_get_matrix (pattern, &pattern_matrix);
+  cairo_matrix_multiply (matrix, &device_to_user, &pattern_matrix);
+}
+
+static CoglTexture *
+create_ramp_texture (cairo_pattern_t *gradient)
+{
+  cairo_surface_t *surface;
+  cairo_pattern_t *ramp;
+  CoglTexture *texture;
+  cairo_t *cr;
+  int i, n_stops;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, RAMP_SIZE, 1);
+  ramp = cairo_pattern_create_linear (0.5, 0, RAMP_SIZE - 0.5, 0);
+
+  cairo_pattern_get_color_stop_count (gradient, &n_stops);
+  for (i = 0; i < n_stops; i++)
+    {
+      double offset, red, green, blue, alpha;
+
+      cairo_pattern_get_color_stop_rgba (gradient, i,
+                                         &offset,
+                                         &red, &green, &blue, &alpha);
+      cairo_pattern_add_color_stop_rgba (ramp, offset, red, green, blue, alpha);
+    }
+
+  cairo_pattern_set_extend (ramp, CAIRO_EXTEND_PAD);
+
+  cr = cairo_create (surface);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source (cr, ramp);
+  cairo_paint (cr);
+  cairo_destroy (cr);
+  cairo_pattern_destroy (ramp);
+
+  cairo_surface_flush (surface);
+
+  texture = cogl_texture_new_from_data (RAMP_SIZE, 1,
+                                        COGL_TEXTURE_NO_SLICING |
+                                        COGL_TEXTURE_NO_ATLAS,
+                                        CLUTTER_CAIRO_FORMAT_ARGB32,
+                                        COGL_PIXEL_FORMAT_ANY,
+                                        cairo_image_surface_get_stride (surface),
+                                        cairo_image_surface_get_data (surface));
+
+  cairo_surface_destroy (surface);
+
+  return texture;
+}
+
+static CoglPipeline *
+get_gradient_template (GradientKind   kind,
+                       cairo_extend_t extend)
+{
+  static CoglPipeline *templates[N_GRADIENT_KINDS][G_N_ELEMENTS (extend_sources)];
+
+  if (G_UNLIKELY (templates[kind][extend] == NULL))
+    {
+      CoglPipeline *pipeline;
+      CoglSnippet *snippet;
+      char *source;
+
+      pipeline = cogl_pipeline_new (get_cogl_context ());
+
+      cogl_pipeline_set_layer_null_texture (pipeline, 0, COGL_TEXTURE_TYPE_2D);
+      cogl_pipeline_set_layer_wrap_mode (pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+      cogl_pipeline_set_layer_filters (pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+
+      /* the paths are in device space, which is where the gradients
+       * are evaluated
+       */
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_VERTEX,
+                                  "varying vec2 clutter_gradient_pos;\n",
+                                  "  clutter_gradient_pos = cogl_position_in.xy;\n");
+      cogl_pipeline_add_snippet (pipeline, snippet);
+      cogl_object_unref (snippet);
+
+      source = g_strconcat (gradient_sources[kind],
+                            extend_sources[extend],
+                            ramp_lookup_source,
+                            NULL);
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_FRAGMENT,
+                                  gradient_declarations[kind],
+                                  source);
+      cogl_pipeline_add_snippet (pipeline, snippet);
+      cogl_object_unref (snippet);
+      g_free (source);
+
+      templates[kind][extend] = pipeline;
+    }
+
+  return templates[kind][extend];
+}
+
+static void
+set_uniform_vec3 (CoglPipeline *pipeline,
+                  const char   *name,
+                  float         x,
+                  float         y,
+                  float         z)
+{
+  float value[3] = { x, y, z };
+
+  cogl_pipeline_set_uniform_float (pipeline,
+                                   cogl_pipeline_get_uniform_location (pipeline, name),
+                                   3, 1,
+                                   value);
+}
+
+static CoglPipeline *
+recorder_create_gradient_pipeline (ClutterVectorRecorder *recorder,
+                                   cairo_pattern_t       *gradient)
+{
+  cairo_extend_t extend = cairo_pattern_get_extend (gradient);
+  CoglPipeline *pipeline;
+  CoglTexture *ramp;
+  cairo_matrix_t m;
+
+  if (extend >= G_N_ELEMENTS (extend_sources))
+    return NULL;
+
+  recorder_get_pattern_matrix (recorder, gradient, &m);
+
+  if (cairo_pattern_get_type (gradient) == CAIRO_PATTERN_TYPE_LINEAR)
+    {
+      double x_0, y_0, x_1, y_1, dx, dy, dd;
+
+      cairo_pattern_get_linear_points (gradient, &x_0, &y_0, &x_1, &y_1);
+
+      dx = x_1 - x_0;
+      dy = y_1 - y_0;
+      dd = dx * dx + dy * dy;
+      if (dd == 0)
+        return NULL;
+
+      pipeline = cogl_pipeline_copy (get_gradient_template (GRADIENT_LINEAR, extend));
+
+      /* t is the projection on the line of the gradient, which is an
+       * affine function of the position in device space
+       */
+      set_uniform_vec3 (pipeline, "clutter_gradient_line",
+                        (m.xx * dx + m.yx * dy) / dd,
+                        (m.xy * dx + m.yy * dy) / dd,
+                        ((m.x0 - x_0) * dx + (m.y0 - y_0) * dy) / dd);
+    }
+  else
+    {
+      double cx_0, cy_0, r_0, cx_1, cy_1, r_1;
+
+      cairo_pattern_get_radial_circles (gradient,
+                                        &cx_0, &cy_0, &r_0,
+                                        &cx_1, &cy_1, &r_1);
+
+      pipeline = cogl_pipeline_copy (get_gradient_template (GRADIENT_RADIAL, extend));
+
+      set_uniform_vec3 (pipeline, "clutter_gradient_row_x", m.xx, m.xy, m.x0);
+      set_uniform_vec3 (pipeline, "clutter_gradient_row_y", m.yx, m.yy, m.y0);
+      set_uniform_vec3 (pipeline, "clutter_gradient_c0", cx_0, cy_0, r_0);
+      set_uniform_vec3 (pipeline, "clutter_gradient_dc",
+                        cx_1 - cx_0, cy_1 - cy_0, r_1 - r_0);
+    }
+
+  ramp = create_ramp_texture (gradient);
+  if (ramp == NULL)
+    {
+      cogl_object_unref (pipeline);
+      return NULL;
+    }
+
+  cogl_pipeline_set_layer_texture (pipeline, 0, ramp);
+  cogl_object_unref (ramp);
+
+  return pipeline;
+}
+
+/* creates the pipeline drawing with the source of the context, if it
+ * is a color or a gradient
+ */
+static CoglPipeline *
+recorder_create_pipeline (ClutterVectorRecorder *recorder)
+{
+  cairo_pattern_t *source = cairo_get_source (recorder->cr);
+  CoglPipeline *pipeline;
+  double red, green, blue, alpha;
+
+  switch (cairo_pattern_get_type (source))
+    {
+    case CAIRO_PATTERN_TYPE_SOLID:
+      cairo_pattern_get_rgba (source, &red, &green, &blue, &alpha);
+
+      pipeline = cogl_pipeline_new (get_cogl_context ());
+      cogl_pipeline_set_color4f (pipeline,
+                                 red * alpha,
+                                 green * alpha,
+                                 blue * alpha,
+                                 alpha);
+      return pipeline;
+
+    case CAIRO_PATTERN_TYPE_LINEAR:
+    case CAIRO_PATTERN_TYPE_RADIAL:
+      return recorder_create_gradient_pipeline (recorder, source);
+
+    default:
+      return NULL;
+    }
+}
+
+/* adds the command filling @path, which is consumed, with the source
+ * and the clip of the context
+ */
+static void
+recorder_add_command (ClutterVectorRecorder *recorder,
+                      CoglPath              *path,
+                      const char            *what)
+{
+  VectorCommand command;
+
+  if (path == NULL)
+    {
+      recorder_set_fallback (recorder, what);
+      return;
+    }
+
+  if (!recorder_get_clip (recorder, &command.clip))
+    {
+      cogl_object_unref (path);
+      recorder_set_fallback (recorder, "clip");
+      return;
+    }
+
+  if (command.clip.width == 0 || command.clip.height == 0)
+    {
+      cogl_object_unref (path);
+      return;
+    }
+
+  command.pipeline = recorder_create_pipeline (recorder);
+  if (command.pipeline == NULL)
+    {
+      cogl_object_unref (path);
+      recorder_set_fallback (recorder, "source");
+      return;
+    }
+
+  command.path = path;
+  command.has_clip = command.clip.x != 0 ||
+                     command.clip.y != 0 ||
+                     command.clip.width != recorder->width ||
+                     command.clip.height != recorder->height;
+
+  g_array_append_val (recorder->commands, command);
+}
+
+/* copies the path of the context, flattened, in device space */
+static CoglPath *
+recorder_copy_fill_path (ClutterVectorRecorder *recorder)
+{
+  cairo_path_t *path;
+  CoglPath *res;
+  int i;
+
+  path = cairo_copy_path_flat (recorder->cr);
+  if (path->status != CAIRO_STATUS_SUCCESS)
+    {
+      cairo_path_destroy (path);
+      return NULL;
+    }
+
+  res = cogl_path_new ();
+
+  for (i = 0; i < path->num_data; i += path->data[i].header.length)
+    {
+      const cairo_path_data_t *data = &path->data[i];
+      double x, y;
+
+      switch (data->header.type)
+        {
+        case CAIRO_PATH_MOVE_TO:
+        case CAIRO_PATH_LINE_TO:
+          x = data[1].point.x;
+          y = data[1].point.y;
+          cairo_user_to_device (recorder->cr, &x, &y);
+
+          if (data->header.type == CAIRO_PATH_MOVE_TO)
+            cogl_path_move_to (res, x, y);
+          else
+            cogl_path_line_to (res, x, y);
+          break;
+
+        case CAIRO_PATH_CLOSE_PATH:
+          cogl_path_close (res);
+          break;
+
+        case CAIRO_PATH_CURVE_TO:
+          /* flattened paths have no curves */
+          break;
+        }
+    }
+
+  cairo_path_destroy (path);
+
+  if (cairo_get_fill_rule (recorder->cr) == CAIRO_FILL_RULE_EVEN_ODD)
+    cogl_path_set_fill_rule (res, COGL_PATH_FILL_RULE_EVEN_ODD);
+  else
+    cogl_path_set_fill_rule (res, COGL_PATH_FILL_RULE_NON_ZERO);
+
+  return res;
+}
+
+/* adds the polygon to @path, always with the same orientation, so that
+ * the overlapping polygons are only filled once with the non-zero rule
+ */
+static void
+stroker_add_polygon (CoglPath          *path,
+                     const VectorPoint *points,
+                     int                n_points)
+{
+  float area = 0.f;
+  int i;
+
+  for (i = 0; i < n_points; i++)
+    {
+      const VectorPoint *a = &points[i];
+      const VectorPoint *b = &points[(i + 1) % n_points];
+
+      area += a->x * b->y - b->x * a->y;
+    }
+
+  if (fabsf (area) < 1e-6f)
+    return;
+
+  if (area > 0)
+    {
+      cogl_path_move_to (path, points[0].x, points[0].y);
+      for (i = 1; i < n_points; i++)
+        cogl_path_line_to (path, points[i].x, points[i].y);
+    }
+  else
+    {
+      cogl_path_move_to (path, points[n_points - 1].x, points[n_points - 1].y);
+      for (i = n_points - 2; i >= 0; i--)
+        cogl_path_line_to (path, points[i].x, points[i].y);
+    }
+
+  cogl_path_close (path);
+}
+
+static void
+stroker_add_circle (CoglPath          *path,
+                    const VectorPoint *center,
+                    float              radius)
+{
+  VectorPoint points[MAX_CIRCLE_SEGMENTS];
+  int i, n_segments;
+
+  n_segments = CLAMP ((int) ceilf (radius * 2.f), 8, MAX_CIRCLE_SEGMENTS);
+
+  for (i = 0; i < n_segments; i++)
+    {
+      float angle = 2.f * G_PI * i / n_segments;
+
+      points[i].x = center->x + radius * cosf (angle);
+      points[i].y = center->y + radius * sinf (angle);
+    }
+
+  stroker_add_polygon (path, points, n_segments);
+}
+
+/* the normal of @d scaled to @half_width */
+static gboolean
+stroker_get_normal (float        dx,
+                    float        dy,
+                    float        half_width,
+                    VectorPoint *normal)
+{
+  float length = sqrtf (dx * dx + dy * dy);
+
+  if (length < 1e-6f)
+    return FALSE;
+
+  normal->x = -dy / length * half_width;
+  normal->y = dx / length * half_width;
+
+  return TRUE;
+}
+
+static void
+stroker_add_segment (CoglPath          *path,
+                     const VectorPoint *a,
+                     const VectorPoint *b,
+                     float              half_width)
+{
+  VectorPoint quad[4], n;
+
+  if (!stroker_get_normal (b->x - a->x, b->y - a->y, half_width, &n))
+    return;
+
+  quad[0].x = a->x + n.x; quad[0].y = a->y + n.y;
+  quad[1].x = b->x + n.x; quad[1].y = b->y + n.y;
+  quad[2].x = b->x - n.x; quad[2].y = b->y - n.y;
+  quad[3].x = a->x - n.x; quad[3].y = a->y - n.y;
+
+  stroker_add_polygon (path, quad, 4);
+}
+
+/* adds the join at @p between the segments going along @d_0 and @d_1 */
+static void
+stroker_add_join (CoglPath          *path,
+                  const VectorPoint *p,
+                  const VectorPoint *d_0,
+                  const VectorPoint *d_1,
+                  float              half_width,
+                  cairo_line_join_t  join,
+                  float              miter_limit)
+{
+  VectorPoint n_0, n_1, polygon[4];
+  float cross, side, dot;
+
+  if (!stroker_get_normal (d_0->x, d_0->y, half_width, &n_0) ||
+      !stroker_get_normal (d_1->x, d_1->y, half_width, &n_1))
+    return;
+
+  if (join == CAIRO_LINE_JOIN_ROUND)
+    {
+      stroker_add_circle (path, p, half_width);
+      return;
+    }
+
+  /* the outer side of the turn */
+  cross = d_0->x * d_1->y - d_0->y * d_1->x;
+  side = cross > 0 ? -1.f : 1.f;
+
+  polygon[0] = *p;
+  polygon[1].x = p->x + side * n_0.x;
+  polygon[1].y = p->y + side * n_0.y;
+
+  dot = (n_0.x * n_1.x + n_0.y * n_1.y) / (half_width * half_width);
+
+  if (join == CAIRO_LINE_JOIN_MITER && 1.f + dot > 1e-6f)
+    {
+      float sum_x = n_0.x + n_1.x, sum_y = n_0.y + n_1.y;
+      float ratio = sqrtf (sum_x * sum_x + sum_y * sum_y) / half_width / (1.f + dot);
+
+      if (ratio <= miter_limit)
+        {
+          polygon[2].x = p->x + side * sum_x / (1.f + dot);
+          polygon[2].y = p->y + side * sum_y / (1.f + dot);
+          polygon[3].x = p->x + side * n_1.x;
+          polygon[3].y = p->y + side * n_1.y;
+
+          stroker_add_polygon (path, polygon, 4);
+          return;
+        }
+    }
+
+  /* bevel */
+  polygon[2].x = p->x + side * n_1.x;
+  polygon[2].y = p->y + side * n_1.y;
+
+  stroker_add_polygon (path, polygon, 3);
+}
+
+/* adds the cap at the end @p of a segment going along @d */
+static void
+stroker_add_cap (CoglPath          *path,
+                 const VectorPoint *p,
+                 const VectorPoint *d,
+                 float              half_width,
+                 cairo_line_cap_t   cap)
+{
+  VectorPoint n, quad[4];
+
+  switch (cap)
+    {
+    case CAIRO_LINE_CAP_BUTT:
+      break;
+
+    case CAIRO_LINE_CAP_ROUND:
+      stroker_add_circle (path, p, half_width);
+      break;
+
+    case CAIRO_LINE_CAP_SQUARE:
+      if (!stroker_get_normal (d->x, d->y, half_width, &n))
+        break;
+
+      /* the normal of the normal, pointing along @d */
+      quad[0].x = p->x + n.x;
+      quad[0].y = p->y + n.y;
+      quad[1].x = p->x + n.x + n.y;
+      quad[1].y = p->y + n.y - n.x;
+      quad[2].x = p->x - n.x + n.y;
+      quad[2].y = p->y - n.y - n.x;
+      quad[3].x = p->x - n.x;
+      quad[3].y = p->y - n.y;
+
+      stroker_add_polygon (path, quad, 4);
+      break;
+    }
+}
+
+static void
+stroker_add_subpath (ClutterVectorRecorder *recorder,
+                     CoglPath              *path,
+                     GArray                *points,
+                     gboolean               closed,
+                     gboolean               degenerate,
+                     float                  half_width)
+{
+  cairo_line_join_t join = cairo_get_line_join (recorder->cr);
+  cairo_line_cap_t cap = cairo_get_line_cap (recorder->cr);
+  float miter_limit = cairo_get_miter_limit (recorder->cr);
+  const VectorPoint *p = (const VectorPoint *) points->data;
+  VectorPoint d_0, d_1;
+  int i, n_points = points->len;
+
+  if (n_points == 0)
+    return;
+
+  /* a sub-path without length is drawn as its caps */
+  if (n_points == 1)
+    {
+      if (degenerate && cap != CAIRO_LINE_CAP_BUTT)
+        {
+          d_0.x = 1.f;
+          d_0.y = 0.f;
+          stroker_add_cap (path, &p[0], &d_0, half_width, cap);
+          d_0.x = -1.f;
+          stroker_add_cap (path, &p[0], &d_0, half_width, cap);
+        }
+
+      return;
+    }
+
+  if (closed &&
+      p[n_points - 1].x == p[0].x &&
+      p[n_points - 1].y == p[0].y)
+    n_points -= 1;
+
+  for (i = 0; i + 1 < n_points; i++)
+    stroker_add_segment (path, &p[i], &p[i + 1], half_width);
+
+  for (i = 1; i + 1 < n_points; i++)
+    {
+      d_0.x = p[i].x - p[i - 1].x;
+      d_0.y = p[i].y - p[i - 1].y;
+      d_1.x = p[i + 1].x - p[i].x;
+      d_1.y = p[i + 1].y - p[i].y;
+
+      stroker_add_join (path, &p[i], &d_0, &d_1, half_width, join, miter_limit);
+    }
+
+  if (closed && n_points > 1)
+    {
+      stroker_add_segment (path, &p[n_points - 1], &p[0], half_width);
+
+      d_0.x = p[n_points - 1].x - p[n_points - 2].x;
+      d_0.y = p[n_points - 1].y - p[n_points - 2].y;
+      d_1.x = p[0].x - p[n_points - 1].x;
+      d_1.y = p[0].y - p[n_points - 1].y;
+      stroker_add_join (path, &p[n_points - 1], &d_0, &d_1, half_width, join, miter_limit);
+
+      d_0 = d_1;
+      d_1.x = p[1].x - p[0].x;
+      d_1.y = p[1].y - p[0].y;
+      stroker_add_join (path, &p[0], &d_0, &d_1, half_width, join, miter_limit);
+    }
+  else
+    {
+      d_0.x = p[0].x - p[1].x;
+      d_0.y = p[0].y - p[1].y;
+      stroker_add_cap (path, &p[0], &d_0, half_width, cap);
+
+      d_1.x = p[n_points - 1].x - p[n_points - 2].x;
+      d_1.y = p[n_points - 1].y - p[n_points - 2].y;
+      stroker_add_cap (path, &p[n_points - 1], &d_1, half_width, cap);
+    }
+}
+
+/* builds the outline of the stroke of the path of the context, in
+ * device space; dashes and non-uniform scales are not supported
+ */
+static CoglPath *
+recorder_create_stroke_path (ClutterVectorRecorder *recorder)
+{
+  cairo_t *cr = recorder->cr;
+  double line_width = cairo_get_line_width (cr);
+  double ux = line_width, uy = 0, vx = 0, vy = line_width;
+  double u_length, v_length;
+  gboolean closed = FALSE, degenerate = FALSE;
+  cairo_path_t *path;
+  GArray *points;
+  CoglPath *res;
+  float half_width;
+  int i;
+
+  if (cairo_get_dash_count (cr) > 0)
+    return NULL;
+
+  cairo_user_to_device_distance (cr, &ux, &uy);
+  cairo_user_to_device_distance (cr, &vx, &vy);
+
+  u_length = sqrt (ux * ux + uy * uy);
+  v_length = sqrt (vx * vx + vy * vy);
+
+  if (fabs (u_length - v_length) > 0.01 * MAX (u_length, v_length) ||
+      fabs (ux * vx + uy * vy) > 0.01 * u_length * v_length)
+    return NULL;
+
+  half_width = u_length / 2.0;
+
+  path = cairo_copy_path_flat (cr);
+  if (path->status != CAIRO_STATUS_SUCCESS)
+    {
+      cairo_path_destroy (path);
+      return NULL;
+    }
+
+  res = cogl_path_new ();
+  cogl_path_set_fill_rule (res, COGL_PATH_FILL_RULE_NON_ZERO);
+
+  points = g_array_new (FALSE, FALSE, sizeof (VectorPoint));
+
+  for (i = 0; half_width > 0 && i < path->num_data; i += path->data[i].header.length)
+    {
+      const cairo_path_data_t *data = &path->data[i];
+      VectorPoint point;
+      double x, y;
+
+      switch (data->header.type)
+        {
+        case CAIRO_PATH_MOVE_TO:
+          stroker_add_subpath (recorder, res, points, closed, degenerate, half_width);
+          g_array_set_size (points, 0);
+          closed = degenerate = FALSE;
+          /* fall through */
+
+        case CAIRO_PATH_LINE_TO:
+          x = data[1].point.x;
+          y = data[1].point.y;
+          cairo_user_to_device (cr, &x, &y);
+
+          point.x = x;
+          point.y = y;
+
+          if (data->header.type == CAIRO_PATH_LINE_TO)
+            {
+              degenerate = TRUE;
+
+              if (points->len > 0)
+                {
+                  const VectorPoint *last =
+                    &g_array_index (points, VectorPoint, points->len - 1);
+
+                  if (last->x == point.x && last->y == point.y)
+                    break;
+                }
+            }
+
+          g_array_append_val (points, point);
+          break;
+
+        case CAIRO_PATH_CLOSE_PATH:
+          closed = degenerate = TRUE;
+          stroker_add_subpath (recorder, res, points, closed, degenerate, half_width);
+          g_array_set_size (points, 0);
+          closed = degenerate = FALSE;
+          break;
+
+        case CAIRO_PATH_CURVE_TO:
+          break;
+        }
+    }
+
+  if (half_width > 0)
+    stroker_add_subpath (recorder, res, points, closed, degenerate, half_width);
+
+  g_array_free (points, TRUE);
+  cairo_path_destroy (path);
+
+  return res;
+}
+
+static void
+recorder_fill_cb (cairo_surface_t *observer,
+                  cairo_surface_t *target,
+                  void            *data)
+{
+  ClutterVectorRecorder *recorder = data;
+
+  if (recorder->cr == NULL || recorder->fallback)
+    return;
+
+  if (cairo_get_operator (recorder->cr) != CAIRO_OPERATOR_OVER)
+    {
+      recorder_set_fallback (recorder, "operator");
+      return;
+    }
+
+  recorder_add_command (recorder, recorder_copy_fill_path (recorder), "fill");
+}
+
+static void
+recorder_stroke_cb (cairo_surface_t *observer,
+                    cairo_surface_t *target,
+                    void            *data)
+{
+  ClutterVectorRecorder *recorder = data;
+
+  if (recorder->cr == NULL || recorder->fallback)
+    return;
+
+  if (cairo_get_operator (recorder->cr) != CAIRO_OPERATOR_OVER)
+    {
+      recorder_set_fallback (recorder, "operator");
+      return;
+    }
+
+  recorder_add_command (recorder, recorder_create_stroke_path (recorder), "stroke");
+}
+
+static void
+recorder_paint_cb (cairo_surface_t *observer,
+                   cairo_surface_t *target,
+                   void            *data)
+{
+  ClutterVectorRecorder *recorder = data;
+  cairo_operator_t op;
+  CoglPath *path;
+
+  if (recorder->cr == NULL || recorder->fallback)
+    return;
+
+  op = cairo_get_operator (recorder->cr);
+
+  /* clearing, or replacing, the whole drawing drops what was drawn */
+  if (op == CAIRO_OPERATOR_CLEAR || op == CAIRO_OPERATOR_SOURCE)
+    {
+      cairo_rectangle_int_t clip;
+
+      if (!recorder_get_clip (recorder, &clip) ||
+          clip.x != 0 || clip.y != 0 ||
+          clip.width != recorder->width ||
+          clip.height != recorder->height)
+        {
+          recorder_set_fallback (recorder, "operator");
+          return;
+        }
+
+      g_array_set_size (recorder->commands, 0);
+
+      if (op == CAIRO_OPERATOR_CLEAR)
+        return;
+    }
+  else if (op != CAIRO_OPERATOR_OVER)
+    {
+      recorder_set_fallback (recorder, "operator");
+      return;
+    }
+
+  path = cogl_path_new ();
+  cogl_path_rectangle (path, 0, 0, recorder->width, recorder->height);
+
+  recorder_add_command (recorder, path, "paint");
+}
+
+static void
+recorder_unsupported_cb (cairo_surface_t *observer,
+                         cairo_surface_t *target,
+                         void            *data)
+{
+  ClutterVectorRecorder *recorder = data;
+
+  if (recorder->cr == NULL)
+    return;
+
+  recorder_set_fallback (recorder, "mask or glyphs");
+}
+
+/*< private >
+ * _clutter_vector_recorder_new:
+ * @width: the width of the drawing, in device pixels
+ * @height: the height of the drawing, in device pixels
+ * @scale: the scale of the device pixels
+ *
+ * Creates a recorder for a drawing of the given size.
+ *
+ * Return value: the new recorder
+ */
+ClutterVectorRecorder *
+_clutter_vector_recorder_new (int width,
+                              int height,
+                              int scale)
+{
+  ClutterVectorRecorder *recorder = g_slice_new0 (ClutterVectorRecorder);
+  cairo_rectangle_t extents = { 0, 0, width, height };
+
+  recorder->width = width;
+  recorder->height = height;
+
+  recorder->commands = g_array_new (FALSE, FALSE, sizeof (VectorCommand));
+  g_array_set_clear_func (recorder->commands, vector_command_clear);
+
+  recorder->recording = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA,
+                                                        &extents);
+  recorder->observer = cairo_surface_create_observer (recorder->recording,
+                                                      CAIRO_SURFACE_OBSERVER_NORMAL);
+  cairo_surface_set_device_scale (recorder->observer, scale, scale);
+
+  cairo_surface_observer_add_fill_callback (recorder->observer,
+                                            recorder_fill_cb,
+                                            recorder);
+  cairo_surface_observer_add_stroke_callback (recorder->observer,
+                                              recorder_stroke_cb,
+                                              recorder);
+  cairo_surface_observer_add_paint_callback (recorder->observer,
+                                             recorder_paint_cb,
+                                             recorder);
+  cairo_surface_observer_add_mask_callback (recorder->observer,
+                                            recorder_unsupported_cb,
+                                            recorder);
+  cairo_surface_observer_add_glyphs_callback (recorder->observer,
+                                              recorder_unsupported_cb,
+                                              recorder);
+
+  return recorder;
+}
+
+/*< private >
+ * _clutter_vector_recorder_free:
+ * @recorder: a #ClutterVectorRecorder
+ *
+ * Frees @recorder and its commands.
+ */
+void
+_clutter_vector_recorder_free (ClutterVectorRecorder *recorder)
+{
+  if (recorder == NULL)
+    return;
+
+  g_clear_pointer (&recorder->observer, cairo_surface_destroy);
+  g_clear_pointer (&recorder->recording, cairo_surface_destroy);
+  g_array_free (recorder->commands, TRUE);
+
+  g_slice_free (ClutterVectorRecorder, recorder);
+}
+
+/*< private >
+ * _clutter_vector_recorder_create_context:
+ * @recorder: a #ClutterVectorRecorder
+ *
+ * Creates the context the drawing is recorded from; the context must
+ * be destroyed before calling _clutter_vector_recorder_finish().
+ *
+ * Return value: (transfer full): a Cairo context
+ */
+cairo_t *
+_clutter_vector_recorder_create_context (ClutterVectorRecorder *recorder)
+{
+  g_assert (recorder->cr == NULL);
+
+  recorder->cr = cairo_create (recorder->observer);
+
+  return recorder->cr;
+}
+
+/*< private >
+ * _clutter_vector_recorder_finish:
+ * @recorder: a #ClutterVectorRecorder
+ *
+ * Stops recording; the recording surface is only kept if the drawing
+ * needs to fall back to the image backend.
+ */
+void
+_clutter_vector_recorder_finish (ClutterVectorRecorder *recorder)
+{
+  recorder->cr = NULL;
+
+  g_clear_pointer (&recorder->observer, cairo_surface_destroy);
+
+  if (!recorder->fallback)
+    g_clear_pointer (&recorder->recording, cairo_surface_destroy);
+
+  CLUTTER_NOTE (MISC, "Recorded %u vector commands%s",
+                recorder->commands->len,
+                recorder->fallback ? " (falling back)" : "");
+}
+
+/*< private >
+ * _clutter_vector_recorder_needs_fallback:
+ * @recorder: a #ClutterVectorRecorder
+ *
+ * Checks whether the drawing used operations that cannot be drawn
+ * on the GPU, in which case it must be replayed on the CPU from
+ * _clutter_vector_recorder_get_recording().
+ *
+ * Return value: %TRUE if the drawing must fall back to the image backend
+ */
+gboolean
+_clutter_vector_recorder_needs_fallback (ClutterVectorRecorder *recorder)
+{
+  return recorder->fallback;
+}
+
+/*< private >
+ * _clutter_vector_recorder_get_recording:
+ * @recorder: a #ClutterVectorRecorder
+ *
+ * Retrieves the recording of the drawing, in device pixels.
+ *
+ * Return value: (transfer none): the recording surface, or %NULL if
+ *   the drawing does not need to fall back
+ */
+cairo_surface_t *
+_clutter_vector_recorder_get_recording (ClutterVectorRecorder *recorder)
+{
+  return recorder->recording;
+}
+
+/*< private >
+ * _clutter_vector_recorder_get_size:
+ * @recorder: a #ClutterVectorRecorder
+ * @width: (out): the width of the drawing, in device pixels
+ * @height: (out): the height of the drawing, in device pixels
+ *
+ * Retrieves the size of the drawing.
+ */
+void
+_clutter_vector_recorder_get_size (ClutterVectorRecorder *recorder,
+                                   int                   *width,
+                                   int                   *height)
+{
+  *width = recorder->width;
+  *height = recorder->height;
+}
+
+/*< private >
+ * _clutter_vector_recorder_render:
+ * @recorder: a #ClutterVectorRecorder
+ * @framebuffer: the framebuffer to draw to
+ *
+ * Draws the recorded commands to @framebuffer, whose projection must
+ * map the device pixels of the drawing to its own pixels.
+ */
+void
+_clutter_vector_recorder_render (ClutterVectorRecorder *recorder,
+                                 CoglFramebuffer       *framebuffer)
+{
+  guint i;
+
+  for (i = 0; i < recorder->commands->len; i++)
+    {
+      const VectorCommand *command =
+        &g_array_index (recorder->commands, VectorCommand, i);
+
+      if (command->has_clip)
+        cogl_framebuffer_push_scissor_clip (framebuffer,
+                                            command->clip.x,
+                                            command->clip.y,
+                                            command->clip.width,
+                                            command->clip.height);
+
+      cogl_framebuffer_fill_path (framebuffer, command->pipeline, command->path);
+
+      if (command->has_clip)
+        cogl_framebuffer_pop_clip (framebuffer);
+    }
+}
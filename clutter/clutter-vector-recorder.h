@@ -0,0 +1,52 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_VECTOR_RECORDER_H__
+#define __CLUTTER_VECTOR_RECORDER_H__
+
+#include <cairo.h>
+#include <cogl/cogl.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterVectorRecorder   ClutterVectorRecorder;
+
+ClutterVectorRecorder * _clutter_vector_recorder_new            (int                     width,
+                                                                 int                     height,
+                                                                 int                     scale);
+void                    _clutter_vector_recorder_free           (ClutterVectorRecorder  *recorder);
+
+cairo_t *               _clutter_vector_recorder_create_context (ClutterVectorRecorder  *recorder);
+void                    _clutter_vector_recorder_finish         (ClutterVectorRecorder  *recorder);
+
+gboolean                _clutter_vector_recorder_needs_fallback (ClutterVectorRecorder  *recorder);
+cairo_surface_t *       _clutter_vector_recorder_get_recording  (ClutterVectorRecorder  *recorder);
+
+void                    _clutter_vector_recorder_get_size       (ClutterVectorRecorder  *recorder,
+                                                                 int                    *width,
+                                                                 int                    *height);
+void                    _clutter_vector_recorder_render         (ClutterVectorRecorder  *recorder,
+                                                                 CoglFramebuffer        *framebuffer);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_VECTOR_RECORDER_H__ */
@@ -0,0 +1,359 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ * ClutterVertexKernel: SIMD implementations of the vertex transforms.
+ *
+ * Every actor transforms the four or eight vertices of its paint volume
+ * a few times per frame, for culling, clipping the redraws and picking.
+ * The kernels transform one vertex per iteration, keeping the columns of
+ * the matrix in vector registers; the projection multiplies by 1/w and
+ * maps to the viewport with a single multiply-add on the x and y
+ * coordinates.
+ *
+ * The SSE and NEON kernels are compiled in when the compiler supports
+ * them, and are only used if the CPU supports them as well; the scalar
+ * kernel is the reference implementation.
+ *
+ * This file does not depend on the rest of Clutter, so that it can be
+ * built into the micro-benchmarks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-vertex-kernels.h"
+
+#if defined (__SSE__) || defined (__x86_64__)
+# define CLUTTER_HAVE_SSE_KERNEL        1
+# define SSE_TARGET
+#elif defined (__i386__) && (G_GNUC_CHECK_VERSION (4, 9) || defined (__clang__))
+/* sse is not part of the baseline, so the kernel is built for it on its
+ * own, and only used if the CPU supports it
+ */
+# define CLUTTER_HAVE_SSE_KERNEL        1
+# define CLUTTER_CHECK_SSE              1
+# define SSE_TARGET                     __attribute__ ((target ("sse")))
+#endif
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+# define CLUTTER_HAVE_NEON_KERNEL       1
+# if defined (__arm__) && defined (__linux__)
+/* 32 bit ARM CPUs are not required to implement NEON */
+#  define CLUTTER_CHECK_NEON            1
+# endif
+#endif
+
+#ifdef CLUTTER_HAVE_SSE_KERNEL
+#include <xmmintrin.h>
+#endif
+
+#ifdef CLUTTER_HAVE_NEON_KERNEL
+#include <arm_neon.h>
+#endif
+
+#ifdef CLUTTER_CHECK_NEON
+#include <sys/auxv.h>
+#ifndef HWCAP_NEON
+#define HWCAP_NEON      (1 << 12)
+#endif
+#endif
+
+/* the matrices follow the layout of CoglMatrix, i.e. column-major */
+#define M(m,row,col)    ((m)[(col) * 4 + (row)])
+
+static void
+transform_scalar (const float         *m,
+                  const ClutterVertex *vertices_in,
+                  ClutterVertex       *vertices_out,
+                  int                  n_vertices)
+{
+  int i;
+
+  for (i = 0; i < n_vertices; i++)
+    {
+      float x = vertices_in[i].x;
+      float y = vertices_in[i].y;
+      float z = vertices_in[i].z;
+
+      vertices_out[i].x = M (m, 0, 0) * x + M (m, 0, 1) * y + M (m, 0, 2) * z + M (m, 0, 3);
+      vertices_out[i].y = M (m, 1, 0) * x + M (m, 1, 1) * y + M (m, 1, 2) * z + M (m, 1, 3);
+      vertices_out[i].z = M (m, 2, 0) * x + M (m, 2, 1) * y + M (m, 2, 2) * z + M (m, 2, 3);
+    }
+}
+
+static void
+project_scalar (const float         *m,
+                const float         *viewport,
+                const ClutterVertex *vertices_in,
+                ClutterVertex       *vertices_out,
+                int                  n_vertices)
+{
+  int i;
+
+  for (i = 0; i < n_vertices; i++)
+    {
+      float x = vertices_in[i].x;
+      float y = vertices_in[i].y;
+      float z = vertices_in[i].z;
+      float px, py, pw;
+
+      px = M (m, 0, 0) * x + M (m, 0, 1) * y + M (m, 0, 2) * z + M (m, 0, 3);
+      py = M (m, 1, 0) * x + M (m, 1, 1) * y + M (m, 1, 2) * z + M (m, 1, 3);
+      pw = M (m, 3, 0) * x + M (m, 3, 1) * y + M (m, 3, 2) * z + M (m, 3, 3);
+
+      /* from normalized device coordinates to window coordinates,
+       * with the origin at the top left corner
+       */
+      vertices_out[i].x = ((((px / pw) + 1.0f) / 2.0f) * viewport[2]) + viewport[0];
+      vertices_out[i].y = viewport[3] - ((((py / pw) + 1.0f) / 2.0f) * viewport[3]) + viewport[1];
+    }
+}
+
+static const ClutterVertexKernel scalar_kernel = {
+  "scalar",
+  transform_scalar,
+  project_scalar,
+};
+
+#ifdef CLUTTER_HAVE_SSE_KERNEL
+SSE_TARGET static void
+transform_sse (const float         *m,
+               const ClutterVertex *vertices_in,
+               ClutterVertex       *vertices_out,
+               int                  n_vertices)
+{
+  __m128 c0 = _mm_loadu_ps (m + 0);
+  __m128 c1 = _mm_loadu_ps (m + 4);
+  __m128 c2 = _mm_loadu_ps (m + 8);
+  __m128 c3 = _mm_loadu_ps (m + 12);
+  int i;
+
+  for (i = 0; i < n_vertices; i++)
+    {
+      __m128 r;
+
+      r = _mm_add_ps (_mm_add_ps (_mm_mul_ps (c0, _mm_set1_ps (vertices_in[i].x)),
+                                  _mm_mul_ps (c1, _mm_set1_ps (vertices_in[i].y))),
+                      _mm_add_ps (_mm_mul_ps (c2, _mm_set1_ps (vertices_in[i].z)),
+                                  c3));
+
+      /* storing four floats would overwrite the next vertex, which
+       * might not be read yet
+       */
+      _mm_storel_pi ((__m64 *) &vertices_out[i].x, r);
+      _mm_store_ss (&vertices_out[i].z, _mm_movehl_ps (r, r));
+    }
+}
+
+SSE_TARGET static void
+project_sse (const float         *m,
+             const float         *viewport,
+             const ClutterVertex *vertices_in,
+             ClutterVertex       *vertices_out,
+             int                  n_vertices)
+{
+  __m128 c0 = _mm_loadu_ps (m + 0);
+  __m128 c1 = _mm_loadu_ps (m + 4);
+  __m128 c2 = _mm_loadu_ps (m + 8);
+  __m128 c3 = _mm_loadu_ps (m + 12);
+  __m128 scale, offset;
+  int i;
+
+  /* x' = x / w * (width / 2) + (width / 2 + x0), and the same for y,
+   * flipped
+   */
+  scale = _mm_setr_ps (viewport[2] * 0.5f, viewport[3] * -0.5f, 0.f, 0.f);
+  offset = _mm_setr_ps (viewport[2] * 0.5f + viewport[0],
+                        viewport[3] * 0.5f + viewport[1],
+                        0.f, 0.f);
+
+  for (i = 0; i < n_vertices; i++)
+    {
+      __m128 r, w;
+
+      r = _mm_add_ps (_mm_add_ps (_mm_mul_ps (c0, _mm_set1_ps (vertices_in[i].x)),
+                                  _mm_mul_ps (c1, _mm_set1_ps (vertices_in[i].y))),
+                      _mm_add_ps (_mm_mul_ps (c2, _mm_set1_ps (vertices_in[i].z)),
+                                  c3));
+
+      w = _mm_shuffle_ps (r, r, _MM_SHUFFLE (3, 3, 3, 3));
+      r = _mm_add_ps (_mm_mul_ps (_mm_div_ps (r, w), scale), offset);
+
+      _mm_storel_pi ((__m64 *) &vertices_out[i].x, r);
+    }
+}
+
+static const ClutterVertexKernel sse_kernel = {
+  "sse",
+  transform_sse,
+  project_sse,
+};
+#endif /* CLUTTER_HAVE_SSE_KERNEL */
+
+#ifdef CLUTTER_HAVE_NEON_KERNEL
+static void
+transform_neon (const float         *m,
+                const ClutterVertex *vertices_in,
+                ClutterVertex       *vertices_out,
+                int                  n_vertices)
+{
+  float32x4_t c0 = vld1q_f32 (m + 0);
+  float32x4_t c1 = vld1q_f32 (m + 4);
+  float32x4_t c2 = vld1q_f32 (m + 8);
+  float32x4_t c3 = vld1q_f32 (m + 12);
+  int i;
+
+  for (i = 0; i < n_vertices; i++)
+    {
+      float32x4_t r;
+
+      r = vmlaq_n_f32 (c3, c0, vertices_in[i].x);
+      r = vmlaq_n_f32 (r, c1, vertices_in[i].y);
+      r = vmlaq_n_f32 (r, c2, vertices_in[i].z);
+
+      vst1_f32 (&vertices_out[i].x, vget_low_f32 (r));
+      vertices_out[i].z = vgetq_lane_f32 (r, 2);
+    }
+}
+
+static void
+project_neon (const float         *m,
+              const float         *viewport,
+              const ClutterVertex *vertices_in,
+              ClutterVertex       *vertices_out,
+              int                  n_vertices)
+{
+  float32x4_t c0 = vld1q_f32 (m + 0);
+  float32x4_t c1 = vld1q_f32 (m + 4);
+  float32x4_t c2 = vld1q_f32 (m + 8);
+  float32x4_t c3 = vld1q_f32 (m + 12);
+  float32x2_t scale, offset;
+  int i;
+
+  /* see project_sse() */
+  scale = vset_lane_f32 (viewport[3] * -0.5f,
+                         vdup_n_f32 (viewport[2] * 0.5f),
+                         1);
+  offset = vset_lane_f32 (viewport[3] * 0.5f + viewport[1],
+                          vdup_n_f32 (viewport[2] * 0.5f + viewport[0]),
+                          1);
+
+  for (i = 0; i < n_vertices; i++)
+    {
+      float32x4_t r;
+      float32x2_t xy;
+
+      r = vmlaq_n_f32 (c3, c0, vertices_in[i].x);
+      r = vmlaq_n_f32 (r, c1, vertices_in[i].y);
+      r = vmlaq_n_f32 (r, c2, vertices_in[i].z);
+
+      /* 32 bit NEON has no vector division; 1/w is only needed once */
+      xy = vmul_n_f32 (scale, 1.0f / vgetq_lane_f32 (r, 3));
+      xy = vmla_f32 (offset, vget_low_f32 (r), xy);
+
+      vst1_f32 (&vertices_out[i].x, xy);
+    }
+}
+
+static const ClutterVertexKernel neon_kernel = {
+  "neon",
+  transform_neon,
+  project_neon,
+};
+#endif /* CLUTTER_HAVE_NEON_KERNEL */
+
+/* the scalar kernel, followed by the supported ones; the last is the
+ * fastest
+ */
+static const ClutterVertexKernel *supported_kernels[3];
+static guint n_supported_kernels = 0;
+
+static void
+clutter_vertex_kernel_init (void)
+{
+  static gsize initialized = 0;
+
+  if (!g_once_init_enter (&initialized))
+    return;
+
+  supported_kernels[n_supported_kernels++] = &scalar_kernel;
+
+#ifdef CLUTTER_HAVE_SSE_KERNEL
+# ifdef CLUTTER_CHECK_SSE
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("sse"))
+# endif
+    supported_kernels[n_supported_kernels++] = &sse_kernel;
+#endif
+
+#ifdef CLUTTER_HAVE_NEON_KERNEL
+# ifdef CLUTTER_CHECK_NEON
+  if (getauxval (AT_HWCAP) & HWCAP_NEON)
+# endif
+    supported_kernels[n_supported_kernels++] = &neon_kernel;
+#endif
+
+  g_once_init_leave (&initialized, 1);
+}
+
+/*< private >
+ * _clutter_vertex_kernel_get_default:
+ *
+ * Retrieves the fastest vertex kernel supported by the CPU.
+ *
+ * Return value: (transfer none): a #ClutterVertexKernel
+ */
+const ClutterVertexKernel *
+_clutter_vertex_kernel_get_default (void)
+{
+  static const ClutterVertexKernel *default_kernel = NULL;
+
+  if (G_UNLIKELY (default_kernel == NULL))
+    {
+      clutter_vertex_kernel_init ();
+
+      default_kernel = supported_kernels[n_supported_kernels - 1];
+    }
+
+  return default_kernel;
+}
+
+/*< private >
+ * _clutter_vertex_kernel_get_supported:
+ * @n_kernels: (out): return location for the number of kernels
+ *
+ * Retrieves all of the vertex kernels supported by the CPU, starting
+ * with the scalar one.
+ *
+ * Return value: (transfer none) (array length=n_kernels): the kernels
+ */
+const ClutterVertexKernel * const *
+_clutter_vertex_kernel_get_supported (guint *n_kernels)
+{
+  clutter_vertex_kernel_init ();
+
+  *n_kernels = n_supported_kernels;
+
+  return supported_kernels;
+}
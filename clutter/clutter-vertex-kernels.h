@@ -0,0 +1,64 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_VERTEX_KERNELS_H__
+#define __CLUTTER_VERTEX_KERNELS_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterVertexKernel     ClutterVertexKernel;
+
+/*< private >
+ * ClutterVertexKernel:
+ * @name: the name of the kernel
+ * @transform: transforms @n_vertices vertices by the affine part of a
+ *   column-major 4x4 matrix
+ * @project: transforms @n_vertices vertices by a column-major 4x4
+ *   matrix, divides them by their w coordinate and maps them to window
+ *   coordinates inside @viewport; only the x and y coordinates of the
+ *   output vertices are written
+ *
+ * An implementation of the vertex transformations used for the paint
+ * volumes. The input and output vertices can be the same.
+ */
+struct _ClutterVertexKernel
+{
+  const gchar *name;
+
+  void (* transform) (const float         *matrix,
+                      const ClutterVertex *vertices_in,
+                      ClutterVertex       *vertices_out,
+                      int                  n_vertices);
+  void (* project)   (const float         *matrix,
+                      const float         *viewport,
+                      const ClutterVertex *vertices_in,
+                      ClutterVertex       *vertices_out,
+                      int                  n_vertices);
+};
+
+const ClutterVertexKernel *             _clutter_vertex_kernel_get_default      (void);
+const ClutterVertexKernel * const *     _clutter_vertex_kernel_get_supported    (guint *n_kernels);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_VERTEX_KERNELS_H__ */
@@ -71,17 +71,20 @@
 #include "clutter-group.h"
 #include "clutter-image.h"
 #include "clutter-input-device.h"
+#include "clutter-instanced-content.h"
 #include "clutter-interval.h"
 #include "clutter-keyframe-transition.h"
 #include "clutter-keysyms.h"
 #include "clutter-layout-manager.h"
 #include "clutter-layout-meta.h"
+#include "clutter-list-view.h"
 #include "clutter-macros.h"
 #include "clutter-main.h"
 #include "clutter-offscreen-effect.h"
 #include "clutter-page-turn-effect.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-paint-node.h"
+#include "clutter-paint-stream.h"
 #include "clutter-pan-action.h"
 #include "clutter-path-constraint.h"
 #include "clutter-path.h"
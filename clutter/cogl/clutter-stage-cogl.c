@@ -38,6 +38,7 @@
 
 #include "clutter-actor-private.h"
 #include "clutter-backend-private.h"
+#include "clutter-box4-private.h"
 #include "clutter-debug.h"
 #include "clutter-event.h"
 #include "clutter-enum-types.h"
@@ -61,6 +62,22 @@ enum {
   PROP_LAST
 };
 
+static void
+clutter_stage_cogl_clear_scaled_buffer (ClutterStageCogl *stage_cogl)
+{
+  if (stage_cogl->scaled_offscreen != NULL)
+    {
+      cogl_object_unref (stage_cogl->scaled_offscreen);
+      stage_cogl->scaled_offscreen = NULL;
+    }
+
+  if (stage_cogl->scaled_texture != NULL)
+    {
+      cogl_object_unref (stage_cogl->scaled_texture);
+      stage_cogl->scaled_texture = NULL;
+    }
+}
+
 static void
 clutter_stage_cogl_unrealize (ClutterStageWindow *stage_window)
 {
@@ -68,6 +85,9 @@ clutter_stage_cogl_unrealize (ClutterStageWindow *stage_window)
 
   CLUTTER_NOTE (BACKEND, "Unrealizing Cogl stage [%p]", stage_cogl);
 
+  /* a deferred swap has no onscreen left to be pushed to */
+  stage_cogl->has_pending_swap = FALSE;
+
   if (stage_cogl->onscreen != NULL)
     {
       cogl_onscreen_remove_frame_callback (stage_cogl->onscreen,
@@ -78,6 +98,8 @@ clutter_stage_cogl_unrealize (ClutterStageWindow *stage_window)
       stage_cogl->onscreen = NULL;
     }
 
+  clutter_stage_cogl_clear_scaled_buffer (stage_cogl);
+
   stage_cogl->pending_swaps = 0;
 }
 
@@ -103,9 +125,11 @@ frame_cb (CoglOnscreen  *onscreen,
       if (stage_cogl->pending_swaps > 0)
         stage_cogl->pending_swaps--;
     }
-  else if (event == COGL_FRAME_EVENT_COMPLETE)
+  else if (event == COGL_FRAME_EVENT_COMPLETE &&
+           !stage_cogl->external_frame_timings)
     {
       gint64 presentation_time_cogl = cogl_frame_info_get_presentation_time (info);
+      gint64 presentation_time = 0;
 
       if (presentation_time_cogl != 0)
         {
@@ -113,11 +137,16 @@ frame_cb (CoglOnscreen  *onscreen,
           gint64 current_time_cogl = cogl_get_clock_time (context);
           gint64 now = g_get_monotonic_time ();
 
-          stage_cogl->last_presentation_time =
+          presentation_time =
             now + (presentation_time_cogl - current_time_cogl) / 1000;
+          stage_cogl->last_presentation_time = presentation_time;
         }
 
       stage_cogl->refresh_rate = cogl_frame_info_get_refresh_rate (info);
+
+      if (stage_cogl->wrapper != NULL)
+        _clutter_stage_frame_info_presented (stage_cogl->wrapper,
+                                             presentation_time);
     }
 }
 
@@ -174,6 +203,41 @@ clutter_stage_cogl_realize (ClutterStageWindow *stage_window)
   return TRUE;
 }
 
+/* The time added to the predicted cost of a frame when scheduling
+ * adaptive updates, to account for the work done by the master clock
+ * before the redraw and for the jitter of the paint cost, in µs
+ */
+#define ADAPTIVE_SYNC_MARGIN    2000
+
+static void
+clutter_stage_cogl_add_paint_cost (ClutterStageCogl *stage_cogl,
+                                   gint64            paint_cost)
+{
+  unsigned int slot = stage_cogl->paint_cost_index % PAINT_COST_HISTORY_MAX;
+
+  stage_cogl->paint_cost_history[slot] = paint_cost;
+  stage_cogl->paint_cost_index++;
+}
+
+/* Returns the time the next frame is expected to take, in µs, or -1
+ * if no frame has been drawn yet; we use the most expensive of the
+ * recent frames, since painting late costs a whole refresh interval
+ * while painting early only costs some latency
+ */
+static gint64
+clutter_stage_cogl_get_paint_cost (ClutterStageCogl *stage_cogl)
+{
+  unsigned int i, n_frames;
+  gint64 paint_cost = -1;
+
+  n_frames = MIN (stage_cogl->paint_cost_index, PAINT_COST_HISTORY_MAX);
+
+  for (i = 0; i < n_frames; i++)
+    paint_cost = MAX (paint_cost, stage_cogl->paint_cost_history[i]);
+
+  return paint_cost;
+}
+
 static void
 clutter_stage_cogl_schedule_update (ClutterStageWindow *stage_window,
                                     gint                sync_delay)
@@ -188,7 +252,7 @@ clutter_stage_cogl_schedule_update (ClutterStageWindow *stage_window,
 
   now = g_get_monotonic_time ();
 
-  if (sync_delay < 0)
+  if (sync_delay < 0 && sync_delay != CLUTTER_STAGE_WINDOW_SYNC_DELAY_ADAPTIVE)
     {
       stage_cogl->update_time = now;
       return;
@@ -214,10 +278,37 @@ clutter_stage_cogl_schedule_update (ClutterStageWindow *stage_window,
   if (refresh_interval == 0)
     refresh_interval = 16667; /* 1/60th second */
 
-  stage_cogl->update_time = stage_cogl->last_presentation_time + 1000 * sync_delay;
+  if (sync_delay == CLUTTER_STAGE_WINDOW_SYNC_DELAY_ADAPTIVE)
+    {
+      gint64 paint_cost = clutter_stage_cogl_get_paint_cost (stage_cogl);
+
+      /* without any history we cannot predict when to start */
+      if (paint_cost < 0)
+        {
+          stage_cogl->update_time = now;
+          return;
+        }
+
+      /* start the update as late as possible while still leaving
+       * enough time to hit the next presentation; if a frame takes
+       * longer than a refresh interval we cannot do better than
+       * starting right after the previous presentation
+       */
+      paint_cost = MIN (paint_cost + ADAPTIVE_SYNC_MARGIN, refresh_interval);
+
+      stage_cogl->update_time =
+        stage_cogl->last_presentation_time + refresh_interval - paint_cost;
+    }
+  else
+    stage_cogl->update_time = stage_cogl->last_presentation_time + 1000 * sync_delay;
 
   while (stage_cogl->update_time < now)
     stage_cogl->update_time += refresh_interval;
+
+  CLUTTER_NOTE (SCHEDULER, "Scheduled update in %" G_GINT64_FORMAT " us "
+                "(sync delay: %d)",
+                stage_cogl->update_time - now,
+                sync_delay);
 }
 
 static gint64
@@ -239,6 +330,43 @@ clutter_stage_cogl_clear_update_time (ClutterStageWindow *stage_window)
   stage_cogl->update_time = -1;
 }
 
+static gint64
+clutter_stage_cogl_get_next_presentation_time (ClutterStageWindow *stage_window)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+  gint64 now, presentation_time;
+  gint64 refresh_interval;
+  float refresh_rate;
+
+  now = g_get_monotonic_time ();
+
+  refresh_rate = stage_cogl->refresh_rate;
+  if (refresh_rate == 0.0)
+    refresh_rate = 60.0;
+
+  refresh_interval = (gint64) (0.5 + 1000000 / refresh_rate);
+  if (refresh_interval == 0)
+    refresh_interval = 16667; /* 1/60th second */
+
+  /* same as clutter_stage_cogl_schedule_update(), we do not trust
+   * presentation times that are too old to extrapolate from
+   */
+  if (stage_cogl->last_presentation_time == 0 ||
+      stage_cogl->last_presentation_time < now - 150000)
+    return now + refresh_interval;
+
+  presentation_time = stage_cogl->last_presentation_time + refresh_interval;
+
+  /* a frame still waiting for its swap is presented first */
+  if (stage_cogl->pending_swaps)
+    presentation_time += refresh_interval;
+
+  while (presentation_time < now)
+    presentation_time += refresh_interval;
+
+  return presentation_time;
+}
+
 static ClutterActor *
 clutter_stage_cogl_get_wrapper (ClutterStageWindow *stage_window)
 {
@@ -332,6 +460,109 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
     return FALSE;
 }
 
+static inline int
+rectangle_area (const cairo_rectangle_int_t *rect)
+{
+  return rect->width * rect->height;
+}
+
+static inline gboolean
+rectangles_overlap (ClutterBox4i a,
+                    ClutterBox4i b)
+{
+  return !_clutter_box4i_is_empty (_clutter_box4i_intersect (a, b));
+}
+
+/* Adds @rect to @region, merging it with the rectangle that results in
+ * the smallest amount of area that would be redrawn needlessly; the
+ * rectangles are merged if they overlap, since overlapping areas would
+ * be painted more than once, or if the region is full
+ */
+static void
+clutter_stage_cogl_region_add (ClutterStageCoglRegion      *region,
+                               const cairo_rectangle_int_t *rect)
+{
+  cairo_rectangle_int_t new_rect = *rect;
+
+  while (TRUE)
+    {
+      cairo_rectangle_int_t best_union = { 0, };
+      ClutterBox4i new_box = _clutter_box4i_from_rectangle (&new_rect);
+      int best = -1, best_cost = G_MAXINT;
+      int i;
+
+      for (i = 0; i < region->n_rects; i++)
+        {
+          ClutterBox4i box = _clutter_box4i_from_rectangle (&region->rects[i]);
+          cairo_rectangle_int_t tmp;
+          int cost;
+
+          _clutter_box4i_to_rectangle (_clutter_box4i_union (box, new_box), &tmp);
+
+          if (rectangles_overlap (box, new_box))
+            cost = G_MININT;
+          else
+            cost = rectangle_area (&tmp)
+                 - rectangle_area (&region->rects[i])
+                 - rectangle_area (&new_rect);
+
+          if (cost < best_cost)
+            {
+              best = i;
+              best_cost = cost;
+              best_union = tmp;
+            }
+        }
+
+      if (best < 0 ||
+          (best_cost > 0 &&
+           region->n_rects < CLUTTER_STAGE_COGL_MAX_REGION_RECTS))
+        {
+          region->rects[region->n_rects++] = new_rect;
+          return;
+        }
+
+      /* the merged rectangle might now overlap with the others, so
+       * we remove the old one and add the union again
+       */
+      region->rects[best] = region->rects[--region->n_rects];
+      new_rect = best_union;
+    }
+}
+
+/* When the rectangles cover most of their bounding box, painting the
+ * stage once per rectangle costs more than what is saved in fill rate,
+ * so we just use the bounding box
+ */
+static void
+clutter_stage_cogl_region_simplify (ClutterStageCoglRegion *region)
+{
+  cairo_rectangle_int_t bounds;
+  ClutterBox4i box;
+  int area, i;
+
+  if (region->n_rects < 2)
+    return;
+
+  box = _clutter_box4i_from_rectangle (&region->rects[0]);
+  area = rectangle_area (&region->rects[0]);
+
+  for (i = 1; i < region->n_rects; i++)
+    {
+      box = _clutter_box4i_union (box,
+                                  _clutter_box4i_from_rectangle (&region->rects[i]));
+      area += rectangle_area (&region->rects[i]);
+    }
+
+  _clutter_box4i_to_rectangle (box, &bounds);
+
+  if (area >= rectangle_area (&bounds) / 4 * 3)
+    {
+      region->rects[0] = bounds;
+      region->n_rects = 1;
+    }
+}
+
 /* A redraw clip represents (in stage coordinates) the bounding box of
  * something that needs to be redraw. Typically they are added to the
  * StageWindow as a result of clutter_actor_queue_clipped_redraw() by
@@ -341,9 +572,10 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
  * A NULL stage_clip means the whole stage needs to be redrawn.
  *
  * What we do with this information:
- * - we keep track of the bounding box for all redraw clips
- * - when we come to redraw; we scissor the redraw to that box and use
- *   glBlitFramebuffer to present the redraw to the front
+ * - we keep track of the bounding box for all redraw clips, as well
+ *   as of a small set of rectangles covering them
+ * - when we come to redraw; we scissor the redraw to each rectangle
+ *   and use glBlitFramebuffer to present the redraw to the front
  *   buffer.
  */
 static void
@@ -373,12 +605,17 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
   if (!stage_cogl->initialized_redraw_clip)
     {
       stage_cogl->bounding_redraw_clip = *stage_clip;
+
+      stage_cogl->redraw_region.rects[0] = *stage_clip;
+      stage_cogl->redraw_region.n_rects = 1;
     }
   else if (stage_cogl->bounding_redraw_clip.width > 0)
     {
       _clutter_util_rectangle_union (&stage_cogl->bounding_redraw_clip,
                                      stage_clip,
                                      &stage_cogl->bounding_redraw_clip);
+
+      clutter_stage_cogl_region_add (&stage_cogl->redraw_region, stage_clip);
     }
 
   stage_cogl->initialized_redraw_clip = TRUE;
@@ -392,7 +629,7 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
 
   if (stage_cogl->using_clipped_redraw)
     {
-      *stage_clip = stage_cogl->bounding_redraw_clip;
+      *stage_clip = stage_cogl->current_redraw_clip;
 
       return TRUE;
     }
@@ -409,7 +646,213 @@ valid_buffer_age (ClutterStageCogl *stage_cogl, int age)
   return age < MIN (stage_cogl->damage_index, DAMAGE_HISTORY_MAX);
 }
 
+/* Converts @region to the array of rectangles expected by the swap
+ * functions, in framebuffer pixels; returns the number of rectangles
+ */
+static int
+region_to_damage (const ClutterStageCoglRegion *region,
+                  int                           window_scale,
+                  int                          *damage)
+{
+  int i;
+
+  for (i = 0; i < region->n_rects; i++)
+    {
+      damage[i * 4 + 0] = region->rects[i].x * window_scale;
+      damage[i * 4 + 1] = region->rects[i].y * window_scale;
+      damage[i * 4 + 2] = region->rects[i].width * window_scale;
+      damage[i * 4 + 3] = region->rects[i].height * window_scale;
+    }
+
+  return region->n_rects;
+}
+
+static void
+clutter_stage_cogl_swap (ClutterStageCogl *stage_cogl)
+{
+  gint64 swap_start;
+
+  if (!stage_cogl->has_pending_swap)
+    return;
+
+  stage_cogl->has_pending_swap = FALSE;
+
+  swap_start = g_get_monotonic_time ();
+
+  /* XXX: It seems there will be a race here in that the stage
+   * window may be resized before the cogl_onscreen_swap_region
+   * is handled and so we may copy the wrong region. I can't
+   * really see how we can handle this with the current state of X
+   * but at least in this case a full redraw should be queued by
+   * the resize anyway so it should only exhibit temporary
+   * artefacts.
+   */
+  _clutter_stage_frame_info_mark (stage_cogl->wrapper,
+                                  CLUTTER_FRAME_MARK_SWAP_START);
+
+  /* push on the screen */
+  if (stage_cogl->swap_region)
+    {
+      CLUTTER_NOTE (BACKEND,
+                    "cogl_onscreen_swap_region (onscreen: %p, "
+                                                "n_rectangles: %d)",
+                    stage_cogl->onscreen,
+                    stage_cogl->swap_n_damage);
+
+      cogl_onscreen_swap_region (stage_cogl->onscreen,
+                                 stage_cogl->swap_damage,
+                                 stage_cogl->swap_n_damage);
+    }
+  else
+    {
+      CLUTTER_NOTE (BACKEND, "cogl_onscreen_swap_buffers_with_damage "
+                             "(onscreen: %p, n_rectangles: %d)",
+                    stage_cogl->onscreen,
+                    stage_cogl->swap_n_damage);
+
+      /* If we have swap buffer events then cogl_onscreen_swap_buffers
+       * will return immediately and we need to track that there is a
+       * swap in progress... */
+      if (clutter_feature_available (CLUTTER_FEATURE_SWAP_EVENTS))
+        stage_cogl->pending_swaps++;
+
+      cogl_onscreen_swap_buffers_with_damage (stage_cogl->onscreen,
+                                              stage_cogl->swap_damage,
+                                              stage_cogl->swap_n_damage);
+    }
+
+  _clutter_stage_frame_info_mark (stage_cogl->wrapper,
+                                  CLUTTER_FRAME_MARK_SWAP_END);
+
+  /* the paints of the other stages between the paint of this stage
+   * and its deferred swap are not part of its cost
+   */
+  clutter_stage_cogl_add_paint_cost (stage_cogl,
+                                     stage_cogl->swap_paint_cost +
+                                     g_get_monotonic_time () - swap_start);
+}
+
 /* XXX: This is basically identical to clutter_stage_glx_redraw */
+/* redirects the paint of the stage into an offscreen buffer of the
+ * size of the window multiplied by @scale; the coordinates of the stage
+ * are unchanged, only the viewport is scaled
+ */
+static gboolean
+clutter_stage_cogl_push_scaled_buffer (ClutterStageCogl *stage_cogl,
+                                       int               window_scale,
+                                       float             scale)
+{
+  CoglFramebuffer *onscreen = COGL_FRAMEBUFFER (stage_cogl->onscreen);
+  CoglFramebuffer *fb;
+  CoglMatrix projection;
+  CoglMatrix modelview;
+  float viewport[4];
+  int width, height;
+
+  width = MAX (cogl_framebuffer_get_width (onscreen) * scale, 1);
+  height = MAX (cogl_framebuffer_get_height (onscreen) * scale, 1);
+
+  if (stage_cogl->scaled_texture == NULL ||
+      cogl_texture_get_width (stage_cogl->scaled_texture) != width ||
+      cogl_texture_get_height (stage_cogl->scaled_texture) != height)
+    {
+      CoglError *error = NULL;
+
+      clutter_stage_cogl_clear_scaled_buffer (stage_cogl);
+
+      stage_cogl->scaled_texture =
+        cogl_texture_new_with_size (width, height,
+                                    COGL_TEXTURE_NO_SLICING |
+                                    COGL_TEXTURE_NO_AUTO_MIPMAP,
+                                    COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+      if (stage_cogl->scaled_texture == NULL)
+        return FALSE;
+
+      stage_cogl->scaled_offscreen =
+        cogl_offscreen_new_with_texture (stage_cogl->scaled_texture);
+      if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (stage_cogl->scaled_offscreen),
+                                      &error))
+        {
+          CLUTTER_NOTE (BACKEND, "Unable to allocate a %dx%d stage buffer: %s",
+                        width, height,
+                        error->message);
+          cogl_error_free (error);
+          clutter_stage_cogl_clear_scaled_buffer (stage_cogl);
+          return FALSE;
+        }
+    }
+
+  fb = COGL_FRAMEBUFFER (stage_cogl->scaled_offscreen);
+
+  _clutter_stage_get_viewport (stage_cogl->wrapper,
+                               &viewport[0],
+                               &viewport[1],
+                               &viewport[2],
+                               &viewport[3]);
+  cogl_framebuffer_set_viewport (fb,
+                                 viewport[0] * window_scale * scale,
+                                 viewport[1] * window_scale * scale,
+                                 viewport[2] * window_scale * scale,
+                                 viewport[3] * window_scale * scale);
+
+  cogl_framebuffer_get_projection_matrix (onscreen, &projection);
+  cogl_framebuffer_set_projection_matrix (fb, &projection);
+  cogl_framebuffer_get_modelview_matrix (onscreen, &modelview);
+  cogl_framebuffer_set_modelview_matrix (fb, &modelview);
+
+  cogl_push_framebuffer (fb);
+  stage_cogl->scaled_paint = TRUE;
+
+  return TRUE;
+}
+
+/* stretches the contents of the offscreen buffer over the window */
+static void
+clutter_stage_cogl_pop_scaled_buffer (ClutterStageCogl *stage_cogl)
+{
+  static CoglPipeline *upscale = NULL;
+  CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
+  CoglMatrix projection;
+  CoglMatrix identity;
+  float viewport[4];
+
+  cogl_pop_framebuffer ();
+  stage_cogl->scaled_paint = FALSE;
+
+  if (G_UNLIKELY (upscale == NULL))
+    {
+      upscale = cogl_pipeline_new (cogl_framebuffer_get_context (fb));
+      cogl_pipeline_set_blend (upscale, "RGBA = ADD (SRC_COLOR, 0)", NULL);
+      cogl_pipeline_set_layer_filters (upscale, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+    }
+
+  cogl_pipeline_set_layer_texture (upscale, 0, stage_cogl->scaled_texture);
+
+  cogl_framebuffer_get_viewport4fv (fb, viewport);
+  cogl_framebuffer_get_projection_matrix (fb, &projection);
+
+  cogl_framebuffer_set_viewport (fb, 0, 0,
+                                 cogl_framebuffer_get_width (fb),
+                                 cogl_framebuffer_get_height (fb));
+
+  cogl_matrix_init_identity (&identity);
+  cogl_framebuffer_set_projection_matrix (fb, &identity);
+  cogl_framebuffer_push_matrix (fb);
+  cogl_framebuffer_set_modelview_matrix (fb, &identity);
+
+  cogl_framebuffer_draw_textured_rectangle (fb, upscale,
+                                            -1, 1, 1, -1,
+                                            0, 0, 1, 1);
+
+  cogl_framebuffer_pop_matrix (fb);
+  cogl_framebuffer_set_projection_matrix (fb, &projection);
+  cogl_framebuffer_set_viewport (fb,
+                                 viewport[0], viewport[1],
+                                 viewport[2], viewport[3]);
+}
+
 static void
 clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 {
@@ -421,16 +864,25 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   gboolean can_blit_sub_buffer;
   gboolean has_buffer_age;
   ClutterActor *wrapper;
-  cairo_rectangle_int_t *clip_region;
-  int damage[4], ndamage;
+  ClutterStageCoglRegion clip_region;
+  ClutterStageCoglRegion frame_damage;
   gboolean force_swap;
   int window_scale;
+  float resolution_scale;
+  gint64 redraw_start;
+  int i;
 
   wrapper = CLUTTER_ACTOR (stage_cogl->wrapper);
 
   if (!stage_cogl->onscreen)
     return;
 
+  resolution_scale = _clutter_stage_get_resolution_scale (stage_cogl->wrapper);
+  if (resolution_scale >= 1.f && stage_cogl->scaled_texture != NULL)
+    clutter_stage_cogl_clear_scaled_buffer (stage_cogl);
+
+  redraw_start = g_get_monotonic_time ();
+
   can_blit_sub_buffer =
     cogl_clutter_winsys_has_feature (COGL_WINSYS_FEATURE_SWAP_REGION);
 
@@ -447,52 +899,80 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 
   may_use_clipped_redraw = FALSE;
   if (_clutter_stage_window_can_clip_redraws (stage_window) &&
-      (can_blit_sub_buffer || has_buffer_age) &&
       have_clip &&
       /* some drivers struggle to get going and produce some junk
        * frames when starting up... */
       stage_cogl->frame_count > 3)
     {
-      may_use_clipped_redraw = TRUE;
-      clip_region = &stage_cogl->bounding_redraw_clip;
+      may_use_clipped_redraw = can_blit_sub_buffer || has_buffer_age;
+      clip_region = stage_cogl->redraw_region;
+
+      if (clip_region.n_rects == 0)
+        {
+          clip_region.rects[0] = stage_cogl->bounding_redraw_clip;
+          clip_region.n_rects = 1;
+        }
+      else
+        clutter_stage_cogl_region_simplify (&clip_region);
     }
   else
-    clip_region = NULL;
+    clip_region.n_rects = 0;
 
+  /* a stage rendered at a reduced resolution is stretched over the
+   * whole window at each frame
+   */
   if (may_use_clipped_redraw &&
+      resolution_scale >= 1.f &&
       G_LIKELY (!(clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)))
     use_clipped_redraw = TRUE;
   else
     use_clipped_redraw = FALSE;
 
+  /* the area that changed since the previous frame, which is all the
+   * compositor needs to recompose once we swap, regardless of how much
+   * of the back buffer we have to repaint; the filtering of the
+   * stretched buffer bleeds past the edges of the damaged areas, so
+   * the whole window is damaged at a reduced resolution
+   */
+  if (resolution_scale >= 1.f &&
+      G_LIKELY (!(clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)))
+    frame_damage = clip_region;
+  else
+    frame_damage.n_rects = 0;
+
   force_swap = FALSE;
 
   window_scale = _clutter_stage_window_get_scale_factor (stage_window);
 
   if (has_buffer_age)
     {
-      cairo_rectangle_int_t *current_damage =
+      ClutterStageCoglRegion *current_damage =
 	&stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index++)];
 
       if (use_clipped_redraw)
 	{
-	  int age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen), i;
+	  int age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen);
 
-	  *current_damage = *clip_region;
+	  *current_damage = clip_region;
 
 	  if (valid_buffer_age (stage_cogl, age))
 	    {
 	      for (i = 1; i <= age; i++)
-		_clutter_util_rectangle_union (clip_region,
-					       &stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index - i - 1)],
-					       clip_region);
+                {
+                  const ClutterStageCoglRegion *old_damage =
+                    &stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index - i - 1)];
+                  int j;
+
+                  for (j = 0; j < old_damage->n_rects; j++)
+                    clutter_stage_cogl_region_add (&clip_region,
+                                                   &old_damage->rects[j]);
+                }
 
-	      CLUTTER_NOTE (CLIPPING, "Reusing back buffer(age=%d) - repairing region: x=%d, y=%d, width=%d, height=%d\n",
+              clutter_stage_cogl_region_simplify (&clip_region);
+
+	      CLUTTER_NOTE (CLIPPING, "Reusing back buffer(age=%d) - repairing %d regions\n",
 			    age,
-			    clip_region->x,
-			    clip_region->y,
-			    clip_region->width,
-			    clip_region->height);
+			    clip_region.n_rects);
 	      force_swap = TRUE;
 	    }
 	  else
@@ -503,10 +983,11 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 	}
       else
 	{
-	  current_damage->x = 0;
-	  current_damage->y = 0;
-	  current_damage->width  = geom.width;
-	  current_damage->height = geom.height;
+	  current_damage->rects[0].x = 0;
+	  current_damage->rects[0].y = 0;
+	  current_damage->rects[0].width  = geom.width;
+	  current_damage->rects[0].height = geom.height;
+	  current_damage->n_rects = 1;
 	}
     }
 
@@ -514,22 +995,32 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
     {
       CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
 
-      CLUTTER_NOTE (CLIPPING,
-                    "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
-                    clip_region->x,
-                    clip_region->y,
-                    clip_region->width,
-                    clip_region->height);
-
       stage_cogl->using_clipped_redraw = TRUE;
 
-      cogl_framebuffer_push_scissor_clip (fb,
-                                          clip_region->x * window_scale,
-                                          clip_region->y * window_scale,
-                                          clip_region->width * window_scale,
-                                          clip_region->height * window_scale);
-      _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip_region);
-      cogl_framebuffer_pop_clip (fb);
+      /* each rectangle is painted separately, so that the areas
+       * between them are left untouched
+       */
+      for (i = 0; i < clip_region.n_rects; i++)
+        {
+          cairo_rectangle_int_t *clip = &clip_region.rects[i];
+
+          CLUTTER_NOTE (CLIPPING,
+                        "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
+                        clip->x,
+                        clip->y,
+                        clip->width,
+                        clip->height);
+
+          stage_cogl->current_redraw_clip = *clip;
+
+          cogl_framebuffer_push_scissor_clip (fb,
+                                              clip->x * window_scale,
+                                              clip->y * window_scale,
+                                              clip->width * window_scale,
+                                              clip->height * window_scale);
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip);
+          cogl_framebuffer_pop_clip (fb);
+        }
 
       stage_cogl->using_clipped_redraw = FALSE;
     }
@@ -542,31 +1033,32 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS) &&
           may_use_clipped_redraw)
         {
-          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip_region);
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper),
+                                   &stage_cogl->bounding_redraw_clip);
+        }
+      else if (resolution_scale < 1.f &&
+               clutter_stage_cogl_push_scaled_buffer (stage_cogl,
+                                                      window_scale,
+                                                      resolution_scale))
+        {
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), NULL);
+          clutter_stage_cogl_pop_scaled_buffer (stage_cogl);
         }
       else
         _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), NULL);
     }
 
+  /* the back buffer holds the whole frame at this point */
+  _clutter_stage_read_captures (stage_cogl->wrapper,
+                                COGL_FRAMEBUFFER (stage_cogl->onscreen));
+
   if (may_use_clipped_redraw &&
       G_UNLIKELY ((clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS)))
     {
       CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
       CoglContext *ctx = cogl_framebuffer_get_context (fb);
       static CoglPipeline *outline = NULL;
-      cairo_rectangle_int_t *clip = &stage_cogl->bounding_redraw_clip;
       ClutterActor *actor = CLUTTER_ACTOR (wrapper);
-      float x_1 = clip->x * window_scale;
-      float x_2 = clip->x + clip->width * window_scale;
-      float y_1 = clip->y * window_scale;
-      float y_2 = clip->y + clip->height * window_scale;
-      CoglVertexP2 quad[4] = {
-        { x_1, y_1 },
-        { x_2, y_1 },
-        { x_2, y_2 },
-        { x_1, y_2 }
-      };
-      CoglPrimitive *prim;
       CoglMatrix modelview;
 
       if (outline == NULL)
@@ -575,78 +1067,95 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
           cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
         }
 
-      prim = cogl_primitive_new_p2 (ctx,
-                                    COGL_VERTICES_MODE_LINE_LOOP,
-                                    4, /* n_vertices */
-                                    quad);
-
       cogl_framebuffer_push_matrix (fb);
       cogl_matrix_init_identity (&modelview);
       _clutter_actor_apply_modelview_transform (actor, &modelview);
       cogl_framebuffer_set_modelview_matrix (fb, &modelview);
-      cogl_framebuffer_draw_primitive (COGL_FRAMEBUFFER (stage_cogl->onscreen),
-                                       outline,
-                                       prim);
+
+      for (i = 0; i < clip_region.n_rects; i++)
+        {
+          cairo_rectangle_int_t *clip = &clip_region.rects[i];
+          float x_1 = clip->x * window_scale;
+          float x_2 = (clip->x + clip->width) * window_scale;
+          float y_1 = clip->y * window_scale;
+          float y_2 = (clip->y + clip->height) * window_scale;
+          CoglVertexP2 quad[4] = {
+            { x_1, y_1 },
+            { x_2, y_1 },
+            { x_2, y_2 },
+            { x_1, y_2 }
+          };
+          CoglPrimitive *prim;
+
+          prim = cogl_primitive_new_p2 (ctx,
+                                        COGL_VERTICES_MODE_LINE_LOOP,
+                                        4, /* n_vertices */
+                                        quad);
+
+          cogl_framebuffer_draw_primitive (fb, outline, prim);
+          cogl_object_unref (prim);
+        }
+
       cogl_framebuffer_pop_matrix (fb);
-      cogl_object_unref (prim);
     }
 
-  /* XXX: It seems there will be a race here in that the stage
-   * window may be resized before the cogl_onscreen_swap_region
-   * is handled and so we may copy the wrong region. I can't
-   * really see how we can handle this with the current state of X
-   * but at least in this case a full redraw should be queued by
-   * the resize anyway so it should only exhibit temporary
-   * artefacts.
-   */
-  if (use_clipped_redraw || force_swap)
-    {
-      damage[0] = clip_region->x * window_scale;
-      damage[1] = clip_region->y * window_scale;
-      damage[2] = clip_region->width * window_scale;
-      damage[3] = clip_region->height * window_scale;
-      ndamage = 1;
-    }
-  else
-    {
-      ndamage = 0;
-    }
+  _clutter_stage_frame_info_mark (stage_cogl->wrapper,
+                                  CLUTTER_FRAME_MARK_PAINT_END);
 
-  /* push on the screen */
   if (use_clipped_redraw && !force_swap)
     {
-      CLUTTER_NOTE (BACKEND,
-                    "cogl_onscreen_swap_region (onscreen: %p, "
-                                                "x: %d, y: %d, "
-                                                "width: %d, height: %d)",
-                    stage_cogl->onscreen,
-                    damage[0], damage[1], damage[2], damage[3]);
-
-      cogl_onscreen_swap_region (stage_cogl->onscreen,
-				 damage, ndamage);
+      /* we copy the areas we painted to the front buffer */
+      stage_cogl->swap_n_damage =
+        region_to_damage (&clip_region, window_scale, stage_cogl->swap_damage);
+      stage_cogl->swap_region = TRUE;
     }
   else
     {
-      CLUTTER_NOTE (BACKEND, "cogl_onscreen_swap_buffers (onscreen: %p)",
-                    stage_cogl->onscreen);
-
-      /* If we have swap buffer events then cogl_onscreen_swap_buffers
-       * will return immediately and we need to track that there is a
-       * swap in progress... */
-      if (clutter_feature_available (CLUTTER_FEATURE_SWAP_EVENTS))
-        stage_cogl->pending_swaps++;
-
-      cogl_onscreen_swap_buffers_with_damage (stage_cogl->onscreen,
-					      damage, ndamage);
+      /* if the winsys does not support swapping with damage then
+       * Cogl falls back to a plain swap; an empty damage means
+       * that the whole surface changed
+       */
+      stage_cogl->swap_n_damage =
+        region_to_damage (&frame_damage, window_scale, stage_cogl->swap_damage);
+      stage_cogl->swap_region = FALSE;
     }
 
   /* reset the redraw clipping for the next paint... */
   stage_cogl->initialized_redraw_clip = FALSE;
+  stage_cogl->redraw_region.n_rects = 0;
 
   /* We have repaired the backbuffer */
   stage_cogl->dirty_backbuffer = FALSE;
 
   stage_cogl->frame_count++;
+
+  stage_cogl->swap_paint_cost = g_get_monotonic_time () - redraw_start;
+  stage_cogl->has_pending_swap = TRUE;
+
+  if (!stage_cogl->defer_swap)
+    clutter_stage_cogl_swap (stage_cogl);
+  else
+    {
+      /* submit the commands of the frame now, so that the GPU can
+       * start rendering it while the swap is deferred
+       */
+      cogl_flush ();
+    }
+}
+
+static void
+clutter_stage_cogl_set_defer_swap (ClutterStageWindow *stage_window,
+                                   gboolean            defer)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+
+  stage_cogl->defer_swap = !!defer;
+}
+
+static void
+clutter_stage_cogl_finish_swap (ClutterStageWindow *stage_window)
+{
+  clutter_stage_cogl_swap (CLUTTER_STAGE_COGL (stage_window));
 }
 
 static CoglFramebuffer *
@@ -654,6 +1163,9 @@ clutter_stage_cogl_get_active_framebuffer (ClutterStageWindow *stage_window)
 {
   ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
 
+  if (stage_cogl->scaled_paint)
+    return COGL_FRAMEBUFFER (stage_cogl->scaled_offscreen);
+
   return COGL_FRAMEBUFFER (stage_cogl->onscreen);
 }
 
@@ -682,7 +1194,7 @@ clutter_stage_cogl_get_dirty_pixel (ClutterStageWindow *stage_window,
     {
       cairo_rectangle_int_t *rect;
 
-      rect = &stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index-1)];
+      rect = &stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index-1)].rects[0];
       *x = rect->x;
       *y = rect->y;
     }
@@ -701,11 +1213,14 @@ clutter_stage_window_iface_init (ClutterStageWindowIface *iface)
   iface->schedule_update = clutter_stage_cogl_schedule_update;
   iface->get_update_time = clutter_stage_cogl_get_update_time;
   iface->clear_update_time = clutter_stage_cogl_clear_update_time;
+  iface->get_next_presentation_time = clutter_stage_cogl_get_next_presentation_time;
   iface->add_redraw_clip = clutter_stage_cogl_add_redraw_clip;
   iface->has_redraw_clips = clutter_stage_cogl_has_redraw_clips;
   iface->ignoring_redraw_clips = clutter_stage_cogl_ignoring_redraw_clips;
   iface->get_redraw_clip_bounds = clutter_stage_cogl_get_redraw_clip_bounds;
   iface->redraw = clutter_stage_cogl_redraw;
+  iface->set_defer_swap = clutter_stage_cogl_set_defer_swap;
+  iface->finish_swap = clutter_stage_cogl_finish_swap;
   iface->get_active_framebuffer = clutter_stage_cogl_get_active_framebuffer;
   iface->dirty_back_buffer = clutter_stage_cogl_dirty_back_buffer;
   iface->get_dirty_pixel = clutter_stage_cogl_get_dirty_pixel;
@@ -23,6 +23,18 @@ G_BEGIN_DECLS
 typedef struct _ClutterStageCogl         ClutterStageCogl;
 typedef struct _ClutterStageCoglClass    ClutterStageCoglClass;
 
+typedef struct _ClutterStageCoglRegion   ClutterStageCoglRegion;
+
+/* A small set of rectangles describing a damaged area; the rectangles
+ * are merged when they overlap, or when the set is full */
+#define CLUTTER_STAGE_COGL_MAX_REGION_RECTS 4
+
+struct _ClutterStageCoglRegion
+{
+  cairo_rectangle_int_t rects[CLUTTER_STAGE_COGL_MAX_REGION_RECTS];
+  int n_rects;
+};
+
 struct _ClutterStageCogl
 {
   GObject parent_instance;
@@ -43,6 +55,12 @@ struct _ClutterStageCogl
   gint64 last_presentation_time;
   gint64 update_time;
 
+  /* Stores the time spent by the most recent redraws, used to start
+   * adaptive updates just in time for the next presentation */
+#define PAINT_COST_HISTORY_MAX 8
+  gint64 paint_cost_history[PAINT_COST_HISTORY_MAX];
+  unsigned int paint_cost_index;
+
   /* We only enable clipped redraws after 2 frames, since we've seen
    * a lot of drivers can struggle to get going and may output some
    * junk frames to start with. */
@@ -50,19 +68,48 @@ struct _ClutterStageCogl
 
   cairo_rectangle_int_t bounding_redraw_clip;
 
+  /* the areas queued for redraw, inside bounding_redraw_clip */
+  ClutterStageCoglRegion redraw_region;
+
+  /* the area being painted during a clipped redraw */
+  cairo_rectangle_int_t current_redraw_clip;
+
   /* Stores a list of previous damaged areas */
 #define DAMAGE_HISTORY_MAX 16
 #define DAMAGE_HISTORY(x) ((x) & (DAMAGE_HISTORY_MAX - 1))
-  cairo_rectangle_int_t damage_history[DAMAGE_HISTORY_MAX];
+  ClutterStageCoglRegion damage_history[DAMAGE_HISTORY_MAX];
   unsigned int damage_index;
 
   guint initialized_redraw_clip : 1;
 
   /* TRUE if the current paint cycle has a clipped redraw. In that
-     case bounding_redraw_clip specifies the the bounds. */
+     case current_redraw_clip specifies the the bounds. */
   guint using_clipped_redraw : 1;
 
+  /* the swap of the last paint, which can be deferred until the
+   * other stages are painted
+   */
+  int swap_damage[4 * CLUTTER_STAGE_COGL_MAX_REGION_RECTS];
+  int swap_n_damage;
+  gint64 swap_paint_cost;
+
+  /* the buffer the stage is painted into when it is rendered at a
+   * reduced resolution, see clutter_stage_set_dynamic_resolution()
+   */
+  CoglTexture *scaled_texture;
+  CoglOffscreen *scaled_offscreen;
+
   guint dirty_backbuffer     : 1;
+
+  guint swap_region          : 1;
+  guint has_pending_swap     : 1;
+  guint defer_swap           : 1;
+  guint scaled_paint         : 1;
+
+  /* set by the subclasses that report the presentation times from
+   * their own frame clock, instead of the Cogl frame events
+   */
+  guint external_frame_timings : 1;
 };
 
 struct _ClutterStageCoglClass
@@ -128,8 +128,10 @@
 
 #include "clutter-animator.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-alpha.h"
 #include "clutter-debug.h"
+#include "clutter-easing.h"
 #include "clutter-enum-types.h"
 #include "clutter-interval.h"
 #include "clutter-private.h"
@@ -229,13 +231,28 @@ typedef struct _PropertyIter {
   ClutterInterval     *interval;
   ClutterAlpha        *alpha;
 
-  GList               *current;
+  /* the keys of the property, sorted by progress */
+  GPtrArray           *keys;
+  guint                current;  /* the index of the current key */
 
   gdouble              start;    /* the progress of current */
   gdouble              end;      /* until which progress it is valid */
   ClutterInterpolation interpolation;
 
+  /* the easing mode of the current interval */
+  guint                mode;
+
+  GParamSpec          *pspec;
+
+  /* the id of the property for the scalar path of ClutterActor, or 0 */
+  guint                scalar_prop_id;
+
+  /* the bounds of the current interval, for numeric properties */
+  gdouble              initial_value;
+  gdouble              final_value;
+
   guint                ease_in : 1;
+  guint                is_numeric : 1;
 } PropertyIter;
 
 static PropObjectKey *
@@ -266,6 +283,7 @@ property_iter_free (gpointer key)
 
       g_object_unref (property_iter->interval);
       g_object_unref (property_iter->alpha);
+      g_ptr_array_unref (property_iter->keys);
 
       g_slice_free (PropertyIter, property_iter);
     }
@@ -274,10 +292,11 @@ property_iter_free (gpointer key)
 static PropertyIter *
 property_iter_new (ClutterAnimator *animator,
                    PropObjectKey   *key,
-                   GType            type)
+                   GParamSpec      *pspec)
 {
   ClutterAnimatorPrivate *priv = animator->priv;
-  PropertyIter *property_iter = g_slice_new (PropertyIter);
+  PropertyIter *property_iter = g_slice_new0 (PropertyIter);
+  GType type = G_PARAM_SPEC_VALUE_TYPE (pspec);
   ClutterInterval *interval = g_object_new (CLUTTER_TYPE_INTERVAL,
                                             "value-type", type,
                                             NULL);
@@ -293,9 +312,115 @@ property_iter_new (ClutterAnimator *animator,
   /* as well as the alpha */
   g_object_ref_sink (property_iter->alpha);
 
+  property_iter->keys = g_ptr_array_new ();
+  property_iter->pspec = pspec;
+
+  /* float and double properties are interpolated without going
+   * through the interval, and properties of ClutterActor are set
+   * without going through GObject when possible
+   */
+  property_iter->is_numeric = type == G_TYPE_FLOAT || type == G_TYPE_DOUBLE;
+  if (property_iter->is_numeric && CLUTTER_IS_ACTOR (key->object))
+    property_iter->scalar_prop_id =
+      _clutter_actor_get_scalar_animatable_property (CLUTTER_ACTOR (key->object),
+                                                     pspec);
+
   return property_iter;
 }
 
+#define property_iter_get_key(iter,index) \
+  ((ClutterAnimatorKey *) g_ptr_array_index ((iter)->keys, (index)))
+
+static inline gdouble
+value_get_number (const GValue *value)
+{
+  if (G_VALUE_HOLDS_FLOAT (value))
+    return g_value_get_float (value);
+
+  return g_value_get_double (value);
+}
+
+static inline gboolean
+mode_is_easing (guint mode)
+{
+  return mode > CLUTTER_CUSTOM_MODE && mode < CLUTTER_ANIMATION_LAST;
+}
+
+static void
+property_iter_set_initial_value (PropertyIter *property_iter,
+                                 const GValue *value)
+{
+  clutter_interval_set_initial_value (property_iter->interval, value);
+
+  if (property_iter->is_numeric)
+    property_iter->initial_value = value_get_number (value);
+}
+
+static void
+property_iter_set_final_value (PropertyIter *property_iter,
+                               const GValue *value)
+{
+  clutter_interval_set_final_value (property_iter->interval, value);
+
+  if (property_iter->is_numeric)
+    property_iter->final_value = value_get_number (value);
+}
+
+static void
+property_iter_set_mode (PropertyIter *property_iter,
+                        guint         mode)
+{
+  property_iter->mode = mode;
+
+  /* the alpha is only needed for the modes registered by the
+   * application; the easing modes are computed directly
+   */
+  if (!mode_is_easing (mode) &&
+      clutter_alpha_get_mode (property_iter->alpha) != mode)
+    clutter_alpha_set_mode (property_iter->alpha, mode);
+}
+
+/* Finds the index of the last key with a progress lower than
+ * @progress, or lower or equal if @inclusive is %TRUE; returns
+ * 0 if there is none.
+ */
+static guint
+property_iter_find_key (PropertyIter *property_iter,
+                        gdouble       progress,
+                        gboolean      inclusive)
+{
+  guint lo = 0, hi = property_iter->keys->len;
+
+  while (hi - lo > 1)
+    {
+      guint mid = (lo + hi) / 2;
+      gdouble key_progress = property_iter_get_key (property_iter, mid)->progress;
+
+      if (key_progress < progress || (inclusive && key_progress == progress))
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/* gets the value of the key @count keys away from the current one, or
+ * the closest key in that direction
+ */
+static gfloat
+property_iter_get_rel (PropertyIter *property_iter,
+                       gint          count)
+{
+  gint index_;
+
+  index_ = CLAMP ((gint) property_iter->current + count,
+                  0,
+                  (gint) property_iter->keys->len - 1);
+
+  return g_value_get_float (&property_iter_get_key (property_iter, index_)->value);
+}
+
 static guint
 prop_actor_hash (gconstpointer value)
 {
@@ -481,6 +606,10 @@ list_find_custom_reverse (GList         *list,
 
 /* Ensures that the interval provided by the animator is correct
  * for the requested progress value.
+ *
+ * The current key is moved one key at a time, which is constant time
+ * when the progress changes monotonically; larger jumps, like seeking
+ * or looping, first move to the right key with a binary search.
  */
 static void
 animation_animator_ensure_animator (ClutterAnimator *animator,
@@ -488,33 +617,34 @@ animation_animator_ensure_animator (ClutterAnimator *animator,
                                     PropObjectKey   *key,
                                     gdouble          progress)
 {
+  guint n_keys = property_iter->keys->len;
 
   if (progress > property_iter->end)
     {
+      guint target = property_iter_find_key (property_iter, progress, FALSE);
+
+      if (target > property_iter->current + 1)
+        property_iter->current = target - 1;
+
       while (progress > property_iter->end)
         {
           ClutterAnimatorKey *initial_key, *next_key;
-          GList *initial, *next;
 
-          initial = g_list_find_custom (property_iter->current->next,
-                                        key,
-                                        sort_actor_prop_func);
-
-          if (initial)
+          if (property_iter->current + 1 < n_keys)
             {
-              initial_key = initial->data;
+              property_iter->current += 1;
+
+              initial_key = property_iter_get_key (property_iter,
+                                                   property_iter->current);
 
-              clutter_interval_set_initial_value (property_iter->interval,
-                                                  &initial_key->value);
-              property_iter->current = initial;
+              property_iter_set_initial_value (property_iter,
+                                               &initial_key->value);
               property_iter->start = initial_key->progress;
 
-              next = g_list_find_custom (initial->next,
-                                         key,
-                                         sort_actor_prop_func);
-              if (next)
+              if (property_iter->current + 1 < n_keys)
                 {
-                  next_key = next->data;
+                  next_key = property_iter_get_key (property_iter,
+                                                    property_iter->current + 1);
 
                   property_iter->end = next_key->progress;
                 }
@@ -525,65 +655,51 @@ animation_animator_ensure_animator (ClutterAnimator *animator,
                   property_iter->end = property_iter->start;
                 }
 
-              clutter_interval_set_final_value (property_iter->interval,
-                                                &next_key->value);
-
-              if ((clutter_alpha_get_mode (property_iter->alpha) != next_key->mode))
-                clutter_alpha_set_mode (property_iter->alpha, next_key->mode);
+              property_iter_set_final_value (property_iter, &next_key->value);
+              property_iter_set_mode (property_iter, next_key->mode);
             }
           else /* no relevant interval */
             {
-              ClutterAnimatorKey *current_key = property_iter->current->data;
-              clutter_interval_set_initial_value (property_iter->interval,
-                                                  &current_key->value);
-              clutter_interval_set_final_value (property_iter->interval,
-                                                &current_key->value);
+              ClutterAnimatorKey *current_key;
+
+              current_key = property_iter_get_key (property_iter,
+                                                   property_iter->current);
+              property_iter_set_initial_value (property_iter,
+                                               &current_key->value);
+              property_iter_set_final_value (property_iter,
+                                             &current_key->value);
               break;
             }
         }
     }
   else if (progress < property_iter->start)
     {
+      guint target = property_iter_find_key (property_iter, progress, TRUE);
+
+      if (target + 1 < property_iter->current)
+        property_iter->current = target + 1;
+
       while (progress < property_iter->start)
         {
           ClutterAnimatorKey *initial_key, *next_key;
-          GList *initial;
-          GList *old = property_iter->current;
-
-          initial = list_find_custom_reverse (property_iter->current->prev,
-                                              key,
-                                              sort_actor_prop_func);
 
-          if (initial)
-            {
-              initial_key = initial->data;
+          if (property_iter->current == 0)
+            break;
 
-              clutter_interval_set_initial_value (property_iter->interval,
-                                                  &initial_key->value);
-              property_iter->current = initial;
-              property_iter->end = property_iter->start;
-              property_iter->start = initial_key->progress;
+          next_key = property_iter_get_key (property_iter,
+                                            property_iter->current);
 
-              if (old)
-                {
-                  next_key = old->data;
+          property_iter->current -= 1;
 
-                  property_iter->end = next_key->progress;
-                }
-              else
-                {
-                  next_key = initial_key;
+          initial_key = property_iter_get_key (property_iter,
+                                               property_iter->current);
 
-                  property_iter->end = 1.0;
-                }
+          property_iter_set_initial_value (property_iter, &initial_key->value);
+          property_iter->start = initial_key->progress;
+          property_iter->end = next_key->progress;
 
-              clutter_interval_set_final_value (property_iter->interval,
-                                                &next_key->value);
-              if ((clutter_alpha_get_mode (property_iter->alpha) != next_key->mode))
-                clutter_alpha_set_mode (property_iter->alpha, next_key->mode);
-            }
-          else
-            break;
+          property_iter_set_final_value (property_iter, &next_key->value);
+          property_iter_set_mode (property_iter, next_key->mode);
         }
     }
 }
@@ -670,7 +786,7 @@ animation_animator_new_frame (ClutterTimeline  *timeline,
       animation_animator_ensure_animator (animator, property_iter,
                                           key,
                                           progress);
-      start_key = property_iter->current->data;
+      start_key = property_iter_get_key (property_iter, property_iter->current);
 
       if (property_iter->end == property_iter->start)
         sub_progress = 0.0; /* we're past the final value */
@@ -683,49 +799,80 @@ animation_animator_new_frame (ClutterTimeline  *timeline,
         {
           GValue tmp_value = G_VALUE_INIT;
           GType int_type;
+          gdouble res;
 
-          g_value_init (&tmp_value, G_VALUE_TYPE (&start_key->value));
+          if (mode_is_easing (property_iter->mode))
+            sub_progress = clutter_easing_for_mode (property_iter->mode,
+                                                    sub_progress,
+                                                    1.0);
+          else
+            {
+              clutter_timeline_advance (animator->priv->slave_timeline,
+                                        sub_progress * 10000);
 
-          clutter_timeline_advance (animator->priv->slave_timeline,
-                                    sub_progress * 10000);
+              sub_progress = clutter_alpha_get_alpha (property_iter->alpha);
+            }
 
-          sub_progress = clutter_alpha_get_alpha (property_iter->alpha);
           int_type = clutter_interval_get_value_type (property_iter->interval);
 
           if (property_iter->interpolation == CLUTTER_INTERPOLATION_CUBIC &&
               int_type == G_TYPE_FLOAT)
             {
               gdouble prev, current, next, nextnext;
-              gdouble res;
 
-              if ((property_iter->ease_in == FALSE ||
-                  (property_iter->ease_in &&
-                   list_find_custom_reverse (property_iter->current->prev,
-                                             property_iter->current->data,
-                                             sort_actor_prop_func))))
+              if (property_iter->ease_in == FALSE ||
+                  property_iter->current > 0)
                 {
                   current = g_value_get_float (&start_key->value);
-                  prev = list_try_get_rel (property_iter->current, -1);
+                  prev = property_iter_get_rel (property_iter, -1);
                 }
               else
                 {
                   /* interpolated and easing in */
-                  clutter_interval_get_initial_value (property_iter->interval,
-                                                      &tmp_value);
-                  prev = current = g_value_get_float (&tmp_value);
+                  prev = current = property_iter->initial_value;
                 }
 
-               next = list_try_get_rel (property_iter->current, 1);
-               nextnext = list_try_get_rel (property_iter->current, 2);
+               next = property_iter_get_rel (property_iter, 1);
+               nextnext = property_iter_get_rel (property_iter, 2);
                res = cubic_interpolation (sub_progress, prev, current, next,
                                           nextnext);
+            }
+          else if (property_iter->is_numeric)
+            {
+              res = property_iter->initial_value
+                  + (property_iter->final_value - property_iter->initial_value)
+                  * sub_progress;
+            }
+          else
+            {
+              g_value_init (&tmp_value, G_VALUE_TYPE (&start_key->value));
+              clutter_interval_compute_value (property_iter->interval,
+                                              sub_progress,
+                                              &tmp_value);
+
+              g_object_set_property (prop_actor_key->object,
+                                     prop_actor_key->property_name,
+                                     &tmp_value);
 
-               g_value_set_float (&tmp_value, res);
+              g_value_unset (&tmp_value);
+              continue;
             }
+
+          if (property_iter->scalar_prop_id != 0)
+            {
+              _clutter_actor_set_scalar_animatable_property (CLUTTER_ACTOR (prop_actor_key->object),
+                                                             property_iter->scalar_prop_id,
+                                                             property_iter->pspec,
+                                                             res);
+              continue;
+            }
+
+          g_value_init (&tmp_value, int_type);
+
+          if (int_type == G_TYPE_FLOAT)
+            g_value_set_float (&tmp_value, res);
           else
-            clutter_interval_compute_value (property_iter->interval,
-                                            sub_progress,
-                                            &tmp_value);
+            g_value_set_double (&tmp_value, res);
 
           g_object_set_property (prop_actor_key->object,
                                  prop_actor_key->property_name,
@@ -740,8 +887,19 @@ static void
 animation_animator_started (ClutterTimeline *timeline,
                             ClutterAnimator *animator)
 {
+  GHashTableIter iter;
+  gpointer key, value;
   GList *k;
 
+  /* the keys are collected again, since they might have changed */
+  g_hash_table_iter_init (&iter, animator->priv->properties);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      PropertyIter *property_iter = value;
+
+      g_ptr_array_set_size (property_iter->keys, 0);
+    }
+
   /* Ensure that animators exist for all involved properties */
   for (k = animator->priv->score; k != NULL; k = k->next)
     {
@@ -763,76 +921,64 @@ animation_animator_started (ClutterTimeline *timeline,
 
           pspec = g_object_class_find_property (klass, key->property_name);
 
-          property_iter = property_iter_new (animator, prop_actor_key,
-                                           G_PARAM_SPEC_VALUE_TYPE (pspec));
+          property_iter = property_iter_new (animator, prop_actor_key, pspec);
           g_hash_table_insert (animator->priv->properties,
                                prop_actor_key,
                                property_iter);
         }
+
+      /* the score is sorted by progress for each property */
+      g_ptr_array_add (property_iter->keys, key);
     }
 
-  /* initialize animator with initial list pointers */
-  {
-    GHashTableIter iter;
-    gpointer key, value;
-
-    g_hash_table_iter_init (&iter, animator->priv->properties);
-    while (g_hash_table_iter_next (&iter, &key, &value))
-      {
-        PropertyIter *property_iter = value;
-        ClutterAnimatorKey *initial_key, *next_key;
-        GList *initial;
-        GList *next;
-
-        initial = g_list_find_custom (animator->priv->score,
-                                      key,
-                                      sort_actor_prop_func);
-        g_assert (initial != NULL);
-        initial_key = initial->data;
-        clutter_interval_set_initial_value (property_iter->interval,
-                                            &initial_key->value);
-
-        property_iter->current       = initial;
-        property_iter->start         = initial_key->progress;
-        property_iter->ease_in       = initial_key->ease_in;
-        property_iter->interpolation = initial_key->interpolation;
-
-        if (property_iter->ease_in)
-          {
-            GValue tmp_value = G_VALUE_INIT;
-            GType int_type;
-
-            int_type = clutter_interval_get_value_type (property_iter->interval);
-            g_value_init (&tmp_value, int_type);
-
-            g_object_get_property (initial_key->object,
-                                   initial_key->property_name,
-                                   &tmp_value);
-
-            clutter_interval_set_initial_value (property_iter->interval,
-                                                &tmp_value);
-
-            g_value_unset (&tmp_value);
-          }
-
-        next = g_list_find_custom (initial->next, key, sort_actor_prop_func);
-        if (next)
-          {
-            next_key = next->data;
-            property_iter->end = next_key->progress;
-          }
-        else
-          {
-            next_key = initial_key;
-            property_iter->end = 1.0;
-          }
-
-        clutter_interval_set_final_value (property_iter->interval,
-                                          &next_key->value);
-        if ((clutter_alpha_get_mode (property_iter->alpha) != next_key->mode))
-          clutter_alpha_set_mode (property_iter->alpha, next_key->mode);
-      }
-  }
+  /* initialize animator with the first keys */
+  g_hash_table_iter_init (&iter, animator->priv->properties);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      PropertyIter *property_iter = value;
+      ClutterAnimatorKey *initial_key, *next_key;
+
+      g_assert (property_iter->keys->len > 0);
+
+      initial_key = property_iter_get_key (property_iter, 0);
+      property_iter_set_initial_value (property_iter, &initial_key->value);
+
+      property_iter->current       = 0;
+      property_iter->start         = initial_key->progress;
+      property_iter->ease_in       = initial_key->ease_in;
+      property_iter->interpolation = initial_key->interpolation;
+
+      if (property_iter->ease_in)
+        {
+          GValue tmp_value = G_VALUE_INIT;
+          GType int_type;
+
+          int_type = clutter_interval_get_value_type (property_iter->interval);
+          g_value_init (&tmp_value, int_type);
+
+          g_object_get_property (initial_key->object,
+                                 initial_key->property_name,
+                                 &tmp_value);
+
+          property_iter_set_initial_value (property_iter, &tmp_value);
+
+          g_value_unset (&tmp_value);
+        }
+
+      if (property_iter->keys->len > 1)
+        {
+          next_key = property_iter_get_key (property_iter, 1);
+          property_iter->end = next_key->progress;
+        }
+      else
+        {
+          next_key = initial_key;
+          property_iter->end = 1.0;
+        }
+
+      property_iter_set_final_value (property_iter, &next_key->value);
+      property_iter_set_mode (property_iter, next_key->mode);
+    }
 }
 
 /**
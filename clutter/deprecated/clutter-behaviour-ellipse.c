@@ -55,6 +55,7 @@
 
 #include "clutter-alpha.h"
 #include "clutter-behaviour.h"
+#include "clutter-behaviour-private.h"
 #include "clutter-behaviour-ellipse.h"
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
@@ -181,19 +182,13 @@ clutter_behaviour_ellipse_advance (ClutterBehaviourEllipse *e,
 
 
 static void
-actor_apply_knot_foreach (ClutterBehaviour *behave,
-                          ClutterActor     *actor,
-                          gpointer          data)
+actor_apply_depth_foreach (ClutterBehaviour *behave,
+                           ClutterActor     *actor,
+                           gpointer          data)
 {
-  ClutterBehaviourEllipsePrivate *priv;
   knot3d *knot = data;
 
-  priv = ((ClutterBehaviourEllipse *) behave)->priv;
-
-  clutter_actor_set_position (actor, knot->x, knot->y);
-
-  if (priv->angle_tilt_x != 0 || priv->angle_tilt_y != 0)
-    clutter_actor_set_depth (actor, knot->z);
+  clutter_actor_set_depth (actor, knot->z);
 }
 
 static inline float
@@ -215,7 +210,9 @@ clutter_behaviour_ellipse_alpha_notify (ClutterBehaviour *behave,
   ClutterBehaviourEllipse *self = CLUTTER_BEHAVIOUR_ELLIPSE (behave);
   ClutterBehaviourEllipsePrivate *priv = self->priv;
   gfloat start, end;
+  static const gchar * const names[] = { "x", "y" };
   gfloat angle = 0;
+  gdouble values[2];
   knot3d knot;
 
   /* we do everything in single precision because it's easier, even
@@ -237,7 +234,15 @@ clutter_behaviour_ellipse_alpha_notify (ClutterBehaviour *behave,
   knot.x += priv->center.x;
   knot.y += priv->center.y;
 
-  clutter_behaviour_actors_foreach (behave, actor_apply_knot_foreach, &knot);
+  values[0] = knot.x;
+  values[1] = knot.y;
+  _clutter_behaviour_set_actors_properties (behave, 2, names, values);
+
+  /* the depth also sorts the children of containers, so it still goes
+   * through the public setter
+   */
+  if (priv->angle_tilt_x != 0 || priv->angle_tilt_y != 0)
+    clutter_behaviour_actors_foreach (behave, actor_apply_depth_foreach, &knot);
 }
 
 static void
@@ -46,6 +46,7 @@
 
 #include "clutter-alpha.h"
 #include "clutter-behaviour.h"
+#include "clutter-behaviour-private.h"
 #include "clutter-behaviour-opacity.h"
 #include "clutter-private.h"
 #include "clutter-debug.h"
@@ -72,19 +73,13 @@ G_DEFINE_TYPE_WITH_PRIVATE (ClutterBehaviourOpacity,
                             clutter_behaviour_opacity,
                             CLUTTER_TYPE_BEHAVIOUR)
 
-static void
-alpha_notify_foreach (ClutterBehaviour *behaviour,
-		      ClutterActor     *actor,
-		      gpointer          data)
-{
-  clutter_actor_set_opacity (actor, GPOINTER_TO_UINT(data));
-}
-
 static void
 clutter_behaviour_alpha_notify (ClutterBehaviour *behave,
                                 gdouble           alpha_value)
 {
+  static const gchar * const names[] = { "opacity" };
   ClutterBehaviourOpacityPrivate *priv;
+  gdouble value;
   guint8 opacity;
 
   priv = CLUTTER_BEHAVIOUR_OPACITY (behave)->priv;
@@ -97,9 +92,8 @@ clutter_behaviour_alpha_notify (ClutterBehaviour *behave,
                 alpha_value,
                 opacity);
 
-  clutter_behaviour_actors_foreach (behave,
-				    alpha_notify_foreach,
-				    GUINT_TO_POINTER ((guint) opacity));
+  value = opacity;
+  _clutter_behaviour_set_actors_properties (behave, 1, names, &value);
 }
 
 static void
@@ -71,6 +71,7 @@
 
 #include "clutter-alpha.h"
 #include "clutter-behaviour.h"
+#include "clutter-behaviour-private.h"
 #include "clutter-behaviour-path.h"
 #include "clutter-bezier.h"
 #include "clutter-debug.h"
@@ -118,25 +119,15 @@ G_DEFINE_TYPE_WITH_CODE (ClutterBehaviourPath,
                          G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_SCRIPTABLE,
                                                 clutter_scriptable_iface_init))
 
-static void
-actor_apply_knot_foreach (ClutterBehaviour *behaviour,
-                          ClutterActor     *actor,
-                          gpointer          data)
-{
-  ClutterKnot *knot = data;
-
-  CLUTTER_NOTE (ANIMATION, "Setting actor to %ix%i", knot->x, knot->y);
-
-  clutter_actor_set_position (actor, knot->x, knot->y);
-}
-
 static void
 clutter_behaviour_path_alpha_notify (ClutterBehaviour *behave,
                                      gdouble           alpha_value)
 {
   ClutterBehaviourPath *pathb = CLUTTER_BEHAVIOUR_PATH (behave);
   ClutterBehaviourPathPrivate *priv = pathb->priv;
+  static const gchar * const names[] = { "x", "y" };
   ClutterKnot position;
+  gdouble values[2];
   guint knot_num;
 
   if (priv->path)
@@ -147,9 +138,11 @@ clutter_behaviour_path_alpha_notify (ClutterBehaviour *behave,
       knot_num = 0;
     }
 
-  clutter_behaviour_actors_foreach (behave,
-                                    actor_apply_knot_foreach,
-                                    &position);
+  CLUTTER_NOTE (ANIMATION, "Setting actors to %ix%i", position.x, position.y);
+
+  values[0] = position.x;
+  values[1] = position.y;
+  _clutter_behaviour_set_actors_properties (behave, 2, names, values);
 
   if (knot_num != priv->last_knot_passed)
     {
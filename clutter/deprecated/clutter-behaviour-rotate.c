@@ -46,6 +46,7 @@
 
 #include "clutter-alpha.h"
 #include "clutter-behaviour.h"
+#include "clutter-behaviour-private.h"
 #include "clutter-behaviour-rotate.h"
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
@@ -63,6 +64,11 @@ struct _ClutterBehaviourRotatePrivate
   gint center_x;
   gint center_y;
   gint center_z;
+
+  /* whether the center of the rotation has been set on the actors;
+   * until then the rotation goes through clutter_actor_set_rotation()
+   */
+  guint center_applied : 1;
 };
 
 enum
@@ -145,9 +151,32 @@ clutter_behaviour_rotate_alpha_notify (ClutterBehaviour *behaviour,
 
   closure.angle = (end - start) * alpha_value + start;
 
-  clutter_behaviour_actors_foreach (behaviour,
-				    alpha_notify_foreach,
-				    &closure);
+  if (!priv->center_applied)
+    {
+      clutter_behaviour_actors_foreach (behaviour,
+                                        alpha_notify_foreach,
+                                        &closure);
+      priv->center_applied = TRUE;
+    }
+  else
+    {
+      static const gchar * const names[] = {
+        "rotation-angle-x",
+        "rotation-angle-y",
+        "rotation-angle-z",
+      };
+
+      _clutter_behaviour_set_actors_properties (behaviour, 1,
+                                                &names[priv->axis],
+                                                &closure.angle);
+    }
+}
+
+static void
+clutter_behaviour_rotate_applied (ClutterBehaviour *behaviour,
+                                  ClutterActor     *actor)
+{
+  CLUTTER_BEHAVIOUR_ROTATE (behaviour)->priv->center_applied = FALSE;
 }
 
 static void
@@ -173,7 +202,7 @@ clutter_behaviour_rotate_set_property (GObject      *gobject,
       break;
 
     case PROP_AXIS:
-      priv->axis = g_value_get_enum (value);
+      clutter_behaviour_rotate_set_axis (rotate, g_value_get_enum (value));
       break;
 
     case PROP_DIRECTION:
@@ -264,6 +293,7 @@ clutter_behaviour_rotate_class_init (ClutterBehaviourRotateClass *klass)
   gobject_class->get_property = clutter_behaviour_rotate_get_property;
 
   behaviour_class->alpha_notify = clutter_behaviour_rotate_alpha_notify;
+  behaviour_class->applied = clutter_behaviour_rotate_applied;
 
   /**
    * ClutterBehaviourRotate:angle-start:
@@ -488,6 +518,7 @@ clutter_behaviour_rotate_set_axis (ClutterBehaviourRotate *rotate,
   if (priv->axis != axis)
     {
       priv->axis = axis;
+      priv->center_applied = FALSE;
 
       g_object_notify_by_pspec (G_OBJECT (rotate), obj_props[PROP_AXIS]);
     }
@@ -634,6 +665,9 @@ clutter_behaviour_rotate_set_center (ClutterBehaviourRotate *rotate,
 
   g_object_freeze_notify (G_OBJECT (rotate));
 
+  if (priv->center_x != x || priv->center_y != y || priv->center_z != z)
+    priv->center_applied = FALSE;
+
   if (priv->center_x != x)
     {
       priv->center_x = x;
@@ -46,6 +46,7 @@
 
 #include "clutter-alpha.h"
 #include "clutter-behaviour.h"
+#include "clutter-behaviour-private.h"
 #include "clutter-behaviour-scale.h"
 #include "clutter-debug.h"
 #include "clutter-main.h"
@@ -78,27 +79,13 @@ G_DEFINE_TYPE_WITH_PRIVATE (ClutterBehaviourScale,
                             clutter_behaviour_scale,
                             CLUTTER_TYPE_BEHAVIOUR)
 
-typedef struct {
-  gdouble scale_x;
-  gdouble scale_y;
-} ScaleFrameClosure;
-
-static void
-scale_frame_foreach (ClutterBehaviour *behaviour,
-                     ClutterActor     *actor,
-		     gpointer          data)
-{
-  ScaleFrameClosure *closure = data;
-
-  clutter_actor_set_scale (actor, closure->scale_x, closure->scale_y);
-}
-
 static void
 clutter_behaviour_scale_alpha_notify (ClutterBehaviour *behave,
                                       gdouble           alpha_value)
 {
   ClutterBehaviourScalePrivate *priv;
-  ScaleFrameClosure closure = { 0, };
+  static const gchar * const names[] = { "scale-x", "scale-y" };
+  gdouble values[2];
 
   priv = CLUTTER_BEHAVIOUR_SCALE (behave)->priv;
 
@@ -107,28 +94,26 @@ clutter_behaviour_scale_alpha_notify (ClutterBehaviour *behave,
   */
   if (alpha_value == 1.0)
     {
-      closure.scale_x = priv->x_scale_end;
-      closure.scale_y = priv->y_scale_end;
+      values[0] = priv->x_scale_end;
+      values[1] = priv->y_scale_end;
     }
   else if (alpha_value == 0)
     {
-      closure.scale_x = priv->x_scale_start;
-      closure.scale_y = priv->y_scale_start;
+      values[0] = priv->x_scale_start;
+      values[1] = priv->y_scale_start;
     }
   else
     {
-      closure.scale_x = (priv->x_scale_end - priv->x_scale_start)
-                      * alpha_value
-                      + priv->x_scale_start;
+      values[0] = (priv->x_scale_end - priv->x_scale_start)
+                * alpha_value
+                + priv->x_scale_start;
 
-      closure.scale_y = (priv->y_scale_end - priv->y_scale_start)
-                      * alpha_value
-                      + priv->y_scale_start;
+      values[1] = (priv->y_scale_end - priv->y_scale_start)
+                * alpha_value
+                + priv->y_scale_start;
     }
 
-  clutter_behaviour_actors_foreach (behave,
-                                    scale_frame_foreach,
-                                    &closure);
+  _clutter_behaviour_set_actors_properties (behave, 2, names, values);
 }
 
 static void
@@ -76,8 +76,10 @@
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 #include "clutter-behaviour.h"
+#include "clutter-behaviour-private.h"
 #include "clutter-alpha.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
@@ -480,6 +482,83 @@ clutter_behaviour_actors_foreach (ClutterBehaviour            *behave,
     }
 }
 
+#define MAX_BEHAVIOUR_PROPERTIES        3
+
+/*< private >
+ * _clutter_behaviour_set_actors_properties:
+ * @behave: a #ClutterBehaviour
+ * @n_properties: the number of properties to set, at most 3
+ * @names: (array length=n_properties): the names of #ClutterActor properties
+ * @values: (array length=n_properties): the values of the properties
+ *
+ * Sets the values computed for the current alpha on every actor driven
+ * by @behave.
+ *
+ * The properties are resolved once for all the actors, and those that
+ * can be are set through the same path used by the transitions of
+ * #ClutterActor, without going through the easing state or a #GValue.
+ * Actors overriding the #ClutterAnimatable interface use the #GObject
+ * property setters instead.
+ */
+void
+_clutter_behaviour_set_actors_properties (ClutterBehaviour   *behave,
+                                          guint               n_properties,
+                                          const gchar * const names[],
+                                          const gdouble       values[])
+{
+  static GObjectClass *actor_class = NULL;
+  GParamSpec *pspecs[MAX_BEHAVIOUR_PROPERTIES];
+  GSList *l;
+  guint i;
+
+  g_assert (n_properties <= MAX_BEHAVIOUR_PROPERTIES);
+
+  if (G_UNLIKELY (actor_class == NULL))
+    actor_class = g_type_class_ref (CLUTTER_TYPE_ACTOR);
+
+  for (i = 0; i < n_properties; i++)
+    {
+      pspecs[i] = g_object_class_find_property (actor_class, names[i]);
+      g_assert (pspecs[i] != NULL);
+    }
+
+  for (l = behave->priv->actors; l != NULL; l = l->next)
+    {
+      ClutterActor *actor = l->data;
+
+      for (i = 0; i < n_properties; i++)
+        {
+          guint prop_id;
+
+          prop_id = _clutter_actor_get_scalar_animatable_property (actor,
+                                                                   pspecs[i]);
+          if (prop_id != 0)
+            {
+              _clutter_actor_set_scalar_animatable_property (actor, prop_id,
+                                                             pspecs[i],
+                                                             values[i]);
+            }
+          else
+            {
+              GValue value = G_VALUE_INIT;
+              GValue real_value = G_VALUE_INIT;
+
+              g_value_init (&value, G_TYPE_DOUBLE);
+              g_value_set_double (&value, values[i]);
+
+              g_value_init (&real_value, G_PARAM_SPEC_VALUE_TYPE (pspecs[i]));
+              if (g_value_transform (&value, &real_value))
+                g_object_set_property (G_OBJECT (actor),
+                                       pspecs[i]->name,
+                                       &real_value);
+
+              g_value_unset (&real_value);
+              g_value_unset (&value);
+            }
+        }
+    }
+}
+
 /**
  * clutter_behaviour_get_alpha:
  * @behave: a #ClutterBehaviour
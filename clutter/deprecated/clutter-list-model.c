@@ -32,7 +32,10 @@
  * #ClutterListModel is a #ClutterModel implementation provided by
  * Clutter. #ClutterListModel uses a #GSequence for storing the
  * values for each row, so it's optimized for insertion and look up
- * in sorted lists.
+ * in sorted lists. When a filter is set, #ClutterListModel keeps an
+ * index of the rows that pass it, updated as rows are added, changed
+ * and removed, so that accessing a row by its position does not need
+ * to run the filter over the whole model.
  *
  * #ClutterListModel is available since Clutter 0.6
  *
@@ -86,6 +89,18 @@ struct _ClutterListModelPrivate
   GSequence *sequence;
 
   ClutterModelIter *temp_iter;
+
+  /* the GSequenceIter of the rows passing the filter, in order */
+  GPtrArray *filtered;
+
+  /* the rows whose filtering must be evaluated again */
+  GHashTable *dirty_rows;
+
+  /* the filter stamp of the model when the index was built */
+  guint filter_stamp;
+
+  guint filtered_valid : 1;
+  guint in_filter      : 1;
 };
 
 struct _ClutterListModelIter
@@ -107,6 +122,157 @@ G_DEFINE_TYPE (ClutterListModelIter,
                clutter_list_model_iter,
                CLUTTER_TYPE_MODEL_ITER)
 
+/*
+ * the index of the filtered rows
+ */
+
+static inline void
+clutter_list_model_mark_row_dirty (ClutterListModel *model,
+                                   GSequenceIter    *seq_iter)
+{
+  if (model->priv->filtered_valid)
+    g_hash_table_add (model->priv->dirty_rows, seq_iter);
+}
+
+static gboolean
+clutter_list_model_filter_seq_iter (ClutterListModel *model,
+                                    GSequenceIter    *seq_iter)
+{
+  ClutterModelIter *temp_iter = model->priv->temp_iter;
+
+  CLUTTER_LIST_MODEL_ITER (temp_iter)->seq_iter = seq_iter;
+
+  return clutter_model_filter_iter (CLUTTER_MODEL (model), temp_iter);
+}
+
+/* returns the position of @seq_iter inside the index of the filtered
+ * rows if it's there, or the position at which it should be inserted
+ */
+static guint
+clutter_list_model_search_filtered (ClutterListModel *model,
+                                    GSequenceIter    *seq_iter,
+                                    gboolean         *found)
+{
+  GPtrArray *filtered = model->priv->filtered;
+  guint lo = 0, hi = filtered->len;
+
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+      gint cmp;
+
+      cmp = g_sequence_iter_compare (g_ptr_array_index (filtered, mid),
+                                     seq_iter);
+      if (cmp == 0)
+        {
+          *found = TRUE;
+          return mid;
+        }
+
+      if (cmp < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  *found = FALSE;
+
+  return lo;
+}
+
+static void
+clutter_list_model_remove_filtered (ClutterListModel *model,
+                                    GSequenceIter    *seq_iter)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  gboolean found;
+  guint pos;
+
+  if (!priv->filtered_valid)
+    return;
+
+  g_hash_table_remove (priv->dirty_rows, seq_iter);
+
+  pos = clutter_list_model_search_filtered (model, seq_iter, &found);
+  if (found)
+    g_ptr_array_remove_index (priv->filtered, pos);
+}
+
+/*
+ * clutter_list_model_update_filtered:
+ * @model: a #ClutterListModel
+ *
+ * Brings the index of the filtered rows up to date: the index is
+ * rebuilt if the filter or the order of the rows changed, otherwise
+ * only the rows that were added or changed since the last update are
+ * filtered again.
+ *
+ * Return value: %TRUE if the index can be used
+ */
+static gboolean
+clutter_list_model_update_filtered (ClutterListModel *model)
+{
+  ClutterListModelPrivate *priv = model->priv;
+  guint filter_stamp;
+
+  /* the filter function is trying to access the model */
+  if (priv->in_filter)
+    return FALSE;
+
+  priv->in_filter = TRUE;
+
+  filter_stamp = _clutter_model_get_filter_stamp (CLUTTER_MODEL (model));
+
+  if (!priv->filtered_valid || priv->filter_stamp != filter_stamp)
+    {
+      GSequenceIter *seq_iter;
+
+      g_ptr_array_set_size (priv->filtered, 0);
+      g_hash_table_remove_all (priv->dirty_rows);
+
+      seq_iter = g_sequence_get_begin_iter (priv->sequence);
+      while (!g_sequence_iter_is_end (seq_iter))
+        {
+          if (clutter_list_model_filter_seq_iter (model, seq_iter))
+            g_ptr_array_add (priv->filtered, seq_iter);
+
+          seq_iter = g_sequence_iter_next (seq_iter);
+        }
+
+      priv->filter_stamp = filter_stamp;
+      priv->filtered_valid = TRUE;
+    }
+  else if (g_hash_table_size (priv->dirty_rows) > 0)
+    {
+      GList *dirty_rows, *l;
+
+      /* the filter function might change the rows */
+      dirty_rows = g_hash_table_get_keys (priv->dirty_rows);
+      g_hash_table_remove_all (priv->dirty_rows);
+
+      for (l = dirty_rows; l != NULL; l = l->next)
+        {
+          GSequenceIter *seq_iter = l->data;
+          gboolean visible, found;
+          guint pos;
+
+          visible = clutter_list_model_filter_seq_iter (model, seq_iter);
+          pos = clutter_list_model_search_filtered (model, seq_iter, &found);
+
+          if (visible && !found)
+            g_ptr_array_insert (priv->filtered, pos, seq_iter);
+          else if (!visible && found)
+            g_ptr_array_remove_index (priv->filtered, pos);
+        }
+
+      g_list_free (dirty_rows);
+    }
+
+  priv->in_filter = FALSE;
+
+  return TRUE;
+}
+
 static void
 clutter_list_model_iter_get_value (ClutterModelIter *iter,
                                    guint             column,
@@ -211,6 +377,9 @@ clutter_list_model_iter_set_value (ClutterModelIter *iter,
     }
   else
     g_value_copy (value, iter_value);
+
+  clutter_list_model_mark_row_dirty (CLUTTER_LIST_MODEL (clutter_model_iter_get_model (iter)),
+                                     iter_default->seq_iter);
 }
 
 static gboolean
@@ -272,6 +441,20 @@ clutter_list_model_iter_is_last (ClutterModelIter *iter)
 
   model = clutter_model_iter_get_model (iter);
 
+  if (clutter_model_get_filter_set (model) &&
+      clutter_list_model_update_filtered (CLUTTER_LIST_MODEL (model)))
+    {
+      GPtrArray *filtered = CLUTTER_LIST_MODEL (model)->priv->filtered;
+
+      /* the 'end' iter is the one after the last filtered row */
+      if (filtered->len > 0)
+        {
+          end = g_ptr_array_index (filtered, filtered->len - 1);
+
+          return iter_default->seq_iter == g_sequence_iter_next (end);
+        }
+    }
+
   sequence = CLUTTER_LIST_MODEL (model)->priv->sequence;
 
   begin = g_sequence_get_end_iter (sequence);
@@ -316,6 +499,27 @@ clutter_list_model_iter_next (ClutterModelIter *iter)
   model = clutter_model_iter_get_model (iter);
   row   = clutter_model_iter_get_row (iter);
 
+  /* the next filtered row is in the index, if the iterator is */
+  if (clutter_model_get_filter_set (model) &&
+      clutter_list_model_update_filtered (CLUTTER_LIST_MODEL (model)))
+    {
+      GPtrArray *filtered = CLUTTER_LIST_MODEL (model)->priv->filtered;
+
+      if (row < filtered->len &&
+          g_ptr_array_index (filtered, row) == iter_default->seq_iter)
+        {
+          if (row + 1 < filtered->len)
+            filter_next = g_ptr_array_index (filtered, row + 1);
+          else
+            filter_next = g_sequence_get_end_iter (g_sequence_iter_get_sequence (iter_default->seq_iter));
+
+          _clutter_model_iter_set_row (CLUTTER_MODEL_ITER (iter_default), row + 1);
+          iter_default->seq_iter = filter_next;
+
+          return CLUTTER_MODEL_ITER (iter_default);
+        }
+    }
+
   filter_next = g_sequence_iter_next (iter_default->seq_iter);
   g_assert (filter_next != NULL);
 
@@ -466,6 +670,21 @@ clutter_list_model_get_iter_at_row (ClutterModel *model,
       return CLUTTER_MODEL_ITER (retval);
     }
 
+  if (clutter_list_model_update_filtered (model_default))
+    {
+      GPtrArray *filtered = model_default->priv->filtered;
+
+      if (row >= filtered->len)
+        {
+          g_object_unref (retval);
+          return NULL;
+        }
+
+      retval->seq_iter = g_ptr_array_index (filtered, row);
+
+      return CLUTTER_MODEL_ITER (retval);
+    }
+
   filter_next = g_sequence_get_begin_iter (sequence);
   g_assert (filter_next != NULL);
 
@@ -526,6 +745,9 @@ clutter_list_model_insert_row (ClutterModel *model,
       pos = index_;
     }
 
+  /* the row is filtered once its values have been set */
+  clutter_list_model_mark_row_dirty (model_default, seq_iter);
+
   retval = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
                          "model", model,
                          "row", pos,
@@ -541,42 +763,41 @@ clutter_list_model_remove_row (ClutterModel *model,
 {
   ClutterListModel *model_default = CLUTTER_LIST_MODEL (model);
   GSequence *sequence = model_default->priv->sequence;
+  ClutterModelIter *iter;
   GSequenceIter *seq_iter;
-  guint pos = 0;
 
-  seq_iter = g_sequence_get_begin_iter (sequence);
-  while (!g_sequence_iter_is_end (seq_iter))
+  if (clutter_model_get_filter_set (model) &&
+      clutter_list_model_update_filtered (model_default))
     {
-      if (clutter_model_filter_row (model, pos))
-        {
-          if (pos == row)
-            {  
-              ClutterModelIter *iter;
-
-              iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
-                                   "model", model,
-                                   "row", pos,
-                                   NULL);
-              CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
-
-              /* the actual row is removed from the sequence inside
-               * the ::row-removed signal class handler, so that every
-               * handler connected to ::row-removed will still get
-               * a valid iterator, and every signal connected to
-               * ::row-removed with the AFTER flag will get an updated
-               * model
-               */
-              g_signal_emit_by_name (model, "row-removed", iter);
-
-              g_object_unref (iter);
-
-              break;
-            }
-        }
+      GPtrArray *filtered = model_default->priv->filtered;
+
+      if (row >= filtered->len)
+        return;
+
+      seq_iter = g_ptr_array_index (filtered, row);
+    }
+  else
+    {
+      if (row >= g_sequence_get_length (sequence))
+        return;
 
-      pos += 1;
-      seq_iter = g_sequence_iter_next (seq_iter);
+      seq_iter = g_sequence_get_iter_at_pos (sequence, row);
     }
+
+  iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
+                       "model", model,
+                       "row", row,
+                       NULL);
+  CLUTTER_LIST_MODEL_ITER (iter)->seq_iter = seq_iter;
+
+  /* the actual row is removed from the sequence inside the ::row-removed
+   * signal class handler, so that every handler connected to ::row-removed
+   * will still get a valid iterator, and every signal connected to
+   * ::row-removed with the AFTER flag will get an updated model
+   */
+  g_signal_emit_by_name (model, "row-removed", iter);
+
+  g_object_unref (iter);
 }
 
 typedef struct
@@ -617,6 +838,34 @@ clutter_list_model_resort (ClutterModel         *model,
   g_sequence_sort (CLUTTER_LIST_MODEL (model)->priv->sequence,
                    sort_model_default,
                    &sort_closure);
+
+  /* the filtered rows are in the order of the sequence */
+  CLUTTER_LIST_MODEL (model)->priv->filtered_valid = FALSE;
+}
+
+static void
+clutter_list_model_resort_row (ClutterModel         *model,
+                               ClutterModelIter     *iter,
+                               ClutterModelSortFunc  func,
+                               gpointer              data)
+{
+  ClutterListModel *list_model = CLUTTER_LIST_MODEL (model);
+  GSequenceIter *seq_iter = CLUTTER_LIST_MODEL_ITER (iter)->seq_iter;
+  SortClosure sort_closure = { NULL, 0, NULL, NULL };
+
+  sort_closure.model  = model;
+  sort_closure.column = clutter_model_get_sorting_column (model);
+  sort_closure.func   = func;
+  sort_closure.data   = data;
+
+  /* the filtered rows are in the order of the sequence, so the row
+   * has to be filtered again at its new position
+   */
+  clutter_list_model_remove_filtered (list_model, seq_iter);
+
+  g_sequence_sort_changed (seq_iter, sort_model_default, &sort_closure);
+
+  clutter_list_model_mark_row_dirty (list_model, seq_iter);
 }
 
 static guint
@@ -628,6 +877,9 @@ clutter_list_model_get_n_rows (ClutterModel *model)
   if (!clutter_model_get_filter_set (model))
     return g_sequence_get_length (list_model->priv->sequence);
 
+  if (clutter_list_model_update_filtered (list_model))
+    return list_model->priv->filtered->len;
+
   return CLUTTER_MODEL_CLASS (clutter_list_model_parent_class)->get_n_rows (model);
 }
 
@@ -650,6 +902,9 @@ clutter_list_model_row_removed (ClutterModel     *model,
 
   g_free (values);
 
+  clutter_list_model_remove_filtered (CLUTTER_LIST_MODEL (model),
+                                      iter_default->seq_iter);
+
   g_sequence_remove (iter_default->seq_iter);
   iter_default->seq_iter = NULL;
 }
@@ -678,6 +933,9 @@ clutter_list_model_finalize (GObject *gobject)
     }
   g_sequence_free (sequence);
 
+  g_ptr_array_unref (model->priv->filtered);
+  g_hash_table_unref (model->priv->dirty_rows);
+
   G_OBJECT_CLASS (clutter_list_model_parent_class)->finalize (gobject);
 }
 
@@ -708,6 +966,7 @@ clutter_list_model_class_init (ClutterListModelClass *klass)
   model_class->insert_row = clutter_list_model_insert_row;
   model_class->remove_row = clutter_list_model_remove_row;
   model_class->resort = clutter_list_model_resort;
+  model_class->resort_row = clutter_list_model_resort_row;
   model_class->get_n_rows = clutter_list_model_get_n_rows;
   model_class->row_removed = clutter_list_model_row_removed;
 }
@@ -718,6 +977,8 @@ clutter_list_model_init (ClutterListModel *model)
   model->priv = clutter_list_model_get_instance_private (model);
 
   model->priv->sequence = g_sequence_new (NULL);
+  model->priv->filtered = g_ptr_array_new ();
+  model->priv->dirty_rows = g_hash_table_new (NULL, NULL);
   model->priv->temp_iter = g_object_new (CLUTTER_TYPE_LIST_MODEL_ITER,
                                          "model",
                                          model,
@@ -212,10 +212,22 @@ struct _ClutterModelPrivate
   gpointer                filter_data;
   GDestroyNotify          filter_notify;
 
+  /* bumped every time the filter changes, so that the implementations
+   * can tell whether the rows they cached as filtered are still valid
+   */
+  guint                   filter_stamp;
+
   gint                    sort_column;
   ClutterModelSortFunc    sort_func;
   gpointer                sort_data;
   GDestroyNotify          sort_notify;
+
+  /* the number of clutter_model_begin_update() calls without a
+   * matching clutter_model_end_update()
+   */
+  gint                    update_depth;
+
+  guint                   resort_pending : 1;
 };
 
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
@@ -777,6 +789,10 @@ clutter_scriptable_iface_init (ClutterScriptableIface *iface)
  * Force a resort on the @model. This function should only be
  * used by subclasses of #ClutterModel.
  *
+ * If called between clutter_model_begin_update() and
+ * clutter_model_end_update(), the resort is deferred until the
+ * end of the update.
+ *
  * Since: 0.6
  *
  * Deprecated: 1.24: Use #GListModel instead
@@ -790,12 +806,101 @@ clutter_model_resort (ClutterModel *model)
   g_return_if_fail (CLUTTER_IS_MODEL (model));
   priv = model->priv;
 
+  if (priv->update_depth > 0)
+    {
+      priv->resort_pending = TRUE;
+      return;
+    }
+
   klass = CLUTTER_MODEL_GET_CLASS (model);
 
   if (klass->resort)
     klass->resort (model, priv->sort_func, priv->sort_data);
 }
 
+/*
+ * clutter_model_resort_row:
+ * @model: a #ClutterModel
+ * @iter: a #ClutterModelIter pointing to a row whose sorting column
+ *   changed
+ *
+ * Moves the row pointed by @iter to its sorted position, falling
+ * back to a resort of the whole model if the implementation cannot
+ * move a single row.
+ */
+static void
+clutter_model_resort_row (ClutterModel     *model,
+                          ClutterModelIter *iter)
+{
+  ClutterModelPrivate *priv = model->priv;
+  ClutterModelClass *klass = CLUTTER_MODEL_GET_CLASS (model);
+
+  if (priv->update_depth > 0)
+    {
+      priv->resort_pending = TRUE;
+      return;
+    }
+
+  if (klass->resort_row != NULL && priv->sort_func != NULL)
+    klass->resort_row (model, iter, priv->sort_func, priv->sort_data);
+  else
+    clutter_model_resort (model);
+}
+
+/**
+ * clutter_model_begin_update:
+ * @model: a #ClutterModel
+ *
+ * Starts a batch of changes to @model.
+ *
+ * Until the matching call to clutter_model_end_update(), changing the
+ * sorting column of a row does not resort the model; the model is
+ * sorted once at the end of the update, and the
+ * #ClutterModel::sort-changed signal is emitted once if it was.
+ *
+ * Calls to this function can be nested.
+ *
+ * Since: 1.26
+ */
+void
+clutter_model_begin_update (ClutterModel *model)
+{
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+
+  model->priv->update_depth += 1;
+}
+
+/**
+ * clutter_model_end_update:
+ * @model: a #ClutterModel
+ *
+ * Ends a batch of changes to @model started with
+ * clutter_model_begin_update().
+ *
+ * Since: 1.26
+ */
+void
+clutter_model_end_update (ClutterModel *model)
+{
+  ClutterModelPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_MODEL (model));
+
+  priv = model->priv;
+
+  g_return_if_fail (priv->update_depth > 0);
+
+  priv->update_depth -= 1;
+  if (priv->update_depth > 0 || !priv->resort_pending)
+    return;
+
+  priv->resort_pending = FALSE;
+
+  clutter_model_resort (model);
+
+  g_signal_emit (model, model_signals[SORT_CHANGED], 0);
+}
+
 /**
  * clutter_model_filter_row:
  * @model: a #ClutterModel
@@ -908,6 +1013,21 @@ _clutter_model_set_n_columns (ClutterModel *model,
     priv->column_names = g_new0 (gchar*, n_columns);
 }
 
+/*< private >
+ * _clutter_model_get_filter_stamp:
+ * @model: a #ClutterModel
+ *
+ * Retrieves a counter that changes every time the filter of @model
+ * is replaced.
+ *
+ * Return value: the filter stamp
+ */
+guint
+_clutter_model_get_filter_stamp (ClutterModel *model)
+{
+  return model->priv->filter_stamp;
+}
+
 /*< private >
  * _clutter_model_set_column_type:
  * @model: a #ClutterModel
@@ -1094,7 +1214,7 @@ clutter_model_appendv (ClutterModel *model,
   g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
 
   if (resort)
-    clutter_model_resort (model);
+    clutter_model_resort_row (model, iter);
 
   g_object_unref (iter);
 }
@@ -1192,7 +1312,7 @@ clutter_model_prependv (ClutterModel *model,
   g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
 
   if (resort)
-    clutter_model_resort (model);
+    clutter_model_resort_row (model, iter);
 
   g_object_unref (iter);
 }
@@ -1276,8 +1396,8 @@ clutter_model_insert (ClutterModel *model,
   iter = CLUTTER_MODEL_GET_CLASS (model)->insert_row (model, row);
   g_assert (CLUTTER_IS_MODEL_ITER (iter));
 
-  /* set_valist() will call clutter_model_resort() if one of the
-   * passed columns matches the model sorting column index
+  /* set_valist() will move the row to its sorted position if one of
+   * the passed columns matches the model sorting column index
    */
   va_start (args, row);
   clutter_model_iter_set_internal_valist (iter, args);
@@ -1336,7 +1456,7 @@ clutter_model_insertv (ClutterModel *model,
   g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
 
   if (resort)
-    clutter_model_resort (model);
+    clutter_model_resort_row (model, iter);
 
   g_object_unref (iter);
 }
@@ -1387,7 +1507,7 @@ clutter_model_insert_value (ClutterModel *model,
     g_signal_emit (model, model_signals[ROW_ADDED], 0, iter);
 
   if (priv->sort_column == column)
-    clutter_model_resort (model);
+    clutter_model_resort_row (model, iter);
 
   g_object_unref (iter);
 }
@@ -1769,6 +1889,7 @@ clutter_model_set_filter (ClutterModel           *model,
   priv->filter_func = func;
   priv->filter_data = user_data;
   priv->filter_notify = notify;
+  priv->filter_stamp += 1;
 
   g_signal_emit (model, model_signals[FILTER_CHANGED], 0);
   g_object_notify (G_OBJECT (model), "filter-set");
@@ -2099,7 +2220,7 @@ clutter_model_iter_set_internal_valist (ClutterModelIter *iter,
     }
 
   if (sort)
-    clutter_model_resort (model);
+    clutter_model_resort_row (model, iter);
 }
 
 static void inline
@@ -142,6 +142,10 @@ struct _ClutterModel
  *   of the model
  * @resort: virtual function for sorting the model using the passed
  *   sorting function
+ * @resort_row: virtual function for moving the row pointed by the
+ *   given iterator to its position according to the passed sorting
+ *   function, if the rest of the model is already sorted; if not
+ *   implemented, the whole model is sorted using @resort. Since: 1.26
  * @insert_row: virtual function for inserting a row at the given index
  *   and returning an iterator pointing to it; if the index is a negative
  *   integer, the row should be appended to the model
@@ -186,9 +190,14 @@ struct _ClutterModelClass
   void              (* sort_changed)    (ClutterModel     *model);
   void              (* filter_changed)  (ClutterModel     *model);
 
+  /*< public >*/
+  void              (* resort_row)      (ClutterModel         *model,
+                                         ClutterModelIter     *iter,
+                                         ClutterModelSortFunc  func,
+                                         gpointer              data);
+
   /*< private >*/
   /* padding for future expansion */
-  void (*_clutter_model_1) (void);
   void (*_clutter_model_2) (void);
   void (*_clutter_model_3) (void);
   void (*_clutter_model_4) (void);
@@ -290,6 +299,10 @@ gboolean              clutter_model_get_filter_set     (ClutterModel     *model)
 
 CLUTTER_DEPRECATED_IN_1_24_FOR(GListModel)
 void                  clutter_model_resort             (ClutterModel     *model);
+CLUTTER_AVAILABLE_IN_1_26
+void                  clutter_model_begin_update       (ClutterModel     *model);
+CLUTTER_AVAILABLE_IN_1_26
+void                  clutter_model_end_update         (ClutterModel     *model);
 CLUTTER_DEPRECATED_IN_1_24_FOR(GListModel)
 gboolean              clutter_model_filter_row         (ClutterModel     *model,
                                                         guint             row);
@@ -213,6 +213,9 @@ typedef struct State
                                   from other states to this one */
   GArray       *animators;     /* list of animators for transitioning from
                                 * specific source states */
+  GHashTable   *transitions;   /* the keys resolved for the transitions from
+                                  various source state names, built lazily
+                                  and cleared when the keys change */
   ClutterState *clutter_state; /* the ClutterState object this state belongs to
                                 */
 } State;
@@ -231,6 +234,8 @@ struct _ClutterStatePrivate
   State           *target_state;      /* target state name */
   ClutterAnimator *current_animator;  /* !NULL if the current transition is
                                          overriden by an animator */
+  GPtrArray       *current_keys;      /* the keys of the current transition,
+                                         owned by target_state */
 };
 
 #define SLAVE_TIMELINE_LENGTH 10000
@@ -405,6 +410,85 @@ clutter_state_key_free (gpointer clutter_state_key)
 }
 
 
+/*
+ * state_get_transition:
+ * @state: the target #State
+ * @source_state_name: the interned name of the source state, or %NULL
+ *
+ * Retrieves the keys animated when transitioning from @source_state_name
+ * to @state: for each object and property, the key specific to the
+ * source state if there is one, or the default key otherwise.
+ *
+ * The keys are resolved once and kept until the keys of @state change.
+ *
+ * Return value: (transfer none): an array of #ClutterStateKey
+ */
+static GPtrArray *
+state_get_transition (State       *state,
+                      const gchar *source_state_name)
+{
+  ClutterStateKey *chosen = NULL;
+  GObject *curobj = NULL;
+  const gchar *curprop = NULL;
+  GPtrArray *keys;
+  GList *k;
+
+  keys = g_hash_table_lookup (state->transitions, source_state_name);
+  if (keys != NULL)
+    return keys;
+
+  keys = g_ptr_array_new ();
+
+  /* the keys are sorted by object and property */
+  for (k = state->keys; k != NULL; k = k->next)
+    {
+      ClutterStateKey *key = k->data;
+
+      if (key->object != curobj || key->property_name != curprop)
+        {
+          if (chosen != NULL)
+            g_ptr_array_add (keys, chosen);
+
+          chosen = NULL;
+          curobj = key->object;
+          curprop = key->property_name;
+        }
+
+      if (key->source_state == NULL)
+        {
+          if (chosen == NULL)
+            chosen = key;
+        }
+      else if (key->source_state->name == source_state_name)
+        chosen = key;
+    }
+
+  if (chosen != NULL)
+    g_ptr_array_add (keys, chosen);
+
+  g_hash_table_insert (state->transitions, (gpointer) source_state_name, keys);
+
+  return keys;
+}
+
+/*
+ * state_keys_changed:
+ * @state: a #State
+ *
+ * Drops the transitions resolved for @state after its keys changed,
+ * and resolves the current transition again if @state is its target.
+ */
+static void
+state_keys_changed (State *state)
+{
+  ClutterStatePrivate *priv = state->clutter_state->priv;
+
+  g_hash_table_remove_all (state->transitions);
+
+  if (state == priv->target_state)
+    priv->current_keys = state_get_transition (state, priv->source_state_name);
+}
+
 static inline void
 clutter_state_remove_key_internal (ClutterState *this,
                                    const gchar  *source_state_name,
@@ -453,6 +537,7 @@ again_from_start:
                 {
                   /* Remove matching key */
                   target_state->keys = g_list_remove (target_state->keys, key);
+                  state_keys_changed (target_state);
                   key->is_inert = is_inert;
                   clutter_state_key_free (key);
 
@@ -499,6 +584,7 @@ state_free (gpointer data)
     clutter_state_key_free (state->keys->data);
 
   g_array_free (state->animators, TRUE);
+  g_hash_table_destroy (state->transitions);
   g_hash_table_destroy (state->durations);
   g_free (state);
 }
@@ -514,6 +600,9 @@ state_new (ClutterState *clutter_state,
   state->name = name;
   state->animators = g_array_new (TRUE, TRUE, sizeof (StateAnimator));
   state->durations = g_hash_table_new (g_direct_hash, g_direct_equal);
+  state->transitions = g_hash_table_new_full (NULL, NULL,
+                                              NULL,
+                                              (GDestroyNotify) g_ptr_array_unref);
 
   return state;
 }
@@ -552,94 +641,64 @@ clutter_state_new_frame (ClutterTimeline *timeline,
                          ClutterState    *state)
 {
   ClutterStatePrivate *priv = state->priv;
-  GList *k;
   gdouble progress;
-  const gchar *curprop = NULL;
-  GObject *curobj = NULL;
-  gboolean found_specific = FALSE;
+  guint i;
 
-  if (priv->current_animator)
+  if (priv->current_animator || priv->current_keys == NULL)
     return;
 
   progress = clutter_timeline_get_progress (timeline);
 
-  for (k = priv->target_state->keys; k; k = k->next)
+  for (i = 0; i < priv->current_keys->len; i++)
     {
-      ClutterStateKey *key = k->data;
+      ClutterStateKey *key = g_ptr_array_index (priv->current_keys, i);
+      gdouble pre_delay = key->pre_delay + key->pre_pre_delay;
       gdouble sub_progress;
 
-      if ((curprop && !(curprop == key->property_name)) ||
-          key->object != curobj)
-        {
-          curprop = key->property_name;
-          curobj = key->object;
-          found_specific = FALSE;
-        }
-
-      if (!found_specific)
-        {
-          if (key->source_state != NULL &&
-              key->source_state->name != NULL &&
-              priv->source_state_name != NULL && 
-              g_str_equal (priv->source_state_name, key->source_state->name))
-            {
-              found_specific = TRUE;
-            }
-
-          if (found_specific || key->source_state == NULL)
-            {
-              gdouble pre_delay = key->pre_delay + key->pre_pre_delay;
+      sub_progress = (progress - pre_delay)
+                   / (1.0 - (pre_delay + key->post_delay));
 
-              sub_progress = (progress - pre_delay)
-                           / (1.0 - (pre_delay + key->post_delay));
+      if (sub_progress < 0.0)
+        continue;
 
-              if (sub_progress >= 0.0)
-                {
-                  if (sub_progress >= 1.0)
-                    sub_progress = 1.0;
+      if (sub_progress >= 1.0)
+        sub_progress = 1.0;
 
-                  clutter_timeline_advance (priv->slave_timeline,
-                                            sub_progress * SLAVE_TIMELINE_LENGTH);
-                  sub_progress = clutter_alpha_get_alpha (key->alpha);
+      clutter_timeline_advance (priv->slave_timeline,
+                                sub_progress * SLAVE_TIMELINE_LENGTH);
+      sub_progress = clutter_alpha_get_alpha (key->alpha);
 
-                  if (key->is_animatable)
-                    {
-                      ClutterAnimatable *animatable;
-                      GValue value = G_VALUE_INIT;
-                      gboolean res;
+      if (key->is_animatable)
+        {
+          ClutterAnimatable *animatable;
+          GValue value = G_VALUE_INIT;
+          gboolean res;
 
-                      animatable = CLUTTER_ANIMATABLE (key->object);
+          animatable = CLUTTER_ANIMATABLE (key->object);
 
-                      g_value_init (&value, clutter_state_key_get_property_type (key));
+          g_value_init (&value, clutter_state_key_get_property_type (key));
 
-                      res =
-                        clutter_animatable_interpolate_value (animatable,
-                                                              key->property_name,
-                                                              key->interval,
-                                                              sub_progress,
-                                                              &value);
+          res =
+            clutter_animatable_interpolate_value (animatable,
+                                                  key->property_name,
+                                                  key->interval,
+                                                  sub_progress,
+                                                  &value);
 
-                      if (res)
-                        clutter_animatable_set_final_state (animatable,
-                                                            key->property_name,
-                                                            &value);
+          if (res)
+            clutter_animatable_set_final_state (animatable,
+                                                key->property_name,
+                                                &value);
 
-                      g_value_unset (&value);
-                    }
-                  else
-                    {
-                      const GValue *value;
-
-                      value = clutter_interval_compute (key->interval, sub_progress);
-                      if (value != NULL)
-                        g_object_set_property (key->object, key->property_name, value);
-                    }
-                }
+          g_value_unset (&value);
+        }
+      else
+        {
+          const GValue *value;
 
-              /* XXX: should the target value of the default destination be
-               * used even when found a specific source_state key?
-               */
-            }
+          value = clutter_interval_compute (key->interval, sub_progress);
+          if (value != NULL)
+            g_object_set_property (key->object, key->property_name, value);
         }
     }
 }
@@ -654,7 +713,7 @@ clutter_state_change (ClutterState *state,
   ClutterAnimator     *animator;
   State               *new_state;
   guint                duration;
-  GList               *k;
+  guint                i;
 
   g_return_val_if_fail (CLUTTER_IS_STATE (state), NULL);
 
@@ -671,6 +730,7 @@ clutter_state_change (ClutterState *state,
 
       priv->source_state_name = priv->target_state_name = NULL;
       priv->source_state = priv->target_state = NULL;
+      priv->current_keys = NULL;
 
       clutter_timeline_stop (priv->timeline);
       clutter_timeline_rewind (priv->timeline);
@@ -724,6 +784,8 @@ clutter_state_change (ClutterState *state,
                                          priv->source_state_name,
                                          priv->target_state_name);
   priv->target_state = new_state;
+  priv->current_keys = state_get_transition (new_state,
+                                             priv->source_state_name);
 
   if (animator == NULL && new_state->keys == NULL)
     animator = clutter_state_get_animator (state, NULL,
@@ -737,9 +799,9 @@ clutter_state_change (ClutterState *state,
     }
   else
     {
-      for (k = new_state->keys; k != NULL; k = k->next)
+      for (i = 0; i < priv->current_keys->len; i++)
         {
-          ClutterStateKey *key = k->data;
+          ClutterStateKey *key = g_ptr_array_index (priv->current_keys, i);
           GValue initial = G_VALUE_INIT;
 
           /* Reset the pre-pre-delay - this is only used for setting keys
@@ -1085,6 +1147,8 @@ clutter_state_set_key_internal (ClutterState    *state,
                                              key,
                                              sort_props_func);
 
+  state_keys_changed (target_state);
+
   /* If the current target state is modified, we have some work to do.
    *
    * If the animation is running, we add a key to the current animation
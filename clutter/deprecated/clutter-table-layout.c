@@ -77,6 +77,7 @@
 #endif
 
 #include <math.h>
+#include <string.h>
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 #include "deprecated/clutter-container.h"
@@ -104,6 +105,7 @@ typedef struct _DimensionData {
 
   guint expand  : 1;
   guint visible : 1;
+  guint dirty   : 1;
 } DimensionData;
 
 struct _ClutterTableLayoutPrivate
@@ -123,11 +125,24 @@ struct _ClutterTableLayoutPrivate
   GArray *columns;
   GArray *rows;
 
+  /* the requests of the children spanning a single column or row,
+   * kept for each line until one of its children changes; the
+   * row requests depend on the final widths of the columns they
+   * were computed for
+   */
+  GArray *col_requests;
+  GArray *row_requests;
+  GArray *row_requests_widths;
+
   gulong easing_mode;
   guint easing_duration;
 
   guint is_animating   : 1;
   guint use_animations : 1;
+
+  guint lines_valid        : 1;
+  guint col_requests_dirty : 1;
+  guint row_requests_dirty : 1;
 };
 
 struct _ClutterTableChild
@@ -182,6 +197,12 @@ G_DEFINE_TYPE (ClutterTableChild, clutter_table_child, CLUTTER_TYPE_LAYOUT_META)
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterTableLayout, clutter_table_layout, CLUTTER_TYPE_LAYOUT_MANAGER)
 
+static void clutter_table_layout_invalidate_lines (ClutterTableLayout *self);
+static void clutter_table_layout_invalidate_child (ClutterTableLayout *self,
+                                                   ClutterTableChild  *meta,
+                                                   gboolean            columns,
+                                                   gboolean            rows);
+
 /*
  * ClutterBoxChild
  */
@@ -212,6 +233,7 @@ table_child_set_position (ClutterTableChild *self,
       ClutterLayoutManager *layout;
 
       layout = clutter_layout_meta_get_manager (CLUTTER_LAYOUT_META (self));
+      clutter_table_layout_invalidate_lines (CLUTTER_TABLE_LAYOUT (layout));
       clutter_layout_manager_layout_changed (layout);
 
       g_object_freeze_notify (G_OBJECT (self));
@@ -252,6 +274,7 @@ table_child_set_span (ClutterTableChild  *self,
       ClutterLayoutManager *layout;
 
       layout = clutter_layout_meta_get_manager (CLUTTER_LAYOUT_META (self));
+      clutter_table_layout_invalidate_lines (CLUTTER_TABLE_LAYOUT (layout));
       clutter_layout_manager_layout_changed (layout);
 
       if (row_changed)
@@ -374,6 +397,10 @@ table_child_set_expand (ClutterTableChild *self,
       ClutterLayoutManager *layout;
 
       layout = clutter_layout_meta_get_manager (CLUTTER_LAYOUT_META (self));
+      clutter_table_layout_invalidate_child (CLUTTER_TABLE_LAYOUT (layout),
+                                             self,
+                                             x_changed,
+                                             y_changed);
       clutter_layout_manager_layout_changed (layout);
 
       g_object_freeze_notify (G_OBJECT (self));
@@ -642,15 +669,150 @@ clutter_table_layout_get_child_meta_type (ClutterLayoutManager *manager)
   return CLUTTER_TYPE_TABLE_CHILD;
 }
 
+/* Marks the number of lines as changed, which resets the requests
+ * of every line.
+ */
+static void
+clutter_table_layout_invalidate_lines (ClutterTableLayout *self)
+{
+  self->priv->lines_valid = FALSE;
+}
+
+static void
+invalidate_requests (GArray   *requests,
+                     gint      start,
+                     gint      span)
+{
+  DimensionData *lines = (DimensionData *) (void *) requests->data;
+  gint i;
+
+  for (i = MAX (start, 0); i < start + span && i < (gint) requests->len; i++)
+    lines[i].dirty = TRUE;
+}
+
+/* Marks the columns and rows spanned by the child of @meta as changed,
+ * so that only their requests are computed again.
+ */
+static void
+clutter_table_layout_invalidate_child (ClutterTableLayout *self,
+                                       ClutterTableChild  *meta,
+                                       gboolean            columns,
+                                       gboolean            rows)
+{
+  ClutterTableLayoutPrivate *priv = self->priv;
+
+  if (!priv->lines_valid)
+    return;
+
+  if (columns)
+    {
+      invalidate_requests (priv->col_requests, meta->col, meta->col_span);
+      priv->col_requests_dirty = TRUE;
+    }
+
+  if (rows)
+    {
+      invalidate_requests (priv->row_requests, meta->row, meta->row_span);
+      priv->row_requests_dirty = TRUE;
+    }
+}
+
+static void
+on_child_changed (ClutterActor       *child,
+                  ClutterTableLayout *self)
+{
+  ClutterLayoutManager *manager = CLUTTER_LAYOUT_MANAGER (self);
+  ClutterLayoutMeta *meta;
+
+  if (!self->priv->lines_valid)
+    return;
+
+  meta = clutter_layout_manager_get_child_meta (manager,
+                                                self->priv->container,
+                                                child);
+  if (meta == NULL)
+    return;
+
+  clutter_table_layout_invalidate_child (self, CLUTTER_TABLE_CHILD (meta),
+                                         TRUE,
+                                         TRUE);
+}
+
+static void
+on_child_visible_changed (ClutterActor       *child,
+                          GParamSpec         *pspec,
+                          ClutterTableLayout *self)
+{
+  on_child_changed (child, self);
+}
+
+static void
+on_actor_added (ClutterContainer   *container,
+                ClutterActor       *child,
+                ClutterTableLayout *self)
+{
+  g_signal_connect (child, "queue-relayout",
+                    G_CALLBACK (on_child_changed),
+                    self);
+  g_signal_connect (child, "notify::visible",
+                    G_CALLBACK (on_child_visible_changed),
+                    self);
+
+  clutter_table_layout_invalidate_lines (self);
+}
+
+static void
+on_actor_removed (ClutterContainer   *container,
+                  ClutterActor       *child,
+                  ClutterTableLayout *self)
+{
+  g_signal_handlers_disconnect_by_func (child, on_child_changed, self);
+  g_signal_handlers_disconnect_by_func (child, on_child_visible_changed, self);
+
+  clutter_table_layout_invalidate_lines (self);
+}
+
 static void
 clutter_table_layout_set_container (ClutterLayoutManager *layout,
                                     ClutterContainer     *container)
 {
-  ClutterTableLayoutPrivate *priv = CLUTTER_TABLE_LAYOUT (layout)->priv;
+  ClutterTableLayout *self = CLUTTER_TABLE_LAYOUT (layout);
+  ClutterTableLayoutPrivate *priv = self->priv;
+  ClutterActorIter iter;
+  ClutterActor *child;
+
+  if (priv->container != NULL)
+    {
+      clutter_actor_iter_init (&iter, CLUTTER_ACTOR (priv->container));
+      while (clutter_actor_iter_next (&iter, &child))
+        on_actor_removed (priv->container, child, self);
+
+      g_signal_handlers_disconnect_by_func (priv->container,
+                                            on_actor_added,
+                                            self);
+      g_signal_handlers_disconnect_by_func (priv->container,
+                                            on_actor_removed,
+                                            self);
+    }
 
   priv->container = container;
-}
 
+  clutter_table_layout_invalidate_lines (self);
+
+  if (priv->container != NULL)
+    {
+      clutter_actor_iter_init (&iter, CLUTTER_ACTOR (priv->container));
+      while (clutter_actor_iter_next (&iter, &child))
+        on_actor_added (priv->container, child, self);
+
+      g_signal_connect (priv->container, "actor-added",
+                        G_CALLBACK (on_actor_added),
+                        self);
+      g_signal_connect (priv->container, "actor-removed",
+                        G_CALLBACK (on_actor_removed),
+                        self);
+    }
+}
 
 static void
 update_row_col (ClutterTableLayout *layout,
@@ -661,6 +823,9 @@ update_row_col (ClutterTableLayout *layout,
   ClutterActor *actor, *child;
   gint n_cols, n_rows;
 
+  if (priv->lines_valid)
+    return;
+
   n_cols = n_rows = 0;
 
   if (container == NULL)
@@ -686,43 +851,77 @@ out:
   priv->n_cols = n_cols;
   priv->n_rows = n_rows;
 
+  /* every line has to be requested again */
+  g_array_set_size (priv->col_requests, 0);
+  g_array_set_size (priv->col_requests, n_cols);
+  invalidate_requests (priv->col_requests, 0, n_cols);
+  priv->col_requests_dirty = TRUE;
+
+  g_array_set_size (priv->row_requests, 0);
+  g_array_set_size (priv->row_requests, n_rows);
+  invalidate_requests (priv->row_requests, 0, n_rows);
+  priv->row_requests_dirty = TRUE;
+
+  priv->lines_valid = TRUE;
 }
 
+/* Computes the requests of the lines marked as dirty from the children
+ * spanning only one of them; the requests of the other lines are kept.
+ */
 static void
-calculate_col_widths (ClutterTableLayout *self,
+update_line_requests (ClutterTableLayout *self,
                       ClutterContainer   *container,
-                      gint                for_width)
+                      ClutterOrientation  orientation)
 {
   ClutterTableLayoutPrivate *priv = self->priv;
   ClutterLayoutManager *manager = CLUTTER_LAYOUT_MANAGER (self);
+  DimensionData *lines, *columns;
   ClutterActor *actor, *child;
+  GArray *requests;
   gint i;
-  DimensionData *columns;
-  ClutterOrientation orientation = CLUTTER_ORIENTATION_HORIZONTAL;
 
-  update_row_col (self, container);
-  g_array_set_size (priv->columns, 0);
-  g_array_set_size (priv->columns, priv->n_cols);
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      if (!priv->col_requests_dirty)
+        return;
+
+      requests = priv->col_requests;
+      priv->col_requests_dirty = FALSE;
+    }
+  else
+    {
+      if (!priv->row_requests_dirty)
+        return;
+
+      requests = priv->row_requests;
+      priv->row_requests_dirty = FALSE;
+    }
+
+  lines = (DimensionData *) (void *) requests->data;
   columns = (DimensionData *) (void *) priv->columns->data;
 
-  /* reset the visibility of all columns */
-  priv->visible_cols = 0;
-  for (i = 0; i < priv->n_cols; i++)
+  for (i = 0; i < (gint) requests->len; i++)
     {
-      columns[i].expand = FALSE;
-      columns[i].visible = FALSE;
+      if (lines[i].dirty)
+        {
+          lines[i].min_size = 0;
+          lines[i].pref_size = 0;
+          lines[i].final_size = 0;
+          lines[i].expand = FALSE;
+          lines[i].visible = FALSE;
+        }
     }
 
   actor = CLUTTER_ACTOR (container);
 
-  /* STAGE ONE: calculate column widths for non-spanned children */
   for (child = clutter_actor_get_first_child (actor);
        child != NULL;
        child = clutter_actor_get_next_sibling (child))
     {
       ClutterTableChild *meta;
-      DimensionData *col;
+      DimensionData *line;
       gfloat c_min, c_pref;
+      gboolean expand;
 
       if (!clutter_actor_is_visible (child))
         continue;
@@ -732,29 +931,93 @@ calculate_col_widths (ClutterTableLayout *self,
                                                                     container,
                                                                     child));
 
-      if (meta->col_span > 1)
-        continue;
+      if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+        {
+          if (meta->col_span > 1)
+            continue;
 
-      col = &columns[meta->col];
+          line = &lines[meta->col];
+          if (!line->dirty)
+            continue;
 
-      if (!col->visible)
+          clutter_actor_get_preferred_width (child, -1, &c_min, &c_pref);
+          expand = meta->x_expand;
+        }
+      else
         {
-          col->visible = TRUE;
-          priv->visible_cols += 1;
+          if (meta->row_span > 1)
+            continue;
+
+          line = &lines[meta->row];
+          if (!line->dirty)
+            continue;
+
+          clutter_actor_get_preferred_height (child,
+                                              columns[meta->col].final_size,
+                                              &c_min, &c_pref);
+          expand = meta->y_expand;
         }
 
-      clutter_actor_get_preferred_width (child, -1, &c_min, &c_pref);
+      line->visible = TRUE;
+      line->min_size = MAX (line->min_size, c_min);
+      line->pref_size = MAX (line->pref_size, c_pref);
 
-      col->min_size = MAX (col->min_size, c_min);
-      col->pref_size = MAX (col->pref_size, c_pref);
+      if (!line->expand)
+        line->expand = clutter_actor_needs_expand (child, orientation) || expand;
+    }
 
-      if (!col->expand)
-        {
-          col->expand = clutter_actor_needs_expand (child, orientation) ||
-            meta->x_expand;
-        }
+  for (i = 0; i < (gint) requests->len; i++)
+    lines[i].dirty = FALSE;
+}
+
+/* Copies the requests of the lines into @lines, returning the number
+ * of visible lines.
+ */
+static gint
+copy_line_requests (GArray *lines,
+                    GArray *requests)
+{
+  DimensionData *data;
+  gint i, n_visible = 0;
+
+  g_array_set_size (lines, requests->len);
+
+  if (requests->len == 0)
+    return 0;
+
+  memcpy (lines->data, requests->data, requests->len * sizeof (DimensionData));
+
+  data = (DimensionData *) (void *) lines->data;
+  for (i = 0; i < (gint) lines->len; i++)
+    {
+      if (data[i].visible)
+        n_visible += 1;
     }
 
+  return n_visible;
+}
+
+static void
+calculate_col_widths (ClutterTableLayout *self,
+                      ClutterContainer   *container,
+                      gint                for_width)
+{
+  ClutterTableLayoutPrivate *priv = self->priv;
+  ClutterLayoutManager *manager = CLUTTER_LAYOUT_MANAGER (self);
+  ClutterActor *actor, *child;
+  gint i;
+  DimensionData *columns;
+  ClutterOrientation orientation = CLUTTER_ORIENTATION_HORIZONTAL;
+
+  update_row_col (self, container);
+
+  /* STAGE ONE: calculate column widths for non-spanned children */
+  update_line_requests (self, container, orientation);
+  priv->visible_cols = copy_line_requests (priv->columns, priv->col_requests);
+  columns = (DimensionData *) (void *) priv->columns->data;
+
+  actor = CLUTTER_ACTOR (container);
+
   /* STAGE TWO: take spanning children into account */
   for (child = clutter_actor_get_first_child (actor);
        child != NULL;
@@ -976,62 +1239,31 @@ calculate_row_heights (ClutterTableLayout *self,
   ClutterOrientation orientation = CLUTTER_ORIENTATION_VERTICAL;
 
   update_row_col (self, container);
-  g_array_set_size (priv->rows, 0);
-  g_array_set_size (priv->rows, self->priv->n_rows);
 
-  rows = (DimensionData *) (void *) priv->rows->data;
   columns = (DimensionData *) (void *) priv->columns->data;
 
-  /* reset the visibility of all rows */
-  priv->visible_rows = 0;
-  for (i = 0; i < priv->n_rows; i++)
-    {
-      rows[i].expand = FALSE;
-      rows[i].visible = FALSE;
-    }
-
-  actor = CLUTTER_ACTOR (container);
-
-  /* STAGE ONE: calculate row heights for non-spanned children */
-  for (child = clutter_actor_get_first_child (actor);
-       child != NULL;
-       child = clutter_actor_get_next_sibling (child))
+  /* the heights of the rows depend on the widths of the columns */
+  for (i = 0; i < priv->n_cols; i++)
     {
-      ClutterTableChild *meta;
-      DimensionData *row;
-      gfloat c_min, c_pref;
-
-      if (!clutter_actor_is_visible (child))
-        continue;
-
-      meta =
-        CLUTTER_TABLE_CHILD (clutter_layout_manager_get_child_meta (manager,
-                                                                    container,
-                                                                    child));
-
-      if (meta->row_span > 1)
-        continue;
-
-      row = &rows[meta->row];
-
-      if (!row->visible)
+      if (i >= (gint) priv->row_requests_widths->len ||
+          g_array_index (priv->row_requests_widths, gfloat, i) != columns[i].final_size)
         {
-          row->visible = TRUE;
-          priv->visible_rows += 1;
+          invalidate_requests (priv->row_requests, 0, priv->n_rows);
+          priv->row_requests_dirty = TRUE;
+          break;
         }
+    }
 
-      clutter_actor_get_preferred_height (child, columns[meta->col].final_size,
-                                          &c_min, &c_pref);
+  g_array_set_size (priv->row_requests_widths, priv->n_cols);
+  for (i = 0; i < priv->n_cols; i++)
+    g_array_index (priv->row_requests_widths, gfloat, i) = columns[i].final_size;
 
-      row->min_size = MAX (row->min_size, c_min);
-      row->pref_size = MAX (row->pref_size, c_pref);
+  /* STAGE ONE: calculate row heights for non-spanned children */
+  update_line_requests (self, container, orientation);
+  priv->visible_rows = copy_line_requests (priv->rows, priv->row_requests);
+  rows = (DimensionData *) (void *) priv->rows->data;
 
-      if (!row->expand)
-        {
-          row->expand = clutter_actor_needs_expand (child, orientation) ||
-            meta->y_expand;
-        }
-    }
+  actor = CLUTTER_ACTOR (container);
 
   /* STAGE TWO: take spanning children into account */
   for (child = clutter_actor_get_first_child (actor);
@@ -1284,7 +1516,8 @@ clutter_table_layout_get_preferred_width (ClutterLayoutManager *layout,
       return;
     }
 
-  calculate_table_dimensions (self, container, -1, for_height);
+  /* the width of the columns does not depend on the rows */
+  calculate_col_widths (self, container, -1);
   columns = (DimensionData *) (void *) priv->columns->data;
 
   total_min_width = MAX ((priv->visible_cols - 1) * (float) priv->col_spacing, 0);
@@ -1588,6 +1821,9 @@ clutter_table_layout_finalize (GObject *gobject)
 
   g_array_free (priv->columns, TRUE);
   g_array_free (priv->rows, TRUE);
+  g_array_free (priv->col_requests, TRUE);
+  g_array_free (priv->row_requests, TRUE);
+  g_array_free (priv->row_requests_widths, TRUE);
 
   G_OBJECT_CLASS (clutter_table_layout_parent_class)->finalize (gobject);
 }
@@ -1734,6 +1970,9 @@ clutter_table_layout_init (ClutterTableLayout *layout)
 
   priv->columns = g_array_new (FALSE, TRUE, sizeof (DimensionData));
   priv->rows = g_array_new (FALSE, TRUE, sizeof (DimensionData));
+  priv->col_requests = g_array_new (FALSE, TRUE, sizeof (DimensionData));
+  priv->row_requests = g_array_new (FALSE, TRUE, sizeof (DimensionData));
+  priv->row_requests_widths = g_array_new (FALSE, TRUE, sizeof (gfloat));
 }
 
 /**
@@ -38,6 +38,7 @@
 #include <unistd.h>
 
 #include <glib.h>
+#include <glib-unix.h>
 #include <libinput.h>
 
 #include "clutter-backend.h"
@@ -72,6 +73,8 @@ struct _ClutterTouchState
 {
   guint32 id;
   ClutterPoint coords;
+
+  guint active : 1;
 };
 
 struct _ClutterSeatEvdev
@@ -84,7 +87,10 @@ struct _ClutterSeatEvdev
   ClutterInputDevice *core_pointer;
   ClutterInputDevice *core_keyboard;
 
-  GHashTable *touches;
+  /* the touch points, indexed by their seat slot, which is also
+   * the slot of their sequence in the core pointer
+   */
+  ClutterTouchState touches[CLUTTER_INPUT_DEVICE_N_TOUCH_SLOTS];
 
   struct xkb_state *xkb;
   xkb_led_index_t caps_lock_led;
@@ -142,6 +148,22 @@ struct _ClutterDeviceManagerEvdevPrivate
   guint stage_removed_handler;
 
   GSList *event_filters;
+
+  /* held while using libinput, which the input thread shares with
+   * the main thread
+   */
+  GRecMutex libinput_lock;
+
+  /* the optional thread reading the input devices */
+  GThread *input_thread;
+  GMainContext *input_context;
+  GMainLoop *input_loop;
+
+  /* written by the input thread to wake up the main loop, once per
+   * batch of libinput events
+   */
+  int wakeup_fds[2];
+  gint wakeup_pending;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterDeviceManagerEvdev,
@@ -151,6 +173,10 @@ G_DEFINE_TYPE_WITH_PRIVATE (ClutterDeviceManagerEvdev,
 static ClutterOpenDeviceCallback  device_open_callback;
 static ClutterCloseDeviceCallback device_close_callback;
 static gpointer                   device_callback_data;
+static gboolean                   use_input_thread = FALSE;
+
+/* the time of the libinput event being translated, in microseconds */
+static gint64                     current_hardware_time = 0;
 
 #ifdef CLUTTER_ENABLE_DEBUG
 static const char *device_type_str[] = {
@@ -228,6 +254,10 @@ clutter_event_check (GSource *source)
 static void
 queue_event (ClutterEvent *event)
 {
+  /* the key repeats are not reported by the devices */
+  if (current_hardware_time != 0)
+    clutter_event_set_hardware_time (event, current_hardware_time);
+
   _clutter_event_push (event, FALSE);
 }
 
@@ -759,8 +789,128 @@ dispatch_libinput (ClutterDeviceManagerEvdev *manager_evdev)
 {
   ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
 
-  libinput_dispatch (priv->libinput);
+  g_rec_mutex_lock (&priv->libinput_lock);
+
+  /* the input thread reads the devices on its own, so we only need
+   * to translate what it queued
+   */
+  if (priv->input_thread == NULL)
+    libinput_dispatch (priv->libinput);
+
   process_events (manager_evdev);
+
+  g_rec_mutex_unlock (&priv->libinput_lock);
+}
+
+static void
+clear_wakeup (ClutterDeviceManagerEvdev *manager_evdev)
+{
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
+  char buf[64];
+
+  while (read (priv->wakeup_fds[0], buf, sizeof (buf)) > 0)
+    ;
+
+  /* reset before translating the events, so that the events read
+   * from now on will wake us up again
+   */
+  g_atomic_int_set (&priv->wakeup_pending, 0);
+}
+
+static gboolean
+input_thread_dispatch (gint          fd,
+                       GIOCondition  condition,
+                       gpointer      user_data)
+{
+  ClutterDeviceManagerEvdev *manager_evdev = user_data;
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
+  gboolean has_events;
+
+  g_rec_mutex_lock (&priv->libinput_lock);
+
+  libinput_dispatch (priv->libinput);
+  has_events = libinput_next_event_type (priv->libinput) != LIBINPUT_EVENT_NONE;
+
+  g_rec_mutex_unlock (&priv->libinput_lock);
+
+  /* the main loop only needs to be woken up once until it handles
+   * the events queued so far
+   */
+  if (has_events &&
+      g_atomic_int_compare_and_exchange (&priv->wakeup_pending, 0, 1))
+    {
+      /* a full pipe already wakes up the main loop */
+      if (write (priv->wakeup_fds[1], "", 1) < 0 && errno != EAGAIN)
+        g_warning ("Unable to wake up the main loop: %s", g_strerror (errno));
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gpointer
+input_thread_func (gpointer data)
+{
+  ClutterDeviceManagerEvdev *manager_evdev = data;
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
+
+  g_main_context_push_thread_default (priv->input_context);
+  g_main_loop_run (priv->input_loop);
+  g_main_context_pop_thread_default (priv->input_context);
+
+  return NULL;
+}
+
+static gboolean
+input_thread_start (ClutterDeviceManagerEvdev *manager_evdev)
+{
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
+  GError *error = NULL;
+  GSource *source;
+
+  if (!g_unix_open_pipe (priv->wakeup_fds, FD_CLOEXEC, &error) ||
+      !g_unix_set_fd_nonblocking (priv->wakeup_fds[0], TRUE, &error) ||
+      !g_unix_set_fd_nonblocking (priv->wakeup_fds[1], TRUE, &error))
+    {
+      g_warning ("Unable to create the input thread: %s", error->message);
+      g_error_free (error);
+      return FALSE;
+    }
+
+  priv->input_context = g_main_context_new ();
+  priv->input_loop = g_main_loop_new (priv->input_context, FALSE);
+
+  source = g_unix_fd_source_new (libinput_get_fd (priv->libinput), G_IO_IN);
+  g_source_set_callback (source, (GSourceFunc) input_thread_dispatch,
+                         manager_evdev,
+                         NULL);
+  g_source_attach (source, priv->input_context);
+  g_source_unref (source);
+
+  priv->input_thread = g_thread_new ("clutter-input", input_thread_func,
+                                     manager_evdev);
+
+  CLUTTER_NOTE (EVENT, "Reading the input devices from a thread");
+
+  return TRUE;
+}
+
+static void
+input_thread_stop (ClutterDeviceManagerEvdev *manager_evdev)
+{
+  ClutterDeviceManagerEvdevPrivate *priv = manager_evdev->priv;
+
+  if (priv->input_thread == NULL)
+    return;
+
+  g_main_loop_quit (priv->input_loop);
+  g_thread_join (priv->input_thread);
+  priv->input_thread = NULL;
+
+  g_main_loop_unref (priv->input_loop);
+  g_main_context_unref (priv->input_context);
+
+  /* the read end belongs to the event source */
+  close (priv->wakeup_fds[1]);
 }
 
 static gboolean
@@ -781,6 +931,9 @@ clutter_event_dispatch (GSource     *g_source,
   if (clutter_events_pending ())
     goto queue_event;
 
+  if (manager_evdev->priv->input_thread != NULL)
+    clear_wakeup (manager_evdev);
+
   dispatch_libinput (manager_evdev);
 
  queue_event:
@@ -836,7 +989,11 @@ clutter_event_source_new (ClutterDeviceManagerEvdev *manager_evdev)
   /* setup the source */
   event_source->manager_evdev = manager_evdev;
 
-  fd = libinput_get_fd (priv->libinput);
+  if (priv->input_thread != NULL)
+    fd = priv->wakeup_fds[0];
+  else
+    fd = libinput_get_fd (priv->libinput);
+
   event_source->event_poll_fd.fd = fd;
   event_source->event_poll_fd.events = G_IO_IN;
 
@@ -864,12 +1021,6 @@ clutter_event_source_free (ClutterEventSource *source)
   g_source_unref (g_source);
 }
 
-static void
-clutter_touch_state_free (ClutterTouchState *touch_state)
-{
-  g_slice_free (ClutterTouchState, touch_state);
-}
-
 static void
 clutter_seat_evdev_set_libinput_seat (ClutterSeatEvdev *seat,
                                       struct libinput_seat *libinput_seat)
@@ -913,9 +1064,6 @@ clutter_seat_evdev_new (ClutterDeviceManagerEvdev *manager_evdev)
   _clutter_device_manager_add_device (manager, device);
   seat->core_keyboard = device;
 
-  seat->touches = g_hash_table_new_full (NULL, NULL, NULL,
-                                         (GDestroyNotify) clutter_touch_state_free);
-
   ctx = xkb_context_new(0);
   g_assert (ctx);
 
@@ -961,7 +1109,6 @@ clutter_seat_evdev_free (ClutterSeatEvdev *seat)
       g_object_unref (device);
     }
   g_slist_free (seat->devices);
-  g_hash_table_unref (seat->touches);
 
   xkb_state_unref (seat->xkb);
 
@@ -1160,6 +1307,7 @@ clutter_seat_evdev_sync_leds (ClutterSeatEvdev *seat)
   ClutterInputDeviceEvdev *device_evdev;
   int caps_lock, num_lock, scroll_lock;
   enum libinput_led leds = 0;
+  ClutterDeviceManagerEvdevPrivate *priv = seat->manager_evdev->priv;
 
   caps_lock = xkb_state_led_index_is_active (seat->xkb, seat->caps_lock_led);
   num_lock = xkb_state_led_index_is_active (seat->xkb, seat->num_lock_led);
@@ -1172,11 +1320,15 @@ clutter_seat_evdev_sync_leds (ClutterSeatEvdev *seat)
   if (scroll_lock)
     leds |= LIBINPUT_LED_SCROLL_LOCK;
 
+  g_rec_mutex_lock (&priv->libinput_lock);
+
   for (iter = seat->devices; iter; iter = iter->next)
     {
       device_evdev = iter->data;
       _clutter_input_device_evdev_update_leds (device_evdev, leds);
     }
+
+  g_rec_mutex_unlock (&priv->libinput_lock);
 }
 
 static void
@@ -1227,43 +1379,55 @@ process_base_event (ClutterDeviceManagerEvdev *manager_evdev,
   return handled;
 }
 
+static ClutterTouchState *_device_seat_get_touch (ClutterInputDevice *input_device,
+                                                  gint32              id);
+
 static ClutterTouchState *
 _device_seat_add_touch (ClutterInputDevice *input_device,
-                        guint32             id)
+                        gint32              id)
 {
   ClutterInputDeviceEvdev *device_evdev =
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
   ClutterTouchState *touch;
 
-  touch = g_slice_new0 (ClutterTouchState);
-  touch->id = id;
+  /* the touch points beyond the slot table are ignored */
+  if (id < 0 || (guint) id >= G_N_ELEMENTS (seat->touches))
+    {
+      CLUTTER_NOTE (EVENT, "Ignoring touch point in seat slot %d", id);
+      return NULL;
+    }
 
-  g_hash_table_insert (seat->touches, GUINT_TO_POINTER (id), touch);
+  touch = &seat->touches[id];
+  touch->id = id;
+  touch->active = TRUE;
 
   return touch;
 }
 
 static void
 _device_seat_remove_touch (ClutterInputDevice *input_device,
-                           guint32             id)
+                           gint32              id)
 {
-  ClutterInputDeviceEvdev *device_evdev =
-    CLUTTER_INPUT_DEVICE_EVDEV (input_device);
-  ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
+  ClutterTouchState *touch = _device_seat_get_touch (input_device, id);
 
-  g_hash_table_remove (seat->touches, GUINT_TO_POINTER (id));
+  if (touch != NULL)
+    touch->active = FALSE;
 }
 
 static ClutterTouchState *
 _device_seat_get_touch (ClutterInputDevice *input_device,
-                        guint32             id)
+                        gint32              id)
 {
   ClutterInputDeviceEvdev *device_evdev =
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
 
-  return g_hash_table_lookup (seat->touches, GUINT_TO_POINTER (id));
+  if (id < 0 || (guint) id >= G_N_ELEMENTS (seat->touches) ||
+      !seat->touches[id].active)
+    return NULL;
+
+  return &seat->touches[id];
 }
 
 static void
@@ -1299,6 +1463,40 @@ check_notify_discrete_scroll (ClutterDeviceManagerEvdev *manager_evdev,
   seat->accum_scroll_dy = fmodf (seat->accum_scroll_dy, DISCRETE_SCROLL_STEP);
 }
 
+/* libinput uses CLOCK_MONOTONIC, like g_get_monotonic_time() */
+static gint64
+get_event_time_usec (struct libinput_event *event)
+{
+  switch (libinput_event_get_type (event))
+    {
+    case LIBINPUT_EVENT_KEYBOARD_KEY:
+      return libinput_event_keyboard_get_time_usec (libinput_event_get_keyboard_event (event));
+
+    case LIBINPUT_EVENT_POINTER_MOTION:
+    case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+    case LIBINPUT_EVENT_POINTER_BUTTON:
+    case LIBINPUT_EVENT_POINTER_AXIS:
+      return libinput_event_pointer_get_time_usec (libinput_event_get_pointer_event (event));
+
+    case LIBINPUT_EVENT_TOUCH_DOWN:
+    case LIBINPUT_EVENT_TOUCH_UP:
+    case LIBINPUT_EVENT_TOUCH_MOTION:
+    case LIBINPUT_EVENT_TOUCH_CANCEL:
+      return libinput_event_touch_get_time_usec (libinput_event_get_touch_event (event));
+
+    case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+    case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+    case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+    case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+    case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+    case LIBINPUT_EVENT_GESTURE_PINCH_END:
+      return libinput_event_gesture_get_time_usec (libinput_event_get_gesture_event (event));
+
+    default:
+      return 0;
+    }
+}
+
 static gboolean
 process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
                       struct libinput_event *event)
@@ -1491,7 +1689,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         stage_width = clutter_actor_get_width (CLUTTER_ACTOR (stage));
         stage_height = clutter_actor_get_height (CLUTTER_ACTOR (stage));
 
-        slot = libinput_event_touch_get_slot (touch_event);
+        slot = libinput_event_touch_get_seat_slot (touch_event);
         time = libinput_event_touch_get_time (touch_event);
         x = libinput_event_touch_get_x_transformed (touch_event,
                                                     stage_width);
@@ -1499,6 +1697,9 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
                                                     stage_height);
 
         touch_state = _device_seat_add_touch (device, slot);
+        if (touch_state == NULL)
+          break;
+
         touch_state->coords.x = x;
         touch_state->coords.y = y;
 
@@ -1516,9 +1717,11 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
           libinput_event_get_touch_event (event);
         device = libinput_device_get_user_data (libinput_device);
 
-        slot = libinput_event_touch_get_slot (touch_event);
+        slot = libinput_event_touch_get_seat_slot (touch_event);
         time = libinput_event_touch_get_time (touch_event);
         touch_state = _device_seat_get_touch (device, slot);
+        if (touch_state == NULL)
+          break;
 
         notify_touch_event (device, CLUTTER_TOUCH_END, time, slot,
 			    touch_state->coords.x, touch_state->coords.y);
@@ -1546,7 +1749,7 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         stage_width = clutter_actor_get_width (CLUTTER_ACTOR (stage));
         stage_height = clutter_actor_get_height (CLUTTER_ACTOR (stage));
 
-        slot = libinput_event_touch_get_slot (touch_event);
+        slot = libinput_event_touch_get_seat_slot (touch_event);
         time = libinput_event_touch_get_time (touch_event);
         x = libinput_event_touch_get_x_transformed (touch_event,
                                                     stage_width);
@@ -1554,6 +1757,9 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
                                                     stage_height);
 
         touch_state = _device_seat_get_touch (device, slot);
+        if (touch_state == NULL)
+          break;
+
         touch_state->coords.x = x;
         touch_state->coords.y = y;
 
@@ -1564,23 +1770,26 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     case LIBINPUT_EVENT_TOUCH_CANCEL:
       {
         ClutterTouchState *touch_state;
-        GHashTableIter iter;
         guint32 time;
         struct libinput_event_touch *touch_event =
           libinput_event_get_touch_event (event);
         ClutterSeatEvdev *seat;
+        guint i;
 
         device = libinput_device_get_user_data (libinput_device);
         time = libinput_event_touch_get_time (touch_event);
         seat = _clutter_input_device_evdev_get_seat (CLUTTER_INPUT_DEVICE_EVDEV (device));
-        g_hash_table_iter_init (&iter, seat->touches);
 
-        while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &touch_state))
+        for (i = 0; i < G_N_ELEMENTS (seat->touches); i++)
           {
+            touch_state = &seat->touches[i];
+            if (!touch_state->active)
+              continue;
+
             notify_touch_event (device, CLUTTER_TOUCH_CANCEL,
                                 time, touch_state->id,
                                 touch_state->coords.x, touch_state->coords.y);
-            g_hash_table_iter_remove (&iter);
+            touch_state->active = FALSE;
           }
 
         break;
@@ -1705,8 +1914,10 @@ process_event (ClutterDeviceManagerEvdev *manager_evdev,
 
   if (process_base_event (manager_evdev, event))
     return;
-  if (process_device_event (manager_evdev, event))
-    return;
+
+  current_hardware_time = get_event_time_usec (event);
+  process_device_event (manager_evdev, event);
+  current_hardware_time = 0;
 }
 
 static void
@@ -1813,6 +2024,9 @@ clutter_device_manager_evdev_constructed (GObject *gobject)
 
   dispatch_libinput (manager_evdev);
 
+  if (use_input_thread)
+    input_thread_start (manager_evdev);
+
   source = clutter_event_source_new (manager_evdev);
   priv->event_source = source;
 }
@@ -1858,6 +2072,8 @@ clutter_device_manager_evdev_finalize (GObject *object)
   manager_evdev = CLUTTER_DEVICE_MANAGER_EVDEV (object);
   priv = manager_evdev->priv;
 
+  input_thread_stop (manager_evdev);
+
   g_slist_free_full (priv->seats, (GDestroyNotify) clutter_seat_evdev_free);
   g_slist_free (priv->devices);
 
@@ -1873,6 +2089,8 @@ clutter_device_manager_evdev_finalize (GObject *object)
   if (priv->libinput != NULL)
     libinput_unref (priv->libinput);
 
+  g_rec_mutex_clear (&priv->libinput_lock);
+
   G_OBJECT_CLASS (clutter_device_manager_evdev_parent_class)->finalize (object);
 }
 
@@ -1952,6 +2170,8 @@ clutter_device_manager_evdev_init (ClutterDeviceManagerEvdev *self)
 
   priv = self->priv = clutter_device_manager_evdev_get_instance_private (self);
 
+  g_rec_mutex_init (&priv->libinput_lock);
+
   priv->stage_manager = clutter_stage_manager_get_default ();
   g_object_ref (priv->stage_manager);
 
@@ -2030,8 +2250,10 @@ clutter_evdev_release_devices (void)
       return;
     }
 
+  g_rec_mutex_lock (&priv->libinput_lock);
   libinput_suspend (priv->libinput);
   process_events (manager_evdev);
+  g_rec_mutex_unlock (&priv->libinput_lock);
 
   priv->released = TRUE;
 }
@@ -2101,9 +2323,11 @@ clutter_evdev_reclaim_devices (void)
       return;
     }
 
+  g_rec_mutex_lock (&priv->libinput_lock);
   libinput_resume (priv->libinput);
   clutter_evdev_update_xkb_state (manager_evdev);
   process_events (manager_evdev);
+  g_rec_mutex_unlock (&priv->libinput_lock);
 
   priv->released = FALSE;
 }
@@ -2136,6 +2360,35 @@ clutter_evdev_set_device_callbacks (ClutterOpenDeviceCallback  open_callback,
   device_callback_data = user_data;
 }
 
+/**
+ * clutter_evdev_set_input_thread:
+ * @enabled: whether to read the input devices from a thread
+ *
+ * Sets whether Clutter should read the input devices from a dedicated
+ * thread, instead of the main loop.
+ *
+ * The input thread keeps draining the devices, and running the timers
+ * of libinput, while the main loop is busy drawing a frame; the events
+ * are still translated and delivered by the main loop, which the input
+ * thread wakes up once for each batch of events.
+ *
+ * When the input thread is enabled, the callbacks set with
+ * clutter_evdev_set_device_callbacks() can be called from the input
+ * thread, and the #libinput_device returned by
+ * clutter_evdev_input_device_get_libinput_device() should not be used
+ * outside of the handlers of the Clutter events.
+ *
+ * This function must be called before clutter_init().
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+void
+clutter_evdev_set_input_thread (gboolean enabled)
+{
+  use_input_thread = !!enabled;
+}
+
 /**
  * clutter_evdev_set_keyboard_map: (skip)
  * @evdev: the #ClutterDeviceManager created by the evdev backend
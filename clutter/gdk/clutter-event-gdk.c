@@ -333,7 +333,7 @@ clutter_gdk_handle_event (GdkEvent *gdk_event)
       event->any.stage = stage;
 
       if (gdk_event->any.send_event)
-	event->any.flags = CLUTTER_EVENT_FLAG_SYNTHETIC;
+	clutter_event_set_flags (event, CLUTTER_EVENT_FLAG_SYNTHETIC);
 
       _clutter_event_push (event, FALSE);
 
@@ -169,7 +169,9 @@ master_clock_process_stage_events (ClutterMasterClockGdk *master_clock,
 #endif
 
   /* Process queued events */
+  _clutter_stage_frame_info_mark (stage, CLUTTER_FRAME_MARK_EVENTS_START);
   _clutter_stage_process_queued_events (stage);
+  _clutter_stage_frame_info_mark (stage, CLUTTER_FRAME_MARK_EVENTS_END);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -276,30 +278,58 @@ clutter_master_clock_gdk_update (GdkFrameClock         *frame_clock,
   master_clock->remaining_budget = master_clock->frame_budget;
 #endif
 
+  /* the stages might be removed from the clock while processing the
+   * events, so we iterate over a copy of the list
+   */
   stages = g_hash_table_lookup (master_clock->clock_to_stage, frame_clock);
+  stages = g_list_copy (stages);
+  g_list_foreach (stages, (GFunc) g_object_ref, NULL);
+
   CLUTTER_NOTE (SCHEDULER, "Updating %d stages tied to frame clock %p",
                 g_list_length (stages), frame_clock);
+
+  /* Each frame is split into three separate phases: */
+
+  /* 1. process all the events; goes through the stage's event queue
+   *    and processes each event according to its type, then emits the
+   *    various signals that are associated with the event. The frames
+   *    presented since the last tick are reported before, so that the
+   *    scheduling of the stage uses the timings of the frame clock
+   */
   for (l = stages; l != NULL; l = l->next)
     {
       ClutterStage *stage = l->data;
+      ClutterStageWindow *stage_window = _clutter_stage_get_window (stage);
 
       CLUTTER_NOTE (SCHEDULER, "Master clock (stage:%p, clock:%p) [tick]", stage, frame_clock);
 
-      /* Each frame is split into three separate phases: */
+      if (CLUTTER_IS_STAGE_GDK (stage_window))
+        _clutter_stage_gdk_update_frame_timings (CLUTTER_STAGE_GDK (stage_window),
+                                                 frame_clock);
+
+      _clutter_stage_frame_info_begin (stage, master_clock->cur_tick);
 
-      /* 1. process all the events; goes through the stage's event queue
-       *    and processes each event according to its type, then emits the
-       *    various signals that are associated with the event
-       */
       master_clock_process_stage_events (master_clock, stage);
+    }
 
-      /* 2. advance the timelines */
-      master_clock_advance_timelines (master_clock);
+  /* 2. advance the timelines; this is done once per tick of the frame
+   *    clock, regardless of the number of stages tied to it
+   */
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_frame_info_mark (l->data, CLUTTER_FRAME_MARK_TIMELINES_START);
 
-      /* 3. relayout and redraw the stage; the stage might have been
-       *    destroyed in 1. when processing events, check whether it's
-       *    still alive.
-       */
+  master_clock_advance_timelines (master_clock);
+
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_frame_info_mark (l->data, CLUTTER_FRAME_MARK_TIMELINES_END);
+
+  /* 3. relayout and redraw the stages; a stage might have been
+   *    destroyed in 1. when processing events, check whether it's
+   *    still alive.
+   */
+  for (l = stages; l != NULL; l = l->next)
+    {
+      ClutterStage *stage = l->data;
 
       if (g_hash_table_lookup (master_clock->stage_to_clock, stage) != NULL)
         {
@@ -308,6 +338,8 @@ clutter_master_clock_gdk_update (GdkFrameClock         *frame_clock,
         }
     }
 
+  g_list_free_full (stages, g_object_unref);
+
   master_clock->prev_tick = master_clock->cur_tick;
 
   _clutter_threads_release_lock ();
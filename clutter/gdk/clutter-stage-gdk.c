@@ -175,6 +175,7 @@ static void
 clutter_stage_gdk_unrealize (ClutterStageWindow *stage_window)
 {
   ClutterStageGdk *stage_gdk = CLUTTER_STAGE_GDK (stage_window);
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
 
   if (stage_gdk->window != NULL)
     {
@@ -183,8 +184,6 @@ clutter_stage_gdk_unrealize (ClutterStageWindow *stage_window)
 
       if (stage_gdk->foreign_window)
         {
-          ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
-
           g_object_unref (stage_gdk->window);
 
           /* Clutter still uses part of the deprecated stateful API of
@@ -207,6 +206,15 @@ clutter_stage_gdk_unrealize (ClutterStageWindow *stage_window)
       stage_gdk->window = NULL;
     }
 
+  /* the frames swapped on the window will not be presented anymore */
+  while (!g_queue_is_empty (&stage_gdk->swapped_frames))
+    {
+      g_free (g_queue_pop_head (&stage_gdk->swapped_frames));
+
+      if (stage_cogl->wrapper != NULL)
+        _clutter_stage_frame_info_presented (stage_cogl->wrapper, 0);
+    }
+
   clutter_stage_window_parent_iface->unrealize (stage_window);
 
 #if defined(GDK_WINDOWING_WAYLAND)
@@ -615,7 +623,9 @@ static void
 clutter_stage_gdk_redraw (ClutterStageWindow *stage_window)
 {
   ClutterStageGdk *stage_gdk = CLUTTER_STAGE_GDK (stage_window);
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
   GdkFrameClock *clock;
+  guint frame_count;
 
   if (stage_gdk->window == NULL ||
       (clock = gdk_window_get_frame_clock (stage_gdk->window)) == NULL)
@@ -626,11 +636,98 @@ clutter_stage_gdk_redraw (ClutterStageWindow *stage_window)
 
   gdk_frame_clock_begin_updating (clock);
 
+  frame_count = stage_cogl->frame_count;
+
   clutter_stage_window_parent_iface->redraw (stage_window);
 
+  /* the presentation time of the frame is known once the timings of
+   * the frame of the clock are complete
+   */
+  if (stage_cogl->frame_count != frame_count)
+    {
+      gint64 frame_counter = gdk_frame_clock_get_frame_counter (clock);
+
+      g_queue_push_tail (&stage_gdk->swapped_frames,
+                         g_memdup (&frame_counter, sizeof (gint64)));
+    }
+
   gdk_frame_clock_end_updating (clock);
 }
 
+/*< private >
+ * _clutter_stage_gdk_update_frame_timings:
+ * @stage_gdk: a #ClutterStageGdk
+ * @frame_clock: the #GdkFrameClock of the window of @stage_gdk
+ *
+ * Reports the presentation times of the frames swapped by @stage_gdk
+ * whose #GdkFrameTimings are complete, and feeds them, along with the
+ * refresh interval, to the scheduling of the stage.
+ */
+void
+_clutter_stage_gdk_update_frame_timings (ClutterStageGdk *stage_gdk,
+                                         GdkFrameClock   *frame_clock)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_gdk);
+  gint64 *frame_counter;
+
+  while ((frame_counter = g_queue_peek_head (&stage_gdk->swapped_frames)) != NULL)
+    {
+      GdkFrameTimings *timings;
+      gint64 presentation_time = 0;
+
+      timings = gdk_frame_clock_get_timings (frame_clock, *frame_counter);
+
+      /* frames that fell off the history of the clock are never going
+       * to be completed
+       */
+      if (timings != NULL)
+        {
+          gint64 refresh_interval;
+
+          if (!gdk_frame_timings_get_complete (timings))
+            break;
+
+          presentation_time = gdk_frame_timings_get_presentation_time (timings);
+          if (presentation_time != 0)
+            stage_cogl->last_presentation_time = presentation_time;
+
+          refresh_interval = gdk_frame_timings_get_refresh_interval (timings);
+          if (refresh_interval > 0)
+            stage_cogl->refresh_rate = 1000000.0 / refresh_interval;
+        }
+
+      g_free (g_queue_pop_head (&stage_gdk->swapped_frames));
+
+      if (stage_cogl->wrapper != NULL)
+        _clutter_stage_frame_info_presented (stage_cogl->wrapper,
+                                             presentation_time);
+    }
+}
+
+static gint64
+clutter_stage_gdk_get_next_presentation_time (ClutterStageWindow *stage_window)
+{
+  ClutterStageGdk *stage_gdk = CLUTTER_STAGE_GDK (stage_window);
+  GdkFrameClock *frame_clock;
+  GdkFrameTimings *frame_timings;
+  gint64 presentation_time;
+
+  if (stage_gdk->window == NULL ||
+      (frame_clock = gdk_window_get_frame_clock (stage_gdk->window)) == NULL ||
+      (frame_timings = gdk_frame_clock_get_current_timings (frame_clock)) == NULL)
+    return clutter_stage_window_parent_iface->get_next_presentation_time (stage_window);
+
+  /* GDK predicts the presentation of the frame it is painting from the
+   * history of the clock
+   */
+  presentation_time =
+    gdk_frame_timings_get_predicted_presentation_time (frame_timings);
+  if (presentation_time == 0)
+    return clutter_stage_window_parent_iface->get_next_presentation_time (stage_window);
+
+  return presentation_time;
+}
+
 static void
 clutter_stage_gdk_schedule_update (ClutterStageWindow *stage_window,
                                     gint                sync_delay)
@@ -672,6 +769,9 @@ clutter_stage_gdk_dispose (GObject *gobject)
 {
   ClutterStageGdk *stage_gdk = CLUTTER_STAGE_GDK (gobject);
 
+  g_queue_foreach (&stage_gdk->swapped_frames, (GFunc) g_free, NULL);
+  g_queue_clear (&stage_gdk->swapped_frames);
+
   if (stage_gdk->window != NULL)
     {
       g_object_set_data (G_OBJECT (stage_gdk->window),
@@ -735,6 +835,9 @@ static const struct wl_registry_listener registry_listener = {
 static void
 clutter_stage_gdk_init (ClutterStageGdk *stage)
 {
+  /* the presentation times come from the GdkFrameClock */
+  CLUTTER_STAGE_COGL (stage)->external_frame_timings = TRUE;
+
 #if defined(GDK_WINDOWING_WAYLAND)
   {
     GdkDisplay *gdk_display = gdk_display_get_default ();
@@ -775,6 +878,7 @@ clutter_stage_window_iface_init (ClutterStageWindowIface *iface)
   iface->redraw = clutter_stage_gdk_redraw;
   iface->schedule_update = clutter_stage_gdk_schedule_update;
   iface->get_update_time = clutter_stage_gdk_get_update_time;
+  iface->get_next_presentation_time = clutter_stage_gdk_get_next_presentation_time;
 }
 
 /**
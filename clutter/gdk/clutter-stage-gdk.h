@@ -51,6 +51,11 @@ struct _ClutterStageGdk
 
   gboolean foreign_window;
 
+  /* the counters of the frames of the GdkFrameClock in which the stage
+   * swapped, waiting for their presentation time
+   */
+  GQueue swapped_frames;
+
 #if defined(GDK_WINDOWING_WAYLAND)
   struct wl_subcompositor *subcompositor;
   struct wl_surface *clutter_surface;
@@ -80,6 +85,9 @@ struct _ClutterStageGdkClass
 
 GType _clutter_stage_gdk_get_type (void) G_GNUC_CONST;
 
+void _clutter_stage_gdk_update_frame_timings (ClutterStageGdk *stage_gdk,
+                                              GdkFrameClock   *frame_clock);
+
 void _clutter_stage_gdk_notify_configure (ClutterStageGdk *stage_gdk,
                                           gint x,
                                           gint y,
@@ -0,0 +1,150 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The headless backend renders the stages into offscreen framebuffers,
+ * without any window or display server, so that the benchmarks can
+ * run on machines without a display.
+ *
+ * The frames are not paced by a display: a stage is updated as soon as
+ * it needs to, and the timelines are advanced using a virtual clock that
+ * moves by exactly one frame interval at each iteration of the master
+ * clock, regardless of how long the frame took. Running the same
+ * program twice thus paints the same sequence of frames.
+ */
+
+#include "config.h"
+
+#include "clutter-backend-headless.h"
+#include "clutter-device-manager-headless.h"
+#include "clutter-stage-headless.h"
+
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+#include <cogl/cogl.h>
+
+#define clutter_backend_headless_get_type       _clutter_backend_headless_get_type
+
+G_DEFINE_TYPE (ClutterBackendHeadless, clutter_backend_headless, CLUTTER_TYPE_BACKEND)
+
+void
+_clutter_backend_headless_events_init (ClutterBackend *backend)
+{
+  if (backend->device_manager != NULL)
+    return;
+
+  CLUTTER_NOTE (BACKEND, "init_events");
+
+  backend->device_manager =
+    g_object_new (CLUTTER_TYPE_DEVICE_MANAGER_HEADLESS,
+                  "backend", backend,
+                  NULL);
+}
+
+/*< private >
+ * _clutter_backend_headless_advance_clock:
+ * @backend_headless: a #ClutterBackendHeadless
+ *
+ * Advances the virtual clock of the backend by one frame; the frame
+ * interval is taken from the default frame rate, see the
+ * `CLUTTER_DEFAULT_FPS` environment variable.
+ *
+ * Return value: the time of the new frame, in usecs
+ */
+gint64
+_clutter_backend_headless_advance_clock (ClutterBackendHeadless *backend_headless)
+{
+  if (backend_headless->frame_interval == 0)
+    {
+      guint frame_rate = clutter_get_default_frame_rate ();
+
+      backend_headless->frame_interval = 1000000 / MAX (frame_rate, 1);
+    }
+
+  backend_headless->frame_time += backend_headless->frame_interval;
+
+  return backend_headless->frame_time;
+}
+
+static CoglRenderer *
+clutter_backend_headless_get_renderer (ClutterBackend  *backend,
+                                       GError         **error)
+{
+  CoglRenderer *renderer;
+
+  renderer = cogl_renderer_new ();
+
+#ifdef COGL_HAS_EGL_SUPPORT
+  /* only EGL can create a context without any native window; the
+   * stages never create an onscreen framebuffer, so the winsys only
+   * needs to provide a pbuffer, or a surfaceless context
+   */
+  cogl_renderer_add_constraint (renderer, COGL_RENDERER_CONSTRAINT_USES_EGL);
+#endif
+
+  return renderer;
+}
+
+static ClutterFeatureFlags
+clutter_backend_headless_get_features (ClutterBackend *backend)
+{
+  ClutterBackendClass *parent_class;
+  ClutterFeatureFlags flags;
+
+  parent_class = CLUTTER_BACKEND_CLASS (clutter_backend_headless_parent_class);
+  flags = parent_class->get_features (backend);
+
+  /* any number of offscreen framebuffers can be created */
+  flags &= ~(CLUTTER_FEATURE_STAGE_STATIC | CLUTTER_FEATURE_SWAP_EVENTS);
+  flags |= CLUTTER_FEATURE_STAGE_MULTIPLE;
+
+  /* each frame is "presented" as soon as the GPU is done with it, so
+   * the frames are throttled by their own cost, like a display with an
+   * infinite refresh rate, instead of being polled at the default
+   * frame rate
+   */
+  flags |= CLUTTER_FEATURE_SYNC_TO_VBLANK;
+
+  return flags;
+}
+
+static void
+clutter_backend_headless_class_init (ClutterBackendHeadlessClass *klass)
+{
+  ClutterBackendClass *backend_class = CLUTTER_BACKEND_CLASS (klass);
+
+  backend_class->stage_window_type = CLUTTER_TYPE_STAGE_HEADLESS;
+
+  backend_class->get_renderer = clutter_backend_headless_get_renderer;
+  backend_class->get_features = clutter_backend_headless_get_features;
+}
+
+static void
+clutter_backend_headless_init (ClutterBackendHeadless *backend_headless)
+{
+  /* the virtual clock starts from the real one, so that the times
+   * of the frames stay comparable with the times of the events
+   */
+  backend_headless->frame_time = g_get_monotonic_time ();
+  backend_headless->frame_interval = 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The headless backend has no input devices of its own; it only
+ * provides the core pointer and keyboard, so that the synthesized and
+ * replayed events have a device to refer to.
+ */
+
+#include "config.h"
+
+#include "clutter-device-manager-headless.h"
+
+#include "clutter-debug.h"
+#include "clutter-device-manager-private.h"
+#include "clutter-stage-manager.h"
+
+#define clutter_device_manager_headless_get_type        _clutter_device_manager_headless_get_type
+
+G_DEFINE_TYPE (ClutterDeviceManagerHeadless,
+               clutter_device_manager_headless,
+               CLUTTER_TYPE_DEVICE_MANAGER)
+
+static void
+clutter_device_manager_headless_add_device (ClutterDeviceManager *manager,
+                                            ClutterInputDevice   *device)
+{
+  ClutterDeviceManagerHeadless *self = CLUTTER_DEVICE_MANAGER_HEADLESS (manager);
+
+  self->devices = g_slist_prepend (self->devices, device);
+}
+
+static void
+clutter_device_manager_headless_remove_device (ClutterDeviceManager *manager,
+                                               ClutterInputDevice   *device)
+{
+  ClutterDeviceManagerHeadless *self = CLUTTER_DEVICE_MANAGER_HEADLESS (manager);
+
+  self->devices = g_slist_remove (self->devices, device);
+}
+
+static const GSList *
+clutter_device_manager_headless_get_devices (ClutterDeviceManager *manager)
+{
+  return CLUTTER_DEVICE_MANAGER_HEADLESS (manager)->devices;
+}
+
+static ClutterInputDevice *
+clutter_device_manager_headless_get_core_device (ClutterDeviceManager   *manager,
+                                                 ClutterInputDeviceType  type)
+{
+  ClutterDeviceManagerHeadless *self = CLUTTER_DEVICE_MANAGER_HEADLESS (manager);
+
+  switch (type)
+    {
+    case CLUTTER_POINTER_DEVICE:
+      return self->core_pointer;
+
+    case CLUTTER_KEYBOARD_DEVICE:
+      return self->core_keyboard;
+
+    default:
+      return NULL;
+    }
+}
+
+static ClutterInputDevice *
+clutter_device_manager_headless_get_device (ClutterDeviceManager *manager,
+                                            gint                  id)
+{
+  ClutterDeviceManagerHeadless *self = CLUTTER_DEVICE_MANAGER_HEADLESS (manager);
+  GSList *l;
+
+  for (l = self->devices; l != NULL; l = l->next)
+    {
+      ClutterInputDevice *device = l->data;
+
+      if (clutter_input_device_get_device_id (device) == id)
+        return device;
+    }
+
+  return NULL;
+}
+
+static void
+clutter_device_manager_headless_constructed (GObject *gobject)
+{
+  ClutterDeviceManager *manager = CLUTTER_DEVICE_MANAGER (gobject);
+  ClutterDeviceManagerHeadless *self = CLUTTER_DEVICE_MANAGER_HEADLESS (gobject);
+  ClutterStage *stage;
+
+  stage = clutter_stage_manager_get_default_stage (clutter_stage_manager_get_default ());
+
+  self->core_pointer = g_object_new (CLUTTER_TYPE_INPUT_DEVICE,
+                                     "id", 0,
+                                     "name", "Core Pointer",
+                                     "device-type", CLUTTER_POINTER_DEVICE,
+                                     "device-mode", CLUTTER_INPUT_MODE_MASTER,
+                                     "has-cursor", TRUE,
+                                     "enabled", TRUE,
+                                     NULL);
+  _clutter_input_device_set_stage (self->core_pointer, stage);
+  _clutter_device_manager_add_device (manager, self->core_pointer);
+
+  CLUTTER_NOTE (EVENT, "Added core pointer device");
+
+  self->core_keyboard = g_object_new (CLUTTER_TYPE_INPUT_DEVICE,
+                                      "id", 1,
+                                      "name", "Core Keyboard",
+                                      "device-type", CLUTTER_KEYBOARD_DEVICE,
+                                      "device-mode", CLUTTER_INPUT_MODE_MASTER,
+                                      "enabled", TRUE,
+                                      NULL);
+  _clutter_input_device_set_stage (self->core_keyboard, stage);
+  _clutter_device_manager_add_device (manager, self->core_keyboard);
+
+  CLUTTER_NOTE (EVENT, "Added core keyboard device");
+
+  if (G_OBJECT_CLASS (clutter_device_manager_headless_parent_class)->constructed)
+    G_OBJECT_CLASS (clutter_device_manager_headless_parent_class)->constructed (gobject);
+}
+
+static void
+clutter_device_manager_headless_finalize (GObject *gobject)
+{
+  ClutterDeviceManagerHeadless *self = CLUTTER_DEVICE_MANAGER_HEADLESS (gobject);
+
+  g_slist_free_full (self->devices, g_object_unref);
+
+  G_OBJECT_CLASS (clutter_device_manager_headless_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_device_manager_headless_class_init (ClutterDeviceManagerHeadlessClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterDeviceManagerClass *manager_class = CLUTTER_DEVICE_MANAGER_CLASS (klass);
+
+  gobject_class->constructed = clutter_device_manager_headless_constructed;
+  gobject_class->finalize = clutter_device_manager_headless_finalize;
+
+  manager_class->add_device = clutter_device_manager_headless_add_device;
+  manager_class->remove_device = clutter_device_manager_headless_remove_device;
+  manager_class->get_devices = clutter_device_manager_headless_get_devices;
+  manager_class->get_core_device = clutter_device_manager_headless_get_core_device;
+  manager_class->get_device = clutter_device_manager_headless_get_device;
+}
+
+static void
+clutter_device_manager_headless_init (ClutterDeviceManagerHeadless *self)
+{
+}
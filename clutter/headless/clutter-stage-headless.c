@@ -0,0 +1,395 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2026  Clutter contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The stage window of the headless backend paints the stage into an
+ * offscreen framebuffer of the size of the stage.
+ *
+ * There is no swap: once the stage is painted the stage window waits
+ * for the GPU to finish the frame, and reports the wait as the swap of
+ * the frame in the #ClutterFrameInfo, so that the GPU cost of a frame
+ * is measured separately from the CPU cost of its paint. The end of
+ * the wait is reported as the presentation time of the frame.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include "clutter-stage-headless.h"
+
+#include "clutter-backend-private.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+#include "clutter-stage-private.h"
+#include "clutter-stage-window.h"
+
+#define DEFAULT_WIDTH   800
+#define DEFAULT_HEIGHT  600
+
+static void clutter_stage_window_iface_init (ClutterStageWindowIface *iface);
+
+#define clutter_stage_headless_get_type _clutter_stage_headless_get_type
+
+G_DEFINE_TYPE_WITH_CODE (ClutterStageHeadless,
+                         clutter_stage_headless,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_STAGE_WINDOW,
+                                                clutter_stage_window_iface_init));
+
+enum
+{
+  PROP_0,
+
+  PROP_WRAPPER,
+  PROP_BACKEND,
+
+  PROP_LAST
+};
+
+static void
+clutter_stage_headless_free_framebuffer (ClutterStageHeadless *stage_headless)
+{
+  if (stage_headless->offscreen != NULL)
+    {
+      cogl_object_unref (stage_headless->offscreen);
+      stage_headless->offscreen = NULL;
+    }
+
+  if (stage_headless->texture != NULL)
+    {
+      cogl_object_unref (stage_headless->texture);
+      stage_headless->texture = NULL;
+    }
+}
+
+static gboolean
+clutter_stage_headless_allocate_framebuffer (ClutterStageHeadless *stage_headless)
+{
+  CoglError *error = NULL;
+
+  clutter_stage_headless_free_framebuffer (stage_headless);
+
+  stage_headless->texture =
+    cogl_texture_new_with_size (stage_headless->width,
+                                stage_headless->height,
+                                COGL_TEXTURE_NO_SLICING,
+                                COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (stage_headless->texture == NULL)
+    {
+      g_warning ("Failed to allocate a %dx%d headless stage",
+                 stage_headless->width,
+                 stage_headless->height);
+      return FALSE;
+    }
+
+  stage_headless->offscreen =
+    cogl_offscreen_new_with_texture (stage_headless->texture);
+  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (stage_headless->offscreen),
+                                  &error))
+    {
+      g_warning ("Failed to allocate a %dx%d headless stage: %s",
+                 stage_headless->width,
+                 stage_headless->height,
+                 error->message);
+      cogl_error_free (error);
+      clutter_stage_headless_free_framebuffer (stage_headless);
+      return FALSE;
+    }
+
+  CLUTTER_NOTE (BACKEND, "Allocated a %dx%d offscreen for stage [%p]",
+                stage_headless->width,
+                stage_headless->height,
+                stage_headless);
+
+  return TRUE;
+}
+
+static void
+clutter_stage_headless_flush_presentation (ClutterStageHeadless *stage_headless)
+{
+  if (stage_headless->presentation_id == 0)
+    return;
+
+  g_source_remove (stage_headless->presentation_id);
+  stage_headless->presentation_id = 0;
+
+  if (stage_headless->wrapper != NULL)
+    _clutter_stage_frame_info_presented (stage_headless->wrapper,
+                                         stage_headless->presentation_time);
+}
+
+static gboolean
+clutter_stage_headless_present (gpointer data)
+{
+  ClutterStageHeadless *stage_headless = data;
+
+  stage_headless->presentation_id = 0;
+
+  if (stage_headless->wrapper != NULL)
+    _clutter_stage_frame_info_presented (stage_headless->wrapper,
+                                         stage_headless->presentation_time);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+clutter_stage_headless_realize (ClutterStageWindow *stage_window)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+  ClutterBackend *backend = clutter_get_default_backend ();
+
+  CLUTTER_NOTE (BACKEND, "Realizing headless stage [%p]", stage_headless);
+
+  if (backend->cogl_context == NULL)
+    {
+      g_warning ("Failed to realize stage: missing Cogl context");
+      return FALSE;
+    }
+
+  if (stage_headless->offscreen != NULL)
+    return TRUE;
+
+  return clutter_stage_headless_allocate_framebuffer (stage_headless);
+}
+
+static void
+clutter_stage_headless_unrealize (ClutterStageWindow *stage_window)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  CLUTTER_NOTE (BACKEND, "Unrealizing headless stage [%p]", stage_headless);
+
+  clutter_stage_headless_flush_presentation (stage_headless);
+  clutter_stage_headless_free_framebuffer (stage_headless);
+}
+
+static ClutterActor *
+clutter_stage_headless_get_wrapper (ClutterStageWindow *stage_window)
+{
+  return CLUTTER_ACTOR (CLUTTER_STAGE_HEADLESS (stage_window)->wrapper);
+}
+
+static void
+clutter_stage_headless_show (ClutterStageWindow *stage_window,
+                             gboolean            do_raise)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  clutter_actor_map (CLUTTER_ACTOR (stage_headless->wrapper));
+}
+
+static void
+clutter_stage_headless_hide (ClutterStageWindow *stage_window)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  clutter_actor_unmap (CLUTTER_ACTOR (stage_headless->wrapper));
+}
+
+static void
+clutter_stage_headless_get_geometry (ClutterStageWindow    *stage_window,
+                                     cairo_rectangle_int_t *geometry)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  if (geometry != NULL)
+    {
+      geometry->x = geometry->y = 0;
+      geometry->width = stage_headless->width;
+      geometry->height = stage_headless->height;
+    }
+}
+
+static void
+clutter_stage_headless_resize (ClutterStageWindow *stage_window,
+                               gint                width,
+                               gint                height)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  width = MAX (width, 1);
+  height = MAX (height, 1);
+
+  if (stage_headless->width == width && stage_headless->height == height)
+    return;
+
+  stage_headless->width = width;
+  stage_headless->height = height;
+
+  /* the new size is effective immediately, as the stage is allocated
+   * before it is painted
+   */
+  if (stage_headless->offscreen != NULL)
+    clutter_stage_headless_allocate_framebuffer (stage_headless);
+}
+
+static void
+clutter_stage_headless_schedule_update (ClutterStageWindow *stage_window,
+                                        gint                sync_delay)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  /* there is no display to synchronize with, so the next update is
+   * always due right away
+   */
+  if (stage_headless->update_time == -1)
+    stage_headless->update_time = g_get_monotonic_time ();
+}
+
+static gint64
+clutter_stage_headless_get_update_time (ClutterStageWindow *stage_window)
+{
+  return CLUTTER_STAGE_HEADLESS (stage_window)->update_time;
+}
+
+static void
+clutter_stage_headless_clear_update_time (ClutterStageWindow *stage_window)
+{
+  CLUTTER_STAGE_HEADLESS (stage_window)->update_time = -1;
+}
+
+static void
+clutter_stage_headless_redraw (ClutterStageWindow *stage_window)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+  CoglFramebuffer *framebuffer;
+
+  if (stage_headless->offscreen == NULL)
+    return;
+
+  framebuffer = COGL_FRAMEBUFFER (stage_headless->offscreen);
+
+  /* the previous frame has been ended by the stage already */
+  clutter_stage_headless_flush_presentation (stage_headless);
+
+  _clutter_stage_do_paint (stage_headless->wrapper, NULL);
+
+  _clutter_stage_read_captures (stage_headless->wrapper, framebuffer);
+
+  _clutter_stage_frame_info_mark (stage_headless->wrapper,
+                                  CLUTTER_FRAME_MARK_PAINT_END);
+
+  /* Cogl does not expose GPU timer queries, so the GPU time of the
+   * frame is measured by waiting for the GPU to complete it
+   */
+  _clutter_stage_frame_info_mark (stage_headless->wrapper,
+                                  CLUTTER_FRAME_MARK_SWAP_START);
+  cogl_framebuffer_finish (framebuffer);
+  _clutter_stage_frame_info_mark (stage_headless->wrapper,
+                                  CLUTTER_FRAME_MARK_SWAP_END);
+
+  /* the frame is only waiting for its presentation once the stage has
+   * ended it, after the redraw returns
+   */
+  stage_headless->presentation_time = g_get_monotonic_time ();
+  stage_headless->presentation_id =
+    g_idle_add_full (G_PRIORITY_HIGH,
+                     clutter_stage_headless_present,
+                     stage_headless,
+                     NULL);
+}
+
+static CoglFramebuffer *
+clutter_stage_headless_get_active_framebuffer (ClutterStageWindow *stage_window)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (stage_window);
+
+  return COGL_FRAMEBUFFER (stage_headless->offscreen);
+}
+
+static void
+clutter_stage_window_iface_init (ClutterStageWindowIface *iface)
+{
+  iface->realize = clutter_stage_headless_realize;
+  iface->unrealize = clutter_stage_headless_unrealize;
+  iface->get_wrapper = clutter_stage_headless_get_wrapper;
+  iface->get_geometry = clutter_stage_headless_get_geometry;
+  iface->resize = clutter_stage_headless_resize;
+  iface->show = clutter_stage_headless_show;
+  iface->hide = clutter_stage_headless_hide;
+  iface->schedule_update = clutter_stage_headless_schedule_update;
+  iface->get_update_time = clutter_stage_headless_get_update_time;
+  iface->clear_update_time = clutter_stage_headless_clear_update_time;
+  iface->redraw = clutter_stage_headless_redraw;
+  iface->get_active_framebuffer = clutter_stage_headless_get_active_framebuffer;
+}
+
+static void
+clutter_stage_headless_set_property (GObject      *gobject,
+                                     guint         prop_id,
+                                     const GValue *value,
+                                     GParamSpec   *pspec)
+{
+  ClutterStageHeadless *self = CLUTTER_STAGE_HEADLESS (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_WRAPPER:
+      self->wrapper = g_value_get_object (value);
+      break;
+
+    case PROP_BACKEND:
+      self->backend = g_value_get_object (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_stage_headless_dispose (GObject *gobject)
+{
+  ClutterStageHeadless *stage_headless = CLUTTER_STAGE_HEADLESS (gobject);
+
+  if (stage_headless->presentation_id != 0)
+    {
+      g_source_remove (stage_headless->presentation_id);
+      stage_headless->presentation_id = 0;
+    }
+
+  clutter_stage_headless_free_framebuffer (stage_headless);
+
+  G_OBJECT_CLASS (clutter_stage_headless_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_stage_headless_class_init (ClutterStageHeadlessClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = clutter_stage_headless_set_property;
+  gobject_class->dispose = clutter_stage_headless_dispose;
+
+  g_object_class_override_property (gobject_class, PROP_WRAPPER, "wrapper");
+  g_object_class_override_property (gobject_class, PROP_BACKEND, "backend");
+}
+
+static void
+clutter_stage_headless_init (ClutterStageHeadless *stage_headless)
+{
+  stage_headless->width = DEFAULT_WIDTH;
+  stage_headless->height = DEFAULT_HEIGHT;
+
+  stage_headless->update_time = -1;
+}
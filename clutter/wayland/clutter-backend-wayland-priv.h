@@ -27,6 +27,7 @@
 #ifndef __CLUTTER_BACKEND_WAYLAND_PRIV_H__
 #define __CLUTTER_BACKEND_WAYLAND_PRIV_H__
 
+#include <time.h>
 #include <glib-object.h>
 #include <clutter/clutter-event.h>
 #include <clutter/clutter-backend.h>
@@ -46,6 +47,7 @@ struct _ClutterBackendWayland
   struct wl_display *wayland_display;
   struct wl_registry *wayland_registry;
   struct wl_compositor *wayland_compositor;
+  struct wl_subcompositor *wayland_subcompositor;
   struct wl_shell *wayland_shell;
   struct wl_shm *wayland_shm;
   struct wl_surface *cursor_surface;
@@ -53,6 +55,12 @@ struct _ClutterBackendWayland
   struct wl_output *wayland_output;
   struct wl_cursor_theme *cursor_theme;
 
+  /* the presentation-time global, if the compositor has one, and the
+   * clock of the timestamps of its feedback
+   */
+  struct wp_presentation *wayland_presentation;
+  clockid_t presentation_clock_id;
+
   gint cursor_x, cursor_y;
   gint output_width, output_height;
 
@@ -56,6 +56,10 @@
 #include <cogl/cogl.h>
 #include <cogl/cogl-wayland-client.h>
 
+#ifdef HAVE_WAYLAND_PRESENTATION
+#include "wayland/presentation-time-client-protocol.h"
+#endif
+
 #define clutter_backend_wayland_get_type     _clutter_backend_wayland_get_type
 
 G_DEFINE_TYPE (ClutterBackendWayland, clutter_backend_wayland, CLUTTER_TYPE_BACKEND);
@@ -86,6 +90,11 @@ clutter_backend_wayland_dispose (GObject *gobject)
       backend_wayland->cursor_theme = NULL;
     }
 
+#ifdef HAVE_WAYLAND_PRESENTATION
+  g_clear_pointer (&backend_wayland->wayland_presentation,
+                   wp_presentation_destroy);
+#endif
+
   G_OBJECT_CLASS (clutter_backend_wayland_parent_class)->dispose (gobject);
 }
 
@@ -128,6 +137,22 @@ static const struct wl_output_listener wayland_output_listener = {
 };
 
 
+#ifdef HAVE_WAYLAND_PRESENTATION
+static void
+presentation_handle_clock_id (void *data,
+                              struct wp_presentation *presentation,
+                              uint32_t clock_id)
+{
+  ClutterBackendWayland *backend_wayland = data;
+
+  backend_wayland->presentation_clock_id = clock_id;
+}
+
+static const struct wp_presentation_listener wayland_presentation_listener = {
+  presentation_handle_clock_id,
+};
+#endif /* HAVE_WAYLAND_PRESENTATION */
+
 static void
 registry_handle_global (void *data,
                         struct wl_registry *registry,
@@ -140,6 +165,9 @@ registry_handle_global (void *data,
   if (strcmp (interface, "wl_compositor") == 0)
     backend_wayland->wayland_compositor =
       wl_registry_bind (registry, id, &wl_compositor_interface, 1);
+  else if (strcmp (interface, "wl_subcompositor") == 0)
+    backend_wayland->wayland_subcompositor =
+      wl_registry_bind (registry, id, &wl_subcompositor_interface, 1);
   else if (strcmp (interface, "wl_seat") == 0)
     {
       ClutterDeviceManager *device_manager = backend_wayland->device_manager;
@@ -164,6 +192,16 @@ registry_handle_global (void *data,
                               &wayland_output_listener,
                               backend_wayland);
     }
+#ifdef HAVE_WAYLAND_PRESENTATION
+  else if (strcmp (interface, "wp_presentation") == 0)
+    {
+      backend_wayland->wayland_presentation =
+        wl_registry_bind (registry, id, &wp_presentation_interface, 1);
+      wp_presentation_add_listener (backend_wayland->wayland_presentation,
+                                    &wayland_presentation_listener,
+                                    backend_wayland);
+    }
+#endif
 }
 
 static const struct wl_registry_listener wayland_registry_listener = {
@@ -320,6 +358,7 @@ _clutter_backend_wayland_ensure_cursor (ClutterBackendWayland *backend_wayland)
 static void
 clutter_backend_wayland_init (ClutterBackendWayland *backend_wayland)
 {
+  backend_wayland->presentation_clock_id = CLOCK_MONOTONIC;
 }
 
 /**
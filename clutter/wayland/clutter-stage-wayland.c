@@ -36,11 +36,41 @@
 #include "clutter-backend-wayland-priv.h"
 #include "clutter-stage-window.h"
 #include "clutter-stage-private.h"
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
 #include "clutter-event-private.h"
 #include "clutter-wayland.h"
 #include <cogl/cogl.h>
 #include <cogl/cogl-wayland-client.h>
 
+#include <math.h>
+#include <time.h>
+
+#ifdef HAVE_WAYLAND_PRESENTATION
+#include "wayland/presentation-time-client-protocol.h"
+#endif
+
+typedef struct _ClutterStageWaylandLayer        ClutterStageWaylandLayer;
+
+/* an actor painted in a subsurface of the stage */
+struct _ClutterStageWaylandLayer
+{
+  ClutterActor *actor;
+
+  struct wl_surface *wayland_surface;
+  struct wl_subsurface *wayland_subsurface;
+  CoglOnscreen *onscreen;
+
+  /* the paint box of the actor, in stage coordinates */
+  int x, y;
+  int width, height;
+
+  gulong redraw_id;
+  gulong destroy_id;
+
+  guint damaged : 1;
+};
+
 static ClutterStageWindowIface *clutter_stage_window_parent_iface = NULL;
 
 static void clutter_stage_window_iface_init (ClutterStageWindowIface *iface);
@@ -128,6 +158,17 @@ clutter_stage_wayland_realize (ClutterStageWindow *stage_window)
   if (stage_wayland->fullscreen)
     clutter_stage_wayland_set_fullscreen (stage_window, TRUE);
 
+#ifdef HAVE_WAYLAND_PRESENTATION
+  {
+    ClutterBackendWayland *backend_wayland =
+      CLUTTER_BACKEND_WAYLAND (stage_cogl->backend);
+
+    /* the presentation feedback replaces the frame events of Cogl */
+    stage_cogl->external_frame_timings =
+      backend_wayland->wayland_presentation != NULL;
+  }
+#endif
+
   return TRUE;
 }
 
@@ -235,10 +276,451 @@ clutter_stage_wayland_can_clip_redraws (ClutterStageWindow *stage_window)
   return TRUE;
 }
 
+static void
+clutter_stage_wayland_layer_clear (ClutterStageWaylandLayer *layer)
+{
+  if (layer->onscreen != NULL)
+    {
+      _clutter_actor_set_paint_in_layer (layer->actor, FALSE);
+
+      cogl_object_unref (layer->onscreen);
+      layer->onscreen = NULL;
+    }
+
+  if (layer->wayland_subsurface != NULL)
+    {
+      wl_subsurface_destroy (layer->wayland_subsurface);
+      layer->wayland_subsurface = NULL;
+    }
+
+  if (layer->wayland_surface != NULL)
+    {
+      wl_surface_destroy (layer->wayland_surface);
+      layer->wayland_surface = NULL;
+    }
+}
+
+static void
+clutter_stage_wayland_layer_free (ClutterStageWaylandLayer *layer)
+{
+  clutter_stage_wayland_layer_clear (layer);
+
+  g_signal_handler_disconnect (layer->actor, layer->redraw_id);
+  g_signal_handler_disconnect (layer->actor, layer->destroy_id);
+  g_object_unref (layer->actor);
+
+  g_slice_free (ClutterStageWaylandLayer, layer);
+}
+
+/* Creates the subsurface of @layer; if the compositor does not support
+ * subsurfaces, the actor is simply painted with the rest of the stage
+ */
+static gboolean
+clutter_stage_wayland_layer_ensure (ClutterStageWayland      *stage_wayland,
+                                    ClutterStageWaylandLayer *layer)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_wayland);
+  ClutterBackend *backend = CLUTTER_BACKEND (stage_cogl->backend);
+  ClutterBackendWayland *backend_wayland = CLUTTER_BACKEND_WAYLAND (backend);
+  CoglError *error = NULL;
+
+  if (layer->onscreen != NULL)
+    return TRUE;
+
+  if (backend_wayland->wayland_subcompositor == NULL ||
+      stage_wayland->wayland_surface == NULL)
+    return FALSE;
+
+  layer->wayland_surface =
+    wl_compositor_create_surface (backend_wayland->wayland_compositor);
+  layer->wayland_subsurface =
+    wl_subcompositor_get_subsurface (backend_wayland->wayland_subcompositor,
+                                     layer->wayland_surface,
+                                     stage_wayland->wayland_surface);
+
+  /* the layer is updated on its own, without waiting for the stage */
+  wl_subsurface_set_desync (layer->wayland_subsurface);
+
+  layer->onscreen = cogl_onscreen_new (backend->cogl_context,
+                                       MAX (layer->width, 1),
+                                       MAX (layer->height, 1));
+  cogl_wayland_onscreen_set_foreign_surface (layer->onscreen,
+                                             layer->wayland_surface);
+
+  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (layer->onscreen), &error))
+    {
+      CLUTTER_NOTE (BACKEND, "Unable to allocate the layer of actor '%s': %s",
+                    _clutter_actor_get_debug_name (layer->actor),
+                    error->message);
+      cogl_error_free (error);
+      clutter_stage_wayland_layer_clear (layer);
+      return FALSE;
+    }
+
+  _clutter_actor_set_paint_in_layer (layer->actor, TRUE);
+
+  return TRUE;
+}
+
+static void
+clutter_stage_wayland_layer_paint (ClutterStageWayland      *stage_wayland,
+                                   ClutterStageWaylandLayer *layer)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_wayland);
+  CoglFramebuffer *fb = COGL_FRAMEBUFFER (layer->onscreen);
+  ClutterActor *parent;
+  CoglMatrix projection, modelview;
+  float viewport[4];
+
+  if (cogl_framebuffer_get_width (fb) != layer->width ||
+      cogl_framebuffer_get_height (fb) != layer->height)
+    cogl_wayland_onscreen_resize (layer->onscreen,
+                                  layer->width, layer->height,
+                                  0, 0);
+
+  cogl_push_framebuffer (fb);
+
+  /* the layer is the area of the stage under the paint box of the
+   * actor, so we offset the viewport of the stage
+   */
+  _clutter_stage_get_viewport (stage_cogl->wrapper,
+                               &viewport[0],
+                               &viewport[1],
+                               &viewport[2],
+                               &viewport[3]);
+  cogl_framebuffer_set_viewport (fb,
+                                 viewport[0] - layer->x,
+                                 viewport[1] - layer->y,
+                                 viewport[2],
+                                 viewport[3]);
+
+  _clutter_stage_get_projection_matrix (stage_cogl->wrapper, &projection);
+  cogl_framebuffer_set_projection_matrix (fb, &projection);
+
+  cogl_matrix_init_identity (&modelview);
+  parent = clutter_actor_get_parent (layer->actor);
+  if (parent != NULL)
+    _clutter_actor_apply_relative_transformation_matrix (parent, NULL,
+                                                         &modelview);
+  cogl_framebuffer_set_modelview_matrix (fb, &modelview);
+
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH,
+                            0.f, 0.f, 0.f, 0.f);
+
+  _clutter_actor_push_layer_paint ();
+  clutter_actor_paint (layer->actor);
+  _clutter_actor_pop_layer_paint ();
+
+  cogl_pop_framebuffer ();
+
+  cogl_onscreen_swap_buffers (layer->onscreen);
+
+  layer->damaged = FALSE;
+}
+
+static void
+clutter_stage_wayland_update_layers (ClutterStageWayland *stage_wayland,
+                                     gboolean             full_redraw)
+{
+  GList *l;
+
+  for (l = stage_wayland->layers; l != NULL; l = l->next)
+    {
+      ClutterStageWaylandLayer *layer = l->data;
+      ClutterActorBox box;
+      int x, y, width, height;
+
+      if (!clutter_actor_is_mapped (layer->actor) ||
+          !clutter_actor_get_paint_box (layer->actor, &box))
+        {
+          /* the actor is painted with the stage until it can be
+           * promoted again
+           */
+          clutter_stage_wayland_layer_clear (layer);
+          continue;
+        }
+
+      x = floorf (box.x1);
+      y = floorf (box.y1);
+      width = ceilf (box.x2) - x;
+      height = ceilf (box.y2) - y;
+
+      if (width < 1 || height < 1)
+        continue;
+
+      if (x != layer->x || y != layer->y ||
+          width != layer->width || height != layer->height)
+        {
+          layer->x = x;
+          layer->y = y;
+          layer->width = width;
+          layer->height = height;
+          layer->damaged = TRUE;
+
+          /* the position is applied with the next commit of the stage */
+          if (layer->wayland_subsurface != NULL)
+            wl_subsurface_set_position (layer->wayland_subsurface, x, y);
+        }
+
+      if (layer->onscreen == NULL)
+        {
+          if (!clutter_stage_wayland_layer_ensure (stage_wayland, layer))
+            continue;
+
+          wl_subsurface_set_position (layer->wayland_subsurface, x, y);
+          layer->damaged = TRUE;
+        }
+
+      /* a redraw queued inside the layer can stop propagating once a
+       * full redraw of the stage is queued, so we cannot rely on the
+       * damage of the layer in that case
+       */
+      if (layer->damaged || full_redraw)
+        clutter_stage_wayland_layer_paint (stage_wayland, layer);
+    }
+}
+
+static void
+frame_callback_done (void               *data,
+                     struct wl_callback *callback,
+                     uint32_t            time)
+{
+  ClutterStageWayland *stage_wayland = data;
+
+  /* the master clock checks the update time of the stage again once
+   * the Wayland events have been dispatched
+   */
+  wl_callback_destroy (callback);
+  stage_wayland->frame_callback = NULL;
+}
+
+static const struct wl_callback_listener frame_callback_listener = {
+  frame_callback_done
+};
+
+#ifdef HAVE_WAYLAND_PRESENTATION
+/* converts @time, in microseconds of @clock_id, to the clock used by
+ * g_get_monotonic_time()
+ */
+static gint64
+clutter_stage_wayland_convert_time (clockid_t clock_id,
+                                    gint64    time)
+{
+  struct timespec now;
+
+  if (clock_id == CLOCK_MONOTONIC)
+    return time;
+
+  if (clock_gettime (clock_id, &now) != 0)
+    return 0;
+
+  return g_get_monotonic_time () + time -
+         ((gint64) now.tv_sec * G_USEC_PER_SEC + now.tv_nsec / 1000);
+}
+
+static void
+presentation_feedback_sync_output (void                            *data,
+                                   struct wp_presentation_feedback *feedback,
+                                   struct wl_output                *output)
+{
+}
+
+static void
+presentation_feedback_presented (void                            *data,
+                                 struct wp_presentation_feedback *feedback,
+                                 uint32_t                         tv_sec_hi,
+                                 uint32_t                         tv_sec_lo,
+                                 uint32_t                         tv_nsec,
+                                 uint32_t                         refresh,
+                                 uint32_t                         seq_hi,
+                                 uint32_t                         seq_lo,
+                                 uint32_t                         flags)
+{
+  ClutterStageWayland *stage_wayland = data;
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_wayland);
+  ClutterBackendWayland *backend_wayland =
+    CLUTTER_BACKEND_WAYLAND (stage_cogl->backend);
+  ClutterPresentationFlags presentation_flags = CLUTTER_PRESENTATION_NONE;
+  gint64 presentation_time;
+
+  g_queue_remove (&stage_wayland->presentation_feedbacks, feedback);
+  wp_presentation_feedback_destroy (feedback);
+
+  presentation_time = ((gint64) tv_sec_hi << 32 | tv_sec_lo) * G_USEC_PER_SEC +
+                      tv_nsec / 1000;
+  presentation_time =
+    clutter_stage_wayland_convert_time (backend_wayland->presentation_clock_id,
+                                        presentation_time);
+
+  if (presentation_time != 0)
+    stage_cogl->last_presentation_time = presentation_time;
+
+  /* the refresh interval is in nanoseconds, and 0 if unknown */
+  if (refresh != 0)
+    stage_cogl->refresh_rate = 1000000000.0 / refresh;
+
+  if (flags & WP_PRESENTATION_FEEDBACK_KIND_VSYNC)
+    presentation_flags |= CLUTTER_PRESENTATION_VSYNC;
+  if (flags & WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK)
+    presentation_flags |= CLUTTER_PRESENTATION_HW_CLOCK;
+  if (flags & WP_PRESENTATION_FEEDBACK_KIND_HW_COMPLETION)
+    presentation_flags |= CLUTTER_PRESENTATION_HW_COMPLETION;
+  if (flags & WP_PRESENTATION_FEEDBACK_KIND_ZERO_COPY)
+    presentation_flags |= CLUTTER_PRESENTATION_ZERO_COPY;
+
+  CLUTTER_NOTE (SCHEDULER, "Frame presented at %" G_GINT64_FORMAT
+                " (refresh: %u ns, flags: %x)",
+                presentation_time,
+                refresh,
+                flags);
+
+  if (stage_cogl->wrapper != NULL)
+    _clutter_stage_frame_info_presented_full (stage_cogl->wrapper,
+                                              presentation_time,
+                                              refresh / 1000,
+                                              presentation_flags);
+}
+
+static void
+presentation_feedback_discarded (void                            *data,
+                                 struct wp_presentation_feedback *feedback)
+{
+  ClutterStageWayland *stage_wayland = data;
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_wayland);
+
+  g_queue_remove (&stage_wayland->presentation_feedbacks, feedback);
+  wp_presentation_feedback_destroy (feedback);
+
+  if (stage_cogl->wrapper != NULL)
+    _clutter_stage_frame_info_presented (stage_cogl->wrapper, 0);
+}
+
+static const struct wp_presentation_feedback_listener presentation_feedback_listener = {
+  presentation_feedback_sync_output,
+  presentation_feedback_presented,
+  presentation_feedback_discarded
+};
+#endif /* HAVE_WAYLAND_PRESENTATION */
+
+/* requests the frame callback, and the presentation feedback, of the
+ * frame being painted; both are part of the pending state of the
+ * surface, so they are committed along with the swap of the frame,
+ * even when the swap is deferred
+ */
+static void
+clutter_stage_wayland_request_frame (ClutterStageWayland *stage_wayland)
+{
+#ifdef HAVE_WAYLAND_PRESENTATION
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_wayland);
+  ClutterBackendWayland *backend_wayland =
+    CLUTTER_BACKEND_WAYLAND (stage_cogl->backend);
+#endif
+
+  if (stage_wayland->frame_callback == NULL)
+    {
+      stage_wayland->frame_callback =
+        wl_surface_frame (stage_wayland->wayland_surface);
+      wl_callback_add_listener (stage_wayland->frame_callback,
+                                &frame_callback_listener,
+                                stage_wayland);
+    }
+
+#ifdef HAVE_WAYLAND_PRESENTATION
+  if (backend_wayland->wayland_presentation != NULL)
+    {
+      struct wp_presentation_feedback *feedback;
+
+      feedback =
+        wp_presentation_feedback (backend_wayland->wayland_presentation,
+                                  stage_wayland->wayland_surface);
+      wp_presentation_feedback_add_listener (feedback,
+                                             &presentation_feedback_listener,
+                                             stage_wayland);
+      g_queue_push_tail (&stage_wayland->presentation_feedbacks, feedback);
+    }
+#endif
+}
+
+/* drops the frame callback and the presentation feedback of the
+ * frames that will never be presented
+ */
+static void
+clutter_stage_wayland_clear_frames (ClutterStageWayland *stage_wayland)
+{
+#ifdef HAVE_WAYLAND_PRESENTATION
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_wayland);
+#endif
+
+  g_clear_pointer (&stage_wayland->frame_callback, wl_callback_destroy);
+
+#ifdef HAVE_WAYLAND_PRESENTATION
+  while (!g_queue_is_empty (&stage_wayland->presentation_feedbacks))
+    {
+      wp_presentation_feedback_destroy (g_queue_pop_head (&stage_wayland->presentation_feedbacks));
+
+      if (stage_cogl->wrapper != NULL)
+        _clutter_stage_frame_info_presented (stage_cogl->wrapper, 0);
+    }
+#endif
+}
+
+static gint64
+clutter_stage_wayland_get_update_time (ClutterStageWindow *stage_window)
+{
+  ClutterStageWayland *stage_wayland = CLUTTER_STAGE_WAYLAND (stage_window);
+
+  /* the compositor is not ready for a new frame: painting one now
+   * would either block in the swap or produce a frame that is never
+   * shown
+   */
+  if (stage_wayland->frame_callback != NULL)
+    return -1; /* in the future, indefinite */
+
+  return clutter_stage_window_parent_iface->get_update_time (stage_window);
+}
+
+static void
+clutter_stage_wayland_redraw (ClutterStageWindow *stage_window)
+{
+  ClutterStageWayland *stage_wayland = CLUTTER_STAGE_WAYLAND (stage_window);
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+  gboolean full_redraw;
+
+  full_redraw = !_clutter_stage_window_has_redraw_clips (stage_window);
+
+  /* the layers are updated first, so that their new position is
+   * committed with the stage; the actors painted in a layer are
+   * skipped when painting the stage
+   */
+  if (stage_wayland->layers != NULL)
+    clutter_stage_wayland_update_layers (stage_wayland, full_redraw);
+
+  if (stage_cogl->onscreen != NULL && stage_wayland->wayland_surface != NULL)
+    clutter_stage_wayland_request_frame (stage_wayland);
+
+  clutter_stage_window_parent_iface->redraw (stage_window);
+}
+
+static void
+clutter_stage_wayland_unrealize (ClutterStageWindow *stage_window)
+{
+  ClutterStageWayland *stage_wayland = CLUTTER_STAGE_WAYLAND (stage_window);
+
+  g_list_foreach (stage_wayland->layers,
+                  (GFunc) clutter_stage_wayland_layer_clear,
+                  NULL);
+
+  clutter_stage_wayland_clear_frames (stage_wayland);
+
+  clutter_stage_window_parent_iface->unrealize (stage_window);
+}
+
 static void
 clutter_stage_wayland_init (ClutterStageWayland *stage_wayland)
 {
   stage_wayland->cursor_visible = TRUE;
+
+  g_queue_init (&stage_wayland->presentation_feedbacks);
 }
 
 static void
@@ -252,11 +734,29 @@ clutter_stage_window_iface_init (ClutterStageWindowIface *iface)
   iface->set_cursor_visible = clutter_stage_wayland_set_cursor_visible;
   iface->resize = clutter_stage_wayland_resize;
   iface->can_clip_redraws = clutter_stage_wayland_can_clip_redraws;
+  iface->get_update_time = clutter_stage_wayland_get_update_time;
+  iface->redraw = clutter_stage_wayland_redraw;
+  iface->unrealize = clutter_stage_wayland_unrealize;
+}
+
+static void
+clutter_stage_wayland_dispose (GObject *gobject)
+{
+  ClutterStageWayland *stage_wayland = CLUTTER_STAGE_WAYLAND (gobject);
+
+  g_list_free_full (stage_wayland->layers,
+                    (GDestroyNotify) clutter_stage_wayland_layer_free);
+  stage_wayland->layers = NULL;
+
+  G_OBJECT_CLASS (clutter_stage_wayland_parent_class)->dispose (gobject);
 }
 
 static void
 clutter_stage_wayland_class_init (ClutterStageWaylandClass *klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->dispose = clutter_stage_wayland_dispose;
 }
 
 /**
@@ -363,3 +863,126 @@ clutter_wayland_stage_set_wl_surface (ClutterStage *stage,
   else
     g_warning (G_STRLOC ": cannot set foreign surface for stage");
 }
+
+static void
+on_layer_queue_redraw (ClutterActor             *actor,
+                       ClutterActor             *origin,
+                       ClutterStageWaylandLayer *layer)
+{
+  layer->damaged = TRUE;
+}
+
+static ClutterStageWaylandLayer *
+clutter_stage_wayland_find_layer (ClutterStageWayland *stage_wayland,
+                                  ClutterActor        *actor)
+{
+  GList *l;
+
+  for (l = stage_wayland->layers; l != NULL; l = l->next)
+    {
+      ClutterStageWaylandLayer *layer = l->data;
+
+      if (layer->actor == actor)
+        return layer;
+    }
+
+  return NULL;
+}
+
+static void
+on_layer_destroy (ClutterActor *actor,
+                  ClutterStage *stage)
+{
+  clutter_wayland_stage_remove_layer (stage, actor);
+}
+
+/**
+ * clutter_wayland_stage_add_layer:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor inside @stage
+ *
+ * Promotes @actor to a layer of its own: the actor is painted in a
+ * subsurface of the surface of @stage, positioned over the area of the
+ * actor, instead of being painted with the rest of the stage. When only
+ * the actor changes, only its subsurface is painted again and committed,
+ * and the compositor puts it together with the stage.
+ *
+ * The subsurface is stacked above the stage, so this is meant for actors
+ * with nothing painted over them, like a video. Layers should not be
+ * nested inside other layers.
+ *
+ * If the compositor does not support subsurfaces, @actor is painted
+ * with the stage, as usual.
+ *
+ * Note: this function can only be called when running on the Wayland
+ * platform. Calling this function at any other time has no effect.
+ *
+ * Since: 1.26
+ */
+void
+clutter_wayland_stage_add_layer (ClutterStage *stage,
+                                 ClutterActor *actor)
+{
+  ClutterStageWindow *stage_window = _clutter_stage_get_window (stage);
+  ClutterStageWayland *stage_wayland;
+  ClutterStageWaylandLayer *layer;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (actor));
+
+  if (!CLUTTER_IS_STAGE_WAYLAND (stage_window))
+    return;
+
+  stage_wayland = CLUTTER_STAGE_WAYLAND (stage_window);
+
+  if (clutter_stage_wayland_find_layer (stage_wayland, actor) != NULL)
+    return;
+
+  layer = g_slice_new0 (ClutterStageWaylandLayer);
+  layer->actor = g_object_ref (actor);
+  layer->damaged = TRUE;
+  layer->redraw_id = g_signal_connect (actor, "queue-redraw",
+                                       G_CALLBACK (on_layer_queue_redraw),
+                                       layer);
+  layer->destroy_id = g_signal_connect (actor, "destroy",
+                                        G_CALLBACK (on_layer_destroy),
+                                        stage);
+
+  stage_wayland->layers = g_list_prepend (stage_wayland->layers, layer);
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
+
+/**
+ * clutter_wayland_stage_remove_layer:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor
+ *
+ * Paints @actor with the rest of @stage again, after it was promoted
+ * to a layer by clutter_wayland_stage_add_layer().
+ *
+ * Since: 1.26
+ */
+void
+clutter_wayland_stage_remove_layer (ClutterStage *stage,
+                                    ClutterActor *actor)
+{
+  ClutterStageWindow *stage_window = _clutter_stage_get_window (stage);
+  ClutterStageWayland *stage_wayland;
+  ClutterStageWaylandLayer *layer;
+
+  g_return_if_fail (CLUTTER_IS_ACTOR (actor));
+
+  if (!CLUTTER_IS_STAGE_WAYLAND (stage_window))
+    return;
+
+  stage_wayland = CLUTTER_STAGE_WAYLAND (stage_window);
+
+  layer = clutter_stage_wayland_find_layer (stage_wayland, actor);
+  if (layer == NULL)
+    return;
+
+  stage_wayland->layers = g_list_remove (stage_wayland->layers, layer);
+  clutter_stage_wayland_layer_free (layer);
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
@@ -56,6 +56,19 @@ struct _ClutterStageWayland
   gboolean foreign_wl_surface;
   gboolean shown;
   gboolean cursor_visible;
+
+  /* the actors promoted to subsurfaces */
+  GList *layers;
+
+  /* the frame callback requested with the last frame; no new frame
+   * is painted until the compositor signals it is ready for one
+   */
+  struct wl_callback *frame_callback;
+
+  /* the presentation feedback of the frames not presented yet, from
+   * the oldest to the newest
+   */
+  GQueue presentation_feedbacks;
 };
 
 struct _ClutterStageWaylandClass
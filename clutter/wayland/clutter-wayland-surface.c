@@ -179,6 +179,10 @@ free_surface_buffers (ClutterWaylandSurface *self)
       priv->buffer = NULL;
       free_pipeline (self);
     }
+
+  _clutter_actor_set_client_buffer (CLUTTER_ACTOR (self),
+                                    CLUTTER_CLIENT_BUFFER_NONE,
+                                    NULL);
 }
 
 static void
@@ -549,6 +553,13 @@ clutter_wayland_surface_attach_buffer (ClutterWaylandSurface *self,
   if (!priv->buffer)
     return FALSE;
 
+  /* the stage window can present the buffer directly when the surface
+   * covers the whole stage
+   */
+  _clutter_actor_set_client_buffer (CLUTTER_ACTOR (self),
+                                    CLUTTER_CLIENT_BUFFER_WAYLAND,
+                                    buffer);
+
   set_size (self,
             cogl_texture_get_width (COGL_TEXTURE (priv->buffer)),
             cogl_texture_get_height (COGL_TEXTURE (priv->buffer)));
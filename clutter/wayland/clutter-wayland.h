@@ -52,6 +52,12 @@ struct wl_surface *clutter_wayland_stage_get_wl_surface (ClutterStage *stage);
 CLUTTER_AVAILABLE_IN_1_16
 void clutter_wayland_stage_set_wl_surface (ClutterStage *stage, struct wl_surface *surface);
 
+CLUTTER_AVAILABLE_IN_1_26
+void clutter_wayland_stage_add_layer (ClutterStage *stage, ClutterActor *actor);
+
+CLUTTER_AVAILABLE_IN_1_26
+void clutter_wayland_stage_remove_layer (ClutterStage *stage, ClutterActor *actor);
+
 CLUTTER_AVAILABLE_IN_1_16
 void clutter_wayland_set_display (struct wl_display *display);
 
@@ -24,6 +24,7 @@
 #include "config.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #include "clutter-device-manager-xi2.h"
 
@@ -1641,3 +1642,74 @@ clutter_device_manager_xi2_init (ClutterDeviceManagerXI2 *self)
                                                NULL,
                                                (GDestroyNotify) g_object_unref);
 }
+
+/*< private >
+ * _clutter_device_manager_xi2_compress_motion:
+ * @manager_xi2: a #ClutterDeviceManagerXI2
+ * @xevent: an X event, with its cookie data
+ * @next: the X event following @xevent, with its cookie data
+ * @sample: (out): return location for the position of @xevent
+ *
+ * Checks whether @xevent is an XI2 motion event that can be dropped
+ * before being translated, because @next is a motion event of the
+ * same devices on the same window, with the same buttons, modifiers
+ * and changed valuators; the scroll valuators are absolute, so the
+ * scroll delta of @next covers the one of @xevent.
+ *
+ * Return value: %TRUE if @xevent can be dropped, in which case
+ *   @sample is set to its position, relative to the stage
+ */
+gboolean
+_clutter_device_manager_xi2_compress_motion (ClutterDeviceManagerXI2 *manager_xi2,
+                                             const XEvent            *xevent,
+                                             const XEvent            *next,
+                                             ClutterEventSample      *sample)
+{
+  const XIDeviceEvent *xev, *next_xev;
+  ClutterStageX11 *stage_x11;
+  ClutterStage *stage;
+
+  if (xevent->xcookie.type != GenericEvent ||
+      xevent->xcookie.extension != manager_xi2->opcode ||
+      xevent->xcookie.data == NULL ||
+      next->xcookie.type != GenericEvent ||
+      next->xcookie.extension != manager_xi2->opcode ||
+      next->xcookie.data == NULL)
+    return FALSE;
+
+  xev = xevent->xcookie.data;
+  next_xev = next->xcookie.data;
+
+  if (xev->evtype != XI_Motion || next_xev->evtype != XI_Motion)
+    return FALSE;
+
+  if (xev->deviceid != next_xev->deviceid ||
+      xev->sourceid != next_xev->sourceid ||
+      xev->event != next_xev->event ||
+      xev->flags != next_xev->flags ||
+      xev->mods.effective != next_xev->mods.effective ||
+      xev->group.effective != next_xev->group.effective)
+    return FALSE;
+
+  if (xev->buttons.mask_len != next_xev->buttons.mask_len ||
+      memcmp (xev->buttons.mask, next_xev->buttons.mask,
+              xev->buttons.mask_len) != 0)
+    return FALSE;
+
+  if (xev->valuators.mask_len != next_xev->valuators.mask_len ||
+      memcmp (xev->valuators.mask, next_xev->valuators.mask,
+              xev->valuators.mask_len) != 0)
+    return FALSE;
+
+  stage = clutter_x11_get_stage_from_window (xev->event);
+  if (stage == NULL || CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return FALSE;
+
+  stage_x11 = CLUTTER_STAGE_X11 (_clutter_stage_get_window (stage));
+
+  sample->time = xev->time;
+  translate_coords (stage_x11, xev->event_x, xev->event_y,
+                    &sample->x, &sample->y);
+
+  return TRUE;
+}
@@ -24,7 +24,9 @@
 #ifndef __CLUTTER_DEVICE_MANAGER_XI2_H__
 #define __CLUTTER_DEVICE_MANAGER_XI2_H__
 
+#include <X11/Xlib.h>
 #include <clutter/clutter-device-manager.h>
+#include <clutter/clutter-event.h>
 
 G_BEGIN_DECLS
 
@@ -59,6 +61,11 @@ struct _ClutterDeviceManagerXI2Class
 
 GType _clutter_device_manager_xi2_get_type (void) G_GNUC_CONST;
 
+gboolean _clutter_device_manager_xi2_compress_motion (ClutterDeviceManagerXI2 *manager_xi2,
+                                                      const XEvent            *xevent,
+                                                      const XEvent            *next,
+                                                      ClutterEventSample      *sample);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_DEVICE_MANAGER_XI2_H__ */
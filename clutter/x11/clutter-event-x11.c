@@ -27,6 +27,7 @@
 #include "config.h"
 
 #include "clutter-backend-x11.h"
+#include "clutter-device-manager-xi2.h"
 #include "clutter-x11.h"
 
 #include "clutter-backend-private.h"
@@ -63,6 +64,9 @@
 static Window ParentEmbedderWin = None;
 #endif
 
+/* the number of X events read from the connection at once */
+#define EVENTS_BATCH_SIZE       64
+
 typedef struct _ClutterEventSource      ClutterEventSource;
 
 struct _ClutterEventSource
@@ -272,33 +276,97 @@ clutter_event_check (GSource *source)
   return retval;
 }
 
+/* translates and queues all the pending X events; the XI2 motion
+ * events followed by another motion of the same device are dropped
+ * before being translated, and their positions are added to the
+ * history of the motion event they were compressed into
+ */
 static void
 events_queue (ClutterBackendX11 *backend_x11)
 {
   ClutterBackend *backend = CLUTTER_BACKEND (backend_x11);
   Display *xdisplay = backend_x11->xdpy;
-  ClutterEvent *event;
-  XEvent xevent;
+  ClutterDeviceManagerXI2 *manager_xi2 = NULL;
+  XEvent xevents[EVENTS_BATCH_SIZE];
+  GArray *samples = NULL;
+  int i, n_events;
+
+#ifdef HAVE_XGE
+  if (CLUTTER_IS_DEVICE_MANAGER_XI2 (backend_x11->device_manager))
+    manager_xi2 = CLUTTER_DEVICE_MANAGER_XI2 (backend_x11->device_manager);
+#endif
 
-  while (!clutter_events_pending () && XPending (xdisplay))
+  while (XPending (xdisplay))
     {
-      XNextEvent (xdisplay, &xevent);
+      n_events = 0;
 
-      event = clutter_event_new (CLUTTER_NOTHING);
+      while (n_events < EVENTS_BATCH_SIZE &&
+             XEventsQueued (xdisplay, QueuedAlready) > 0)
+        {
+          XNextEvent (xdisplay, &xevents[n_events]);
 
 #ifdef HAVE_XGE
-      XGetEventData (xdisplay, &xevent.xcookie);
+          XGetEventData (xdisplay, &xevents[n_events].xcookie);
 #endif
 
-      if (_clutter_backend_translate_event (backend, &xevent, event))
-        _clutter_event_push (event, FALSE);
-      else
-        clutter_event_free (event);
+          n_events += 1;
+        }
+
+      for (i = 0; i < n_events; i++)
+        {
+          ClutterEventSample sample;
+          ClutterEvent *event;
+          guint j;
+
+          if (manager_xi2 != NULL && i + 1 < n_events &&
+              _clutter_device_manager_xi2_compress_motion (manager_xi2,
+                                                           &xevents[i],
+                                                           &xevents[i + 1],
+                                                           &sample))
+            {
+              if (samples == NULL)
+                samples = g_array_new (FALSE, FALSE, sizeof (ClutterEventSample));
+
+              g_array_append_val (samples, sample);
+              continue;
+            }
+
+          event = clutter_event_new (CLUTTER_NOTHING);
+
+          if (_clutter_backend_translate_event (backend, &xevents[i], event))
+            {
+              /* the compressed motions can become a smooth scroll */
+              if (samples != NULL && event->type == CLUTTER_MOTION)
+                {
+                  for (j = 0; j < samples->len; j++)
+                    {
+                      const ClutterEventSample *prev =
+                        &g_array_index (samples, ClutterEventSample, j);
+
+                      _clutter_event_add_history_sample (event,
+                                                         prev->time,
+                                                         prev->x,
+                                                         prev->y);
+                    }
+                }
+
+              _clutter_event_push (event, FALSE);
+            }
+          else
+            clutter_event_free (event);
+
+          if (samples != NULL)
+            g_array_set_size (samples, 0);
+        }
 
 #ifdef HAVE_XGE
-      XFreeEventData (xdisplay, &xevent.xcookie);
+      for (i = 0; i < n_events; i++)
+        XFreeEventData (xdisplay, &xevents[i].xcookie);
 #endif
     }
+
+  if (samples != NULL)
+    g_array_free (samples, TRUE);
 }
 
 static gboolean
@@ -316,13 +384,11 @@ clutter_event_dispatch (GSource     *source,
   */
   events_queue (backend);
 
-  /* Pop an event off the queue if any */
-  event = clutter_event_get ();
-  if (event != NULL)
-    {
-      /* forward the event into clutter for emission etc. */
-      _clutter_stage_queue_event (event->any.stage, event, FALSE);
-    }
+  /* forward all the queued events into clutter for emission etc.,
+   * instead of one per iteration of the main loop
+   */
+  while ((event = clutter_event_get ()) != NULL)
+    _clutter_stage_queue_event (event->any.stage, event, FALSE);
 
   _clutter_threads_release_lock ();
 
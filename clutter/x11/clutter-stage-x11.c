@@ -1106,9 +1106,9 @@ clutter_stage_x11_translate_event (ClutterEventTranslator *translator,
                 g_source_remove (stage_x11->clipped_redraws_cool_off);
 
               stage_x11->clipped_redraws_cool_off =
-                clutter_threads_add_timeout (1000,
-                                             clipped_redraws_cool_off_cb,
-                                             stage_x11);
+                clutter_threads_add_coalesced_timeout (1000, 250,
+                                                       clipped_redraws_cool_off_cb,
+                                                       stage_x11);
 
               /* Queue a relayout - we want glViewport to be called
                * with the correct values, and this is done in ClutterStage
@@ -54,6 +54,8 @@
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 
+#include <math.h>
+
 #include <cogl/cogl.h>
 
 #include <cogl/cogl-texture-pixmap-x11.h>
@@ -124,6 +126,10 @@ struct _ClutterX11TexturePixmapPrivate
   gint          window_x, window_y;
   gint          window_width, window_height;
 
+  /* the damage reported by the events that announced more events */
+  gint          damage_x1, damage_y1;
+  gint          damage_x2, damage_y2;
+
   guint window_redirect_automatic : 1;
   /* FIXME: this is inconsistently either whether the window is mapped or whether
    * it is viewable, and isn't updated correctly. */
@@ -132,6 +138,7 @@ struct _ClutterX11TexturePixmapPrivate
   guint owns_pixmap               : 1;
   guint override_redirect         : 1;
   guint automatic_updates         : 1;
+  guint has_pending_damage        : 1;
 };
 
 static int _damage_event_base = 0;
@@ -164,14 +171,45 @@ static void
 process_damage_event (ClutterX11TexturePixmap *texture,
                       XDamageNotifyEvent *damage_event)
 {
-  /* Cogl will deal with updating the texture and subtracting from the
-     damage region so we only need to queue a redraw */
+  ClutterX11TexturePixmapPrivate *priv = texture->priv;
+  const XRectangle *area = &damage_event->area;
+
+  if (area->width > 0 && area->height > 0)
+    {
+      if (!priv->has_pending_damage)
+        {
+          priv->damage_x1 = area->x;
+          priv->damage_y1 = area->y;
+          priv->damage_x2 = area->x + area->width;
+          priv->damage_y2 = area->y + area->height;
+          priv->has_pending_damage = TRUE;
+        }
+      else
+        {
+          priv->damage_x1 = MIN (priv->damage_x1, area->x);
+          priv->damage_y1 = MIN (priv->damage_y1, area->y);
+          priv->damage_x2 = MAX (priv->damage_x2, area->x + area->width);
+          priv->damage_y2 = MAX (priv->damage_y2, area->y + area->height);
+        }
+    }
+
+  /* the events of a single damage report are queued together, so we
+   * only queue one redraw for all of them
+   */
+  if (damage_event->more || !priv->has_pending_damage)
+    return;
+
+  priv->has_pending_damage = FALSE;
+
+  /* Cogl will deal with updating the damaged area of the texture and
+     subtracting from the damage region so we only need to queue a
+     redraw */
   g_signal_emit (texture, signals[QUEUE_DAMAGE_REDRAW],
                  0,
-                 damage_event->area.x,
-                 damage_event->area.y,
-                 damage_event->area.width,
-                 damage_event->area.height);
+                 priv->damage_x1,
+                 priv->damage_y1,
+                 priv->damage_x2 - priv->damage_x1,
+                 priv->damage_y2 - priv->damage_y1);
 }
 
 static ClutterX11FilterReturn
@@ -321,6 +359,7 @@ free_damage_resources (ClutterX11TexturePixmap *texture)
       XSync (dpy, FALSE);
       clutter_x11_untrap_x_errors ();
       priv->damage = None;
+      priv->has_pending_damage = FALSE;
 
       clutter_x11_remove_filter (on_x_event_filter, (gpointer)texture);
 
@@ -348,6 +387,7 @@ clutter_x11_texture_pixmap_real_queue_damage_redraw (
   ClutterActorBox allocation;
   float scale_x, scale_y;
   cairo_rectangle_int_t clip;
+  gint x1, y1, x2, y2;
 
   /* NB: clutter_actor_queue_clipped_redraw expects a box in the actor's
    * coordinate space so we need to convert from pixmap coordinates to
@@ -371,13 +411,25 @@ clutter_x11_texture_pixmap_real_queue_damage_redraw (
 
   clutter_actor_get_allocation_box (self, &allocation);
 
+  /* the damage outside of the pixmap is never painted */
+  x1 = MAX (x, 0);
+  y1 = MAX (y, 0);
+  x2 = MIN (x + width, (gint) priv->pixmap_width);
+  y2 = MIN (y + height, (gint) priv->pixmap_height);
+
+  if (x2 <= x1 || y2 <= y1)
+    return;
+
   scale_x = (allocation.x2 - allocation.x1) / priv->pixmap_width;
   scale_y = (allocation.y2 - allocation.y1) / priv->pixmap_height;
 
-  clip.x = x * scale_x;
-  clip.y = y * scale_y;
-  clip.width = width * scale_x;
-  clip.height = height * scale_y;
+  /* round outwards, so that the pixels of the actor that are only
+   * partially covered by the damage are painted again as well
+   */
+  clip.x = floorf (x1 * scale_x);
+  clip.y = floorf (y1 * scale_y);
+  clip.width = ceilf (x2 * scale_x) - clip.x;
+  clip.height = ceilf (y2 * scale_y) - clip.y;
   clutter_actor_queue_redraw_with_clip (self, &clip);
 }
 
@@ -855,6 +907,10 @@ clutter_x11_texture_pixmap_set_pixmap (ClutterX11TexturePixmap *texture,
       priv->pixmap = pixmap;
       new_pixmap = TRUE;
 
+      _clutter_actor_set_client_buffer (CLUTTER_ACTOR (texture),
+                                        CLUTTER_CLIENT_BUFFER_X11_PIXMAP,
+                                        GUINT_TO_POINTER (pixmap));
+
       /* The damage object is created on the pixmap, so it needs to be
        * recreated with a change in pixmap.
        */
@@ -735,7 +735,72 @@ actor_pivot (void)
   g_assert (cogl_matrix_equal (&result_implicit, &result_explicit));
 }
 
+static void
+assert_stage_point (ClutterActor *actor,
+                    gfloat        x,
+                    gfloat        y)
+{
+  ClutterVertex point = CLUTTER_VERTEX_INIT (5, 5, 0);
+  ClutterVertex vertex;
+
+  clutter_actor_apply_relative_transform_to_point (actor, NULL, &point, &vertex);
+
+  g_assert_cmpfloat (vertex.x, ==, x);
+  g_assert_cmpfloat (vertex.y, ==, y);
+}
+
+static void
+actor_cached_transform (void)
+{
+  ClutterActor *stage, *parent, *child, *other;
+  ClutterActorBox parent_box = CLUTTER_ACTOR_BOX_INIT (10, 20, 110, 120);
+  ClutterActorBox child_box = CLUTTER_ACTOR_BOX_INIT (5, 5, 15, 15);
+
+  stage = clutter_test_get_stage ();
+
+  parent = clutter_actor_new ();
+  child = clutter_actor_new ();
+  other = clutter_actor_new ();
+
+  clutter_actor_add_child (stage, parent);
+  clutter_actor_add_child (stage, other);
+  clutter_actor_add_child (parent, child);
+
+  clutter_actor_allocate (parent, &parent_box, CLUTTER_ALLOCATION_NONE);
+  clutter_actor_allocate (other, &parent_box, CLUTTER_ALLOCATION_NONE);
+  clutter_actor_allocate (child, &child_box, CLUTTER_ALLOCATION_NONE);
+
+  assert_stage_point (child, 20, 30);
+
+  /* the second query uses the cached matrices */
+  assert_stage_point (child, 20, 30);
+
+  /* changing an ancestor invalidates the descendants */
+  clutter_actor_set_translation (parent, 100, 0, 0);
+  assert_stage_point (child, 120, 30);
+
+  clutter_actor_set_scale (parent, 2, 2);
+  assert_stage_point (child, 130, 40);
+
+  /* changing the actor itself does not affect its parent */
+  clutter_actor_set_translation (child, 0, 10, 0);
+  assert_stage_point (child, 130, 60);
+  assert_stage_point (parent, 120, 30);
+
+  /* moving the actor to another parent */
+  g_object_ref (child);
+  clutter_actor_remove_child (parent, child);
+  clutter_actor_add_child (other, child);
+  g_object_unref (child);
+
+  assert_stage_point (child, 20, 40);
+
+  clutter_actor_destroy (parent);
+  clutter_actor_destroy (other);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/transforms/anchor-point", actor_anchors)
   CLUTTER_TEST_UNIT ("/actor/transforms/pivot-point", actor_pivot)
+  CLUTTER_TEST_UNIT ("/actor/transforms/cached", actor_cached_transform)
 )
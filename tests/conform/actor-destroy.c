@@ -190,6 +190,44 @@ actor_destruction (void)
   g_assert_null (test);
 }
 
+static void
+actor_destruction_deferred (void)
+{
+  ClutterActor *parent = clutter_actor_new ();
+  ClutterActor *root = clutter_actor_new ();
+  ClutterActor *child = clutter_actor_new ();
+  ClutterActor *grandchild = clutter_actor_new ();
+  gboolean destroy_called = FALSE;
+
+  g_object_ref_sink (parent);
+
+  clutter_actor_add_child (parent, root);
+  clutter_actor_add_child (root, child);
+  clutter_actor_add_child (child, grandchild);
+
+  g_object_add_weak_pointer (G_OBJECT (root), (gpointer *) &root);
+  g_object_add_weak_pointer (G_OBJECT (grandchild), (gpointer *) &grandchild);
+  g_signal_connect (grandchild, "destroy", G_CALLBACK (on_destroy), &destroy_called);
+
+  clutter_actor_destroy_deferred (root);
+
+  /* detached right away, destroyed later */
+  g_assert_cmpint (clutter_actor_get_n_children (parent), ==, 0);
+  g_assert_nonnull (root);
+  g_assert (!destroy_called);
+
+  /* destroying an actor of the subtree before its turn is safe */
+  clutter_actor_destroy (child);
+  g_assert (destroy_called);
+  g_assert_null (grandchild);
+
+  while (root != NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_object_unref (parent);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/destruction", actor_destruction)
+  CLUTTER_TEST_UNIT ("/actor/destruction-deferred", actor_destruction_deferred)
 )
@@ -536,6 +536,136 @@ actor_contains (void)
                        expected_results[x * 10 + y]);
 }
 
+static void
+count_signal (gint *counter)
+{
+  *counter += 1;
+}
+
+static void
+actor_batch_children (void)
+{
+  ClutterActorBox box = CLUTTER_ACTOR_BOX_INIT (0, 0, 100, 100);
+  ClutterActor *parent, *actor;
+  ClutterActor *children[4];
+  int add_count = 0, remove_count = 0, relayout_count = 0;
+  int i;
+
+  parent = clutter_actor_new ();
+  g_object_ref_sink (parent);
+
+  actor = clutter_actor_new ();
+  clutter_actor_add_child (parent, actor);
+
+  /* clear the relayout flags */
+  clutter_actor_allocate (parent, &box, CLUTTER_ALLOCATION_NONE);
+
+  g_signal_connect_swapped (actor, "actor-added",
+                            G_CALLBACK (count_signal),
+                            &add_count);
+  g_signal_connect_swapped (actor, "actor-removed",
+                            G_CALLBACK (count_signal),
+                            &remove_count);
+  g_signal_connect_swapped (parent, "queue-relayout",
+                            G_CALLBACK (count_signal),
+                            &relayout_count);
+
+  for (i = 0; i < G_N_ELEMENTS (children); i++)
+    children[i] = clutter_actor_new ();
+
+  clutter_actor_freeze_layout (actor);
+  clutter_actor_add_children (actor, children, G_N_ELEMENTS (children));
+
+  g_assert_cmpint (add_count, ==, G_N_ELEMENTS (children));
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, G_N_ELEMENTS (children));
+  g_assert (clutter_actor_get_first_child (actor) == children[0]);
+  g_assert (clutter_actor_get_last_child (actor) == children[3]);
+
+  /* the relayout is only propagated when thawing */
+  g_assert_cmpint (relayout_count, ==, 0);
+  clutter_actor_thaw_layout (actor);
+  g_assert_cmpint (relayout_count, ==, 1);
+
+  clutter_actor_remove_children_range (actor, 1, 2);
+
+  g_assert_cmpint (remove_count, ==, 2);
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 2);
+  g_assert (clutter_actor_get_first_child (actor) == children[0]);
+  g_assert (clutter_actor_get_last_child (actor) == children[3]);
+
+  clutter_actor_remove_children_range (actor, 0, -1);
+
+  g_assert_cmpint (remove_count, ==, 4);
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 0);
+
+  clutter_actor_destroy (parent);
+  g_object_unref (parent);
+}
+
+static void
+actor_sort_children_by_z (void)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterActor *foo, *bar, *baz, *iter;
+
+  g_object_ref_sink (actor);
+
+  foo = g_object_new (CLUTTER_TYPE_ACTOR, "name", "foo", "z-position", 10.f, NULL);
+  bar = g_object_new (CLUTTER_TYPE_ACTOR, "name", "bar", "z-position", 20.f, NULL);
+  baz = g_object_new (CLUTTER_TYPE_ACTOR, "name", "baz", "z-position", 0.f, NULL);
+
+  /* the order is not changed until sorting is enabled */
+  clutter_actor_insert_child_at_index (actor, bar, 0);
+  clutter_actor_insert_child_at_index (actor, foo, 0);
+  g_assert (clutter_actor_get_first_child (actor) == foo);
+
+  g_assert (!clutter_actor_get_sort_children_by_z (actor));
+  clutter_actor_set_sort_children_by_z (actor, TRUE);
+  g_assert (clutter_actor_get_sort_children_by_z (actor));
+
+  g_assert (clutter_actor_get_first_child (actor) == foo);
+  g_assert (clutter_actor_get_last_child (actor) == bar);
+
+  /* the requested index is ignored */
+  clutter_actor_insert_child_at_index (actor, baz, -1);
+
+  iter = clutter_actor_get_first_child (actor);
+  g_assert_cmpstr (clutter_actor_get_name (iter), ==, "baz");
+  iter = clutter_actor_get_next_sibling (iter);
+  g_assert_cmpstr (clutter_actor_get_name (iter), ==, "foo");
+  iter = clutter_actor_get_next_sibling (iter);
+  g_assert_cmpstr (clutter_actor_get_name (iter), ==, "bar");
+
+  /* changing the z-position moves the child */
+  clutter_actor_set_z_position (baz, 30.f);
+  g_assert (clutter_actor_get_first_child (actor) == foo);
+  g_assert (clutter_actor_get_last_child (actor) == baz);
+  g_assert (clutter_actor_get_previous_sibling (baz) == bar);
+
+  clutter_actor_set_z_position (bar, 5.f);
+  g_assert (clutter_actor_get_first_child (actor) == bar);
+  g_assert (clutter_actor_get_next_sibling (bar) == foo);
+  g_assert (clutter_actor_get_next_sibling (foo) == baz);
+
+  /* children at the same depth keep their order */
+  clutter_actor_set_z_position (bar, 10.f);
+  g_assert (clutter_actor_get_first_child (actor) == foo);
+  g_assert (clutter_actor_get_next_sibling (foo) == bar);
+
+  clutter_actor_remove_child (actor, foo);
+  g_assert (clutter_actor_get_first_child (actor) == bar);
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 2);
+
+  /* the order is kept when sorting is disabled */
+  clutter_actor_set_sort_children_by_z (actor, FALSE);
+  clutter_actor_set_z_position (bar, 40.f);
+  g_assert (clutter_actor_get_first_child (actor) == bar);
+  g_assert (clutter_actor_get_last_child (actor) == baz);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (actor);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/graph/add-child", actor_add_child)
   CLUTTER_TEST_UNIT ("/actor/graph/insert-child", actor_insert_child)
@@ -546,4 +676,6 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/graph/remove-all", actor_remove_all)
   CLUTTER_TEST_UNIT ("/actor/graph/container-signals", actor_container_signals)
   CLUTTER_TEST_UNIT ("/actor/graph/contains", actor_contains)
+  CLUTTER_TEST_UNIT ("/actor/graph/batch-children", actor_batch_children)
+  CLUTTER_TEST_UNIT ("/actor/graph/sort-children-by-z", actor_sort_children_by_z)
 )
@@ -1,5 +1,61 @@
 #include <clutter/clutter.h>
 
+typedef struct _CountActor      CountActor;
+typedef struct _CountActorClass CountActorClass;
+
+struct _CountActor
+{
+  ClutterActor parent_instance;
+
+  guint n_allocations;
+  guint n_height_requests;
+};
+
+struct _CountActorClass
+{
+  ClutterActorClass parent_class;
+};
+
+GType count_actor_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (CountActor, count_actor, CLUTTER_TYPE_ACTOR)
+
+static void
+count_actor_allocate (ClutterActor           *actor,
+                      const ClutterActorBox  *box,
+                      ClutterAllocationFlags  flags)
+{
+  ((CountActor *) actor)->n_allocations += 1;
+
+  CLUTTER_ACTOR_CLASS (count_actor_parent_class)->allocate (actor, box, flags);
+}
+
+static void
+count_actor_get_preferred_height (ClutterActor *actor,
+                                  gfloat        for_width,
+                                  gfloat       *min_height_p,
+                                  gfloat       *natural_height_p)
+{
+  ((CountActor *) actor)->n_height_requests += 1;
+
+  /* behave like wrapping text */
+  *min_height_p = *natural_height_p = for_width > 0 ? 10000.f / for_width : 0.f;
+}
+
+static void
+count_actor_class_init (CountActorClass *klass)
+{
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+
+  actor_class->allocate = count_actor_allocate;
+  actor_class->get_preferred_height = count_actor_get_preferred_height;
+}
+
+static void
+count_actor_init (CountActor *self)
+{
+}
+
 static void
 actor_basic_layout (void)
 {
@@ -86,7 +142,566 @@ actor_margin_layout (void)
   clutter_test_assert_actor_at_point (stage, &p, flower[2]);
 }
 
+static void
+on_after_paint (ClutterStage *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_paint (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong id;
+
+  id = g_signal_connect (stage, "after-paint",
+                         G_CALLBACK (on_after_paint),
+                         &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, id);
+}
+
+static void
+actor_relayout_boundary (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  CountActor *outer, *card;
+  ClutterActor *leaf;
+  ClutterPoint p;
+
+  outer = g_object_new (count_actor_get_type (), NULL);
+  clutter_actor_add_child (stage, CLUTTER_ACTOR (outer));
+
+  /* a fixed size makes the card a relayout boundary */
+  card = g_object_new (count_actor_get_type (), NULL);
+  clutter_actor_set_size (CLUTTER_ACTOR (card), 200, 200);
+  clutter_actor_add_child (CLUTTER_ACTOR (outer), CLUTTER_ACTOR (card));
+
+  leaf = clutter_actor_new ();
+  clutter_actor_set_background_color (leaf, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (leaf, 50, 50);
+  clutter_actor_add_child (CLUTTER_ACTOR (card), leaf);
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  g_assert (!clutter_actor_get_relayout_boundary (CLUTTER_ACTOR (card)));
+
+  /* resizing the leaf only allocates the card again */
+  outer->n_allocations = card->n_allocations = 0;
+  clutter_actor_set_size (leaf, 100, 100);
+  wait_for_paint (stage);
+
+  g_assert_cmpuint (card->n_allocations, ==, 1);
+  g_assert_cmpuint (outer->n_allocations, ==, 0);
+
+  clutter_point_init (&p, 75, 75);
+  clutter_test_assert_actor_at_point (stage, &p, leaf);
+
+  /* resizing the card itself still goes up to the stage */
+  outer->n_allocations = card->n_allocations = 0;
+  clutter_actor_set_size (CLUTTER_ACTOR (card), 300, 300);
+  wait_for_paint (stage);
+
+  g_assert_cmpuint (outer->n_allocations, ==, 1);
+  g_assert_cmpuint (card->n_allocations, ==, 1);
+
+  /* without a fixed size, the card must opt in */
+  clutter_actor_set_size (CLUTTER_ACTOR (card), -1, -1);
+  clutter_actor_set_relayout_boundary (CLUTTER_ACTOR (card), TRUE);
+  g_assert (clutter_actor_get_relayout_boundary (CLUTTER_ACTOR (card)));
+  wait_for_paint (stage);
+
+  outer->n_allocations = card->n_allocations = 0;
+  clutter_actor_set_size (leaf, 50, 50);
+  wait_for_paint (stage);
+
+  g_assert_cmpuint (card->n_allocations, ==, 1);
+  g_assert_cmpuint (outer->n_allocations, ==, 0);
+}
+
+static void
+actor_size_request_cache (void)
+{
+  CountActor *actor = g_object_new (count_actor_get_type (), NULL);
+  gfloat min_height, natural_height;
+  gint round, i;
+
+  g_object_ref_sink (actor);
+
+  /* a height-for-width layout probing more sizes than the initial
+   * size of the cache should only hit the actor once per size
+   */
+  for (round = 0; round < 3; round++)
+    {
+      for (i = 1; i <= 8; i++)
+        {
+          clutter_actor_get_preferred_height (CLUTTER_ACTOR (actor), i * 10.f,
+                                              &min_height,
+                                              &natural_height);
+          g_assert_cmpfloat (natural_height, ==, 10000.f / (i * 10.f));
+        }
+    }
+
+  g_assert_cmpuint (actor->n_height_requests, ==, 8);
+
+  /* the margins are not part of the cache key */
+  clutter_actor_set_margin_left (CLUTTER_ACTOR (actor), 10);
+  actor->n_height_requests = 0;
+
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (actor), 110.f, NULL, &natural_height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (actor), 110.f, NULL, &natural_height);
+
+  g_assert_cmpuint (actor->n_height_requests, ==, 1);
+  g_assert_cmpfloat (natural_height, ==, 100.f);
+
+  /* a relayout clears the cache */
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (actor));
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (actor), 110.f, NULL, &natural_height);
+
+  g_assert_cmpuint (actor->n_height_requests, ==, 2);
+
+  g_object_unref (actor);
+}
+
+static void
+assert_actor_position (ClutterActor *actor,
+                       gfloat        x,
+                       gfloat        y)
+{
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, x);
+  g_assert_cmpfloat (clutter_actor_get_y (actor), ==, y);
+}
+
+static ClutterActor *
+add_flow_item (ClutterActor *vase,
+               gfloat        width,
+               gfloat        height)
+{
+  ClutterActor *item = clutter_actor_new ();
+
+  clutter_actor_set_size (item, width, height);
+  clutter_actor_add_child (vase, item);
+
+  return item;
+}
+
+static void
+actor_flow_layout_changes (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterLayoutManager *flow;
+  ClutterActor *vase, *item[7];
+  gint i;
+
+  flow = clutter_flow_layout_new (CLUTTER_FLOW_HORIZONTAL);
+  clutter_flow_layout_set_snap_to_grid (CLUTTER_FLOW_LAYOUT (flow), FALSE);
+
+  vase = clutter_actor_new ();
+  clutter_actor_set_layout_manager (vase, flow);
+  clutter_actor_set_width (vase, 300);
+  clutter_actor_add_child (stage, vase);
+
+  for (i = 0; i < 5; i++)
+    item[i] = add_flow_item (vase, 100, 100);
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[2], 200, 0);
+  assert_actor_position (item[3], 0, 100);
+  assert_actor_position (item[4], 100, 100);
+
+  /* appending fills the last line, then starts a new one */
+  item[5] = add_flow_item (vase, 100, 100);
+  item[6] = add_flow_item (vase, 200, 50);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[0], 0, 0);
+  assert_actor_position (item[5], 200, 100);
+  assert_actor_position (item[6], 0, 200);
+  g_assert_cmpfloat (clutter_actor_get_height (vase), ==, 250);
+
+  /* removing a child moves the following ones back */
+  clutter_actor_remove_child (vase, item[1]);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[2], 100, 0);
+  assert_actor_position (item[3], 200, 0);
+  assert_actor_position (item[4], 0, 100);
+  assert_actor_position (item[6], 0, 200);
+
+  /* resizing a child changes the extent of its line */
+  clutter_actor_set_height (item[5], 150);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[5], 100, 100);
+  assert_actor_position (item[6], 0, 250);
+
+  /* hidden children are skipped */
+  clutter_actor_hide (item[0]);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[2], 0, 0);
+  assert_actor_position (item[5], 0, 100);
+  assert_actor_position (item[6], 100, 100);
+
+  clutter_actor_show (item[0]);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[2], 100, 0);
+
+  /* reordering the children does not emit any signal */
+  clutter_actor_set_child_below_sibling (vase, item[6], NULL);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[6], 0, 0);
+  assert_actor_position (item[0], 200, 0);
+  assert_actor_position (item[2], 0, 100);
+  assert_actor_position (item[5], 0, 200);
+
+  clutter_actor_destroy (vase);
+}
+
+static void
+actor_grid_layout_changes (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterLayoutManager *grid;
+  ClutterActor *table, *cell[4];
+  gint i;
+
+  grid = clutter_grid_layout_new ();
+
+  table = clutter_actor_new ();
+  clutter_actor_set_layout_manager (table, grid);
+  clutter_actor_add_child (stage, table);
+
+  for (i = 0; i < 4; i++)
+    {
+      cell[i] = clutter_actor_new ();
+      clutter_actor_set_size (cell[i], 100, 100);
+      clutter_grid_layout_attach (CLUTTER_GRID_LAYOUT (grid), cell[i],
+                                  i % 2, i / 2,
+                                  1, 1);
+    }
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  assert_actor_position (cell[1], 100, 0);
+  assert_actor_position (cell[3], 100, 100);
+
+  /* the cached requests are discarded when a child changes size */
+  clutter_actor_set_size (cell[0], 150, 50);
+  wait_for_paint (stage);
+
+  assert_actor_position (cell[1], 150, 0);
+  assert_actor_position (cell[3], 150, 100);
+  g_assert_cmpfloat (clutter_actor_get_width (table), ==, 250);
+
+  /* ... when a child is hidden */
+  clutter_actor_hide (cell[0]);
+  clutter_actor_hide (cell[2]);
+  wait_for_paint (stage);
+
+  assert_actor_position (cell[1], 0, 0);
+  assert_actor_position (cell[3], 0, 100);
+
+  /* ... and when a child is removed */
+  clutter_actor_remove_child (table, cell[1]);
+  wait_for_paint (stage);
+
+  assert_actor_position (cell[3], 0, 0);
+  g_assert_cmpfloat (clutter_actor_get_height (table), ==, 100);
+
+  clutter_actor_destroy (table);
+}
+
+static void
+actor_constraint_chain (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *first, *second, *third;
+
+  /* the bound actors are allocated before their sources */
+  third = clutter_actor_new ();
+  clutter_actor_set_size (third, 10, 10);
+  clutter_actor_add_child (stage, third);
+
+  second = clutter_actor_new ();
+  clutter_actor_set_size (second, 10, 10);
+  clutter_actor_add_child (stage, second);
+
+  first = clutter_actor_new ();
+  clutter_actor_set_size (first, 10, 10);
+  clutter_actor_set_position (first, 10, 20);
+  clutter_actor_add_child (stage, first);
+
+  clutter_actor_add_constraint (second, clutter_bind_constraint_new (first, CLUTTER_BIND_X, 100));
+  clutter_actor_add_constraint (third, clutter_bind_constraint_new (second, CLUTTER_BIND_X, 100));
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  assert_actor_position (second, 110, 0);
+  assert_actor_position (third, 210, 0);
+
+  /* moving the source updates the whole chain in the same frame */
+  clutter_actor_set_x (first, 50);
+  wait_for_paint (stage);
+
+  assert_actor_position (first, 50, 20);
+  assert_actor_position (second, 150, 0);
+  assert_actor_position (third, 250, 0);
+
+  /* without its source, the actor is placed by the stage again */
+  clutter_actor_destroy (second);
+  clutter_actor_set_x (first, 0);
+  wait_for_paint (stage);
+
+  assert_actor_position (third, 0, 0);
+
+  clutter_actor_destroy (first);
+  clutter_actor_destroy (third);
+}
+
+static void
+actor_fixed_position_move (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *container;
+  CountActor *child;
+  ClutterActorBox box;
+
+  child = g_object_new (count_actor_get_type (), NULL);
+  clutter_actor_set_size (CLUTTER_ACTOR (child), 50, 50);
+  clutter_actor_set_position (CLUTTER_ACTOR (child), 10, 10);
+  clutter_actor_add_child (stage, CLUTTER_ACTOR (child));
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  /* moving a child of the stage allocates it right away */
+  child->n_allocations = 0;
+  clutter_actor_set_position (CLUTTER_ACTOR (child), 100, 50);
+  g_assert_cmpuint (child->n_allocations, ==, 1);
+
+  clutter_actor_get_allocation_box (CLUTTER_ACTOR (child), &box);
+  g_assert_cmpfloat (box.x1, ==, 100);
+  g_assert_cmpfloat (box.y1, ==, 50);
+  g_assert_cmpfloat (box.x2, ==, 150);
+  g_assert_cmpfloat (box.y2, ==, 100);
+
+  /* the size of this container depends on the position of the child */
+  container = clutter_actor_new ();
+  g_object_ref (child);
+  clutter_actor_remove_child (stage, CLUTTER_ACTOR (child));
+  clutter_actor_add_child (container, CLUTTER_ACTOR (child));
+  clutter_actor_add_child (stage, container);
+  g_object_unref (child);
+  wait_for_paint (stage);
+
+  child->n_allocations = 0;
+  clutter_actor_set_x (CLUTTER_ACTOR (child), 200);
+  g_assert_cmpuint (child->n_allocations, ==, 0);
+
+  wait_for_paint (stage);
+  g_assert_cmpuint (child->n_allocations, ==, 1);
+  g_assert_cmpfloat (clutter_actor_get_width (container), ==, 250);
+
+  clutter_actor_destroy (container);
+}
+
+static void
+actor_allocation_easing (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterLayoutManager *box;
+  ClutterActor *container, *item[2];
+  ClutterAnimationMode mode;
+  ClutterActorBox alloc;
+  guint duration;
+  gint i;
+
+  box = clutter_box_layout_new ();
+  clutter_layout_manager_set_allocation_easing (box, CLUTTER_LINEAR, 100);
+  clutter_layout_manager_get_allocation_easing (box, &mode, &duration);
+  g_assert_cmpint (mode, ==, CLUTTER_LINEAR);
+  g_assert_cmpuint (duration, ==, 100);
+
+  container = clutter_actor_new ();
+  clutter_actor_set_layout_manager (container, box);
+  clutter_actor_add_child (stage, container);
+
+  for (i = 0; i < 2; i++)
+    {
+      item[i] = clutter_actor_new ();
+      clutter_actor_set_size (item[i], 100, 100);
+      clutter_actor_add_child (container, item[i]);
+    }
+
+  /* the first allocation is not animated */
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  assert_actor_position (item[1], 100, 0);
+
+  /* the resized child jumps, the following one moves */
+  clutter_actor_set_width (item[0], 200);
+  wait_for_paint (stage);
+
+  clutter_actor_get_allocation_box (item[0], &alloc);
+  g_assert_cmpfloat (alloc.x2, ==, 200);
+
+  clutter_actor_get_allocation_box (item[1], &alloc);
+  g_assert_cmpfloat (alloc.x1, <, 200);
+
+  /* without a transition of its own */
+  g_assert_null (clutter_actor_get_transition (item[1], "allocation"));
+
+  do
+    {
+      g_main_context_iteration (NULL, TRUE);
+      clutter_actor_get_allocation_box (item[1], &alloc);
+    }
+  while (alloc.x1 < 200);
+
+  assert_actor_position (item[1], 200, 0);
+
+  clutter_actor_destroy (container);
+}
+
+static void
+on_notify_count (GObject    *gobject,
+                 GParamSpec *pspec,
+                 guint      *n_notifies)
+{
+  *n_notifies += 1;
+}
+
+static void
+actor_coalesced_notify (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  guint n_notifies = 0;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, 50, 50);
+  clutter_actor_add_child (stage, actor);
+  g_signal_connect (actor, "notify::x",
+                    G_CALLBACK (on_notify_count),
+                    &n_notifies);
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  clutter_stage_set_coalesce_notifications (CLUTTER_STAGE (stage), TRUE);
+
+  /* the changes are only notified once, after the layout */
+  clutter_actor_set_x (actor, 10);
+  clutter_actor_set_x (actor, 20);
+  clutter_actor_set_x (actor, 30);
+  g_assert_cmpuint (n_notifies, ==, 0);
+
+  wait_for_paint (stage);
+  g_assert_cmpuint (n_notifies, ==, 1);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 30);
+
+  /* disabling the coalescing emits the held notifications */
+  clutter_actor_set_x (actor, 40);
+  clutter_stage_set_coalesce_notifications (CLUTTER_STAGE (stage), FALSE);
+  g_assert_cmpuint (n_notifies, ==, 2);
+
+  clutter_actor_set_x (actor, 50);
+  g_assert_cmpuint (n_notifies, ==, 3);
+
+  clutter_actor_destroy (actor);
+}
+
+#define N_BOX_ITEMS     10
+
+static void
+actor_layout_work_bounds (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterLayoutStats before, after;
+  ClutterActor *box, *card, *leaf;
+  ClutterActor *item[N_BOX_ITEMS];
+  gint i;
+
+  box = clutter_actor_new ();
+  clutter_actor_set_layout_manager (box, clutter_box_layout_new ());
+  clutter_actor_add_child (stage, box);
+
+  for (i = 0; i < N_BOX_ITEMS; i++)
+    item[i] = add_flow_item (box, 20, 20);
+
+  /* a fixed size makes the card a relayout boundary */
+  card = clutter_actor_new ();
+  clutter_actor_set_size (card, 100, 100);
+  clutter_actor_set_y (card, 100);
+  clutter_actor_add_child (stage, card);
+
+  leaf = add_flow_item (card, 10, 10);
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  /* a frame without changes does no layout work */
+  clutter_actor_get_layout_stats (&before);
+  wait_for_paint (stage);
+  clutter_actor_get_layout_stats (&after);
+
+  g_assert_cmpuint (after.n_measures - before.n_measures, ==, 0);
+  g_assert_cmpuint (after.n_allocations - before.n_allocations, ==, 0);
+  g_assert_cmpuint (after.n_relayout_roots - before.n_relayout_roots, ==, 0);
+
+  /* resizing a child of the box relayouts the stage once, measures
+   * the box a bounded number of times, and allocates each actor of
+   * the stage at most once
+   */
+  clutter_actor_get_layout_stats (&before);
+  clutter_actor_set_width (item[N_BOX_ITEMS / 2], 40);
+  wait_for_paint (stage);
+  clutter_actor_get_layout_stats (&after);
+
+  g_assert_cmpuint (after.n_relayout_roots - before.n_relayout_roots, ==, 1);
+  g_assert_cmpuint (after.n_measures - before.n_measures, <=, 4);
+  g_assert_cmpuint (after.n_allocations - before.n_allocations, <=, N_BOX_ITEMS + 4);
+  g_assert_cmpfloat (clutter_actor_get_width (box), ==, (N_BOX_ITEMS + 1) * 20);
+
+  /* resizing the leaf of the card only relayouts the card */
+  clutter_actor_get_layout_stats (&before);
+  clutter_actor_set_size (leaf, 20, 20);
+  wait_for_paint (stage);
+  clutter_actor_get_layout_stats (&after);
+
+  g_assert_cmpuint (after.n_relayout_roots - before.n_relayout_roots, ==, 1);
+  g_assert_cmpuint (after.n_measures - before.n_measures, ==, 0);
+  g_assert_cmpuint (after.n_allocations - before.n_allocations, <=, 2);
+
+  clutter_actor_destroy (card);
+  clutter_actor_destroy (box);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/layout/basic", actor_basic_layout)
   CLUTTER_TEST_UNIT ("/actor/layout/margin", actor_margin_layout)
+  CLUTTER_TEST_UNIT ("/actor/layout/relayout-boundary", actor_relayout_boundary)
+  CLUTTER_TEST_UNIT ("/actor/layout/size-request-cache", actor_size_request_cache)
+  CLUTTER_TEST_UNIT ("/actor/layout/flow-changes", actor_flow_layout_changes)
+  CLUTTER_TEST_UNIT ("/actor/layout/grid-changes", actor_grid_layout_changes)
+  CLUTTER_TEST_UNIT ("/actor/layout/constraint-chain", actor_constraint_chain)
+  CLUTTER_TEST_UNIT ("/actor/layout/coalesced-notify", actor_coalesced_notify)
+  CLUTTER_TEST_UNIT ("/actor/layout/fixed-position-move", actor_fixed_position_move)
+  CLUTTER_TEST_UNIT ("/actor/layout/allocation-easing", actor_allocation_easing)
+  CLUTTER_TEST_UNIT ("/actor/layout/work-bounds", actor_layout_work_bounds)
 )
@@ -0,0 +1,261 @@
+#include <clutter/clutter.h>
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_paint (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong id;
+
+  id = g_signal_connect (stage, "after-paint",
+                         G_CALLBACK (on_after_paint),
+                         &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, id);
+}
+
+static void
+on_paint (ClutterActor *actor,
+          gint         *n_paints)
+{
+  *n_paints += 1;
+}
+
+static void
+actor_occlusion_opaque (void)
+{
+  ClutterActor *stage, *below, *above;
+  gint n_paints = 0;
+
+  stage = clutter_test_get_stage ();
+
+  below = clutter_actor_new ();
+  clutter_actor_set_background_color (below, CLUTTER_COLOR_Red);
+  clutter_actor_set_position (below, 20, 20);
+  clutter_actor_set_size (below, 50, 50);
+  clutter_actor_add_child (stage, below);
+  g_signal_connect (below, "paint", G_CALLBACK (on_paint), &n_paints);
+
+  above = clutter_actor_new ();
+  clutter_actor_set_background_color (above, CLUTTER_COLOR_Blue);
+  clutter_actor_set_position (above, 10, 10);
+  clutter_actor_set_size (above, 100, 100);
+  clutter_actor_add_child (stage, above);
+
+  clutter_actor_show (stage);
+
+  if (g_test_verbose ())
+    g_print ("An actor covered by an opaque actor is not painted\n");
+
+  wait_for_paint (stage);
+  g_assert_cmpint (n_paints, ==, 0);
+
+  if (g_test_verbose ())
+    g_print ("An actor covered by a translucent actor is painted\n");
+
+  clutter_actor_set_opacity (above, 128);
+  wait_for_paint (stage);
+  g_assert_cmpint (n_paints, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("An actor partially covered by an opaque actor is painted\n");
+
+  clutter_actor_set_opacity (above, 255);
+  clutter_actor_set_position (below, 80, 80);
+  wait_for_paint (stage);
+  g_assert_cmpint (n_paints, ==, 2);
+
+  if (g_test_verbose ())
+    g_print ("An actor painted above an opaque actor is painted\n");
+
+  clutter_actor_set_position (below, 20, 20);
+  clutter_actor_set_child_above_sibling (stage, below, above);
+  wait_for_paint (stage);
+  g_assert_cmpint (n_paints, ==, 3);
+}
+
+static void
+on_screen_notify (ClutterActor *actor,
+                  GParamSpec   *pspec,
+                  gint         *n_notifies)
+{
+  *n_notifies += 1;
+}
+
+static void
+actor_occlusion_on_screen (void)
+{
+  ClutterActor *stage, *clip, *actor, *above;
+  gint n_notifies = 0;
+
+  stage = clutter_test_get_stage ();
+
+  clip = clutter_actor_new ();
+  clutter_actor_set_size (clip, 200, 200);
+  clutter_actor_set_clip_to_allocation (clip, TRUE);
+  clutter_actor_add_child (stage, clip);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_Red);
+  clutter_actor_set_position (actor, 20, 20);
+  clutter_actor_set_size (actor, 50, 50);
+  clutter_actor_set_track_visibility (actor, TRUE);
+  clutter_actor_add_child (clip, actor);
+  g_signal_connect (actor, "notify::on-screen",
+                    G_CALLBACK (on_screen_notify),
+                    &n_notifies);
+
+  clutter_actor_show (stage);
+
+  if (g_test_verbose ())
+    g_print ("An actor inside the stage is on screen\n");
+
+  wait_for_paint (stage);
+  g_assert (clutter_actor_is_on_screen (actor));
+  g_assert_cmpint (n_notifies, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("An actor outside of the clip of its parent is off screen\n");
+
+  clutter_actor_set_position (actor, 300, 20);
+  wait_for_paint (stage);
+  g_assert (!clutter_actor_is_on_screen (actor));
+  g_assert_cmpint (n_notifies, ==, 2);
+
+  if (g_test_verbose ())
+    g_print ("The changes within a frame are coalesced\n");
+
+  clutter_actor_set_position (actor, 20, 20);
+  clutter_actor_set_position (actor, 300, 20);
+  wait_for_paint (stage);
+  g_assert (!clutter_actor_is_on_screen (actor));
+  g_assert_cmpint (n_notifies, ==, 2);
+
+  if (g_test_verbose ())
+    g_print ("A transparent actor is off screen\n");
+
+  clutter_actor_set_position (actor, 20, 20);
+  clutter_actor_set_opacity (clip, 0);
+  wait_for_paint (stage);
+  g_assert (!clutter_actor_is_on_screen (actor));
+
+  if (g_test_verbose ())
+    g_print ("An actor covered by an opaque actor is off screen\n");
+
+  clutter_actor_set_opacity (clip, 255);
+  above = clutter_actor_new ();
+  clutter_actor_set_background_color (above, CLUTTER_COLOR_Blue);
+  clutter_actor_set_size (above, 100, 100);
+  clutter_actor_add_child (clip, above);
+  wait_for_paint (stage);
+  g_assert (!clutter_actor_is_on_screen (actor));
+
+  clutter_actor_destroy (above);
+  wait_for_paint (stage);
+  g_assert (clutter_actor_is_on_screen (actor));
+
+  if (g_test_verbose ())
+    g_print ("A hidden actor is off screen\n");
+
+  clutter_actor_hide (actor);
+  g_assert (!clutter_actor_is_on_screen (actor));
+
+  clutter_actor_destroy (clip);
+}
+
+static void
+assert_pixel (ClutterActor *stage,
+              int           x,
+              int           y,
+              guint8        red,
+              guint8        green,
+              guint8        blue)
+{
+  guchar *pixel;
+
+  pixel = clutter_stage_read_pixels (CLUTTER_STAGE (stage), x, y, 1, 1);
+
+  g_assert_cmpint (ABS ((int) red - (int) pixel[0]), <=, 2);
+  g_assert_cmpint (ABS ((int) green - (int) pixel[1]), <=, 2);
+  g_assert_cmpint (ABS ((int) blue - (int) pixel[2]), <=, 2);
+
+  g_free (pixel);
+}
+
+static void
+actor_occlusion_depth_sorted (void)
+{
+  ClutterActor *stage, *back, *card, *child, *glass;
+
+  stage = clutter_test_get_stage ();
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+
+  g_assert (!clutter_stage_get_depth_sorted_paint (CLUTTER_STAGE (stage)));
+  clutter_stage_set_depth_sorted_paint (CLUTTER_STAGE (stage), TRUE);
+  g_assert (clutter_stage_get_depth_sorted_paint (CLUTTER_STAGE (stage)));
+
+  back = clutter_actor_new ();
+  clutter_actor_set_background_color (back, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (back, 100, 100);
+  clutter_actor_add_child (stage, back);
+
+  card = clutter_actor_new ();
+  clutter_actor_set_background_color (card, CLUTTER_COLOR_Blue);
+  clutter_actor_set_position (card, 50, 0);
+  clutter_actor_set_size (card, 100, 100);
+  clutter_actor_add_child (stage, card);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_background_color (child, CLUTTER_COLOR_Green);
+  clutter_actor_set_position (child, 25, 25);
+  clutter_actor_set_size (child, 50, 50);
+  clutter_actor_add_child (card, child);
+
+  glass = clutter_actor_new ();
+  clutter_actor_set_background_color (glass, CLUTTER_COLOR_White);
+  clutter_actor_set_opacity (glass, 128);
+  clutter_actor_set_position (glass, 0, 50);
+  clutter_actor_set_size (glass, 200, 100);
+  clutter_actor_add_child (stage, glass);
+
+  clutter_actor_show (stage);
+
+  if (g_test_verbose ())
+    g_print ("The actors painted later are above the opaque ones
+");
+
+  assert_pixel (stage, 25, 25, 255, 0, 0);
+  assert_pixel (stage, 125, 25, 0, 0, 255);
+  assert_pixel (stage, 85, 40, 0, 255, 0);
+  assert_pixel (stage, 25, 75, 255, 128, 128);
+  assert_pixel (stage, 85, 60, 128, 255, 128);
+  assert_pixel (stage, 175, 125, 128, 128, 128);
+
+  if (g_test_verbose ())
+    g_print ("The paint order is kept when the children change
+");
+
+  clutter_actor_set_child_below_sibling (stage, card, back);
+  assert_pixel (stage, 75, 25, 255, 0, 0);
+  assert_pixel (stage, 125, 25, 0, 0, 255);
+
+  clutter_stage_set_depth_sorted_paint (CLUTTER_STAGE (stage), FALSE);
+  assert_pixel (stage, 75, 25, 255, 0, 0);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/occlusion/opaque", actor_occlusion_opaque)
+  CLUTTER_TEST_UNIT ("/actor/occlusion/on-screen", actor_occlusion_on_screen)
+  CLUTTER_TEST_UNIT ("/actor/occlusion/depth-sorted", actor_occlusion_depth_sorted)
+)
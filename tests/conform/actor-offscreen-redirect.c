@@ -290,6 +290,23 @@ run_verify (gpointer user_data)
   clutter_actor_set_position (data->unrelated_actor, 0, 1);
   verify_redraw (data, 0);
 
+  /* With the redirect for static actors, the actor should be painted
+     directly until it has not changed for a few frames */
+  clutter_actor_set_offscreen_redirect (data->container,
+                                        CLUTTER_OFFSCREEN_REDIRECT_AUTOMATIC_FOR_STATIC);
+  verify_redraw (data, 1);
+  verify_redraw (data, 1);
+
+  /* The third static paint fills the cache */
+  verify_redraw (data, 1);
+  verify_redraw (data, 0);
+  verify_redraw (data, 0);
+
+  /* Any change to a child should drop the cache */
+  clutter_actor_queue_redraw (data->child);
+  verify_redraw (data, 1);
+  verify_redraw (data, 1);
+
   data->was_painted = TRUE;
 
   return G_SOURCE_REMOVE;
@@ -0,0 +1,311 @@
+#include <clutter/clutter.h>
+
+typedef struct _FooActor      FooActor;
+typedef struct _FooActorClass FooActorClass;
+
+struct _FooActorClass
+{
+  ClutterActorClass parent_class;
+};
+
+struct _FooActor
+{
+  ClutterActor parent;
+
+  guint8 last_paint_opacity;
+  int n_builds;
+};
+
+GType foo_actor_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (FooActor, foo_actor, CLUTTER_TYPE_ACTOR)
+
+static void
+foo_actor_paint_node (ClutterActor     *actor,
+                      ClutterPaintNode *root)
+{
+  FooActor *foo_actor = (FooActor *) actor;
+  ClutterColor color = { 255, 0, 0, 255 };
+  ClutterPaintNode *node;
+  ClutterActorBox box;
+
+  foo_actor->last_paint_opacity = clutter_actor_get_paint_opacity (actor);
+  foo_actor->n_builds += 1;
+
+  color.alpha = foo_actor->last_paint_opacity;
+
+  clutter_actor_get_allocation_box (actor, &box);
+  clutter_actor_box_set_origin (&box, 0.f, 0.f);
+
+  node = clutter_color_node_new (&color);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+}
+
+static void
+foo_actor_class_init (FooActorClass *klass)
+{
+  CLUTTER_ACTOR_CLASS (klass)->paint_node = foo_actor_paint_node;
+}
+
+static void
+foo_actor_init (FooActor *self)
+{
+}
+
+typedef struct _RoundedActor      RoundedActor;
+typedef struct _RoundedActorClass RoundedActorClass;
+
+struct _RoundedActorClass
+{
+  ClutterActorClass parent_class;
+};
+
+struct _RoundedActor
+{
+  ClutterActor parent;
+};
+
+GType rounded_actor_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (RoundedActor, rounded_actor, CLUTTER_TYPE_ACTOR)
+
+static void
+rounded_actor_paint_node (ClutterActor     *actor,
+                          ClutterPaintNode *root)
+{
+  ClutterPaintNode *node;
+  ClutterActorBox box;
+
+  clutter_actor_get_allocation_box (actor, &box);
+  clutter_actor_box_set_origin (&box, 0.f, 0.f);
+
+  /* a circle, with a blue border */
+  node = clutter_rounded_rect_node_new (CLUTTER_COLOR_Red, 50.f);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+
+  node = clutter_border_node_new (CLUTTER_COLOR_Blue, 50.f, 10.f);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+}
+
+static void
+rounded_actor_class_init (RoundedActorClass *klass)
+{
+  CLUTTER_ACTOR_CLASS (klass)->paint_node = rounded_actor_paint_node;
+}
+
+static void
+rounded_actor_init (RoundedActor *self)
+{
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_paint (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong id;
+
+  id = g_signal_connect (stage, "after-paint",
+                         G_CALLBACK (on_after_paint),
+                         &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, id);
+}
+
+static void
+actor_paint_nodes_retained (void)
+{
+  ClutterActor *stage, *group;
+  FooActor *foo;
+
+  stage = clutter_test_get_stage ();
+
+  group = clutter_actor_new ();
+  clutter_actor_add_child (stage, group);
+
+  foo = g_object_new (foo_actor_get_type (), NULL);
+  clutter_actor_set_position (CLUTTER_ACTOR (foo), 10, 10);
+  clutter_actor_set_size (CLUTTER_ACTOR (foo), 50, 50);
+  clutter_actor_add_child (group, CLUTTER_ACTOR (foo));
+
+  clutter_actor_show (stage);
+
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("Repainting the stage does not rebuild the paint nodes\n");
+
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("Moving the actor does not rebuild the paint nodes\n");
+
+  clutter_actor_set_position (CLUTTER_ACTOR (group), 20, 20);
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("Queueing a redraw rebuilds the paint nodes\n");
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (foo));
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 2);
+
+  if (g_test_verbose ())
+    g_print ("Resizing the actor rebuilds the paint nodes\n");
+
+  clutter_actor_set_size (CLUTTER_ACTOR (foo), 100, 100);
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 3);
+
+  if (g_test_verbose ())
+    g_print ("Changing the opacity of the parent rebuilds the paint nodes\n");
+
+  clutter_actor_set_opacity (group, 128);
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 4);
+  g_assert_cmpint (foo->last_paint_opacity, ==, 128);
+
+  wait_for_paint (stage);
+  g_assert_cmpint (foo->n_builds, ==, 4);
+}
+
+static void
+actor_paint_nodes_paint_volume (void)
+{
+  ClutterActor *stage, *group, *child;
+  const ClutterPaintVolume *pv;
+  ClutterVertex origin;
+
+  stage = clutter_test_get_stage ();
+
+  /* the volume of the group is the union of its allocation and of
+   * the volumes of its children
+   */
+  group = clutter_actor_new ();
+  clutter_actor_set_size (group, 10, 10);
+  clutter_actor_add_child (stage, group);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_background_color (child, CLUTTER_COLOR_Red);
+  clutter_actor_set_position (child, 10, 10);
+  clutter_actor_set_size (child, 50, 50);
+  clutter_actor_add_child (group, child);
+
+  clutter_actor_show (stage);
+  wait_for_paint (stage);
+
+  pv = clutter_actor_get_paint_volume (group);
+  g_assert (pv != NULL);
+  g_assert_cmpfloat (clutter_paint_volume_get_width (pv), ==, 60);
+
+  if (g_test_verbose ())
+    g_print ("Moving the child updates the volume of the parent\n");
+
+  clutter_actor_set_position (child, 40, 10);
+  wait_for_paint (stage);
+
+  pv = clutter_actor_get_paint_volume (group);
+  g_assert (pv != NULL);
+  g_assert_cmpfloat (clutter_paint_volume_get_width (pv), ==, 90);
+
+  if (g_test_verbose ())
+    g_print ("Adding a child updates the volume of the parent\n");
+
+  child = clutter_actor_new ();
+  clutter_actor_set_position (child, 0, 100);
+  clutter_actor_set_size (child, 10, 10);
+  clutter_actor_add_child (group, child);
+  wait_for_paint (stage);
+
+  pv = clutter_actor_get_paint_volume (group);
+  g_assert (pv != NULL);
+  g_assert_cmpfloat (clutter_paint_volume_get_height (pv), ==, 110);
+
+  if (g_test_verbose ())
+    g_print ("Hiding a child updates the volume of the parent\n");
+
+  clutter_actor_hide (child);
+  wait_for_paint (stage);
+
+  pv = clutter_actor_get_paint_volume (group);
+  g_assert (pv != NULL);
+  clutter_paint_volume_get_origin (pv, &origin);
+  g_assert_cmpfloat (origin.y, ==, 0);
+  g_assert_cmpfloat (clutter_paint_volume_get_height (pv), ==, 60);
+}
+
+static void
+assert_pixel (ClutterActor *stage,
+              int           x,
+              int           y,
+              guint8        red,
+              guint8        green,
+              guint8        blue)
+{
+  guchar *pixel;
+
+  pixel = clutter_stage_read_pixels (CLUTTER_STAGE (stage), x, y, 1, 1);
+
+  g_assert_cmpint (ABS ((int) red - (int) pixel[0]), <=, 2);
+  g_assert_cmpint (ABS ((int) green - (int) pixel[1]), <=, 2);
+  g_assert_cmpint (ABS ((int) blue - (int) pixel[2]), <=, 2);
+
+  g_free (pixel);
+}
+
+static void
+actor_paint_nodes_rounded (void)
+{
+  ClutterActor *stage, *actor;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    {
+      if (g_test_verbose ())
+        g_print ("Skipping the rounded rectangles: no GLSL support\n");
+      return;
+    }
+
+  stage = clutter_test_get_stage ();
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+
+  actor = g_object_new (rounded_actor_get_type (), NULL);
+  clutter_actor_set_size (actor, 100, 100);
+  clutter_actor_add_child (stage, actor);
+
+  clutter_actor_show (stage);
+
+  /* the center is filled, the border is inside the edges, and the
+   * corners are outside of the circle
+   */
+  assert_pixel (stage, 50, 50, 255, 0, 0);
+  assert_pixel (stage, 50, 4, 0, 0, 255);
+  assert_pixel (stage, 95, 50, 0, 0, 255);
+  assert_pixel (stage, 4, 4, 0, 0, 0);
+  assert_pixel (stage, 95, 95, 0, 0, 0);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/paint-nodes/retained", actor_paint_nodes_retained)
+  CLUTTER_TEST_UNIT ("/actor/paint-nodes/rounded", actor_paint_nodes_rounded)
+  CLUTTER_TEST_UNIT ("/actor/paint-nodes/paint-volume", actor_paint_nodes_paint_volume)
+)
@@ -255,7 +255,7 @@ on_timeout (gpointer data)
 }
 
 static void
-actor_pick (void)
+run_actor_pick (gboolean geometric)
 {
   int y, x;
   State state;
@@ -264,6 +264,8 @@ actor_pick (void)
 
   state.stage = clutter_test_get_stage ();
 
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (state.stage), geometric);
+
   state.actor_width = STAGE_WIDTH / ACTORS_X;
   state.actor_height = STAGE_HEIGHT / ACTORS_Y;
 
@@ -306,6 +308,261 @@ actor_pick (void)
   g_assert (state.pass);
 }
 
+static void
+actor_pick (void)
+{
+  run_actor_pick (FALSE);
+}
+
+static void
+actor_pick_geometric (void)
+{
+  run_actor_pick (TRUE);
+}
+
+/* runs @func after the first paint of the stage, so that the
+ * actors have a valid allocation
+ */
+static void
+run_after_paint (ClutterActor *stage,
+                 GSourceFunc   func,
+                 gpointer      data)
+{
+  gboolean done = FALSE;
+  gpointer check_data[2] = { data, &done };
+
+  clutter_actor_show (stage);
+
+  clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_POST_PAINT,
+                                         func,
+                                         check_data,
+                                         NULL);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static gboolean
+check_pick_cache (gpointer data)
+{
+  gpointer *check_data = data;
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *rect = check_data[0];
+  ClutterActor *actor;
+
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == rect);
+
+  /* the second pick at the same position is served by the cache */
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == rect);
+
+  /* changing the reactivity, the visibility or the scene graph must
+   * discard the cached results
+   */
+  clutter_actor_set_reactive (rect, FALSE);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == stage);
+
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_ALL,
+                                          50, 50);
+  g_assert (actor == rect);
+
+  clutter_actor_hide (rect);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_ALL,
+                                          50, 50);
+  g_assert (actor == stage);
+
+  clutter_actor_show (rect);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_ALL,
+                                          50, 50);
+  g_assert (actor == rect);
+
+  clutter_actor_destroy (rect);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_ALL,
+                                          50, 50);
+  g_assert (actor == stage);
+
+  *((gboolean *) check_data[1]) = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+actor_pick_cache (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *rect;
+
+  rect = clutter_actor_new ();
+  clutter_actor_set_background_color (rect, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (rect, 100, 100);
+  clutter_actor_set_reactive (rect, TRUE);
+  clutter_actor_add_child (stage, rect);
+
+  run_after_paint (stage, check_pick_cache, rect);
+}
+
+static gboolean
+check_pick_multiple (gpointer data)
+{
+  gpointer *check_data = data;
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor **rects = check_data[0];
+  ClutterActor *actors[ACTORS_X + 1];
+  ClutterPoint positions[ACTORS_X + 1];
+  float width = STAGE_WIDTH / ACTORS_X;
+  int i;
+
+  for (i = 0; i < ACTORS_X; i++)
+    {
+      positions[i].x = i * width + width / 2;
+      positions[i].y = 50;
+    }
+
+  /* the last position is not covered by any actor */
+  positions[ACTORS_X].x = 10;
+  positions[ACTORS_X].y = 200;
+
+  clutter_stage_get_actors_at_positions (CLUTTER_STAGE (stage),
+                                         CLUTTER_PICK_ALL,
+                                         positions,
+                                         G_N_ELEMENTS (positions),
+                                         actors);
+
+  for (i = 0; i < ACTORS_X; i++)
+    g_assert (actors[i] == rects[i]);
+
+  g_assert (actors[ACTORS_X] == stage);
+
+  *((gboolean *) check_data[1]) = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+run_actor_pick_multiple (gboolean geometric)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *rects[ACTORS_X];
+  float width = STAGE_WIDTH / ACTORS_X;
+  int i;
+
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (stage), geometric);
+
+  for (i = 0; i < ACTORS_X; i++)
+    {
+      rects[i] = clutter_actor_new ();
+      clutter_actor_set_background_color (rects[i], CLUTTER_COLOR_Blue);
+      clutter_actor_set_position (rects[i], i * width, 0);
+      clutter_actor_set_size (rects[i], width, 100);
+      clutter_actor_add_child (stage, rects[i]);
+    }
+
+  run_after_paint (stage, check_pick_multiple, rects);
+}
+
+static void
+actor_pick_multiple (void)
+{
+  run_actor_pick_multiple (FALSE);
+}
+
+static void
+actor_pick_multiple_geometric (void)
+{
+  run_actor_pick_multiple (TRUE);
+}
+
+static gboolean
+check_pick_reactive_subtree (gpointer data)
+{
+  gpointer *check_data = data;
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *container = check_data[0];
+  ClutterActor *child = clutter_actor_get_first_child (container);
+  ClutterActor *grandchild = clutter_actor_get_first_child (child);
+  ClutterActor *actor;
+
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == grandchild);
+
+  /* the subtree has no reactive actors left */
+  clutter_actor_set_reactive (grandchild, FALSE);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == stage);
+
+  /* the non-reactive actors are still picked in the CLUTTER_PICK_ALL mode */
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_ALL,
+                                          50, 50);
+  g_assert (actor == grandchild);
+
+  /* moving a reactive actor inside the subtree makes it pickable again */
+  clutter_actor_set_reactive (grandchild, TRUE);
+  g_object_ref (child);
+  clutter_actor_remove_child (container, child);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == stage);
+
+  clutter_actor_add_child (container, child);
+  g_object_unref (child);
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          50, 50);
+  g_assert (actor == grandchild);
+
+  clutter_actor_destroy (container);
+
+  *((gboolean *) check_data[1]) = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+actor_pick_reactive_subtree (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *container, *child, *grandchild;
+
+  container = clutter_actor_new ();
+  clutter_actor_set_size (container, 200, 200);
+  clutter_actor_add_child (stage, container);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_size (child, 200, 200);
+  clutter_actor_add_child (container, child);
+
+  grandchild = clutter_actor_new ();
+  clutter_actor_set_background_color (grandchild, CLUTTER_COLOR_Green);
+  clutter_actor_set_size (grandchild, 100, 100);
+  clutter_actor_set_reactive (grandchild, TRUE);
+  clutter_actor_add_child (child, grandchild);
+
+  run_after_paint (stage, check_pick_reactive_subtree, container);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/pick", actor_pick)
+  CLUTTER_TEST_UNIT ("/actor/pick-geometric", actor_pick_geometric)
+  CLUTTER_TEST_UNIT ("/actor/pick-cache", actor_pick_cache)
+  CLUTTER_TEST_UNIT ("/actor/pick-multiple", actor_pick_multiple)
+  CLUTTER_TEST_UNIT ("/actor/pick-multiple-geometric", actor_pick_multiple_geometric)
+  CLUTTER_TEST_UNIT ("/actor/pick-reactive-subtree", actor_pick_reactive_subtree)
 )
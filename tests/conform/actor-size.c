@@ -210,7 +210,49 @@ actor_fixed_size (void)
   g_object_unref (rect);
 }
 
+static void
+actor_size_request_work (void)
+{
+  ClutterLayoutStats before, after;
+  ClutterActor *test;
+  gfloat nat_width, nat_height;
+
+  test = g_object_new (TEST_TYPE_ACTOR, NULL);
+  g_object_ref_sink (test);
+
+  /* the first request asks the actor for both sizes */
+  clutter_actor_get_layout_stats (&before);
+  clutter_actor_get_preferred_size (test, NULL, NULL, &nat_width, &nat_height);
+  clutter_actor_get_layout_stats (&after);
+
+  g_assert_cmpuint (after.n_measures - before.n_measures, >=, 2);
+  g_assert_cmpuint (after.n_measures - before.n_measures, <=, 3);
+
+  /* asking again without changes is served by the cache */
+  before = after;
+  clutter_actor_get_preferred_size (test, NULL, NULL, &nat_width, &nat_height);
+  clutter_actor_get_preferred_size (test, NULL, NULL, &nat_width, &nat_height);
+  clutter_actor_get_layout_stats (&after);
+
+  g_assert_cmpuint (after.n_measures - before.n_measures, ==, 0);
+  g_assert_cmpuint (after.n_measure_cache_hits - before.n_measure_cache_hits, >=, 4);
+  g_assert_cmpuint (after.n_allocations - before.n_allocations, ==, 0);
+
+  /* a fixed size never reaches the actor, nor the cache */
+  clutter_actor_set_size (test, 50, 50);
+  before = after;
+  clutter_actor_get_preferred_size (test, NULL, NULL, &nat_width, &nat_height);
+  clutter_actor_get_layout_stats (&after);
+
+  g_assert_cmpuint (after.n_measures - before.n_measures, ==, 0);
+  g_assert_cmpuint (after.n_measure_cache_hits - before.n_measure_cache_hits, ==, 0);
+
+  clutter_actor_destroy (test);
+  g_object_unref (test);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/size/preferred", actor_preferred_size)
   CLUTTER_TEST_UNIT ("/actor/size/fixed", actor_fixed_size)
+  CLUTTER_TEST_UNIT ("/actor/size/request-work", actor_size_request_work)
 )
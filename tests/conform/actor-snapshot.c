@@ -0,0 +1,95 @@
+#include <glib.h>
+#include <clutter/clutter.h>
+
+static void
+actor_snapshot_round_trip (void)
+{
+  ClutterActor *root, *copy;
+  ClutterActor *child, *text;
+  ClutterColor color = { 0x11, 0x22, 0x33, 0xff };
+  GError *error = NULL;
+  GBytes *snapshot;
+
+  root = clutter_actor_new ();
+  g_object_ref_sink (root);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_name (child, "box");
+  clutter_actor_set_position (child, 10, 20);
+  clutter_actor_set_size (child, 100, 50);
+  clutter_actor_set_opacity (child, 128);
+  clutter_actor_set_background_color (child, &color);
+  clutter_actor_set_layout_manager (child,
+                                    clutter_box_layout_new ());
+  clutter_box_layout_set_orientation (CLUTTER_BOX_LAYOUT (clutter_actor_get_layout_manager (child)),
+                                      CLUTTER_ORIENTATION_VERTICAL);
+  clutter_actor_add_child (root, child);
+
+  text = clutter_text_new_with_text ("Sans 12px", "Hello");
+  clutter_actor_set_name (text, "label");
+  clutter_actor_hide (text);
+  clutter_actor_add_child (child, text);
+
+  snapshot = clutter_actor_save_snapshot (root);
+  g_assert (snapshot != NULL);
+
+  copy = clutter_actor_new ();
+  g_object_ref_sink (copy);
+
+  g_assert (clutter_actor_restore_snapshot (copy, snapshot, &error));
+  g_assert_no_error (error);
+
+  g_assert_cmpint (clutter_actor_get_n_children (copy), ==, 1);
+
+  child = clutter_actor_get_first_child (copy);
+  g_assert_cmpstr (clutter_actor_get_name (child), ==, "box");
+  g_assert_cmpfloat (clutter_actor_get_x (child), ==, 10);
+  g_assert_cmpfloat (clutter_actor_get_y (child), ==, 20);
+  g_assert_cmpfloat (clutter_actor_get_width (child), ==, 100);
+  g_assert_cmpfloat (clutter_actor_get_height (child), ==, 50);
+  g_assert_cmpint (clutter_actor_get_opacity (child), ==, 128);
+  g_assert (CLUTTER_ACTOR_IS_VISIBLE (child));
+  g_assert (CLUTTER_IS_BOX_LAYOUT (clutter_actor_get_layout_manager (child)));
+  g_assert_cmpint (clutter_box_layout_get_orientation (CLUTTER_BOX_LAYOUT (clutter_actor_get_layout_manager (child))),
+                   ==,
+                   CLUTTER_ORIENTATION_VERTICAL);
+
+  text = clutter_actor_get_first_child (child);
+  g_assert (CLUTTER_IS_TEXT (text));
+  g_assert_cmpstr (clutter_actor_get_name (text), ==, "label");
+  g_assert_cmpstr (clutter_text_get_text (CLUTTER_TEXT (text)), ==, "Hello");
+  g_assert (!CLUTTER_ACTOR_IS_VISIBLE (text));
+
+  g_bytes_unref (snapshot);
+  clutter_actor_destroy (copy);
+  g_object_unref (copy);
+  clutter_actor_destroy (root);
+  g_object_unref (root);
+}
+
+static void
+actor_snapshot_invalid (void)
+{
+  ClutterActor *root;
+  GError *error = NULL;
+  GBytes *snapshot;
+
+  root = clutter_actor_new ();
+  g_object_ref_sink (root);
+
+  snapshot = g_bytes_new_static ("garbage", 7);
+
+  g_assert (!clutter_actor_restore_snapshot (root, snapshot, &error));
+  g_assert (error != NULL);
+  g_assert_cmpint (clutter_actor_get_n_children (root), ==, 0);
+
+  g_clear_error (&error);
+  g_bytes_unref (snapshot);
+  clutter_actor_destroy (root);
+  g_object_unref (root);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/snapshot/round-trip", actor_snapshot_round_trip)
+  CLUTTER_TEST_UNIT ("/actor/snapshot/invalid", actor_snapshot_invalid)
+)
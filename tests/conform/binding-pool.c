@@ -292,6 +292,80 @@ binding_pool (void)
   clutter_actor_destroy (CLUTTER_ACTOR (key_group));
 }
 
+static gboolean
+lookup_action (GObject             *gobject,
+               const gchar         *action_name,
+               guint                key_val,
+               ClutterModifierType  modifiers,
+               gpointer             data)
+{
+  return TRUE;
+}
+
+static void
+binding_pool_lookup (void)
+{
+  ClutterBindingPool *pool = clutter_binding_pool_new ("lookup-test");
+  GObject *gobject = g_object_new (G_TYPE_OBJECT, NULL);
+  guint i;
+
+  g_assert (clutter_binding_pool_find ("lookup-test") == pool);
+  g_assert (clutter_binding_pool_find ("lookup-test-missing") == NULL);
+
+  /* enough entries to make the table grow a few times */
+  for (i = 0; i < 200; i++)
+    {
+      clutter_binding_pool_install_action (pool, "plain",
+                                           CLUTTER_KEY_a + i, 0,
+                                           G_CALLBACK (lookup_action),
+                                           NULL, NULL);
+      clutter_binding_pool_install_action (pool, "control",
+                                           CLUTTER_KEY_a + i,
+                                           CLUTTER_CONTROL_MASK,
+                                           G_CALLBACK (lookup_action),
+                                           NULL, NULL);
+    }
+
+  for (i = 0; i < 200; i++)
+    {
+      g_assert_cmpstr (clutter_binding_pool_find_action (pool, CLUTTER_KEY_a + i, 0), ==, "plain");
+      g_assert_cmpstr (clutter_binding_pool_find_action (pool, CLUTTER_KEY_a + i, CLUTTER_CONTROL_MASK), ==, "control");
+    }
+
+  /* modifiers that are not part of a binding are ignored */
+  g_assert_cmpstr (clutter_binding_pool_find_action (pool, CLUTTER_KEY_a,
+                                                     CLUTTER_CONTROL_MASK |
+                                                     CLUTTER_LOCK_MASK |
+                                                     CLUTTER_BUTTON1_MASK),
+                   ==, "control");
+  g_assert (clutter_binding_pool_activate (pool, CLUTTER_KEY_a,
+                                           CLUTTER_MOD2_MASK,
+                                           gobject));
+  g_assert (!clutter_binding_pool_activate (pool, CLUTTER_KEY_a,
+                                            CLUTTER_SHIFT_MASK,
+                                            gobject));
+
+  /* removing entries must not break the lookup of the other ones */
+  for (i = 0; i < 200; i += 2)
+    clutter_binding_pool_remove_action (pool, CLUTTER_KEY_a + i, 0);
+
+  for (i = 0; i < 200; i++)
+    {
+      if (i % 2 == 0)
+        g_assert (clutter_binding_pool_find_action (pool, CLUTTER_KEY_a + i, 0) == NULL);
+      else
+        g_assert_cmpstr (clutter_binding_pool_find_action (pool, CLUTTER_KEY_a + i, 0), ==, "plain");
+
+      g_assert_cmpstr (clutter_binding_pool_find_action (pool, CLUTTER_KEY_a + i, CLUTTER_CONTROL_MASK), ==, "control");
+    }
+
+  g_object_unref (gobject);
+  g_object_unref (pool);
+
+  g_assert (clutter_binding_pool_find ("lookup-test") == NULL);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/binding-pool", binding_pool)
+  CLUTTER_TEST_UNIT ("/binding-pool/lookup", binding_pool_lookup)
 )
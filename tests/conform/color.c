@@ -310,10 +310,54 @@ color_operators (void)
   g_assert_cmpuint (clutter_color_to_pixel (&res), ==, 0x00ff00cc);
 }
 
+static void
+color_interpolate_array (void)
+{
+  ClutterColor initial[19], final[19], result[19], single;
+  ClutterColor transparent = { 0xff, 0x00, 0x00, 0x00 };
+  ClutterColor blue = { 0x00, 0x00, 0xff, 0xff };
+  int i;
+
+  for (i = 0; i < G_N_ELEMENTS (initial); i++)
+    {
+      clutter_color_init (&initial[i], i * 13, 255 - i * 7, i * 3, 255);
+      clutter_color_init (&final[i], 255 - i * 11, i * 5, 128, i * 13);
+    }
+
+  /* the array version can round differently, but only by one */
+  clutter_color_interpolate_array (initial, final, 0.3, result,
+                                   G_N_ELEMENTS (initial));
+
+  for (i = 0; i < G_N_ELEMENTS (initial); i++)
+    {
+      clutter_color_interpolate (&initial[i], &final[i], 0.3, &single);
+
+      g_assert_cmpint (ABS (result[i].red - single.red), <=, 1);
+      g_assert_cmpint (ABS (result[i].green - single.green), <=, 1);
+      g_assert_cmpint (ABS (result[i].blue - single.blue), <=, 1);
+      g_assert_cmpint (ABS (result[i].alpha - single.alpha), <=, 1);
+    }
+
+  /* the end points are exact */
+  clutter_color_interpolate_array (initial, final, 1.0, result,
+                                   G_N_ELEMENTS (initial));
+  for (i = 0; i < G_N_ELEMENTS (initial); i++)
+    g_assert (clutter_color_equal (&result[i], &final[i]));
+
+  /* a transparent color does not tint the premultiplied interpolation */
+  clutter_color_interpolate_array_premultiplied (&transparent, &blue, 0.5,
+                                                 result, 1);
+  g_assert_cmpuint (result[0].red, ==, 0x00);
+  g_assert_cmpuint (result[0].green, ==, 0x00);
+  g_assert_cmpuint (result[0].blue, ==, 0xff);
+  g_assert_cmpuint (result[0].alpha, ==, 0x80);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/color/hls-roundtrip", color_hls_roundtrip)
   CLUTTER_TEST_UNIT ("/color/from-string/invalid", color_from_string_invalid)
   CLUTTER_TEST_UNIT ("/color/from-string/valid", color_from_string_valid)
   CLUTTER_TEST_UNIT ("/color/to-string", color_to_string)
   CLUTTER_TEST_UNIT ("/color/operators", color_operators)
+  CLUTTER_TEST_UNIT ("/color/interpolate-array", color_interpolate_array)
 )
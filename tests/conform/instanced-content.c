@@ -0,0 +1,80 @@
+#include <clutter/clutter.h>
+
+static void
+instanced_content_instances (void)
+{
+  ClutterContent *content = clutter_instanced_content_new ();
+  ClutterInstancedContent *instanced = CLUTTER_INSTANCED_CONTENT (content);
+  ClutterInstance instances[2] = { { 0, }, };
+  ClutterInstance instance;
+  gfloat positions[2] = { 100.f, 0.f };
+
+  g_assert_cmpuint (clutter_instanced_content_get_n_instances (instanced), ==, 0);
+
+  /* new instances are white, with the whole texture */
+  clutter_instanced_content_set_n_instances (instanced, 3);
+  clutter_instanced_content_get_instance (instanced, 2, &instance);
+  g_assert_cmpfloat (instance.scale, ==, 1.f);
+  g_assert_cmpfloat (instance.tx2, ==, 1.f);
+  g_assert (clutter_color_equal (&instance.color, CLUTTER_COLOR_White));
+
+  instances[0].width = instances[0].height = 10.f;
+  instances[0].scale = 1.f;
+  instances[0].color = *CLUTTER_COLOR_Red;
+  instances[1] = instances[0];
+  instances[1].x = 5.f;
+
+  /* setting instances past the end adds them */
+  clutter_instanced_content_set_instances (instanced, 2, 2, instances);
+  g_assert_cmpuint (clutter_instanced_content_get_n_instances (instanced), ==, 4);
+
+  /* the last instance is on top */
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 7.f, 5.f), ==, 3);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 2.f, 5.f), ==, 2);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 20.f, 5.f), ==, -1);
+
+  /* moving an instance keeps the rest of its data */
+  clutter_instanced_content_set_positions (instanced, 3, 1, positions);
+  clutter_instanced_content_get_instance (instanced, 3, &instance);
+  g_assert_cmpfloat (instance.x, ==, 100.f);
+  g_assert_cmpfloat (instance.width, ==, 10.f);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 7.f, 5.f), ==, 2);
+
+  clutter_instanced_content_set_n_instances (instanced, 2);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 2.f, 5.f), ==, -1);
+
+  g_object_unref (content);
+}
+
+static void
+instanced_content_rotation (void)
+{
+  ClutterContent *content = clutter_instanced_content_new ();
+  ClutterInstancedContent *instanced = CLUTTER_INSTANCED_CONTENT (content);
+  ClutterInstance instance = { 0, };
+
+  instance.width = 40.f;
+  instance.height = 10.f;
+  instance.scale = 1.f;
+  instance.rotation = 90.f;
+  instance.color = *CLUTTER_COLOR_White;
+
+  clutter_instanced_content_set_instances (instanced, 0, 1, &instance);
+
+  /* rotated around its center at 20, 5 */
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 20.f, 20.f), ==, 0);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 35.f, 5.f), ==, -1);
+
+  /* and scaled around its center */
+  instance.scale = 0.5f;
+  clutter_instanced_content_set_instances (instanced, 0, 1, &instance);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 20.f, 20.f), ==, -1);
+  g_assert_cmpint (clutter_instanced_content_get_instance_at (instanced, 20.f, 12.f), ==, 0);
+
+  g_object_unref (content);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/instanced-content/instances", instanced_content_instances)
+  CLUTTER_TEST_UNIT ("/instanced-content/rotation", instanced_content_rotation)
+)
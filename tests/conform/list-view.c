@@ -0,0 +1,168 @@
+#include <clutter/clutter.h>
+
+#define N_ITEMS         10000
+#define ITEM_HEIGHT     10.f
+#define VIEWPORT_HEIGHT 100.f
+
+typedef struct {
+  guint n_created;
+  guint n_bound;
+} ListViewData;
+
+static ClutterActor *
+create_child (gpointer item,
+              gpointer user_data)
+{
+  ListViewData *data = user_data;
+  ClutterActor *child = clutter_actor_new ();
+
+  g_object_set_data (G_OBJECT (child), "item", item);
+  data->n_created += 1;
+
+  return child;
+}
+
+static void
+bind_child (ClutterActor *child,
+            gpointer      item,
+            gpointer      user_data)
+{
+  ListViewData *data = user_data;
+
+  g_object_set_data (G_OBJECT (child), "item", item);
+  data->n_bound += 1;
+}
+
+static void
+on_after_paint (ClutterStage *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_paint (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong id;
+
+  id = g_signal_connect (stage, "after-paint",
+                         G_CALLBACK (on_after_paint),
+                         &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, id);
+}
+
+static void
+assert_children_match_model (ClutterListView *view,
+                             GListModel      *model)
+{
+  guint first, n_children, i;
+
+  g_assert (clutter_list_view_get_child_range (view, &first, &n_children));
+
+  for (i = first; i < first + n_children; i++)
+    {
+      ClutterActor *child = clutter_list_view_get_item_child (view, i);
+      gpointer item = g_list_model_get_item (model, i);
+
+      g_assert (child != NULL);
+      g_assert (g_object_get_data (G_OBJECT (child), "item") == item);
+
+      g_object_unref (item);
+    }
+}
+
+static void
+list_view_virtual (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *scroll, *view;
+  ListViewData data = { 0, };
+  GListStore *store;
+  ClutterPoint p;
+  guint first, n_children, i;
+
+  store = g_list_store_new (G_TYPE_OBJECT);
+  for (i = 0; i < N_ITEMS; i++)
+    {
+      GObject *item = g_object_new (G_TYPE_OBJECT, NULL);
+
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  scroll = clutter_scroll_actor_new ();
+  clutter_scroll_actor_set_scroll_mode (CLUTTER_SCROLL_ACTOR (scroll),
+                                        CLUTTER_SCROLL_VERTICALLY);
+  clutter_actor_set_size (scroll, 100.f, VIEWPORT_HEIGHT);
+  clutter_actor_add_child (stage, scroll);
+
+  view = clutter_list_view_new ();
+  clutter_list_view_set_item_size (CLUTTER_LIST_VIEW (view), 0.f, ITEM_HEIGHT);
+  clutter_list_view_set_prefetch_margin (CLUTTER_LIST_VIEW (view), 0.f);
+  clutter_list_view_bind_model (CLUTTER_LIST_VIEW (view),
+                                G_LIST_MODEL (store),
+                                create_child,
+                                bind_child,
+                                &data,
+                                NULL);
+  clutter_actor_set_width (view, 100.f);
+  clutter_actor_add_child (scroll, view);
+
+  g_assert (clutter_list_view_get_model (CLUTTER_LIST_VIEW (view)) == G_LIST_MODEL (store));
+
+  clutter_actor_show (stage);
+
+  /* the children are created after the first allocation */
+  wait_for_paint (stage);
+  wait_for_paint (stage);
+
+  /* the view is as tall as all of the items, but only has children
+   * for the visible ones
+   */
+  g_assert_cmpfloat (clutter_actor_get_height (view), ==, N_ITEMS * ITEM_HEIGHT);
+
+  g_assert (clutter_list_view_get_child_range (CLUTTER_LIST_VIEW (view),
+                                               &first,
+                                               &n_children));
+  g_assert_cmpuint (first, ==, 0);
+  g_assert_cmpuint (n_children, ==, VIEWPORT_HEIGHT / ITEM_HEIGHT);
+  g_assert_cmpuint (data.n_created, ==, n_children);
+  g_assert_cmpuint (clutter_actor_get_n_children (view), ==, n_children);
+  assert_children_match_model (CLUTTER_LIST_VIEW (view), G_LIST_MODEL (store));
+
+  /* scrolling recycles the children instead of creating new ones */
+  clutter_point_init (&p, 0.f, 5000.f);
+  clutter_scroll_actor_scroll_to_point (CLUTTER_SCROLL_ACTOR (scroll), &p);
+  wait_for_paint (stage);
+
+  g_assert (clutter_list_view_get_child_range (CLUTTER_LIST_VIEW (view),
+                                               &first,
+                                               &n_children));
+  g_assert_cmpuint (first, ==, 5000.f / ITEM_HEIGHT);
+  g_assert_cmpuint (n_children, ==, VIEWPORT_HEIGHT / ITEM_HEIGHT);
+  g_assert_cmpuint (data.n_created, ==, n_children);
+  g_assert_cmpuint (data.n_bound, ==, n_children);
+  g_assert (clutter_list_view_get_item_child (CLUTTER_LIST_VIEW (view), 0) == NULL);
+  assert_children_match_model (CLUTTER_LIST_VIEW (view), G_LIST_MODEL (store));
+
+  /* removing an item before the visible ones rebinds the children */
+  g_list_store_remove (store, 0);
+  wait_for_paint (stage);
+
+  g_assert_cmpfloat (clutter_actor_get_height (view), ==, (N_ITEMS - 1) * ITEM_HEIGHT);
+  assert_children_match_model (CLUTTER_LIST_VIEW (view), G_LIST_MODEL (store));
+
+  clutter_actor_destroy (scroll);
+  g_object_unref (store);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/list-view/virtual", list_view_virtual)
+)
@@ -257,6 +257,171 @@ list_model_filter (void)
   g_object_unref (test_data.model);
 }
 
+static void
+list_model_filter_update (void)
+{
+  ClutterModel *model;
+  ClutterModelIter *iter;
+  gint i;
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_STRING, "Foo",
+                                  G_TYPE_INT,    "Bar");
+
+  clutter_model_set_filter (model, filter_odd_rows, NULL, NULL);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 0);
+
+  /* rows added after the filter are filtered as well */
+  for (i = 1; i < 10; i++)
+    {
+      gchar *foo = g_strdup_printf ("String %d", i);
+
+      clutter_model_append (model,
+                            COLUMN_FOO, foo,
+                            COLUMN_BAR, i,
+                            -1);
+
+      g_free (foo);
+    }
+
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 5);
+
+  for (i = 0; i < 5; i++)
+    {
+      iter = clutter_model_get_iter_at_row (model, i);
+      compare_iter (iter, i,
+                    filter_odd[i].expected_foo,
+                    filter_odd[i].expected_bar);
+      g_object_unref (iter);
+    }
+
+  /* changing a row moves it in and out of the filter */
+  iter = clutter_model_get_iter_at_row (model, 0);
+  clutter_model_iter_set (iter, COLUMN_BAR, 2, -1);
+  g_object_unref (iter);
+
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 4);
+
+  iter = clutter_model_get_iter_at_row (model, 0);
+  compare_iter (iter, 0,
+                filter_odd[1].expected_foo,
+                filter_odd[1].expected_bar);
+  g_object_unref (iter);
+
+  /* removing a row removes the n-th filtered row */
+  clutter_model_remove (model, 1);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 3);
+
+  iter = clutter_model_get_iter_at_row (model, 1);
+  compare_iter (iter, 1,
+                filter_odd[3].expected_foo,
+                filter_odd[3].expected_bar);
+  g_object_unref (iter);
+
+  clutter_model_set_filter (model, NULL, NULL, NULL);
+  g_assert_cmpint (clutter_model_get_n_rows (model), ==, 8);
+
+  g_object_unref (model);
+}
+
+static gint
+sort_bar (ClutterModel *model,
+          const GValue *a,
+          const GValue *b,
+          gpointer      dummy G_GNUC_UNUSED)
+{
+  return g_value_get_int (a) - g_value_get_int (b);
+}
+
+static void
+check_sorted (ClutterModel *model)
+{
+  ClutterModelIter *iter;
+  gint last_bar = G_MININT;
+
+  iter = clutter_model_get_first_iter (model);
+  while (!clutter_model_iter_is_last (iter))
+    {
+      gint bar = 0;
+
+      clutter_model_iter_get (iter, COLUMN_BAR, &bar, -1);
+      g_assert_cmpint (bar, >=, last_bar);
+      last_bar = bar;
+
+      iter = clutter_model_iter_next (iter);
+    }
+
+  g_object_unref (iter);
+}
+
+static void
+on_sort_changed (ClutterModel *model,
+                 gpointer      data)
+{
+  gint *n_emissions = data;
+
+  *n_emissions += 1;
+}
+
+static void
+list_model_sort_update (void)
+{
+  ClutterModel *model;
+  ClutterModelIter *iter;
+  gint n_emissions = 0;
+  gint i;
+
+  model = clutter_list_model_new (N_COLUMNS,
+                                  G_TYPE_STRING, "Foo",
+                                  G_TYPE_INT,    "Bar");
+
+  clutter_model_set_sort (model, COLUMN_BAR, sort_bar, NULL, NULL);
+
+  /* every row is moved to its position when added */
+  for (i = 0; i < 10; i++)
+    clutter_model_append (model,
+                          COLUMN_FOO, "String",
+                          COLUMN_BAR, (i * 7) % 10,
+                          -1);
+
+  check_sorted (model);
+
+  /* and when its sorting column changes */
+  iter = clutter_model_get_iter_at_row (model, 0);
+  clutter_model_iter_set (iter, COLUMN_BAR, 42, -1);
+  g_object_unref (iter);
+
+  check_sorted (model);
+
+  iter = clutter_model_get_last_iter (model);
+  compare_iter (iter, 9, "String", 42);
+  g_object_unref (iter);
+
+  /* a batch of changes sorts the model once */
+  g_signal_connect (model, "sort-changed",
+                    G_CALLBACK (on_sort_changed),
+                    &n_emissions);
+
+  clutter_model_begin_update (model);
+
+  for (i = 0; i < 10; i++)
+    {
+      iter = clutter_model_get_iter_at_row (model, i);
+      clutter_model_iter_set (iter, COLUMN_BAR, 10 - i, -1);
+      g_object_unref (iter);
+    }
+
+  g_assert_cmpint (n_emissions, ==, 0);
+
+  clutter_model_end_update (model);
+
+  g_assert_cmpint (n_emissions, ==, 1);
+
+  check_sorted (model);
+
+  g_object_unref (model);
+}
+
 static void
 list_model_iterate (void)
 {
@@ -523,6 +688,8 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/list-model/populate", list_model_populate)
   CLUTTER_TEST_UNIT ("/list-model/iterate", list_model_iterate)
   CLUTTER_TEST_UNIT ("/list-model/filter", list_model_filter)
+  CLUTTER_TEST_UNIT ("/list-model/filter-update", list_model_filter_update)
+  CLUTTER_TEST_UNIT ("/list-model/sort-update", list_model_sort_update)
   CLUTTER_TEST_UNIT ("/list-model/row-changed", list_model_row_changed)
   CLUTTER_TEST_UNIT ("/list-model/from-script", list_model_from_script)
 )
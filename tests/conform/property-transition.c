@@ -0,0 +1,280 @@
+#include <clutter/clutter.h>
+
+typedef struct {
+  ClutterActor *actor;
+  guint n_notify_x;
+  guint n_notify_opacity;
+  guint n_frames;
+  guint n_notify_scale;
+  guint n_notify_translation;
+  guint n_queue_redraw;
+  gfloat last_x;
+  gboolean x_was_monotonic;
+  gboolean saw_intermediate;
+  gboolean completed;
+} TransitionState;
+
+static void
+on_notify_x (ClutterActor    *actor,
+             GParamSpec      *pspec,
+             TransitionState *state)
+{
+  gfloat x = clutter_actor_get_x (actor);
+
+  if (x < state->last_x)
+    state->x_was_monotonic = FALSE;
+
+  state->last_x = x;
+  state->n_notify_x += 1;
+}
+
+static void
+on_notify_opacity (ClutterActor    *actor,
+                   GParamSpec      *pspec,
+                   TransitionState *state)
+{
+  state->n_notify_opacity += 1;
+}
+
+static void
+on_notify_scale_x (ClutterActor    *actor,
+                   GParamSpec      *pspec,
+                   TransitionState *state)
+{
+  state->n_notify_scale += 1;
+}
+
+static void
+on_notify_translation_x (ClutterActor    *actor,
+                         GParamSpec      *pspec,
+                         TransitionState *state)
+{
+  state->n_notify_translation += 1;
+}
+
+static void
+on_queue_redraw (ClutterActor    *actor,
+                 ClutterActor    *origin,
+                 TransitionState *state)
+{
+  state->n_queue_redraw += 1;
+}
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             elapsed,
+              TransitionState *state)
+{
+  guint8 opacity = clutter_actor_get_opacity (state->actor);
+
+  if (opacity != 0 && opacity != 255)
+    state->saw_intermediate = TRUE;
+
+  state->n_frames += 1;
+}
+
+static void
+on_stopped (ClutterTimeline *timeline,
+            gboolean         is_finished,
+            TransitionState *state)
+{
+  state->completed = TRUE;
+}
+
+static void
+property_transition_scalar (void)
+{
+  TransitionState state = { NULL, };
+  ClutterTransition *transition;
+  ClutterActor *stage;
+
+  /* implicit transitions are skipped on unmapped actors */
+  stage = clutter_test_get_stage ();
+  state.actor = clutter_actor_new ();
+  clutter_actor_add_child (stage, state.actor);
+  clutter_actor_show (stage);
+  state.x_was_monotonic = TRUE;
+
+  g_signal_connect (state.actor, "notify::x",
+                    G_CALLBACK (on_notify_x),
+                    &state);
+  g_signal_connect (state.actor, "notify::opacity",
+                    G_CALLBACK (on_notify_opacity),
+                    &state);
+
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, 250);
+  clutter_actor_set_easing_mode (state.actor, CLUTTER_LINEAR);
+  clutter_actor_set_x (state.actor, 100.f);
+  clutter_actor_set_opacity (state.actor, 0);
+  clutter_actor_restore_easing_state (state.actor);
+
+  transition = clutter_actor_get_transition (state.actor, "x");
+  g_assert (transition != NULL);
+
+  g_signal_connect (transition, "new-frame",
+                    G_CALLBACK (on_new_frame),
+                    &state);
+  g_signal_connect (transition, "stopped",
+                    G_CALLBACK (on_stopped),
+                    &state);
+
+  while (!state.completed)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* the notifications emitted by the last frame are flushed before
+   * the next paint
+   */
+  while (state.last_x < 100.f)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("frames: %u, notify::x: %u, notify::opacity: %u\n",
+             state.n_frames,
+             state.n_notify_x,
+             state.n_notify_opacity);
+
+  g_assert_cmpfloat (clutter_actor_get_x (state.actor), ==, 100.f);
+  g_assert_cmpint (clutter_actor_get_opacity (state.actor), ==, 0);
+  g_assert (state.x_was_monotonic);
+
+  /* each property is notified at most once per frame */
+  g_assert_cmpint (state.n_notify_x, >, 0);
+  g_assert_cmpint (state.n_notify_x, <=, state.n_frames);
+  g_assert_cmpint (state.n_notify_opacity, >, 0);
+  g_assert_cmpint (state.n_notify_opacity, <=, state.n_frames);
+
+  clutter_actor_destroy (state.actor);
+}
+
+static void
+property_transition_paint_time (void)
+{
+  TransitionState state = { NULL, };
+  ClutterTransition *transition;
+  ClutterActor *stage;
+  gdouble scale_x;
+
+  stage = clutter_test_get_stage ();
+  state.actor = clutter_actor_new ();
+  clutter_actor_add_child (stage, state.actor);
+  clutter_actor_show (stage);
+
+  g_signal_connect (state.actor, "notify::opacity",
+                    G_CALLBACK (on_notify_opacity),
+                    &state);
+  g_signal_connect (state.actor, "notify::scale-x",
+                    G_CALLBACK (on_notify_scale_x),
+                    &state);
+
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, 250);
+  clutter_actor_set_easing_mode (state.actor, CLUTTER_LINEAR);
+  clutter_actor_set_easing_paint_time (state.actor, TRUE);
+  g_assert (clutter_actor_get_easing_paint_time (state.actor));
+  clutter_actor_set_opacity (state.actor, 0);
+  clutter_actor_set_scale (state.actor, 2.0, 2.0);
+  clutter_actor_restore_easing_state (state.actor);
+
+  transition = clutter_actor_get_transition (state.actor, "opacity");
+  g_assert (transition != NULL);
+
+  g_signal_connect (transition, "new-frame",
+                    G_CALLBACK (on_new_frame),
+                    &state);
+  g_signal_connect (transition, "stopped",
+                    G_CALLBACK (on_stopped),
+                    &state);
+
+  while (!state.completed)
+    g_main_context_iteration (NULL, TRUE);
+
+  while (state.n_notify_opacity == 0 || state.n_notify_scale == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("frames: %u, notify::opacity: %u, notify::scale-x: %u\n",
+             state.n_frames,
+             state.n_notify_opacity,
+             state.n_notify_scale);
+
+  /* the stage painted the intermediate values... */
+  g_assert (state.saw_intermediate);
+
+  /* ...but only the final state went through the property system */
+  g_assert_cmpint (state.n_notify_opacity, ==, 1);
+  g_assert_cmpint (state.n_notify_scale, ==, 1);
+  g_assert_cmpint (clutter_actor_get_opacity (state.actor), ==, 0);
+  clutter_actor_get_scale (state.actor, &scale_x, NULL);
+  g_assert_cmpfloat (scale_x, ==, 2.0);
+
+  clutter_actor_destroy (state.actor);
+}
+
+static void
+property_transition_no_op (void)
+{
+  TransitionState state = { NULL, };
+  ClutterTransition *transition;
+  ClutterActor *stage;
+
+  stage = clutter_test_get_stage ();
+  state.actor = clutter_actor_new ();
+  clutter_actor_set_opacity (state.actor, 254);
+  clutter_actor_add_child (stage, state.actor);
+  clutter_actor_show (stage);
+
+  clutter_actor_save_easing_state (state.actor);
+  clutter_actor_set_easing_duration (state.actor, 250);
+  clutter_actor_set_easing_mode (state.actor, CLUTTER_LINEAR);
+
+  /* the opacity only changes on the last frame, and the translation
+   * never changes
+   */
+  clutter_actor_set_opacity (state.actor, 255);
+  clutter_actor_set_translation (state.actor, 0.f, 0.f, 0.f);
+  clutter_actor_restore_easing_state (state.actor);
+
+  transition = clutter_actor_get_transition (state.actor, "opacity");
+  g_assert (transition != NULL);
+
+  g_signal_connect (state.actor, "notify::opacity",
+                    G_CALLBACK (on_notify_opacity),
+                    &state);
+  g_signal_connect (state.actor, "notify::translation-x",
+                    G_CALLBACK (on_notify_translation_x),
+                    &state);
+  g_signal_connect (state.actor, "queue-redraw",
+                    G_CALLBACK (on_queue_redraw),
+                    &state);
+  g_signal_connect (transition, "new-frame",
+                    G_CALLBACK (on_new_frame),
+                    &state);
+  g_signal_connect (transition, "stopped",
+                    G_CALLBACK (on_stopped),
+                    &state);
+
+  while (!state.completed)
+    g_main_context_iteration (NULL, TRUE);
+
+  while (state.n_notify_opacity == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("frames: %u, queue-redraw: %u\n",
+             state.n_frames,
+             state.n_queue_redraw);
+
+  g_assert_cmpint (clutter_actor_get_opacity (state.actor), ==, 255);
+  g_assert_cmpint (state.n_notify_opacity, ==, 1);
+  g_assert_cmpint (state.n_notify_translation, ==, 0);
+  g_assert_cmpint (state.n_queue_redraw, ==, 1);
+
+  clutter_actor_destroy (state.actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/property-transition/scalar", property_transition_scalar)
+  CLUTTER_TEST_UNIT ("/property-transition/paint-time", property_transition_paint_time)
+  CLUTTER_TEST_UNIT ("/property-transition/no-op", property_transition_no_op)
+)
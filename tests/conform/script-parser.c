@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include <glib/gstdio.h>
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 #include <clutter/clutter.h>
@@ -163,6 +164,50 @@ script_child (void)
   g_free (test_file);
 }
 
+static void
+script_lazy (void)
+{
+  ClutterScript *script = clutter_script_new ();
+  GObject *container, *actor;
+  GError *error = NULL;
+  gboolean focus_ret;
+  gchar *test_file;
+
+  clutter_script_set_lazy_construction (script, TRUE);
+
+  test_file = g_test_build_filename (G_TEST_DIST, "scripts", "test-script-child.json", NULL);
+  clutter_script_load_from_file (script, test_file, &error);
+  if (g_test_verbose () && error)
+    g_print ("Error: %s", error->message);
+
+  g_assert_no_error (error);
+
+  container = clutter_script_get_object (script, "test-group");
+  g_assert (TEST_IS_GROUP (container));
+
+  /* the children are added once the container is on a stage */
+  g_assert_cmpint (clutter_actor_get_n_children (CLUTTER_ACTOR (container)), ==, 0);
+
+  clutter_actor_add_child (clutter_test_get_stage (), CLUTTER_ACTOR (container));
+  g_assert_cmpint (clutter_actor_get_n_children (CLUTTER_ACTOR (container)), ==, 2);
+
+  actor = clutter_script_get_object (script, "test-rect-1");
+  g_assert (CLUTTER_IS_RECTANGLE (actor));
+  g_assert (clutter_actor_get_parent (CLUTTER_ACTOR (actor)) == CLUTTER_ACTOR (container));
+  g_assert_cmpfloat (clutter_actor_get_width (CLUTTER_ACTOR (actor)), ==, 100.0);
+
+  focus_ret = FALSE;
+  clutter_container_child_get (CLUTTER_CONTAINER (container),
+                               CLUTTER_ACTOR (actor),
+                               "focus", &focus_ret,
+                               NULL);
+  g_assert (focus_ret);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (container));
+  g_object_unref (script);
+  g_free (test_file);
+}
+
 static void
 script_single (void)
 {
@@ -196,6 +241,53 @@ script_single (void)
   g_free (test_file);
 }
 
+static void
+script_compiled (void)
+{
+  ClutterScript *script = clutter_script_new ();
+  ClutterActor *container, *child;
+  GError *error = NULL;
+  gchar *test_file, *compiled_file;
+
+  test_file = g_test_build_filename (G_TEST_DIST, "scripts", "test-script-compiled.json", NULL);
+  compiled_file = g_build_filename (g_get_tmp_dir (), "test-script-compiled.bin", NULL);
+
+  clutter_script_compile_file (script, test_file, compiled_file, &error);
+  if (g_test_verbose () && error)
+    g_print ("Error: %s", error->message);
+
+  g_assert_no_error (error);
+
+  /* compiling does not create any object */
+  g_assert (clutter_script_list_objects (script) == NULL);
+
+  clutter_script_load_from_compiled_file (script, compiled_file, &error);
+  if (g_test_verbose () && error)
+    g_print ("Error: %s", error->message);
+
+  g_assert_no_error (error);
+
+  container = CLUTTER_ACTOR (clutter_script_get_object (script, "compiled-container"));
+  g_assert (CLUTTER_IS_ACTOR (container));
+  g_assert_cmpstr (clutter_actor_get_name (container), ==, "Compiled Container");
+  g_assert_cmpint (clutter_actor_get_opacity (container), ==, 128);
+  g_assert (clutter_actor_get_reactive (container));
+  g_assert_cmpint (clutter_actor_get_x_align (container), ==, CLUTTER_ACTOR_ALIGN_CENTER);
+
+  g_assert_cmpint (clutter_actor_get_n_children (container), ==, 1);
+
+  child = clutter_actor_get_first_child (container);
+  g_assert (CLUTTER_IS_TEXT (child));
+  g_assert_cmpstr (clutter_text_get_text (CLUTTER_TEXT (child)), ==, "Anonymous");
+  g_assert_cmpint (clutter_text_get_ellipsize (CLUTTER_TEXT (child)), ==, PANGO_ELLIPSIZE_END);
+
+  g_object_unref (script);
+
+  g_unlink (compiled_file);
+  g_free (compiled_file);
+  g_free (test_file);
+}
+
 static void
 script_implicit_alpha (void)
 {
@@ -424,4 +516,6 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/script/object-property", script_object_property)
   CLUTTER_TEST_UNIT ("/script/layout-property", script_layout_property)
   CLUTTER_TEST_UNIT ("/script/actor-margin", script_margin)
+  CLUTTER_TEST_UNIT ("/script/compiled", script_compiled)
+  CLUTTER_TEST_UNIT ("/script/lazy-construction", script_lazy)
 )
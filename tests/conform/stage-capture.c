@@ -0,0 +1,92 @@
+#include <string.h>
+#include <clutter/clutter.h>
+
+typedef struct {
+  gint n_captures;
+  gint n_notified;
+  gint width;
+  gint height;
+  guint8 pixel[4];
+} CaptureState;
+
+static void
+on_capture (ClutterStage *stage,
+            const guint8 *data,
+            gint          width,
+            gint          height,
+            gint          rowstride,
+            gpointer      user_data)
+{
+  CaptureState *state = user_data;
+
+  g_assert (data != NULL);
+  g_assert_cmpint (rowstride, >=, width * 4);
+
+  state->width = width;
+  state->height = height;
+  memcpy (state->pixel, data + (height / 2) * rowstride + (width / 2) * 4, 4);
+  state->n_captures += 1;
+}
+
+static void
+on_notify (gpointer user_data)
+{
+  CaptureState *state = user_data;
+
+  state->n_notified += 1;
+}
+
+static void
+stage_capture (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  cairo_rectangle_int_t rect = { 10, 10, 40, 20 };
+  CaptureState state = { 0, };
+  ClutterActor *actor;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (actor, 100, 100);
+  clutter_actor_add_child (stage, actor);
+
+  clutter_actor_show (stage);
+
+  /* the capture is delivered a few frames after it is read back, even
+   * if nothing else is painting the stage
+   */
+  clutter_stage_capture_async (CLUTTER_STAGE (stage), &rect, 1,
+                               on_capture, &state, on_notify);
+
+  while (state.n_notified < 1)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpint (state.n_captures, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("Captured %dx%d pixels, center: %d, %d, %d\n",
+             state.width, state.height,
+             state.pixel[0], state.pixel[1], state.pixel[2]);
+
+  g_assert_cmpint (state.width, ==, 40);
+  g_assert_cmpint (state.height, ==, 20);
+  g_assert_cmpint (state.pixel[0], ==, 0xff);
+  g_assert_cmpint (state.pixel[1], ==, 0x00);
+  g_assert_cmpint (state.pixel[2], ==, 0x00);
+
+  /* the scaled down capture averages the blocks of pixels */
+  clutter_stage_capture_async (CLUTTER_STAGE (stage), &rect, 4,
+                               on_capture, &state, on_notify);
+
+  while (state.n_notified < 2)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpint (state.n_captures, ==, 2);
+  g_assert_cmpint (state.width, ==, 10);
+  g_assert_cmpint (state.height, ==, 5);
+  g_assert_cmpint (state.pixel[0], ==, 0xff);
+  g_assert_cmpint (state.pixel[1], ==, 0x00);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/stage/capture", stage_capture)
+)
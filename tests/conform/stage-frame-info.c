@@ -0,0 +1,107 @@
+#include <clutter/clutter.h>
+
+#define N_FRAMES 5
+
+typedef struct {
+  ClutterActor *stage;
+  gint64 last_counter;
+  guint n_frames;
+} FrameInfoState;
+
+static void
+on_frame_info (ClutterStage     *stage,
+               ClutterFrameInfo *info,
+               FrameInfoState   *state)
+{
+  if (g_test_verbose ())
+    g_print ("Frame %" G_GINT64_FORMAT ": events %" G_GINT64_FORMAT " us, "
+             "layout %" G_GINT64_FORMAT " us, paint %" G_GINT64_FORMAT " us\n",
+             info->frame_counter,
+             info->events_end - info->events_start,
+             info->layout_end - info->layout_start,
+             info->paint_end - info->paint_start);
+
+  g_assert_cmpint (info->frame_counter, >, state->last_counter);
+
+  g_assert_cmpint (info->events_start, <=, info->events_end);
+  g_assert_cmpint (info->events_end, <=, info->timelines_start);
+  g_assert_cmpint (info->timelines_start, <=, info->timelines_end);
+  g_assert_cmpint (info->timelines_end, <=, info->layout_start);
+  g_assert_cmpint (info->layout_start, <=, info->layout_end);
+  g_assert_cmpint (info->layout_end, <=, info->paint_start);
+  g_assert_cmpint (info->paint_start, <=, info->paint_end);
+
+  if (info->swap_start != 0)
+    {
+      g_assert_cmpint (info->paint_end, <=, info->swap_start);
+      g_assert_cmpint (info->swap_start, <=, info->swap_end);
+    }
+
+  state->last_counter = info->frame_counter;
+  state->n_frames += 1;
+}
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             msecs,
+              FrameInfoState  *state)
+{
+  clutter_actor_queue_redraw (state->stage);
+}
+
+static void
+stage_frame_info (void)
+{
+  ClutterFrameInfo frames[N_FRAMES + 1];
+  ClutterTimeline *timeline;
+  FrameInfoState state = { NULL, };
+  guint i, n_frames;
+
+  state.stage = clutter_test_get_stage ();
+
+  g_assert (!clutter_stage_get_collect_frame_info (CLUTTER_STAGE (state.stage)));
+  g_assert_cmpint (clutter_stage_get_frame_info_history (CLUTTER_STAGE (state.stage),
+                                                         frames,
+                                                         N_FRAMES), ==, 0);
+
+  clutter_stage_set_collect_frame_info (CLUTTER_STAGE (state.stage), TRUE);
+  g_signal_connect (state.stage, "frame-info",
+                    G_CALLBACK (on_frame_info),
+                    &state);
+
+  /* keep the stage painting until enough frames have been collected */
+  timeline = clutter_timeline_new (1000);
+  clutter_timeline_set_repeat_count (timeline, -1);
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (on_new_frame), &state);
+
+  clutter_actor_show (state.stage);
+  clutter_timeline_start (timeline);
+
+  while (state.n_frames < N_FRAMES)
+    g_main_context_iteration (NULL, TRUE);
+
+  clutter_timeline_stop (timeline);
+
+  /* the history is ordered from the oldest to the newest frame */
+  n_frames = clutter_stage_get_frame_info_history (CLUTTER_STAGE (state.stage),
+                                                   frames,
+                                                   N_FRAMES);
+  g_assert_cmpint (n_frames, ==, N_FRAMES);
+  g_assert_cmpint (frames[N_FRAMES - 1].frame_counter, ==, state.last_counter);
+
+  for (i = 1; i < n_frames; i++)
+    g_assert_cmpint (frames[i].frame_counter, ==, frames[i - 1].frame_counter + 1);
+
+  /* disabling the collection drops the history */
+  clutter_stage_set_collect_frame_info (CLUTTER_STAGE (state.stage), FALSE);
+  g_assert_cmpint (clutter_stage_get_frame_info_history (CLUTTER_STAGE (state.stage),
+                                                         frames,
+                                                         N_FRAMES + 1), ==, 0);
+
+  g_signal_handlers_disconnect_by_func (state.stage, on_frame_info, &state);
+  g_object_unref (timeline);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/stage/frame-info", stage_frame_info)
+)
@@ -322,6 +322,20 @@ text_password_char (void)
 
   g_assert_cmpstr (clutter_text_get_text (text), ==, "hello");
 
+  /* the layout shows the invisible characters, and follows the changes
+   * of the contents
+   */
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (text)), ==, "*****");
+
+  clutter_text_set_text (text, "hi");
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (text)), ==, "**");
+
+  clutter_text_set_password_char (text, '-');
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (text)), ==, "--");
+
+  clutter_text_set_password_char (text, 0);
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (text)), ==, "hi");
+
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
 
@@ -533,6 +547,149 @@ text_idempotent_use_markup (void)
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
 
+static void
+text_async_layout (void)
+{
+  ClutterText *text, *sync_text;
+  GString *contents;
+  gfloat natural_width, sync_natural_width;
+  gint i;
+
+  contents = g_string_new (NULL);
+  for (i = 0; i < 200; i++)
+    g_string_append (contents, "The quick brown fox jumps over the lazy dog. ");
+
+  text = CLUTTER_TEXT (clutter_text_new ());
+  g_object_ref_sink (text);
+
+  g_assert (!clutter_text_get_async_layout (text));
+  clutter_text_set_async_layout (text, TRUE);
+  g_assert (clutter_text_get_async_layout (text));
+
+  clutter_text_set_text (text, contents->str);
+
+  /* the contents are shaped later, and until then the text is empty */
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (text), -1, NULL, &natural_width);
+  g_assert_cmpfloat (natural_width, ==, 0);
+
+  while (natural_width == 0)
+    {
+      g_main_context_iteration (NULL, TRUE);
+      clutter_actor_get_preferred_width (CLUTTER_ACTOR (text), -1, NULL, &natural_width);
+    }
+
+  sync_text = CLUTTER_TEXT (clutter_text_new_with_text (NULL, contents->str));
+  g_object_ref_sink (sync_text);
+
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (sync_text), -1, NULL, &sync_natural_width);
+  g_assert_cmpfloat (natural_width, ==, sync_natural_width);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (sync_text));
+  g_object_unref (sync_text);
+
+  /* short contents are shaped right away */
+  clutter_text_set_text (text, "foo");
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (text), -1, NULL, &natural_width);
+  g_assert_cmpfloat (natural_width, >, 0);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+  g_object_unref (text);
+
+  g_string_free (contents, TRUE);
+}
+
+static void
+text_buffer_edits (void)
+{
+  ClutterTextBuffer *buffer;
+  GString *expected;
+  gint i;
+
+  buffer = clutter_text_buffer_new ();
+  expected = g_string_new (NULL);
+
+  /* long enough for the offsets to go through the checkpoints */
+  for (i = 0; i < 2000; i++)
+    {
+      clutter_text_buffer_insert_text (buffer, i, "\xc3\xa4", 1);
+      g_string_append (expected, "\xc3\xa4");
+    }
+
+  for (i = 0; i < 100; i++)
+    {
+      guint position = (i * 37) % clutter_text_buffer_get_length (buffer);
+      gchar *at;
+
+      at = g_utf8_offset_to_pointer (expected->str, position);
+      g_string_insert (expected, at - expected->str, "ab");
+      clutter_text_buffer_insert_text (buffer, position, "ab", 2);
+
+      position = (i * 53) % clutter_text_buffer_get_length (buffer);
+      at = g_utf8_offset_to_pointer (expected->str, position);
+      g_string_erase (expected,
+                      at - expected->str,
+                      g_utf8_offset_to_pointer (at, 3) - at);
+      clutter_text_buffer_delete_text (buffer, position, 3);
+
+      g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==, expected->str);
+      g_assert_cmpuint (clutter_text_buffer_get_length (buffer), ==,
+                        g_utf8_strlen (expected->str, -1));
+    }
+
+  g_string_free (expected, TRUE);
+  g_object_unref (buffer);
+}
+
+static void
+assert_same_size (ClutterActor *a,
+                  ClutterActor *b,
+                  gfloat        for_width)
+{
+  gfloat natural_a, natural_b;
+
+  clutter_actor_get_preferred_width (a, -1, NULL, &natural_a);
+  clutter_actor_get_preferred_width (b, -1, NULL, &natural_b);
+  g_assert_cmpfloat (natural_a, ==, natural_b);
+
+  clutter_actor_get_preferred_height (a, for_width, NULL, &natural_a);
+  clutter_actor_get_preferred_height (b, for_width, NULL, &natural_b);
+  g_assert_cmpfloat (natural_a, ==, natural_b);
+}
+
+static void
+text_paragraph_extents (void)
+{
+  const char *contents = "foo\nthe quick brown fox jumps over the lazy dog\n\nbar\n";
+  ClutterActor *editable, *reference;
+
+  /* editable texts are measured one paragraph at a time, and must
+   * have the same size as the layout of the whole text
+   */
+  editable = clutter_text_new_with_text (NULL, contents);
+  g_object_ref_sink (editable);
+  clutter_text_set_editable (CLUTTER_TEXT (editable), TRUE);
+  clutter_text_set_line_wrap (CLUTTER_TEXT (editable), TRUE);
+
+  reference = clutter_text_new_with_text (NULL, contents);
+  g_object_ref_sink (reference);
+  clutter_text_set_line_wrap (CLUTTER_TEXT (reference), TRUE);
+
+  assert_same_size (editable, reference, 50.f);
+
+  clutter_text_insert_text (CLUTTER_TEXT (editable), "a longer first paragraph ", 0);
+  clutter_text_insert_text (CLUTTER_TEXT (reference), "a longer first paragraph ", 0);
+  assert_same_size (editable, reference, 50.f);
+
+  clutter_text_set_text (CLUTTER_TEXT (editable), "");
+  clutter_text_set_text (CLUTTER_TEXT (reference), "");
+  assert_same_size (editable, reference, 50.f);
+
+  clutter_actor_destroy (editable);
+  g_object_unref (editable);
+  clutter_actor_destroy (reference);
+  g_object_unref (reference);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/text/utf8-validation", text_utf8_validation)
   CLUTTER_TEST_UNIT ("/text/set-empty", text_set_empty)
@@ -547,4 +704,7 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/text/cursor", text_cursor)
   CLUTTER_TEST_UNIT ("/text/event", text_event)
   CLUTTER_TEST_UNIT ("/text/idempotent-use-markup", text_idempotent_use_markup)
+  CLUTTER_TEST_UNIT ("/text/async-layout", text_async_layout)
+  CLUTTER_TEST_UNIT ("/text/paragraph-extents", text_paragraph_extents)
+  CLUTTER_TEST_UNIT ("/text/buffer-edits", text_buffer_edits)
 )
@@ -0,0 +1,131 @@
+#include <clutter/clutter.h>
+
+#define N_THREADS       4
+#define N_TASKS         250
+
+typedef struct {
+  gint n_run;
+  gint last_value[N_THREADS];
+  gboolean in_order;
+} TasksState;
+
+typedef struct {
+  TasksState *state;
+  gint thread;
+  gint value;
+} TaskData;
+
+static void
+task_func (gpointer data)
+{
+  TaskData *task = data;
+  TasksState *state = task->state;
+
+  if (task->value != state->last_value[task->thread] + 1)
+    state->in_order = FALSE;
+
+  state->last_value[task->thread] = task->value;
+  state->n_run += 1;
+}
+
+static void
+task_data_free (gpointer data)
+{
+  g_slice_free (TaskData, data);
+}
+
+static gpointer
+post_tasks (gpointer data)
+{
+  TaskData *first = data;
+  gint i;
+
+  for (i = 1; i <= N_TASKS; i++)
+    {
+      TaskData *task = g_slice_new (TaskData);
+
+      task->state = first->state;
+      task->thread = first->thread;
+      task->value = i;
+
+      /* the queue is not limited */
+      g_assert (clutter_threads_post_task (task_func, task, task_data_free));
+    }
+
+  return NULL;
+}
+
+static void
+threads_tasks_order (void)
+{
+  TasksState state = { 0, };
+  TaskData firsts[N_THREADS];
+  GThread *threads[N_THREADS];
+  gint i;
+
+  state.in_order = TRUE;
+
+  for (i = 0; i < N_THREADS; i++)
+    {
+      firsts[i].state = &state;
+      firsts[i].thread = i;
+
+      threads[i] = g_thread_new ("post-tasks", post_tasks, &firsts[i]);
+    }
+
+  for (i = 0; i < N_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  while (state.n_run < N_THREADS * N_TASKS)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert (state.in_order);
+  g_assert_cmpint (state.n_run, ==, N_THREADS * N_TASKS);
+}
+
+static void
+threads_tasks_limits (void)
+{
+  TasksState state = { 0, };
+  TaskData tasks[3];
+  guint max_tasks;
+  gint64 budget;
+  gint i;
+
+  state.in_order = TRUE;
+
+  clutter_threads_set_task_queue_limits (2, 0);
+  clutter_threads_get_task_queue_limits (&max_tasks, &budget);
+  g_assert_cmpuint (max_tasks, ==, 2);
+  g_assert_cmpint (budget, ==, 0);
+
+  for (i = 0; i < 3; i++)
+    {
+      tasks[i].state = &state;
+      tasks[i].thread = 0;
+      tasks[i].value = i + 1;
+    }
+
+  g_assert (clutter_threads_post_task (task_func, &tasks[0], NULL));
+  g_assert (clutter_threads_post_task (task_func, &tasks[1], NULL));
+
+  /* the queue is full until the main loop runs the tasks */
+  g_assert (!clutter_threads_post_task (task_func, &tasks[2], NULL));
+
+  while (state.n_run < 2)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert (clutter_threads_post_task (task_func, &tasks[2], NULL));
+
+  while (state.n_run < 3)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert (state.in_order);
+
+  clutter_threads_set_task_queue_limits (0, 0);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/threads/tasks/order", threads_tasks_order)
+  CLUTTER_TEST_UNIT ("/threads/tasks/limits", threads_tasks_limits)
+)
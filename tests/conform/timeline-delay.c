@@ -0,0 +1,159 @@
+#include <clutter/clutter.h>
+
+#define N_TIMELINES 8
+
+typedef struct {
+  ClutterTimeline *timelines[N_TIMELINES];
+  guint started[N_TIMELINES];
+  guint n_started;
+  guint n_completed;
+} DelayState;
+
+static void
+on_started (ClutterTimeline *timeline,
+            DelayState      *state)
+{
+  guint i;
+
+  for (i = 0; i < N_TIMELINES; i++)
+    {
+      if (state->timelines[i] == timeline)
+        state->started[state->n_started++] = i;
+    }
+}
+
+static void
+on_completed (ClutterTimeline *timeline,
+              DelayState      *state)
+{
+  state->n_completed += 1;
+}
+
+static void
+timeline_delay_staggered (void)
+{
+  DelayState state = { { NULL, }, };
+  guint i;
+
+  /* start the timelines in the reverse order of their delay, to check
+   * that they are started by deadline and not by insertion order
+   */
+  for (i = 0; i < N_TIMELINES; i++)
+    {
+      state.timelines[i] = clutter_timeline_new (50);
+      clutter_timeline_set_delay (state.timelines[i], 20 * (i + 1));
+
+      g_signal_connect (state.timelines[i], "started",
+                        G_CALLBACK (on_started),
+                        &state);
+      g_signal_connect (state.timelines[i], "completed",
+                        G_CALLBACK (on_completed),
+                        &state);
+    }
+
+  for (i = N_TIMELINES; i > 0; i--)
+    clutter_timeline_start (state.timelines[i - 1]);
+
+  if (g_test_verbose ())
+    g_print ("Stopping a timeline before its delay elapses\n");
+
+  clutter_timeline_stop (state.timelines[3]);
+
+  while (state.n_completed < N_TIMELINES - 1)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpint (state.n_started, ==, N_TIMELINES - 1);
+
+  for (i = 1; i < state.n_started; i++)
+    {
+      if (g_test_verbose ())
+        g_print ("Timeline %u started after timeline %u\n",
+                 state.started[i],
+                 state.started[i - 1]);
+
+      g_assert_cmpint (state.started[i], >, state.started[i - 1]);
+      g_assert_cmpint (state.started[i], !=, 3);
+    }
+
+  g_assert (!clutter_timeline_is_playing (state.timelines[3]));
+
+  for (i = 0; i < N_TIMELINES; i++)
+    g_object_unref (state.timelines[i]);
+}
+
+static void
+on_marker_reached (ClutterTimeline *timeline,
+                   const gchar     *marker_name,
+                   gint             msecs,
+                   GString         *reached)
+{
+  if (reached->len > 0)
+    g_string_append_c (reached, ',');
+
+  g_string_append (reached, marker_name);
+}
+
+static void
+on_markers_completed (ClutterTimeline *timeline,
+                      gboolean        *completed)
+{
+  *completed = TRUE;
+}
+
+static void
+timeline_markers_sorted (void)
+{
+  ClutterTimeline *timeline;
+  GString *reached;
+  gboolean completed;
+
+  timeline = clutter_timeline_new (100);
+  reached = g_string_new (NULL);
+
+  clutter_timeline_add_marker_at_time (timeline, "end", 100);
+  clutter_timeline_add_marker (timeline, "half", 0.5);
+  clutter_timeline_add_marker_at_time (timeline, "start", 0);
+
+  g_signal_connect (timeline, "marker-reached",
+                    G_CALLBACK (on_marker_reached),
+                    reached);
+  g_signal_connect (timeline, "completed",
+                    G_CALLBACK (on_markers_completed),
+                    &completed);
+
+  completed = FALSE;
+  clutter_timeline_start (timeline);
+  while (!completed)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("Markers reached: %s\n", reached->str);
+
+  g_assert_cmpstr (reached->str, ==, "start,half,end");
+
+  if (g_test_verbose ())
+    g_print ("Changing the duration moves the relative markers\n");
+
+  g_string_truncate (reached, 0);
+  clutter_timeline_set_duration (timeline, 400);
+  clutter_timeline_add_marker_at_time (timeline, "late", 150);
+  clutter_timeline_rewind (timeline);
+
+  completed = FALSE;
+  clutter_timeline_start (timeline);
+  while (!completed)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("Markers reached: %s\n", reached->str);
+
+  g_assert_cmpstr (reached->str, ==, "start,end,late,half");
+
+  g_string_free (reached, TRUE);
+  g_object_unref (timeline);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/timeline/delay/staggered", timeline_delay_staggered)
+  CLUTTER_TEST_UNIT ("/timeline/markers/sorted", timeline_markers_sorted)
+)
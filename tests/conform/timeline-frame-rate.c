@@ -0,0 +1,67 @@
+#include <clutter/clutter.h>
+
+typedef struct {
+  gint last_msecs;
+  gint min_interval;
+  guint n_frames;
+  gboolean completed;
+} FrameRateState;
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             msecs,
+              FrameRateState  *state)
+{
+  /* the last frame is clamped to the duration */
+  if (state->n_frames != 0 && msecs != clutter_timeline_get_duration (timeline))
+    state->min_interval = MIN (state->min_interval, msecs - state->last_msecs);
+
+  state->last_msecs = msecs;
+  state->n_frames += 1;
+}
+
+static void
+on_completed (ClutterTimeline *timeline,
+              FrameRateState  *state)
+{
+  state->completed = TRUE;
+}
+
+static void
+timeline_frame_rate_capped (void)
+{
+  FrameRateState state = { 0, G_MAXINT, 0, FALSE };
+  ClutterTimeline *timeline;
+
+  timeline = clutter_timeline_new (500);
+
+  g_assert_cmpuint (clutter_timeline_get_max_frame_rate (timeline), ==, 0);
+  clutter_timeline_set_max_frame_rate (timeline, 10);
+  g_assert_cmpuint (clutter_timeline_get_max_frame_rate (timeline), ==, 10);
+
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (on_new_frame), &state);
+  g_signal_connect (timeline, "completed", G_CALLBACK (on_completed), &state);
+
+  clutter_timeline_start (timeline);
+
+  while (!state.completed)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("frames: %u, shortest interval: %d msecs\n",
+             state.n_frames,
+             state.min_interval);
+
+  /* the first frame, then one every 100 msecs, with some slack */
+  g_assert_cmpuint (state.n_frames, <=, 7);
+  g_assert_cmpint (state.min_interval, >=, 80);
+
+  /* the timeline still reaches its end */
+  g_assert_cmpint (state.last_msecs, ==, 500);
+
+  g_object_unref (timeline);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/timeline/frame-rate/capped", timeline_frame_rate_capped)
+)
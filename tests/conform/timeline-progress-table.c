@@ -0,0 +1,122 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+static const ClutterAnimationMode table_modes[] = {
+  CLUTTER_LINEAR,
+  CLUTTER_EASE_IN_OUT_QUAD,
+  CLUTTER_EASE_IN_SINE,
+  CLUTTER_EASE_IN_OUT_SINE,
+  CLUTTER_EASE_OUT_EXPO,
+  CLUTTER_EASE_IN_OUT_EXPO,
+  CLUTTER_EASE_IN_ELASTIC,
+  CLUTTER_EASE_OUT_ELASTIC,
+  CLUTTER_EASE_IN_OUT_ELASTIC,
+  CLUTTER_EASE_IN_BOUNCE,
+  CLUTTER_EASE_OUT_BOUNCE,
+  CLUTTER_EASE_IN_OUT_BOUNCE,
+  CLUTTER_STEPS,
+  CLUTTER_EASE,
+  CLUTTER_EASE_IN_OUT,
+};
+
+static void
+compare_timelines (ClutterTimeline *reference,
+                   ClutterTimeline *tabulated)
+{
+  guint duration = clutter_timeline_get_duration (reference);
+  gdouble max_error = 0.0;
+  guint msecs;
+
+  for (msecs = 0; msecs <= duration; msecs++)
+    {
+      gdouble error;
+
+      clutter_timeline_advance (reference, msecs);
+      clutter_timeline_advance (tabulated, msecs);
+
+      error = fabs (clutter_timeline_get_progress (reference) -
+                    clutter_timeline_get_progress (tabulated));
+
+      max_error = MAX (max_error, error);
+    }
+
+  if (g_test_verbose ())
+    g_print ("  max error: %g\n", max_error);
+
+  g_assert_cmpfloat (max_error, <, 0.003);
+
+  /* the end points are sampled, not interpolated */
+  clutter_timeline_advance (reference, 0);
+  clutter_timeline_advance (tabulated, 0);
+  g_assert_cmpfloat (fabs (clutter_timeline_get_progress (reference) -
+                           clutter_timeline_get_progress (tabulated)), <, 1e-9);
+
+  clutter_timeline_advance (reference, duration);
+  clutter_timeline_advance (tabulated, duration);
+  g_assert_cmpfloat (fabs (clutter_timeline_get_progress (reference) -
+                           clutter_timeline_get_progress (tabulated)), <, 1e-9);
+}
+
+static void
+timeline_progress_table_modes (void)
+{
+  ClutterTimeline *reference, *tabulated;
+  guint i;
+
+  reference = clutter_timeline_new (1500);
+  tabulated = clutter_timeline_new (1500);
+
+  g_assert (!clutter_timeline_get_use_progress_table (tabulated));
+  clutter_timeline_set_use_progress_table (tabulated, TRUE);
+  g_assert (clutter_timeline_get_use_progress_table (tabulated));
+
+  for (i = 0; i < G_N_ELEMENTS (table_modes); i++)
+    {
+      if (g_test_verbose ())
+        g_print ("mode: %d\n", table_modes[i]);
+
+      clutter_timeline_set_progress_mode (reference, table_modes[i]);
+      clutter_timeline_set_progress_mode (tabulated, table_modes[i]);
+
+      compare_timelines (reference, tabulated);
+    }
+
+  g_object_unref (reference);
+  g_object_unref (tabulated);
+}
+
+static void
+timeline_progress_table_cubic_bezier (void)
+{
+  ClutterTimeline *reference, *tabulated;
+  ClutterPoint c_1, c_2;
+
+  reference = clutter_timeline_new (1000);
+  tabulated = clutter_timeline_new (1000);
+  clutter_timeline_set_use_progress_table (tabulated, TRUE);
+
+  clutter_point_init (&c_1, 0.1, 0.7);
+  clutter_point_init (&c_2, 1.0, 0.1);
+  clutter_timeline_set_cubic_bezier_progress (reference, &c_1, &c_2);
+  clutter_timeline_set_cubic_bezier_progress (tabulated, &c_1, &c_2);
+
+  compare_timelines (reference, tabulated);
+
+  if (g_test_verbose ())
+    g_print ("Changing the control points rebuilds the table\n");
+
+  clutter_point_init (&c_1, 0.6, 0.0);
+  clutter_point_init (&c_2, 0.4, 1.0);
+  clutter_timeline_set_cubic_bezier_progress (reference, &c_1, &c_2);
+  clutter_timeline_set_cubic_bezier_progress (tabulated, &c_1, &c_2);
+
+  compare_timelines (reference, tabulated);
+
+  g_object_unref (reference);
+  g_object_unref (tabulated);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/timeline/progress-table/modes", timeline_progress_table_modes)
+  CLUTTER_TEST_UNIT ("/timeline/progress-table/cubic-bezier", timeline_progress_table_cubic_bezier)
+)
@@ -0,0 +1,571 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <clutter/clutter.h>
+
+#define MIN_ACTORS 100
+#define MAX_ACTORS 100000
+
+/* the number of operations run for each benchmark and size */
+#define N_OPERATIONS 1000000
+
+/* the depth of the chains of actors of the deep trees */
+#define DEEP_TREE_DEPTH 100
+
+static gint max_actors = MAX_ACTORS;
+static gint n_operations = N_OPERATIONS;
+static gchar *filter = NULL;
+
+static GOptionEntry entries[] = {
+  {
+    "max-actors", 'a',
+    0,
+    G_OPTION_ARG_INT, &max_actors,
+    "Largest number of actors", "ACTORS"
+  },
+  {
+    "num-operations", 'o',
+    0,
+    G_OPTION_ARG_INT, &n_operations,
+    "Number of operations for each benchmark", "OPERATIONS"
+  },
+  {
+    "filter", 'f',
+    0,
+    G_OPTION_ARG_STRING, &filter,
+    "Only run the benchmarks containing this string", "NAME"
+  },
+  { NULL }
+};
+
+/* the allocations are counted by wrapping the allocator of the C
+ * library, which is used by GLib and by Clutter; G_SLICE is set to
+ * always-malloc in main() so that the slices are counted as well
+ */
+static gsize alloc_count = 0;
+static gsize alloc_bytes = 0;
+
+#ifdef __GLIBC__
+#define HAVE_ALLOC_COUNTERS 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+extern void __libc_free (void *ptr);
+
+static inline void
+count_allocation (size_t size)
+{
+  __atomic_fetch_add (&alloc_count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&alloc_bytes, size, __ATOMIC_RELAXED);
+}
+
+void *
+malloc (size_t size)
+{
+  count_allocation (size);
+
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members,
+        size_t size)
+{
+  count_allocation (n_members * size);
+
+  return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void   *ptr,
+         size_t  size)
+{
+  count_allocation (size);
+
+  return __libc_realloc (ptr, size);
+}
+
+void
+free (void *ptr)
+{
+  __libc_free (ptr);
+}
+#endif /* __GLIBC__ */
+
+typedef struct {
+  ClutterActor *stage;
+
+  /* the parent of the actors of the benchmark, and another parent
+   * for the reparenting benchmark
+   */
+  ClutterActor *root;
+  ClutterActor *other;
+
+  ClutterActor **actors;
+  gint n_actors;
+
+  gint iteration;
+} BenchState;
+
+typedef struct {
+  const gchar *name;
+
+  void (* setup)    (BenchState *state);
+  void (* run)      (BenchState *state);
+  void (* teardown) (BenchState *state);
+} Benchmark;
+
+/* lets the master clock process the redraws and the relayouts queued
+ * by the benchmarks, outside of the measurements
+ */
+static void
+flush_stage (BenchState *state)
+{
+  clutter_stage_ensure_redraw (CLUTTER_STAGE (state->stage));
+
+  while (g_main_context_iteration (NULL, FALSE))
+    ;
+}
+
+static ClutterActor *
+create_actor (gint i)
+{
+  ClutterColor color = { 0x00, 0x00, 0x00, 0xff };
+  ClutterActor *actor;
+
+  color.red = i & 0xff;
+  color.green = (i >> 8) & 0xff;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_background_color (actor, &color);
+  clutter_actor_set_size (actor, 10.f, 10.f);
+
+  return actor;
+}
+
+static void
+create_actors (BenchState *state)
+{
+  gint i;
+
+  state->actors = g_new (ClutterActor *, state->n_actors);
+
+  for (i = 0; i < state->n_actors; i++)
+    state->actors[i] = g_object_ref_sink (create_actor (i));
+}
+
+/* adds the actors to the root, half of them outside of the stage */
+static void
+create_children (BenchState *state)
+{
+  gint i;
+
+  create_actors (state);
+
+  for (i = 0; i < state->n_actors; i++)
+    {
+      clutter_actor_set_position (state->actors[i],
+                                  (i % 2 == 0 ? 0.f : 10000.f) + (i % 50) * 10.f,
+                                  (i / 50 % 50) * 10.f);
+      clutter_actor_add_child (state->root, state->actors[i]);
+    }
+}
+
+static void
+destroy_children (BenchState *state)
+{
+  gint i;
+
+  clutter_actor_destroy_all_children (state->root);
+  clutter_actor_destroy_all_children (state->other);
+
+  for (i = 0; i < state->n_actors; i++)
+    g_object_unref (state->actors[i]);
+
+  g_clear_pointer (&state->actors, g_free);
+
+  flush_stage (state);
+}
+
+static void
+setup_children (BenchState *state)
+{
+  create_children (state);
+  flush_stage (state);
+}
+
+/* create: the bytes per operation are the memory held by a
+ * colored rectangle outside of the scene graph
+ */
+
+static void
+setup_create (BenchState *state)
+{
+  state->actors = g_new (ClutterActor *, state->n_actors);
+}
+
+static void
+run_create (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    state->actors[i] = g_object_ref_sink (create_actor (i));
+}
+
+/* add-child */
+
+static void
+run_add_child (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    clutter_actor_add_child (state->root, state->actors[i]);
+}
+
+/* remove-child */
+
+static void
+run_remove_child (BenchState *state)
+{
+  gint i;
+
+  for (i = state->n_actors - 1; i >= 0; i--)
+    clutter_actor_remove_child (state->root, state->actors[i]);
+}
+
+/* reparent */
+
+static void
+run_reparent (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    {
+      clutter_actor_remove_child (state->root, state->actors[i]);
+      clutter_actor_add_child (state->other, state->actors[i]);
+    }
+}
+
+/* set-position */
+
+static void
+run_set_position (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    clutter_actor_set_position (state->actors[i],
+                                (i % 50) * 10.f + state->iteration % 2,
+                                (i / 50 % 50) * 10.f);
+}
+
+/* set-size */
+
+static void
+run_set_size (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    clutter_actor_set_size (state->actors[i],
+                            10.f + state->iteration % 2,
+                            10.f + i % 3);
+}
+
+/* allocate-wide and allocate-deep: every leaf queues a relayout, and
+ * the root is allocated again
+ */
+
+static void
+allocate_root (BenchState *state)
+{
+  ClutterActorBox box;
+
+  clutter_actor_box_init (&box, 0.f, 0.f, 500.f + state->iteration % 2, 500.f);
+  clutter_actor_allocate (state->root, &box, CLUTTER_ALLOCATION_NONE);
+}
+
+static void
+setup_deep_tree (BenchState *state)
+{
+  ClutterActor *parent = NULL;
+  gint i;
+
+  create_actors (state);
+
+  for (i = 0; i < state->n_actors; i++)
+    {
+      if (i % DEEP_TREE_DEPTH == 0)
+        parent = state->root;
+
+      clutter_actor_set_position (state->actors[i], 1.f, 1.f);
+      clutter_actor_add_child (parent, state->actors[i]);
+
+      parent = state->actors[i];
+    }
+
+  flush_stage (state);
+}
+
+static void
+run_allocate_wide (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    clutter_actor_queue_relayout (state->actors[i]);
+
+  allocate_root (state);
+}
+
+static void
+run_allocate_deep (BenchState *state)
+{
+  gint i;
+
+  for (i = DEEP_TREE_DEPTH - 1; i < state->n_actors; i += DEEP_TREE_DEPTH)
+    clutter_actor_queue_relayout (state->actors[i]);
+
+  if (state->n_actors % DEEP_TREE_DEPTH != 0)
+    clutter_actor_queue_relayout (state->actors[state->n_actors - 1]);
+
+  allocate_root (state);
+}
+
+/* paint: half of the actors are outside of the stage, and culled;
+ * paint-deep: the actors are nested, so every actor pushes a modelview
+ * on top of the ones of its parents
+ */
+
+static void
+run_paint (BenchState *state)
+{
+  guchar *pixels;
+
+  /* reading back the stage paints it synchronously */
+  pixels = clutter_stage_read_pixels (CLUTTER_STAGE (state->stage), 0, 0, 1, 1);
+  g_free (pixels);
+}
+
+/* create-transition */
+
+static void
+run_create_transition (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    {
+      clutter_actor_save_easing_state (state->actors[i]);
+      clutter_actor_set_easing_duration (state->actors[i], 250);
+      clutter_actor_set_opacity (state->actors[i], 128 + state->iteration % 2);
+      clutter_actor_restore_easing_state (state->actors[i]);
+    }
+}
+
+static void
+teardown_transitions (BenchState *state)
+{
+  gint i;
+
+  for (i = 0; i < state->n_actors; i++)
+    clutter_actor_remove_all_transitions (state->actors[i]);
+
+  destroy_children (state);
+}
+
+/* destroy */
+
+static void
+setup_destroy (BenchState *state)
+{
+  gint i;
+
+  create_children (state);
+
+  /* the root holds the only reference on its children */
+  for (i = 0; i < state->n_actors; i++)
+    g_object_unref (state->actors[i]);
+
+  g_clear_pointer (&state->actors, g_free);
+
+  flush_stage (state);
+}
+
+static void
+run_destroy (BenchState *state)
+{
+  clutter_actor_destroy_all_children (state->root);
+}
+
+static void
+teardown_destroy (BenchState *state)
+{
+  flush_stage (state);
+}
+
+static const Benchmark benchmarks[] = {
+  { "create", setup_create, run_create, destroy_children },
+  { "add-child", create_actors, run_add_child, destroy_children },
+  { "remove-child", setup_children, run_remove_child, destroy_children },
+  { "reparent", setup_children, run_reparent, destroy_children },
+  { "set-position", setup_children, run_set_position, destroy_children },
+  { "set-size", setup_children, run_set_size, destroy_children },
+  { "allocate-wide", setup_children, run_allocate_wide, destroy_children },
+  { "allocate-deep", setup_deep_tree, run_allocate_deep, destroy_children },
+  { "paint", setup_children, run_paint, destroy_children },
+  { "paint-deep", setup_deep_tree, run_paint, destroy_children },
+  { "create-transition", setup_children, run_create_transition, teardown_transitions },
+  { "destroy", setup_destroy, run_destroy, teardown_destroy },
+};
+
+static void
+run_benchmark (const Benchmark *bench,
+               BenchState      *state,
+               FILE            *json)
+{
+  gsize n_allocs = 0, n_bytes = 0;
+  gdouble elapsed = 0.0;
+  gdouble n_ops, ns_per_op;
+  gint n_iterations, i;
+  GTimer *timer;
+
+  n_iterations = MAX (1, n_operations / state->n_actors);
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      gsize start_count, start_bytes;
+
+      state->iteration = i;
+
+      bench->setup (state);
+
+      start_count = alloc_count;
+      start_bytes = alloc_bytes;
+      g_timer_start (timer);
+
+      bench->run (state);
+
+      g_timer_stop (timer);
+      elapsed += g_timer_elapsed (timer, NULL);
+      n_allocs += alloc_count - start_count;
+      n_bytes += alloc_bytes - start_bytes;
+
+      bench->teardown (state);
+    }
+
+  g_timer_destroy (timer);
+
+  n_ops = (gdouble) n_iterations * state->n_actors;
+  ns_per_op = elapsed * 1e9 / n_ops;
+
+#ifdef HAVE_ALLOC_COUNTERS
+  printf ("%-18s %7d actors: %10.1f ns/op, %8.1f bytes/op, %6.2f allocs/op\n",
+          bench->name, state->n_actors,
+          ns_per_op,
+          n_bytes / n_ops,
+          n_allocs / n_ops);
+#else
+  printf ("%-18s %7d actors: %10.1f ns/op\n",
+          bench->name, state->n_actors,
+          ns_per_op);
+#endif
+
+  if (json != NULL)
+    {
+      fprintf (json,
+               "{ \"id\": \"actor-graph/%s/%d\", \"ns_per_op\": %.1f, ",
+               bench->name, state->n_actors,
+               ns_per_op);
+
+#ifdef HAVE_ALLOC_COUNTERS
+      fprintf (json,
+               "\"bytes_per_op\": %.1f, \"allocs_per_op\": %.2f }\n",
+               n_bytes / n_ops,
+               n_allocs / n_ops);
+#else
+      fprintf (json, "\"bytes_per_op\": null, \"allocs_per_op\": null }\n");
+#endif
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  const gchar *json_path;
+  GError *error = NULL;
+  BenchState state = { NULL, };
+  FILE *json = NULL;
+  gint n_actors;
+  guint i;
+
+  /* count the slices as allocations */
+  g_setenv ("G_SLICE", "always-malloc", TRUE);
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Actor graph test with "
+          "%d to %d actors and %d operations per benchmark\n",
+          MIN_ACTORS,
+          max_actors,
+          n_operations);
+
+  /* one JSON object per line, like the performance tests */
+  json_path = g_getenv ("CLUTTER_PERFORMANCE_JSON");
+  if (json_path != NULL)
+    {
+      json = fopen (json_path, "a");
+      if (json == NULL)
+        g_error ("Unable to open '%s'", json_path);
+    }
+
+  state.stage = clutter_stage_new ();
+  clutter_actor_set_size (state.stage, 512, 512);
+  clutter_stage_set_title (CLUTTER_STAGE (state.stage), "Actor graph");
+
+  state.root = clutter_actor_new ();
+  clutter_actor_add_child (state.stage, state.root);
+
+  state.other = clutter_actor_new ();
+  clutter_actor_add_child (state.stage, state.other);
+
+  clutter_actor_show (state.stage);
+  flush_stage (&state);
+
+  for (n_actors = MIN_ACTORS; n_actors <= max_actors; n_actors *= 10)
+    {
+      state.n_actors = n_actors;
+
+      for (i = 0; i < G_N_ELEMENTS (benchmarks); i++)
+        {
+          if (filter != NULL && strstr (benchmarks[i].name, filter) == NULL)
+            continue;
+
+          run_benchmark (&benchmarks[i], &state, json);
+        }
+    }
+
+  if (json != NULL)
+    fclose (json);
+
+  clutter_actor_destroy (state.stage);
+
+  return EXIT_SUCCESS;
+}
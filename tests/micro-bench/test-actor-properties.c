@@ -0,0 +1,122 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <clutter/clutter.h>
+
+#define N_ACTORS 1000
+#define N_ITERATIONS 1000
+
+static gint n_actors = N_ACTORS;
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-actors", 'a',
+    0,
+    G_OPTION_ARG_INT, &n_actors,
+    "Number of actors", "ACTORS"
+  },
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  { NULL }
+};
+
+/* the number of property accesses done by update_actor() */
+#define N_ACCESSES 12
+
+/* sets and reads back the transformation, layout and easing state of
+ * @actor, each of which is stored outside of the instance structure
+ */
+static gfloat
+update_actor (ClutterActor *actor,
+              gint          iteration)
+{
+  gfloat value = (gfloat) (iteration % 100);
+  gdouble scale_x, scale_y;
+  gfloat retval;
+
+  clutter_actor_save_easing_state (actor);
+  clutter_actor_set_easing_duration (actor, 0);
+
+  clutter_actor_set_pivot_point (actor, 0.5f, 0.5f);
+  clutter_actor_set_scale (actor, 1.0 + value / 100.0, 1.0);
+  clutter_actor_set_rotation_angle (actor, CLUTTER_Z_AXIS, value);
+  clutter_actor_set_translation (actor, value, value, 0.f);
+  clutter_actor_set_margin_left (actor, value);
+  clutter_actor_set_x_align (actor, CLUTTER_ACTOR_ALIGN_CENTER);
+
+  clutter_actor_restore_easing_state (actor);
+
+  clutter_actor_get_scale (actor, &scale_x, &scale_y);
+
+  retval = (gfloat) scale_x;
+  retval += clutter_actor_get_rotation_angle (actor, CLUTTER_Z_AXIS);
+  retval += clutter_actor_get_margin_left (actor);
+  retval += clutter_actor_get_easing_duration (actor);
+
+  return retval;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *error = NULL;
+  ClutterActor **actors;
+  GTimer *timer;
+  gdouble elapsed;
+  gfloat sum = 0.f;
+  gint i, j;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Actor property test with "
+          "%d actors and %d iterations\n",
+          n_actors,
+          n_iterations);
+
+  actors = g_new (ClutterActor *, n_actors);
+  for (i = 0; i < n_actors; i++)
+    actors[i] = g_object_ref_sink (clutter_actor_new ());
+
+  /* warm up, and allocate the state of every actor */
+  for (i = 0; i < n_actors; i++)
+    sum += update_actor (actors[i], 0);
+
+  timer = g_timer_new ();
+
+  for (j = 0; j < n_iterations; j++)
+    for (i = 0; i < n_actors; i++)
+      sum += update_actor (actors[i], j);
+
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  printf ("Total: %.3f ms, %.1f ns per actor, %.1f ns per access (%g)\n",
+          elapsed * 1000.0,
+          elapsed * 1e9 / ((gdouble) n_iterations * n_actors),
+          elapsed * 1e9 / ((gdouble) n_iterations * n_actors * N_ACCESSES),
+          sum);
+
+  g_timer_destroy (timer);
+
+  for (i = 0; i < n_actors; i++)
+    {
+      clutter_actor_destroy (actors[i]);
+      g_object_unref (actors[i]);
+    }
+
+  g_free (actors);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <clutter/clutter.h>
+
+#define N_CHILDREN 1000
+#define N_ITERATIONS 200
+
+static gint n_children = N_CHILDREN;
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-children", 'c',
+    0,
+    G_OPTION_ARG_INT, &n_children,
+    "Number of children", "CHILDREN"
+  },
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  { NULL }
+};
+
+/* measures and allocates @box at a different width on each iteration,
+ * which looks up the child meta of every child of @box in each pass
+ */
+static void
+layout_box (ClutterActor *box,
+            gint          iteration)
+{
+  ClutterActorBox allocation;
+  gfloat min_width, nat_width;
+  gfloat min_height, nat_height;
+
+  /* drop the cached preferred size of the box, but not of its children */
+  clutter_actor_queue_relayout (box);
+
+  clutter_actor_get_preferred_width (box, -1, &min_width, &nat_width);
+  clutter_actor_get_preferred_height (box, nat_width, &min_height, &nat_height);
+
+  clutter_actor_box_init (&allocation,
+                          0.f, 0.f,
+                          nat_width + (iteration % 2),
+                          nat_height);
+  clutter_actor_allocate (box, &allocation, CLUTTER_ALLOCATION_NONE);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *error = NULL;
+  ClutterLayoutManager *layout;
+  ClutterActor *box;
+  GTimer *timer;
+  gdouble elapsed;
+  gint i;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Box layout test with "
+          "%d children and %d iterations\n",
+          n_children,
+          n_iterations);
+
+  layout = clutter_box_layout_new ();
+
+  box = g_object_ref_sink (clutter_actor_new ());
+  clutter_actor_set_layout_manager (box, layout);
+
+  for (i = 0; i < n_children; i++)
+    {
+      ClutterActor *child = clutter_actor_new ();
+
+      clutter_actor_set_size (child, 10.f + (i % 7), 10.f + (i % 5));
+      clutter_actor_add_child (box, child);
+
+      /* the child properties are stored in the child meta */
+      clutter_layout_manager_child_set (layout, CLUTTER_CONTAINER (box),
+                                        child,
+                                        "x-fill", i % 2 == 0,
+                                        "y-fill", TRUE,
+                                        NULL);
+    }
+
+  /* warm up, and create the child meta of every child */
+  layout_box (box, 0);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_iterations; i++)
+    layout_box (box, i + 1);
+
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  printf ("Total: %.3f ms, %.1f us per layout, %.1f ns per child\n",
+          elapsed * 1000.0,
+          elapsed * 1e6 / n_iterations,
+          elapsed * 1e9 / ((gdouble) n_iterations * n_children));
+
+  g_timer_destroy (timer);
+
+  clutter_actor_destroy (box);
+  g_object_unref (box);
+
+  return EXIT_SUCCESS;
+}
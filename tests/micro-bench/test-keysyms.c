@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <clutter/clutter.h>
+
+#define N_ITERATIONS 10000
+
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  { NULL }
+};
+
+static void
+report (const gchar *name,
+        gdouble      elapsed,
+        gint64       n_ops)
+{
+  printf ("%-28s %8.2f ns/op\n", name, elapsed * 1e9 / MAX (n_ops, 1));
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GArray *keysyms, *characters, *misses;
+  volatile guint sink = 0;
+  GTimer *timer;
+  guint i;
+  gint n;
+
+  context = g_option_context_new ("- keysym lookup benchmark");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_option_context_free (context);
+
+  /* collect the keys that go through the lookup tables, skipping the
+   * Latin-1 ranges that are mapped 1:1
+   */
+  keysyms = g_array_new (FALSE, FALSE, sizeof (guint));
+  characters = g_array_new (FALSE, FALSE, sizeof (guint32));
+  misses = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = 0x100; i < 0x10000; i++)
+    {
+      guint32 wc = i;
+
+      if (clutter_keysym_to_unicode (i) != 0)
+        g_array_append_val (keysyms, i);
+      else if (misses->len < keysyms->len)
+        g_array_append_val (misses, i);
+
+      if (clutter_unicode_to_keysym (wc) != (wc | 0x01000000))
+        g_array_append_val (characters, wc);
+    }
+
+  printf ("Keysym lookup test with %d iterations, %u keysyms, %u characters\n",
+          n_iterations,
+          keysyms->len,
+          characters->len);
+
+  timer = g_timer_new ();
+
+  for (n = 0; n < n_iterations; n++)
+    for (i = 0; i < keysyms->len; i++)
+      sink += clutter_keysym_to_unicode (g_array_index (keysyms, guint, i));
+
+  report ("keysym-to-unicode",
+          g_timer_elapsed (timer, NULL),
+          (gint64) n_iterations * keysyms->len);
+
+  g_timer_start (timer);
+
+  for (n = 0; n < n_iterations; n++)
+    for (i = 0; i < characters->len; i++)
+      sink += clutter_unicode_to_keysym (g_array_index (characters, guint32, i));
+
+  report ("unicode-to-keysym",
+          g_timer_elapsed (timer, NULL),
+          (gint64) n_iterations * characters->len);
+
+  /* keys without a mapping have to be rejected quickly as well */
+  g_timer_start (timer);
+
+  for (n = 0; n < n_iterations; n++)
+    for (i = 0; i < misses->len; i++)
+      sink += clutter_keysym_to_unicode (g_array_index (misses, guint, i));
+
+  report ("keysym-to-unicode-miss",
+          g_timer_elapsed (timer, NULL),
+          (gint64) n_iterations * misses->len);
+
+  g_timer_destroy (timer);
+  g_array_unref (keysyms);
+  g_array_unref (characters);
+  g_array_unref (misses);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <clutter/clutter.h>
+
+#define N_NODES 1000
+#define N_FRAMES 1000
+
+static gint n_nodes = N_NODES;
+static gint n_frames = N_FRAMES;
+
+static GOptionEntry entries[] = {
+  {
+    "num-nodes", 'n',
+    0,
+    G_OPTION_ARG_INT, &n_nodes,
+    "Number of nodes per frame", "NODES"
+  },
+  {
+    "num-frames", 'f',
+    0,
+    G_OPTION_ARG_INT, &n_frames,
+    "Number of frames", "FRAMES"
+  },
+  { NULL }
+};
+
+/* builds and releases a paint node tree similar to the one created by
+ * a frame with @n_nodes actors, each with a background color
+ */
+static void
+build_frame (void)
+{
+  ClutterColor color = { 0xff, 0x00, 0x00, 0xff };
+  ClutterActorBox box = { 0.f, 0.f, 100.f, 100.f };
+  ClutterPaintNode *root;
+  gint i;
+
+  root = clutter_color_node_new (NULL);
+  clutter_paint_node_set_name (root, "Root");
+
+  for (i = 0; i < n_nodes; i++)
+    {
+      ClutterPaintNode *node;
+
+      color.green = i & 0xff;
+
+      node = clutter_color_node_new (&color);
+      clutter_paint_node_add_rectangle (node, &box);
+      clutter_paint_node_add_child (root, node);
+      clutter_paint_node_unref (node);
+    }
+
+  clutter_paint_node_unref (root);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *error = NULL;
+  GTimer *timer;
+  gdouble elapsed;
+  gint i;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Paint node allocation test with "
+          "%d nodes per frame and %d frames\n",
+          n_nodes,
+          n_frames);
+
+  /* warm up */
+  build_frame ();
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_frames; i++)
+    build_frame ();
+
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  printf ("Total: %.3f ms, %.3f ms per frame, %.1f ns per node\n",
+          elapsed * 1000.0,
+          elapsed * 1000.0 / n_frames,
+          elapsed * 1e9 / ((gdouble) n_frames * n_nodes));
+
+  g_timer_destroy (timer);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,361 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <clutter/clutter.h>
+#include <cogl-pango/cogl-pango.h>
+
+#define N_ITERATIONS 1000
+
+static gint n_iterations = N_ITERATIONS;
+static gchar *corpus_name = NULL;
+static gchar *font_name = "Sans 12";
+
+static GOptionEntry entries[] = {
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  {
+    "corpus", 'c',
+    0,
+    G_OPTION_ARG_STRING, &corpus_name,
+    "Only run the given corpus (ascii, cjk, bidi, markup)", "CORPUS"
+  },
+  {
+    "font", 'f',
+    0,
+    G_OPTION_ARG_STRING, &font_name,
+    "Font to use", "FONT"
+  },
+  { NULL }
+};
+
+typedef struct {
+  const gchar *name;
+  const gchar *text;
+  gboolean use_markup;
+} Corpus;
+
+static const Corpus corpora[] = {
+  {
+    "ascii",
+    "The quick brown fox jumps over the lazy dog, 0123456789 times.",
+    FALSE
+  },
+  {
+    "cjk",
+    "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0"
+    "\xe3\x82\x92\xe8\xa1\xa8\xe7\xa4\xba\xe3\x81\x99\xe3\x82\x8b\xe3\x80\x82"
+    "\xe4\xb8\xad\xe6\x96\x87\xe5\xad\x97\xe7\xac\xa6\xe4\xb8\xb2\xe3\x80\x82"
+    "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4 \xeb\xac\xb8\xec\x9e\x90\xec\x97\xb4.",
+    FALSE
+  },
+  {
+    "bidi",
+    "English text \xd7\xa2\xd7\x91\xd7\xa8\xd7\x99\xd7\xaa "
+    "\xd8\xa7\xd9\x84\xd8\xb9\xd8\xb1\xd8\xa8\xd9\x8a\xd8\xa9 "
+    "123 more English \xd7\xa9\xd7\x9c\xd7\x95\xd7\x9d.",
+    FALSE
+  },
+  {
+    "markup",
+    "<b>Bold</b> <i>italic</i> <span foreground='red'>red</span> "
+    "<span size='large'>large</span> <u>underlined</u> "
+    "<span font='Monospace'>mono</span> <s>struck</s> <sub>sub</sub>",
+    TRUE
+  },
+};
+
+static void
+report (const Corpus *corpus,
+        const gchar  *phase,
+        gdouble       elapsed,
+        gint          n_ops)
+{
+  printf ("%-8s %-24s %12.1f ns/op\n",
+          corpus->name,
+          phase,
+          elapsed * 1e9 / MAX (n_ops, 1));
+}
+
+/* returns a different string each time, so that nothing is cached */
+static gchar *
+unique_text (const Corpus *corpus,
+             gint          iteration)
+{
+  if (corpus->use_markup)
+    return g_strdup_printf ("%s <b>%d</b>", corpus->text, iteration);
+
+  return g_strdup_printf ("%s %d", corpus->text, iteration);
+}
+
+static void
+set_contents (PangoLayout  *layout,
+              const Corpus *corpus,
+              const gchar  *text)
+{
+  if (corpus->use_markup)
+    pango_layout_set_markup (layout, text, -1);
+  else
+    pango_layout_set_text (layout, text, -1);
+}
+
+/* creates and shapes a new layout for each iteration */
+static void
+bench_layout_creation (const Corpus *corpus,
+                       PangoContext *context)
+{
+  PangoFontDescription *desc = pango_font_description_from_string (font_name);
+  gchar **texts = g_new (gchar *, n_iterations);
+  GTimer *timer;
+  gint i;
+
+  for (i = 0; i < n_iterations; i++)
+    texts[i] = unique_text (corpus, i);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      PangoLayout *layout = pango_layout_new (context);
+      PangoRectangle logical;
+
+      pango_layout_set_font_description (layout, desc);
+      set_contents (layout, corpus, texts[i]);
+      pango_layout_get_extents (layout, NULL, &logical);
+
+      g_object_unref (layout);
+    }
+
+  report (corpus, "layout-creation", g_timer_elapsed (timer, NULL), n_iterations);
+
+  g_timer_destroy (timer);
+
+  for (i = 0; i < n_iterations; i++)
+    g_free (texts[i]);
+
+  g_free (texts);
+  pango_font_description_free (desc);
+}
+
+static void
+set_text_contents (ClutterText  *text,
+                   const Corpus *corpus,
+                   const gchar  *contents)
+{
+  if (corpus->use_markup)
+    clutter_text_set_markup (text, contents);
+  else
+    clutter_text_set_text (text, contents);
+}
+
+/* measures new contents each time, then the same contents again */
+static void
+bench_preferred_size (const Corpus *corpus)
+{
+  ClutterActor *actor = clutter_text_new_with_text (font_name, "");
+  gchar **texts = g_new (gchar *, n_iterations);
+  gdouble miss_time = 0, hit_time = 0, shared_time;
+  gfloat min_width, nat_width, min_height, nat_height;
+  ClutterActor **actors;
+  GTimer *timer;
+  gint i;
+
+  g_object_ref_sink (actor);
+
+  for (i = 0; i < n_iterations; i++)
+    texts[i] = unique_text (corpus, i);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      set_text_contents (CLUTTER_TEXT (actor), corpus, texts[i]);
+
+      g_timer_start (timer);
+      clutter_actor_get_preferred_width (actor, -1, &min_width, &nat_width);
+      clutter_actor_get_preferred_height (actor, nat_width, &min_height, &nat_height);
+      miss_time += g_timer_elapsed (timer, NULL);
+
+      g_timer_start (timer);
+      clutter_actor_get_preferred_width (actor, -1, &min_width, &nat_width);
+      clutter_actor_get_preferred_height (actor, nat_width, &min_height, &nat_height);
+      hit_time += g_timer_elapsed (timer, NULL);
+    }
+
+  report (corpus, "preferred-size-miss", miss_time, n_iterations);
+  report (corpus, "preferred-size-hit", hit_time, n_iterations);
+
+  /* many actors with the same contents, which can share their layouts */
+  actors = g_new (ClutterActor *, n_iterations);
+  for (i = 0; i < n_iterations; i++)
+    {
+      actors[i] = g_object_ref_sink (clutter_text_new_with_text (font_name, ""));
+      set_text_contents (CLUTTER_TEXT (actors[i]), corpus, corpus->text);
+    }
+
+  g_timer_start (timer);
+
+  for (i = 0; i < n_iterations; i++)
+    clutter_actor_get_preferred_width (actors[i], -1, &min_width, &nat_width);
+
+  shared_time = g_timer_elapsed (timer, NULL);
+  report (corpus, "preferred-size-shared", shared_time, n_iterations);
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      clutter_actor_destroy (actors[i]);
+      g_object_unref (actors[i]);
+    }
+
+  g_free (actors);
+  g_timer_destroy (timer);
+
+  for (i = 0; i < n_iterations; i++)
+    g_free (texts[i]);
+
+  g_free (texts);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (actor);
+}
+
+/* uploads the glyphs of a layout to an empty glyph cache */
+static void
+bench_glyph_upload (const Corpus *corpus,
+                    PangoContext *context)
+{
+  PangoFontDescription *desc = pango_font_description_from_string (font_name);
+  PangoLayout *layout = pango_layout_new (context);
+  gdouble elapsed = 0;
+  GTimer *timer;
+  gint i;
+
+  pango_layout_set_font_description (layout, desc);
+  set_contents (layout, corpus, corpus->text);
+  pango_layout_get_extents (layout, NULL, NULL);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      clutter_clear_glyph_cache ();
+
+      g_timer_start (timer);
+      cogl_pango_ensure_glyph_cache_for_layout (layout);
+      elapsed += g_timer_elapsed (timer, NULL);
+    }
+
+  report (corpus, "glyph-cache-upload", elapsed, n_iterations);
+
+  g_timer_destroy (timer);
+  g_object_unref (layout);
+  pango_font_description_free (desc);
+}
+
+/* submits an already shaped layout with cached glyphs to an offscreen
+ * framebuffer, so that no window is needed
+ */
+static void
+bench_paint (const Corpus *corpus,
+             PangoContext *context)
+{
+  PangoFontDescription *desc = pango_font_description_from_string (font_name);
+  PangoLayout *layout = pango_layout_new (context);
+  CoglColor color;
+  CoglTexture *texture;
+  CoglOffscreen *offscreen;
+  CoglFramebuffer *fb;
+  CoglError *error = NULL;
+  gdouble elapsed;
+  GTimer *timer;
+  gint i;
+
+  texture = cogl_texture_new_with_size (512, 64,
+                                        COGL_TEXTURE_NO_SLICING,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  offscreen = cogl_offscreen_new_with_texture (texture);
+  fb = COGL_FRAMEBUFFER (offscreen);
+
+  if (!cogl_framebuffer_allocate (fb, &error))
+    {
+      printf ("%-8s %-24s skipped: %s\n", corpus->name, "paint", error->message);
+      cogl_error_free (error);
+      goto out;
+    }
+
+  cogl_framebuffer_orthographic (fb, 0, 0, 512, 64, -1, 100);
+  cogl_color_init_from_4ub (&color, 0xff, 0xff, 0xff, 0xff);
+
+  pango_layout_set_font_description (layout, desc);
+  set_contents (layout, corpus, corpus->text);
+  cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+  /* warm up the geometry cached on the layout */
+  cogl_pango_show_layout (fb, layout, 0, 0, &color);
+  cogl_framebuffer_finish (fb);
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_iterations; i++)
+    cogl_pango_show_layout (fb, layout, 0, 0, &color);
+
+  cogl_framebuffer_finish (fb);
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  report (corpus, "paint-submission", elapsed, n_iterations);
+
+  g_timer_destroy (timer);
+
+out:
+  cogl_object_unref (offscreen);
+  cogl_object_unref (texture);
+  g_object_unref (layout);
+  pango_font_description_free (desc);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *error = NULL;
+  PangoContext *context;
+  PangoFontMap *font_map;
+  gint i;
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    {
+      g_printerr ("Unable to initialize Clutter: %s\n",
+                  error != NULL ? error->message : "unknown error");
+      return EXIT_FAILURE;
+    }
+
+  printf ("Text breakdown test with %d iterations, using '%s'\n",
+          n_iterations,
+          font_name);
+
+  font_map = clutter_get_font_map ();
+  context = pango_font_map_create_context (font_map);
+
+  for (i = 0; i < G_N_ELEMENTS (corpora); i++)
+    {
+      const Corpus *corpus = &corpora[i];
+
+      if (corpus_name != NULL && strcmp (corpus_name, corpus->name) != 0)
+        continue;
+
+      bench_layout_creation (corpus, context);
+      bench_preferred_size (corpus);
+      bench_glyph_upload (corpus, context);
+      bench_paint (corpus, context);
+    }
+
+  g_object_unref (context);
+
+  return EXIT_SUCCESS;
+}
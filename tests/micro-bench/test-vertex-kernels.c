@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <clutter/clutter.h>
+
+#include "clutter-vertex-kernels.h"
+
+#define N_ITERATIONS 1000000
+
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  { NULL }
+};
+
+static void
+report (const gchar *kernel,
+        const gchar *name,
+        gdouble      elapsed,
+        gint64       n_ops)
+{
+  printf ("%-8s %-20s %8.2f ns/vertex\n", kernel, name, elapsed * 1e9 / MAX (n_ops, 1));
+}
+
+/* the paint volume of a rotated actor on a default stage */
+static void
+setup_matrices (CoglMatrix *modelview,
+                CoglMatrix *projection,
+                float      *viewport)
+{
+  viewport[0] = 0.f;
+  viewport[1] = 0.f;
+  viewport[2] = 800.f;
+  viewport[3] = 600.f;
+
+  cogl_matrix_init_identity (projection);
+  cogl_matrix_perspective (projection, 60.f, 800.f / 600.f, 0.1f, 100.f);
+
+  cogl_matrix_init_identity (modelview);
+  cogl_matrix_translate (modelview, -0.5f, 0.5f, -0.866f);
+  cogl_matrix_scale (modelview, 1.f / 600.f, -1.f / 600.f, 1.f / 600.f);
+  cogl_matrix_translate (modelview, 200.f, 150.f, 0.f);
+  cogl_matrix_rotate (modelview, 30.f, 0.f, 1.f, 0.f);
+}
+
+static void
+setup_vertices (ClutterVertex *vertices)
+{
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      vertices[i].x = (i & 1) ? 320.f : 0.f;
+      vertices[i].y = (i & 2) ? 240.f : 0.f;
+      vertices[i].z = (i & 4) ? 50.f : 0.f;
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  const ClutterVertexKernel * const *kernels;
+  CoglMatrix modelview, projection, mvp;
+  ClutterVertex vertices[8], reference[8], result[8];
+  float viewport[4];
+  GTimer *timer;
+  guint n_kernels, k;
+  gint n, i;
+
+  context = g_option_context_new ("- vertex transform benchmark");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_option_context_free (context);
+
+  setup_matrices (&modelview, &projection, viewport);
+  cogl_matrix_multiply (&mvp, &projection, &modelview);
+
+  kernels = _clutter_vertex_kernel_get_supported (&n_kernels);
+
+  printf ("Vertex transform test with %d iterations, %u kernels, using '%s'\n",
+          n_iterations,
+          n_kernels,
+          _clutter_vertex_kernel_get_default ()->name);
+
+  timer = g_timer_new ();
+
+  /* the code the kernels replace */
+  setup_vertices (vertices);
+  g_timer_start (timer);
+
+  for (n = 0; n < n_iterations; n++)
+    cogl_matrix_transform_points (&modelview,
+                                  3,
+                                  sizeof (ClutterVertex),
+                                  vertices,
+                                  sizeof (ClutterVertex),
+                                  result,
+                                  8);
+
+  report ("cogl", "transform", g_timer_elapsed (timer, NULL),
+          (gint64) n_iterations * 8);
+
+  g_timer_start (timer);
+
+  for (n = 0; n < n_iterations; n++)
+    {
+      float tmp[8 * 4];
+
+      cogl_matrix_project_points (&mvp,
+                                  3,
+                                  sizeof (ClutterVertex),
+                                  vertices,
+                                  sizeof (float) * 4,
+                                  tmp,
+                                  8);
+
+      for (i = 0; i < 8; i++)
+        {
+          result[i].x = ((tmp[i * 4] / tmp[i * 4 + 3] + 1.f) / 2.f) * viewport[2];
+          result[i].y = viewport[3] - ((tmp[i * 4 + 1] / tmp[i * 4 + 3] + 1.f) / 2.f) * viewport[3];
+        }
+    }
+
+  report ("cogl", "project", g_timer_elapsed (timer, NULL),
+          (gint64) n_iterations * 8);
+
+  for (k = 0; k < n_kernels; k++)
+    {
+      const ClutterVertexKernel *kernel = kernels[k];
+      const float *matrix = cogl_matrix_get_array (&modelview);
+      float max_error = 0.f;
+
+      g_timer_start (timer);
+
+      for (n = 0; n < n_iterations; n++)
+        kernel->transform (matrix, vertices, result, 8);
+
+      report (kernel->name, "transform", g_timer_elapsed (timer, NULL),
+              (gint64) n_iterations * 8);
+
+      /* the 2D actors only project the four front vertices */
+      matrix = cogl_matrix_get_array (&mvp);
+
+      g_timer_start (timer);
+
+      for (n = 0; n < n_iterations; n++)
+        kernel->project (matrix, viewport, vertices, result, 4);
+
+      report (kernel->name, "project (4 vertices)", g_timer_elapsed (timer, NULL),
+              (gint64) n_iterations * 4);
+
+      g_timer_start (timer);
+
+      for (n = 0; n < n_iterations; n++)
+        kernel->project (matrix, viewport, vertices, result, 8);
+
+      report (kernel->name, "project (8 vertices)", g_timer_elapsed (timer, NULL),
+              (gint64) n_iterations * 8);
+
+      /* every kernel has to agree with the scalar one */
+      kernels[0]->project (matrix, viewport, vertices, reference, 8);
+
+      for (i = 0; i < 8; i++)
+        {
+          max_error = MAX (max_error, fabsf (result[i].x - reference[i].x));
+          max_error = MAX (max_error, fabsf (result[i].y - reference[i].y));
+        }
+
+      if (max_error > 0.01f)
+        {
+          g_printerr ("The '%s' kernel is off by %f pixels\n",
+                      kernel->name,
+                      max_error);
+          return EXIT_FAILURE;
+        }
+    }
+
+  g_timer_destroy (timer);
+
+  return EXIT_SUCCESS;
+}
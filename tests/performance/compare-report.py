@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+# Compares the JSON performance report written by the tests when
+# CLUTTER_PERFORMANCE_JSON is set against a stored baseline, and exits
+# with a non-zero status if any test regressed.
+#
+# Usage: compare-report.py [--threshold PERCENT] BASELINE REPORT
+
+import argparse
+import json
+import sys
+
+# the metrics that regress when they grow; fps regresses when it drops
+LOWER_IS_BETTER = [
+    'frame_time_p50',
+    'frame_time_p95',
+    'frame_time_p99',
+    'missed_vblanks',
+    'input_latency_p50',
+    'input_latency_p95',
+    'events',
+    'timelines',
+    'layout',
+    'paint',
+    'pick',
+    'swap',
+    'ns_per_op',
+    'bytes_per_op',
+    'allocs_per_op',
+]
+
+HIGHER_IS_BETTER = [
+    'fps',
+]
+
+# below this value, in milliseconds, the differences are noise
+MIN_SIGNIFICANT = 0.05
+
+
+def load_report(path):
+    report = {}
+
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+
+            entry = json.loads(line)
+            report[entry['id']] = entry
+
+    return report
+
+
+def compare_metric(name, old, new):
+    if old is None or new is None:
+        return None
+
+    if max(abs(old), abs(new)) < MIN_SIGNIFICANT:
+        return None
+
+    if old == 0:
+        change = 100.0
+    else:
+        change = (new - old) * 100.0 / abs(old)
+
+    if name in HIGHER_IS_BETTER:
+        change = -change
+
+    return change
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare performance reports')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='allowed regression, in percent (default: 5)')
+    parser.add_argument('baseline')
+    parser.add_argument('report')
+    args = parser.parse_args()
+
+    baseline = load_report(args.baseline)
+    report = load_report(args.report)
+
+    regressions = 0
+
+    for test_id in sorted(report):
+        if test_id not in baseline:
+            print('%s: no baseline' % test_id)
+            continue
+
+        for name in HIGHER_IS_BETTER + LOWER_IS_BETTER:
+            old = baseline[test_id].get(name)
+            new = report[test_id].get(name)
+            change = compare_metric(name, old, new)
+
+            if change is None:
+                continue
+
+            if change > args.threshold:
+                status = 'REGRESSED'
+                regressions += 1
+            elif change < -args.threshold:
+                status = 'improved'
+            else:
+                continue
+
+            print('%s: %s %s -> %s (%+.1f%%) %s' %
+                  (test_id, name, old, new, change, status))
+
+    for test_id in sorted(baseline):
+        if test_id not in report:
+            print('%s: missing from the report' % test_id)
+
+    if regressions > 0:
+        print('%d regressions over %.1f%%' % (regressions, args.threshold))
+        return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+#include "test-common.h"
+
+#define STAGE_WIDTH  800
+#define STAGE_HEIGHT 600
+
+#define N_PARAGRAPHS 200
+
+static gint n_paragraphs = N_PARAGRAPHS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-paragraphs", 'p',
+    0,
+    G_OPTION_ARG_INT, &n_paragraphs,
+    "Number of paragraphs", "PARAGRAPHS"
+  },
+  { NULL }
+};
+
+static const char paragraph[] =
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+  "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+  "ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+  "aliquip ex ea commodo consequat. \xce\x91\xce\xb2\xce\xb3 "
+  "\xd0\x90\xd0\xb1\xd0\xb2 0123456789.\n";
+
+/* inserting a character at the start of the text invalidates the
+ * layout of the whole buffer, like typing at the top of a long document
+ */
+static gboolean
+edit_text (gpointer data)
+{
+  ClutterText *text = data;
+  static gint n_edits = 0;
+
+  clutter_text_set_cursor_position (text, 0);
+
+  if ((n_edits++ % 2) == 0)
+    clutter_text_insert_unichar (text, 'x');
+  else
+    clutter_text_delete_text (text, 0, 1);
+
+  return G_SOURCE_CONTINUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterColor text_color = { 0xff, 0xff, 0xff, 0xff };
+  ClutterActor *stage, *text;
+  GString *str;
+  gint i;
+
+  clutter_perf_fps_init ();
+
+  if (CLUTTER_INIT_SUCCESS !=
+        clutter_init_with_args (&argc, &argv,
+                                NULL,
+                                entries,
+                                NULL,
+                                NULL))
+    {
+      g_warning ("Failed to initialize clutter");
+      return -1;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, STAGE_WIDTH, STAGE_HEIGHT);
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Big Text Performance");
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_main_quit), NULL);
+
+  str = g_string_new (NULL);
+  for (i = 0; i < n_paragraphs; i++)
+    g_string_append (str, paragraph);
+
+  printf ("Big text performance test with %d paragraphs, %d bytes\n",
+          n_paragraphs,
+          (int) str->len);
+
+  text = clutter_text_new_full ("Sans 12px", str->str, &text_color);
+  clutter_text_set_editable (CLUTTER_TEXT (text), TRUE);
+  clutter_text_set_line_wrap (CLUTTER_TEXT (text), TRUE);
+  clutter_actor_set_width (text, STAGE_WIDTH);
+  clutter_actor_add_child (stage, text);
+
+  g_string_free (str, TRUE);
+
+  clutter_actor_show (stage);
+
+  clutter_perf_fps_start (CLUTTER_STAGE (stage));
+  clutter_threads_add_idle (edit_text, text);
+  clutter_main ();
+  clutter_perf_fps_report ("test-big-text");
+
+  return 0;
+}
@@ -1,4 +1,6 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
 #include <glib.h>
 #include <clutter/clutter.h>
 
@@ -6,15 +8,34 @@ static GTimer *testtimer = NULL;
 static gint testframes = 0;
 static float testmaxtime = 1.0;
 
+/* the timing information of each frame, as collected by the stage */
+static GArray *testframeinfo = NULL;
+
+/* the input to screen latencies of the frames processing input */
+static GArray *testlatencies = NULL;
+
 /* initialize environment to be suitable for fps testing */
 void clutter_perf_fps_init (void)
 {
-  /* Force not syncing to vblank, we want free-running maximum FPS */
-  g_setenv ("vblank_mode", "0", FALSE);
-  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  /* the headless backend is never throttled, and it advances the
+   * timelines by one frame interval at each frame, so it keeps the
+   * usual frame interval for the animations to progress as on screen
+   */
+  if (g_strcmp0 (g_getenv ("CLUTTER_BACKEND"), "headless") == 0)
+    g_setenv ("CLUTTER_DEFAULT_FPS", "60", FALSE);
 
-  /* also overrride internal default FPS */
-  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+  /* Force not syncing to vblank, we want free-running maximum FPS;
+   * frame pacing (and missed vblanks) can only be measured when
+   * syncing, though
+   */
+  if (!g_getenv ("CLUTTER_PERFORMANCE_SYNC_TO_VBLANK"))
+    {
+      g_setenv ("vblank_mode", "0", FALSE);
+      g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+
+      /* also overrride internal default FPS */
+      g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+    }
 
   if (g_getenv ("CLUTTER_PERFORMANCE_TEST_DURATION"))
     testmaxtime = atof(g_getenv("CLUTTER_PERFORMANCE_TEST_DURATION"));
@@ -25,22 +46,197 @@ void clutter_perf_fps_init (void)
 }
 
 static void perf_stage_paint_cb (ClutterStage *stage, gpointer *data);
+static void perf_stage_frame_info_cb (ClutterStage     *stage,
+                                      ClutterFrameInfo *info,
+                                      gpointer          data);
 static gboolean perf_fake_mouse_cb (gpointer stage);
 
 void clutter_perf_fps_start (ClutterStage *stage)
 {
+  testframeinfo = g_array_new (FALSE, FALSE, sizeof (ClutterFrameInfo));
+  testlatencies = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  clutter_stage_set_collect_frame_info (stage, TRUE);
+
   g_signal_connect (stage, "paint", G_CALLBACK (perf_stage_paint_cb), NULL);
+  g_signal_connect (stage, "frame-info",
+                    G_CALLBACK (perf_stage_frame_info_cb),
+                    NULL);
 }
 
 void clutter_perf_fake_mouse (ClutterStage *stage)
 {
+  /* a recorded session drives the input instead, see the
+   * CLUTTER_REPLAY_EVENTS environment variable
+   */
+  if (g_getenv ("CLUTTER_REPLAY_EVENTS") != NULL)
+    return;
+
   clutter_threads_add_timeout (1000/60, perf_fake_mouse_cb, stage);
 }
 
+static int perf_compare_doubles (gconstpointer a, gconstpointer b)
+{
+  gdouble da = *(const gdouble *) a;
+  gdouble db = *(const gdouble *) b;
+
+  return da < db ? -1 : da > db ? 1 : 0;
+}
+
+/* nearest rank percentile of a sorted array */
+static gdouble perf_percentile (GArray *sorted, gdouble percentile)
+{
+  guint rank;
+
+  if (sorted->len == 0)
+    return 0.0;
+
+  rank = (guint) ceil (percentile / 100.0 * sorted->len);
+  rank = CLAMP (rank, 1, sorted->len);
+
+  return g_array_index (sorted, gdouble, rank - 1);
+}
+
+static gdouble perf_phase_mean (gsize start_offset, gsize end_offset)
+{
+  gdouble total = 0.0;
+  guint i, n = 0;
+
+  for (i = 0; i < testframeinfo->len; i++)
+    {
+      ClutterFrameInfo *info = &g_array_index (testframeinfo, ClutterFrameInfo, i);
+      gint64 start = G_STRUCT_MEMBER (gint64, info, start_offset);
+      gint64 end = G_STRUCT_MEMBER (gint64, info, end_offset);
+
+      if (start == 0 || end == 0)
+        continue;
+
+      total += end - start;
+      n += 1;
+    }
+
+  return n > 0 ? total / n / 1000.0 : 0.0;
+}
+
+#define PERF_PHASE_MEAN(phase) \
+  perf_phase_mean (G_STRUCT_OFFSET (ClutterFrameInfo, phase##_start), \
+                   G_STRUCT_OFFSET (ClutterFrameInfo, phase##_end))
+
 void clutter_perf_fps_report (const gchar *id)
 {
-  g_print ("\n@ %s: %.2f fps \n",
-       id, testframes / g_timer_elapsed (testtimer, NULL));
+  GArray *intervals;
+  gdouble fps, vblank, pick_time = 0.0;
+  gint missed_vblanks = -1;
+  gboolean presented = TRUE;
+  const gchar *json_path;
+  guint i;
+
+  fps = testframes / g_timer_elapsed (testtimer, NULL);
+
+  g_print ("\n@ %s: %.2f fps \n", id, fps);
+
+  /* use the presentation times if all frames have them, and the
+   * master clock ticks otherwise
+   */
+  for (i = 0; i < testframeinfo->len; i++)
+    {
+      if (g_array_index (testframeinfo, ClutterFrameInfo, i).presentation_time == 0)
+        presented = FALSE;
+    }
+
+  intervals = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  for (i = 1; i < testframeinfo->len; i++)
+    {
+      const ClutterFrameInfo *prev = &g_array_index (testframeinfo, ClutterFrameInfo, i - 1);
+      const ClutterFrameInfo *cur = &g_array_index (testframeinfo, ClutterFrameInfo, i);
+      gdouble interval;
+
+      if (presented)
+        interval = cur->presentation_time - prev->presentation_time;
+      else
+        interval = cur->frame_time - prev->frame_time;
+
+      interval /= 1000.0;
+      g_array_append_val (intervals, interval);
+    }
+
+  for (i = 0; i < testframeinfo->len; i++)
+    pick_time += g_array_index (testframeinfo, ClutterFrameInfo, i).pick_time;
+
+  if (testframeinfo->len > 0)
+    pick_time = pick_time / testframeinfo->len / 1000.0;
+
+  g_array_sort (intervals, perf_compare_doubles);
+  g_array_sort (testlatencies, perf_compare_doubles);
+
+  /* the most frequent interval between presented frames is the refresh
+   * interval, as long as the scene keeps up most of the time
+   */
+  vblank = perf_percentile (intervals, 50);
+  if (presented && vblank > 0.0)
+    {
+      missed_vblanks = 0;
+      for (i = 0; i < intervals->len; i++)
+        {
+          gdouble interval = g_array_index (intervals, gdouble, i);
+
+          missed_vblanks += MAX (0, (gint) floor (interval / vblank + 0.5) - 1);
+        }
+    }
+
+  g_print ("@ %s: frame time p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, "
+           "missed vblanks %d\n",
+           id,
+           perf_percentile (intervals, 50),
+           perf_percentile (intervals, 95),
+           perf_percentile (intervals, 99),
+           missed_vblanks);
+
+  /* one JSON object per line, to be compared by compare-report.py */
+  json_path = g_getenv ("CLUTTER_PERFORMANCE_JSON");
+  if (json_path != NULL)
+    {
+      FILE *json = fopen (json_path, "a");
+
+      if (json == NULL)
+        g_error ("Unable to open '%s'", json_path);
+
+      fprintf (json,
+               "{ \"id\": \"%s\", \"fps\": %.2f, \"frames\": %u, "
+               "\"frame_time_p50\": %.3f, \"frame_time_p95\": %.3f, "
+               "\"frame_time_p99\": %.3f, ",
+               id, fps, testframeinfo->len,
+               perf_percentile (intervals, 50),
+               perf_percentile (intervals, 95),
+               perf_percentile (intervals, 99));
+
+      if (missed_vblanks >= 0)
+        fprintf (json, "\"missed_vblanks\": %d, ", missed_vblanks);
+      else
+        fprintf (json, "\"missed_vblanks\": null, ");
+
+      if (testlatencies->len > 0)
+        fprintf (json,
+                 "\"input_latency_p50\": %.3f, \"input_latency_p95\": %.3f, ",
+                 perf_percentile (testlatencies, 50),
+                 perf_percentile (testlatencies, 95));
+      else
+        fprintf (json, "\"input_latency_p50\": null, \"input_latency_p95\": null, ");
+
+      fprintf (json,
+               "\"events\": %.3f, \"timelines\": %.3f, \"layout\": %.3f, "
+               "\"paint\": %.3f, \"pick\": %.3f, \"swap\": %.3f }\n",
+               PERF_PHASE_MEAN (events),
+               PERF_PHASE_MEAN (timelines),
+               PERF_PHASE_MEAN (layout),
+               PERF_PHASE_MEAN (paint),
+               pick_time,
+               PERF_PHASE_MEAN (swap));
+
+      fclose (json);
+    }
+
+  g_array_free (intervals, TRUE);
 }
 
 static void perf_stage_paint_cb (ClutterStage *stage, gpointer *data)
@@ -54,6 +250,32 @@ static void perf_stage_paint_cb (ClutterStage *stage, gpointer *data)
     }
 }
 
+static void perf_stage_frame_info_cb (ClutterStage     *stage,
+                                      ClutterFrameInfo *info,
+                                      gpointer          data)
+{
+  g_array_append_val (testframeinfo, *info);
+
+  /* the stage records the input device times of the events processed
+   * by each frame
+   */
+  if (info->n_input_events > 0)
+    {
+      gint64 screen_time;
+      gdouble latency;
+
+      if (info->presentation_time != 0)
+        screen_time = info->presentation_time;
+      else if (info->swap_end != 0)
+        screen_time = info->swap_end;
+      else
+        screen_time = info->paint_end;
+
+      latency = (screen_time - info->oldest_input_time) / 1000.0;
+      g_array_append_val (testlatencies, latency);
+    }
+}
+
 static void wrap (gfloat *value, gfloat min, gfloat max)
 {
   if (*value > max)
@@ -106,6 +328,9 @@ static gboolean perf_fake_mouse_cb (gpointer stage)
   event->motion.stage = stage;
   event->motion.device = device;
 
+  /* the synthesized events are reported at the same time */
+  clutter_event_set_hardware_time (event, g_get_monotonic_time ());
+
   /* called about every 60fps, and do 10 picks per stage */
   for (i = 0; i < 10; i++)
     {
@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+#include "test-common.h"
+
+#define STAGE_WIDTH  800
+#define STAGE_HEIGHT 600
+
+#define N_DEPTH   100
+#define N_BRANCHES  4
+
+static gint n_depth = N_DEPTH;
+static gint n_branches = N_BRANCHES;
+
+static GOptionEntry entries[] = {
+  {
+    "depth", 'd',
+    0,
+    G_OPTION_ARG_INT, &n_depth,
+    "Depth of each branch of the hierarchy", "DEPTH"
+  },
+  {
+    "num-branches", 'b',
+    0,
+    G_OPTION_ARG_INT, &n_branches,
+    "Number of branches of the hierarchy", "BRANCHES"
+  },
+  { NULL }
+};
+
+static void
+new_frame (ClutterTimeline *timeline,
+           gint             msecs,
+           ClutterActor    *root)
+{
+  gdouble progress = clutter_timeline_get_progress (timeline);
+  ClutterActor *child;
+
+  /* rotating the first level of each branch invalidates the
+   * transformations of the whole hierarchy below it
+   */
+  for (child = clutter_actor_get_first_child (root);
+       child != NULL;
+       child = clutter_actor_get_next_sibling (child))
+    clutter_actor_set_rotation_angle (child, CLUTTER_Z_AXIS, 360.0 * progress);
+}
+
+static ClutterActor *
+create_branch (gint branch)
+{
+  ClutterColor color = { 0x00, 0x00, 0x00, 0xff };
+  ClutterActor *top = NULL, *parent = NULL;
+  gint i;
+
+  for (i = 0; i < n_depth; i++)
+    {
+      ClutterActor *actor = clutter_actor_new ();
+
+      color.red = (branch * 64) & 0xff;
+      color.green = (i * 255) / n_depth;
+      color.blue = 0xff - color.green;
+
+      clutter_actor_set_background_color (actor, &color);
+      clutter_actor_set_size (actor, 200.0f, 200.0f);
+      clutter_actor_set_pivot_point (actor, 0.5f, 0.5f);
+      clutter_actor_set_position (actor, 1.0f, 1.0f);
+      clutter_actor_set_scale (actor, 0.99, 0.99);
+
+      if (parent != NULL)
+        clutter_actor_add_child (parent, actor);
+      else
+        top = actor;
+
+      parent = actor;
+    }
+
+  return top;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage;
+  ClutterTimeline *timeline;
+  gint i;
+
+  clutter_perf_fps_init ();
+
+  if (CLUTTER_INIT_SUCCESS !=
+        clutter_init_with_args (&argc, &argv,
+                                NULL,
+                                entries,
+                                NULL,
+                                NULL))
+    {
+      g_warning ("Failed to initialize clutter");
+      return -1;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, STAGE_WIDTH, STAGE_HEIGHT);
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Deep Hierarchy Performance");
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_main_quit), NULL);
+
+  printf ("Deep hierarchy performance test with "
+          "%d branches of %d actors\n",
+          n_branches,
+          n_depth);
+
+  for (i = 0; i < n_branches; i++)
+    {
+      ClutterActor *branch = create_branch (i);
+
+      clutter_actor_set_position (branch,
+                                  (STAGE_WIDTH / n_branches) * i,
+                                  STAGE_HEIGHT / 3);
+      clutter_actor_add_child (stage, branch);
+    }
+
+  timeline = clutter_timeline_new (4000);
+  clutter_timeline_set_repeat_count (timeline, -1);
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (new_frame), stage);
+
+  clutter_actor_show (stage);
+
+  clutter_perf_fps_start (CLUTTER_STAGE (stage));
+  clutter_timeline_start (timeline);
+  clutter_main ();
+  clutter_perf_fps_report ("test-deep-hierarchy");
+
+  g_object_unref (timeline);
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+#include "test-common.h"
+
+#define STAGE_WIDTH  800
+#define STAGE_HEIGHT 600
+
+#define ACTOR_SIZE    16
+
+#define N_ACTORS 1000
+
+static gint n_actors = N_ACTORS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-actors", 'a',
+    0,
+    G_OPTION_ARG_INT, &n_actors,
+    "Number of actors", "ACTORS"
+  },
+  { NULL }
+};
+
+static void
+animate_actor (ClutterActor *actor)
+{
+  clutter_actor_save_easing_state (actor);
+  clutter_actor_set_easing_mode (actor, CLUTTER_EASE_IN_OUT_SINE);
+  clutter_actor_set_easing_duration (actor, g_random_int_range (500, 2000));
+
+  clutter_actor_set_translation (actor,
+                                 g_random_double_range (0, STAGE_WIDTH - ACTOR_SIZE),
+                                 g_random_double_range (0, STAGE_HEIGHT - ACTOR_SIZE),
+                                 0.0f);
+  clutter_actor_set_opacity (actor, g_random_int_range (64, 256));
+  clutter_actor_set_rotation_angle (actor, CLUTTER_Z_AXIS,
+                                    g_random_double_range (0, 360));
+
+  clutter_actor_restore_easing_state (actor);
+}
+
+/* each actor starts a new set of transitions when the previous ones
+ * complete, so that there are always about n_actors * 4 running
+ */
+static void
+transitions_completed (ClutterActor *actor,
+                       gpointer      data)
+{
+  animate_actor (actor);
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage;
+  gint i;
+
+  clutter_perf_fps_init ();
+
+  if (CLUTTER_INIT_SUCCESS !=
+        clutter_init_with_args (&argc, &argv,
+                                NULL,
+                                entries,
+                                NULL,
+                                NULL))
+    {
+      g_warning ("Failed to initialize clutter");
+      return -1;
+    }
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, STAGE_WIDTH, STAGE_HEIGHT);
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Transitions Performance");
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_main_quit), NULL);
+
+  printf ("Transitions performance test with %d actors\n", n_actors);
+
+  for (i = 0; i < n_actors; i++)
+    {
+      ClutterColor color = { 0x00, 0x00, 0x00, 0xff };
+      ClutterActor *actor = clutter_actor_new ();
+
+      color.red = g_random_int_range (0, 256);
+      color.green = g_random_int_range (0, 256);
+      color.blue = g_random_int_range (0, 256);
+
+      clutter_actor_set_background_color (actor, &color);
+      clutter_actor_set_size (actor, ACTOR_SIZE, ACTOR_SIZE);
+      clutter_actor_set_pivot_point (actor, 0.5f, 0.5f);
+      g_signal_connect (actor, "transitions-completed",
+                        G_CALLBACK (transitions_completed),
+                        NULL);
+
+      clutter_actor_add_child (stage, actor);
+    }
+
+  clutter_actor_show (stage);
+
+  /* the implicit transitions are only created for mapped actors */
+  for (i = 0; i < n_actors; i++)
+    animate_actor (clutter_actor_get_child_at_index (stage, i));
+
+  clutter_perf_fps_start (CLUTTER_STAGE (stage));
+  clutter_main ();
+  clutter_perf_fps_report ("test-transitions");
+
+  return 0;
+}